@@ -27,6 +27,28 @@
 # find opm -name '*.c*' -printf '\t%p\n' | sort
 #list (APPEND MAIN_SOURCE_FILES)
 
+# the optional library of precompiled template instantiations
+if (OPM_MATERIAL_PRECOMPILED)
+	list (APPEND MAIN_SOURCE_FILES
+		opm/material/precompiled/BlackOilFluidSystem.cpp
+		opm/material/precompiled/CO2Tables.cpp
+		opm/material/precompiled/EclMaterialLawManager.cpp
+		opm/material/precompiled/Evaluation.cpp
+		opm/material/precompiled/H2O.cpp
+		)
+endif ()
+
+# the optional C interface to the array-valued kernels. see
+# opm/material/capi/OpmMaterialCApi.h for details.
+if (OPM_MATERIAL_CAPI)
+	list (APPEND MAIN_SOURCE_FILES
+		opm/material/capi/OpmMaterialCApi.cpp
+		)
+	list (APPEND PUBLIC_HEADER_FILES
+		opm/material/capi/OpmMaterialCApi.h
+		)
+endif ()
+
 # originally generated with the command:
 # find tests -name '*.cpp' -a ! -wholename '*/not-unit/*' -printf '\t%p\n' | sort
 list (APPEND TEST_SOURCE_FILES
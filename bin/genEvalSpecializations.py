@@ -13,13 +13,29 @@
 # script, you need a python 2 installation where the Jinja2 module is
 # available.
 #
+# Alternatively, `./bin/genEvalSpecializations.py --extra OUTPUT_DIR
+# SIZES` generates specializations for an additional list of numbers
+# of derivatives, e.g. "15;20" or "15,20", below OUTPUT_DIR. The files
+# in the source tree are not touched in this case, and sizes for which
+# a specialization is already checked in are skipped. This is used by
+# the build system if the OPM_EVAL_SIZES option is set.
+#
 import os
 import sys
 import jinja2
 
-maxDerivs = 12
-if len(sys.argv) == 2:
-    maxDerivs = int(sys.argv[1])
+extraOutputDir = None
+if len(sys.argv) == 4 and sys.argv[1] == "--extra":
+    extraOutputDir = sys.argv[2]
+    sizes = sorted(set([int(n) for n in sys.argv[3].replace(",", ";").split(";") if n.strip()]))
+    srcDir = os.path.join(os.path.dirname(os.path.abspath(sys.argv[0])), "..")
+    sizes = [n for n in sizes
+             if n > 0 and not os.path.exists(os.path.join(srcDir, "opm/material/densead/Evaluation%d.hpp"%n))]
+else:
+    maxDerivs = 12
+    if len(sys.argv) == 2:
+        maxDerivs = int(sys.argv[1])
+    sizes = range(1, maxDerivs + 1)
 
 fileNames = []
 
@@ -69,6 +85,7 @@ specializationTemplate = \
 
 #include "Evaluation.hpp"
 #include "Math.hpp"
+#include "DerivativeKernels.hpp"
 
 #include <opm/common/Valgrind.hpp>
 
@@ -111,6 +128,11 @@ protected:
     //! length of internal data vector
     static constexpr int length_ = size + 1;
 
+    //! properties of the internal data vector if it is padded for SIMD registers
+    typedef PaddedStorage<ValueT, length_> StorageTraits;
+    //! length of internal data vector including the padding
+    static constexpr int paddedLength_ = StorageTraits::paddedLength;
+
     //! position index for value
     static constexpr int valuepos_ = 0;
     //! start index for derivatives
@@ -167,6 +189,12 @@ public:
         data_[{{i}}] = 0.0;
 {%   endfor %}\
 {% endif %}\
+#if OPM_DENSEAD_ALIGN_STORAGE
+        // the padding is always kept at zero after an evaluation has been initialized
+        for (int i = length_; i < paddedLength_; ++i) {
+            data_[i] = 0.0;
+        }
+#endif
     }
 
     // create a function evaluation for a "naked" depending variable (i.e., f(x) = x)
@@ -212,10 +240,37 @@ public:
 {% endif %}\
     }
 
+    // set all derivatives to the ones of other multiplied by a factor, i.e., apply the
+    // chain rule f(g(x))' = f'(g(x))*g'(x)
+    void setScaledDerivatives(const ValueType& factor, const Evaluation& other)
+    {
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and restore the value afterwards
+        const ValueType value = data_[valuepos_];
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::scale(&data_[0], &other.data_[0], factor);
+        data_[valuepos_] = value;
+#elif OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::scale(&data_[dstart_], &other.data_[dstart_], factor);
+#else
+{% if numDerivs < 0 %}\
+        for (int i = dstart_; i < dend_; ++i) {
+            data_[i] = factor*other.data_[i];
+        }
+{% else %}\
+{%   for i in range(1, numDerivs+1) %}\
+        data_[{{i}}] = factor*other.data_[{{i}}];
+{%   endfor %}\
+{% endif %}\
+#endif
+    }
+
 
     // add value and derivatives from other to this values and derivatives
     Evaluation& operator+=(const Evaluation& other)
     {
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::add(&data_[0], &other.data_[0]);
+#else
 {% if numDerivs < 0 %}\
         for (int i = 0; i < length_; ++i) {
             data_[i] += other.data_[i];
@@ -225,6 +280,7 @@ public:
         data_[{{i}}] += other.data_[{{i}}];
 {%   endfor %}\
 {% endif %}\
+#endif
 
         return *this;
     }
@@ -273,10 +329,18 @@ public:
         const ValueType u = this->value();
         const ValueType v = other.value();
 
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and recompute the value afterwards
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::productRule(&data_[0], &other.data_[0], v, u);
+        data_[valuepos_] = u*v;
+#else
         // value
         data_[valuepos_] *= v ;
 
         //  derivatives
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::productRule(&data_[dstart_], &other.data_[dstart_], v, u);
+#else
 {% if numDerivs < 0 %}\
         for (int i = dstart_; i < dend_; ++i) {
             data_[i] = data_[i] * v + other.data_[i] * u;
@@ -286,6 +350,8 @@ public:
         data_[{{i}}] = data_[{{i}}] * v + other.data_[{{i}}] * u;
 {%   endfor %}\
 {% endif %}\
+#endif
+#endif
 
         return *this;
     }
@@ -312,8 +378,19 @@ public:
     {
         // values are divided, derivatives follow the rule for division, i.e., (u/v)' = (v'u -
         // u'v)/v^2.
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and recompute the value afterwards. note
+        // that 'other' may be the same object as 'this'
+        const ValueType u = data_[ valuepos_ ];
+        const ValueType v = other.value();
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::quotientRule(&data_[0], &other.data_[0], u, v);
+        data_[valuepos_] = u/v;
+#else
         ValueType& u = data_[ valuepos_ ];
         const ValueType& v = other.value();
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::quotientRule(&data_[dstart_], &other.data_[dstart_], u, v);
+#else
 {% if numDerivs < 0 %}\
         for (unsigned idx = dstart_; idx < dend_; ++idx) {
             const ValueType& uPrime = data_[idx];
@@ -326,7 +403,9 @@ public:
         data_[{{i}}] = (v*data_[{{i}}] - u*other.data_[{{i}}])/(v*v);
 {%   endfor %}\
 {% endif %}\
+#endif
         u /= v;
+#endif
 
         return *this;
     }
@@ -532,7 +611,7 @@ public:
     }
 
 private:
-    std::array<ValueT, length_> data_;
+    alignas(StorageTraits::alignment) std::array<ValueT, paddedLength_> data_;
 };
 
 {% if numDerivs < 0 %}\
@@ -661,8 +740,23 @@ public:
 
 } // namespace Dune
 
+// the specializations can be disabled to compare their performance with the one of the
+// generic code (see tests/bench_densead.cpp). since this changes the definition of the
+// Evaluation class, the macro must be set consistently for all translation units.
+#ifndef OPM_DENSEAD_DISABLE_SPECIALIZATIONS
+#define OPM_DENSEAD_DISABLE_SPECIALIZATIONS 0
+#endif
+
+#if !OPM_DENSEAD_DISABLE_SPECIALIZATIONS
 #include "EvaluationSpecializations.hpp"
 
+// specializations for further numbers of derivatives which have been generated by the
+// build system (see the OPM_EVAL_SIZES option of the top-level CMakeLists.txt)
+#if OPM_DENSEAD_HAVE_EXTRA_SPECIALIZATIONS
+#include <opm/material/densead/EvaluationExtraSpecializations.hpp>
+#endif
+#endif
+
 #endif // OPM_DENSEAD_EVALUATION_HPP
 {% else %}\
 #endif // OPM_DENSEAD_EVALUATION{{numDerivs}}_HPP
@@ -700,41 +794,58 @@ includeSpecializationsTemplate = \
  * \\attention THIS FILE GETS AUTOMATICALLY GENERATED BY THE "{{ scriptName }}"
  *            SCRIPT. DO NOT EDIT IT MANUALLY!
  */
-#ifndef OPM_DENSEAD_EVALUATION_SPECIALIZATIONS_HPP
-#define OPM_DENSEAD_EVALUATION_SPECIALIZATIONS_HPP
+#ifndef {{ guardName }}
+#define {{ guardName }}
 
 {% for fileName in fileNames %}\
 #include <{{ fileName }}>
 {% endfor %}\
 
-#endif // OPM_DENSEAD_EVALUATION_SPECIALIZATIONS_HPP
+#endif // {{ guardName }}
 """
 
-print ("Generating generic template class")
-fileName = "opm/material/densead/Evaluation.hpp"
-template = jinja2.Template(specializationTemplate)
-fileContents = template.render(numDerivs=-1, scriptName=os.path.basename(sys.argv[0]))
+scriptName = os.path.basename(sys.argv[0])
 
-f = open(fileName, "w")
-f.write(fileContents)
-f.close()
+if extraOutputDir is None:
+    outputDir = "."
+
+    print ("Generating generic template class")
+    fileName = "opm/material/densead/Evaluation.hpp"
+    template = jinja2.Template(specializationTemplate)
+    fileContents = template.render(numDerivs=-1, scriptName=scriptName)
 
-for numDerivs in range(1, maxDerivs + 1):
+    f = open(fileName, "w")
+    f.write(fileContents)
+    f.close()
+else:
+    outputDir = extraOutputDir
+    specializationDir = os.path.join(outputDir, "opm/material/densead")
+    if not os.path.isdir(specializationDir):
+        os.makedirs(specializationDir)
+
+for numDerivs in sizes:
     print ("Generating specialization for %d derivatives"%numDerivs)
 
     fileName = "opm/material/densead/Evaluation%d.hpp"%numDerivs
     fileNames.append(fileName)
 
     template = jinja2.Template(specializationTemplate)
-    fileContents = template.render(numDerivs=numDerivs, scriptName=os.path.basename(sys.argv[0]))
+    fileContents = template.render(numDerivs=numDerivs, scriptName=scriptName)
 
-    f = open(fileName, "w")
+    f = open(os.path.join(outputDir, fileName), "w")
     f.write(fileContents)
     f.close()
 
+if extraOutputDir is None:
+    includeFileName = "opm/material/densead/EvaluationSpecializations.hpp"
+    guardName = "OPM_DENSEAD_EVALUATION_SPECIALIZATIONS_HPP"
+else:
+    includeFileName = "opm/material/densead/EvaluationExtraSpecializations.hpp"
+    guardName = "OPM_DENSEAD_EVALUATION_EXTRA_SPECIALIZATIONS_HPP"
+
 template = jinja2.Template(includeSpecializationsTemplate)
-fileContents = template.render(fileNames=fileNames, scriptName=os.path.basename(sys.argv[0]))
+fileContents = template.render(fileNames=fileNames, guardName=guardName, scriptName=scriptName)
 
-f = open("opm/material/densead/EvaluationSpecializations.hpp", "w")
+f = open(os.path.join(outputDir, includeFileName), "w")
 f.write(fileContents)
 f.close()
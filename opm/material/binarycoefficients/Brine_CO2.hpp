@@ -33,6 +33,9 @@
 #include <opm/material/components/CO2.hpp>
 #include <opm/material/IdealGas.hpp>
 
+#include <cmath>
+#include <cstddef>
+
 namespace Opm {
 namespace BinaryCoeff {
 
@@ -105,42 +108,75 @@ public:
                                        Evaluation& xlCO2,
                                        Evaluation& ygH2O)
     {
-        Evaluation A = computeA_(temperature, pg);
-
         /* salinity: conversion from mass fraction to mol fraction */
         Scalar x_NaCl = salinityToMolFrac_(salinity);
+        Scalar molalityNaCl = moleFracToMolality_(x_NaCl); // molality of NaCl
 
-        // if both phases are present the mole fractions in each phase can be calculate
-        // with the mutual solubility function
-        if (knownPhaseIdx < 0) {
-            Scalar molalityNaCl = moleFracToMolality_(x_NaCl); // molality of NaCl //CHANGED
-            Evaluation m0_CO2 = molalityCO2inPureWater_(temperature, pg); // molality of CO2 in pure water
-            Evaluation gammaStar = activityCoefficient_(temperature, pg, molalityNaCl);// activity coefficient of CO2 in brine
-            Evaluation m_CO2 = m0_CO2 / gammaStar; // molality of CO2 in brine
-            xlCO2 = m_CO2 / (molalityNaCl + 55.508 + m_CO2); // mole fraction of CO2 in brine
-            ygH2O = A * (1 - xlCO2 - x_NaCl); // mole fraction of water in the gas phase
-        }
+        calculateMoleFractions_(temperature, pg, x_NaCl, molalityNaCl, knownPhaseIdx, xlCO2, ygH2O);
+    }
 
-        // if only liquid phase is present the mole fraction of CO2 in brine is given and
-        // and the virtual equilibrium mole fraction of water in the non-existing gas phase can be estimated
-        // with the mutual solubility function
-        if (knownPhaseIdx == liquidPhaseIdx)
-            ygH2O = A * (1 - xlCO2 - x_NaCl);
+    /*!
+     * \brief Computes the mutual solubilities of brine and CO2 for a batch of cells.
+     *
+     * This is equivalent to calling the single-cell variant of calculateMoleFractions()
+     * for each cell, but the salinity dependent terms are only recomputed if the
+     * salinity changes between consecutive cells and the cells are distributed over
+     * the available threads if OpenMP is enabled.
+     *
+     * \param temperature the temperatures of the cells [K]
+     * \param pg the gas phase pressures of the cells [Pa]
+     * \param salinity the salinities of the cells [kg NaCl / kg solution]
+     * \param knownPhaseIdx indicates which phases are present in each cell. If this is
+     *                      nullptr, both phases are assumed to be present everywhere
+     * \param xlCO2 mole fractions of CO2 in brine [mol/mol]
+     * \param ygH2O mole fractions of water in the gas phase [mol/mol]
+     * \param numCells the number of entries of each of the arrays
+     */
+    template <class Evaluation>
+    static void calculateMoleFractions(const Evaluation* temperature,
+                                       const Evaluation* pg,
+                                       const Scalar* salinity,
+                                       const int* knownPhaseIdx,
+                                       Evaluation* xlCO2,
+                                       Evaluation* ygH2O,
+                                       std::size_t numCells)
+    {
+        const long n = static_cast<long>(numCells);
 
-        // if only gas phase is present the mole fraction of water in the gas phase is given and
-        // and the virtual equilibrium mole fraction of CO2 in the non-existing liquid phase can be estimated
-        // with the mutual solubility function
-        if (knownPhaseIdx == gasPhaseIdx)
-            //y_H2o = fluidstate.
-            xlCO2 = 1 - x_NaCl - ygH2O / A;
-    }
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Scalar lastSalinity = 0.0;
+            Scalar x_NaCl = salinityToMolFrac_(lastSalinity);
+            Scalar molalityNaCl = moleFracToMolality_(x_NaCl);
 
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (long cellIdx = 0; cellIdx < n; ++cellIdx) {
+                if (salinity[cellIdx] != lastSalinity) {
+                    lastSalinity = salinity[cellIdx];
+                    x_NaCl = salinityToMolFrac_(lastSalinity);
+                    molalityNaCl = moleFracToMolality_(x_NaCl);
+                }
+
+                calculateMoleFractions_(temperature[cellIdx],
+                                        pg[cellIdx],
+                                        x_NaCl,
+                                        molalityNaCl,
+                                        knownPhaseIdx ? knownPhaseIdx[cellIdx] : -1,
+                                        xlCO2[cellIdx],
+                                        ygH2O[cellIdx]);
+            }
+        }
+    }
     /*!
      * \brief Henry coefficent \f$\mathrm{[N/m^2]}\f$ for CO2 in brine.
      */
     template <class Evaluation>
     static Evaluation henry(const Evaluation& temperature)
-    { return fugacityCoefficientCO2(temperature, /*pressure=*/1e5)*1e5; }
+    { return fugacityCoefficientCO2(temperature, /*pressure=*/Evaluation(1e5))*1e5; }
 
     /*!
      * \brief Returns the fugacity coefficient of the CO2 component in a water-CO2 mixture
@@ -210,6 +246,108 @@ public:
     }
 
 private:
+    /*!
+     * \brief The single-cell kernel of calculateMoleFractions().
+     *
+     * The salinity dependent quantities are passed in because they do not depend on
+     * the cell's temperature and pressure.
+     */
+    template <class Evaluation>
+    static void calculateMoleFractions_(const Evaluation& temperature,
+                                        const Evaluation& pg,
+                                        Scalar x_NaCl,
+                                        Scalar molalityNaCl,
+                                        const int knownPhaseIdx,
+                                        Evaluation& xlCO2,
+                                        Evaluation& ygH2O)
+    {
+        Evaluation A, B;
+        computeAB_(temperature, pg, A, B);
+
+        // if both phases are present the mole fractions in each phase can be calculate
+        // with the mutual solubility function
+        if (knownPhaseIdx < 0) {
+            // molality of CO2 in pure water (Spycher, Pruess and Ennis-King, 2003)
+            const Evaluation& yH2OinGas = (1 - B) / (1. / A - B);
+            const Evaluation& xCO2inWater = B * (1 - yH2OinGas);
+            const Evaluation& m0_CO2 = (xCO2inWater * 55.508) / (1 - xCO2inWater);
+
+            Evaluation gammaStar = activityCoefficient_(temperature, pg, molalityNaCl);// activity coefficient of CO2 in brine
+            Evaluation m_CO2 = m0_CO2 / gammaStar; // molality of CO2 in brine
+            xlCO2 = m_CO2 / (molalityNaCl + 55.508 + m_CO2); // mole fraction of CO2 in brine
+            ygH2O = A * (1 - xlCO2 - x_NaCl); // mole fraction of water in the gas phase
+        }
+
+        // if only liquid phase is present the mole fraction of CO2 in brine is given and
+        // and the virtual equilibrium mole fraction of water in the non-existing gas phase can be estimated
+        // with the mutual solubility function
+        if (knownPhaseIdx == liquidPhaseIdx)
+            ygH2O = A * (1 - xlCO2 - x_NaCl);
+
+        // if only gas phase is present the mole fraction of water in the gas phase is given and
+        // and the virtual equilibrium mole fraction of CO2 in the non-existing liquid phase can be estimated
+        // with the mutual solubility function
+        if (knownPhaseIdx == gasPhaseIdx)
+            xlCO2 = 1 - x_NaCl - ygH2O / A;
+    }
+
+    /*!
+     * \brief Computes the paramaters A and B for the calculation of the mutual
+     *        solubility in the water-CO2 system at once.
+     *
+     * The molar volume of CO2 and the terms of the Redlich-Kwong equation which are
+     * shared by the fugacity coefficients of CO2 and H2O are only evaluated once. Also,
+     * the equilibrium constants, the fugacity coefficients and the Poynting corrections
+     * are combined into a single exponential for each parameter.
+     *
+     * \param temperature the temperature [K]
+     * \param pg the gas phase pressure [Pa]
+     * \param A the parameter A given in Spycher, Pruess and Ennis-King (2003)
+     * \param B the parameter B given in Spycher, Pruess and Ennis-King (2003)
+     */
+    template <class Evaluation>
+    static void computeAB_(const Evaluation& temperature, const Evaluation& pg, Evaluation& A, Evaluation& B)
+    {
+        static const Scalar ln10 = std::log(10.0);
+        const Scalar a_CO2_H2O = 7.89e7; // mixture parameter of Redlich-Kwong equation
+        const Scalar b_CO2 = 27.8; // mixture parameter of Redlich-Kwong equation
+        const Scalar b_H2O = 18.18; // mixture parameter of Redlich-Kwong equation
+        const Scalar v_av_H2O = 18.1; // average partial molar volume of H2O [cm^3/mol]
+        const Scalar v_av_CO2 = 32.6; // average partial molar volume of CO2 [cm^3/mol]
+        const Scalar R = IdealGas::R * 10.; // ideal gas constant with unit bar cm^3 /(K mol)
+
+        const Evaluation& V = 1 / (CO2::gasDensity(temperature, pg) / CO2::molarMass()) * 1.e6; // molar volume in cm^3/mol
+        const Evaluation& pg_bar = pg / 1.e5; // gas phase pressure in bar
+        const Evaluation& a_CO2 = (7.54e7 - 4.13e4 * temperature); // mixture parameter of  Redlich-Kwong equation
+        const Evaluation& RT = R*temperature;
+        const Evaluation& RT15bb = RT*Opm::sqrt(temperature)*(b_CO2*b_CO2);
+
+        // the terms which are shared by the fugacity coefficients of both components
+        const Evaluation& lnVVb = Opm::log(V/(V - b_CO2));
+        const Evaluation& lnVbV = Opm::log((V + b_CO2)/V);
+        const Evaluation& lnZ = Opm::log(pg_bar*V/RT);
+        const Evaluation& rkTerm = (lnVbV - b_CO2/(V + b_CO2))/RT15bb;
+
+        const Evaluation& lnPhiCO2 =
+            lnVVb + b_CO2/(V - b_CO2)
+            - 2*a_CO2*b_CO2/RT15bb*lnVbV
+            + a_CO2*b_CO2*rkTerm
+            - lnZ;
+        const Evaluation& lnPhiH2O =
+            lnVVb + b_H2O/(V - b_CO2)
+            - 2*a_CO2_H2O*b_CO2/RT15bb*lnVbV
+            + a_CO2*b_H2O*rkTerm
+            - lnZ;
+
+        // decadic logarithms of the equilibrium constants at 1 bar
+        const Evaluation& logk0_H2O = log10EquilibriumConstantH2O_(temperature);
+        const Evaluation& logk0_CO2 = log10EquilibriumConstantCO2_(temperature);
+
+        const Evaluation& deltaP = pg_bar - 1; // pressure range [bar] from p0 = 1bar to pg[bar]
+        A = Opm::exp(ln10*logk0_H2O - lnPhiH2O + deltaP*(v_av_H2O/RT))/pg_bar;
+        B = pg_bar/55.508*Opm::exp(lnPhiCO2 - ln10*logk0_CO2 - deltaP*(v_av_CO2/RT));
+    }
+
     /*!
      * \brief Returns the molality of NaCl (mol NaCl / kg water) for a given mole fraction
      *
@@ -237,23 +375,6 @@ private:
         return 55.508 * x_NaCl / (1 - x_NaCl);
     }
 
-    /*!
-     * \brief Returns the equilibrium molality of CO2 (mol CO2 / kg water) for a
-     * CO2-water mixture at a given pressure and temperature
-     *
-     * \param temperature The temperature [K]
-     * \param pg The gas phase pressure [Pa]
-     */
-    template <class Evaluation>
-    static Evaluation molalityCO2inPureWater_(const Evaluation& temperature, const Evaluation& pg)
-    {
-        const Evaluation& A = computeA_(temperature, pg); // according to Spycher, Pruess and Ennis-King (2003)
-        const Evaluation& B = computeB_(temperature, pg); // according to Spycher, Pruess and Ennis-King (2003)
-        const Evaluation& yH2OinGas = (1 - B) / (1. / A - B); // equilibrium mol fraction of H2O in the gas phase
-        const Evaluation& xCO2inWater = B * (1 - yH2OinGas); // equilibrium mol fraction of CO2 in the water phase
-        return (xCO2inWater * 55.508) / (1 - xCO2inWater); // CO2 molality
-    }
-
     /*!
      * \brief Returns the activity coefficient of CO2 in brine for a
      *           molal description. According to "Duan and Sun 2003"
@@ -275,46 +396,6 @@ private:
         return Opm::exp(lnGammaStar);
     }
 
-    /*!
-     * \brief Returns the paramater A for the calculation of
-     * them mutual solubility in the water-CO2 system.
-     * Given in Spycher, Pruess and Ennis-King (2003)
-     *
-     * \param T the temperature [K]
-     * \param pg the gas phase pressure [Pa]
-     */
-    template <class Evaluation>
-    static Evaluation computeA_(const Evaluation& temperature, const Evaluation& pg)
-    {
-        const Evaluation& deltaP = pg / 1e5 - 1; // pressure range [bar] from p0 = 1bar to pg[bar]
-        Scalar v_av_H2O = 18.1; // average partial molar volume of H2O [cm^3/mol]
-        Scalar R = IdealGas::R * 10;
-        const Evaluation& k0_H2O = equilibriumConstantH2O_(temperature); // equilibrium constant for H2O at 1 bar
-        const Evaluation& phi_H2O = fugacityCoefficientH2O(temperature, pg); // fugacity coefficient of H2O for the water-CO2 system
-        const Evaluation& pg_bar = pg / 1.e5;
-        return k0_H2O/(phi_H2O*pg_bar)*Opm::exp(deltaP*v_av_H2O/(R*temperature));
-    }
-
-    /*!
-     * \brief Returns the paramater B for the calculation of
-     * the mutual solubility in the water-CO2 system.
-     * Given in Spycher, Pruess and Ennis-King (2003)
-     *
-     * \param temperature the temperature [K]
-     * \param pg the gas phase pressure [Pa]
-     */
-    template <class Evaluation>
-    static Evaluation computeB_(const Evaluation& temperature, const Evaluation& pg)
-    {
-        const Evaluation& deltaP = pg / 1e5 - 1; // pressure range [bar] from p0 = 1bar to pg[bar]
-        const Scalar v_av_CO2 = 32.6; // average partial molar volume of CO2 [cm^3/mol]
-        const Scalar R = IdealGas::R * 10;
-        const Evaluation& k0_CO2 = equilibriumConstantCO2_(temperature); // equilibrium constant for CO2 at 1 bar
-        const Evaluation& phi_CO2 = fugacityCoefficientCO2(temperature, pg); // fugacity coefficient of CO2 for the water-CO2 system
-        const Evaluation& pg_bar = pg / 1.e5;
-        return phi_CO2*pg_bar/(55.508*k0_CO2)*Opm::exp(-(deltaP*v_av_CO2)/(R*temperature));
-    }
-
     /*!
      * \brief Returns the parameter lambda, which is needed for the
      * calculation of the CO2 activity coefficient in the brine-CO2 system.
@@ -356,35 +437,31 @@ private:
     }
 
     /*!
-     * \brief Returns the equilibrium constant for CO2, which is needed for the
-     * calculation of the mutual solubility in the water-CO2 system
+     * \brief Returns the decadic logarithm of the equilibrium constant for CO2, which
+     * is needed for the calculation of the mutual solubility in the water-CO2 system
      * Given in Spycher, Pruess and Ennis-King (2003)
      * \param temperature the temperature [K]
      */
     template <class Evaluation>
-    static Evaluation equilibriumConstantCO2_(const Evaluation& temperature)
+    static Evaluation log10EquilibriumConstantCO2_(const Evaluation& temperature)
     {
         Evaluation temperatureCelcius = temperature - 273.15;
         static const Scalar c[3] = { 1.189, 1.304e-2, -5.446e-5 };
-        Evaluation logk0_CO2 = c[0] + temperatureCelcius*(c[1] + temperatureCelcius*c[2]);
-        Evaluation k0_CO2 = Opm::pow(10.0, logk0_CO2);
-        return k0_CO2;
+        return c[0] + temperatureCelcius*(c[1] + temperatureCelcius*c[2]);
     }
 
     /*!
-     * \brief Returns the equilibrium constant for H2O, which is needed for the
-     * calculation of the mutual solubility in the water-CO2 system
+     * \brief Returns the decadic logarithm of the equilibrium constant for H2O, which
+     * is needed for the calculation of the mutual solubility in the water-CO2 system
      * Given in Spycher, Pruess and Ennis-King (2003)
      * \param temperature the temperature [K]
      */
     template <class Evaluation>
-    static Evaluation equilibriumConstantH2O_(const Evaluation& temperature)
+    static Evaluation log10EquilibriumConstantH2O_(const Evaluation& temperature)
     {
         Evaluation temperatureCelcius = temperature - 273.15;
         static const Scalar c[4] = { -2.209, 3.097e-2, -1.098e-4, 2.048e-7 };
-        Evaluation logk0_H2O =
-            c[0] + temperatureCelcius*(c[1] + temperatureCelcius*(c[2] + temperatureCelcius*c[3]));
-        return Opm::pow(10.0, logk0_H2O);
+        return c[0] + temperatureCelcius*(c[1] + temperatureCelcius*(c[2] + temperatureCelcius*c[3]));
     }
 
 };
@@ -0,0 +1,266 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Implementation of the C interface to the array-valued black-oil PVT and
+ *        saturation function kernels.
+ *
+ * See opm/material/capi/OpmMaterialCApi.h.
+ */
+#include <config.h>
+
+#include "OpmMaterialCApi.h"
+
+// the interface requires opm-parser to read the decks
+#if HAVE_OPM_PARSER
+
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+#include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
+
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+typedef Opm::FluidSystems::BlackOil<double> FluidSystem;
+typedef Opm::ThreePhaseMaterialTraits<double,
+                                      /*wettingPhaseIdx=*/FluidSystem::waterPhaseIdx,
+                                      /*nonWettingPhaseIdx=*/FluidSystem::oilPhaseIdx,
+                                      /*gasPhaseIdx=*/FluidSystem::gasPhaseIdx> MaterialTraits;
+typedef Opm::EclMaterialLawManager<MaterialTraits> MaterialLawManager;
+
+thread_local std::string lastError;
+
+int setError(const char* what)
+{
+    lastError = what;
+    return 1;
+}
+
+// the range-wise kernels of the material law manager are serial, so the range is
+// split into one contiguous block per thread
+template <bool computeKr>
+void evalSaturationFunctions(const MaterialLawManager& manager,
+                             double* const* result,
+                             const double* const* saturations,
+                             size_t beginCellIdx,
+                             size_t endCellIdx)
+{
+    const long numCells = static_cast<long>(endCellIdx - beginCellIdx);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        long numThreads = 1;
+        long threadIdx = 0;
+#ifdef _OPENMP
+        numThreads = omp_get_num_threads();
+        threadIdx = omp_get_thread_num();
+#endif
+        const long blockBegin = numCells*threadIdx/numThreads;
+        const long blockEnd = numCells*(threadIdx + 1)/numThreads;
+        if (blockBegin < blockEnd) {
+            double* blockResult[FluidSystem::numPhases];
+            const double* blockSaturations[FluidSystem::numPhases];
+            for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+                blockResult[phaseIdx] = result[phaseIdx] + blockBegin;
+                blockSaturations[phaseIdx] = saturations[phaseIdx] + blockBegin;
+            }
+
+            const unsigned elemBegin = static_cast<unsigned>(beginCellIdx + blockBegin);
+            const unsigned elemEnd = static_cast<unsigned>(beginCellIdx + blockEnd);
+            if (computeKr)
+                manager.relativePermeabilities(blockResult, blockSaturations, elemBegin, elemEnd);
+            else
+                manager.capillaryPressures(blockResult, blockSaturations, elemBegin, elemEnd);
+        }
+    }
+}
+} // anonymous namespace
+
+struct OpmMaterialEclModel
+{
+    FluidSystem::Context fluidSystemContext;
+    MaterialLawManager materialLawManager;
+    size_t numCells;
+};
+
+extern "C" {
+
+const char* opm_material_last_error(void)
+{ return lastError.c_str(); }
+
+OpmMaterialEclModel* opm_material_ecl_model_create(const char* deckFileName)
+{
+    OpmMaterialEclModel* model = nullptr;
+    try {
+        Opm::Parser parser;
+        Opm::ParseContext parseContext;
+        const auto deck = parser.parseFile(deckFileName, parseContext);
+        const Opm::EclipseState eclState(deck, parseContext);
+
+        const auto& eclGrid = eclState.getInputGrid();
+        std::vector<int> compressedToCartesianElemIdx(eclGrid.getNumActive());
+        for (size_t activeIdx = 0; activeIdx < compressedToCartesianElemIdx.size(); ++activeIdx)
+            compressedToCartesianElemIdx[activeIdx] = static_cast<int>(eclGrid.getGlobalIndex(activeIdx));
+
+        model = new OpmMaterialEclModel;
+        model->numCells = compressedToCartesianElemIdx.size();
+        {
+            FluidSystem::ScopedContext scopedContext(model->fluidSystemContext);
+            FluidSystem::initFromDeck(deck, eclState);
+        }
+        model->materialLawManager.initFromDeck(deck, eclState, compressedToCartesianElemIdx);
+        return model;
+    }
+    catch (const std::exception& e) {
+        delete model;
+        setError(e.what());
+    }
+    catch (...) {
+        delete model;
+        setError("Unknown error while reading the deck");
+    }
+    return nullptr;
+}
+
+void opm_material_ecl_model_destroy(OpmMaterialEclModel* model)
+{ delete model; }
+
+size_t opm_material_ecl_model_num_cells(const OpmMaterialEclModel* model)
+{ return model->numCells; }
+
+int opm_material_ecl_model_phase_is_active(const OpmMaterialEclModel* model,
+                                           unsigned phaseIdx)
+{
+    return phaseIdx < FluidSystem::numPhases
+        && model->fluidSystemContext.phaseIsActive[phaseIdx];
+}
+
+int opm_material_ecl_model_phase_properties(const OpmMaterialEclModel* model,
+                                            const OpmMaterialPhasePropertyInput* input,
+                                            const OpmMaterialPhasePropertyOutput* output)
+{
+    try {
+        FluidSystem::PropertyExportInput exportInput;
+        exportInput.numCells = input->numCells;
+        exportInput.regionIdx = input->regionIdx;
+        exportInput.temperature = input->temperature;
+        exportInput.Rs = input->Rs;
+        exportInput.Rv = input->Rv;
+
+        FluidSystem::PropertyExportOutput exportOutput;
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            if (model->fluidSystemContext.phaseIsActive[phaseIdx] && !input->pressure[phaseIdx])
+                return setError("The pressure of an active phase is missing");
+
+            exportInput.pressure[phaseIdx] = input->pressure[phaseIdx];
+            exportInput.saturation[phaseIdx] = input->saturation[phaseIdx];
+
+            exportOutput.invB[phaseIdx] = output->invB[phaseIdx];
+            exportOutput.density[phaseIdx] = output->density[phaseIdx];
+            exportOutput.viscosity[phaseIdx] = output->viscosity[phaseIdx];
+            exportOutput.saturatedDissolutionFactor[phaseIdx] =
+                output->saturatedDissolutionFactor[phaseIdx];
+        }
+
+        // the fluid system only reads the context, so it can be shared by concurrent
+        // calls
+        FluidSystem::ScopedContext
+            scopedContext(const_cast<FluidSystem::Context&>(model->fluidSystemContext));
+        FluidSystem::exportPhaseProperties(exportInput, exportOutput);
+    }
+    catch (const std::exception& e) {
+        return setError(e.what());
+    }
+    catch (...) {
+        return setError("Unknown error while computing the phase properties");
+    }
+    return 0;
+}
+
+int opm_material_ecl_model_relative_permeabilities(const OpmMaterialEclModel* model,
+                                                   double* const* kr,
+                                                   const double* const* saturations,
+                                                   size_t beginCellIdx,
+                                                   size_t endCellIdx)
+{
+    if (beginCellIdx > endCellIdx || endCellIdx > model->numCells)
+        return setError("Invalid range of cells");
+
+    try {
+        evalSaturationFunctions</*computeKr=*/true>(model->materialLawManager,
+                                                     kr,
+                                                     saturations,
+                                                     beginCellIdx,
+                                                     endCellIdx);
+    }
+    catch (const std::exception& e) {
+        return setError(e.what());
+    }
+    catch (...) {
+        return setError("Unknown error while computing the relative permeabilities");
+    }
+    return 0;
+}
+
+int opm_material_ecl_model_capillary_pressures(const OpmMaterialEclModel* model,
+                                               double* const* pc,
+                                               const double* const* saturations,
+                                               size_t beginCellIdx,
+                                               size_t endCellIdx)
+{
+    if (beginCellIdx > endCellIdx || endCellIdx > model->numCells)
+        return setError("Invalid range of cells");
+
+    try {
+        evalSaturationFunctions</*computeKr=*/false>(model->materialLawManager,
+                                                      pc,
+                                                      saturations,
+                                                      beginCellIdx,
+                                                      endCellIdx);
+    }
+    catch (const std::exception& e) {
+        return setError(e.what());
+    }
+    catch (...) {
+        return setError("Unknown error while computing the capillary pressures");
+    }
+    return 0;
+}
+
+} // extern "C"
+#endif // HAVE_OPM_PARSER
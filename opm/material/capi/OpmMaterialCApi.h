@@ -0,0 +1,164 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief A C interface to the array-valued black-oil PVT and saturation function
+ *        kernels of ECL decks.
+ *
+ * The interface is meant for calling the kernels from other languages, e.g., from
+ * Python via ctypes, using the arrays of the caller without copying them. All arrays
+ * are plain C arrays of doubles (or unsigned ints for region indices) which are
+ * indexed by the cell, and the quantities of the phases are passed as one array per
+ * phase, using the phase indices of the black-oil fluid system (water = 0, oil = 1,
+ * gas = 2). No function of the interface calls back into the caller, so bindings may
+ * release their interpreter lock for the duration of a call. The cells are processed
+ * by all OpenMP threads.
+ *
+ * All functions which can fail return 0 on success and a non-zero value on error. In
+ * this case, opm_material_last_error() returns a description of the error which is
+ * valid until the next call of the interface by the same thread.
+ *
+ * The interface is part of the library if opm-material is configured with
+ * -DOPM_MATERIAL_CAPI=ON and opm-parser is available. python/opm_material.py
+ * contains bindings for NumPy arrays.
+ */
+#ifndef OPM_MATERIAL_CAPI_H
+#define OPM_MATERIAL_CAPI_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \brief The PVT properties and the saturation functions of an ECL deck.
+ *
+ * Each model uses its own context of the black-oil fluid system, i.e., several models
+ * can be used at the same time.
+ */
+typedef struct OpmMaterialEclModel OpmMaterialEclModel;
+
+/*!
+ * \brief The per-cell input quantities of opm_material_ecl_model_phase_properties().
+ *
+ * The meaning of the arrays is the same as for the members of
+ * Opm::FluidSystems::BlackOil::PropertyExportInput. Arrays which are not needed must
+ * be NULL.
+ */
+typedef struct OpmMaterialPhasePropertyInput
+{
+    size_t numCells;
+    const unsigned* regionIdx;
+    const double* temperature;
+    const double* pressure[3];
+    const double* saturation[3];
+    const double* Rs;
+    const double* Rv;
+} OpmMaterialPhasePropertyInput;
+
+/*!
+ * \brief The arrays which receive the results of
+ *        opm_material_ecl_model_phase_properties().
+ *
+ * Only the quantities whose array is not NULL are written.
+ */
+typedef struct OpmMaterialPhasePropertyOutput
+{
+    double* invB[3];
+    double* density[3];
+    double* viscosity[3];
+    double* saturatedDissolutionFactor[3];
+} OpmMaterialPhasePropertyOutput;
+
+/*!
+ * \brief Returns the description of the last error of the calling thread.
+ */
+const char* opm_material_last_error(void);
+
+/*!
+ * \brief Read an ECL deck file and set up the PVT properties and the saturation
+ *        functions of its active cells.
+ *
+ * \return The model or NULL on error.
+ */
+OpmMaterialEclModel* opm_material_ecl_model_create(const char* deckFileName);
+
+/*!
+ * \brief Release all resources of a model.
+ */
+void opm_material_ecl_model_destroy(OpmMaterialEclModel* model);
+
+/*!
+ * \brief The number of active cells of the deck of a model.
+ *
+ * The saturation functions are indexed by the active cells.
+ */
+size_t opm_material_ecl_model_num_cells(const OpmMaterialEclModel* model);
+
+/*!
+ * \brief Returns 1 if a phase is active in the deck of a model and 0 if not.
+ */
+int opm_material_ecl_model_phase_is_active(const OpmMaterialEclModel* model,
+                                           unsigned phaseIdx);
+
+/*!
+ * \brief Compute the PVT properties of the phases for many cells.
+ *
+ * See Opm::FluidSystems::BlackOil::exportPhaseProperties().
+ */
+int opm_material_ecl_model_phase_properties(const OpmMaterialEclModel* model,
+                                            const OpmMaterialPhasePropertyInput* input,
+                                            const OpmMaterialPhasePropertyOutput* output);
+
+/*!
+ * \brief Compute the relative permeabilities of a contiguous range of active cells.
+ *
+ * 'saturations[phaseIdx][i]' is the saturation of the phase in the cell
+ * 'beginCellIdx + i'; the results are stored the same way in 'kr'. See
+ * Opm::EclMaterialLawManager::relativePermeabilities().
+ */
+int opm_material_ecl_model_relative_permeabilities(const OpmMaterialEclModel* model,
+                                                   double* const* kr,
+                                                   const double* const* saturations,
+                                                   size_t beginCellIdx,
+                                                   size_t endCellIdx);
+
+/*!
+ * \brief Compute the capillary pressures of a contiguous range of active cells.
+ *
+ * The arrays are organized the same way as for
+ * opm_material_ecl_model_relative_permeabilities().
+ */
+int opm_material_ecl_model_capillary_pressures(const OpmMaterialEclModel* model,
+                                               double* const* pc,
+                                               const double* const* saturations,
+                                               size_t beginCellIdx,
+                                               size_t endCellIdx);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,405 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Classes to store fully initialized objects in a compact binary format.
+ *
+ * Objects which support this provide the methods
+ *
+ * \code
+ * void serialize(BinaryWriter& writer) const;
+ * void deserialize(BinaryReader& reader);
+ * \endcode
+ *
+ * Objects which are referenced by several shared pointers are only stored once if they
+ * are written using BinaryWriter::writeShared(), and they are shared again after they
+ * have been read using BinaryReader::readShared().
+ *
+ * The format uses the native byte order and the native size of the scalars, i.e., it is
+ * meant to cache objects between runs of the same build on the same kind of machine, not
+ * to exchange them. Since the reader operates on a contiguous range of memory, the data
+ * can be read from a file using readBinaryFile() or from a memory-mapped file.
+ */
+#ifndef OPM_MATERIAL_BINARY_SERIALIZATION_HPP
+#define OPM_MATERIAL_BINARY_SERIALIZATION_HPP
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+namespace BinarySerializationDetail {
+// the first bytes of each blob: "OPMB" followed by the version of the format
+static const std::uint32_t magic = 0x424d504f;
+static const std::uint32_t formatVersion = 5;
+
+// an address which is unique for each type. it is used to make sure that a shared
+// object is read back using the type it was written with.
+template <class T>
+struct TypeTag
+{ static const char value; };
+
+template <class T>
+const char TypeTag<T>::value = 0;
+}
+
+/*!
+ * \brief Writes objects to a binary blob in memory.
+ */
+class BinaryWriter
+{
+public:
+    BinaryWriter()
+    {
+        write(BinarySerializationDetail::magic);
+        write(BinarySerializationDetail::formatVersion);
+    }
+
+    /*!
+     * \brief Append a value of a trivially copyable type.
+     */
+    template <class T>
+    void write(const T& value)
+    {
+        static_assert(std::is_pod<T>::value,
+                      "Only plain old data can be written as raw bytes");
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        data_.insert(data_.end(), bytes, bytes + sizeof(T));
+    }
+
+    /*!
+     * \brief Append a vector of trivially copyable values and its size.
+     */
+    template <class T>
+    void write(const std::vector<T>& values)
+    {
+        static_assert(std::is_pod<T>::value,
+                      "Only vectors of plain old data can be written as raw bytes");
+        write(static_cast<std::uint64_t>(values.size()));
+        if (values.empty())
+            return;
+        const char* bytes = reinterpret_cast<const char*>(values.data());
+        data_.insert(data_.end(), bytes, bytes + values.size()*sizeof(T));
+    }
+
+    void write(const std::vector<bool>& values)
+    {
+        write(static_cast<std::uint64_t>(values.size()));
+        for (bool value : values)
+            write(static_cast<std::uint8_t>(value));
+    }
+
+    /*!
+     * \brief Append an object which is either plain old data or provides a serialize()
+     *        method.
+     */
+    template <class T>
+    void writeObject(const T& object)
+    { writeObject_(object); }
+
+    /*!
+     * \brief Append a vector of objects which provide a serialize() method.
+     */
+    template <class T>
+    void writeObjects(const std::vector<T>& objects)
+    {
+        write(static_cast<std::uint64_t>(objects.size()));
+        for (const auto& object : objects)
+            writeObject_(object);
+    }
+
+    /*!
+     * \brief Append an object which is referenced by a shared pointer.
+     *
+     * Objects which are referenced by several pointers are only written once. The object
+     * must either be plain old data or provide a serialize() method.
+     */
+    template <class T>
+    void writeShared(const std::shared_ptr<T>& object)
+    {
+        if (!object) {
+            write(static_cast<std::uint64_t>(0));
+            return;
+        }
+
+        const void* address = object.get();
+        const auto it = sharedObjectIds_.find(address);
+        if (it != sharedObjectIds_.end()) {
+            write(it->second);
+            return;
+        }
+
+        const std::uint64_t id = sharedObjectIds_.size() + 1;
+        sharedObjectIds_[address] = id;
+        write(id);
+        writeObject_(*object);
+    }
+
+    /*!
+     * \brief Append a vector of shared pointers and the objects which they reference.
+     */
+    template <class T>
+    void writeSharedObjects(const std::vector<std::shared_ptr<T> >& objects)
+    {
+        write(static_cast<std::uint64_t>(objects.size()));
+        for (const auto& object : objects)
+            writeShared(object);
+    }
+
+    /*!
+     * \brief Returns the blob which has been written so far.
+     */
+    const std::vector<char>& data() const
+    { return data_; }
+
+    /*!
+     * \brief Write the blob to a file.
+     */
+    void writeToFile(const std::string& fileName) const
+    {
+        std::ofstream os(fileName, std::ios::binary);
+        if (!os)
+            OPM_THROW(std::runtime_error, "Could not open file '" << fileName << "' for writing");
+
+        os.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+        if (!os)
+            OPM_THROW(std::runtime_error, "Could not write to file '" << fileName << "'");
+    }
+
+private:
+    template <class T>
+    typename std::enable_if<std::is_pod<T>::value>::type
+    writeObject_(const T& object)
+    { write(object); }
+
+    template <class T>
+    typename std::enable_if<!std::is_pod<T>::value>::type
+    writeObject_(const T& object)
+    { object.serialize(*this); }
+
+    std::vector<char> data_;
+    std::unordered_map<const void*, std::uint64_t> sharedObjectIds_;
+};
+
+/*!
+ * \brief Reads objects from a binary blob which was produced by BinaryWriter.
+ *
+ * The reader does not own the memory of the blob, which must stay valid as long as the
+ * reader is used.
+ */
+class BinaryReader
+{
+public:
+    BinaryReader(const char* data, std::size_t size)
+        : data_(data)
+        , size_(size)
+        , pos_(0)
+    {
+        std::uint32_t magic;
+        std::uint32_t formatVersion;
+        read(magic);
+        if (magic != BinarySerializationDetail::magic)
+            OPM_THROW(std::runtime_error, "The data is not a serialized opm-material object");
+        read(formatVersion);
+        if (formatVersion != BinarySerializationDetail::formatVersion)
+            OPM_THROW(std::runtime_error,
+                      "Unsupported version " << formatVersion << " of the serialization format");
+    }
+
+    explicit BinaryReader(const std::vector<char>& data)
+        : BinaryReader(data.data(), data.size())
+    {}
+
+    /*!
+     * \brief Read a value of a trivially copyable type.
+     */
+    template <class T>
+    void read(T& value)
+    {
+        static_assert(std::is_pod<T>::value,
+                      "Only plain old data can be read as raw bytes");
+        std::memcpy(&value, take_(sizeof(T)), sizeof(T));
+    }
+
+    /*!
+     * \brief Read a vector of trivially copyable values.
+     */
+    template <class T>
+    void read(std::vector<T>& values)
+    {
+        static_assert(std::is_pod<T>::value,
+                      "Only vectors of plain old data can be read as raw bytes");
+        const std::size_t n = readSize_(sizeof(T));
+        values.resize(n);
+        if (n > 0)
+            std::memcpy(values.data(), take_(n*sizeof(T)), n*sizeof(T));
+    }
+
+    void read(std::vector<bool>& values)
+    {
+        const std::size_t n = readSize_(1);
+        values.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint8_t value;
+            read(value);
+            values[i] = (value != 0);
+        }
+    }
+
+    /*!
+     * \brief Read an object which was written by BinaryWriter::writeObject().
+     */
+    template <class T>
+    void readObject(T& object)
+    { readObject_(object); }
+
+    /*!
+     * \brief Read a vector of objects which provide a deserialize() method.
+     */
+    template <class T>
+    void readObjects(std::vector<T>& objects)
+    {
+        const std::size_t n = readSize_(1);
+        objects.resize(n);
+        for (auto& object : objects)
+            readObject_(object);
+    }
+
+    /*!
+     * \brief Read an object which was written by BinaryWriter::writeShared().
+     *
+     * If the object has already been read for a different pointer, the pointer
+     * references the same object.
+     */
+    template <class T>
+    void readShared(std::shared_ptr<T>& object)
+    {
+        std::uint64_t id;
+        read(id);
+        if (id == 0) {
+            object.reset();
+            return;
+        }
+
+        const void* typeTag = &BinarySerializationDetail::TypeTag<T>::value;
+        if (id <= sharedObjects_.size()) {
+            const auto& entry = sharedObjects_[id - 1];
+            if (entry.second != typeTag)
+                OPM_THROW(std::runtime_error,
+                          "Corrupt serialized data: shared object " << id << " has a different type");
+            object = std::static_pointer_cast<T>(entry.first);
+            return;
+        }
+
+        if (id != sharedObjects_.size() + 1)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: invalid shared object " << id);
+
+        object = std::make_shared<T>();
+        sharedObjects_.push_back(std::make_pair(std::shared_ptr<void>(object), typeTag));
+        readObject_(*object);
+    }
+
+    /*!
+     * \brief Read a vector of shared pointers which was written by
+     *        BinaryWriter::writeSharedObjects().
+     */
+    template <class T>
+    void readSharedObjects(std::vector<std::shared_ptr<T> >& objects)
+    {
+        const std::size_t n = readSize_(sizeof(std::uint64_t));
+        objects.resize(n);
+        for (auto& object : objects)
+            readShared(object);
+    }
+
+    /*!
+     * \brief Returns true iff all bytes of the blob have been read.
+     */
+    bool atEnd() const
+    { return pos_ == size_; }
+
+private:
+    // read the number of elements of a vector and make sure that the blob is large
+    // enough to contain them
+    std::size_t readSize_(std::size_t minBytesPerElement)
+    {
+        std::uint64_t n;
+        read(n);
+        if (n > (size_ - pos_)/minBytesPerElement)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: invalid size " << n);
+        return static_cast<std::size_t>(n);
+    }
+
+    const char* take_(std::size_t numBytes)
+    {
+        if (numBytes > size_ - pos_)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: unexpected end of data");
+        const char* result = data_ + pos_;
+        pos_ += numBytes;
+        return result;
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_pod<T>::value>::type
+    readObject_(T& object)
+    { read(object); }
+
+    template <class T>
+    typename std::enable_if<!std::is_pod<T>::value>::type
+    readObject_(T& object)
+    { object.deserialize(*this); }
+
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_;
+    std::vector<std::pair<std::shared_ptr<void>, const void*> > sharedObjects_;
+};
+
+/*!
+ * \brief Read the contents of a file which was written by BinaryWriter::writeToFile().
+ */
+inline std::vector<char> readBinaryFile(const std::string& fileName)
+{
+    std::ifstream is(fileName, std::ios::binary);
+    if (!is)
+        OPM_THROW(std::runtime_error, "Could not open file '" << fileName << "' for reading");
+
+    return std::vector<char>(std::istreambuf_iterator<char>(is),
+                             std::istreambuf_iterator<char>());
+}
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,196 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::CellBlockPipeline
+ */
+#ifndef OPM_CELL_BLOCK_PIPELINE_HPP
+#define OPM_CELL_BLOCK_PIPELINE_HPP
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace Opm {
+
+namespace CellBlockPipelineDetail {
+// calls the stages with indices [stageIdx, numStages) for a range of cells
+template <std::size_t stageIdx, std::size_t numStages>
+struct StageRunner
+{
+    template <class StageTuple>
+    static void run(const StageTuple& stages, std::size_t begin, std::size_t end)
+    {
+        std::get<stageIdx>(stages)(begin, end);
+        StageRunner<stageIdx + 1, numStages>::run(stages, begin, end);
+    }
+};
+
+template <std::size_t numStages>
+struct StageRunner<numStages, numStages>
+{
+    template <class StageTuple>
+    static void run(const StageTuple& /*stages*/, std::size_t /*begin*/, std::size_t /*end*/)
+    {}
+};
+} // namespace CellBlockPipelineDetail
+
+/*!
+ * \brief Adapts a function which processes a single cell to a stage of a
+ *        CellBlockPipeline.
+ */
+template <class CellFunction>
+class CellStage
+{
+public:
+    explicit CellStage(CellFunction fn)
+        : fn_(std::move(fn))
+    {}
+
+    void operator()(std::size_t begin, std::size_t end) const
+    {
+        for (std::size_t cellIdx = begin; cellIdx < end; ++cellIdx)
+            fn_(cellIdx);
+    }
+
+private:
+    CellFunction fn_;
+};
+
+/*!
+ * \brief Create a pipeline stage which calls 'fn(cellIdx)' for each cell of a block.
+ */
+template <class CellFunction>
+CellStage<CellFunction> makeCellStage(CellFunction fn)
+{ return CellStage<CellFunction>(std::move(fn)); }
+
+/*!
+ * \brief Runs several stages of the computation of the intensive quantities of the
+ *        cells block by block.
+ *
+ * Computing e.g. the PVT properties, the relative permeabilities and capillary
+ * pressures, and the heat conductivities of all cells in separate passes streams the
+ * state of every cell through the cache once per pass. Instead, this class splits the
+ * cells into blocks and runs all stages for one block before proceeding with the next
+ * one, so the quantities produced by one stage are usually still cached when the next
+ * stage reads them.
+ *
+ * The quantities of the cells are expected to be stored as separate arrays which are
+ * indexed by the cell ("structure of arrays"). Each stage is a callable object which
+ * is invoked as 'stage(begin, end)' and processes the cells [begin, end) by reading
+ * from and writing to these arrays. The stages of a block are called in the order in
+ * which they were passed, so later stages may use the results of earlier ones for the
+ * same cells. The blocks are distributed to the threads dynamically if OpenMP is
+ * enabled, i.e., stages must not write to the quantities of cells outside of their
+ * range. For example:
+ *
+ * \code
+ * auto pipeline =
+ *     Opm::makeCellBlockPipeline(256,
+ *                                Opm::makeCellStage([&](size_t i) { invBo[i] = oilPvt.inverseFormationVolumeFactor(regionIdx[i], T[i], p[i], Rs[i]); }),
+ *                                Opm::makeCellStage([&](size_t i) { krw[i] = MaterialLaw::twoPhaseSatKrw(params[i], Sw[i]); }));
+ * pipeline.run(numCells);
+ * \endcode
+ */
+template <class... Stages>
+class CellBlockPipeline
+{
+    typedef std::tuple<Stages...> StageTuple;
+    typedef CellBlockPipelineDetail::StageRunner<0, sizeof...(Stages)> Runner;
+
+public:
+    //! The number of stages of the pipeline
+    static const std::size_t numStages = sizeof...(Stages);
+
+    CellBlockPipeline(std::size_t blockSize, Stages... stages)
+        : stages_(std::move(stages)...)
+        , blockSize_(blockSize)
+    {
+        if (blockSize_ == 0)
+            OPM_THROW(std::invalid_argument, "The block size of a pipeline must be positive");
+    }
+
+    /*!
+     * \brief Returns the maximum number of cells which are processed by the stages at
+     *        once.
+     */
+    std::size_t blockSize() const
+    { return blockSize_; }
+
+    /*!
+     * \brief Returns the number of blocks into which a given number of cells is split.
+     */
+    std::size_t numBlocks(std::size_t numCells) const
+    { return (numCells + blockSize_ - 1)/blockSize_; }
+
+    /*!
+     * \brief Run all stages for the cells [0, numCells).
+     */
+    void run(std::size_t numCells) const
+    {
+        const int n = static_cast<int>(numBlocks(numCells));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int blockIdx = 0; blockIdx < n; ++blockIdx)
+            runBlock_(static_cast<std::size_t>(blockIdx), numCells);
+    }
+
+    /*!
+     * \brief Run all stages for the cells [0, numCells) using the calling thread only.
+     *
+     * This is useful if the pipeline is invoked from within a parallel region.
+     */
+    void runSerial(std::size_t numCells) const
+    {
+        const std::size_t n = numBlocks(numCells);
+        for (std::size_t blockIdx = 0; blockIdx < n; ++blockIdx)
+            runBlock_(blockIdx, numCells);
+    }
+
+private:
+    void runBlock_(std::size_t blockIdx, std::size_t numCells) const
+    {
+        const std::size_t begin = blockIdx*blockSize_;
+        const std::size_t end = std::min(begin + blockSize_, numCells);
+        Runner::run(stages_, begin, end);
+    }
+
+    StageTuple stages_;
+    std::size_t blockSize_;
+};
+
+/*!
+ * \brief Create a pipeline from a block size and a sequence of stages.
+ */
+template <class... Stages>
+CellBlockPipeline<Stages...> makeCellBlockPipeline(std::size_t blockSize, Stages... stages)
+{ return CellBlockPipeline<Stages...>(blockSize, std::move(stages)...); }
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,244 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::CellChangeDetector
+ */
+#ifndef OPM_CELL_CHANGE_DETECTOR_HPP
+#define OPM_CELL_CHANGE_DETECTOR_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <vector>
+#include <initializer_list>
+#include <cstddef>
+
+namespace Opm {
+
+/*!
+ * \brief The number of cells which were re-evaluated and skipped by the last call of
+ *        CellChangeDetector::update().
+ */
+struct CellChangeStatistics
+{
+    CellChangeStatistics()
+        : numEvaluated(0)
+        , numSkipped(0)
+    {}
+
+    size_t numEvaluated;
+    size_t numSkipped;
+};
+
+/*!
+ * \brief Determines the cells whose inputs did not change since the last evaluation.
+ *
+ * In the late Newton iterations and in the converged parts of a model, the primary
+ * variables of many cells stay the same between two evaluations of the constitutive
+ * relations. This class keeps a copy of the input arrays of a batched evaluation (e.g.,
+ * the pressures, temperatures and dissolution factors which are passed to
+ * Opm::PvtRegionBatch or the saturations which are passed to the
+ * EclMaterialLawManager) and compares them with the ones of the next call. The
+ * cells for which any input differs are marked as changed, all other ones can be
+ * skipped if the output arrays of the previous evaluation are reused:
+ *
+ * \code
+ * detector.update(numCells, {T.data(), p.data(), Rs.data()});
+ * batch.setCellMask(detector.changedMask());
+ * batch.inverseFormationVolumeFactor(oilPvt, T.data(), p.data(), Rs.data(), invBo.data());
+ *
+ * materialLawManager.relativePermeabilitiesOfElements(kr, S,
+ *                                                     detector.changedCells().data(),
+ *                                                     detector.changedCells().data()
+ *                                                     + detector.changedCells().size());
+ * \endcode
+ *
+ * By default, two inputs are only considered to be unchanged if their values and all
+ * their derivatives are identical. If a tolerance is specified, the relative difference
+ * of each of them must be below the tolerance instead. Note that each detector
+ * represents the inputs of a single output array: If the same arrays are evaluated for
+ * different output quantities, one detector can be shared, but it must only be updated
+ * once per evaluation.
+ *
+ * \tparam Evaluation The type of the inputs, i.e., a floating point type or a
+ *                    DenseAd::Evaluation
+ */
+template <class Evaluation>
+class CellChangeDetector
+{
+    typedef Opm::MathToolbox<Evaluation> Toolbox;
+    typedef typename Toolbox::Scalar Scalar;
+
+public:
+    CellChangeDetector()
+        : tolerance_(0.0)
+        , numInputs_(0)
+    {}
+
+    /*!
+     * \brief Set the relative tolerance below which an input is considered unchanged.
+     *
+     * A tolerance of zero means that the inputs must be identical.
+     */
+    void setTolerance(Scalar tolerance)
+    { tolerance_ = tolerance; }
+
+    /*!
+     * \brief Returns the relative tolerance below which an input is considered
+     *        unchanged.
+     */
+    Scalar tolerance() const
+    { return tolerance_; }
+
+    /*!
+     * \brief Forget the inputs of the previous evaluation.
+     *
+     * The next call of update() marks all cells as changed. This needs to be called if
+     * the output arrays were modified or if the evaluated relations changed, e.g., at
+     * the beginning of a time step if the hysteresis parameters were updated.
+     */
+    void reset()
+    {
+        previousInputs_.clear();
+        numInputs_ = 0;
+    }
+
+    /*!
+     * \brief Compare the inputs of all cells to the ones of the previous call.
+     *
+     * The current inputs are remembered for the next call. If the number of cells or
+     * the number of input arrays differs from the previous call, all cells are
+     * considered to be changed.
+     *
+     * \param numCells The number of cells, i.e., the size of each input array
+     * \param inputs The input arrays of the evaluation
+     */
+    const CellChangeStatistics& update(size_t numCells,
+                                       std::initializer_list<const Evaluation*> inputs)
+    { return update(numCells, inputs.begin(), inputs.size()); }
+
+    /*!
+     * \copydoc update(size_t, std::initializer_list<const Evaluation*>)
+     *
+     * \param numInputs The number of input arrays
+     */
+    const CellChangeStatistics& update(size_t numCells,
+                                       const Evaluation* const* inputs,
+                                       size_t numInputs)
+    {
+        bool havePrevious =
+            numInputs == numInputs_
+            && previousInputs_.size() == numCells*numInputs;
+
+        numInputs_ = numInputs;
+        previousInputs_.resize(numCells*numInputs);
+        changedMask_.resize(numCells);
+        changedCells_.clear();
+
+        for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            Evaluation* prev = &previousInputs_[cellIdx*numInputs];
+
+            bool changed = !havePrevious;
+            for (size_t inputIdx = 0; inputIdx < numInputs; ++inputIdx) {
+                const Evaluation& cur = inputs[inputIdx][cellIdx];
+                if (!changed && !isUnchanged_(prev[inputIdx], cur))
+                    changed = true;
+                prev[inputIdx] = cur;
+            }
+
+            changedMask_[cellIdx] = changed;
+            if (changed)
+                changedCells_.push_back(static_cast<unsigned>(cellIdx));
+        }
+
+        statistics_.numEvaluated = changedCells_.size();
+        statistics_.numSkipped = numCells - changedCells_.size();
+        return statistics_;
+    }
+
+    /*!
+     * \brief Returns true if the inputs of a cell changed during the last update().
+     */
+    bool changed(size_t cellIdx) const
+    { return changedMask_[cellIdx] != 0; }
+
+    /*!
+     * \brief Returns a flag for each cell which is non-zero if its inputs changed
+     *        during the last update().
+     */
+    const std::vector<unsigned char>& changedMask() const
+    { return changedMask_; }
+
+    /*!
+     * \brief Returns the indices of the cells whose inputs changed during the last
+     *        update() in ascending order.
+     */
+    const std::vector<unsigned>& changedCells() const
+    { return changedCells_; }
+
+    /*!
+     * \brief Returns the number of evaluated and skipped cells of the last update().
+     */
+    const CellChangeStatistics& statistics() const
+    { return statistics_; }
+
+private:
+    bool isUnchanged_(const Evaluation& a, const Evaluation& b) const
+    {
+        if (tolerance_ > 0.0)
+            return Toolbox::isSame(a, b, tolerance_);
+
+        return isIdentical_(a, b);
+    }
+
+    template <class T>
+    static bool isIdentical_(const T& a, const T& b)
+    {
+        if (Opm::MathToolbox<T>::value(a) != Opm::MathToolbox<T>::value(b))
+            return false;
+        return isIdenticalDerivatives_(a, b);
+    }
+
+    static bool isIdenticalDerivatives_(Scalar, Scalar)
+    { return true; }
+
+    template <class T>
+    static bool isIdenticalDerivatives_(const T& a, const T& b)
+    {
+        for (int varIdx = 0; varIdx < T::size; ++varIdx)
+            if (!isIdentical_(a.derivative(varIdx), b.derivative(varIdx)))
+                return false;
+        return true;
+    }
+
+    Scalar tolerance_;
+    size_t numInputs_;
+    std::vector<Evaluation> previousInputs_;
+    std::vector<unsigned char> changedMask_;
+    std::vector<unsigned> changedCells_;
+    CellChangeStatistics statistics_;
+};
+
+} // namespace Opm
+
+#endif
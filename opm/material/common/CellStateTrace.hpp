@@ -0,0 +1,200 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::CellStateTraceWriter
+ */
+#ifndef OPM_CELL_STATE_TRACE_HPP
+#define OPM_CELL_STATE_TRACE_HPP
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief The black-oil state of a single cell at the time at which the fluid and
+ *        saturation dependent properties of the cell were evaluated.
+ */
+struct CellStateRecord
+{
+    //! The oil phase pressure \f$\mathrm{[Pa]}\f$
+    double pressure;
+    //! The temperature \f$\mathrm{[K]}\f$
+    double temperature;
+    //! The gas dissolution factor of the oil phase \f$\mathrm{[m^3/m^3]}\f$
+    double Rs;
+    //! The oil vaporization factor of the gas phase \f$\mathrm{[m^3/m^3]}\f$
+    double Rv;
+    //! The saturation of the water phase \f$\mathrm{[-]}\f$
+    double Sw;
+    //! The saturation of the oil phase \f$\mathrm{[-]}\f$
+    double So;
+    //! The saturation of the gas phase \f$\mathrm{[-]}\f$
+    double Sg;
+    //! The index of the cell, see CellStateTraceWriter
+    std::uint32_t elemIdx;
+};
+
+namespace CellStateTraceDetail {
+inline const char* magic()
+{ return "OPMCST01"; }
+
+enum { magicLength = 8 };
+
+// the fields of a record in the order in which they are stored
+enum { numDoubleFields = 7 };
+enum { recordSize = numDoubleFields*sizeof(double) + sizeof(std::uint32_t) };
+} // namespace CellStateTraceDetail
+
+/*!
+ * \ingroup FluidSystems
+ *
+ * \brief Records the states of cells to a binary file so that the evaluation of the
+ *        fluid and saturation dependent properties can be replayed later.
+ *
+ * Such traces are intended to be captured from production simulation runs and to be
+ * replayed by benchmark programs. The file consists of
+ *
+ * - the 8 character identifier "OPMCST01" (without a terminating zero byte),
+ * - an unsigned 32 bit integer which specifies the size of a record in bytes (60
+ *   for this version of the format),
+ * - an arbitrary number of records until the end of the file.
+ *
+ * Each record stores the oil pressure, the temperature, Rs, Rv, Sw, So and Sg of the
+ * cell as 64 bit IEEE doubles, followed by the index of the cell as an unsigned 32
+ * bit integer. (See Opm::CellStateRecord for the units.) There is no padding between
+ * the fields or the records and all numbers use the byte order of the machine which
+ * wrote the file, i.e., little endian on x86.
+ *
+ * The cell index is the index of the cell within the active cells of the deck's grid
+ * in the order of the Cartesian (natural) indices; that is the "compressed" index
+ * which is also used by Opm::EclMaterialLawManager. Records are replayed in the order
+ * in which they were written, so the trace should be written in the order in which
+ * the simulator evaluated the cells.
+ */
+class CellStateTraceWriter
+{
+public:
+    /*!
+     * \brief Create a trace file and write its header.
+     *
+     * An existing file of the same name is overwritten.
+     */
+    explicit CellStateTraceWriter(const std::string& fileName)
+        : file_(fileName.c_str(), std::ios::binary)
+    {
+        if (!file_)
+            OPM_THROW(std::runtime_error,
+                      "Could not open file '" << fileName << "' for writing the cell state trace");
+
+        std::uint32_t recordSize = CellStateTraceDetail::recordSize;
+        file_.write(CellStateTraceDetail::magic(), CellStateTraceDetail::magicLength);
+        file_.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+    }
+
+    /*!
+     * \brief Append the state of a cell to the trace.
+     */
+    void write(const CellStateRecord& record)
+    {
+        const double values[CellStateTraceDetail::numDoubleFields] = {
+            record.pressure, record.temperature, record.Rs, record.Rv,
+            record.Sw, record.So, record.Sg
+        };
+        file_.write(reinterpret_cast<const char*>(values), sizeof(values));
+        file_.write(reinterpret_cast<const char*>(&record.elemIdx), sizeof(record.elemIdx));
+
+        if (!file_)
+            OPM_THROW(std::runtime_error, "Could not write to the cell state trace");
+    }
+
+    /*!
+     * \brief Write all buffered records to the file.
+     */
+    void flush()
+    { file_.flush(); }
+
+private:
+    std::ofstream file_;
+};
+
+/*!
+ * \ingroup FluidSystems
+ *
+ * \brief Read all records of a trace file which was written by
+ *        Opm::CellStateTraceWriter.
+ */
+inline std::vector<CellStateRecord> readCellStateTrace(const std::string& fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    if (!file)
+        OPM_THROW(std::runtime_error,
+                  "Could not open the cell state trace '" << fileName << "'");
+
+    char magic[CellStateTraceDetail::magicLength];
+    std::uint32_t recordSize = 0;
+    file.read(magic, CellStateTraceDetail::magicLength);
+    file.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+    if (!file
+        || std::strncmp(magic, CellStateTraceDetail::magic(), CellStateTraceDetail::magicLength) != 0
+        || recordSize != CellStateTraceDetail::recordSize)
+        OPM_THROW(std::runtime_error,
+                  "File '" << fileName << "' does not contain a cell state trace");
+
+    std::vector<CellStateRecord> records;
+    while (true) {
+        double values[CellStateTraceDetail::numDoubleFields];
+        std::uint32_t elemIdx;
+        file.read(reinterpret_cast<char*>(values), sizeof(values));
+        if (file.gcount() == 0 && file.eof())
+            break;
+        file.read(reinterpret_cast<char*>(&elemIdx), sizeof(elemIdx));
+        if (!file)
+            OPM_THROW(std::runtime_error,
+                      "The cell state trace '" << fileName << "' is truncated");
+
+        CellStateRecord record;
+        record.pressure = values[0];
+        record.temperature = values[1];
+        record.Rs = values[2];
+        record.Rv = values[3];
+        record.Sw = values[4];
+        record.So = values[5];
+        record.Sg = values[6];
+        record.elemIdx = elemIdx;
+        records.push_back(record);
+    }
+
+    return records;
+}
+
+} // namespace Opm
+
+#endif
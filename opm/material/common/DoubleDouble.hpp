@@ -0,0 +1,964 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This file provides a floating point type which represents values by the
+ *        unevaluated sum of two double precision values.
+ *
+ * Such "double-double" values exhibit about 106 bits of mantissa, i.e., roughly 31
+ * decimal digits. In contrast to the quadruple precision type of quad.hpp, all
+ * operations are composed of a few hardware double precision operations, so
+ * instantiating the material laws with Opm::DoubleDouble as the Scalar type is much
+ * faster than using the software emulated __float128 type. This makes it suitable for
+ * regression tests which verify the precision of the double precision code. The
+ * exponent range is the one of double precision values, though.
+ *
+ * Like for the quad type, the type traits of the standard library are specialized
+ * so that Opm::DoubleDouble is considered to be a primitive floating point type and
+ * the usual mathematical functions are provided in the std namespace. As a result,
+ * the generic Opm::MathToolbox and the automatic differentiation code can be used
+ * with it.
+ *
+ * Note that the error-free transformations which this type is based on require
+ * IEEE compliant rounding, i.e., code which uses it must not be compiled with
+ * -ffast-math or similar options.
+ */
+#ifndef OPM_COMMON_DOUBLE_DOUBLE_HPP
+#define OPM_COMMON_DOUBLE_DOUBLE_HPP
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief A floating point value which is represented by the unevaluated sum of two
+ *        double precision values.
+ *
+ * The high part is the value rounded to double precision, the low part is the
+ * rounding error, i.e., |lo| is at most half a unit in the last place of hi.
+ */
+class DoubleDouble
+{
+public:
+    // the value is uninitialized like for the primitive floating point types
+    DoubleDouble() = default;
+
+    /*!
+     * \brief Create a value from a double precision value.
+     */
+    constexpr DoubleDouble(double value)
+        : hi_(value)
+        , lo_(0.0)
+    {}
+
+    /*!
+     * \brief Create a value from its high and low parts.
+     *
+     * The parts must not overlap, i.e., hi + lo must be hi if evaluated in double
+     * precision.
+     */
+    constexpr DoubleDouble(double hi, double lo)
+        : hi_(hi)
+        , lo_(lo)
+    {}
+
+    /*!
+     * \brief Returns the value rounded to double precision.
+     */
+    constexpr double hi() const
+    { return hi_; }
+
+    /*!
+     * \brief Returns the rounding error of hi().
+     */
+    constexpr double lo() const
+    { return lo_; }
+
+    explicit operator double() const
+    { return hi_; }
+
+    explicit operator float() const
+    { return static_cast<float>(hi_); }
+
+    DoubleDouble operator-() const
+    { return DoubleDouble(-hi_, -lo_); }
+
+    DoubleDouble operator+() const
+    { return *this; }
+
+    DoubleDouble& operator+=(const DoubleDouble& other);
+    DoubleDouble& operator-=(const DoubleDouble& other);
+    DoubleDouble& operator*=(const DoubleDouble& other);
+    DoubleDouble& operator/=(const DoubleDouble& other);
+
+    DoubleDouble& operator+=(double other);
+    DoubleDouble& operator-=(double other);
+    DoubleDouble& operator*=(double other);
+    DoubleDouble& operator/=(double other);
+
+private:
+    double hi_;
+    double lo_;
+};
+
+namespace DoubleDoubleDetail {
+// the error-free transformations. all of them return the rounded result of an
+// operation and store its rounding error in 'err'
+
+// s + err = a + b exactly
+inline double twoSum(double a, double b, double& err)
+{
+    double s = a + b;
+    double bb = s - a;
+    err = (a - (s - bb)) + (b - bb);
+    return s;
+}
+
+// s + err = a + b exactly, requires |a| >= |b| or a == 0
+inline double quickTwoSum(double a, double b, double& err)
+{
+    double s = a + b;
+    err = b - (s - a);
+    return s;
+}
+
+#ifndef FP_FAST_FMA
+// split a double precision value into two non-overlapping halves of 26 bits each
+inline void split(double a, double& hi, double& lo)
+{
+    // 2^27 + 1
+    const double splitter = 134217729.0;
+    // values above this threshold would overflow the multiplication by the splitter
+    const double threshold = 6.69692879491417e+299;
+    if (a > threshold || a < -threshold) {
+        a *= 3.7252902984619140625e-09; // 2^-28
+        double t = splitter*a;
+        hi = t - (t - a);
+        lo = a - hi;
+        hi *= 268435456.0; // 2^28
+        lo *= 268435456.0;
+    }
+    else {
+        double t = splitter*a;
+        hi = t - (t - a);
+        lo = a - hi;
+    }
+}
+#endif
+
+// p + err = a*b exactly
+inline double twoProd(double a, double b, double& err)
+{
+    double p = a*b;
+#ifdef FP_FAST_FMA
+    err = std::fma(a, b, -p);
+#else
+    // Dekker's algorithm. without a fast fused multiply-add instruction, the
+    // compiler cannot contract the operations either
+    double aHi, aLo, bHi, bLo;
+    split(a, aHi, aLo);
+    split(b, bHi, bLo);
+    err = ((aHi*bHi - p) + aHi*bLo + aLo*bHi) + aLo*bLo;
+#endif
+    return p;
+}
+
+inline constexpr DoubleDouble ln2()
+{ return DoubleDouble(6.931471805599453e-01, 2.3190468138462996e-17); }
+
+inline constexpr DoubleDouble pi()
+{ return DoubleDouble(3.141592653589793e+00, 1.2246467991473532e-16); }
+
+inline constexpr DoubleDouble halfPi()
+{ return DoubleDouble(1.5707963267948966e+00, 6.123233995736766e-17); }
+
+// the number of decimal digits which are required to represent all values
+inline constexpr int maxDigits10()
+{ return 33; }
+
+// the relative precision up to which the series expansions are evaluated
+inline constexpr double seriesEpsilon()
+{ return 4.930380657631324e-32; }
+} // namespace DoubleDoubleDetail
+
+////////////
+// arithmetic operators
+////////////
+
+inline DoubleDouble operator+(const DoubleDouble& a, const DoubleDouble& b)
+{
+    using namespace DoubleDoubleDetail;
+
+    double s2, t2;
+    double s1 = twoSum(a.hi(), b.hi(), s2);
+    if (!std::isfinite(s1))
+        return s1;
+    double t1 = twoSum(a.lo(), b.lo(), t2);
+    s2 += t1;
+    s1 = quickTwoSum(s1, s2, s2);
+    s2 += t2;
+    s1 = quickTwoSum(s1, s2, s2);
+    return DoubleDouble(s1, s2);
+}
+
+inline DoubleDouble operator+(const DoubleDouble& a, double b)
+{
+    using namespace DoubleDoubleDetail;
+
+    double s2;
+    double s1 = twoSum(a.hi(), b, s2);
+    if (!std::isfinite(s1))
+        return s1;
+    s2 += a.lo();
+    s1 = quickTwoSum(s1, s2, s2);
+    return DoubleDouble(s1, s2);
+}
+
+inline DoubleDouble operator+(double a, const DoubleDouble& b)
+{ return b + a; }
+
+inline DoubleDouble operator-(const DoubleDouble& a, const DoubleDouble& b)
+{ return a + (-b); }
+
+inline DoubleDouble operator-(const DoubleDouble& a, double b)
+{ return a + (-b); }
+
+inline DoubleDouble operator-(double a, const DoubleDouble& b)
+{ return (-b) + a; }
+
+inline DoubleDouble operator*(const DoubleDouble& a, const DoubleDouble& b)
+{
+    using namespace DoubleDoubleDetail;
+
+    double p2;
+    double p1 = twoProd(a.hi(), b.hi(), p2);
+    if (!std::isfinite(p1))
+        return p1;
+    p2 += a.hi()*b.lo() + a.lo()*b.hi();
+    p1 = quickTwoSum(p1, p2, p2);
+    return DoubleDouble(p1, p2);
+}
+
+inline DoubleDouble operator*(const DoubleDouble& a, double b)
+{
+    using namespace DoubleDoubleDetail;
+
+    double p2;
+    double p1 = twoProd(a.hi(), b, p2);
+    if (!std::isfinite(p1))
+        return p1;
+    p2 += a.lo()*b;
+    p1 = quickTwoSum(p1, p2, p2);
+    return DoubleDouble(p1, p2);
+}
+
+inline DoubleDouble operator*(double a, const DoubleDouble& b)
+{ return b*a; }
+
+inline DoubleDouble operator/(const DoubleDouble& a, const DoubleDouble& b)
+{
+    using namespace DoubleDoubleDetail;
+
+    // long division: each quotient of the high parts adds about 53 bits
+    double q1 = a.hi()/b.hi();
+    if (!std::isfinite(q1))
+        return q1;
+    DoubleDouble r = a - b*q1;
+    double q2 = r.hi()/b.hi();
+    r -= b*q2;
+    double q3 = r.hi()/b.hi();
+    q1 = quickTwoSum(q1, q2, q2);
+    return DoubleDouble(q1, q2) + q3;
+}
+
+inline DoubleDouble operator/(const DoubleDouble& a, double b)
+{
+    using namespace DoubleDoubleDetail;
+
+    double q1 = a.hi()/b;
+    if (!std::isfinite(q1))
+        return q1;
+
+    // compute the remainder a - q1*b
+    double p2, e;
+    double p1 = twoProd(q1, b, p2);
+    double s = twoSum(a.hi(), -p1, e);
+    e += a.lo();
+    e -= p2;
+
+    double q2 = (s + e)/b;
+    q1 = quickTwoSum(q1, q2, q2);
+    return DoubleDouble(q1, q2);
+}
+
+inline DoubleDouble operator/(double a, const DoubleDouble& b)
+{ return DoubleDouble(a)/b; }
+
+inline DoubleDouble& DoubleDouble::operator+=(const DoubleDouble& other)
+{ return *this = *this + other; }
+
+inline DoubleDouble& DoubleDouble::operator-=(const DoubleDouble& other)
+{ return *this = *this - other; }
+
+inline DoubleDouble& DoubleDouble::operator*=(const DoubleDouble& other)
+{ return *this = *this * other; }
+
+inline DoubleDouble& DoubleDouble::operator/=(const DoubleDouble& other)
+{ return *this = *this / other; }
+
+inline DoubleDouble& DoubleDouble::operator+=(double other)
+{ return *this = *this + other; }
+
+inline DoubleDouble& DoubleDouble::operator-=(double other)
+{ return *this = *this - other; }
+
+inline DoubleDouble& DoubleDouble::operator*=(double other)
+{ return *this = *this * other; }
+
+inline DoubleDouble& DoubleDouble::operator/=(double other)
+{ return *this = *this / other; }
+
+////////////
+// comparison operators
+////////////
+
+inline bool operator==(const DoubleDouble& a, const DoubleDouble& b)
+{ return a.hi() == b.hi() && a.lo() == b.lo(); }
+
+inline bool operator==(const DoubleDouble& a, double b)
+{ return a.hi() == b && a.lo() == 0.0; }
+
+inline bool operator==(double a, const DoubleDouble& b)
+{ return b == a; }
+
+inline bool operator!=(const DoubleDouble& a, const DoubleDouble& b)
+{ return !(a == b); }
+
+inline bool operator!=(const DoubleDouble& a, double b)
+{ return !(a == b); }
+
+inline bool operator!=(double a, const DoubleDouble& b)
+{ return !(a == b); }
+
+inline bool operator<(const DoubleDouble& a, const DoubleDouble& b)
+{ return a.hi() < b.hi() || (a.hi() == b.hi() && a.lo() < b.lo()); }
+
+inline bool operator<(const DoubleDouble& a, double b)
+{ return a.hi() < b || (a.hi() == b && a.lo() < 0.0); }
+
+inline bool operator<(double a, const DoubleDouble& b)
+{ return a < b.hi() || (a == b.hi() && 0.0 < b.lo()); }
+
+inline bool operator>(const DoubleDouble& a, const DoubleDouble& b)
+{ return b < a; }
+
+inline bool operator>(const DoubleDouble& a, double b)
+{ return b < a; }
+
+inline bool operator>(double a, const DoubleDouble& b)
+{ return b < a; }
+
+inline bool operator<=(const DoubleDouble& a, const DoubleDouble& b)
+{ return a.hi() < b.hi() || (a.hi() == b.hi() && a.lo() <= b.lo()); }
+
+inline bool operator<=(const DoubleDouble& a, double b)
+{ return a.hi() < b || (a.hi() == b && a.lo() <= 0.0); }
+
+inline bool operator<=(double a, const DoubleDouble& b)
+{ return a < b.hi() || (a == b.hi() && 0.0 <= b.lo()); }
+
+inline bool operator>=(const DoubleDouble& a, const DoubleDouble& b)
+{ return b <= a; }
+
+inline bool operator>=(const DoubleDouble& a, double b)
+{ return b <= a; }
+
+inline bool operator>=(double a, const DoubleDouble& b)
+{ return b <= a; }
+
+////////////
+// mathematical functions. the std namespace variants below forward to these.
+////////////
+
+namespace DoubleDoubleDetail {
+inline DoubleDouble abs(const DoubleDouble& a)
+{ return (a.hi() < 0.0) ? -a : a; }
+
+inline DoubleDouble floor(const DoubleDouble& a)
+{
+    double hi = std::floor(a.hi());
+    double lo = 0.0;
+    if (hi == a.hi()) {
+        // the high part is an integer, so the fractional digits are in the low part
+        lo = std::floor(a.lo());
+        hi = quickTwoSum(hi, lo, lo);
+    }
+    return DoubleDouble(hi, lo);
+}
+
+inline DoubleDouble ceil(const DoubleDouble& a)
+{
+    double hi = std::ceil(a.hi());
+    double lo = 0.0;
+    if (hi == a.hi()) {
+        lo = std::ceil(a.lo());
+        hi = quickTwoSum(hi, lo, lo);
+    }
+    return DoubleDouble(hi, lo);
+}
+
+// rounds half-way cases away from zero like std::round()
+inline DoubleDouble round(const DoubleDouble& a)
+{
+    if (a.hi() < 0.0)
+        return -floor(-a + 0.5);
+    return floor(a + 0.5);
+}
+
+// multiplication by an integral power of two, which is exact
+inline DoubleDouble ldexp(const DoubleDouble& a, int exp)
+{ return DoubleDouble(std::ldexp(a.hi(), exp), std::ldexp(a.lo(), exp)); }
+
+inline DoubleDouble sqrt(const DoubleDouble& a)
+{
+    if (a.hi() == 0.0)
+        return a.hi();
+    if (a.hi() < 0.0)
+        return std::numeric_limits<double>::quiet_NaN();
+    if (!std::isfinite(a.hi()))
+        return a.hi();
+
+    // one Newton step for the inverse square root starting with the double precision
+    // value (Karp's trick), i.e., sqrt(a) ~ a*x + (a - (a*x)^2)*x/2 with x = 1/sqrt(a)
+    double x = 1.0/std::sqrt(a.hi());
+    double ax = a.hi()*x;
+    double ax2Err;
+    double ax2 = twoProd(ax, ax, ax2Err);
+    DoubleDouble residual = a - DoubleDouble(ax2, ax2Err);
+    double lo;
+    double hi = twoSum(ax, residual.hi()*x*0.5, lo);
+    return DoubleDouble(hi, lo);
+}
+
+// integral power by repeated squaring
+inline DoubleDouble powi(const DoubleDouble& base, long exp)
+{
+    DoubleDouble result = 1.0;
+    DoubleDouble factor = base;
+    unsigned long n = (exp < 0) ? static_cast<unsigned long>(-exp) : static_cast<unsigned long>(exp);
+    while (n > 0) {
+        if (n & 1)
+            result *= factor;
+        n >>= 1;
+        if (n > 0)
+            factor *= factor;
+    }
+    return (exp < 0) ? 1.0/result : result;
+}
+
+inline DoubleDouble exp(const DoubleDouble& a)
+{
+    // 709 is slightly below log(max())
+    if (std::isnan(a.hi()))
+        return a;
+    if (a.hi() <= -709.0)
+        return 0.0;
+    if (a.hi() >= 709.0)
+        return std::numeric_limits<double>::infinity();
+    if (a.hi() == 0.0)
+        return 1.0;
+
+    // reduce the argument to |r| <= ln(2)/2/512, i.e., exp(a) = 2^m*exp(r)^512
+    const int numSquarings = 9;
+    const double invK = 1.0/512.0;
+    double m = std::floor(a.hi()/ln2().hi() + 0.5);
+    DoubleDouble r = ldexp(a - ln2()*m, -numSquarings);
+
+    // Taylor series of exp(r) - 1
+    DoubleDouble s = r;
+    DoubleDouble term = r;
+    for (int n = 2; n < 20; ++n) {
+        term = term*r/static_cast<double>(n);
+        s += term;
+        if (std::abs(term.hi()) <= seriesEpsilon()*invK)
+            break;
+    }
+
+    // undo the division by 512: (1 + s)^2 - 1 = 2s + s^2
+    for (int i = 0; i < numSquarings; ++i)
+        s = ldexp(s, 1) + s*s;
+
+    return ldexp(s + 1.0, static_cast<int>(m));
+}
+
+inline DoubleDouble log(const DoubleDouble& a)
+{
+    if (std::isnan(a.hi()))
+        return a;
+    if (a.hi() == 0.0)
+        return -std::numeric_limits<double>::infinity();
+    if (a.hi() < 0.0)
+        return std::numeric_limits<double>::quiet_NaN();
+    if (!std::isfinite(a.hi()))
+        return a.hi();
+
+    // one Newton step for exp(x) - a = 0, i.e., x = x + a*exp(-x) - 1, which doubles
+    // the number of correct digits of the double precision value
+    DoubleDouble x = std::log(a.hi());
+    return x + a*exp(-x) - 1.0;
+}
+
+inline DoubleDouble pow(const DoubleDouble& base, const DoubleDouble& exp)
+{
+    // integral exponents are handled exactly like by std::pow(), in particular for
+    // negative bases
+    if (floor(exp) == exp && std::abs(exp.hi()) < 2147483648.0)
+        return powi(base, static_cast<long>(exp.hi()));
+
+    if (base.hi() == 0.0)
+        return (exp.hi() > 0.0) ? 0.0 : std::numeric_limits<double>::infinity();
+
+    return DoubleDoubleDetail::exp(exp*log(base));
+}
+
+// computes the sine and the cosine of an argument at the same time
+inline void sincos(const DoubleDouble& a, DoubleDouble& sinA, DoubleDouble& cosA)
+{
+    if (!std::isfinite(a.hi())) {
+        sinA = cosA = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+
+    // reduce the argument to |r| <= pi/4. this looses precision for very large
+    // arguments, which do not occur in the material laws, though.
+    double k = std::floor(a.hi()/halfPi().hi() + 0.5);
+    DoubleDouble r = a - halfPi()*k;
+
+    // Taylor series of the sine and the cosine
+    DoubleDouble r2 = r*r;
+    DoubleDouble s = r;
+    DoubleDouble c = 1.0;
+    DoubleDouble sinTerm = r;
+    DoubleDouble cosTerm = 1.0;
+    for (int n = 1; n < 20; ++n) {
+        cosTerm = -cosTerm*r2/static_cast<double>((2*n - 1)*(2*n));
+        sinTerm = -sinTerm*r2/static_cast<double>((2*n)*(2*n + 1));
+        c += cosTerm;
+        s += sinTerm;
+        if (std::abs(cosTerm.hi()) <= seriesEpsilon())
+            break;
+    }
+
+    // undo the argument reduction
+    switch (static_cast<int>(k - 4.0*std::floor(k/4.0))) {
+    case 0: sinA = s; cosA = c; break;
+    case 1: sinA = c; cosA = -s; break;
+    case 2: sinA = -s; cosA = -c; break;
+    default: sinA = -c; cosA = s; break;
+    }
+}
+
+inline DoubleDouble sin(const DoubleDouble& a)
+{
+    DoubleDouble s, c;
+    sincos(a, s, c);
+    return s;
+}
+
+inline DoubleDouble cos(const DoubleDouble& a)
+{
+    DoubleDouble s, c;
+    sincos(a, s, c);
+    return c;
+}
+
+inline DoubleDouble tan(const DoubleDouble& a)
+{
+    DoubleDouble s, c;
+    sincos(a, s, c);
+    return s/c;
+}
+
+inline DoubleDouble atan2(const DoubleDouble& y, const DoubleDouble& x)
+{
+    if (std::isnan(x.hi()) || std::isnan(y.hi()))
+        return std::numeric_limits<double>::quiet_NaN();
+    if (!std::isfinite(x.hi()) || !std::isfinite(y.hi()))
+        return std::atan2(y.hi(), x.hi());
+    if (x.hi() == 0.0) {
+        if (y.hi() == 0.0)
+            return std::atan2(y.hi(), x.hi());
+        return (y.hi() > 0.0) ? halfPi() : -halfPi();
+    }
+    if (y.hi() == 0.0)
+        return (x.hi() > 0.0) ? DoubleDouble(y.hi()) : std::copysign(1.0, y.hi())*pi();
+
+    // one Newton step starting at the double precision result. the point (x, y) is
+    // normalized to the unit circle, so z is corrected by comparing (cos z, sin z) to
+    // it
+    DoubleDouble r = sqrt(x*x + y*y);
+    DoubleDouble xx = x/r;
+    DoubleDouble yy = y/r;
+    DoubleDouble z = std::atan2(y.hi(), x.hi());
+    DoubleDouble sinZ, cosZ;
+    sincos(z, sinZ, cosZ);
+    if (std::abs(xx.hi()) > std::abs(yy.hi()))
+        return z + (yy - sinZ)/cosZ;
+    return z - (xx - cosZ)/sinZ;
+}
+
+inline DoubleDouble atan(const DoubleDouble& a)
+{ return atan2(a, DoubleDouble(1.0)); }
+
+inline DoubleDouble asin(const DoubleDouble& a)
+{
+    if (abs(a) > 1.0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return atan2(a, sqrt(1.0 - a*a));
+}
+
+inline DoubleDouble acos(const DoubleDouble& a)
+{
+    if (abs(a) > 1.0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return atan2(sqrt(1.0 - a*a), a);
+}
+
+// converts a value into a string in scientific notation with the given number of
+// significant digits
+inline std::string toString(const DoubleDouble& a, int numDigits)
+{
+    if (!std::isfinite(a.hi()) || a.hi() == 0.0)
+        return std::to_string(a.hi());
+
+    std::string result;
+    DoubleDouble r = a;
+    if (r.hi() < 0.0) {
+        result += '-';
+        r = -r;
+    }
+
+    // scale the value to [1, 10)
+    int exp10 = static_cast<int>(std::floor(std::log10(r.hi())));
+    r /= powi(DoubleDouble(10.0), exp10);
+    if (r >= 10.0) {
+        r /= 10.0;
+        ++exp10;
+    }
+    else if (r < 1.0) {
+        r *= 10.0;
+        --exp10;
+    }
+
+    // extract one more digit than requested for the rounding
+    numDigits = std::max(1, std::min(numDigits, maxDigits10()));
+    std::vector<int> digits(numDigits + 1);
+    for (int i = 0; i <= numDigits; ++i) {
+        int d = static_cast<int>(std::floor(r.hi()));
+        DoubleDouble fraction = r - static_cast<double>(d);
+        if (fraction.hi() < 0.0) {
+            --d;
+            fraction += 1.0;
+        }
+        digits[i] = std::max(0, std::min(9, d));
+        r = fraction*10.0;
+    }
+
+    // round to nearest
+    if (digits[numDigits] >= 5) {
+        int i = numDigits - 1;
+        for (; i >= 0 && digits[i] == 9; --i)
+            digits[i] = 0;
+        if (i >= 0)
+            ++digits[i];
+        else {
+            digits[0] = 1;
+            ++exp10;
+        }
+    }
+
+    result += static_cast<char>('0' + digits[0]);
+    if (numDigits > 1) {
+        result += '.';
+        for (int i = 1; i < numDigits; ++i)
+            result += static_cast<char>('0' + digits[i]);
+    }
+    result += 'e';
+    result += (exp10 < 0) ? '-' : '+';
+    std::string expString = std::to_string(std::abs(exp10));
+    if (expString.size() < 2)
+        result += '0';
+    result += expString;
+    return result;
+}
+
+// converts a string in decimal fixed point or scientific notation to a value.
+// returns false if the string does not represent a finite number.
+inline bool fromString(const std::string& str, DoubleDouble& result)
+{
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < str.size() && (str[pos] == '-' || str[pos] == '+'))
+        negative = (str[pos++] == '-');
+
+    // the value of all mantissa digits and the position of the decimal point
+    DoubleDouble mantissa = 0.0;
+    int exp10 = 0;
+    bool haveDigits = false;
+    bool afterPoint = false;
+    for (; pos < str.size(); ++pos) {
+        char c = str[pos];
+        if (c >= '0' && c <= '9') {
+            mantissa = mantissa*10.0 + static_cast<double>(c - '0');
+            if (afterPoint)
+                --exp10;
+            haveDigits = true;
+        }
+        else if (c == '.' && !afterPoint)
+            afterPoint = true;
+        else
+            break;
+    }
+    if (!haveDigits)
+        return false;
+
+    if (pos < str.size() && (str[pos] == 'e' || str[pos] == 'E')) {
+        char* end;
+        long exp = std::strtol(str.c_str() + pos + 1, &end, 10);
+        if (end == str.c_str() + pos + 1)
+            return false;
+        exp10 += static_cast<int>(exp);
+        pos = static_cast<size_t>(end - str.c_str());
+    }
+    if (pos != str.size())
+        return false;
+
+    result = (exp10 < 0) ? mantissa/powi(DoubleDouble(10.0), -exp10) : mantissa*powi(DoubleDouble(10.0), exp10);
+    if (negative)
+        result = -result;
+    return true;
+}
+} // namespace DoubleDoubleDetail
+
+/*!
+ * \brief Print a value.
+ *
+ * If the precision of the stream exceeds the one of double precision values, the
+ * value is printed in scientific notation using all requested digits.
+ */
+inline std::ostream& operator<<(std::ostream& os, const DoubleDouble& value)
+{
+    if (os.precision() <= std::numeric_limits<double>::digits10
+        || value.hi() == 0.0
+        || !std::isfinite(value.hi()))
+        return os << value.hi();
+
+    return os << DoubleDoubleDetail::toString(value, static_cast<int>(os.precision()));
+}
+
+/*!
+ * \brief Read a value in decimal notation using full precision.
+ */
+inline std::istream& operator>>(std::istream& is, DoubleDouble& value)
+{
+    std::string token;
+    if (!(is >> token))
+        return is;
+
+    if (!DoubleDoubleDetail::fromString(token, value)) {
+        // infinities and NaNs
+        char* end;
+        double tmp = std::strtod(token.c_str(), &end);
+        if (end != token.c_str() + token.size())
+            is.setstate(std::ios::failbit);
+        else
+            value = tmp;
+    }
+    return is;
+}
+
+} // namespace Opm
+
+namespace std {
+
+// provide the numeric limits for the double-double type
+template <>
+class numeric_limits<Opm::DoubleDouble>
+{
+public:
+    static constexpr bool is_specialized = true;
+
+    static constexpr Opm::DoubleDouble min() throw()
+    { return 2.004168360008973e-292; }
+    static constexpr Opm::DoubleDouble max() throw()
+    { return Opm::DoubleDouble(1.7976931348623157e+308, 9.979201547673598e+291); }
+    static constexpr Opm::DoubleDouble lowest() throw()
+    { return Opm::DoubleDouble(-1.7976931348623157e+308, -9.979201547673598e+291); }
+
+    // number of bits in mantissa
+    static constexpr int digits = 2*numeric_limits<double>::digits;
+    // number of decimal digits
+    static constexpr int digits10 = 31;
+    static constexpr int max_digits10 = Opm::DoubleDoubleDetail::maxDigits10();
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr int radix = 2;
+    static constexpr Opm::DoubleDouble epsilon() throw()
+    { return 4.930380657631324e-32; }
+    static constexpr Opm::DoubleDouble round_error() throw()
+    { return 0.5; }
+
+    // the low part must be representable as a normalized double
+    static constexpr int min_exponent = numeric_limits<double>::min_exponent + numeric_limits<double>::digits;
+    static constexpr int min_exponent10 = -291;
+    static constexpr int max_exponent = numeric_limits<double>::max_exponent;
+    static constexpr int max_exponent10 = numeric_limits<double>::max_exponent10;
+
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr float_denorm_style has_denorm = denorm_absent;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr Opm::DoubleDouble infinity() throw()
+    { return numeric_limits<double>::infinity(); }
+    static constexpr Opm::DoubleDouble quiet_NaN() throw()
+    { return numeric_limits<double>::quiet_NaN(); }
+    static constexpr Opm::DoubleDouble signaling_NaN() throw()
+    { return numeric_limits<double>::signaling_NaN(); }
+    static constexpr Opm::DoubleDouble denorm_min() throw()
+    { return min(); }
+
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+
+    static constexpr bool traps = numeric_limits<double>::traps;
+    static constexpr bool tinyness_before = numeric_limits<double>::tinyness_before;
+    static constexpr float_round_style round_style = round_to_nearest;
+};
+
+// the double-double type is considered to be a primitive floating point type
+template <>
+struct is_floating_point<Opm::DoubleDouble>
+    : public integral_constant<bool, true>
+{};
+
+template <>
+struct is_arithmetic<Opm::DoubleDouble>
+    : public integral_constant<bool, true>
+{};
+
+template <>
+struct is_signed<Opm::DoubleDouble>
+    : public integral_constant<bool, true>
+{};
+
+inline Opm::DoubleDouble abs(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::abs(val); }
+
+inline Opm::DoubleDouble fabs(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::abs(val); }
+
+inline Opm::DoubleDouble floor(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::floor(val); }
+
+inline Opm::DoubleDouble ceil(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::ceil(val); }
+
+inline Opm::DoubleDouble round(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::round(val); }
+
+inline Opm::DoubleDouble max(const Opm::DoubleDouble& a, const Opm::DoubleDouble& b)
+{ return (a > b) ? a : b; }
+
+inline Opm::DoubleDouble min(const Opm::DoubleDouble& a, const Opm::DoubleDouble& b)
+{ return (a < b) ? a : b; }
+
+inline Opm::DoubleDouble sqrt(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::sqrt(val); }
+
+inline Opm::DoubleDouble pow(const Opm::DoubleDouble& base, const Opm::DoubleDouble& exp)
+{ return Opm::DoubleDoubleDetail::pow(base, exp); }
+
+inline Opm::DoubleDouble pow(const Opm::DoubleDouble& base, double exp)
+{ return Opm::DoubleDoubleDetail::pow(base, exp); }
+
+inline Opm::DoubleDouble pow(double base, const Opm::DoubleDouble& exp)
+{ return Opm::DoubleDoubleDetail::pow(base, exp); }
+
+inline Opm::DoubleDouble pow(const Opm::DoubleDouble& base, int exp)
+{ return Opm::DoubleDoubleDetail::powi(base, exp); }
+
+inline Opm::DoubleDouble exp(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::exp(val); }
+
+inline Opm::DoubleDouble log(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::log(val); }
+
+inline Opm::DoubleDouble log10(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::log(val)/Opm::DoubleDoubleDetail::log(Opm::DoubleDouble(10.0)); }
+
+inline Opm::DoubleDouble sin(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::sin(val); }
+
+inline Opm::DoubleDouble cos(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::cos(val); }
+
+inline Opm::DoubleDouble tan(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::tan(val); }
+
+inline Opm::DoubleDouble asin(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::asin(val); }
+
+inline Opm::DoubleDouble acos(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::acos(val); }
+
+inline Opm::DoubleDouble atan(const Opm::DoubleDouble& val)
+{ return Opm::DoubleDoubleDetail::atan(val); }
+
+inline Opm::DoubleDouble atan2(const Opm::DoubleDouble& a, const Opm::DoubleDouble& b)
+{ return Opm::DoubleDoubleDetail::atan2(a, b); }
+
+inline Opm::DoubleDouble ldexp(const Opm::DoubleDouble& val, int exp)
+{ return Opm::DoubleDoubleDetail::ldexp(val, exp); }
+
+inline bool isfinite(const Opm::DoubleDouble& val)
+{ return std::isfinite(val.hi()); }
+
+inline bool isnan(const Opm::DoubleDouble& val)
+{ return std::isnan(val.hi()); }
+
+inline bool isinf(const Opm::DoubleDouble& val)
+{ return std::isinf(val.hi()); }
+
+} // namespace std
+
+#endif // OPM_COMMON_DOUBLE_DOUBLE_HPP
@@ -0,0 +1,125 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ErrorStatus
+ */
+#ifndef OPM_MATERIAL_ERROR_STATUS_HPP
+#define OPM_MATERIAL_ERROR_STATUS_HPP
+
+#include <cstddef>
+
+namespace Opm {
+
+/*!
+ * \brief Per-thread counters for the problems which were encountered by the
+ *        non-throwing variants of the evaluation methods.
+ *
+ * Methods like Tabulated1DFunction::evalNoThrow() do not throw if they are called
+ * outside of the valid range. Instead, they extrapolate and record the problem here,
+ * so that loops over many cells do not need to be prepared for exceptions and the
+ * problems can be checked once after the loop:
+ *
+ * \code
+ * Opm::ErrorStatus::reset();
+ * for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+ *     mu[cellIdx] = table.evalNoThrow(p[cellIdx]);
+ * if (Opm::ErrorStatus::any())
+ *     ... // e.g. cut the time step
+ * \endcode
+ *
+ * The counters are thread local, i.e., every thread must check and reset its own
+ * status.
+ */
+class ErrorStatus
+{
+public:
+    enum Kind {
+        //! A tabulated function was evaluated outside of its range
+        TableOutOfRange,
+
+        //! A flash calculation did not converge or its Jacobian was singular
+        FlashNotConverged,
+
+        numKinds
+    };
+
+    /*!
+     * \brief Record that a problem of a given kind occurred.
+     */
+    static void record(Kind kind, std::size_t n = 1)
+    { counts_()[kind] += n; }
+
+    /*!
+     * \brief Returns how often a problem of a given kind occurred since the last
+     *        reset of the calling thread.
+     */
+    static std::size_t count(Kind kind)
+    { return counts_()[kind]; }
+
+    /*!
+     * \brief Returns true iff any problem occurred since the last reset of the calling
+     *        thread.
+     */
+    static bool any()
+    {
+        const std::size_t* counts = counts_();
+        for (unsigned kind = 0; kind < numKinds; ++kind)
+            if (counts[kind] > 0)
+                return true;
+        return false;
+    }
+
+    /*!
+     * \brief Clear the counters of the calling thread.
+     */
+    static void reset()
+    {
+        std::size_t* counts = counts_();
+        for (unsigned kind = 0; kind < numKinds; ++kind)
+            counts[kind] = 0;
+    }
+
+    /*!
+     * \brief Returns a human readable name of a kind of problem.
+     */
+    static const char* name(Kind kind)
+    {
+        switch (kind) {
+        case TableOutOfRange: return "table evaluated out of range";
+        case FlashNotConverged: return "flash calculation not converged";
+        default: return "unknown";
+        }
+    }
+
+private:
+    static std::size_t* counts_()
+    {
+        static thread_local std::size_t counts[numKinds] = {};
+        return counts;
+    }
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,109 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::FirstTouchArray
+ */
+#ifndef OPM_FIRST_TOUCH_ARRAY_HPP
+#define OPM_FIRST_TOUCH_ARRAY_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief A fixed-size array whose elements are constructed individually.
+ *
+ * Operating systems usually place a page of memory on the NUMA node of the thread
+ * which first writes to it. A std::vector constructs all of its elements on the thread
+ * which creates it, i.e., all of its memory ends up on the NUMA node of that thread.
+ * In contrast, this class only allocates the memory for the elements. Each element is
+ * then explicitly constructed by construct(), which is supposed to be called by the
+ * thread that later works with the element. All elements must be constructed before
+ * they are accessed, the ones which were constructed are destroyed together with the
+ * array.
+ *
+ * \tparam T The type of the elements. It must be default constructible.
+ */
+template <class T>
+class FirstTouchArray
+{
+public:
+    typedef T value_type;
+
+    explicit FirstTouchArray(size_t size = 0)
+        : data_(static_cast<T*>(size > 0 ? ::operator new(size*sizeof(T)) : nullptr))
+        , size_(size)
+        , constructed_(size, 0)
+    {}
+
+    FirstTouchArray(const FirstTouchArray&) = delete;
+    FirstTouchArray& operator=(const FirstTouchArray&) = delete;
+
+    ~FirstTouchArray()
+    {
+        for (size_t i = 0; i < size_; ++i)
+            if (constructed_[i])
+                data_[i].~T();
+        ::operator delete(data_);
+    }
+
+    /*!
+     * \brief Default construct an element of the array.
+     *
+     * Different elements may be constructed concurrently by different threads.
+     */
+    T& construct(size_t idx)
+    {
+        assert(idx < size_ && !constructed_[idx]);
+        new (data_ + idx) T();
+        constructed_[idx] = 1;
+        return data_[idx];
+    }
+
+    /*!
+     * \brief Returns the number of elements of the array.
+     */
+    size_t size() const
+    { return size_; }
+
+    T& operator[](size_t idx)
+    { assert(constructed_[idx]); return data_[idx]; }
+
+    const T& operator[](size_t idx) const
+    { assert(constructed_[idx]); return data_[idx]; }
+
+private:
+    T* data_;
+    size_t size_;
+    // bytes instead of std::vector<bool>, so that the flags of different elements can
+    // be set concurrently
+    std::vector<unsigned char> constructed_;
+};
+
+} // namespace Opm
+
+#endif
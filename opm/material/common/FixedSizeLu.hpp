@@ -0,0 +1,273 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::FixedSizeLu
+ */
+#ifndef OPM_FIXED_SIZE_LU_HPP
+#define OPM_FIXED_SIZE_LU_HPP
+
+#include <opm/material/common/SimdValue.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+namespace Opm {
+
+namespace FixedSizeLuDetail {
+// access to the individual matrices if several of them are factorized at once
+template <class Value>
+struct Lanes
+{
+    typedef Value Scalar;
+    static const int width = 1;
+
+    static Scalar& lane(Value& value, int /*laneIdx*/)
+    { return value; }
+
+    static const Scalar& lane(const Value& value, int /*laneIdx*/)
+    { return value; }
+};
+
+template <class ScalarT, int widthV>
+struct Lanes<Opm::SimdValue<ScalarT, widthV> >
+{
+    typedef ScalarT Scalar;
+    static const int width = widthV;
+
+    static Scalar& lane(Opm::SimdValue<ScalarT, widthV>& value, int laneIdx)
+    { return value[laneIdx]; }
+
+    static const Scalar& lane(const Opm::SimdValue<ScalarT, widthV>& value, int laneIdx)
+    { return value[laneIdx]; }
+};
+} // namespace FixedSizeLuDetail
+
+/*!
+ * \brief LU decomposition with partial pivoting of small dense matrices whose size is
+ *        known at compile time.
+ *
+ * The matrices of the linearized systems of equations of the constraint solvers have
+ * between about four and forty rows. For these, the generic decomposition of
+ * Dune::FieldMatrix is comparatively slow. Since all loop bounds of this class are
+ * compile time constants and the matrix is stored as a contiguous row-major array,
+ * the compiler can unroll the loops and vectorize the elimination of the rows.
+ *
+ * If Opm::SimdValue is used as the value type, each lane represents an independent
+ * matrix, i.e., several matrices are factorized at once. In this case the pivot rows
+ * are determined for each lane individually while the elimination is carried out for
+ * all lanes in lock-step.
+ */
+template <class Value, int n>
+class FixedSizeLu
+{
+    typedef FixedSizeLuDetail::Lanes<Value> Lanes;
+
+public:
+    typedef typename Lanes::Scalar Scalar;
+    static const int numLanes = Lanes::width;
+    static const int size = n;
+
+    /*!
+     * \brief Compute the decomposition of a matrix.
+     *
+     * The matrix can be of any type which provides the A[rowIdx][colIdx] syntax. A
+     * matrix is considered to be singular if the absolute value of a pivot element
+     * is below 'singularLimit' or if it is not finite. The return value is false if
+     * any of the factorized matrices is singular.
+     */
+    template <class Matrix>
+    bool factorize(const Matrix& A, Scalar singularLimit = 1e-35)
+    {
+        for (int rowIdx = 0; rowIdx < n; ++rowIdx)
+            for (int colIdx = 0; colIdx < n; ++colIdx)
+                lu_[rowIdx*n + colIdx] = A[rowIdx][colIdx];
+
+        bool regular = true;
+        for (int laneIdx = 0; laneIdx < numLanes; ++laneIdx)
+            singular_[laneIdx] = false;
+
+        for (int k = 0; k < n; ++k) {
+            // find the pivot row of the current column and swap it with the current
+            // one. this needs to be done for each lane individually.
+            for (int laneIdx = 0; laneIdx < numLanes; ++laneIdx) {
+                int pivotIdx = k;
+                Scalar pivotAbs = std::abs(Lanes::lane(lu_[k*n + k], laneIdx));
+                for (int rowIdx = k + 1; rowIdx < n; ++rowIdx) {
+                    Scalar tmp = std::abs(Lanes::lane(lu_[rowIdx*n + k], laneIdx));
+                    if (tmp > pivotAbs) {
+                        pivotIdx = rowIdx;
+                        pivotAbs = tmp;
+                    }
+                }
+
+                if (!(pivotAbs >= singularLimit) || !std::isfinite(pivotAbs)) {
+                    // avoid spreading NaNs and infinities in the remaining steps
+                    pivotRows_[laneIdx][k] = k;
+                    Lanes::lane(lu_[k*n + k], laneIdx) = 1.0;
+                    singular_[laneIdx] = true;
+                    regular = false;
+                    continue;
+                }
+
+                pivotRows_[laneIdx][k] = pivotIdx;
+                if (pivotIdx != k)
+                    for (int colIdx = 0; colIdx < n; ++colIdx)
+                        std::swap(Lanes::lane(lu_[k*n + colIdx], laneIdx),
+                                  Lanes::lane(lu_[pivotIdx*n + colIdx], laneIdx));
+            }
+
+            // eliminate the current column from the remaining rows
+            const Value invPivot = 1.0/lu_[k*n + k];
+            for (int rowIdx = k + 1; rowIdx < n; ++rowIdx) {
+                const Value factor = lu_[rowIdx*n + k]*invPivot;
+                lu_[rowIdx*n + k] = factor;
+                for (int colIdx = k + 1; colIdx < n; ++colIdx)
+                    lu_[rowIdx*n + colIdx] -= factor*lu_[k*n + colIdx];
+            }
+        }
+
+        return regular;
+    }
+
+    /*!
+     * \brief Returns true if the matrix of a lane was found to be singular by the
+     *        last call to factorize().
+     */
+    bool isSingular(int laneIdx = 0) const
+    { return singular_[laneIdx]; }
+
+    /*!
+     * \brief Solve A x = b using the decomposition.
+     *
+     * 'x' and 'b' may be the same object.
+     */
+    template <class SolutionVector, class RhsVector>
+    void solve(SolutionVector& x, const RhsVector& b) const
+    {
+        std::array<Value, n> y;
+        for (int i = 0; i < n; ++i)
+            y[i] = b[i];
+
+        // apply the row permutation
+        for (int laneIdx = 0; laneIdx < numLanes; ++laneIdx)
+            for (int k = 0; k < n; ++k)
+                if (pivotRows_[laneIdx][k] != k)
+                    std::swap(Lanes::lane(y[k], laneIdx),
+                              Lanes::lane(y[pivotRows_[laneIdx][k]], laneIdx));
+
+        // forward substitution. L has unit diagonal
+        for (int i = 1; i < n; ++i)
+            for (int j = 0; j < i; ++j)
+                y[i] -= lu_[i*n + j]*y[j];
+
+        // backward substitution
+        for (int i = n - 1; i >= 0; --i) {
+            for (int j = i + 1; j < n; ++j)
+                y[i] -= lu_[i*n + j]*y[j];
+            y[i] /= lu_[i*n + i];
+        }
+
+        for (int i = 0; i < n; ++i)
+            x[i] = y[i];
+    }
+
+    /*!
+     * \brief Compute the inverse of the factorized matrix.
+     */
+    template <class Matrix>
+    void invert(Matrix& Ainv) const
+    {
+        std::array<Value, n> e;
+        for (int colIdx = 0; colIdx < n; ++colIdx) {
+            for (int i = 0; i < n; ++i)
+                e[i] = (i == colIdx)?1.0:0.0;
+
+            solve(e, e);
+            for (int rowIdx = 0; rowIdx < n; ++rowIdx)
+                Ainv[rowIdx][colIdx] = e[rowIdx];
+        }
+    }
+
+private:
+    std::array<Value, n*n> lu_;
+    std::array<std::array<int, n>, numLanes> pivotRows_;
+    std::array<bool, numLanes> singular_;
+};
+
+namespace FixedSizeLuDetail {
+template <class Field, int n>
+bool solve(Dune::FieldVector<Field, n>& x,
+           const Dune::FieldMatrix<Field, n, n>& A,
+           const Dune::FieldVector<Field, n>& b,
+           double singularLimit,
+           std::true_type /*isFloatingPoint*/)
+{
+    FixedSizeLu<Field, n> lu;
+    if (!lu.factorize(A, static_cast<Field>(singularLimit)))
+        return false;
+
+    lu.solve(x, b);
+    return true;
+}
+
+template <class Field, int n>
+bool solve(Dune::FieldVector<Field, n>& x,
+           const Dune::FieldMatrix<Field, n, n>& A,
+           const Dune::FieldVector<Field, n>& b,
+           double /*singularLimit*/,
+           std::false_type /*isFloatingPoint*/)
+{
+    x = 0.0;
+    try { A.solve(x, b); }
+    catch (const Dune::FMatrixError&) {
+        return false;
+    }
+    return true;
+}
+} // namespace FixedSizeLuDetail
+
+/*!
+ * \brief Solve a small dense linear system of equations.
+ *
+ * If the entries of the matrix are floating point values, Opm::FixedSizeLu is used.
+ * Otherwise, e.g. for function evaluations, the system is solved using the
+ * decomposition of Dune::FieldMatrix. In either case, false is returned if the
+ * matrix is singular.
+ */
+template <class Field, int n>
+bool fixedSizeLuSolve(Dune::FieldVector<Field, n>& x,
+                      const Dune::FieldMatrix<Field, n, n>& A,
+                      const Dune::FieldVector<Field, n>& b,
+                      double singularLimit = 1e-35)
+{ return FixedSizeLuDetail::solve(x, A, b, singularLimit, std::is_floating_point<Field>()); }
+
+} // namespace Opm
+
+#endif
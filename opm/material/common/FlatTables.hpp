@@ -0,0 +1,419 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Flat representations of tabulated functions which can be evaluated by
+ *        device code.
+ *
+ * The regular table classes use std::vector, exceptions and other facilities which are
+ * not available on accelerators. Their initialized tables can be exported into a
+ * FlatTableBuffer, which stores the sampling points of any number of tables in two
+ * contiguous arrays (one for the scalars and one for the integer offsets). Each table
+ * is described by a small descriptor of plain old data which only contains offsets
+ * into these arrays, e.g.
+ *
+ * \code
+ * Opm::FlatTableBuffer<double> buffer;
+ * auto flatTable = table.exportFlat(buffer);
+ *
+ * // copy buffer.scalars() and buffer.indices() to the device, then
+ * Opm::FlatTableData<double> deviceData(deviceScalars, deviceIndices);
+ * double y = flatTable.eval(deviceData, x); // in a kernel
+ * \endcode
+ *
+ * The evaluation methods of the descriptors are marked using OPM_HOST_DEVICE and do
+ * not allocate memory or throw exceptions. They yield the same results as the
+ * corresponding methods of the host-side objects. For plain floating point arguments,
+ * they can be called from CUDA or HIP kernels; for automatic differentiation types,
+ * the arithmetic operators of these types must be device-callable as well.
+ */
+#ifndef OPM_MATERIAL_FLAT_TABLES_HPP
+#define OPM_MATERIAL_FLAT_TABLES_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#ifndef OPM_HOST_DEVICE
+#if defined(__CUDACC__) || defined(__HIPCC__)
+#define OPM_HOST_DEVICE __host__ __device__
+#else
+#define OPM_HOST_DEVICE
+#endif
+#endif
+
+namespace Opm {
+
+namespace FlatTablesDetail {
+// the scalar value of a plain floating point value or an evaluation
+template <class Evaluation>
+OPM_HOST_DEVICE
+typename std::enable_if<std::is_floating_point<Evaluation>::value, Evaluation>::type
+scalarValue(const Evaluation& x)
+{ return x; }
+
+template <class Evaluation>
+OPM_HOST_DEVICE
+auto scalarValue(const Evaluation& x)
+    -> typename std::enable_if<!std::is_floating_point<Evaluation>::value,
+                               decltype(x.value())>::type
+{ return x.value(); }
+
+// an integer clamped to the range [lo, hi]
+OPM_HOST_DEVICE inline int clamp(int value, int lo, int hi)
+{ return value < lo ? lo : (value > hi ? hi : value); }
+}
+
+/*!
+ * \brief The arrays of a flat table buffer as seen by the code which evaluates the
+ *        tables.
+ *
+ * The pointers may either refer to the memory of the host-side buffer or to copies of
+ * its arrays in the memory of an accelerator.
+ */
+template <class Scalar>
+struct FlatTableData
+{
+    FlatTableData() = default;
+
+    OPM_HOST_DEVICE FlatTableData(const Scalar* scalarsArg, const unsigned* indicesArg)
+        : scalars(scalarsArg)
+        , indices(indicesArg)
+    {}
+
+    const Scalar* scalars = nullptr;
+    const unsigned* indices = nullptr;
+};
+
+/*!
+ * \brief Stores the sampling points of tables which have been exported into their flat
+ *        representation.
+ */
+template <class Scalar>
+class FlatTableBuffer
+{
+public:
+    /*!
+     * \brief Append a range of scalars and return the offset of the first one.
+     */
+    template <class Iterator>
+    unsigned appendScalars(Iterator begin, Iterator end)
+    {
+        const unsigned offset = static_cast<unsigned>(scalars_.size());
+        for (; begin != end; ++begin)
+            scalars_.push_back(static_cast<Scalar>(*begin));
+        return offset;
+    }
+
+    /*!
+     * \brief Append a range of integers and return the offset of the first one.
+     */
+    template <class Iterator>
+    unsigned appendIndices(Iterator begin, Iterator end)
+    {
+        const unsigned offset = static_cast<unsigned>(indices_.size());
+        for (; begin != end; ++begin)
+            indices_.push_back(static_cast<unsigned>(*begin));
+        return offset;
+    }
+
+    /*!
+     * \brief The scalars of all tables which have been exported so far.
+     */
+    const std::vector<Scalar>& scalars() const
+    { return scalars_; }
+
+    /*!
+     * \brief The integer offsets of all tables which have been exported so far.
+     */
+    const std::vector<unsigned>& indices() const
+    { return indices_; }
+
+    /*!
+     * \brief The arrays of the buffer for evaluating the tables on the host.
+     *
+     * The result becomes invalid if further tables are exported.
+     */
+    FlatTableData<Scalar> data() const
+    { return FlatTableData<Scalar>(scalars_.data(), indices_.data()); }
+
+private:
+    std::vector<Scalar> scalars_;
+    std::vector<unsigned> indices_;
+};
+
+/*!
+ * \brief Descriptor of a flat piecewise linear function of one variable.
+ *
+ * The sampling points must be sorted by ascending x values. Two conventions are
+ * supported: By default, the function is extended beyond the range of the sampling
+ * points by the first and last segments, and a position which coincides with a
+ * sampling point belongs to the segment on its right, like for
+ * Opm::Tabulated1DFunction. If clampRange is set, the function is constant outside of
+ * the range and such positions belong to the segment on their left, like for
+ * Opm::PiecewiseLinearTwoPhaseMaterial.
+ */
+template <class Scalar>
+struct FlatTabulated1DFunction
+{
+    unsigned xOffset;
+    unsigned yOffset;
+    unsigned numSamples;
+    bool clampRange;
+
+    /*!
+     * \brief Find the index of the segment which is used for a given position.
+     */
+    OPM_HOST_DEVICE unsigned segmentIndex(const FlatTableData<Scalar>& data, Scalar x) const
+    {
+        const Scalar* xValues = data.scalars + xOffset;
+        if (x <= xValues[1])
+            return 0;
+        if (x > xValues[numSamples - 2] || (!clampRange && x == xValues[numSamples - 2]))
+            return numSamples - 2;
+
+        // bisection. the invariant is xValues[lowerIdx] < x < xValues[upperIdx] if the
+        // segments are right-closed and xValues[lowerIdx] <= x < xValues[upperIdx] else
+        unsigned lowerIdx = 1;
+        unsigned upperIdx = numSamples - 2;
+        while (lowerIdx + 1 < upperIdx) {
+            const unsigned pivotIdx = (lowerIdx + upperIdx)/2;
+            if (x < xValues[pivotIdx] || (clampRange && x == xValues[pivotIdx]))
+                upperIdx = pivotIdx;
+            else
+                lowerIdx = pivotIdx;
+        }
+        return lowerIdx;
+    }
+
+    /*!
+     * \brief Evaluate the function at a given position.
+     */
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation eval(const FlatTableData<Scalar>& data, const Evaluation& x) const
+    {
+        if (clampRange && outsideRange_(data, x))
+            return clampedValue_(data, x);
+        return interpolate_(data, x, segmentIndex(data, FlatTablesDetail::scalarValue(x)));
+    }
+
+    /*!
+     * \brief Evaluate the function at a given position using a given segment.
+     *
+     * This allows to evaluate several functions which use the same sampling points
+     * with a single search.
+     */
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation evalSegment(const FlatTableData<Scalar>& data,
+                                           const Evaluation& x,
+                                           unsigned segIdx) const
+    {
+        if (clampRange && outsideRange_(data, x))
+            return clampedValue_(data, x);
+        return interpolate_(data, x, segIdx);
+    }
+
+    /*!
+     * \brief Evaluate the derivative of the function at a given position.
+     */
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation evalDerivative(const FlatTableData<Scalar>& data, const Evaluation& x) const
+    {
+        if (clampRange && outsideRange_(data, x))
+            return 0.0;
+
+        const Scalar* xValues = data.scalars + xOffset;
+        const Scalar* yValues = data.scalars + yOffset;
+        const unsigned segIdx = segmentIndex(data, FlatTablesDetail::scalarValue(x));
+        return (yValues[segIdx + 1] - yValues[segIdx])/(xValues[segIdx + 1] - xValues[segIdx]);
+    }
+
+private:
+    // tables with a clamped range may consist of a single sampling point, which is
+    // dealt with here
+    template <class Evaluation>
+    OPM_HOST_DEVICE bool outsideRange_(const FlatTableData<Scalar>& data, const Evaluation& x) const
+    {
+        const Scalar* xValues = data.scalars + xOffset;
+        return x <= xValues[0] || x >= xValues[numSamples - 1];
+    }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation clampedValue_(const FlatTableData<Scalar>& data, const Evaluation& x) const
+    {
+        const Scalar* xValues = data.scalars + xOffset;
+        const Scalar* yValues = data.scalars + yOffset;
+        if (x <= xValues[0])
+            return yValues[0];
+        return yValues[numSamples - 1];
+    }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation interpolate_(const FlatTableData<Scalar>& data,
+                                            const Evaluation& x,
+                                            unsigned segIdx) const
+    {
+        const Scalar* xValues = data.scalars + xOffset;
+        const Scalar* yValues = data.scalars + yOffset;
+        const Scalar x0 = xValues[segIdx];
+        const Scalar x1 = xValues[segIdx + 1];
+        const Scalar y0 = yValues[segIdx];
+        const Scalar y1 = yValues[segIdx + 1];
+
+        // the same order of the operations as the ones of the host-side classes,
+        // which precompute the slopes of the segments
+        return y0 + (x - x0)*((y1 - y0)/(x1 - x0));
+    }
+};
+
+/*!
+ * \brief Descriptor of a flat function of two variables which is sampled uniformly in
+ *        the x direction, but non-uniformly in the y direction.
+ *
+ * This is the flat representation of Opm::UniformXTabulated2DFunction and
+ * Opm::UniformXTabulated2DMultiFunction. Each sampling point may store several
+ * quantities, which are evaluated at once. The table is always extended beyond its
+ * range.
+ */
+template <class Scalar>
+struct FlatUniformXTabulated2DFunction
+{
+    unsigned xOffset;
+    unsigned numX;
+    // offset of the numX + 1 column offsets in the integer array
+    unsigned colOffsetIdx;
+    unsigned yOffset;
+    unsigned valuesOffset;
+    unsigned numValues;
+
+    /*!
+     * \brief Evaluate all quantities at a given position.
+     *
+     * The results array must be able to hold numValues entries.
+     */
+    template <class Evaluation>
+    OPM_HOST_DEVICE void eval(const FlatTableData<Scalar>& data,
+                              const Evaluation& x,
+                              const Evaluation& y,
+                              Evaluation* results) const
+    {
+        using FlatTablesDetail::scalarValue;
+        using FlatTablesDetail::clamp;
+
+        const Scalar* xPos = data.scalars + xOffset;
+        const unsigned* colOffset = data.indices + colOffsetIdx;
+
+        const unsigned xSegIdx = xSegmentIndex_(xPos, scalarValue(x));
+        Evaluation alpha = Scalar(xSegIdx) + (x - xPos[xSegIdx])*(1/(xPos[xSegIdx + 1] - xPos[xSegIdx]));
+        const unsigned i =
+            static_cast<unsigned>(clamp(static_cast<int>(scalarValue(alpha)), 0, static_cast<int>(numX) - 2));
+        alpha -= Scalar(i);
+
+        const Scalar* yPos1 = data.scalars + yOffset + colOffset[i];
+        const Scalar* yPos2 = data.scalars + yOffset + colOffset[i + 1];
+        const unsigned numY1 = colOffset[i + 1] - colOffset[i];
+        const unsigned numY2 = colOffset[i + 2] - colOffset[i + 1];
+
+        const unsigned ySegIdx1 = ySegmentIndex_(yPos1, numY1, scalarValue(y));
+        const unsigned ySegIdx2 = ySegmentIndex_(yPos2, numY2, scalarValue(y));
+        Evaluation beta1 = Scalar(ySegIdx1) + (y - yPos1[ySegIdx1])*(1/(yPos1[ySegIdx1 + 1] - yPos1[ySegIdx1]));
+        Evaluation beta2 = Scalar(ySegIdx2) + (y - yPos2[ySegIdx2])*(1/(yPos2[ySegIdx2 + 1] - yPos2[ySegIdx2]));
+
+        const unsigned j1 =
+            static_cast<unsigned>(clamp(static_cast<int>(scalarValue(beta1)), 0, static_cast<int>(numY1) - 2));
+        const unsigned j2 =
+            static_cast<unsigned>(clamp(static_cast<int>(scalarValue(beta2)), 0, static_cast<int>(numY2) - 2));
+        beta1 -= Scalar(j1);
+        beta2 -= Scalar(j2);
+
+        const Scalar* v11 = data.scalars + valuesOffset + (colOffset[i] + j1)*numValues;
+        const Scalar* v12 = v11 + numValues;
+        const Scalar* v21 = data.scalars + valuesOffset + (colOffset[i + 1] + j2)*numValues;
+        const Scalar* v22 = v21 + numValues;
+        for (unsigned valueIdx = 0; valueIdx < numValues; ++valueIdx) {
+            const Evaluation& s1 = v11[valueIdx]*(1.0 - beta1) + v12[valueIdx]*beta1;
+            const Evaluation& s2 = v21[valueIdx]*(1.0 - beta2) + v22[valueIdx]*beta2;
+            results[valueIdx] = s1*(1.0 - alpha) + s2*alpha;
+        }
+    }
+
+    /*!
+     * \brief Evaluate the first quantity at a given position.
+     */
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation eval(const FlatTableData<Scalar>& data,
+                                    const Evaluation& x,
+                                    const Evaluation& y) const
+    {
+        // the descriptors of tables with more than one quantity must use the variant
+        // which evaluates all of them
+        Evaluation result;
+        eval(data, x, y, &result);
+        return result;
+    }
+
+private:
+    // the same segments as the ones of UniformXTabulated2DFunction
+    OPM_HOST_DEVICE unsigned xSegmentIndex_(const Scalar* xPos, Scalar x) const
+    {
+        if (x <= xPos[1])
+            return 0;
+        if (x >= xPos[numX - 2])
+            return numX - 2;
+
+        unsigned lowerIdx = 1;
+        unsigned upperIdx = numX - 2;
+        while (lowerIdx + 1 < upperIdx) {
+            const unsigned pivotIdx = (lowerIdx + upperIdx)/2;
+            if (x < xPos[pivotIdx])
+                upperIdx = pivotIdx;
+            else
+                lowerIdx = pivotIdx;
+        }
+        return lowerIdx;
+    }
+
+    OPM_HOST_DEVICE static unsigned ySegmentIndex_(const Scalar* yPos, unsigned numY, Scalar y)
+    {
+        unsigned lowerIdx = 0;
+        unsigned upperIdx = numY - 1;
+        while (lowerIdx + 1 < upperIdx) {
+            const unsigned pivotIdx = (lowerIdx + upperIdx)/2;
+            if (y < yPos[pivotIdx])
+                upperIdx = pivotIdx;
+            else
+                lowerIdx = pivotIdx;
+        }
+        return lowerIdx;
+    }
+};
+
+static_assert(std::is_pod<FlatTabulated1DFunction<double> >::value,
+              "The descriptors of flat tables must be plain old data");
+static_assert(std::is_pod<FlatUniformXTabulated2DFunction<double> >::value,
+              "The descriptors of flat tables must be plain old data");
+
+} // namespace Opm
+
+#endif
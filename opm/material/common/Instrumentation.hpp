@@ -0,0 +1,279 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Counters and timers for the hot spots of opm-material.
+ *
+ * The instrumentation is controlled by the OPM_MATERIAL_INSTRUMENTATION macro:
+ *
+ * - 0 (default): The OPM_MATERIAL_COUNT*() and OPM_MATERIAL_TIME_SCOPE() macros
+ *   expand to nothing, i.e., the instrumentation does not cost anything.
+ * - 1: The counters are incremented.
+ * - 2: The counters are incremented and the timers are active. Note that the timers
+ *   read the clock twice per timed scope, which is not negligible for small scopes.
+ *
+ * Since opm-material is header-only, the macro must be set consistently for all
+ * translation units of a program, e.g., using the OPM_MATERIAL_INSTRUMENTATION CMake
+ * cache variable of this module or a compiler flag in the build system of the
+ * simulator.
+ *
+ * Each thread increments its own set of counters, so no synchronization is required
+ * on the hot paths. The values of all threads are summed up by
+ * Opm::Instrumentation::summary() and printed by Opm::Instrumentation::print(),
+ * typically at the end of the simulation. These functions and reset() must not be
+ * called while other threads are evaluating instrumented code.
+ */
+#ifndef OPM_MATERIAL_INSTRUMENTATION_HPP
+#define OPM_MATERIAL_INSTRUMENTATION_HPP
+
+#ifndef OPM_MATERIAL_INSTRUMENTATION
+#define OPM_MATERIAL_INSTRUMENTATION 0
+#endif
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+
+#if OPM_MATERIAL_INSTRUMENTATION
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace Opm {
+namespace Instrumentation {
+
+//! The quantities which are counted
+enum CounterId {
+    tabulated1DEval,
+    tabulated1DExtrapolation,
+    liveOilSaturationPressure,
+    liveOilSaturationPressureNewtonIteration,
+    wetGasSaturationPressure,
+    wetGasSaturationPressureNewtonIteration,
+    ncpFlashSolve,
+    ncpFlashNewtonIteration,
+    ncpFlashFailure,
+    numCounters
+};
+
+//! The code sections which are timed
+enum TimerId {
+    liveOilSaturationPressureTimer,
+    wetGasSaturationPressureTimer,
+    ncpFlashSolveTimer,
+    numTimers
+};
+
+inline const char* counterName(CounterId counterId)
+{
+    static const char* names[numCounters] = {
+        "Tabulated1DFunction::eval() calls",
+        "Tabulated1DFunction::eval() extrapolations",
+        "LiveOilPvt::saturationPressure() calls",
+        "LiveOilPvt::saturationPressure() Newton iterations",
+        "WetGasPvt::saturationPressure() calls",
+        "WetGasPvt::saturationPressure() Newton iterations",
+        "NcpFlash solves",
+        "NcpFlash Newton iterations",
+        "NcpFlash failures"
+    };
+    return names[counterId];
+}
+
+inline const char* timerName(TimerId timerId)
+{
+    static const char* names[numTimers] = {
+        "LiveOilPvt::saturationPressure()",
+        "WetGasPvt::saturationPressure()",
+        "NcpFlash::solve()"
+    };
+    return names[timerId];
+}
+
+/*!
+ * \brief The values of all counters and timers summed up over all threads.
+ */
+struct Summary
+{
+    std::uint64_t counters[numCounters];
+    std::uint64_t timerCalls[numTimers];
+    double timerSeconds[numTimers];
+};
+
+#if OPM_MATERIAL_INSTRUMENTATION
+// the counters and timers of a single thread
+struct ThreadData
+{
+    std::uint64_t counters[numCounters];
+    std::uint64_t timerCalls[numTimers];
+    std::uint64_t timerNanoseconds[numTimers];
+};
+
+// the data of all threads which ever used the instrumentation. the objects are owned
+// by the registry so that the values of threads which have already finished are
+// still included in the summary.
+class ThreadDataRegistry
+{
+public:
+    static ThreadDataRegistry& instance()
+    {
+        static ThreadDataRegistry registry;
+        return registry;
+    }
+
+    ThreadData* create()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        data_.emplace_back(new ThreadData());
+        return data_.back().get();
+    }
+
+    template <class Fn>
+    void forEach(Fn fn)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& data : data_)
+            fn(*data);
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadData> > data_;
+};
+
+inline ThreadData& threadData()
+{
+    static thread_local ThreadData* data = ThreadDataRegistry::instance().create();
+    return *data;
+}
+
+inline void increment(CounterId counterId, std::uint64_t n = 1)
+{ threadData().counters[counterId] += n; }
+
+/*!
+ * \brief Adds the time between its construction and its destruction to a timer.
+ */
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(TimerId timerId)
+        : timerId_(timerId)
+        , startTime_(std::chrono::steady_clock::now())
+    {}
+
+    ~ScopedTimer()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - startTime_;
+        ThreadData& data = threadData();
+        data.timerNanoseconds[timerId_] +=
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        ++ data.timerCalls[timerId_];
+    }
+
+private:
+    TimerId timerId_;
+    std::chrono::steady_clock::time_point startTime_;
+};
+#endif // OPM_MATERIAL_INSTRUMENTATION
+
+/*!
+ * \brief Sum up the counters and timers of all threads.
+ *
+ * If the instrumentation is disabled, all values are zero.
+ */
+inline Summary summary()
+{
+    Summary result = Summary();
+#if OPM_MATERIAL_INSTRUMENTATION
+    ThreadDataRegistry::instance().forEach([&result](const ThreadData& data) {
+            for (unsigned i = 0; i < numCounters; ++i)
+                result.counters[i] += data.counters[i];
+            for (unsigned i = 0; i < numTimers; ++i) {
+                result.timerCalls[i] += data.timerCalls[i];
+                result.timerSeconds[i] += static_cast<double>(data.timerNanoseconds[i])*1e-9;
+            }
+        });
+#endif
+    return result;
+}
+
+/*!
+ * \brief Set all counters and timers of all threads to zero.
+ */
+inline void reset()
+{
+#if OPM_MATERIAL_INSTRUMENTATION
+    ThreadDataRegistry::instance().forEach([](ThreadData& data) { data = ThreadData(); });
+#endif
+}
+
+/*!
+ * \brief Print the counters and timers summed up over all threads.
+ */
+inline void print(std::ostream& os)
+{
+#if OPM_MATERIAL_INSTRUMENTATION
+    const Summary s = summary();
+    const std::ios_base::fmtflags oldFlags = os.flags();
+    const std::streamsize oldPrecision = os.precision();
+    os << "opm-material instrumentation:\n";
+    for (unsigned i = 0; i < numCounters; ++i)
+        os << "  " << std::left << std::setw(56) << counterName(static_cast<CounterId>(i))
+           << std::right << std::setw(16) << s.counters[i] << "\n";
+#if OPM_MATERIAL_INSTRUMENTATION > 1
+    for (unsigned i = 0; i < numTimers; ++i)
+        os << "  " << std::left << std::setw(56) << timerName(static_cast<TimerId>(i))
+           << std::right << std::setw(16) << s.timerCalls[i] << " calls, "
+           << std::fixed << std::setprecision(6) << s.timerSeconds[i] << " s\n";
+#endif
+    os.flags(oldFlags);
+    os.precision(oldPrecision);
+#else
+    os << "opm-material instrumentation is disabled (OPM_MATERIAL_INSTRUMENTATION=0)\n";
+#endif
+}
+
+} // namespace Instrumentation
+} // namespace Opm
+
+#if OPM_MATERIAL_INSTRUMENTATION
+#define OPM_MATERIAL_COUNT(counterId)                                   \
+    ::Opm::Instrumentation::increment(::Opm::Instrumentation::counterId)
+#define OPM_MATERIAL_COUNT_N(counterId, n)                              \
+    ::Opm::Instrumentation::increment(::Opm::Instrumentation::counterId, n)
+#else
+#define OPM_MATERIAL_COUNT(counterId) do {} while (false)
+#define OPM_MATERIAL_COUNT_N(counterId, n) do { (void) sizeof(n); } while (false)
+#endif
+
+#if OPM_MATERIAL_INSTRUMENTATION > 1
+#define OPM_MATERIAL_TIME_SCOPE(timerId)                                \
+    ::Opm::Instrumentation::ScopedTimer opmMaterialScopedTimer_(::Opm::Instrumentation::timerId)
+#else
+#define OPM_MATERIAL_TIME_SCOPE(timerId) do {} while (false)
+#endif
+
+#endif
@@ -30,7 +30,10 @@
 #ifndef OPM_MEANS_HH
 #define OPM_MEANS_HH
 
+#include <opm/material/common/MathToolbox.hpp>
+
 #include <cmath>
+#include <cstddef>
 
 namespace Opm {
 /*!
@@ -50,7 +53,7 @@ inline Scalar arithmeticMean(Scalar x, Scalar y)
  *
  * This uses the usual definition of the geometric mean:
  * \f[
- <a(x,y)> = \sqrt{x^2 + y^2}
+ <a(x,y)> = \sqrt{x y}
 \f]
  */
 template <class Scalar>
@@ -59,7 +62,7 @@ inline Scalar geometricMean(Scalar x, Scalar y)
     if (x*y <= 0.0)
         return 0.0;
 
-    return std::sqrt(x*y);
+    return Opm::sqrt(x*y);
 }
 
 /*!
@@ -79,6 +82,211 @@ inline Scalar harmonicMean(Scalar x, Scalar y)
     return (2*x*y)/(y + x);
 }
 
+namespace MeansDetail {
+// the means of two values are homogeneous functions of degree one, i.e.,
+//
+//    mean(x, y) = dmean/dx*x + dmean/dy*y
+//
+// the kernels below thus only compute the mean of the scalar values and its two
+// partial derivatives. for automatic differentiation, the result is then obtained by
+// two scalar multiplications and an addition, which are much cheaper than the chain
+// of products, quotients and square roots of the two-value functions and which can
+// be vectorized over the derivatives. the kernels do not contain data dependent jumps
+// and avoid divisions by zero for the entries which are cut off.
+struct ArithmeticMeanKernel
+{
+    template <class Scalar>
+    static void apply(Scalar x, Scalar y, Scalar& mean, Scalar& dmean_dx, Scalar& dmean_dy)
+    {
+        mean = arithmeticMean(x, y);
+        dmean_dx = 0.5;
+        dmean_dy = 0.5;
+    }
+};
+
+struct GeometricMeanKernel
+{
+    template <class Scalar>
+    static void apply(Scalar x, Scalar y, Scalar& mean, Scalar& dmean_dx, Scalar& dmean_dy)
+    {
+        Scalar xy = x*y;
+        bool positive = (xy > 0);
+        Scalar root = std::sqrt(positive ? xy : Scalar(1.0));
+        mean = positive ? root : Scalar(0.0);
+        dmean_dx = positive ? y/(2*root) : Scalar(0.0);
+        dmean_dy = positive ? x/(2*root) : Scalar(0.0);
+    }
+};
+
+struct HarmonicMeanKernel
+{
+    template <class Scalar>
+    static void apply(Scalar x, Scalar y, Scalar& mean, Scalar& dmean_dx, Scalar& dmean_dy)
+    {
+        Scalar xy = x*y;
+        Scalar sum = x + y;
+        bool positive = (xy > 0);
+        Scalar safeSum = (sum != 0) ? sum : Scalar(1.0);
+        Scalar invSum = 1/safeSum;
+        mean = positive ? (2*xy)/safeSum : Scalar(0.0);
+        dmean_dx = positive ? 2*y*y*invSum*invSum : Scalar(0.0);
+        dmean_dy = positive ? 2*x*x*invSum*invSum : Scalar(0.0);
+    }
+};
+
+// assemble the result from the mean of the values and its partial derivatives. for
+// plain floating point values, this is just the mean.
+template <class Evaluation, class Scalar>
+inline Evaluation composeMean(const Evaluation& x,
+                              const Evaluation& y,
+                              Scalar mean,
+                              Scalar dmean_dx,
+                              Scalar dmean_dy)
+{
+    Evaluation result = x*dmean_dx + y*dmean_dy;
+    result.setValue(mean);
+    return result;
+}
+
+inline float composeMean(float, float, float mean, float, float)
+{ return mean; }
+
+inline double composeMean(double, double, double mean, double, double)
+{ return mean; }
+
+template <class Kernel, class Evaluation>
+inline Evaluation evalMean(const Evaluation& x, const Evaluation& y)
+{
+    typedef typename Opm::MathToolbox<Evaluation>::Scalar Scalar;
+
+    Scalar mean, dmean_dx, dmean_dy;
+    Kernel::apply(Opm::scalarValue(x), Opm::scalarValue(y), mean, dmean_dx, dmean_dy);
+    return composeMean(x, y, mean, dmean_dx, dmean_dy);
+}
+
+template <class Kernel, class Evaluation>
+inline void meanMany(Evaluation* result,
+                     const Evaluation* x,
+                     const Evaluation* y,
+                     size_t numValues)
+{
+    for (size_t i = 0; i < numValues; ++i)
+        result[i] = evalMean<Kernel>(x[i], y[i]);
+}
+
+template <class Kernel, class Evaluation, class Index>
+inline void meanFaces(Evaluation* faceValues,
+                      const Evaluation* cellValues,
+                      const Index* interiorCells,
+                      const Index* exteriorCells,
+                      size_t numFaces)
+{
+    for (size_t i = 0; i < numFaces; ++i)
+        faceValues[i] = evalMean<Kernel>(cellValues[interiorCells[i]], cellValues[exteriorCells[i]]);
+}
+} // namespace MeansDetail
+
+/*!
+ * \brief Computes the arithmetic averages of two arrays of values.
+ *
+ * After calling this function, result[i] is arithmeticMean(x[i], y[i]) for all i <
+ * numValues. The values may be plain floating point values or dense automatic
+ * differentiation evaluations.
+ */
+template <class Evaluation>
+inline void arithmeticMeanMany(Evaluation* result,
+                               const Evaluation* x,
+                               const Evaluation* y,
+                               size_t numValues)
+{ MeansDetail::meanMany<MeansDetail::ArithmeticMeanKernel>(result, x, y, numValues); }
+
+/*!
+ * \brief Computes the geometric averages of two arrays of values.
+ *
+ * After calling this function, result[i] is geometricMean(x[i], y[i]) for all i <
+ * numValues. The loop body does not contain any data dependent jumps, so it can be
+ * vectorized by the compiler. For automatic differentiation, only the function values
+ * are passed to the square root, and the derivatives are obtained by scaling the ones
+ * of the arguments. Their results thus may differ from the ones of geometricMean() by
+ * round-off.
+ */
+template <class Evaluation>
+inline void geometricMeanMany(Evaluation* result,
+                              const Evaluation* x,
+                              const Evaluation* y,
+                              size_t numValues)
+{ MeansDetail::meanMany<MeansDetail::GeometricMeanKernel>(result, x, y, numValues); }
+
+/*!
+ * \brief Computes the harmonic averages of two arrays of values.
+ *
+ * After calling this function, result[i] is harmonicMean(x[i], y[i]) for all i <
+ * numValues. The loop body does not contain any data dependent jumps, so it can be
+ * vectorized by the compiler. For automatic differentiation, the division is only
+ * applied to the function values, and the derivatives are obtained by scaling the
+ * ones of the arguments. Their results thus may differ from the ones of
+ * harmonicMean() by round-off.
+ */
+template <class Evaluation>
+inline void harmonicMeanMany(Evaluation* result,
+                             const Evaluation* x,
+                             const Evaluation* y,
+                             size_t numValues)
+{ MeansDetail::meanMany<MeansDetail::HarmonicMeanKernel>(result, x, y, numValues); }
+
+/*!
+ * \brief Computes the arithmetic averages of cell values for a list of faces.
+ *
+ * The face with index i connects the cells interiorCells[i] and exteriorCells[i], so
+ * faceValues[i] is set to the arithmetic mean of the cell values of these two cells.
+ * This allows to compute the cell quantities once per cell instead of once per face.
+ */
+template <class Evaluation, class Index>
+inline void arithmeticMeanFaces(Evaluation* faceValues,
+                                const Evaluation* cellValues,
+                                const Index* interiorCells,
+                                const Index* exteriorCells,
+                                size_t numFaces)
+{
+    MeansDetail::meanFaces<MeansDetail::ArithmeticMeanKernel>(faceValues, cellValues,
+                                                              interiorCells, exteriorCells,
+                                                              numFaces);
+}
+
+/*!
+ * \brief Computes the geometric averages of cell values for a list of faces.
+ *
+ * See arithmeticMeanFaces() and geometricMeanMany() for details.
+ */
+template <class Evaluation, class Index>
+inline void geometricMeanFaces(Evaluation* faceValues,
+                               const Evaluation* cellValues,
+                               const Index* interiorCells,
+                               const Index* exteriorCells,
+                               size_t numFaces)
+{
+    MeansDetail::meanFaces<MeansDetail::GeometricMeanKernel>(faceValues, cellValues,
+                                                             interiorCells, exteriorCells,
+                                                             numFaces);
+}
+
+/*!
+ * \brief Computes the harmonic averages of cell values for a list of faces.
+ *
+ * See arithmeticMeanFaces() and harmonicMeanMany() for details.
+ */
+template <class Evaluation, class Index>
+inline void harmonicMeanFaces(Evaluation* faceValues,
+                              const Evaluation* cellValues,
+                              const Index* interiorCells,
+                              const Index* exteriorCells,
+                              size_t numFaces)
+{
+    MeansDetail::meanFaces<MeansDetail::HarmonicMeanKernel>(faceValues, cellValues,
+                                                            interiorCells, exteriorCells,
+                                                            numFaces);
+}
+
 } // namespace Ewoms
 
 #endif // EWOMS_AVERAGE_HH
@@ -0,0 +1,148 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::MemoryUsage
+ */
+#ifndef OPM_MATERIAL_MEMORY_USAGE_HPP
+#define OPM_MATERIAL_MEMORY_USAGE_HPP
+
+#include <climits>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief The memory which is used by an object, broken down by categories.
+ *
+ * The memory is accounted as the size of the objects plus the capacity of the
+ * containers which they own. Objects which are shared by several owners are only
+ * counted once, but the overhead of the heap allocator and of the reference counters
+ * of shared pointers is not included, i.e., the values are a lower bound of the memory
+ * which is actually used.
+ */
+class MemoryUsage
+{
+public:
+    /*!
+     * \brief Account a number of bytes for a category.
+     */
+    void add(const std::string& category, std::size_t numBytes)
+    { bytes_[category] += numBytes; }
+
+    /*!
+     * \brief Add the memory of all categories of another object.
+     */
+    void add(const MemoryUsage& other)
+    {
+        for (const auto& entry : other.bytes_)
+            bytes_[entry.first] += entry.second;
+    }
+
+    /*!
+     * \brief Returns the number of bytes accounted for a category.
+     */
+    std::size_t bytes(const std::string& category) const
+    {
+        const auto it = bytes_.find(category);
+        return it == bytes_.end() ? 0 : it->second;
+    }
+
+    /*!
+     * \brief Returns the number of bytes accounted for each category.
+     */
+    const std::map<std::string, std::size_t>& categories() const
+    { return bytes_; }
+
+    /*!
+     * \brief Returns the number of bytes of all categories.
+     */
+    std::size_t total() const
+    {
+        std::size_t result = 0;
+        for (const auto& entry : bytes_)
+            result += entry.second;
+        return result;
+    }
+
+    /*!
+     * \brief Print the memory of each category and the total in MiB.
+     */
+    void print(std::ostream& os) const
+    {
+        const std::ios_base::fmtflags oldFlags = os.flags();
+        const std::streamsize oldPrecision = os.precision();
+
+        os << std::fixed << std::setprecision(3);
+        for (const auto& entry : bytes_)
+            os << "  " << std::left << std::setw(32) << entry.first
+               << std::right << std::setw(14) << toMiB_(entry.second) << " MiB\n";
+        os << "  " << std::left << std::setw(32) << "total"
+           << std::right << std::setw(14) << toMiB_(total()) << " MiB\n";
+
+        os.flags(oldFlags);
+        os.precision(oldPrecision);
+    }
+
+private:
+    static double toMiB_(std::size_t numBytes)
+    { return static_cast<double>(numBytes)/(1024.0*1024.0); }
+
+    std::map<std::string, std::size_t> bytes_;
+};
+
+/*!
+ * \brief Returns the number of bytes reserved by a vector for its elements.
+ *
+ * Memory which is owned by the elements themselves is not included.
+ */
+template <class T>
+std::size_t vectorMemoryUsage(const std::vector<T>& v)
+{ return v.capacity()*sizeof(T); }
+
+inline std::size_t vectorMemoryUsage(const std::vector<bool>& v)
+{ return (v.capacity() + CHAR_BIT - 1)/CHAR_BIT; }
+
+/*!
+ * \brief Returns the number of bytes used by a vector of tables.
+ *
+ * This includes the memory reserved by the vector and the memory owned by the tables,
+ * which must provide a heapMemoryUsage() method.
+ */
+template <class Table>
+std::size_t tableVectorMemoryUsage(const std::vector<Table>& tables)
+{
+    std::size_t result = vectorMemoryUsage(tables);
+    for (const auto& table : tables)
+        result += table.heapMemoryUsage();
+    return result;
+}
+
+} // namespace Opm
+
+#endif
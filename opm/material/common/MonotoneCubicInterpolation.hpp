@@ -0,0 +1,249 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::MonotoneCubicInterpolation
+ */
+#ifndef OPM_MONOTONE_CUBIC_INTERPOLATION_HPP
+#define OPM_MONOTONE_CUBIC_INTERPOLATION_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Spline.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+/*!
+ * \brief The schemes which the tables can use to interpolate between their sampling
+ *        points.
+ *
+ * With linear interpolation, the derivatives of the tabulated quantities jump at the
+ * sampling points, which may cause the Newton method to oscillate if a solution is
+ * close to one of them. The monotone cubic interpolation is continuously
+ * differentiable and does not overshoot the sampled values.
+ */
+enum class TableInterpolation
+{
+    Linear,
+    MonotoneCubic
+};
+
+/*!
+ * \brief Monotonicity preserving piecewise cubic Hermite interpolation of a table.
+ *
+ * The slopes at the sampling points are determined using the Fritsch-Carlson method
+ * of Opm::Spline. Each segment is stored as the three coefficients (c1, c2, c3) of
+ * the polynomial
+ *
+ * y(x) = y_i + c1*(x - x_i) + c2*(x - x_i)^2 + c3*(x - x_i)^3,
+ *
+ * so that evaluating a segment is as cheap as the Horner scheme. Outside of the range
+ * of a segment, it is continued by the straight line through its end point, i.e., the
+ * tables are extrapolated linearly like the piecewise linear ones.
+ */
+template <class Scalar>
+class MonotoneCubicInterpolation
+{
+public:
+    //! The number of coefficients which are stored per segment
+    static const unsigned numCoeffs = 3;
+
+    /*!
+     * \brief Compute the coefficients of all segments of n sampling points.
+     *
+     * The x values must be ascending. If they exhibit jumps, i.e., if two neighboring
+     * values are equal, each strictly ascending part is interpolated on its own and the
+     * coefficients of the segments of zero width are zero.
+     */
+    template <class XContainer, class YContainer>
+    static void computeCoefficients(std::vector<Scalar>& coeffs,
+                                    size_t n,
+                                    const XContainer& x,
+                                    const YContainer& y)
+    {
+        coeffs.assign(n > 1 ? numCoeffs*(n - 1) : 0, 0.0);
+
+        std::vector<Scalar> xRun, yRun, slopes;
+        size_t beginIdx = 0;
+        while (beginIdx + 1 < n) {
+            size_t endIdx = beginIdx + 1;
+            while (endIdx < n && x[endIdx - 1] < x[endIdx])
+                ++endIdx;
+
+            size_t m = endIdx - beginIdx;
+            if (m > 1) {
+                xRun.assign(m, 0.0);
+                yRun.assign(m, 0.0);
+                slopes.assign(m, 0.0);
+                for (size_t k = 0; k < m; ++k) {
+                    xRun[k] = x[beginIdx + k];
+                    yRun[k] = y[beginIdx + k];
+                }
+                Opm::Spline<Scalar>::monotonicSlopes(m, xRun, yRun, slopes);
+
+                for (size_t k = 0; k + 1 < m; ++k) {
+                    Scalar h = xRun[k + 1] - xRun[k];
+                    Scalar delta = (yRun[k + 1] - yRun[k])/h;
+                    Scalar* c = &coeffs[numCoeffs*(beginIdx + k)];
+                    c[0] = slopes[k];
+                    c[1] = (3*delta - 2*slopes[k] - slopes[k + 1])/h;
+                    c[2] = (slopes[k] + slopes[k + 1] - 2*delta)/(h*h);
+                }
+            }
+
+            // skip the segments of zero width
+            beginIdx = endIdx;
+            while (beginIdx + 1 < n && !(x[beginIdx] < x[beginIdx + 1]))
+                ++beginIdx;
+        }
+    }
+
+    /*!
+     * \brief Evaluate a segment given its coefficients and its end points.
+     */
+    template <class Evaluation>
+    static Evaluation eval(const Scalar* c,
+                           Scalar x0,
+                           Scalar x1,
+                           Scalar y0,
+                           Scalar y1,
+                           const Evaluation& x)
+    {
+        if (x < x0)
+            return y0 + (x - x0)*c[0];
+        if (x > x1)
+            return y1 + (x - x1)*endSlope_(c, x1 - x0);
+
+        const Evaluation& t = x - x0;
+        return y0 + t*(c[0] + t*(c[1] + t*c[2]));
+    }
+
+    /*!
+     * \brief Evaluate the derivative of a segment given its coefficients and its end
+     *        points.
+     */
+    template <class Evaluation>
+    static Evaluation evalDerivative(const Scalar* c,
+                                     Scalar x0,
+                                     Scalar x1,
+                                     const Evaluation& x)
+    {
+        if (x < x0)
+            return c[0];
+        if (x > x1)
+            return endSlope_(c, x1 - x0);
+
+        const Evaluation& t = x - x0;
+        return c[0] + t*(2*c[1] + 3*t*c[2]);
+    }
+
+    /*!
+     * \brief Evaluate the second derivative of a segment given its coefficients and its
+     *        end points.
+     */
+    template <class Evaluation>
+    static Evaluation evalSecondDerivative(const Scalar* c,
+                                           Scalar x0,
+                                           Scalar x1,
+                                           const Evaluation& x)
+    {
+        if (x < x0 || x > x1)
+            return 0.0;
+        return 2*c[1] + 6*(x - x0)*c[2];
+    }
+
+    /*!
+     * \brief Evaluate the third derivative of a segment given its coefficients and its
+     *        end points.
+     */
+    template <class Evaluation>
+    static Evaluation evalThirdDerivative(const Scalar* c,
+                                          Scalar x0,
+                                          Scalar x1,
+                                          const Evaluation& x)
+    {
+        if (x < x0 || x > x1)
+            return 0.0;
+        return 6*c[2];
+    }
+
+    /*!
+     * \brief Evaluate the cubic Hermite polynomial of a segment given the values and
+     *        the slopes at its end points.
+     *
+     * This is used if the values at the end points are not known in advance, e.g., if
+     * they are interpolated themselves. Like eval(), the segment is continued linearly
+     * outside of its range.
+     */
+    template <class Evaluation>
+    static Evaluation evalHermite(Scalar x0,
+                                  Scalar x1,
+                                  const Evaluation& y0,
+                                  const Evaluation& y1,
+                                  const Evaluation& m0,
+                                  const Evaluation& m1,
+                                  const Evaluation& x)
+    {
+        if (x < x0)
+            return y0 + (x - x0)*m0;
+        if (x > x1)
+            return y1 + (x - x1)*m1;
+
+        Scalar h = x1 - x0;
+        const Evaluation& delta = (y1 - y0)/h;
+        const Evaluation& c2 = (3*delta - 2*m0 - m1)/h;
+        const Evaluation& c3 = (m0 + m1 - 2*delta)/(h*h);
+        const Evaluation& t = x - x0;
+        return y0 + t*(m0 + t*(c2 + t*c3));
+    }
+
+    /*!
+     * \brief The slope at a sampling point which keeps the interpolation monotonic given
+     *        the slopes of the secants of the adjacent segments and their widths.
+     *
+     * In contrast to the Fritsch-Carlson method, this only requires the neighbors of
+     * the sampling point: The slope is the weighted harmonic mean of the secants by
+     * Fritsch and Butland if they exhibit the same sign, else it is zero.
+     */
+    template <class Evaluation>
+    static Evaluation localSlope(Scalar hLeft,
+                                 Scalar hRight,
+                                 const Evaluation& deltaLeft,
+                                 const Evaluation& deltaRight)
+    {
+        if (!(Opm::scalarValue(deltaLeft)*Opm::scalarValue(deltaRight) > 0.0))
+            return 0.0;
+
+        return 3*(hLeft + hRight)/((2*hRight + hLeft)/deltaLeft + (hRight + 2*hLeft)/deltaRight);
+    }
+
+private:
+    // the slope of a segment of width h at its right end point
+    static Scalar endSlope_(const Scalar* c, Scalar h)
+    { return c[0] + h*(2*c[1] + 3*h*c[2]); }
+};
+
+} // namespace Opm
+
+#endif
@@ -29,6 +29,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <type_traits>
 
 #include <opm/material/common/MathToolbox.hpp>
 
@@ -127,29 +128,16 @@ void invertCubicPolynomialPostProcess_(SolContainer& sol,
 }
 //! \endcond
 
-/*!
- * \ingroup Math
- * \brief Invert a cubic polynomial analytically
- *
- * The polynomial is defined as
- * \f[ p(x) = a\; x^3 + + b\;x^3 + c\;x + d \f]
- *
- * This method teturns the number of solutions which are in the real
- * numbers. The "sol" argument contains the real roots of the cubic
- * polynomial in order with the smallest root first.
- *
- * \param sol Container into which the solutions are written
- * \param a The coefficient for the cubic term
- * \param b The coefficient for the quadratic term
- * \param c The coefficient for the linear term
- * \param d The coefficient for the constant term
- */
+//! \cond SKIP_THIS
+// computes the roots using the arithmetic of the scalar type, i.e., if the
+// coefficients are function evaluations, the derivatives are propagated through
+// all steps of the algorithm
 template <class Scalar, class SolContainer>
-unsigned invertCubicPolynomial(SolContainer* sol,
-                               Scalar a,
-                               Scalar b,
-                               Scalar c,
-                               Scalar d)
+unsigned invertCubicPolynomialGeneric_(SolContainer* sol,
+                                       Scalar a,
+                                       Scalar b,
+                                       Scalar c,
+                                       Scalar d)
 {
     // reduces to a quadratic polynomial
     if (std::abs(Opm::scalarValue(a)) < 1e-30)
@@ -309,6 +297,101 @@ unsigned invertCubicPolynomial(SolContainer* sol,
 
     return 3;
 }
+
+// computes the roots of a polynomial with first-order function evaluations as
+// coefficients: the values of the roots are determined using plain floating point
+// arithmetic, their derivatives are then obtained via the implicit function
+// theorem, i.e.,
+//
+//   dx = - (da*x^3 + db*x^2 + dc*x + dd)/(3*a*x^2 + 2*b*x + c)
+template <class Evaluation, class SolContainer>
+unsigned invertCubicPolynomialImplicit_(SolContainer* sol,
+                                        const Evaluation& a,
+                                        const Evaluation& b,
+                                        const Evaluation& c,
+                                        const Evaluation& d)
+{
+    typedef typename MathToolbox<Evaluation>::Scalar Scalar;
+
+    const Scalar aVal = Opm::scalarValue(a);
+    const Scalar bVal = Opm::scalarValue(b);
+    const Scalar cVal = Opm::scalarValue(c);
+    const Scalar dVal = Opm::scalarValue(d);
+
+    Scalar solVal[3];
+    unsigned numSol = invertCubicPolynomialGeneric_(solVal, aVal, bVal, cVal, dVal);
+    for (unsigned i = 0; i < numSol; ++i) {
+        const Scalar x = solVal[i];
+        const Scalar fPrime = cVal + x*(2*bVal + x*3*aVal);
+        if (std::abs(fPrime) < 1e-30) {
+            // multiple root: the derivatives are not defined
+            sol[i] = x;
+            continue;
+        }
+
+        // the value of f is zero up to round-off, its derivatives are the partial
+        // derivatives of the polynomial with regard to the coefficients
+        const Evaluation& f = d + x*(c + x*(b + x*a));
+        sol[i] = x - f/fPrime;
+    }
+
+    return numSol;
+}
+
+template <class Scalar, class SolContainer>
+unsigned invertCubicPolynomial_(SolContainer* sol,
+                                Scalar a,
+                                Scalar b,
+                                Scalar c,
+                                Scalar d,
+                                std::false_type /*isFirstOrderEvaluation*/)
+{ return invertCubicPolynomialGeneric_(sol, a, b, c, d); }
+
+template <class Scalar, class SolContainer>
+unsigned invertCubicPolynomial_(SolContainer* sol,
+                                Scalar a,
+                                Scalar b,
+                                Scalar c,
+                                Scalar d,
+                                std::true_type /*isFirstOrderEvaluation*/)
+{ return invertCubicPolynomialImplicit_(sol, a, b, c, d); }
+//! \endcond
+
+/*!
+ * \ingroup Math
+ * \brief Invert a cubic polynomial analytically
+ *
+ * The polynomial is defined as
+ * \f[ p(x) = a\; x^3 + + b\;x^3 + c\;x + d \f]
+ *
+ * This method teturns the number of solutions which are in the real
+ * numbers. The "sol" argument contains the real roots of the cubic
+ * polynomial in order with the smallest root first.
+ *
+ * \param sol Container into which the solutions are written
+ * \param a The coefficient for the cubic term
+ * \param b The coefficient for the quadratic term
+ * \param c The coefficient for the linear term
+ * If the coefficients are first-order function evaluations, the roots are computed
+ * using floating point arithmetic and their derivatives are obtained in a single step
+ * via the implicit function theorem.
+ *
+ * \param d The coefficient for the constant term
+ */
+template <class Scalar, class SolContainer>
+unsigned invertCubicPolynomial(SolContainer* sol,
+                               Scalar a,
+                               Scalar b,
+                               Scalar c,
+                               Scalar d)
+{
+    typedef std::integral_constant<bool,
+                                   !std::is_floating_point<Scalar>::value
+                                   && std::is_floating_point<typename MathToolbox<Scalar>::ValueType>::value>
+        IsFirstOrderEvaluation;
+
+    return invertCubicPolynomial_(sol, a, b, c, d, IsFirstOrderEvaluation());
+}
 }
 
 #endif
@@ -0,0 +1,91 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Support for the optional library of precompiled template instantiations.
+ *
+ * opm-material is header-only, so every translation unit of a program compiles the
+ * fluid systems, the material law manager and the components for the types which it
+ * uses. If the module is configured with the OPM_MATERIAL_PRECOMPILED CMake option,
+ * the opmmaterial library additionally contains explicit instantiations of the most
+ * common configurations:
+ *
+ * - Opm::DenseAd::Evaluation<double, N> for N = 1, ..., 6
+ * - Opm::H2O<double> including its property methods for double and the Evaluations
+ *   above
+ * - Opm::FluidSystems::BlackOil<double> with the oil, gas and water PVT multiplexers
+ *   and their property methods for double and the Evaluations above
+ * - Opm::EclMaterialLawManager for the three-phase traits of the black-oil fluid
+ *   system (if opm-parser is available)
+ * - The CO2 tables of co2tables.inc as Opm::PrecompiledCO2Tables (see
+ *   opm/material/components/PrecompiledCO2Tables.hpp)
+ *
+ * Translation units which define OPM_MATERIAL_EXTERN_TEMPLATES to 1 see explicit
+ * instantiation declarations ('extern template') for these types, so the compiler
+ * does not need to emit them and the program must be linked against the library. The
+ * methods which are defined within the class bodies are implicitly inline, so the
+ * compiler may still instantiate them for inlining when optimizing. Like for
+ * OPM_DENSEAD_DISABLE_SPECIALIZATIONS, the layout-affecting macros of the dense-AD
+ * code must be set identically for the library and the program.
+ */
+#ifndef OPM_MATERIAL_PRECOMPILED_INSTANTIATIONS_HPP
+#define OPM_MATERIAL_PRECOMPILED_INSTANTIATIONS_HPP
+
+#ifndef OPM_MATERIAL_EXTERN_TEMPLATES
+#define OPM_MATERIAL_EXTERN_TEMPLATES 0
+#endif
+
+namespace Opm {
+namespace DenseAd {
+template <class ValueT, int numDerivs>
+class Evaluation;
+}
+
+namespace Precompiled {
+// the macros below cannot take template arguments which contain commas
+typedef DenseAd::Evaluation<double, 1> Evaluation1;
+typedef DenseAd::Evaluation<double, 2> Evaluation2;
+typedef DenseAd::Evaluation<double, 3> Evaluation3;
+typedef DenseAd::Evaluation<double, 4> Evaluation4;
+typedef DenseAd::Evaluation<double, 5> Evaluation5;
+typedef DenseAd::Evaluation<double, 6> Evaluation6;
+} // namespace Precompiled
+} // namespace Opm
+
+/*!
+ * \brief Expands MACRO(PREFIX, Evaluation) for all evaluation types for which the
+ *        library contains instantiations.
+ *
+ * PREFIX is 'extern' for the declarations and empty for the definitions.
+ */
+#define OPM_MATERIAL_FOR_EACH_PRECOMPILED_EVALUATION(MACRO, PREFIX) \
+    MACRO(PREFIX, double)                                           \
+    MACRO(PREFIX, Opm::Precompiled::Evaluation1)                    \
+    MACRO(PREFIX, Opm::Precompiled::Evaluation2)                    \
+    MACRO(PREFIX, Opm::Precompiled::Evaluation3)                    \
+    MACRO(PREFIX, Opm::Precompiled::Evaluation4)                    \
+    MACRO(PREFIX, Opm::Precompiled::Evaluation5)                    \
+    MACRO(PREFIX, Opm::Precompiled::Evaluation6)
+
+#endif
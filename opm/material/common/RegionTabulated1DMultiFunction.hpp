@@ -0,0 +1,288 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::RegionTabulated1DMultiFunction
+ */
+#ifndef OPM_REGION_TABULATED_1D_MULTI_FUNCTION_HPP
+#define OPM_REGION_TABULATED_1D_MULTI_FUNCTION_HPP
+
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/TabulationLookupHint.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/densead/ExpressionTemplates.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <array>
+#include <cassert>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Implements a set of linearly interpolated scalar functions of one variable
+ *        for all regions of a simulation.
+ *
+ * Within a region, all quantities are sampled at the same positions. The sampling
+ * points of all regions are stored in a single contiguous array, and the values of all
+ * quantities of a sampling point are adjacent in memory. In contrast to using one
+ * Tabulated1DFunction object per quantity and region, the segment which contains a
+ * given position only needs to be searched once for all quantities.
+ *
+ * Outside of the sampled range of a region, the functions are extrapolated linearly.
+ * For each quantity, the result is the same as the one of
+ * Tabulated1DFunction::eval(x, true) for a table with the same sampling points.
+ *
+ * \tparam numValuesV The number of quantities which are stored for each sampling point
+ */
+template <class Scalar, unsigned numValuesV>
+class RegionTabulated1DMultiFunction
+{
+public:
+    //! The number of quantities which are stored for each sampling point
+    static const unsigned numValues = numValuesV;
+
+    //! The type used to specify the values of all quantities for a sampling point
+    typedef std::array<Scalar, numValues> ValueArray;
+
+    //! The type of the object which accelerates repeated lookups
+    typedef TabulationLookupHint<1> LookupHint;
+
+    RegionTabulated1DMultiFunction()
+        : regionOffset_(1, 0)
+    { }
+
+    /*!
+     * \brief Remove all regions.
+     */
+    void clear()
+    {
+        xValues_.clear();
+        values_.clear();
+        slopes_.clear();
+        regionOffset_.assign(1, 0);
+    }
+
+    /*!
+     * \brief Add the sampling points of the next region.
+     *
+     * The positions must be sorted in ascending order, and at least two sampling points
+     * are required unless the region is not used, in which case it may be empty.
+     */
+    void appendRegion(const std::vector<Scalar>& xValues,
+                      const std::vector<ValueArray>& values)
+    {
+        if (xValues.size() != values.size())
+            OPM_THROW(std::invalid_argument,
+                      "The number of positions and values of a region must be the same");
+        if (xValues.size() == 1)
+            OPM_THROW(std::invalid_argument,
+                      "A tabulated region requires at least two sampling points");
+
+        xValues_.insert(xValues_.end(), xValues.begin(), xValues.end());
+        values_.insert(values_.end(), values.begin(), values.end());
+
+        // the slope of the segment which starts at each sampling point. the entry of
+        // the last sampling point of the region is not used.
+        const size_t n = xValues.size();
+        for (size_t sampleIdx = 0; sampleIdx < n; ++sampleIdx) {
+            ValueArray slope;
+            slope.fill(0.0);
+            if (sampleIdx + 1 < n)
+                for (unsigned valueIdx = 0; valueIdx < numValues; ++valueIdx)
+                    slope[valueIdx] =
+                        (values[sampleIdx + 1][valueIdx] - values[sampleIdx][valueIdx])
+                        /(xValues[sampleIdx + 1] - xValues[sampleIdx]);
+            slopes_.push_back(slope);
+        }
+
+        regionOffset_.push_back(static_cast<unsigned>(xValues_.size()));
+    }
+
+    /*!
+     * \brief Returns the number of regions.
+     */
+    unsigned numRegions() const
+    { return static_cast<unsigned>(regionOffset_.size() - 1); }
+
+    /*!
+     * \brief Returns the number of sampling points of a region.
+     */
+    unsigned numSamples(unsigned regionIdx) const
+    {
+        assert(regionIdx < numRegions());
+        return regionOffset_[regionIdx + 1] - regionOffset_[regionIdx];
+    }
+
+    /*!
+     * \brief Returns the position of a sampling point of a region.
+     */
+    Scalar xAt(unsigned regionIdx, unsigned sampleIdx) const
+    {
+        assert(sampleIdx < numSamples(regionIdx));
+        return xValues_[regionOffset_[regionIdx] + sampleIdx];
+    }
+
+    /*!
+     * \brief Returns the values of all quantities at a sampling point of a region.
+     */
+    const ValueArray& valuesAt(unsigned regionIdx, unsigned sampleIdx) const
+    {
+        assert(sampleIdx < numSamples(regionIdx));
+        return values_[regionOffset_[regionIdx] + sampleIdx];
+    }
+
+    /*!
+     * \brief Returns the number of bytes allocated for the sampling points of all
+     *        regions.
+     *
+     * The size of the object itself is not included.
+     */
+    std::size_t heapMemoryUsage() const
+    {
+        return
+            vectorMemoryUsage(xValues_)
+            + vectorMemoryUsage(values_)
+            + vectorMemoryUsage(slopes_)
+            + vectorMemoryUsage(regionOffset_);
+    }
+
+    /*!
+     * \brief Evaluate all quantities of a region at a given position.
+     */
+    template <class Evaluation>
+    void eval(unsigned regionIdx,
+              const Evaluation& x,
+              std::array<Evaluation, numValues>& result) const
+    {
+        const unsigned segIdx = findSegmentIndex_(regionIdx, Opm::scalarValue(x));
+        const Scalar x0 = xValues_[segIdx];
+        const ValueArray& y0 = values_[segIdx];
+        const ValueArray& slope = slopes_[segIdx];
+        for (unsigned valueIdx = 0; valueIdx < numValues; ++valueIdx)
+            result[valueIdx] = eval_(x, x0, y0[valueIdx], slope[valueIdx]);
+    }
+
+    /*!
+     * \brief Evaluate all quantities of a region at a given position using a lookup
+     *        hint.
+     *
+     * The segment which was found by the previous lookup using the hint is checked
+     * first. The result is the same as the one of the method without hint.
+     */
+    template <class Evaluation>
+    void eval(unsigned regionIdx,
+              const Evaluation& x,
+              std::array<Evaluation, numValues>& result,
+              LookupHint& hint) const
+    {
+        const unsigned segIdx = findSegmentIndex_(regionIdx, Opm::scalarValue(x), hint.segmentIdx());
+        hint.setSegmentIdx(0, segIdx);
+
+        const Scalar x0 = xValues_[segIdx];
+        const ValueArray& y0 = values_[segIdx];
+        const ValueArray& slope = slopes_[segIdx];
+        for (unsigned valueIdx = 0; valueIdx < numValues; ++valueIdx)
+            result[valueIdx] = eval_(x, x0, y0[valueIdx], slope[valueIdx]);
+    }
+
+    /*!
+     * \brief Evaluate a single quantity of a region at a given position.
+     */
+    template <class Evaluation>
+    Evaluation eval(unsigned regionIdx, unsigned valueIdx, const Evaluation& x) const
+    {
+        assert(valueIdx < numValues);
+
+        const unsigned segIdx = findSegmentIndex_(regionIdx, Opm::scalarValue(x));
+        return eval_(x, xValues_[segIdx], values_[segIdx][valueIdx], slopes_[segIdx][valueIdx]);
+    }
+
+private:
+    // this is the same expression as the one used by Tabulated1DFunction, so both
+    // yield the same results
+    template <class Evaluation>
+    static Evaluation eval_(const Evaluation& x, Scalar x0, Scalar y0, Scalar slope)
+    { return Opm::DenseAd::evaluate(y0 + (Opm::DenseAd::lazy(x) - x0)*slope); }
+
+    // returns the global index of the first sampling point of the segment of a region
+    // which is used to evaluate the functions at a given position. positions outside
+    // of the sampled range use the first or the last segment. the segment hintIdx and
+    // its right neighbor are tried before resorting to bisection if they are interior
+    // segments of the region.
+    unsigned findSegmentIndex_(unsigned regionIdx, Scalar x, unsigned hintIdx = 0) const
+    {
+        assert(regionIdx < numRegions());
+        assert(numSamples(regionIdx) >= 2);
+
+        unsigned lowerIdx = regionOffset_[regionIdx];
+        unsigned upperIdx = regionOffset_[regionIdx + 1] - 1;
+        if (x <= xValues_[lowerIdx + 1])
+            return lowerIdx;
+        else if (x >= xValues_[upperIdx - 1])
+            return upperIdx - 1;
+
+        // since the first and the last segment were already dealt with above, the
+        // result is the same as that of the bisection
+        if (lowerIdx < hintIdx && hintIdx + 1 < upperIdx) {
+            if (xValues_[hintIdx] <= x && x < xValues_[hintIdx + 1])
+                return hintIdx;
+            else if (hintIdx + 2 < upperIdx
+                     && xValues_[hintIdx + 1] <= x
+                     && x < xValues_[hintIdx + 2])
+                return hintIdx + 1;
+        }
+
+        // bisection. the segment fulfills x_i <= x < x_{i+1}
+        ++lowerIdx;
+        --upperIdx;
+        while (lowerIdx + 1 < upperIdx) {
+            unsigned pivotIdx = (lowerIdx + upperIdx) / 2;
+            if (x < xValues_[pivotIdx])
+                upperIdx = pivotIdx;
+            else
+                lowerIdx = pivotIdx;
+        }
+
+        return lowerIdx;
+    }
+
+    // the positions of the sampling points of all regions
+    std::vector<Scalar> xValues_;
+
+    // the values of all quantities at each sampling point
+    std::vector<ValueArray> values_;
+
+    // the slopes of all quantities in the segment which starts at each sampling point
+    std::vector<ValueArray> slopes_;
+
+    // the index of the first sampling point of each region. the last entry is the
+    // total number of sampling points.
+    std::vector<unsigned> regionOffset_;
+};
+
+} // namespace Opm
+
+#endif
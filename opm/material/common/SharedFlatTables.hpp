@@ -0,0 +1,426 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Flat tables which are stored in a shared memory segment so that all
+ *        processes on a node can use a single copy of them.
+ *
+ * Each MPI rank usually holds its own copy of the PVT and saturation function tables,
+ * although they are identical for all ranks. A SharedFlatTableSegment places the
+ * arrays of a FlatTableBuffer and the descriptors of the exported tables in a named
+ * POSIX shared memory segment. One process per node creates it, the others attach to
+ * it and evaluate the tables using the descriptors and the FlatTableData which refer
+ * to the segment, e.g.
+ *
+ * \code
+ * MPI_Comm nodeComm;
+ * MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeComm);
+ * int nodeRank;
+ * MPI_Comm_rank(nodeComm, &nodeRank);
+ *
+ * std::shared_ptr<Opm::SharedFlatTableSegment<double> > segment;
+ * if (nodeRank == 0) {
+ *     Opm::FlatTableBuffer<double> buffer;
+ *     Opm::SharedFlatTableSegment<double>::Descriptors descriptors;
+ *     descriptors.append(liveOilPvt.exportFlat(buffer)); // block 0
+ *     descriptors.append(dryGasPvt.exportFlat(buffer)); // block 1
+ *     segment = Opm::SharedFlatTableSegment<double>::create("/opm-tables-" + jobId, buffer, descriptors);
+ * }
+ * MPI_Barrier(nodeComm);
+ * if (nodeRank != 0)
+ *     segment = Opm::SharedFlatTableSegment<double>::attach("/opm-tables-" + jobId);
+ * MPI_Barrier(nodeComm); // the creator must not release the segment before this point
+ *
+ * const auto* oilRegions = segment->template descriptors<Opm::FlatLiveOilPvtRegion<double> >(0);
+ * double invBo = oilRegions[pvtRegionIdx].inverseFormationVolumeFactor(segment->data(), p, Rs);
+ * \endcode
+ *
+ * The segment is mapped read-only by the attaching processes. Its name is removed from
+ * the system when the object of the creating process is destroyed, the memory is
+ * released once no process has it mapped anymore. The descriptors must be plain old
+ * data without pointers, which is the case for all flat descriptors. The layout of the
+ * segment is specific to the build, i.e., all processes must use the same executable.
+ *
+ * Shared memory segments are only supported on POSIX systems. Older C libraries
+ * require linking against librt for them.
+ */
+#ifndef OPM_SHARED_FLAT_TABLES_HPP
+#define OPM_SHARED_FLAT_TABLES_HPP
+
+#include <opm/material/common/FlatTables.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OPM_HAVE_POSIX_SHARED_MEMORY 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Opm {
+namespace SharedFlatTablesDetail {
+// the first bytes of each segment: "OPMS" followed by the version of the layout
+static const std::uint32_t magic = 0x534d504f;
+static const std::uint32_t layoutVersion = 1;
+
+// all arrays of the segment start at multiples of this
+static const std::size_t alignment = 64;
+
+inline std::size_t align(std::size_t offset)
+{ return (offset + alignment - 1)/alignment*alignment; }
+
+struct Header
+{
+    std::uint32_t magic;
+    std::uint32_t layoutVersion;
+    std::uint32_t scalarSize;
+    std::uint32_t numBlocks;
+    std::uint64_t numScalars;
+    std::uint64_t numIndices;
+    std::uint64_t scalarsOffset;
+    std::uint64_t indicesOffset;
+    std::uint64_t size;
+};
+
+struct Block
+{
+    std::uint64_t offset;
+    std::uint64_t numDescriptors;
+    std::uint64_t descriptorSize;
+};
+} // namespace SharedFlatTablesDetail
+
+/*!
+ * \brief The arrays of a flat table buffer and the descriptors of its tables in a
+ *        named shared memory segment.
+ */
+template <class Scalar>
+class SharedFlatTableSegment
+{
+    typedef SharedFlatTablesDetail::Header Header;
+    typedef SharedFlatTablesDetail::Block Block;
+
+public:
+    /*!
+     * \brief The descriptors which are stored in a segment.
+     *
+     * The descriptors are organized in blocks of equal type, e.g. the descriptors of
+     * all PVT regions of a phase. The blocks are numbered in the order in which they
+     * are appended.
+     */
+    class Descriptors
+    {
+        friend class SharedFlatTableSegment;
+
+    public:
+        /*!
+         * \brief Append a block of descriptors and return its index.
+         */
+        template <class Descriptor>
+        unsigned append(const std::vector<Descriptor>& descriptors)
+        {
+            static_assert(std::is_trivially_copyable<Descriptor>::value,
+                          "Only descriptors which are plain old data can be shared");
+
+            Block block;
+            block.offset = 0; // determined by the layout of the segment
+            block.numDescriptors = descriptors.size();
+            block.descriptorSize = sizeof(Descriptor);
+            blocks_.push_back(block);
+
+            const char* begin = reinterpret_cast<const char*>(descriptors.data());
+            data_.emplace_back(begin, begin + descriptors.size()*sizeof(Descriptor));
+            return static_cast<unsigned>(blocks_.size() - 1);
+        }
+
+    private:
+        std::vector<Block> blocks_;
+        std::vector<std::vector<char> > data_;
+    };
+
+    SharedFlatTableSegment(const SharedFlatTableSegment&) = delete;
+    SharedFlatTableSegment& operator=(const SharedFlatTableSegment&) = delete;
+
+    ~SharedFlatTableSegment()
+    {
+#if OPM_HAVE_POSIX_SHARED_MEMORY
+        if (address_)
+            munmap(address_, size_);
+        if (isOwner_)
+            shm_unlink(name_.c_str());
+#endif
+    }
+
+    /*!
+     * \brief Create a shared memory segment which stores the tables of a buffer and
+     *        their descriptors.
+     *
+     * The name must start with a slash and must not contain any further ones. An
+     * exception is thrown if a segment of the same name exists already.
+     */
+    static std::shared_ptr<SharedFlatTableSegment> create(const std::string& name,
+                                                          const FlatTableBuffer<Scalar>& buffer,
+                                                          const Descriptors& descriptors)
+    {
+#if OPM_HAVE_POSIX_SHARED_MEMORY
+        // the layout of the segment: header, blocks, scalars, indices and the
+        // descriptors of each block
+        std::vector<Block> blocks = descriptors.blocks_;
+        Header header;
+        header.magic = SharedFlatTablesDetail::magic;
+        header.layoutVersion = SharedFlatTablesDetail::layoutVersion;
+        header.scalarSize = sizeof(Scalar);
+        header.numBlocks = static_cast<std::uint32_t>(blocks.size());
+        header.numScalars = buffer.scalars().size();
+        header.numIndices = buffer.indices().size();
+
+        std::size_t offset = sizeof(Header) + blocks.size()*sizeof(Block);
+        header.scalarsOffset = SharedFlatTablesDetail::align(offset);
+        offset = header.scalarsOffset + header.numScalars*sizeof(Scalar);
+        header.indicesOffset = SharedFlatTablesDetail::align(offset);
+        offset = header.indicesOffset + header.numIndices*sizeof(unsigned);
+        for (auto& block : blocks) {
+            block.offset = SharedFlatTablesDetail::align(offset);
+            offset = block.offset + block.numDescriptors*block.descriptorSize;
+        }
+        header.size = std::max<std::size_t>(offset, 1);
+
+        std::shared_ptr<SharedFlatTableSegment> segment(new SharedFlatTableSegment(name));
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd < 0)
+            OPM_THROW(std::runtime_error,
+                      "Could not create the shared memory segment '" << name << "': "
+                      << std::strerror(errno));
+        segment->isOwner_ = true;
+
+        if (ftruncate(fd, static_cast<off_t>(header.size)) != 0) {
+            int errorCode = errno;
+            close(fd);
+            OPM_THROW(std::runtime_error,
+                      "Could not resize the shared memory segment '" << name << "': "
+                      << std::strerror(errorCode));
+        }
+        segment->map_(fd, header.size, PROT_READ | PROT_WRITE);
+
+        char* data = static_cast<char*>(segment->address_);
+        std::memcpy(data, &header, sizeof(Header));
+        if (!blocks.empty())
+            std::memcpy(data + sizeof(Header), blocks.data(), blocks.size()*sizeof(Block));
+        if (header.numScalars > 0)
+            std::memcpy(data + header.scalarsOffset, buffer.scalars().data(), header.numScalars*sizeof(Scalar));
+        if (header.numIndices > 0)
+            std::memcpy(data + header.indicesOffset, buffer.indices().data(), header.numIndices*sizeof(unsigned));
+        for (std::size_t blockIdx = 0; blockIdx < blocks.size(); ++blockIdx) {
+            const auto& blockData = descriptors.data_[blockIdx];
+            if (!blockData.empty())
+                std::memcpy(data + blocks[blockIdx].offset, blockData.data(), blockData.size());
+        }
+
+        // the tables are not modified anymore
+        mprotect(segment->address_, segment->size_, PROT_READ);
+        segment->init_();
+        return segment;
+#else
+        OPM_THROW(std::runtime_error,
+                  "Shared memory segments are not supported on this platform (creating '"
+                  << name << "' with " << buffer.scalars().size() << " scalars and "
+                  << descriptors.blocks_.size() << " descriptor blocks)");
+#endif
+    }
+
+    /*!
+     * \brief Map a shared memory segment which has been created by another process.
+     */
+    static std::shared_ptr<SharedFlatTableSegment> attach(const std::string& name)
+    {
+#if OPM_HAVE_POSIX_SHARED_MEMORY
+        std::shared_ptr<SharedFlatTableSegment> segment(new SharedFlatTableSegment(name));
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            OPM_THROW(std::runtime_error,
+                      "Could not open the shared memory segment '" << name << "': "
+                      << std::strerror(errno));
+
+        struct stat status;
+        if (fstat(fd, &status) != 0) {
+            int errorCode = errno;
+            close(fd);
+            OPM_THROW(std::runtime_error,
+                      "Could not determine the size of the shared memory segment '" << name << "': "
+                      << std::strerror(errorCode));
+        }
+        segment->map_(fd, static_cast<std::size_t>(status.st_size), PROT_READ);
+        segment->init_();
+        return segment;
+#else
+        OPM_THROW(std::runtime_error,
+                  "Shared memory segments are not supported on this platform (attaching to '"
+                  << name << "')");
+#endif
+    }
+
+    /*!
+     * \brief The name of the segment.
+     */
+    const std::string& name() const
+    { return name_; }
+
+    /*!
+     * \brief Returns true if the segment has been created by this object.
+     */
+    bool isOwner() const
+    { return isOwner_; }
+
+    /*!
+     * \brief The number of bytes of the segment.
+     */
+    std::size_t size() const
+    { return size_; }
+
+    /*!
+     * \brief The arrays of the tables for evaluating them using their descriptors.
+     */
+    FlatTableData<Scalar> data() const
+    { return FlatTableData<Scalar>(scalars_, indices_); }
+
+    /*!
+     * \brief The number of blocks of descriptors.
+     */
+    unsigned numBlocks() const
+    { return static_cast<unsigned>(blocks_.size()); }
+
+    /*!
+     * \brief The number of descriptors of a block.
+     */
+    std::size_t numDescriptors(unsigned blockIdx) const
+    { return block_(blockIdx).numDescriptors; }
+
+    /*!
+     * \brief The descriptors of a block.
+     *
+     * An exception is thrown if the size of the descriptor type differs from the one of
+     * the descriptors which have been appended to the block.
+     */
+    template <class Descriptor>
+    const Descriptor* descriptors(unsigned blockIdx) const
+    {
+        const Block& block = block_(blockIdx);
+        if (block.descriptorSize != sizeof(Descriptor))
+            OPM_THROW(std::logic_error,
+                      "The descriptors of block " << blockIdx << " of the shared memory segment '"
+                      << name_ << "' are of a different type");
+        return reinterpret_cast<const Descriptor*>(static_cast<const char*>(address_) + block.offset);
+    }
+
+private:
+    explicit SharedFlatTableSegment(const std::string& name)
+        : name_(name)
+    {}
+
+#if OPM_HAVE_POSIX_SHARED_MEMORY
+    void map_(int fd, std::size_t size, int protection)
+    {
+        void* address = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        int errorCode = errno;
+        close(fd);
+        if (address == MAP_FAILED)
+            OPM_THROW(std::runtime_error,
+                      "Could not map the shared memory segment '" << name_ << "': "
+                      << std::strerror(errorCode));
+
+        address_ = address;
+        size_ = size;
+    }
+#endif
+
+    // check the layout of the segment and set up the pointers into it
+    void init_()
+    {
+        const char* data = static_cast<const char*>(address_);
+        Header header;
+        if (size_ < sizeof(Header))
+            OPM_THROW(std::runtime_error,
+                      "Corrupt shared memory segment '" << name_ << "': too small");
+        std::memcpy(&header, data, sizeof(Header));
+        if (header.magic != SharedFlatTablesDetail::magic
+            || header.layoutVersion != SharedFlatTablesDetail::layoutVersion
+            || header.scalarSize != sizeof(Scalar))
+            OPM_THROW(std::runtime_error,
+                      "The shared memory segment '" << name_ << "' was created by an "
+                      "incompatible build or for a different scalar type");
+
+        const std::size_t blocksEnd = sizeof(Header) + header.numBlocks*sizeof(Block);
+        if (header.size > size_
+            || blocksEnd > header.size
+            || header.scalarsOffset + header.numScalars*sizeof(Scalar) > header.size
+            || header.indicesOffset + header.numIndices*sizeof(unsigned) > header.size)
+            OPM_THROW(std::runtime_error,
+                      "Corrupt shared memory segment '" << name_ << "': inconsistent sizes");
+
+        blocks_.resize(header.numBlocks);
+        if (header.numBlocks > 0)
+            std::memcpy(blocks_.data(), data + sizeof(Header), header.numBlocks*sizeof(Block));
+        for (const auto& block : blocks_)
+            if (block.offset + block.numDescriptors*block.descriptorSize > header.size)
+                OPM_THROW(std::runtime_error,
+                          "Corrupt shared memory segment '" << name_ << "': inconsistent sizes");
+
+        scalars_ = reinterpret_cast<const Scalar*>(data + header.scalarsOffset);
+        indices_ = reinterpret_cast<const unsigned*>(data + header.indicesOffset);
+    }
+
+    const Block& block_(unsigned blockIdx) const
+    {
+        if (blockIdx >= blocks_.size())
+            OPM_THROW(std::logic_error,
+                      "The shared memory segment '" << name_ << "' does not contain a block "
+                      << blockIdx);
+        return blocks_[blockIdx];
+    }
+
+    std::string name_;
+    bool isOwner_ = false;
+    void* address_ = nullptr;
+    std::size_t size_ = 0;
+
+    std::vector<Block> blocks_;
+    const Scalar* scalars_ = nullptr;
+    const unsigned* indices_ = nullptr;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,417 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief A value type which represents the same quantity for several cells at once.
+ *
+ * Using Opm::SimdValue as the value type of Opm::DenseAd::Evaluation allows to evaluate
+ * the generic code of fluid systems and material laws for several cells in lock-step,
+ * i.e., the vectorization is done across cells instead of across derivatives. The lanes
+ * are stored in a plain array and all operations are simple loops of fixed length which
+ * the compiler is able to vectorize.
+ *
+ * Comparisons of SimdValue objects yield Opm::SimdMask objects which do not convert to
+ * bool, so code which branches on values does not silently compile. Such branches must
+ * be expressed using Opm::select(), Opm::anyTrue() and Opm::allTrue() which also work
+ * for plain booleans and thus can be used in generic code.
+ */
+#ifndef OPM_MATERIAL_SIMD_VALUE_HPP
+#define OPM_MATERIAL_SIMD_VALUE_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <type_traits>
+
+namespace Opm {
+
+/*!
+ * \brief The result of a lane-wise comparison of SimdValue objects.
+ */
+template <int widthV>
+class SimdMask
+{
+public:
+    static constexpr int width = widthV;
+
+    SimdMask()
+    { lanes_.fill(false); }
+
+    explicit SimdMask(bool value)
+    { lanes_.fill(value); }
+
+    bool operator[](int laneIdx) const
+    { return lanes_[laneIdx]; }
+
+    bool& operator[](int laneIdx)
+    { return lanes_[laneIdx]; }
+
+    SimdMask operator&&(const SimdMask& other) const
+    {
+        SimdMask result;
+        for (int i = 0; i < width; ++i)
+            result.lanes_[i] = lanes_[i] && other.lanes_[i];
+        return result;
+    }
+
+    SimdMask operator||(const SimdMask& other) const
+    {
+        SimdMask result;
+        for (int i = 0; i < width; ++i)
+            result.lanes_[i] = lanes_[i] || other.lanes_[i];
+        return result;
+    }
+
+    SimdMask operator!() const
+    {
+        SimdMask result;
+        for (int i = 0; i < width; ++i)
+            result.lanes_[i] = !lanes_[i];
+        return result;
+    }
+
+private:
+    std::array<bool, width> lanes_;
+};
+
+/*!
+ * \brief Represents the values of a scalar quantity for a fixed number of cells.
+ */
+template <class ScalarT, int widthV>
+class SimdValue
+{
+    static_assert(std::is_floating_point<ScalarT>::value,
+                  "SimdValue expects floating point scalars");
+
+public:
+    typedef ScalarT Scalar;
+    typedef Opm::SimdMask<widthV> Mask;
+    static constexpr int width = widthV;
+
+    //! default constructor. in contrast to plain scalars, all lanes are zero
+    SimdValue()
+    { lanes_.fill(0.0); }
+
+    //! broadcast a scalar to all lanes
+    SimdValue(Scalar value)
+    { lanes_.fill(value); }
+
+    //! return the value for a given lane
+    const Scalar& operator[](int laneIdx) const
+    { return lanes_[laneIdx]; }
+
+    //! return the value for a given lane
+    Scalar& operator[](int laneIdx)
+    { return lanes_[laneIdx]; }
+
+    SimdValue& operator+=(const SimdValue& other)
+    {
+        for (int i = 0; i < width; ++i)
+            lanes_[i] += other.lanes_[i];
+        return *this;
+    }
+
+    SimdValue& operator-=(const SimdValue& other)
+    {
+        for (int i = 0; i < width; ++i)
+            lanes_[i] -= other.lanes_[i];
+        return *this;
+    }
+
+    SimdValue& operator*=(const SimdValue& other)
+    {
+        for (int i = 0; i < width; ++i)
+            lanes_[i] *= other.lanes_[i];
+        return *this;
+    }
+
+    SimdValue& operator/=(const SimdValue& other)
+    {
+        for (int i = 0; i < width; ++i)
+            lanes_[i] /= other.lanes_[i];
+        return *this;
+    }
+
+    SimdValue operator-() const
+    {
+        SimdValue result;
+        for (int i = 0; i < width; ++i)
+            result.lanes_[i] = - lanes_[i];
+        return result;
+    }
+
+    //! apply a unary function to all lanes
+    template <class Fn>
+    SimdValue apply(Fn fn) const
+    {
+        SimdValue result;
+        for (int i = 0; i < width; ++i)
+            result.lanes_[i] = fn(lanes_[i]);
+        return result;
+    }
+
+    //! apply a binary function to all lanes of two values
+    template <class Fn>
+    static SimdValue apply(const SimdValue& a, const SimdValue& b, Fn fn)
+    {
+        SimdValue result;
+        for (int i = 0; i < width; ++i)
+            result.lanes_[i] = fn(a.lanes_[i], b.lanes_[i]);
+        return result;
+    }
+
+    //! compare all lanes of two values
+    template <class Fn>
+    static Mask compare(const SimdValue& a, const SimdValue& b, Fn fn)
+    {
+        Mask result;
+        for (int i = 0; i < width; ++i)
+            result[i] = fn(a.lanes_[i], b.lanes_[i]);
+        return result;
+    }
+
+private:
+    std::array<Scalar, width> lanes_;
+};
+
+#define OPM_SIMD_VALUE_BINARY_OP(OP)                                            \
+    template <class Scalar, int width>                                          \
+    SimdValue<Scalar, width> operator OP(const SimdValue<Scalar, width>& a,     \
+                                         const SimdValue<Scalar, width>& b)     \
+    { return SimdValue<Scalar, width>::apply(a, b, [](Scalar x, Scalar y) { return x OP y; }); } \
+                                                                                \
+    template <class Scalar, int width, class RhsScalar>                         \
+    typename std::enable_if<std::is_arithmetic<RhsScalar>::value,               \
+                            SimdValue<Scalar, width> >::type                    \
+    operator OP(const SimdValue<Scalar, width>& a, const RhsScalar& b)          \
+    { return a OP SimdValue<Scalar, width>(b); }                                \
+                                                                                \
+    template <class LhsScalar, class Scalar, int width>                         \
+    typename std::enable_if<std::is_arithmetic<LhsScalar>::value,               \
+                            SimdValue<Scalar, width> >::type                    \
+    operator OP(const LhsScalar& a, const SimdValue<Scalar, width>& b)          \
+    { return SimdValue<Scalar, width>(a) OP b; }
+
+OPM_SIMD_VALUE_BINARY_OP(+)
+OPM_SIMD_VALUE_BINARY_OP(-)
+OPM_SIMD_VALUE_BINARY_OP(*)
+OPM_SIMD_VALUE_BINARY_OP(/)
+
+#undef OPM_SIMD_VALUE_BINARY_OP
+
+#define OPM_SIMD_VALUE_COMPARISON(OP)                                           \
+    template <class Scalar, int width>                                          \
+    SimdMask<width> operator OP(const SimdValue<Scalar, width>& a,              \
+                                const SimdValue<Scalar, width>& b)              \
+    { return SimdValue<Scalar, width>::compare(a, b, [](Scalar x, Scalar y) { return x OP y; }); } \
+                                                                                \
+    template <class Scalar, int width, class RhsScalar>                         \
+    typename std::enable_if<std::is_arithmetic<RhsScalar>::value,               \
+                            SimdMask<width> >::type                             \
+    operator OP(const SimdValue<Scalar, width>& a, const RhsScalar& b)          \
+    { return a OP SimdValue<Scalar, width>(b); }                                \
+                                                                                \
+    template <class LhsScalar, class Scalar, int width>                         \
+    typename std::enable_if<std::is_arithmetic<LhsScalar>::value,               \
+                            SimdMask<width> >::type                             \
+    operator OP(const LhsScalar& a, const SimdValue<Scalar, width>& b)          \
+    { return SimdValue<Scalar, width>(a) OP b; }
+
+OPM_SIMD_VALUE_COMPARISON(<)
+OPM_SIMD_VALUE_COMPARISON(<=)
+OPM_SIMD_VALUE_COMPARISON(>)
+OPM_SIMD_VALUE_COMPARISON(>=)
+OPM_SIMD_VALUE_COMPARISON(==)
+OPM_SIMD_VALUE_COMPARISON(!=)
+
+#undef OPM_SIMD_VALUE_COMPARISON
+
+template <class Scalar, int width>
+std::ostream& operator<<(std::ostream& os, const SimdValue<Scalar, width>& value)
+{
+    os << "[";
+    for (int i = 0; i < width; ++i)
+        os << ((i > 0)?" ":"") << value[i];
+    os << "]";
+    return os;
+}
+
+////////////
+// helpers for branches which work for scalars as well as for SIMD values
+////////////
+
+//! returns true if the condition is true for at least one lane
+inline bool anyTrue(bool cond)
+{ return cond; }
+
+template <int width>
+bool anyTrue(const SimdMask<width>& cond)
+{
+    for (int i = 0; i < width; ++i)
+        if (cond[i])
+            return true;
+    return false;
+}
+
+//! returns true if the condition is true for all lanes
+inline bool allTrue(bool cond)
+{ return cond; }
+
+template <int width>
+bool allTrue(const SimdMask<width>& cond)
+{
+    for (int i = 0; i < width; ++i)
+        if (!cond[i])
+            return false;
+    return true;
+}
+
+//! returns a if the condition is true and b otherwise
+template <class T>
+T select(bool cond, const T& a, const T& b)
+{ return cond ? a : b; }
+
+//! returns the lanes of a for which the condition is true and the ones of b otherwise
+template <class Scalar, int width>
+SimdValue<Scalar, width> select(const SimdMask<width>& cond,
+                                const SimdValue<Scalar, width>& a,
+                                const SimdValue<Scalar, width>& b)
+{
+    SimdValue<Scalar, width> result;
+    for (int i = 0; i < width; ++i)
+        result[i] = cond[i] ? a[i] : b[i];
+    return result;
+}
+
+/*!
+ * \brief The math toolbox for SIMD values.
+ *
+ * All functions are applied lane-wise. isfinite() returns true only if all lanes are
+ * finite and isnan() returns true if any lane is NaN so that the checks of the
+ * toolboxes for automatic differentiation continue to work.
+ */
+template <class ScalarT, int width>
+struct MathToolbox<Opm::SimdValue<ScalarT, width> >
+{
+public:
+    typedef ScalarT Scalar;
+    typedef Opm::SimdValue<ScalarT, width> ValueType;
+    typedef Opm::MathToolbox<Scalar> InnerToolbox;
+    typedef ValueType Evaluation;
+
+    static ValueType value(const ValueType& value)
+    { return value; }
+
+    static ValueType scalarValue(const ValueType& value)
+    { return value; }
+
+    static ValueType createConstant(const ValueType& value)
+    { return value; }
+
+    static ValueType createVariable(const ValueType& value, unsigned /*varIdx*/)
+    { return value; }
+
+    template <class LhsEval>
+    static typename std::enable_if<std::is_same<ValueType, LhsEval>::value,
+                                   LhsEval>::type
+    decay(const ValueType& value)
+    { return value; }
+
+    static bool isSame(const ValueType& a, const ValueType& b, Scalar tolerance)
+    {
+        for (int i = 0; i < width; ++i)
+            if (!InnerToolbox::isSame(a[i], b[i], tolerance))
+                return false;
+        return true;
+    }
+
+    ////////////
+    // arithmetic functions
+    ////////////
+
+    static ValueType max(const ValueType& arg1, const ValueType& arg2)
+    { return ValueType::apply(arg1, arg2, [](Scalar x, Scalar y) { return std::max(x, y); }); }
+
+    static ValueType min(const ValueType& arg1, const ValueType& arg2)
+    { return ValueType::apply(arg1, arg2, [](Scalar x, Scalar y) { return std::min(x, y); }); }
+
+    static ValueType abs(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::abs(x); }); }
+
+    static ValueType tan(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::tan(x); }); }
+
+    static ValueType atan(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::atan(x); }); }
+
+    static ValueType atan2(const ValueType& arg1, const ValueType& arg2)
+    { return ValueType::apply(arg1, arg2, [](Scalar x, Scalar y) { return std::atan2(x, y); }); }
+
+    static ValueType sin(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::sin(x); }); }
+
+    static ValueType asin(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::asin(x); }); }
+
+    static ValueType cos(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::cos(x); }); }
+
+    static ValueType acos(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::acos(x); }); }
+
+    static ValueType sqrt(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::sqrt(x); }); }
+
+    static ValueType exp(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::exp(x); }); }
+
+    static ValueType log(const ValueType& arg)
+    { return arg.apply([](Scalar x) { return std::log(x); }); }
+
+    static ValueType pow(const ValueType& base, const ValueType& exp)
+    { return ValueType::apply(base, exp, [](Scalar x, Scalar y) { return std::pow(x, y); }); }
+
+    static bool isfinite(const ValueType& arg)
+    {
+        for (int i = 0; i < width; ++i)
+            if (!std::isfinite(arg[i]))
+                return false;
+        return true;
+    }
+
+    static bool isnan(const ValueType& arg)
+    {
+        for (int i = 0; i < width; ++i)
+            if (std::isnan(arg[i]))
+                return true;
+        return false;
+    }
+};
+
+} // namespace Opm
+
+#endif
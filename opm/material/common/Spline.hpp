@@ -29,11 +29,16 @@
 
 #include <opm/material/common/TridiagonalMatrix.hpp>
 #include <opm/material/common/PolynomialUtils.hpp>
+#include <opm/material/common/MathToolbox.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/Unused.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <ostream>
+#include <stdexcept>
 #include <vector>
 #include <tuple>
 
@@ -107,6 +112,88 @@ public:
         Monotonic
     };
 
+    /*!
+     * \brief The factorized linear system of equations which determines the moments
+     *        of full, natural or periodic splines for given sampling positions.
+     *
+     * The matrix of this system only depends on the x values of the sampling points.
+     * If many splines use the same x values, the system can thus be factorized once and
+     * then be passed to the set*() methods of all of them, which then only need to
+     * compute the right hand side and to do the substitution. The result is identical
+     * to the one of a spline which is set up without a shared system.
+     */
+    class MomentSystem
+    {
+        friend class Spline;
+
+    public:
+        MomentSystem()
+            : splineType_(Natural)
+        { }
+
+        /*!
+         * \brief Factorize the system for a given spline type and given x values of the
+         *        sampling points.
+         *
+         * The x values must be in strictly ascending order. Monotonic splines are not
+         * supported because they are not determined by a linear system.
+         */
+        template <class ScalarContainerX>
+        void factorize(const ScalarContainerX& x, SplineType splineType)
+        {
+            size_t nSamples = x.size();
+            if (nSamples < 2 || (splineType == Periodic && nSamples < 3))
+                OPM_THROW(std::invalid_argument,
+                          "Too few sampling points for the moments of a spline");
+            if (splineType == Monotonic)
+                OPM_THROW(std::invalid_argument,
+                          "Monotonic splines are not determined by a linear system of equations");
+
+            // use a spline without values to set up the matrix
+            Spline tmp;
+            tmp.setNumSamples_(nSamples);
+            std::copy(x.begin(), x.end(), tmp.xPos_.begin());
+            for (size_t i = 1; i < nSamples; ++i)
+                if (!(tmp.xPos_[i - 1] < tmp.xPos_[i]))
+                    OPM_THROW(std::invalid_argument,
+                              "The x values of the sampling points must be strictly ascending");
+
+            Matrix M;
+            if (splineType == Periodic) {
+                M.resize(nSamples - 1);
+                tmp.makePeriodicMatrix_(M);
+            }
+            else {
+                M.resize(nSamples);
+                if (splineType == Full)
+                    tmp.makeFullMatrix_(M);
+                else
+                    tmp.makeNaturalMatrix_(M);
+            }
+
+            factorization_.factorize(M);
+            xPos_.swap(tmp.xPos_);
+            splineType_ = splineType;
+        }
+
+        /*!
+         * \brief Returns the type of the splines for which the system was factorized.
+         */
+        SplineType splineType() const
+        { return splineType_; }
+
+        /*!
+         * \brief Returns the number of sampling points of the splines.
+         */
+        size_t numSamples() const
+        { return xPos_.size(); }
+
+    private:
+        SplineType splineType_;
+        Vector xPos_;
+        TridiagonalFactorization<Scalar> factorization_;
+    };
+
     /*!
      * \brief Default constructor for a spline.
      *
@@ -272,6 +359,7 @@ public:
         slopeVec_.resize(2);
         xPos_.resize(2);
         yPos_.resize(2);
+        clearPrecomputedCoefficients_();
 
         if (x0 > x1) {
             xPos_[0] = x1;
@@ -706,6 +794,47 @@ public:
             OPM_THROW(std::runtime_error, "Spline type " << splineType << " not supported at this place");
     }
 
+    /*!
+     * \brief Set the sampling points of a natural or periodic spline using a system
+     *        of equations which has already been factorized.
+     *
+     * The x values must be the ones for which the system was factorized, and the
+     * sampling points are not sorted.
+     */
+    template <class ScalarContainerX, class ScalarContainerY>
+    void setXYContainers(const ScalarContainerX& x,
+                         const ScalarContainerY& y,
+                         const MomentSystem& system)
+    {
+        if (system.splineType() == Full)
+            OPM_THROW(std::invalid_argument,
+                      "The boundary slopes must be specified for a full spline");
+
+        assignSharedSystemSamples_(x, y, system);
+        makeSplineFromSystem_(system, /*m0=*/0.0, /*m1=*/0.0);
+    }
+
+    /*!
+     * \brief Set the sampling points and the boundary slopes of a full spline using a
+     *        system of equations which has already been factorized.
+     *
+     * The x values must be the ones for which the system was factorized, and the
+     * sampling points are not sorted.
+     */
+    template <class ScalarContainerX, class ScalarContainerY>
+    void setXYContainers(const ScalarContainerX& x,
+                         const ScalarContainerY& y,
+                         Scalar m0, Scalar m1,
+                         const MomentSystem& system)
+    {
+        if (system.splineType() != Full)
+            OPM_THROW(std::invalid_argument,
+                      "Boundary slopes can only be specified for full splines");
+
+        assignSharedSystemSamples_(x, y, system);
+        makeSplineFromSystem_(system, m0, m1);
+    }
+
     /*!
      * \brief Return true iff the given x is in range [x1, xn].
      */
@@ -731,6 +860,51 @@ public:
     Scalar valueAt(size_t sampleIdx) const
     { return y_(sampleIdx); }
 
+    /*!
+     * \brief Speed up the evaluation of the spline.
+     *
+     * This converts the Hermite representation of each segment to the
+     * coefficients of a cubic polynomial in \f$x - x_i\f$, so that eval()
+     * reduces to a Horner step once the segment is known. Also, an index which
+     * maps uniformly sized buckets of the abscissa to the segments is built, so
+     * that the segment can be found in constant time if the sampling points are
+     * reasonably evenly spaced.
+     *
+     * This method must be called after the sampling points have been
+     * specified. Calling any of the set*() methods afterwards discards the
+     * precomputed data.
+     */
+    void precomputeCoefficients()
+    {
+        size_t n = numSamples();
+        if (n < 2) {
+            clearPrecomputedCoefficients_();
+            return;
+        }
+
+        coeffs_.resize(4*(n - 1));
+        for (size_t i = 0; i < n - 1; ++i) {
+            Scalar h = h_(i + 1);
+            Scalar delta = (y_(i + 1) - y_(i))/h;
+            Scalar m0 = slope_(i);
+            Scalar m1 = slope_(i + 1);
+
+            coeffs_[4*i + 0] = y_(i);
+            coeffs_[4*i + 1] = m0;
+            coeffs_[4*i + 2] = (3*delta - 2*m0 - m1)/h;
+            coeffs_[4*i + 3] = (m0 + m1 - 2*delta)/(h*h);
+        }
+
+        updateSegmentLookup_();
+    }
+
+    /*!
+     * \brief Returns true if precomputeCoefficients() was called after the
+     *        sampling points have been set.
+     */
+    bool hasPrecomputedCoefficients() const
+    { return !coeffs_.empty(); }
+
     /*!
      * \brief Prints k tuples of the format (x, y, dx/dy, isMonotonic)
      *        to stdout.
@@ -821,6 +995,66 @@ public:
         return eval_(x, segmentIdx_(Opm::scalarValue(x)));
     }
 
+    /*!
+     * \brief Evaluate the spline at a contiguous array of positions.
+     *
+     * This is equivalent to calling eval() for each entry of the array, but the
+     * segment which was found for a given position is tried first for the next
+     * one. If the positions are sorted or if neighboring positions are close to
+     * each other, the segment search is thus skipped for most entries.
+     *
+     * \param numValues The number of positions which ought to be evaluated
+     * \param x Pointer to the first position on the abscissa
+     * \param result Pointer to the first entry of the array which receives the
+     *               values of the spline. It must be able to hold numValues entries.
+     * \param extrapolate If this parameter is set to true, the spline will be
+     *                    extended beyond its range by straight lines, if false
+     *                    evaluating the spline outside of its range causes an
+     *                    exception to be thrown.
+     *
+     * If the results are plain scalars while the positions are Evaluations, only the
+     * values of the positions are used, i.e., no derivatives are computed.
+     */
+    template <class InputEvaluation, class Evaluation>
+    void evalMany(size_t numValues,
+                  const InputEvaluation* x,
+                  Evaluation* result,
+                  bool extrapolate = false) const
+    {
+        const Scalar xMin = xAt(0);
+        const Scalar xMax = xAt(numSamples() - 1);
+
+        size_t segIdx = 0;
+        for (size_t i = 0; i < numValues; ++i) {
+            const auto& xi = Opm::decay<Evaluation>(x[i]);
+            Scalar xs = Opm::scalarValue(xi);
+            if (!(xMin <= xs && xs <= xMax)) {
+                result[i] = eval(xi, extrapolate);
+                continue;
+            }
+
+            if (!(x_(segIdx) <= xs && xs < x_(segIdx + 1)))
+                segIdx = segmentIdx_(xs);
+
+            result[i] = eval_(xi, segIdx);
+        }
+    }
+
+    /*!
+     * \brief Evaluate the spline at all positions of an STL-compatible container.
+     *
+     * The result container is resized to the size of the container of positions.
+     * See the pointer based variant of this method for details.
+     */
+    template <class InputContainer, class ResultContainer>
+    void evalMany(const InputContainer& x,
+                  ResultContainer& result,
+                  bool extrapolate = false) const
+    {
+        result.resize(x.size());
+        evalMany(x.size(), x.data(), result.data(), extrapolate);
+    }
+
     /*!
      * \brief Evaluate the spline's derivative at a given position.
      *
@@ -1030,6 +1264,63 @@ public:
     int monotonic() const
     { return monotonic(xAt(0), xAt(numSamples() - 1)); }
 
+    /*!
+     * \brief Compute the slopes at the sampling points of a monotonic cubic Hermite
+     *        interpolation of n sampling points.
+     *
+     * This is the Fritsch-Carlson method which is also used for monotonic splines. The
+     * x values must be strictly increasing. Other interpolation schemes can use the
+     * resulting slopes to become continuously differentiable without overshooting
+     * the sampled values.
+     */
+    template <class XContainer, class YContainer, class SlopeContainer>
+    static void monotonicSlopes(size_t n,
+                                const XContainer& x,
+                                const YContainer& y,
+                                SlopeContainer& slopes)
+    {
+        assert(n > 1);
+
+        // calculate the slopes of the secant lines
+        std::vector<Scalar> delta(n);
+        for (size_t k = 0; k < n - 1; ++k)
+            delta[k] = (Scalar(y[k + 1]) - Scalar(y[k]))/(Scalar(x[k + 1]) - Scalar(x[k]));
+
+        // calculate the "raw" slopes at the sample points
+        for (size_t k = 1; k < n - 1; ++k)
+            slopes[k] = (delta[k - 1] + delta[k])/2;
+        slopes[0] = delta[0];
+        slopes[n - 1] = delta[n - 2];
+
+        // post-process the "raw" slopes at the sample points
+        for (size_t k = 0; k < n - 1; ++k) {
+            if (std::abs(delta[k]) < 1e-50) {
+                // make the spline flat if the inputs are equal
+                slopes[k] = 0;
+                slopes[k + 1] = 0;
+                continue;
+            }
+
+            Scalar alpha = slopes[k] / delta[k];
+            Scalar beta = slopes[k + 1] / delta[k];
+
+            // the slope at a local extremum of the sampling points is zero
+            if (alpha < 0 || (k > 0 && slopes[k] * delta[k - 1] < 0)) {
+                slopes[k] = 0;
+                alpha = 0;
+            }
+
+            // limit (alpha, beta) to a circle of radius 3. this is also required if the
+            // slope at the left end of the segment was set to zero above, else the
+            // segment may overshoot at its right end.
+            if (alpha*alpha + beta*beta > 3*3) {
+                Scalar tau = 3.0/std::sqrt(alpha*alpha + beta*beta);
+                slopes[k] = tau*alpha*delta[k];
+                slopes[k + 1] = tau*beta*delta[k];
+            }
+        }
+    }
+
 protected:
     /*!
      * \brief Helper class needed to sort the input sampling points.
@@ -1095,6 +1386,60 @@ protected:
         xPos_.resize(nSamples);
         yPos_.resize(nSamples);
         slopeVec_.resize(nSamples);
+        clearPrecomputedCoefficients_();
+    }
+
+    /*!
+     * \brief Discard the data which was set up by precomputeCoefficients().
+     */
+    void clearPrecomputedCoefficients_()
+    {
+        coeffs_.clear();
+        segmentLookupIdx_.clear();
+    }
+
+    /*!
+     * \brief Build the index which maps uniformly sized buckets of the abscissa to the
+     *        first segment which overlaps with them.
+     *
+     * The bucket width is chosen such that for splines with reasonably evenly spaced
+     * sampling points, a bucket overlaps with only one or two segments. For splines
+     * with less than four sampling points, bisection is cheap and the index is not
+     * built.
+     */
+    void updateSegmentLookup_()
+    {
+        segmentLookupIdx_.clear();
+
+        size_t n = numSamples();
+        if (n < 4)
+            return;
+
+        Scalar range = x_(n - 1) - x_(0);
+        if (!(range > 0.0))
+            return;
+
+        Scalar minWidth = range;
+        for (size_t i = 0; i < n - 1; ++i)
+            minWidth = std::min(minWidth, x_(i + 1) - x_(i));
+
+        // use between one and four buckets per segment
+        size_t numBuckets = n - 1;
+        Scalar idealNumBuckets = std::ceil(range/minWidth);
+        if (idealNumBuckets > static_cast<Scalar>(4*(n - 1)))
+            numBuckets = 4*(n - 1);
+        else if (idealNumBuckets > static_cast<Scalar>(numBuckets))
+            numBuckets = static_cast<size_t>(idealNumBuckets);
+
+        lookupInvBucketWidth_ = numBuckets/range;
+        segmentLookupIdx_.resize(numBuckets + 1);
+        size_t segIdx = 0;
+        for (size_t bucketIdx = 0; bucketIdx <= numBuckets; ++bucketIdx) {
+            Scalar xBucket = x_(0) + bucketIdx*range/numBuckets;
+            while (segIdx < n - 2 && x_(segIdx + 1) <= xBucket)
+                ++segIdx;
+            segmentLookupIdx_[bucketIdx] = static_cast<unsigned>(segIdx);
+        }
     }
 
     /*!
@@ -1159,12 +1504,73 @@ protected:
         // solve for the moments (-> second derivatives)
         M.solve(moments, d);
 
+        this->expandPeriodicMoments_(moments);
+
+        // convert the moments to slopes at the sample points
+        this->setSlopesFromMoments_(slopeVec_, moments);
+    }
+
+    /*!
+     * \brief Convert the moments of the linear system of a periodic spline to the
+     *        moments of all sampling points.
+     *
+     * The system does not contain the moment of the first sampling point because it is
+     * identical to the one of the last.
+     */
+    void expandPeriodicMoments_(Vector& moments) const
+    {
         moments.resize(numSamples());
         for (int i = static_cast<int>(numSamples()) - 2; i >= 0; --i) {
             unsigned ui = static_cast<unsigned>(i);
             moments[ui+1] = moments[ui];
         }
         moments[0] = moments[numSamples() - 1];
+    }
+
+    /*!
+     * \brief Copy the sampling points of a spline which uses a shared system of
+     *        equations and make sure that they are compatible with it.
+     */
+    template <class ScalarContainerX, class ScalarContainerY>
+    void assignSharedSystemSamples_(const ScalarContainerX& x,
+                                    const ScalarContainerY& y,
+                                    const MomentSystem& system)
+    {
+        if (x.size() != system.numSamples() || y.size() != system.numSamples())
+            OPM_THROW(std::invalid_argument,
+                      "The number of sampling points does not match the shared system");
+
+        setNumSamples_(system.numSamples());
+        std::copy(x.begin(), x.end(), xPos_.begin());
+        std::copy(y.begin(), y.end(), yPos_.begin());
+
+        if (xPos_ != system.xPos_)
+            OPM_THROW(std::invalid_argument,
+                      "The x values of the sampling points differ from the ones of the shared system");
+    }
+
+    /*!
+     * \brief Compute the slopes at the sampling points using a factorized system of
+     *        equations.
+     */
+    void makeSplineFromSystem_(const MomentSystem& system, Scalar m0, Scalar m1)
+    {
+        size_t numRows = system.factorization_.size();
+        Vector d(numRows);
+        Vector moments(numRows);
+
+        if (system.splineType() == Full)
+            this->makeFullRhs_(d, m0, m1);
+        else if (system.splineType() == Natural)
+            this->makeNaturalRhs_(d);
+        else
+            this->makePeriodicRhs_(d);
+
+        // solve for the moments (-> second derivatives)
+        system.factorization_.solve(moments, d);
+
+        if (system.splineType() == Periodic)
+            this->expandPeriodicMoments_(moments);
 
         // convert the moments to slopes at the sample points
         this->setSlopesFromMoments_(slopeVec_, moments);
@@ -1267,17 +1673,42 @@ protected:
     template <class Vector, class Matrix>
     void makeFullSystem_(Matrix& M, Vector& d, Scalar m0, Scalar m1)
     {
-        makeNaturalSystem_(M, d);
+        makeFullMatrix_(M);
+        makeFullRhs_(d, m0, m1);
+    }
+
+    /*!
+     * \brief Make the matrix of the linear system of equations of the full spline.
+     *
+     * The matrix only depends on the x values of the sampling points.
+     */
+    template <class Matrix>
+    void makeFullMatrix_(Matrix& M)
+    {
+        makeNaturalMatrix_(M);
 
         size_t n = numSamples() - 1;
         // first row
         M[0][1] = 1;
-        d[0] = 6/h_(1) * ( (y_(1) - y_(0))/h_(1) - m0);
 
         // last row
         M[n][n - 1] = 1;
+    }
+
+    /*!
+     * \brief Make the right hand side of the linear system of equations of the full
+     *        spline.
+     */
+    template <class Vector>
+    void makeFullRhs_(Vector& d, Scalar m0, Scalar m1)
+    {
+        makeNaturalRhs_(d);
+
+        size_t n = numSamples() - 1;
+        // first row
+        d[0] = 6/h_(1) * ( (y_(1) - y_(0))/h_(1) - m0);
 
-        // right hand side
+        // last row
         d[n] =
             6/h_(n)
             *
@@ -1290,6 +1721,18 @@ protected:
      */
     template <class Vector, class Matrix>
     void makeNaturalSystem_(Matrix& M, Vector& d)
+    {
+        makeNaturalMatrix_(M);
+        makeNaturalRhs_(d);
+    }
+
+    /*!
+     * \brief Make the matrix of the linear system of equations of the natural spline.
+     *
+     * The matrix only depends on the x values of the sampling points.
+     */
+    template <class Matrix>
+    void makeNaturalMatrix_(Matrix& M)
     {
         M = 0.0;
 
@@ -1301,32 +1744,52 @@ protected:
         for (size_t i = 1; i < n; ++i) {
             Scalar lambda_i = h_(i + 1) / (h_(i) + h_(i + 1));
             Scalar mu_i = 1 - lambda_i;
-            Scalar d_i =
-                6 / (h_(i) + h_(i + 1))
-                *
-                ( (y_(i + 1) - y_(i))/h_(i + 1) - (y_(i) - y_(i - 1))/h_(i));
 
             M[i][i-1] = mu_i;
             M[i][i] = 2;
             M[i][i + 1] = lambda_i;
-            d[i] = d_i;
         };
 
         // See Stroer, equation (2.5.2.7)
         Scalar lambda_0 = 0;
-        Scalar d_0 = 0;
-
         Scalar mu_n = 0;
-        Scalar d_n = 0;
 
         // first row
         M[0][0] = 2;
         M[0][1] = lambda_0;
-        d[0] = d_0;
 
         // last row
         M[n][n-1] = mu_n;
         M[n][n] = 2;
+    }
+
+    /*!
+     * \brief Make the right hand side of the linear system of equations of the natural
+     *        spline.
+     */
+    template <class Vector>
+    void makeNaturalRhs_(Vector& d)
+    {
+        size_t n = numSamples() - 1;
+
+        // second to next to last rows
+        for (size_t i = 1; i < n; ++i) {
+            Scalar d_i =
+                6 / (h_(i) + h_(i + 1))
+                *
+                ( (y_(i + 1) - y_(i))/h_(i + 1) - (y_(i) - y_(i - 1))/h_(i));
+
+            d[i] = d_i;
+        };
+
+        // See Stroer, equation (2.5.2.7)
+        Scalar d_0 = 0;
+        Scalar d_n = 0;
+
+        // first row
+        d[0] = d_0;
+
+        // last row
         d[n] = d_n;
     }
 
@@ -1336,6 +1799,18 @@ protected:
      */
     template <class Matrix, class Vector>
     void makePeriodicSystem_(Matrix& M, Vector& d)
+    {
+        makePeriodicMatrix_(M);
+        makePeriodicRhs_(d);
+    }
+
+    /*!
+     * \brief Make the matrix of the linear system of equations of the periodic spline.
+     *
+     * The matrix only depends on the x values of the sampling points.
+     */
+    template <class Matrix>
+    void makePeriodicMatrix_(Matrix& M)
     {
         M = 0.0;
 
@@ -1349,15 +1824,10 @@ protected:
         for (size_t i = 2; i < n; ++i) {
             Scalar lambda_i = h_(i + 1) / (h_(i) + h_(i + 1));
             Scalar mu_i = 1 - lambda_i;
-            Scalar d_i =
-                6 / (h_(i) + h_(i + 1))
-                *
-                ( (y_(i + 1) - y_(i))/h_(i + 1) - (y_(i) - y_(i - 1))/h_(i));
 
             M[i-1][i-2] = mu_i;
             M[i-1][i-1] = 2;
             M[i-1][i] = lambda_i;
-            d[i-1] = d_i;
         };
 
         Scalar lambda_n = h_(1) / (h_(n) + h_(1));
@@ -1365,6 +1835,36 @@ protected:
         Scalar mu_1 = 1 - lambda_1;
         Scalar mu_n = 1 - lambda_n;
 
+        // first row
+        M[0][0] = 2;
+        M[0][1] = lambda_1;
+        M[0][n-1] = mu_1;
+
+        // last row
+        M[n-1][0] = lambda_n;
+        M[n-1][n-2] = mu_n;
+        M[n-1][n-1] = 2;
+    }
+
+    /*!
+     * \brief Make the right hand side of the linear system of equations of the periodic
+     *        spline.
+     */
+    template <class Vector>
+    void makePeriodicRhs_(Vector& d)
+    {
+        size_t n = numSamples() - 1;
+
+        // second to next to last rows
+        for (size_t i = 2; i < n; ++i) {
+            Scalar d_i =
+                6 / (h_(i) + h_(i + 1))
+                *
+                ( (y_(i + 1) - y_(i))/h_(i + 1) - (y_(i) - y_(i - 1))/h_(i));
+
+            d[i-1] = d_i;
+        };
+
         Scalar d_1 =
             6 / (h_(1) + h_(2))
             *
@@ -1374,17 +1874,10 @@ protected:
             *
             ( (y_(1) - y_(n))/h_(1) - (y_(n) - y_(n-1))/h_(n));
 
-
         // first row
-        M[0][0] = 2;
-        M[0][1] = lambda_1;
-        M[0][n-1] = mu_1;
         d[0] = d_1;
 
         // last row
-        M[n-1][0] = lambda_n;
-        M[n-1][n-2] = mu_n;
-        M[n-1][n-1] = 2;
         d[n-1] = d_n;
     }
 
@@ -1399,43 +1892,13 @@ protected:
     template <class Vector>
     void makeMonotonicSpline_(Vector& slopes)
     {
-        auto n = numSamples();
-
-        // calculate the slopes of the secant lines
-        std::vector<Scalar> delta(n);
-        for (size_t k = 0; k < n - 1; ++k)
-            delta[k] = (y_(k + 1) - y_(k))/(x_(k + 1) - x_(k));
-
-        // calculate the "raw" slopes at the sample points
-        for (size_t k = 1; k < n - 1; ++k)
-            slopes[k] = (delta[k - 1] + delta[k])/2;
-        slopes[0] = delta[0];
-        slopes[n - 1] = delta[n - 2];
-
-        // post-process the "raw" slopes at the sample points
-        for (size_t k = 0; k < n - 1; ++k) {
-            if (std::abs(delta[k]) < 1e-50) {
-                // make the spline flat if the inputs are equal
-                slopes[k] = 0;
-                slopes[k + 1] = 0;
-                ++ k;
-                continue;
-            }
-            else {
-                Scalar alpha = slopes[k] / delta[k];
-                Scalar beta = slopes[k + 1] / delta[k];
-
-                if (alpha < 0 || (k > 0 && slopes[k] / delta[k - 1] < 0)) {
-                    slopes[k] = 0;
-                }
-                // limit (alpha, beta) to a circle of radius 3
-                else if (alpha*alpha + beta*beta > 3*3) {
-                    Scalar tau = 3.0/std::sqrt(alpha*alpha + beta*beta);
-                    slopes[k] = tau*alpha*delta[k];
-                    slopes[k + 1] = tau*beta*delta[k];
-                }
-            }
+        size_t n = numSamples();
+        std::vector<Scalar> xValues(n), yValues(n);
+        for (size_t k = 0; k < n; ++k) {
+            xValues[k] = x_(k);
+            yValues[k] = y_(k);
         }
+        monotonicSlopes(n, xValues, yValues, slopes);
     }
 
     /*!
@@ -1503,6 +1966,13 @@ protected:
     template <class Evaluation>
     Evaluation eval_(const Evaluation& x, size_t i) const
     {
+        if (!coeffs_.empty()) {
+            // use the precomputed coefficients of the segment
+            const Scalar* c = &coeffs_[4*i];
+            const Evaluation& t = x - x_(i);
+            return ((c[3]*t + c[2])*t + c[1])*t + c[0];
+        }
+
         // See http://en.wikipedia.org/wiki/Cubic_Hermite_spline
         Scalar delta = h_(i + 1);
         Evaluation t = (x - x_(i))/delta;
@@ -1743,10 +2213,26 @@ protected:
     // find the segment index for a given x coordinate
     size_t segmentIdx_(Scalar x) const
     {
-        // bisection
         size_t iLow = 0;
         size_t iHigh = numSamples() - 1;
 
+        // narrow down the interval for the bisection using the bucket which
+        // contains x. usually this interval only contains one or two segments.
+        if (!segmentLookupIdx_.empty() && x_(0) <= x) {
+            size_t bucketIdx = static_cast<size_t>((x - x_(0))*lookupInvBucketWidth_);
+            bucketIdx = std::min(bucketIdx, segmentLookupIdx_.size() - 2);
+
+            size_t lowerCandIdx = segmentLookupIdx_[bucketIdx];
+            size_t upperCandIdx = std::min<size_t>(segmentLookupIdx_[bucketIdx + 1] + 1, iHigh);
+
+            // guard against rounding errors when computing the bucket index
+            if (x_(lowerCandIdx) <= x && x < x_(upperCandIdx)) {
+                iLow = lowerCandIdx;
+                iHigh = upperCandIdx;
+            }
+        }
+
+        // bisection
         while (iLow + 1 < iHigh) {
             size_t i = (iLow + iHigh) / 2;
             if (x_(i) > x)
@@ -1809,6 +2295,13 @@ protected:
     Vector xPos_;
     Vector yPos_;
     Vector slopeVec_;
+
+    // coefficients of the segments in terms of (x - x_i), see precomputeCoefficients()
+    Vector coeffs_;
+
+    // acceleration structure for segmentIdx_()
+    std::vector<unsigned> segmentLookupIdx_;
+    Scalar lookupInvBucketWidth_;
 };
 }
 
@@ -0,0 +1,132 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Functions to find the saturation and PVT regions whose tables are identical.
+ *
+ * Decks often specify the same table for many regions. The tables are compared by
+ * their serialized content (see BinarySerialization.hpp): The content of each entry is
+ * written to a binary blob, and only the entries whose blobs exhibit the same hash value
+ * are compared byte by byte.
+ */
+#ifndef OPM_MATERIAL_TABLE_DEDUPLICATION_HPP
+#define OPM_MATERIAL_TABLE_DEDUPLICATION_HPP
+
+#include <opm/material/common/BinarySerialization.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Opm {
+
+namespace TableDeduplicationDetail {
+// the 64 bit FNV-1a hash of a blob
+inline std::uint64_t blobHash(const std::vector<char>& blob)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : blob) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+}
+
+/*!
+ * \brief Find the entries of a sequence which exhibit the same content as a previous
+ *        one.
+ *
+ * \param numEntries The number of entries
+ * \param serializeEntry A function which is called as serializeEntry(writer, idx) and
+ *                       writes everything which determines the content of entry 'idx'
+ *                       to the BinaryWriter.
+ * \return The index of the first entry with the same content for each entry. For the
+ *         entries whose content differs from all previous ones, this is their own index.
+ */
+template <class SerializeFunction>
+std::vector<unsigned> findIdenticalEntries(size_t numEntries,
+                                           const SerializeFunction& serializeEntry)
+{
+    std::vector<unsigned> sourceIdx(numEntries);
+    std::vector<std::vector<char> > blobs(numEntries);
+    std::unordered_map<std::uint64_t, std::vector<unsigned> > candidates;
+
+    for (unsigned idx = 0; idx < numEntries; ++idx) {
+        BinaryWriter writer;
+        serializeEntry(writer, idx);
+        blobs[idx] = writer.data();
+
+        sourceIdx[idx] = idx;
+        auto& sameHashIdx = candidates[TableDeduplicationDetail::blobHash(blobs[idx])];
+        for (unsigned candidateIdx : sameHashIdx) {
+            if (blobs[candidateIdx] == blobs[idx]) {
+                sourceIdx[idx] = candidateIdx;
+                break;
+            }
+        }
+
+        if (sourceIdx[idx] == idx)
+            sameHashIdx.push_back(idx);
+        else
+            std::vector<char>().swap(blobs[idx]);
+    }
+
+    return sourceIdx;
+}
+
+/*!
+ * \brief Let the shared pointers of a vector which reference objects of identical
+ *        content point to the same object.
+ *
+ * The objects must either be plain old data or provide a serialize() method, null
+ * pointers are left alone. The objects which are no longer referenced are released.
+ *
+ * \return The number of pointers which were redirected to an object of a previous entry
+ */
+template <class T>
+unsigned shareIdenticalObjects(std::vector<std::shared_ptr<T> >& objects)
+{
+    const std::vector<unsigned>& sourceIdx =
+        findIdenticalEntries(objects.size(), [&objects](BinaryWriter& writer, unsigned idx) {
+                writer.write(static_cast<std::uint8_t>(objects[idx] != nullptr));
+                if (objects[idx])
+                    writer.writeObject(*objects[idx]);
+            });
+
+    unsigned numShared = 0;
+    for (unsigned idx = 0; idx < objects.size(); ++idx) {
+        if (sourceIdx[idx] == idx || !objects[idx])
+            continue;
+
+        objects[idx] = objects[sourceIdx[idx]];
+        ++numShared;
+    }
+    return numShared;
+}
+
+} // namespace Opm
+
+#endif
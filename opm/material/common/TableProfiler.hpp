@@ -0,0 +1,354 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Records the access pattern of the lookups in tabulated functions.
+ *
+ * If the OPM_MATERIAL_PROFILE_TABLES macro is set to a non-zero value,
+ * Opm::Tabulated1DFunction, Opm::UniformXTabulated2DFunction,
+ * Opm::UniformXTabulated2DMultiFunction and the parameters of
+ * Opm::PiecewiseLinearTwoPhaseMaterial record for each table instance
+ *
+ * - the number of lookups,
+ * - how often each segment was hit,
+ * - how often a lookup hit the same segment as the previous lookup of the same
+ *   thread in the same table and
+ * - how often the table was extrapolated.
+ *
+ * This tells whether the lookup hints or a uniform resampling of a table would pay
+ * off for a given deck. The tables are reported by the names which were assigned via
+ * their setProfileName() methods; the PVT classes and the EclMaterialLawManager use
+ * names like "PVTO region 3 invB" or "SWOF region 1 krw". The statistics of tables
+ * which have the same name, e.g., copies of a table, are summed up.
+ *
+ * If the macro is zero (the default), the tables do not store any profiling data and
+ * setProfileName() does nothing. Since opm-material is header-only, the macro must be
+ * set consistently for all translation units of a program, e.g., using the
+ * OPM_MATERIAL_PROFILE_TABLES CMake option of this module.
+ *
+ * The lookups are recorded by the OPM_MATERIAL_PROFILE_TABLE() macro, which expands to
+ * nothing if profiling is disabled.
+ *
+ * Like the counters of opm/material/common/Instrumentation.hpp, the data is recorded
+ * per thread and tableProfileReport() or printTableProfiles() must not be called
+ * while other threads perform lookups.
+ */
+#ifndef OPM_MATERIAL_TABLE_PROFILER_HPP
+#define OPM_MATERIAL_TABLE_PROFILER_HPP
+
+#ifndef OPM_MATERIAL_PROFILE_TABLES
+#define OPM_MATERIAL_PROFILE_TABLES 0
+#endif
+
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if OPM_MATERIAL_PROFILE_TABLES
+#include <limits>
+#include <memory>
+#include <mutex>
+#endif
+
+namespace Opm {
+
+/*!
+ * \brief The lookup statistics of a table, summed up over all threads.
+ */
+struct TableLookupStatistics
+{
+    TableLookupStatistics()
+        : numLookups(0)
+        , numRepeatedSegment(0)
+        , numExtrapolations(0)
+    {}
+
+    //! The number of lookups which hit each segment
+    std::vector<std::uint64_t> segmentHits;
+    //! The total number of lookups
+    std::uint64_t numLookups;
+    //! The number of lookups which hit the same segment as the previous one
+    std::uint64_t numRepeatedSegment;
+    //! The number of lookups outside of the range of the table
+    std::uint64_t numExtrapolations;
+
+    void add(const TableLookupStatistics& other)
+    {
+        if (segmentHits.size() < other.segmentHits.size())
+            segmentHits.resize(other.segmentHits.size(), 0);
+        for (size_t i = 0; i < other.segmentHits.size(); ++i)
+            segmentHits[i] += other.segmentHits[i];
+        numLookups += other.numLookups;
+        numRepeatedSegment += other.numRepeatedSegment;
+        numExtrapolations += other.numExtrapolations;
+    }
+};
+
+#if OPM_MATERIAL_PROFILE_TABLES
+namespace TableProfilerDetail {
+struct ThreadTableData
+{
+    ThreadTableData()
+        : lastSegment(std::numeric_limits<size_t>::max())
+    {}
+
+    TableLookupStatistics statistics;
+    size_t lastSegment;
+};
+
+// the data of all table instances for a single thread, indexed by the table id
+typedef std::vector<ThreadTableData> ThreadData;
+
+class Registry
+{
+public:
+    static Registry& instance()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    unsigned createTable(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names_.push_back(name);
+        return static_cast<unsigned>(names_.size() - 1);
+    }
+
+    void setName(unsigned tableId, const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names_[tableId] = name;
+    }
+
+    std::string name(unsigned tableId)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_[tableId];
+    }
+
+    ThreadData* createThread()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        threadData_.emplace_back(new ThreadData());
+        return threadData_.back().get();
+    }
+
+    std::map<std::string, TableLookupStatistics> report()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, TableLookupStatistics> result;
+        for (const auto& data : threadData_) {
+            for (size_t tableId = 0; tableId < data->size(); ++tableId) {
+                const auto& stats = (*data)[tableId].statistics;
+                if (stats.numLookups == 0)
+                    continue;
+
+                std::string tableName = names_[tableId];
+                if (tableName.empty())
+                    tableName = "unnamed table #" + std::to_string(tableId);
+                result[tableName].add(stats);
+            }
+        }
+        return result;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& data : threadData_)
+            data->clear();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::string> names_;
+    std::vector<std::unique_ptr<ThreadData> > threadData_;
+};
+
+inline ThreadData& threadData()
+{
+    static thread_local ThreadData* data = Registry::instance().createThread();
+    return *data;
+}
+} // namespace TableProfilerDetail
+#endif // OPM_MATERIAL_PROFILE_TABLES
+
+/*!
+ * \brief The profiling data of a single table instance.
+ *
+ * Tables store an object of this class if profiling is enabled. Copies of a profile
+ * get the name of the original but record their lookups separately.
+ */
+class TableProfile
+{
+public:
+#if OPM_MATERIAL_PROFILE_TABLES
+    TableProfile()
+        : id_(TableProfilerDetail::Registry::instance().createTable(""))
+    {}
+
+    TableProfile(const TableProfile& other)
+        : id_(TableProfilerDetail::Registry::instance().createTable(other.name()))
+    {}
+
+    TableProfile& operator=(const TableProfile& other)
+    {
+        if (this != &other)
+            setName(other.name());
+        return *this;
+    }
+
+    void setName(const std::string& name)
+    { TableProfilerDetail::Registry::instance().setName(id_, name); }
+
+    std::string name() const
+    { return TableProfilerDetail::Registry::instance().name(id_); }
+
+    /*!
+     * \brief Record a lookup which used a given segment of the table.
+     */
+    void record(size_t segIdx, bool extrapolated) const
+    {
+        auto& threadData = TableProfilerDetail::threadData();
+        if (threadData.size() <= id_)
+            threadData.resize(id_ + 1);
+
+        auto& tableData = threadData[id_];
+        auto& stats = tableData.statistics;
+        if (stats.segmentHits.size() <= segIdx)
+            stats.segmentHits.resize(segIdx + 1, 0);
+
+        ++ stats.segmentHits[segIdx];
+        ++ stats.numLookups;
+        if (tableData.lastSegment == segIdx)
+            ++ stats.numRepeatedSegment;
+        if (extrapolated)
+            ++ stats.numExtrapolations;
+        tableData.lastSegment = segIdx;
+    }
+
+private:
+    unsigned id_;
+#else
+    void setName(const std::string& /* name */)
+    {}
+
+    std::string name() const
+    { return ""; }
+
+    void record(size_t /* segIdx */, bool /* extrapolated */) const
+    {}
+#endif
+};
+
+/*!
+ * \brief Return the lookup statistics of all tables which have been used, indexed by
+ *        their names.
+ *
+ * If table profiling is disabled, the result is empty.
+ */
+inline std::map<std::string, TableLookupStatistics> tableProfileReport()
+{
+#if OPM_MATERIAL_PROFILE_TABLES
+    return TableProfilerDetail::Registry::instance().report();
+#else
+    return std::map<std::string, TableLookupStatistics>();
+#endif
+}
+
+/*!
+ * \brief Discard the recorded lookups of all tables.
+ */
+inline void resetTableProfiles()
+{
+#if OPM_MATERIAL_PROFILE_TABLES
+    TableProfilerDetail::Registry::instance().reset();
+#endif
+}
+
+/*!
+ * \brief Print a summary of the lookup statistics of all tables.
+ *
+ * For each table, the number of lookups, the fraction of lookups which hit the same
+ * segment as the previous one, the number of extrapolations and the number of
+ * distinct segments which were hit are printed. If 'printHistograms' is true, the
+ * number of hits of each segment is printed as well.
+ */
+inline void printTableProfiles(std::ostream& os, bool printHistograms = false)
+{
+#if OPM_MATERIAL_PROFILE_TABLES
+    const std::ios_base::fmtflags oldFlags = os.flags();
+    const std::streamsize oldPrecision = os.precision();
+
+    os << "opm-material table lookups:\n"
+       << "  " << std::left << std::setw(40) << "table"
+       << std::right << std::setw(14) << "lookups"
+       << std::setw(10) << "repeated"
+       << std::setw(14) << "extrapolated"
+       << std::setw(14) << "segments hit" << "\n";
+    for (const auto& entry : tableProfileReport()) {
+        const auto& stats = entry.second;
+        size_t numSegmentsHit = 0;
+        for (auto hits : stats.segmentHits)
+            if (hits > 0)
+                ++ numSegmentsHit;
+
+        double repeatedRatio = static_cast<double>(stats.numRepeatedSegment)/stats.numLookups;
+        os << "  " << std::left << std::setw(40) << entry.first
+           << std::right << std::setw(14) << stats.numLookups
+           << std::setw(9) << std::fixed << std::setprecision(1) << repeatedRatio*100 << "%"
+           << std::setw(14) << stats.numExtrapolations
+           << std::setw(14) << numSegmentsHit << "\n";
+
+        if (printHistograms) {
+            os << "    hits per segment:";
+            for (size_t segIdx = 0; segIdx < stats.segmentHits.size(); ++segIdx)
+                if (stats.segmentHits[segIdx] > 0)
+                    os << " " << segIdx << ":" << stats.segmentHits[segIdx];
+            os << "\n";
+        }
+    }
+
+    os.flags(oldFlags);
+    os.precision(oldPrecision);
+#else
+    os << "opm-material table profiling is disabled (OPM_MATERIAL_PROFILE_TABLES=0)\n";
+    (void) printHistograms;
+#endif
+}
+
+} // namespace Opm
+
+#if OPM_MATERIAL_PROFILE_TABLES
+#define OPM_MATERIAL_PROFILE_TABLE(profile, segIdx, extrapolated)  \
+    (profile).record(segIdx, extrapolated)
+#else
+#define OPM_MATERIAL_PROFILE_TABLE(profile, segIdx, extrapolated) do {} while (false)
+#endif
+
+#endif
@@ -0,0 +1,311 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Helpers to remove the sampling points of piecewise linear tables which do
+ *        not contribute to their shape.
+ *
+ * A sampling point can be removed if the curve obtained by interpolating between its
+ * neighbors deviates from it by at most a given tolerance. Since both curves are
+ * piecewise linear, their largest deviation occurs at one of the original sampling
+ * points, so checking these is sufficient to bound the error of the simplified table.
+ */
+#ifndef OPM_MATERIAL_TABLE_SIMPLIFICATION_HPP
+#define OPM_MATERIAL_TABLE_SIMPLIFICATION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <ios>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief The number of sampling points of a set of tables before and after they were
+ *        simplified.
+ */
+class TableSimplificationStats
+{
+public:
+    TableSimplificationStats()
+        : numSamplesBefore_(0)
+        , numSamplesAfter_(0)
+    { }
+
+    /*!
+     * \brief Account the sampling points of a table.
+     */
+    void add(std::size_t numSamplesBefore, std::size_t numSamplesAfter)
+    {
+        numSamplesBefore_ += numSamplesBefore;
+        numSamplesAfter_ += numSamplesAfter;
+    }
+
+    /*!
+     * \brief Forget all tables which were accounted so far.
+     */
+    void clear()
+    {
+        numSamplesBefore_ = 0;
+        numSamplesAfter_ = 0;
+    }
+
+    /*!
+     * \brief The number of sampling points of the original tables.
+     */
+    std::size_t numSamplesBefore() const
+    { return numSamplesBefore_; }
+
+    /*!
+     * \brief The number of sampling points of the simplified tables.
+     */
+    std::size_t numSamplesAfter() const
+    { return numSamplesAfter_; }
+
+    /*!
+     * \brief The fraction of the sampling points which were removed.
+     */
+    double reduction() const
+    {
+        if (numSamplesBefore_ == 0)
+            return 0.0;
+        return 1.0 - double(numSamplesAfter_)/numSamplesBefore_;
+    }
+
+    /*!
+     * \brief Print a one-line summary to a stream.
+     */
+    void print(std::ostream& os, const std::string& name) const
+    {
+        const std::ios_base::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << name << ": " << numSamplesAfter_ << " of " << numSamplesBefore_
+           << " sampling points kept (" << std::fixed << std::setprecision(1)
+           << 100.0*reduction() << "% removed)\n";
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+private:
+    std::size_t numSamplesBefore_;
+    std::size_t numSamplesAfter_;
+};
+
+/*!
+ * \brief Determine the sampling points of a table which are required.
+ *
+ * The first and the last sampling point are always required. canSkip(lowerIdx,
+ * sampleIdx, upperIdx) must return whether the sampling point sampleIdx is reproduced
+ * by interpolating between the sampling points lowerIdx and upperIdx. Starting at the
+ * first sampling point, the segments are extended greedily as long as all sampling
+ * points within them can be skipped.
+ */
+template <class SkipPredicate>
+std::vector<bool> findRequiredSamples(std::size_t numSamples, const SkipPredicate& canSkip)
+{
+    std::vector<bool> isRequired(numSamples, false);
+    if (numSamples == 0)
+        return isRequired;
+
+    isRequired.front() = true;
+    isRequired.back() = true;
+
+    std::size_t lowerIdx = 0;
+    while (lowerIdx + 1 < numSamples) {
+        std::size_t upperIdx = lowerIdx + 1;
+        while (upperIdx + 1 < numSamples) {
+            bool extensible = true;
+            for (std::size_t sampleIdx = lowerIdx + 1; sampleIdx <= upperIdx && extensible; ++sampleIdx)
+                extensible = canSkip(lowerIdx, sampleIdx, upperIdx + 1);
+            if (!extensible)
+                break;
+            ++upperIdx;
+        }
+
+        isRequired[upperIdx] = true;
+        lowerIdx = upperIdx;
+    }
+
+    return isRequired;
+}
+
+/*!
+ * \brief Return whether a sampling point of a piecewise linear curve deviates from the
+ *        line between two other sampling points by at most a given tolerance.
+ *
+ * The sampling point must be located strictly between the other two, so sampling
+ * points which are part of a jump of the curve are never skipped.
+ */
+template <class XVector, class YVector, class Scalar>
+bool isNearlyCollinear(const XVector& xValues,
+                       const YVector& yValues,
+                       std::size_t lowerIdx,
+                       std::size_t sampleIdx,
+                       std::size_t upperIdx,
+                       Scalar tolerance)
+{
+    const Scalar x0 = xValues[lowerIdx];
+    const Scalar x1 = xValues[upperIdx];
+    const Scalar x = xValues[sampleIdx];
+    if (!(x0 < x && x < x1))
+        return false;
+
+    const Scalar y0 = yValues[lowerIdx];
+    const Scalar y1 = yValues[upperIdx];
+    const Scalar y = y0 + (x - x0)*(y1 - y0)/(x1 - x0);
+    return std::abs(y - Scalar(yValues[sampleIdx])) <= tolerance;
+}
+
+/*!
+ * \brief Return the difference between the largest and the smallest value of a
+ *        container.
+ */
+template <class Container>
+typename Container::value_type valueRange(const Container& values)
+{
+    if (values.empty())
+        return 0;
+
+    const auto& minMax = std::minmax_element(values.begin(), values.end());
+    return *minMax.second - *minMax.first;
+}
+
+/*!
+ * \brief Remove the entries of a vector which are not required.
+ */
+template <class T, class Allocator>
+void selectSamples(std::vector<T, Allocator>& values, const std::vector<bool>& isRequired)
+{
+    std::size_t numKept = 0;
+    for (std::size_t sampleIdx = 0; sampleIdx < values.size(); ++sampleIdx)
+        if (isRequired[sampleIdx])
+            values[numKept++] = values[sampleIdx];
+    values.resize(numKept);
+}
+
+/*!
+ * \brief Evaluate the i-th column of a UniformXTabulated2DFunction at a given position
+ *        on the y-axis.
+ *
+ * Positions outside of the range of the column are linearly extrapolated, i.e., the
+ * column is evaluated the same way as by the table itself.
+ */
+template <class Table, class Scalar>
+Scalar evalTableColumn(const Table& table, std::size_t i, Scalar y)
+{
+    const std::size_t n = table.numY(i);
+    if (n == 1)
+        return table.valueAt(i, 0);
+
+    std::size_t j = 0;
+    while (j + 2 < n && table.yAt(i, j + 1) <= y)
+        ++j;
+
+    const Scalar y0 = table.yAt(i, j);
+    const Scalar y1 = table.yAt(i, j + 1);
+    const Scalar v0 = table.valueAt(i, j);
+    const Scalar v1 = table.valueAt(i, j + 1);
+    return v0 + (y - y0)*(v1 - v0)/(y1 - y0);
+}
+
+/*!
+ * \brief Return whether a column of a UniformXTabulated2DFunction is reproduced by
+ *        interpolating between two other columns.
+ *
+ * The interpolated table is compared to the original one at the sampling points of
+ * all three columns, which bounds the deviation for all positions between the first
+ * and the last of them.
+ */
+template <class Table, class Scalar>
+bool canSkipTableColumn(const Table& table,
+                        std::size_t lowerIdx,
+                        std::size_t colIdx,
+                        std::size_t upperIdx,
+                        Scalar tolerance)
+{
+    const Scalar x0 = table.xAt(lowerIdx);
+    const Scalar x1 = table.xAt(upperIdx);
+    const Scalar x = table.xAt(colIdx);
+    if (!(x0 < x && x < x1))
+        return false;
+
+    const Scalar alpha = (x - x0)/(x1 - x0);
+    const std::size_t cols[3] = { lowerIdx, colIdx, upperIdx };
+    for (std::size_t c : cols) {
+        for (std::size_t j = 0; j < table.numY(c); ++j) {
+            const Scalar y = table.yAt(c, j);
+            const Scalar interpolated =
+                (1 - alpha)*evalTableColumn(table, lowerIdx, y)
+                + alpha*evalTableColumn(table, upperIdx, y);
+            if (std::abs(interpolated - evalTableColumn(table, colIdx, y)) > tolerance)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Return a copy of a UniformXTabulated2DFunction which only contains the
+ *        required columns and the required sampling points of each column.
+ *
+ * isRequiredSample[i] specifies the sampling points which are required for the
+ * i-th column of the original table.
+ */
+template <class Table>
+Table selectTableSamples(const Table& table,
+                         const std::vector<bool>& isRequiredColumn,
+                         const std::vector<std::vector<bool> >& isRequiredSample)
+{
+    std::size_t numColumns = 0;
+    std::size_t numSamples = 0;
+    for (std::size_t i = 0; i < table.numX(); ++i) {
+        if (!isRequiredColumn[i])
+            continue;
+        ++numColumns;
+        numSamples += std::count(isRequiredSample[i].begin(), isRequiredSample[i].end(), true);
+    }
+
+    Table result;
+    result.reserve(numColumns, numSamples);
+    for (std::size_t i = 0; i < table.numX(); ++i) {
+        if (!isRequiredColumn[i])
+            continue;
+
+        const std::size_t newIdx = result.appendXPos(table.xAt(i));
+        for (std::size_t j = 0; j < table.numY(i); ++j)
+            if (isRequiredSample[i][j])
+                result.appendSamplePoint(newIdx, table.yAt(i, j), table.valueAt(i, j));
+    }
+
+    return result;
+}
+
+} // namespace Opm
+
+#endif
@@ -27,32 +27,53 @@
 #ifndef OPM_TABULATED_1D_FUNCTION_HPP
 #define OPM_TABULATED_1D_FUNCTION_HPP
 
+#include <opm/material/common/TabulationLookupHint.hpp>
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/ErrorStatus.hpp>
+#include <opm/material/common/FlatTables.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/MonotoneCubicInterpolation.hpp>
+#include <opm/material/common/TableProfiler.hpp>
 #include <opm/material/densead/Math.hpp>
+#include <opm/material/densead/ExpressionTemplates.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/Unused.hpp>
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace Opm {
 /*!
  * \brief Implements a linearly interpolated scalar function that depends on one
  *        variable.
+ *
+ * Optionally, the sampling points can be interpolated by monotone cubic Hermite
+ * polynomials instead, see setInterpolation().
  */
 template <class Scalar>
 class Tabulated1DFunction
 {
 public:
+    //! The type of the objects which cache the segment found by the last lookup
+    typedef TabulationLookupHint<1> LookupHint;
+
     /*!
      * \brief Default constructor for a piecewise linear function.
      *
      * To specfiy the acutal curve, use one of the set() methods.
      */
     Tabulated1DFunction()
+        : lookupInvBucketWidth_(0.0)
+        , interpolation_(TableInterpolation::Linear)
     {}
 
     /*!
@@ -67,6 +88,7 @@ public:
                         const ScalarArrayX& x,
                         const ScalarArrayY& y,
                         bool sortInputs = true)
+        : interpolation_(TableInterpolation::Linear)
     { this->setXYArrays(nSamples, x, y, sortInputs); }
 
     /*!
@@ -81,8 +103,19 @@ public:
     Tabulated1DFunction(const ScalarContainer& x,
                         const ScalarContainer& y,
                         bool sortInputs = true)
+        : interpolation_(TableInterpolation::Linear)
     { this->setXYContainers(x, y, sortInputs); }
 
+    /*!
+     * \brief Convenience constructor for a piecewise linear function which takes over
+     *        the memory of the vectors of sampling points.
+     */
+    Tabulated1DFunction(std::vector<Scalar>&& x,
+                        std::vector<Scalar>&& y,
+                        bool sortInputs = true)
+        : interpolation_(TableInterpolation::Linear)
+    { this->setXYContainers(std::move(x), std::move(y), sortInputs); }
+
     /*!
      * \brief Convenience constructor for a piecewise linear function.
      *
@@ -92,6 +125,7 @@ public:
     template <class PointContainer>
     Tabulated1DFunction(const PointContainer& points,
                         bool sortInputs = true)
+        : interpolation_(TableInterpolation::Linear)
     { this->setContainerOfTuples(points, sortInputs); }
 
     /*!
@@ -117,6 +151,9 @@ public:
             sortInput_();
         else if (xValues_[0] > xValues_[numSamples() - 1])
             reverseSamplingPoints_();
+
+        updateSegmentLookup_();
+        updateSlopes_();
     }
 
     /*!
@@ -140,6 +177,34 @@ public:
             sortInput_();
         else if (xValues_[0] > xValues_[numSamples() - 1])
             reverseSamplingPoints_();
+
+        updateSegmentLookup_();
+        updateSlopes_();
+    }
+
+    /*!
+     * \brief Set the sampling points for the piecewise linear function
+     *
+     * This method takes over the memory of the vectors instead of copying them, so no
+     * allocations are required if the sampling points are already sorted.
+     */
+    void setXYContainers(std::vector<Scalar>&& x,
+                         std::vector<Scalar>&& y,
+                         bool sortInputs = true)
+    {
+        assert(x.size() == y.size());
+        assert(x.size() > 1);
+
+        xValues_ = std::move(x);
+        yValues_ = std::move(y);
+
+        if (sortInputs)
+            sortInput_();
+        else if (xValues_[0] > xValues_[numSamples() - 1])
+            reverseSamplingPoints_();
+
+        updateSegmentLookup_();
+        updateSlopes_();
     }
 
     /*!
@@ -164,6 +229,9 @@ public:
             sortInput_();
         else if (xValues_[0] > xValues_[numSamples() - 1])
             reverseSamplingPoints_();
+
+        updateSegmentLookup_();
+        updateSlopes_();
     }
 
     /*!
@@ -200,8 +268,34 @@ public:
             sortInput_();
         else if (xValues_[0] > xValues_[numSamples() - 1])
             reverseSamplingPoints_();
+
+        updateSegmentLookup_();
+        updateSlopes_();
+    }
+
+    /*!
+     * \brief Set the scheme which is used to interpolate between the sampling points.
+     *
+     * By default, the function is piecewise linear. With
+     * TableInterpolation::MonotoneCubic, it is continuously differentiable and
+     * monotonic wherever the sampling points are, see MonotoneCubicInterpolation. In
+     * both cases, the sampling points are reproduced exactly and the function is
+     * extrapolated by straight lines. The scheme can be set before or after the
+     * sampling points.
+     */
+    void setInterpolation(TableInterpolation value)
+    {
+        interpolation_ = value;
+        updateSlopes_();
     }
 
+    /*!
+     * \brief Returns the scheme which is used to interpolate between the sampling
+     *        points.
+     */
+    TableInterpolation interpolation() const
+    { return interpolation_; }
+
     /*!
      * \brief Returns the number of sampling points.
      */
@@ -232,6 +326,99 @@ public:
     Scalar valueAt(size_t i) const
     { return yValues_[i]; }
 
+    /*!
+     * \brief Set the name under which the lookups of the function are reported if
+     *        table profiling is enabled.
+     *
+     * See opm/material/common/TableProfiler.hpp. If profiling is disabled, this
+     * method does nothing.
+     */
+    void setProfileName(const std::string& name)
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        profile_.setName(name);
+#else
+        (void) name;
+#endif
+    }
+
+    /*!
+     * \brief Returns the number of bytes allocated by the function for its sampling
+     *        points and its lookup index.
+     *
+     * The size of the object itself is not included.
+     */
+    std::size_t heapMemoryUsage() const
+    {
+        return
+            vectorMemoryUsage(xValues_)
+            + vectorMemoryUsage(yValues_)
+            + vectorMemoryUsage(slopes_)
+            + vectorMemoryUsage(cubicCoeffs_)
+            + vectorMemoryUsage(segmentLookupIdx_);
+    }
+
+    /*!
+     * \brief Write the sampling points and the lookup index to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(xValues_);
+        writer.write(yValues_);
+        writer.write(segmentLookupIdx_);
+        writer.write(lookupInvBucketWidth_);
+        writer.write(static_cast<std::int32_t>(interpolation_));
+    }
+
+    /*!
+     * \brief Restore a function which was written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(xValues_);
+        reader.read(yValues_);
+        reader.read(segmentLookupIdx_);
+        reader.read(lookupInvBucketWidth_);
+        std::int32_t interpolation;
+        reader.read(interpolation);
+
+        if (xValues_.size() != yValues_.size())
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: inconsistent sampling points");
+        if (interpolation < static_cast<std::int32_t>(TableInterpolation::Linear)
+            || interpolation > static_cast<std::int32_t>(TableInterpolation::MonotoneCubic))
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: invalid interpolation scheme " << interpolation);
+        interpolation_ = static_cast<TableInterpolation>(interpolation);
+
+        // the slopes and the coefficients of the cubic segments are not serialized
+        // because they can be cheaply recomputed
+        updateSlopes_();
+    }
+
+    /*!
+     * \brief Append the sampling points to a flat table buffer and return the
+     *        descriptor of the function.
+     *
+     * The flat function always extrapolates, i.e., it corresponds to calling eval()
+     * with extrapolate set to true. Flat functions are piecewise linear, so functions
+     * which use monotone cubic interpolation cannot be exported.
+     */
+    template <class FlatScalar>
+    FlatTabulated1DFunction<FlatScalar> exportFlat(FlatTableBuffer<FlatScalar>& buffer) const
+    {
+        if (numSamples() < 2)
+            OPM_THROW(std::logic_error, "Only functions with at least two sampling points can be exported");
+        if (interpolation_ != TableInterpolation::Linear)
+            OPM_THROW(std::logic_error, "Only piecewise linear functions can be exported");
+
+        FlatTabulated1DFunction<FlatScalar> result;
+        result.xOffset = buffer.appendScalars(xValues_.begin(), xValues_.end());
+        result.yOffset = buffer.appendScalars(yValues_.begin(), yValues_.end());
+        result.numSamples = static_cast<unsigned>(numSamples());
+        result.clampRange = false;
+        return result;
+    }
+
     /*!
      * \brief Return true iff the given x is in range [x1, xn].
      */
@@ -255,22 +442,174 @@ public:
             OPM_THROW(Opm::NumericalProblem,
                       "Tried to evaluate a tabulated function outside of its range");
 
+        OPM_MATERIAL_COUNT(tabulated1DEval);
+
         size_t segIdx;
 
-        if (extrapolate && x < xValues_.front())
+        if (extrapolate && x < xValues_.front()) {
+            OPM_MATERIAL_COUNT(tabulated1DExtrapolation);
             segIdx = 0;
-        else if (extrapolate && x > xValues_.back())
+        }
+        else if (extrapolate && x > xValues_.back()) {
+            OPM_MATERIAL_COUNT(tabulated1DExtrapolation);
             segIdx = numSamples() - 2;
+        }
         else
             segIdx = findSegmentIndex_(Opm::scalarValue(x));
 
-        Scalar x0 = xValues_[segIdx];
-        Scalar x1 = xValues_[segIdx + 1];
+        OPM_MATERIAL_PROFILE_TABLE(profile_, segIdx, !applies(x));
+        return eval_(x, segIdx);
+    }
 
-        Scalar y0 = yValues_[segIdx];
-        Scalar y1 = yValues_[segIdx + 1];
+    /*!
+     * \brief Evaluate the function at a given position using a lookup hint.
+     *
+     * The result is identical to that of the eval() method which does not take a hint,
+     * but the segment stored in the hint and its right neighbor are checked before the
+     * full search is done. Afterwards, the hint contains the segment which was used.
+     */
+    template <class Evaluation>
+    Evaluation eval(const Evaluation& x, LookupHint& hint, bool extrapolate = false) const
+    {
+        if (!extrapolate && !applies(x))
+            OPM_THROW(Opm::NumericalProblem,
+                      "Tried to evaluate a tabulated function outside of its range");
+
+        OPM_MATERIAL_COUNT(tabulated1DEval);
+
+        size_t segIdx;
+
+        if (extrapolate && x < xValues_.front()) {
+            OPM_MATERIAL_COUNT(tabulated1DExtrapolation);
+            segIdx = 0;
+        }
+        else if (extrapolate && x > xValues_.back()) {
+            OPM_MATERIAL_COUNT(tabulated1DExtrapolation);
+            segIdx = numSamples() - 2;
+        }
+        else {
+            size_t hintIdx = std::min<size_t>(hint.segmentIdx(), numSamples() - 2);
+            segIdx = findSegmentIndex_(Opm::scalarValue(x), hintIdx);
+        }
+
+        OPM_MATERIAL_PROFILE_TABLE(profile_, segIdx, !applies(x));
+        hint.setSegmentIdx(0, static_cast<unsigned>(segIdx));
+        return eval_(x, segIdx);
+    }
+
+    /*!
+     * \brief Evaluate the function at a contiguous array of positions.
+     *
+     * This is equivalent to calling eval() for each entry of the array, but the
+     * segment which was found for a given position is used as the starting point for
+     * the search of the next one. If the positions are sorted or if neighboring
+     * positions are close to each other (e.g., if the array contains the pressures
+     * of all cells of a grid), the bisection is thus skipped for most entries.
+     *
+     * \param numValues The number of positions which ought to be evaluated
+     * \param x Pointer to the first position on the abscissa
+     * \param result Pointer to the first entry of the array which receives the
+     *               function values. It must be able to hold numValues entries.
+     * \param extrapolate If this parameter is set to true, the function will be extended
+     *                    beyond its range by straight lines, if false calling
+     *                    extrapolate for \f$ x \not [x_{min}, x_{max}]\f$ will cause
+     *                    an exception to be thrown.
+     *
+     * If the results are plain scalars while the positions are Evaluations, only the
+     * values of the positions are used, i.e., no derivatives are computed.
+     */
+    template <class InputEvaluation, class Evaluation>
+    void evalMany(size_t numValues,
+                  const InputEvaluation* x,
+                  Evaluation* result,
+                  bool extrapolate = false) const
+    {
+        OPM_MATERIAL_COUNT_N(tabulated1DEval, numValues);
+
+        size_t segIdx = 0;
+        for (size_t i = 0; i < numValues; ++i) {
+            const auto& xi = Opm::decay<Evaluation>(x[i]);
+            if (!extrapolate && !applies(xi))
+                OPM_THROW(Opm::NumericalProblem,
+                          "Tried to evaluate a tabulated function outside of its range");
+
+            if (extrapolate && xi < xValues_.front()) {
+                OPM_MATERIAL_COUNT(tabulated1DExtrapolation);
+                segIdx = 0;
+            }
+            else if (extrapolate && xi > xValues_.back()) {
+                OPM_MATERIAL_COUNT(tabulated1DExtrapolation);
+                segIdx = numSamples() - 2;
+            }
+            else
+                segIdx = findSegmentIndex_(Opm::scalarValue(xi), segIdx);
+
+            OPM_MATERIAL_PROFILE_TABLE(profile_, segIdx, !applies(xi));
+            result[i] = eval_(xi, segIdx);
+        }
+    }
+
+    /*!
+     * \brief Evaluate the function at all positions of an STL-compatible container.
+     *
+     * The result container is resized to the size of the container of positions. See
+     * the pointer based variant of this method for details.
+     */
+    template <class InputContainer, class ResultContainer>
+    void evalMany(const InputContainer& x,
+                  ResultContainer& result,
+                  bool extrapolate = false) const
+    {
+        result.resize(x.size());
+        evalMany(x.size(), x.data(), result.data(), extrapolate);
+    }
 
-        return y0 + (y1 - y0)*(x - x0)/(x1 - x0);
+    /*!
+     * \brief Evaluate the function at a given position without throwing.
+     *
+     * Positions outside of the range of the function are extrapolated by straight lines
+     * and recorded as ErrorStatus::TableOutOfRange for the calling thread.
+     */
+    template <class Evaluation>
+    Evaluation evalNoThrow(const Evaluation& x) const
+    {
+        if (!applies(x))
+            ErrorStatus::record(ErrorStatus::TableOutOfRange);
+        return eval(x, /*extrapolate=*/true);
+    }
+
+    /*!
+     * \brief Evaluate the function at a given position using a lookup hint without
+     *        throwing.
+     *
+     * See evalNoThrow() for how positions outside of the range are treated.
+     */
+    template <class Evaluation>
+    Evaluation evalNoThrow(const Evaluation& x, LookupHint& hint) const
+    {
+        if (!applies(x))
+            ErrorStatus::record(ErrorStatus::TableOutOfRange);
+        return eval(x, hint, /*extrapolate=*/true);
+    }
+
+    /*!
+     * \brief Evaluate the function at a contiguous array of positions without throwing.
+     *
+     * The number of positions which are outside of the range of the function is
+     * recorded once as ErrorStatus::TableOutOfRange after the loop.
+     */
+    template <class Evaluation>
+    void evalManyNoThrow(size_t numValues,
+                         const Evaluation* x,
+                         Evaluation* result) const
+    {
+        size_t numOutside = 0;
+        for (size_t i = 0; i < numValues; ++i)
+            numOutside += applies(x[i]) ? 0 : 1;
+        if (numOutside > 0)
+            ErrorStatus::record(ErrorStatus::TableOutOfRange, numOutside);
+
+        evalMany(numValues, x, result, /*extrapolate=*/true);
     }
 
     /*!
@@ -297,11 +636,32 @@ public:
         return evalDerivative_(x, segIdx);
     }
 
+    /*!
+     * \brief Evaluate the function's derivative at a given position using a lookup
+     *        hint.
+     *
+     * If the function and its derivative are evaluated at the same position using the
+     * same hint, the segment is only searched once.
+     */
+    template <class Evaluation>
+    Evaluation evalDerivative(const Evaluation& x, LookupHint& hint, bool extrapolate = false) const
+    {
+        if (!extrapolate && !applies(x)) {
+            OPM_THROW(Opm::NumericalProblem,
+                      "Tried to evaluate a derivative of a tabulated"
+                      " function outside of its range");
+        }
+
+        size_t hintIdx = std::min<size_t>(hint.segmentIdx(), numSamples() - 2);
+        size_t segIdx = findSegmentIndex_(Opm::scalarValue(x), hintIdx);
+        hint.setSegmentIdx(0, static_cast<unsigned>(segIdx));
+        return evalDerivative_(x, segIdx);
+    }
+
     /*!
      * \brief Evaluate the function's second derivative at a given position.
      *
-     * Since this class represents a piecewise linear function, this method will always
-     * return 0.
+     * For piecewise linear functions, this method always returns 0.
      *
      * \param x The value on the abscissa where the function's
      *          derivative ought to be evaluated
@@ -320,14 +680,18 @@ public:
                       " function outside of its range");
         }
 
-        return 0.0;
+        if (cubicCoeffs_.empty())
+            return 0.0;
+
+        size_t segIdx = findSegmentIndex_(Opm::scalarValue(x));
+        return MonotoneCubic::evalSecondDerivative(&cubicCoeffs_[MonotoneCubic::numCoeffs*segIdx],
+                                                   xValues_[segIdx], xValues_[segIdx + 1], x);
     }
 
     /*!
      * \brief Evaluate the function's third derivative at a given position.
      *
-     * Since this class represents a piecewise linear function, this method will always
-     * return 0.
+     * For piecewise linear functions, this method always returns 0.
      *
      * \param x The value on the abscissa where the function's
      *          derivative ought to be evaluated
@@ -346,7 +710,12 @@ public:
                       " function outside of its range");
         }
 
-        return 0.0;
+        if (cubicCoeffs_.empty())
+            return 0.0;
+
+        size_t segIdx = findSegmentIndex_(Opm::scalarValue(x));
+        return MonotoneCubic::evalThirdDerivative(&cubicCoeffs_[MonotoneCubic::numCoeffs*segIdx],
+                                                  xValues_[segIdx], xValues_[segIdx + 1], x);
     }
 
     /*!
@@ -473,19 +842,70 @@ public:
     }
 
 private:
-    size_t findSegmentIndex_(Scalar x) const
+    typedef MonotoneCubicInterpolation<Scalar> MonotoneCubic;
+
+    template <class Evaluation>
+    Evaluation eval_(const Evaluation& x, size_t segIdx) const
+    {
+        Scalar x0 = xValues_[segIdx];
+        Scalar y0 = yValues_[segIdx];
+
+        if (!cubicCoeffs_.empty())
+            return MonotoneCubic::eval(&cubicCoeffs_[MonotoneCubic::numCoeffs*segIdx],
+                                       x0, xValues_[segIdx + 1],
+                                       y0, yValues_[segIdx + 1],
+                                       x);
+
+        // evaluate the whole expression in a single pass over the derivatives. since
+        // the slope is precomputed, this only requires a multiplication per entry.
+        return Opm::DenseAd::evaluate(y0 + (Opm::DenseAd::lazy(x) - x0)*slopes_[segIdx]);
+    }
+
+    // find the index of the segment which contains a given x value. hintIdx is the
+    // index of the segment which is checked before resorting to bisection. (It and
+    // its right neighbor are tried.) hintIdx must be smaller than numSamples() - 1.
+    size_t findSegmentIndex_(Scalar x, size_t hintIdx = 0) const
     {
         // we need at least two sampling points!
         assert(xValues_.size() >= 2);
+        assert(hintIdx < xValues_.size() - 1);
 
         if (x <= xValues_[1])
             return 0;
         else if (x >= xValues_[xValues_.size() - 2])
             return xValues_.size() - 2;
         else {
-            // bisection
+            // the segment of the hint or its right neighbor. since the first and
+            // the last segment were already dealt with above, the result is the same
+            // as that of the bisection
+            if (xValues_[hintIdx] <= x && x < xValues_[hintIdx + 1])
+                return hintIdx;
+            else if (hintIdx + 2 < xValues_.size()
+                     && xValues_[hintIdx + 1] <= x
+                     && x < xValues_[hintIdx + 2])
+                return hintIdx + 1;
+
+            // narrow down the interval for the bisection using the bucket which
+            // contains x. usually this interval only contains one or two
+            // segments.
             size_t segmentIdx = 1;
             size_t upperIdx = xValues_.size() - 2;
+            if (!segmentLookupIdx_.empty()) {
+                size_t bucketIdx =
+                    static_cast<size_t>((x - xValues_.front())*lookupInvBucketWidth_);
+                bucketIdx = std::min(bucketIdx, segmentLookupIdx_.size() - 2);
+
+                size_t lowerCandIdx = std::max<size_t>(segmentLookupIdx_[bucketIdx], 1);
+                size_t upperCandIdx = std::min<size_t>(segmentLookupIdx_[bucketIdx + 1] + 1, upperIdx);
+
+                // guard against rounding errors when computing the bucket index
+                if (xValues_[lowerCandIdx] <= x && x < xValues_[upperCandIdx]) {
+                    segmentIdx = lowerCandIdx;
+                    upperIdx = upperCandIdx;
+                }
+            }
+
+            // bisection
             while (segmentIdx + 1 < upperIdx) {
                 size_t pivotIdx = (segmentIdx + upperIdx) / 2;
                 if (x < xValues_[pivotIdx])
@@ -501,15 +921,12 @@ private:
     }
 
     template <class Evaluation>
-    Evaluation evalDerivative_(const Evaluation& x OPM_UNUSED, size_t segIdx) const
+    Evaluation evalDerivative_(const Evaluation& x, size_t segIdx) const
     {
-        Scalar x0 = xValues_[segIdx];
-        Scalar x1 = xValues_[segIdx + 1];
-
-        Scalar y0 = yValues_[segIdx];
-        Scalar y1 = yValues_[segIdx + 1];
-
-        return (y1 - y0)/(x1 - x0);
+        if (!cubicCoeffs_.empty())
+            return MonotoneCubic::evalDerivative(&cubicCoeffs_[MonotoneCubic::numCoeffs*segIdx],
+                                                 xValues_[segIdx], xValues_[segIdx + 1], x);
+        return slopes_[segIdx];
     }
 
     // returns the monotonicity of a segment
@@ -562,6 +979,11 @@ private:
      */
     void sortInput_()
     {
+        // tables from the deck are usually sorted already. this avoids the temporary
+        // arrays in this case
+        if (std::is_sorted(xValues_.begin(), xValues_.end()))
+            return;
+
         size_t n = numSamples();
 
         // create a vector containing 0...n-1
@@ -580,8 +1002,8 @@ private:
             tmpX[i] = xValues_[idxVector[i]];
             tmpY[i] = yValues_[idxVector[i]];
         }
-        xValues_ = tmpX;
-        yValues_ = tmpY;
+        xValues_.swap(tmpX);
+        yValues_.swap(tmpY);
     }
 
     /*!
@@ -598,6 +1020,72 @@ private:
         }
     }
 
+    /*!
+     * \brief Build the index which maps uniformly sized buckets of the abscissa to the
+     *        first segment which overlaps with them.
+     *
+     * The bucket width is chosen such that for tables with reasonably evenly spaced
+     * sampling points, a bucket overlaps with only one or two segments. For tables with
+     * less than four sampling points, bisection is cheap and the index is not built.
+     */
+    void updateSegmentLookup_()
+    {
+        segmentLookupIdx_.clear();
+        lookupInvBucketWidth_ = 0.0;
+
+        size_t n = numSamples();
+        if (n < 4)
+            return;
+
+        Scalar range = xValues_.back() - xValues_.front();
+        if (!(range > 0.0))
+            return;
+
+        Scalar minWidth = range;
+        for (size_t i = 0; i < n - 1; ++i)
+            if (xValues_[i + 1] > xValues_[i])
+                minWidth = std::min(minWidth, xValues_[i + 1] - xValues_[i]);
+
+        // use between one and four buckets per segment
+        size_t numBuckets = n - 1;
+        Scalar idealNumBuckets = std::ceil(range/minWidth);
+        if (idealNumBuckets > static_cast<Scalar>(4*(n - 1)))
+            numBuckets = 4*(n - 1);
+        else if (idealNumBuckets > static_cast<Scalar>(numBuckets))
+            numBuckets = static_cast<size_t>(idealNumBuckets);
+
+        lookupInvBucketWidth_ = numBuckets/range;
+        segmentLookupIdx_.resize(numBuckets + 1);
+        size_t segIdx = 0;
+        for (size_t bucketIdx = 0; bucketIdx <= numBuckets; ++bucketIdx) {
+            Scalar xBucket = xValues_.front() + bucketIdx*range/numBuckets;
+            while (segIdx < n - 2 && xValues_[segIdx + 1] <= xBucket)
+                ++segIdx;
+            segmentLookupIdx_[bucketIdx] = static_cast<unsigned>(segIdx);
+        }
+    }
+
+    /*!
+     * \brief Compute the slopes of all segments and, if the function uses monotone
+     *        cubic interpolation, the coefficients of the cubic segments.
+     *
+     * This avoids the division by the width of the segment when the function is
+     * evaluated, which would otherwise be done for the value and each derivative of
+     * the argument.
+     */
+    void updateSlopes_()
+    {
+        size_t n = numSamples();
+        slopes_.resize(n > 0 ? n - 1 : 0);
+        for (size_t segIdx = 0; segIdx + 1 < n; ++segIdx)
+            slopes_[segIdx] =
+                (yValues_[segIdx + 1] - yValues_[segIdx])/(xValues_[segIdx + 1] - xValues_[segIdx]);
+
+        cubicCoeffs_.clear();
+        if (interpolation_ == TableInterpolation::MonotoneCubic && n > 1)
+            MonotoneCubic::computeCoefficients(cubicCoeffs_, n, xValues_, yValues_);
+    }
+
     /*!
      * \brief Resizes the internal vectors to store the sample points.
      */
@@ -609,6 +1097,23 @@ private:
 
     std::vector<Scalar> xValues_;
     std::vector<Scalar> yValues_;
+
+    // the slopes of the segments, i.e., (y_{i+1} - y_i)/(x_{i+1} - x_i)
+    std::vector<Scalar> slopes_;
+
+    // the coefficients of the segments if monotone cubic interpolation is used, else
+    // empty
+    std::vector<Scalar> cubicCoeffs_;
+
+    // acceleration structure for findSegmentIndex_()
+    std::vector<unsigned> segmentLookupIdx_;
+    Scalar lookupInvBucketWidth_;
+
+    TableInterpolation interpolation_;
+
+#if OPM_MATERIAL_PROFILE_TABLES
+    TableProfile profile_;
+#endif
 };
 } // namespace Opm
 
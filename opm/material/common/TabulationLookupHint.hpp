@@ -0,0 +1,86 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::TabulationLookupHint
+ */
+#ifndef OPM_TABULATION_LOOKUP_HINT_HPP
+#define OPM_TABULATION_LOOKUP_HINT_HPP
+
+#include <array>
+
+namespace Opm {
+
+/*!
+ * \brief Stores the indices of the segments of a tabulated function which were found
+ *        by the last lookup.
+ *
+ * Objects of this class are intended to be kept by the caller for each degree of
+ * freedom (e.g., for each cell of a grid) and to be passed to the eval() methods of the
+ * tabulated functions. Since the position at which a function is evaluated usually
+ * only changes slightly between Newton iterations, the segment which was found last
+ * time is checked first and the search is only done if the position has left it.
+ *
+ * A hint never changes the result of a lookup, it only affects how fast it is: the
+ * returned values are the same as if the method which does not take a hint was called.
+ * If the same hint object is used for different tables, lookups merely get slower.
+ *
+ * \tparam numIndicesV The number of segment indices which are required by the
+ *                     tabulated function, e.g., one for Tabulated1DFunction and three
+ *                     for UniformXTabulated2DFunction.
+ */
+template <unsigned numIndicesV = 1>
+class TabulationLookupHint
+{
+public:
+    static const unsigned numIndices = numIndicesV;
+
+    TabulationLookupHint()
+    { reset(); }
+
+    /*!
+     * \brief Forget all segments which were found so far.
+     */
+    void reset()
+    { segmentIdx_.fill(0); }
+
+    /*!
+     * \brief Return the index of the segment which was found by the last lookup.
+     */
+    unsigned segmentIdx(unsigned idx = 0) const
+    { return segmentIdx_[idx]; }
+
+    /*!
+     * \brief Set the index of the segment which ought to be checked first by the next
+     *        lookup.
+     */
+    void setSegmentIdx(unsigned idx, unsigned value)
+    { segmentIdx_[idx] = value; }
+
+private:
+    std::array<unsigned, numIndices> segmentIdx_;
+};
+
+} // namespace Opm
+
+#endif
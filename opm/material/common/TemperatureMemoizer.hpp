@@ -0,0 +1,172 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::TemperatureMemoizer
+ */
+#ifndef OPM_TEMPERATURE_MEMOIZER_HPP
+#define OPM_TEMPERATURE_MEMOIZER_HPP
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+
+namespace Opm {
+
+/*!
+ * \brief Caches the values of a quantity which only depends on temperature.
+ *
+ * Many component and binary coefficient routines only take the temperature as their
+ * argument, e.g., the vapor pressures of the components or Henry coefficients. In
+ * isothermal or nearly isothermal simulations, these are evaluated for the same
+ * temperatures over and over again. This class remembers the value and the temperature
+ * derivative of such a function for the few temperatures which were used last, so that
+ * evaluations for both, scalars and Opm::DenseAd::Evaluation objects, can be served
+ * by the cache: For the latter, the derivatives of the result are obtained by the
+ * chain rule.
+ *
+ * On a cache miss, the function is called using a DenseAd evaluation with a single
+ * derivative, i.e., the function must be a template or accept DerivativeEvaluation
+ * objects. Since cached entries are keyed on the temperature only, each memoizer object
+ * must be used for a single function. An object is not thread safe, but perThread()
+ * provides a separate memoizer for each thread and each tag type:
+ *
+ * \code
+ * typedef Opm::TemperatureMemoizer<double> Memoizer;
+ * struct VaporPressureTag {};
+ *
+ * const auto& pSat =
+ *     Memoizer::perThread<VaporPressureTag>().eval(temperature,
+ *                                                  &H2O::vaporPressure<Memoizer::DerivativeEvaluation>);
+ * \endcode
+ *
+ * \tparam Scalar The floating point type of the cached values
+ * \tparam numEntriesV The number of temperatures which are remembered
+ */
+template <class Scalar, unsigned numEntriesV = 4>
+class TemperatureMemoizer
+{
+public:
+    static const unsigned numEntries = numEntriesV;
+
+    //! The type which is used to evaluate the memoized function on cache misses
+    typedef Opm::DenseAd::Evaluation<Scalar, 1> DerivativeEvaluation;
+
+    TemperatureMemoizer()
+    { clear(); }
+
+    /*!
+     * \brief Return the memoizer object of the calling thread for a given tag.
+     *
+     * The tag type is only used to distinguish the memoizers of different functions.
+     */
+    template <class Tag>
+    static TemperatureMemoizer& perThread()
+    {
+        static thread_local TemperatureMemoizer memoizer;
+        return memoizer;
+    }
+
+    /*!
+     * \brief Forget all cached values.
+     *
+     * This needs to be called if the memoized function changes, e.g., because its
+     * parameters were modified.
+     */
+    void clear()
+    {
+        numValid_ = 0;
+        lastIdx_ = 0;
+        replaceIdx_ = 0;
+    }
+
+    /*!
+     * \brief Returns the number of temperatures for which the value is currently known.
+     */
+    unsigned size() const
+    { return numValid_; }
+
+    /*!
+     * \brief Evaluate a temperature dependent function, using the cached value if the
+     *        function has been evaluated at the same temperature before.
+     *
+     * \param temperature The temperature [K]. If this is a DenseAd evaluation, the
+     *                    derivatives of the result are computed by the chain rule.
+     * \param fn The function. It gets called with a DerivativeEvaluation object whose
+     *           derivative is the one with regard to temperature.
+     */
+    template <class Evaluation, class Function>
+    Evaluation eval(const Evaluation& temperature, const Function& fn)
+    {
+        Scalar T = Opm::scalarValue(temperature);
+        const Entry& entry = lookup_(T, fn);
+
+        // f(T) + f'(T)*dT, which is exactly f(T) for the value of the result
+        return entry.value + entry.derivative*(temperature - T);
+    }
+
+private:
+    struct Entry
+    {
+        Scalar temperature;
+        Scalar value;
+        Scalar derivative;
+    };
+
+    template <class Function>
+    const Entry& lookup_(Scalar T, const Function& fn)
+    {
+        // the entry which was used last is the most likely one to match
+        if (numValid_ > 0 && entries_[lastIdx_].temperature == T)
+            return entries_[lastIdx_];
+
+        for (unsigned i = 0; i < numValid_; ++i) {
+            if (entries_[i].temperature == T) {
+                lastIdx_ = i;
+                return entries_[i];
+            }
+        }
+
+        // cache miss: replace the entries in a round robin fashion
+        unsigned idx = replaceIdx_;
+        replaceIdx_ = (replaceIdx_ + 1) % numEntries;
+        if (numValid_ < numEntries)
+            ++numValid_;
+
+        const DerivativeEvaluation& result = fn(DerivativeEvaluation::createVariable(T, 0));
+        entries_[idx].temperature = T;
+        entries_[idx].value = result.value();
+        entries_[idx].derivative = result.derivative(0);
+        lastIdx_ = idx;
+        return entries_[idx];
+    }
+
+    Entry entries_[numEntries];
+    unsigned numValid_;
+    unsigned lastIdx_;
+    unsigned replaceIdx_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,158 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Named scopes for the entry points of the fluid systems, the PVT classes, the
+ *        material laws and the flash solvers.
+ *
+ * Since opm-material is header-only and most of its code gets inlined, sampling
+ * profilers attribute the time spent in it to the functions of the simulator which
+ * call it. The OPM_MATERIAL_TRACE_SCOPE("Class::method") macro marks the remainder of
+ * the enclosing block as a named range of an external tracing tool, so that the
+ * time spent in the most important methods becomes visible in its timeline and flame
+ * graphs. The tool is selected by the OPM_MATERIAL_TRACING macro:
+ *
+ * - 0 (default): OPM_MATERIAL_TRACE_SCOPE() expands to nothing.
+ * - 1: NVIDIA Tools Extension (NVTX). Requires the header-only NVTX 3 library
+ *   (nvtx3/nvToolsExt.h) and linking against libdl.
+ * - 2: Intel Instrumentation and Tracing Technology (ITT) as used by VTune. Requires
+ *   ittnotify.h and linking against libittnotify.
+ * - 3: Tracy. Requires the Tracy client (Tracy.hpp) compiled with TRACY_ENABLE.
+ * - 4: Custom hooks. The program must define the functions
+ *   Opm::Tracing::beginScope(const char*) and Opm::Tracing::endScope(), e.g. to
+ *   forward the scopes to a different tool.
+ *
+ * The argument of OPM_MATERIAL_TRACE_SCOPE() must be a string literal. Like for the
+ * instrumentation macros in opm/material/common/Instrumentation.hpp, OPM_MATERIAL_TRACING
+ * must be set consistently for all translation units of a program, e.g., using the
+ * OPM_MATERIAL_TRACING CMake cache variable of this module. Note that the cost of a
+ * scope is considerable compared to the small methods which are marked, so the
+ * absolute timings of a traced build are distorted.
+ */
+#ifndef OPM_MATERIAL_TRACING_HPP
+#define OPM_MATERIAL_TRACING_HPP
+
+#ifndef OPM_MATERIAL_TRACING
+#define OPM_MATERIAL_TRACING 0
+#endif
+
+#if OPM_MATERIAL_TRACING == 1
+#include <nvtx3/nvToolsExt.h>
+#elif OPM_MATERIAL_TRACING == 2
+#include <ittnotify.h>
+#elif OPM_MATERIAL_TRACING == 3
+#include <Tracy.hpp>
+#elif OPM_MATERIAL_TRACING > 4
+#error "Invalid value of OPM_MATERIAL_TRACING, expected 0 (off), 1 (NVTX), 2 (ITT), 3 (Tracy) or 4 (custom)"
+#endif
+
+namespace Opm {
+namespace Tracing {
+
+#if OPM_MATERIAL_TRACING == 1
+/*!
+ * \brief Pushes an NVTX range on construction and pops it on destruction.
+ */
+class NvtxScope
+{
+public:
+    explicit NvtxScope(const char* name)
+    { nvtxRangePushA(name); }
+
+    ~NvtxScope()
+    { nvtxRangePop(); }
+
+    NvtxScope(const NvtxScope&) = delete;
+    NvtxScope& operator=(const NvtxScope&) = delete;
+};
+
+#elif OPM_MATERIAL_TRACING == 2
+// all scopes of opm-material are reported within the same ITT domain
+inline __itt_domain* ittDomain()
+{
+    static __itt_domain* domain = __itt_domain_create("opm-material");
+    return domain;
+}
+
+/*!
+ * \brief Begins an ITT task on construction and ends it on destruction.
+ *
+ * The string handle is created once per scope by the macro.
+ */
+class IttScope
+{
+public:
+    explicit IttScope(__itt_string_handle* name)
+    { __itt_task_begin(ittDomain(), __itt_null, __itt_null, name); }
+
+    ~IttScope()
+    { __itt_task_end(ittDomain()); }
+
+    IttScope(const IttScope&) = delete;
+    IttScope& operator=(const IttScope&) = delete;
+};
+
+#elif OPM_MATERIAL_TRACING == 4
+// these functions must be defined by the program
+void beginScope(const char* name);
+void endScope();
+
+/*!
+ * \brief Calls the custom hooks on construction and destruction.
+ */
+class CustomScope
+{
+public:
+    explicit CustomScope(const char* name)
+    { beginScope(name); }
+
+    ~CustomScope()
+    { endScope(); }
+
+    CustomScope(const CustomScope&) = delete;
+    CustomScope& operator=(const CustomScope&) = delete;
+};
+#endif
+
+} // namespace Tracing
+} // namespace Opm
+
+#if OPM_MATERIAL_TRACING == 1
+#define OPM_MATERIAL_TRACE_SCOPE(name)                                  \
+    ::Opm::Tracing::NvtxScope opmMaterialTraceScope_(name)
+#elif OPM_MATERIAL_TRACING == 2
+#define OPM_MATERIAL_TRACE_SCOPE(name)                                  \
+    static __itt_string_handle* const opmMaterialTraceName_ =           \
+        __itt_string_handle_create(name);                               \
+    ::Opm::Tracing::IttScope opmMaterialTraceScope_(opmMaterialTraceName_)
+#elif OPM_MATERIAL_TRACING == 3
+#define OPM_MATERIAL_TRACE_SCOPE(name) ZoneScopedN(name)
+#elif OPM_MATERIAL_TRACING == 4
+#define OPM_MATERIAL_TRACE_SCOPE(name)                                  \
+    ::Opm::Tracing::CustomScope opmMaterialTraceScope_(name)
+#else
+#define OPM_MATERIAL_TRACE_SCOPE(name) do {} while (false)
+#endif
+
+#endif
@@ -36,6 +36,9 @@
 
 namespace Opm {
 
+template <class Scalar>
+class TridiagonalFactorization;
+
 /*!
  * \brief Provides a tridiagonal matrix that also supports non-zero
  *        entries in the upper right and lower left
@@ -49,6 +52,8 @@ namespace Opm {
 template <class Scalar>
 class TridiagonalMatrix
 {
+    friend class TridiagonalFactorization<Scalar>;
+
     struct TridiagRow_ {
         TridiagRow_(TridiagonalMatrix& m, size_t rowIdx)
             : matrix_(m)
@@ -709,15 +714,13 @@ public:
      *
      * i.e., calculate x, so that it solves Ax = b, where A is a
      * tridiagonal matrix.
+     *
+     * If several systems with the same matrix need to be solved, use a
+     * TridiagonalFactorization object to avoid repeating the elimination.
      */
     template <class XVector, class BVector>
     void solve(XVector& x, const BVector& b) const
-    {
-        if (size() > 2 && std::abs(diag_[2][0]) < 1e-30)
-            solveWithUpperRight_(x, b);
-        else
-            solveWithoutUpperRight_(x, b);
-    }
+    { TridiagonalFactorization<Scalar>(*this).solve(x, b); }
 
     /*!
      * \brief Print the matrix to a given output stream.
@@ -760,87 +763,162 @@ public:
     }
 
 private:
-    template <class XVector, class BVector>
-    void solveWithUpperRight_(XVector& x, const BVector& b) const
-    {
-        size_t n = size();
+    mutable std::vector<Scalar> diag_[3];
+};
 
-        std::vector<Scalar> lowerDiag(diag_[0]), mainDiag(diag_[1]), upperDiag(diag_[2]), lastColumn(n);
-        std::vector<Scalar> bStar(n);
-        std::copy(b.begin(), b.end(), bStar.begin());
+/*!
+ * \brief The elimination of a TridiagonalMatrix which can be used to solve linear
+ *        systems of equations for any number of right hand sides.
+ *
+ * The work which only depends on the matrix is done once by factorize(), solving a
+ * system afterwards only requires a forward and a backward substitution. The results
+ * are identical to the ones of TridiagonalMatrix::solve().
+ */
+template <class Scalar>
+class TridiagonalFactorization
+{
+public:
+    TridiagonalFactorization()
+        : withUpperRight_(false)
+        , withLowerLeft_(false)
+        , upperRight_(0.0)
+    {}
 
-        lastColumn[0] = upperDiag[0];
+    explicit TridiagonalFactorization(const TridiagonalMatrix<Scalar>& matrix)
+    { factorize(matrix); }
 
-        // forward elimination
-        for (size_t i = 1; i < n; ++i) {
-            Scalar alpha = lowerDiag[i - 1]/mainDiag[i - 1];
+    /*!
+     * \brief Eliminate the lower diagonal of a matrix.
+     */
+    void factorize(const TridiagonalMatrix<Scalar>& matrix)
+    {
+        size_t n = matrix.size();
+        const auto& lowerDiag = matrix.diag_[0];
+        mainDiag_ = matrix.diag_[1];
+        upperDiag_ = matrix.diag_[2];
 
-            lowerDiag[i - 1] -= alpha * mainDiag[i - 1];
-            mainDiag[i] -= alpha * upperDiag[i];
+        withUpperRight_ = n > 2 && std::abs(upperDiag_[0]) < 1e-30;
+        upperRight_ = upperDiag_[0];
 
-            bStar[i] -= alpha * bStar[i - 1];
-        };
+        // forward elimination
+        alpha_.resize(n);
+        for (size_t i = 1; i < n; ++i) {
+            alpha_[i] = lowerDiag[i - 1]/mainDiag_[i - 1];
+            mainDiag_[i] -= alpha_[i] * upperDiag_[i];
+        }
 
         // deal with the last row if the entry on the lower left is not zero
-        if (lowerDiag[n - 1] != 0.0 && size() > 2) {
+        withLowerLeft_ = n > 2 && lowerDiag[n - 1] != 0.0;
+        lastRowAlpha_.clear();
+        if (withLowerLeft_) {
+            lastRowAlpha_.resize(n - 1);
             Scalar lastRow = lowerDiag[n - 1];
             for (size_t i = 0; i < n - 1; ++i) {
-                Scalar alpha = lastRow/mainDiag[i];
-                lastRow = - alpha*upperDiag[i + 1];
-                bStar[n - 1] -= alpha * bStar[i];
+                lastRowAlpha_[i] = lastRow/mainDiag_[i];
+                lastRow = - lastRowAlpha_[i]*upperDiag_[i + 1];
             }
 
-            mainDiag[n-1] += lastRow;
-        }
-
-        // backward elimination
-        x[n - 1] = bStar[n - 1]/mainDiag[n-1];
-        for (int i = static_cast<int>(n) - 2; i >= 0; --i) {
-            unsigned iu = static_cast<unsigned>(i);
-            x[iu] = (bStar[iu] - x[iu + 1]*upperDiag[iu+1] - x[n-1]*lastColumn[iu])/mainDiag[iu];
+            mainDiag_[n-1] += lastRow;
         }
     }
 
+    /*!
+     * \brief Return the number of rows of the factorized matrix.
+     */
+    size_t size() const
+    { return mainDiag_.size(); }
+
+    /*!
+     * \brief Calculate x, so that it solves Ax = b for the factorized matrix A.
+     */
     template <class XVector, class BVector>
-    void solveWithoutUpperRight_(XVector& x, const BVector& b) const
+    void solve(XVector& x, const BVector& b) const
     {
         size_t n = size();
 
-        std::vector<Scalar> lowerDiag(diag_[0]), mainDiag(diag_[1]), upperDiag(diag_[2]);
         std::vector<Scalar> bStar(n);
         std::copy(b.begin(), b.end(), bStar.begin());
 
         // forward elimination
-        for (size_t i = 1; i < n; ++i) {
-            Scalar alpha = lowerDiag[i - 1]/mainDiag[i - 1];
-
-            lowerDiag[i - 1] -= alpha * mainDiag[i - 1];
-            mainDiag[i] -= alpha * upperDiag[i];
+        for (size_t i = 1; i < n; ++i)
+            bStar[i] -= alpha_[i] * bStar[i - 1];
 
-            bStar[i] -= alpha * bStar[i - 1];
-        };
+        if (withLowerLeft_)
+            for (size_t i = 0; i < n - 1; ++i)
+                bStar[n - 1] -= lastRowAlpha_[i] * bStar[i];
 
-        // deal with the last row if the entry on the lower left is not zero
-        if (lowerDiag[n - 1] != 0.0 && size() > 2) {
-            Scalar lastRow = lowerDiag[n - 1];
-            for (size_t i = 0; i < n - 1; ++i) {
-                Scalar alpha = lastRow/mainDiag[i];
-                lastRow = - alpha*upperDiag[i + 1];
-                bStar[n - 1] -= alpha * bStar[i];
-            }
+        // backward elimination
+        x[n - 1] = bStar[n - 1]/mainDiag_[n-1];
+        for (int i = static_cast<int>(n) - 2; i >= 0; --i) {
+            unsigned iu = static_cast<unsigned>(i);
+            if (withUpperRight_)
+                x[iu] = (bStar[iu] - x[iu + 1]*upperDiag_[iu+1] - x[n-1]*lastColumn_(iu))/mainDiag_[iu];
+            else
+                x[iu] = (bStar[iu] - x[iu + 1]*upperDiag_[iu+1])/mainDiag_[iu];
+        }
+    }
 
-            mainDiag[n-1] += lastRow;
+    /*!
+     * \brief Solve the system for several right hand sides at once.
+     *
+     * x and b are containers of vectors, e.g., std::vector<std::vector<Scalar> >. The
+     * elimination proceeds row by row for all right hand sides, so the coefficients of
+     * each row only need to be loaded once.
+     */
+    template <class XVectors, class BVectors>
+    void solveAll(XVectors& x, const BVectors& b) const
+    {
+        size_t n = size();
+        size_t numRhs = b.size();
+        assert(x.size() == numRhs);
+
+        // the right hand sides are stored row by row, i.e., the index is i*numRhs + k
+        std::vector<Scalar> bStar(n*numRhs);
+        for (size_t k = 0; k < numRhs; ++k) {
+            size_t i = 0;
+            for (const auto& value : b[k])
+                bStar[(i++)*numRhs + k] = value;
         }
 
+        // forward elimination
+        for (size_t i = 1; i < n; ++i)
+            for (size_t k = 0; k < numRhs; ++k)
+                bStar[i*numRhs + k] -= alpha_[i] * bStar[(i - 1)*numRhs + k];
+
+        if (withLowerLeft_)
+            for (size_t i = 0; i < n - 1; ++i)
+                for (size_t k = 0; k < numRhs; ++k)
+                    bStar[(n - 1)*numRhs + k] -= lastRowAlpha_[i] * bStar[i*numRhs + k];
+
         // backward elimination
-        x[n - 1] = bStar[n - 1]/mainDiag[n-1];
+        for (size_t k = 0; k < numRhs; ++k)
+            x[k][n - 1] = bStar[(n - 1)*numRhs + k]/mainDiag_[n-1];
         for (int i = static_cast<int>(n) - 2; i >= 0; --i) {
             unsigned iu = static_cast<unsigned>(i);
-            x[iu] = (bStar[iu] - x[iu + 1]*upperDiag[iu+1])/mainDiag[iu];
+            for (size_t k = 0; k < numRhs; ++k) {
+                if (withUpperRight_)
+                    x[k][iu] =
+                        (bStar[iu*numRhs + k] - x[k][iu + 1]*upperDiag_[iu+1] - x[k][n-1]*lastColumn_(iu))
+                        /mainDiag_[iu];
+                else
+                    x[k][iu] = (bStar[iu*numRhs + k] - x[k][iu + 1]*upperDiag_[iu+1])/mainDiag_[iu];
+            }
         }
     }
 
-    mutable std::vector<Scalar> diag_[3];
+private:
+    // the entries of the last column above the diagonal which are considered if the
+    // upper right entry is used
+    Scalar lastColumn_(size_t rowIdx) const
+    { return (rowIdx == 0)?upperRight_:0.0; }
+
+    std::vector<Scalar> mainDiag_;
+    std::vector<Scalar> upperDiag_;
+    std::vector<Scalar> alpha_;
+    std::vector<Scalar> lastRowAlpha_;
+    bool withUpperRight_;
+    bool withLowerLeft_;
+    Scalar upperRight_;
 };
 
 } // namespace Opm
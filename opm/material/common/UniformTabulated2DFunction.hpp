@@ -30,9 +30,13 @@
 
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
 
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 #include <assert.h>
@@ -45,6 +49,12 @@ namespace Opm {
  *
  * This class can be used when the sampling points are calculated at
  * run time.
+ *
+ * The sample points are stored row by row, i.e., the samples for a given y position
+ * are adjacent in memory. Since bi-linear interpolation needs the four corners of a
+ * cell, which are spread over two rows, tables which are evaluated often can
+ * additionally store the corners of each cell contiguously using
+ * enableCellWiseLayout().
  */
 template <class Scalar>
 class UniformTabulated2DFunction
@@ -70,6 +80,8 @@ public:
                 Scalar minY, Scalar maxY, unsigned n)
     {
         samples_.resize(m*n);
+        bicubicCoefficients_.clear();
+        cellSamples_.clear();
 
         m_ = m;
         n_ = n;
@@ -79,6 +91,10 @@ public:
 
         yMin_ = minY;
         yMax_ = maxY;
+
+        // the evaluation only needs to multiply by the inverse of the spacing
+        xToIFactor_ = (m - 1)/(xMax_ - xMin_);
+        yToJFactor_ = (n - 1)/(yMax_ - yMin_);
     }
 
     /*!
@@ -147,7 +163,7 @@ public:
       */
     template <class Evaluation>
     Evaluation xToI(const Evaluation& x) const
-    { return (x - xMin())/(xMax() - xMin())*(numX() - 1); }
+    { return (x - xMin())*xToIFactor_; }
 
     /*!
      * \brief Return the interval index of a given position on the y-axis.
@@ -159,7 +175,7 @@ public:
      */
     template <class Evaluation>
     Evaluation yToJ(const Evaluation& y) const
-    { return (y - yMin())/(yMax() - yMin())*(numY() - 1); }
+    { return (y - yMin())*yToJFactor_; }
 
     /*!
      * \brief Returns true iff a coordinate lies in the tabulated range
@@ -182,6 +198,259 @@ public:
     Evaluation eval(const Evaluation& x, const Evaluation& y) const
     {
 #ifndef NDEBUG
+        checkRange_(x, y);
+#endif
+
+        return eval_(x, y);
+    }
+
+    /*!
+     * \brief Evaluate the function at contiguous arrays of positions.
+     *
+     * This is equivalent to calling eval() for each pair of entries of the arrays,
+     * but the lookup of all positions is done by a single tight loop.
+     *
+     * \param numValues The number of positions which ought to be evaluated
+     * \param x Pointer to the first position on the x-axis
+     * \param y Pointer to the first position on the y-axis
+     * \param result Pointer to the first entry of the array which receives the
+     *               function values. It must be able to hold numValues entries.
+     *
+     * If the results are plain scalars while the positions are Evaluations, only the
+     * values of the positions are used, i.e., no derivatives are computed.
+     */
+    template <class InputEvaluation, class Evaluation>
+    void evalMany(size_t numValues,
+                  const InputEvaluation* x,
+                  const InputEvaluation* y,
+                  Evaluation* result) const
+    {
+        for (size_t k = 0; k < numValues; ++k) {
+            const auto& xk = Opm::decay<Evaluation>(x[k]);
+            const auto& yk = Opm::decay<Evaluation>(y[k]);
+#ifndef NDEBUG
+            checkRange_(xk, yk);
+#endif
+            result[k] = eval_(xk, yk);
+        }
+    }
+
+    /*!
+     * \brief Evaluate the function at all positions of STL-compatible containers.
+     *
+     * The result container is resized to the size of the containers of positions.
+     * See the pointer based variant of this method for details.
+     */
+    template <class InputContainer, class ResultContainer>
+    void evalMany(const InputContainer& x,
+                  const InputContainer& y,
+                  ResultContainer& result) const
+    {
+        assert(x.size() == y.size());
+
+        result.resize(x.size());
+        evalMany(x.size(), x.data(), y.data(), result.data());
+    }
+
+    /*!
+     * \brief Get the value of the sample point which is at the
+     *         intersection of the \f$i\f$-th interval of the x-Axis
+     *         and the \f$j\f$-th of the y-Axis.
+     */
+    Scalar getSamplePoint(unsigned i, unsigned j) const
+    {
+        assert(0 <= i && i < m_);
+        assert(0 <= j && j < n_);
+
+        return samples_[j*m_ + i];
+    }
+
+    /*!
+     * \brief Set the value of the sample point which is at the
+     *        intersection of the \f$i\f$-th interval of the x-Axis
+     *        and the \f$j\f$-th of the y-Axis.
+     */
+    void setSamplePoint(unsigned i, unsigned j, Scalar value)
+    {
+        assert(0 <= i && i < m_);
+        assert(0 <= j && j < n_);
+
+        samples_[j*m_ + i] = value;
+        bicubicCoefficients_.clear();
+        cellSamples_.clear();
+    }
+
+    /*!
+     * \brief Additionally store the four corners of each cell contiguously.
+     *
+     * With the default row-wise layout, the bi-linear interpolation needs to load
+     * the sample points from two rows which are far apart for large tables. After
+     * calling this method, the corners of each cell are stored next to each other
+     * so that an evaluation usually only touches a single cache line. The price is
+     * that four times as much memory is used for the sample points.
+     *
+     * The results are the same as for the row-wise layout. This method must be
+     * called after all sample points have been set: Changing a sample point or
+     * resizing the table drops the cell-wise copy of the samples. It has no effect
+     * on bi-cubic interpolation.
+     */
+    void enableCellWiseLayout()
+    {
+        assert(m_ > 1 && n_ > 1);
+
+        cellSamples_.resize(4*(m_ - 1)*(n_ - 1));
+        for (unsigned j = 0; j < n_ - 1; ++j) {
+            for (unsigned i = 0; i < m_ - 1; ++i) {
+                Scalar* s = &cellSamples_[4*(j*(m_ - 1) + i)];
+                s[0] = getSamplePoint(i, j);
+                s[1] = getSamplePoint(i + 1, j);
+                s[2] = getSamplePoint(i, j + 1);
+                s[3] = getSamplePoint(i + 1, j + 1);
+            }
+        }
+    }
+
+    /*!
+     * \brief Returns true if the corners of each cell are stored contiguously.
+     */
+    bool cellWiseLayoutEnabled() const
+    { return !cellSamples_.empty(); }
+
+    /*!
+     * \brief Use bi-cubic instead of bi-linear interpolation.
+     *
+     * This is a piecewise cubic Hermite interpolation. The partial derivatives at the
+     * sampling points are approximated by second order finite differences of the
+     * sample values and the coefficients of the polynomials are precomputed for all
+     * cells. For smooth functions, this is much more accurate than bi-linear
+     * interpolation, so considerably coarser tables can be used, while each
+     * evaluation is only moderately more expensive. Note that the interpolant may
+     * overshoot close to discontinuities of the tabulated function.
+     *
+     * This method must be called after all sample points have been set: Changing a
+     * sample point or resizing the table switches back to bi-linear interpolation.
+     */
+    void enableBicubicInterpolation()
+    {
+        assert(m_ > 1 && n_ > 1);
+
+        // the Hermite basis matrix
+        static const Scalar M[4][4] = {
+            {  1,  0,  0,  0 },
+            {  0,  0,  1,  0 },
+            { -3,  3, -2, -1 },
+            {  2, -2,  1,  1 }
+        };
+
+        bicubicCoefficients_.resize(16*(m_ - 1)*(n_ - 1));
+        for (unsigned j = 0; j < n_ - 1; ++j) {
+            for (unsigned i = 0; i < m_ - 1; ++i) {
+                // the values and the partial derivatives at the corners of the cell
+                Scalar F[4][4];
+                for (unsigned di = 0; di < 2; ++di) {
+                    for (unsigned dj = 0; dj < 2; ++dj) {
+                        F[di][dj] = getSamplePoint(i + di, j + dj);
+                        F[di][dj + 2] = derivativeY_(i + di, j + dj);
+                        F[di + 2][dj] = derivativeX_(i + di, j + dj);
+                        F[di + 2][dj + 2] = derivativeXY_(i + di, j + dj);
+                    }
+                }
+
+                // coefficients = M F M^T
+                Scalar MF[4][4];
+                for (unsigned k = 0; k < 4; ++k) {
+                    for (unsigned l = 0; l < 4; ++l) {
+                        MF[k][l] = 0.0;
+                        for (unsigned r = 0; r < 4; ++r)
+                            MF[k][l] += M[k][r]*F[r][l];
+                    }
+                }
+
+                Scalar* c = &bicubicCoefficients_[16*(j*(m_ - 1) + i)];
+                for (unsigned k = 0; k < 4; ++k) {
+                    for (unsigned l = 0; l < 4; ++l) {
+                        c[4*k + l] = 0.0;
+                        for (unsigned r = 0; r < 4; ++r)
+                            c[4*k + l] += MF[k][r]*M[l][r];
+                    }
+                }
+            }
+        }
+    }
+
+    /*!
+     * \brief Returns true if the function is evaluated using bi-cubic interpolation.
+     */
+    bool bicubicInterpolationEnabled() const
+    { return !bicubicCoefficients_.empty(); }
+
+    /*!
+     * \brief Returns the number of bytes which are allocated on the heap.
+     *
+     * The size of the object itself is not included.
+     */
+    std::size_t heapMemoryUsage() const
+    {
+        return
+            vectorMemoryUsage(samples_)
+            + vectorMemoryUsage(bicubicCoefficients_)
+            + vectorMemoryUsage(cellSamples_);
+    }
+
+    /*!
+     * \brief Write the sampling points to a binary blob.
+     *
+     * The cell-wise layout and the bi-cubic coefficients are not written, only the
+     * fact that they are enabled: They are recomputed by deserialize().
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(xMin_);
+        writer.write(xMax_);
+        writer.write(static_cast<std::uint32_t>(m_));
+        writer.write(yMin_);
+        writer.write(yMax_);
+        writer.write(static_cast<std::uint32_t>(n_));
+        writer.write(samples_);
+        writer.write(static_cast<std::uint8_t>(cellWiseLayoutEnabled()));
+        writer.write(static_cast<std::uint8_t>(bicubicInterpolationEnabled()));
+    }
+
+    /*!
+     * \brief Restore a function which was written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        Scalar minX, maxX, minY, maxY;
+        std::uint32_t m, n;
+        reader.read(minX);
+        reader.read(maxX);
+        reader.read(m);
+        reader.read(minY);
+        reader.read(maxY);
+        reader.read(n);
+
+        std::vector<Scalar> samples;
+        reader.read(samples);
+        if (m < 2 || n < 2 || samples.size() != static_cast<std::size_t>(m)*n)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: inconsistent sampling points");
+
+        resize(minX, maxX, m, minY, maxY, n);
+        samples_ = samples;
+
+        std::uint8_t cellWise, bicubic;
+        reader.read(cellWise);
+        reader.read(bicubic);
+        if (cellWise)
+            enableCellWiseLayout();
+        if (bicubic)
+            enableBicubicInterpolation();
+    }
+
+private:
+    template <class Evaluation>
+    void checkRange_(const Evaluation& x, const Evaluation& y) const
+    {
         if (!applies(x,y))
         {
             OPM_THROW(NumericalProblem,
@@ -191,8 +460,11 @@ public:
                        << xMin() << " to " << xMax() << " times "
                        << yMin() << " to " << yMax());
         };
-#endif
+    }
 
+    template <class Evaluation>
+    Evaluation eval_(const Evaluation& x, const Evaluation& y) const
+    {
         Evaluation alpha = xToI(x);
         Evaluation beta = yToJ(y);
 
@@ -208,44 +480,111 @@ public:
         alpha -= i;
         beta -= j;
 
+        if (!bicubicCoefficients_.empty()) {
+            // bi-cubic interpolation: evaluate the cell's polynomial using Horner's
+            // scheme
+            const Scalar* c = &bicubicCoefficients_[16*(j*(m_ - 1) + i)];
+            Evaluation result = 0.0;
+            for (int k = 3; k >= 0; --k) {
+                const Scalar* ck = c + 4*k;
+                result = result*alpha + (((ck[3]*beta + ck[2])*beta + ck[1])*beta + ck[0]);
+            }
+            return result;
+        }
+
         // bi-linear interpolation
+        if (!cellSamples_.empty()) {
+            const Scalar* s = &cellSamples_[4*(j*(m_ - 1) + i)];
+            const Evaluation& s1 = s[0]*(1.0 - alpha) + s[1]*alpha;
+            const Evaluation& s2 = s[2]*(1.0 - alpha) + s[3]*alpha;
+            return s1*(1.0 - beta) + s2*beta;
+        }
+
         const Evaluation& s1 = getSamplePoint(i, j)*(1.0 - alpha) + getSamplePoint(i + 1, j)*alpha;
         const Evaluation& s2 = getSamplePoint(i, j + 1)*(1.0 - alpha) + getSamplePoint(i + 1, j + 1)*alpha;
         return s1*(1.0 - beta) + s2*beta;
     }
 
-    /*!
-     * \brief Get the value of the sample point which is at the
-     *         intersection of the \f$i\f$-th interval of the x-Axis
-     *         and the \f$j\f$-th of the y-Axis.
-     */
-    Scalar getSamplePoint(unsigned i, unsigned j) const
+    // computes the sampling points and weights used to approximate the derivative at
+    // a sampling point, i.e., second order central differences in the interior and
+    // second order one-sided ones at the boundary
+    static void derivativeStencil_(unsigned idx, unsigned num, unsigned (&indices)[3], Scalar (&weights)[3])
     {
-        assert(0 <= i && i < m_);
-        assert(0 <= j && j < n_);
+        if (num == 2) {
+            indices[0] = 0; weights[0] = -1.0;
+            indices[1] = 1; weights[1] = 1.0;
+            indices[2] = 1; weights[2] = 0.0;
+        }
+        else if (idx == 0) {
+            indices[0] = 0; weights[0] = -1.5;
+            indices[1] = 1; weights[1] = 2.0;
+            indices[2] = 2; weights[2] = -0.5;
+        }
+        else if (idx == num - 1) {
+            indices[0] = num - 1; weights[0] = 1.5;
+            indices[1] = num - 2; weights[1] = -2.0;
+            indices[2] = num - 3; weights[2] = 0.5;
+        }
+        else {
+            indices[0] = idx - 1; weights[0] = -0.5;
+            indices[1] = idx + 1; weights[1] = 0.5;
+            indices[2] = idx; weights[2] = 0.0;
+        }
+    }
 
-        return samples_[j*m_ + i];
+    // the finite difference approximations of the partial derivatives at a sampling
+    // point in index space
+    Scalar derivativeX_(unsigned i, unsigned j) const
+    {
+        unsigned iIdx[3];
+        Scalar iWeight[3];
+        derivativeStencil_(i, m_, iIdx, iWeight);
+
+        Scalar result = 0.0;
+        for (unsigned a = 0; a < 3; ++a)
+            result += iWeight[a]*getSamplePoint(iIdx[a], j);
+        return result;
     }
 
-    /*!
-     * \brief Set the value of the sample point which is at the
-     *        intersection of the \f$i\f$-th interval of the x-Axis
-     *        and the \f$j\f$-th of the y-Axis.
-     */
-    void setSamplePoint(unsigned i, unsigned j, Scalar value)
+    Scalar derivativeY_(unsigned i, unsigned j) const
     {
-        assert(0 <= i && i < m_);
-        assert(0 <= j && j < n_);
+        unsigned jIdx[3];
+        Scalar jWeight[3];
+        derivativeStencil_(j, n_, jIdx, jWeight);
+
+        Scalar result = 0.0;
+        for (unsigned b = 0; b < 3; ++b)
+            result += jWeight[b]*getSamplePoint(i, jIdx[b]);
+        return result;
+    }
 
-        samples_[j*m_ + i] = value;
+    Scalar derivativeXY_(unsigned i, unsigned j) const
+    {
+        unsigned iIdx[3], jIdx[3];
+        Scalar iWeight[3], jWeight[3];
+        derivativeStencil_(i, m_, iIdx, iWeight);
+        derivativeStencil_(j, n_, jIdx, jWeight);
+
+        Scalar result = 0.0;
+        for (unsigned a = 0; a < 3; ++a)
+            for (unsigned b = 0; b < 3; ++b)
+                result += iWeight[a]*jWeight[b]*getSamplePoint(iIdx[a], jIdx[b]);
+        return result;
     }
 
-private:
     // the vector which contains the values of the sample points
     // f(x_i, y_j). don't use this directly, use getSamplePoint(i,j)
     // instead!
     std::vector<Scalar> samples_;
 
+    // the coefficients of the bi-cubic polynomials of all cells if bi-cubic
+    // interpolation is enabled, empty otherwise
+    std::vector<Scalar> bicubicCoefficients_;
+
+    // the sample points at the four corners of all cells if the cell-wise layout is
+    // enabled, empty otherwise
+    std::vector<Scalar> cellSamples_;
+
     // the number of sample points in x direction
     unsigned m_;
 
@@ -259,6 +598,10 @@ private:
     // the range of the tabulation on the y axis
     Scalar yMin_;
     Scalar yMax_;
+
+    // the inverse of the spacing of the sampling points on the x and y axes
+    Scalar xToIFactor_;
+    Scalar yToJFactor_;
 };
 } // namespace Opm
 
@@ -0,0 +1,298 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::UniformTabulated2DMultiFunction
+ */
+#ifndef OPM_UNIFORM_TABULATED_2D_MULTI_FUNCTION_HPP
+#define OPM_UNIFORM_TABULATED_2D_MULTI_FUNCTION_HPP
+
+#include <opm/common/Exceptions.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <assert.h>
+
+namespace Opm {
+
+/*!
+ * \brief Implements a set of scalar functions which depend on two variables and which
+ *        are sampled on the same uniform X-Y grid.
+ *
+ * In contrast to using multiple UniformTabulated2DFunction objects, the interval
+ * indices and the interpolation weights only need to be computed once for all
+ * quantities, and the values of all quantities for a given sampling point are adjacent
+ * in memory.
+ *
+ * \tparam numValuesV The number of quantities which are stored for each sampling point
+ */
+template <class Scalar, unsigned numValuesV>
+class UniformTabulated2DMultiFunction
+{
+public:
+    //! The number of quantities which are stored for each sampling point
+    static const unsigned numValues = numValuesV;
+
+    //! The type used to specify the values of all quantities for a sampling point
+    typedef std::array<Scalar, numValues> ValueArray;
+
+    UniformTabulated2DMultiFunction()
+        : m_(0)
+        , n_(0)
+    { }
+
+    /*!
+     * \brief Constructor where the tabulation parameters are already
+     *        provided.
+     */
+    UniformTabulated2DMultiFunction(Scalar minX, Scalar maxX, unsigned m,
+                                    Scalar minY, Scalar maxY, unsigned n)
+    { resize(minX, maxX, m, minY, maxY, n); }
+
+    /*!
+     * \brief Resize the tabulation to a new range.
+     */
+    void resize(Scalar minX, Scalar maxX, unsigned m,
+                Scalar minY, Scalar maxY, unsigned n)
+    {
+        assert(m > 1 && n > 1);
+
+        samples_.resize(m*n);
+
+        m_ = m;
+        n_ = n;
+
+        xMin_ = minX;
+        xMax_ = maxX;
+
+        yMin_ = minY;
+        yMax_ = maxY;
+
+        // the evaluation only needs to multiply by the inverse of the spacing
+        xToIFactor_ = (m - 1)/(xMax_ - xMin_);
+        yToJFactor_ = (n - 1)/(yMax_ - yMin_);
+    }
+
+    /*!
+     * \brief Returns true if the table does not contain any sampling points.
+     */
+    bool empty() const
+    { return samples_.empty(); }
+
+    /*!
+     * \brief Returns the minimum of the X coordinate of the sampling points.
+     */
+    Scalar xMin() const
+    { return xMin_; }
+
+    /*!
+     * \brief Returns the maximum of the X coordinate of the sampling points.
+     */
+    Scalar xMax() const
+    { return xMax_; }
+
+    /*!
+     * \brief Returns the minimum of the Y coordinate of the sampling points.
+     */
+    Scalar yMin() const
+    { return yMin_; }
+
+    /*!
+     * \brief Returns the maximum of the Y coordinate of the sampling points.
+     */
+    Scalar yMax() const
+    { return yMax_; }
+
+    /*!
+     * \brief Returns the number of sampling points in X direction.
+     */
+    unsigned numX() const
+    { return m_; }
+
+    /*!
+     * \brief Returns the number of sampling points in Y direction.
+     */
+    unsigned numY() const
+    { return n_; }
+
+    /*!
+     * \brief Return the position on the x-axis of the i-th interval.
+     */
+    Scalar iToX(unsigned i) const
+    {
+        assert(0 <= i && i < numX());
+
+        return xMin() + i*(xMax() - xMin())/(numX() - 1);
+    }
+
+    /*!
+     * \brief Return the position on the y-axis of the j-th interval.
+      */
+    Scalar jToY(unsigned j) const
+    {
+        assert(0 <= j && j < numY());
+
+        return yMin() + j*(yMax() - yMin())/(numY() - 1);
+    }
+
+    /*!
+     * \brief Returns true iff a coordinate lies in the tabulated range
+     */
+    template <class Evaluation>
+    bool applies(const Evaluation& x, const Evaluation& y) const
+    {
+        return
+            !empty() &&
+            xMin() <= x && x <= xMax() &&
+            yMin() <= y && y <= yMax();
+    }
+
+    /*!
+     * \brief Evaluate all quantities at a given (x,y) position.
+     *
+     * The quantities are interpolated bi-linearly. For each quantity, the result is
+     * the same as the one of UniformTabulated2DFunction::eval() for a table with the
+     * same sampling points. If this method is called for a value outside of the
+     * tabulated range, a \c Opm::NumericalProblem exception is thrown in debug mode.
+     */
+    template <class Evaluation>
+    void eval(const Evaluation& x,
+              const Evaluation& y,
+              std::array<Evaluation, numValues>& result) const
+    {
+#ifndef NDEBUG
+        if (!applies(x,y))
+        {
+            OPM_THROW(NumericalProblem,
+                       "Attempt to get tabulated value for ("
+                       << x << ", " << y
+                       << ") on a table of extend "
+                       << xMin() << " to " << xMax() << " times "
+                       << yMin() << " to " << yMax());
+        };
+#endif
+
+        Evaluation alpha = (x - xMin())*xToIFactor_;
+        Evaluation beta = (y - yMin())*yToJFactor_;
+
+        unsigned i =
+            static_cast<unsigned>(
+                std::max(0, std::min(static_cast<int>(numX()) - 2,
+                                     static_cast<int>(Opm::scalarValue(alpha)))));
+        unsigned j =
+            static_cast<unsigned>(
+                std::max(0, std::min(static_cast<int>(numY()) - 2,
+                                     static_cast<int>(Opm::scalarValue(beta)))));
+
+        alpha -= i;
+        beta -= j;
+
+        // the weights of the four corners of the cell
+        const Evaluation& w00 = (1.0 - alpha)*(1.0 - beta);
+        const Evaluation& w10 = alpha*(1.0 - beta);
+        const Evaluation& w01 = (1.0 - alpha)*beta;
+        const Evaluation& w11 = alpha*beta;
+
+        const ValueArray& s00 = samples_[j*m_ + i];
+        const ValueArray& s10 = samples_[j*m_ + i + 1];
+        const ValueArray& s01 = samples_[(j + 1)*m_ + i];
+        const ValueArray& s11 = samples_[(j + 1)*m_ + i + 1];
+        for (unsigned valueIdx = 0; valueIdx < numValues; ++valueIdx)
+            result[valueIdx] =
+                w00*s00[valueIdx] + w10*s10[valueIdx]
+                + w01*s01[valueIdx] + w11*s11[valueIdx];
+    }
+
+    /*!
+     * \brief Get the values of the sample point which is at the
+     *        intersection of the \f$i\f$-th interval of the x-Axis
+     *        and the \f$j\f$-th of the y-Axis.
+     */
+    const ValueArray& getSamplePoint(unsigned i, unsigned j) const
+    {
+        assert(0 <= i && i < m_);
+        assert(0 <= j && j < n_);
+
+        return samples_[j*m_ + i];
+    }
+
+    /*!
+     * \brief Set the values of the sample point which is at the
+     *        intersection of the \f$i\f$-th interval of the x-Axis
+     *        and the \f$j\f$-th of the y-Axis.
+     */
+    void setSamplePoint(unsigned i, unsigned j, const ValueArray& values)
+    {
+        assert(0 <= i && i < m_);
+        assert(0 <= j && j < n_);
+
+        samples_[j*m_ + i] = values;
+    }
+
+    /*!
+     * \brief Set all sampling points using a function.
+     *
+     * The function is called as fn(x, y, values) for the position of each sampling
+     * point and must set the values of all quantities for it.
+     */
+    template <class Fn>
+    void sample(Fn fn)
+    {
+        for (unsigned j = 0; j < n_; ++j) {
+            Scalar y = jToY(j);
+            for (unsigned i = 0; i < m_; ++i)
+                fn(iToX(i), y, samples_[j*m_ + i]);
+        }
+    }
+
+private:
+    // the sampling points, stored in row-major order, i.e., the index is j*m + i
+    std::vector<ValueArray> samples_;
+
+    // the number of sampling points in x direction
+    unsigned m_;
+
+    // the number of sampling points in y direction
+    unsigned n_;
+
+    // the range of the tabulation on the x axis
+    Scalar xMin_;
+    Scalar xMax_;
+
+    // the range of the tabulation on the y axis
+    Scalar yMin_;
+    Scalar yMax_;
+
+    // the inverse of the spacing of the sampling points on the x and y axes
+    Scalar xToIFactor_;
+    Scalar yToJFactor_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,365 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::UniformTabulated3DFunction
+ */
+#ifndef OPM_UNIFORM_TABULATED_3D_FUNCTION_HPP
+#define OPM_UNIFORM_TABULATED_3D_FUNCTION_HPP
+
+#include <opm/common/Exceptions.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <assert.h>
+
+namespace Opm {
+
+/*!
+ * \brief Implements a scalar function that depends on three variables and which is
+ *        sampled on an uniform X-Y-Z grid.
+ *
+ * The function is evaluated using tri-linear interpolation. The sample points are
+ * stored such that the samples for given y and z positions are adjacent in memory,
+ * i.e., the sample f(x_i, y_j, z_k) is located at index (k*numY() + j)*numX() + i.
+ */
+template <class Scalar>
+class UniformTabulated3DFunction
+{
+public:
+    UniformTabulated3DFunction()
+        : m_(0), n_(0), o_(0)
+    { }
+
+    /*!
+     * \brief Constructor where the tabulation parameters are already
+     *        provided.
+     */
+    UniformTabulated3DFunction(Scalar minX, Scalar maxX, unsigned m,
+                               Scalar minY, Scalar maxY, unsigned n,
+                               Scalar minZ, Scalar maxZ, unsigned o)
+    {
+        resize(minX, maxX, m, minY, maxY, n, minZ, maxZ, o);
+    }
+
+    /*!
+     * \brief Resize the tabulation to a new range.
+     */
+    void resize(Scalar minX, Scalar maxX, unsigned m,
+                Scalar minY, Scalar maxY, unsigned n,
+                Scalar minZ, Scalar maxZ, unsigned o)
+    {
+        assert(m > 1 && n > 1 && o > 1);
+
+        samples_.resize(m*n*o);
+
+        m_ = m;
+        n_ = n;
+        o_ = o;
+
+        xMin_ = minX;
+        xMax_ = maxX;
+
+        yMin_ = minY;
+        yMax_ = maxY;
+
+        zMin_ = minZ;
+        zMax_ = maxZ;
+
+        // the evaluation only needs to multiply by the inverse of the spacing
+        xToIFactor_ = (m - 1)/(xMax_ - xMin_);
+        yToJFactor_ = (n - 1)/(yMax_ - yMin_);
+        zToKFactor_ = (o - 1)/(zMax_ - zMin_);
+    }
+
+    /*!
+     * \brief Returns the minimum of the X coordinate of the sampling points.
+     */
+    Scalar xMin() const
+    { return xMin_; }
+
+    /*!
+     * \brief Returns the maximum of the X coordinate of the sampling points.
+     */
+    Scalar xMax() const
+    { return xMax_; }
+
+    /*!
+     * \brief Returns the minimum of the Y coordinate of the sampling points.
+     */
+    Scalar yMin() const
+    { return yMin_; }
+
+    /*!
+     * \brief Returns the maximum of the Y coordinate of the sampling points.
+     */
+    Scalar yMax() const
+    { return yMax_; }
+
+    /*!
+     * \brief Returns the minimum of the Z coordinate of the sampling points.
+     */
+    Scalar zMin() const
+    { return zMin_; }
+
+    /*!
+     * \brief Returns the maximum of the Z coordinate of the sampling points.
+     */
+    Scalar zMax() const
+    { return zMax_; }
+
+    /*!
+     * \brief Returns the number of sampling points in X direction.
+     */
+    unsigned numX() const
+    { return m_; }
+
+    /*!
+     * \brief Returns the number of sampling points in Y direction.
+     */
+    unsigned numY() const
+    { return n_; }
+
+    /*!
+     * \brief Returns the number of sampling points in Z direction.
+     */
+    unsigned numZ() const
+    { return o_; }
+
+    /*!
+     * \brief Returns true if the table does not contain any sampling points.
+     */
+    bool empty() const
+    { return samples_.empty(); }
+
+    /*!
+     * \brief Return the position on the x-axis of the i-th interval.
+     */
+    Scalar iToX(unsigned i) const
+    {
+        assert(0 <= i && i < numX());
+
+        return xMin() + i*(xMax() - xMin())/(numX() - 1);
+    }
+
+    /*!
+     * \brief Return the position on the y-axis of the j-th interval.
+     */
+    Scalar jToY(unsigned j) const
+    {
+        assert(0 <= j && j < numY());
+
+        return yMin() + j*(yMax() - yMin())/(numY() - 1);
+    }
+
+    /*!
+     * \brief Return the position on the z-axis of the k-th interval.
+     */
+    Scalar kToZ(unsigned k) const
+    {
+        assert(0 <= k && k < numZ());
+
+        return zMin() + k*(zMax() - zMin())/(numZ() - 1);
+    }
+
+    /*!
+     * \brief Return the interval index of a given position on the x-axis.
+     *
+     * This method returns a *floating point* number. The integer part
+     * should be interpreted as interval, the decimal places are the
+     * position of the x value between the i-th and the (i+1)-th
+     * sample point.
+     */
+    template <class Evaluation>
+    Evaluation xToI(const Evaluation& x) const
+    { return (x - xMin())*xToIFactor_; }
+
+    /*!
+     * \brief Return the interval index of a given position on the y-axis.
+     *
+     * See xToI() for details.
+     */
+    template <class Evaluation>
+    Evaluation yToJ(const Evaluation& y) const
+    { return (y - yMin())*yToJFactor_; }
+
+    /*!
+     * \brief Return the interval index of a given position on the z-axis.
+     *
+     * See xToI() for details.
+     */
+    template <class Evaluation>
+    Evaluation zToK(const Evaluation& z) const
+    { return (z - zMin())*zToKFactor_; }
+
+    /*!
+     * \brief Returns true iff a coordinate lies in the tabulated range
+     */
+    template <class Evaluation>
+    bool applies(const Evaluation& x, const Evaluation& y, const Evaluation& z) const
+    {
+        return
+            xMin() <= x && x <= xMax() &&
+            yMin() <= y && y <= yMax() &&
+            zMin() <= z && z <= zMax();
+    }
+
+    /*!
+     * \brief Evaluate the function at a given (x,y,z) position.
+     *
+     * If this method is called for a value outside of the tabulated
+     * range, a \c Opm::NumericalProblem exception is thrown.
+     */
+    template <class Evaluation>
+    Evaluation eval(const Evaluation& x, const Evaluation& y, const Evaluation& z) const
+    {
+#ifndef NDEBUG
+        checkRange_(x, y, z);
+#endif
+
+        return eval_(x, y, z);
+    }
+
+    /*!
+     * \brief Get the value of the sample point which is at the
+     *        intersection of the \f$i\f$-th interval of the x-Axis,
+     *        the \f$j\f$-th of the y-Axis and the \f$k\f$-th of the z-Axis.
+     */
+    Scalar getSamplePoint(unsigned i, unsigned j, unsigned k) const
+    {
+        assert(0 <= i && i < m_);
+        assert(0 <= j && j < n_);
+        assert(0 <= k && k < o_);
+
+        return samples_[(k*n_ + j)*m_ + i];
+    }
+
+    /*!
+     * \brief Set the value of the sample point which is at the
+     *        intersection of the \f$i\f$-th interval of the x-Axis,
+     *        the \f$j\f$-th of the y-Axis and the \f$k\f$-th of the z-Axis.
+     */
+    void setSamplePoint(unsigned i, unsigned j, unsigned k, Scalar value)
+    {
+        assert(0 <= i && i < m_);
+        assert(0 <= j && j < n_);
+        assert(0 <= k && k < o_);
+
+        samples_[(k*n_ + j)*m_ + i] = value;
+    }
+
+private:
+    template <class Evaluation>
+    void checkRange_(const Evaluation& x, const Evaluation& y, const Evaluation& z) const
+    {
+        if (!applies(x, y, z))
+        {
+            OPM_THROW(NumericalProblem,
+                       "Attempt to get tabulated value for ("
+                       << x << ", " << y << ", " << z
+                       << ") on a table of extend "
+                       << xMin() << " to " << xMax() << " times "
+                       << yMin() << " to " << yMax() << " times "
+                       << zMin() << " to " << zMax());
+        };
+    }
+
+    // returns the index of the interval which contains a position given in index
+    // space. positions outside of the table are extrapolated using the first and the
+    // last intervals
+    static unsigned intervalIdx_(Scalar idx, unsigned num)
+    {
+        return
+            static_cast<unsigned>(
+                std::max(0, std::min(static_cast<int>(num) - 2,
+                                     static_cast<int>(idx))));
+    }
+
+    template <class Evaluation>
+    Evaluation eval_(const Evaluation& x, const Evaluation& y, const Evaluation& z) const
+    {
+        Evaluation alpha = xToI(x);
+        Evaluation beta = yToJ(y);
+        Evaluation gamma = zToK(z);
+
+        unsigned i = intervalIdx_(Opm::scalarValue(alpha), m_);
+        unsigned j = intervalIdx_(Opm::scalarValue(beta), n_);
+        unsigned k = intervalIdx_(Opm::scalarValue(gamma), o_);
+
+        alpha -= i;
+        beta -= j;
+        gamma -= k;
+
+        // the samples at the eight corners of the cell. the corners which only differ
+        // in their x position are adjacent in memory
+        const Scalar* s000 = &samples_[(k*n_ + j)*m_ + i];
+        const Scalar* s010 = s000 + m_;
+        const Scalar* s001 = s000 + n_*m_;
+        const Scalar* s011 = s001 + m_;
+
+        const Evaluation& s00 = s000[0]*(1.0 - alpha) + s000[1]*alpha;
+        const Evaluation& s10 = s010[0]*(1.0 - alpha) + s010[1]*alpha;
+        const Evaluation& s01 = s001[0]*(1.0 - alpha) + s001[1]*alpha;
+        const Evaluation& s11 = s011[0]*(1.0 - alpha) + s011[1]*alpha;
+
+        const Evaluation& s0 = s00*(1.0 - beta) + s10*beta;
+        const Evaluation& s1 = s01*(1.0 - beta) + s11*beta;
+
+        return s0*(1.0 - gamma) + s1*gamma;
+    }
+
+    // the vector which contains the values of the sample points
+    // f(x_i, y_j, z_k). don't use this directly, use getSamplePoint(i,j,k)
+    // instead!
+    std::vector<Scalar> samples_;
+
+    // the number of sample points in x, y and z direction
+    unsigned m_;
+    unsigned n_;
+    unsigned o_;
+
+    // the range of the tabulation on the x axis
+    Scalar xMin_;
+    Scalar xMax_;
+
+    // the range of the tabulation on the y axis
+    Scalar yMin_;
+    Scalar yMax_;
+
+    // the range of the tabulation on the z axis
+    Scalar zMin_;
+    Scalar zMax_;
+
+    // the inverse of the spacing of the sampling points on the x, y and z axes
+    Scalar xToIFactor_;
+    Scalar yToJFactor_;
+    Scalar zToKFactor_;
+};
+} // namespace Opm
+
+#endif
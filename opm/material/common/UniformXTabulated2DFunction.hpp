@@ -32,12 +32,22 @@
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Unused.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/ErrorStatus.hpp>
+#include <opm/material/common/FlatTables.hpp>
 #include <opm/material/common/MathToolbox.hpp>
-
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/MonotoneCubicInterpolation.hpp>
+#include <opm/material/common/TabulationLookupHint.hpp>
+#include <opm/material/common/TableProfiler.hpp>
+#include <opm/material/densead/ExpressionTemplates.hpp>
+
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <limits>
-#include <tuple>
 
 #include <assert.h>
 
@@ -50,16 +60,50 @@ namespace Opm {
  * "Uniform on the X-axis" means that all Y sampling points must be located along a line
  * for this value. This class can be used when the sampling points are calculated at run
  * time.
+ *
+ * By default, the function is interpolated bi-linearly. Optionally, monotone cubic
+ * Hermite interpolation can be used in both directions, see setInterpolation().
  */
 template <class Scalar>
 class UniformXTabulated2DFunction
 {
-    typedef std::tuple</*x=*/Scalar, /*y=*/Scalar, /*value=*/Scalar> SamplePoint;
-
 public:
+    //! The type of the objects which cache the segments found by the last lookup
+    //!
+    //! The first index is the segment on the x-axis, the second and third ones are the
+    //! segments on the y-axis for the left and the right column.
+    typedef TabulationLookupHint<3> LookupHint;
+
     UniformXTabulated2DFunction()
+        : interpolation_(TableInterpolation::Linear)
     { }
 
+    /*!
+     * \brief Set the scheme which is used to interpolate between the sampling points.
+     *
+     * With TableInterpolation::MonotoneCubic, each column is interpolated using the
+     * monotone cubic Hermite polynomials of MonotoneCubicInterpolation. In x direction,
+     * the values of the columns for the requested y are interpolated by cubic Hermite
+     * polynomials as well. Since these values are only known at evaluation time, the
+     * slopes at the columns are determined locally from the neighboring columns using
+     * MonotoneCubicInterpolation::localSlope(), so that a lookup involves four instead
+     * of two columns. The resulting function is continuously differentiable, it
+     * reproduces the sampling points and is extrapolated linearly. The scheme can be
+     * set before or after the sampling points.
+     */
+    void setInterpolation(TableInterpolation value)
+    {
+        interpolation_ = value;
+        updateCubicCoeffs_();
+    }
+
+    /*!
+     * \brief Returns the scheme which is used to interpolate between the sampling
+     *        points.
+     */
+    TableInterpolation interpolation() const
+    { return interpolation_; }
+
     /*!
      * \brief Returns the minimum of the X coordinate of the sampling points.
      */
@@ -82,13 +126,13 @@ public:
      * \brief Returns the value of the Y coordinate of a sampling point.
      */
     Scalar yAt(size_t i, size_t j) const
-    { return std::get<1>(samples_[i][j]); }
+    { return yPos_[colOffset_[i] + j]; }
 
     /*!
      * \brief Returns the value of a sampling point.
      */
     Scalar valueAt(size_t i, size_t j) const
-    { return std::get<2>(samples_[i][j]); }
+    { return values_[colOffset_[i] + j]; }
 
     /*!
      * \brief Returns the number of sampling points in X direction.
@@ -100,19 +144,22 @@ public:
      * \brief Returns the minimum of the Y coordinate of the sampling points for a given column.
      */
     Scalar yMin(size_t i) const
-    { return std::get<1>(samples_.at(i).front()); }
+    { return yAt(i, 0); }
 
     /*!
      * \brief Returns the maximum of the Y coordinate of the sampling points for a given column.
      */
     Scalar yMax(size_t i) const
-    { return std::get<1>(samples_.at(i).back()); }
+    { return yAt(i, numY(i) - 1); }
 
     /*!
      * \brief Returns the number of sampling points in Y direction a given column.
      */
     size_t numY(size_t i) const
-    { return samples_.at(i).size(); }
+    {
+        assert(i < numX());
+        return colOffset_[i + 1] - colOffset_[i];
+    }
 
     /*!
      * \brief Return the position on the x-axis of the i-th interval.
@@ -130,9 +177,9 @@ public:
     Scalar jToY(size_t i, size_t j) const
     {
         assert(0 <= i && i < numX());
-        assert(0 <= j && size_t(j) < samples_[i].size());
+        assert(0 <= j && size_t(j) < numY(i));
 
-        return std::get<1>(samples_.at(i).at(j));
+        return yAt(i, j);
     }
 
     /*!
@@ -148,33 +195,8 @@ public:
     {
         assert(extrapolate || (xMin() <= x && x <= xMax()));
 
-        // we need at least two sampling points!
-        assert(xPos_.size() >= 2);
-
-        size_t segmentIdx;
-        if (x <= xPos_[1])
-            segmentIdx = 0;
-        else if (x >= xPos_[xPos_.size() - 2])
-            segmentIdx = xPos_.size() - 2;
-        else {
-            // bisection
-            segmentIdx = 1;
-            size_t upperIdx = xPos_.size() - 2;
-            while (segmentIdx + 1 < upperIdx) {
-                size_t pivotIdx = (segmentIdx + upperIdx) / 2;
-                if (x < xPos_[pivotIdx])
-                    upperIdx = pivotIdx;
-                else
-                    segmentIdx = pivotIdx;
-            }
-
-            assert(xPos_[segmentIdx] <= x);
-            assert(x <= xPos_[segmentIdx + 1]);
-        }
-
-        Scalar x1 = xPos_[segmentIdx];
-        Scalar x2 = xPos_[segmentIdx + 1];
-        return Scalar(segmentIdx) + (x - x1)/(x2 - x1);
+        size_t segmentIdx = xSegmentIndex_(Opm::scalarValue(x), /*hintIdx=*/0);
+        return xToI_(x, segmentIdx);
     }
 
     /*!
@@ -189,32 +211,127 @@ public:
     Evaluation yToJ(size_t i, const Evaluation& y, bool extrapolate OPM_OPTIM_UNUSED = false) const
     {
         assert(0 <= i && i < numX());
-        const auto& colSamplePoints = samples_.at(i);
-
         assert(extrapolate || (yMin(i) <= y && y <= yMax(i)));
 
-        Scalar y1;
-        Scalar y2;
+        size_t segmentIdx = ySegmentIndex_(i, Opm::scalarValue(y), /*hintIdx=*/0);
+        Evaluation beta = yToJ_(i, y, segmentIdx);
 
-        // interval halving
-        size_t lowerIdx = 0;
-        size_t upperIdx = colSamplePoints.size() - 1;
-        size_t pivotIdx = (lowerIdx + upperIdx) / 2;
-        while (lowerIdx + 1 < upperIdx) {
-            if (y < std::get<1>(colSamplePoints[pivotIdx]))
-                upperIdx = pivotIdx;
-            else
-                lowerIdx = pivotIdx;
-            pivotIdx = (lowerIdx + upperIdx) / 2;
-        }
+        assert(yAt(i, segmentIdx) <= y || (extrapolate && segmentIdx == 0));
+        assert(y <= yAt(i, segmentIdx + 1) || (extrapolate && segmentIdx == numY(i) - 2));
+
+        return beta;
+    }
 
-        y1 = std::get<1>(colSamplePoints[lowerIdx]);
-        y2 = std::get<1>(colSamplePoints[lowerIdx + 1]);
+    /*!
+     * \brief Set the name under which the lookups of the function are reported if
+     *        table profiling is enabled.
+     *
+     * See opm/material/common/TableProfiler.hpp. The segments are identified by the
+     * index of the sampling point at their lower left corner. If profiling is
+     * disabled, this method does nothing.
+     */
+    void setProfileName(const std::string& name)
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        profile_.setName(name);
+#else
+        (void) name;
+#endif
+    }
 
-        assert(y1 <= y || (extrapolate && lowerIdx == 0));
-        assert(y <= y2 || (extrapolate && lowerIdx == colSamplePoints.size() - 2));
+    /*!
+     * \brief Returns the number of bytes allocated by the function for its sampling
+     *        points.
+     *
+     * The size of the object itself is not included.
+     */
+    std::size_t heapMemoryUsage() const
+    {
+        return
+            vectorMemoryUsage(xPos_)
+            + vectorMemoryUsage(invXSpacing_)
+            + vectorMemoryUsage(yPos_)
+            + vectorMemoryUsage(invYSpacing_)
+            + vectorMemoryUsage(values_)
+            + vectorMemoryUsage(cubicCoeffs_)
+            + vectorMemoryUsage(colOffset_);
+    }
 
-        return Scalar(lowerIdx) + (y - y1)/(y2 - y1);
+    /*!
+     * \brief Write the sampling points to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(xPos_);
+        writer.write(yPos_);
+        writer.write(values_);
+        writer.write(colOffset_);
+        writer.write(static_cast<std::int32_t>(interpolation_));
+    }
+
+    /*!
+     * \brief Restore a function which was written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(xPos_);
+        reader.read(yPos_);
+        reader.read(values_);
+        reader.read(colOffset_);
+        std::int32_t interpolation;
+        reader.read(interpolation);
+
+        // the column offsets are only allocated once the first column is added
+        bool consistent =
+            yPos_.size() == values_.size()
+            && (colOffset_.empty()
+                ? xPos_.empty() && yPos_.empty()
+                : colOffset_.size() == xPos_.size() + 1 && colOffset_.back() == yPos_.size());
+        if (!consistent)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: inconsistent sampling points");
+        if (interpolation < static_cast<std::int32_t>(TableInterpolation::Linear)
+            || interpolation > static_cast<std::int32_t>(TableInterpolation::MonotoneCubic))
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: invalid interpolation scheme " << interpolation);
+        interpolation_ = static_cast<TableInterpolation>(interpolation);
+
+        // the inverse spacings and the coefficients of the cubic segments are not
+        // serialized because they can be cheaply recomputed
+        updateInvXSpacing_();
+        invYSpacing_.resize(yPos_.size());
+        for (size_t i = 0; i < numX(); ++i)
+            updateInvYSpacing_(i, colOffset_[i], colOffset_[i + 1]);
+        updateCubicCoeffs_();
+    }
+
+    /*!
+     * \brief Append the sampling points to a flat table buffer and return the
+     *        descriptor of the function.
+     *
+     * The flat function always extrapolates, i.e., it corresponds to calling eval()
+     * with extrapolate set to true. Flat functions are interpolated bi-linearly, so
+     * functions which use monotone cubic interpolation cannot be exported.
+     */
+    template <class FlatScalar>
+    FlatUniformXTabulated2DFunction<FlatScalar> exportFlat(FlatTableBuffer<FlatScalar>& buffer) const
+    {
+        if (interpolation_ != TableInterpolation::Linear)
+            OPM_THROW(std::logic_error, "Only bi-linearly interpolated functions can be exported");
+        if (numX() < 2)
+            OPM_THROW(std::logic_error, "Only functions with at least two columns can be exported");
+        for (size_t i = 0; i < numX(); ++i)
+            if (numY(i) < 2)
+                OPM_THROW(std::logic_error, "Only functions with at least two sampling points per column "
+                          "can be exported");
+
+        FlatUniformXTabulated2DFunction<FlatScalar> result;
+        result.xOffset = buffer.appendScalars(xPos_.begin(), xPos_.end());
+        result.numX = static_cast<unsigned>(numX());
+        result.colOffsetIdx = buffer.appendIndices(colOffset_.begin(), colOffset_.end());
+        result.yOffset = buffer.appendScalars(yPos_.begin(), yPos_.end());
+        result.valuesOffset = buffer.appendScalars(values_.begin(), values_.end());
+        result.numValues = 1;
+        return result;
     }
 
     /*!
@@ -226,17 +343,16 @@ public:
             return false;
 
         Scalar i = xToI(x, /*extrapolate=*/false);
-        const auto& col1SamplePoints = samples_.at(unsigned(i));
-        const auto& col2SamplePoints = samples_.at(unsigned(i));
+        unsigned colIdx = unsigned(i);
         Scalar alpha = i - static_cast<int>(i);
 
         Scalar minY =
-                alpha*std::get<1>(col1SamplePoints.front()) +
-                (1 - alpha)*std::get<1>(col2SamplePoints.front());
+                alpha*yMin(colIdx) +
+                (1 - alpha)*yMin(colIdx);
 
         Scalar maxY =
-                alpha*std::get<1>(col1SamplePoints.back()) +
-                (1 - alpha)*std::get<1>(col2SamplePoints.back());
+                alpha*yMax(colIdx) +
+                (1 - alpha)*yMax(colIdx);
 
         return minY <= y && y <= maxY;
     }
@@ -249,49 +365,56 @@ public:
     template <class Evaluation>
     Evaluation eval(const Evaluation& x, const Evaluation& y, bool extrapolate=false) const
     {
-#ifndef NDEBUG
-        if (!extrapolate && !applies(Opm::scalarValue(x), Opm::scalarValue(y))) {
-            OPM_THROW(NumericalProblem,
-                      "Attempt to get undefined table value (" << x << ", " << y << ")");
-        };
-#endif
-
-        // bi-linear interpolation: first, calculate the x and y indices in the lookup
-        // table ...
-        Evaluation alpha = xToI(x, extrapolate);
-        size_t i =
-            static_cast<size_t>(std::max(0, std::min(static_cast<int>(numX()) - 2,
-                                                     static_cast<int>(Opm::scalarValue(alpha)))));
-        alpha -= i;
-
-        Evaluation beta1;
-        Evaluation beta2;
-
-        beta1 = yToJ(i, y, extrapolate);
-        beta2 = yToJ(i + 1, y, extrapolate);
-
-        size_t j1 = static_cast<size_t>(std::max(0, std::min(static_cast<int>(numY(i)) - 2,
-                                                             static_cast<int>(Opm::scalarValue(beta1)))));
-        size_t j2 = static_cast<size_t>(std::max(0, std::min(static_cast<int>(numY(i + 1)) - 2,
-                                                             static_cast<int>(Opm::scalarValue(beta2)))));
-
-        beta1 -= j1;
-        beta2 -= j2;
-
-        // evaluate the two function values for the same y value ...
-        Evaluation s1, s2;
-        s1 = valueAt(i, j1)*(1.0 - beta1) + valueAt(i, j1 + 1)*beta1;
-        s2 = valueAt(i + 1, j2)*(1.0 - beta2) + valueAt(i + 1, j2 + 1)*beta2;
+        size_t segIdx[3] = { 0, 0, 0 };
+        return eval_(x, y, extrapolate, segIdx);
+    }
 
-        Valgrind::CheckDefined(s1);
-        Valgrind::CheckDefined(s2);
+    /*!
+     * \brief Evaluate the function at a given (x,y) position using a lookup hint.
+     *
+     * The result is identical to that of the eval() method which does not take a hint,
+     * but the segments stored in the hint are checked before the full searches are
+     * done. Afterwards, the hint contains the segments which were used.
+     */
+    template <class Evaluation>
+    Evaluation eval(const Evaluation& x,
+                    const Evaluation& y,
+                    LookupHint& hint,
+                    bool extrapolate=false) const
+    {
+        size_t segIdx[3] = { hint.segmentIdx(0), hint.segmentIdx(1), hint.segmentIdx(2) };
+        const Evaluation& result = eval_(x, y, extrapolate, segIdx);
+        for (unsigned k = 0; k < 3; ++k)
+            hint.setSegmentIdx(k, static_cast<unsigned>(segIdx[k]));
+        return result;
+    }
 
-        // ... and finally combine them using x the position
-        Evaluation result;
-        result = s1*(1.0 - alpha) + s2*alpha;
-        Valgrind::CheckDefined(result);
+    /*!
+     * \brief Evaluate the function at a given (x,y) position without throwing.
+     *
+     * Positions outside of the tabulated range are extrapolated and recorded as
+     * ErrorStatus::TableOutOfRange for the calling thread.
+     */
+    template <class Evaluation>
+    Evaluation evalNoThrow(const Evaluation& x, const Evaluation& y) const
+    {
+        if (!applies(Opm::scalarValue(x), Opm::scalarValue(y)))
+            ErrorStatus::record(ErrorStatus::TableOutOfRange);
+        return eval(x, y, /*extrapolate=*/true);
+    }
 
-        return result;
+    /*!
+     * \brief Evaluate the function at a given (x,y) position using a lookup hint
+     *        without throwing.
+     *
+     * See evalNoThrow() for how positions outside of the range are treated.
+     */
+    template <class Evaluation>
+    Evaluation evalNoThrow(const Evaluation& x, const Evaluation& y, LookupHint& hint) const
+    {
+        if (!applies(Opm::scalarValue(x), Opm::scalarValue(y)))
+            ErrorStatus::record(ErrorStatus::TableOutOfRange);
+        return eval(x, y, hint, /*extrapolate=*/true);
     }
 
     /*!
@@ -301,15 +424,20 @@ public:
      */
     size_t appendXPos(Scalar nextX)
     {
+        if (colOffset_.empty())
+            colOffset_.push_back(0);
+
         if (xPos_.empty() || xPos_.back() < nextX) {
             xPos_.push_back(nextX);
-            samples_.resize(xPos_.size());
+            colOffset_.push_back(colOffset_.back());
+            updateInvXSpacing_();
             return xPos_.size() - 1;
         }
         else if (xPos_.front() > nextX) {
             // this is slow, but so what?
             xPos_.insert(xPos_.begin(), nextX);
-            samples_.insert(samples_.begin(), std::vector<SamplePoint>());
+            colOffset_.insert(colOffset_.begin(), 0);
+            updateInvXSpacing_();
             return 0;
         }
         OPM_THROW(std::invalid_argument,
@@ -326,14 +454,14 @@ public:
     {
         assert(0 <= i && i < numX());
 
-        Scalar x = iToX(i);
-        if (samples_[i].empty() || std::get<1>(samples_[i].back()) < y) {
-            samples_[i].push_back(SamplePoint(x, y, value));
-            return samples_[i].size() - 1;
+        if (numY(i) == 0 || yMax(i) < y) {
+            // this is cheap if the sampling points are appended column by column
+            insertSamplePoint_(i, colOffset_[i + 1], y, value);
+            return numY(i) - 1;
         }
-        else if (std::get<1>(samples_[i].front()) > y) {
+        else if (yMin(i) > y) {
             // slow, but we still don't care...
-            samples_[i].insert(samples_[i].begin(), SamplePoint(x, y, value));
+            insertSamplePoint_(i, colOffset_[i], y, value);
             return 0;
         }
 
@@ -342,6 +470,66 @@ public:
                   "ascending or descending order.");
     }
 
+    /*!
+     * \brief Append all sampling points of a column at once.
+     *
+     * The positions on the y-axis must be strictly ascending and larger than the ones
+     * of the sampling points which have already been added to the column. Compared to
+     * calling appendSamplePoint() for each point, the subsequent columns are only
+     * shifted once if the column is not the last one.
+     */
+    template <class YContainer, class ValueContainer>
+    void appendSamplePoints(size_t i, const YContainer& y, const ValueContainer& values)
+    {
+        assert(0 <= i && i < numX());
+        assert(y.size() == values.size());
+
+        size_t n = y.size();
+        if (n == 0)
+            return;
+
+        auto yIt = y.begin();
+        Scalar lastY = *yIt;
+        if (numY(i) > 0 && !(yMax(i) < lastY))
+            OPM_THROW(std::invalid_argument,
+                      "Sampling points must be specified in ascending order.");
+        for (++yIt; yIt != y.end(); ++yIt) {
+            if (!(lastY < *yIt))
+                OPM_THROW(std::invalid_argument,
+                          "Sampling points must be specified in ascending order.");
+            lastY = *yIt;
+        }
+
+        size_t flatIdx = colOffset_[i + 1];
+        yPos_.insert(yPos_.begin() + flatIdx, y.begin(), y.end());
+        invYSpacing_.insert(invYSpacing_.begin() + flatIdx, n, 0.0);
+        values_.insert(values_.begin() + flatIdx, values.begin(), values.end());
+        for (size_t k = i + 1; k < colOffset_.size(); ++k)
+            colOffset_[k] += n;
+        updateInvYSpacing_(i, flatIdx, flatIdx + n);
+        if (interpolation_ == TableInterpolation::MonotoneCubic) {
+            cubicCoeffs_.insert(cubicCoeffs_.begin() + MonotoneCubic::numCoeffs*flatIdx,
+                                MonotoneCubic::numCoeffs*n, 0.0);
+            updateColumnCubicCoeffs_(i);
+        }
+    }
+
+    /*!
+     * \brief Reserve the memory for a given number of columns and sampling points.
+     *
+     * This avoids the reallocations of the internal arrays if the size of the table
+     * is known before it is filled.
+     */
+    void reserve(size_t numColumns, size_t numSamplePoints)
+    {
+        xPos_.reserve(numColumns);
+        invXSpacing_.reserve(numColumns);
+        colOffset_.reserve(numColumns + 1);
+        yPos_.reserve(numSamplePoints);
+        invYSpacing_.reserve(numSamplePoints);
+        values_.reserve(numSamplePoints);
+    }
+
     /*!
      * \brief Print the table for debugging purposes.
      *
@@ -376,13 +564,310 @@ public:
     }
 
 private:
-    // the vector which contains the values of the sample points
-    // f(x_i, y_j). don't use this directly, use getSamplePoint(i,j)
-    // instead!
-    std::vector<std::vector<SamplePoint> > samples_;
+    typedef MonotoneCubicInterpolation<Scalar> MonotoneCubic;
+
+    // bi-linear interpolation. segIdx contains the hints for the segment indices on
+    // input and the ones which were used on output.
+    template <class Evaluation>
+    Evaluation eval_(const Evaluation& x,
+                     const Evaluation& y,
+                     bool extrapolate,
+                     size_t* segIdx) const
+    {
+#ifndef NDEBUG
+        if (!extrapolate && !applies(Opm::scalarValue(x), Opm::scalarValue(y))) {
+            OPM_THROW(NumericalProblem,
+                      "Attempt to get undefined table value (" << x << ", " << y << ")");
+        };
+#endif
+
+        // bi-linear interpolation: first, calculate the x and y indices in the lookup
+        // table ...
+        assert(extrapolate || (xMin() <= x && x <= xMax()));
+        segIdx[0] = xSegmentIndex_(Opm::scalarValue(x), std::min(segIdx[0], numX() - 2));
+        Evaluation alpha = xToI_(x, segIdx[0]);
+        size_t i =
+            static_cast<size_t>(std::max(0, std::min(static_cast<int>(numX()) - 2,
+                                                     static_cast<int>(Opm::scalarValue(alpha)))));
+        alpha -= i;
+
+        Evaluation beta1;
+        Evaluation beta2;
+
+        segIdx[1] = ySegmentIndex_(i, Opm::scalarValue(y), segIdx[1]);
+        segIdx[2] = ySegmentIndex_(i + 1, Opm::scalarValue(y), segIdx[2]);
+        beta1 = yToJ_(i, y, segIdx[1]);
+        beta2 = yToJ_(i + 1, y, segIdx[2]);
+
+        size_t j1 = static_cast<size_t>(std::max(0, std::min(static_cast<int>(numY(i)) - 2,
+                                                             static_cast<int>(Opm::scalarValue(beta1)))));
+        size_t j2 = static_cast<size_t>(std::max(0, std::min(static_cast<int>(numY(i + 1)) - 2,
+                                                             static_cast<int>(Opm::scalarValue(beta2)))));
+
+        beta1 -= j1;
+        beta2 -= j2;
+
+        if (interpolation_ == TableInterpolation::MonotoneCubic)
+            return evalCubic_(x, y, i, j1, j2, beta1, alpha);
+
+        // the lookups are profiled by the sampling point at the lower end of the
+        // segment of the left column
+        OPM_MATERIAL_PROFILE_TABLE(profile_, colOffset_[i] + j1,
+                                   Opm::scalarValue(alpha) < 0.0 || Opm::scalarValue(alpha) > 1.0
+                                   || Opm::scalarValue(beta1) < 0.0 || Opm::scalarValue(beta1) > 1.0);
+
+        // evaluate the two function values for the same y value ...
+        Evaluation s1, s2;
+        s1 = Opm::DenseAd::evaluate(valueAt(i, j1)*(1.0 - Opm::DenseAd::lazy(beta1))
+                                    + valueAt(i, j1 + 1)*Opm::DenseAd::lazy(beta1));
+        s2 = Opm::DenseAd::evaluate(valueAt(i + 1, j2)*(1.0 - Opm::DenseAd::lazy(beta2))
+                                    + valueAt(i + 1, j2 + 1)*Opm::DenseAd::lazy(beta2));
+
+        Valgrind::CheckDefined(s1);
+        Valgrind::CheckDefined(s2);
+
+        // ... and finally combine them using x the position
+        Evaluation result;
+        result = Opm::DenseAd::evaluate(Opm::DenseAd::lazy(s1)*(1.0 - Opm::DenseAd::lazy(alpha))
+                                        + Opm::DenseAd::lazy(s2)*Opm::DenseAd::lazy(alpha));
+        Valgrind::CheckDefined(result);
+
+        return result;
+    }
+
+    // monotone cubic interpolation. i is the segment on the x-axis and j1 and j2 are
+    // the segments of the columns i and i + 1 which contain y.
+    template <class Evaluation>
+    Evaluation evalCubic_(const Evaluation& x,
+                          const Evaluation& y,
+                          size_t i,
+                          size_t j1,
+                          size_t j2,
+                          const Evaluation& beta1,
+                          const Evaluation& alpha) const
+    {
+        // the positions within the segments are only needed by the profiler
+#if OPM_MATERIAL_PROFILE_TABLES
+        OPM_MATERIAL_PROFILE_TABLE(profile_, colOffset_[i] + j1,
+                                   Opm::scalarValue(alpha) < 0.0 || Opm::scalarValue(alpha) > 1.0
+                                   || Opm::scalarValue(beta1) < 0.0 || Opm::scalarValue(beta1) > 1.0);
+#else
+        (void) alpha;
+        (void) beta1;
+#endif
+
+        // the values of the two columns for the requested y value ...
+        const Evaluation& s1 = evalColumnCubic_(i, j1, y);
+        const Evaluation& s2 = evalColumnCubic_(i + 1, j2, y);
+
+        // ... the slopes of the function in x direction at these columns ...
+        Scalar x1 = xPos_[i];
+        Scalar x2 = xPos_[i + 1];
+        const Evaluation& delta = (s2 - s1)*invXSpacing_[i];
+
+        Evaluation m1 = delta;
+        if (i > 0) {
+            Scalar x0 = xPos_[i - 1];
+            size_t j0 = ySegmentIndex_(i - 1, Opm::scalarValue(y), j1);
+            const Evaluation& s0 = evalColumnCubic_(i - 1, j0, y);
+            m1 = MonotoneCubic::localSlope(x1 - x0, x2 - x1, (s1 - s0)*invXSpacing_[i - 1], delta);
+        }
+
+        Evaluation m2 = delta;
+        if (i + 2 < numX()) {
+            Scalar x3 = xPos_[i + 2];
+            size_t j3 = ySegmentIndex_(i + 2, Opm::scalarValue(y), j2);
+            const Evaluation& s3 = evalColumnCubic_(i + 2, j3, y);
+            m2 = MonotoneCubic::localSlope(x2 - x1, x3 - x2, delta, (s3 - s2)*invXSpacing_[i + 1]);
+        }
+
+        // ... and finally combine them using the x position
+        const Evaluation& result = MonotoneCubic::evalHermite(x1, x2, s1, s2, m1, m2, x);
+        Valgrind::CheckDefined(result);
 
-    // the position of each vertical line on the x-axis
+        return result;
+    }
+
+    // evaluate the j-th segment of the i-th column at a given y value
+    template <class Evaluation>
+    Evaluation evalColumnCubic_(size_t i, size_t j, const Evaluation& y) const
+    {
+        size_t flatIdx = colOffset_[i] + j;
+        return MonotoneCubic::eval(&cubicCoeffs_[MonotoneCubic::numCoeffs*flatIdx],
+                                   yPos_[flatIdx], yPos_[flatIdx + 1],
+                                   values_[flatIdx], values_[flatIdx + 1],
+                                   y);
+    }
+
+    template <class Evaluation>
+    Evaluation xToI_(const Evaluation& x, size_t segmentIdx) const
+    { return Scalar(segmentIdx) + (x - xPos_[segmentIdx])*invXSpacing_[segmentIdx]; }
+
+    template <class Evaluation>
+    Evaluation yToJ_(size_t i, const Evaluation& y, size_t segmentIdx) const
+    {
+        size_t flatIdx = colOffset_[i] + segmentIdx;
+        return Scalar(segmentIdx) + (y - yPos_[flatIdx])*invYSpacing_[flatIdx];
+    }
+
+    // find the segment on the x-axis which contains a given x value. the segment
+    // given by hintIdx is checked before resorting to bisection.
+    size_t xSegmentIndex_(Scalar x, size_t hintIdx) const
+    {
+        // we need at least two sampling points!
+        assert(xPos_.size() >= 2);
+        assert(hintIdx < xPos_.size() - 1);
+
+        if (x <= xPos_[1])
+            return 0;
+        else if (x >= xPos_[xPos_.size() - 2])
+            return xPos_.size() - 2;
+        else if (xPos_[hintIdx] <= x && x < xPos_[hintIdx + 1])
+            return hintIdx;
+
+        // bisection
+        size_t segmentIdx = 1;
+        size_t upperIdx = xPos_.size() - 2;
+        while (segmentIdx + 1 < upperIdx) {
+            size_t pivotIdx = (segmentIdx + upperIdx) / 2;
+            if (x < xPos_[pivotIdx])
+                upperIdx = pivotIdx;
+            else
+                segmentIdx = pivotIdx;
+        }
+
+        assert(xPos_[segmentIdx] <= x);
+        assert(x <= xPos_[segmentIdx + 1]);
+
+        return segmentIdx;
+    }
+
+    // find the segment of the i-th column which contains a given y value. the
+    // segment given by hintIdx is checked before resorting to interval halving.
+    size_t ySegmentIndex_(size_t i, Scalar y, size_t hintIdx) const
+    {
+        const Scalar* colY = yPos_.data() + colOffset_[i];
+        size_t n = numY(i);
+
+        // the checks are done such that the result is the same as the one of the
+        // interval halving below. in particular values beyond the range of the column
+        // are mapped to the first or the last segment
+        if (hintIdx + 1 < n
+            && (hintIdx == 0 || colY[hintIdx] <= y)
+            && (hintIdx + 2 == n || y < colY[hintIdx + 1]))
+            return hintIdx;
+
+        // interval halving
+        size_t lowerIdx = 0;
+        size_t upperIdx = n - 1;
+        size_t pivotIdx = (lowerIdx + upperIdx) / 2;
+        while (lowerIdx + 1 < upperIdx) {
+            if (y < colY[pivotIdx])
+                upperIdx = pivotIdx;
+            else
+                lowerIdx = pivotIdx;
+            pivotIdx = (lowerIdx + upperIdx) / 2;
+        }
+
+        return lowerIdx;
+    }
+
+    // insert a sampling point into the i-th column at a given position of the
+    // flattened arrays
+    void insertSamplePoint_(size_t i, size_t flatIdx, Scalar y, Scalar value)
+    {
+        yPos_.insert(yPos_.begin() + flatIdx, y);
+        invYSpacing_.insert(invYSpacing_.begin() + flatIdx, 0.0);
+        values_.insert(values_.begin() + flatIdx, value);
+        for (size_t k = i + 1; k < colOffset_.size(); ++k)
+            ++ colOffset_[k];
+        updateInvYSpacing_(i, flatIdx, flatIdx + 1);
+        if (interpolation_ == TableInterpolation::MonotoneCubic) {
+            cubicCoeffs_.insert(cubicCoeffs_.begin() + MonotoneCubic::numCoeffs*flatIdx,
+                                MonotoneCubic::numCoeffs, 0.0);
+            updateColumnCubicCoeffs_(i);
+        }
+    }
+
+    // compute the coefficients of the cubic segments of all columns if monotone cubic
+    // interpolation is used, else release them
+    void updateCubicCoeffs_()
+    {
+        cubicCoeffs_.clear();
+        if (interpolation_ != TableInterpolation::MonotoneCubic)
+            return;
+
+        cubicCoeffs_.resize(MonotoneCubic::numCoeffs*yPos_.size(), 0.0);
+        for (size_t i = 0; i < numX(); ++i)
+            updateColumnCubicCoeffs_(i);
+    }
+
+    // compute the coefficients of the cubic segments of the i-th column. like the
+    // inverse spacings, they are stored for each sampling point and the entries of the
+    // last one of the column are not used.
+    void updateColumnCubicCoeffs_(size_t i)
+    {
+        size_t n = numY(i);
+        if (n < 2)
+            return;
+
+        std::vector<Scalar> columnCoeffs;
+        MonotoneCubic::computeCoefficients(columnCoeffs, n,
+                                           yPos_.data() + colOffset_[i],
+                                           values_.data() + colOffset_[i]);
+        std::copy(columnCoeffs.begin(), columnCoeffs.end(),
+                  cubicCoeffs_.begin() + MonotoneCubic::numCoeffs*colOffset_[i]);
+    }
+
+    // compute the inverse distances of all adjacent sampling points on the x-axis.
+    // the entry of the last sampling point is not used.
+    void updateInvXSpacing_()
+    {
+        size_t n = xPos_.size();
+        invXSpacing_.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            invXSpacing_[i] = (i + 1 < n) ? 1/(xPos_[i + 1] - xPos_[i]) : 0.0;
+    }
+
+    // update the inverse distances of the sampling points of the i-th column after
+    // the ones in the range [beginIdx, endIdx) of the flattened arrays were
+    // inserted. the segments which start at these points and the one which ends at the
+    // first of them are affected. the entry of the last sampling point of the column
+    // is not used.
+    void updateInvYSpacing_(size_t i, size_t beginIdx, size_t endIdx)
+    {
+        size_t colBegin = colOffset_[i];
+        size_t colEnd = colOffset_[i + 1];
+        for (size_t flatIdx = std::max(beginIdx, colBegin + 1) - 1; flatIdx < endIdx; ++flatIdx)
+            invYSpacing_[flatIdx] =
+                (flatIdx + 1 < colEnd) ? 1/(yPos_[flatIdx + 1] - yPos_[flatIdx]) : 0.0;
+    }
+
+    // the positions on the y-axis and the function values f(x_i, y_j) of all sampling
+    // points. the sampling points are stored column by column, i.e., the ones of the
+    // i-th column are located at the indices [colOffset_[i], colOffset_[i + 1]). don't
+    // use these directly, use yAt(i, j) and valueAt(i, j) instead!
+    std::vector<Scalar> yPos_;
+    std::vector<Scalar> values_;
+    std::vector<size_t> colOffset_;
+
+    // the inverse distance of each sampling point to the next one of its column. this
+    // avoids the division of evaluations when mapping a position to the y-index.
+    std::vector<Scalar> invYSpacing_;
+
+    // the coefficients of the cubic segments of each sampling point if monotone cubic
+    // interpolation is used, else empty
+    std::vector<Scalar> cubicCoeffs_;
+    TableInterpolation interpolation_;
+
+    // the position of each vertical line on the x-axis and the inverse distances to
+    // the next one
     std::vector<Scalar> xPos_;
+    std::vector<Scalar> invXSpacing_;
+
+#if OPM_MATERIAL_PROFILE_TABLES
+    TableProfile profile_;
+#endif
 };
 } // namespace Opm
 
@@ -0,0 +1,496 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::UniformXTabulated2DMultiFunction
+ */
+#ifndef OPM_UNIFORM_X_TABULATED_2D_MULTI_FUNCTION_HPP
+#define OPM_UNIFORM_X_TABULATED_2D_MULTI_FUNCTION_HPP
+
+#include <opm/common/Valgrind.hpp>
+#include <opm/common/Exceptions.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Unused.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/FlatTables.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/TabulationLookupHint.hpp>
+#include <opm/material/common/TableProfiler.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include <assert.h>
+
+namespace Opm {
+
+/*!
+ * \brief Implements a set of scalar functions which depend on two variables and which
+ *        share the same sampling points.
+ *
+ * The sampling points must be arranged the same way as for UniformXTabulated2DFunction,
+ * i.e., the sampling points exhibit the same positions on the Y axis for each position
+ * on the X axis. In contrast to using multiple UniformXTabulated2DFunction objects,
+ * the sampling points only need to be looked up once for all quantities and the values
+ * of all quantities for a given sampling point are adjacent in memory.
+ *
+ * \tparam numValuesV The number of quantities which are stored for each sampling point
+ */
+template <class Scalar, unsigned numValuesV>
+class UniformXTabulated2DMultiFunction
+{
+public:
+    //! The number of quantities which are stored for each sampling point
+    static const unsigned numValues = numValuesV;
+
+    //! The type used to specify the values of all quantities for a sampling point
+    typedef std::array<Scalar, numValues> ValueArray;
+
+    //! The type of the objects which cache the segments found by the last lookup
+    //!
+    //! The indices have the same meaning as for UniformXTabulated2DFunction.
+    typedef TabulationLookupHint<3> LookupHint;
+
+    UniformXTabulated2DMultiFunction()
+    { }
+
+    /*!
+     * \brief Returns the minimum of the X coordinate of the sampling points.
+     */
+    Scalar xMin() const
+    { return xPos_.front(); }
+
+    /*!
+     * \brief Returns the maximum of the X coordinate of the sampling points.
+     */
+    Scalar xMax() const
+    { return xPos_.back(); }
+
+    /*!
+     * \brief Returns the value of the X coordinate of the sampling points.
+     */
+    Scalar xAt(size_t i) const
+    { return xPos_[i]; }
+
+    /*!
+     * \brief Returns the value of the Y coordinate of a sampling point.
+     */
+    Scalar yAt(size_t i, size_t j) const
+    { return yPos_[colOffset_[i] + j]; }
+
+    /*!
+     * \brief Returns the value of the valueIdx-th quantity at a sampling point.
+     */
+    Scalar valueAt(size_t i, size_t j, unsigned valueIdx) const
+    { return values_[colOffset_[i] + j][valueIdx]; }
+
+    /*!
+     * \brief Returns the number of sampling points in X direction.
+     */
+    size_t numX() const
+    { return xPos_.size(); }
+
+    /*!
+     * \brief Returns the number of sampling points in Y direction a given column.
+     */
+    size_t numY(size_t i) const
+    {
+        assert(i < numX());
+        return colOffset_[i + 1] - colOffset_[i];
+    }
+
+    /*!
+     * \brief Returns the minimum of the Y coordinate of the sampling points for a given column.
+     */
+    Scalar yMin(size_t i) const
+    { return yAt(i, 0); }
+
+    /*!
+     * \brief Returns the maximum of the Y coordinate of the sampling points for a given column.
+     */
+    Scalar yMax(size_t i) const
+    { return yAt(i, numY(i) - 1); }
+
+    /*!
+     * \brief Set the name under which the lookups of the function are reported if
+     *        table profiling is enabled.
+     *
+     * See UniformXTabulated2DFunction::setProfileName().
+     */
+    void setProfileName(const std::string& name)
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        profile_.setName(name);
+#else
+        (void) name;
+#endif
+    }
+
+    /*!
+     * \brief Returns the number of bytes allocated by the function for its sampling
+     *        points.
+     *
+     * The size of the object itself is not included.
+     */
+    std::size_t heapMemoryUsage() const
+    {
+        return
+            vectorMemoryUsage(xPos_)
+            + vectorMemoryUsage(invXSpacing_)
+            + vectorMemoryUsage(yPos_)
+            + vectorMemoryUsage(invYSpacing_)
+            + vectorMemoryUsage(values_)
+            + vectorMemoryUsage(colOffset_);
+    }
+
+    /*!
+     * \brief Write the sampling points to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(xPos_);
+        writer.write(yPos_);
+        writer.write(values_);
+        writer.write(colOffset_);
+    }
+
+    /*!
+     * \brief Restore a function which was written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(xPos_);
+        reader.read(yPos_);
+        reader.read(values_);
+        reader.read(colOffset_);
+
+        // the column offsets are only allocated once the first column is added
+        bool consistent =
+            yPos_.size() == values_.size()
+            && (colOffset_.empty()
+                ? xPos_.empty() && yPos_.empty()
+                : colOffset_.size() == xPos_.size() + 1 && colOffset_.back() == yPos_.size());
+        if (!consistent)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: inconsistent sampling points");
+
+        // the inverse spacings are not serialized because they can be cheaply
+        // recomputed
+        updateInvXSpacing_();
+        invYSpacing_.resize(yPos_.size());
+        for (size_t i = 0; i < numX(); ++i)
+            updateInvYSpacing_(i, colOffset_[i], colOffset_[i + 1]);
+    }
+
+    /*!
+     * \brief Append the sampling points to a flat table buffer and return the
+     *        descriptor of the function.
+     *
+     * The quantities of each sampling point are stored next to each other. The flat
+     * function always extrapolates.
+     */
+    template <class FlatScalar>
+    FlatUniformXTabulated2DFunction<FlatScalar> exportFlat(FlatTableBuffer<FlatScalar>& buffer) const
+    {
+        if (numX() < 2)
+            OPM_THROW(std::logic_error, "Only functions with at least two columns can be exported");
+        for (size_t i = 0; i < numX(); ++i)
+            if (numY(i) < 2)
+                OPM_THROW(std::logic_error, "Only functions with at least two sampling points per column "
+                          "can be exported");
+
+        FlatUniformXTabulated2DFunction<FlatScalar> result;
+        result.xOffset = buffer.appendScalars(xPos_.begin(), xPos_.end());
+        result.numX = static_cast<unsigned>(numX());
+        result.colOffsetIdx = buffer.appendIndices(colOffset_.begin(), colOffset_.end());
+        result.yOffset = buffer.appendScalars(yPos_.begin(), yPos_.end());
+        result.valuesOffset = static_cast<unsigned>(buffer.scalars().size());
+        for (const auto& values : values_)
+            buffer.appendScalars(values.begin(), values.end());
+        result.numValues = numValues;
+        return result;
+    }
+
+    /*!
+     * \brief Evaluate all quantities at a given (x,y) position.
+     *
+     * For each quantity, the result is the same as the one of
+     * UniformXTabulated2DFunction::eval() for a table with the same sampling points.
+     */
+    template <class Evaluation>
+    void eval(const Evaluation& x,
+              const Evaluation& y,
+              std::array<Evaluation, numValues>& result,
+              bool extrapolate=false) const
+    {
+        size_t segIdx[3] = { 0, 0, 0 };
+        eval_(x, y, result, extrapolate, segIdx);
+    }
+
+    /*!
+     * \brief Evaluate all quantities at a given (x,y) position using a lookup hint.
+     */
+    template <class Evaluation>
+    void eval(const Evaluation& x,
+              const Evaluation& y,
+              std::array<Evaluation, numValues>& result,
+              LookupHint& hint,
+              bool extrapolate=false) const
+    {
+        size_t segIdx[3] = { hint.segmentIdx(0), hint.segmentIdx(1), hint.segmentIdx(2) };
+        eval_(x, y, result, extrapolate, segIdx);
+        for (unsigned k = 0; k < 3; ++k)
+            hint.setSegmentIdx(k, static_cast<unsigned>(segIdx[k]));
+    }
+
+    /*!
+     * \brief Set the x-position of a vertical line.
+     *
+     * Returns the i index of that line.
+     */
+    size_t appendXPos(Scalar nextX)
+    {
+        if (colOffset_.empty())
+            colOffset_.push_back(0);
+
+        if (xPos_.empty() || xPos_.back() < nextX) {
+            xPos_.push_back(nextX);
+            colOffset_.push_back(colOffset_.back());
+            updateInvXSpacing_();
+            return xPos_.size() - 1;
+        }
+        else if (xPos_.front() > nextX) {
+            // this is slow, but so what?
+            xPos_.insert(xPos_.begin(), nextX);
+            colOffset_.insert(colOffset_.begin(), 0);
+            updateInvXSpacing_();
+            return 0;
+        }
+        OPM_THROW(std::invalid_argument,
+                  "Sampling points should be specified either monotonically "
+                  "ascending or descending.");
+    }
+
+    /*!
+     * \brief Append a sample point.
+     *
+     * Returns the j index of that point.
+     */
+    size_t appendSamplePoint(size_t i, Scalar y, const ValueArray& values)
+    {
+        assert(0 <= i && i < numX());
+
+        if (numY(i) == 0 || yMax(i) < y) {
+            insertSamplePoint_(i, colOffset_[i + 1], y, values);
+            return numY(i) - 1;
+        }
+        else if (yMin(i) > y) {
+            // slow, but we still don't care...
+            insertSamplePoint_(i, colOffset_[i], y, values);
+            return 0;
+        }
+
+        OPM_THROW(std::invalid_argument,
+                  "Sampling points must be specified in either monotonically "
+                  "ascending or descending order.");
+    }
+
+    /*!
+     * \brief Reserve the memory for a given number of columns and sampling points.
+     *
+     * See UniformXTabulated2DFunction::reserve().
+     */
+    void reserve(size_t numColumns, size_t numSamplePoints)
+    {
+        xPos_.reserve(numColumns);
+        invXSpacing_.reserve(numColumns);
+        colOffset_.reserve(numColumns + 1);
+        yPos_.reserve(numSamplePoints);
+        invYSpacing_.reserve(numSamplePoints);
+        values_.reserve(numSamplePoints);
+    }
+
+private:
+    template <class Evaluation>
+    void eval_(const Evaluation& x,
+               const Evaluation& y,
+               std::array<Evaluation, numValues>& result,
+               bool extrapolate OPM_OPTIM_UNUSED,
+               size_t* segIdx) const
+    {
+        assert(extrapolate || (xMin() <= x && x <= xMax()));
+
+        // calculate the x and y indices in the lookup table. this is done exactly the
+        // same way as by UniformXTabulated2DFunction
+        segIdx[0] = xSegmentIndex_(Opm::scalarValue(x), std::min(segIdx[0], numX() - 2));
+        Evaluation alpha = Scalar(segIdx[0]) + (x - xPos_[segIdx[0]])*invXSpacing_[segIdx[0]];
+        size_t i =
+            static_cast<size_t>(std::max(0, std::min(static_cast<int>(numX()) - 2,
+                                                     static_cast<int>(Opm::scalarValue(alpha)))));
+        alpha -= i;
+
+        segIdx[1] = ySegmentIndex_(i, Opm::scalarValue(y), segIdx[1]);
+        segIdx[2] = ySegmentIndex_(i + 1, Opm::scalarValue(y), segIdx[2]);
+        const size_t flatIdx1 = colOffset_[i] + segIdx[1];
+        const size_t flatIdx2 = colOffset_[i + 1] + segIdx[2];
+        Evaluation beta1 = Scalar(segIdx[1]) + (y - yPos_[flatIdx1])*invYSpacing_[flatIdx1];
+        Evaluation beta2 = Scalar(segIdx[2]) + (y - yPos_[flatIdx2])*invYSpacing_[flatIdx2];
+
+        size_t j1 = static_cast<size_t>(std::max(0, std::min(static_cast<int>(numY(i)) - 2,
+                                                             static_cast<int>(Opm::scalarValue(beta1)))));
+        size_t j2 = static_cast<size_t>(std::max(0, std::min(static_cast<int>(numY(i + 1)) - 2,
+                                                             static_cast<int>(Opm::scalarValue(beta2)))));
+
+        beta1 -= j1;
+        beta2 -= j2;
+
+        // the lookups are profiled by the sampling point at the lower end of the
+        // segment of the left column
+        OPM_MATERIAL_PROFILE_TABLE(profile_, colOffset_[i] + j1,
+                                   Opm::scalarValue(alpha) < 0.0 || Opm::scalarValue(alpha) > 1.0
+                                   || Opm::scalarValue(beta1) < 0.0 || Opm::scalarValue(beta1) > 1.0);
+
+        const ValueArray& v11 = values_[colOffset_[i] + j1];
+        const ValueArray& v12 = values_[colOffset_[i] + j1 + 1];
+        const ValueArray& v21 = values_[colOffset_[i + 1] + j2];
+        const ValueArray& v22 = values_[colOffset_[i + 1] + j2 + 1];
+        for (unsigned valueIdx = 0; valueIdx < numValues; ++valueIdx) {
+            // evaluate the two function values for the same y value ...
+            Evaluation s1, s2;
+            s1 = v11[valueIdx]*(1.0 - beta1) + v12[valueIdx]*beta1;
+            s2 = v21[valueIdx]*(1.0 - beta2) + v22[valueIdx]*beta2;
+
+            // ... and finally combine them using x the position
+            result[valueIdx] = s1*(1.0 - alpha) + s2*alpha;
+            Valgrind::CheckDefined(result[valueIdx]);
+        }
+    }
+
+    // find the segment on the x-axis which contains a given x value. this works the
+    // same way as in UniformXTabulated2DFunction.
+    size_t xSegmentIndex_(Scalar x, size_t hintIdx) const
+    {
+        assert(xPos_.size() >= 2);
+        assert(hintIdx < xPos_.size() - 1);
+
+        if (x <= xPos_[1])
+            return 0;
+        else if (x >= xPos_[xPos_.size() - 2])
+            return xPos_.size() - 2;
+        else if (xPos_[hintIdx] <= x && x < xPos_[hintIdx + 1])
+            return hintIdx;
+
+        // bisection
+        size_t segmentIdx = 1;
+        size_t upperIdx = xPos_.size() - 2;
+        while (segmentIdx + 1 < upperIdx) {
+            size_t pivotIdx = (segmentIdx + upperIdx) / 2;
+            if (x < xPos_[pivotIdx])
+                upperIdx = pivotIdx;
+            else
+                segmentIdx = pivotIdx;
+        }
+
+        return segmentIdx;
+    }
+
+    // find the segment of the i-th column which contains a given y value. this works
+    // the same way as in UniformXTabulated2DFunction.
+    size_t ySegmentIndex_(size_t i, Scalar y, size_t hintIdx) const
+    {
+        const Scalar* colY = yPos_.data() + colOffset_[i];
+        size_t n = numY(i);
+
+        if (hintIdx + 1 < n
+            && (hintIdx == 0 || colY[hintIdx] <= y)
+            && (hintIdx + 2 == n || y < colY[hintIdx + 1]))
+            return hintIdx;
+
+        // interval halving
+        size_t lowerIdx = 0;
+        size_t upperIdx = n - 1;
+        size_t pivotIdx = (lowerIdx + upperIdx) / 2;
+        while (lowerIdx + 1 < upperIdx) {
+            if (y < colY[pivotIdx])
+                upperIdx = pivotIdx;
+            else
+                lowerIdx = pivotIdx;
+            pivotIdx = (lowerIdx + upperIdx) / 2;
+        }
+
+        return lowerIdx;
+    }
+
+    void insertSamplePoint_(size_t i, size_t flatIdx, Scalar y, const ValueArray& values)
+    {
+        yPos_.insert(yPos_.begin() + flatIdx, y);
+        invYSpacing_.insert(invYSpacing_.begin() + flatIdx, 0.0);
+        values_.insert(values_.begin() + flatIdx, values);
+        for (size_t k = i + 1; k < colOffset_.size(); ++k)
+            ++ colOffset_[k];
+        updateInvYSpacing_(i, flatIdx, flatIdx + 1);
+    }
+
+    // see UniformXTabulated2DFunction
+    void updateInvXSpacing_()
+    {
+        size_t n = xPos_.size();
+        invXSpacing_.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            invXSpacing_[i] = (i + 1 < n) ? 1/(xPos_[i + 1] - xPos_[i]) : 0.0;
+    }
+
+    void updateInvYSpacing_(size_t i, size_t beginIdx, size_t endIdx)
+    {
+        size_t colBegin = colOffset_[i];
+        size_t colEnd = colOffset_[i + 1];
+        for (size_t flatIdx = std::max(beginIdx, colBegin + 1) - 1; flatIdx < endIdx; ++flatIdx)
+            invYSpacing_[flatIdx] =
+                (flatIdx + 1 < colEnd) ? 1/(yPos_[flatIdx + 1] - yPos_[flatIdx]) : 0.0;
+    }
+
+    // the positions on the y-axis and the values of all quantities of the sampling
+    // points. the sampling points are stored column by column, i.e., the ones of the
+    // i-th column are located at the indices [colOffset_[i], colOffset_[i + 1]).
+    std::vector<Scalar> yPos_;
+    std::vector<ValueArray> values_;
+    std::vector<size_t> colOffset_;
+
+    // the inverse distance of each sampling point to the next one of its column
+    std::vector<Scalar> invYSpacing_;
+
+    // the position of each vertical line on the x-axis and the inverse distances to
+    // the next one
+    std::vector<Scalar> xPos_;
+    std::vector<Scalar> invXSpacing_;
+
+#if OPM_MATERIAL_PROFILE_TABLES
+    TableProfile profile_;
+#endif
+};
+} // namespace Opm
+
+#endif
@@ -0,0 +1,135 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief The value-only mode of the batched evaluation methods.
+ *
+ * Line searches, residual checks, convergence tests and the output only need the
+ * values of the constitutive relations, not their derivatives. The batched methods
+ * thus allow the type of the results to differ from the one of the inputs: If the
+ * results are plain scalars while the inputs are Evaluations, only the values of the
+ * inputs are used and the same code path is instantiated for scalars, i.e., no
+ * derivatives are computed at all. E.g.,
+ *
+ * \code
+ * std::vector<Evaluation> p, T, Rs;     // the primary variables of the Newton method
+ * std::vector<double> invBoValue(numCells);
+ * pvtBatch.inverseFormationVolumeFactor(oilPvt, T.data(), p.data(), Rs.data(), invBoValue.data());
+ * \endcode
+ *
+ * This is supported by
+ *
+ * - the methods of Opm::PvtRegionBatch,
+ * - EclMaterialLawManager::relativePermeabilities(),
+ *   EclMaterialLawManager::capillaryPressures() and their "OfElements" variants,
+ * - the evalMany() methods of Opm::Tabulated1DFunction, Opm::Spline and
+ *   Opm::UniformTabulated2DFunction,
+ * - the "Batch" methods of the fluid systems and
+ *   BlackOilFluidSystem::computeAllPhaseProperties(), whose result type is given by
+ *   the 'LhsEval' template argument.
+ *
+ * If the types of the inputs and the results are the same, the inputs are used as
+ * they are, so the full evaluation does not pay for this.
+ */
+#ifndef OPM_VALUE_ONLY_HPP
+#define OPM_VALUE_ONLY_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <opm/common/Unused.hpp>
+
+#include <vector>
+#include <cstddef>
+
+namespace Opm {
+
+/*!
+ * \brief Provides a fixed number of arrays of inputs as arrays of the type of the
+ *        results of a batched evaluation.
+ *
+ * If the types differ, the inputs are decayed into scratch storage which is reused by
+ * subsequent calls of assign(). Otherwise, the arrays of the inputs are passed through.
+ */
+template <class ResultEval, class InputEval, unsigned numArrays>
+class DecayedArrays
+{
+public:
+    DecayedArrays()
+    {}
+
+    DecayedArrays(const InputEval* const* inputs, size_t numValues)
+    { assign(inputs, numValues); }
+
+    /*!
+     * \brief Decay the first numValues entries of each array of inputs.
+     */
+    void assign(const InputEval* const* inputs, size_t numValues)
+    {
+        storage_.resize(numArrays*numValues);
+        for (unsigned arrayIdx = 0; arrayIdx < numArrays; ++arrayIdx) {
+            ResultEval* dest = storage_.data() + arrayIdx*numValues;
+            const InputEval* src = inputs[arrayIdx];
+            for (size_t i = 0; i < numValues; ++i)
+                dest[i] = Opm::decay<ResultEval>(src[i]);
+            arrays_[arrayIdx] = dest;
+        }
+    }
+
+    /*!
+     * \brief Returns the decayed arrays.
+     */
+    const ResultEval* const* arrays() const
+    { return arrays_; }
+
+private:
+    std::vector<ResultEval> storage_;
+    const ResultEval* arrays_[numArrays];
+};
+
+template <class Eval, unsigned numArrays>
+class DecayedArrays<Eval, Eval, numArrays>
+{
+public:
+    DecayedArrays()
+    {}
+
+    DecayedArrays(const Eval* const* inputs, size_t numValues)
+    { assign(inputs, numValues); }
+
+    void assign(const Eval* const* inputs, size_t numValues OPM_UNUSED)
+    {
+        for (unsigned arrayIdx = 0; arrayIdx < numArrays; ++arrayIdx)
+            arrays_[arrayIdx] = inputs[arrayIdx];
+    }
+
+    const Eval* const* arrays() const
+    { return arrays_; }
+
+private:
+    const Eval* arrays_[numArrays];
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,253 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::WorkStealingScheduler
+ */
+#ifndef OPM_WORK_STEALING_SCHEDULER_HPP
+#define OPM_WORK_STEALING_SCHEDULER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Opm {
+
+/*!
+ * \brief Distributes work items of very different cost to the threads by work stealing.
+ *
+ * This is intended for batched calculations whose cost per cell varies by orders of
+ * magnitude, e.g. flash calculations where single-phase cells converge immediately
+ * while near-critical ones need dozens of iterations. With a static partitioning of
+ * the cells, the threads which got the cheap cells are idle while the others are
+ * still busy.
+ *
+ * Each thread owns a queue of items which initially holds a contiguous range of them.
+ * A thread takes chunks from the front of its queue whose size is a fraction of the
+ * items left in it, i.e., the chunks get smaller towards the end. If its queue is
+ * empty, a thread steals half of the items from the back of another thread's queue.
+ * The function which processes a chunk may leave items which need more work in it,
+ * e.g. cells which did not converge within a few iterations. These items are
+ * re-queued at the back of the queue of the thread, where they are the first ones to
+ * be stolen by idle threads.
+ *
+ * The function is invoked as 'fn(chunk)' where 'chunk' is a std::vector of item
+ * indices. On return, 'chunk' must contain the items which still need work, which
+ * must be a subset of the ones passed. The function is called concurrently by all
+ * threads if OpenMP is enabled, so it must only modify the data of the items of its
+ * chunk. If the function throws, the remaining items are abandoned and the exception
+ * is rethrown by run(). For example:
+ *
+ * \code
+ * Opm::WorkStealingScheduler<unsigned> scheduler;
+ * scheduler.run(numCells, [&](std::vector<unsigned>& chunk) {
+ *         unsigned numUnfinished = 0;
+ *         for (unsigned cellIdx : chunk)
+ *             if (!iterate(cellIdx, 4)) // at most four iterations at a time
+ *                 chunk[numUnfinished++] = cellIdx;
+ *         chunk.resize(numUnfinished);
+ *     });
+ * \endcode
+ */
+template <class Index = unsigned>
+class WorkStealingScheduler
+{
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Index> items;
+    };
+
+public:
+    typedef std::vector<Index> Chunk;
+
+    /*!
+     * \brief Create a scheduler which does not hand out chunks smaller than a given
+     *        number of items unless fewer items are left in the queue of a thread.
+     */
+    explicit WorkStealingScheduler(std::size_t minChunkSize = 1)
+        : minChunkSize_(std::max<std::size_t>(minChunkSize, 1))
+    {}
+
+    /*!
+     * \brief The minimum number of items of a chunk.
+     */
+    std::size_t minChunkSize() const
+    { return minChunkSize_; }
+
+    /*!
+     * \brief Process the items [0, numItems) until no item needs any more work.
+     *
+     * The calling thread does all the work if OpenMP is disabled, if it is called
+     * within a parallel region or if there are not more items than the minimum size
+     * of a chunk.
+     */
+    template <class ChunkFunction>
+    void run(std::size_t numItems, ChunkFunction fn)
+    {
+        if (numItems == 0)
+            return;
+
+        exception_ = nullptr;
+        abort_ = false;
+#ifdef _OPENMP
+        if (!omp_in_parallel() && omp_get_max_threads() > 1 && numItems > minChunkSize_) {
+#pragma omp parallel
+            {
+#pragma omp single
+                distribute_(numItems, static_cast<unsigned>(omp_get_num_threads()));
+
+                work_(static_cast<unsigned>(omp_get_thread_num()), fn);
+            }
+        }
+        else
+#endif
+        {
+            distribute_(numItems, /*numThreads=*/1);
+            work_(/*threadIdx=*/0, fn);
+        }
+
+        queues_.clear();
+        if (exception_)
+            std::rethrow_exception(exception_);
+    }
+
+private:
+    // fill the queues of the threads with contiguous ranges of items
+    void distribute_(std::size_t numItems, unsigned numThreads)
+    {
+        queues_.clear();
+        for (unsigned threadIdx = 0; threadIdx < numThreads; ++threadIdx) {
+            queues_.emplace_back(new Queue);
+            std::size_t beginIdx = (numItems*threadIdx)/numThreads;
+            std::size_t endIdx = (numItems*(threadIdx + 1))/numThreads;
+            for (std::size_t itemIdx = beginIdx; itemIdx < endIdx; ++itemIdx)
+                queues_.back()->items.push_back(static_cast<Index>(itemIdx));
+        }
+        pendingItems_ = numItems;
+    }
+
+    template <class ChunkFunction>
+    void work_(unsigned threadIdx, ChunkFunction& fn)
+    {
+        Chunk chunk;
+        while (next_(threadIdx, chunk)) {
+            const std::size_t chunkSize = chunk.size();
+            try {
+                fn(chunk);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex_);
+                if (!exception_)
+                    exception_ = std::current_exception();
+                abort_ = true;
+                return;
+            }
+
+            // the unfinished items must be queued before the finished ones are
+            // accounted for. otherwise the other threads might stop prematurely
+            if (!chunk.empty()) {
+                Queue& queue = *queues_[threadIdx];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.items.insert(queue.items.end(), chunk.begin(), chunk.end());
+            }
+            pendingItems_ -= chunkSize - chunk.size();
+        }
+    }
+
+    // get the next chunk of a thread. returns false if no work is left
+    bool next_(unsigned threadIdx, Chunk& chunk)
+    {
+        chunk.clear();
+        while (!abort_ && pendingItems_ > 0) {
+            if (takeChunk_(threadIdx, chunk))
+                return true;
+            if (!steal_(threadIdx))
+                // the remaining items are processed by other threads, but some of them
+                // may be re-queued
+                std::this_thread::yield();
+        }
+        return false;
+    }
+
+    bool takeChunk_(unsigned threadIdx, Chunk& chunk)
+    {
+        Queue& queue = *queues_[threadIdx];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        const std::size_t n = queue.items.size();
+        if (n == 0)
+            return false;
+
+        const std::size_t chunkSize = std::min(n, std::max(minChunkSize_, (n + 3)/4));
+        chunk.assign(queue.items.begin(), queue.items.begin() + chunkSize);
+        queue.items.erase(queue.items.begin(), queue.items.begin() + chunkSize);
+        return true;
+    }
+
+    // move half of the items of another thread's queue to the one of a thread
+    bool steal_(unsigned threadIdx)
+    {
+        const unsigned numThreads = static_cast<unsigned>(queues_.size());
+        for (unsigned offset = 1; offset < numThreads; ++offset) {
+            Queue& victim = *queues_[(threadIdx + offset) % numThreads];
+            std::vector<Index> stolen;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                const std::size_t n = victim.items.size();
+                if (n == 0)
+                    continue;
+
+                const std::size_t numStolen = (n + 1)/2;
+                stolen.assign(victim.items.end() - numStolen, victim.items.end());
+                victim.items.erase(victim.items.end() - numStolen, victim.items.end());
+            }
+
+            Queue& queue = *queues_[threadIdx];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.items.insert(queue.items.end(), stolen.begin(), stolen.end());
+            return true;
+        }
+        return false;
+    }
+
+    std::size_t minChunkSize_;
+    std::vector<std::unique_ptr<Queue> > queues_;
+    std::atomic<std::size_t> pendingItems_{0};
+    std::atomic<bool> abort_{false};
+    std::mutex exceptionMutex_;
+    std::exception_ptr exception_;
+};
+
+} // namespace Opm
+
+#endif
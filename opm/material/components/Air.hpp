@@ -79,19 +79,19 @@ public:
      *
      * Taken from constrelair.hh.
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 0.02896; /* [kg/mol] */ }
 
     /*!
      * \brief Returns the critical temperature \f$\mathrm{[K]}\f$ of \f$AIR\f$.
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return 132.531 ; /* [K] */ }
 
     /*!
      * \brief Returns the critical pressure \f$\mathrm{[Pa]}\f$ of \f$AIR\f$.
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return 37.86e5; /* [Pa] */ }
 
     /*!
@@ -0,0 +1,201 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::BinaryCO2Tables
+ */
+#ifndef OPM_BINARY_CO2_TABLES_HPP
+#define OPM_BINARY_CO2_TABLES_HPP
+
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+/*!
+ * \ingroup Components
+ *
+ * \brief Provides the tabulated density and enthalpy of CO2 which are required by the
+ *        Opm::CO2 component, loaded from a binary file at runtime.
+ *
+ * This class can be used as the 'CO2Tables' template parameter of Opm::CO2,
+ * Opm::BinaryCoeff::Brine_CO2 and Opm::FluidSystems::BrineCO2 instead of including
+ * the compiled-in tables of co2tables.inc. Since the temperature and pressure ranges
+ * and the resolution of the tables are stored in the file, arbitrary tabulations
+ * can be used. The tables of co2tables.inc can be converted to this format using
+ * write().
+ *
+ * The file starts with an identifier and the brine salinity, followed by the
+ * enthalpy and the density tables. Each table is stored as its extent and its
+ * sample points in the memory layout of Opm::UniformTabulated2DFunction.
+ *
+ * \tparam Tag Allows to use several sets of tables within the same program
+ */
+template <class Tag = void>
+class BinaryCO2Tables
+{
+    static const char* magic_()
+    { return "OPMCO2T1"; }
+
+    enum { magicLength_ = 8 };
+
+public:
+    typedef Opm::UniformTabulated2DFunction<double> TabulatedFunction;
+
+    //! The specific enthalpy of CO2 \f$\mathrm{[J/kg]}\f$ depending on temperature and pressure
+    static TabulatedFunction tabulatedEnthalpy;
+    //! The density of CO2 \f$\mathrm{[kg/m^3]}\f$ depending on temperature and pressure
+    static TabulatedFunction tabulatedDensity;
+    //! The salinity of the brine \f$\mathrm{[-]}\f$ used together with the tables
+    static double brineSalinity;
+
+    /*!
+     * \brief Load the tables from a binary file which was created by write().
+     *
+     * If 'bicubicInterpolation' is true, the tables are evaluated using bi-cubic
+     * instead of bi-linear interpolation. This allows to use much coarser tables for
+     * the same accuracy, but the interpolation may overshoot at the phase transition
+     * of sub-critical CO2. Otherwise, the corners of each cell of the tables are
+     * stored contiguously to speed up the bi-linear interpolation.
+     */
+    static void load(const std::string& fileName, bool bicubicInterpolation = false)
+    {
+        std::ifstream file(fileName.c_str(), std::ios::binary);
+        if (!file)
+            OPM_THROW(std::runtime_error,
+                      "Could not open the CO2 tables file '" << fileName << "'");
+
+        char magic[magicLength_];
+        file.read(magic, magicLength_);
+        if (!file || std::strncmp(magic, magic_(), magicLength_) != 0)
+            OPM_THROW(std::runtime_error,
+                      "File '" << fileName << "' does not contain CO2 tables");
+
+        file.read(reinterpret_cast<char*>(&brineSalinity), sizeof(brineSalinity));
+        readTable_(file, tabulatedEnthalpy);
+        readTable_(file, tabulatedDensity);
+
+        if (!file)
+            OPM_THROW(std::runtime_error,
+                      "Could not read the CO2 tables from file '" << fileName << "'");
+
+        if (bicubicInterpolation) {
+            tabulatedEnthalpy.enableBicubicInterpolation();
+            tabulatedDensity.enableBicubicInterpolation();
+        }
+        else {
+            tabulatedEnthalpy.enableCellWiseLayout();
+            tabulatedDensity.enableCellWiseLayout();
+        }
+    }
+
+    /*!
+     * \brief Write a set of tables to a binary file which can be read by load().
+     */
+    static void write(const std::string& fileName,
+                      const TabulatedFunction& enthalpy,
+                      const TabulatedFunction& density,
+                      double salinity)
+    {
+        std::ofstream file(fileName.c_str(), std::ios::binary);
+        if (!file)
+            OPM_THROW(std::runtime_error,
+                      "Could not open file '" << fileName << "' for writing the CO2 tables");
+
+        file.write(magic_(), magicLength_);
+        file.write(reinterpret_cast<const char*>(&salinity), sizeof(salinity));
+        writeTable_(file, enthalpy);
+        writeTable_(file, density);
+
+        if (!file)
+            OPM_THROW(std::runtime_error,
+                      "Could not write the CO2 tables to file '" << fileName << "'");
+    }
+
+private:
+    // each table consists of its extent followed by the sample points
+    static void readTable_(std::ifstream& file, TabulatedFunction& table)
+    {
+        unsigned numX, numY;
+        double xMin, xMax, yMin, yMax;
+        file.read(reinterpret_cast<char*>(&numX), sizeof(numX));
+        file.read(reinterpret_cast<char*>(&numY), sizeof(numY));
+        file.read(reinterpret_cast<char*>(&xMin), sizeof(xMin));
+        file.read(reinterpret_cast<char*>(&xMax), sizeof(xMax));
+        file.read(reinterpret_cast<char*>(&yMin), sizeof(yMin));
+        file.read(reinterpret_cast<char*>(&yMax), sizeof(yMax));
+        if (numX < 2 || numY < 2)
+            file.setstate(std::ios::failbit);
+        if (!file)
+            return;
+
+        std::vector<double> samples(numX*numY);
+        file.read(reinterpret_cast<char*>(samples.data()), samples.size()*sizeof(double));
+        if (!file)
+            return;
+
+        table.resize(xMin, xMax, numX, yMin, yMax, numY);
+        for (unsigned j = 0; j < numY; ++j)
+            for (unsigned i = 0; i < numX; ++i)
+                table.setSamplePoint(i, j, samples[j*numX + i]);
+    }
+
+    static void writeTable_(std::ofstream& file, const TabulatedFunction& table)
+    {
+        unsigned numX = table.numX();
+        unsigned numY = table.numY();
+        double xMin = table.xMin();
+        double xMax = table.xMax();
+        double yMin = table.yMin();
+        double yMax = table.yMax();
+        file.write(reinterpret_cast<const char*>(&numX), sizeof(numX));
+        file.write(reinterpret_cast<const char*>(&numY), sizeof(numY));
+        file.write(reinterpret_cast<const char*>(&xMin), sizeof(xMin));
+        file.write(reinterpret_cast<const char*>(&xMax), sizeof(xMax));
+        file.write(reinterpret_cast<const char*>(&yMin), sizeof(yMin));
+        file.write(reinterpret_cast<const char*>(&yMax), sizeof(yMax));
+
+        std::vector<double> samples(numX*numY);
+        for (unsigned j = 0; j < numY; ++j)
+            for (unsigned i = 0; i < numX; ++i)
+                samples[j*numX + i] = table.getSamplePoint(i, j);
+        file.write(reinterpret_cast<const char*>(samples.data()), samples.size()*sizeof(double));
+    }
+};
+
+template <class Tag>
+typename BinaryCO2Tables<Tag>::TabulatedFunction BinaryCO2Tables<Tag>::tabulatedEnthalpy;
+template <class Tag>
+typename BinaryCO2Tables<Tag>::TabulatedFunction BinaryCO2Tables<Tag>::tabulatedDensity;
+template <class Tag>
+double BinaryCO2Tables<Tag>::brineSalinity = 0.0;
+
+} // namespace Opm
+
+#endif
@@ -88,25 +88,25 @@ public:
     /*!
      * \copydoc H2O::criticalTemperature
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return H2O::criticalTemperature(); /* [K] */ }
 
     /*!
      * \copydoc H2O::criticalPressure
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return H2O::criticalPressure(); /* [N/m^2] */ }
 
     /*!
      * \copydoc H2O::tripleTemperature
      */
-    static Scalar tripleTemperature()
+    static constexpr Scalar tripleTemperature()
     { return H2O::tripleTemperature(); /* [K] */ }
 
     /*!
      * \copydoc H2O::triplePressure
      */
-    static Scalar triplePressure()
+    static constexpr Scalar triplePressure()
     { return H2O::triplePressure(); /* [N/m^2] */ }
 
     /*!
@@ -135,6 +135,20 @@ public:
     template <class Evaluation>
     static Evaluation liquidEnthalpy(const Evaluation& temperature,
                                      const Evaluation& pressure)
+    { return liquidEnthalpy(temperature, pressure, Opm::constant<Evaluation>(salinity)); }
+
+    /*!
+     * \brief Specific enthalpy of liquid brine with an explicitly specified salinity
+     *        \f$\mathrm{[J/kg]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param brineSalinity The mass fraction of salt in the brine
+     */
+    template <class Evaluation>
+    static Evaluation liquidEnthalpy(const Evaluation& temperature,
+                                     const Evaluation& pressure,
+                                     const Evaluation& brineSalinity)
     {
         // Numerical coefficents from Palliser and McKibbin
         static const Scalar f[] = {
@@ -151,7 +165,7 @@ public:
 
         const Evaluation& theta = temperature - 273.15;
 
-        Evaluation S = salinity;
+        Evaluation S = brineSalinity;
         const Evaluation& S_lSAT =
             f[0]
             + f[1]*theta
@@ -248,25 +262,44 @@ public:
      */
     template <class Evaluation>
     static Evaluation liquidDensity(const Evaluation& temperature, const Evaluation& pressure)
-    {
-        Evaluation tempC = temperature - 273.15;
-        Evaluation pMPa = pressure/1.0E6;
+    { return liquidDensity(temperature, pressure, Opm::constant<Evaluation>(salinity)); }
 
+    /*!
+     * \brief The density of liquid brine with an explicitly specified salinity
+     *        \f$\mathrm{[kg/m^3]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param brineSalinity The mass fraction of salt in the brine
+     */
+    template <class Evaluation>
+    static Evaluation liquidDensity(const Evaluation& temperature,
+                                    const Evaluation& pressure,
+                                    const Evaluation& brineSalinity)
+    {
         const Evaluation rhow = H2O::liquidDensity(temperature, pressure);
-        return
-            rhow +
-            1000*salinity*(
-                0.668 +
-                0.44*salinity +
-                1.0E-6*(
-                    300*pMPa -
-                    2400*pMPa*salinity +
-                    tempC*(
-                        80.0 -
-                        3*tempC -
-                        3300*salinity -
-                        13*pMPa +
-                        47*pMPa*salinity)));
+        return rhow + saltDensity_(temperature, pressure, brineSalinity);
+    }
+
+    /*!
+     * \brief The density of liquid brine \f$\mathrm{[kg/m^3]}\f$ for arrays of
+     *        temperatures and pressures.
+     *
+     * The densities of pure water are computed by the array-valued method of the
+     * water component first. The salt correction is then added in a loop without
+     * branches which the compiler is able to vectorize.
+     */
+    template <class Evaluation>
+    static void liquidDensityBatch(size_t numValues,
+                                   const Evaluation* temperature,
+                                   const Evaluation* pressure,
+                                   Evaluation* values)
+    {
+        H2O::liquidDensityBatch(numValues, temperature, pressure, values);
+
+        const Evaluation& brineSalinity = Opm::constant<Evaluation>(salinity);
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = values[i] + saltDensity_(temperature[i], pressure[i], brineSalinity);
     }
 
     /*!
@@ -324,17 +357,57 @@ public:
      *   "Equations of State for basin geofluids"
      */
     template <class Evaluation>
-    static Evaluation liquidViscosity(const Evaluation& temperature, const Evaluation& /*pressure*/)
+    static Evaluation liquidViscosity(const Evaluation& temperature, const Evaluation& pressure)
+    { return liquidViscosity(temperature, pressure, Opm::constant<Evaluation>(salinity)); }
+
+    /*!
+     * \brief The dynamic viscosity of liquid brine with an explicitly specified
+     *        salinity \f$\mathrm{[Pa*s]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param brineSalinity The mass fraction of salt in the brine
+     */
+    template <class Evaluation>
+    static Evaluation liquidViscosity(const Evaluation& temperature,
+                                      const Evaluation& /*pressure*/,
+                                      const Evaluation& brineSalinity)
     {
         Evaluation T_C = temperature - 273.15;
         if(temperature <= 275.) // regularization
             T_C = 275.0;
 
-        Evaluation A = (0.42*std::pow((std::pow(salinity, 0.8)-0.17), 2) + 0.045)*Opm::pow(T_C, 0.8);
-        Evaluation mu_brine = 0.1 + 0.333*salinity + (1.65+91.9*salinity*salinity*salinity)*Opm::exp(-A);
+        const Evaluation& S = brineSalinity;
+        Evaluation A = (0.42*Opm::pow((Opm::pow(S, 0.8)-0.17), 2) + 0.045)*Opm::pow(T_C, 0.8);
+        Evaluation mu_brine = 0.1 + 0.333*S + (1.65+91.9*S*S*S)*Opm::exp(-A);
 
         return mu_brine/1000.0; // convert to [Pa s] (todo: check if correct cP->Pa s is times 10...)
     }
+
+private:
+    // the contribution of the salt to the density of brine according to Batzle & Wang
+    template <class Evaluation>
+    static Evaluation saltDensity_(const Evaluation& temperature,
+                                   const Evaluation& pressure,
+                                   const Evaluation& brineSalinity)
+    {
+        Evaluation tempC = temperature - 273.15;
+        Evaluation pMPa = pressure/1.0E6;
+
+        return
+            1000*brineSalinity*(
+                0.668 +
+                0.44*brineSalinity +
+                1.0E-6*(
+                    300*pMPa -
+                    2400*pMPa*brineSalinity +
+                    tempC*(
+                        80.0 -
+                        3*tempC -
+                        3300*brineSalinity -
+                        13*pMPa +
+                        47*pMPa*brineSalinity)));
+    }
 };
 
 /*!
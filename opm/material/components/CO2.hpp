@@ -66,31 +66,31 @@ public:
     /*!
      * \brief The mass in [kg] of one mole of CO2.
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 44e-3; }
 
     /*!
      * \brief Returns the critical temperature [K] of CO2
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return 273.15 + 30.95; /* [K] */ }
 
     /*!
      * \brief Returns the critical pressure [Pa] of CO2
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return 73.8e5; /* [N/m^2] */ }
 
     /*!
      * \brief Returns the temperature [K]at CO2's triple point.
      */
-    static Scalar tripleTemperature()
+    static constexpr Scalar tripleTemperature()
     { return 273.15 - 56.35; /* [K] */ }
 
     /*!
      * \brief Returns the pressure [Pa] at CO2's triple point.
      */
-    static Scalar triplePressure()
+    static constexpr Scalar triplePressure()
     { return 5.11e5; /* [N/m^2] */ }
 
     /*!
@@ -200,6 +200,26 @@ public:
      */
     template <class Evaluation>
     static Evaluation gasViscosity(Evaluation temperature, const Evaluation& pressure)
+    {
+        if(temperature < 275.) // regularization
+            temperature = 275.0;
+
+        const Evaluation& rho = gasDensity(temperature, pressure); // CO2 mass density [kg/m^3]
+        return gasViscosityFromDensity(temperature, rho);
+    }
+
+    /*!
+     * \brief The dynamic viscosity [Pa s] of CO2 for a known mass density.
+     *
+     * This avoids to look up the density if it is already known. Note that in
+     * contrast to gasViscosity(), the temperature is not regularized, i.e., the
+     * temperature should be at least 275 K.
+     *
+     * \param temperature Temperature of component \f$\mathrm{[K]}\f$
+     * \param rho The mass density of CO2 \f$\mathrm{[kg/m^3]}\f$
+     */
+    template <class Evaluation>
+    static Evaluation gasViscosityFromDensity(const Evaluation& temperature, const Evaluation& rho)
     {
         const Scalar a0 = 0.235156;
         const Scalar a1 = -0.491266;
@@ -215,8 +235,6 @@ public:
 
         const Scalar ESP = 251.196;
 
-        if(temperature < 275.) // regularization
-            temperature = 275.0;
         Evaluation TStar = temperature/ESP;
 
         // mu0: viscosity in zero-density limit
@@ -225,8 +243,6 @@ public:
 
         Evaluation mu0 = 1.00697*Opm::sqrt(temperature) / SigmaStar;
 
-        const Evaluation& rho = gasDensity(temperature, pressure); // CO2 mass density [kg/m^3]
-
         // dmu : excess viscosity at elevated density
         Evaluation dmu =
             d11*rho
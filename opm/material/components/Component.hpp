@@ -30,6 +30,8 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 
+#include <cstddef>
+
 namespace Opm {
 
 /*!
@@ -47,6 +49,24 @@ public:
 
     static const bool isTabulated = false;
 
+    /*!
+     * \brief Specify which properties of the component do not depend on temperature
+     *        and pressure.
+     *
+     * Fluid systems evaluate such properties once for an arbitrary state instead of
+     * calling the component with the state of each cell, and the results do not
+     * exhibit any derivatives. Components which implement a property as a constant
+     * should set the respective flag to true.
+     */
+    static const bool liquidDensityIsConstant = false;
+    static const bool liquidViscosityIsConstant = false;
+    static const bool liquidThermalConductivityIsConstant = false;
+    static const bool liquidHeatCapacityIsConstant = false;
+    static const bool gasDensityIsConstant = false;
+    static const bool gasViscosityIsConstant = false;
+    static const bool gasThermalConductivityIsConstant = false;
+    static const bool gasHeatCapacityIsConstant = false;
+
     /*!
      * \brief A default routine for initialization, not needed for components and must not be called.
      *
@@ -235,6 +255,199 @@ public:
     template <class Evaluation>
     static Evaluation liquidHeatCapacity(const Evaluation& /* temperature */, const Evaluation& /* pressure */)
     { OPM_THROW(std::runtime_error, "Not implemented: Component::liquidHeatCapacity()"); }
+    /****************************************
+     * Array-valued methods
+     *
+     * These compute a quantity for arrays of temperatures and pressures. The default
+     * implementations simply call the method for a single value of the component for
+     * each entry. Components for which a loop over the entries can be implemented
+     * more efficiently, e.g., by separating the branches from the arithmetic so that
+     * the compiler is able to vectorize the loop, override them. Since the methods
+     * for single values are dispatched using the Implementation template parameter,
+     * components which are derived from another component must override the
+     * array-valued methods for all quantities which they change.
+     ****************************************/
+
+    /*!
+     * \brief The vapor pressure in \f$\mathrm{[Pa]}\f$ of the component for an array
+     *        of temperatures.
+     */
+    template <class Evaluation>
+    static void vaporPressureBatch(size_t numValues,
+                                   const Evaluation* temperature,
+                                   Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::vaporPressure(temperature[i]);
+    }
+
+    /*!
+     * \brief The density of the pure component as a gas for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void gasDensityBatch(size_t numValues,
+                                const Evaluation* temperature,
+                                const Evaluation* pressure,
+                                Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::gasDensity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The density of the pure component as a liquid for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void liquidDensityBatch(size_t numValues,
+                                   const Evaluation* temperature,
+                                   const Evaluation* pressure,
+                                   Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::liquidDensity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The specific enthalpy of the pure component as a gas for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void gasEnthalpyBatch(size_t numValues,
+                                 const Evaluation* temperature,
+                                 const Evaluation* pressure,
+                                 Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::gasEnthalpy(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The specific enthalpy of the pure component as a liquid for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void liquidEnthalpyBatch(size_t numValues,
+                                    const Evaluation* temperature,
+                                    const Evaluation* pressure,
+                                    Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::liquidEnthalpy(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The specific internal energy of the pure component as a gas for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void gasInternalEnergyBatch(size_t numValues,
+                                       const Evaluation* temperature,
+                                       const Evaluation* pressure,
+                                       Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::gasInternalEnergy(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The specific internal energy of the pure component as a liquid for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void liquidInternalEnergyBatch(size_t numValues,
+                                          const Evaluation* temperature,
+                                          const Evaluation* pressure,
+                                          Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::liquidInternalEnergy(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The dynamic viscosity of the pure component as a gas for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void gasViscosityBatch(size_t numValues,
+                                  const Evaluation* temperature,
+                                  const Evaluation* pressure,
+                                  Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::gasViscosity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The dynamic viscosity of the pure component as a liquid for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void liquidViscosityBatch(size_t numValues,
+                                     const Evaluation* temperature,
+                                     const Evaluation* pressure,
+                                     Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::liquidViscosity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The thermal conductivity of the pure component as a gas for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void gasThermalConductivityBatch(size_t numValues,
+                                            const Evaluation* temperature,
+                                            const Evaluation* pressure,
+                                            Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::gasThermalConductivity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The thermal conductivity of the pure component as a liquid for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void liquidThermalConductivityBatch(size_t numValues,
+                                               const Evaluation* temperature,
+                                               const Evaluation* pressure,
+                                               Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::liquidThermalConductivity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The specific isobaric heat capacity of the pure component as a gas for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void gasHeatCapacityBatch(size_t numValues,
+                                     const Evaluation* temperature,
+                                     const Evaluation* pressure,
+                                     Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::gasHeatCapacity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \brief The specific isobaric heat capacity of the pure component as a liquid for arrays of
+     *        temperatures and pressures.
+     */
+    template <class Evaluation>
+    static void liquidHeatCapacityBatch(size_t numValues,
+                                        const Evaluation* temperature,
+                                        const Evaluation* pressure,
+                                        Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::liquidHeatCapacity(temperature[i], pressure[i]);
+    }
 };
 
 } // namespace Opm
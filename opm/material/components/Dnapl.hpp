@@ -49,6 +49,12 @@ template <class Scalar>
 class DNAPL : public Component<Scalar, DNAPL<Scalar> >
 {
 public:
+    //! \copydoc Component::liquidDensityIsConstant
+    static const bool liquidDensityIsConstant = true;
+    static const bool liquidViscosityIsConstant = true;
+    static const bool liquidThermalConductivityIsConstant = true;
+    static const bool liquidHeatCapacityIsConstant = true;
+
     /*!
      * \brief A human readable name for the TCE.
      */
@@ -77,44 +77,67 @@ public:
     /*!
      * \brief The molar mass in \f$\mathrm{[kg/mol]}\f$ of water.
      */
-    static const Scalar molarMass()
-    { return Common::molarMass; }
+    static constexpr Scalar molarMass()
+    { return IAPWS::CommonConstants::molarMass(); }
 
     /*!
      * \brief The acentric factor \f$\mathrm{[-]}\f$ of water.
      */
-    static const Scalar acentricFactor()
-    { return Common::acentricFactor; }
+    static constexpr Scalar acentricFactor()
+    { return IAPWS::CommonConstants::acentricFactor(); }
 
     /*!
      * \brief Returns the critical temperature \f$\mathrm{[K]}\f$ of water
      */
-    static const Scalar criticalTemperature()
-    { return Common::criticalTemperature; }
+    static constexpr Scalar criticalTemperature()
+    { return IAPWS::CommonConstants::criticalTemperature(); }
 
     /*!
      * \brief Returns the critical pressure \f$\mathrm{[Pa]}\f$ of water.
      */
-    static const Scalar criticalPressure()
-    { return Common::criticalPressure; }
+    static constexpr Scalar criticalPressure()
+    { return IAPWS::CommonConstants::criticalPressure(); }
 
     /*!
      * \brief Returns the molar volume \f$\mathrm{[m^3/mol]}\f$ of water at the critical point
      */
-    static const Scalar criticalMolarVolume()
+    static Scalar criticalMolarVolume()
     { return Common::criticalMolarVolume; }
 
     /*!
      * \brief Returns the temperature \f$\mathrm{[K]}\f$ at water's triple point.
      */
-    static const Scalar tripleTemperature()
-    { return Common::tripleTemperature; }
+    static constexpr Scalar tripleTemperature()
+    { return IAPWS::CommonConstants::tripleTemperature(); }
 
     /*!
      * \brief Returns the pressure \f$\mathrm{[Pa]}\f$ at water's triple point.
      */
-    static const Scalar triplePressure()
-    { return Common::triplePressure; }
+    static constexpr Scalar triplePressure()
+    { return IAPWS::CommonConstants::triplePressure(); }
+
+    /*!
+     * \brief The thermodynamic and transport properties of a phase of pure water at a
+     *        given temperature and pressure.
+     *
+     * This is the result of computeAllLiquidProperties() and computeAllGasProperties().
+     */
+    template <class Evaluation>
+    struct PhaseProperties
+    {
+        //! The density \f$\mathrm{[kg/m^3]}\f$
+        Evaluation density;
+        //! The specific enthalpy \f$\mathrm{[J/kg]}\f$
+        Evaluation enthalpy;
+        //! The specific internal energy \f$\mathrm{[J/kg]}\f$
+        Evaluation internalEnergy;
+        //! The specific isobaric heat capacity \f$\mathrm{[J/(kg K)]}\f$
+        Evaluation heatCapacity;
+        //! The dynamic viscosity \f$\mathrm{[Pa*s]}\f$
+        Evaluation viscosity;
+        //! The thermal conductivity \f$\mathrm{[W/(m K)]}\f$
+        Evaluation thermalConductivity;
+    };
 
     /*!
      * \brief The vapor pressure in \f$\mathrm{[Pa]}\f$ of pure water
@@ -677,49 +700,28 @@ public:
     template <class Evaluation>
     static Evaluation liquidDensity(const Evaluation& temperature, const Evaluation& pressure)
     {
-        if (!Region1::isValid(temperature, pressure))
-        {
-            OPM_THROW(NumericalProblem,
-                      "Density of water is only implemented for temperatures below 623.15K and "
-                      "pressures below 100MPa. (T = " << temperature << ", p=" << pressure);
-        }
-
-        // regularization
-        Evaluation pv = vaporPressure(temperature);
-        if (pressure < pv) {
-            // the pressure is too low, in this case we use the slope
-            // of the density at the vapor pressure to regularize
-
-            // calculate the partial derivative of the specific volume
-            // to the pressure at the vapor pressure.
-            Scalar eps = Opm::scalarValue(pv)*1e-8;
-            Evaluation v0 = volumeRegion1_(temperature, pv);
-            Evaluation v1 = volumeRegion1_(temperature, pv + eps);
-            Evaluation dv_dp = (v1 - v0)/eps;
-
-            /*
-              Scalar v0 = volumeRegion1_(temperature, pv);
-              Scalar pi = Region1::pi(pv);
-              Scalar dp_dpi = Region1::dp_dpi(pv);
-              Scalar dgamma_dpi = Region1::dgamma_dpi(temperature, pv);
-              Scalar ddgamma_ddpi = Region1::ddgamma_ddpi(temperature, pv);
-
-              Scalar RT = Rs*temperature;
-              Scalar dv_dp =
-              RT/(dp_dpi*pv)
-              *
-              (dgamma_dpi + pi*ddgamma_ddpi - v0*dp_dpi/RT);
-            */
-
-            // calculate the partial derivative of the density to the
-            // pressure at vapor pressure
-            Evaluation drho_dp = - 1/(v0*v0)*dv_dp;
+        checkLiquidDensityRange_(temperature, pressure);
+        return liquidDensityRegion1_(temperature, pressure);
+    }
 
-            // use a straight line for extrapolation
-            return 1.0/v0 + (pressure - pv)*drho_dp;
-        };
+    /*!
+     * \brief The density of pure water in \f$\mathrm{[kg/m^3]}\f$ for arrays of
+     *        temperatures and pressures.
+     *
+     * The range of all values is checked before the densities are computed, so the
+     * loop which computes them does not contain the code path which throws.
+     */
+    template <class Evaluation>
+    static void liquidDensityBatch(size_t numValues,
+                                   const Evaluation* temperature,
+                                   const Evaluation* pressure,
+                                   Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            checkLiquidDensityRange_(temperature[i], pressure[i]);
 
-        return 1/volumeRegion1_(temperature, pressure);
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = liquidDensityRegion1_(temperature[i], pressure[i]);
     }
 
     /*!
@@ -854,7 +856,162 @@ public:
         return Common::thermalConductivityIAPWS(temperature, rho);
     }
 
+    /*!
+     * \brief Computes all properties of liquid water at once.
+     *
+     * The results agree with the ones of liquidDensity(), liquidEnthalpy(),
+     * liquidInternalEnergy(), liquidHeatCapacity(), liquidViscosity() and
+     * liquidThermalConductivity(), but the IAPWS region 1 Gibbs free energy and its
+     * derivatives are only evaluated once. If the pressure is below the vapor pressure,
+     * the regularized quantities of the individual methods are used.
+     *
+     * \param temperature Absolute temperature of the fluid in \f$\mathrm{[K]}\f$
+     * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    static PhaseProperties<Evaluation> computeAllLiquidProperties(const Evaluation& temperature,
+                                                                  const Evaluation& pressure)
+    {
+        if (!Region1::isValid(temperature, pressure))
+        {
+            OPM_THROW(NumericalProblem,
+                      "Properties of water are only implemented for temperatures below 623.15K and "
+                      "pressures below 100MPa. (T = " << temperature << ", p=" << pressure);
+        }
+
+        PhaseProperties<Evaluation> props;
+        const Evaluation& pv = vaporPressure(temperature);
+        if (pressure < pv) {
+            // regularization
+            props.density = liquidDensity(temperature, pressure);
+            props.enthalpy = liquidEnthalpy(temperature, pressure);
+            props.internalEnergy = liquidInternalEnergy(temperature, pressure);
+            props.heatCapacity = liquidHeatCapacity(temperature, pressure);
+        }
+        else {
+            Evaluation g, g_tau, g_pi, g_taupi, g_pipi, g_tautau;
+            Region1::gammaAndDerivatives(g, g_tau, g_pi, g_taupi, g_pipi, g_tautau,
+                                         temperature, pressure);
+
+            const Evaluation& tau = Region1::tau(temperature);
+            const Evaluation& pi = Region1::pi(pressure);
+            props.density = 1/(pi*g_pi*Rs*temperature/pressure);
+            props.enthalpy = tau*g_tau*Rs*temperature;
+            props.internalEnergy = Rs*temperature*(tau*g_tau - pi*g_pi);
+            props.heatCapacity = - tau*tau*g_tautau*Rs;
+        }
+
+        props.viscosity = Common::viscosity(temperature, props.density);
+        props.thermalConductivity = Common::thermalConductivityIAPWS(temperature, props.density);
+        return props;
+    }
+
+    /*!
+     * \brief Computes all properties of steam at once.
+     *
+     * The results agree with the ones of gasDensity(), gasEnthalpy(),
+     * gasInternalEnergy(), gasHeatCapacity(), gasViscosity() and
+     * gasThermalConductivity(), but the IAPWS region 2 Gibbs free energy and its
+     * derivatives are only evaluated once. If the pressure is above the vapor pressure
+     * or close to zero, the regularized quantities of the individual methods are used.
+     *
+     * \param temperature Absolute temperature of the fluid in \f$\mathrm{[K]}\f$
+     * \param pressure Phase pressure in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    static PhaseProperties<Evaluation> computeAllGasProperties(const Evaluation& temperature,
+                                                               const Evaluation& pressure)
+    {
+        if (!Region2::isValid(temperature, pressure))
+        {
+            OPM_THROW(NumericalProblem,
+                      "Properties of steam are only implemented for temperatures below 623.15K and "
+                      "pressures below 100MPa. (T = " << temperature << ", p=" << pressure);
+        }
+
+        PhaseProperties<Evaluation> props;
+        const Evaluation& pv = vaporPressure(temperature);
+        if (pressure < triplePressure() - 100 || pressure > pv) {
+            // regularization
+            props.density = gasDensity(temperature, pressure);
+            props.enthalpy = gasEnthalpy(temperature, pressure);
+            props.internalEnergy = gasInternalEnergy(temperature, pressure);
+            props.heatCapacity = gasHeatCapacity(temperature, pressure);
+        }
+        else {
+            Evaluation g, g_tau, g_pi, g_taupi, g_pipi, g_tautau;
+            Region2::gammaAndDerivatives(g, g_tau, g_pi, g_taupi, g_pipi, g_tautau,
+                                         temperature, pressure);
+
+            const Evaluation& tau = Region2::tau(temperature);
+            const Evaluation& pi = Region2::pi(pressure);
+            props.density = 1.0/(pi*g_pi*Rs*temperature/pressure);
+            props.enthalpy = tau*g_tau*Rs*temperature;
+            props.internalEnergy = Rs*temperature*(tau*g_tau - pi*g_pi);
+            props.heatCapacity = - tau*tau*g_tautau*Rs;
+        }
+
+        props.viscosity = Common::viscosity(temperature, props.density);
+        props.thermalConductivity = Common::thermalConductivityIAPWS(temperature, props.density);
+        return props;
+    }
+
 private:
+    // throws if the density of liquid water is not implemented for a temperature and
+    // pressure
+    template <class Evaluation>
+    static void checkLiquidDensityRange_(const Evaluation& temperature, const Evaluation& pressure)
+    {
+        if (!Region1::isValid(temperature, pressure))
+        {
+            OPM_THROW(NumericalProblem,
+                      "Density of water is only implemented for temperatures below 623.15K and "
+                      "pressures below 100MPa. (T = " << temperature << ", p=" << pressure);
+        }
+    }
+
+    // the density of liquid water in region 1, regularized below the vapor pressure
+    template <class Evaluation>
+    static Evaluation liquidDensityRegion1_(const Evaluation& temperature, const Evaluation& pressure)
+    {
+        // regularization
+        Evaluation pv = vaporPressure(temperature);
+        if (pressure < pv) {
+            // the pressure is too low, in this case we use the slope
+            // of the density at the vapor pressure to regularize
+
+            // calculate the partial derivative of the specific volume
+            // to the pressure at the vapor pressure.
+            Scalar eps = Opm::scalarValue(pv)*1e-8;
+            Evaluation v0 = volumeRegion1_(temperature, pv);
+            Evaluation v1 = volumeRegion1_(temperature, pv + eps);
+            Evaluation dv_dp = (v1 - v0)/eps;
+
+            /*
+              Scalar v0 = volumeRegion1_(temperature, pv);
+              Scalar pi = Region1::pi(pv);
+              Scalar dp_dpi = Region1::dp_dpi(pv);
+              Scalar dgamma_dpi = Region1::dgamma_dpi(temperature, pv);
+              Scalar ddgamma_ddpi = Region1::ddgamma_ddpi(temperature, pv);
+
+              Scalar RT = Rs*temperature;
+              Scalar dv_dp =
+              RT/(dp_dpi*pv)
+              *
+              (dgamma_dpi + pi*ddgamma_ddpi - v0*dp_dpi/RT);
+            */
+
+            // calculate the partial derivative of the density to the
+            // pressure at vapor pressure
+            Evaluation drho_dp = - 1/(v0*v0)*dv_dp;
+
+            // use a straight line for extrapolation
+            return 1.0/v0 + (pressure - pv)*drho_dp;
+        };
+
+        return 1/volumeRegion1_(temperature, pressure);
+    }
+
     // the unregularized specific enthalpy for liquid water
     template <class Evaluation>
     static Evaluation enthalpyRegion1_(const Evaluation& temperature, const Evaluation& pressure)
@@ -879,24 +1036,31 @@ private:
     template <class Evaluation>
     static Evaluation heatCap_v_Region1_(const Evaluation& temperature, const Evaluation& pressure)
     {
-        double tau = Region1::tau(temperature);
-        double num = Region1::dgamma_dpi(temperature, pressure) - tau * Region1::ddgamma_dtaudpi(temperature, pressure);
-        double diff = std::pow(num, 2) / Region1::ddgamma_ddpi(temperature, pressure);
+        Evaluation g, g_tau, g_pi, g_taupi, g_pipi, g_tautau;
+        Region1::gammaAndDerivatives(g, g_tau, g_pi, g_taupi, g_pipi, g_tautau,
+                                     temperature, pressure);
+
+        const Evaluation& tau = Region1::tau(temperature);
+        const Evaluation& num = g_pi - tau*g_taupi;
+        const Evaluation& diff = num*num/g_pipi;
 
         return
-            - std::pow(tau, 2 ) *
-            Region1::ddgamma_ddtau(temperature, pressure) * Rs +
-            diff;
+            - tau*tau*g_tautau*Rs
+            + diff;
     }
 
     // the unregularized specific internal energy for liquid water
     template <class Evaluation>
     static Evaluation internalEnergyRegion1_(const Evaluation& temperature, const Evaluation& pressure)
     {
+        Evaluation g, g_tau, g_pi, g_taupi, g_pipi, g_tautau;
+        Region1::gammaAndDerivatives(g, g_tau, g_pi, g_taupi, g_pipi, g_tautau,
+                                     temperature, pressure);
+
         return
             Rs * temperature *
-            ( Region1::tau(temperature)*Region1::dgamma_dtau(temperature, pressure) -
-              Region1::pi(pressure)*Region1::dgamma_dpi(temperature, pressure));
+            ( Region1::tau(temperature)*g_tau -
+              Region1::pi(pressure)*g_pi);
     }
 
     // the unregularized specific volume for liquid water
@@ -923,10 +1087,14 @@ private:
     template <class Evaluation>
     static Evaluation internalEnergyRegion2_(const Evaluation& temperature, const Evaluation& pressure)
     {
+        Evaluation g, g_tau, g_pi, g_taupi, g_pipi, g_tautau;
+        Region2::gammaAndDerivatives(g, g_tau, g_pi, g_taupi, g_pipi, g_tautau,
+                                     temperature, pressure);
+
         return
             Rs * temperature *
-            ( Region2::tau(temperature)*Region2::dgamma_dtau(temperature, pressure) -
-              Region2::pi(pressure)*Region2::dgamma_dpi(temperature, pressure));
+            ( Region2::tau(temperature)*g_tau -
+              Region2::pi(pressure)*g_pi);
     }
 
     // the unregularized specific isobaric heat capacity
@@ -943,13 +1111,16 @@ private:
     template <class Evaluation>
     static Evaluation heatCap_v_Region2_(const Evaluation& temperature, const Evaluation& pressure)
     {
+        Evaluation g, g_tau, g_pi, g_taupi, g_pipi, g_tautau;
+        Region2::gammaAndDerivatives(g, g_tau, g_pi, g_taupi, g_pipi, g_tautau,
+                                     temperature, pressure);
+
         const Evaluation& tau = Region2::tau(temperature);
         const Evaluation& pi = Region2::pi(pressure);
-        const Evaluation& num = 1 + pi * Region2::dgamma_dpi(temperature, pressure) + tau * pi * Region2::ddgamma_dtaudpi(temperature, pressure);
-        const Evaluation& diff = num * num / (1 - pi * pi * Region2::ddgamma_ddpi(temperature, pressure));
+        const Evaluation& num = 1 + pi*g_pi + tau*pi*g_taupi;
+        const Evaluation& diff = num*num/(1 - pi*pi*g_pipi);
         return
-            - std::pow(tau, 2 ) *
-            Region2::ddgamma_ddtau(temperature, pressure) * Rs
+            - tau*tau*g_tautau*Rs
             - diff;
     }
 
@@ -968,4 +1139,36 @@ template <class Scalar>
 const Scalar H2O<Scalar>::Rs = Common::Rs;
 } // namespace Opm
 
+// the instantiations which are part of the library of precompiled instantiations (see
+// opm/material/common/PrecompiledInstantiations.hpp)
+#include <opm/material/common/PrecompiledInstantiations.hpp>
+
+#define OPM_MATERIAL_INSTANTIATE_H2O_(PREFIX, Evaluation) \
+    PREFIX template Evaluation H2O<double>::vaporPressure<Evaluation>(Evaluation); \
+    PREFIX template Evaluation H2O<double>::gasEnthalpy<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::liquidEnthalpy<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::gasHeatCapacity<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::liquidHeatCapacity<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::gasInternalEnergy<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::liquidInternalEnergy<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::gasDensity<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::liquidDensity<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::gasViscosity<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::liquidViscosity<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::gasThermalConductivity<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template Evaluation H2O<double>::liquidThermalConductivity<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template H2O<double>::PhaseProperties<Evaluation> \
+    H2O<double>::computeAllLiquidProperties<Evaluation>(const Evaluation&, const Evaluation&); \
+    PREFIX template H2O<double>::PhaseProperties<Evaluation> \
+    H2O<double>::computeAllGasProperties<Evaluation>(const Evaluation&, const Evaluation&);
+
+#if OPM_MATERIAL_EXTERN_TEMPLATES
+#include <opm/material/densead/Evaluation.hpp>
+
+namespace Opm {
+extern template class H2O<double>;
+OPM_MATERIAL_FOR_EACH_PRECOMPILED_EVALUATION(OPM_MATERIAL_INSTANTIATE_H2O_, extern)
+} // namespace Opm
+#endif
+
 #endif
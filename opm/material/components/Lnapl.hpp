@@ -43,6 +43,12 @@ template <class Scalar>
 class LNAPL : public Component<Scalar, LNAPL<Scalar> >
 {
 public:
+    //! \copydoc Component::liquidDensityIsConstant
+    static const bool liquidDensityIsConstant = true;
+    static const bool liquidViscosityIsConstant = true;
+    static const bool liquidThermalConductivityIsConstant = true;
+    static const bool liquidHeatCapacityIsConstant = true;
+
     /*!
      * \brief A human readable name for the iso-octane.
      */
@@ -52,7 +58,7 @@ public:
     /*!
      * \brief The molar mass in \f$\mathrm{[kg/mol]}\f$ of iso-octane.
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 0.11423; }
 
     /*!
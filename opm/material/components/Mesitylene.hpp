@@ -55,19 +55,19 @@ public:
     /*!
      * \brief The molar mass in \f$\mathrm{[kg/mol]}\f$ of mesitylene
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 0.120; }
 
     /*!
      * \brief Returns the critical temperature \f$\mathrm{[K]}\f$ of mesitylene
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return 637.3; }
 
     /*!
      * \brief Returns the critical pressure \f$\mathrm{[Pa]}\f$ of mesitylene
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return 31.3e5; }
 
     /*!
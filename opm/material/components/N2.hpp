@@ -61,31 +61,31 @@ public:
     /*!
      * \brief The molar mass in \f$\mathrm{[kg/mol]}\f$ of molecular nitrogen.
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 28.0134e-3;}
 
     /*!
      * \brief Returns the critical temperature \f$\mathrm{[K]}\f$ of molecular nitrogen
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return 126.192; /* [K] */ }
 
     /*!
      * \brief Returns the critical pressure \f$\mathrm{[Pa]}\f$ of molecular nitrogen.
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return 3.39858e6; /* [N/m^2] */ }
 
     /*!
      * \brief Returns the temperature \f$\mathrm{[K]}\f$ at molecular nitrogen's triple point.
      */
-    static Scalar tripleTemperature()
+    static constexpr Scalar tripleTemperature()
     { return 63.151; /* [K] */ }
 
     /*!
      * \brief Returns the pressure \f$\mathrm{[Pa]}\f$ at molecular nitrogen's triple point.
      */
-    static Scalar triplePressure()
+    static constexpr Scalar triplePressure()
     { return 12.523e3; /* [N/m^2] */ }
 
     /*!
@@ -0,0 +1,60 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief The CO2 tables of the library of precompiled instantiations.
+ *
+ * The tables of co2tables.inc are large and must be included by exactly one
+ * translation unit of a program. If the module is configured with the
+ * OPM_MATERIAL_PRECOMPILED CMake option, they are part of the opmmaterial library
+ * instead, and this header makes them available as Opm::PrecompiledCO2Tables, e.g.
+ *
+ * \code
+ * typedef Opm::CO2<double, Opm::PrecompiledCO2Tables> CO2;
+ * \endcode
+ *
+ * (see opm/material/common/PrecompiledInstantiations.hpp).
+ */
+#ifndef OPM_PRECOMPILED_CO2_TABLES_HPP
+#define OPM_PRECOMPILED_CO2_TABLES_HPP
+
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
+
+namespace Opm {
+namespace PrecompiledCO2TablesImpl {
+// this must be identical to the definitions of co2tables.inc
+typedef Opm::UniformTabulated2DFunction< double > TabulatedFunction;
+
+// this class collects all the tabulated quantities in one convenient place
+struct CO2Tables {
+   static TabulatedFunction   tabulatedEnthalpy;
+   static TabulatedFunction   tabulatedDensity;
+   static const double brineSalinity;
+};
+} // namespace PrecompiledCO2TablesImpl
+
+typedef PrecompiledCO2TablesImpl::CO2Tables PrecompiledCO2Tables;
+} // namespace Opm
+
+#endif
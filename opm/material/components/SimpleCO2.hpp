@@ -52,6 +52,10 @@ class SimpleCO2 : public Component<Scalar, SimpleCO2<Scalar> >
     typedef Opm::IdealGas<Scalar> IdealGas;
 
 public:
+    //! \copydoc Component::liquidDensityIsConstant
+    static const bool liquidHeatCapacityIsConstant = true;
+    static const bool gasHeatCapacityIsConstant = true;
+
     /*!
      * \copydoc Component::name
      */
@@ -61,31 +65,31 @@ public:
     /*!
      * \copydoc Component::molarMass
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 44e-3; }
 
     /*!
      * \brief Returns the critical temperature \f$\mathrm{[K]}\f$ of \f$CO_2\f$.
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return 273.15 + 30.95; /* [K] */ }
 
     /*!
      * \brief Returns the critical pressure \f$\mathrm{[Pa]}\f$ of \f$CO_2\f$.
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return 73.8e5; /* [N/m^2] */ }
 
     /*!
      * \brief Returns the temperature \f$\mathrm{[K]}\f$ at the triple point of \f$CO_2\f$.
      */
-    static Scalar tripleTemperature()
+    static constexpr Scalar tripleTemperature()
     { return 273.15 - 56.35; /* [K] */ }
 
     /*!
      * \brief Returns the pressure \f$\mathrm{[Pa]}\f$ at the triple point of \f$CO_2\f$.
      */
-    static Scalar triplePressure()
+    static constexpr Scalar triplePressure()
     { return 5.11e5; /* [N/m^2] */ }
 
     /*!
@@ -60,6 +60,15 @@ class SimpleH2O : public Component<Scalar, SimpleH2O<Scalar> >
     static const Scalar R;  // specific gas constant of water
 
 public:
+    //! \copydoc Component::liquidDensityIsConstant
+    static const bool liquidDensityIsConstant = true;
+    static const bool liquidViscosityIsConstant = true;
+    static const bool liquidThermalConductivityIsConstant = true;
+    static const bool liquidHeatCapacityIsConstant = true;
+    static const bool gasViscosityIsConstant = true;
+    static const bool gasThermalConductivityIsConstant = true;
+    static const bool gasHeatCapacityIsConstant = true;
+
     /*!
      * \brief A human readable name for the water.
      */
@@ -87,31 +96,31 @@ public:
     /*!
      * \brief The molar mass in \f$\mathrm{[kg/mol]}\f$ of water.
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 18e-3; }
 
     /*!
      * \brief Returns the critical temperature \f$\mathrm{[K]}\f$ of water.
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return 647.096; /* [K] */ }
 
     /*!
      * \brief Returns the critical pressure \f$\mathrm{[Pa]}\f$ of water.
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return 22.064e6; /* [N/m^2] */ }
 
     /*!
      * \brief Returns the temperature \f$\mathrm{[K]}\f$ at water's triple point.
      */
-    static Scalar tripleTemperature()
+    static constexpr Scalar tripleTemperature()
     { return 273.16; /* [K] */ }
 
     /*!
      * \brief Returns the pressure \f$\mathrm{[Pa]}\f$ at water's triple point.
      */
-    static Scalar triplePressure()
+    static constexpr Scalar triplePressure()
     { return 611.657; /* [N/m^2] */ }
 
     /*!
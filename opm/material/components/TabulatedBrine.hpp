@@ -0,0 +1,323 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::TabulatedBrine
+ */
+#ifndef OPM_TABULATED_BRINE_HPP
+#define OPM_TABULATED_BRINE_HPP
+
+#include <opm/material/components/Brine.hpp>
+#include <opm/material/common/UniformTabulated3DFunction.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+
+namespace Opm {
+
+/*!
+ * \ingroup Components
+ *
+ * \brief Brine whose liquid properties are tabulated over temperature, pressure and
+ *        salinity.
+ *
+ * Opm::Brine computes the salt correction of the density, the enthalpy and the
+ * viscosity of the liquid on top of the properties of pure water for each call. If the
+ * salinity varies, e.g., if water of a different salinity than the one of the formation
+ * is injected, Opm::TabulatedComponent cannot be used because it only tabulates a
+ * single salinity. This class tabulates these quantities on a uniform grid in (T, p,
+ * salinity) space instead and uses tri-linear interpolation to evaluate them.
+ *
+ * The methods which do not take an explicit salinity use the salinity of the
+ * Opm::Brine base class. Outside of the tabulated range and before init() has been
+ * called, the properties are computed analytically. The properties of the gas phase
+ * are the ones of Opm::Brine.
+ *
+ * \tparam Scalar The type used for scalar values
+ * \tparam H2O The component which provides the properties of pure water
+ */
+template <class Scalar, class H2O>
+class TabulatedBrine : public Brine<Scalar, H2O>
+{
+    typedef Opm::Brine<Scalar, H2O> ParentType;
+    typedef Opm::UniformTabulated3DFunction<Scalar> Table;
+
+public:
+    static const bool isTabulated = true;
+
+    /*!
+     * \brief Initialize the tables.
+     *
+     * If OpenMP is enabled, the tables are filled in parallel, so the methods of the
+     * H2O component must be thread safe.
+     *
+     * \param tempMin The minimum of the temperature range in \f$\mathrm{[K]}\f$
+     * \param tempMax The maximum of the temperature range in \f$\mathrm{[K]}\f$
+     * \param nTemp The number of entries/steps within the temperature range
+     * \param pressMin The minimum of the pressure range in \f$\mathrm{[Pa]}\f$
+     * \param pressMax The maximum of the pressure range in \f$\mathrm{[Pa]}\f$
+     * \param nPress The number of entries/steps within the pressure range
+     * \param salinityMin The minimum of the mass fraction of salt
+     * \param salinityMax The maximum of the mass fraction of salt
+     * \param nSalinity The number of entries/steps within the salinity range
+     */
+    static void init(Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                     Scalar pressMin, Scalar pressMax, unsigned nPress,
+                     Scalar salinityMin, Scalar salinityMax, unsigned nSalinity)
+    {
+        liquidDensityTable_.resize(tempMin, tempMax, nTemp,
+                                   pressMin, pressMax, nPress,
+                                   salinityMin, salinityMax, nSalinity);
+        liquidEnthalpyTable_.resize(tempMin, tempMax, nTemp,
+                                    pressMin, pressMax, nPress,
+                                    salinityMin, salinityMax, nSalinity);
+        liquidViscosityTable_.resize(tempMin, tempMax, nTemp,
+                                     pressMin, pressMax, nPress,
+                                     salinityMin, salinityMax, nSalinity);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int kInt = 0; kInt < static_cast<int>(nSalinity); ++kInt) {
+            unsigned k = static_cast<unsigned>(kInt);
+            Scalar S = liquidDensityTable_.kToZ(k);
+            for (unsigned j = 0; j < nPress; ++j) {
+                Scalar p = liquidDensityTable_.jToY(j);
+                for (unsigned i = 0; i < nTemp; ++i) {
+                    Scalar T = liquidDensityTable_.iToX(i);
+
+                    liquidDensityTable_.setSamplePoint(i, j, k, ParentType::liquidDensity(T, p, S));
+                    liquidEnthalpyTable_.setSamplePoint(i, j, k, ParentType::liquidEnthalpy(T, p, S));
+                    liquidViscosityTable_.setSamplePoint(i, j, k, ParentType::liquidViscosity(T, p, S));
+                }
+            }
+        }
+    }
+
+    /*!
+     * \brief Returns true if the tables have been initialized.
+     */
+    static bool tablesInitialized()
+    { return !liquidDensityTable_.empty(); }
+
+    /*!
+     * \copydoc Brine::liquidEnthalpy
+     */
+    template <class Evaluation>
+    static Evaluation liquidEnthalpy(const Evaluation& temperature,
+                                     const Evaluation& pressure)
+    { return liquidEnthalpy(temperature, pressure, Opm::constant<Evaluation>(ParentType::salinity)); }
+
+    /*!
+     * \brief Specific enthalpy of liquid brine with an explicitly specified salinity
+     *        \f$\mathrm{[J/kg]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param brineSalinity The mass fraction of salt in the brine
+     */
+    template <class Evaluation>
+    static Evaluation liquidEnthalpy(const Evaluation& temperature,
+                                     const Evaluation& pressure,
+                                     const Evaluation& brineSalinity)
+    {
+        if (!useTable_(temperature, pressure, brineSalinity))
+            return ParentType::liquidEnthalpy(temperature, pressure, brineSalinity);
+
+        return liquidEnthalpyTable_.eval(temperature, pressure, brineSalinity);
+    }
+
+    /*!
+     * \copydoc Brine::liquidHeatCapacity
+     */
+    template <class Evaluation>
+    static Evaluation liquidHeatCapacity(const Evaluation& temperature,
+                                         const Evaluation& pressure)
+    {
+        Scalar eps = Opm::scalarValue(temperature)*1e-8;
+        return (liquidEnthalpy(temperature + eps, pressure) - liquidEnthalpy(temperature, pressure))/eps;
+    }
+
+    /*!
+     * \copydoc Brine::liquidInternalEnergy
+     */
+    template <class Evaluation>
+    static Evaluation liquidInternalEnergy(const Evaluation& temperature,
+                                           const Evaluation& pressure)
+    {
+        return
+            liquidEnthalpy(temperature, pressure) -
+            pressure/liquidDensity(temperature, pressure);
+    }
+
+    /*!
+     * \copydoc Brine::liquidDensity
+     */
+    template <class Evaluation>
+    static Evaluation liquidDensity(const Evaluation& temperature, const Evaluation& pressure)
+    { return liquidDensity(temperature, pressure, Opm::constant<Evaluation>(ParentType::salinity)); }
+
+    /*!
+     * \brief The density of liquid brine with an explicitly specified salinity
+     *        \f$\mathrm{[kg/m^3]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param brineSalinity The mass fraction of salt in the brine
+     */
+    template <class Evaluation>
+    static Evaluation liquidDensity(const Evaluation& temperature,
+                                    const Evaluation& pressure,
+                                    const Evaluation& brineSalinity)
+    {
+        if (!useTable_(temperature, pressure, brineSalinity))
+            return ParentType::liquidDensity(temperature, pressure, brineSalinity);
+
+        return liquidDensityTable_.eval(temperature, pressure, brineSalinity);
+    }
+
+    /*!
+     * \copydoc Brine::liquidViscosity
+     */
+    template <class Evaluation>
+    static Evaluation liquidViscosity(const Evaluation& temperature, const Evaluation& pressure)
+    { return liquidViscosity(temperature, pressure, Opm::constant<Evaluation>(ParentType::salinity)); }
+
+    /*!
+     * \brief The dynamic viscosity of liquid brine with an explicitly specified
+     *        salinity \f$\mathrm{[Pa*s]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     * \param brineSalinity The mass fraction of salt in the brine
+     */
+    template <class Evaluation>
+    static Evaluation liquidViscosity(const Evaluation& temperature,
+                                      const Evaluation& pressure,
+                                      const Evaluation& brineSalinity)
+    {
+        if (!useTable_(temperature, pressure, brineSalinity))
+            return ParentType::liquidViscosity(temperature, pressure, brineSalinity);
+
+        return liquidViscosityTable_.eval(temperature, pressure, brineSalinity);
+    }
+
+    // the array-valued methods of the base classes would use the methods of Brine
+    // for the quantities which are tabulated here
+
+    /*!
+     * \copydoc Component::liquidEnthalpyBatch
+     */
+    template <class Evaluation>
+    static void liquidEnthalpyBatch(size_t numValues,
+                                    const Evaluation* temperature,
+                                    const Evaluation* pressure,
+                                    Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = liquidEnthalpy(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \copydoc Component::liquidHeatCapacityBatch
+     */
+    template <class Evaluation>
+    static void liquidHeatCapacityBatch(size_t numValues,
+                                        const Evaluation* temperature,
+                                        const Evaluation* pressure,
+                                        Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = liquidHeatCapacity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \copydoc Component::liquidInternalEnergyBatch
+     */
+    template <class Evaluation>
+    static void liquidInternalEnergyBatch(size_t numValues,
+                                          const Evaluation* temperature,
+                                          const Evaluation* pressure,
+                                          Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = liquidInternalEnergy(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \copydoc Component::liquidDensityBatch
+     */
+    template <class Evaluation>
+    static void liquidDensityBatch(size_t numValues,
+                                   const Evaluation* temperature,
+                                   const Evaluation* pressure,
+                                   Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = liquidDensity(temperature[i], pressure[i]);
+    }
+
+    /*!
+     * \copydoc Component::liquidViscosityBatch
+     */
+    template <class Evaluation>
+    static void liquidViscosityBatch(size_t numValues,
+                                     const Evaluation* temperature,
+                                     const Evaluation* pressure,
+                                     Evaluation* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = liquidViscosity(temperature[i], pressure[i]);
+    }
+
+private:
+    // all tables exhibit the same range, so it is sufficient to check one of them
+    template <class Evaluation>
+    static bool useTable_(const Evaluation& temperature,
+                          const Evaluation& pressure,
+                          const Evaluation& brineSalinity)
+    {
+        return
+            tablesInitialized()
+            && liquidDensityTable_.applies(temperature, pressure, brineSalinity);
+    }
+
+    static Table liquidDensityTable_;
+    static Table liquidEnthalpyTable_;
+    static Table liquidViscosityTable_;
+};
+
+template <class Scalar, class H2O>
+typename TabulatedBrine<Scalar, H2O>::Table
+TabulatedBrine<Scalar, H2O>::liquidDensityTable_;
+
+template <class Scalar, class H2O>
+typename TabulatedBrine<Scalar, H2O>::Table
+TabulatedBrine<Scalar, H2O>::liquidEnthalpyTable_;
+
+template <class Scalar, class H2O>
+typename TabulatedBrine<Scalar, H2O>::Table
+TabulatedBrine<Scalar, H2O>::liquidViscosityTable_;
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,1098 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::TabulatedComponentTables
+ */
+#ifndef OPM_TABULATED_COMPONENT_TABLES_HPP
+#define OPM_TABULATED_COMPONENT_TABLES_HPP
+
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <array>
+#include <string>
+#include <vector>
+
+#include <opm/common/Exceptions.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/material/common/MathToolbox.hpp>
+
+namespace Opm {
+/*!
+ * \ingroup Components
+ *
+ * \brief The tables of all thermodynamic properties of a given component for
+ *        one range of temperatures and pressures.
+ *
+ * In contrast to Opm::TabulatedComponent, which uses this class, each object owns
+ * its tables. Thus, tables for several ranges can coexist, e.g., a coarse one which
+ * covers a wide range of states and a fine one for the operating window of a
+ * reservoir. The methods which evaluate the properties are const and do not modify
+ * any state, so an initialized object can be used by several threads at once. If a
+ * value is outside of the tabulated range, the raw component is evaluated instead.
+ *
+ * At the moment, this class can only handle the sub-critical fluids
+ * since it tabulates along the vapor pressure curve.
+ *
+ * \tparam Scalar The type used for scalar values
+ * \tparam RawComponent The component which ought to be tabulated
+ * \tparam useVaporPressure If true, tabulate all quantities along the
+ *                          vapor pressure curve, if false use the
+ *                          pressure range [p_min, p_max]
+ */
+template <class ScalarT, class RawComponent, bool useVaporPressure=true>
+class TabulatedComponentTables
+{
+public:
+    typedef ScalarT Scalar;
+
+    //! The positions of the quantities within the results of liquidProperties() and
+    //! gasProperties()
+    enum { densityIdx = 0,
+           enthalpyIdx = 1,
+           heatCapacityIdx = 2,
+           viscosityIdx = 3,
+           thermalConductivityIdx = 4,
+           numPhaseQuantities = 5 };
+
+    /*!
+     * \brief Create an object without any tables.
+     *
+     * init() must be called before any property can be evaluated.
+     */
+    TabulatedComponentTables()
+        : tempMin_(0.0), tempMax_(0.0), nTemp_(0), tempIdxFactor_(0.0)
+        , pressMin_(0.0), pressMax_(0.0), nPress_(0)
+        , densityMin_(0.0), densityMax_(0.0), nDensity_(0)
+    {}
+
+    /*!
+     * \brief Create the tables for a given range.
+     *
+     * \copydetails init()
+     */
+    TabulatedComponentTables(Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                             Scalar pressMin, Scalar pressMax, unsigned nPress,
+                             const std::string& cacheFileName = "")
+    { init(tempMin, tempMax, nTemp, pressMin, pressMax, nPress, cacheFileName); }
+
+    /*!
+     * \brief Initialize the tables.
+     *
+     * Filling the tables requires a large number of evaluations of the raw
+     * component. If OpenMP is enabled, this is done in parallel, so the methods of
+     * the raw component must be thread safe. If 'cacheFileName' is not empty, the
+     * tables are read from this file if it exists and was created for the same
+     * component and ranges; otherwise they are computed and written to the file.
+     *
+     * \param tempMin The minimum of the temperature range in \f$\mathrm{[K]}\f$
+     * \param tempMax The maximum of the temperature range in \f$\mathrm{[K]}\f$
+     * \param nTemp The number of entries/steps within the temperature range
+     * \param pressMin The minimum of the pressure range in \f$\mathrm{[Pa]}\f$
+     * \param pressMax The maximum of the pressure range in \f$\mathrm{[Pa]}\f$
+     * \param nPress The number of entries/steps within the pressure range
+     * \param cacheFileName The name of the binary file used to store the tables
+     *
+     * The object must not be used by other threads while it is initialized.
+     */
+    void init(Scalar tempMin, Scalar tempMax, unsigned nTemp,
+              Scalar pressMin, Scalar pressMax, unsigned nPress,
+              const std::string& cacheFileName = "")
+    {
+        tempMin_ = tempMin;
+        tempMax_ = tempMax;
+        nTemp_ = nTemp;
+        tempIdxFactor_ = (nTemp_ - 1)/(tempMax_ - tempMin_);
+        pressMin_ = pressMin;
+        pressMax_ = pressMax;
+        nPress_ = nPress;
+        nDensity_ = nPress_;
+
+        allocateTables_();
+
+        if (cacheFileName.empty() || !readCache_(cacheFileName)) {
+            fillTemperaturePressureTables_();
+            fillTemperatureDensityTables_();
+
+            if (!cacheFileName.empty())
+                writeCache_(cacheFileName);
+        }
+    }
+
+    /*!
+     * \brief Returns true if init() has not been called yet.
+     */
+    bool empty() const
+    { return nTemp_ == 0; }
+
+    /*!
+     * \brief The minimum of the tabulated temperature range in \f$\mathrm{[K]}\f$.
+     */
+    Scalar tempMin() const
+    { return tempMin_; }
+
+    /*!
+     * \brief The maximum of the tabulated temperature range in \f$\mathrm{[K]}\f$.
+     */
+    Scalar tempMax() const
+    { return tempMax_; }
+
+    /*!
+     * \brief The minimum of the tabulated pressure range in \f$\mathrm{[Pa]}\f$.
+     */
+    Scalar pressMin() const
+    { return pressMin_; }
+
+    /*!
+     * \brief The maximum of the tabulated pressure range in \f$\mathrm{[Pa]}\f$.
+     */
+    Scalar pressMax() const
+    { return pressMax_; }
+
+    /*!
+     * \brief The vapor pressure in \f$\mathrm{[Pa]}\f$ of the component at a given
+     *        temperature.
+     *
+     * \param T temperature of component
+     */
+    template <class Evaluation>
+    Evaluation vaporPressure(const Evaluation& temperature) const
+    {
+        const Evaluation& result = interpolateT_(vaporPressure_, temperature);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::vaporPressure(temperature);
+        return result;
+    }
+
+    /*!
+     * \brief Specific enthalpy of the gas \f$\mathrm{[J/kg]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation gasEnthalpy(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateGasTP_(enthalpyIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::gasEnthalpy(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief Specific enthalpy of the liquid \f$\mathrm{[J/kg]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation liquidEnthalpy(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateLiquidTP_(enthalpyIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::liquidEnthalpy(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief Specific isobaric heat capacity of the gas \f$\mathrm{[J/(kg K)]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation gasHeatCapacity(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateGasTP_(heatCapacityIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::gasHeatCapacity(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief Specific isobaric heat capacity of the liquid \f$\mathrm{[J/(kg K)]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation liquidHeatCapacity(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateLiquidTP_(heatCapacityIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::liquidHeatCapacity(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief Specific internal energy of the gas \f$\mathrm{[J/kg]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation gasInternalEnergy(const Evaluation& temperature, const Evaluation& pressure) const
+    { return gasEnthalpy(temperature, pressure) - pressure/gasDensity(temperature, pressure); }
+
+    /*!
+     * \brief Specific internal energy of the liquid \f$\mathrm{[J/kg]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation liquidInternalEnergy(const Evaluation& temperature, const Evaluation& pressure) const
+    { return liquidEnthalpy(temperature, pressure) - pressure/liquidDensity(temperature, pressure); }
+
+    /*!
+     * \brief The pressure of gas in \f$\mathrm{[Pa]}\f$ at a given density and temperature.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param density density of component in \f$\mathrm{[kg/m^3]}\f$
+     */
+    template <class Evaluation>
+    Evaluation gasPressure(const Evaluation& temperature, Scalar density) const
+    {
+        const Evaluation& result = interpolateGasTRho_(gasPressure_,
+                                                       temperature,
+                                                       density);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::gasPressure(temperature,
+                                             density);
+        return result;
+    }
+
+    /*!
+     * \brief The pressure of liquid in \f$\mathrm{[Pa]}\f$ at a given density and temperature.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param density density of component in \f$\mathrm{[kg/m^3]}\f$
+     */
+    template <class Evaluation>
+    Evaluation liquidPressure(const Evaluation& temperature, Scalar density) const
+    {
+        const Evaluation& result = interpolateLiquidTRho_(liquidPressure_,
+                                                          temperature,
+                                                          density);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::liquidPressure(temperature,
+                                                density);
+        return result;
+    }
+
+    /*!
+     * \brief The density of gas at a given pressure and temperature
+     *        \f$\mathrm{[kg/m^3]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation gasDensity(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateGasTP_(densityIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::gasDensity(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief The density of liquid at a given pressure and
+     *        temperature \f$\mathrm{[kg/m^3]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation liquidDensity(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateLiquidTP_(densityIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::liquidDensity(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief The dynamic viscosity \f$\mathrm{[Pa*s]}\f$ of gas.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation gasViscosity(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateGasTP_(viscosityIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::gasViscosity(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief The dynamic viscosity \f$\mathrm{[Pa*s]}\f$ of liquid.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation liquidViscosity(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateLiquidTP_(viscosityIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::liquidViscosity(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief The thermal conductivity of gaseous water \f$\mathrm{[W / (m K)]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation gasThermalConductivity(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateGasTP_(thermalConductivityIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::gasThermalConductivity(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief The thermal conductivity of liquid water \f$\mathrm{[W / (m K)]}\f$.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    Evaluation liquidThermalConductivity(const Evaluation& temperature, const Evaluation& pressure) const
+    {
+        const Evaluation& result = interpolateLiquidTP_(thermalConductivityIdx, temperature, pressure);
+        if (std::isnan(Opm::scalarValue(result)))
+            return RawComponent::liquidThermalConductivity(temperature, pressure);
+        return result;
+    }
+
+    /*!
+     * \brief The density, the specific enthalpy, the specific isobaric heat capacity,
+     *        the dynamic viscosity and the thermal conductivity of the liquid.
+     *
+     * The results are the same as the ones of the individual methods, but the
+     * position of the state within the tables is only determined once and the values
+     * of all quantities at a sampling point are adjacent in memory. The results are
+     * indexed by densityIdx, enthalpyIdx, heatCapacityIdx, viscosityIdx and
+     * thermalConductivityIdx.
+     *
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    std::array<Evaluation, numPhaseQuantities> liquidProperties(const Evaluation& temperature,
+                                                                const Evaluation& pressure) const
+    {
+        std::array<Evaluation, numPhaseQuantities> result;
+        TPCell_<Evaluation> cell;
+        const bool inRange = liquidCell_(cell, temperature, pressure);
+        for (unsigned quantityIdx = 0; quantityIdx < numPhaseQuantities; ++quantityIdx) {
+            if (inRange)
+                result[quantityIdx] = interpolateCell_(liquidValues_, cell, quantityIdx);
+            if (!inRange || std::isnan(Opm::scalarValue(result[quantityIdx])))
+                result[quantityIdx] = rawLiquidQuantity_(quantityIdx, temperature, pressure);
+        }
+        return result;
+    }
+
+    /*!
+     * \brief The density, the specific enthalpy, the specific isobaric heat capacity,
+     *        the dynamic viscosity and the thermal conductivity of the gas.
+     *
+     * \copydetails liquidProperties()
+     */
+    template <class Evaluation>
+    std::array<Evaluation, numPhaseQuantities> gasProperties(const Evaluation& temperature,
+                                                             const Evaluation& pressure) const
+    {
+        std::array<Evaluation, numPhaseQuantities> result;
+        TPCell_<Evaluation> cell;
+        const bool inRange = gasCell_(cell, temperature, pressure);
+        for (unsigned quantityIdx = 0; quantityIdx < numPhaseQuantities; ++quantityIdx) {
+            if (inRange)
+                result[quantityIdx] = interpolateCell_(gasValues_, cell, quantityIdx);
+            if (!inRange || std::isnan(Opm::scalarValue(result[quantityIdx])))
+                result[quantityIdx] = rawGasQuantity_(quantityIdx, temperature, pressure);
+        }
+        return result;
+    }
+
+private:
+    // the flat indices of the four sampling points of the cell of the temperature and
+    // pressure tables which contains a state and their interpolation weights
+    template <class Evaluation>
+    struct TPCell_
+    {
+        size_t idx[4];
+        Evaluation weight[4];
+    };
+
+    // the tables of the cache file. the quantities which depend on the temperature and
+    // the pressure are interleaved, so each table is described by its array, the
+    // distance between consecutive entries and the position of its first entry.
+    struct CacheTable_
+    {
+        std::vector<Scalar>* values;
+        unsigned stride;
+        unsigned offset;
+    };
+
+    enum { numCacheTables_ = 17 };
+
+    void allocateTables_()
+    {
+        for (auto* table : { &vaporPressure_,
+                             &minGasDensity__, &maxGasDensity__,
+                             &minLiquidDensity__, &maxLiquidDensity__ })
+            table->resize(nTemp_);
+
+        gasValues_.resize(nTemp_*nPress_*numPhaseQuantities);
+        liquidValues_.resize(nTemp_*nPress_*numPhaseQuantities);
+        gasPressure_.resize(nTemp_*nDensity_);
+        liquidPressure_.resize(nTemp_*nDensity_);
+    }
+
+    // the order of the tables is the one of the cache file
+    std::array<CacheTable_, numCacheTables_> cacheTables_()
+    {
+        return {{
+            { &vaporPressure_, 1, 0 },
+            { &minGasDensity__, 1, 0 },
+            { &maxGasDensity__, 1, 0 },
+            { &minLiquidDensity__, 1, 0 },
+            { &maxLiquidDensity__, 1, 0 },
+            { &gasValues_, numPhaseQuantities, enthalpyIdx },
+            { &liquidValues_, numPhaseQuantities, enthalpyIdx },
+            { &gasValues_, numPhaseQuantities, heatCapacityIdx },
+            { &liquidValues_, numPhaseQuantities, heatCapacityIdx },
+            { &gasValues_, numPhaseQuantities, densityIdx },
+            { &liquidValues_, numPhaseQuantities, densityIdx },
+            { &gasValues_, numPhaseQuantities, viscosityIdx },
+            { &liquidValues_, numPhaseQuantities, viscosityIdx },
+            { &gasValues_, numPhaseQuantities, thermalConductivityIdx },
+            { &liquidValues_, numPhaseQuantities, thermalConductivityIdx },
+            { &gasPressure_, 1, 0 },
+            { &liquidPressure_, 1, 0 }
+        }};
+    }
+
+    // fill the temperature-pressure tables
+    void fillTemperaturePressureTables_()
+    {
+        assert(std::numeric_limits<Scalar>::has_quiet_NaN);
+        Scalar NaN = std::numeric_limits<Scalar>::quiet_NaN();
+
+        // the temperature sampling points are independent of each other
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int iTInt = 0; iTInt < static_cast<int>(nTemp_); ++ iTInt) {
+            unsigned iT = static_cast<unsigned>(iTInt);
+            Scalar temperature = iT * (tempMax_ - tempMin_)/(nTemp_ - 1) + tempMin_;
+
+            try { vaporPressure_[iT] = RawComponent::vaporPressure(temperature); }
+            catch (const std::exception&) { vaporPressure_[iT] = NaN; }
+
+            Scalar pgMax = maxGasPressure_(iT);
+            Scalar pgMin = minGasPressure_(iT);
+
+            // fill the temperature, pressure gas arrays
+            for (unsigned iP = 0; iP < nPress_; ++ iP) {
+                Scalar pressure = iP * (pgMax - pgMin)/(nPress_ - 1) + pgMin;
+
+                Scalar* values = &gasValues_[(iT + iP*nTemp_)*numPhaseQuantities];
+
+                try { values[enthalpyIdx] = RawComponent::gasEnthalpy(temperature, pressure); }
+                catch (const std::exception&) { values[enthalpyIdx] = NaN; }
+
+                try { values[heatCapacityIdx] = RawComponent::gasHeatCapacity(temperature, pressure); }
+                catch (const std::exception&) { values[heatCapacityIdx] = NaN; }
+
+                try { values[densityIdx] = RawComponent::gasDensity(temperature, pressure); }
+                catch (const std::exception&) { values[densityIdx] = NaN; }
+
+                try { values[viscosityIdx] = RawComponent::gasViscosity(temperature, pressure); }
+                catch (const std::exception&) { values[viscosityIdx] = NaN; }
+
+                try { values[thermalConductivityIdx] = RawComponent::gasThermalConductivity(temperature, pressure); }
+                catch (const std::exception&) { values[thermalConductivityIdx] = NaN; }
+            };
+
+            Scalar plMin = minLiquidPressure_(iT);
+            Scalar plMax = maxLiquidPressure_(iT);
+            for (unsigned iP = 0; iP < nPress_; ++ iP) {
+                Scalar pressure = iP * (plMax - plMin)/(nPress_ - 1) + plMin;
+
+                Scalar* values = &liquidValues_[(iT + iP*nTemp_)*numPhaseQuantities];
+
+                try { values[enthalpyIdx] = RawComponent::liquidEnthalpy(temperature, pressure); }
+                catch (const std::exception&) { values[enthalpyIdx] = NaN; }
+
+                try { values[heatCapacityIdx] = RawComponent::liquidHeatCapacity(temperature, pressure); }
+                catch (const std::exception&) { values[heatCapacityIdx] = NaN; }
+
+                try { values[densityIdx] = RawComponent::liquidDensity(temperature, pressure); }
+                catch (const std::exception&) { values[densityIdx] = NaN; }
+
+                try { values[viscosityIdx] = RawComponent::liquidViscosity(temperature, pressure); }
+                catch (const std::exception&) { values[viscosityIdx] = NaN; }
+
+                try { values[thermalConductivityIdx] = RawComponent::liquidThermalConductivity(temperature, pressure); }
+                catch (const std::exception&) { values[thermalConductivityIdx] = NaN; }
+            }
+        }
+    }
+
+    // fill the temperature-density tables. this requires the vapor pressures to be
+    // known for all temperatures.
+    void fillTemperatureDensityTables_()
+    {
+        Scalar NaN = std::numeric_limits<Scalar>::quiet_NaN();
+
+        // calculate the minimum and maximum values for the densities. This is done
+        // serially because errors are not caught here
+        for (unsigned iT = 0; iT < nTemp_; ++ iT) {
+            Scalar temperature = iT * (tempMax_ - tempMin_)/(nTemp_ - 1) + tempMin_;
+
+            minGasDensity__[iT] = RawComponent::gasDensity(temperature, minGasPressure_(iT));
+            if (iT < nTemp_ - 1)
+                maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iT + 1));
+            else
+                maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iT));
+
+            minLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, minLiquidPressure_(iT));
+            if (iT < nTemp_ - 1)
+                maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iT + 1));
+            else
+                maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iT));
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int iTInt = 0; iTInt < static_cast<int>(nTemp_); ++ iTInt) {
+            unsigned iT = static_cast<unsigned>(iTInt);
+            Scalar temperature = iT * (tempMax_ - tempMin_)/(nTemp_ - 1) + tempMin_;
+
+            // fill the temperature, density gas arrays
+            for (unsigned iRho = 0; iRho < nDensity_; ++ iRho) {
+                Scalar density =
+                    Scalar(iRho)/(nDensity_ - 1) *
+                    (maxGasDensity__[iT] - minGasDensity__[iT])
+                    +
+                    minGasDensity__[iT];
+
+                unsigned i = iT + iRho*nTemp_;
+
+                try { gasPressure_[i] = RawComponent::gasPressure(temperature, density); }
+                catch (const std::exception&) { gasPressure_[i] = NaN; };
+            };
+
+            // fill the temperature, density liquid arrays
+            for (unsigned iRho = 0; iRho < nDensity_; ++ iRho) {
+                Scalar density =
+                    Scalar(iRho)/(nDensity_ - 1) *
+                    (maxLiquidDensity__[iT] - minLiquidDensity__[iT])
+                    +
+                    minLiquidDensity__[iT];
+
+                unsigned i = iT + iRho*nTemp_;
+
+                try { liquidPressure_[i] = RawComponent::liquidPressure(temperature, density); }
+                catch (const std::exception&) { liquidPressure_[i] = NaN; };
+            };
+        }
+    }
+
+    // the binary format of the cache file is a header which specifies the
+    // component, the scalar type and the sampling ranges, followed by the raw
+    // contents of the tables in the order given by cacheTables_()
+    bool readCache_(const std::string& fileName)
+    {
+        std::ifstream file(fileName.c_str(), std::ios::binary);
+        if (!file)
+            return false;
+
+        const std::string& componentName = RawComponent::name();
+        unsigned nameLength;
+        file.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+        if (!file || nameLength != componentName.size())
+            return false;
+        std::string name(nameLength, ' ');
+        file.read(&name[0], nameLength);
+
+        unsigned scalarSize, nTemp, nPress, vaporPressureMode;
+        Scalar tempMin, tempMax, pressMin, pressMax;
+        file.read(reinterpret_cast<char*>(&scalarSize), sizeof(scalarSize));
+        file.read(reinterpret_cast<char*>(&vaporPressureMode), sizeof(vaporPressureMode));
+        file.read(reinterpret_cast<char*>(&nTemp), sizeof(nTemp));
+        file.read(reinterpret_cast<char*>(&nPress), sizeof(nPress));
+        file.read(reinterpret_cast<char*>(&tempMin), sizeof(tempMin));
+        file.read(reinterpret_cast<char*>(&tempMax), sizeof(tempMax));
+        file.read(reinterpret_cast<char*>(&pressMin), sizeof(pressMin));
+        file.read(reinterpret_cast<char*>(&pressMax), sizeof(pressMax));
+        if (!file
+            || name != componentName
+            || scalarSize != sizeof(Scalar)
+            || vaporPressureMode != static_cast<unsigned>(useVaporPressure)
+            || nTemp != nTemp_
+            || nPress != nPress_
+            || tempMin != tempMin_
+            || tempMax != tempMax_
+            || pressMin != pressMin_
+            || pressMax != pressMax_)
+            return false;
+
+        std::vector<Scalar> buffer;
+        for (const auto& table : cacheTables_()) {
+            buffer.resize(table.values->size()/table.stride);
+            file.read(reinterpret_cast<char*>(buffer.data()), buffer.size()*sizeof(Scalar));
+            for (size_t i = 0; i < buffer.size(); ++i)
+                (*table.values)[i*table.stride + table.offset] = buffer[i];
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    void writeCache_(const std::string& fileName)
+    {
+        std::ofstream file(fileName.c_str(), std::ios::binary);
+        if (!file)
+            OPM_THROW(std::runtime_error,
+                      "Could not open file '" << fileName << "' for writing the tables of "
+                      << RawComponent::name());
+
+        const std::string& componentName = RawComponent::name();
+        unsigned nameLength = static_cast<unsigned>(componentName.size());
+        file.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+        file.write(componentName.c_str(), nameLength);
+
+        unsigned scalarSize = sizeof(Scalar);
+        unsigned vaporPressureMode = useVaporPressure;
+        file.write(reinterpret_cast<const char*>(&scalarSize), sizeof(scalarSize));
+        file.write(reinterpret_cast<const char*>(&vaporPressureMode), sizeof(vaporPressureMode));
+        file.write(reinterpret_cast<const char*>(&nTemp_), sizeof(nTemp_));
+        file.write(reinterpret_cast<const char*>(&nPress_), sizeof(nPress_));
+        file.write(reinterpret_cast<const char*>(&tempMin_), sizeof(tempMin_));
+        file.write(reinterpret_cast<const char*>(&tempMax_), sizeof(tempMax_));
+        file.write(reinterpret_cast<const char*>(&pressMin_), sizeof(pressMin_));
+        file.write(reinterpret_cast<const char*>(&pressMax_), sizeof(pressMax_));
+
+        std::vector<Scalar> buffer;
+        for (const auto& table : cacheTables_()) {
+            buffer.resize(table.values->size()/table.stride);
+            for (size_t i = 0; i < buffer.size(); ++i)
+                buffer[i] = (*table.values)[i*table.stride + table.offset];
+            file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size()*sizeof(Scalar));
+        }
+
+        if (!file)
+            OPM_THROW(std::runtime_error,
+                      "Could not write the tables of " << RawComponent::name()
+                      << " to file '" << fileName << "'");
+    }
+
+    // returns an interpolated value depending on temperature
+    template <class Evaluation>
+    Evaluation interpolateT_(const std::vector<Scalar>& values, const Evaluation& T) const
+    {
+        Evaluation alphaT = tempIdx_(T);
+        if (nTemp_ < 2 || alphaT < 0 || alphaT >= nTemp_ - 1)
+            return std::numeric_limits<Scalar>::quiet_NaN();
+
+        size_t iT = static_cast<size_t>(Opm::scalarValue(alphaT));
+        alphaT -= iT;
+
+        return
+            values[iT    ]*(1 - alphaT) +
+            values[iT + 1]*(    alphaT);
+    }
+
+    // returns an interpolated quantity of the liquid depending on temperature and
+    // pressure
+    template <class Evaluation>
+    Evaluation interpolateLiquidTP_(unsigned quantityIdx, const Evaluation& T, const Evaluation& p) const
+    {
+        TPCell_<Evaluation> cell;
+        if (!liquidCell_(cell, T, p))
+            return std::numeric_limits<Scalar>::quiet_NaN();
+        return interpolateCell_(liquidValues_, cell, quantityIdx);
+    }
+
+    // returns an interpolated quantity of the gas depending on temperature and
+    // pressure
+    template <class Evaluation>
+    Evaluation interpolateGasTP_(unsigned quantityIdx, const Evaluation& T, const Evaluation& p) const
+    {
+        TPCell_<Evaluation> cell;
+        if (!gasCell_(cell, T, p))
+            return std::numeric_limits<Scalar>::quiet_NaN();
+        return interpolateCell_(gasValues_, cell, quantityIdx);
+    }
+
+    // determine the cell of the liquid tables which contains a state. returns false if
+    // the temperature is outside of the tabulated range.
+    template <class Evaluation>
+    bool liquidCell_(TPCell_<Evaluation>& cell, const Evaluation& T, const Evaluation& p) const
+    {
+        Evaluation alphaT = tempIdx_(T);
+        if (nTemp_ < 2 || alphaT < 0 || alphaT >= nTemp_ - 1)
+            return false;
+
+        size_t iT = static_cast<size_t>(Opm::scalarValue(alphaT));
+        alphaT -= iT;
+
+        Evaluation alphaP1 = pressLiquidIdx_(p, iT);
+        Evaluation alphaP2 = pressLiquidIdx_(p, iT + 1);
+
+        size_t iP1 =
+            static_cast<size_t>(
+                std::max<int>(0, std::min(static_cast<int>(nPress_) - 2,
+                                          static_cast<int>(Opm::scalarValue(alphaP1)))));
+        size_t iP2 =
+            static_cast<size_t>(
+                std::max(0, std::min(static_cast<int>(nPress_) - 2,
+                                     static_cast<int>(Opm::scalarValue(alphaP2)))));
+        alphaP1 -= iP1;
+        alphaP2 -= iP2;
+
+        setCell_(cell, iT, iP1, iP2, alphaT, alphaP1, alphaP2);
+        return true;
+    }
+
+    // determine the cell of the gas tables which contains a state. returns false if
+    // the temperature is outside of the tabulated range.
+    template <class Evaluation>
+    bool gasCell_(TPCell_<Evaluation>& cell, const Evaluation& T, const Evaluation& p) const
+    {
+        Evaluation alphaT = tempIdx_(T);
+        if (nTemp_ < 2 || alphaT < 0 || alphaT >= nTemp_ - 1)
+            return false;
+
+        size_t iT =
+            static_cast<size_t>(
+                std::max(0, std::min(static_cast<int>(nTemp_) - 2,
+                                     static_cast<int>(Opm::scalarValue(alphaT)))));
+        alphaT -= iT;
+
+        Evaluation alphaP1 = pressGasIdx_(p, iT);
+        Evaluation alphaP2 = pressGasIdx_(p, iT + 1);
+        size_t iP1 =
+            static_cast<size_t>(
+                std::max(0, std::min(static_cast<int>(nPress_) - 2,
+                                     static_cast<int>(Opm::scalarValue(alphaP1)))));
+        size_t iP2 =
+            static_cast<size_t>(
+                std::max(0, std::min(static_cast<int>(nPress_) - 2,
+                                     static_cast<int>(Opm::scalarValue(alphaP2)))));
+        alphaP1 -= iP1;
+        alphaP2 -= iP2;
+
+        setCell_(cell, iT, iP1, iP2, alphaT, alphaP1, alphaP2);
+        return true;
+    }
+
+    // the pressure ranges differ between the two temperatures of a cell, so the
+    // pressure indices and weights are specified for each of them
+    template <class Evaluation>
+    void setCell_(TPCell_<Evaluation>& cell,
+                  size_t iT, size_t iP1, size_t iP2,
+                  const Evaluation& alphaT,
+                  const Evaluation& alphaP1,
+                  const Evaluation& alphaP2) const
+    {
+        cell.idx[0] = ((iT    ) + (iP1    )*nTemp_)*numPhaseQuantities;
+        cell.idx[1] = ((iT    ) + (iP1 + 1)*nTemp_)*numPhaseQuantities;
+        cell.idx[2] = ((iT + 1) + (iP2    )*nTemp_)*numPhaseQuantities;
+        cell.idx[3] = ((iT + 1) + (iP2 + 1)*nTemp_)*numPhaseQuantities;
+
+        cell.weight[0] = (1 - alphaT)*(1 - alphaP1);
+        cell.weight[1] = (1 - alphaT)*(    alphaP1);
+        cell.weight[2] = (    alphaT)*(1 - alphaP2);
+        cell.weight[3] = (    alphaT)*(    alphaP2);
+    }
+
+    template <class Evaluation>
+    Evaluation interpolateCell_(const std::vector<Scalar>& values,
+                                const TPCell_<Evaluation>& cell,
+                                unsigned quantityIdx) const
+    {
+        return
+            values[cell.idx[0] + quantityIdx]*cell.weight[0] +
+            values[cell.idx[1] + quantityIdx]*cell.weight[1] +
+            values[cell.idx[2] + quantityIdx]*cell.weight[2] +
+            values[cell.idx[3] + quantityIdx]*cell.weight[3];
+    }
+
+    // evaluate a quantity of the liquid using the raw component
+    template <class Evaluation>
+    static Evaluation rawLiquidQuantity_(unsigned quantityIdx, const Evaluation& T, const Evaluation& p)
+    {
+        switch (quantityIdx) {
+        case densityIdx: return RawComponent::liquidDensity(T, p);
+        case enthalpyIdx: return RawComponent::liquidEnthalpy(T, p);
+        case heatCapacityIdx: return RawComponent::liquidHeatCapacity(T, p);
+        case viscosityIdx: return RawComponent::liquidViscosity(T, p);
+        default: return RawComponent::liquidThermalConductivity(T, p);
+        }
+    }
+
+    // evaluate a quantity of the gas using the raw component
+    template <class Evaluation>
+    static Evaluation rawGasQuantity_(unsigned quantityIdx, const Evaluation& T, const Evaluation& p)
+    {
+        switch (quantityIdx) {
+        case densityIdx: return RawComponent::gasDensity(T, p);
+        case enthalpyIdx: return RawComponent::gasEnthalpy(T, p);
+        case heatCapacityIdx: return RawComponent::gasHeatCapacity(T, p);
+        case viscosityIdx: return RawComponent::gasViscosity(T, p);
+        default: return RawComponent::gasThermalConductivity(T, p);
+        }
+    }
+
+    // returns an interpolated value for gas depending on
+    // temperature and density
+    template <class Evaluation>
+    Evaluation interpolateGasTRho_(const std::vector<Scalar>& values, const Evaluation& T, const Evaluation& rho) const
+    {
+        if (nTemp_ < 2)
+            return std::numeric_limits<Scalar>::quiet_NaN();
+
+        Evaluation alphaT = tempIdx_(T);
+        unsigned iT = std::max(0,
+                               std::min(static_cast<int>(nTemp_ - 2),
+                                        static_cast<int>(alphaT)));
+        alphaT -= iT;
+
+        Evaluation alphaP1 = densityGasIdx_(rho, iT);
+        Evaluation alphaP2 = densityGasIdx_(rho, iT + 1);
+        unsigned iP1 =
+            std::max(0,
+                     std::min(static_cast<int>(nDensity_ - 2),
+                              static_cast<int>(alphaP1)));
+        unsigned iP2 =
+            std::max(0,
+                     std::min(static_cast<int>(nDensity_ - 2),
+                              static_cast<int>(alphaP2)));
+        alphaP1 -= iP1;
+        alphaP2 -= iP2;
+
+        return
+            values[(iT    ) + (iP1    )*nTemp_]*(1 - alphaT)*(1 - alphaP1) +
+            values[(iT    ) + (iP1 + 1)*nTemp_]*(1 - alphaT)*(    alphaP1) +
+            values[(iT + 1) + (iP2    )*nTemp_]*(    alphaT)*(1 - alphaP2) +
+            values[(iT + 1) + (iP2 + 1)*nTemp_]*(    alphaT)*(    alphaP2);
+    }
+
+    // returns an interpolated value for liquid depending on
+    // temperature and density
+    template <class Evaluation>
+    Evaluation interpolateLiquidTRho_(const std::vector<Scalar>& values, const Evaluation& T, const Evaluation& rho) const
+    {
+        if (nTemp_ < 2)
+            return std::numeric_limits<Scalar>::quiet_NaN();
+
+        Evaluation alphaT = tempIdx_(T);
+        unsigned iT = std::max<int>(0, std::min<int>(nTemp_ - 2, static_cast<int>(alphaT)));
+        alphaT -= iT;
+
+        Evaluation alphaP1 = densityLiquidIdx_(rho, iT);
+        Evaluation alphaP2 = densityLiquidIdx_(rho, iT + 1);
+        unsigned iP1 = std::max<int>(0, std::min<int>(nDensity_ - 2, static_cast<int>(alphaP1)));
+        unsigned iP2 = std::max<int>(0, std::min<int>(nDensity_ - 2, static_cast<int>(alphaP2)));
+        alphaP1 -= iP1;
+        alphaP2 -= iP2;
+
+        return
+            values[(iT    ) + (iP1    )*nTemp_]*(1 - alphaT)*(1 - alphaP1) +
+            values[(iT    ) + (iP1 + 1)*nTemp_]*(1 - alphaT)*(    alphaP1) +
+            values[(iT + 1) + (iP2    )*nTemp_]*(    alphaT)*(1 - alphaP2) +
+            values[(iT + 1) + (iP2 + 1)*nTemp_]*(    alphaT)*(    alphaP2);
+    }
+
+
+    // returns the index of an entry in a temperature field. this is NaN if the tables
+    // have not been initialized, i.e., it is outside of any valid range
+    template <class Evaluation>
+    Evaluation tempIdx_(const Evaluation& temperature) const
+    {
+        if (nTemp_ < 2)
+            return std::numeric_limits<Scalar>::quiet_NaN();
+        return (temperature - tempMin_)*tempIdxFactor_;
+    }
+
+    // returns the index of an entry in a pressure field
+    template <class Evaluation>
+    Evaluation pressLiquidIdx_(const Evaluation& pressure, size_t tempIdx) const
+    {
+        Scalar plMin = minLiquidPressure_(tempIdx);
+        Scalar plMax = maxLiquidPressure_(tempIdx);
+
+        // only divide scalars: the range depends on the temperature index, so
+        // the factor cannot be computed when the tables are initialized
+        Scalar factor = (nPress_ - 1)/(plMax - plMin);
+        return (pressure - plMin)*factor;
+    }
+
+    // returns the index of an entry in a temperature field
+    template <class Evaluation>
+    Evaluation pressGasIdx_(const Evaluation& pressure, size_t tempIdx) const
+    {
+        Scalar pgMin = minGasPressure_(tempIdx);
+        Scalar pgMax = maxGasPressure_(tempIdx);
+
+        Scalar factor = (nPress_ - 1)/(pgMax - pgMin);
+        return (pressure - pgMin)*factor;
+    }
+
+    // returns the index of an entry in a density field
+    template <class Evaluation>
+    Evaluation densityLiquidIdx_(const Evaluation& density, size_t tempIdx) const
+    {
+        Scalar densityMin = minLiquidDensity_(tempIdx);
+        Scalar densityMax = maxLiquidDensity_(tempIdx);
+        Scalar factor = (nDensity_ - 1)/(densityMax - densityMin);
+        return (density - densityMin)*factor;
+    }
+
+    // returns the index of an entry in a density field
+    template <class Evaluation>
+    Evaluation densityGasIdx_(const Evaluation& density, size_t tempIdx) const
+    {
+        Scalar densityMin = minGasDensity_(tempIdx);
+        Scalar densityMax = maxGasDensity_(tempIdx);
+        Scalar factor = (nDensity_ - 1)/(densityMax - densityMin);
+        return (density - densityMin)*factor;
+    }
+
+    // returns the minimum tabulized liquid pressure at a given
+    // temperature index
+    Scalar minLiquidPressure_(size_t tempIdx) const
+    {
+        if (!useVaporPressure || tempIdx >= vaporPressure_.size())
+            return pressMin_;
+        else
+            return std::max<Scalar>(pressMin_, vaporPressure_[tempIdx] / 1.1);
+    }
+
+    // returns the maximum tabulized liquid pressure at a given
+    // temperature index
+    Scalar maxLiquidPressure_(size_t tempIdx) const
+    {
+        if (!useVaporPressure || tempIdx >= vaporPressure_.size())
+            return pressMax_;
+        else
+            return std::max<Scalar>(pressMax_, vaporPressure_[tempIdx] * 1.1);
+    }
+
+    // returns the minumum tabulized gas pressure at a given
+    // temperature index
+    Scalar minGasPressure_(size_t tempIdx) const
+    {
+        if (!useVaporPressure || tempIdx >= vaporPressure_.size())
+            return pressMin_;
+        else
+            return std::min<Scalar>(pressMin_, vaporPressure_[tempIdx] / 1.1 );
+    }
+
+    // returns the maximum tabulized gas pressure at a given
+    // temperature index
+    Scalar maxGasPressure_(size_t tempIdx) const
+    {
+        if (!useVaporPressure || tempIdx >= vaporPressure_.size())
+            return pressMax_;
+        else
+            return std::min<Scalar>(pressMax_, vaporPressure_[tempIdx] * 1.1);
+    }
+
+
+    // returns the minimum tabulized liquid density at a given
+    // temperature index
+    Scalar minLiquidDensity_(size_t tempIdx) const
+    { return minLiquidDensity__[tempIdx]; }
+
+    // returns the maximum tabulized liquid density at a given
+    // temperature index
+    Scalar maxLiquidDensity_(size_t tempIdx) const
+    { return maxLiquidDensity__[tempIdx]; }
+
+    // returns the minumum tabulized gas density at a given
+    // temperature index
+    Scalar minGasDensity_(size_t tempIdx) const
+    { return minGasDensity__[tempIdx]; }
+
+    // returns the maximum tabulized gas density at a given
+    // temperature index
+    Scalar maxGasDensity_(size_t tempIdx) const
+    { return maxGasDensity__[tempIdx]; }
+
+    // 1D fields with the temperature as degree of freedom
+    std::vector<Scalar> vaporPressure_;
+
+    std::vector<Scalar> minLiquidDensity__;
+    std::vector<Scalar> maxLiquidDensity__;
+
+    std::vector<Scalar> minGasDensity__;
+    std::vector<Scalar> maxGasDensity__;
+
+    // 2D fields with the temperature and pressure as degrees of freedom. the
+    // quantities of each sampling point are stored next to each other in the order
+    // given by densityIdx, enthalpyIdx, etc.
+    std::vector<Scalar> gasValues_;
+    std::vector<Scalar> liquidValues_;
+
+    // 2D fields with the temperature and density as degrees of
+    // freedom
+    std::vector<Scalar> gasPressure_;
+    std::vector<Scalar> liquidPressure_;
+
+    // temperature, pressure and density ranges
+    Scalar tempMin_;
+    Scalar tempMax_;
+    unsigned nTemp_;
+    // (nTemp_ - 1)/(tempMax_ - tempMin_)
+    Scalar tempIdxFactor_;
+
+    Scalar pressMin_;
+    Scalar pressMax_;
+    unsigned nPress_;
+
+    Scalar densityMin_;
+    Scalar densityMax_;
+    unsigned nDensity_;
+};
+
+} // namespace Opm
+
+#endif
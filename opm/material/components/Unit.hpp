@@ -55,31 +55,31 @@ public:
     /*!
      * \copydoc Component::molarMass
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 1.0; }
 
     /*!
      * \copydoc Component::criticalTemperature
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return 1.0; }
 
     /*!
      * \copydoc Component::criticalPressure
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return 1.0; }
 
     /*!
      * \copydoc Component::tripleTemperature
      */
-    static Scalar tripleTemperature()
+    static constexpr Scalar tripleTemperature()
     { return 1.0; }
 
     /*!
      * \copydoc Component::triplePressure
      */
-    static Scalar triplePressure()
+    static constexpr Scalar triplePressure()
     { return 1.0; }
 
     /*!
@@ -58,19 +58,19 @@ public:
     /*!
      * \brief The molar mass in \f$\mathrm{[kg/mol]}\f$ of xylene
      */
-    static Scalar molarMass()
+    static constexpr Scalar molarMass()
     { return 0.106; }
 
     /*!
      * \brief Returns the critical temperature \f$\mathrm{[K]}\f$ of xylene
      */
-    static Scalar criticalTemperature()
+    static constexpr Scalar criticalTemperature()
     { return 617.1; }
 
     /*!
      * \brief Returns the critical pressure \f$\mathrm{[Pa]}\f$ of xylene
      */
-    static Scalar criticalPressure()
+    static constexpr Scalar criticalPressure()
     { return 35.4e5; }
 
     /*!
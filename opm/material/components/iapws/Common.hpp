@@ -35,6 +35,38 @@
 namespace Opm {
 namespace IAPWS {
 
+/*!
+ * \ingroup IAPWS
+ *
+ * \brief The constants of water which can be used in constant expressions.
+ *
+ * These are the values of the corresponding static members of Common, but they do not
+ * depend on the scalar type.
+ */
+struct CommonConstants
+{
+    static constexpr double molarMass()
+    { return 18.01518e-3; }
+
+    static constexpr double criticalTemperature()
+    { return 647.096; }
+
+    static constexpr double criticalPressure()
+    { return 22.064e6; }
+
+    static constexpr double criticalDensity()
+    { return 322.0; }
+
+    static constexpr double acentricFactor()
+    { return 0.344; }
+
+    static constexpr double tripleTemperature()
+    { return 273.16; }
+
+    static constexpr double triplePressure()
+    { return 611.657; }
+};
+
 /*!
  *
  *  \ingroup IAPWS
@@ -81,6 +113,33 @@ public:
     //! Triple pressure of water \f$\mathrm{[Pa]}\f$
     static const Scalar triplePressure;
 
+    /*!
+     * \brief Fills a table with the integer powers of a quantity.
+     *
+     * After calling this method, table[k - minExp] contains \f$x^k\f$ for all
+     * \f$k\f$ in \f$[minExp, maxExp]\f$. The powers are computed by recurrence, so
+     * only a single division is required for the whole table.
+     *
+     * \param table The array to be filled. It needs room for maxExp - minExp + 1 entries
+     * \param x The base
+     * \param minExp The smallest exponent of the table (must not be positive)
+     * \param maxExp The largest exponent of the table (must not be negative)
+     */
+    template <class Evaluation>
+    static void integerPowers(Evaluation* table, const Evaluation& x, int minExp, int maxExp)
+    {
+        Evaluation* x0 = table - minExp;
+        x0[0] = 1.0;
+        for (int k = 1; k <= maxExp; ++k)
+            x0[k] = x0[k - 1]*x;
+
+        if (minExp < 0) {
+            const Evaluation& xInv = 1.0/x;
+            for (int k = -1; k >= minExp; --k)
+                x0[k] = x0[k + 1]*xInv;
+        }
+    }
+
     /*!
      * \brief The dynamic viscosity \f$\mathrm{[(N/m^2)*s]}\f$of pure water.
      *
@@ -230,23 +289,23 @@ public:
 };
 
 template <class Scalar>
-const Scalar Common<Scalar>::molarMass = 18.01518e-3;
+const Scalar Common<Scalar>::molarMass = CommonConstants::molarMass();
 template <class Scalar>
 const Scalar Common<Scalar>::Rs = Opm::Constants<Scalar>::R/molarMass;
 template <class Scalar>
-const Scalar Common<Scalar>::criticalTemperature = 647.096;
+const Scalar Common<Scalar>::criticalTemperature = CommonConstants::criticalTemperature();
 template <class Scalar>
-const Scalar Common<Scalar>::criticalPressure = 22.064e6;
+const Scalar Common<Scalar>::criticalPressure = CommonConstants::criticalPressure();
 template <class Scalar>
-const Scalar Common<Scalar>::criticalDensity = 322.0;
+const Scalar Common<Scalar>::criticalDensity = CommonConstants::criticalDensity();
 template <class Scalar>
 const Scalar Common<Scalar>::criticalMolarVolume = molarMass/criticalDensity;
 template <class Scalar>
-const Scalar Common<Scalar>::acentricFactor = 0.344;
+const Scalar Common<Scalar>::acentricFactor = CommonConstants::acentricFactor();
 template <class Scalar>
-const Scalar Common<Scalar>::tripleTemperature = 273.16;
+const Scalar Common<Scalar>::tripleTemperature = CommonConstants::tripleTemperature();
 template <class Scalar>
-const Scalar Common<Scalar>::triplePressure = 611.657;
+const Scalar Common<Scalar>::triplePressure = CommonConstants::triplePressure();
 
 } // namespace IAPWS
 } // namespace Opm
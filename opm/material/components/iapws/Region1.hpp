@@ -27,6 +27,7 @@
 #ifndef OPM_IAPWS_REGION1_HPP
 #define OPM_IAPWS_REGION1_HPP
 
+#include <opm/material/components/iapws/Common.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 
 #include <cmath>
@@ -135,12 +136,15 @@ public:
     template <class Evaluation>
     static Evaluation gamma(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauPow[numTauPowers_];
+        powerTables_(piPow, tauPow, temperature, pressure);
 
         Evaluation result = 0;
         for (int i = 0; i < 34; ++i) {
-            result += n(i)*Opm::pow(7.1 - pi_, I(i))*Opm::pow(tau_ - 1.222, J(i));
+            const int k = I(i) - minPiExp_;
+            const int j = J(i) - minTauExp_;
+            result += n(i)*piPow[k]*tauPow[j];
         }
 
         return result;
@@ -161,16 +165,15 @@ public:
     template <class Evaluation>
     static Evaluation dgamma_dtau(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauPow[numTauPowers_];
+        powerTables_(piPow, tauPow, temperature, pressure);
 
         Evaluation result = 0.0;
         for (int i = 0; i < 34; i++) {
-            result +=
-                n(i) *
-                Opm::pow(7.1 - pi_, static_cast<Scalar>(I(i))) *
-                Opm::pow(tau_ - 1.222,  static_cast<Scalar>(J(i)-1)) *
-                J(i);
+            const int k = I(i) - minPiExp_;
+            const int j = J(i) - minTauExp_;
+            result += n(i)*J(i)*piPow[k]*tauPow[j - 1];
         }
 
         return result;
@@ -190,16 +193,15 @@ public:
     template <class Evaluation>
     static Evaluation dgamma_dpi(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauPow[numTauPowers_];
+        powerTables_(piPow, tauPow, temperature, pressure);
 
         Evaluation result = 0.0;
         for (int i = 0; i < 34; i++) {
-            result +=
-                -n(i) *
-                I(i) *
-                Opm::pow(7.1 - pi_, static_cast<Scalar>(I(i) - 1)) *
-                Opm::pow(tau_ - 1.222, static_cast<Scalar>(J(i)));
+            const int k = I(i) - minPiExp_;
+            const int j = J(i) - minTauExp_;
+            result += -n(i)*I(i)*piPow[k - 1]*tauPow[j];
         }
 
         return result;
@@ -220,17 +222,15 @@ public:
     template <class Evaluation>
     static Evaluation ddgamma_dtaudpi(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauPow[numTauPowers_];
+        powerTables_(piPow, tauPow, temperature, pressure);
 
         Evaluation result = 0.0;
         for (int i = 0; i < 34; i++) {
-            result +=
-                -n(i) *
-                I(i) *
-                J(i) *
-                Opm::pow(7.1 - pi_, static_cast<Scalar>(I(i) - 1)) *
-                Opm::pow(tau_ - 1.222, static_cast<Scalar>(J(i) - 1));
+            const int k = I(i) - minPiExp_;
+            const int j = J(i) - minTauExp_;
+            result += -n(i)*I(i)*J(i)*piPow[k - 1]*tauPow[j - 1];
         }
 
         return result;
@@ -251,17 +251,15 @@ public:
     template <class Evaluation>
     static Evaluation ddgamma_ddpi(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauPow[numTauPowers_];
+        powerTables_(piPow, tauPow, temperature, pressure);
 
         Evaluation result = 0.0;
         for (int i = 0; i < 34; i++) {
-            result +=
-                n(i) *
-                I(i) *
-                (I(i) - 1) *
-                Opm::pow(7.1 - pi_, I(i) - 2) *
-                Opm::pow(tau_ - 1.222, J(i));
+            const int k = I(i) - minPiExp_;
+            const int j = J(i) - minTauExp_;
+            result += n(i)*(I(i)*(I(i) - 1))*piPow[k - 2]*tauPow[j];
         }
 
         return result;
@@ -281,23 +279,97 @@ public:
     template <class Evaluation>
     static Evaluation ddgamma_ddtau(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauPow[numTauPowers_];
+        powerTables_(piPow, tauPow, temperature, pressure);
 
         Evaluation result = 0.0;
         for (int i = 0; i < 34; i++) {
-            result +=
-                n(i) *
-                Opm::pow(7.1 - pi_, I(i)) *
-                J(i) *
-                (J(i) - 1) *
-                Opm::pow(tau_ - 1.222,  J(i) - 2);
+            const int k = I(i) - minPiExp_;
+            const int j = J(i) - minTauExp_;
+            result += n(i)*(J(i)*(J(i) - 1))*piPow[k]*tauPow[j - 2];
         }
 
         return result;
     }
 
+    /*!
+     * \brief Computes the Gibbs free energy (dimensionless) and all of its first and
+     *        second partial derivatives for IAPWS region 1 (i.e. liquid) in a single
+     *        pass.
+     *
+     * This is considerably cheaper than calling gamma(), dgamma_dtau(), dgamma_dpi(),
+     * ddgamma_dtaudpi(), ddgamma_ddpi() and ddgamma_ddtau() individually if several
+     * of these quantities are required for the same state.
+     *
+     * \param g The Gibbs free energy
+     * \param g_tau The partial derivative to the normalized temperature
+     * \param g_pi The partial derivative to the normalized pressure
+     * \param g_taupi The partial derivative to the normalized temperature and pressure
+     * \param g_pipi The second partial derivative to the normalized pressure
+     * \param g_tautau The second partial derivative to the normalized temperature
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    static void gammaAndDerivatives(Evaluation& g,
+                                    Evaluation& g_tau,
+                                    Evaluation& g_pi,
+                                    Evaluation& g_taupi,
+                                    Evaluation& g_pipi,
+                                    Evaluation& g_tautau,
+                                    const Evaluation& temperature,
+                                    const Evaluation& pressure)
+    {
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauPow[numTauPowers_];
+        powerTables_(piPow, tauPow, temperature, pressure);
+
+        g = 0.0;
+        g_tau = 0.0;
+        g_pi = 0.0;
+        g_taupi = 0.0;
+        g_pipi = 0.0;
+        g_tautau = 0.0;
+        for (int i = 0; i < 34; i++) {
+            const int k = I(i) - minPiExp_;
+            const int j = J(i) - minTauExp_;
+            const Evaluation& ni_pi = n(i)*piPow[k];
+            const Evaluation& ni_dpi = -n(i)*I(i)*piPow[k - 1];
+
+            g += ni_pi*tauPow[j];
+            g_tau += ni_pi*J(i)*tauPow[j - 1];
+            g_tautau += ni_pi*(J(i)*(J(i) - 1))*tauPow[j - 2];
+            g_pi += ni_dpi*tauPow[j];
+            g_taupi += ni_dpi*J(i)*tauPow[j - 1];
+            g_pipi += n(i)*(I(i)*(I(i) - 1))*piPow[k - 2]*tauPow[j];
+        }
+    }
+
 private:
+    // the range of exponents of the power tables, including the ones
+    // required for the derivatives
+    enum {
+        minPiExp_ = -2,
+        maxPiExp_ = 32,
+        numPiPowers_ = maxPiExp_ - minPiExp_ + 1,
+
+        minTauExp_ = -43,
+        maxTauExp_ = 17,
+        numTauPowers_ = maxTauExp_ - minTauExp_ + 1
+    };
+
+    // compute the integer powers of (7.1 - pi) and (tau - 1.222)
+    template <class Evaluation>
+    static void powerTables_(Evaluation* piPow,
+                             Evaluation* tauPow,
+                             const Evaluation& temperature,
+                             const Evaluation& pressure)
+    {
+        Common<Scalar>::integerPowers(piPow, Evaluation(7.1 - pi(pressure)), minPiExp_, maxPiExp_);
+        Common<Scalar>::integerPowers(tauPow, Evaluation(tau(temperature) - 1.222), minTauExp_, maxTauExp_);
+    }
+
     static Scalar n(int i)
     {
         static const Scalar n[34] = {
@@ -317,7 +389,7 @@ private:
         return n[i];
     }
 
-    static Scalar I(int i)
+    static int I(int i)
     {
         static const short int I[34] = {
             0, 0, 0,
@@ -336,7 +408,7 @@ private:
         return I[i];
     }
 
-    static Scalar J(int i)
+    static int J(int i)
     {
         static const short int J[34] = {
              -2, -1, 0,
@@ -27,6 +27,7 @@
 #ifndef OPM_IAPWS_REGION2_HPP
 #define OPM_IAPWS_REGION2_HPP
 
+#include <opm/material/components/iapws/Common.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 
 #include <cmath>
@@ -135,22 +136,24 @@ public:
     template <class Evaluation>
     static Evaluation gamma(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation& tau_ = tau(temperature); /* reduced temperature */
-        const Evaluation& pi_ = pi(pressure);      /* reduced pressure */
+        Evaluation tauPow[numTauPowers_];
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauResPow[numTauResPowers_];
+        powerTables_(tauPow, piPow, tauResPow, temperature, pressure);
 
         Evaluation result;
 
         // ideal gas part
-        result = Opm::log(pi_);
+        result = Opm::log(pi(pressure));
         for (int i = 0; i < 9; ++i)
-            result += n_g(i)*Opm::pow(tau_, J_g(i));
+            result += n_g(i)*tauPow[J_g(i) - minTauExp_];
 
         // residual part
-        for (int i = 0; i < 43; ++i)
-            result +=
-                n_r(i)*
-                Opm::pow(pi_, I_r(i))*
-                Opm::pow(tau_ - 0.5, J_r(i));
+        for (int i = 0; i < 43; ++i) {
+            const int k = I_r(i) - minPiExp_;
+            const int j = J_r(i) - minTauResExp_;
+            result += n_r(i)*piPow[k]*tauResPow[j];
+        }
         return result;
     }
 
@@ -169,25 +172,21 @@ public:
     template <class Evaluation>
     static Evaluation dgamma_dtau(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation& tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation& pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation tauPow[numTauPowers_];
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauResPow[numTauResPowers_];
+        powerTables_(tauPow, piPow, tauResPow, temperature, pressure);
 
         // ideal gas part
         Evaluation result = 0.0;
-        for (int i = 0; i < 9; i++) {
-            result +=
-                n_g(i) *
-                J_g(i) *
-                Opm::pow(tau_, static_cast<Scalar>(J_g(i) - 1));
-        }
+        for (int i = 0; i < 9; i++)
+            result += n_g(i)*J_g(i)*tauPow[J_g(i) - minTauExp_ - 1];
 
         // residual part
         for (int i = 0; i < 43; i++) {
-            result +=
-                n_r(i) *
-                Opm::pow(pi_,  static_cast<Scalar>(I_r(i))) *
-                J_r(i) *
-                Opm::pow(tau_ - 0.5, static_cast<Scalar>(J_r(i) - 1));
+            const int k = I_r(i) - minPiExp_;
+            const int j = J_r(i) - minTauResExp_;
+            result += n_r(i)*J_r(i)*piPow[k]*tauResPow[j - 1];
         }
 
         return result;
@@ -208,19 +207,19 @@ public:
     template <class Evaluation>
     static Evaluation dgamma_dpi(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation& tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation& pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation tauPow[numTauPowers_];
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauResPow[numTauResPowers_];
+        powerTables_(tauPow, piPow, tauResPow, temperature, pressure);
 
         // ideal gas part
-        Evaluation result = 1/pi_;
+        Evaluation result = piPow[-1 - minPiExp_];
 
         // residual part
         for (int i = 0; i < 43; i++) {
-            result +=
-                n_r(i) *
-                I_r(i) *
-                Opm::pow(pi_, static_cast<Scalar>(I_r(i) - 1)) *
-                Opm::pow(tau_ - 0.5, static_cast<Scalar>(J_r(i)));
+            const int k = I_r(i) - minPiExp_;
+            const int j = J_r(i) - minTauResExp_;
+            result += n_r(i)*I_r(i)*piPow[k - 1]*tauResPow[j];
         }
 
         return result;
@@ -241,20 +240,19 @@ public:
     template <class Evaluation>
     static Evaluation ddgamma_dtaudpi(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation& tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation& pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation tauPow[numTauPowers_];
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauResPow[numTauResPowers_];
+        powerTables_(tauPow, piPow, tauResPow, temperature, pressure);
 
         // ideal gas part
         Evaluation result = 0.0;
 
         // residual part
         for (int i = 0; i < 43; i++) {
-            result +=
-                n_r(i) *
-                I_r(i) *
-                J_r(i) *
-                Opm::pow(pi_, static_cast<Scalar>(I_r(i) - 1)) *
-                Opm::pow(tau_ - 0.5, static_cast<Scalar>(J_r(i) - 1));
+            const int k = I_r(i) - minPiExp_;
+            const int j = J_r(i) - minTauResExp_;
+            result += n_r(i)*(I_r(i)*J_r(i))*piPow[k - 1]*tauResPow[j - 1];
         }
 
         return result;
@@ -275,20 +273,20 @@ public:
     template <class Evaluation>
     static Evaluation ddgamma_ddpi(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation& tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation& pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation tauPow[numTauPowers_];
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauResPow[numTauResPowers_];
+        powerTables_(tauPow, piPow, tauResPow, temperature, pressure);
 
         // ideal gas part
-        Evaluation result = -1/(pi_*pi_);
+        const Evaluation& piInv = piPow[-1 - minPiExp_];
+        Evaluation result = -piInv*piInv;
 
         // residual part
         for (int i = 0; i < 43; i++) {
-            result +=
-                n_r(i) *
-                I_r(i) *
-                (I_r(i) - 1) *
-                Opm::pow(pi_, static_cast<Scalar>(I_r(i) - 2)) *
-                Opm::pow(tau_ - 0.5, static_cast<Scalar>(J_r(i)));
+            const int k = I_r(i) - minPiExp_;
+            const int j = J_r(i) - minTauResExp_;
+            result += n_r(i)*(I_r(i)*(I_r(i) - 1))*piPow[k - 2]*tauResPow[j];
         }
 
         return result;
@@ -309,34 +307,124 @@ public:
     template <class Evaluation>
     static Evaluation ddgamma_ddtau(const Evaluation& temperature, const Evaluation& pressure)
     {
-        const Evaluation& tau_ = tau(temperature);   /* reduced temperature */
-        const Evaluation& pi_ = pi(pressure);    /* reduced pressure */
+        Evaluation tauPow[numTauPowers_];
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauResPow[numTauResPowers_];
+        powerTables_(tauPow, piPow, tauResPow, temperature, pressure);
 
         // ideal gas part
         Evaluation result = 0.0;
-        for (int i = 0; i < 9; i++) {
-            result +=
-                n_g(i) *
-                J_g(i) *
-                (J_g(i) - 1) *
-                Opm::pow(tau_, static_cast<Scalar>(J_g(i) - 2));
-        }
+        for (int i = 0; i < 9; i++)
+            result += n_g(i)*(J_g(i)*(J_g(i) - 1))*tauPow[J_g(i) - minTauExp_ - 2];
 
         // residual part
         for (int i = 0; i < 43; i++) {
-            result +=
-                n_r(i) *
-                Opm::pow(pi_,  I_r(i)) *
-                J_r(i) *
-                (J_r(i) - 1.) *
-                Opm::pow(tau_ - 0.5, static_cast<Scalar>(J_r(i) - 2));
+            const int k = I_r(i) - minPiExp_;
+            const int j = J_r(i) - minTauResExp_;
+            result += n_r(i)*(J_r(i)*(J_r(i) - 1))*piPow[k]*tauResPow[j - 2];
         }
 
         return result;
     }
 
+    /*!
+     * \brief Computes the Gibbs free energy (dimensionless) and all of its first and
+     *        second partial derivatives for IAPWS region 2 (i.e. sub-critical steam)
+     *        in a single pass.
+     *
+     * This is considerably cheaper than calling gamma(), dgamma_dtau(), dgamma_dpi(),
+     * ddgamma_dtaudpi(), ddgamma_ddpi() and ddgamma_ddtau() individually if several
+     * of these quantities are required for the same state.
+     *
+     * \param g The Gibbs free energy
+     * \param g_tau The partial derivative to the normalized temperature
+     * \param g_pi The partial derivative to the normalized pressure
+     * \param g_taupi The partial derivative to the normalized temperature and pressure
+     * \param g_pipi The second partial derivative to the normalized pressure
+     * \param g_tautau The second partial derivative to the normalized temperature
+     * \param temperature temperature of component in \f$\mathrm{[K]}\f$
+     * \param pressure pressure of component in \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    static void gammaAndDerivatives(Evaluation& g,
+                                    Evaluation& g_tau,
+                                    Evaluation& g_pi,
+                                    Evaluation& g_taupi,
+                                    Evaluation& g_pipi,
+                                    Evaluation& g_tautau,
+                                    const Evaluation& temperature,
+                                    const Evaluation& pressure)
+    {
+        Evaluation tauPow[numTauPowers_];
+        Evaluation piPow[numPiPowers_];
+        Evaluation tauResPow[numTauResPowers_];
+        powerTables_(tauPow, piPow, tauResPow, temperature, pressure);
+
+        // ideal gas part
+        const Evaluation& piInv = piPow[-1 - minPiExp_];
+        g = Opm::log(pi(pressure));
+        g_tau = 0.0;
+        g_pi = piInv;
+        g_taupi = 0.0;
+        g_pipi = -piInv*piInv;
+        g_tautau = 0.0;
+        for (int i = 0; i < 9; i++) {
+            const int j = J_g(i) - minTauExp_;
+            g += n_g(i)*tauPow[j];
+            g_tau += n_g(i)*J_g(i)*tauPow[j - 1];
+            g_tautau += n_g(i)*(J_g(i)*(J_g(i) - 1))*tauPow[j - 2];
+        }
+
+        // residual part
+        for (int i = 0; i < 43; i++) {
+            const int k = I_r(i) - minPiExp_;
+            const int j = J_r(i) - minTauResExp_;
+            const Evaluation& ni_pi = n_r(i)*piPow[k];
+            const Evaluation& ni_dpi = n_r(i)*I_r(i)*piPow[k - 1];
+
+            g += ni_pi*tauResPow[j];
+            g_tau += ni_pi*J_r(i)*tauResPow[j - 1];
+            g_tautau += ni_pi*(J_r(i)*(J_r(i) - 1))*tauResPow[j - 2];
+            g_pi += ni_dpi*tauResPow[j];
+            g_taupi += ni_dpi*J_r(i)*tauResPow[j - 1];
+            g_pipi += n_r(i)*(I_r(i)*(I_r(i) - 1))*piPow[k - 2]*tauResPow[j];
+        }
+    }
 
 private:
+    // the range of exponents of the power tables, including the ones
+    // required for the derivatives
+    enum {
+        // tau for the ideal gas part
+        minTauExp_ = -7,
+        maxTauExp_ = 3,
+        numTauPowers_ = maxTauExp_ - minTauExp_ + 1,
+
+        // pi for the residual part
+        minPiExp_ = -1,
+        maxPiExp_ = 24,
+        numPiPowers_ = maxPiExp_ - minPiExp_ + 1,
+
+        // (tau - 0.5) for the residual part
+        minTauResExp_ = -2,
+        maxTauResExp_ = 58,
+        numTauResPowers_ = maxTauResExp_ - minTauResExp_ + 1
+    };
+
+    // compute the integer powers of tau, pi and (tau - 0.5)
+    template <class Evaluation>
+    static void powerTables_(Evaluation* tauPow,
+                             Evaluation* piPow,
+                             Evaluation* tauResPow,
+                             const Evaluation& temperature,
+                             const Evaluation& pressure)
+    {
+        const Evaluation& tau_ = tau(temperature);
+        Common<Scalar>::integerPowers(tauPow, tau_, minTauExp_, maxTauExp_);
+        Common<Scalar>::integerPowers(piPow, pi(pressure), minPiExp_, maxPiExp_);
+        Common<Scalar>::integerPowers(tauResPow, Evaluation(tau_ - 0.5), minTauResExp_, maxTauResExp_);
+    }
+
     static Scalar n_g(int i)
     {
         static const Scalar n[9] = {
@@ -369,7 +457,7 @@ private:
         return n[i];
     }
 
-    static Scalar I_r(int i)
+    static int I_r(int i)
     {
         static const short int I[43] = {
             1, 1, 1,
@@ -391,7 +479,7 @@ private:
         return I[i];
     }
 
-    static Scalar J_g(int i)
+    static int J_g(int i)
     {
         static const short int J[9] = {
             0, 1, -5,
@@ -401,7 +489,7 @@ private:
         return J[i];
     }
 
-    static Scalar J_r(int i)
+    static int J_r(int i)
     {
         static const short int J[43] = {
             0, 1, 2,
@@ -27,7 +27,10 @@
 #ifndef OPM_COMPOSITION_FROM_FUGACITIES_HPP
 #define OPM_COMPOSITION_FROM_FUGACITIES_HPP
 
+#include <opm/material/fluidstates/CompositionalFluidState.hpp>
+#include <opm/material/common/FixedSizeLu.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Tracing.hpp>
 
 
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
@@ -43,6 +46,7 @@
 #include <opm/common/Valgrind.hpp>
 
 #include <limits>
+#include <type_traits>
 
 namespace Opm {
 
@@ -55,6 +59,11 @@ class CompositionFromFugacities
 {
     enum { numComponents = FluidSystem::numComponents };
 
+    // the solvers for other evaluation types are used to solve the problem using
+    // plain scalars
+    template <class OtherScalar, class OtherFluidSystem, class OtherEvaluation>
+    friend class CompositionFromFugacities;
+
 public:
     typedef Dune::FieldVector<Evaluation, numComponents> ComponentVector;
 
@@ -90,6 +99,8 @@ public:
                       unsigned phaseIdx,
                       const ComponentVector& targetFug)
     {
+        OPM_MATERIAL_TRACE_SCOPE("CompositionFromFugacities::solve");
+
         // use a much more efficient method in case the phase is an
         // ideal mixture
         if (FluidSystem::isIdealMixture(phaseIdx)) {
@@ -138,10 +149,10 @@ public:
             */
 
             // Solve J*x = b
-            x = 0.0;
-            try { J.solve(x, b); }
-            catch (Dune::FMatrixError e)
-            { throw Opm::NumericalProblem(e.what()); }
+            if (!fixedSizeLuSolve(x, J, b))
+                OPM_THROW(Opm::NumericalProblem,
+                          "Singular Jacobian matrix for the " << FluidSystem::phaseName(phaseIdx)
+                          << "Phase composition");
 
             //std::cout << "original delta: " << x << "\n";
 
@@ -183,8 +194,127 @@ public:
                   << ", T = " << fluidState.temperature(phaseIdx));
     }
 
+    /*!
+     * \brief Calculates the chemical equilibrium from the component fugacities in a
+     *        phase and obtains the derivatives of the composition using the implicit
+     *        function theorem.
+     *
+     * Instead of running the Newton method using function evaluations, the
+     * composition is determined using plain scalars. The derivatives of the mole
+     * fractions x with regard to the input quantities z (i.e., the target fugacities,
+     * the pressure and the temperature) are then calculated using the Jacobian matrix
+     * of the converged solution, i.e., \f$dx/dz = - J^{-1} \partial F/\partial z\f$.
+     */
+    template <class FluidState>
+    static void solveWithImplicitDerivatives(FluidState& fluidState,
+                                             typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                             unsigned phaseIdx,
+                                             const ComponentVector& targetFug)
+    {
+        solveWithImplicitDerivatives_(fluidState,
+                                      paramCache,
+                                      phaseIdx,
+                                      targetFug,
+                                      std::is_same<Evaluation, Scalar>());
+    }
+
 
 protected:
+    template <class FluidState>
+    static void solveWithImplicitDerivatives_(FluidState& fluidState,
+                                              typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                              unsigned phaseIdx,
+                                              const ComponentVector& targetFug,
+                                              std::true_type /*isScalar*/)
+    { solve(fluidState, paramCache, phaseIdx, targetFug); }
+
+    template <class FluidState>
+    static void solveWithImplicitDerivatives_(FluidState& fluidState,
+                                              typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                              unsigned phaseIdx,
+                                              const ComponentVector& targetFug,
+                                              std::false_type /*isScalar*/)
+    {
+        typedef Opm::CompositionFromFugacities<Scalar, FluidSystem, Scalar> ScalarSolver;
+        typedef Opm::CompositionalFluidState<Scalar, FluidSystem, /*energy=*/false> ScalarFluidState;
+        static const int numInputDerivs = Evaluation::size;
+
+        OPM_MATERIAL_TRACE_SCOPE("CompositionFromFugacities::solveWithImplicitDerivatives");
+
+        // the composition of ideal mixtures is calculated directly
+        if (FluidSystem::isIdealMixture(phaseIdx)) {
+            solveIdealMix_(fluidState, paramCache, phaseIdx, targetFug);
+            return;
+        }
+
+        // determine the composition using plain scalars
+        ScalarFluidState scalarFluidState;
+        scalarFluidState.assign(fluidState);
+
+        typename FluidSystem::template ParameterCache<Scalar> scalarParamCache;
+        scalarParamCache.assignPersistentData(paramCache);
+
+        typename ScalarSolver::ComponentVector scalarTargetFug;
+        for (unsigned i = 0; i < numComponents; ++i)
+            scalarTargetFug[i] = Opm::scalarValue(targetFug[i]);
+
+        ScalarSolver::solve(scalarFluidState, scalarParamCache, phaseIdx, scalarTargetFug);
+
+        // linearize the system of equations at the solution
+        Dune::FieldMatrix<Scalar, numComponents, numComponents> J;
+        Dune::FieldVector<Scalar, numComponents> scalarDefect;
+        ScalarSolver::linearize_(J, scalarDefect, scalarFluidState, scalarParamCache, phaseIdx, scalarTargetFug);
+
+        // evaluate the defect at the solution while keeping the composition constant
+        // to get its partial derivatives with regard to the input quantities
+        ComponentVector x;
+        for (unsigned i = 0; i < numComponents; ++i)
+            x[i] = scalarFluidState.moleFraction(phaseIdx, i);
+        fluidState.setMoleFractions(phaseIdx, x);
+        paramCache.updatePhase(fluidState, phaseIdx);
+
+        ComponentVector defect;
+        for (unsigned i = 0; i < numComponents; ++i) {
+            const Evaluation& phi = FluidSystem::fugacityCoefficient(fluidState,
+                                                                     paramCache,
+                                                                     phaseIdx,
+                                                                     i);
+            defect[i] = targetFug[i] - phi*fluidState.pressure(phaseIdx)*x[i];
+        }
+
+        // dx/dz = - J^-1 dF/dz
+        FixedSizeLu<Scalar, numComponents> luJ;
+        if (!luJ.factorize(J))
+            OPM_THROW(Opm::NumericalProblem,
+                      "Singular Jacobian matrix for the " << FluidSystem::phaseName(phaseIdx)
+                      << "Phase composition");
+
+        Dune::FieldVector<Scalar, numComponents> dFdz;
+        Dune::FieldVector<Scalar, numComponents> dxdz;
+        for (int derivIdx = 0; derivIdx < numInputDerivs; ++ derivIdx) {
+            for (unsigned i = 0; i < numComponents; ++i)
+                dFdz[i] = defect[i].derivative(derivIdx);
+
+            luJ.solve(dxdz, dFdz);
+            for (unsigned i = 0; i < numComponents; ++i)
+                x[i].setDerivative(derivIdx, -dxdz[i]);
+        }
+
+        fluidState.setMoleFractions(phaseIdx, x);
+        paramCache.updateComposition(fluidState, phaseIdx);
+
+        for (unsigned i = 0; i < numComponents; ++i) {
+            const Evaluation& phi = FluidSystem::fugacityCoefficient(fluidState,
+                                                                     paramCache,
+                                                                     phaseIdx,
+                                                                     i);
+            fluidState.setFugacityCoefficient(phaseIdx, i, phi);
+        }
+
+        const Evaluation& rho = FluidSystem::density(fluidState, paramCache, phaseIdx);
+        fluidState.setDensity(phaseIdx, rho);
+    }
+
     // update the phase composition in case the phase is an ideal
     // mixture, i.e. the component's fugacity coefficients are
     // independent of the phase's composition.
@@ -194,6 +324,7 @@ protected:
                                unsigned phaseIdx,
                                const ComponentVector& fugacities)
     {
+        ComponentVector x;
         for (unsigned i = 0; i < numComponents; ++ i) {
             const Evaluation& phi = FluidSystem::fugacityCoefficient(fluidState,
                                                                      paramCache,
@@ -204,8 +335,9 @@ protected:
             Valgrind::CheckDefined(gamma);
             Valgrind::CheckDefined(fugacities[i]);
             fluidState.setFugacityCoefficient(phaseIdx, i, phi);
-            fluidState.setMoleFraction(phaseIdx, i, fugacities[i]/gamma);
+            x[i] = fugacities[i]/gamma;
         };
+        fluidState.setMoleFractions(phaseIdx, x);
 
         paramCache.updatePhase(fluidState, phaseIdx);
 
@@ -240,6 +372,25 @@ protected:
             absError = std::max(absError, std::abs(Opm::scalarValue(defect[i])));
         }
 
+        // use the closed form derivatives of the fugacity coefficients if the fluid
+        // system provides them: since f_j = phi_j p x_j, the derivative of the defect
+        // is -p phi_j (delta_jk + x_j dln(phi_j)/dx_k)
+        Dune::FieldMatrix<Evaluation, numComponents, numComponents> dLnPhi;
+        if (FluidSystem::hasAnalyticFugacityDerivatives(phaseIdx)
+            && FluidSystem::lnFugacityCoefficientDerivatives(dLnPhi, fluidState, paramCache, phaseIdx))
+        {
+            const Evaluation& p = fluidState.pressure(phaseIdx);
+            for (unsigned j = 0; j < numComponents; ++j) {
+                const Evaluation& pPhi = p*fluidState.fugacityCoefficient(phaseIdx, j);
+                const Evaluation& xj = fluidState.moleFraction(phaseIdx, j);
+                for (unsigned k = 0; k < numComponents; ++k)
+                    J[j][k] = - pPhi*xj*dLnPhi[j][k];
+                J[j][j] -= pPhi;
+            }
+
+            return absError;
+        }
+
         // assemble jacobian matrix of the constraints for the composition
         static const Scalar eps = std::numeric_limits<Scalar>::epsilon()*1e6;
         for (unsigned i = 0; i < numComponents; ++ i) {
@@ -313,8 +464,10 @@ protected:
             x /= (sumDelta/maxDelta);
 
         // change composition
+        Dune::FieldVector<Evaluation, numComponents> newComp;
         for (unsigned i = 0; i < numComponents; ++i) {
-            Evaluation newx = origComp[i] - x[i];
+            Evaluation& newx = newComp[i];
+            newx = origComp[i] - x[i];
             // only allow negative mole fractions if the target fugacity is negative
             if (targetFug[i] > 0)
                 newx = Opm::max(0.0, newx);
@@ -324,9 +477,8 @@ protected:
             // if the target fugacity is zero, the mole fraction must also be zero
             else
                 newx = 0;
-
-            fluidState.setMoleFraction(phaseIdx, i, newx);
         }
+        fluidState.setMoleFractions(phaseIdx, newComp);
 
         paramCache.updateComposition(fluidState, phaseIdx);
 
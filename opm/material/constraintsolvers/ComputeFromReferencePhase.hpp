@@ -28,6 +28,7 @@
 #define OPM_COMPUTE_FROM_REFERENCE_PHASE_HPP
 
 #include <opm/material/constraintsolvers/CompositionFromFugacities.hpp>
+#include <opm/material/common/Tracing.hpp>
 
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
@@ -35,6 +36,10 @@
 
 #include <dune/common/fvector.hh>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm {
 
 /*!
@@ -112,6 +117,8 @@ public:
                       bool setViscosity,
                       bool setEnthalpy)
     {
+        OPM_MATERIAL_TRACE_SCOPE("ComputeFromReferencePhase::solve");
+
         // compute the density and enthalpy of the
         // reference phase
         paramCache.updatePhase(fluidState, refPhaseIdx);
@@ -168,6 +175,149 @@ public:
                                                              phaseIdx));
         }
     }
+
+    /*!
+     * \brief Computes all quantities for a contiguous array of fluid states.
+     *
+     * Each fluid state must satisfy the same preconditions as for solve(). The cells
+     * are split into one contiguous block per thread if OpenMP is enabled. Within a
+     * block, a cell whose reference phase state (temperature, phase pressures and
+     * reference phase composition) is identical to the previous one gets the results
+     * of that cell copied instead of being solved again. This is the common case for
+     * the cells of a row at the same depth during hydrostatic equilibration. Otherwise
+     * the compositions of the non-reference phases of the previous cell are used as
+     * the initial guess.
+     *
+     * If the calculation of a cell fails, the cell's entry in 'failedCells' is set to
+     * true (if 'failedCells' is not a null pointer) and the remaining cells are still
+     * processed. The parameter caches of all cells are updated.
+     *
+     * \return The number of cells for which the calculation failed.
+     */
+    template <class FluidState>
+    static unsigned solveMany(FluidState* fluidStates,
+                              typename FluidSystem::template ParameterCache<typename FluidState::Scalar>* paramCaches,
+                              unsigned numCells,
+                              unsigned refPhaseIdx,
+                              bool setViscosity,
+                              bool setEnthalpy,
+                              bool* failedCells = nullptr)
+    {
+        unsigned numFailed = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:numFailed)
+        {
+            unsigned threadIdx = static_cast<unsigned>(omp_get_thread_num());
+            unsigned numThreads = static_cast<unsigned>(omp_get_num_threads());
+            unsigned blockBeginIdx = static_cast<unsigned>((size_t(numCells)*threadIdx)/numThreads);
+            unsigned blockEndIdx = static_cast<unsigned>((size_t(numCells)*(threadIdx + 1))/numThreads);
+
+            numFailed += solveBlock_(fluidStates, paramCaches, blockBeginIdx, blockEndIdx,
+                                     refPhaseIdx, setViscosity, setEnthalpy, failedCells);
+        }
+#else
+        numFailed = solveBlock_(fluidStates, paramCaches, 0, numCells,
+                                refPhaseIdx, setViscosity, setEnthalpy, failedCells);
+#endif
+
+        return numFailed;
+    }
+
+private:
+    template <class FluidState>
+    static unsigned solveBlock_(FluidState* fluidStates,
+                                typename FluidSystem::template ParameterCache<typename FluidState::Scalar>* paramCaches,
+                                unsigned beginIdx,
+                                unsigned endIdx,
+                                unsigned refPhaseIdx,
+                                bool setViscosity,
+                                bool setEnthalpy,
+                                bool* failedCells)
+    {
+        unsigned numFailed = 0;
+        // the last cell of the block which was solved successfully
+        int lastIdx = -1;
+        for (unsigned cellIdx = beginIdx; cellIdx < endIdx; ++cellIdx) {
+            FluidState& fluidState = fluidStates[cellIdx];
+
+            if (lastIdx >= 0) {
+                const FluidState& lastFluidState = fluidStates[lastIdx];
+                if (hasSameReferenceState_(fluidState, lastFluidState, refPhaseIdx)) {
+                    copyResults_(fluidState, lastFluidState, setViscosity, setEnthalpy);
+                    paramCaches[cellIdx] = paramCaches[lastIdx];
+                    if (failedCells)
+                        failedCells[cellIdx] = false;
+                    continue;
+                }
+
+                // use the result of the previous cell as the initial guess
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                    if (phaseIdx == refPhaseIdx)
+                        continue;
+
+                    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                        fluidState.setMoleFraction(phaseIdx, compIdx,
+                                                   lastFluidState.moleFraction(phaseIdx, compIdx));
+                }
+            }
+
+            bool failed = false;
+            try {
+                solve(fluidState, paramCaches[cellIdx], refPhaseIdx, setViscosity, setEnthalpy);
+            }
+            catch (const Opm::NumericalProblem&) {
+                failed = true;
+            }
+
+            if (failed)
+                ++numFailed;
+            else
+                lastIdx = static_cast<int>(cellIdx);
+
+            if (failedCells)
+                failedCells[cellIdx] = failed;
+        }
+
+        return numFailed;
+    }
+
+    template <class FluidState>
+    static bool hasSameReferenceState_(const FluidState& fs1,
+                                       const FluidState& fs2,
+                                       unsigned refPhaseIdx)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (fs1.temperature(phaseIdx) != fs2.temperature(phaseIdx)
+                || fs1.pressure(phaseIdx) != fs2.pressure(phaseIdx))
+                return false;
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            if (fs1.moleFraction(refPhaseIdx, compIdx) != fs2.moleFraction(refPhaseIdx, compIdx))
+                return false;
+
+        return true;
+    }
+
+    template <class FluidState>
+    static void copyResults_(FluidState& dst,
+                             const FluidState& src,
+                             bool setViscosity,
+                             bool setEnthalpy)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                dst.setMoleFraction(phaseIdx, compIdx, src.moleFraction(phaseIdx, compIdx));
+                dst.setFugacityCoefficient(phaseIdx, compIdx, src.fugacityCoefficient(phaseIdx, compIdx));
+            }
+            dst.setDensity(phaseIdx, src.density(phaseIdx));
+
+            if (setViscosity)
+                dst.setViscosity(phaseIdx, src.viscosity(phaseIdx));
+            if (setEnthalpy)
+                dst.setEnthalpy(phaseIdx, src.enthalpy(phaseIdx));
+        }
+    }
 };
 
 } // namespace Opm
@@ -0,0 +1,214 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::FlashCache
+ */
+#ifndef OPM_FLASH_CACHE_HPP
+#define OPM_FLASH_CACHE_HPP
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fvector.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <unordered_map>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+
+namespace Opm {
+
+/*!
+ * \brief Stores the results of previous flash calculations.
+ *
+ * The results are put onto a hashed grid in the space spanned by the logarithm of
+ * the pressure, the temperature and the overall mole fractions. The size of the grid
+ * cells is given by the tolerances. A lookup only considers the entries which are
+ * located in the same grid cell as the queried state, and an entry is only returned
+ * if it is within the tolerances. If the maximum number of entries is reached, the
+ * cache is cleared.
+ *
+ * The objects are not thread-safe, i.e., each thread should use its own cache.
+ */
+template <class Scalar, int numComponents>
+class FlashCache
+{
+public:
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+
+    //! The result of a flash calculation
+    struct Entry
+    {
+        Scalar pressure;
+        Scalar temperature;
+        ComponentVector moleFractions;
+
+        //! The natural logarithms of the equilibrium ratios
+        ComponentVector lnK;
+
+        //! The fraction of the moles in the gas phase. 0 and 1 mean single-phase.
+        Scalar vaporFraction;
+
+        bool isTwoPhase() const
+        { return vaporFraction > 0.0 && vaporFraction < 1.0; }
+    };
+
+    /*!
+     * \brief Create an empty cache.
+     *
+     * 'pressureTolerance' is relative, the other two tolerances are absolute. If
+     * 'directLookup' is true, the equilibrium ratios of cached two-phase results are
+     * used to split the phases without any further iterations. Else they are only
+     * used as the initial guess.
+     */
+    FlashCache(Scalar pressureTolerance = 1e-3,
+               Scalar temperatureTolerance = 0.1,
+               Scalar moleFractionTolerance = 1e-3,
+               bool directLookup = false,
+               size_t maxEntries = 100000)
+        : pressureTolerance_(pressureTolerance)
+        , temperatureTolerance_(temperatureTolerance)
+        , moleFractionTolerance_(moleFractionTolerance)
+        , directLookup_(directLookup)
+        , maxEntries_(maxEntries)
+        , numHits_(0)
+        , numMisses_(0)
+    {}
+
+    /*!
+     * \brief Returns true if cached two-phase results are used without iterating.
+     */
+    bool directLookup() const
+    { return directLookup_; }
+
+    /*!
+     * \brief Returns a cached result which is close to the given state.
+     *
+     * If there is none, nullptr is returned. The number of hits or misses is
+     * incremented accordingly.
+     */
+    const Entry* lookup(Scalar p, Scalar T, const ComponentVector& z)
+    {
+        auto it = cells_.find(cellHash_(p, T, z));
+        if (it != cells_.end()) {
+            for (unsigned entryIdx : it->second) {
+                const Entry& entry = entries_[entryIdx];
+                if (isClose_(entry, p, T, z)) {
+                    ++numHits_;
+                    return &entry;
+                }
+            }
+        }
+
+        ++numMisses_;
+        return nullptr;
+    }
+
+    /*!
+     * \brief Add the result of a flash calculation.
+     */
+    void insert(Scalar p, Scalar T, const ComponentVector& z, const ComponentVector& lnK, Scalar vaporFraction)
+    {
+        if (entries_.size() >= maxEntries_) {
+            entries_.clear();
+            cells_.clear();
+        }
+
+        Entry entry;
+        entry.pressure = p;
+        entry.temperature = T;
+        entry.moleFractions = z;
+        entry.lnK = lnK;
+        entry.vaporFraction = vaporFraction;
+
+        cells_[cellHash_(p, T, z)].push_back(static_cast<unsigned>(entries_.size()));
+        entries_.push_back(entry);
+    }
+
+    /*!
+     * \brief Remove all entries. The hit and miss counters are not reset.
+     */
+    void clear()
+    {
+        entries_.clear();
+        cells_.clear();
+    }
+
+    /*!
+     * \brief The number of entries in the cache.
+     */
+    size_t size() const
+    { return entries_.size(); }
+
+    /*!
+     * \brief The number of lookups which returned a cached result.
+     */
+    size_t numHits() const
+    { return numHits_; }
+
+    /*!
+     * \brief The number of lookups which did not find a cached result.
+     */
+    size_t numMisses() const
+    { return numMisses_; }
+
+private:
+    size_t cellHash_(Scalar p, Scalar T, const ComponentVector& z) const
+    {
+        std::hash<long> longHash;
+        size_t hash = longHash(static_cast<long>(std::floor(std::log(p)/pressureTolerance_)));
+        hash = hash*31 + longHash(static_cast<long>(std::floor(T/temperatureTolerance_)));
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            hash = hash*31 + longHash(static_cast<long>(std::floor(z[compIdx]/moleFractionTolerance_)));
+        return hash;
+    }
+
+    bool isClose_(const Entry& entry, Scalar p, Scalar T, const ComponentVector& z) const
+    {
+        if (std::abs(std::log(p/entry.pressure)) > pressureTolerance_)
+            return false;
+        if (std::abs(T - entry.temperature) > temperatureTolerance_)
+            return false;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            if (std::abs(z[compIdx] - entry.moleFractions[compIdx]) > moleFractionTolerance_)
+                return false;
+        return true;
+    }
+
+    Scalar pressureTolerance_;
+    Scalar temperatureTolerance_;
+    Scalar moleFractionTolerance_;
+    bool directLookup_;
+    size_t maxEntries_;
+
+    std::vector<Entry> entries_;
+    std::unordered_map<size_t, std::vector<unsigned> > cells_;
+
+    size_t numHits_;
+    size_t numMisses_;
+};
+
+} // namespace Opm
+
+#endif
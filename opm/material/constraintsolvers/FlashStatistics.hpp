@@ -0,0 +1,64 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::FlashStatistics
+ */
+#ifndef OPM_FLASH_STATISTICS_HPP
+#define OPM_FLASH_STATISTICS_HPP
+
+namespace Opm {
+
+/*!
+ * \brief Describes how a flash calculation went.
+ *
+ * This is filled by the solve() methods of the flash solvers which take a statistics
+ * object. In contrast to the methods without it, they do not throw if the Newton
+ * method fails.
+ */
+template <class Scalar>
+struct FlashStatistics
+{
+    FlashStatistics()
+        : numIterations(0)
+        , relativeError(0.0)
+        , linearSolverFailed(false)
+        , converged(false)
+    {}
+
+    //! The number of Newton iterations which were carried out
+    unsigned numIterations;
+
+    //! The weighted maximum of the last Newton update, i.e., the convergence criterion
+    Scalar relativeError;
+
+    //! True if the Newton method was aborted because the Jacobian matrix was singular
+    bool linearSolverFailed;
+
+    //! True if the flash calculation has converged
+    bool converged;
+};
+
+} // namespace Opm
+
+#endif
@@ -27,10 +27,14 @@
 #ifndef OPM_IMMISCIBLE_FLASH_HPP
 #define OPM_IMMISCIBLE_FLASH_HPP
 
+#include <opm/material/constraintsolvers/FlashStatistics.hpp>
 #include <opm/material/fluidstates/ImmiscibleFluidState.hpp>
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/material/densead/Math.hpp>
+#include <opm/material/common/ErrorStatus.hpp>
+#include <opm/material/common/FixedSizeLu.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Tracing.hpp>
 #include <opm/common/Valgrind.hpp>
 
 #include <opm/common/ErrorMacros.hpp>
@@ -39,11 +43,28 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <array>
 #include <limits>
 #include <iostream>
+#include <type_traits>
 
 namespace Opm {
 
+namespace ImmiscibleFlashDetail {
+// material laws which specify 'hasZeroCapillaryPressure = true' always yield zero
+// capillary pressures, i.e., all phases exhibit the same pressure
+template <class MaterialLaw, class = void>
+struct HasZeroCapillaryPressure
+    : public std::false_type
+{};
+
+template <class MaterialLaw>
+struct HasZeroCapillaryPressure<MaterialLaw,
+                                typename std::enable_if<MaterialLaw::hasZeroCapillaryPressure>::type>
+    : public std::true_type
+{};
+} // namespace ImmiscibleFlashDetail
+
 /*!
  * \brief Determines the pressures and saturations of all fluid phases
  *        given the total mass of all components.
@@ -69,6 +90,14 @@ namespace Opm {
  * by this, though. In this case the original pressure is kept, and
  * the saturation of the phase is calculated by dividing the global
  * molarity of the component by the phase density.
+ *
+ * If the capillary pressure is zero regardless of the saturations (see
+ * ImmiscibleFlashDetail::HasZeroCapillaryPressure), all phases exhibit
+ * the same pressure and the saturation of each phase follows from its
+ * molar density at this pressure. The system thus reduces to the
+ * single equation \f$\sum_\alpha c^\alpha/\rho_{mol,\alpha}(p) = 1\f$
+ * which is solved by a scalar Newton method before resorting to the
+ * multi-dimensional one.
  */
 template <class Scalar, class FluidSystem>
 class ImmiscibleFlash
@@ -116,8 +145,44 @@ public:
                       const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
                       Scalar tolerance = -1)
     {
+        FlashStatistics<Scalar> stats;
+        solve<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance);
+
+        if (stats.linearSolverFailed)
+            OPM_THROW(Opm::NumericalProblem,
+                      "ImmiscibleFlash solver failed: Singular Jacobian matrix after "
+                      << stats.numIterations << " iterations");
+        if (!stats.converged)
+            OPM_THROW(Opm::NumericalProblem,
+                      "ImmiscibleFlash solver failed: "
+                      "{c_alpha^kappa} = {" << globalMolarities << "}, "
+                      << "T = " << fluidState.temperature(/*phaseIdx=*/0));
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium and reports how the Newton method went.
+     *
+     * The Newton method starts at the quantities of 'fluidState'. If the solution of
+     * a previous time step is available, it can thus be used as a warm start instead
+     * of calling guessInitial(). Instead of throwing an exception if the flash
+     * calculation fails, this is indicated by 'stats', it is recorded as
+     * ErrorStatus::FlashNotConverged for the calling thread and 'fluidState' is left
+     * unmodified.
+     */
+    template <class MaterialLaw, class FluidState>
+    static void solve(FluidState& fluidState,
+                      const typename MaterialLaw::Params& matParams,
+                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                      const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                      FlashStatistics<Scalar>& stats,
+                      Scalar tolerance = -1)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("ImmiscibleFlash::solve");
+
         typedef typename FluidState::Scalar InputEval;
 
+        stats = FlashStatistics<Scalar>();
+
         /////////////////////////
         // Check if all fluid phases are incompressible
         /////////////////////////
@@ -135,9 +200,18 @@ public:
             // determination is much simpler than a full flash calculation.)
             paramCache.updateAll(fluidState);
             solveAllIncompressible_(fluidState, paramCache, globalMolarities);
+            stats.converged = true;
             return;
         }
 
+        if (tolerance <= 0)
+            tolerance = std::min<Scalar>(1e-5,
+                                         1e8*std::numeric_limits<Scalar>::epsilon());
+
+        if (ImmiscibleFlashDetail::HasZeroCapillaryPressure<MaterialLaw>::value
+            && solveCommonPressure_(fluidState, paramCache, globalMolarities, stats, tolerance))
+            return;
+
         typedef Dune::FieldMatrix<InputEval, numEq, numEq> Matrix;
         typedef Dune::FieldVector<InputEval, numEq> Vector;
 
@@ -147,10 +221,6 @@ public:
 
         Dune::FMatrixPrecision<InputEval>::set_singular_limit(1e-35);
 
-        if (tolerance <= 0)
-            tolerance = std::min<Scalar>(1e-5,
-                                         1e8*std::numeric_limits<Scalar>::epsilon());
-
         typename FluidSystem::template ParameterCache<FlashEval> flashParamCache;
         flashParamCache.assignPersistentData(paramCache);
 
@@ -198,31 +268,185 @@ public:
             Valgrind::CheckDefined(b);
 
             // Solve J*x = b
-            deltaX = 0;
-
-            try { J.solve(deltaX, b); }
-            catch (Dune::FMatrixError e) {
-                throw Opm::NumericalProblem(e.what());
+            if (!fixedSizeLuSolve(deltaX, J, b)) {
+                stats.linearSolverFailed = true;
+                ErrorStatus::record(ErrorStatus::FlashNotConverged);
+                return;
             }
             Valgrind::CheckDefined(deltaX);
 
             // update the fluid quantities.
-            Scalar relError = update_<MaterialLaw>(flashFluidState, flashParamCache, matParams, deltaX);
+            stats.relativeError = update_<MaterialLaw>(flashFluidState, flashParamCache, matParams, deltaX);
+            ++stats.numIterations;
 
-            if (relError < tolerance) {
+            if (stats.relativeError < tolerance) {
                 assignOutputFluidState_(flashFluidState, fluidState);
+                stats.converged = true;
                 return;
             }
         }
 
-        OPM_THROW(Opm::NumericalProblem,
-                  "ImmiscibleFlash solver failed: "
-                  "{c_alpha^kappa} = {" << globalMolarities << "}, "
-                  << "T = " << fluidState.temperature(/*phaseIdx=*/0));
+        ErrorStatus::record(ErrorStatus::FlashNotConverged);
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium and obtains the derivatives of the
+     *        result using the implicit function theorem.
+     *
+     * Instead of running the Newton method using function evaluations, the flash
+     * problem is solved using plain scalars and the derivatives of the primary
+     * variables X with regard to the input quantities z are calculated afterwards
+     * using the Jacobian matrix of the converged solution, i.e., \f$dX/dz = - J^{-1}
+     * \partial F/\partial z\f$. Besides this, the method is equivalent to the solve()
+     * method which takes a statistics object.
+     */
+    template <class MaterialLaw, class FluidState>
+    static void solveWithImplicitDerivatives(FluidState& fluidState,
+                                             const typename MaterialLaw::Params& matParams,
+                                             typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                             const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                                             FlashStatistics<Scalar>& stats,
+                                             Scalar tolerance = -1)
+    {
+        typedef typename FluidState::Scalar InputEval;
+
+        solveWithImplicitDerivatives_<MaterialLaw>(fluidState,
+                                                   matParams,
+                                                   paramCache,
+                                                   globalMolarities,
+                                                   stats,
+                                                   tolerance,
+                                                   std::is_same<InputEval, Scalar>());
     }
 
 
 protected:
+    template <class MaterialLaw, class FluidState>
+    static void solveWithImplicitDerivatives_(FluidState& fluidState,
+                                              const typename MaterialLaw::Params& matParams,
+                                              typename FluidSystem::template ParameterCache<Scalar>& paramCache,
+                                              const Dune::FieldVector<Scalar, numComponents>& globalMolarities,
+                                              FlashStatistics<Scalar>& stats,
+                                              Scalar tolerance,
+                                              std::true_type /*isScalar*/)
+    { solve<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance); }
+
+    template <class MaterialLaw, class FluidState>
+    static void solveWithImplicitDerivatives_(FluidState& fluidState,
+                                              const typename MaterialLaw::Params& matParams,
+                                              typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                              const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                                              FlashStatistics<Scalar>& stats,
+                                              Scalar tolerance,
+                                              std::false_type /*isScalar*/)
+    {
+        typedef typename FluidState::Scalar InputEval;
+        static const int numInputDerivs = InputEval::size;
+
+        typedef Opm::DenseAd::Evaluation<Scalar, numEq> FlashEval;
+        typedef Opm::ImmiscibleFluidState<Scalar, FluidSystem, /*energy=*/false> ScalarFluidState;
+        typedef Opm::ImmiscibleFluidState<FlashEval, FluidSystem, /*energy=*/false> FlashFluidState;
+        typedef Opm::ImmiscibleFluidState<InputEval, FluidSystem, /*energy=*/false> InputFluidState;
+
+        OPM_MATERIAL_TRACE_SCOPE("ImmiscibleFlash::solveWithImplicitDerivatives");
+
+        // the Newton method is not used if all fluid phases are incompressible
+        bool allIncompressible = true;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (FluidSystem::isCompressible(phaseIdx)) {
+                allIncompressible = false;
+                break;
+            }
+        }
+
+        if (allIncompressible) {
+            solve<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance);
+            return;
+        }
+
+        // solve the flash problem using plain scalars
+        ScalarFluidState scalarFluidState;
+        scalarFluidState.assign(fluidState);
+
+        typename FluidSystem::template ParameterCache<Scalar> scalarParamCache;
+        scalarParamCache.assignPersistentData(paramCache);
+
+        Dune::FieldVector<Scalar, numComponents> scalarGlobalMolarities;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            scalarGlobalMolarities[compIdx] = Opm::scalarValue(globalMolarities[compIdx]);
+
+        solve<MaterialLaw>(scalarFluidState, matParams, scalarParamCache, scalarGlobalMolarities, stats, tolerance);
+        if (!stats.converged)
+            return;
+
+        // linearize the system of equations at the solution
+        typename FluidSystem::template ParameterCache<FlashEval> flashParamCache;
+        flashParamCache.assignPersistentData(paramCache);
+
+        FlashFluidState flashFluidState;
+        assignFlashFluidState_<MaterialLaw>(scalarFluidState, flashFluidState, matParams, flashParamCache);
+
+        Dune::FieldVector<FlashEval, numComponents> flashGlobalMolarities;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
+            flashGlobalMolarities[compIdx] = scalarGlobalMolarities[compIdx];
+
+        Dune::FieldVector<FlashEval, numEq> flashDefect;
+        evalDefect_(flashDefect, flashFluidState, flashGlobalMolarities);
+
+        Dune::FieldMatrix<Scalar, numEq, numEq> J;
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+            for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
+                J[eqIdx][pvIdx] = flashDefect[eqIdx].derivative(pvIdx);
+
+        // evaluate the defect at the solution while keeping the primary variables
+        // constant to get its partial derivatives with regard to the input
+        // quantities
+        InputFluidState inputFluidState;
+        inputFluidState.setTemperature(fluidState.temperature(/*phaseIdx=*/0));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            inputFluidState.setPressure(phaseIdx, scalarFluidState.pressure(phaseIdx));
+            inputFluidState.setSaturation(phaseIdx, scalarFluidState.saturation(phaseIdx));
+        }
+
+        typename FluidSystem::template ParameterCache<InputEval> inputParamCache;
+        inputParamCache.assignPersistentData(paramCache);
+        inputParamCache.updateAll(inputFluidState);
+        completeFluidState_<MaterialLaw>(inputFluidState, inputParamCache, matParams);
+
+        Dune::FieldVector<InputEval, numEq> inputDefect;
+        evalDefect_(inputDefect, inputFluidState, globalMolarities);
+
+        // dX/dz = - J^-1 dF/dz
+        FixedSizeLu<Scalar, numEq> luJ;
+        if (!luJ.factorize(J)) {
+            ErrorStatus::record(ErrorStatus::FlashNotConverged);
+            stats.linearSolverFailed = true;
+            stats.converged = false;
+            return;
+        }
+
+        std::array<InputEval, numEq> X;
+        for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
+            X[pvIdx] = getQuantity_(scalarFluidState, pvIdx);
+
+        Dune::FieldVector<Scalar, numEq> dFdz;
+        Dune::FieldVector<Scalar, numEq> dXdz;
+        for (int derivIdx = 0; derivIdx < numInputDerivs; ++ derivIdx) {
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                dFdz[eqIdx] = inputDefect[eqIdx].derivative(derivIdx);
+
+            luJ.solve(dXdz, dFdz);
+            for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
+                X[pvIdx].setDerivative(derivIdx, -dXdz[pvIdx]);
+        }
+
+        for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
+            setQuantity_(inputFluidState, pvIdx, X[pvIdx]);
+        completeFluidState_<MaterialLaw>(inputFluidState, inputParamCache, matParams);
+
+        copyFluidState_(inputFluidState, fluidState);
+    }
+
     template <class FluidState>
     static void printFluidState_(const FluidState& fs)
     {
@@ -318,22 +542,120 @@ protected:
         }
     }
 
+    // copy the result of a flash calculation whose quantities are of the same type as
+    // the ones of the output fluid state
+    template <class FlashFluidState, class OutputFluidState>
+    static void copyFluidState_(const FlashFluidState& flashFluidState,
+                                OutputFluidState& outputFluidState)
+    {
+        outputFluidState.setTemperature(flashFluidState.temperature(/*phaseIdx=*/0));
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            outputFluidState.setSaturation(phaseIdx, flashFluidState.saturation(phaseIdx));
+            outputFluidState.setPressure(phaseIdx, flashFluidState.pressure(phaseIdx));
+            outputFluidState.setDensity(phaseIdx, flashFluidState.density(phaseIdx));
+        }
+    }
+
     template <class FluidState>
     static void solveAllIncompressible_(FluidState& fluidState,
                                         typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
                                         const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities)
     {
+        typedef typename FluidState::Scalar Evaluation;
+
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            Scalar rho = FluidSystem::density(fluidState, paramCache, phaseIdx);
+            const Evaluation& rho = FluidSystem::density(fluidState, paramCache, phaseIdx);
             fluidState.setDensity(phaseIdx, rho);
 
-            Scalar saturation =
+            const Evaluation& saturation =
                 globalMolarities[/*compIdx=*/phaseIdx]
                 / fluidState.molarDensity(phaseIdx);
             fluidState.setSaturation(phaseIdx, saturation);
         }
     }
 
+    // determine the pressure which is common to all phases if the capillary pressure is
+    // zero. the saturations follow from the phase densities, so the only equation is
+    // that the saturations sum up to one. false is returned if the scalar Newton method
+    // does not converge, in which case the fluid state is left unmodified.
+    template <class FluidState>
+    static bool solveCommonPressure_(FluidState& fluidState,
+                                     typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                     const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                                     FlashStatistics<Scalar>& stats,
+                                     Scalar tolerance)
+    {
+        typedef typename FluidState::Scalar InputEval;
+        typedef Opm::DenseAd::Evaluation<InputEval, 1> PressureEval;
+        typedef Opm::ImmiscibleFluidState<PressureEval, FluidSystem> PressureFluidState;
+        typedef typename FluidSystem::template ParameterCache<PressureEval> PressureParamCache;
+
+        PressureParamCache pressureParamCache;
+        pressureParamCache.assignPersistentData(paramCache);
+
+        PressureFluidState pressureFluidState;
+        pressureFluidState.setTemperature(fluidState.temperature(/*phaseIdx=*/0));
+
+        InputEval p = fluidState.pressure(/*phaseIdx=*/0);
+        const unsigned nMax = 50; // <- maximum number of newton iterations
+        for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
+            const PressureEval pEval = PressureEval::createVariable(p, /*varIdx=*/0);
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                pressureFluidState.setPressure(phaseIdx, pEval);
+            pressureParamCache.updateAll(pressureFluidState,
+                                         /*except=*/PressureParamCache::Temperature|PressureParamCache::Composition);
+
+            // the saturations of the phases which are implied by the pressure
+            PressureEval sumSat = -1.0;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                const PressureEval& rho = FluidSystem::density(pressureFluidState, pressureParamCache, phaseIdx);
+                pressureFluidState.setDensity(phaseIdx, rho);
+
+                const PressureEval& S =
+                    globalMolarities[/*compIdx=*/phaseIdx]/pressureFluidState.molarDensity(phaseIdx);
+                pressureFluidState.setSaturation(phaseIdx, S);
+                sumSat += S;
+            }
+
+            const InputEval& dSumSat_dp = sumSat.derivative(0);
+            if (!(Opm::scalarValue(dSumSat_dp) != 0.0) || !std::isfinite(Opm::scalarValue(dSumSat_dp)))
+                return false;
+
+            InputEval delta = sumSat.value()/dSumSat_dp;
+            stats.relativeError = std::abs(Opm::scalarValue(delta))*quantityWeight_(fluidState, p0PvIdx);
+            ++stats.numIterations;
+
+            // dampen to at most 50% change in pressure per iteration
+            delta = Opm::min(0.5*p, Opm::max(-0.5*p, delta));
+            p -= delta;
+
+            if (stats.relativeError < tolerance) {
+                // the saturation of the last phase is one minus the sum of the ones of
+                // the others, analogous to the multi-dimensional Newton method
+                InputEval Slast = 1.0;
+                fluidState.setTemperature(pressureFluidState.temperature(/*phaseIdx=*/0).value());
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                    fluidState.setPressure(phaseIdx, pressureFluidState.pressure(phaseIdx).value());
+                    fluidState.setDensity(phaseIdx, pressureFluidState.density(phaseIdx).value());
+                    if (phaseIdx < numPhases - 1) {
+                        const InputEval& S = pressureFluidState.saturation(phaseIdx).value();
+                        fluidState.setSaturation(phaseIdx, S);
+                        Slast -= S;
+                    }
+                }
+                fluidState.setSaturation(numPhases - 1, Slast);
+
+                stats.converged = true;
+                return true;
+            }
+        }
+
+        // let the multi-dimensional Newton method start from scratch
+        stats = FlashStatistics<Scalar>();
+        return false;
+    }
+
     template <class FluidState, class FlashDefectVector, class FlashComponentVector>
     static void evalDefect_(FlashDefectVector& b,
                             const FluidState& fluidState,
@@ -27,6 +27,7 @@
 #ifndef OPM_MISCIBLE_MULTIPHASE_COMPOSITION_HPP
 #define OPM_MISCIBLE_MULTIPHASE_COMPOSITION_HPP
 
+#include <opm/material/common/FixedSizeLu.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 
 
@@ -42,6 +43,8 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Valgrind.hpp>
 
+#include <cmath>
+
 namespace Opm {
 
 /*!
@@ -197,11 +200,144 @@ public:
             }
         }
 
+        // solve for all mole fractions. in the common case, the mole fractions of
+        // all phases are expressed in terms of the ones of the first phase, which
+        // reduces the system of equations to numComponents unknowns
+        Dune::FieldVector<Evaluation, numComponents*numPhases> x;
+        if (!solveReduced_(x, fluidState, phasePresence, auxConstraints, numAuxConstraints))
+            solveFull_(x, fluidState, phasePresence, auxConstraints, numAuxConstraints);
+
+        // set all mole fractions and the additional quantities in
+        // the fluid state
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                unsigned rowIdx = phaseIdx*numComponents + compIdx;
+                fluidState.setMoleFraction(phaseIdx, compIdx, x[rowIdx]);
+            }
+            paramCache.updateComposition(fluidState, phaseIdx);
+
+            const Evaluation& rho = FluidSystem::density(fluidState, paramCache, phaseIdx);
+            fluidState.setDensity(phaseIdx, rho);
+
+            if (setViscosity) {
+                const Evaluation& mu = FluidSystem::viscosity(fluidState, paramCache, phaseIdx);
+                fluidState.setViscosity(phaseIdx, mu);
+            }
+
+            if (setInternalEnergy) {
+                const Evaluation& h =  FluidSystem::enthalpy(fluidState, paramCache, phaseIdx);
+                fluidState.setEnthalpy(phaseIdx, h);
+            }
+        }
+    }
+
+    /*!
+     * \brief Computes the composition of all phases of a N-phase,
+     *        N-component fluid system assuming that all N phases are
+     *        present
+     *
+     * This is a convenience method where no auxiliary constraints are used.
+     */
+    template <class FluidState, class ParameterCache>
+    static void solve(FluidState& fluidState,
+                      ParameterCache& paramCache,
+                      bool setViscosity,
+                      bool setInternalEnergy)
+    {
+        solve(fluidState,
+              paramCache,
+              /*phasePresence=*/0xffffff,
+              /*numAuxConstraints=*/0,
+              /*auxConstraints=*/0,
+              setViscosity,
+              setInternalEnergy);
+    }
+
+protected:
+    // solve the linear system of equations for the mole fractions by eliminating
+    // the mole fractions of all phases except the first one. this is possible if
+    // the product of fugacity coefficient and pressure is non-zero for all
+    // components in all phases. returns false if this is not the case.
+    template <class FluidState>
+    static bool solveReduced_(Dune::FieldVector<Evaluation, numComponents*numPhases>& x,
+                              const FluidState& fluidState,
+                              int phasePresence,
+                              const MMPCAuxConstraint<Evaluation>* auxConstraints,
+                              unsigned numAuxConstraints)
+    {
+        // the equality of fugacities yields x_alpha,i = K_alpha,i * x_0,i with
+        // K_alpha,i = phi_0,i p_0 / (phi_alpha,i p_alpha)
+        Evaluation K[numPhases][numComponents];
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            const Evaluation& gamma0 =
+                fluidState.fugacityCoefficient(/*phaseIdx=*/0, compIdx)
+                *fluidState.pressure(/*phaseIdx=*/0);
+
+            K[0][compIdx] = 1.0;
+            for (unsigned phaseIdx = 1; phaseIdx < numPhases; ++phaseIdx) {
+                const Evaluation& gamma =
+                    fluidState.fugacityCoefficient(phaseIdx, compIdx)
+                    *fluidState.pressure(phaseIdx);
+                if (!(Opm::abs(gamma) > 0.0) || !std::isfinite(Opm::scalarValue(gamma)))
+                    return false;
+
+                K[phaseIdx][compIdx] = gamma0/gamma;
+            }
+        }
+
+        // the remaining equations are the sums of the mole fractions of the
+        // present phases and the auxiliary constraints
+        Dune::FieldMatrix<Evaluation, numComponents, numComponents> M(0.0);
+        Dune::FieldVector<Evaluation, numComponents> x0(0.0);
+        Dune::FieldVector<Evaluation, numComponents> b(0.0);
+
+        unsigned rowIdx = 0;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (!(phasePresence&  (1 << phaseIdx)))
+                continue;
+
+            b[rowIdx] = 1.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                M[rowIdx][compIdx] = K[phaseIdx][compIdx];
+            ++rowIdx;
+        }
+
+        assert(rowIdx + numAuxConstraints == numComponents);
+
+        for (unsigned auxEqIdx = 0; auxEqIdx < numAuxConstraints; ++auxEqIdx, ++rowIdx) {
+            unsigned phaseIdx = auxConstraints[auxEqIdx].phaseIdx();
+            unsigned compIdx = auxConstraints[auxEqIdx].compIdx();
+
+            b[rowIdx] = auxConstraints[auxEqIdx].value();
+            M[rowIdx][compIdx] = K[phaseIdx][compIdx];
+        }
+
+        Dune::FMatrixPrecision<Scalar>::set_singular_limit(1e-50);
+        if (!fixedSizeLuSolve(x0, M, b, /*singularLimit=*/1e-50))
+            OPM_THROW(NumericalProblem,
+                      "Numerical problem in MiscibleMultiPhaseComposition::solve(): "
+                      "Singular matrix; M=" << M);
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                x[phaseIdx*numComponents + compIdx] = K[phaseIdx][compIdx]*x0[compIdx];
+
+        return true;
+    }
+
+    // solve the full linear system of equations for the mole fractions of all
+    // phases
+    template <class FluidState>
+    static void solveFull_(Dune::FieldVector<Evaluation, numComponents*numPhases>& x,
+                           const FluidState& fluidState,
+                           int phasePresence,
+                           const MMPCAuxConstraint<Evaluation>* auxConstraints,
+                           unsigned numAuxConstraints)
+    {
         // create the linear system of equations which defines the
         // mole fractions
         static const int numEq = numComponents*numPhases;
         Dune::FieldMatrix<Evaluation, numEq, numEq> M(0.0);
-        Dune::FieldVector<Evaluation, numEq> x(0.0);
         Dune::FieldVector<Evaluation, numEq> b(0.0);
 
         // assemble the equations expressing the fact that the
@@ -256,63 +392,11 @@ public:
         }
 
         // solve for all mole fractions
-        try {
-            Dune::FMatrixPrecision<Scalar>::set_singular_limit(1e-50);
-            M.solve(x, b);
-        }
-        catch (const Dune::FMatrixError& e) {
+        Dune::FMatrixPrecision<Scalar>::set_singular_limit(1e-50);
+        if (!fixedSizeLuSolve(x, M, b, /*singularLimit=*/1e-50))
             OPM_THROW(NumericalProblem,
-                      "Numerical problem in MiscibleMultiPhaseComposition::solve(): " << e.what() << "; M="<<M);
-        }
-        catch (...) {
-            throw;
-        }
-
-
-        // set all mole fractions and the additional quantities in
-        // the fluid state
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                unsigned rowIdx = phaseIdx*numComponents + compIdx;
-                fluidState.setMoleFraction(phaseIdx, compIdx, x[rowIdx]);
-            }
-            paramCache.updateComposition(fluidState, phaseIdx);
-
-            const Evaluation& rho = FluidSystem::density(fluidState, paramCache, phaseIdx);
-            fluidState.setDensity(phaseIdx, rho);
-
-            if (setViscosity) {
-                const Evaluation& mu = FluidSystem::viscosity(fluidState, paramCache, phaseIdx);
-                fluidState.setViscosity(phaseIdx, mu);
-            }
-
-            if (setInternalEnergy) {
-                const Evaluation& h =  FluidSystem::enthalpy(fluidState, paramCache, phaseIdx);
-                fluidState.setEnthalpy(phaseIdx, h);
-            }
-        }
-    }
-
-    /*!
-     * \brief Computes the composition of all phases of a N-phase,
-     *        N-component fluid system assuming that all N phases are
-     *        present
-     *
-     * This is a convenience method where no auxiliary constraints are used.
-     */
-    template <class FluidState, class ParameterCache>
-    static void solve(FluidState& fluidState,
-                      ParameterCache& paramCache,
-                      bool setViscosity,
-                      bool setInternalEnergy)
-    {
-        solve(fluidState,
-              paramCache,
-              /*phasePresence=*/0xffffff,
-              /*numAuxConstraints=*/0,
-              /*auxConstraints=*/0,
-              setViscosity,
-              setInternalEnergy);
+                      "Numerical problem in MiscibleMultiPhaseComposition::solve(): "
+                      "Singular matrix; M=" << M);
     }
 };
 
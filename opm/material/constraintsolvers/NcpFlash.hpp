@@ -27,12 +27,18 @@
 #ifndef OPM_NCP_FLASH_HPP
 #define OPM_NCP_FLASH_HPP
 
+#include <opm/material/constraintsolvers/FlashStatistics.hpp>
 #include <opm/material/fluidmatrixinteractions/NullMaterial.hpp>
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/material/densead/Math.hpp>
+#include <opm/material/common/ErrorStatus.hpp>
+#include <opm/material/common/FixedSizeLu.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/Tracing.hpp>
+#include <opm/material/common/WorkStealingScheduler.hpp>
 #include <opm/common/Valgrind.hpp>
 
 #include <opm/common/ErrorMacros.hpp>
@@ -43,8 +49,11 @@
 #include <dune/common/fmatrix.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <array>
 #include <limits>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 namespace Opm {
 
@@ -132,11 +141,10 @@ public:
         typename FluidSystem::template ParameterCache<Evaluation> paramCache;
         paramCache.updateAll(fluidState);
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx) {
-                const typename FluidState::Scalar phi =
-                    FluidSystem::fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx);
-                fluidState.setFugacityCoefficient(phaseIdx, compIdx, phi);
-            }
+            typename FluidState::Scalar phi[numComponents];
+            FluidSystem::fugacityCoefficients(fluidState, paramCache, phaseIdx, phi);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
+                fluidState.setFugacityCoefficient(phaseIdx, compIdx, phi[compIdx]);
         }
     }
 
@@ -152,6 +160,38 @@ public:
                       typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
                       const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
                       Scalar tolerance = -1.0)
+    {
+        FlashStatistics<Scalar> stats;
+        solve<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance);
+
+        if (stats.linearSolverFailed)
+            OPM_THROW(NumericalProblem,
+                      "NcpFlash solver failed: Singular Jacobian matrix after "
+                      << stats.numIterations << " iterations");
+        if (!stats.converged)
+            OPM_THROW(NumericalProblem,
+                      "NcpFlash solver failed: "
+                      "{c_alpha^kappa} = {" << globalMolarities << "}, "
+                      << "T = " << fluidState.temperature(/*phaseIdx=*/0));
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium and reports how the Newton method went.
+     *
+     * The Newton method starts at the quantities of 'fluidState'. If the solution of
+     * a previous time step is available, it can thus be used as a warm start instead
+     * of calling guessInitial(). Instead of throwing an exception if the flash
+     * calculation fails, this is indicated by 'stats', it is recorded as
+     * ErrorStatus::FlashNotConverged for the calling thread and 'fluidState' is left
+     * unmodified.
+     */
+    template <class MaterialLaw, class FluidState>
+    static void solve(FluidState& fluidState,
+                      const typename MaterialLaw::Params& matParams,
+                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                      const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                      FlashStatistics<Scalar>& stats,
+                      Scalar tolerance = -1.0)
     {
         typedef typename FluidState::Scalar InputEval;
 
@@ -164,6 +204,10 @@ public:
         typedef Dune::FieldVector<FlashEval, numEq> FlashDefectVector;
         typedef Opm::CompositionalFluidState<FlashEval, FluidSystem, /*energy=*/false> FlashFluidState;
 
+        OPM_MATERIAL_COUNT(ncpFlashSolve);
+        OPM_MATERIAL_TIME_SCOPE(ncpFlashSolveTimer);
+        OPM_MATERIAL_TRACE_SCOPE("NcpFlash::solve");
+
         Dune::FMatrixPrecision<InputEval>::set_singular_limit(1e-35);
 
         if (tolerance <= 0)
@@ -198,45 +242,69 @@ public:
         for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
             flashGlobalMolarities[compIdx] = globalMolarities[compIdx];
 
+        stats = FlashStatistics<Scalar>();
+
         FlashDefectVector defect;
-        const unsigned nMax = 50; // <- maximum number of newton iterations
-        for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
-            // calculate the defect of the flash equations and their derivatives
+        for (unsigned nIdx = 0; nIdx < maxIterations_; ++nIdx) {
+            // calculate the defect and solve the linearized system of equations
             evalDefect_(defect, flashFluidState, flashGlobalMolarities);
             Valgrind::CheckDefined(defect);
-
-            // create field matrices and vectors out of the evaluation vector to solve
-            // the linear system of equations.
-            for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx) {
-                for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
-                    J[eqIdx][pvIdx] = defect[eqIdx].derivative(pvIdx);
-
-                b[eqIdx] = defect[eqIdx].value();
-            }
-            Valgrind::CheckDefined(J);
-            Valgrind::CheckDefined(b);
-
-            // Solve J*x = b
-            deltaX = 0.0;
-            try { J.solve(deltaX, b); }
-            catch (const Dune::FMatrixError& e) {
-                throw Opm::NumericalProblem(e.what());
+            if (!solveLinearized_(deltaX, J, b, defect)) {
+                OPM_MATERIAL_COUNT(ncpFlashFailure);
+                ErrorStatus::record(ErrorStatus::FlashNotConverged);
+                stats.linearSolverFailed = true;
+                return;
             }
-            Valgrind::CheckDefined(deltaX);
 
             // update the fluid quantities.
-            Scalar relError = update_<MaterialLaw>(flashFluidState, matParams, flashParamCache, deltaX);
+            stats.relativeError = update_<MaterialLaw>(flashFluidState, matParams, flashParamCache, deltaX);
+            ++stats.numIterations;
+            OPM_MATERIAL_COUNT(ncpFlashNewtonIteration);
 
-            if (relError < tolerance) {
+            if (stats.relativeError < tolerance) {
                 assignOutputFluidState_(flashFluidState, fluidState);
+                stats.converged = true;
                 return;
             }
         }
 
-        OPM_THROW(NumericalProblem,
-                  "NcpFlash solver failed: "
-                  "{c_alpha^kappa} = {" << globalMolarities << "}, "
-                  << "T = " << fluidState.temperature(/*phaseIdx=*/0));
+        OPM_MATERIAL_COUNT(ncpFlashFailure);
+        ErrorStatus::record(ErrorStatus::FlashNotConverged);
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium and obtains the derivatives of the
+     *        result using the implicit function theorem.
+     *
+     * This method is equivalent to the solve() method which takes a statistics object,
+     * but if the quantities of the fluid state are function evaluations, the Newton
+     * method is not carried out using them. Instead, the flash problem is solved using
+     * plain scalars and the derivatives of the primary variables X with regard to the
+     * input quantities z (i.e., the global molarities and the temperature) are
+     * calculated afterwards using a single linear solve with the Jacobian matrix of
+     * the converged solution:
+     *
+     * \f[ \frac{dX}{dz} = - J^{-1} \frac{\partial F}{\partial z} \f]
+     *
+     * The derivatives of the initial values of the fluid state are not considered.
+     */
+    template <class MaterialLaw, class FluidState>
+    static void solveWithImplicitDerivatives(FluidState& fluidState,
+                                             const typename MaterialLaw::Params& matParams,
+                                             typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                             const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                                             FlashStatistics<Scalar>& stats,
+                                             Scalar tolerance = -1.0)
+    {
+        typedef typename FluidState::Scalar InputEval;
+
+        solveWithImplicitDerivatives_<MaterialLaw>(fluidState,
+                                                   matParams,
+                                                   paramCache,
+                                                   globalMolarities,
+                                                   stats,
+                                                   tolerance,
+                                                   std::is_same<InputEval, Scalar>());
     }
 
     /*!
@@ -259,8 +327,297 @@ public:
         solve<MaterialLaw>(fluidState, matParams, globalMolarities, tolerance);
     }
 
+    /*!
+     * \brief Calculates the chemical equilibrium of many cells at once.
+     *
+     * The arguments of cell 'i' are 'fluidStates[i]', '*matParams[i]', 'paramCaches[i]'
+     * and 'globalMolarities[i]'. The fluid states must already be initialized (e.g. in
+     * terms of guessInitial()). The cells are distributed to the threads by a
+     * WorkStealingScheduler if OpenMP is enabled: The cells of a chunk are iterated in
+     * lock-step for a few Newton iterations, and the ones which have not converged by
+     * then are re-queued so that idle threads can take them over. The Newton method
+     * stops for a cell as soon as it has converged. The results are independent of the
+     * number of threads.
+     *
+     * Instead of throwing an exception, a cell which does not converge gets an
+     * iteration count of -1 in 'numIterations' and its fluid state is not modified.
+     * For all other cells, the number of Newton iterations is stored. The return value
+     * is the number of cells which failed to converge.
+     */
+    template <class MaterialLaw, class FluidState>
+    static unsigned solveMany(FluidState* fluidStates,
+                              const typename MaterialLaw::Params* const* matParams,
+                              typename FluidSystem::template ParameterCache<typename FluidState::Scalar>* paramCaches,
+                              const Dune::FieldVector<typename FluidState::Scalar, numComponents>* globalMolarities,
+                              int* numIterations,
+                              unsigned numCells,
+                              Scalar tolerance = -1.0)
+    {
+        typedef typename FluidState::Scalar InputEval;
+
+        typedef Dune::FieldMatrix<InputEval, numEq, numEq> Matrix;
+        typedef Dune::FieldVector<InputEval, numEq> Vector;
+
+        typedef Opm::DenseAd::Evaluation</*Scalar=*/InputEval,
+                                         /*numDerivs=*/numEq> FlashEval;
+
+        typedef Dune::FieldVector<FlashEval, numEq> FlashDefectVector;
+        typedef Dune::FieldVector<FlashEval, numComponents> FlashComponentVector;
+        typedef Opm::CompositionalFluidState<FlashEval, FluidSystem, /*energy=*/false> FlashFluidState;
+        typedef typename FluidSystem::template ParameterCache<FlashEval> FlashParamCache;
+
+        OPM_MATERIAL_COUNT_N(ncpFlashSolve, numCells);
+        OPM_MATERIAL_TIME_SCOPE(ncpFlashSolveTimer);
+        OPM_MATERIAL_TRACE_SCOPE("NcpFlash::solve");
+
+        Dune::FMatrixPrecision<InputEval>::set_singular_limit(1e-35);
+
+        if (tolerance <= 0)
+            tolerance = std::min<Scalar>(1e-3,
+                                         1e8*std::numeric_limits<Scalar>::epsilon());
+
+        std::vector<FlashFluidState> flashFluidStates(numCells);
+        std::vector<FlashParamCache> flashParamCaches(numCells);
+        std::vector<FlashComponentVector> flashGlobalMolarities(numCells);
+
+        // the number of Newton iterations which have been done for each cell
+        std::vector<unsigned> numCellIterations(numCells, 0);
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            flashParamCaches[cellIdx].assignPersistentData(paramCaches[cellIdx]);
+            assignFlashFluidState_<MaterialLaw>(fluidStates[cellIdx],
+                                                flashFluidStates[cellIdx],
+                                                *matParams[cellIdx],
+                                                flashParamCaches[cellIdx]);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
+                flashGlobalMolarities[cellIdx][compIdx] = globalMolarities[cellIdx][compIdx];
+
+            numIterations[cellIdx] = -1;
+        }
+
+        // the chunks only contain the cells which have not converged yet
+        Opm::WorkStealingScheduler<unsigned> scheduler(/*minChunkSize=*/manyMinChunkSize_);
+        scheduler.run(numCells, [&](std::vector<unsigned>& activeCells) {
+                Matrix J;
+                Vector deltaX;
+                Vector b;
+                FlashDefectVector defect;
+                for (unsigned roundIdx = 0; roundIdx < manyIterationsPerRound_ && !activeCells.empty(); ++roundIdx) {
+                    unsigned numActive = 0;
+                    OPM_MATERIAL_COUNT_N(ncpFlashNewtonIteration, activeCells.size());
+                    for (unsigned cellIdx : activeCells) {
+                        FlashFluidState& flashFluidState = flashFluidStates[cellIdx];
+                        const unsigned nIdx = numCellIterations[cellIdx]++;
+
+                        evalDefect_(defect, flashFluidState, flashGlobalMolarities[cellIdx]);
+                        if (!solveLinearized_(deltaX, J, b, defect) || !isFinite_(deltaX))
+                            continue; // give up on the cell
+
+                        Scalar relError = update_<MaterialLaw>(flashFluidState,
+                                                               *matParams[cellIdx],
+                                                               flashParamCaches[cellIdx],
+                                                               deltaX);
+                        if (relError < tolerance) {
+                            assignOutputFluidState_(flashFluidState, fluidStates[cellIdx]);
+                            numIterations[cellIdx] = static_cast<int>(nIdx + 1);
+                            continue;
+                        }
+
+                        if (nIdx + 1 < maxIterations_)
+                            activeCells[numActive++] = cellIdx;
+                    }
+                    activeCells.resize(numActive);
+                }
+            });
+
+        unsigned numFailed = 0;
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            if (numIterations[cellIdx] < 0)
+                ++numFailed;
+        OPM_MATERIAL_COUNT_N(ncpFlashFailure, numFailed);
+
+        return numFailed;
+    }
+
 
 protected:
+    static const unsigned maxIterations_ = 50; // <- maximum number of newton iterations
+
+    // the number of Newton iterations of solveMany() after which the cells of a chunk
+    // which have not converged yet are re-queued, and the minimum size of the chunks
+    static const unsigned manyIterationsPerRound_ = 4;
+    static const unsigned manyMinChunkSize_ = 8;
+
+    // the quantities of the fluid state do not exhibit any derivatives, so the
+    // implicit function theorem is not required
+    template <class MaterialLaw, class FluidState>
+    static void solveWithImplicitDerivatives_(FluidState& fluidState,
+                                              const typename MaterialLaw::Params& matParams,
+                                              typename FluidSystem::template ParameterCache<Scalar>& paramCache,
+                                              const Dune::FieldVector<Scalar, numComponents>& globalMolarities,
+                                              FlashStatistics<Scalar>& stats,
+                                              Scalar tolerance,
+                                              std::true_type /*isScalar*/)
+    { solve<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance); }
+
+    template <class MaterialLaw, class FluidState>
+    static void solveWithImplicitDerivatives_(FluidState& fluidState,
+                                              const typename MaterialLaw::Params& matParams,
+                                              typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                              const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                                              FlashStatistics<Scalar>& stats,
+                                              Scalar tolerance,
+                                              std::false_type /*isScalar*/)
+    {
+        typedef typename FluidState::Scalar InputEval;
+        static const int numInputDerivs = InputEval::size;
+
+        typedef Opm::DenseAd::Evaluation<Scalar, numEq> FlashEval;
+        typedef Opm::CompositionalFluidState<Scalar, FluidSystem, /*energy=*/false> ScalarFluidState;
+        typedef Opm::CompositionalFluidState<FlashEval, FluidSystem, /*energy=*/false> FlashFluidState;
+        typedef Opm::CompositionalFluidState<InputEval, FluidSystem, /*energy=*/false> InputFluidState;
+
+        OPM_MATERIAL_TRACE_SCOPE("NcpFlash::solveWithImplicitDerivatives");
+
+        // solve the flash problem using plain scalars
+        ScalarFluidState scalarFluidState;
+        scalarFluidState.assign(fluidState);
+
+        typename FluidSystem::template ParameterCache<Scalar> scalarParamCache;
+        scalarParamCache.assignPersistentData(paramCache);
+
+        Dune::FieldVector<Scalar, numComponents> scalarGlobalMolarities;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            scalarGlobalMolarities[compIdx] = Opm::scalarValue(globalMolarities[compIdx]);
+
+        solve<MaterialLaw>(scalarFluidState, matParams, scalarParamCache, scalarGlobalMolarities, stats, tolerance);
+        if (!stats.converged)
+            return;
+
+        // linearize the system of equations at the solution
+        typename FluidSystem::template ParameterCache<FlashEval> flashParamCache;
+        flashParamCache.assignPersistentData(paramCache);
+
+        FlashFluidState flashFluidState;
+        assignFlashFluidState_<MaterialLaw>(scalarFluidState, flashFluidState, matParams, flashParamCache);
+
+        Dune::FieldVector<FlashEval, numComponents> flashGlobalMolarities;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
+            flashGlobalMolarities[compIdx] = scalarGlobalMolarities[compIdx];
+
+        Dune::FieldVector<FlashEval, numEq> flashDefect;
+        evalDefect_(flashDefect, flashFluidState, flashGlobalMolarities);
+
+        Dune::FieldMatrix<Scalar, numEq, numEq> J;
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+            for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
+                J[eqIdx][pvIdx] = flashDefect[eqIdx].derivative(pvIdx);
+
+        // the partial derivatives of the defect with regard to the input quantities
+        // are obtained by evaluating it at the solution while keeping the primary
+        // variables constant
+        InputFluidState inputFluidState;
+        inputFluidState.setTemperature(fluidState.temperature(/*phaseIdx=*/0));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            inputFluidState.setPressure(phaseIdx, scalarFluidState.pressure(phaseIdx));
+            inputFluidState.setSaturation(phaseIdx, scalarFluidState.saturation(phaseIdx));
+
+            std::array<InputEval, numComponents> x;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                x[compIdx] = scalarFluidState.moleFraction(phaseIdx, compIdx);
+            inputFluidState.setMoleFractions(phaseIdx, x);
+        }
+
+        typename FluidSystem::template ParameterCache<InputEval> inputParamCache;
+        inputParamCache.assignPersistentData(paramCache);
+        inputParamCache.updateAll(inputFluidState);
+        completeFluidState_<MaterialLaw>(inputFluidState, inputParamCache, matParams);
+
+        Dune::FieldVector<InputEval, numEq> inputDefect;
+        evalDefect_(inputDefect, inputFluidState, globalMolarities);
+
+        // dX/dz = - J^-1 dF/dz. the Jacobian matrix is only factorized once for all
+        // derivatives
+        FixedSizeLu<Scalar, numEq> luJ;
+        if (!luJ.factorize(J)) {
+            OPM_MATERIAL_COUNT(ncpFlashFailure);
+            ErrorStatus::record(ErrorStatus::FlashNotConverged);
+            stats.linearSolverFailed = true;
+            stats.converged = false;
+            return;
+        }
+
+        std::array<InputEval, numEq> X;
+        for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
+            X[pvIdx] = getQuantity_(scalarFluidState, pvIdx);
+
+        Dune::FieldVector<Scalar, numEq> dFdz;
+        Dune::FieldVector<Scalar, numEq> dXdz;
+        for (int derivIdx = 0; derivIdx < numInputDerivs; ++ derivIdx) {
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                dFdz[eqIdx] = inputDefect[eqIdx].derivative(derivIdx);
+
+            luJ.solve(dXdz, dFdz);
+            for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
+                X[pvIdx].setDerivative(derivIdx, -dXdz[pvIdx]);
+        }
+
+        // update the fluid state with the primary variables which exhibit the
+        // derivatives and copy the result to the output fluid state
+        std::array<std::array<InputEval, numComponents>, numPhases> moleFractions;
+        for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx) {
+            if (isMoleFracIdx_(pvIdx)) {
+                unsigned phaseIdx = (pvIdx - numPhases)/numComponents;
+                unsigned compIdx = (pvIdx - numPhases)%numComponents;
+                moleFractions[phaseIdx][compIdx] = X[pvIdx];
+            }
+            else
+                setQuantity_(inputFluidState, pvIdx, X[pvIdx]);
+        }
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            inputFluidState.setMoleFractions(phaseIdx, moleFractions[phaseIdx]);
+
+        completeFluidState_<MaterialLaw>(inputFluidState, inputParamCache, matParams);
+
+        copyFluidState_(inputFluidState, fluidState);
+    }
+
+    // solve the system of equations which is linearized around the current solution,
+    // i.e., J*deltaX = b. false is returned if the Jacobian matrix is singular.
+    template <class Vector, class Matrix, class FlashDefectVector>
+    static bool solveLinearized_(Vector& deltaX,
+                                 Matrix& J,
+                                 Vector& b,
+                                 const FlashDefectVector& defect)
+    {
+        // create field matrices and vectors out of the evaluation vector to solve
+        // the linear system of equations.
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx) {
+            for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
+                J[eqIdx][pvIdx] = defect[eqIdx].derivative(pvIdx);
+
+            b[eqIdx] = defect[eqIdx].value();
+        }
+        Valgrind::CheckDefined(J);
+        Valgrind::CheckDefined(b);
+
+        // Solve J*x = b
+        if (!fixedSizeLuSolve(deltaX, J, b))
+            return false;
+        Valgrind::CheckDefined(deltaX);
+
+        return true;
+    }
+
+    template <class Vector>
+    static bool isFinite_(const Vector& deltaX)
+    {
+        for (unsigned i = 0; i < numEq; ++i)
+            if (!std::isfinite(Opm::scalarValue(deltaX[i])))
+                return false;
+        return true;
+    }
+
     template <class FluidState>
     static void printFluidState_(const FluidState& fluidState)
     {
@@ -348,11 +705,12 @@ protected:
 
         // copy the mole fractions: all of them are primary variables
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            std::array<FlashEval, numComponents> x;
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                FlashEval x = inputFluidState.moleFraction(phaseIdx, compIdx);
-                x.setDerivative(x00PvIdx + phaseIdx*numComponents + compIdx, 1.0);
-                flashFluidState.setMoleFraction(phaseIdx, compIdx, x);
+                x[compIdx] = inputFluidState.moleFraction(phaseIdx, compIdx);
+                x[compIdx].setDerivative(x00PvIdx + phaseIdx*numComponents + compIdx, 1.0);
             }
+            flashFluidState.setMoleFractions(phaseIdx, x);
         }
 
         flashParamCache.updateAll(flashFluidState);
@@ -363,10 +721,10 @@ protected:
             const FlashEval& rho = FluidSystem::density(flashFluidState, flashParamCache, phaseIdx);
             flashFluidState.setDensity(phaseIdx, rho);
 
-            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                const FlashEval& fugCoeff = FluidSystem::fugacityCoefficient(flashFluidState, flashParamCache, phaseIdx, compIdx);
-                flashFluidState.setFugacityCoefficient(phaseIdx, compIdx, fugCoeff);
-            }
+            FlashEval fugCoeffs[numComponents];
+            FluidSystem::fugacityCoefficients(flashFluidState, flashParamCache, phaseIdx, fugCoeffs);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                flashFluidState.setFugacityCoefficient(phaseIdx, compIdx, fugCoeffs[compIdx]);
         }
     }
 
@@ -388,17 +746,44 @@ protected:
             outputFluidState.setDensity(phaseIdx, rho);
         }
 
-        // copy the mole fractions and fugacity coefficients
+        // copy the mole fractions and fugacity coefficients. the composition of a
+        // phase is set at once so that the average molar mass is only updated once
+        // per phase instead of once per component
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            std::array<typename OutputFluidState::Scalar, numComponents> x;
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                const auto& moleFrac =
-                    flashFluidState.moleFraction(phaseIdx, compIdx).value();
-                outputFluidState.setMoleFraction(phaseIdx, compIdx, moleFrac);
+                x[compIdx] = flashFluidState.moleFraction(phaseIdx, compIdx).value();
 
                 const auto& fugCoeff =
                     flashFluidState.fugacityCoefficient(phaseIdx, compIdx).value();
                 outputFluidState.setFugacityCoefficient(phaseIdx, compIdx, fugCoeff);
             }
+            outputFluidState.setMoleFractions(phaseIdx, x);
+        }
+    }
+
+    // copy the result of a flash calculation whose quantities are of the same type as
+    // the ones of the output fluid state
+    template <class FlashFluidState, class OutputFluidState>
+    static void copyFluidState_(const FlashFluidState& flashFluidState,
+                                OutputFluidState& outputFluidState)
+    {
+        outputFluidState.setTemperature(flashFluidState.temperature(/*phaseIdx=*/0));
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            outputFluidState.setSaturation(phaseIdx, flashFluidState.saturation(phaseIdx));
+            outputFluidState.setPressure(phaseIdx, flashFluidState.pressure(phaseIdx));
+            outputFluidState.setDensity(phaseIdx, flashFluidState.density(phaseIdx));
+        }
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            std::array<typename OutputFluidState::Scalar, numComponents> x;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                x[compIdx] = flashFluidState.moleFraction(phaseIdx, compIdx);
+                outputFluidState.setFugacityCoefficient(phaseIdx, compIdx,
+                                                        flashFluidState.fugacityCoefficient(phaseIdx, compIdx));
+            }
+            outputFluidState.setMoleFractions(phaseIdx, x);
         }
     }
 
@@ -470,6 +855,10 @@ protected:
             assert(std::isfinite(Opm::scalarValue(deltaX[i])));
 #endif
 
+        // the new mole fractions are collected and set for each phase at once, so that
+        // the average molar masses of the phases only need to be computed once
+        std::array<std::array<FlashEval, numComponents>, numPhases> newMoleFractions;
+
         Scalar relError = 0;
         for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx) {
             FlashEval tmp = getQuantity_(fluidState, pvIdx);
@@ -495,9 +884,18 @@ protected:
             }
 
             tmp -= delta;
-            setQuantity_(fluidState, pvIdx, tmp);
+            if (isMoleFracIdx_(pvIdx)) {
+                unsigned phaseIdx = (pvIdx - numPhases)/numComponents;
+                unsigned compIdx = (pvIdx - numPhases)%numComponents;
+                newMoleFractions[phaseIdx][compIdx] = tmp;
+            }
+            else
+                setQuantity_(fluidState, pvIdx, tmp);
         }
 
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            fluidState.setMoleFractions(phaseIdx, newMoleFractions[phaseIdx]);
+
         completeFluidState_<MaterialLaw>(fluidState, paramCache, matParams);
 
         return relError;
@@ -537,10 +935,10 @@ protected:
             const FlashEval& rho = FluidSystem::density(flashFluidState, paramCache, phaseIdx);
             flashFluidState.setDensity(phaseIdx, rho);
 
-            for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx) {
-                const FlashEval& phi = FluidSystem::fugacityCoefficient(flashFluidState, paramCache, phaseIdx, compIdx);
-                flashFluidState.setFugacityCoefficient(phaseIdx, compIdx, phi);
-            }
+            FlashEval phi[numComponents];
+            FluidSystem::fugacityCoefficients(flashFluidState, paramCache, phaseIdx, phi);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
+                flashFluidState.setFugacityCoefficient(phaseIdx, compIdx, phi[compIdx]);
         }
     }
 
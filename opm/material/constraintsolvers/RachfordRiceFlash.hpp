@@ -0,0 +1,399 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::RachfordRiceFlash
+ */
+#ifndef OPM_RACHFORD_RICE_FLASH_HPP
+#define OPM_RACHFORD_RICE_FLASH_HPP
+
+#include <opm/material/constraintsolvers/SuccessiveSubstitutionFlash.hpp>
+#include <opm/material/constraintsolvers/FlashStatistics.hpp>
+#include <opm/material/fluidstates/CompositionalFluidState.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace Opm {
+
+/*!
+ * \brief Determines the phase compositions, pressures and saturations given the total
+ *        mass of all components using a reduced set of primary variables.
+ *
+ * This solver has the same interface as NcpFlash, but it only considers the phases
+ * 'liquidPhaseIdxV' and 'gasPhaseIdxV'. The saturations of all other phases are
+ * zero. Instead of the pressure, the saturations and the mole fractions of all
+ * phases, the natural logarithms of the N equilibrium ratios, the pressure of the
+ * liquid phase and the gas saturation are solved for. The phase split of the moles is
+ * given by the Rachford-Rice equation. Thus the Newton method solves a system of
+ * N + 2 equations instead of the numPhases*(N + 1) equations of NcpFlash:
+ *
+ * - N equations stemming from the fact that the fugacity of any component is the same
+ *   in both phases
+ * - 2 constraints from the fact that the volume of each phase is given by its
+ *   saturation
+ *
+ * Whether two phases are present is decided by the stability test of
+ * SuccessiveSubstitutionFlash which also provides the initial equilibrium
+ * ratios. If the mixture is single-phase, only the pressure is determined.
+ */
+template <class Scalar, class FluidSystem, int liquidPhaseIdxV, int gasPhaseIdxV>
+class RachfordRiceFlash : protected SuccessiveSubstitutionFlash<Scalar, FluidSystem>
+{
+    typedef SuccessiveSubstitutionFlash<Scalar, FluidSystem> ParentType;
+
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    enum { liquidPhaseIdx = liquidPhaseIdxV };
+    enum { gasPhaseIdx = gasPhaseIdxV };
+
+    enum {
+        pressurePvIdx = numComponents,
+        gasSaturationPvIdx = numComponents + 1
+    };
+
+    static const int numEq = numComponents + 2;
+    static const unsigned maxIterations_ = 50;
+
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem, /*energy=*/false> TmpFluidState;
+
+public:
+    /*!
+     * \brief Calculates the chemical equilibrium from the total molarities of the
+     *        components.
+     *
+     * The temperature must be set in 'fluidState'. The initial pressure is the one of
+     * the liquid phase of 'fluidState'.
+     */
+    template <class MaterialLaw, class FluidState>
+    static void solve(FluidState& fluidState,
+                      const typename MaterialLaw::Params& matParams,
+                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                      const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                      Scalar tolerance = -1.0)
+    {
+        FlashStatistics<Scalar> stats;
+        solve<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance);
+
+        if (!stats.converged)
+            OPM_THROW(NumericalProblem,
+                      "RachfordRiceFlash solver failed: "
+                      "{c_alpha^kappa} = {" << globalMolarities << "}, "
+                      << "T = " << fluidState.temperature(/*phaseIdx=*/0));
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium and reports how the Newton method went.
+     *
+     * If the calculation fails, this is indicated by 'stats' and 'fluidState' is left
+     * unmodified.
+     */
+    template <class MaterialLaw, class FluidState>
+    static void solve(FluidState& fluidState,
+                      const typename MaterialLaw::Params& matParams,
+                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                      const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                      FlashStatistics<Scalar>& stats,
+                      Scalar tolerance = -1.0)
+    {
+        stats = FlashStatistics<Scalar>();
+
+        if (tolerance <= 0)
+            tolerance = std::max<Scalar>(1e-10,
+                                         1e3*std::numeric_limits<Scalar>::epsilon());
+
+        Scalar totalMolarity = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            totalMolarity += globalMolarities[compIdx];
+        ComponentVector z(globalMolarities);
+        z /= totalMolarity;
+
+        Scalar T = fluidState.temperature(/*phaseIdx=*/0);
+        Scalar p = fluidState.pressure(liquidPhaseIdx);
+        Scalar Sg = std::min<Scalar>(0.9, std::max<Scalar>(0.1, Opm::scalarValue(fluidState.saturation(gasPhaseIdx))));
+
+        // the stability test and the Newton method for the single-phase case are
+        // alternated at most a few times because the pressure may end up on the other
+        // side of the saturation pressure
+        ComponentVector lnK;
+        for (unsigned attemptIdx = 0; attemptIdx < 3 && !stats.converged; ++attemptIdx) {
+            TmpFluidState tmpFs;
+            tmpFs.setTemperature(T);
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                tmpFs.setPressure(phaseIdx, p);
+            typename FluidSystem::template ParameterCache<Scalar> tmpParamCache;
+
+            ParentType::wilsonLnK_(lnK, T, p);
+            unsigned feedPhaseIdx;
+            bool stable = ParentType::isStable_(lnK,
+                                                feedPhaseIdx,
+                                                tmpFs,
+                                                tmpParamCache,
+                                                z,
+                                                liquidPhaseIdx,
+                                                gasPhaseIdx,
+                                                stats);
+
+            if (!stable) {
+                Scalar V = 0.5;
+                twoPhaseNewton_<MaterialLaw>(lnK, p, Sg, V, stats, T, z, totalMolarity, matParams, tolerance);
+                if (!stats.converged)
+                    return;
+
+                if (Sg > 0.0 && Sg < 1.0) {
+                    ComponentVector x, y;
+                    ParentType::computeCompositions_(x, y, lnK, z, V);
+                    assignOutput_<MaterialLaw>(fluidState, paramCache, matParams, T, p, Sg, x, y);
+                    return;
+                }
+
+                // the phase split ended up at the boundary, i.e., only one phase is
+                // present
+                feedPhaseIdx = (Sg >= 1.0) ? unsigned(gasPhaseIdx) : unsigned(liquidPhaseIdx);
+                stats.converged = false;
+            }
+
+            // single phase. determine the pressure at which the phase fills the pore
+            // space and check the stability again
+            Scalar oldP = p;
+            singlePhaseNewton_<MaterialLaw>(p, stats, feedPhaseIdx, T, z, totalMolarity, matParams, tolerance);
+            if (!stats.converged)
+                return;
+            if (std::abs(p - oldP) <= tolerance*p || attemptIdx == 2) {
+                Sg = (feedPhaseIdx == gasPhaseIdx) ? 1.0 : 0.0;
+                assignOutput_<MaterialLaw>(fluidState, paramCache, matParams, T, p, Sg, z, z);
+                return;
+            }
+            stats.converged = false;
+        }
+    }
+
+protected:
+    template <class MaterialLaw, class FlashFluidState>
+    static void updatePressures_(FlashFluidState& flashFs,
+                                 const typename MaterialLaw::Params& matParams,
+                                 const typename FlashFluidState::Scalar& pLiquid)
+    {
+        typedef typename FlashFluidState::Scalar Evaluation;
+
+        Dune::FieldVector<Evaluation, numPhases> pC;
+        MaterialLaw::capillaryPressures(pC, matParams, flashFs);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            flashFs.setPressure(phaseIdx, pLiquid + (pC[phaseIdx] - pC[liquidPhaseIdx]));
+    }
+
+    template <class FlashFluidState>
+    static void setSaturations_(FlashFluidState& flashFs,
+                                const typename FlashFluidState::Scalar& Sg)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            flashFs.setSaturation(phaseIdx, 0.0);
+        flashFs.setSaturation(gasPhaseIdx, Sg);
+        flashFs.setSaturation(liquidPhaseIdx, 1.0 - Sg);
+    }
+
+    // the Newton method if both phases are present. if one of the phases vanishes, the
+    // gas saturation is set to 0 or 1.
+    template <class MaterialLaw>
+    static void twoPhaseNewton_(ComponentVector& lnK,
+                                Scalar& p,
+                                Scalar& Sg,
+                                Scalar& V,
+                                FlashStatistics<Scalar>& stats,
+                                Scalar T,
+                                const ComponentVector& z,
+                                Scalar totalMolarity,
+                                const typename MaterialLaw::Params& matParams,
+                                Scalar tolerance)
+    {
+        typedef Opm::DenseAd::Evaluation<Scalar, numEq> Evaluation;
+        typedef Dune::FieldVector<Evaluation, numComponents> EvalVector;
+        typedef Dune::FieldMatrix<Scalar, numEq, numEq> Matrix;
+        typedef Dune::FieldVector<Scalar, numEq> Vector;
+        typedef Opm::CompositionalFluidState<Evaluation, FluidSystem, /*energy=*/false> FlashFluidState;
+
+        FlashFluidState flashFs;
+        flashFs.setTemperature(T);
+        typename FluidSystem::template ParameterCache<Evaluation> flashParamCache;
+
+        Matrix J;
+        Vector b, deltaX;
+        for (unsigned nIdx = 0; nIdx < maxIterations_; ++nIdx) {
+            EvalVector lnKEval, K;
+            ComponentVector Kvalue;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                lnKEval[compIdx] = Evaluation::createVariable(lnK[compIdx], compIdx);
+                K[compIdx] = Opm::exp(lnKEval[compIdx]);
+                Kvalue[compIdx] = K[compIdx].value();
+            }
+            Evaluation pEval = Evaluation::createVariable(p, pressurePvIdx);
+            Evaluation SgEval = Evaluation::createVariable(Sg, gasSaturationPvIdx);
+
+            // the vapor fraction and the phase compositions
+            V = ParentType::solveRachfordRice_(lnK, z, V);
+            Evaluation VEval =
+                V - ParentType::rachfordRice_(K, z, V)/ParentType::rachfordRiceDerivative_(Kvalue, z, V);
+            EvalVector x, y;
+            ParentType::computeCompositions_(x, y, K, z, VEval, /*kIsLogarithmic=*/false);
+
+            setSaturations_(flashFs, SgEval);
+            updatePressures_<MaterialLaw>(flashFs, matParams, pEval);
+
+            EvalVector lnPhiPL, lnPhiPV;
+            ParentType::computeLnPhiP_(lnPhiPL, flashFs, flashParamCache, liquidPhaseIdx, x);
+            ParentType::computeLnPhiP_(lnPhiPV, flashFs, flashParamCache, gasPhaseIdx, y);
+
+            const Evaluation& rhoL = FluidSystem::density(flashFs, flashParamCache, liquidPhaseIdx);
+            const Evaluation& rhoV = FluidSystem::density(flashFs, flashParamCache, gasPhaseIdx);
+            Evaluation molarVolumeL = flashFs.averageMolarMass(liquidPhaseIdx)/rhoL;
+            Evaluation molarVolumeV = flashFs.averageMolarMass(gasPhaseIdx)/rhoV;
+
+            // assemble the residual
+            Dune::FieldVector<Evaluation, numEq> residual;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                residual[compIdx] = lnKEval[compIdx] + lnPhiPV[compIdx] - lnPhiPL[compIdx];
+            residual[pressurePvIdx] = totalMolarity*(1.0 - VEval)*molarVolumeL - (1.0 - SgEval);
+            residual[gasSaturationPvIdx] = totalMolarity*VEval*molarVolumeV - SgEval;
+
+            Scalar maxResidual = 0.0;
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                    J[eqIdx][pvIdx] = residual[eqIdx].derivative(pvIdx);
+                b[eqIdx] = residual[eqIdx].value();
+                maxResidual = std::max<Scalar>(maxResidual, std::abs(b[eqIdx]));
+            }
+            stats.relativeError = maxResidual;
+            if (maxResidual < tolerance) {
+                stats.converged = true;
+                return;
+            }
+
+            deltaX = 0.0;
+            try { J.solve(deltaX, b); }
+            catch (const Dune::FMatrixError&) {
+                stats.linearSolverFailed = true;
+                return;
+            }
+            ++stats.numIterations;
+
+            // update the primary variables. the changes are limited in order to
+            // stay within the range where the equation of state is sensible.
+            Scalar sumLnKSquared = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                lnK[compIdx] -= std::min<Scalar>(1.0, std::max<Scalar>(-1.0, deltaX[compIdx]));
+                sumLnKSquared += lnK[compIdx]*lnK[compIdx];
+            }
+            p -= std::min<Scalar>(0.5*p, std::max<Scalar>(-0.5*p, deltaX[pressurePvIdx]));
+            Sg -= std::min<Scalar>(0.2, std::max<Scalar>(-0.2, deltaX[gasSaturationPvIdx]));
+
+            if (sumLnKSquared < 1e-4 || Sg <= 0.0 || Sg >= 1.0) {
+                // the phases become identical or one of them vanishes
+                Sg = std::min<Scalar>(1.0, std::max<Scalar>(0.0, Sg));
+                stats.converged = true;
+                if (sumLnKSquared < 1e-4)
+                    Sg = (V >= 0.5) ? 1.0 : 0.0;
+                return;
+            }
+        }
+    }
+
+    // the Newton method if only a single phase is present. the only primary variable
+    // is the pressure of the phase.
+    template <class MaterialLaw>
+    static void singlePhaseNewton_(Scalar& p,
+                                   FlashStatistics<Scalar>& stats,
+                                   unsigned phaseIdx,
+                                   Scalar T,
+                                   const ComponentVector& z,
+                                   Scalar totalMolarity,
+                                   const typename MaterialLaw::Params& matParams,
+                                   Scalar tolerance)
+    {
+        typedef Opm::DenseAd::Evaluation<Scalar, 1> Evaluation;
+        typedef Opm::CompositionalFluidState<Evaluation, FluidSystem, /*energy=*/false> FlashFluidState;
+
+        FlashFluidState flashFs;
+        flashFs.setTemperature(T);
+        setSaturations_(flashFs, Evaluation((phaseIdx == gasPhaseIdx) ? 1.0 : 0.0));
+        typename FluidSystem::template ParameterCache<Evaluation> flashParamCache;
+
+        for (unsigned nIdx = 0; nIdx < maxIterations_; ++nIdx) {
+            Evaluation pEval = Evaluation::createVariable(p, /*varIdx=*/0);
+            updatePressures_<MaterialLaw>(flashFs, matParams, pEval);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                flashFs.setMoleFraction(phaseIdx, compIdx, z[compIdx]);
+            flashParamCache.updatePhase(flashFs, phaseIdx);
+
+            const Evaluation& rho = FluidSystem::density(flashFs, flashParamCache, phaseIdx);
+            Evaluation residual = totalMolarity*flashFs.averageMolarMass(phaseIdx)/rho - 1.0;
+
+            stats.relativeError = std::abs(residual.value());
+            if (stats.relativeError < tolerance) {
+                stats.converged = true;
+                return;
+            }
+
+            if (!(std::abs(residual.derivative(0)) > 0.0)) {
+                stats.linearSolverFailed = true;
+                return;
+            }
+            ++stats.numIterations;
+
+            Scalar deltaP = residual.value()/residual.derivative(0);
+            p -= std::min<Scalar>(0.5*p, std::max<Scalar>(-0.5*p, deltaP));
+        }
+    }
+
+    template <class MaterialLaw, class FluidState, class ParamCache>
+    static void assignOutput_(FluidState& fluidState,
+                              ParamCache& paramCache,
+                              const typename MaterialLaw::Params& matParams,
+                              Scalar T,
+                              Scalar p,
+                              Scalar Sg,
+                              const ComponentVector& x,
+                              const ComponentVector& y)
+    {
+        fluidState.setTemperature(T);
+        setSaturations_(fluidState, Sg);
+        updatePressures_<MaterialLaw>(fluidState, matParams, p);
+        ParentType::assignOutput_(fluidState, paramCache, x, y, liquidPhaseIdx, gasPhaseIdx);
+    }
+};
+
+} // namespace Opm
+
+#endif
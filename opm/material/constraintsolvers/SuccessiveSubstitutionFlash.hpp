@@ -0,0 +1,668 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::SuccessiveSubstitutionFlash
+ */
+#ifndef OPM_SUCCESSIVE_SUBSTITUTION_FLASH_HPP
+#define OPM_SUCCESSIVE_SUBSTITUTION_FLASH_HPP
+
+#include <opm/material/constraintsolvers/FlashCache.hpp>
+#include <opm/material/constraintsolvers/FlashStatistics.hpp>
+#include <opm/material/fluidstates/CompositionalFluidState.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+#include <opm/common/Valgrind.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace Opm {
+
+/*!
+ * \brief Determines the compositions of a liquid and a gas phase which are in
+ *        equilibrium at a given pressure and temperature.
+ *
+ * In contrast to NcpFlash, the overall mole fractions of the components and the
+ * pressure are given. The solver first checks whether the mixture is stable as a
+ * single phase using Michelsen's tangent plane criterion. If it is, no flash
+ * calculation is done at all. Otherwise, the natural logarithms of the equilibrium
+ * ratios \f$K_\kappa = y_\kappa/x_\kappa\f$ are determined by successive substitution
+ * of the fugacity ratios, which is accelerated by the dominant eigenvalue method
+ * (GDEM). Close to the solution, the solver switches to the Newton method.
+ *
+ * The successive substitution steps only require the fugacity coefficients while
+ * the Newton steps require their derivatives with regard to the equilibrium ratios,
+ * i.e., the number of Jacobian matrices which need to be assembled using automatic
+ * differentiation is small.
+ *
+ * The fluid system must provide the critical temperature and pressure as well as
+ * the acentric factors of all components. These are used to get the initial
+ * equilibrium ratios using Wilson's correlation.
+ *
+ * See:
+ *
+ * M. L. Michelsen: The isothermal flash problem. Part I. Stability, Fluid Phase
+ * Equilibria 9 (1982), pp. 1-19
+ *
+ * C. M. Crowe, M. Nishio: Convergence promotion in the simulation of chemical
+ * processes - the general dominant eigenvalue method, AIChE Journal 21 (1975),
+ * pp. 528-533
+ */
+template <class Scalar, class FluidSystem>
+class SuccessiveSubstitutionFlash
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem, /*energy=*/false> TmpFluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> TmpParamCache;
+
+    static const unsigned maxIterations_ = 200;
+    static const unsigned maxStabilityIterations_ = 100;
+    static const unsigned gdemInterval_ = 5;
+
+public:
+    /*!
+     * \brief Calculates the phase equilibrium of a liquid and a gas phase.
+     *
+     * The temperature and the pressures of both phases must be set in
+     * 'fluidState'. 'globalMoleFractions' are the overall mole fractions of all
+     * components. After the flash calculation converged, the mole fractions, the
+     * fugacity coefficients and the densities of the two phases are set and
+     * 'vaporFraction' is the fraction of the total number of moles which is in the
+     * gas phase. If the mixture is stable as a single phase, both phases get the
+     * overall composition and the vapor fraction is either 0 or 1. The saturations
+     * and the quantities of all other phases are not modified.
+     *
+     * If the calculation fails, this is indicated by 'stats' and 'fluidState' is left
+     * unmodified.
+     */
+    template <class FluidState>
+    static void solve(FluidState& fluidState,
+                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                      const ComponentVector& globalMoleFractions,
+                      unsigned liquidPhaseIdx,
+                      unsigned gasPhaseIdx,
+                      Scalar& vaporFraction,
+                      FlashStatistics<Scalar>& stats,
+                      Scalar tolerance = -1.0)
+    {
+        ComponentVector lnK;
+        wilsonLnK_(lnK,
+                   fluidState.temperature(liquidPhaseIdx),
+                   fluidState.pressure(liquidPhaseIdx));
+
+        solve_(fluidState, paramCache, globalMoleFractions, liquidPhaseIdx, gasPhaseIdx,
+               lnK, /*checkStability=*/true, liquidPhaseIdx, vaporFraction, stats, tolerance);
+    }
+
+    /*!
+     * \brief Calculates the phase equilibrium of a liquid and a gas phase using the
+     *        results of previous flash calculations.
+     *
+     * If the cache holds the result for a similar pressure, temperature and
+     * composition, the stability test is skipped. If the cached result is
+     * single-phase, it is used directly. If it is two-phase, its equilibrium ratios
+     * are either used directly to split the phases (if the cache is configured for
+     * this) or as the initial guess of the flash calculation. Otherwise, the full
+     * flash calculation is done and its result is added to the cache.
+     */
+    template <class FluidState>
+    static void solve(FluidState& fluidState,
+                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                      const ComponentVector& globalMoleFractions,
+                      unsigned liquidPhaseIdx,
+                      unsigned gasPhaseIdx,
+                      Scalar& vaporFraction,
+                      FlashStatistics<Scalar>& stats,
+                      FlashCache<Scalar, numComponents>& cache,
+                      Scalar tolerance = -1.0)
+    {
+        typedef typename FlashCache<Scalar, numComponents>::Entry CacheEntry;
+
+        const ComponentVector& z = globalMoleFractions;
+        Scalar T = fluidState.temperature(liquidPhaseIdx);
+        Scalar p = fluidState.pressure(liquidPhaseIdx);
+
+        ComponentVector lnK;
+        const CacheEntry* entry = cache.lookup(p, T, z);
+        if (!entry) {
+            wilsonLnK_(lnK, T, p);
+            solve_(fluidState, paramCache, z, liquidPhaseIdx, gasPhaseIdx,
+                   lnK, /*checkStability=*/true, liquidPhaseIdx, vaporFraction, stats, tolerance);
+            if (stats.converged)
+                cache.insert(p, T, z, lnK, vaporFraction);
+            return;
+        }
+
+        stats = FlashStatistics<Scalar>();
+        if (entry->isTwoPhase() && cache.directLookup()) {
+            Scalar V = solveRachfordRice_(entry->lnK, z, entry->vaporFraction);
+            if (V > 0.0 && V < 1.0) {
+                ComponentVector x, y;
+                computeCompositions_(x, y, entry->lnK, z, V);
+                vaporFraction = V;
+                assignOutput_(fluidState, paramCache, x, y, liquidPhaseIdx, gasPhaseIdx);
+                stats.converged = true;
+                return;
+            }
+        }
+        else if (!entry->isTwoPhase()) {
+            vaporFraction = entry->vaporFraction;
+            assignOutput_(fluidState, paramCache, z, z, liquidPhaseIdx, gasPhaseIdx);
+            stats.converged = true;
+            return;
+        }
+
+        lnK = entry->lnK;
+        unsigned feedPhaseIdx = (entry->vaporFraction >= 0.5) ? gasPhaseIdx : liquidPhaseIdx;
+        solve_(fluidState, paramCache, z, liquidPhaseIdx, gasPhaseIdx,
+               lnK, /*checkStability=*/false, feedPhaseIdx, vaporFraction, stats, tolerance);
+    }
+
+protected:
+    // the flash calculation starting at the given equilibrium ratios. if the stability
+    // test is skipped, 'feedPhaseIdx' is the phase which is used if the solution
+    // turns out to be trivial. on exit, 'lnK' are the final equilibrium ratios.
+    template <class FluidState>
+    static void solve_(FluidState& fluidState,
+                       typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                       const ComponentVector& z,
+                       unsigned liquidPhaseIdx,
+                       unsigned gasPhaseIdx,
+                       ComponentVector& lnK,
+                       bool checkStability,
+                       unsigned feedPhaseIdx,
+                       Scalar& vaporFraction,
+                       FlashStatistics<Scalar>& stats,
+                       Scalar tolerance)
+    {
+        stats = FlashStatistics<Scalar>();
+
+        if (tolerance <= 0)
+            tolerance = std::max<Scalar>(1e-10,
+                                         1e3*std::numeric_limits<Scalar>::epsilon());
+
+        TmpFluidState tmpFs;
+        tmpFs.setTemperature(fluidState.temperature(liquidPhaseIdx));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            tmpFs.setPressure(phaseIdx, fluidState.pressure(phaseIdx));
+        TmpParamCache tmpParamCache;
+
+        // check whether the mixture splits into two phases at all
+        if (checkStability
+            && isStable_(lnK, feedPhaseIdx, tmpFs, tmpParamCache, z, liquidPhaseIdx, gasPhaseIdx, stats))
+        {
+            vaporFraction = (feedPhaseIdx == gasPhaseIdx) ? 1.0 : 0.0;
+            assignOutput_(fluidState, paramCache, z, z, liquidPhaseIdx, gasPhaseIdx);
+            stats.converged = true;
+            return;
+        }
+
+        // determine the equilibrium ratios
+        Scalar V = 0.5;
+        ComponentVector x, y;
+        ComponentVector lnPhiL, lnPhiV;
+        ComponentVector delta, lastDelta;
+        Scalar newtonThreshold = 1e-2;
+        bool useNewton = false;
+        unsigned numSubstitutions = 0;
+        for (unsigned iterIdx = 0; iterIdx < maxIterations_; ++iterIdx) {
+            if (useNewton) {
+                Scalar lastError = stats.relativeError;
+                if (!newtonStep_(lnK, V, stats, z, liquidPhaseIdx, gasPhaseIdx, fluidState)) {
+                    // go back to successive substitution and only try the Newton
+                    // method again when it is closer to the solution
+                    useNewton = false;
+                    newtonThreshold /= 10;
+                    numSubstitutions = 0;
+                    continue;
+                }
+
+                if (stats.relativeError < tolerance) {
+                    stats.converged = true;
+                    break;
+                }
+                if (stats.relativeError > lastError) {
+                    useNewton = false;
+                    newtonThreshold /= 10;
+                    numSubstitutions = 0;
+                }
+                continue;
+            }
+
+            // successive substitution step
+            V = solveRachfordRice_(lnK, z, V);
+            computeCompositions_(x, y, lnK, z, V);
+            computeLnPhiP_(lnPhiL, tmpFs, tmpParamCache, liquidPhaseIdx, x);
+            computeLnPhiP_(lnPhiV, tmpFs, tmpParamCache, gasPhaseIdx, y);
+
+            Scalar maxDelta = 0.0;
+            Scalar sumLnKSquared = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                Scalar newLnK = lnPhiL[compIdx] - lnPhiV[compIdx];
+                delta[compIdx] = newLnK - lnK[compIdx];
+                lnK[compIdx] = newLnK;
+
+                maxDelta = std::max(maxDelta, std::abs(delta[compIdx]));
+                sumLnKSquared += newLnK*newLnK;
+            }
+            ++stats.numIterations;
+            ++numSubstitutions;
+            stats.relativeError = maxDelta;
+
+            if (sumLnKSquared < 1e-4)
+                // the solution approaches the trivial one, i.e., the mixture is a
+                // single phase after all
+                break;
+
+            if (maxDelta < tolerance) {
+                stats.converged = true;
+                break;
+            }
+            if (maxDelta < newtonThreshold) {
+                useNewton = true;
+                continue;
+            }
+
+            // accelerate the fixed point iteration by extrapolating along the
+            // dominant eigenvector of the iteration
+            if (numSubstitutions%gdemInterval_ == 0) {
+                Scalar num = 0.0;
+                Scalar denom = 0.0;
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                    num += delta[compIdx]*delta[compIdx];
+                    denom += lastDelta[compIdx]*delta[compIdx];
+                }
+
+                if (denom > 0.0) {
+                    Scalar lambda = num/denom;
+                    if (lambda < 1.0)
+                        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                            lnK[compIdx] += delta[compIdx]*lambda/(1.0 - lambda);
+                }
+            }
+            lastDelta = delta;
+        }
+
+        V = solveRachfordRice_(lnK, z, V);
+        if (stats.converged && (V <= 0.0 || V >= 1.0)) {
+            // the phase split is outside of the physical range, i.e., a single phase
+            // is present.
+            vaporFraction = (V >= 1.0) ? 1.0 : 0.0;
+            assignOutput_(fluidState, paramCache, z, z, liquidPhaseIdx, gasPhaseIdx);
+            return;
+        }
+        if (!stats.converged) {
+            Scalar sumLnKSquared = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                sumLnKSquared += lnK[compIdx]*lnK[compIdx];
+            if (sumLnKSquared >= 1e-4)
+                return;
+
+            // trivial solution: use the phase which is preferred by the feed
+            vaporFraction = (feedPhaseIdx == gasPhaseIdx) ? 1.0 : 0.0;
+            assignOutput_(fluidState, paramCache, z, z, liquidPhaseIdx, gasPhaseIdx);
+            stats.converged = true;
+            return;
+        }
+
+        vaporFraction = V;
+        computeCompositions_(x, y, lnK, z, V);
+        assignOutput_(fluidState, paramCache, x, y, liquidPhaseIdx, gasPhaseIdx);
+    }
+
+    // the initial equilibrium ratios using Wilson's correlation
+    static void wilsonLnK_(ComponentVector& lnK, Scalar T, Scalar p)
+    {
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar Tc = FluidSystem::criticalTemperature(compIdx);
+            Scalar pc = FluidSystem::criticalPressure(compIdx);
+            Scalar omega = FluidSystem::acentricFactor(compIdx);
+            lnK[compIdx] = std::log(pc/p) + 5.373*(1 + omega)*(1 - Tc/T);
+        }
+    }
+
+    // compute the natural logarithms of the fugacity coefficients times the phase
+    // pressure, i.e., of the fugacities divided by the mole fractions, of all
+    // components if the phase exhibits the given composition
+    template <class FluidState, class ParamCache, class EvalVector>
+    static void computeLnPhiP_(EvalVector& lnPhiP,
+                               FluidState& fluidState,
+                               ParamCache& paramCache,
+                               unsigned phaseIdx,
+                               const EvalVector& moleFractions)
+    {
+        typedef typename EvalVector::value_type Evaluation;
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            fluidState.setMoleFraction(phaseIdx, compIdx, moleFractions[compIdx]);
+
+        paramCache.updatePhase(fluidState, phaseIdx);
+        Evaluation lnP = Opm::log(fluidState.pressure(phaseIdx));
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            lnPhiP[compIdx] =
+                Opm::log(FluidSystem::fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx))
+                + lnP;
+    }
+
+    // the Rachford-Rice function and its derivative with regard to the vapor fraction
+    template <class Evaluation>
+    static Evaluation rachfordRice_(const Dune::FieldVector<Evaluation, numComponents>& K,
+                                    const ComponentVector& z,
+                                    Scalar V)
+    {
+        Evaluation result = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            result += z[compIdx]*(K[compIdx] - 1.0)/(1.0 + V*(K[compIdx] - 1.0));
+        return result;
+    }
+
+    static Scalar rachfordRiceDerivative_(const ComponentVector& K,
+                                          const ComponentVector& z,
+                                          Scalar V)
+    {
+        Scalar result = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar tmp = (K[compIdx] - 1.0)/(1.0 + V*(K[compIdx] - 1.0));
+            result -= z[compIdx]*tmp*tmp;
+        }
+        return result;
+    }
+
+    // determine the vapor fraction for given equilibrium ratios. the vapor fraction
+    // may be outside of [0, 1] ("negative flash"), but it is always inside the range
+    // for which all phase compositions are positive.
+    static Scalar solveRachfordRice_(const ComponentVector& lnK,
+                                     const ComponentVector& z,
+                                     Scalar V)
+    {
+        ComponentVector K;
+        Scalar Kmin = std::numeric_limits<Scalar>::max();
+        Scalar Kmax = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            K[compIdx] = std::exp(lnK[compIdx]);
+            if (z[compIdx] <= 0.0)
+                continue;
+            Kmin = std::min(Kmin, K[compIdx]);
+            Kmax = std::max(Kmax, K[compIdx]);
+        }
+
+        if (Kmax <= 1.0)
+            return 0.0; // everything is liquid
+        if (Kmin >= 1.0)
+            return 1.0; // everything is gas
+
+        // the Rachford-Rice function is monotonically decreasing between its poles
+        Scalar Vlow = 1.0/(1.0 - Kmax);
+        Scalar Vhigh = 1.0/(1.0 - Kmin);
+        if (!(Vlow < V && V < Vhigh))
+            V = (Vlow + Vhigh)/2;
+        for (unsigned i = 0; i < 100; ++i) {
+            Scalar g = rachfordRice_(K, z, V);
+            if (g > 0.0)
+                Vlow = V;
+            else
+                Vhigh = V;
+
+            // Newton step, use bisection if it leaves the bracket
+            Scalar newV = V - g/rachfordRiceDerivative_(K, z, V);
+            if (!(Vlow < newV && newV < Vhigh))
+                newV = (Vlow + Vhigh)/2;
+
+            bool converged = std::abs(newV - V) <= 10*std::numeric_limits<Scalar>::epsilon()*(1.0 + std::abs(V));
+            V = newV;
+            if (converged)
+                break;
+        }
+
+        return V;
+    }
+
+    template <class EvalVector>
+    static void computeCompositions_(EvalVector& x,
+                                     EvalVector& y,
+                                     const EvalVector& K,
+                                     const ComponentVector& z,
+                                     const typename EvalVector::value_type& V,
+                                     bool kIsLogarithmic = true)
+    {
+        typedef typename EvalVector::value_type Evaluation;
+
+        Evaluation sumX = 0.0;
+        Evaluation sumY = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Evaluation Ki = kIsLogarithmic ? Opm::exp(K[compIdx]) : K[compIdx];
+            x[compIdx] = z[compIdx]/(1.0 + V*(Ki - 1.0));
+            y[compIdx] = Ki*x[compIdx];
+            sumX += x[compIdx];
+            sumY += y[compIdx];
+        }
+
+        // if the vapor fraction is outside of the physical range, the compositions do
+        // not sum up to 1
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            x[compIdx] /= sumX;
+            y[compIdx] /= sumY;
+        }
+    }
+
+    // the tangent plane stability test. the equilibrium ratios are updated by the
+    // result of the test if the mixture is unstable.
+    template <class ParamCache>
+    static bool isStable_(ComponentVector& lnK,
+                          unsigned& feedPhaseIdx,
+                          TmpFluidState& tmpFs,
+                          ParamCache& tmpParamCache,
+                          const ComponentVector& z,
+                          unsigned liquidPhaseIdx,
+                          unsigned gasPhaseIdx,
+                          FlashStatistics<Scalar>& stats)
+    {
+        // the feed is assumed to be the phase with the lower Gibbs energy
+        ComponentVector lnPhiL, lnPhiV;
+        computeLnPhiP_(lnPhiL, tmpFs, tmpParamCache, liquidPhaseIdx, z);
+        computeLnPhiP_(lnPhiV, tmpFs, tmpParamCache, gasPhaseIdx, z);
+        Scalar gL = 0.0;
+        Scalar gV = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            if (z[compIdx] <= 0.0)
+                continue;
+            gL += z[compIdx]*lnPhiL[compIdx];
+            gV += z[compIdx]*lnPhiV[compIdx];
+        }
+        feedPhaseIdx = (gL <= gV) ? liquidPhaseIdx : gasPhaseIdx;
+        const ComponentVector& lnPhiZ = (feedPhaseIdx == liquidPhaseIdx) ? lnPhiL : lnPhiV;
+
+        // try a gas-like and a liquid-like trial phase
+        ComponentVector Y, lnY, y, lnPhiY;
+        for (unsigned trialIdx = 0; trialIdx < 2; ++trialIdx) {
+            unsigned trialPhaseIdx = (trialIdx == 0) ? gasPhaseIdx : liquidPhaseIdx;
+            Scalar sign = (trialIdx == 0) ? 1.0 : -1.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                Y[compIdx] = (z[compIdx] > 0.0) ? z[compIdx]*std::exp(sign*lnK[compIdx]) : 0.0;
+
+            bool trivial = false;
+            for (unsigned iterIdx = 0; iterIdx < maxStabilityIterations_; ++iterIdx) {
+                Scalar sumY = 0.0;
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                    sumY += Y[compIdx];
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                    y[compIdx] = Y[compIdx]/sumY;
+
+                computeLnPhiP_(lnPhiY, tmpFs, tmpParamCache, trialPhaseIdx, y);
+                ++stats.numIterations;
+
+                Scalar maxDelta = 0.0;
+                Scalar distance = 0.0;
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                    if (z[compIdx] <= 0.0)
+                        continue;
+                    Scalar lnZ = std::log(z[compIdx]);
+                    Scalar newLnY = lnZ + lnPhiZ[compIdx] - lnPhiY[compIdx];
+                    maxDelta = std::max(maxDelta, std::abs(newLnY - std::log(Y[compIdx])));
+                    distance += (newLnY - lnZ)*(newLnY - lnZ);
+                    Y[compIdx] = std::exp(newLnY);
+                    lnY[compIdx] = newLnY;
+                }
+
+                if (distance < 1e-4) {
+                    // the trial phase converges to the feed
+                    trivial = true;
+                    break;
+                }
+                if (maxDelta < 1e-10)
+                    break;
+            }
+
+            Scalar sumY = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                sumY += Y[compIdx];
+            if (trivial || sumY <= 1.0 + 1e-8)
+                continue;
+
+            // the mixture is unstable. use the trial phase to get the initial
+            // equilibrium ratios.
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                if (z[compIdx] <= 0.0)
+                    continue;
+                lnK[compIdx] = sign*(lnY[compIdx] - std::log(z[compIdx]));
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    // do a Newton step for the natural logarithms of the equilibrium ratios. false is
+    // returned if the linear system of equations could not be solved. in this case,
+    // the solver falls back to successive substitution.
+    template <class FluidState>
+    static bool newtonStep_(ComponentVector& lnK,
+                            Scalar& V,
+                            FlashStatistics<Scalar>& stats,
+                            const ComponentVector& z,
+                            unsigned liquidPhaseIdx,
+                            unsigned gasPhaseIdx,
+                            const FluidState& inputFluidState)
+    {
+        typedef Opm::DenseAd::Evaluation<Scalar, numComponents> Evaluation;
+        typedef Dune::FieldVector<Evaluation, numComponents> EvalVector;
+        typedef Dune::FieldMatrix<Scalar, numComponents, numComponents> Matrix;
+        typedef Opm::CompositionalFluidState<Evaluation, FluidSystem, /*energy=*/false> FlashFluidState;
+
+        FlashFluidState flashFs;
+        flashFs.setTemperature(inputFluidState.temperature(liquidPhaseIdx));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            flashFs.setPressure(phaseIdx, inputFluidState.pressure(phaseIdx));
+        typename FluidSystem::template ParameterCache<Evaluation> flashParamCache;
+
+        EvalVector lnKEval, K;
+        ComponentVector Kvalue;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            lnKEval[compIdx] = Evaluation::createVariable(lnK[compIdx], compIdx);
+            K[compIdx] = Opm::exp(lnKEval[compIdx]);
+            Kvalue[compIdx] = K[compIdx].value();
+        }
+
+        // the vapor fraction is an implicit function of the equilibrium ratios. at
+        // the root of the Rachford-Rice function, a single Newton step yields its
+        // derivatives.
+        V = solveRachfordRice_(lnK, z, V);
+        Evaluation VEval = V - rachfordRice_(K, z, V)/rachfordRiceDerivative_(Kvalue, z, V);
+
+        EvalVector x, y;
+        computeCompositions_(x, y, K, z, VEval, /*kIsLogarithmic=*/false);
+
+        EvalVector lnPhiL, lnPhiV;
+        computeLnPhiP_(lnPhiL, flashFs, flashParamCache, liquidPhaseIdx, x);
+        computeLnPhiP_(lnPhiV, flashFs, flashParamCache, gasPhaseIdx, y);
+
+        // the residual is zero if the fugacities of all components are the same in
+        // both phases
+        Matrix J;
+        ComponentVector b, deltaLnK;
+        Scalar maxResidual = 0.0;
+        for (unsigned eqIdx = 0; eqIdx < numComponents; ++eqIdx) {
+            Evaluation residual = lnKEval[eqIdx] + lnPhiV[eqIdx] - lnPhiL[eqIdx];
+            for (unsigned pvIdx = 0; pvIdx < numComponents; ++pvIdx)
+                J[eqIdx][pvIdx] = residual.derivative(pvIdx);
+            b[eqIdx] = residual.value();
+            maxResidual = std::max(maxResidual, std::abs(b[eqIdx]));
+        }
+        ++stats.numIterations;
+        stats.relativeError = maxResidual;
+
+        deltaLnK = 0.0;
+        try { J.solve(deltaLnK, b); }
+        catch (const Dune::FMatrixError&) {
+            return false;
+        }
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            if (!std::isfinite(deltaLnK[compIdx]))
+                return false;
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            lnK[compIdx] -= deltaLnK[compIdx];
+
+        return true;
+    }
+
+    template <class FluidState, class ParamCache>
+    static void assignOutput_(FluidState& fluidState,
+                              ParamCache& paramCache,
+                              const ComponentVector& x,
+                              const ComponentVector& y,
+                              unsigned liquidPhaseIdx,
+                              unsigned gasPhaseIdx)
+    {
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            fluidState.setMoleFraction(liquidPhaseIdx, compIdx, x[compIdx]);
+            fluidState.setMoleFraction(gasPhaseIdx, compIdx, y[compIdx]);
+        }
+
+        for (unsigned i = 0; i < 2; ++i) {
+            unsigned phaseIdx = (i == 0) ? liquidPhaseIdx : gasPhaseIdx;
+            paramCache.updatePhase(fluidState, phaseIdx);
+            fluidState.setDensity(phaseIdx, FluidSystem::density(fluidState, paramCache, phaseIdx));
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fluidState.setFugacityCoefficient(phaseIdx,
+                                                  compIdx,
+                                                  FluidSystem::fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx));
+        }
+    }
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,170 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Evaluation of functions of few arguments using evaluations which only
+ *        consider derivatives with regard to these arguments.
+ *
+ * Many constitutive relations, e.g., the black-oil PVT relations, only depend on two
+ * or three quantities while the caller's evaluations carry the derivatives with
+ * regard to all primary variables of a cell. Instead of propagating all of them
+ * through the function, each argument is narrowed to an evaluation with one
+ * derivative per argument, and the derivatives of the result are expanded to the
+ * caller's primary variables afterwards using the chain rule, e.g.
+ *
+ * \code
+ * typedef Opm::DenseAd::Evaluation<double, 6> Evaluation;
+ * typedef Opm::ReducedEvaluation<Evaluation, 2>::type ReducedEvaluation;
+ *
+ * Evaluation x = ..., y = ...;
+ * ReducedEvaluation f = g(Opm::narrowToVariable<ReducedEvaluation>(x, 0),
+ *                         Opm::narrowToVariable<ReducedEvaluation>(y, 1));
+ * Evaluation z = Opm::expandDerivatives<Evaluation>(f, x, y);
+ * \endcode
+ *
+ * The arguments passed to expandDerivatives() must be the ones which were narrowed,
+ * in the order of their variable indices. Scalar arguments are passed through and
+ * treated as constants.
+ */
+#ifndef OPM_DENSEAD_DERIVATIVE_EXPANSION_HPP
+#define OPM_DENSEAD_DERIVATIVE_EXPANSION_HPP
+
+#include "Evaluation.hpp"
+
+#include <type_traits>
+
+namespace Opm {
+
+/*!
+ * \brief The type of an evaluation which only considers the derivatives with regard
+ *        to a given number of variables.
+ *
+ * For scalars, this is the scalar type itself.
+ */
+template <class Evaluation, int numReducedVars>
+struct ReducedEvaluation
+{
+    static_assert(std::is_floating_point<Evaluation>::value,
+                  "Only floating point scalars and dense-AD evaluations are supported");
+
+    typedef Evaluation type;
+};
+
+template <class ValueT, int numVars, int numReducedVars>
+struct ReducedEvaluation<DenseAd::Evaluation<ValueT, numVars>, numReducedVars>
+{
+    static_assert(std::is_floating_point<ValueT>::value,
+                  "Nested evaluations cannot be reduced");
+
+    typedef DenseAd::Evaluation<ValueT, numReducedVars> type;
+};
+
+/*!
+ * \brief Pass through a scalar argument.
+ *
+ * Scalars do not depend on any primary variable, so they are not converted. This
+ * allows to narrow the arguments of functions which expect some of them to be scalars.
+ */
+template <class ReducedEval, class Scalar>
+typename std::enable_if<std::is_floating_point<Scalar>::value, const Scalar&>::type
+narrowToVariable(const Scalar& value, int /*varIdx*/)
+{ return value; }
+
+/*!
+ * \brief Convert an argument to the variable of the reduced evaluation type with a
+ *        given index.
+ *
+ * The value is retained while the derivatives with regard to the caller's primary
+ * variables are discarded. They must be accounted for by expandDerivatives().
+ */
+template <class ReducedEval, class ValueT, int numVars>
+ReducedEval narrowToVariable(const DenseAd::Evaluation<ValueT, numVars>& eval, int varIdx)
+{ return ReducedEval::createVariable(eval.value(), varIdx); }
+
+namespace DerivativeExpansionDetail {
+template <class Evaluation, class Scalar>
+typename std::enable_if<std::is_floating_point<Scalar>::value>::type
+addTerm(Evaluation& /*result*/,
+        const typename Evaluation::ValueType& /*dfdArg*/,
+        const Scalar& /*arg*/)
+{ }
+
+template <class Evaluation>
+void addTerm(Evaluation& result,
+             const typename Evaluation::ValueType& dfdArg,
+             const Evaluation& arg)
+{
+    for (int varIdx = 0; varIdx < Evaluation::size; ++varIdx)
+        result.setDerivative(varIdx, result.derivative(varIdx) + dfdArg*arg.derivative(varIdx));
+}
+
+template <class Evaluation, class ReducedEval>
+void addTerms(Evaluation& /*result*/, const ReducedEval& /*reduced*/, int /*argIdx*/)
+{ }
+
+template <class Evaluation, class ReducedEval, class Arg, class... Args>
+void addTerms(Evaluation& result,
+              const ReducedEval& reduced,
+              int argIdx,
+              const Arg& arg,
+              const Args&... args)
+{
+    addTerm(result, reduced.derivative(argIdx), arg);
+    addTerms(result, reduced, argIdx + 1, args...);
+}
+} // namespace DerivativeExpansionDetail
+
+/*!
+ * \brief Return the result of a function evaluated using reduced evaluations as a
+ *        scalar.
+ *
+ * If the caller does not consider derivatives, there is nothing to expand.
+ */
+template <class Evaluation, class... Args>
+typename std::enable_if<std::is_floating_point<Evaluation>::value, Evaluation>::type
+expandDerivatives(const Evaluation& reduced, const Args&... /*args*/)
+{ return reduced; }
+
+/*!
+ * \brief Expand the derivatives of a function evaluated using reduced evaluations to
+ *        the primary variables of its arguments.
+ *
+ * i.e., the derivative of the result with regard to the primary variable j is
+ * \f$\sum_i \partial f/\partial a_i \cdot \partial a_i/\partial x_j\f$.
+ */
+template <class Evaluation, class ReducedEval, class... Args>
+typename std::enable_if<!std::is_floating_point<Evaluation>::value, Evaluation>::type
+expandDerivatives(const ReducedEval& reduced, const Args&... args)
+{
+    static_assert(ReducedEval::size == sizeof...(Args),
+                  "The number of arguments must match the number of reduced variables");
+
+    Evaluation result = Evaluation::createConstant(reduced.value());
+    DerivativeExpansionDetail::addTerms(result, reduced, /*argIdx=*/0, args...);
+    return result;
+}
+
+} // namespace Opm
+
+#endif
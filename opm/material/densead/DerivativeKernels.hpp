@@ -0,0 +1,403 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Explicitly vectorized kernels for the derivative part of dense-AD evaluations.
+ *
+ * These kernels are only used if the OPM_DENSEAD_USE_SIMD macro is set to a non-zero
+ * value at compile time. The instruction set is then selected by the flags which the
+ * compiler has been invoked with (AVX-512F, AVX, SSE2 or ARM NEON on AArch64). For
+ * value types other than float and double, or if no suitable instruction set is
+ * available, the kernels fall back to plain loops.
+ *
+ * The kernels only apply separate multiplications, additions and divisions to the
+ * derivatives, i.e., unless the compiler is allowed to contract the scalar code into
+ * fused multiply-add instructions, the results are bit-identical to the ones of the
+ * scalar code. The function values are never touched by the SIMD code.
+ *
+ * If OPM_DENSEAD_ALIGN_STORAGE is additionally set to a non-zero value, the storage of
+ * the Evaluation objects is padded to a multiple of the SIMD register width and aligned
+ * accordingly. The kernels can then process the complete storage of an evaluation using
+ * full registers; the function value is recomputed by scalar code afterwards. Aligned
+ * load and store instructions are only used if the compiler guarantees that dynamically
+ * allocated memory honors the alignment of over-aligned types (i.e., C++17).
+ */
+#ifndef OPM_DENSEAD_DERIVATIVE_KERNELS_HPP
+#define OPM_DENSEAD_DERIVATIVE_KERNELS_HPP
+
+#ifndef OPM_DENSEAD_USE_SIMD
+#define OPM_DENSEAD_USE_SIMD 0
+#endif
+
+#ifndef OPM_DENSEAD_ALIGN_STORAGE
+#define OPM_DENSEAD_ALIGN_STORAGE 0
+#endif
+
+#if OPM_DENSEAD_USE_SIMD
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#endif
+
+#include <cstddef>
+
+namespace Opm {
+namespace DenseAd {
+/*!
+ * \brief Abstraction of a SIMD register for a given scalar type.
+ *
+ * The generic case does not provide a vectorized implementation at all.
+ */
+template <class Scalar>
+struct SimdPack
+{
+    static constexpr int width = 0;
+};
+
+#if OPM_DENSEAD_USE_SIMD
+#if defined(__AVX512F__)
+template <>
+struct SimdPack<double>
+{
+    typedef __m512d Register;
+    static constexpr int width = 8;
+
+    static Register load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, Register a) { _mm512_storeu_pd(p, a); }
+    static Register loadAligned(const double* p) { return _mm512_load_pd(p); }
+    static void storeAligned(double* p, Register a) { _mm512_store_pd(p, a); }
+    static Register broadcast(double a) { return _mm512_set1_pd(a); }
+    static Register add(Register a, Register b) { return _mm512_add_pd(a, b); }
+    static Register sub(Register a, Register b) { return _mm512_sub_pd(a, b); }
+    static Register mul(Register a, Register b) { return _mm512_mul_pd(a, b); }
+    static Register div(Register a, Register b) { return _mm512_div_pd(a, b); }
+};
+
+template <>
+struct SimdPack<float>
+{
+    typedef __m512 Register;
+    static constexpr int width = 16;
+
+    static Register load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, Register a) { _mm512_storeu_ps(p, a); }
+    static Register loadAligned(const float* p) { return _mm512_load_ps(p); }
+    static void storeAligned(float* p, Register a) { _mm512_store_ps(p, a); }
+    static Register broadcast(float a) { return _mm512_set1_ps(a); }
+    static Register add(Register a, Register b) { return _mm512_add_ps(a, b); }
+    static Register sub(Register a, Register b) { return _mm512_sub_ps(a, b); }
+    static Register mul(Register a, Register b) { return _mm512_mul_ps(a, b); }
+    static Register div(Register a, Register b) { return _mm512_div_ps(a, b); }
+};
+#elif defined(__AVX__)
+template <>
+struct SimdPack<double>
+{
+    typedef __m256d Register;
+    static constexpr int width = 4;
+
+    static Register load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, Register a) { _mm256_storeu_pd(p, a); }
+    static Register loadAligned(const double* p) { return _mm256_load_pd(p); }
+    static void storeAligned(double* p, Register a) { _mm256_store_pd(p, a); }
+    static Register broadcast(double a) { return _mm256_set1_pd(a); }
+    static Register add(Register a, Register b) { return _mm256_add_pd(a, b); }
+    static Register sub(Register a, Register b) { return _mm256_sub_pd(a, b); }
+    static Register mul(Register a, Register b) { return _mm256_mul_pd(a, b); }
+    static Register div(Register a, Register b) { return _mm256_div_pd(a, b); }
+};
+
+template <>
+struct SimdPack<float>
+{
+    typedef __m256 Register;
+    static constexpr int width = 8;
+
+    static Register load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Register a) { _mm256_storeu_ps(p, a); }
+    static Register loadAligned(const float* p) { return _mm256_load_ps(p); }
+    static void storeAligned(float* p, Register a) { _mm256_store_ps(p, a); }
+    static Register broadcast(float a) { return _mm256_set1_ps(a); }
+    static Register add(Register a, Register b) { return _mm256_add_ps(a, b); }
+    static Register sub(Register a, Register b) { return _mm256_sub_ps(a, b); }
+    static Register mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+    static Register div(Register a, Register b) { return _mm256_div_ps(a, b); }
+};
+#elif defined(__SSE2__)
+template <>
+struct SimdPack<double>
+{
+    typedef __m128d Register;
+    static constexpr int width = 2;
+
+    static Register load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, Register a) { _mm_storeu_pd(p, a); }
+    static Register loadAligned(const double* p) { return _mm_load_pd(p); }
+    static void storeAligned(double* p, Register a) { _mm_store_pd(p, a); }
+    static Register broadcast(double a) { return _mm_set1_pd(a); }
+    static Register add(Register a, Register b) { return _mm_add_pd(a, b); }
+    static Register sub(Register a, Register b) { return _mm_sub_pd(a, b); }
+    static Register mul(Register a, Register b) { return _mm_mul_pd(a, b); }
+    static Register div(Register a, Register b) { return _mm_div_pd(a, b); }
+};
+
+template <>
+struct SimdPack<float>
+{
+    typedef __m128 Register;
+    static constexpr int width = 4;
+
+    static Register load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Register a) { _mm_storeu_ps(p, a); }
+    static Register loadAligned(const float* p) { return _mm_load_ps(p); }
+    static void storeAligned(float* p, Register a) { _mm_store_ps(p, a); }
+    static Register broadcast(float a) { return _mm_set1_ps(a); }
+    static Register add(Register a, Register b) { return _mm_add_ps(a, b); }
+    static Register sub(Register a, Register b) { return _mm_sub_ps(a, b); }
+    static Register mul(Register a, Register b) { return _mm_mul_ps(a, b); }
+    static Register div(Register a, Register b) { return _mm_div_ps(a, b); }
+};
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+template <>
+struct SimdPack<double>
+{
+    typedef float64x2_t Register;
+    static constexpr int width = 2;
+
+    static Register load(const double* p) { return vld1q_f64(p); }
+    static void store(double* p, Register a) { vst1q_f64(p, a); }
+    static Register loadAligned(const double* p) { return vld1q_f64(p); }
+    static void storeAligned(double* p, Register a) { vst1q_f64(p, a); }
+    static Register broadcast(double a) { return vdupq_n_f64(a); }
+    static Register add(Register a, Register b) { return vaddq_f64(a, b); }
+    static Register sub(Register a, Register b) { return vsubq_f64(a, b); }
+    static Register mul(Register a, Register b) { return vmulq_f64(a, b); }
+    static Register div(Register a, Register b) { return vdivq_f64(a, b); }
+};
+
+template <>
+struct SimdPack<float>
+{
+    typedef float32x4_t Register;
+    static constexpr int width = 4;
+
+    static Register load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, Register a) { vst1q_f32(p, a); }
+    static Register loadAligned(const float* p) { return vld1q_f32(p); }
+    static void storeAligned(float* p, Register a) { vst1q_f32(p, a); }
+    static Register broadcast(float a) { return vdupq_n_f32(a); }
+    static Register add(Register a, Register b) { return vaddq_f32(a, b); }
+    static Register sub(Register a, Register b) { return vsubq_f32(a, b); }
+    static Register mul(Register a, Register b) { return vmulq_f32(a, b); }
+    static Register div(Register a, Register b) { return vdivq_f32(a, b); }
+};
+#endif
+#endif // OPM_DENSEAD_USE_SIMD
+
+/*!
+ * \brief Specifies the padded length and the alignment of the storage of an evaluation.
+ *
+ * Without OPM_DENSEAD_ALIGN_STORAGE or without SIMD support for the value type, the
+ * storage is neither padded nor over-aligned.
+ */
+template <class ValueType, int length>
+struct PaddedStorage
+{
+#if OPM_DENSEAD_ALIGN_STORAGE
+    static constexpr int registerWidth =
+        (SimdPack<ValueType>::width > 0) ? SimdPack<ValueType>::width : 1;
+#else
+    static constexpr int registerWidth = 1;
+#endif
+
+    //! the number of entries of the storage including the padding
+    static constexpr int paddedLength = ((length + registerWidth - 1)/registerWidth)*registerWidth;
+
+    //! the alignment of the storage in bytes
+    static constexpr std::size_t alignment =
+        (registerWidth > 1) ? registerWidth*sizeof(ValueType) : alignof(ValueType);
+
+    //! specifies whether aligned SIMD loads and stores can be used for the storage
+#if defined(__cpp_aligned_new)
+    static constexpr bool alignedAccess = (registerWidth > 1);
+#else
+    static constexpr bool alignedAccess = false;
+#endif
+};
+
+/*!
+ * \brief The scalar implementation of the derivative kernels.
+ *
+ * All kernels operate on n consecutive entries. The destination and the source arrays
+ * may be identical but must not partially overlap.
+ */
+template <class ValueType, int n, bool aligned = false,
+          bool vectorized = (SimdPack<ValueType>::width > 0)>
+struct DerivativeKernels
+{
+    // a[i] += b[i]
+    static void add(ValueType* a, const ValueType* b)
+    {
+        for (int i = 0; i < n; ++i)
+            a[i] += b[i];
+    }
+
+    // a[i] = a[i]*v + b[i]*u, i.e., the product rule (u*v)' = u'v + v'u
+    static void productRule(ValueType* a, const ValueType* b, const ValueType& v, const ValueType& u)
+    {
+        for (int i = 0; i < n; ++i)
+            a[i] = a[i]*v + b[i]*u;
+    }
+
+    // a[i] = (v*a[i] - u*b[i])/(v*v), i.e., the quotient rule (u/v)' = (vu' - uv')/v^2
+    static void quotientRule(ValueType* a, const ValueType* b, const ValueType& u, const ValueType& v)
+    {
+        for (int i = 0; i < n; ++i)
+            a[i] = (v*a[i] - u*b[i])/(v*v);
+    }
+
+    // a[i] = c*b[i], i.e., the chain rule f(g)' = f'(g)*g'
+    static void scale(ValueType* a, const ValueType* b, const ValueType& c)
+    {
+        for (int i = 0; i < n; ++i)
+            a[i] = c*b[i];
+    }
+
+    // a[i] = b[i]
+    static void copy(ValueType* a, const ValueType* b)
+    {
+        for (int i = 0; i < n; ++i)
+            a[i] = b[i];
+    }
+
+    // a[i] += c*b[i]
+    static void addScaled(ValueType* a, const ValueType* b, const ValueType& c)
+    {
+        for (int i = 0; i < n; ++i)
+            a[i] += c*b[i];
+    }
+};
+
+/*!
+ * \brief The explicitly vectorized implementation of the derivative kernels.
+ *
+ * The entries which do not fill a complete SIMD register are handled by scalar code. If
+ * 'aligned' is true, the arrays must be aligned to the size of a SIMD register.
+ */
+template <class ValueType, int n, bool aligned>
+struct DerivativeKernels<ValueType, n, aligned, /*vectorized=*/true>
+{
+    typedef SimdPack<ValueType> Pack;
+    typedef typename Pack::Register Register;
+
+    static constexpr int simdEnd_ = n - n%Pack::width;
+
+    static Register load_(const ValueType* p)
+    { return aligned ? Pack::loadAligned(p) : Pack::load(p); }
+
+    static void store_(ValueType* p, Register a)
+    {
+        if (aligned)
+            Pack::storeAligned(p, a);
+        else
+            Pack::store(p, a);
+    }
+
+    static void add(ValueType* a, const ValueType* b)
+    {
+        int i = 0;
+        for (; i < simdEnd_; i += Pack::width)
+            store_(a + i, Pack::add(load_(a + i), load_(b + i)));
+        for (; i < n; ++i)
+            a[i] += b[i];
+    }
+
+    static void productRule(ValueType* a, const ValueType* b, const ValueType& v, const ValueType& u)
+    {
+        const Register vv = Pack::broadcast(v);
+        const Register uu = Pack::broadcast(u);
+
+        int i = 0;
+        for (; i < simdEnd_; i += Pack::width)
+            store_(a + i, Pack::add(Pack::mul(load_(a + i), vv),
+                                    Pack::mul(load_(b + i), uu)));
+        for (; i < n; ++i)
+            a[i] = a[i]*v + b[i]*u;
+    }
+
+    static void quotientRule(ValueType* a, const ValueType* b, const ValueType& u, const ValueType& v)
+    {
+        const Register vv = Pack::broadcast(v);
+        const Register uu = Pack::broadcast(u);
+        const Register vSquared = Pack::broadcast(v*v);
+
+        int i = 0;
+        for (; i < simdEnd_; i += Pack::width)
+            store_(a + i, Pack::div(Pack::sub(Pack::mul(vv, load_(a + i)),
+                                              Pack::mul(uu, load_(b + i))),
+                                    vSquared));
+        for (; i < n; ++i)
+            a[i] = (v*a[i] - u*b[i])/(v*v);
+    }
+
+    static void scale(ValueType* a, const ValueType* b, const ValueType& c)
+    {
+        const Register cc = Pack::broadcast(c);
+
+        int i = 0;
+        for (; i < simdEnd_; i += Pack::width)
+            store_(a + i, Pack::mul(cc, load_(b + i)));
+        for (; i < n; ++i)
+            a[i] = c*b[i];
+    }
+
+    static void copy(ValueType* a, const ValueType* b)
+    {
+        int i = 0;
+        for (; i < simdEnd_; i += Pack::width)
+            store_(a + i, load_(b + i));
+        for (; i < n; ++i)
+            a[i] = b[i];
+    }
+
+    static void addScaled(ValueType* a, const ValueType* b, const ValueType& c)
+    {
+        const Register cc = Pack::broadcast(c);
+
+        int i = 0;
+        for (; i < simdEnd_; i += Pack::width)
+            store_(a + i, Pack::add(load_(a + i), Pack::mul(cc, load_(b + i))));
+        for (; i < n; ++i)
+            a[i] += c*b[i];
+    }
+};
+
+} // namespace DenseAd
+} // namespace Opm
+
+#endif
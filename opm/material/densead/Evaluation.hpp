@@ -34,6 +34,7 @@
 
 #include "Evaluation.hpp"
 #include "Math.hpp"
+#include "DerivativeKernels.hpp"
 
 #include <opm/common/Valgrind.hpp>
 
@@ -67,6 +68,11 @@ protected:
     //! length of internal data vector
     static constexpr int length_ = size + 1;
 
+    //! properties of the internal data vector if it is padded for SIMD registers
+    typedef PaddedStorage<ValueT, length_> StorageTraits;
+    //! length of internal data vector including the padding
+    static constexpr int paddedLength_ = StorageTraits::paddedLength;
+
     //! position index for value
     static constexpr int valuepos_ = 0;
     //! start index for derivatives
@@ -117,6 +123,12 @@ public:
         for (int i = dstart_; i < dend_; ++i) {
             data_[i] = 0.0;
         }
+#if OPM_DENSEAD_ALIGN_STORAGE
+        // the padding is always kept at zero after an evaluation has been initialized
+        for (int i = length_; i < paddedLength_; ++i) {
+            data_[i] = 0.0;
+        }
+#endif
     }
 
     // create a function evaluation for a "naked" depending variable (i.e., f(x) = x)
@@ -156,13 +168,35 @@ public:
         }
     }
 
+    // set all derivatives to the ones of other multiplied by a factor, i.e., apply the
+    // chain rule f(g(x))' = f'(g(x))*g'(x)
+    void setScaledDerivatives(const ValueType& factor, const Evaluation& other)
+    {
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and restore the value afterwards
+        const ValueType value = data_[valuepos_];
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::scale(&data_[0], &other.data_[0], factor);
+        data_[valuepos_] = value;
+#elif OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::scale(&data_[dstart_], &other.data_[dstart_], factor);
+#else
+        for (int i = dstart_; i < dend_; ++i) {
+            data_[i] = factor*other.data_[i];
+        }
+#endif
+    }
+
 
     // add value and derivatives from other to this values and derivatives
     Evaluation& operator+=(const Evaluation& other)
     {
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::add(&data_[0], &other.data_[0]);
+#else
         for (int i = 0; i < length_; ++i) {
             data_[i] += other.data_[i];
         }
+#endif
 
         return *this;
     }
@@ -205,13 +239,23 @@ public:
         const ValueType u = this->value();
         const ValueType v = other.value();
 
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and recompute the value afterwards
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::productRule(&data_[0], &other.data_[0], v, u);
+        data_[valuepos_] = u*v;
+#else
         // value
         data_[valuepos_] *= v ;
 
         //  derivatives
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::productRule(&data_[dstart_], &other.data_[dstart_], v, u);
+#else
         for (int i = dstart_; i < dend_; ++i) {
             data_[i] = data_[i] * v + other.data_[i] * u;
         }
+#endif
+#endif
 
         return *this;
     }
@@ -232,15 +276,28 @@ public:
     {
         // values are divided, derivatives follow the rule for division, i.e., (u/v)' = (v'u -
         // u'v)/v^2.
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and recompute the value afterwards. note
+        // that 'other' may be the same object as 'this'
+        const ValueType u = data_[ valuepos_ ];
+        const ValueType v = other.value();
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::quotientRule(&data_[0], &other.data_[0], u, v);
+        data_[valuepos_] = u/v;
+#else
         ValueType& u = data_[ valuepos_ ];
         const ValueType& v = other.value();
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::quotientRule(&data_[dstart_], &other.data_[dstart_], u, v);
+#else
         for (unsigned idx = dstart_; idx < dend_; ++idx) {
             const ValueType& uPrime = data_[idx];
             const ValueType& vPrime = other.data_[idx];
 
             data_[idx] = (v*uPrime - u*vPrime)/(v*v);
         }
+#endif
         u /= v;
+#endif
 
         return *this;
     }
@@ -434,7 +491,7 @@ public:
     }
 
 private:
-    std::array<ValueT, length_> data_;
+    alignas(StorageTraits::alignment) std::array<ValueT, paddedLength_> data_;
 };
 
 // the generic operators are only required for the unspecialized case
@@ -560,6 +617,37 @@ public:
 
 } // namespace Dune
 
+// the specializations can be disabled to compare their performance with the one of the
+// generic code (see tests/bench_densead.cpp). since this changes the definition of the
+// Evaluation class, the macro must be set consistently for all translation units.
+#ifndef OPM_DENSEAD_DISABLE_SPECIALIZATIONS
+#define OPM_DENSEAD_DISABLE_SPECIALIZATIONS 0
+#endif
+
+#if !OPM_DENSEAD_DISABLE_SPECIALIZATIONS
 #include "EvaluationSpecializations.hpp"
 
+// specializations for further numbers of derivatives which have been generated by the
+// build system (see the OPM_EVAL_SIZES option of the top-level CMakeLists.txt)
+#if OPM_DENSEAD_HAVE_EXTRA_SPECIALIZATIONS
+#include <opm/material/densead/EvaluationExtraSpecializations.hpp>
+#endif
+#endif
+
+// the evaluations which are part of the library of precompiled instantiations (see
+// opm/material/common/PrecompiledInstantiations.hpp)
+#include <opm/material/common/PrecompiledInstantiations.hpp>
+
+#if OPM_MATERIAL_EXTERN_TEMPLATES
+namespace Opm {
+namespace DenseAd {
+extern template class Evaluation<double, 1>;
+extern template class Evaluation<double, 2>;
+extern template class Evaluation<double, 3>;
+extern template class Evaluation<double, 4>;
+extern template class Evaluation<double, 5>;
+extern template class Evaluation<double, 6>;
+}} // namespace DenseAd, Opm
+#endif
+
 #endif // OPM_DENSEAD_EVALUATION_HPP
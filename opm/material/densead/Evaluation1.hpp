@@ -33,6 +33,7 @@
 
 #include "Evaluation.hpp"
 #include "Math.hpp"
+#include "DerivativeKernels.hpp"
 
 #include <opm/common/Valgrind.hpp>
 
@@ -62,6 +63,11 @@ protected:
     //! length of internal data vector
     static constexpr int length_ = size + 1;
 
+    //! properties of the internal data vector if it is padded for SIMD registers
+    typedef PaddedStorage<ValueT, length_> StorageTraits;
+    //! length of internal data vector including the padding
+    static constexpr int paddedLength_ = StorageTraits::paddedLength;
+
     //! position index for value
     static constexpr int valuepos_ = 0;
     //! start index for derivatives
@@ -110,6 +116,12 @@ public:
     void clearDerivatives()
     {
         data_[1] = 0.0;
+#if OPM_DENSEAD_ALIGN_STORAGE
+        // the padding is always kept at zero after an evaluation has been initialized
+        for (int i = length_; i < paddedLength_; ++i) {
+            data_[i] = 0.0;
+        }
+#endif
     }
 
     // create a function evaluation for a "naked" depending variable (i.e., f(x) = x)
@@ -147,12 +159,32 @@ public:
         data_[1] = other.data_[1];
     }
 
+    // set all derivatives to the ones of other multiplied by a factor, i.e., apply the
+    // chain rule f(g(x))' = f'(g(x))*g'(x)
+    void setScaledDerivatives(const ValueType& factor, const Evaluation& other)
+    {
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and restore the value afterwards
+        const ValueType value = data_[valuepos_];
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::scale(&data_[0], &other.data_[0], factor);
+        data_[valuepos_] = value;
+#elif OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::scale(&data_[dstart_], &other.data_[dstart_], factor);
+#else
+        data_[1] = factor*other.data_[1];
+#endif
+    }
+
 
     // add value and derivatives from other to this values and derivatives
     Evaluation& operator+=(const Evaluation& other)
     {
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::add(&data_[0], &other.data_[0]);
+#else
         data_[0] += other.data_[0];
         data_[1] += other.data_[1];
+#endif
 
         return *this;
     }
@@ -194,11 +226,21 @@ public:
         const ValueType u = this->value();
         const ValueType v = other.value();
 
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and recompute the value afterwards
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::productRule(&data_[0], &other.data_[0], v, u);
+        data_[valuepos_] = u*v;
+#else
         // value
         data_[valuepos_] *= v ;
 
         //  derivatives
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::productRule(&data_[dstart_], &other.data_[dstart_], v, u);
+#else
         data_[1] = data_[1] * v + other.data_[1] * u;
+#endif
+#endif
 
         return *this;
     }
@@ -218,10 +260,23 @@ public:
     {
         // values are divided, derivatives follow the rule for division, i.e., (u/v)' = (v'u -
         // u'v)/v^2.
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and recompute the value afterwards. note
+        // that 'other' may be the same object as 'this'
+        const ValueType u = data_[ valuepos_ ];
+        const ValueType v = other.value();
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::quotientRule(&data_[0], &other.data_[0], u, v);
+        data_[valuepos_] = u/v;
+#else
         ValueType& u = data_[ valuepos_ ];
         const ValueType& v = other.value();
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::quotientRule(&data_[dstart_], &other.data_[dstart_], u, v);
+#else
         data_[1] = (v*data_[1] - u*other.data_[1])/(v*v);
+#endif
         u /= v;
+#endif
 
         return *this;
     }
@@ -413,7 +468,7 @@ public:
     }
 
 private:
-    std::array<ValueT, length_> data_;
+    alignas(StorageTraits::alignment) std::array<ValueT, paddedLength_> data_;
 };
 
 } } // namespace DenseAd, Opm
@@ -33,6 +33,7 @@
 
 #include "Evaluation.hpp"
 #include "Math.hpp"
+#include "DerivativeKernels.hpp"
 
 #include <opm/common/Valgrind.hpp>
 
@@ -62,6 +63,11 @@ protected:
     //! length of internal data vector
     static constexpr int length_ = size + 1;
 
+    //! properties of the internal data vector if it is padded for SIMD registers
+    typedef PaddedStorage<ValueT, length_> StorageTraits;
+    //! length of internal data vector including the padding
+    static constexpr int paddedLength_ = StorageTraits::paddedLength;
+
     //! position index for value
     static constexpr int valuepos_ = 0;
     //! start index for derivatives
@@ -119,6 +125,12 @@ public:
         data_[8] = 0.0;
         data_[9] = 0.0;
         data_[10] = 0.0;
+#if OPM_DENSEAD_ALIGN_STORAGE
+        // the padding is always kept at zero after an evaluation has been initialized
+        for (int i = length_; i < paddedLength_; ++i) {
+            data_[i] = 0.0;
+        }
+#endif
     }
 
     // create a function evaluation for a "naked" depending variable (i.e., f(x) = x)
@@ -165,10 +177,38 @@ public:
         data_[10] = other.data_[10];
     }
 
+    // set all derivatives to the ones of other multiplied by a factor, i.e., apply the
+    // chain rule f(g(x))' = f'(g(x))*g'(x)
+    void setScaledDerivatives(const ValueType& factor, const Evaluation& other)
+    {
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and restore the value afterwards
+        const ValueType value = data_[valuepos_];
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::scale(&data_[0], &other.data_[0], factor);
+        data_[valuepos_] = value;
+#elif OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::scale(&data_[dstart_], &other.data_[dstart_], factor);
+#else
+        data_[1] = factor*other.data_[1];
+        data_[2] = factor*other.data_[2];
+        data_[3] = factor*other.data_[3];
+        data_[4] = factor*other.data_[4];
+        data_[5] = factor*other.data_[5];
+        data_[6] = factor*other.data_[6];
+        data_[7] = factor*other.data_[7];
+        data_[8] = factor*other.data_[8];
+        data_[9] = factor*other.data_[9];
+        data_[10] = factor*other.data_[10];
+#endif
+    }
+
 
     // add value and derivatives from other to this values and derivatives
     Evaluation& operator+=(const Evaluation& other)
     {
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::add(&data_[0], &other.data_[0]);
+#else
         data_[0] += other.data_[0];
         data_[1] += other.data_[1];
         data_[2] += other.data_[2];
@@ -180,6 +220,7 @@ public:
         data_[8] += other.data_[8];
         data_[9] += other.data_[9];
         data_[10] += other.data_[10];
+#endif
 
         return *this;
     }
@@ -230,10 +271,18 @@ public:
         const ValueType u = this->value();
         const ValueType v = other.value();
 
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and recompute the value afterwards
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::productRule(&data_[0], &other.data_[0], v, u);
+        data_[valuepos_] = u*v;
+#else
         // value
         data_[valuepos_] *= v ;
 
         //  derivatives
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::productRule(&data_[dstart_], &other.data_[dstart_], v, u);
+#else
         data_[1] = data_[1] * v + other.data_[1] * u;
         data_[2] = data_[2] * v + other.data_[2] * u;
         data_[3] = data_[3] * v + other.data_[3] * u;
@@ -244,6 +293,8 @@ public:
         data_[8] = data_[8] * v + other.data_[8] * u;
         data_[9] = data_[9] * v + other.data_[9] * u;
         data_[10] = data_[10] * v + other.data_[10] * u;
+#endif
+#endif
 
         return *this;
     }
@@ -272,8 +323,19 @@ public:
     {
         // values are divided, derivatives follow the rule for division, i.e., (u/v)' = (v'u -
         // u'v)/v^2.
+#if OPM_DENSEAD_USE_SIMD && OPM_DENSEAD_ALIGN_STORAGE
+        // process the complete padded storage and recompute the value afterwards. note
+        // that 'other' may be the same object as 'this'
+        const ValueType u = data_[ valuepos_ ];
+        const ValueType v = other.value();
+        DerivativeKernels<ValueType, paddedLength_, StorageTraits::alignedAccess>::quotientRule(&data_[0], &other.data_[0], u, v);
+        data_[valuepos_] = u/v;
+#else
         ValueType& u = data_[ valuepos_ ];
         const ValueType& v = other.value();
+#if OPM_DENSEAD_USE_SIMD
+        DerivativeKernels<ValueType, size>::quotientRule(&data_[dstart_], &other.data_[dstart_], u, v);
+#else
         data_[1] = (v*data_[1] - u*other.data_[1])/(v*v);
         data_[2] = (v*data_[2] - u*other.data_[2])/(v*v);
         data_[3] = (v*data_[3] - u*other.data_[3])/(v*v);
@@ -284,7 +346,9 @@ public:
         data_[8] = (v*data_[8] - u*other.data_[8])/(v*v);
         data_[9] = (v*data_[9] - u*other.data_[9])/(v*v);
         data_[10] = (v*data_[10] - u*other.data_[10])/(v*v);
+#endif
         u /= v;
+#endif
 
         return *this;
     }
@@ -494,7 +558,7 @@ public:
     }
 
 private:
-    std::array<ValueT, length_> data_;
+    alignas(StorageTraits::alignment) std::array<ValueT, paddedLength_> data_;
 };
 
 } } // namespace DenseAd, Opm
@@ -0,0 +1,415 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief An opt-in expression template layer for the dense-AD Evaluation class.
+ *
+ * Each sub-expression of an arithmetic expression of Evaluation objects usually
+ * produces a temporary Evaluation, i.e., the derivatives are copied around for every
+ * operation. If at least one Evaluation operand of an expression is wrapped using
+ * Opm::DenseAd::lazy(), the expression is instead represented by a tree of light-weight
+ * nodes which is turned into an Evaluation in a single pass over the derivatives by
+ * Opm::DenseAd::evaluate():
+ *
+ * \code
+ * Evaluation y = Opm::DenseAd::evaluate(y0 + (y1 - y0)*(Opm::DenseAd::lazy(x) - x0)/(x1 - x0));
+ * \endcode
+ *
+ * The values of the sub-expressions are computed when the nodes are created and the
+ * derivatives are calculated using the same operations as the ones of Evaluation, i.e.,
+ * if the constants exhibit the same precision as the evaluations, the results are
+ * identical to the ones of eagerly evaluated expressions (except for the sign of zero
+ * derivatives). Expressions
+ * only keep references to the wrapped Evaluation objects, so they must be evaluated
+ * before the end of the full expression (i.e., do not store them in 'auto' variables).
+ * Evaluation objects which are not wrapped by lazy() cannot be mixed with expressions.
+ * For all other types, e.g., plain floating point values, lazy() and evaluate() are
+ * identity functions so that generic code can use them unconditionally.
+ */
+#ifndef OPM_DENSEAD_EXPRESSION_TEMPLATES_HPP
+#define OPM_DENSEAD_EXPRESSION_TEMPLATES_HPP
+
+#include "Evaluation.hpp"
+
+#include <type_traits>
+
+namespace Opm {
+namespace DenseAd {
+
+/*!
+ * \brief Base class of all nodes of dense-AD expressions.
+ *
+ * Derived classes provide the value() and derivative() methods as well as the
+ * EvaluationType typedef.
+ */
+template <class Implementation>
+class ExpressionBase
+{
+public:
+    const Implementation& asImp_() const
+    { return *static_cast<const Implementation*>(this); }
+
+    //! evaluate the expression in a single pass over the derivatives
+    template <class Imp = Implementation>
+    typename Imp::EvaluationType evaluate() const
+    {
+        typename Imp::EvaluationType result;
+
+        result.setValue(asImp_().value());
+        for (int varIdx = 0; varIdx < Imp::EvaluationType::size; ++varIdx)
+            result.setDerivative(varIdx, asImp_().derivative(varIdx));
+
+        return result;
+    }
+};
+
+//! Leaf node which refers to an Evaluation object
+template <class Eval>
+class EvaluationRefExpression : public ExpressionBase<EvaluationRefExpression<Eval> >
+{
+public:
+    typedef Eval EvaluationType;
+    typedef typename Eval::ValueType ValueType;
+
+    explicit EvaluationRefExpression(const Eval& eval)
+        : eval_(eval)
+    {}
+
+    const ValueType& value() const
+    { return eval_.value(); }
+
+    ValueType derivative(int varIdx) const
+    { return eval_.derivative(varIdx); }
+
+private:
+    const Eval& eval_;
+};
+
+//! Node for a + b
+template <class A, class B>
+class SumExpression : public ExpressionBase<SumExpression<A, B> >
+{
+    static_assert(std::is_same<typename A::EvaluationType, typename B::EvaluationType>::value,
+                  "Operands of expressions must use the same type of evaluations");
+public:
+    typedef typename A::EvaluationType EvaluationType;
+    typedef typename EvaluationType::ValueType ValueType;
+
+    SumExpression(const A& a, const B& b)
+        : a_(a), b_(b), value_(a.value() + b.value())
+    {}
+
+    const ValueType& value() const
+    { return value_; }
+
+    ValueType derivative(int varIdx) const
+    { return a_.derivative(varIdx) + b_.derivative(varIdx); }
+
+private:
+    A a_;
+    B b_;
+    ValueType value_;
+};
+
+//! Node for a - b
+template <class A, class B>
+class DifferenceExpression : public ExpressionBase<DifferenceExpression<A, B> >
+{
+    static_assert(std::is_same<typename A::EvaluationType, typename B::EvaluationType>::value,
+                  "Operands of expressions must use the same type of evaluations");
+public:
+    typedef typename A::EvaluationType EvaluationType;
+    typedef typename EvaluationType::ValueType ValueType;
+
+    DifferenceExpression(const A& a, const B& b)
+        : a_(a), b_(b), value_(a.value() - b.value())
+    {}
+
+    const ValueType& value() const
+    { return value_; }
+
+    ValueType derivative(int varIdx) const
+    { return a_.derivative(varIdx) - b_.derivative(varIdx); }
+
+private:
+    A a_;
+    B b_;
+    ValueType value_;
+};
+
+//! Node for a*b, (u*v)' = (v'u + u'v)
+template <class A, class B>
+class ProductExpression : public ExpressionBase<ProductExpression<A, B> >
+{
+    static_assert(std::is_same<typename A::EvaluationType, typename B::EvaluationType>::value,
+                  "Operands of expressions must use the same type of evaluations");
+public:
+    typedef typename A::EvaluationType EvaluationType;
+    typedef typename EvaluationType::ValueType ValueType;
+
+    ProductExpression(const A& a, const B& b)
+        : a_(a), b_(b), value_(a.value()*b.value())
+    {}
+
+    const ValueType& value() const
+    { return value_; }
+
+    ValueType derivative(int varIdx) const
+    { return a_.derivative(varIdx)*b_.value() + b_.derivative(varIdx)*a_.value(); }
+
+private:
+    A a_;
+    B b_;
+    ValueType value_;
+};
+
+//! Node for a/b, (u/v)' = (vu' - uv')/v^2
+template <class A, class B>
+class QuotientExpression : public ExpressionBase<QuotientExpression<A, B> >
+{
+    static_assert(std::is_same<typename A::EvaluationType, typename B::EvaluationType>::value,
+                  "Operands of expressions must use the same type of evaluations");
+public:
+    typedef typename A::EvaluationType EvaluationType;
+    typedef typename EvaluationType::ValueType ValueType;
+
+    QuotientExpression(const A& a, const B& b)
+        : a_(a), b_(b), value_(a.value()/b.value())
+    {}
+
+    const ValueType& value() const
+    { return value_; }
+
+    ValueType derivative(int varIdx) const
+    {
+        const ValueType& u = a_.value();
+        const ValueType& v = b_.value();
+        return (v*a_.derivative(varIdx) - u*b_.derivative(varIdx))/(v*v);
+    }
+
+private:
+    A a_;
+    B b_;
+    ValueType value_;
+};
+
+//! Node for -a
+template <class A>
+class NegationExpression : public ExpressionBase<NegationExpression<A> >
+{
+public:
+    typedef typename A::EvaluationType EvaluationType;
+    typedef typename EvaluationType::ValueType ValueType;
+
+    explicit NegationExpression(const A& a)
+        : a_(a), value_(- a.value())
+    {}
+
+    const ValueType& value() const
+    { return value_; }
+
+    ValueType derivative(int varIdx) const
+    { return - a_.derivative(varIdx); }
+
+private:
+    A a_;
+    ValueType value_;
+};
+
+//! Node for a + c and a - c with a constant c. (The derivatives are the ones of a.)
+template <class A>
+class ShiftedExpression : public ExpressionBase<ShiftedExpression<A> >
+{
+public:
+    typedef typename A::EvaluationType EvaluationType;
+    typedef typename EvaluationType::ValueType ValueType;
+
+    ShiftedExpression(const A& a, const ValueType& value)
+        : a_(a), value_(value)
+    {}
+
+    const ValueType& value() const
+    { return value_; }
+
+    ValueType derivative(int varIdx) const
+    { return a_.derivative(varIdx); }
+
+private:
+    A a_;
+    ValueType value_;
+};
+
+//! Node for a*c and c*a with a constant c
+template <class A>
+class ScaledExpression : public ExpressionBase<ScaledExpression<A> >
+{
+public:
+    typedef typename A::EvaluationType EvaluationType;
+    typedef typename EvaluationType::ValueType ValueType;
+
+    ScaledExpression(const A& a, const ValueType& factor)
+        : a_(a), factor_(factor), value_(a.value()*factor)
+    {}
+
+    const ValueType& value() const
+    { return value_; }
+
+    ValueType derivative(int varIdx) const
+    { return a_.derivative(varIdx)*factor_; }
+
+private:
+    A a_;
+    ValueType factor_;
+    ValueType value_;
+};
+
+//! Node for c/a with a constant c
+template <class A>
+class ReciprocalExpression : public ExpressionBase<ReciprocalExpression<A> >
+{
+public:
+    typedef typename A::EvaluationType EvaluationType;
+    typedef typename EvaluationType::ValueType ValueType;
+
+    ReciprocalExpression(const ValueType& c, const A& a)
+        : a_(a), c_(c), value_(c/a.value())
+    {}
+
+    const ValueType& value() const
+    { return value_; }
+
+    ValueType derivative(int varIdx) const
+    {
+        const ValueType& v = a_.value();
+        return (- c_*a_.derivative(varIdx))/(v*v);
+    }
+
+private:
+    A a_;
+    ValueType c_;
+    ValueType value_;
+};
+
+/*!
+ * \brief Start a lazily evaluated expression
+ */
+template <class ValueType, int numVars>
+EvaluationRefExpression<Evaluation<ValueType, numVars> > lazy(const Evaluation<ValueType, numVars>& eval)
+{ return EvaluationRefExpression<Evaluation<ValueType, numVars> >(eval); }
+
+/*!
+ * \brief Plain floating point values and other types of evaluations are not wrapped
+ */
+template <class T>
+const T& lazy(const T& value)
+{ return value; }
+
+/*!
+ * \brief Convert an expression to an Evaluation object
+ */
+template <class Expr>
+typename std::enable_if<std::is_base_of<ExpressionBase<Expr>, Expr>::value,
+                        typename Expr::EvaluationType>::type
+evaluate(const Expr& expr)
+{ return expr.evaluate(); }
+
+/*!
+ * \brief Objects which are not expressions are returned as they are
+ */
+template <class T>
+typename std::enable_if<!std::is_base_of<ExpressionBase<T>, T>::value, T>::type
+evaluate(const T& value)
+{ return value; }
+
+// operators for two expressions
+template <class A, class B>
+SumExpression<A, B> operator+(const ExpressionBase<A>& a, const ExpressionBase<B>& b)
+{ return SumExpression<A, B>(a.asImp_(), b.asImp_()); }
+
+template <class A, class B>
+DifferenceExpression<A, B> operator-(const ExpressionBase<A>& a, const ExpressionBase<B>& b)
+{ return DifferenceExpression<A, B>(a.asImp_(), b.asImp_()); }
+
+template <class A, class B>
+ProductExpression<A, B> operator*(const ExpressionBase<A>& a, const ExpressionBase<B>& b)
+{ return ProductExpression<A, B>(a.asImp_(), b.asImp_()); }
+
+template <class A, class B>
+QuotientExpression<A, B> operator/(const ExpressionBase<A>& a, const ExpressionBase<B>& b)
+{ return QuotientExpression<A, B>(a.asImp_(), b.asImp_()); }
+
+template <class A>
+NegationExpression<A> operator-(const ExpressionBase<A>& a)
+{ return NegationExpression<A>(a.asImp_()); }
+
+// operators for an expression and a constant. the operations on the value are the same
+// as the ones of the Evaluation class.
+template <class A, class Scalar>
+typename std::enable_if<std::is_arithmetic<Scalar>::value, ShiftedExpression<A> >::type
+operator+(const ExpressionBase<A>& a, const Scalar& c)
+{ return ShiftedExpression<A>(a.asImp_(), a.asImp_().value() + c); }
+
+template <class Scalar, class A>
+typename std::enable_if<std::is_arithmetic<Scalar>::value, ShiftedExpression<A> >::type
+operator+(const Scalar& c, const ExpressionBase<A>& a)
+{ return ShiftedExpression<A>(a.asImp_(), a.asImp_().value() + c); }
+
+template <class A, class Scalar>
+typename std::enable_if<std::is_arithmetic<Scalar>::value, ShiftedExpression<A> >::type
+operator-(const ExpressionBase<A>& a, const Scalar& c)
+{ return ShiftedExpression<A>(a.asImp_(), a.asImp_().value() - c); }
+
+template <class Scalar, class A>
+typename std::enable_if<std::is_arithmetic<Scalar>::value, ShiftedExpression<NegationExpression<A> > >::type
+operator-(const Scalar& c, const ExpressionBase<A>& a)
+{ return ShiftedExpression<NegationExpression<A> >(NegationExpression<A>(a.asImp_()), c - a.asImp_().value()); }
+
+template <class A, class Scalar>
+typename std::enable_if<std::is_arithmetic<Scalar>::value, ScaledExpression<A> >::type
+operator*(const ExpressionBase<A>& a, const Scalar& c)
+{ return ScaledExpression<A>(a.asImp_(), c); }
+
+template <class Scalar, class A>
+typename std::enable_if<std::is_arithmetic<Scalar>::value, ScaledExpression<A> >::type
+operator*(const Scalar& c, const ExpressionBase<A>& a)
+{ return ScaledExpression<A>(a.asImp_(), c); }
+
+template <class A, class Scalar>
+typename std::enable_if<std::is_arithmetic<Scalar>::value, ScaledExpression<A> >::type
+operator/(const ExpressionBase<A>& a, const Scalar& c)
+{
+    typedef typename A::ValueType ValueType;
+    const ValueType tmp = 1.0/c;
+    return ScaledExpression<A>(a.asImp_(), tmp);
+}
+
+template <class Scalar, class A>
+typename std::enable_if<std::is_arithmetic<Scalar>::value, ReciprocalExpression<A> >::type
+operator/(const Scalar& c, const ExpressionBase<A>& a)
+{ return ReciprocalExpression<A>(c, a.asImp_()); }
+
+} // namespace DenseAd
+} // namespace Opm
+
+#endif
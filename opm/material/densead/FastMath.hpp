@@ -0,0 +1,271 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Fast approximations of the exponential function and the logarithm which can be
+ *        used by the dense automatic differentiation (AD) framework.
+ *
+ * If the OPM_DENSEAD_FAST_MATH macro is set to a non-zero value before the DenseAd
+ * headers are included, the exp(), log() and pow() functions for Evaluation objects use
+ * the approximations of this file for the function values instead of the ones of the C
+ * library. Since the derivatives of these functions are computed from the function
+ * values, this also speeds up the derivatives. By default, the macro is zero, i.e.,
+ * validation builds get the exact functions of the C library.
+ *
+ * The approximations only consist of a range reduction by means of the binary
+ * representation of the argument, a small table and a polynomial, i.e., they can be
+ * inlined by the compiler. Their relative error is below 1e-14 for double and below the
+ * machine precision for float. For pow(), the error of the logarithm is amplified by
+ * the exponent, i.e., the relative error of \f$x^y\f$ is bounded by \f$10^{-14}(1 +
+ * |y\,\ln x|)\f$. Arguments for which the approximation does not apply (zero, negative,
+ * subnormal, non-finite or very large ones) are passed to the C library.
+ *
+ * Note that the macro changes the definition of the DenseAd functions, so all
+ * translation units of a program which instantiate the same code using evaluations must
+ * be compiled with the same setting.
+ */
+#ifndef OPM_DENSEAD_FAST_MATH_HPP
+#define OPM_DENSEAD_FAST_MATH_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifndef OPM_DENSEAD_FAST_MATH
+#define OPM_DENSEAD_FAST_MATH 0
+#endif
+
+namespace Opm {
+namespace DenseAd {
+namespace FastMath {
+
+// the tables which are used by the approximations. (this is a class template so that
+// the tables can be defined in the header.)
+template <class Dummy = void>
+struct Tables
+{
+    //! 2^(j/32) for j in [0, 32)
+    static const double expTable[32];
+    //! 1/c_i for the centers c_i = 1 + (i + 1/2)/64 of the intervals of the mantissa
+    static const double logInvCenter[64];
+    //! ln(c_i) for the centers c_i = 1 + (i + 1/2)/64 of the intervals of the mantissa
+    static const double logLnCenter[64];
+};
+
+template <class Dummy>
+const double Tables<Dummy>::expTable[32] = {
+        1.0, 1.0218971486541166, 1.0442737824274138, 1.0671404006768237,
+        1.0905077326652577, 1.1143867425958924, 1.1387886347566916, 1.1637248587775775,
+        1.189207115002721, 1.215247359980469, 1.241857812073484, 1.2690509571917332,
+        1.2968395546510096, 1.3252366431597413, 1.3542555469368927, 1.383909881963832,
+        1.4142135623730951, 1.4451808069770467, 1.4768261459394993, 1.5091644275934228,
+        1.5422108254079407, 1.5759808451078865, 1.6104903319492543, 1.645755478153965,
+        1.681792830507429, 1.718619298122478, 1.7562521603732995, 1.7947090750031072,
+        1.8340080864093424, 1.8741676341103, 1.9152065613971474, 1.9571441241754002
+};
+
+template <class Dummy>
+const double Tables<Dummy>::logInvCenter[64] = {
+        0.9922480620155039, 0.9770992366412213, 0.9624060150375939, 0.9481481481481482,
+        0.9343065693430657, 0.920863309352518, 0.9078014184397163, 0.8951048951048951,
+        0.8827586206896552, 0.8707482993197279, 0.8590604026845637, 0.847682119205298,
+        0.8366013071895425, 0.8258064516129032, 0.8152866242038217, 0.8050314465408805,
+        0.7950310559006211, 0.7852760736196319, 0.7757575757575758, 0.7664670658682635,
+        0.757396449704142, 0.7485380116959064, 0.7398843930635838, 0.7314285714285714,
+        0.7231638418079096, 0.7150837988826816, 0.7071823204419889, 0.6994535519125683,
+        0.6918918918918919, 0.6844919786096256, 0.6772486772486772, 0.6701570680628273,
+        0.6632124352331606, 0.6564102564102564, 0.649746192893401, 0.6432160804020101,
+        0.6368159203980099, 0.6305418719211823, 0.624390243902439, 0.6183574879227053,
+        0.6124401913875598, 0.6066350710900474, 0.6009389671361502, 0.5953488372093023,
+        0.5898617511520737, 0.5844748858447488, 0.579185520361991, 0.5739910313901345,
+        0.5688888888888889, 0.5638766519823789, 0.5589519650655022, 0.5541125541125541,
+        0.5493562231759657, 0.5446808510638298, 0.540084388185654, 0.5355648535564853,
+        0.5311203319502075, 0.5267489711934157, 0.5224489795918368, 0.5182186234817814,
+        0.5140562248995983, 0.5099601593625498, 0.5059288537549407, 0.5019607843137255
+};
+
+template <class Dummy>
+const double Tables<Dummy>::logLnCenter[64] = {
+        0.007782140442054949, 0.02316705928153438, 0.0383188643021366, 0.053244514518812285,
+        0.06795066190850775, 0.08244366921107459, 0.09672962645855111, 0.11081436634029011,
+        0.12470347850095724, 0.13840232285911913, 0.15191604202584197, 0.16524957289530717,
+        0.1784076574728183, 0.19139485299962947, 0.2042155414286909, 0.21687393830061436,
+        0.22937410106484582, 0.24171993688714516, 0.25391520998096345, 0.26596354849713794,
+        0.2778684510034563, 0.28963329258304266, 0.3012613305781618, 0.3127557100038969,
+        0.324119468654212, 0.3353555419211378, 0.34646676734620857, 0.3574558889218038,
+        0.3683255611587076, 0.37907835293496944, 0.3897167511400252, 0.4002431641270127,
+        0.4106599249852684, 0.42096929464412963, 0.4311734648183713, 0.4412745608048752,
+        0.45127464413945856, 0.46117571512217015, 0.470979715218791, 0.4806885293457519,
+        0.4903039880451938, 0.4998278695564493, 0.5092619017898079, 0.5186077642080457,
+        0.5278670896208424, 0.5370414658968836, 0.5461324375981357, 0.5551415075405016,
+        0.564070138284803, 0.5729197535617855, 0.5816917396346225, 0.5903874466021763,
+        0.5990081896460834, 0.6075552502245418, 0.616029877215514, 0.6244332880118935,
+        0.6327666695710378, 0.6410311794209312, 0.6492279466251099, 0.65735807270836,
+        0.6654226325450905, 0.6734226752121667, 0.6813592248079031, 0.689233281238809
+};
+
+// ln(2), split into a part which can be multiplied with small integers exactly and the
+// rest
+static const double ln2Hi = 6.93147180369123816490e-01;
+static const double ln2Lo = 1.90821492927058770002e-10;
+
+/*!
+ * \brief Approximates the exponential function.
+ *
+ * The argument is reduced to \f$x = (32 e + j)\,\ln(2)/32 + r\f$ with \f$|r| \leq
+ * \ln(2)/64\f$, \f$2^{j/32}\f$ is taken from a table and \f$e^r\f$ is evaluated using
+ * its Taylor polynomial of degree 5.
+ */
+inline double exp(double x)
+{
+    if (!(std::abs(x) < 708.0))
+        // overflow, underflow to subnormal values, infinities and NaNs
+        return std::exp(x);
+
+    const double invLn2By32 = 46.166241308446828384;
+    // adding this constant rounds to the next integer
+    const double roundingShift = 6755399441055744.0;
+
+    double kd = (x*invLn2By32 + roundingShift) - roundingShift;
+    double r = (x - kd*(ln2Hi/32)) - kd*(ln2Lo/32);
+
+    std::int64_t k = static_cast<std::int64_t>(kd);
+    std::int64_t j = k & 31;
+    std::int64_t e = (k - j)/32;
+
+    double p = 1 + r*(1 + r*(1/2.0 + r*(1/6.0 + r*(1/24.0 + r*(1/120.0)))));
+
+    // the scaling factor 2^e
+    std::int64_t scaleBits = (e + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &scaleBits, sizeof(scale));
+
+    return (Tables<>::expTable[j]*p)*scale;
+}
+
+/*!
+ * \brief Approximates the natural logarithm.
+ *
+ * The argument is split into \f$x = m\,2^e\f$ with \f$m \in [1, 2)\f$ and
+ * \f$\ln m = \ln c_i + \ln(1 + (m - c_i)/c_i)\f$ is evaluated using the center
+ * \f$c_i\f$ of the one of 64 intervals of the mantissa which contains \f$m\f$, a table
+ * for \f$\ln c_i\f$ and the Taylor polynomial of degree 8 of \f$\ln(1 + r)\f$. Close
+ * to 1, the polynomial is directly used to avoid cancellation.
+ */
+inline double log(double x)
+{
+    if (!(x >= std::numeric_limits<double>::min() && x <= std::numeric_limits<double>::max()))
+        // zero, negative, subnormal and non-finite arguments
+        return std::log(x);
+
+    double r;
+    double offset;
+    if (std::abs(x - 1) < 1/64.0) {
+        r = x - 1;
+        offset = 0.0;
+    }
+    else {
+        std::uint64_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        double e = static_cast<double>(static_cast<int>(bits >> 52) - 1023);
+        unsigned i = static_cast<unsigned>((bits >> 46) & 63);
+        bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+        double m;
+        std::memcpy(&m, &bits, sizeof(m));
+
+        // the difference to the center of the interval is exact
+        double center = 1 + (i + 0.5)/64;
+        r = (m - center)*Tables<>::logInvCenter[i];
+        offset = e*ln2Hi + (Tables<>::logLnCenter[i] + e*ln2Lo);
+    }
+
+    double p =
+        r*(1 + r*(-1/2.0 + r*(1/3.0 + r*(-1/4.0 + r*(1/5.0 + r*(-1/6.0
+        + r*(1/7.0 + r*(-1/8.0))))))));
+
+    return offset + p;
+}
+
+/*!
+ * \brief Approximates the power function.
+ *
+ * Negative bases are passed to the C library, because the power is only defined for
+ * them if the exponent is an integer.
+ */
+inline double pow(double base, double exp)
+{
+    if (!(base > 0.0))
+        return std::pow(base, exp);
+    return FastMath::exp(exp*FastMath::log(base));
+}
+
+} // namespace FastMath
+
+/*!
+ * \brief The functions of the math toolbox which are used to compute the values of
+ *        transcendental functions for evaluations if OPM_DENSEAD_FAST_MATH is enabled.
+ *
+ * For value types other than float and double, this is simply the math toolbox of the
+ * value type. Note that for nested evaluations, the approximations are still used for
+ * the innermost values if fast math is enabled.
+ */
+template <class ValueType>
+struct FastMathToolbox : public Opm::MathToolbox<ValueType>
+{};
+
+template <>
+struct FastMathToolbox<double> : public Opm::MathToolbox<double>
+{
+    static double exp(double arg)
+    { return FastMath::exp(arg); }
+
+    static double log(double arg)
+    { return FastMath::log(arg); }
+
+    template <class ExpType>
+    static double pow(double base, const ExpType& exp)
+    { return FastMath::pow(base, static_cast<double>(exp)); }
+};
+
+template <>
+struct FastMathToolbox<float> : public Opm::MathToolbox<float>
+{
+    static float exp(float arg)
+    { return static_cast<float>(FastMath::exp(arg)); }
+
+    static float log(float arg)
+    { return static_cast<float>(FastMath::log(arg)); }
+
+    template <class ExpType>
+    static float pow(float base, const ExpType& exp)
+    { return static_cast<float>(FastMath::pow(base, static_cast<double>(exp))); }
+};
+
+} // namespace DenseAd
+} // namespace Opm
+
+#endif
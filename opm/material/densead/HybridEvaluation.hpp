@@ -0,0 +1,948 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Representation of an evaluation of a function and its derivatives which keeps
+ *        track of the derivatives that can be non-zero.
+ */
+#ifndef OPM_DENSEAD_HYBRID_EVALUATION_HPP
+#define OPM_DENSEAD_HYBRID_EVALUATION_HPP
+
+#include "Evaluation.hpp"
+#include "Math.hpp"
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+namespace Opm {
+namespace DenseAd {
+
+/*!
+ * \brief Represents a function evaluation and its derivatives w.r.t. a fixed set of
+ *        variables where only a subset of the derivatives is non-zero.
+ *
+ * In addition to the value and the derivatives, objects of this class store a bit mask
+ * of the "active" derivatives, i.e., the ones which are potentially non-zero. All
+ * inactive derivatives are zero and their storage is neither read nor written by the
+ * arithmetic operations. This reduces the number of floating point operations and the
+ * memory traffic considerably if many intermediate quantities only depend on a few of the
+ * primary variables, like for compositional flash calculations with many components. If
+ * all derivatives of the operands are active, plain dense loops are used.
+ *
+ * The class exhibits the same interface as Opm::DenseAd::Evaluation and its results
+ * agree with the ones of the dense evaluations except for the sign of zero
+ * derivatives. Note that the storage of inactive derivatives is left uninitialized.
+ */
+template <class ValueT, int numDerivs>
+class HybridEvaluation
+{
+    static_assert(0 < numDerivs && numDerivs <= 64,
+                  "HybridEvaluation is only implemented for 1 to 64 derivatives");
+
+public:
+    //! field type
+    typedef ValueT ValueType;
+
+    //! type of the bit mask of the active derivatives
+    typedef std::uint64_t Mask;
+
+    //! number of derivatives
+    static constexpr int size = numDerivs;
+
+    //! the bit mask which represents that all derivatives are active
+    static constexpr Mask fullMask = (numDerivs == 64) ? ~Mask(0) : ((Mask(1) << numDerivs) - 1);
+
+    //! the dense evaluation which is equivalent to this class
+    typedef Opm::DenseAd::Evaluation<ValueT, numDerivs> DenseEvaluation;
+
+    //! default constructor
+    HybridEvaluation() : value_(0.0), mask_(0)
+    {}
+
+    //! copy other function evaluation
+    HybridEvaluation(const HybridEvaluation& other) = default;
+
+    // create an evaluation which represents a constant function
+    //
+    // i.e., f(x) = c. this implies an evaluation with the given value and all
+    // derivatives being zero.
+    template <class RhsValueType>
+    HybridEvaluation(const RhsValueType& c)
+        : value_(c), mask_(0)
+    {}
+
+    // create an evaluation which represents the variable with the given index
+    template <class RhsValueType>
+    HybridEvaluation(const RhsValueType& c, int varPos)
+        : value_(c), mask_(Mask(1) << varPos)
+    {
+        assert(0 <= varPos && varPos < size);
+
+        derivatives_[varPos] = 1.0;
+    }
+
+    // convert a dense evaluation. only the non-zero derivatives become active.
+    explicit HybridEvaluation(const DenseEvaluation& dense)
+        : value_(dense.value()), mask_(0)
+    {
+        for (int varIdx = 0; varIdx < size; ++varIdx) {
+            if (dense.derivative(varIdx) != 0.0) {
+                mask_ |= Mask(1) << varIdx;
+                derivatives_[varIdx] = dense.derivative(varIdx);
+            }
+        }
+    }
+
+    // convert the object to a dense evaluation
+    DenseEvaluation toDense() const
+    {
+        DenseEvaluation result(value_);
+        forEachActive_(mask_, [&](int i) { result.setDerivative(i, derivatives_[i]); });
+        return result;
+    }
+
+    // set all derivatives to zero
+    void clearDerivatives()
+    { mask_ = 0; }
+
+    // create a function evaluation for a "naked" depending variable (i.e., f(x) = x)
+    template <class RhsValueType>
+    static HybridEvaluation createVariable(const RhsValueType& value, int varPos)
+    { return HybridEvaluation(value, varPos); }
+
+    // "evaluate" a constant function (i.e. a function that does not depend on the set of
+    // relevant variables, f(x) = c).
+    template <class RhsValueType>
+    static HybridEvaluation createConstant(const RhsValueType& value)
+    { return HybridEvaluation(value); }
+
+    // print the value and the derivatives of the function evaluation
+    void print(std::ostream& os = std::cout) const
+    {
+        // print value
+        os << "v: " << value() << " / d:";
+
+        // print derivatives
+        for (int varIdx = 0; varIdx < size; ++varIdx) {
+            os << " " << derivative(varIdx);
+        }
+    }
+
+    // copy all derivatives from other
+    void copyDerivatives(const HybridEvaluation& other)
+    {
+        mask_ = other.mask_;
+        forEachActive_(mask_, [&](int i) { derivatives_[i] = other.derivatives_[i]; });
+    }
+
+    // set all derivatives to the ones of other multiplied by a factor, i.e., apply the
+    // chain rule f(g(x))' = f'(g(x))*g'(x)
+    void setScaledDerivatives(const ValueType& factor, const HybridEvaluation& other)
+    {
+        mask_ = other.mask_;
+        if (mask_ == fullMask) {
+            for (int i = 0; i < size; ++i)
+                derivatives_[i] = factor*other.derivatives_[i];
+        }
+        else
+            forEachActive_(mask_, [&](int i) { derivatives_[i] = factor*other.derivatives_[i]; });
+    }
+
+    // set the derivatives to fn(a', b') for all derivatives which are active in a or in
+    // b. inactive derivatives of the arguments are passed as zero, and fn(0, 0) must be
+    // zero.
+    template <class BinaryFn>
+    void setDerivatives(const HybridEvaluation& a, const HybridEvaluation& b, BinaryFn fn)
+    {
+        const ValueType zero = 0.0;
+        const Mask both = a.mask_ & b.mask_;
+        const Mask onlyA = a.mask_ & ~b.mask_;
+        const Mask onlyB = b.mask_ & ~a.mask_;
+
+        // the arguments may be the same object as this one, so they must be read
+        // before any of the results are written.
+        std::array<ValueType, size> tmp;
+        forEachActive_(both, [&](int i) { tmp[i] = fn(a.derivatives_[i], b.derivatives_[i]); });
+        forEachActive_(onlyA, [&](int i) { tmp[i] = fn(a.derivatives_[i], zero); });
+        forEachActive_(onlyB, [&](int i) { tmp[i] = fn(zero, b.derivatives_[i]); });
+
+        mask_ = a.mask_ | b.mask_;
+        forEachActive_(mask_, [&](int i) { derivatives_[i] = tmp[i]; });
+    }
+
+    // add value and derivatives from other to this values and derivatives
+    HybridEvaluation& operator+=(const HybridEvaluation& other)
+    {
+        value_ += other.value_;
+
+        if ((mask_ & other.mask_) == fullMask) {
+            for (int i = 0; i < size; ++i)
+                derivatives_[i] += other.derivatives_[i];
+            return *this;
+        }
+
+        forEachActive_(mask_ & other.mask_,
+                       [&](int i) { derivatives_[i] += other.derivatives_[i]; });
+        forEachActive_(other.mask_ & ~mask_,
+                       [&](int i) { derivatives_[i] = other.derivatives_[i]; });
+        mask_ |= other.mask_;
+
+        return *this;
+    }
+
+    // add value from other to this values
+    template <class RhsValueType>
+    HybridEvaluation& operator+=(const RhsValueType& other)
+    {
+        // value is added, derivatives stay the same
+        value_ += other;
+
+        return *this;
+    }
+
+    // subtract other's value and derivatives from this values
+    HybridEvaluation& operator-=(const HybridEvaluation& other)
+    {
+        value_ -= other.value_;
+
+        if ((mask_ & other.mask_) == fullMask) {
+            for (int i = 0; i < size; ++i)
+                derivatives_[i] -= other.derivatives_[i];
+            return *this;
+        }
+
+        forEachActive_(mask_ & other.mask_,
+                       [&](int i) { derivatives_[i] -= other.derivatives_[i]; });
+        forEachActive_(other.mask_ & ~mask_,
+                       [&](int i) { derivatives_[i] = - other.derivatives_[i]; });
+        mask_ |= other.mask_;
+
+        return *this;
+    }
+
+    // subtract other's value from this values
+    template <class RhsValueType>
+    HybridEvaluation& operator-=(const RhsValueType& other)
+    {
+        // for constants, values are subtracted, derivatives stay the same
+        value_ -= other;
+
+        return *this;
+    }
+
+    // multiply values and apply chain rule to derivatives: (u*v)' = (v'u + u'v)
+    HybridEvaluation& operator*=(const HybridEvaluation& other)
+    {
+        const ValueType u = value_;
+        const ValueType v = other.value_;
+
+        // value
+        value_ *= v;
+
+        // derivatives
+        if ((mask_ & other.mask_) == fullMask) {
+            for (int i = 0; i < size; ++i)
+                derivatives_[i] = derivatives_[i]*v + other.derivatives_[i]*u;
+            return *this;
+        }
+
+        forEachActive_(mask_ & other.mask_,
+                       [&](int i) { derivatives_[i] = derivatives_[i]*v + other.derivatives_[i]*u; });
+        forEachActive_(mask_ & ~other.mask_,
+                       [&](int i) { derivatives_[i] *= v; });
+        forEachActive_(other.mask_ & ~mask_,
+                       [&](int i) { derivatives_[i] = other.derivatives_[i]*u; });
+        mask_ |= other.mask_;
+
+        return *this;
+    }
+
+    // m(c*u)' = c*u'
+    template <class RhsValueType>
+    HybridEvaluation& operator*=(const RhsValueType& other)
+    {
+        value_ *= other;
+        forEachActive_(mask_, [&](int i) { derivatives_[i] *= other; });
+
+        return *this;
+    }
+
+    // m(u*v)' = (vu' - uv')/v^2
+    HybridEvaluation& operator/=(const HybridEvaluation& other)
+    {
+        const ValueType u = value_;
+        const ValueType v = other.value_;
+
+        // derivatives
+        if ((mask_ & other.mask_) == fullMask) {
+            for (int i = 0; i < size; ++i)
+                derivatives_[i] = (v*derivatives_[i] - u*other.derivatives_[i])/(v*v);
+        }
+        else {
+            forEachActive_(mask_ & other.mask_,
+                           [&](int i) { derivatives_[i] = (v*derivatives_[i] - u*other.derivatives_[i])/(v*v); });
+            forEachActive_(mask_ & ~other.mask_,
+                           [&](int i) { derivatives_[i] = (v*derivatives_[i])/(v*v); });
+            forEachActive_(other.mask_ & ~mask_,
+                           [&](int i) { derivatives_[i] = (- u*other.derivatives_[i])/(v*v); });
+            mask_ |= other.mask_;
+        }
+
+        // value
+        value_ /= v;
+
+        return *this;
+    }
+
+    // divide value and derivatives by value of other
+    template <class RhsValueType>
+    HybridEvaluation& operator/=(const RhsValueType& other)
+    {
+        const ValueType tmp = 1.0/other;
+
+        return (*this) *= tmp;
+    }
+
+    // add two evaluation objects
+    HybridEvaluation operator+(const HybridEvaluation& other) const
+    {
+        HybridEvaluation result(*this);
+        result += other;
+        return result;
+    }
+
+    // add constant to this object
+    template <class RhsValueType>
+    HybridEvaluation operator+(const RhsValueType& other) const
+    {
+        HybridEvaluation result(*this);
+        result += other;
+        return result;
+    }
+
+    // subtract two evaluation objects
+    HybridEvaluation operator-(const HybridEvaluation& other) const
+    {
+        HybridEvaluation result(*this);
+        result -= other;
+        return result;
+    }
+
+    // subtract constant from evaluation object
+    template <class RhsValueType>
+    HybridEvaluation operator-(const RhsValueType& other) const
+    {
+        HybridEvaluation result(*this);
+        result -= other;
+        return result;
+    }
+
+    // negation (unary minus) operator
+    HybridEvaluation operator-() const
+    {
+        HybridEvaluation result;
+
+        result.value_ = - value_;
+        result.mask_ = mask_;
+        forEachActive_(mask_, [&](int i) { result.derivatives_[i] = - derivatives_[i]; });
+
+        return result;
+    }
+
+    HybridEvaluation operator*(const HybridEvaluation& other) const
+    {
+        HybridEvaluation result(*this);
+        result *= other;
+        return result;
+    }
+
+    template <class RhsValueType>
+    HybridEvaluation operator*(const RhsValueType& other) const
+    {
+        HybridEvaluation result(*this);
+        result *= other;
+        return result;
+    }
+
+    HybridEvaluation operator/(const HybridEvaluation& other) const
+    {
+        HybridEvaluation result(*this);
+        result /= other;
+        return result;
+    }
+
+    template <class RhsValueType>
+    HybridEvaluation operator/(const RhsValueType& other) const
+    {
+        HybridEvaluation result(*this);
+        result /= other;
+        return result;
+    }
+
+    template <class RhsValueType>
+    HybridEvaluation& operator=(const RhsValueType& other)
+    {
+        setValue( other );
+        clearDerivatives();
+
+        return *this;
+    }
+
+    // copy assignment from evaluation
+    HybridEvaluation& operator=(const HybridEvaluation& other) = default;
+
+    template <class RhsValueType>
+    bool operator==(const RhsValueType& other) const
+    { return value() == other; }
+
+    bool operator==(const HybridEvaluation& other) const
+    {
+        if (value_ != other.value_)
+            return false;
+
+        for (int varIdx = 0; varIdx < size; ++varIdx)
+            if (derivative(varIdx) != other.derivative(varIdx))
+                return false;
+
+        return true;
+    }
+
+    bool operator!=(const HybridEvaluation& other) const
+    { return !operator==(other); }
+
+    template <class RhsValueType>
+    bool operator>(RhsValueType other) const
+    { return value() > other; }
+
+    bool operator>(const HybridEvaluation& other) const
+    { return value() > other.value(); }
+
+    template <class RhsValueType>
+    bool operator<(RhsValueType other) const
+    { return value() < other; }
+
+    bool operator<(const HybridEvaluation& other) const
+    { return value() < other.value(); }
+
+    template <class RhsValueType>
+    bool operator>=(RhsValueType other) const
+    { return value() >= other; }
+
+    bool operator>=(const HybridEvaluation& other) const
+    { return value() >= other.value(); }
+
+    template <class RhsValueType>
+    bool operator<=(RhsValueType other) const
+    { return value() <= other; }
+
+    bool operator<=(const HybridEvaluation& other) const
+    { return value() <= other.value(); }
+
+    // return value of variable
+    const ValueType& value() const
+    { return value_; }
+
+    // set value of variable
+    template <class RhsValueType>
+    void setValue(const RhsValueType& val)
+    { value_ = val; }
+
+    // return varIdx'th derivative
+    ValueType derivative(int varIdx) const
+    {
+        assert(0 <= varIdx && varIdx < size);
+
+        if (!isActive(varIdx))
+            return 0.0;
+        return derivatives_[varIdx];
+    }
+
+    // set derivative at position varIdx
+    void setDerivative(int varIdx, const ValueType& derVal)
+    {
+        assert(0 <= varIdx && varIdx < size);
+
+        mask_ |= Mask(1) << varIdx;
+        derivatives_[varIdx] = derVal;
+    }
+
+    // returns true if the derivative at position varIdx is potentially non-zero
+    bool isActive(int varIdx) const
+    { return (mask_ >> varIdx) & 1; }
+
+    // returns the bit mask of the potentially non-zero derivatives
+    Mask activeMask() const
+    { return mask_; }
+
+    // returns the number of potentially non-zero derivatives
+    int numActiveDerivatives() const
+    {
+        int n = 0;
+        forEachActive_(mask_, [&](int) { ++n; });
+        return n;
+    }
+
+private:
+    // call fn(i) for all bits i which are set in the mask in ascending order
+    template <class Fn>
+    static void forEachActive_(Mask mask, Fn fn)
+    {
+        while (mask) {
+#if defined(__GNUC__) || defined(__clang__)
+            const int i = __builtin_ctzll(mask);
+#else
+            int i = 0;
+            while (!((mask >> i) & 1))
+                ++i;
+#endif
+            fn(i);
+            mask &= mask - 1;
+        }
+    }
+
+    ValueType value_;
+    Mask mask_;
+    std::array<ValueType, size> derivatives_;
+};
+
+template <class RhsValueType, class ValueType, int numVars>
+bool operator<(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{ return b > a; }
+
+template <class RhsValueType, class ValueType, int numVars>
+bool operator>(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{ return b < a; }
+
+template <class RhsValueType, class ValueType, int numVars>
+bool operator<=(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{ return b >= a; }
+
+template <class RhsValueType, class ValueType, int numVars>
+bool operator>=(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{ return b <= a; }
+
+template <class RhsValueType, class ValueType, int numVars>
+bool operator!=(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{ return a != b.value(); }
+
+template <class RhsValueType, class ValueType, int numVars>
+HybridEvaluation<ValueType, numVars> operator+(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{
+    HybridEvaluation<ValueType, numVars> result(b);
+    result += a;
+    return result;
+}
+
+template <class RhsValueType, class ValueType, int numVars>
+HybridEvaluation<ValueType, numVars> operator-(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{
+    HybridEvaluation<ValueType, numVars> result(a);
+    result -= b;
+    return result;
+}
+
+template <class RhsValueType, class ValueType, int numVars>
+HybridEvaluation<ValueType, numVars> operator/(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{
+    HybridEvaluation<ValueType, numVars> tmp(a);
+    tmp /= b;
+    return tmp;
+}
+
+template <class RhsValueType, class ValueType, int numVars>
+HybridEvaluation<ValueType, numVars> operator*(const RhsValueType& a, const HybridEvaluation<ValueType, numVars>& b)
+{
+    HybridEvaluation<ValueType, numVars> result(b);
+    result *= a;
+    return result;
+}
+
+template <class ValueType, int numVars>
+std::ostream& operator<<(std::ostream& os, const HybridEvaluation<ValueType, numVars>& eval)
+{
+    os << eval.value();
+    return os;
+}
+
+// provide some algebraic functions. the number of derivatives is the first template
+// parameter of these functions so that explicitly specified template arguments like
+// 'Opm::DenseAd::sin<double, 3>' unambiguously refer to the dense variants.
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> abs(const HybridEvaluation<ValueType, numVars>& x)
+{ return (x > 0.0)?x:-x; }
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> min(const HybridEvaluation<ValueType, numVars>& x1,
+                                         const HybridEvaluation<ValueType, numVars>& x2)
+{ return (x1 < x2)?x1:x2; }
+
+template <int numVars, class Arg1ValueType, class ValueType>
+HybridEvaluation<ValueType, numVars> min(const Arg1ValueType& x1,
+                                         const HybridEvaluation<ValueType, numVars>& x2)
+{ return (x1 < x2)?HybridEvaluation<ValueType, numVars>(x1):x2; }
+
+template <int numVars, class ValueType, class Arg2ValueType>
+HybridEvaluation<ValueType, numVars> min(const HybridEvaluation<ValueType, numVars>& x1,
+                                         const Arg2ValueType& x2)
+{ return min(x2, x1); }
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> max(const HybridEvaluation<ValueType, numVars>& x1,
+                                         const HybridEvaluation<ValueType, numVars>& x2)
+{ return (x1 > x2)?x1:x2; }
+
+template <int numVars, class Arg1ValueType, class ValueType>
+HybridEvaluation<ValueType, numVars> max(const Arg1ValueType& x1,
+                                         const HybridEvaluation<ValueType, numVars>& x2)
+{ return (x1 > x2)?HybridEvaluation<ValueType, numVars>(x1):x2; }
+
+template <int numVars, class ValueType, class Arg2ValueType>
+HybridEvaluation<ValueType, numVars> max(const HybridEvaluation<ValueType, numVars>& x1,
+                                         const Arg2ValueType& x2)
+{ return max(x2, x1); }
+
+// apply the chain rule for a function f with f(x) = fx and f'(x) = df_dx
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> chainRule_(const HybridEvaluation<ValueType, numVars>& x,
+                                                const ValueType& fx,
+                                                const ValueType& df_dx)
+{
+    HybridEvaluation<ValueType, numVars> result(fx);
+    result.setScaledDerivatives(df_dx, x);
+    return result;
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> tan(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    const ValueType& tmp = ValueTypeToolbox::tan(x.value());
+    return chainRule_(x, tmp, static_cast<ValueType>(1 + tmp*tmp));
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> atan(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    return chainRule_(x,
+                      ValueTypeToolbox::atan(x.value()),
+                      static_cast<ValueType>(1/(1 + x.value()*x.value())));
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> atan2(const HybridEvaluation<ValueType, numVars>& x,
+                                           const HybridEvaluation<ValueType, numVars>& y)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    HybridEvaluation<ValueType, numVars> result(ValueTypeToolbox::atan2(x.value(), y.value()));
+
+    // derivatives use the chain rule
+    const ValueType xv = x.value();
+    const ValueType yv = y.value();
+    const ValueType& alpha = 1/(1 + (xv*xv)/(yv*yv));
+    result.setDerivatives(x, y,
+                          [&](const ValueType& xPrime, const ValueType& yPrime)
+                          { return alpha/(yv*yv)*(xPrime*yv - xv*yPrime); });
+
+    return result;
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> sin(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    return chainRule_(x,
+                      ValueTypeToolbox::sin(x.value()),
+                      ValueTypeToolbox::cos(x.value()));
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> asin(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    return chainRule_(x,
+                      ValueTypeToolbox::asin(x.value()),
+                      static_cast<ValueType>(1.0/ValueTypeToolbox::sqrt(1 - x.value()*x.value())));
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> cos(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    return chainRule_(x,
+                      ValueTypeToolbox::cos(x.value()),
+                      static_cast<ValueType>(-ValueTypeToolbox::sin(x.value())));
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> acos(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    return chainRule_(x,
+                      ValueTypeToolbox::acos(x.value()),
+                      static_cast<ValueType>(- 1.0/ValueTypeToolbox::sqrt(1 - x.value()*x.value())));
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> sqrt(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    const ValueType& sqrt_x = ValueTypeToolbox::sqrt(x.value());
+    return chainRule_(x, sqrt_x, static_cast<ValueType>(0.5/sqrt_x));
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> exp(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    const ValueType& exp_x = ValueTypeToolbox::exp(x.value());
+    return chainRule_(x, exp_x, exp_x);
+}
+
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> log(const HybridEvaluation<ValueType, numVars>& x)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    return chainRule_(x,
+                      ValueTypeToolbox::log(x.value()),
+                      static_cast<ValueType>(1/x.value()));
+}
+
+// exponentiation of arbitrary base with a fixed constant
+template <int numVars, class ValueType, class ExpType>
+HybridEvaluation<ValueType, numVars> pow(const HybridEvaluation<ValueType, numVars>& base,
+                                         const ExpType& exp)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    // we special case the base 0 case because 0.0 is in the valid range of the
+    // base but the generic code leads to NaNs.
+    if (base == 0.0)
+        return HybridEvaluation<ValueType, numVars>(0.0);
+
+    const ValueType& pow_x = ValueTypeToolbox::pow(base.value(), exp);
+    return chainRule_(base, pow_x, static_cast<ValueType>(pow_x/base.value()*exp));
+}
+
+// exponentiation of constant base with an arbitrary exponent
+template <int numVars, class BaseType, class ValueType>
+HybridEvaluation<ValueType, numVars> pow(const BaseType& base,
+                                         const HybridEvaluation<ValueType, numVars>& exp)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    // we special case the base 0 case because 0.0 is in the valid range of the
+    // base but the generic code leads to NaNs.
+    if (base == 0.0)
+        return HybridEvaluation<ValueType, numVars>(0.0);
+
+    const ValueType& lnBase = ValueTypeToolbox::log(base);
+    const ValueType& value = ValueTypeToolbox::exp(lnBase*exp.value());
+    return chainRule_(exp, value, static_cast<ValueType>(lnBase*value));
+}
+
+// this is the most expensive power function. Computationally it is pretty expensive, so
+// one of the above two variants above should be preferred if possible.
+template <int numVars, class ValueType>
+HybridEvaluation<ValueType, numVars> pow(const HybridEvaluation<ValueType, numVars>& base,
+                                         const HybridEvaluation<ValueType, numVars>& exp)
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    // we special case the base 0 case because 0.0 is in the valid range of the
+    // base but the generic code leads to NaNs.
+    if (base == 0.0)
+        return HybridEvaluation<ValueType, numVars>(0.0);
+
+    const ValueType valuePow = ValueTypeToolbox::pow(base.value(), exp.value());
+    HybridEvaluation<ValueType, numVars> result(valuePow);
+
+    // use the chain rule for the derivatives. since both, the base and the exponent can
+    // potentially depend on the variable set, calculating these is quite elaborate...
+    const ValueType f = base.value();
+    const ValueType g = exp.value();
+    const ValueType logF = ValueTypeToolbox::log(f);
+    result.setDerivatives(base, exp,
+                          [&](const ValueType& fPrime, const ValueType& gPrime)
+                          { return (g*fPrime/f + logF*gPrime) * valuePow; });
+
+    return result;
+}
+
+} // namespace DenseAd
+
+// a kind of traits class for the automatic differentiation case. (The toolbox for the
+// scalar case is provided by the MathToolbox.hpp header file.)
+template <class ValueT, int numVars>
+struct MathToolbox<Opm::DenseAd::HybridEvaluation<ValueT, numVars> >
+{
+public:
+    typedef ValueT ValueType;
+    typedef Opm::MathToolbox<ValueType> InnerToolbox;
+    typedef typename InnerToolbox::Scalar Scalar;
+    typedef Opm::DenseAd::HybridEvaluation<ValueType, numVars> Evaluation;
+
+    static ValueType value(const Evaluation& eval)
+    { return eval.value(); }
+
+    static decltype(InnerToolbox::scalarValue(0.0)) scalarValue(const Evaluation& eval)
+    { return InnerToolbox::scalarValue(eval.value()); }
+
+    static Evaluation createConstant(ValueType value)
+    { return Evaluation::createConstant(value); }
+
+    static Evaluation createVariable(ValueType value, int varIdx)
+    { return Evaluation::createVariable(value, varIdx); }
+
+    template <class LhsEval>
+    static typename std::enable_if<std::is_same<Evaluation, LhsEval>::value,
+                                   LhsEval>::type
+    decay(const Evaluation& eval)
+    { return eval; }
+
+    template <class LhsEval>
+    static typename std::enable_if<std::is_same<Evaluation, LhsEval>::value,
+                                   LhsEval>::type
+    decay(const Evaluation&& eval)
+    { return eval; }
+
+    template <class LhsEval>
+    static typename std::enable_if<std::is_floating_point<LhsEval>::value,
+                                   LhsEval>::type
+    decay(const Evaluation& eval)
+    { return eval.value(); }
+
+    // comparison
+    static bool isSame(const Evaluation& a, const Evaluation& b, Scalar tolerance)
+    {
+        typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+        // make sure that the value of the evaluation is identical
+        if (!ValueTypeToolbox::isSame(a.value(), b.value(), tolerance))
+            return false;
+
+        // make sure that the derivatives are identical
+        for (int curVarIdx = 0; curVarIdx < numVars; ++curVarIdx)
+            if (!ValueTypeToolbox::isSame(a.derivative(curVarIdx), b.derivative(curVarIdx), tolerance))
+                return false;
+
+        return true;
+    }
+
+    // arithmetic functions
+    template <class Arg1Eval, class Arg2Eval>
+    static Evaluation max(const Arg1Eval& arg1, const Arg2Eval& arg2)
+    { return Opm::DenseAd::max(arg1, arg2); }
+
+    template <class Arg1Eval, class Arg2Eval>
+    static Evaluation min(const Arg1Eval& arg1, const Arg2Eval& arg2)
+    { return Opm::DenseAd::min(arg1, arg2); }
+
+    static Evaluation abs(const Evaluation& arg)
+    { return Opm::DenseAd::abs(arg); }
+
+    static Evaluation tan(const Evaluation& arg)
+    { return Opm::DenseAd::tan(arg); }
+
+    static Evaluation atan(const Evaluation& arg)
+    { return Opm::DenseAd::atan(arg); }
+
+    static Evaluation atan2(const Evaluation& arg1, const Evaluation& arg2)
+    { return Opm::DenseAd::atan2(arg1, arg2); }
+
+    static Evaluation sin(const Evaluation& arg)
+    { return Opm::DenseAd::sin(arg); }
+
+    static Evaluation asin(const Evaluation& arg)
+    { return Opm::DenseAd::asin(arg); }
+
+    static Evaluation cos(const Evaluation& arg)
+    { return Opm::DenseAd::cos(arg); }
+
+    static Evaluation acos(const Evaluation& arg)
+    { return Opm::DenseAd::acos(arg); }
+
+    static Evaluation sqrt(const Evaluation& arg)
+    { return Opm::DenseAd::sqrt(arg); }
+
+    static Evaluation exp(const Evaluation& arg)
+    { return Opm::DenseAd::exp(arg); }
+
+    static Evaluation log(const Evaluation& arg)
+    { return Opm::DenseAd::log(arg); }
+
+    template <class RhsValueType>
+    static Evaluation pow(const Evaluation& arg1, const RhsValueType& arg2)
+    { return Opm::DenseAd::pow(arg1, arg2); }
+
+    template <class RhsValueType>
+    static Evaluation pow(const RhsValueType& arg1, const Evaluation& arg2)
+    { return Opm::DenseAd::pow(arg1, arg2); }
+
+    static Evaluation pow(const Evaluation& arg1, const Evaluation& arg2)
+    { return Opm::DenseAd::pow(arg1, arg2); }
+
+    static bool isfinite(const Evaluation& arg)
+    {
+        if (!InnerToolbox::isfinite(arg.value()))
+            return false;
+
+        for (int i = 0; i < numVars; ++i)
+            if (!InnerToolbox::isfinite(arg.derivative(i)))
+                return false;
+
+        return true;
+    }
+
+    static bool isnan(const Evaluation& arg)
+    {
+        if (InnerToolbox::isnan(arg.value()))
+            return true;
+
+        for (int i = 0; i < numVars; ++i)
+            if (InnerToolbox::isnan(arg.derivative(i)))
+                return true;
+
+        return false;
+    }
+};
+
+} // namespace Opm
+
+#endif
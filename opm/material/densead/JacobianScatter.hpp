@@ -0,0 +1,182 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Functions which transfer the values and derivatives of dense-AD evaluations
+ *        into residual vectors and blocks of Jacobian matrices.
+ *
+ * The derivatives of an evaluation are stored contiguously, so a row of a Jacobian
+ * block can be filled by copying the complete derivative array at once instead of
+ * calling derivative() for each entry. The copies use the kernels of
+ * DerivativeKernels.hpp, i.e., they are explicitly vectorized if OPM_DENSEAD_USE_SIMD
+ * is enabled. Each row of a block is assumed to store the derivatives with regard to
+ * all primary variables consecutively, i.e., the number of columns of a block must be
+ * the number of derivatives of the evaluations.
+ */
+#ifndef OPM_DENSEAD_JACOBIAN_SCATTER_HPP
+#define OPM_DENSEAD_JACOBIAN_SCATTER_HPP
+
+#include "Evaluation.hpp"
+#include "DerivativeKernels.hpp"
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cstddef>
+
+namespace Opm {
+namespace DenseAd {
+
+/*!
+ * \brief Copy the derivatives of a sequence of evaluations into the rows of a block.
+ *
+ * The derivatives of evals[k] are written to block[k*rowStride + i] for
+ * 0 <= i < numVars, i.e., 'rowStride' is the distance between two consecutive rows
+ * of the block in memory.
+ *
+ * \param block Pointer to the first entry of the first row of the block
+ * \param rowStride The distance between the first entries of two consecutive rows
+ * \param evals Pointer to the first evaluation
+ * \param numEvals The number of evaluations, i.e., the number of rows to be written
+ */
+template <class ValueT, int numVars>
+void scatterDerivatives(ValueT* block,
+                        std::size_t rowStride,
+                        const Evaluation<ValueT, numVars>* evals,
+                        std::size_t numEvals)
+{
+    typedef DerivativeKernels<ValueT, numVars> Kernels;
+
+    for (std::size_t k = 0; k < numEvals; ++k)
+        Kernels::copy(block + k*rowStride, &evals[k].derivative(0));
+}
+
+/*!
+ * \brief Copy the derivatives of a sequence of evaluations into the rows of a
+ *        Dune::FieldMatrix.
+ *
+ * Row k of the matrix receives the derivatives of evals[k]. 'evals' can be any
+ * container which provides the evals[k] syntax.
+ */
+template <class ValueT, int numEqs, int numVars, class EvalContainer>
+void scatterDerivatives(Dune::FieldMatrix<ValueT, numEqs, numVars>& block,
+                        const EvalContainer& evals)
+{
+    typedef DerivativeKernels<ValueT, numVars> Kernels;
+
+    for (int eqIdx = 0; eqIdx < numEqs; ++eqIdx)
+        Kernels::copy(&block[eqIdx][0], &evals[eqIdx].derivative(0));
+}
+
+/*!
+ * \brief Add a sequence of evaluations to the entries of a residual and to the rows of
+ *        the corresponding block of the Jacobian matrix at once.
+ *
+ * For each k < numEqs, this computes residual[k] += flux[k].value() and adds the
+ * derivatives of flux[k] to the k-th row of the block, which starts at
+ * block[k*rowStride].
+ */
+template <class ValueT, int numVars>
+void accumulateResidualAndJacobian(ValueT* residual,
+                                   ValueT* block,
+                                   std::size_t rowStride,
+                                   const Evaluation<ValueT, numVars>* flux,
+                                   std::size_t numEqs)
+{
+    typedef DerivativeKernels<ValueT, numVars> Kernels;
+
+    for (std::size_t k = 0; k < numEqs; ++k) {
+        residual[k] += flux[k].value();
+        Kernels::add(block + k*rowStride, &flux[k].derivative(0));
+    }
+}
+
+/*!
+ * \brief Add a multiple of a sequence of evaluations to the entries of a residual and
+ *        to the rows of the corresponding block of the Jacobian matrix at once.
+ *
+ * This is the same as the variant without the factor, but 'factor*flux[k]' is added
+ * instead of 'flux[k]'. This can e.g. be used to subtract a flux from the equations of
+ * the neighboring degree of freedom.
+ */
+template <class ValueT, int numVars>
+void accumulateResidualAndJacobian(ValueT* residual,
+                                   ValueT* block,
+                                   std::size_t rowStride,
+                                   const Evaluation<ValueT, numVars>* flux,
+                                   std::size_t numEqs,
+                                   const ValueT& factor)
+{
+    typedef DerivativeKernels<ValueT, numVars> Kernels;
+
+    for (std::size_t k = 0; k < numEqs; ++k) {
+        residual[k] += factor*flux[k].value();
+        Kernels::addScaled(block + k*rowStride, &flux[k].derivative(0), factor);
+    }
+}
+
+/*!
+ * \brief Add a sequence of evaluations to a residual vector and a block of the
+ *        Jacobian matrix which are represented by Dune data structures.
+ *
+ * Entry k of the residual and row k of the block are updated using flux[k]. 'flux'
+ * can be any container which provides the flux[k] syntax.
+ */
+template <class ValueT, int numEqs, int numVars, class EvalContainer>
+void accumulateResidualAndJacobian(Dune::FieldVector<ValueT, numEqs>& residual,
+                                   Dune::FieldMatrix<ValueT, numEqs, numVars>& block,
+                                   const EvalContainer& flux)
+{
+    typedef DerivativeKernels<ValueT, numVars> Kernels;
+
+    for (int eqIdx = 0; eqIdx < numEqs; ++eqIdx) {
+        residual[eqIdx] += flux[eqIdx].value();
+        Kernels::add(&block[eqIdx][0], &flux[eqIdx].derivative(0));
+    }
+}
+
+/*!
+ * \brief Add a multiple of a sequence of evaluations to a residual vector and a block
+ *        of the Jacobian matrix which are represented by Dune data structures.
+ */
+template <class ValueT, int numEqs, int numVars, class EvalContainer>
+void accumulateResidualAndJacobian(Dune::FieldVector<ValueT, numEqs>& residual,
+                                   Dune::FieldMatrix<ValueT, numEqs, numVars>& block,
+                                   const EvalContainer& flux,
+                                   const ValueT& factor)
+{
+    typedef DerivativeKernels<ValueT, numVars> Kernels;
+
+    for (int eqIdx = 0; eqIdx < numEqs; ++eqIdx) {
+        residual[eqIdx] += factor*flux[eqIdx].value();
+        Kernels::addScaled(&block[eqIdx][0], &flux[eqIdx].derivative(0), factor);
+    }
+}
+
+} // namespace DenseAd
+} // namespace Opm
+
+#endif
@@ -33,6 +33,7 @@
 #define OPM_LOCAL_AD_MATH_HPP
 
 #include "Evaluation.hpp"
+#include "FastMath.hpp"
 
 #include <opm/material/common/MathToolbox.hpp>
 
@@ -42,6 +43,16 @@ namespace DenseAd {
 template <class ValueT, int numVars>
 class Evaluation;
 
+// the toolbox which is used to compute the values of exp(), log() and pow(). (see
+// FastMath.hpp)
+#if OPM_DENSEAD_FAST_MATH
+template <class ValueType>
+using TranscendentalToolbox = FastMathToolbox<ValueType>;
+#else
+template <class ValueType>
+using TranscendentalToolbox = Opm::MathToolbox<ValueType>;
+#endif
+
 // provide some algebraic functions
 template <class ValueType, int numVars>
 Evaluation<ValueType, numVars> abs(const Evaluation<ValueType, numVars>& x)
@@ -89,8 +100,7 @@ Evaluation<ValueType, numVars> tan(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     const ValueType& df_dx = 1 + tmp*tmp;
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
@@ -106,8 +116,7 @@ Evaluation<ValueType, numVars> atan(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     const ValueType& df_dx = 1/(1 + x.value()*x.value());
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
@@ -144,8 +153,7 @@ Evaluation<ValueType, numVars> sin(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     const ValueType& df_dx = ValueTypeToolbox::cos(x.value());
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
@@ -161,8 +169,7 @@ Evaluation<ValueType, numVars> asin(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     const ValueType& df_dx = 1.0/ValueTypeToolbox::sqrt(1 - x.value()*x.value());
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
@@ -178,8 +185,7 @@ Evaluation<ValueType, numVars> cos(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     const ValueType& df_dx = -ValueTypeToolbox::sin(x.value());
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
@@ -195,8 +201,7 @@ Evaluation<ValueType, numVars> acos(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     const ValueType& df_dx = - 1.0/ValueTypeToolbox::sqrt(1 - x.value()*x.value());
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
@@ -213,9 +218,7 @@ Evaluation<ValueType, numVars> sqrt(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     ValueType df_dx = 0.5/sqrt_x;
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx) {
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
-    }
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
@@ -223,7 +226,7 @@ Evaluation<ValueType, numVars> sqrt(const Evaluation<ValueType, numVars>& x)
 template <class ValueType, int numVars>
 Evaluation<ValueType, numVars> exp(const Evaluation<ValueType, numVars>& x)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef TranscendentalToolbox<ValueType> ValueTypeToolbox;
     Evaluation<ValueType, numVars> result;
 
     const ValueType& exp_x = ValueTypeToolbox::exp(x.value());
@@ -231,8 +234,7 @@ Evaluation<ValueType, numVars> exp(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     const ValueType& df_dx = exp_x;
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
@@ -242,7 +244,7 @@ template <class ValueType, int numVars, class ExpType>
 Evaluation<ValueType, numVars> pow(const Evaluation<ValueType, numVars>& base,
                                    const ExpType& exp)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef TranscendentalToolbox<ValueType> ValueTypeToolbox;
     Evaluation<ValueType, numVars> result;
 
     const ValueType& pow_x = ValueTypeToolbox::pow(base.value(), exp);
@@ -256,19 +258,57 @@ Evaluation<ValueType, numVars> pow(const Evaluation<ValueType, numVars>& base,
     else {
         // derivatives use the chain rule
         const ValueType& df_dx = pow_x/base.value()*exp;
-        for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-            result.setDerivative(curVarIdx, df_dx*base.derivative(curVarIdx));
+        result.setScaledDerivatives(df_dx, base);
     }
 
     return result;
 }
 
+// exponentiation of arbitrary base with a fixed integer exponent. the power is computed
+// by repeated squaring and the derivative reuses the intermediate power x^(n - 1)
+template <class ValueType, int numVars>
+Evaluation<ValueType, numVars> pow(const Evaluation<ValueType, numVars>& base,
+                                   int exp)
+{
+    Evaluation<ValueType, numVars> result;
+
+    if (exp == 0) {
+        // x^0 = 1 for all x, including 0 (as for std::pow())
+        result = 1.0;
+        return result;
+    }
+
+    // x^(n - 1) for n = |exp|
+    unsigned n = static_cast<unsigned>(exp < 0 ? -exp : exp);
+    ValueType powNm1 = 1.0;
+    ValueType x = base.value();
+    for (unsigned m = n - 1; m > 0; m >>= 1) {
+        if (m & 1)
+            powNm1 *= x;
+        x *= x;
+    }
+
+    ValueType pow_x = powNm1*base.value();
+    ValueType df_dx = static_cast<ValueType>(n)*powNm1;
+    if (exp < 0) {
+        // d/dx x^-n = -n x^(n - 1)/x^(2n)
+        pow_x = 1.0/pow_x;
+        df_dx = -df_dx*pow_x*pow_x;
+    }
+
+    // derivatives use the chain rule
+    result.setValue(pow_x);
+    result.setScaledDerivatives(df_dx, base);
+
+    return result;
+}
+
 // exponentiation of constant base with an arbitrary exponent
 template <class BaseType, class ValueType, int numVars>
 Evaluation<ValueType, numVars> pow(const BaseType& base,
                                    const Evaluation<ValueType, numVars>& exp)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef TranscendentalToolbox<ValueType> ValueTypeToolbox;
 
     Evaluation<ValueType, numVars> result;
 
@@ -283,8 +323,7 @@ Evaluation<ValueType, numVars> pow(const BaseType& base,
 
         // derivatives use the chain rule
         const ValueType& df_dx = lnBase*result.value();
-        for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-            result.setDerivative(curVarIdx, df_dx*exp.derivative(curVarIdx));
+        result.setScaledDerivatives(df_dx, exp);
     }
 
     return result;
@@ -296,7 +335,7 @@ template <class ValueType, int numVars>
 Evaluation<ValueType, numVars> pow(const Evaluation<ValueType, numVars>& base,
                                    const Evaluation<ValueType, numVars>& exp)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef TranscendentalToolbox<ValueType> ValueTypeToolbox;
 
     Evaluation<ValueType, numVars> result;
 
@@ -306,19 +345,22 @@ Evaluation<ValueType, numVars> pow(const Evaluation<ValueType, numVars>& base,
         result = 0.0;
     }
     else {
-        ValueType valuePow = ValueTypeToolbox::pow(base.value(), exp.value());
+        const ValueType& f = base.value();
+        const ValueType& g = exp.value();
+        const ValueType& valuePow = ValueTypeToolbox::pow(f, g);
         result.setValue(valuePow);
 
         // use the chain rule for the derivatives. since both, the base and the exponent can
-        // potentially depend on the variable set, calculating these is quite elaborate...
-        const ValueType& f = base.value();
-        const ValueType& g = exp.value();
-        const ValueType& logF = ValueTypeToolbox::log(f);
-        for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx) {
-            const ValueType& fPrime = base.derivative(curVarIdx);
-            const ValueType& gPrime = exp.derivative(curVarIdx);
-            result.setDerivative(curVarIdx, (g*fPrime/f + logF*gPrime) * valuePow);
-        }
+        // potentially depend on the variable set, i.e.,
+        //
+        //    (f^g)' = g*f^g/f*f' + ln(f)*f^g*g'
+        //
+        // the factors do not depend on the variable so they are only computed once
+        const ValueType& df = g*valuePow/f;
+        const ValueType& dg = ValueTypeToolbox::log(f)*valuePow;
+        result.setScaledDerivatives(df, base);
+        for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
+            result.setDerivative(curVarIdx, result.derivative(curVarIdx) + dg*exp.derivative(curVarIdx));
     }
 
     return result;
@@ -327,7 +369,7 @@ Evaluation<ValueType, numVars> pow(const Evaluation<ValueType, numVars>& base,
 template <class ValueType, int numVars>
 Evaluation<ValueType, numVars> log(const Evaluation<ValueType, numVars>& x)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef TranscendentalToolbox<ValueType> ValueTypeToolbox;
 
     Evaluation<ValueType, numVars> result;
 
@@ -335,20 +377,16 @@ Evaluation<ValueType, numVars> log(const Evaluation<ValueType, numVars>& x)
 
     // derivatives use the chain rule
     const ValueType& df_dx = 1/x.value();
-    for (int curVarIdx = 0; curVarIdx < result.size; ++curVarIdx)
-        result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
+    result.setScaledDerivatives(df_dx, x);
 
     return result;
 }
 
-} // namespace DenseAd
-
-// a kind of traits class for the automatic differentiation case. (The toolbox for the
-// scalar case is provided by the MathToolbox.hpp header file.)
+// the implementation of the math toolbox for evaluations. (this is a separate class so
+// that specializations of the toolbox for specific value types can reuse it.)
 template <class ValueT, int numVars>
-struct MathToolbox<Opm::DenseAd::Evaluation<ValueT, numVars> >
+struct EvaluationMathToolbox
 {
-private:
 public:
     typedef ValueT ValueType;
     typedef Opm::MathToolbox<ValueType> InnerToolbox;
@@ -379,11 +417,13 @@ public:
     decay(const Evaluation&& eval)
     { return eval; }
 
+    // for nested evaluations, the value is decayed recursively. this also allows to
+    // decay a second-order evaluation to a first-order one.
     template <class LhsEval>
-    static typename std::enable_if<std::is_floating_point<LhsEval>::value,
+    static typename std::enable_if<!std::is_same<Evaluation, LhsEval>::value,
                                    LhsEval>::type
     decay(const Evaluation& eval)
-    { return eval.value(); }
+    { return InnerToolbox::template decay<LhsEval>(eval.value()); }
 
     // comparison
     static bool isSame(const Evaluation& a, const Evaluation& b, Scalar tolerance)
@@ -480,6 +520,15 @@ public:
     }
 };
 
+} // namespace DenseAd
+
+// a kind of traits class for the automatic differentiation case. (The toolbox for the
+// scalar case is provided by the MathToolbox.hpp header file.)
+template <class ValueT, int numVars>
+struct MathToolbox<Opm::DenseAd::Evaluation<ValueT, numVars> >
+    : public Opm::DenseAd::EvaluationMathToolbox<ValueT, numVars>
+{};
+
 }
 
 #endif
@@ -0,0 +1,106 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Conversion of scalars and dense-AD evaluations to a different floating point
+ *        precision.
+ *
+ * This is used to evaluate a function in single precision while the caller keeps
+ * working in double precision, e.g.
+ *
+ * \code
+ * typedef Opm::DenseAd::Evaluation<double, 3> Evaluation;
+ * typedef Opm::ChangeScalarType<Evaluation, float>::type FloatEvaluation;
+ *
+ * Evaluation x = ...;
+ * FloatEvaluation y = f(Opm::precisionCast<FloatEvaluation>(x));
+ * Evaluation z = Opm::precisionCast<Evaluation>(y);
+ * \endcode
+ *
+ * The value and all derivatives are converted, i.e., the derivatives computed in the
+ * lower precision are retained.
+ */
+#ifndef OPM_DENSEAD_PRECISION_CAST_HPP
+#define OPM_DENSEAD_PRECISION_CAST_HPP
+
+#include "Evaluation.hpp"
+
+#include <type_traits>
+
+namespace Opm {
+
+/*!
+ * \brief The type of a scalar or an evaluation if its floating point values are
+ *        represented by a different type.
+ */
+template <class Evaluation, class TargetScalar>
+struct ChangeScalarType
+{
+    static_assert(std::is_floating_point<Evaluation>::value,
+                  "Only floating point scalars and dense-AD evaluations are supported");
+
+    typedef TargetScalar type;
+};
+
+template <class ValueT, int numVars, class TargetScalar>
+struct ChangeScalarType<DenseAd::Evaluation<ValueT, numVars>, TargetScalar>
+{
+    typedef DenseAd::Evaluation<typename ChangeScalarType<ValueT, TargetScalar>::type, numVars> type;
+};
+
+/*!
+ * \brief Convert a scalar to a different floating point type.
+ */
+template <class TargetEvaluation, class Scalar>
+typename std::enable_if<std::is_floating_point<Scalar>::value, TargetEvaluation>::type
+precisionCast(const Scalar& value)
+{
+    static_assert(std::is_floating_point<TargetEvaluation>::value,
+                  "A scalar can only be converted to a scalar");
+    return static_cast<TargetEvaluation>(value);
+}
+
+/*!
+ * \brief Convert the value and the derivatives of an evaluation to a different
+ *        floating point type.
+ *
+ * The target must be an evaluation with the same number of derivatives.
+ */
+template <class TargetEvaluation, class ValueT, int numVars>
+TargetEvaluation precisionCast(const DenseAd::Evaluation<ValueT, numVars>& eval)
+{
+    static_assert(TargetEvaluation::size == numVars,
+                  "Evaluations can only be converted if their number of derivatives is the same");
+    typedef typename TargetEvaluation::ValueType TargetValueType;
+
+    TargetEvaluation result;
+    result.setValue(precisionCast<TargetValueType>(eval.value()));
+    for (int varIdx = 0; varIdx < numVars; ++varIdx)
+        result.setDerivative(varIdx, precisionCast<TargetValueType>(eval.derivative(varIdx)));
+    return result;
+}
+
+} // namespace Opm
+
+#endif
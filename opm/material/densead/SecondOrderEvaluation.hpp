@@ -0,0 +1,176 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Second-order derivatives using nested dense-AD evaluations.
+ *
+ * A second-order evaluation is an evaluation whose value and derivatives are
+ * first-order evaluations with regard to the same variables, i.e.,
+ * Evaluation<Evaluation<Scalar, n>, n>. Passing such objects through the templated
+ * constitutive relations yields the gradient and the Hessian matrix of the result in
+ * a single pass, e.g.
+ *
+ * \code
+ * typedef Opm::DenseAd::SecondOrderEvaluation<double, 2> Evaluation;
+ *
+ * Evaluation Sw = Opm::DenseAd::createSecondOrderVariable<double, 2>(0.3, 0);
+ * Evaluation p = Opm::DenseAd::createSecondOrderVariable<double, 2>(1e5, 1);
+ * Evaluation f = g(Sw, p);
+ *
+ * Opm::DenseAd::SymmetricHessian<double, 2> H(f);
+ * double d2f_dSw_dp = H(0, 1);
+ * \endcode
+ */
+#ifndef OPM_DENSEAD_SECOND_ORDER_EVALUATION_HPP
+#define OPM_DENSEAD_SECOND_ORDER_EVALUATION_HPP
+
+#include "Evaluation.hpp"
+#include "Math.hpp"
+
+#include <array>
+#include <cassert>
+
+namespace Opm {
+namespace DenseAd {
+
+/*!
+ * \brief An evaluation which represents the first and second derivatives with regard
+ *        to 'numVars' variables.
+ */
+template <class Scalar, int numVars>
+using SecondOrderEvaluation = Evaluation<Evaluation<Scalar, numVars>, numVars>;
+
+/*!
+ * \brief Create a second-order evaluation which represents the variable with a given
+ *        index.
+ *
+ * Both, the value and the first derivative with regard to the variable are seeded.
+ */
+template <class Scalar, int numVars>
+SecondOrderEvaluation<Scalar, numVars> createSecondOrderVariable(const Scalar& value, int varIdx)
+{
+    typedef Evaluation<Scalar, numVars> FirstOrder;
+
+    SecondOrderEvaluation<Scalar, numVars> result =
+        SecondOrderEvaluation<Scalar, numVars>::createConstant(FirstOrder::createVariable(value, varIdx));
+    result.setDerivative(varIdx, FirstOrder::createConstant(1.0));
+    return result;
+}
+
+/*!
+ * \brief Create a second-order evaluation which does not depend on any variable.
+ */
+template <class Scalar, int numVars>
+SecondOrderEvaluation<Scalar, numVars> createSecondOrderConstant(const Scalar& value)
+{
+    typedef Evaluation<Scalar, numVars> FirstOrder;
+
+    return SecondOrderEvaluation<Scalar, numVars>::createConstant(FirstOrder::createConstant(value));
+}
+
+/*!
+ * \brief The Hessian matrix of a function stored as a packed lower triangle.
+ *
+ * The nested evaluation stores all numVars^2 second derivatives, but the inner
+ * derivative of the outer derivative with regard to i and j is mathematically the same
+ * for (i, j) and (j, i). This class only keeps numVars*(numVars + 1)/2 entries and the
+ * gradient, which is what e.g. optimization tools need to store per function.
+ */
+template <class Scalar, int numVars>
+class SymmetricHessian
+{
+public:
+    static const int size = numVars;
+    static const int numEntries = numVars*(numVars + 1)/2;
+
+    SymmetricHessian()
+    {
+        value_ = 0.0;
+        gradient_.fill(0.0);
+        entries_.fill(0.0);
+    }
+
+    /*!
+     * \brief Extract the value, the gradient and the Hessian of a second-order
+     *        evaluation.
+     */
+    explicit SymmetricHessian(const SecondOrderEvaluation<Scalar, numVars>& eval)
+    { assign(eval); }
+
+    /*!
+     * \brief Extract the value, the gradient and the Hessian of a second-order
+     *        evaluation.
+     *
+     * Only the lower triangle of the second derivatives is considered. Up to rounding,
+     * the upper one is identical.
+     */
+    void assign(const SecondOrderEvaluation<Scalar, numVars>& eval)
+    {
+        value_ = eval.value().value();
+        for (int i = 0; i < numVars; ++i) {
+            gradient_[i] = eval.value().derivative(i);
+
+            const auto& dEval_di = eval.derivative(i);
+            for (int j = 0; j <= i; ++j)
+                entries_[index_(i, j)] = dEval_di.derivative(j);
+        }
+    }
+
+    /*!
+     * \brief The value of the function.
+     */
+    const Scalar& value() const
+    { return value_; }
+
+    /*!
+     * \brief The first derivative of the function with regard to a variable.
+     */
+    const Scalar& gradient(int varIdx) const
+    { return gradient_[varIdx]; }
+
+    /*!
+     * \brief The second derivative of the function with regard to two variables.
+     */
+    const Scalar& operator()(int i, int j) const
+    { return (i >= j)?entries_[index_(i, j)]:entries_[index_(j, i)]; }
+
+    Scalar& operator()(int i, int j)
+    { return (i >= j)?entries_[index_(i, j)]:entries_[index_(j, i)]; }
+
+private:
+    static int index_(int i, int j)
+    {
+        assert(0 <= j && j <= i && i < numVars);
+        return i*(i + 1)/2 + j;
+    }
+
+    Scalar value_;
+    std::array<Scalar, numVars> gradient_;
+    std::array<Scalar, numEntries> entries_;
+};
+
+} // namespace DenseAd
+} // namespace Opm
+
+#endif
@@ -0,0 +1,250 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Support for dense-AD evaluations which represent several cells at once.
+ *
+ * If Opm::SimdValue is used as the value type of Opm::DenseAd::Evaluation, the value and
+ * each derivative of an evaluation hold the respective quantity for a fixed number of
+ * cells. This file provides the variants of the algebraic functions of densead/Math.hpp
+ * which need to branch on values, the corresponding math toolbox, lane-wise selection of
+ * evaluations and the means to convert between these evaluations and the ones for
+ * individual cells.
+ */
+#ifndef OPM_DENSEAD_SIMD_EVALUATION_HPP
+#define OPM_DENSEAD_SIMD_EVALUATION_HPP
+
+#include "Evaluation.hpp"
+#include "Math.hpp"
+
+#include <opm/material/common/SimdValue.hpp>
+
+namespace Opm {
+//! returns the lanes of a for which the condition is true and the ones of b otherwise
+template <class Scalar, int width, int numVars>
+DenseAd::Evaluation<SimdValue<Scalar, width>, numVars>
+select(const SimdMask<width>& cond,
+       const DenseAd::Evaluation<SimdValue<Scalar, width>, numVars>& a,
+       const DenseAd::Evaluation<SimdValue<Scalar, width>, numVars>& b)
+{
+    DenseAd::Evaluation<SimdValue<Scalar, width>, numVars> result;
+
+    result.setValue(select(cond, a.value(), b.value()));
+    for (int varIdx = 0; varIdx < numVars; ++varIdx)
+        result.setDerivative(varIdx, select(cond, a.derivative(varIdx), b.derivative(varIdx)));
+
+    return result;
+}
+
+//! extract the evaluation of a single cell
+template <class Scalar, int width, int numVars>
+DenseAd::Evaluation<Scalar, numVars>
+getLane(const DenseAd::Evaluation<SimdValue<Scalar, width>, numVars>& eval, int laneIdx)
+{
+    DenseAd::Evaluation<Scalar, numVars> result;
+
+    result.setValue(eval.value()[laneIdx]);
+    for (int varIdx = 0; varIdx < numVars; ++varIdx)
+        result.setDerivative(varIdx, eval.derivative(varIdx)[laneIdx]);
+
+    return result;
+}
+
+//! set the evaluation of a single cell
+template <class Scalar, int width, int numVars>
+void setLane(DenseAd::Evaluation<SimdValue<Scalar, width>, numVars>& eval,
+             int laneIdx,
+             const DenseAd::Evaluation<Scalar, numVars>& laneEval)
+{
+    SimdValue<Scalar, width> tmp = eval.value();
+    tmp[laneIdx] = laneEval.value();
+    eval.setValue(tmp);
+
+    for (int varIdx = 0; varIdx < numVars; ++varIdx) {
+        tmp = eval.derivative(varIdx);
+        tmp[laneIdx] = laneEval.derivative(varIdx);
+        eval.setDerivative(varIdx, tmp);
+    }
+}
+
+namespace DenseAd {
+// the functions below replace the ones of densead/Math.hpp which branch on the value of
+// their arguments. the number of derivatives is the first template parameter so that
+// explicitly specified template arguments like 'Opm::DenseAd::abs<double, 3>' still
+// unambiguously refer to the generic variants.
+template <int numVars, class Scalar, int width>
+Evaluation<SimdValue<Scalar, width>, numVars>
+abs(const Evaluation<SimdValue<Scalar, width>, numVars>& x)
+{ return Opm::select(x.value() > 0.0, x, -x); }
+
+template <int numVars, class Scalar, int width>
+Evaluation<SimdValue<Scalar, width>, numVars>
+min(const Evaluation<SimdValue<Scalar, width>, numVars>& x1,
+    const Evaluation<SimdValue<Scalar, width>, numVars>& x2)
+{ return Opm::select(x1.value() < x2.value(), x1, x2); }
+
+template <int numVars, class Arg1ValueType, class Scalar, int width>
+Evaluation<SimdValue<Scalar, width>, numVars>
+min(const Arg1ValueType& x1,
+    const Evaluation<SimdValue<Scalar, width>, numVars>& x2)
+{
+    const Evaluation<SimdValue<Scalar, width>, numVars> tmp(x1);
+    return Opm::select(tmp.value() < x2.value(), tmp, x2);
+}
+
+template <int numVars, class Scalar, int width, class Arg2ValueType>
+Evaluation<SimdValue<Scalar, width>, numVars>
+min(const Evaluation<SimdValue<Scalar, width>, numVars>& x1,
+    const Arg2ValueType& x2)
+{ return min(x2, x1); }
+
+template <int numVars, class Scalar, int width>
+Evaluation<SimdValue<Scalar, width>, numVars>
+max(const Evaluation<SimdValue<Scalar, width>, numVars>& x1,
+    const Evaluation<SimdValue<Scalar, width>, numVars>& x2)
+{ return Opm::select(x1.value() > x2.value(), x1, x2); }
+
+template <int numVars, class Arg1ValueType, class Scalar, int width>
+Evaluation<SimdValue<Scalar, width>, numVars>
+max(const Arg1ValueType& x1,
+    const Evaluation<SimdValue<Scalar, width>, numVars>& x2)
+{
+    const Evaluation<SimdValue<Scalar, width>, numVars> tmp(x1);
+    return Opm::select(tmp.value() > x2.value(), tmp, x2);
+}
+
+template <int numVars, class Scalar, int width, class Arg2ValueType>
+Evaluation<SimdValue<Scalar, width>, numVars>
+max(const Evaluation<SimdValue<Scalar, width>, numVars>& x1,
+    const Arg2ValueType& x2)
+{ return max(x2, x1); }
+
+// exponentiation of arbitrary base with a fixed constant
+template <int numVars, class Scalar, int width, class ExpType>
+Evaluation<SimdValue<Scalar, width>, numVars>
+pow(const Evaluation<SimdValue<Scalar, width>, numVars>& base,
+    const ExpType& exp)
+{
+    typedef SimdValue<Scalar, width> ValueType;
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    Evaluation<ValueType, numVars> result;
+
+    const ValueType& pow_x = ValueTypeToolbox::pow(base.value(), exp);
+    result.setValue(pow_x);
+
+    // derivatives use the chain rule
+    const ValueType& df_dx = pow_x/base.value()*exp;
+    result.setScaledDerivatives(df_dx, base);
+
+    // we special case the base 0 case because 0.0 is in the valid range of the base
+    // but the generic code leads to NaNs.
+    return Opm::select(base.value() == 0.0, Evaluation<ValueType, numVars>(0.0), result);
+}
+
+// exponentiation of constant base with an arbitrary exponent
+template <int numVars, class BaseType, class Scalar, int width>
+Evaluation<SimdValue<Scalar, width>, numVars>
+pow(const BaseType& base,
+    const Evaluation<SimdValue<Scalar, width>, numVars>& exp)
+{
+    typedef SimdValue<Scalar, width> ValueType;
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    Evaluation<ValueType, numVars> result;
+
+    const ValueType& lnBase = ValueTypeToolbox::log(base);
+    result.setValue(ValueTypeToolbox::exp(lnBase*exp.value()));
+
+    // derivatives use the chain rule
+    const ValueType& df_dx = lnBase*result.value();
+    result.setScaledDerivatives(df_dx, exp);
+
+    // we special case the base 0 case because 0.0 is in the valid range of the base
+    // but the generic code leads to NaNs.
+    return Opm::select(ValueType(base) == 0.0, Evaluation<ValueType, numVars>(0.0), result);
+}
+
+template <int numVars, class Scalar, int width>
+Evaluation<SimdValue<Scalar, width>, numVars>
+pow(const Evaluation<SimdValue<Scalar, width>, numVars>& base,
+    const Evaluation<SimdValue<Scalar, width>, numVars>& exp)
+{
+    typedef SimdValue<Scalar, width> ValueType;
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    Evaluation<ValueType, numVars> result;
+
+    ValueType valuePow = ValueTypeToolbox::pow(base.value(), exp.value());
+    result.setValue(valuePow);
+
+    // use the chain rule for the derivatives. since both, the base and the exponent can
+    // potentially depend on the variable set, calculating these is quite elaborate...
+    const ValueType& f = base.value();
+    const ValueType& g = exp.value();
+    const ValueType& logF = ValueTypeToolbox::log(f);
+    for (int curVarIdx = 0; curVarIdx < numVars; ++curVarIdx) {
+        const ValueType& fPrime = base.derivative(curVarIdx);
+        const ValueType& gPrime = exp.derivative(curVarIdx);
+        result.setDerivative(curVarIdx, (g*fPrime/f + logF*gPrime) * valuePow);
+    }
+
+    // we special case the base 0 case because 0.0 is in the valid range of the base
+    // but the generic code leads to NaNs.
+    return Opm::select(base.value() == 0.0, Evaluation<ValueType, numVars>(0.0), result);
+}
+
+} // namespace DenseAd
+
+// the math toolbox for evaluations of several cells. the functions which need to
+// branch on values use the lane-wise variants from above.
+template <class ScalarT, int width, int numVars>
+struct MathToolbox<Opm::DenseAd::Evaluation<Opm::SimdValue<ScalarT, width>, numVars> >
+    : public Opm::DenseAd::EvaluationMathToolbox<Opm::SimdValue<ScalarT, width>, numVars>
+{
+    typedef Opm::DenseAd::Evaluation<Opm::SimdValue<ScalarT, width>, numVars> Evaluation;
+
+    template <class Arg1Eval, class Arg2Eval>
+    static Evaluation max(const Arg1Eval& arg1, const Arg2Eval& arg2)
+    { return Opm::DenseAd::max(arg1, arg2); }
+
+    template <class Arg1Eval, class Arg2Eval>
+    static Evaluation min(const Arg1Eval& arg1, const Arg2Eval& arg2)
+    { return Opm::DenseAd::min(arg1, arg2); }
+
+    static Evaluation abs(const Evaluation& arg)
+    { return Opm::DenseAd::abs(arg); }
+
+    template <class RhsValueType>
+    static Evaluation pow(const Evaluation& arg1, const RhsValueType& arg2)
+    { return Opm::DenseAd::pow(arg1, arg2); }
+
+    template <class RhsValueType>
+    static Evaluation pow(const RhsValueType& arg1, const Evaluation& arg2)
+    { return Opm::DenseAd::pow(arg1, arg2); }
+
+    static Evaluation pow(const Evaluation& arg1, const Evaluation& arg2)
+    { return Opm::DenseAd::pow(arg1, arg2); }
+};
+
+} // namespace Opm
+
+#endif
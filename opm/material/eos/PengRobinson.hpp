@@ -36,6 +36,9 @@
 #include <opm/material/common/PolynomialUtils.hpp>
 
 #include <csignal>
+#include <fstream>
+#include <limits>
+#include <string>
 
 namespace Opm {
 
@@ -62,32 +65,76 @@ class PengRobinson
     { }
 
 public:
-    static void  init(Scalar /*aMin*/, Scalar /*aMax*/, unsigned /*na*/,
-                      Scalar /*bMin*/, Scalar /*bMax*/, unsigned /*nb*/)
+    /*!
+     * \brief Initialize the equation of state for a range of the attractive and
+     *        repulsive parameters.
+     *
+     * If 'tabulateCriticalPoints' is true, the critical points of the fluids are
+     * tabulated on a uniform na x nb grid. Super-critical fluids then only require a
+     * table lookup instead of a nested Newton method. Computing the tabulation is
+     * expensive: if OpenMP is enabled, the table is filled in parallel. If
+     * 'cacheFileName' is not empty, the table is read from this file if it exists
+     * and was created for the same grid; otherwise it is computed and written to the
+     * file.
+     */
+    static void init(Scalar aMin, Scalar aMax, unsigned na,
+                     Scalar bMin, Scalar bMax, unsigned nb,
+                     bool tabulateCriticalPoints = false,
+                     const std::string& cacheFileName = "")
     {
-/*
+        criticalPointsTabulated_ = false;
+        if (!tabulateCriticalPoints)
+            return;
+
         // resize the tabulation for the critical points
         criticalTemperature_.resize(aMin, aMax, na, bMin, bMax, nb);
         criticalPressure_.resize(aMin, aMax, na, bMin, bMax, nb);
         criticalMolarVolume_.resize(aMin, aMax, na, bMin, bMax, nb);
 
-        Scalar VmCrit, pCrit, TCrit;
-        for (unsigned i = 0; i < na; ++i) {
-            Scalar a = criticalTemperature_.iToX(i);
-            assert(std::abs(criticalTemperature_.xToI(criticalTemperature_.iToX(i)) - i) < 1e-10);
+        if (cacheFileName.empty() || !readCriticalPointCache_(cacheFileName)) {
+            fillCriticalPointTables_();
+            if (!cacheFileName.empty())
+                writeCriticalPointCache_(cacheFileName);
+        }
 
-            for (unsigned j = 0; j < nb; ++j) {
-                Scalar b = criticalTemperature_.jToY(j);
-                assert(std::abs(criticalTemperature_.yToJ(criticalTemperature_.jToY(j)) - j) < 1e-10);
+        // the three tables are looked up for every super-critical fluid, so keep
+        // the corners of each cell in the same cache line
+        criticalTemperature_.enableCellWiseLayout();
+        criticalPressure_.enableCellWiseLayout();
+        criticalMolarVolume_.enableCellWiseLayout();
 
-                findCriticalPoint_(TCrit, pCrit, VmCrit,  a, b);
+        criticalPointsTabulated_ = true;
+    }
 
-                criticalTemperature_.setSamplePoint(i, j, TCrit);
-                criticalPressure_.setSamplePoint(i, j, pCrit);
-                criticalMolarVolume_.setSamplePoint(i, j, VmCrit);
-            }
+    /*!
+     * \brief Computes the critical point of a fluid given its attractive and
+     *        repulsive parameters.
+     *
+     * If the critical points were tabulated by init() and the parameters are within
+     * the range of the tabulation, the result is interpolated. Otherwise it is
+     * determined using Newton's method.
+     */
+    template <class Evaluation>
+    static void computeCriticalPoint(Evaluation& Tcrit,
+                                     Evaluation& pcrit,
+                                     Evaluation& Vcrit,
+                                     const Evaluation& a,
+                                     const Evaluation& b)
+    {
+        if (criticalPointsTabulated_ && criticalTemperature_.applies(a, b)) {
+            Tcrit = criticalTemperature_.eval(a, b);
+            pcrit = criticalPressure_.eval(a, b);
+            Vcrit = criticalMolarVolume_.eval(a, b);
+
+            // sample points for which the critical point could not be determined
+            // are NaN
+            if (std::isfinite(Opm::scalarValue(Tcrit))
+                && std::isfinite(Opm::scalarValue(pcrit))
+                && std::isfinite(Opm::scalarValue(Vcrit)))
+                return;
         }
-        */
+
+        findCriticalPoint_(Tcrit, pcrit, Vcrit, a, b);
     }
 
     /*!
@@ -105,35 +152,119 @@ public:
         if (T >= Component::criticalTemperature())
             return Component::criticalPressure();
 
-        // initial guess of the vapor pressure
-        Evaluation Vm[3];
-        const Scalar eps = Component::criticalPressure()*1e-10;
-
         // use the Ambrose-Walton method to get an initial guess of
         // the vapor pressure
-        Evaluation pVap = ambroseWalton_(params, T);
+        const Evaluation& pInit = ambroseWalton_(params, T);
 
-        // Newton-Raphson method
-        for (unsigned i = 0; i < 5; ++i) {
-            // calculate the molar densities
-            int numSol OPM_OPTIM_UNUSED = molarVolumes(Vm, params, T, pVap);
-            assert(numSol == 3);
+        return computeVaporPressure(T, Evaluation(params.a()), Evaluation(params.b()), pInit);
+    }
 
-            const Evaluation& f = fugacityDifference_(params, T, pVap, Vm[0], Vm[2]);
-            Evaluation df_dp =
-                fugacityDifference_(params, T, pVap  + eps, Vm[0], Vm[2])
-                -
-                fugacityDifference_(params, T, pVap - eps, Vm[0], Vm[2]);
-            df_dp /= 2*eps;
+    /*!
+     * \brief Computes the vapor pressure of a pure fluid given its attractive and
+     *        repulsive parameters at a temperature below its critical point.
+     *
+     * Newton's method is used to make the fugacities of the liquid and the gas phase
+     * equal, starting at the pressure 'pInit'. The iterations are confined to the
+     * pressure range in which the isotherm exhibits a liquid and a gas branch. Since
+     * the derivative of the logarithm of the fugacity coefficient of a pure fluid
+     * with regard to ln(p) is Z - 1, no further evaluations of the equation of state
+     * are required for the derivative.
+     */
+    template <class Evaluation>
+    static Evaluation computeVaporPressure(const Evaluation& T,
+                                           const Evaluation& a,
+                                           const Evaluation& b,
+                                           const Evaluation& pInit)
+    {
+        // the pressures at the minimum and the maximum of the isotherm bound the
+        // vapor pressure
+        Evaluation Vmin, Vmax, pMin, pMax;
+        if (!findExtrema_(Vmin, Vmax, pMin, pMax, a, b, T))
+            OPM_THROW(NumericalProblem,
+                      "The Peng-Robinson fluid with a=" << a << ", b=" << b
+                      << " does not exhibit a vapor pressure at T=" << T);
+        Scalar pLow = std::max<Scalar>(0.0, Opm::scalarValue(eosPressure_(a, b, T, Vmin)));
+        Scalar pHigh = Opm::scalarValue(eosPressure_(a, b, T, Vmax));
+
+        const Scalar sqrt2 = std::sqrt(2.0);
+        const Evaluation& RT = R*T;
+        const Evaluation& C = a/(2*sqrt2*b*RT);
+
+        Evaluation pVap = pInit;
+        Evaluation VmLiquid = (Vmin + b)/2;
+        for (unsigned i = 0; i < 100; ++i) {
+            if (!(pLow < Opm::scalarValue(pVap) && Opm::scalarValue(pVap) < pHigh))
+                // bisect the bracket if Newton's method left it. the vapor pressure
+                // may be many orders of magnitude below the upper bound, so the
+                // bracket is bisected geometrically if possible
+                pVap = (pLow > 0) ? std::sqrt(pLow*pHigh) : pHigh/2;
+
+            // at low reduced temperatures, the compressibility factor of the liquid
+            // is close to B^*, so the liquid root of the cubic equation is not
+            // precise enough. instead, the molar volumes are determined on the
+            // branches of the isotherm, which are monotonically decreasing
+            VmLiquid = isothermBranchVolume_(a, b, T, pVap,
+                                             Opm::scalarValue(b),
+                                             Opm::scalarValue(Vmin),
+                                             VmLiquid);
+            const Evaluation& VmGas =
+                isothermBranchVolume_(a, b, T, pVap,
+                                      Opm::scalarValue(Vmax),
+                                      Opm::scalarValue(RT/pVap + b),
+                                      Evaluation(RT/pVap + b));
+
+            const Evaluation& lnPhiLiquid =
+                pVap*VmLiquid/RT - 1 - Opm::log(pVap*(VmLiquid - b)/RT)
+                - C*Opm::log((VmLiquid + (1 + sqrt2)*b)/(VmLiquid + (1 - sqrt2)*b));
+            const Evaluation& lnPhiGas =
+                pVap*VmGas/RT - 1 - Opm::log(pVap*(VmGas - b)/RT)
+                - C*Opm::log((VmGas + (1 + sqrt2)*b)/(VmGas + (1 - sqrt2)*b));
+
+            // the liquid is less stable than the gas below the vapor pressure
+            const Evaluation& f = lnPhiLiquid - lnPhiGas;
+            if (f > 0.0)
+                pLow = Opm::scalarValue(pVap);
+            else
+                pHigh = Opm::scalarValue(pVap);
 
-            const Evaluation& delta = f/df_dp;
-            pVap = pVap - delta;
+            // use Newton's method for the logarithm of the pressure, which is
+            // almost linear in the fugacity difference
+            const Evaluation& deltaLnP = f*RT/(pVap*(VmLiquid - VmGas));
+            pVap *= Opm::exp(-deltaLnP);
 
-            if (std::abs(Opm::scalarValue(delta/pVap)) < 1e-10)
-                break;
+            if (std::abs(Opm::scalarValue(deltaLnP)) < 1e-10)
+                return pVap;
         }
 
-        return pVap;
+        OPM_THROW(NumericalProblem,
+                  "Newton's method did not converge for the vapor pressure of the "
+                  "Peng-Robinson fluid with a=" << a << ", b=" << b << " at T=" << T);
+    }
+
+    /*!
+     * \brief The Ambrose-Walton method to estimate the vapor pressure of a
+     *        component given its critical point and its acentric factor.
+     *
+     * See:
+     *
+     * D. Ambrose, J. Walton: "Vapor Pressures up to Their Critical
+     * Temperatures of Normal Alkanes and 1-Alkanols", Pure
+     * Appl. Chem., 61, 1395-1403, 1989
+     */
+    template <class Evaluation>
+    static Evaluation ambroseWaltonVaporPressure(const Evaluation& T,
+                                                 Scalar Tcrit,
+                                                 Scalar pcrit,
+                                                 Scalar omega)
+    {
+        const Evaluation& Tr = T / Tcrit;
+        const Evaluation& tau = 1 - Tr;
+
+        const Evaluation& f0 = (tau*(-5.97616 + Opm::sqrt(tau)*(1.29874 - tau*0.60394)) - 1.06841*Opm::pow(tau, 5))/Tr;
+        const Evaluation& f1 = (tau*(-5.03365 + Opm::sqrt(tau)*(1.11505 - tau*5.41217)) - 7.46628*Opm::pow(tau, 5))/Tr;
+        const Evaluation& f2 = (tau*(-0.64771 + Opm::sqrt(tau)*(2.41539 - tau*4.26979)) + 3.25259*Opm::pow(tau, 5))/Tr;
+
+        return pcrit*Opm::exp(f0 + omega * (f1 + omega*f2));
     }
 
     /*!
@@ -287,14 +418,11 @@ protected:
                                      bool isGasPhase)
     {
         Evaluation Tcrit, pcrit, Vcrit;
-        findCriticalPoint_(Tcrit,
-                           pcrit,
-                           Vcrit,
-                           params.a(phaseIdx),
-                           params.b(phaseIdx));
-
-
-        //Evaluation Vcrit = criticalMolarVolume_.eval(params.a(phaseIdx), params.b(phaseIdx));
+        computeCriticalPoint(Tcrit,
+                             pcrit,
+                             Vcrit,
+                             Evaluation(params.a(phaseIdx)),
+                             Evaluation(params.b(phaseIdx)));
 
         if (isGasPhase)
             Vm = Opm::max(Vm, Vcrit);
@@ -337,8 +465,8 @@ protected:
             // check if we're converged
             if (f < 1e-10 || (i == iMax - 1 && f < 1e-8)) {
                 Tcrit = T;
-                pcrit = (minP + maxP)/2;
                 Vcrit = (maxVm + minVm)/2;
+                pcrit = eosPressure_(a, b, Tcrit, Vcrit);
                 return;
             }
 
@@ -358,8 +486,8 @@ protected:
             Evaluation fPrime = (fStar - f)/eps;
             if (std::abs(Opm::scalarValue(fPrime)) < 1e-40) {
                 Tcrit = T;
-                pcrit = (minP + maxP)/2;
                 Vcrit = (maxVm + minVm)/2;
+                pcrit = eosPressure_(a, b, Tcrit, Vcrit);
                 return;
             }
 
@@ -375,8 +503,8 @@ protected:
                 if (j >= 20) {
                     if (f < 1e-8) {
                         Tcrit = T;
-                        pcrit = (minP + maxP)/2;
                         Vcrit = (maxVm + minVm)/2;
+                        pcrit = eosPressure_(a, b, Tcrit, Vcrit);
                         return;
                     }
                     OPM_THROW(NumericalProblem,
@@ -397,6 +525,49 @@ protected:
         assert(false);
     }
 
+    // the molar volume on a monotonically decreasing branch (Vlow, Vhigh) of an
+    // isotherm for which the EOS yields a given pressure
+    template <class Evaluation>
+    static Evaluation isothermBranchVolume_(const Evaluation& a,
+                                            const Evaluation& b,
+                                            const Evaluation& T,
+                                            const Evaluation& p,
+                                            Scalar Vlow,
+                                            Scalar Vhigh,
+                                            Evaluation Vm)
+    {
+        for (unsigned i = 0; i < 100; ++i) {
+            if (!(Vlow < Opm::scalarValue(Vm) && Opm::scalarValue(Vm) < Vhigh))
+                Vm = (Vlow + Vhigh)/2;
+
+            const Evaluation& g = eosPressure_(a, b, T, Vm) - p;
+            if (g > 0.0)
+                Vlow = Opm::scalarValue(Vm);
+            else
+                Vhigh = Opm::scalarValue(Vm);
+
+            const Evaluation& denom = Vm*(Vm + 2*b) - b*b;
+            const Evaluation& dg_dV =
+                - R*T/((Vm - b)*(Vm - b)) + 2*a*(Vm + b)/(denom*denom);
+            const Evaluation& delta = g/dg_dV;
+            Vm -= delta;
+
+            if (std::abs(Opm::scalarValue(delta)) < 1e-13*Opm::scalarValue(Vm)
+                || Vhigh - Vlow < 1e-13*Vhigh)
+                break;
+        }
+
+        return Vm;
+    }
+
+    // the pressure given by the EOS for a temperature and molar volume
+    template <class Evaluation>
+    static Evaluation eosPressure_(const Evaluation& a,
+                                   const Evaluation& b,
+                                   const Evaluation& T,
+                                   const Evaluation& Vm)
+    { return R*T/(Vm - b) - a/(Vm*(Vm + 2*b) - b*b); }
+
     // find the two molar volumes where the EOS exhibits extrema and
     // which are larger than the covolume of the phase
     template <class Evaluation>
@@ -485,60 +656,141 @@ protected:
     /*!
      * \brief The Ambrose-Walton method to estimate the vapor
      *        pressure.
-     *
-     * \return Vapor pressure estimate in bar
-     *
-     * See:
-     *
-     * D. Ambrose, J. Walton: "Vapor Pressures up to Their Critical
-     * Temperatures of Normal Alkanes and 1-Alkanols", Pure
-     * Appl. Chem., 61, 1395-1403, 1989
      */
     template <class Evaluation, class Params>
     static Evaluation ambroseWalton_(const Params& /*params*/, const Evaluation& T)
     {
         typedef typename Params::Component Component;
 
-        const Evaluation& Tr = T / Component::criticalTemperature();
-        const Evaluation& tau = 1 - Tr;
-        const Evaluation& omega = Component::acentricFactor();
+        return ambroseWaltonVaporPressure(T,
+                                          Component::criticalTemperature(),
+                                          Component::criticalPressure(),
+                                          Component::acentricFactor());
+    }
 
-        const Evaluation& f0 = (tau*(-5.97616 + Opm::sqrt(tau)*(1.29874 - tau*0.60394)) - 1.06841*Opm::pow(tau, 5))/Tr;
-        const Evaluation& f1 = (tau*(-5.03365 + Opm::sqrt(tau)*(1.11505 - tau*5.41217)) - 7.46628*Opm::pow(tau, 5))/Tr;
-        const Evaluation& f2 = (tau*(-0.64771 + Opm::sqrt(tau)*(2.41539 - tau*4.26979)) + 3.25259*Opm::pow(tau, 5))/Tr;
+    static void fillCriticalPointTables_()
+    {
+        const int na = static_cast<int>(criticalTemperature_.numX());
+        const int nb = static_cast<int>(criticalTemperature_.numY());
+
+        // the sample points are independent of each other
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < na; ++i) {
+            Scalar a = criticalTemperature_.iToX(static_cast<unsigned>(i));
+            assert(std::abs(criticalTemperature_.xToI(criticalTemperature_.iToX(i)) - i) < 1e-10);
+
+            for (int j = 0; j < nb; ++j) {
+                Scalar b = criticalTemperature_.jToY(static_cast<unsigned>(j));
+                assert(std::abs(criticalTemperature_.yToJ(criticalTemperature_.jToY(j)) - j) < 1e-10);
+
+                Scalar VmCrit, pCrit, TCrit;
+                try {
+                    findCriticalPoint_(TCrit, pCrit, VmCrit, a, b);
+                }
+                catch (const NumericalProblem&) {
+                    // computeCriticalPoint() falls back to Newton's method if it
+                    // encounters such a sample point
+                    TCrit = pCrit = VmCrit = std::numeric_limits<Scalar>::quiet_NaN();
+                }
+
+                criticalTemperature_.setSamplePoint(i, j, TCrit);
+                criticalPressure_.setSamplePoint(i, j, pCrit);
+                criticalMolarVolume_.setSamplePoint(i, j, VmCrit);
+            }
+        }
+    }
+
+    // the binary format of the cache file is a header which specifies the scalar
+    // type and the sampling grid, followed by the sample points of the critical
+    // temperatures, pressures and molar volumes
+    static bool readCriticalPointCache_(const std::string& fileName)
+    {
+        std::ifstream file(fileName.c_str(), std::ios::binary);
+        if (!file)
+            return false;
+
+        unsigned scalarSize, na, nb;
+        Scalar aMin, aMax, bMin, bMax;
+        file.read(reinterpret_cast<char*>(&scalarSize), sizeof(scalarSize));
+        file.read(reinterpret_cast<char*>(&na), sizeof(na));
+        file.read(reinterpret_cast<char*>(&nb), sizeof(nb));
+        file.read(reinterpret_cast<char*>(&aMin), sizeof(aMin));
+        file.read(reinterpret_cast<char*>(&aMax), sizeof(aMax));
+        file.read(reinterpret_cast<char*>(&bMin), sizeof(bMin));
+        file.read(reinterpret_cast<char*>(&bMax), sizeof(bMax));
+        if (!file
+            || scalarSize != sizeof(Scalar)
+            || na != criticalTemperature_.numX()
+            || nb != criticalTemperature_.numY()
+            || aMin != criticalTemperature_.xMin()
+            || aMax != criticalTemperature_.xMax()
+            || bMin != criticalTemperature_.yMin()
+            || bMax != criticalTemperature_.yMax())
+            return false;
 
-        return Component::criticalPressure()*std::exp(f0 + omega * (f1 + omega*f2));
+        UniformTabulated2DFunction<Scalar>* tables[3] =
+            { &criticalTemperature_, &criticalPressure_, &criticalMolarVolume_ };
+        for (auto* table : tables) {
+            for (unsigned j = 0; j < nb; ++j) {
+                for (unsigned i = 0; i < na; ++i) {
+                    Scalar value;
+                    file.read(reinterpret_cast<char*>(&value), sizeof(value));
+                    table->setSamplePoint(i, j, value);
+                }
+            }
+        }
+
+        return static_cast<bool>(file);
     }
 
-    /*!
-     * \brief Returns the difference between the liquid and the gas phase
-     *        fugacities in [bar]
-     *
-     * \param params Parameters
-     * \param T Temperature [K]
-     * \param p Pressure [bar]
-     * \param VmLiquid Molar volume of the liquid phase [cm^3/mol]
-     * \param VmGas Molar volume of the gas phase [cm^3/mol]
-     */
-    template <class Evaluation, class Params>
-    static Evaluation fugacityDifference_(const Params& params,
-                                          const Evaluation& T,
-                                          const Evaluation& p,
-                                          const Evaluation& VmLiquid,
-                                          const Evaluation& VmGas)
-    { return fugacity(params, T, p, VmLiquid) - fugacity(params, T, p, VmGas); }
+    static void writeCriticalPointCache_(const std::string& fileName)
+    {
+        std::ofstream file(fileName.c_str(), std::ios::binary);
+        if (!file)
+            OPM_THROW(std::runtime_error,
+                      "Could not open file '" << fileName << "' for writing the critical points");
+
+        unsigned scalarSize = sizeof(Scalar);
+        unsigned na = criticalTemperature_.numX();
+        unsigned nb = criticalTemperature_.numY();
+        Scalar aMin = criticalTemperature_.xMin();
+        Scalar aMax = criticalTemperature_.xMax();
+        Scalar bMin = criticalTemperature_.yMin();
+        Scalar bMax = criticalTemperature_.yMax();
+        file.write(reinterpret_cast<const char*>(&scalarSize), sizeof(scalarSize));
+        file.write(reinterpret_cast<const char*>(&na), sizeof(na));
+        file.write(reinterpret_cast<const char*>(&nb), sizeof(nb));
+        file.write(reinterpret_cast<const char*>(&aMin), sizeof(aMin));
+        file.write(reinterpret_cast<const char*>(&aMax), sizeof(aMax));
+        file.write(reinterpret_cast<const char*>(&bMin), sizeof(bMin));
+        file.write(reinterpret_cast<const char*>(&bMax), sizeof(bMax));
+
+        const UniformTabulated2DFunction<Scalar>* tables[3] =
+            { &criticalTemperature_, &criticalPressure_, &criticalMolarVolume_ };
+        for (const auto* table : tables) {
+            for (unsigned j = 0; j < nb; ++j) {
+                for (unsigned i = 0; i < na; ++i) {
+                    Scalar value = table->getSamplePoint(i, j);
+                    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+                }
+            }
+        }
+    }
 
-/*
+    static bool criticalPointsTabulated_;
     static UniformTabulated2DFunction<Scalar> criticalTemperature_;
     static UniformTabulated2DFunction<Scalar> criticalPressure_;
     static UniformTabulated2DFunction<Scalar> criticalMolarVolume_;
-*/
 };
 
 template <class Scalar>
 const Scalar PengRobinson<Scalar>::R = Opm::Constants<Scalar>::R;
 
-/*
+template <class Scalar>
+bool PengRobinson<Scalar>::criticalPointsTabulated_ = false;
+
 template <class Scalar>
 UniformTabulated2DFunction<Scalar> PengRobinson<Scalar>::criticalTemperature_;
 
@@ -547,7 +799,6 @@ UniformTabulated2DFunction<Scalar> PengRobinson<Scalar>::criticalPressure_;
 
 template <class Scalar>
 UniformTabulated2DFunction<Scalar> PengRobinson<Scalar>::criticalMolarVolume_;
-*/
 
 } // namespace Opm
 
@@ -31,6 +31,7 @@
 
 #include <opm/material/Constants.hpp>
 
+#include <cmath>
 #include <iostream>
 
 namespace Opm {
@@ -151,6 +152,190 @@ public:
         return fugCoeff;
     }
 
+    /*!
+     * \brief Computes the fugacity coefficients of all components in the phase.
+     *
+     * After this method was called, fugCoeffs[i] contains the fugacity coefficient of
+     * component i as computed by computeFugacityCoefficient(). The compressibility
+     * factor, the logarithmic term of the Peng-Robinson fugacity expression and the
+     * square roots of the pure component attraction parameters are shared by all
+     * components, so this is considerably cheaper than calling
+     * computeFugacityCoefficient() for each component.
+     */
+    template <class FluidState, class Params, class Container>
+    static void computeFugacityCoefficients(const FluidState& fs,
+                                            const Params& params,
+                                            unsigned phaseIdx,
+                                            Container& fugCoeffs)
+    {
+        typedef typename FluidState::Scalar Evaluation;
+
+        Evaluation Vm = params.molarVolume(phaseIdx);
+        Evaluation b = params.b(phaseIdx);
+        Evaluation a = params.a(phaseIdx);
+
+        // Calculate the compressibility factor
+        Evaluation RT = R*fs.temperature(phaseIdx);
+        Evaluation p = fs.pressure(phaseIdx);
+        Evaluation Z = p*Vm/RT;
+
+        // Calculate A^* and B^* (see: Reid, p. 42)
+        Evaluation Astar = a*p/(RT*RT);
+        Evaluation Bstar = b*p/(RT);
+
+        // the mole fraction weighted square roots of the attraction parameters. the
+        // mole fractions are normalized like in computeFugacityCoefficient()
+        Evaluation sumMoleFractions = 0.0;
+        for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx)
+            sumMoleFractions += fs.moleFraction(phaseIdx, compJIdx);
+
+        Evaluation sqrtA[numComponents];
+        Evaluation xSqrtA[numComponents];
+        for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx) {
+            sqrtA[compJIdx] = Opm::sqrt(params.aPure(phaseIdx, compJIdx));
+            xSqrtA[compJIdx] = fs.moleFraction(phaseIdx, compJIdx)/sumMoleFractions*sqrtA[compJIdx];
+        }
+
+        const Scalar sqrtUW = std::sqrt(u*u - 4*w);
+        Evaluation lnBase =
+            Opm::log((2*Z + Bstar*(u + sqrtUW)) /
+                     (2*Z + Bstar*(u - sqrtUW)));
+        Evaluation C = Astar/(Bstar*sqrtUW);
+        Evaluation invZMinusB = 1.0/Opm::max(1e-9, Z - Bstar);
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Evaluation bi_b = params.bPure(phaseIdx, compIdx) / b;
+
+            // calculate delta_i (see: Reid, p. 145)
+            Evaluation tmp = 0.0;
+            for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx)
+                tmp +=
+                    xSqrtA[compJIdx]
+                    * (1.0 - StaticParameters::interactionCoefficient(compIdx, compJIdx));
+            Evaluation deltai = 2*sqrtA[compIdx]/a*tmp;
+
+            Evaluation fugCoeff =
+                Opm::exp(bi_b*(Z - 1) + C*(bi_b - deltai)*lnBase)*invZMinusB;
+
+            // limit the fugacity coefficient to the same range as
+            // computeFugacityCoefficient()
+            fugCoeff = Opm::min(1e10, fugCoeff);
+            fugCoeff = Opm::max(1e-10, fugCoeff);
+
+            fugCoeffs[compIdx] = fugCoeff;
+        }
+    }
+
+    /*!
+     * \brief Computes the partial derivatives of the logarithms of the fugacity
+     *        coefficients of all components with regard to the phase's mole fractions.
+     *
+     * After this method was called, dLnPhi[i][k] contains \f$\partial \ln \phi_i /
+     * \partial x_k\f$ for constant pressure and temperature. The mole fractions are
+     * treated as independent variables and the molar volume is differentiated
+     * implicitly via the cubic equation of state. If the fugacity coefficient of a
+     * component is cut off by the limits of computeFugacityCoefficient(), its
+     * derivatives are zero.
+     *
+     * \return false if the molar volume of the phase is not a root of the cubic
+     *         equation of state, i.e., if it was extrapolated for a phase which does not
+     *         exist at the given conditions. dLnPhi is not set in this case.
+     */
+    template <class FluidState, class Params, class Matrix>
+    static bool computeLnFugacityCoefficientDerivatives(Matrix& dLnPhi,
+                                                        const FluidState& fs,
+                                                        const Params& params,
+                                                        unsigned phaseIdx)
+    {
+        typedef typename FluidState::Scalar Evaluation;
+
+        const Scalar sqrt2 = std::sqrt(2.0);
+        const Scalar sigma1 = 1 + sqrt2;
+        const Scalar sigma2 = 1 - sqrt2;
+
+        Evaluation RT = R*fs.temperature(phaseIdx);
+        Evaluation p = fs.pressure(phaseIdx);
+        Evaluation a = params.a(phaseIdx);
+        Evaluation b = params.b(phaseIdx);
+        Evaluation Z = p*params.molarVolume(phaseIdx)/RT;
+        Evaluation A = a*p/(RT*RT);
+        Evaluation B = b*p/RT;
+
+        // for extrapolated molar volumes, the derivatives of the cubic equation of
+        // state do not apply
+        Evaluation F = Z*(Z*(Z - (1 - B)) + (A - 3*B*B - 2*B)) - (A*B - B*B - B*B*B);
+        if (!(Opm::abs(F) < 1e-8*(1 + Opm::abs(A) + Opm::abs(B))))
+            return false;
+
+        // the binary attraction parameters and their mole fraction weighted sums
+        Evaluation sumMoleFractions = 0.0;
+        Evaluation aSum[numComponents];
+        Scalar aij[numComponents][numComponents];
+        for (unsigned compIIdx = 0; compIIdx < numComponents; ++compIIdx) {
+            sumMoleFractions += fs.moleFraction(phaseIdx, compIIdx);
+            aSum[compIIdx] = 0.0;
+            for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx) {
+                aij[compIIdx][compJIdx] =
+                    std::sqrt(Opm::scalarValue(params.aPure(phaseIdx, compIIdx)
+                                               *params.aPure(phaseIdx, compJIdx)))
+                    * (1.0 - StaticParameters::interactionCoefficient(compIIdx, compJIdx));
+                aSum[compIIdx] += fs.moleFraction(phaseIdx, compJIdx)*aij[compIIdx][compJIdx];
+            }
+        }
+
+        // partial derivatives of the cubic equation of state
+        //   F(Z, A, B) = Z^3 - (1 - B) Z^2 + (A - 3B^2 - 2B) Z - (AB - B^2 - B^3)
+        Evaluation dF_dZ = 3*Z*Z - 2*(1 - B)*Z + (A - 3*B*B - 2*B);
+        Evaluation dF_dA = Z - B;
+        Evaluation dF_dB = Z*Z - (6*B + 2)*Z - (A - 2*B - 3*B*B);
+
+        Evaluation C = A/(2*sqrt2*B);
+        Evaluation L = Opm::log((Z + sigma1*B)/(Z + sigma2*B));
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Evaluation bi_b = params.bPure(phaseIdx, compIdx)/b;
+            Evaluation deltai = 2*aSum[compIdx]/(sumMoleFractions*a);
+
+            // check whether the fugacity coefficient is affected by the limiters
+            Evaluation lnPhi =
+                bi_b*(Z - 1) - Opm::log(Opm::max(1e-9, Z - B)) + C*(bi_b - deltai)*L;
+            bool isLimited =
+                Z - B < 1e-9
+                || lnPhi > std::log(1e10)
+                || lnPhi < std::log(1e-10);
+
+            for (unsigned compKIdx = 0; compKIdx < numComponents; ++compKIdx) {
+                if (isLimited) {
+                    dLnPhi[compIdx][compKIdx] = 0.0;
+                    continue;
+                }
+
+                Evaluation da = 2*aSum[compKIdx];
+                Evaluation db = params.bPure(phaseIdx, compKIdx);
+                Evaluation dA = A*da/a;
+                Evaluation dB = B*db/b;
+                Evaluation dZ = - (dF_dA*dA + dF_dB*dB)/dF_dZ;
+
+                Evaluation dbi_b = - bi_b*db/b;
+                Evaluation ddeltai =
+                    2*aij[compIdx][compKIdx]/(sumMoleFractions*a)
+                    - deltai*(1.0/sumMoleFractions + da/a);
+                Evaluation dC = C*(da/a - db/b);
+                Evaluation dL =
+                    (dZ + sigma1*dB)/(Z + sigma1*B)
+                    - (dZ + sigma2*dB)/(Z + sigma2*B);
+
+                dLnPhi[compIdx][compKIdx] =
+                    dbi_b*(Z - 1) + bi_b*dZ
+                    - (dZ - dB)/(Z - B)
+                    + dC*(bi_b - deltai)*L
+                    + C*(dbi_b - ddeltai)*L
+                    + C*(bi_b - deltai)*dL;
+            }
+        }
+
+        return true;
+    }
 };
 
 template <class Scalar, class StaticParameters>
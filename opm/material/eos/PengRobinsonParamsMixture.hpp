@@ -33,6 +33,7 @@
 #include <opm/material/Constants.hpp>
 
 #include <algorithm>
+#include <limits>
 
 namespace Opm
 {
@@ -69,6 +70,11 @@ class PengRobinsonParamsMixture
     static const Scalar R;
 
 public:
+    PengRobinsonParamsMixture()
+        : cachedTemperature_(std::numeric_limits<Scalar>::quiet_NaN())
+        , mixUpToDate_(false)
+    {}
+
     /*!
      * \brief Update Peng-Robinson parameters for the pure components.
      */
@@ -82,13 +88,20 @@ public:
     /*!
      * \brief Peng-Robinson parameters for the pure components.
      *
-     * This method is given by the SPE5 paper.
+     * This method is given by the SPE5 paper. The parameters of the pure components
+     * and the binary attraction parameters only depend on temperature, so they are
+     * only recalculated if the temperature differs from the one of the last call.
      */
     void updatePure(Scalar temperature, Scalar pressure)
     {
         Valgrind::CheckDefined(temperature);
         Valgrind::CheckDefined(pressure);
 
+        if (temperature == cachedTemperature_)
+            return;
+        cachedTemperature_ = temperature;
+        mixUpToDate_ = false;
+
         // Calculate the Peng-Robinson parameters of the pure
         // components
         //
@@ -147,28 +160,33 @@ public:
         //
         // See: R. Reid, et al.: The Properties of Gases and Liquids,
         // 4th edition, McGraw-Hill, 1987, p. 82
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            const Scalar moleFrac = fs.moleFraction(phaseIdx, compIdx);
+            moleFractions_[compIdx] = Opm::max(0.0, Opm::min(1.0, moleFrac));
+            Valgrind::CheckDefined(moleFractions_[compIdx]);
+        }
+
         Scalar newA = 0;
         Scalar newB = 0;
         for (unsigned compIIdx = 0; compIIdx < numComponents; ++compIIdx) {
-            const Scalar moleFracI = fs.moleFraction(phaseIdx, compIIdx);
-            Scalar xi = Opm::max(0.0, Opm::min(1.0, moleFracI));
-            Valgrind::CheckDefined(xi);
+            Scalar xi = moleFractions_[compIIdx];
 
-            for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx) {
-                const Scalar moleFracJ = fs.moleFraction(phaseIdx, compJIdx );
-                Scalar xj = Opm::max(0.0, Opm::min(1.0, moleFracJ));
-                Valgrind::CheckDefined(xj);
+            // the mole fraction weighted sum of the binary attraction parameters
+            // of the component. these are kept to allow updateSingleMoleFraction()
+            // to only do O(N) work.
+            aSum_[compIIdx] = 0;
+            for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx)
+                aSum_[compIIdx] += moleFractions_[compJIdx] * aCache_[compIIdx][compJIdx];
 
-                // mixing rule from Reid, page 82
-                newA +=  xi * xj * aCache_[compIIdx][compJIdx];
-
-                assert(std::isfinite(Opm::scalarValue(newA)));
-            }
+            // mixing rule from Reid, page 82
+            newA += xi * aSum_[compIIdx];
+            assert(std::isfinite(Opm::scalarValue(newA)));
 
             // mixing rule from Reid, page 82
-            newB += Opm::max(0.0, xi) * this->pureParams_[compIIdx].b();
+            newB += xi * this->pureParams_[compIIdx].b();
             assert(std::isfinite(Opm::scalarValue(newB)));
         }
+        mixUpToDate_ = true;
 
         // assert(newB > 0);
         this->setA(newA);
@@ -185,15 +203,60 @@ public:
      *        was changed.
      *
      * The updatePure() method needs to be called _before_ calling
-     * this method!
+     * this method! If updateMix() was called after the last change of
+     * the temperature, only the contributions of the changed component
+     * are updated, i.e., this is O(N) instead of O(N^2).
      */
     template <class FluidState>
     void updateSingleMoleFraction(const FluidState& fs,
-                                  unsigned /*compIdx*/)
+                                  unsigned compIdx)
     {
-        updateMix(fs);
+        if (!mixUpToDate_) {
+            updateMix(fs);
+            return;
+        }
+
+        const Scalar moleFrac = fs.moleFraction(phaseIdx, compIdx);
+        Scalar xk = Opm::max(0.0, Opm::min(1.0, moleFrac));
+        Scalar deltaX = xk - moleFractions_[compIdx];
+        if (deltaX == 0.0)
+            return;
+
+        // a = sum_i sum_j x_i x_j a_ij, so changing x_k by deltaX changes a by
+        // 2*deltaX*sum_j x_j a_kj + deltaX^2 a_kk
+        Scalar newA = this->a() + deltaX*(2*aSum_[compIdx] + deltaX*aCache_[compIdx][compIdx]);
+        Scalar newB = this->b() + deltaX*this->pureParams_[compIdx].b();
+
+        for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx)
+            aSum_[compJIdx] += deltaX*aCache_[compJIdx][compIdx];
+        moleFractions_[compIdx] = xk;
+
+        this->setA(newA);
+        this->setB(newB);
+
+        Valgrind::CheckDefined(this->a());
+        Valgrind::CheckDefined(this->b());
     }
 
+    /*!
+     * \brief Return the binary attraction parameter of two components
+     *
+     * This is \f$a_{ij} = (1 - k_{ij}) \sqrt{a_i a_j}\f$ for the
+     * temperature of the last call to updatePure().
+     */
+    Scalar aBinary(unsigned compIIdx, unsigned compJIdx) const
+    { return aCache_[compIIdx][compJIdx]; }
+
+    /*!
+     * \brief Return the mole fraction weighted sum of the binary
+     *        attraction parameters of a component
+     *
+     * This is \f$\sum_j x_j a_{ij}\f$ for the composition of the last
+     * call to updateMix() or updateSingleMoleFraction().
+     */
+    Scalar aSum(unsigned compIdx) const
+    { return aSum_[compIdx]; }
+
     /*!
      * \brief Return the Peng-Robinson parameters of a pure substance,
      */
@@ -243,7 +306,11 @@ private:
         }
     }
 
+    Scalar cachedTemperature_;
     Scalar aCache_[numComponents][numComponents];
+    Scalar aSum_[numComponents];
+    Scalar moleFractions_[numComponents];
+    bool mixUpToDate_;
 };
 
 template <class Scalar, class FluidSystem, unsigned phaseIdx, bool useSpe5Relations>
@@ -165,7 +165,7 @@ public:
     {
         assert(0.0 <= Sw && Sw <= 1.0);
 
-        return params.entryPressure()*Opm::pow(Sw, -1/params.lambda());
+        return params.entryPressure()*Opm::pow(Sw, -params.invLambda());
     }
 
     template <class Evaluation>
@@ -238,13 +238,13 @@ public:
     {
         assert(0.0 <= Sw && Sw <= 1.0);
 
-        return Opm::pow(Sw, 2.0/params.lambda() + 3.0);
+        return Opm::pow(Sw, 2*params.invLambda() + 3.0);
     }
 
     template <class Evaluation>
     static Evaluation twoPhaseSatKrwInv(const Params& params, const Evaluation& krw)
     {
-        return Opm::pow(krw, 1.0/(2.0/params.lambda() + 3.0));
+        return Opm::pow(krw, 1.0/(2*params.invLambda() + 3.0));
     }
 
     /*!
@@ -269,7 +269,7 @@ public:
     {
         assert(0.0 <= Sw && Sw <= 1.0);
 
-        Scalar exponent = 2.0/params.lambda() + 1.0;
+        Scalar exponent = 2*params.invLambda() + 1.0;
         const Evaluation Sn = 1.0 - Sw;
         return Sn*Sn*(1. - Opm::pow(Sw, exponent));
     }
@@ -47,8 +47,6 @@ class BrooksCoreyParams : public EnsureFinalized
 {
     typedef typename TraitsT::Scalar Scalar;
 public:
-    using EnsureFinalized :: finalize;
-
     typedef TraitsT Traits;
 
     BrooksCoreyParams()
@@ -62,6 +60,31 @@ public:
         finalize();
     }
 
+    /*!
+     * \brief Calculate all dependent quantities once the independent
+     *        quantities of the parameter object have been set.
+     */
+    void finalize()
+    {
+        invLambda_ = 1/lambda_;
+
+        EnsureFinalized::finalize();
+    }
+
+    /*!
+     * \brief Returns true if the independent quantities of two parameter
+     *        objects are identical.
+     */
+    bool operator==(const BrooksCoreyParams& other) const
+    {
+        return
+            entryPressure_ == other.entryPressure_
+            && lambda_ == other.lambda_;
+    }
+
+    bool operator!=(const BrooksCoreyParams& other) const
+    { return !(*this == other); }
+
     /*!
      * \brief Returns the entry pressure [Pa]
      */
@@ -87,9 +110,17 @@ public:
     void setLambda(Scalar v)
     { lambda_ = v; }
 
+    /*!
+     * \brief Returns the inverse of the lambda shape parameter
+     */
+    Scalar invLambda() const
+    { EnsureFinalized::check(); return invLambda_; }
+
 private:
     Scalar entryPressure_;
     Scalar lambda_;
+
+    Scalar invLambda_;
 };
 } // namespace Opm
 
@@ -28,6 +28,7 @@
 #define OPM_ECL_DEFAULT_MATERIAL_HPP
 
 #include "EclDefaultMaterialParams.hpp"
+#include "MaterialLawCombinedEvaluation.hpp"
 
 #include <opm/common/Valgrind.hpp>
 #include <opm/material/common/MathToolbox.hpp>
@@ -312,6 +313,76 @@ public:
         values[gasPhaseIdx] = krg<FluidState, Evaluation>(params, fluidState);
     }
 
+    /*!
+     * \brief The capillary pressures and the relative permeabilities of all phases.
+     *
+     * This yields the same results as capillaryPressures() and
+     * relativePermeabilities(), but the oil-water capillary pressure and the water
+     * relative permeability as well as the gas-oil capillary pressure and the gas
+     * relative permeability are evaluated at the same saturation, so the nested
+     * two-phase laws are asked for each pair in a single call. If no gas is present
+     * (or no water and no connate water), the oil relative permeability of the
+     * oil-water (gas-oil) system is evaluated at the same saturation as well and is
+     * obtained from the same call.
+     */
+    template <class PcContainerT, class KrContainerT, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainerT& pcValues,
+                                                            KrContainerT& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fluidState)
+    {
+        typedef typename std::remove_reference<decltype(pcValues[0])>::type Evaluation;
+
+        const Evaluation& Sw = Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
+        const Evaluation& Sg = Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
+        const Evaluation& Sgo = 1 - Sg;
+
+        // the saturations at which the oil relperms of the two-phase systems are
+        // evaluated, see krn_()
+        const Evaluation& SwOil = Opm::max(Evaluation(params.Swl()), Sw);
+        const Evaluation& Sw_ow = Sg + SwOil;
+        const Evaluation& So_go = 1.0 - Sw_ow;
+
+        // the oil relperms of the two-phase systems are not required if the oil relperm
+        // is tabulated
+        Evaluation kro;
+        const bool tabulatedKro = tabulatedKrn_(kro, params, SwOil, Sg);
+
+        // if these coincide with the saturations of the capillary pressures (including
+        // their derivatives), the oil relperms are obtained from the same calls
+        Evaluation pcow;
+        Evaluation krw;
+        Evaluation kro_ow;
+        const bool sameSw_ow = (Sw_ow == Sw);
+        Opm::twoPhaseSatPcnwAndKr<OilWaterMaterialLaw, Evaluation>(&pcow, &krw,
+                                                                   (sameSw_ow && !tabulatedKro) ? &kro_ow : nullptr,
+                                                                   params.oilWaterParams(), Sw);
+        if (!sameSw_ow && !tabulatedKro)
+            kro_ow = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw_ow);
+
+        Evaluation pcgo;
+        Evaluation krg;
+        Evaluation kro_go;
+        const bool sameSo_go = (So_go == Sgo);
+        Opm::twoPhaseSatPcnwAndKr<GasOilMaterialLaw, Evaluation>(&pcgo,
+                                                                 (sameSo_go && !tabulatedKro) ? &kro_go : nullptr,
+                                                                 &krg,
+                                                                 params.gasOilParams(), Sgo);
+        if (!sameSo_go && !tabulatedKro)
+            kro_go = GasOilMaterialLaw::twoPhaseSatKrw(params.gasOilParams(), So_go);
+
+        if (!tabulatedKro)
+            kro = interpolateKrn_(params, SwOil, Sg, Sw_ow, kro_ow, kro_go);
+
+        pcValues[gasPhaseIdx] = pcgo;
+        pcValues[oilPhaseIdx] = 0;
+        pcValues[waterPhaseIdx] = - pcow;
+
+        krValues[waterPhaseIdx] = krw;
+        krValues[oilPhaseIdx] = kro;
+        krValues[gasPhaseIdx] = krg;
+    }
+
     /*!
      * \brief The relative permeability of the gas phase.
      */
@@ -341,34 +412,9 @@ public:
     static Evaluation krn(const Params& params,
                           const FluidState& fluidState)
     {
-        Scalar Swco = params.Swl();
-
-        Evaluation Sw =
-            Opm::max(Evaluation(Swco),
-                         Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx)));
-        Evaluation Sg = Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
-
-        Evaluation Sw_ow = Sg + Sw;
-        Evaluation So_go = 1.0 - Sw_ow;
-        const Evaluation& kro_ow = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw_ow);
-        const Evaluation& kro_go = GasOilMaterialLaw::twoPhaseSatKrw(params.gasOilParams(), So_go);
-
-        // avoid the division by zero: chose a regularized kro which is used if Sw - Swco
-        // < epsilon/2 and interpolate between the oridinary and the regularized kro between
-        // epsilon and epsilon/2
-        const Scalar epsilon = 1e-5;
-        if (Opm::scalarValue(Sw_ow) - Swco < epsilon) {
-            Evaluation kro2 = (kro_ow + kro_go)/2;;
-            if (Opm::scalarValue(Sw_ow) - Swco > epsilon/2) {
-                Evaluation kro1 = (Sg*kro_go + (Sw - Swco)*kro_ow)/(Sw_ow - Swco);
-                Evaluation alpha = (epsilon - (Sw_ow - Swco))/(epsilon/2);
-                return kro2*alpha + kro1*(1 - alpha);
-            }
-
-            return kro2;
-        }
-        else
-            return (Sg*kro_go + (Sw - Swco)*kro_ow)/(Sw_ow - Swco);
+        const Evaluation& Sw = Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
+        const Evaluation& Sg = Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
+        return krn_(params, Sw, Sg);
     }
 
     /*!
@@ -376,10 +422,11 @@ public:
      *
      * This assumes that the nested two-phase material laws are parameters for
      * EclHysteresisLaw. If they are not, calling this methid will cause a compiler
-     * error. (But not calling it will still work.)
+     * error. (But not calling it will still work.) The return value is true if the
+     * scanning curves of any of the nested laws were modified.
      */
     template <class FluidState>
-    static void updateHysteresis(Params& params, const FluidState& fluidState)
+    static bool updateHysteresis(Params& params, const FluidState& fluidState)
     {
         Scalar Sw = Opm::scalarValue(fluidState.saturation(waterPhaseIdx));
         Scalar So = Opm::scalarValue(fluidState.saturation(oilPhaseIdx));
@@ -396,8 +443,9 @@ public:
             //
             // Though be aware that from a physical perspective this is definitively
             // incorrect!
-            params.oilWaterParams().update(/*pcSw=*/1 - So, /*krwSw=*/1 - So, /*krn_Sw=*/1 - So);
-            params.gasOilParams().update(/*pcSw=*/1 - Sg, /*krwSw=*/1 - Sg, /*krn_Sw=*/1 - Sg);
+            bool changed = params.oilWaterParams().update(/*pcSw=*/1 - So, /*krwSw=*/1 - So, /*krn_Sw=*/1 - So);
+            changed = params.gasOilParams().update(/*pcSw=*/1 - Sg, /*krwSw=*/1 - Sg, /*krn_Sw=*/1 - Sg) || changed;
+            return changed;
         }
         else {
             Scalar Swco = params.Swl();
@@ -407,9 +455,80 @@ public:
             Scalar Sw_ow = Sg + std::max(Swco, Sw);
             Scalar So_go = 1 + Sw_ow;
 
-            params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/1 - Sg, /*krnSw=*/Sw_ow);
-            params.gasOilParams().update(/*pcSw=*/1 - Sg, /*krwSw=*/So_go, /*krnSw=*/1 - Sg);
+            bool changed = params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/1 - Sg, /*krnSw=*/Sw_ow);
+            changed = params.gasOilParams().update(/*pcSw=*/1 - Sg, /*krwSw=*/So_go, /*krnSw=*/1 - Sg) || changed;
+            return changed;
+        }
+    }
+
+private:
+    template <class Evaluation>
+    static Evaluation krn_(const Params& params,
+                           const Evaluation& SwIn,
+                           const Evaluation& Sg)
+    {
+        Scalar Swco = params.Swl();
+
+        Evaluation Sw = Opm::max(Evaluation(Swco), SwIn);
+
+        Evaluation kro;
+        if (tabulatedKrn_(kro, params, Sw, Sg))
+            return kro;
+
+        Evaluation Sw_ow = Sg + Sw;
+        Evaluation So_go = 1.0 - Sw_ow;
+        const Evaluation& kro_ow = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw_ow);
+        const Evaluation& kro_go = GasOilMaterialLaw::twoPhaseSatKrw(params.gasOilParams(), So_go);
+
+        return interpolateKrn_(params, Sw, Sg, Sw_ow, kro_ow, kro_go);
+    }
+
+    // look the oil relperm up in the table of the parameters if there is one and the
+    // saturations are within the triangle covered by it. 'Sw' is the water saturation
+    // limited to the connate one.
+    template <class Evaluation>
+    static bool tabulatedKrn_(Evaluation& kro,
+                              const Params& params,
+                              const Evaluation& Sw,
+                              const Evaluation& Sg)
+    {
+        const auto* kroTable = params.kroTable();
+        if (!kroTable || !kroTable->applies(Sw, Sg) || Sw + Sg > 1.0)
+            return false;
+
+        kro = kroTable->eval(Sw, Sg);
+        return true;
+    }
+
+    // the saturation weighted interpolation of the oil relperms of the two-phase
+    // systems. 'Sw' is the water saturation limited to the connate one and 'Sw_ow'
+    // is the sum of it and the gas saturation.
+    template <class Evaluation>
+    static Evaluation interpolateKrn_(const Params& params,
+                                      const Evaluation& Sw,
+                                      const Evaluation& Sg,
+                                      const Evaluation& Sw_ow,
+                                      const Evaluation& kro_ow,
+                                      const Evaluation& kro_go)
+    {
+        Scalar Swco = params.Swl();
+
+        // avoid the division by zero: chose a regularized kro which is used if Sw - Swco
+        // < epsilon/2 and interpolate between the oridinary and the regularized kro between
+        // epsilon and epsilon/2
+        const Scalar epsilon = 1e-5;
+        if (Opm::scalarValue(Sw_ow) - Swco < epsilon) {
+            Evaluation kro2 = (kro_ow + kro_go)/2;;
+            if (Opm::scalarValue(Sw_ow) - Swco > epsilon/2) {
+                Evaluation kro1 = (Sg*kro_go + (Sw - Swco)*kro_ow)/(Sw_ow - Swco);
+                Evaluation alpha = (epsilon - (Sw_ow - Swco))/(epsilon/2);
+                return kro2*alpha + kro1*(1 - alpha);
+            }
+
+            return kro2;
         }
+        else
+            return (Sg*kro_go + (Sw - Swco)*kro_ow)/(Sw_ow - Swco);
     }
 };
 } // namespace Opm
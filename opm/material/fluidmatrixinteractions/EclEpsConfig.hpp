@@ -35,6 +35,8 @@
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #endif
 
+#include <opm/material/common/BinarySerialization.hpp>
+
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/Unused.hpp>
@@ -243,6 +245,32 @@ public:
     }
 #endif
 
+    /*!
+     * \brief Write the configuration to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(enableSatScaling_);
+        writer.write(enableThreePointKrSatScaling_);
+        writer.write(enablePcScaling_);
+        writer.write(enableLeverettScaling_);
+        writer.write(enableKrwScaling_);
+        writer.write(enableKrnScaling_);
+    }
+
+    /*!
+     * \brief Restore the configuration which was written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(enableSatScaling_);
+        reader.read(enableThreePointKrSatScaling_);
+        reader.read(enablePcScaling_);
+        reader.read(enableLeverettScaling_);
+        reader.read(enableKrwScaling_);
+        reader.read(enableKrnScaling_);
+    }
+
 private:
     // enable scaling of the input saturations (i.e., rescale the x-Axis)
     bool enableSatScaling_;
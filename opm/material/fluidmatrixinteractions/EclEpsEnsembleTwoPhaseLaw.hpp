@@ -0,0 +1,205 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::EclEpsEnsembleTwoPhaseLaw
+ */
+#ifndef OPM_ECL_EPS_ENSEMBLE_TWO_PHASE_LAW_HPP
+#define OPM_ECL_EPS_ENSEMBLE_TWO_PHASE_LAW_HPP
+
+#include "EclEpsEnsembleTwoPhaseLawParams.hpp"
+#include "MaterialLawCombinedEvaluation.hpp"
+
+#include <opm/material/common/Tracing.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Evaluates the ECL end-point scaling of a two-phase law for all members of
+ *        an ensemble of scaling point realizations at once.
+ *
+ * This is intended for uncertainty studies which evaluate the same saturation under
+ * many realizations of the end points, e.g., SWL, SWCR or KRW. A single call yields
+ * the values of all members. The conversion of the scaled saturation to the unscaled
+ * ones and the scaling of the values of the unscaled curves are loops over the
+ * members which the compiler is able to vectorize. The unscaled curves are shared by
+ * all members: Members which map to the same unscaled saturation share a single
+ * lookup and the segment found for a member is tried first for the next one. If the
+ * saturations are not scaled at all, a single fused lookup is done for all members.
+ *
+ * The results are identical to the ones of EclEpsTwoPhaseLaw without baked scaling
+ * for the scaled points of the respective member. Only plain scalars are supported,
+ * and the effective law must provide the lookup hint API of
+ * PiecewiseLinearTwoPhaseMaterial.
+ */
+template <class EffLawT,
+          class ParamsT = EclEpsEnsembleTwoPhaseLawParams<EffLawT> >
+class EclEpsEnsembleTwoPhaseLaw
+{
+    typedef EffLawT EffLaw;
+    typedef typename EffLaw::Params EffLawParams;
+    typedef typename EffLaw::LookupHint LookupHint;
+
+public:
+    typedef typename EffLaw::Traits Traits;
+    typedef ParamsT Params;
+    typedef typename EffLaw::Scalar Scalar;
+    typedef typename Params::SatScaling SatScaling;
+
+    /*!
+     * \brief The capillary pressure and the relative permeabilities of all members at
+     *        a given wetting phase saturation.
+     *
+     * The output arrays must provide a value for each member of the ensemble. Only the
+     * quantities for which a non-null pointer is passed are computed.
+     */
+    static void twoPhaseSatPcnwAndKr(Scalar* pcnw,
+                                     Scalar* krw,
+                                     Scalar* krn,
+                                     const Params& params,
+                                     Scalar SwScaled)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclEpsEnsembleTwoPhaseLaw::twoPhaseSatPcnwAndKr");
+
+        if (!params.config().enableSatScaling()) {
+            // all members see the same unscaled saturation
+            Scalar pcnwUnscaled, krwUnscaled, krnUnscaled;
+            Opm::twoPhaseSatPcnwAndKr<EffLaw>(pcnw ? &pcnwUnscaled : nullptr,
+                                              krw ? &krwUnscaled : nullptr,
+                                              krn ? &krnUnscaled : nullptr,
+                                              params.effectiveLawParams(),
+                                              SwScaled);
+            if (pcnw)
+                broadcast_(pcnw, params.pcnwFactors(), pcnwUnscaled);
+            if (krw)
+                broadcast_(krw, params.krwFactors(), krwUnscaled);
+            if (krn)
+                broadcast_(krn, params.krnFactors(), krnUnscaled);
+            return;
+        }
+
+        if (pcnw)
+            evalCurve_<PcCurve>(pcnw, params, params.pcSatScaling(), params.pcnwFactors(), SwScaled);
+        if (krw)
+            evalCurve_<KrwCurve>(krw, params, params.krwSatScaling(), params.krwFactors(), SwScaled);
+        if (krn)
+            evalCurve_<KrnCurve>(krn, params, params.krnSatScaling(), params.krnFactors(), SwScaled);
+    }
+
+    /*!
+     * \brief The capillary pressure of all members at a given wetting phase
+     *        saturation.
+     */
+    static void twoPhaseSatPcnw(Scalar* values, const Params& params, Scalar SwScaled)
+    { twoPhaseSatPcnwAndKr(values, nullptr, nullptr, params, SwScaled); }
+
+    /*!
+     * \brief The relative permeability of the wetting phase of all members at a given
+     *        wetting phase saturation.
+     */
+    static void twoPhaseSatKrw(Scalar* values, const Params& params, Scalar SwScaled)
+    { twoPhaseSatPcnwAndKr(nullptr, values, nullptr, params, SwScaled); }
+
+    /*!
+     * \brief The relative permeability of the non-wetting phase of all members at a
+     *        given wetting phase saturation.
+     */
+    static void twoPhaseSatKrn(Scalar* values, const Params& params, Scalar SwScaled)
+    { twoPhaseSatPcnwAndKr(nullptr, nullptr, values, params, SwScaled); }
+
+private:
+    enum Curve { PcCurve, KrwCurve, KrnCurve };
+
+    static void broadcast_(Scalar* values, const std::vector<Scalar>& factors, Scalar unscaledValue)
+    {
+        const size_t n = factors.size();
+        const Scalar* factor = factors.data();
+        for (size_t memberIdx = 0; memberIdx < n; ++memberIdx)
+            values[memberIdx] = unscaledValue*factor[memberIdx];
+    }
+
+    template <Curve curve>
+    static Scalar lookup_(const EffLawParams& effParams, Scalar SwUnscaled, LookupHint& hint)
+    {
+        if (curve == PcCurve)
+            return EffLaw::twoPhaseSatPcnw(effParams, SwUnscaled, hint);
+        else if (curve == KrwCurve)
+            return EffLaw::twoPhaseSatKrw(effParams, SwUnscaled, hint);
+        return EffLaw::twoPhaseSatKrn(effParams, SwUnscaled, hint);
+    }
+
+    template <Curve curve>
+    static void evalCurve_(Scalar* values,
+                           const Params& params,
+                           const SatScaling& scaling,
+                           const std::vector<Scalar>& factors,
+                           Scalar SwScaled)
+    {
+        const size_t n = factors.size();
+        if (n == 0)
+            return;
+
+        // the unscaled saturations of all members. the values array is used as
+        // scratch space for them
+        const Scalar lowBase = scaling.lowBase;
+        const Scalar highBase = scaling.highBase;
+        const Scalar* breakpoint = scaling.breakpoint.data();
+        const Scalar* lowOrigin = scaling.lowOrigin.data();
+        const Scalar* lowRatio = scaling.lowRatio.data();
+        const Scalar* highOrigin = scaling.highOrigin.data();
+        const Scalar* highRatio = scaling.highRatio.data();
+        for (size_t memberIdx = 0; memberIdx < n; ++memberIdx) {
+            Scalar low = lowBase + (SwScaled - lowOrigin[memberIdx])*lowRatio[memberIdx];
+            Scalar high = highBase + (SwScaled - highOrigin[memberIdx])*highRatio[memberIdx];
+            values[memberIdx] = (SwScaled < breakpoint[memberIdx]) ? low : high;
+        }
+
+        // the lookups in the shared unscaled curve
+        const EffLawParams& effParams = params.effectiveLawParams();
+        LookupHint hint;
+        Scalar lastSwUnscaled = values[0];
+        Scalar lastValue = lookup_<curve>(effParams, lastSwUnscaled, hint);
+        values[0] = lastValue;
+        for (size_t memberIdx = 1; memberIdx < n; ++memberIdx) {
+            Scalar SwUnscaled = values[memberIdx];
+            if (SwUnscaled != lastSwUnscaled) {
+                lastSwUnscaled = SwUnscaled;
+                lastValue = lookup_<curve>(effParams, SwUnscaled, hint);
+            }
+            values[memberIdx] = lastValue;
+        }
+
+        // the scaling of the values
+        const Scalar* factor = factors.data();
+        for (size_t memberIdx = 0; memberIdx < n; ++memberIdx)
+            values[memberIdx] *= factor[memberIdx];
+    }
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,307 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::EclEpsEnsembleTwoPhaseLawParams
+ */
+#ifndef OPM_ECL_EPS_ENSEMBLE_TWO_PHASE_LAW_PARAMS_HPP
+#define OPM_ECL_EPS_ENSEMBLE_TWO_PHASE_LAW_PARAMS_HPP
+
+#include "EclEpsConfig.hpp"
+#include "EclEpsScalingPoints.hpp"
+
+#include <opm/material/common/EnsureFinalized.hpp>
+
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief The parameters of the ECL end-point scaling for an ensemble of realizations
+ *        of the scaling points.
+ *
+ * All members of the ensemble share the effective law, the unscaled points and the
+ * scaling configuration, only the scaled points differ. The quantities of the scaled
+ * points which are needed by the saturation and the value scaling are stored as
+ * one array per quantity (structure of arrays) whose entries are the members, so
+ * that all members are scaled by loops which the compiler is able to vectorize.
+ */
+template <class EffLawT>
+class EclEpsEnsembleTwoPhaseLawParams : public EnsureFinalized
+{
+    typedef typename EffLawT::Params EffLawParams;
+    typedef typename EffLawParams::Traits::Scalar Scalar;
+
+public:
+    typedef typename EffLawParams::Traits Traits;
+    typedef Opm::EclEpsScalingPoints<Scalar> ScalingPoints;
+
+    /*!
+     * \brief The saturation scaling of a curve for all members.
+     *
+     * The unscaled saturation of a member is given by
+     * 'lowBase + (Sw - lowOrigin)*lowRatio' if the scaled saturation Sw is below the
+     * breakpoint and by 'highBase + (Sw - highOrigin)*highRatio' otherwise. This is the
+     * same sequence of operations as the one of EclEpsTwoPhaseLaw.
+     */
+    struct SatScaling
+    {
+        Scalar lowBase;
+        Scalar highBase;
+        std::vector<Scalar> breakpoint;
+        std::vector<Scalar> lowOrigin;
+        std::vector<Scalar> lowRatio;
+        std::vector<Scalar> highOrigin;
+        std::vector<Scalar> highRatio;
+    };
+
+    EclEpsEnsembleTwoPhaseLawParams()
+    {
+    }
+
+    /*!
+     * \brief Calculate all dependent quantities once the independent
+     *        quantities of the parameter object have been set.
+     */
+    void finalize()
+    {
+        assert(effectiveLawParams_);
+        assert(unscaledPoints_);
+
+        const size_t n = numMembers();
+        const auto& unscaledPoints = *unscaledPoints_;
+        const bool threePoint = config_.enableThreePointKrSatScaling();
+
+        resizeSatScaling_(pcSatScaling_, n);
+        resizeSatScaling_(krwSatScaling_, n);
+        resizeSatScaling_(krnSatScaling_, n);
+        pcnwFactor_.resize(n);
+        krwFactor_.resize(n);
+        krnFactor_.resize(n);
+        for (size_t memberIdx = 0; memberIdx < n; ++memberIdx) {
+            const auto& scaledPoints = scaledPoints_[memberIdx];
+
+            initSatScaling_(pcSatScaling_, memberIdx, /*threePoint=*/false,
+                            unscaledPoints.saturationPcPoints(), scaledPoints.saturationPcPoints());
+            initSatScaling_(krwSatScaling_, memberIdx, threePoint,
+                            unscaledPoints.saturationKrwPoints(), scaledPoints.saturationKrwPoints());
+            initSatScaling_(krnSatScaling_, memberIdx, threePoint,
+                            unscaledPoints.saturationKrnPoints(), scaledPoints.saturationKrnPoints());
+
+            pcnwFactor_[memberIdx] = 1.0;
+            if (config_.enableLeverettScaling())
+                pcnwFactor_[memberIdx] = scaledPoints.leverettFactor();
+            else if (config_.enablePcScaling())
+                pcnwFactor_[memberIdx] = scaledPoints.maxPcnw()/unscaledPoints.maxPcnw();
+
+            krwFactor_[memberIdx] = 1.0;
+            if (config_.enableKrwScaling())
+                krwFactor_[memberIdx] = scaledPoints.maxKrw()/unscaledPoints.maxKrw();
+
+            krnFactor_[memberIdx] = 1.0;
+            if (config_.enableKrnScaling())
+                krnFactor_[memberIdx] = scaledPoints.maxKrn()/unscaledPoints.maxKrn();
+        }
+
+        EnsureFinalized :: finalize();
+    }
+
+    /*!
+     * \brief Set the endpoint scaling configuration object which is used by all
+     *        members.
+     */
+    void setConfig(std::shared_ptr<EclEpsConfig> value)
+    { config_ = *value; }
+
+    /*!
+     * \brief Returns the endpoint scaling configuration object.
+     */
+    const EclEpsConfig& config() const
+    { return config_; }
+
+    /*!
+     * \brief Set the scaling points which are seen by the nested material law
+     */
+    void setUnscaledPoints(std::shared_ptr<ScalingPoints> value)
+    { unscaledPoints_ = value; }
+
+    /*!
+     * \brief Returns the scaling points which are seen by the nested material law
+     */
+    const ScalingPoints& unscaledPoints() const
+    { return *unscaledPoints_; }
+
+    /*!
+     * \brief Sets the parameter object for the effective/nested material law.
+     */
+    void setEffectiveLawParams(std::shared_ptr<EffLawParams> value)
+    { effectiveLawParams_ = value; }
+
+    /*!
+     * \brief Returns the parameter object for the effective/nested material law.
+     */
+    const EffLawParams& effectiveLawParams() const
+    { return *effectiveLawParams_; }
+
+    /*!
+     * \brief Set the number of members of the ensemble.
+     */
+    void setNumMembers(size_t value)
+    { scaledPoints_.resize(value); }
+
+    /*!
+     * \brief Returns the number of members of the ensemble.
+     */
+    size_t numMembers() const
+    { return scaledPoints_.size(); }
+
+    /*!
+     * \brief Set the scaling points of a member which are seen by the physical model.
+     */
+    void setScaledPoints(size_t memberIdx, const ScalingPoints& value)
+    { scaledPoints_[memberIdx] = value; }
+
+    /*!
+     * \brief Set the scaling points of a member which are seen by the physical model
+     *        from the end points of a realization.
+     *
+     * The configuration must have been set before.
+     */
+    template <class InfoScalar>
+    void setScaledPoints(size_t memberIdx,
+                         const EclEpsScalingPointsInfo<InfoScalar>& epsInfo,
+                         EclTwoPhaseSystemType epsSystemType)
+    { scaledPoints_[memberIdx].init(epsInfo, config_, epsSystemType); }
+
+    /*!
+     * \brief Returns the scaling points of a member which are seen by the physical
+     *        model.
+     */
+    const ScalingPoints& scaledPoints(size_t memberIdx) const
+    { return scaledPoints_[memberIdx]; }
+
+    /*!
+     * \brief The saturation scaling of the capillary pressure curve of all members.
+     */
+    const SatScaling& pcSatScaling() const
+    { EnsureFinalized::check(); return pcSatScaling_; }
+
+    /*!
+     * \brief The saturation scaling of the wetting phase relperm curve of all members.
+     */
+    const SatScaling& krwSatScaling() const
+    { EnsureFinalized::check(); return krwSatScaling_; }
+
+    /*!
+     * \brief The saturation scaling of the non-wetting phase relperm curve of all
+     *        members.
+     */
+    const SatScaling& krnSatScaling() const
+    { EnsureFinalized::check(); return krnSatScaling_; }
+
+    /*!
+     * \brief The factors by which the unscaled capillary pressure of the members is
+     *        multiplied.
+     */
+    const std::vector<Scalar>& pcnwFactors() const
+    { EnsureFinalized::check(); return pcnwFactor_; }
+
+    /*!
+     * \brief The factors by which the unscaled wetting phase relperm of the members is
+     *        multiplied.
+     */
+    const std::vector<Scalar>& krwFactors() const
+    { EnsureFinalized::check(); return krwFactor_; }
+
+    /*!
+     * \brief The factors by which the unscaled non-wetting phase relperm of the members
+     *        is multiplied.
+     */
+    const std::vector<Scalar>& krnFactors() const
+    { EnsureFinalized::check(); return krnFactor_; }
+
+private:
+    static void resizeSatScaling_(SatScaling& scaling, size_t n)
+    {
+        scaling.breakpoint.resize(n);
+        scaling.lowOrigin.resize(n);
+        scaling.lowRatio.resize(n);
+        scaling.highOrigin.resize(n);
+        scaling.highRatio.resize(n);
+    }
+
+    // the counterpart of the two- and three-point conversions of EclEpsTwoPhaseLaw.
+    // for two-point scaling, the breakpoint is never reached.
+    template <class PointsContainer>
+    static void initSatScaling_(SatScaling& scaling,
+                                size_t memberIdx,
+                                bool threePoint,
+                                const PointsContainer& unscaledSats,
+                                const PointsContainer& scaledSats)
+    {
+        scaling.lowBase = unscaledSats[0];
+        scaling.lowOrigin[memberIdx] = scaledSats[0];
+        if (!threePoint || unscaledSats[1] >= unscaledSats[2]) {
+            scaling.highBase = unscaledSats[0];
+            scaling.breakpoint[memberIdx] = std::numeric_limits<Scalar>::max();
+            scaling.lowRatio[memberIdx] =
+                (unscaledSats[1] - unscaledSats[0])/(scaledSats[1] - scaledSats[0]);
+            scaling.highOrigin[memberIdx] = scaling.lowOrigin[memberIdx];
+            scaling.highRatio[memberIdx] = scaling.lowRatio[memberIdx];
+            return;
+        }
+
+        Scalar delta = scaledSats[1] - scaledSats[0];
+        if (delta <= 1e-20)
+            delta = 1.0; // prevent division by zero for (possibly) incorrect input data
+        scaling.lowRatio[memberIdx] = (unscaledSats[1] - unscaledSats[0])/delta;
+
+        delta = scaledSats[2] - scaledSats[1];
+        if (delta <= 1e-20)
+            delta = 1.0; // prevent division by zero for (possibly) incorrect input data
+        scaling.highBase = unscaledSats[1];
+        scaling.breakpoint[memberIdx] = scaledSats[1];
+        scaling.highOrigin[memberIdx] = scaledSats[1];
+        scaling.highRatio[memberIdx] = (unscaledSats[2] - unscaledSats[1])/delta;
+    }
+
+    std::shared_ptr<EffLawParams> effectiveLawParams_;
+    EclEpsConfig config_;
+    std::shared_ptr<ScalingPoints> unscaledPoints_;
+    std::vector<ScalingPoints> scaledPoints_;
+
+    SatScaling pcSatScaling_;
+    SatScaling krwSatScaling_;
+    SatScaling krnSatScaling_;
+    std::vector<Scalar> pcnwFactor_;
+    std::vector<Scalar> krwFactor_;
+    std::vector<Scalar> krnFactor_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,386 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::EclEpsQuantizedScalingPoints
+ */
+#ifndef OPM_ECL_EPS_QUANTIZED_SCALING_POINTS_HPP
+#define OPM_ECL_EPS_QUANTIZED_SCALING_POINTS_HPP
+
+#include "EclEpsScalingPoints.hpp"
+
+#include <opm/material/common/BinarySerialization.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Selects the quantized storage of the end-point scaling points if it is used
+ *        as the scalar type of the scaling points of EclEpsTwoPhaseLawParams or of
+ *        EclMaterialLawManager.
+ *
+ * The scaling points are decoded to the Scalar type when they are accessed.
+ */
+template <class Scalar>
+struct EclEpsQuantized
+{};
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief The scales of the maxima of quantized scaling points.
+ *
+ * The scales are usually shared by all elements of a saturation region. They are the
+ * largest absolute values of the maximum capillary pressure (or the Leverett factor)
+ * and of the maximum relative permeabilities of the wetting and the non-wetting
+ * phase.
+ */
+template <class Scalar>
+struct EclEpsQuantizationScales
+{
+    enum { pcnwIdx = 0, krwIdx = 1, krnIdx = 2 };
+
+    /*!
+     * \brief Extend the scales such that the maxima of some scaling points can be
+     *        represented.
+     */
+    void include(const EclEpsScalingPoints<Scalar>& points)
+    {
+        maxima[pcnwIdx] = std::max(maxima[pcnwIdx], std::abs(points.maxPcnw()));
+        maxima[krwIdx] = std::max(maxima[krwIdx], std::abs(points.maxKrw()));
+        maxima[krnIdx] = std::max(maxima[krnIdx], std::abs(points.maxKrn()));
+    }
+
+    /*!
+     * \brief Extend the scales such that the maxima of the scaling points of an info
+     *        object can be represented.
+     */
+    template <class InfoScalar>
+    void include(const EclEpsScalingPointsInfo<InfoScalar>& epsInfo,
+                 const EclEpsConfig& config,
+                 EclTwoPhaseSystemType epsSystemType)
+    {
+        EclEpsScalingPoints<Scalar> points = EclEpsScalingPoints<Scalar>();
+        points.init(epsInfo, config, epsSystemType);
+        include(points);
+    }
+
+    std::array<Scalar, 3> maxima;
+};
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Stores the points on the X and Y axis to be scaled if endpoint scaling is
+ *        used as 16 bit fixed point numbers.
+ *
+ * This class provides the interface of EclEpsScalingPoints, but the accessors return
+ * the points by value because they are decoded on access. The saturations are stored
+ * as fixed point numbers in [0, 1], i.e., their resolution is 1/65535. The maxima of
+ * the capillary pressure and of the relative permeabilities are stored as signed
+ * fixed point numbers relative to a set of scales which is usually shared by all
+ * elements of a saturation region, so their resolution is 1/32767 of the respective
+ * scale.
+ *
+ * Setting a maximum whose magnitude exceeds the one of its scale gives the object a
+ * private copy of the scales. Shared scales are thus never modified, and objects
+ * without scales of their own (e.g., the unscaled points) represent their maxima
+ * exactly.
+ */
+template <class Scalar>
+class EclEpsQuantizedScalingPoints
+{
+    typedef EclEpsQuantizationScales<Scalar> Scales;
+
+public:
+    EclEpsQuantizedScalingPoints()
+    {
+        maxCodes_.fill(0);
+        saturationPcCodes_.fill(0);
+        saturationKrwCodes_.fill(0);
+        saturationKrnCodes_.fill(0);
+    }
+
+    /*!
+     * \brief Assigns the scaling points which actually ought to be used.
+     *
+     * If the scales are shared, they must be set before the points.
+     */
+    template <class InfoScalar>
+    void init(const EclEpsScalingPointsInfo<InfoScalar>& epsInfo,
+              const EclEpsConfig& config,
+              EclTwoPhaseSystemType epsSystemType)
+    {
+        EclEpsScalingPoints<Scalar> points = EclEpsScalingPoints<Scalar>();
+        points.init(epsInfo, config, epsSystemType);
+        assign(points);
+    }
+
+    /*!
+     * \brief Encode the points of an object which stores them without quantization.
+     */
+    void assign(const EclEpsScalingPoints<Scalar>& points)
+    {
+        for (unsigned pointIdx = 0; pointIdx < 2; ++pointIdx)
+            setSaturationPcPoint(pointIdx, points.saturationPcPoints()[pointIdx]);
+        for (unsigned pointIdx = 0; pointIdx < 3; ++pointIdx) {
+            setSaturationKrwPoint(pointIdx, points.saturationKrwPoints()[pointIdx]);
+            setSaturationKrnPoint(pointIdx, points.saturationKrnPoints()[pointIdx]);
+        }
+        setMax_(Scales::pcnwIdx, points.maxPcnw());
+        setMax_(Scales::krwIdx, points.maxKrw());
+        setMax_(Scales::krnIdx, points.maxKrn());
+    }
+
+    /*!
+     * \brief Set the scales of the maxima.
+     *
+     * The maxima are re-encoded using the new scales. The scales object must not be
+     * modified afterwards because it may be shared by other objects.
+     */
+    void setScales(std::shared_ptr<Scales> value)
+    {
+        const Scalar maxPcnwValue = maxPcnw();
+        const Scalar maxKrwValue = maxKrw();
+        const Scalar maxKrnValue = maxKrn();
+        scales_ = value;
+        setMax_(Scales::pcnwIdx, maxPcnwValue);
+        setMax_(Scales::krwIdx, maxKrwValue);
+        setMax_(Scales::krnIdx, maxKrnValue);
+    }
+
+    /*!
+     * \brief Returns the scales of the maxima.
+     */
+    const std::shared_ptr<Scales>& scales() const
+    { return scales_; }
+
+    /*!
+     * \brief Sets an saturation value for capillary pressure saturation scaling
+     */
+    void setSaturationPcPoint(unsigned pointIdx, Scalar value)
+    { saturationPcCodes_[pointIdx] = encodeSaturation_(value); }
+
+    /*!
+     * \brief Returns the points used for capillary pressure saturation scaling
+     */
+    std::array<Scalar, 2> saturationPcPoints() const
+    { return {{ decodeSaturation_(saturationPcCodes_[0]), decodeSaturation_(saturationPcCodes_[1]) }}; }
+
+    /*!
+     * \brief Sets an saturation value for wetting-phase relperm saturation scaling
+     */
+    void setSaturationKrwPoint(unsigned pointIdx, Scalar value)
+    { saturationKrwCodes_[pointIdx] = encodeSaturation_(value); }
+
+    /*!
+     * \brief Returns the points used for wetting phase relperm saturation scaling
+     */
+    std::array<Scalar, 3> saturationKrwPoints() const
+    { return decodeSaturations_(saturationKrwCodes_); }
+
+    /*!
+     * \brief Sets an saturation value for non-wetting phase relperm saturation scaling
+     */
+    void setSaturationKrnPoint(unsigned pointIdx, Scalar value)
+    { saturationKrnCodes_[pointIdx] = encodeSaturation_(value); }
+
+    /*!
+     * \brief Returns the points used for non-wetting phase relperm saturation scaling
+     */
+    std::array<Scalar, 3> saturationKrnPoints() const
+    { return decodeSaturations_(saturationKrnCodes_); }
+
+    /*!
+     * \brief Sets the maximum capillary pressure
+     */
+    void setMaxPcnw(Scalar value)
+    { setMax_(Scales::pcnwIdx, value); }
+
+    /*!
+     * \brief Returns the maximum capillary pressure
+     */
+    Scalar maxPcnw() const
+    { return max_(Scales::pcnwIdx); }
+
+    /*!
+     * \brief Sets the Leverett scaling factor for capillary pressure
+     */
+    void setLeverettFactor(Scalar value)
+    { setMax_(Scales::pcnwIdx, value); }
+
+    /*!
+     * \brief Returns the Leverett scaling factor for capillary pressure
+     */
+    Scalar leverettFactor() const
+    { return max_(Scales::pcnwIdx); }
+
+    /*!
+     * \brief Sets the maximum wetting phase relative permeability
+     */
+    void setMaxKrw(Scalar value)
+    { setMax_(Scales::krwIdx, value); }
+
+    /*!
+     * \brief Returns the maximum wetting phase relative permeability
+     */
+    Scalar maxKrw() const
+    { return max_(Scales::krwIdx); }
+
+    /*!
+     * \brief Sets the maximum non-wetting phase relative permeability
+     */
+    void setMaxKrn(Scalar value)
+    { setMax_(Scales::krnIdx, value); }
+
+    /*!
+     * \brief Returns the maximum non-wetting phase relative permeability
+     */
+    Scalar maxKrn() const
+    { return max_(Scales::krnIdx); }
+
+    void print() const
+    {
+        const auto& krnPoints = saturationKrnPoints();
+        std::cout << "    saturationKrnPoints_[0]: " << krnPoints[0] << "\n"
+                  << "    saturationKrnPoints_[1]: " << krnPoints[1] << "\n"
+                  << "    saturationKrnPoints_[2]: " << krnPoints[2] << "\n";
+    }
+
+    /*!
+     * \brief Write the points to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.writeShared(scales_);
+        writer.write(maxCodes_);
+        writer.write(saturationPcCodes_);
+        writer.write(saturationKrwCodes_);
+        writer.write(saturationKrnCodes_);
+    }
+
+    /*!
+     * \brief Restore the points which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.readShared(scales_);
+        reader.read(maxCodes_);
+        reader.read(saturationPcCodes_);
+        reader.read(saturationKrwCodes_);
+        reader.read(saturationKrnCodes_);
+    }
+
+private:
+    static const std::uint16_t maxSaturationCode = 65535;
+    static const std::int16_t maxMaximumCode = 32767;
+
+    static std::uint16_t encodeSaturation_(Scalar value)
+    {
+        // saturations outside of [0, 1] (and NaNs) are clamped
+        if (!(value > 0.0))
+            return 0;
+        if (value >= 1.0)
+            return maxSaturationCode;
+        return static_cast<std::uint16_t>(std::floor(value*maxSaturationCode + 0.5));
+    }
+
+    static Scalar decodeSaturation_(std::uint16_t code)
+    { return Scalar(code)/maxSaturationCode; }
+
+    static std::array<Scalar, 3> decodeSaturations_(const std::array<std::uint16_t, 3>& codes)
+    {
+        return {{ decodeSaturation_(codes[0]),
+                  decodeSaturation_(codes[1]),
+                  decodeSaturation_(codes[2]) }};
+    }
+
+    void setMax_(unsigned idx, Scalar value)
+    {
+        const Scalar absValue = std::abs(value);
+        if (!scales_ || absValue > scales_->maxima[idx]) {
+            // the value cannot be represented using the current scales. the other
+            // maxima keep their scales, so their codes stay valid.
+            auto privateScales = std::make_shared<Scales>();
+            if (scales_)
+                *privateScales = *scales_;
+            else
+                privateScales->maxima.fill(0.0);
+            privateScales->maxima[idx] = absValue;
+            scales_ = privateScales;
+        }
+
+        const Scalar scale = scales_->maxima[idx];
+        if (scale == 0.0) {
+            maxCodes_[idx] = 0;
+            return;
+        }
+
+        const Scalar code = std::floor(value/scale*maxMaximumCode + 0.5);
+        maxCodes_[idx] =
+            static_cast<std::int16_t>(std::max<Scalar>(-maxMaximumCode, std::min<Scalar>(maxMaximumCode, code)));
+    }
+
+    Scalar max_(unsigned idx) const
+    {
+        if (!scales_)
+            return 0.0;
+        return Scalar(maxCodes_[idx])/maxMaximumCode*scales_->maxima[idx];
+    }
+
+    std::shared_ptr<Scales> scales_;
+    std::array<std::int16_t, 3> maxCodes_;
+    std::array<std::uint16_t, 2> saturationPcCodes_;
+    std::array<std::uint16_t, 3> saturationKrwCodes_;
+    std::array<std::uint16_t, 3> saturationKrnCodes_;
+};
+
+/*!
+ * \brief Yields the class which stores the scaling points for the scalar type of the
+ *        scaling points of EclEpsTwoPhaseLawParams.
+ */
+template <class ScalingPointsScalar>
+struct EclEpsScalingPointsStorage
+{
+    typedef EclEpsScalingPoints<ScalingPointsScalar> type;
+    typedef EclEpsQuantizationScales<ScalingPointsScalar> Scales;
+    static const bool isQuantized = false;
+};
+
+template <class Scalar>
+struct EclEpsScalingPointsStorage<EclEpsQuantized<Scalar> >
+{
+    typedef EclEpsQuantizedScalingPoints<Scalar> type;
+    typedef EclEpsQuantizationScales<Scalar> Scales;
+    static const bool isQuantized = true;
+};
+
+} // namespace Opm
+
+#endif
@@ -47,6 +47,7 @@
 
 #include <array>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <cassert>
 #include <algorithm>
@@ -56,7 +57,10 @@ namespace Opm {
  * \brief Collects all grid properties which are relevant for end point scaling.
  *
  * This class is used for both, the drainage and the imbibition variants of the ECL
- * keywords.
+ * keywords. The arrays are either the global ones of the EclipseState, which are
+ * indexed by the cartesian index of a cell, or arrays which only contain the elements
+ * of the local process (see EclMaterialLawManager::initFromElementProperties()). A
+ * nullptr indicates that a property is not specified.
  */
 class EclEpsGridProperties
 {
@@ -64,6 +68,16 @@ class EclEpsGridProperties
     typedef std::vector<double> DoubleData;
 
 public:
+    EclEpsGridProperties()
+        : satnum(nullptr)
+        , swl(nullptr), sgl(nullptr)
+        , swcr(nullptr), sgcr(nullptr), sowcr(nullptr), sogcr(nullptr)
+        , swu(nullptr), sgu(nullptr)
+        , pcw(nullptr), pcg(nullptr)
+        , krw(nullptr), kro(nullptr), krg(nullptr)
+        , poro(nullptr), permx(nullptr), permy(nullptr), permz(nullptr)
+    {}
+
 #if HAVE_OPM_PARSER
     void initFromDeck(const Opm::Deck& /* deck */,
                       const Opm::EclipseState& eclState,
@@ -186,6 +200,34 @@ struct EclEpsScalingPointsInfo
     Scalar maxKrog; // maximum relative permability of oil in the gas-oil system
     Scalar maxKrg; // maximum relative permability of gas
 
+    /*!
+     * \brief Returns true if all values of two scaling point infos are identical.
+     */
+    bool operator==(const EclEpsScalingPointsInfo<Scalar>& data) const
+    {
+        return
+            Swl == data.Swl &&
+            Sgl == data.Sgl &&
+            Sowl == data.Sowl &&
+            Sogl == data.Sogl &&
+            Swcr == data.Swcr &&
+            Sgcr == data.Sgcr &&
+            Sowcr == data.Sowcr &&
+            Sogcr == data.Sogcr &&
+            Swu == data.Swu &&
+            Sgu == data.Sgu &&
+            Sowu == data.Sowu &&
+            Sogu == data.Sogu &&
+            maxPcow == data.maxPcow &&
+            maxPcgo == data.maxPcgo &&
+            pcowLeverettFactor == data.pcowLeverettFactor &&
+            pcgoLeverettFactor == data.pcgoLeverettFactor &&
+            maxKrw == data.maxKrw &&
+            maxKrow == data.maxKrow &&
+            maxKrog == data.maxKrog &&
+            maxKrg == data.maxKrg;
+    }
+
     void print() const
     {
         std::cout << "    Swl: " << Swl << "\n"
@@ -221,6 +263,11 @@ struct EclEpsScalingPointsInfo
                          const Opm::EclipseState& eclState,
                          unsigned satRegionIdx)
     {
+        // there are no "unscaled" Leverett factors, so we just set them to 1.0. this
+        // needs to be done before the two-phase cases return early.
+        pcowLeverettFactor = 1.0;
+        pcgoLeverettFactor = 1.0;
+
         // TODO: support for the SOF2/SOF3 keyword family
         const auto& tables = eclState.getTableManager();
         const TableContainer&  swofTables = tables.getSwofTables();
@@ -285,10 +332,6 @@ struct EclEpsScalingPointsInfo
         else {
             throw std::domain_error("No valid saturation keyword family specified");
         }
-
-        // there are no "unscaled" Leverett factors, so we just set them to 1.0
-        pcowLeverettFactor = 1.0;
-        pcgoLeverettFactor = 1.0;
     }
 
     /*!
@@ -321,74 +364,162 @@ struct EclEpsScalingPointsInfo
         extractGridPropertyValue_(maxKrow, epsProperties.kro, cartesianCellIdx);
         extractGridPropertyValue_(maxKrog, epsProperties.kro, cartesianCellIdx);
 
-        // compute the Leverett capillary pressure scaling factors if applicable.  note
-        // that this needs to be done using non-SI units to make it correspond to the
-        // documentation.
         pcowLeverettFactor = 1.0;
         pcgoLeverettFactor = 1.0;
-        if (eclState.getTableManager().useJFunc()) {
-            const auto& jfunc = eclState.getTableManager().getJFunc();
-            const auto& jfuncDir = jfunc.direction();
-
-            Scalar perm;
-            if (jfuncDir == Opm::JFunc::Direction::X)
-                perm =
-                    (*epsProperties.permx)[cartesianCellIdx];
-            else if (jfuncDir == Opm::JFunc::Direction::Y)
-                perm =
-                    (*epsProperties.permy)[cartesianCellIdx];
-            else if (jfuncDir == Opm::JFunc::Direction::Z)
-                perm =
-                    (*epsProperties.permz)[cartesianCellIdx];
-            else if (jfuncDir == Opm::JFunc::Direction::XY)
-                // TODO: verify that this really is the arithmetic mean. (the
-                // documentation just says that the "average" should be used, IMO the
-                // harmonic mean would be more appropriate because that's what's usually
-                // applied when calculating the fluxes.)
-                perm =
-                    Opm::arithmeticMean((*epsProperties.permx)[cartesianCellIdx],
-                                        (*epsProperties.permy)[cartesianCellIdx]);
-            else
-                OPM_THROW(std::runtime_error, "Illegal direction indicator for the JFUNC "
-                          "keyword ("<<static_cast<int>(jfuncDir)<<")");
-
-            // convert permeability from m^2 to mD
-            perm *= 1.01325e15;
-
-            Scalar poro = (*epsProperties.poro)[cartesianCellIdx];
-            Scalar alpha = jfunc.alphaFactor();
-            Scalar beta = jfunc.betaFactor();
-
-            // the part of the Leverett capillary pressure which does not depend on
-            // surface tension.
-            Scalar commonFactor = std::pow(poro, alpha)/std::pow(perm, beta);
-
-            // multiply the documented constant by 10^5 because we want the pressures
-            // in [Pa], not in [bar]
-            const Scalar Uconst = 0.318316 * 1e5;
-
-            // compute the oil-water Leverett factor.
-            const auto& jfuncFlag = jfunc.flag();
-            if (jfuncFlag == Opm::JFunc::Flag::WATER || jfuncFlag == Opm::JFunc::Flag::BOTH) {
-                // note that we use the surface tension in terms of [dyn/cm]
-                Scalar gamma =
-                    jfunc.owSurfaceTension();
-                pcowLeverettFactor = commonFactor*gamma*Uconst;
-            }
+        if (eclState.getTableManager().useJFunc())
+            computeLeverettFactors_(eclState, epsProperties, cartesianCellIdx);
+    }
 
-            // compute the gas-oil Leverett factor.
-            if (jfuncFlag == Opm::JFunc::Flag::GAS || jfuncFlag == Opm::JFunc::Flag::BOTH) {
-                // note that we use the surface tension in terms of [dyn/cm]
-                Scalar gamma =
-                    jfunc.goSurfaceTension();
-                pcgoLeverettFactor = commonFactor*gamma*Uconst;
-            }
+    /*!
+     * \brief Extract the values of the scaled scaling parameters for a range of
+     *        elements.
+     *
+     * This is equivalent to calling extractScaled() for each object, but the grid
+     * properties are processed one at a time for all elements, which is considerably
+     * more cache friendly than gathering all properties of one element after the other.
+     * The objects must already contain the unscaled values of the saturation region
+     * of the respective element, and propertyIdx(i) must return the index of the i-th
+     * object in the arrays of the grid properties.
+     */
+    template <class PropertyIndexFunction>
+    static void extractScaled(std::vector<EclEpsScalingPointsInfo<Scalar> >& infos,
+                              const Opm::EclipseState& eclState,
+                              const EclEpsGridProperties& epsProperties,
+                              const PropertyIndexFunction& propertyIdx)
+    {
+        typedef EclEpsScalingPointsInfo<Scalar> Info;
+
+        extractGridPropertyColumn_(infos, &Info::Swl, epsProperties.swl, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::Sgl, epsProperties.sgl, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::Swcr, epsProperties.swcr, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::Sgcr, epsProperties.sgcr, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::Sowcr, epsProperties.sowcr, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::Sogcr, epsProperties.sogcr, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::Swu, epsProperties.swu, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::Sgu, epsProperties.sgu, propertyIdx);
+
+        extractGridPropertyColumn_(infos, &Info::maxPcow, epsProperties.pcw, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::maxPcgo, epsProperties.pcg, propertyIdx);
+
+        extractGridPropertyColumn_(infos, &Info::maxKrw, epsProperties.krw, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::maxKrg, epsProperties.krg, propertyIdx);
+
+        // quite likely that's wrong!
+        extractGridPropertyColumn_(infos, &Info::maxKrow, epsProperties.kro, propertyIdx);
+        extractGridPropertyColumn_(infos, &Info::maxKrog, epsProperties.kro, propertyIdx);
+
+        const bool useJFunc = eclState.getTableManager().useJFunc();
+
+        // exceptions must not escape from the parallel loop, so the input of the
+        // Leverett factors is checked beforehand
+        if (useJFunc)
+            checkLeverettInput_(eclState, epsProperties);
+
+        const unsigned numInfos = static_cast<unsigned>(infos.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (unsigned i = 0; i < numInfos; ++i) {
+            Info& info = infos[i];
+            info.pcowLeverettFactor = 1.0;
+            info.pcgoLeverettFactor = 1.0;
+            if (useJFunc)
+                info.computeLeverettFactors_(eclState, epsProperties, propertyIdx(i));
         }
     }
 #endif
 
 private:
 #if HAVE_OPM_PARSER
+    // make sure that computeLeverettFactors_() does not throw for any element
+    static void checkLeverettInput_(const Opm::EclipseState& eclState,
+                                    const EclEpsGridProperties& epsProperties)
+    {
+        const auto& jfuncDir = eclState.getTableManager().getJFunc().direction();
+
+        bool havePerm;
+        if (jfuncDir == Opm::JFunc::Direction::X)
+            havePerm = epsProperties.permx != nullptr;
+        else if (jfuncDir == Opm::JFunc::Direction::Y)
+            havePerm = epsProperties.permy != nullptr;
+        else if (jfuncDir == Opm::JFunc::Direction::Z)
+            havePerm = epsProperties.permz != nullptr;
+        else if (jfuncDir == Opm::JFunc::Direction::XY)
+            havePerm = epsProperties.permx != nullptr && epsProperties.permy != nullptr;
+        else
+            OPM_THROW(std::runtime_error, "Illegal direction indicator for the JFUNC "
+                      "keyword ("<<static_cast<int>(jfuncDir)<<")");
+
+        if (!havePerm || epsProperties.poro == nullptr)
+            OPM_THROW(std::runtime_error, "The Leverett capillary pressure scaling requires "
+                      "the porosity and the permeability in the direction specified by the "
+                      "JFUNC keyword");
+    }
+
+    // compute the Leverett capillary pressure scaling factors. note that this needs to
+    // be done using non-SI units to make it correspond to the documentation.
+    void computeLeverettFactors_(const Opm::EclipseState& eclState,
+                                 const EclEpsGridProperties& epsProperties,
+                                 unsigned cartesianCellIdx)
+    {
+        const auto& jfunc = eclState.getTableManager().getJFunc();
+        const auto& jfuncDir = jfunc.direction();
+
+        Scalar perm;
+        if (jfuncDir == Opm::JFunc::Direction::X)
+            perm =
+                (*epsProperties.permx)[cartesianCellIdx];
+        else if (jfuncDir == Opm::JFunc::Direction::Y)
+            perm =
+                (*epsProperties.permy)[cartesianCellIdx];
+        else if (jfuncDir == Opm::JFunc::Direction::Z)
+            perm =
+                (*epsProperties.permz)[cartesianCellIdx];
+        else if (jfuncDir == Opm::JFunc::Direction::XY)
+            // TODO: verify that this really is the arithmetic mean. (the
+            // documentation just says that the "average" should be used, IMO the
+            // harmonic mean would be more appropriate because that's what's usually
+            // applied when calculating the fluxes.)
+            perm =
+                Opm::arithmeticMean((*epsProperties.permx)[cartesianCellIdx],
+                                    (*epsProperties.permy)[cartesianCellIdx]);
+        else
+            OPM_THROW(std::runtime_error, "Illegal direction indicator for the JFUNC "
+                      "keyword ("<<static_cast<int>(jfuncDir)<<")");
+
+        // convert permeability from m^2 to mD
+        perm *= 1.01325e15;
+
+        Scalar poro = (*epsProperties.poro)[cartesianCellIdx];
+        Scalar alpha = jfunc.alphaFactor();
+        Scalar beta = jfunc.betaFactor();
+
+        // the part of the Leverett capillary pressure which does not depend on
+        // surface tension.
+        Scalar commonFactor = std::pow(poro, alpha)/std::pow(perm, beta);
+
+        // multiply the documented constant by 10^5 because we want the pressures
+        // in [Pa], not in [bar]
+        const Scalar Uconst = 0.318316 * 1e5;
+
+        // compute the oil-water Leverett factor.
+        const auto& jfuncFlag = jfunc.flag();
+        if (jfuncFlag == Opm::JFunc::Flag::WATER || jfuncFlag == Opm::JFunc::Flag::BOTH) {
+            // note that we use the surface tension in terms of [dyn/cm]
+            Scalar gamma =
+                jfunc.owSurfaceTension();
+            pcowLeverettFactor = commonFactor*gamma*Uconst;
+        }
+
+        // compute the gas-oil Leverett factor.
+        if (jfuncFlag == Opm::JFunc::Flag::GAS || jfuncFlag == Opm::JFunc::Flag::BOTH) {
+            // note that we use the surface tension in terms of [dyn/cm]
+            Scalar gamma =
+                jfunc.goSurfaceTension();
+            pcgoLeverettFactor = commonFactor*gamma*Uconst;
+        }
+    }
+
     void extractUnscaledSgof_(const Opm::SgofTable& sgofTable)
     {
         // minimum gas and oil-in-gas-oil saturation
@@ -598,6 +729,24 @@ private:
 
         targetValue = (*propData)[cartesianCellIdx];
     }
+
+    template <class PropertyIndexFunction>
+    static void extractGridPropertyColumn_(std::vector<EclEpsScalingPointsInfo<Scalar> >& infos,
+                                           Scalar EclEpsScalingPointsInfo<Scalar>::*target,
+                                           const std::vector<double>* propData,
+                                           const PropertyIndexFunction& propertyIdx)
+    {
+        if (!propData)
+            return;
+
+        const std::vector<double>& data = *propData;
+        const unsigned numInfos = static_cast<unsigned>(infos.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (unsigned i = 0; i < numInfos; ++i)
+            infos[i].*target = data[propertyIdx(i)];
+    }
 };
 
 /*!
@@ -612,8 +761,12 @@ class EclEpsScalingPoints
 public:
     /*!
      * \brief Assigns the scaling points which actually ought to be used.
+     *
+     * The scalar type of the info object may differ from the one used to store the
+     * scaling points, e.g., if the points are stored using single precision.
      */
-    void init(const EclEpsScalingPointsInfo<Scalar>& epsInfo,
+    template <class InfoScalar>
+    void init(const EclEpsScalingPointsInfo<InfoScalar>& epsInfo,
               const EclEpsConfig& config,
               EclTwoPhaseSystemType epsSystemType)
     {
@@ -28,11 +28,18 @@
 #define OPM_ECL_EPS_TWO_PHASE_LAW_HPP
 
 #include "EclEpsTwoPhaseLawParams.hpp"
+#include "MaterialLawCombinedEvaluation.hpp"
 
 #include <opm/material/fluidstates/SaturationOverlayFluidState.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
 namespace Opm {
 /*!
  * \ingroup FluidMatrixInteractions
@@ -44,9 +51,15 @@ namespace Opm {
  * and produce unscaled quantities. This class implements the "impedance adaption" layer
  * between the two worlds. The basic purpose of it is thus the same as the one of \a
  * EffToAbsLaw, but it is quite a bit more complex.
+ *
+ * If enableScaling is false, the layer is compiled as a pass-through: All curves are
+ * then directly evaluated by the effective law using its unscaled parameters and the
+ * configuration of the parameter object is not looked at. This corresponds to a deck
+ * which does not use the ENDSCALE keyword.
  */
 template <class EffLawT,
-          class ParamsT = EclEpsTwoPhaseLawParams<EffLawT> >
+          class ParamsT = EclEpsTwoPhaseLawParams<EffLawT>,
+          bool enableScaling = true>
 class EclEpsTwoPhaseLaw : public EffLawT::Traits
 {
     typedef EffLawT EffLaw;
@@ -152,14 +165,68 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& SwScaled)
     {
+        if (!enableScaling)
+            return EffLaw::twoPhaseSatPcnw(params.effectiveLawParams(), SwScaled);
+
+        if (params.hasBakedLawParams())
+            return EffLaw::twoPhaseSatPcnw(params.bakedLawParams(), SwScaled);
+
         const Evaluation& SwUnscaled = scaledToUnscaledSatPc(params, SwScaled);
         const Evaluation& pcUnscaled = EffLaw::twoPhaseSatPcnw(params.effectiveLawParams(), SwUnscaled);
         return unscaledToScaledPcnw_(params, pcUnscaled);
     }
 
+    /*!
+     * \brief The capillary pressure and the relative permeabilities at a given
+     *        wetting phase saturation.
+     *
+     * Only the quantities for which a non-null pointer is passed are computed. If the
+     * scaling has been baked or if the saturations are not scaled, all curves are
+     * evaluated at the same saturation and the effective law is asked for them in a
+     * single call.
+     */
+    template <class Evaluation>
+    static void twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+                                     Evaluation* krw,
+                                     Evaluation* krn,
+                                     const Params& params,
+                                     const Evaluation& SwScaled)
+    {
+        if (!enableScaling) {
+            Opm::twoPhaseSatPcnwAndKr<EffLaw>(pcnw, krw, krn, params.effectiveLawParams(), SwScaled);
+            return;
+        }
+
+        if (params.hasBakedLawParams()) {
+            Opm::twoPhaseSatPcnwAndKr<EffLaw>(pcnw, krw, krn, params.bakedLawParams(), SwScaled);
+            return;
+        }
+
+        if (!params.config().enableSatScaling()) {
+            Opm::twoPhaseSatPcnwAndKr<EffLaw>(pcnw, krw, krn, params.effectiveLawParams(), SwScaled);
+            if (pcnw)
+                *pcnw = unscaledToScaledPcnw_(params, *pcnw);
+            if (krw)
+                *krw = unscaledToScaledKrw_(params, *krw);
+            if (krn)
+                *krn = unscaledToScaledKrn_(params, *krn);
+            return;
+        }
+
+        if (pcnw)
+            *pcnw = twoPhaseSatPcnw(params, SwScaled);
+        if (krw)
+            *krw = twoPhaseSatKrw(params, SwScaled);
+        if (krn)
+            *krn = twoPhaseSatKrn(params, SwScaled);
+    }
+
     template <class Evaluation>
     static Evaluation twoPhaseSatPcnwInv(const Params& params, const Evaluation& pcnwScaled)
     {
+        if (!enableScaling)
+            return EffLaw::twoPhaseSatPcnwInv(params.effectiveLawParams(), pcnwScaled);
+
         Evaluation pcnwUnscaled = scaledToUnscaledPcnw_(params, pcnwScaled);
         Evaluation SwUnscaled = EffLaw::twoPhaseSatPcnwInv(params.effectiveLawParams(), pcnwUnscaled);
         return unscaledToScaledSatPc(params, SwUnscaled);
@@ -230,6 +297,12 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatKrw(const Params& params, const Evaluation& SwScaled)
     {
+        if (!enableScaling)
+            return EffLaw::twoPhaseSatKrw(params.effectiveLawParams(), SwScaled);
+
+        if (params.hasBakedLawParams())
+            return EffLaw::twoPhaseSatKrw(params.bakedLawParams(), SwScaled);
+
         const Evaluation& SwUnscaled = scaledToUnscaledSatKrw(params, SwScaled);
         const Evaluation& krwUnscaled = EffLaw::twoPhaseSatKrw(params.effectiveLawParams(), SwUnscaled);
         return unscaledToScaledKrw_(params, krwUnscaled);
@@ -238,6 +311,9 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatKrwInv(const Params& params, const Evaluation& krwScaled)
     {
+        if (!enableScaling)
+            return EffLaw::twoPhaseSatKrwInv(params.effectiveLawParams(), krwScaled);
+
         Evaluation krwUnscaled = scaledToUnscaledKrw_(params, krwScaled);
         Evaluation SwUnscaled = EffLaw::twoPhaseSatKrwInv(params.effectiveLawParams(), krwUnscaled);
         return unscaledToScaledSatKrw(params, SwUnscaled);
@@ -256,6 +332,12 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatKrn(const Params& params, const Evaluation& SwScaled)
     {
+        if (!enableScaling)
+            return EffLaw::twoPhaseSatKrn(params.effectiveLawParams(), SwScaled);
+
+        if (params.hasBakedLawParams())
+            return EffLaw::twoPhaseSatKrn(params.bakedLawParams(), SwScaled);
+
         const Evaluation& SwUnscaled = scaledToUnscaledSatKrn(params, SwScaled);
         const Evaluation& krnUnscaled = EffLaw::twoPhaseSatKrn(params.effectiveLawParams(), SwUnscaled);
         return unscaledToScaledKrn_(params, krnUnscaled);
@@ -264,6 +346,9 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatKrnInv(const Params& params, const Evaluation& krnScaled)
     {
+        if (!enableScaling)
+            return EffLaw::twoPhaseSatKrnInv(params.effectiveLawParams(), krnScaled);
+
         Evaluation krnUnscaled = scaledToUnscaledKrn_(params, krnScaled);
         Evaluation SwUnscaled = EffLaw::twoPhaseSatKrnInv(params.effectiveLawParams(), krnUnscaled);
         return unscaledToScaledSatKrn(params, SwUnscaled);
@@ -277,7 +362,7 @@ public:
     template <class Evaluation>
     static Evaluation scaledToUnscaledSatPc(const Params& params, const Evaluation& SwScaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!enableScaling || !params.config().enableSatScaling())
             return SwScaled;
 
         // the saturations of capillary pressure are always scaled using two-point
@@ -290,7 +375,7 @@ public:
     template <class Evaluation>
     static Evaluation unscaledToScaledSatPc(const Params& params, const Evaluation& SwUnscaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!enableScaling || !params.config().enableSatScaling())
             return SwUnscaled;
 
         // the saturations of capillary pressure are always scaled using two-point
@@ -307,7 +392,7 @@ public:
     template <class Evaluation>
     static Evaluation scaledToUnscaledSatKrw(const Params& params, const Evaluation& SwScaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!enableScaling || !params.config().enableSatScaling())
             return SwScaled;
 
         if (params.config().enableThreePointKrSatScaling()) {
@@ -325,7 +410,7 @@ public:
     template <class Evaluation>
     static Evaluation unscaledToScaledSatKrw(const Params& params, const Evaluation& SwUnscaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!enableScaling || !params.config().enableSatScaling())
             return SwUnscaled;
 
         if (params.config().enableThreePointKrSatScaling()) {
@@ -347,7 +432,7 @@ public:
     template <class Evaluation>
     static Evaluation scaledToUnscaledSatKrn(const Params& params, const Evaluation& SwScaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!enableScaling || !params.config().enableSatScaling())
             return SwScaled;
 
         if (params.config().enableThreePointKrSatScaling())
@@ -364,7 +449,7 @@ public:
     template <class Evaluation>
     static Evaluation unscaledToScaledSatKrn(const Params& params, const Evaluation& SwUnscaled)
     {
-        if (!params.config().enableSatScaling())
+        if (!enableScaling || !params.config().enableSatScaling())
             return SwUnscaled;
 
         if (params.config().enableThreePointKrSatScaling()) {
@@ -379,7 +464,132 @@ public:
         }
     }
 
+    /*!
+     * \brief Pre-compute the scaled capillary pressure and relative permeability curves.
+     *
+     * This requires the effective law to be based on sampling points, e.g.,
+     * PiecewiseLinearTwoPhaseMaterial. Since all transformations of the end-point scaling
+     * are piecewise linear, the curves of the scaled law are represented exactly by a
+     * table which contains the scaled sampling points of the effective law plus the
+     * kinks of the saturation scaling. If the scaling cannot be inverted or if the
+     * layer is compiled as a pass-through, nothing is baked and false is returned.
+     */
+    static bool bakeScaling(Params& params)
+    {
+        typedef typename EffLaw::Params EffLawParams;
+
+        params.setBakedLawParams(nullptr);
+        if (!enableScaling)
+            return false;
+
+        const Params& constParams = params;
+        const auto& effParams = constParams.effectiveLawParams();
+        const auto& scaledPoints = constParams.scaledPoints();
+        auto bakedParams = std::make_shared<EffLawParams>();
+        std::vector<Scalar> SwValues;
+        std::vector<Scalar> values;
+
+        if (!bakeCurve_(SwValues, values, constParams, PcCurve,
+                        effParams.SwPcwnSamples(), scaledPoints.saturationPcPoints()))
+            return false;
+        bakedParams->setPcnwSamples(SwValues, values);
+
+        if (!bakeCurve_(SwValues, values, constParams, KrwCurve,
+                        effParams.SwKrwSamples(), scaledPoints.saturationKrwPoints()))
+            return false;
+        bakedParams->setKrwSamples(SwValues, values);
+
+        if (!bakeCurve_(SwValues, values, constParams, KrnCurve,
+                        effParams.SwKrnSamples(), scaledPoints.saturationKrnPoints()))
+            return false;
+        bakedParams->setKrnSamples(SwValues, values);
+
+        bakedParams->finalize();
+        params.setBakedLawParams(bakedParams);
+        return true;
+    }
+
 private:
+    enum BakedCurve { PcCurve, KrwCurve, KrnCurve };
+
+    static Scalar unscaledToScaledSat_(const Params& params, BakedCurve curve, Scalar SwUnscaled)
+    {
+        switch (curve) {
+        case PcCurve: return unscaledToScaledSatPc(params, SwUnscaled);
+        case KrwCurve: return unscaledToScaledSatKrw(params, SwUnscaled);
+        default: return unscaledToScaledSatKrn(params, SwUnscaled);
+        }
+    }
+
+    static Scalar scaledToUnscaledSat_(const Params& params, BakedCurve curve, Scalar SwScaled)
+    {
+        switch (curve) {
+        case PcCurve: return scaledToUnscaledSatPc(params, SwScaled);
+        case KrwCurve: return scaledToUnscaledSatKrw(params, SwScaled);
+        default: return scaledToUnscaledSatKrn(params, SwScaled);
+        }
+    }
+
+    static Scalar evalCurve_(const Params& params, BakedCurve curve, Scalar SwScaled)
+    {
+        switch (curve) {
+        case PcCurve: return twoPhaseSatPcnw(params, SwScaled);
+        case KrwCurve: return twoPhaseSatKrw(params, SwScaled);
+        default: return twoPhaseSatKrn(params, SwScaled);
+        }
+    }
+
+    template <class SamplesContainer, class PointsContainer>
+    static bool bakeCurve_(std::vector<Scalar>& SwScaledValues,
+                           std::vector<Scalar>& values,
+                           const Params& params,
+                           BakedCurve curve,
+                           const SamplesContainer& SwUnscaledSamples,
+                           const PointsContainer& scaledSats)
+    {
+        const Scalar tolerance = 1e3*std::numeric_limits<Scalar>::epsilon();
+
+        SwScaledValues.clear();
+        for (size_t sampleIdx = 0; sampleIdx < SwUnscaledSamples.size(); ++ sampleIdx) {
+            Scalar SwUnscaled = SwUnscaledSamples[sampleIdx];
+            Scalar SwScaled = unscaledToScaledSat_(params, curve, SwUnscaled);
+
+            // the saturation scaling must be strictly monotonically increasing and
+            // invertible for the table to be exact
+            if (!std::isfinite(SwScaled))
+                return false;
+            if (!SwScaledValues.empty() && !(SwScaled > SwScaledValues.back()))
+                return false;
+            if (!(std::abs(scaledToUnscaledSat_(params, curve, SwScaled) - SwUnscaled) <= tolerance))
+                return false;
+
+            SwScaledValues.push_back(SwScaled);
+        }
+
+        if (SwScaledValues.size() < 2)
+            return false;
+
+        // the saturation scaling may exhibit kinks at the scaled saturation points
+        if (params.config().enableSatScaling()) {
+            for (size_t pointIdx = 0; pointIdx < scaledSats.size(); ++ pointIdx) {
+                Scalar SwScaled = scaledSats[pointIdx];
+                if (!(SwScaled > SwScaledValues.front() && SwScaled < SwScaledValues.back()))
+                    continue;
+
+                auto it = std::lower_bound(SwScaledValues.begin(), SwScaledValues.end(), SwScaled);
+                if (*it != SwScaled)
+                    SwScaledValues.insert(it, SwScaled);
+            }
+        }
+
+        // the values at the sampling points are evaluated using the regular code path
+        values.resize(SwScaledValues.size());
+        for (size_t sampleIdx = 0; sampleIdx < SwScaledValues.size(); ++ sampleIdx)
+            values[sampleIdx] = evalCurve_(params, curve, SwScaledValues[sampleIdx]);
+
+        return true;
+    }
+
     template <class Evaluation, class PointsContainer>
     static Evaluation scaledToUnscaledSatTwoPoint_(const Evaluation& scaledSat,
                                                    const PointsContainer& unscaledSats,
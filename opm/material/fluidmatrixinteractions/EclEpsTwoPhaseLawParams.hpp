@@ -29,6 +29,7 @@
 
 #include "EclEpsConfig.hpp"
 #include "EclEpsScalingPoints.hpp"
+#include "EclEpsQuantizedScalingPoints.hpp"
 
 #if HAVE_OPM_PARSER
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -40,6 +41,7 @@
 #include <cassert>
 #include <algorithm>
 
+#include <opm/material/common/BinarySerialization.hpp>
 #include <opm/material/common/EnsureFinalized.hpp>
 
 namespace Opm {
@@ -48,8 +50,16 @@ namespace Opm {
  *
  * \brief A default implementation of the parameters for the material law adapter class
  *        which implements ECL endpoint scaleing .
+ *
+ * The scaling points are stored using the ScalingPointsScalarT type, which may be
+ * float to reduce the memory required for each element. If it is
+ * EclEpsQuantized<Scalar>, the points are stored as 16 bit fixed point numbers (see
+ * EclEpsQuantizedScalingPoints) and decoded whenever they are accessed. The configuration and the
+ * scaled points are stored by value because they are consulted by every evaluation
+ * and this avoids chasing a pointer for them.
  */
-template <class EffLawT>
+template <class EffLawT,
+          class ScalingPointsScalarT = typename EffLawT::Params::Traits::Scalar>
 class EclEpsTwoPhaseLawParams : public EnsureFinalized
 {
     typedef typename EffLawT::Params EffLawParams;
@@ -57,7 +67,7 @@ class EclEpsTwoPhaseLawParams : public EnsureFinalized
 
 public:
     typedef typename EffLawParams::Traits Traits;
-    typedef Opm::EclEpsScalingPoints<Scalar> ScalingPoints;
+    typedef typename Opm::EclEpsScalingPointsStorage<ScalingPointsScalarT>::type ScalingPoints;
 
     EclEpsTwoPhaseLawParams()
     {
@@ -70,8 +80,7 @@ public:
     void finalize()
     {
 #ifndef NDEBUG
-        assert(config_);
-        if (config_->enableSatScaling()) {
+        if (config_.enableSatScaling()) {
             assert(unscaledPoints_);
         }
         assert(effectiveLawParams_);
@@ -81,21 +90,24 @@ public:
 
     /*!
      * \brief Set the endpoint scaling configuration object.
+     *
+     * The configuration is copied, i.e., later modifications of the object do not
+     * affect the parameters.
      */
     void setConfig(std::shared_ptr<EclEpsConfig> value)
-    { config_ = value; }
+    { config_ = *value; bakedLawParams_.reset(); }
 
     /*!
      * \brief Returns the endpoint scaling configuration object.
      */
     const EclEpsConfig& config() const
-    { return *config_; }
+    { return config_; }
 
     /*!
      * \brief Set the scaling points which are seen by the nested material law
      */
     void setUnscaledPoints(std::shared_ptr<ScalingPoints> value)
-    { unscaledPoints_ = value; }
+    { unscaledPoints_ = value; bakedLawParams_.reset(); }
 
     /*!
      * \brief Returns the scaling points which are seen by the nested material law
@@ -107,7 +119,7 @@ public:
      * \brief Set the scaling points which are seen by the physical model
      */
     void setScaledPoints(std::shared_ptr<ScalingPoints> value)
-    { scaledPoints_ = *value; }
+    { scaledPoints_ = *value; bakedLawParams_.reset(); }
 
     /*!
      * \brief Returns the scaling points which are seen by the physical model
@@ -117,15 +129,17 @@ public:
 
     /*!
      * \brief Returns the scaling points which are seen by the physical model
+     *
+     * Since the returned points may be modified, this drops the baked parameter object.
      */
     ScalingPoints& scaledPoints()
-    { return scaledPoints_; }
+    { bakedLawParams_.reset(); return scaledPoints_; }
 
     /*!
      * \brief Sets the parameter object for the effective/nested material law.
      */
     void setEffectiveLawParams(std::shared_ptr<EffLawParams> value)
-    { effectiveLawParams_ = value; }
+    { effectiveLawParams_ = value; bakedLawParams_.reset(); }
 
     /*!
      * \brief Returns the parameter object for the effective/nested material law.
@@ -133,10 +147,67 @@ public:
     const EffLawParams& effectiveLawParams() const
     { return *effectiveLawParams_; }
 
+    /*!
+     * \brief Sets a parameter object for the effective law which already includes the
+     *        end-point scaling.
+     *
+     * If such an object is present, the scaled curves are directly evaluated using it.
+     * It is dropped as soon as any of the quantities which are relevant for the scaling
+     * is changed.
+     */
+    void setBakedLawParams(std::shared_ptr<EffLawParams> value)
+    { bakedLawParams_ = value; }
+
+    /*!
+     * \brief Returns true if a parameter object with baked-in end-point scaling is
+     *        present.
+     */
+    bool hasBakedLawParams() const
+    { return static_cast<bool>(bakedLawParams_); }
+
+    /*!
+     * \brief Returns the parameter object with baked-in end-point scaling.
+     */
+    const EffLawParams& bakedLawParams() const
+    { return *bakedLawParams_; }
+
+    /*!
+     * \brief Write the finalized parameters to a binary blob.
+     *
+     * The nested objects are written as shared objects, i.e., objects which are used by
+     * several parameter objects are only stored once. Since the material law manager
+     * does not set up the curves of phases which are not present, the parameters may be
+     * incomplete.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.writeShared(effectiveLawParams_);
+        writer.writeShared(bakedLawParams_);
+        config_.serialize(writer);
+        writer.writeShared(unscaledPoints_);
+        writer.writeObject(scaledPoints_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.readShared(effectiveLawParams_);
+        reader.readShared(bakedLawParams_);
+        config_.deserialize(reader);
+        reader.readShared(unscaledPoints_);
+        reader.readObject(scaledPoints_);
+
+        if (effectiveLawParams_)
+            EnsureFinalized::finalize();
+    }
+
 private:
     std::shared_ptr<EffLawParams> effectiveLawParams_;
+    std::shared_ptr<EffLawParams> bakedLawParams_;
 
-    std::shared_ptr<EclEpsConfig> config_;
+    EclEpsConfig config_;
     std::shared_ptr<ScalingPoints> unscaledPoints_;
     ScalingPoints scaledPoints_;
 };
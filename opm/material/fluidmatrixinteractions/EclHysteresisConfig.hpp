@@ -34,6 +34,8 @@
 #include <opm/parser/eclipse/Deck/DeckItem.hpp>
 #endif
 
+#include <opm/material/common/BinarySerialization.hpp>
+
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 
@@ -163,6 +165,26 @@ public:
     }
 #endif
 
+    /*!
+     * \brief Write the configuration to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(enableHysteresis_);
+        writer.write(pcHysteresisModel_);
+        writer.write(krHysteresisModel_);
+    }
+
+    /*!
+     * \brief Restore the configuration which was written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(enableHysteresis_);
+        reader.read(pcHysteresisModel_);
+        reader.read(krHysteresisModel_);
+    }
+
 private:
     // enable hysteresis at all
     bool enableHysteresis_;
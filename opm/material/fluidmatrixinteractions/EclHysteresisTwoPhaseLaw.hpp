@@ -28,15 +28,27 @@
 #define OPM_ECL_HYSTERESIS_TWO_PHASE_LAW_HPP
 
 #include "EclHysteresisTwoPhaseLawParams.hpp"
+#include "MaterialLawCombinedEvaluation.hpp"
+
+#include <opm/material/common/Tracing.hpp>
+
+#include <cstddef>
+#include <vector>
 
 namespace Opm {
 /*!
  * \ingroup FluidMatrixInteractions
  *
  * \brief This material law implements the hysteresis model of the ECL file format
+ *
+ * If enableHysteresis is false, the layer is compiled as a pass-through which always
+ * uses the drainage curves without looking at the configuration of the parameter
+ * object. This corresponds to a deck which does not specify the HYSTER option of the
+ * SATOPTS keyword.
  */
 template <class EffectiveLawT,
-          class ParamsT = EclHysteresisTwoPhaseLawParams<EffectiveLawT> >
+          class ParamsT = EclHysteresisTwoPhaseLawParams<EffectiveLawT>,
+          bool enableHysteresis = true>
 class EclHysteresisTwoPhaseLaw : public EffectiveLawT::Traits
 {
 public:
@@ -148,6 +160,8 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& Sw)
     {
+        OPM_MATERIAL_TRACE_SCOPE("EclHysteresisTwoPhaseLaw::twoPhaseSatPcnw");
+
         // TODO: capillary pressure hysteresis
         return EffectiveLaw::twoPhaseSatPcnw(params.drainageParams(), Sw);
 /*
@@ -164,6 +178,43 @@ public:
 */
     }
 
+    /*!
+     * \brief The capillary pressure and the relative permeabilities at a given
+     *        wetting phase saturation.
+     *
+     * Only the quantities for which a non-null pointer is passed are computed. The
+     * capillary pressure always uses the drainage curve, so if all requested relative
+     * permeabilities use it as well, the effective law is asked for all quantities
+     * in a single call.
+     */
+    template <class Evaluation>
+    static void twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+                                     Evaluation* krw,
+                                     Evaluation* krn,
+                                     const Params& params,
+                                     const Evaluation& Sw)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclHysteresisTwoPhaseLaw::twoPhaseSatPcnwAndKr");
+
+        bool krDrainage =
+            !enableHysteresis
+            || !params.config().enableHysteresis()
+            || params.config().krHysteresisModel() < 0
+            || ((!krw || Sw <= params.krwSwMdc()) && (!krn || Sw <= params.krnSwMdc()));
+
+        if (krDrainage) {
+            Opm::twoPhaseSatPcnwAndKr<EffectiveLaw>(pcnw, krw, krn, params.drainageParams(), Sw);
+            return;
+        }
+
+        if (pcnw)
+            *pcnw = twoPhaseSatPcnw(params, Sw);
+        if (krw)
+            *krw = twoPhaseSatKrw(params, Sw);
+        if (krn)
+            *krn = twoPhaseSatKrn(params, Sw);
+    }
+
     /*!
      * \brief The saturation-capillary pressure curves.
      */
@@ -236,9 +287,12 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatKrw(const Params& params, const Evaluation& Sw)
     {
+        OPM_MATERIAL_TRACE_SCOPE("EclHysteresisTwoPhaseLaw::twoPhaseSatKrw");
 
         // if no relperm hysteresis is enabled, use the drainage curve
-        if (!params.config().enableHysteresis() || params.config().krHysteresisModel() < 0)
+        if (!enableHysteresis
+            || !params.config().enableHysteresis()
+            || params.config().krHysteresisModel() < 0)
             return EffectiveLaw::twoPhaseSatKrw(params.drainageParams(), Sw);
 
         // if it is enabled, use either the drainage or the imbibition curve. if the
@@ -264,8 +318,12 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatKrn(const Params& params, const Evaluation& Sw)
     {
+        OPM_MATERIAL_TRACE_SCOPE("EclHysteresisTwoPhaseLaw::twoPhaseSatKrn");
+
         // if no relperm hysteresis is enabled, use the drainage curve
-        if (!params.config().enableHysteresis() || params.config().krHysteresisModel() < 0)
+        if (!enableHysteresis
+            || !params.config().enableHysteresis()
+            || params.config().krHysteresisModel() < 0)
             return EffectiveLaw::twoPhaseSatKrn(params.drainageParams(), Sw);
 
         // if it is enabled, use either the drainage or the imbibition curve. if the
@@ -276,6 +334,103 @@ public:
         return EffectiveLaw::twoPhaseSatKrn(params.imbibitionParams(),
                                             Sw + params.deltaSwImbKrn());
     }
+
+    /*!
+     * \brief The relative permeabilities of both phases for an array of saturations.
+     *
+     * paramsOf(i) must return the parameter object which is used for the i-th
+     * saturation, and only the quantities for which a non-null pointer is passed are
+     * computed. Since the hysteresis state is specific for each element, the values
+     * are first partitioned into the ones which are on the drainage curve and the ones
+     * which are on an imbibition scanning curve. Each group is then evaluated by a loop
+     * which does not need to decide between the curves. The results are identical to
+     * the ones of twoPhaseSatKrw() and twoPhaseSatKrn().
+     */
+    template <class ParamsFunction, class Evaluation>
+    static void twoPhaseSatKrMany(Evaluation* krw,
+                                  Evaluation* krn,
+                                  const ParamsFunction& paramsOf,
+                                  const Evaluation* Sw,
+                                  size_t numValues)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclHysteresisTwoPhaseLaw::twoPhaseSatKrMany");
+
+        if (!enableHysteresis) {
+            for (size_t i = 0; i < numValues; ++i) {
+                if (krw)
+                    krw[i] = EffectiveLaw::twoPhaseSatKrw(paramsOf(i).drainageParams(), Sw[i]);
+                if (krn)
+                    krn[i] = EffectiveLaw::twoPhaseSatKrn(paramsOf(i).drainageParams(), Sw[i]);
+            }
+            return;
+        }
+
+        std::vector<size_t> valueIdx(numValues);
+
+        if (krw) {
+            size_t numDrainage =
+                partitionDrainage_(valueIdx, paramsOf, Sw,
+                                   [](const Params& params) { return params.krwSwMdc(); });
+
+            for (size_t j = 0; j < numDrainage; ++j) {
+                size_t i = valueIdx[j];
+                krw[i] = EffectiveLaw::twoPhaseSatKrw(paramsOf(i).drainageParams(), Sw[i]);
+            }
+
+            for (size_t j = numDrainage; j < numValues; ++j) {
+                size_t i = valueIdx[j];
+                const Params& params = paramsOf(i);
+                krw[i] = EffectiveLaw::twoPhaseSatKrw(params.imbibitionParams(),
+                                                      Sw[i] + params.deltaSwImbKrw());
+            }
+        }
+
+        if (krn) {
+            size_t numDrainage =
+                partitionDrainage_(valueIdx, paramsOf, Sw,
+                                   [](const Params& params) { return params.krnSwMdc(); });
+
+            for (size_t j = 0; j < numDrainage; ++j) {
+                size_t i = valueIdx[j];
+                krn[i] = EffectiveLaw::twoPhaseSatKrn(paramsOf(i).drainageParams(), Sw[i]);
+            }
+
+            for (size_t j = numDrainage; j < numValues; ++j) {
+                size_t i = valueIdx[j];
+                const Params& params = paramsOf(i);
+                krn[i] = EffectiveLaw::twoPhaseSatKrn(params.imbibitionParams(),
+                                                      Sw[i] + params.deltaSwImbKrn());
+            }
+        }
+    }
+
+private:
+    // move the indices of the values which use the drainage curve to the front of
+    // 'valueIdx' and the ones on an imbibition scanning curve to its back. the return
+    // value is the number of values on the drainage curve.
+    template <class ParamsFunction, class Evaluation, class SwMdcFunction>
+    static size_t partitionDrainage_(std::vector<size_t>& valueIdx,
+                                     const ParamsFunction& paramsOf,
+                                     const Evaluation* Sw,
+                                     const SwMdcFunction& swMdc)
+    {
+        size_t numDrainage = 0;
+        size_t scanningBeginIdx = valueIdx.size();
+        for (size_t i = 0; i < valueIdx.size(); ++i) {
+            const Params& params = paramsOf(i);
+            bool drainage =
+                !params.config().enableHysteresis()
+                || params.config().krHysteresisModel() < 0
+                || Sw[i] <= swMdc(params);
+
+            if (drainage)
+                valueIdx[numDrainage++] = i;
+            else
+                valueIdx[--scanningBeginIdx] = i;
+        }
+
+        return numDrainage;
+    }
 };
 } // namespace Opm
 
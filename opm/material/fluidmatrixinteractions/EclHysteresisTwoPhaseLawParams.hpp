@@ -40,6 +40,7 @@
 #include <cassert>
 #include <algorithm>
 
+#include <opm/material/common/BinarySerialization.hpp>
 #include <opm/material/common/EnsureFinalized.hpp>
 
 namespace Opm {
@@ -88,15 +89,18 @@ public:
 
     /*!
      * \brief Set the endpoint scaling configuration object.
+     *
+     * The configuration is copied because it is consulted by every evaluation, i.e.,
+     * later modifications of the object do not affect the parameters.
      */
     void setConfig(std::shared_ptr<EclHysteresisConfig> value)
-    { config_ = value; }
+    { config_ = *value; }
 
     /*!
      * \brief Returns the endpoint scaling configuration object.
      */
     const EclHysteresisConfig& config() const
-    { return *config_; }
+    { return config_; }
 
     /*!
      * \brief Sets the parameters used for the drainage curve
@@ -241,9 +245,10 @@ public:
      * \brief Notify the hysteresis law that a given wetting-phase saturation has been seen
      *
      * This updates the scanning curves and the imbibition<->drainage reversal points as
-     * appropriate.
+     * appropriate. The return value is true if a saturation reversal was detected, i.e.,
+     * if the scanning curves were modified.
      */
-    void update(Scalar pcSw, Scalar /* krwSw */, Scalar krnSw)
+    bool update(Scalar pcSw, Scalar /* krwSw */, Scalar krnSw)
     {
         bool updateParams = false;
         if (pcSw < pcSwMdc_) {
@@ -271,6 +276,43 @@ public:
 
         if (updateParams)
             updateDynamicParams_();
+
+        return updateParams;
+    }
+
+    /*!
+     * \brief Write the finalized parameters including the hysteresis state to a binary
+     *        blob.
+     *
+     * The imbibition curve is only written if hysteresis is enabled.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        config_.serialize(writer);
+        drainageParams_.serialize(writer);
+        if (config().enableHysteresis())
+            imbibitionParams_.serialize(writer);
+        writer.write(krnSwMdc_);
+        writer.write(pcSwMdc_);
+        writer.write(deltaSwImbKrn_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     *
+     * The dependent quantities are restored verbatim instead of being recomputed.
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        config_.deserialize(reader);
+        drainageParams_.deserialize(reader);
+        if (config().enableHysteresis())
+            imbibitionParams_.deserialize(reader);
+        reader.read(krnSwMdc_);
+        reader.read(pcSwMdc_);
+        reader.read(deltaSwImbKrn_);
+
+        EnsureFinalized::finalize();
     }
 
 private:
@@ -307,7 +349,7 @@ private:
 #endif
     }
 
-    std::shared_ptr<EclHysteresisConfig> config_;
+    EclHysteresisConfig config_;
     EffLawParams imbibitionParams_;
     EffLawParams drainageParams_;
 
@@ -36,20 +36,43 @@
 #include <opm/material/fluidmatrixinteractions/EclEpsTwoPhaseLaw.hpp>
 #include <opm/material/fluidmatrixinteractions/EclHysteresisTwoPhaseLaw.hpp>
 #include <opm/material/fluidmatrixinteractions/EclEpsScalingPoints.hpp>
+#include <opm/material/fluidmatrixinteractions/EclEpsQuantizedScalingPoints.hpp>
 #include <opm/material/fluidmatrixinteractions/EclEpsConfig.hpp>
 #include <opm/material/fluidmatrixinteractions/EclHysteresisConfig.hpp>
 #include <opm/material/fluidmatrixinteractions/EclMultiplexerMaterial.hpp>
+#include <opm/material/fluidmatrixinteractions/EclThreePhaseKroTable.hpp>
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
 #include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/FirstTouchArray.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/TableDeduplication.hpp>
+#include <opm/material/common/Tracing.hpp>
+#include <opm/material/common/ValueOnly.hpp>
 
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 
 namespace Opm {
@@ -59,13 +82,56 @@ namespace Opm {
  *
  * \brief Provides an simple way to create and manage the material law objects
  *        for a complete ECL deck.
+ *
+ * If hysteresis is disabled, elements which are located in the same saturation region
+ * and which exhibit identical scaled end points use the same parameter object. Such an
+ * element gets its own copy if its scaling points are modified (e.g. by
+ * applySwatinit()).
+ *
+ * The sampling points of the saturation function tables and the per-element scaling
+ * points are stored using the StorageScalarT type. Setting it to float roughly halves
+ * the memory required for the tables and the scaling points of each element while the
+ * saturation functions are still evaluated using the scalar type of the traits.
+ *
+ * The per-element scaling points may alternatively be stored using the
+ * ScalingPointsStorageT type. If it is EclEpsQuantized<Scalar>, the saturation end
+ * points are stored as 16 bit fixed point numbers and the maxima of the capillary
+ * pressure and the relative permeabilities relative to scales which are shared by all
+ * elements of a saturation region (see EclEpsQuantizedScalingPoints). They are decoded
+ * whenever they are accessed by the saturation functions.
+ *
+ * After initialization, all const methods (and the static methods of the material law
+ * if they are called with the const parameter objects) may be called concurrently by
+ * any number of threads. They do not modify any state and only use scratch objects
+ * which are located on the stack of the calling thread. updateHysteresis() may be
+ * called concurrently for distinct elements because elements do not share their
+ * parameter objects if hysteresis is enabled. All other non-const methods, in
+ * particular applySwatinit(), the set*HysteresisParams() methods,
+ * restoreHysteresisState() and bakeEndPointScaling() must not run concurrently with any
+ * other method of the object.
+ *
+ * If enableEpsLayer or enableHysteresisLayer is false, the corresponding layer of the
+ * two-phase material laws is compiled as a pass-through, i.e., the relative
+ * permeabilities and capillary pressures are evaluated without looking at the
+ * configuration of the end-point scaling or of the hysteresis model. Such a manager can
+ * only be initialized for decks which do not use the respective feature, else an
+ * exception is thrown. dispatchEclMaterialLawManager() selects the slimmest
+ * instantiation which supports a given deck.
  */
-template <class TraitsT>
+template <class TraitsT,
+          class StorageScalarT = typename TraitsT::Scalar,
+          bool enableEpsLayer = true,
+          bool enableHysteresisLayer = true,
+          class ScalingPointsStorageT = StorageScalarT>
 class EclMaterialLawManager
 {
 private:
     typedef TraitsT Traits;
     typedef typename Traits::Scalar Scalar;
+    typedef StorageScalarT StorageScalar;
+    typedef ScalingPointsStorageT ScalingPointsStorage;
+    typedef EclEpsScalingPointsStorage<ScalingPointsStorage> ScalingPointsStorageTraits;
+    typedef typename ScalingPointsStorageTraits::Scales QuantizationScales;
     enum { waterPhaseIdx = Traits::wettingPhaseIdx };
     enum { oilPhaseIdx = Traits::nonWettingPhaseIdx };
     enum { gasPhaseIdx = Traits::gasPhaseIdx };
@@ -75,20 +141,28 @@ private:
     typedef TwoPhaseMaterialTraits<Scalar, waterPhaseIdx, oilPhaseIdx> OilWaterTraits;
 
     // the two-phase material law which is defined on effective (unscaled) saturations
-    typedef PiecewiseLinearTwoPhaseMaterial<GasOilTraits> GasOilEffectiveTwoPhaseLaw;
-    typedef PiecewiseLinearTwoPhaseMaterial<OilWaterTraits> OilWaterEffectiveTwoPhaseLaw;
-    typedef typename GasOilEffectiveTwoPhaseLaw::Params GasOilEffectiveTwoPhaseParams;
-    typedef typename OilWaterEffectiveTwoPhaseLaw::Params OilWaterEffectiveTwoPhaseParams;
+    typedef PiecewiseLinearTwoPhaseMaterialParams<GasOilTraits, StorageScalar> GasOilEffectiveTwoPhaseParams;
+    typedef PiecewiseLinearTwoPhaseMaterialParams<OilWaterTraits, StorageScalar> OilWaterEffectiveTwoPhaseParams;
+    typedef PiecewiseLinearTwoPhaseMaterial<GasOilTraits, GasOilEffectiveTwoPhaseParams> GasOilEffectiveTwoPhaseLaw;
+    typedef PiecewiseLinearTwoPhaseMaterial<OilWaterTraits, OilWaterEffectiveTwoPhaseParams> OilWaterEffectiveTwoPhaseLaw;
 
     // the two-phase material law which is defined on absolute (scaled) saturations
-    typedef EclEpsTwoPhaseLaw<GasOilEffectiveTwoPhaseLaw> GasOilEpsTwoPhaseLaw;
-    typedef EclEpsTwoPhaseLaw<OilWaterEffectiveTwoPhaseLaw> OilWaterEpsTwoPhaseLaw;
+    typedef EclEpsTwoPhaseLaw<GasOilEffectiveTwoPhaseLaw,
+                              EclEpsTwoPhaseLawParams<GasOilEffectiveTwoPhaseLaw, ScalingPointsStorage>,
+                              enableEpsLayer> GasOilEpsTwoPhaseLaw;
+    typedef EclEpsTwoPhaseLaw<OilWaterEffectiveTwoPhaseLaw,
+                              EclEpsTwoPhaseLawParams<OilWaterEffectiveTwoPhaseLaw, ScalingPointsStorage>,
+                              enableEpsLayer> OilWaterEpsTwoPhaseLaw;
     typedef typename GasOilEpsTwoPhaseLaw::Params GasOilEpsTwoPhaseParams;
     typedef typename OilWaterEpsTwoPhaseLaw::Params OilWaterEpsTwoPhaseParams;
 
     // the scaled two-phase material laws with hystersis
-    typedef EclHysteresisTwoPhaseLaw<GasOilEpsTwoPhaseLaw> GasOilTwoPhaseLaw;
-    typedef EclHysteresisTwoPhaseLaw<OilWaterEpsTwoPhaseLaw> OilWaterTwoPhaseLaw;
+    typedef EclHysteresisTwoPhaseLaw<GasOilEpsTwoPhaseLaw,
+                                     EclHysteresisTwoPhaseLawParams<GasOilEpsTwoPhaseLaw>,
+                                     enableHysteresisLayer> GasOilTwoPhaseLaw;
+    typedef EclHysteresisTwoPhaseLaw<OilWaterEpsTwoPhaseLaw,
+                                     EclHysteresisTwoPhaseLawParams<OilWaterEpsTwoPhaseLaw>,
+                                     enableHysteresisLayer> OilWaterTwoPhaseLaw;
     typedef typename GasOilTwoPhaseLaw::Params GasOilTwoPhaseHystParams;
     typedef typename OilWaterTwoPhaseLaw::Params OilWaterTwoPhaseHystParams;
 
@@ -97,52 +171,110 @@ public:
     typedef EclMultiplexerMaterial<Traits, GasOilTwoPhaseLaw, OilWaterTwoPhaseLaw> MaterialLaw;
     typedef typename MaterialLaw::Params MaterialLawParams;
 
+    // the type of the objects which store the end-point scaling points
+    typedef typename ScalingPointsStorageTraits::type ScalingPoints;
+
 private:
     // internal typedefs
     typedef std::vector<std::shared_ptr<GasOilEffectiveTwoPhaseParams> > GasOilEffectiveParamVector;
     typedef std::vector<std::shared_ptr<OilWaterEffectiveTwoPhaseParams> > OilWaterEffectiveParamVector;
-    typedef std::vector<std::shared_ptr<EclEpsScalingPoints<Scalar> > > GasOilScalingPointsVector;
-    typedef std::vector<std::shared_ptr<EclEpsScalingPoints<Scalar> > > OilWaterScalingPointsVector;
+    typedef std::vector<std::shared_ptr<ScalingPoints> > GasOilScalingPointsVector;
+    typedef std::vector<std::shared_ptr<ScalingPoints> > OilWaterScalingPointsVector;
     typedef std::vector<std::shared_ptr<EclEpsScalingPointsInfo<Scalar> > > GasOilScalingInfoVector;
     typedef std::vector<std::shared_ptr<EclEpsScalingPointsInfo<Scalar> > > OilWaterScalingInfoVector;
+    typedef std::vector<std::shared_ptr<EclEpsScalingPointsInfo<Scalar> > > ScalingInfoVector;
     typedef std::vector<std::shared_ptr<GasOilTwoPhaseHystParams> > GasOilParamVector;
     typedef std::vector<std::shared_ptr<OilWaterTwoPhaseHystParams> > OilWaterParamVector;
     typedef std::vector<std::shared_ptr<MaterialLawParams> > MaterialLawParamsVector;
+    typedef std::vector<std::shared_ptr<QuantizationScales> > QuantizationScalesVector;
 
 public:
+    /*!
+     * \brief The dynamic hysteresis state of all elements.
+     *
+     * Each quantity is stored in a separate array which is indexed by the element.
+     */
+    struct HysteresisState
+    {
+        std::vector<Scalar> oilWaterPcSwMdc;
+        std::vector<Scalar> oilWaterKrnSwMdc;
+        std::vector<Scalar> oilWaterDeltaSwImbKrn;
+
+        std::vector<Scalar> gasOilPcSwMdc;
+        std::vector<Scalar> gasOilKrnSwMdc;
+        std::vector<Scalar> gasOilDeltaSwImbKrn;
+    };
+
     EclMaterialLawManager()
+        : leverettPorosityExponent_(0.0)
     {}
 
+    /*!
+     * \brief Specify the OpenMP thread which is going to work with each element.
+     *
+     * The memory of the per-element objects (the parameters of the material laws
+     * including the hysteresis state and the scaled end points) is written for the
+     * first time by the thread which initializes the element. On systems with several
+     * NUMA nodes, it is thus placed close to this thread. If the simulator later
+     * processes the elements with a different assignment of elements to threads, e.g.,
+     * because its assembly loop is partitioned by the grid, the mapping used by the
+     * assembly should be passed here before calling initFromDeck() or
+     * initFromElementProperties(): Element 'elemIdx' is then initialized by thread
+     * 'threadOfElem[elemIdx] % numThreads'. Without a mapping, the elements are split
+     * into contiguous blocks of equal size, one per thread, like by an OpenMP loop with
+     * static scheduling.
+     */
+    void setElementThreadMapping(const std::vector<unsigned>& threadOfElem)
+    { elemThreadMapping_ = threadOfElem; }
+
     void initFromDeck(const Opm::Deck& deck,
                       const Opm::EclipseState& eclState,
                       const std::vector<int>& compressedToCartesianElemIdx)
-    {
-        // get the number of saturation regions and the number of cells in the deck
-        const size_t numSatRegions = eclState.runspec().tabdims().getNumSatTables();
-        size_t numCompressedElems = compressedToCartesianElemIdx.size();
-
-        // copy the SATNUM grid property. in some cases this is not necessary, but it
-        // should not require much memory anyway...
-        satnumRegionArray_.resize(numCompressedElems);
-        if (eclState.get3DProperties().hasDeckIntGridProperty("SATNUM")) {
-            const auto& satnumRawData = eclState.get3DProperties().getIntGridProperty("SATNUM").getData();
-            for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
-                unsigned cartesianElemIdx = static_cast<unsigned>(compressedToCartesianElemIdx[elemIdx]);
-                satnumRegionArray_[elemIdx] = satnumRawData[cartesianElemIdx] - 1;
-            }
-        }
-        else
-            std::fill(satnumRegionArray_.begin(), satnumRegionArray_.end(), 0);
-
-        readGlobalEpsOptions_(deck, eclState);
-        readGlobalHysteresisOptions_(deck);
-        readGlobalThreePhaseOptions_(deck);
-
-        unscaledEpsInfo_.resize(numSatRegions);
-        for (unsigned satRegionIdx = 0; satRegionIdx < numSatRegions; ++satRegionIdx)
-            unscaledEpsInfo_[satRegionIdx].extractUnscaled(deck, eclState, satRegionIdx);
+    { initFromDeck_(deck, eclState, compressedToCartesianElemIdx, /*isReadRegion=*/std::vector<bool>()); }
 
-        initParamsForElements_(deck, eclState, compressedToCartesianElemIdx, satnumRegionArray_);
+    /*!
+     * \brief Initialize the parameters of the elements of the local process using grid
+     *        properties which have already been distributed.
+     *
+     * In contrast to initFromDeck(), the grid properties for end-point scaling are not
+     * taken from the EclipseState, i.e., its global arrays are neither accessed nor
+     * created by this method. Instead, all arrays of the passed objects must be indexed
+     * by the local element index, and their satnum members must point to the local
+     * SATNUM and IMBNUM arrays (using the one-based region indices of the deck). The
+     * number of local elements is the size of the SATNUM array. Properties which are not
+     * specified by the deck must be nullptr, and the porosity and the permeabilities are
+     * only required if the deck uses the JFUNC keyword. The imbibition properties are only
+     * used if hysteresis is enabled. The deck and the EclipseState are still needed for
+     * the saturation function tables and the global options.
+     */
+    void initFromElementProperties(const Opm::Deck& deck,
+                                   const Opm::EclipseState& eclState,
+                                   const EclEpsGridProperties& epsGridProperties,
+                                   const EclEpsGridProperties& epsImbGridProperties)
+    {
+        if (!epsGridProperties.satnum)
+            OPM_THROW(std::invalid_argument,
+                      "The SATNUM array of the local elements must be specified");
+
+        const auto& satnumData = *epsGridProperties.satnum;
+        satnumRegionArray_.resize(satnumData.size());
+        for (unsigned elemIdx = 0; elemIdx < satnumData.size(); ++elemIdx)
+            satnumRegionArray_[elemIdx] = satnumData[elemIdx] - 1;
+
+        initRegionData_(deck, eclState);
+
+        if (enableHysteresis()
+            && (!epsImbGridProperties.satnum || epsImbGridProperties.satnum->size() != satnumData.size()))
+            OPM_THROW(std::invalid_argument,
+                      "The IMBNUM array of the local elements must be specified if hysteresis is enabled");
+
+        initParamsForElements_(deck,
+                               eclState,
+                               epsGridProperties,
+                               epsImbGridProperties,
+                               static_cast<unsigned>(satnumData.size()),
+                               /*isReadRegion=*/std::vector<bool>(),
+                               [](unsigned elemIdx) { return elemIdx; });
     }
 
     /*!
@@ -157,57 +289,298 @@ public:
                          Scalar pcow,
                          Scalar Sw)
     {
-        auto& elemScaledEpsInfo = *oilWaterScaledEpsInfoDrainage_[elemIdx];
+        Scalar maxPcowFactor = swatinitMaxPcowFactor_(elemIdx, pcow, Sw);
+        if (maxPcowFactor >= 0.0) {
+            // the scaling points of this element are about to be modified, so it
+            // must not share its parameter objects with other elements anymore. its
+            // scaling info stays shared, the factor is stored separately.
+            if (elemParamsAreShared_[elemIdx])
+                makeElemParamsUnique_(elemIdx);
+            allocateMaxPcowMultipliers_();
+
+            scaleMaxPcow_(elemIdx, maxPcowFactor);
+        }
 
-        // TODO: Mixed wettability systems - see ecl kw OPTIONS switch 74
+        return Sw;
+    }
 
-        if (pcow < 0.0)
-            Sw = elemScaledEpsInfo.Swu;
-        else {
+    /*!
+     * \brief Modify the initial condition of all elements according to the SWATINIT
+     *        keyword.
+     *
+     * This is equivalent to calling applySwatinit() for each element, with
+     * 'pcow[elemIdx]' and 'Sw[elemIdx]' being the capillary pressure and the water
+     * saturation of an element. The resulting saturations are written to 'Sw'. The
+     * capillary pressures are evaluated concurrently if OpenMP is available. Only the
+     * elements which share their parameter objects with other elements and need to
+     * be modified are given their own copies, which is done sequentially. The scaling
+     * info of the elements is not copied: the factors by which their maximum
+     * capillary pressure is scaled are kept in a separate per-element array.
+     */
+    void applySwatinit(const std::vector<Scalar>& pcow, std::vector<Scalar>& Sw)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::applySwatinit");
+
+        unsigned numElems = static_cast<unsigned>(materialLawParams_.size());
+        if (pcow.size() != numElems || Sw.size() != numElems)
+            OPM_THROW(std::invalid_argument,
+                      "The capillary pressure and the saturation must be specified for all "
+                      << numElems << " elements");
+
+        // the factors by which the maximum capillary pressure of the elements is scaled.
+        // (negative for the elements which are not modified.)
+        std::vector<Scalar> maxPcowFactor(numElems);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+            maxPcowFactor[elemIdx] = swatinitMaxPcowFactor_(elemIdx, pcow[elemIdx], Sw[elemIdx]);
+
+        bool anyModified = false;
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            if (maxPcowFactor[elemIdx] < 0.0)
+                continue;
+
+            if (elemParamsAreShared_[elemIdx])
+                makeElemParamsUnique_(elemIdx);
+            anyModified = true;
+        }
+        if (anyModified)
+            allocateMaxPcowMultipliers_();
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+            if (maxPcowFactor[elemIdx] >= 0.0)
+                scaleMaxPcow_(elemIdx, maxPcowFactor[elemIdx]);
+    }
 
-            if (Sw <= elemScaledEpsInfo.Swl)
-                Sw = elemScaledEpsInfo.Swl;
-
-            // specify a fluid state which only stores the saturations
-            typedef Opm::SimpleModularFluidState<Scalar,
-                                                 numPhases,
-                                                 /*numComponents=*/0,
-                                                 /*FluidSystem=*/void, /* -> don't care */
-                                                 /*storePressure=*/false,
-                                                 /*storeTemperature=*/false,
-                                                 /*storeComposition=*/false,
-                                                 /*storeFugacity=*/false,
-                                                 /*storeSaturation=*/true,
-                                                 /*storeDensity=*/false,
-                                                 /*storeViscosity=*/false,
-                                                 /*storeEnthalpy=*/false> FluidState;
-            FluidState fs;
-            fs.setSaturation(waterPhaseIdx, Sw);
-            fs.setSaturation(gasPhaseIdx, 0);
-            fs.setSaturation(oilPhaseIdx, 0);
-            Scalar pc[numPhases] = { 0 };
-            MaterialLaw::capillaryPressures(pc, materialLawParams(elemIdx), fs);
-
-            Scalar pcowAtSw = pc[oilPhaseIdx] - pc[waterPhaseIdx];
-            if (pcowAtSw > 0.0) {
-                elemScaledEpsInfo.maxPcow *= pcow/pcowAtSw;
-                auto& elemEclEpsScalingPoints = oilWaterScaledEpsPointsDrainage(elemIdx);
-                elemEclEpsScalingPoints.init(elemScaledEpsInfo, *oilWaterEclEpsConfig_, Opm::EclOilWaterSystem);
+    /*!
+     * \brief Update the Leverett capillary pressure scaling factors after the porosity
+     *        of the elements has changed, e.g., due to rock compaction.
+     *
+     * The Leverett factors are computed once at initialization. Since they are
+     * proportional to the porosity raised to the exponent of the JFUNC keyword, they are
+     * rescaled here instead of re-deriving them from the grid properties.
+     * 'porosity[elemIdx]' is the current porosity of an element. Elements whose porosity
+     * did not change are left alone, the others get their own parameter objects if they
+     * shared them with other elements. The baked tables of the modified elements (see
+     * bakeEndPointScaling()) are recomputed, but the parameters of well connections must
+     * be set up again using initConnectionMaterialLawParams(). The method does nothing
+     * if Leverett scaling is not used and returns the number of modified elements.
+     */
+    unsigned updateLeverettFactors(const std::vector<Scalar>& porosity)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::updateLeverettFactors");
+
+        if (leverettPorosity_.empty())
+            return 0;
+
+        if (porosity.size() != leverettPorosity_.size())
+            OPM_THROW(std::invalid_argument,
+                      "The porosity must be specified for all " << leverettPorosity_.size()
+                      << " elements, got " << porosity.size());
+
+        unsigned numUpdated = 0;
+        for (unsigned elemIdx = 0; elemIdx < porosity.size(); ++elemIdx) {
+            // elements without pore volume do not have a meaningful Leverett factor
+            Scalar oldPorosity = leverettPorosity_[elemIdx];
+            if (porosity[elemIdx] == oldPorosity || !(oldPorosity > 0.0))
+                continue;
+
+            Scalar factor = std::pow(porosity[elemIdx]/oldPorosity, leverettPorosityExponent_);
+            if (elemParamsAreShared_[elemIdx])
+                makeElemParamsUnique_(elemIdx);
+            makeElemEpsInfoUnique_(elemIdx);
+
+            auto& info = *oilWaterScaledEpsInfoDrainage_[elemIdx];
+            info.pcowLeverettFactor *= factor;
+            info.pcgoLeverettFactor *= factor;
+
+            auto& params = *materialLawParams_[elemIdx];
+            switch (params.approach()) {
+            case EclStone1Approach:
+                rescaleLeverettFactors_<EclStone1Approach>(params, factor);
+                break;
+
+            case EclStone2Approach:
+                rescaleLeverettFactors_<EclStone2Approach>(params, factor);
+                break;
+
+            case EclDefaultApproach:
+                rescaleLeverettFactors_<EclDefaultApproach>(params, factor);
+                break;
+
+            case EclTwoPhaseApproach:
+                rescaleLeverettFactors_<EclTwoPhaseApproach>(params, factor);
+                break;
             }
+
+            leverettPorosity_[elemIdx] = porosity[elemIdx];
+            ++numUpdated;
         }
 
-        return Sw;
+        return numUpdated;
+    }
+
+    /*!
+     * \brief Re-read the saturation functions of some saturation regions from the deck
+     *        after they were modified by the schedule.
+     *
+     * Only the tables of the regions in 'satRegionIndices' (zero-based) and the elements
+     * which use them are re-initialized: the elements whose SATNUM region or, if
+     * hysteresis is enabled, whose IMBNUM region is one of them. The remaining elements
+     * and regions keep their parameter objects. The global options of the deck (e.g.,
+     * the three-phase model, end-point scaling and hysteresis) must be the same as for
+     * the initialization, otherwise an exception is thrown. The hysteresis state of the
+     * re-initialized elements, the modifications of their maximum capillary pressure by
+     * SWATINIT and their Leverett porosities (see updateLeverettFactors()) are retained.
+     * The re-initialized elements do not have baked tables, i.e., bakeEndPointScaling()
+     * should be called again if it was used, and the parameters of well connections
+     * must be set up again using initConnectionMaterialLawParams(). The method returns
+     * the number of re-initialized elements.
+     */
+    unsigned updateSatRegionsFromDeck(const Opm::Deck& deck,
+                                      const Opm::EclipseState& eclState,
+                                      const std::vector<int>& compressedToCartesianElemIdx,
+                                      const std::vector<unsigned>& satRegionIndices)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::updateSatRegionsFromDeck");
+
+        const unsigned numElems = static_cast<unsigned>(materialLawParams_.size());
+        if (compressedToCartesianElemIdx.size() != numElems)
+            OPM_THROW(std::invalid_argument,
+                      "The cartesian index must be specified for all " << numElems
+                      << " elements, got " << compressedToCartesianElemIdx.size());
+
+        std::vector<bool> isUpdatedRegion(numSatnumRegions(), false);
+        for (unsigned satRegionIdx : satRegionIndices) {
+            if (satRegionIdx >= numSatnumRegions())
+                OPM_THROW(std::invalid_argument,
+                          "Invalid saturation region " << satRegionIdx << ", the deck specifies "
+                          << numSatnumRegions() << " regions");
+            isUpdatedRegion[satRegionIdx] = true;
+        }
+
+        // the elements which use the tables of the updated regions
+        EclEpsGridProperties epsImbGridProperties;
+        if (enableHysteresis())
+            epsImbGridProperties.initFromDeck(deck, eclState, /*imbibition=*/true);
+
+        std::vector<unsigned> updatedElems;
+        std::vector<int> updatedCartesianElemIdx;
+        std::vector<unsigned> updatedThreadMapping;
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            unsigned cartesianElemIdx = static_cast<unsigned>(compressedToCartesianElemIdx[elemIdx]);
+            bool isUpdated = isUpdatedRegion[static_cast<unsigned>(satnumRegionArray_[elemIdx])];
+            if (!isUpdated && epsImbGridProperties.satnum)
+                isUpdated = isUpdatedRegion[static_cast<unsigned>((*epsImbGridProperties.satnum)[cartesianElemIdx] - 1)];
+            if (!isUpdated)
+                continue;
+
+            updatedElems.push_back(elemIdx);
+            updatedCartesianElemIdx.push_back(compressedToCartesianElemIdx[elemIdx]);
+            if (!elemThreadMapping_.empty())
+                updatedThreadMapping.push_back(elemThreadMapping_[elemIdx]);
+        }
+
+        if (eclState.runspec().tabdims().getNumSatTables() != numSatnumRegions())
+            OPM_THROW(std::runtime_error,
+                      "The number of saturation regions must not change when saturation"
+                      " regions are updated");
+
+        // initialize the updated elements from scratch. only the tables of the updated
+        // regions are read from the deck, the other regions use the existing objects.
+        EclMaterialLawManager updated;
+        updated.setElementThreadMapping(updatedThreadMapping);
+        updated.unscaledEpsInfo_ = unscaledEpsInfo_;
+        updated.gasOilUnscaledPointsVector_ = gasOilUnscaledPointsVector_;
+        updated.oilWaterUnscaledPointsVector_ = oilWaterUnscaledPointsVector_;
+        updated.gasOilEffectiveParamVector_ = gasOilEffectiveParamVector_;
+        updated.oilWaterEffectiveParamVector_ = oilWaterEffectiveParamVector_;
+        updated.initFromDeck_(deck, eclState, updatedCartesianElemIdx, isUpdatedRegion);
+
+        if (updated.numSatnumRegions() != numSatnumRegions()
+            || updated.enableEndPointScaling_ != enableEndPointScaling_
+            || updated.enableHysteresis() != enableHysteresis()
+            || updated.threePhaseApproach_ != threePhaseApproach_
+            || updated.twoPhaseApproach_ != twoPhaseApproach_
+            || updated.storeGasOilParams_ != storeGasOilParams_
+            || updated.storeOilWaterParams_ != storeOilWaterParams_
+            || updated.leverettPorosity_.empty() != leverettPorosity_.empty())
+            OPM_THROW(std::runtime_error,
+                      "The global saturation function options of the deck must not change"
+                      " when saturation regions are updated");
+
+        for (unsigned satRegionIdx = 0; satRegionIdx < numSatnumRegions(); ++satRegionIdx) {
+            if (!isUpdatedRegion[satRegionIdx])
+                continue;
+
+            unscaledEpsInfo_[satRegionIdx] = updated.unscaledEpsInfo_[satRegionIdx];
+            gasOilUnscaledPointsVector_[satRegionIdx] = updated.gasOilUnscaledPointsVector_[satRegionIdx];
+            oilWaterUnscaledPointsVector_[satRegionIdx] = updated.oilWaterUnscaledPointsVector_[satRegionIdx];
+            gasOilEffectiveParamVector_[satRegionIdx] = updated.gasOilEffectiveParamVector_[satRegionIdx];
+            oilWaterEffectiveParamVector_[satRegionIdx] = updated.oilWaterEffectiveParamVector_[satRegionIdx];
+        }
+
+        // the porosities on which the Leverett factors of the updated elements are based
+        // after the update. the new objects use the ones of the deck.
+        std::vector<Scalar> leverettPorosity(leverettPorosity_);
+        for (unsigned i = 0; i < updatedElems.size(); ++i) {
+            unsigned elemIdx = updatedElems[i];
+
+            Scalar owPcSwMdc = 2.0, owKrnSwMdc = 2.0, goPcSwMdc = 2.0, goKrnSwMdc = 2.0;
+            if (enableHysteresis()) {
+                oilWaterHysteresisParams(owPcSwMdc, owKrnSwMdc, elemIdx);
+                gasOilHysteresisParams(goPcSwMdc, goKrnSwMdc, elemIdx);
+            }
+
+            materialLawParams_[elemIdx] = updated.materialLawParams_[i];
+            oilWaterScaledEpsInfoDrainage_[elemIdx] = updated.oilWaterScaledEpsInfoDrainage_[i];
+            elemParamsAreShared_[elemIdx] = updated.elemParamsAreShared_[i];
+            if (!leverettPorosity_.empty())
+                leverettPorosity_[elemIdx] = updated.leverettPorosity_[i];
+
+            // elements with hysteresis never share their parameter objects
+            if (enableHysteresis()) {
+                setOilWaterHysteresisParams(owPcSwMdc, owKrnSwMdc, elemIdx);
+                setGasOilHysteresisParams(goPcSwMdc, goKrnSwMdc, elemIdx);
+            }
+
+            if (!maxPcowMultiplier_.empty() && maxPcowMultiplier_[elemIdx] != 1.0) {
+                Scalar maxPcowFactor = maxPcowMultiplier_[elemIdx];
+                maxPcowMultiplier_[elemIdx] = 1.0;
+                if (elemParamsAreShared_[elemIdx])
+                    makeElemParamsUnique_(elemIdx);
+                scaleMaxPcow_(elemIdx, maxPcowFactor);
+            }
+        }
+
+        updateLeverettFactors(leverettPorosity);
+
+        return static_cast<unsigned>(updatedElems.size());
     }
 
     bool enableEndPointScaling() const
     { return enableEndPointScaling_; }
 
     bool enableHysteresis() const
-    { return hysteresisConfig_->enableHysteresis(); }
+    { return enableHysteresisLayer && hysteresisConfig_->enableHysteresis(); }
 
+    /*!
+     * \brief Returns the parameter object of an element for modification.
+     *
+     * Elements with identical end points share their parameter objects, so the element
+     * gets a copy of its own first if required. This is not thread safe and it defeats
+     * the sharing, so the const variant should be used to evaluate the saturation
+     * functions.
+     */
     MaterialLawParams& materialLawParams(unsigned elemIdx)
     {
         assert(0 <= elemIdx && elemIdx <  materialLawParams_.size());
+        if (elemParamsAreShared_[elemIdx])
+            makeElemParamsUnique_(elemIdx);
         return *materialLawParams_[elemIdx];
     }
 
@@ -218,439 +591,2173 @@ public:
     }
 
     /*!
-     * \brief Returns a material parameter object for a given element and saturation region.
+     * \brief Pre-compute the material parameter objects of well connections.
      *
-     * This method changes the saturation table idx in the original material law parameter object.
-     * In the context of ECL reservoir simulators, this is required to properly handle
-     * wells with its own saturation table idx. In order to reset the saturation table idx
-     * in the materialLawparams_ call the method with the cells satRegionIdx
+     * Each entry of connections specifies the element index and the saturation region
+     * index of a connection. For all connections whose saturation region differs from
+     * the SATNUM region of their element, a dedicated parameter object is created. It
+     * uses the saturation function tables of the connection's region and the scaled
+     * end points and the hysteresis parameters of the element. Connections of elements
+     * which share their parameter objects also share the connection parameters.
+     *
+     * This needs to be called again whenever the connections change, e.g., if the well
+     * schedule changes. The objects are not part of the serialized state. If hysteresis
+     * is enabled, the scanning curves of the connections follow the ones of their
+     * element, i.e., they are updated by updateHysteresis(), restoreHysteresisState() and
+     * the set*HysteresisParams() methods.
      */
-    const MaterialLawParams& connectionMaterialLawParams(unsigned satRegionIdx, unsigned elemIdx) const
+    void initConnectionMaterialLawParams(const std::vector<std::pair<unsigned, unsigned> >& connections)
     {
-        MaterialLawParams& mlp = *materialLawParams_[elemIdx];
+        connectionParams_.clear();
+        hysteresisConnections_.clear();
 
-        if (enableHysteresis()) {
-            OPM_MESSAGE("Warning: Using non-defautl satnum regions for conenction is not tested in combination with hysteresis");
-        }
         // Currently we don't support COMPIMP. I.e. use the same table lookup for the hysteresis curves.
-        // unsigned impRegionIdx = satRegionIdx;
 
-        // change the sat table it points to.
-        switch (mlp.approach()) {
-        case EclStone1Approach: {
-            auto& realParams = mlp.template getRealParams<Opm::EclStone1Approach>();
-
-            realParams.oilWaterParams().drainageParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[satRegionIdx]);
-            realParams.oilWaterParams().drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
-            realParams.gasOilParams().drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
-            realParams.gasOilParams().drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
-//            if (enableHysteresis()) {
-//                realParams.oilWaterParams().imbibitionParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[impRegionIdx]);
-//                realParams.oilWaterParams().imbibitionParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[impRegionIdx]);
-//                realParams.gasOilParams().imbibitionParams().setUnscaledPoints(gasOilUnscaledPointsVector_[impRegionIdx]);
-//                realParams.gasOilParams().imbibitionParams().setEffectiveLawParams(gasOilEffectiveParamVector_[impRegionIdx]);
-//            }
-        }
-            break;
+        std::map<std::pair<const MaterialLawParams*, unsigned>, std::shared_ptr<MaterialLawParams> > paramsCache;
+        for (const auto& connection : connections) {
+            const unsigned elemIdx = connection.first;
+            const unsigned satRegionIdx = connection.second;
+            assert(elemIdx < materialLawParams_.size());
+            assert(satRegionIdx < unscaledEpsInfo_.size());
 
-        case EclStone2Approach: {
-            auto& realParams = mlp.template getRealParams<Opm::EclStone2Approach>();
-            realParams.oilWaterParams().drainageParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[satRegionIdx]);
-            realParams.oilWaterParams().drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
-            realParams.gasOilParams().drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
-            realParams.gasOilParams().drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
-//            if (enableHysteresis()) {
-//                realParams.oilWaterParams().imbibitionParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[impRegionIdx]);
-//                realParams.oilWaterParams().imbibitionParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[impRegionIdx]);
-//                realParams.gasOilParams().imbibitionParams().setUnscaledPoints(gasOilUnscaledPointsVector_[impRegionIdx]);
-//                realParams.gasOilParams().imbibitionParams().setEffectiveLawParams(gasOilEffectiveParamVector_[impRegionIdx]);
-//            }
-        }
-            break;
+            if (static_cast<int>(satRegionIdx) == satnumRegionArray_[elemIdx])
+                continue;
 
-        case EclDefaultApproach: {
-            auto& realParams = mlp.template getRealParams<Opm::EclDefaultApproach>();
-            realParams.oilWaterParams().drainageParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[satRegionIdx]);
-            realParams.oilWaterParams().drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
-            realParams.gasOilParams().drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
-            realParams.gasOilParams().drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
-//            if (enableHysteresis()) {
-//                realParams.oilWaterParams().imbibitionParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[impRegionIdx]);
-//                realParams.oilWaterParams().imbibitionParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[impRegionIdx]);
-//                realParams.gasOilParams().imbibitionParams().setUnscaledPoints(gasOilUnscaledPointsVector_[impRegionIdx]);
-//                realParams.gasOilParams().imbibitionParams().setEffectiveLawParams(gasOilEffectiveParamVector_[impRegionIdx]);
-//            }
-        }
-            break;
+            auto& params = paramsCache[std::make_pair(materialLawParams_[elemIdx].get(), satRegionIdx)];
+            if (!params) {
+                params = makeConnectionParams_(*materialLawParams_[elemIdx], satRegionIdx);
 
-        case EclTwoPhaseApproach: {
-            auto& realParams = mlp.template getRealParams<Opm::EclTwoPhaseApproach>();
-            realParams.oilWaterParams().drainageParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[satRegionIdx]);
-            realParams.oilWaterParams().drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
-            realParams.gasOilParams().drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
-            realParams.gasOilParams().drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
-//            if (enableHysteresis()) {
-//                realParams.oilWaterParams().imbibitionParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[impRegionIdx]);
-//                realParams.oilWaterParams().imbibitionParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[impRegionIdx]);
-//                realParams.gasOilParams().imbibitionParams().setUnscaledPoints(gasOilUnscaledPointsVector_[impRegionIdx]);
-//                realParams.gasOilParams().imbibitionParams().setEffectiveLawParams(gasOilEffectiveParamVector_[impRegionIdx]);
-//            }
+                // the parameter objects of the elements are never shared if hysteresis
+                // is enabled, so each connection object belongs to a single element
+                if (enableHysteresis())
+                    hysteresisConnections_.emplace(elemIdx, params.get());
+            }
+            connectionParams_[connectionKey_(elemIdx, satRegionIdx)] = params;
         }
-            break;
 
-        default:
-            OPM_THROW(std::logic_error, "Enum value for material approach unknown!");
-        }
+        // the imbibition scanning curves depend on the drainage curves, so they are
+        // recomputed for the tables of the connection's saturation region
+        for (const auto& connection : hysteresisConnections_)
+            updateConnectionHysteresis_(*materialLawParams_[connection.first], *connection.second);
+    }
 
-        return mlp;
+    /*!
+     * \brief Returns the material parameter object for a given element and saturation
+     *        region.
+     *
+     * In the context of ECL reservoir simulators, this is required to properly handle
+     * wells with their own saturation table idx. If the saturation region is the one
+     * of the element, its parameter object is returned, otherwise the one which was
+     * created by initConnectionMaterialLawParams(). The parameter objects of the
+     * elements are never modified by this method.
+     */
+    const MaterialLawParams& connectionMaterialLawParams(unsigned satRegionIdx, unsigned elemIdx) const
+    {
+        assert(elemIdx < materialLawParams_.size());
+        if (static_cast<int>(satRegionIdx) == satnumRegionArray_[elemIdx])
+            return *materialLawParams_[elemIdx];
+
+        auto paramsIt = connectionParams_.find(connectionKey_(elemIdx, satRegionIdx));
+        if (paramsIt == connectionParams_.end())
+            OPM_THROW(std::logic_error,
+                      "No material law parameters for the connection of element " << elemIdx
+                      << " to saturation region " << satRegionIdx << " have been"
+                      " pre-computed. Call initConnectionMaterialLawParams() first.");
+
+        return *paramsIt->second;
     }
 
     int satnumRegionIdx(unsigned elemIdx) const {
         return satnumRegionArray_[elemIdx];
     }
 
-    std::shared_ptr<MaterialLawParams>& materialLawParamsPointerReferenceHack(unsigned elemIdx)
+    /*!
+     * \brief Returns the number of saturation regions.
+     */
+    unsigned numSatnumRegions() const
+    { return static_cast<unsigned>(unscaledEpsInfo_.size()); }
+
+    /*!
+     * \brief Returns the indices of all elements sorted by their saturation region.
+     *
+     * Within a region, the elements are sorted by their index. Evaluating the
+     * saturation functions in this order, e.g., using relativePermeabilitiesOfElements(),
+     * keeps the tables of one region in the cache instead of alternating between the
+     * tables of different regions.
+     */
+    const std::vector<unsigned>& satnumRegionOrder() const
+    { return satnumRegionOrder_; }
+
+    /*!
+     * \brief Returns a pointer to the first index of satnumRegionOrder() which belongs
+     *        to a given saturation region.
+     */
+    const unsigned* satnumRegionElemsBegin(unsigned satRegionIdx) const
     {
-        assert(0 <= elemIdx && elemIdx <  materialLawParams_.size());
-        return materialLawParams_[elemIdx];
+        assert(satRegionIdx < numSatnumRegions());
+        return satnumRegionOrder_.data() + satnumRegionOffsets_[satRegionIdx];
     }
 
-    template <class FluidState>
-    void updateHysteresis(const FluidState& fluidState, unsigned elemIdx)
+    /*!
+     * \brief Returns a pointer behind the last index of satnumRegionOrder() which
+     *        belongs to a given saturation region.
+     */
+    const unsigned* satnumRegionElemsEnd(unsigned satRegionIdx) const
     {
-        if (!enableHysteresis())
-            return;
+        assert(satRegionIdx < numSatnumRegions());
+        return satnumRegionOrder_.data() + satnumRegionOffsets_[satRegionIdx + 1];
+    }
 
-        auto threePhaseParams = materialLawParams_[elemIdx];
-        MaterialLaw::updateHysteresis(*threePhaseParams, fluidState);
+    /*!
+     * \brief Returns the pointer to the parameter object of an element for
+     *        modification.
+     *
+     * Like the non-const materialLawParams(), this gives the element a parameter object
+     * of its own if it is shared with other elements.
+     */
+    std::shared_ptr<MaterialLawParams>& materialLawParamsPointerReferenceHack(unsigned elemIdx)
+    {
+        assert(0 <= elemIdx && elemIdx <  materialLawParams_.size());
+        if (elemParamsAreShared_[elemIdx])
+            makeElemParamsUnique_(elemIdx);
+        return materialLawParams_[elemIdx];
     }
 
-    void oilWaterHysteresisParams(Scalar& pcSwMdc,
-                                  Scalar& krnSwMdc,
-                                  unsigned elemIdx) const
+    /*!
+     * \brief Pre-compute the scaled saturation functions of all elements.
+     *
+     * Afterwards, the end-point scaling transformations and the associated table lookups
+     * can be skipped when evaluating the saturation functions, at the price of storing
+     * one set of tables for each distinct parameter object. The results are identical
+     * except for rounding errors. The tables of an element are dropped if its scaling
+     * points are modified later on (e.g. by applySwatinit()). If this is done for many
+     * elements, this method should be called again afterwards.
+     */
+    void bakeEndPointScaling()
     {
-        if (!enableHysteresis()) {
-            OPM_THROW(std::runtime_error, "Cannot get hysteresis parameters if hysteresis not enabled.");
+        std::unordered_map<const MaterialLawParams*, bool> isBaked;
+        for (size_t elemIdx = 0; elemIdx < materialLawParams_.size(); ++elemIdx) {
+            MaterialLawParams& params = *materialLawParams_[elemIdx];
+            if (!isBaked.insert(std::make_pair(&params, true)).second)
+                continue;
+
+            switch (params.approach()) {
+            case EclStone1Approach:
+                bakeThreePhaseParams_<EclStone1Approach>(params);
+                break;
+
+            case EclStone2Approach:
+                bakeThreePhaseParams_<EclStone2Approach>(params);
+                break;
+
+            case EclDefaultApproach:
+                bakeThreePhaseParams_<EclDefaultApproach>(params);
+                break;
+
+            case EclTwoPhaseApproach:
+                bakeThreePhaseParams_<EclTwoPhaseApproach>(params);
+                break;
+            }
         }
-        const auto& params = materialLawParams(elemIdx);
-        MaterialLaw::oilWaterHysteresisParams(pcSwMdc, krnSwMdc, params);
     }
 
-    void setOilWaterHysteresisParams(const Scalar& pcSwMdc,
-                                     const Scalar& krnSwMdc,
-                                     unsigned elemIdx)
+    /*!
+     * \brief Replace the evaluation of the three-phase oil relative permeability by a
+     *        lookup in a table for the elements without end-point scaling.
+     *
+     * For these elements, the oil relperm of the Stone and the default three-phase
+     * approaches only depends on the water and the gas saturations of their SATNUM
+     * region. It is sampled once per region, see tabulateEclThreePhaseKro(), and the
+     * table is shared by all elements of the region which use the same parameter
+     * object as other elements and whose end points are the unscaled ones. Regions for
+     * which 'tolerance' cannot be met with at most 'maxNumSamples' points per
+     * direction keep the exact evaluation. Tabulation is not possible if hysteresis is
+     * enabled or if the two-phase approach is used.
+     *
+     * Elements whose parameter objects are made unique later (e.g. by applySwatinit())
+     * or replaced by updateSatRegionsFromDeck() do not use the table anymore, so this
+     * method should be called after the initialization of the simulation is
+     * complete. The return value is the number of elements which use a table.
+     */
+    unsigned tabulateThreePhaseKro(Scalar tolerance = 1e-3, unsigned maxNumSamples = 513)
     {
-        if (!enableHysteresis()) {
-            OPM_THROW(std::runtime_error, "Cannot set hysteresis parameters if hysteresis not enabled.");
+        if (enableHysteresis())
+            return 0;
+
+        switch (threePhaseApproach_) {
+        case EclStone1Approach:
+            return tabulateThreePhaseKro_<typename MaterialLaw::Stone1Material, EclStone1Approach>(tolerance, maxNumSamples);
+
+        case EclStone2Approach:
+            return tabulateThreePhaseKro_<typename MaterialLaw::Stone2Material, EclStone2Approach>(tolerance, maxNumSamples);
+
+        case EclDefaultApproach:
+            return tabulateThreePhaseKro_<typename MaterialLaw::DefaultMaterial, EclDefaultApproach>(tolerance, maxNumSamples);
+
+        case EclTwoPhaseApproach:
+            break;
         }
-        auto& params = materialLawParams(elemIdx);
-        MaterialLaw::setOilWaterHysteresisParams(pcSwMdc, krnSwMdc, params);
+
+        return 0;
     }
 
-    void gasOilHysteresisParams(Scalar& pcSwMdc,
-                                Scalar& krnSwMdc,
-                                unsigned elemIdx) const
+    /*!
+     * \brief Returns the memory used by the material parameters of all elements.
+     *
+     * The memory is broken down into the parameters of the effective saturation
+     * functions (including the baked tables of bakeEndPointScaling()), the end-point
+     * scaling points, the hysteresis parameters, the parameters of the three-phase
+     * multiplexer and the per-element index arrays. Objects which are shared by several
+     * elements or regions are only accounted once.
+     */
+    MemoryUsage memoryUsage() const
     {
-        if (!enableHysteresis()) {
-            OPM_THROW(std::runtime_error, "Cannot get hysteresis parameters if hysteresis not enabled.");
-        }
-        const auto& params = materialLawParams(elemIdx);
-        MaterialLaw::gasOilHysteresisParams(pcSwMdc, krnSwMdc, params);
+        MemoryUsage usage;
+        std::unordered_set<const void*> visited;
+
+        usage.add("element index",
+                  vectorMemoryUsage(materialLawParams_)
+                  + vectorMemoryUsage(oilWaterScaledEpsInfoDrainage_)
+                  + vectorMemoryUsage(elemParamsAreShared_)
+                  + vectorMemoryUsage(satnumRegionArray_)
+                  + vectorMemoryUsage(satnumRegionOrder_)
+                  + vectorMemoryUsage(satnumRegionOffsets_)
+                  + vectorMemoryUsage(leverettPorosity_)
+                  + vectorMemoryUsage(maxPcowMultiplier_));
+
+        usage.add("scaling points",
+                  vectorMemoryUsage(unscaledEpsInfo_)
+                  + vectorMemoryUsage(gasOilUnscaledPointsVector_)
+                  + vectorMemoryUsage(oilWaterUnscaledPointsVector_));
+        addSharedMemoryUsage_(usage, visited, "scaling points", gasOilUnscaledPointsVector_);
+        addSharedMemoryUsage_(usage, visited, "scaling points", oilWaterUnscaledPointsVector_);
+        addSharedMemoryUsage_(usage, visited, "scaling points", oilWaterScaledEpsInfoDrainage_);
+
+        usage.add("effective params",
+                  vectorMemoryUsage(gasOilEffectiveParamVector_)
+                  + vectorMemoryUsage(oilWaterEffectiveParamVector_));
+        for (const auto& effParams : gasOilEffectiveParamVector_)
+            addEffectiveMemoryUsage_(usage, visited, effParams.get());
+        for (const auto& effParams : oilWaterEffectiveParamVector_)
+            addEffectiveMemoryUsage_(usage, visited, effParams.get());
+
+        for (const auto& paramsPtr : materialLawParams_)
+            addMaterialLawMemoryUsage_(usage, visited, *paramsPtr);
+
+        usage.add("connection index",
+                  connectionParams_.size()*sizeof(typename ConnectionParamsMap::value_type));
+        for (const auto& connection : connectionParams_)
+            addMaterialLawMemoryUsage_(usage, visited, *connection.second);
+        usage.add("connection index",
+                  hysteresisConnections_.size()*sizeof(typename decltype(hysteresisConnections_)::value_type));
+
+        return usage;
     }
 
-    void setGasOilHysteresisParams(const Scalar& pcSwMdc,
-                                   const Scalar& krnSwMdc,
-                                   unsigned elemIdx)
+    /*!
+     * \brief Write the complete state of the manager to a binary blob.
+     *
+     * This includes the tables of the saturation regions, the scaled end points of
+     * all elements and their hysteresis state. Objects which are shared by several
+     * elements or regions are only written once and are shared again by
+     * deserialize().
+     */
+    void serialize(BinaryWriter& writer) const
     {
-        if (!enableHysteresis()) {
-            OPM_THROW(std::runtime_error, "Cannot set hysteresis parameters if hysteresis not enabled.");
-        }
-        auto& params = materialLawParams(elemIdx);
-        MaterialLaw::setGasOilHysteresisParams(pcSwMdc, krnSwMdc, params);
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::serialize");
+
+        serializeRegionData_(writer);
+        writer.write(static_cast<std::uint64_t>(materialLawParams_.size()));
+        for (unsigned elemIdx = 0; elemIdx < materialLawParams_.size(); ++elemIdx)
+            serializeElement_(writer, elemIdx);
     }
 
-    EclEpsScalingPoints<Scalar>& oilWaterScaledEpsPointsDrainage(unsigned elemIdx)
+    /*!
+     * \brief Write the state of the manager for a subset of the elements to a binary
+     *        blob.
+     *
+     * The element with index elemIndices[i] becomes element i of the manager which
+     * deserializes the blob, e.g., a process which only stores the elements of its
+     * partition of the grid. The tables of all saturation regions are always written.
+     */
+    void serialize(BinaryWriter& writer, const std::vector<unsigned>& elemIndices) const
     {
-        auto& materialParams = *materialLawParams_[elemIdx];
-        switch (materialParams.approach()) {
-        case EclStone1Approach: {
-            auto& realParams = materialParams.template getRealParams<Opm::EclStone1Approach>();
-            return realParams.oilWaterParams().drainageParams().scaledPoints();
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::serialize");
+
+        serializeRegionData_(writer);
+        writer.write(static_cast<std::uint64_t>(elemIndices.size()));
+        for (unsigned elemIdx : elemIndices) {
+            if (elemIdx >= materialLawParams_.size())
+                OPM_THROW(std::invalid_argument,
+                          "Element index " << elemIdx << " is out of range");
+            serializeElement_(writer, elemIdx);
         }
+    }
 
-        case EclStone2Approach: {
-            auto& realParams = materialParams.template getRealParams<Opm::EclStone2Approach>();
-            return realParams.oilWaterParams().drainageParams().scaledPoints();
-        }
+    /*!
+     * \brief Restore the state which was written by one of the serialize() methods.
+     *
+     * This replaces the initialization using initFromDeck().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::deserialize");
+
+        reader.read(enableEndPointScaling_);
+        reader.read(hasGasOilParams_);
+        reader.read(hasOilWaterParams_);
+        reader.read(storeGasOilParams_);
+        reader.read(storeOilWaterParams_);
+        reader.readShared(hysteresisConfig_);
+        reader.readShared(oilWaterEclEpsConfig_);
+        if (!hysteresisConfig_ || !oilWaterEclEpsConfig_)
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: the material law manager has no configuration");
+        checkLayers_();
+
+        std::int32_t threePhaseApproach;
+        std::int32_t twoPhaseApproach;
+        reader.read(threePhaseApproach);
+        reader.read(twoPhaseApproach);
+        if (threePhaseApproach < EclDefaultApproach || threePhaseApproach > EclTwoPhaseApproach
+            || twoPhaseApproach < EclTwoPhaseGasOil || twoPhaseApproach > EclTwoPhaseGasWater)
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: invalid approach of the material law manager");
+        threePhaseApproach_ = static_cast<EclMultiplexerApproach>(threePhaseApproach);
+        twoPhaseApproach_ = static_cast<enum EclTwoPhaseApproach>(twoPhaseApproach);
+
+        reader.read(unscaledEpsInfo_);
+        reader.readSharedObjects(gasOilUnscaledPointsVector_);
+        reader.readSharedObjects(oilWaterUnscaledPointsVector_);
+        reader.readSharedObjects(gasOilEffectiveParamVector_);
+        reader.readSharedObjects(oilWaterEffectiveParamVector_);
+
+        bool hasLeverettPorosity;
+        bool hasMaxPcowMultiplier;
+        reader.read(leverettPorosityExponent_);
+        reader.read(hasLeverettPorosity);
+        reader.read(hasMaxPcowMultiplier);
+
+        // the elements are appended one by one, so that a corrupt number of elements
+        // results in an exception instead of a huge allocation
+        std::uint64_t numElems;
+        reader.read(numElems);
+        oilWaterScaledEpsInfoDrainage_.clear();
+        materialLawParams_.clear();
+        elemParamsAreShared_.clear();
+        satnumRegionArray_.clear();
+        leverettPorosity_.clear();
+        maxPcowMultiplier_.clear();
+        connectionParams_.clear();
+        hysteresisConnections_.clear();
+        for (std::uint64_t elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            std::shared_ptr<EclEpsScalingPointsInfo<Scalar> > epsInfo;
+            std::shared_ptr<MaterialLawParams> params;
+            std::uint8_t isShared;
+            std::int32_t satnumRegionIdx;
+            reader.readShared(epsInfo);
+            reader.readShared(params);
+            reader.read(isShared);
+            reader.read(satnumRegionIdx);
+
+            if (!epsInfo || !params)
+                OPM_THROW(std::runtime_error,
+                          "Corrupt serialized data: missing parameters of element " << elemIdx);
+            if (satnumRegionIdx < 0
+                || static_cast<std::size_t>(satnumRegionIdx) >= unscaledEpsInfo_.size())
+                OPM_THROW(std::runtime_error,
+                          "Corrupt serialized data: invalid saturation region of element " << elemIdx);
+
+            oilWaterScaledEpsInfoDrainage_.push_back(epsInfo);
+            materialLawParams_.push_back(params);
+            elemParamsAreShared_.push_back(isShared != 0);
+            satnumRegionArray_.push_back(satnumRegionIdx);
+
+            if (hasLeverettPorosity) {
+                Scalar porosity;
+                reader.read(porosity);
+                leverettPorosity_.push_back(porosity);
+            }
 
-        case EclDefaultApproach: {
-            auto& realParams = materialParams.template getRealParams<Opm::EclDefaultApproach>();
-            return realParams.oilWaterParams().drainageParams().scaledPoints();
+            if (hasMaxPcowMultiplier) {
+                Scalar multiplier;
+                reader.read(multiplier);
+                maxPcowMultiplier_.push_back(multiplier);
+            }
         }
 
-        case EclTwoPhaseApproach: {
-            auto& realParams = materialParams.template getRealParams<Opm::EclTwoPhaseApproach>();
-            return realParams.oilWaterParams().drainageParams().scaledPoints();
-        }
-        default:
-            OPM_THROW(std::logic_error, "Enum value for material approach unknown!");
-        }
+        updateSatnumRegionOrder_();
     }
 
-    const Opm::EclEpsScalingPointsInfo<Scalar>& oilWaterScaledEpsInfoDrainage(size_t elemIdx) const
+    /*!
+     * \brief Update the hysteresis parameters of an element.
+     *
+     * The return value is true if a saturation reversal was detected for the element,
+     * i.e., if its scanning curves were modified.
+     */
+    template <class FluidState>
+    bool updateHysteresis(const FluidState& fluidState, unsigned elemIdx)
     {
-        return *oilWaterScaledEpsInfoDrainage_[elemIdx];
+        if (!enableHysteresis())
+            return false;
+
+        if (!MaterialLaw::updateHysteresis(*materialLawParams_[elemIdx], fluidState))
+            return false;
+
+        updateConnectionHysteresis_(elemIdx);
+        return true;
     }
 
-    std::shared_ptr<EclEpsScalingPointsInfo<Scalar> >& oilWaterScaledEpsInfoDrainagePointerReferenceHack(unsigned elemIdx)
+    /*!
+     * \brief Update the hysteresis parameters of a contiguous range of elements.
+     *
+     * 'fluidStates[i]' is the fluid state of the element 'beginElemIdx + i'. The number
+     * of elements whose scanning curves were modified is returned. If 'updatedElems' is
+     * specified, the indices of these elements are appended to it, so that quantities
+     * which depend on the hysteresis parameters only need to be recomputed for them.
+     */
+    template <class FluidStateContainer>
+    unsigned updateHysteresis(const FluidStateContainer& fluidStates,
+                              unsigned beginElemIdx,
+                              unsigned endElemIdx,
+                              std::vector<unsigned>* updatedElems = nullptr)
     {
-        return oilWaterScaledEpsInfoDrainage_[elemIdx];
+        if (!enableHysteresis())
+            return 0;
+
+        return updateHysteresisBlock_(fluidStates, beginElemIdx, beginElemIdx, endElemIdx, updatedElems);
     }
-private:
-    void readGlobalEpsOptions_(const Opm::Deck& deck, const Opm::EclipseState& eclState)
-    {
-        oilWaterEclEpsConfig_ = std::make_shared<Opm::EclEpsConfig>();
+
+    /*!
+     * \brief Update the hysteresis parameters of a contiguous range of elements using
+     *        all threads of the OpenMP team.
+     *
+     * The arguments and the return value are the same as for the serial range variant of
+     * updateHysteresis(). Each thread processes one contiguous block of elements, so
+     * that the threads only touch the parameter objects of neighboring threads at the
+     * block boundaries. The indices of the modified elements are collected per thread
+     * and appended to 'updatedElems' in ascending order. This method must be called
+     * outside of a parallel region. Without OpenMP, it is equivalent to the serial
+     * variant.
+     */
+    template <class FluidStateContainer>
+    unsigned updateHysteresisParallel(const FluidStateContainer& fluidStates,
+                                      unsigned beginElemIdx,
+                                      unsigned endElemIdx,
+                                      std::vector<unsigned>* updatedElems = nullptr)
+    {
+        if (!enableHysteresis())
+            return 0;
+
+#ifdef _OPENMP
+        assert(beginElemIdx <= endElemIdx && endElemIdx <= materialLawParams_.size());
+        std::vector<std::vector<unsigned> > threadUpdatedElems(static_cast<size_t>(omp_get_max_threads()));
+        unsigned numUpdated = 0;
+
+#pragma omp parallel reduction(+:numUpdated)
+        {
+            unsigned threadIdx = static_cast<unsigned>(omp_get_thread_num());
+            unsigned numThreads = static_cast<unsigned>(omp_get_num_threads());
+            size_t numElems = endElemIdx - beginElemIdx;
+            unsigned blockBeginIdx = beginElemIdx + static_cast<unsigned>((numElems*threadIdx)/numThreads);
+            unsigned blockEndIdx = beginElemIdx + static_cast<unsigned>((numElems*(threadIdx + 1))/numThreads);
+
+            // the indices are first collected in a vector which is private to the
+            // thread, so that the threads do not write to adjacent memory locations
+            std::vector<unsigned> localUpdatedElems;
+            numUpdated += updateHysteresisBlock_(fluidStates,
+                                                 beginElemIdx,
+                                                 blockBeginIdx,
+                                                 blockEndIdx,
+                                                 updatedElems ? &localUpdatedElems : nullptr);
+            threadUpdatedElems[threadIdx].swap(localUpdatedElems);
+        }
+
+        if (updatedElems)
+            for (const auto& localUpdatedElems : threadUpdatedElems)
+                updatedElems->insert(updatedElems->end(), localUpdatedElems.begin(), localUpdatedElems.end());
+
+        return numUpdated;
+#else
+        return updateHysteresisBlock_(fluidStates, beginElemIdx, beginElemIdx, endElemIdx, updatedElems);
+#endif
+    }
+
+    /*!
+     * \brief Compute the relative permeabilities of a contiguous range of elements.
+     *
+     * The saturations and the results are given as one array per phase, i.e.,
+     * 'saturations[phaseIdx][i]' is the saturation of the phase in the element
+     * 'beginElemIdx + i'. Since all elements use the same three-phase approach, the
+     * approach is only dispatched once for the whole range.
+     *
+     * If the results are plain scalars while the saturations are Evaluations, only the
+     * values of the saturations are used and no derivatives are computed (see
+     * opm/material/common/ValueOnly.hpp).
+     */
+    template <class InputEvaluation, class Evaluation>
+    void relativePermeabilities(Evaluation* const* kr,
+                                const InputEvaluation* const* saturations,
+                                unsigned beginElemIdx,
+                                unsigned endElemIdx) const
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::relativePermeabilities");
+
+        const Opm::DecayedArrays<Evaluation, InputEvaluation, numPhases>
+            sat(saturations, endElemIdx - beginElemIdx);
+        evalRange_</*computeKr=*/true>(kr, sat.arrays(), beginElemIdx, endElemIdx);
+    }
+
+    /*!
+     * \brief Compute the capillary pressures of a contiguous range of elements.
+     *
+     * The arrays are organized the same way as for relativePermeabilities().
+     */
+    template <class InputEvaluation, class Evaluation>
+    void capillaryPressures(Evaluation* const* pc,
+                            const InputEvaluation* const* saturations,
+                            unsigned beginElemIdx,
+                            unsigned endElemIdx) const
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::capillaryPressures");
+
+        const Opm::DecayedArrays<Evaluation, InputEvaluation, numPhases>
+            sat(saturations, endElemIdx - beginElemIdx);
+        evalRange_</*computeKr=*/false>(pc, sat.arrays(), beginElemIdx, endElemIdx);
+    }
+
+    /*!
+     * \brief Compute the relative permeabilities of a set of elements.
+     *
+     * In contrast to relativePermeabilities(), the arrays are indexed by the element
+     * index, i.e., 'saturations[phaseIdx][elemIdx]' is the saturation of the phase in
+     * element 'elemIdx' and only the entries of the elements in [elemIdxBegin,
+     * elemIdxEnd) are read and written. This allows to evaluate the elements in the
+     * order given by satnumRegionOrder() without reordering the data of the simulator.
+     * Runs of consecutive element indices are passed on to the range-wise kernels.
+     */
+    template <class InputEvaluation, class Evaluation>
+    void relativePermeabilitiesOfElements(Evaluation* const* kr,
+                                          const InputEvaluation* const* saturations,
+                                          const unsigned* elemIdxBegin,
+                                          const unsigned* elemIdxEnd) const
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::relativePermeabilitiesOfElements");
+
+        evalElements_</*computeKr=*/true>(kr, saturations, elemIdxBegin, elemIdxEnd);
+    }
+
+    /*!
+     * \brief Compute the capillary pressures of a set of elements.
+     *
+     * The arrays are organized the same way as for relativePermeabilitiesOfElements().
+     */
+    template <class InputEvaluation, class Evaluation>
+    void capillaryPressuresOfElements(Evaluation* const* pc,
+                                      const InputEvaluation* const* saturations,
+                                      const unsigned* elemIdxBegin,
+                                      const unsigned* elemIdxEnd) const
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::capillaryPressuresOfElements");
+
+        evalElements_</*computeKr=*/false>(pc, saturations, elemIdxBegin, elemIdxEnd);
+    }
+
+    /*!
+     * \brief Store the dynamic hysteresis state of all elements.
+     *
+     * In contrast to the set*HysteresisParams() methods, restoring this state using
+     * restoreHysteresisState() reverts the scanning curves exactly and does not need to
+     * recompute them, e.g., in order to repeat a time step.
+     */
+    void saveHysteresisState(HysteresisState& state) const
+    {
+        size_t numElems = enableHysteresis() ? materialLawParams_.size() : 0;
+        state.oilWaterPcSwMdc.resize(numElems);
+        state.oilWaterKrnSwMdc.resize(numElems);
+        state.oilWaterDeltaSwImbKrn.resize(numElems);
+        state.gasOilPcSwMdc.resize(numElems);
+        state.gasOilKrnSwMdc.resize(numElems);
+        state.gasOilDeltaSwImbKrn.resize(numElems);
+
+        if (numElems > 0)
+            dispatchApproach_(HysteresisStateSaver_(*this, state));
+    }
+
+    /*!
+     * \brief Restore the dynamic hysteresis state saved by saveHysteresisState().
+     */
+    void restoreHysteresisState(const HysteresisState& state)
+    {
+        if (!enableHysteresis())
+            return;
+
+        if (state.oilWaterPcSwMdc.size() != materialLawParams_.size())
+            OPM_THROW(std::invalid_argument,
+                      "The hysteresis state does not match the number of elements");
+
+        dispatchApproach_(HysteresisStateRestorer_(*this, state));
+
+        for (const auto& connection : hysteresisConnections_)
+            updateConnectionHysteresis_(*materialLawParams_[connection.first], *connection.second);
+    }
+
+    void oilWaterHysteresisParams(Scalar& pcSwMdc,
+                                  Scalar& krnSwMdc,
+                                  unsigned elemIdx) const
+    {
+        if (!enableHysteresis()) {
+            OPM_THROW(std::runtime_error, "Cannot get hysteresis parameters if hysteresis not enabled.");
+        }
+        if (!storeOilWaterParams_) {
+            // the values which signify that the drainage curve is used
+            pcSwMdc = 2.0;
+            krnSwMdc = 2.0;
+            return;
+        }
+        const auto& params = materialLawParams(elemIdx);
+        MaterialLaw::oilWaterHysteresisParams(pcSwMdc, krnSwMdc, params);
+    }
+
+    void setOilWaterHysteresisParams(const Scalar& pcSwMdc,
+                                     const Scalar& krnSwMdc,
+                                     unsigned elemIdx)
+    {
+        if (!enableHysteresis()) {
+            OPM_THROW(std::runtime_error, "Cannot set hysteresis parameters if hysteresis not enabled.");
+        }
+        if (!storeOilWaterParams_)
+            return;
+        auto& params = materialLawParams(elemIdx);
+        MaterialLaw::setOilWaterHysteresisParams(pcSwMdc, krnSwMdc, params);
+        updateConnectionHysteresis_(elemIdx);
+    }
+
+    void gasOilHysteresisParams(Scalar& pcSwMdc,
+                                Scalar& krnSwMdc,
+                                unsigned elemIdx) const
+    {
+        if (!enableHysteresis()) {
+            OPM_THROW(std::runtime_error, "Cannot get hysteresis parameters if hysteresis not enabled.");
+        }
+        if (!storeGasOilParams_) {
+            // the values which signify that the drainage curve is used
+            pcSwMdc = 2.0;
+            krnSwMdc = 2.0;
+            return;
+        }
+        const auto& params = materialLawParams(elemIdx);
+        MaterialLaw::gasOilHysteresisParams(pcSwMdc, krnSwMdc, params);
+    }
+
+    void setGasOilHysteresisParams(const Scalar& pcSwMdc,
+                                   const Scalar& krnSwMdc,
+                                   unsigned elemIdx)
+    {
+        if (!enableHysteresis()) {
+            OPM_THROW(std::runtime_error, "Cannot set hysteresis parameters if hysteresis not enabled.");
+        }
+        if (!storeGasOilParams_)
+            return;
+        auto& params = materialLawParams(elemIdx);
+        MaterialLaw::setGasOilHysteresisParams(pcSwMdc, krnSwMdc, params);
+        updateConnectionHysteresis_(elemIdx);
+    }
+
+    ScalingPoints& oilWaterScaledEpsPointsDrainage(unsigned elemIdx)
+    {
+        if (elemParamsAreShared_[elemIdx])
+            makeElemParamsUnique_(elemIdx);
+
+        auto& materialParams = *materialLawParams_[elemIdx];
+        switch (materialParams.approach()) {
+        case EclStone1Approach: {
+            auto& realParams = materialParams.template getRealParams<Opm::EclStone1Approach>();
+            return realParams.oilWaterParams().drainageParams().scaledPoints();
+        }
+
+        case EclStone2Approach: {
+            auto& realParams = materialParams.template getRealParams<Opm::EclStone2Approach>();
+            return realParams.oilWaterParams().drainageParams().scaledPoints();
+        }
+
+        case EclDefaultApproach: {
+            auto& realParams = materialParams.template getRealParams<Opm::EclDefaultApproach>();
+            return realParams.oilWaterParams().drainageParams().scaledPoints();
+        }
+
+        case EclTwoPhaseApproach: {
+            auto& realParams = materialParams.template getRealParams<Opm::EclTwoPhaseApproach>();
+            return realParams.oilWaterParams().drainageParams().scaledPoints();
+        }
+        default:
+            OPM_THROW(std::logic_error, "Enum value for material approach unknown!");
+        }
+    }
+
+    /*!
+     * \brief Returns the oil-water scaling info of an element.
+     *
+     * The info is returned by value because the maximum capillary pressure of elements
+     * modified by applySwatinit() is not stored in the info object, which usually is
+     * shared with other elements.
+     */
+    Opm::EclEpsScalingPointsInfo<Scalar> oilWaterScaledEpsInfoDrainage(size_t elemIdx) const
+    {
+        Opm::EclEpsScalingPointsInfo<Scalar> info = *oilWaterScaledEpsInfoDrainage_[elemIdx];
+        if (!maxPcowMultiplier_.empty())
+            info.maxPcow *= maxPcowMultiplier_[elemIdx];
+        return info;
+    }
+
+    std::shared_ptr<EclEpsScalingPointsInfo<Scalar> >& oilWaterScaledEpsInfoDrainagePointerReferenceHack(unsigned elemIdx)
+    {
+        if (elemParamsAreShared_[elemIdx])
+            makeElemParamsUnique_(elemIdx);
+        makeElemEpsInfoUnique_(elemIdx);
+
+        // the caller may modify the info object, so it must contain the complete
+        // maximum capillary pressure
+        if (!maxPcowMultiplier_.empty()) {
+            oilWaterScaledEpsInfoDrainage_[elemIdx]->maxPcow *= maxPcowMultiplier_[elemIdx];
+            maxPcowMultiplier_[elemIdx] = 1.0;
+        }
+
+        return oilWaterScaledEpsInfoDrainage_[elemIdx];
+    }
+private:
+    void readGlobalEpsOptions_(const Opm::Deck& deck, const Opm::EclipseState& eclState)
+    {
+        oilWaterEclEpsConfig_ = std::make_shared<Opm::EclEpsConfig>();
         oilWaterEclEpsConfig_-> initFromDeck(deck, eclState, Opm::EclOilWaterSystem);
 
         enableEndPointScaling_ = deck.hasKeyword("ENDSCALE");
     }
 
-    void readGlobalHysteresisOptions_(const Opm::Deck& deck)
+    void readGlobalHysteresisOptions_(const Opm::Deck& deck)
+    {
+        hysteresisConfig_ = std::make_shared<Opm::EclHysteresisConfig>();
+        hysteresisConfig_->initFromDeck(deck);
+    }
+
+    // make sure that the layers of the material laws which are required by the deck
+    // have not been compiled out
+    void checkLayers_() const
+    {
+        if (!enableEpsLayer && enableEndPointScaling_)
+            OPM_THROW(std::runtime_error,
+                      "The deck uses end-point scaling, but the material law manager has "
+                      "been instantiated without the end-point scaling layer");
+        if (!enableHysteresisLayer && hysteresisConfig_->enableHysteresis())
+            OPM_THROW(std::runtime_error,
+                      "The deck uses hysteresis, but the material law manager has been "
+                      "instantiated without the hysteresis layer");
+    }
+
+    void readGlobalThreePhaseOptions_(const Opm::Deck& deck)
+    {
+        bool gasEnabled = deck.hasKeyword("GAS");
+        bool oilEnabled = deck.hasKeyword("OIL");
+        bool waterEnabled = deck.hasKeyword("WATER");
+
+        int numEnabled =
+            (gasEnabled?1:0)
+            + (oilEnabled?1:0)
+            + (waterEnabled?1:0);
+
+        if (numEnabled < 2)
+            OPM_THROW(std::runtime_error,
+                      "At least two fluid phases must be enabled. (Is: " << numEnabled << ")");
+
+        if (numEnabled == 2) {
+            threePhaseApproach_ = Opm::EclTwoPhaseApproach;
+            if (!gasEnabled)
+                twoPhaseApproach_ = Opm::EclTwoPhaseOilWater;
+            else if (!oilEnabled)
+                twoPhaseApproach_ = Opm::EclTwoPhaseGasWater;
+            else if (!waterEnabled)
+                twoPhaseApproach_ = Opm::EclTwoPhaseGasOil;
+        }
+        else {
+            assert(numEnabled == 3);
+
+            threePhaseApproach_ = Opm::EclDefaultApproach;
+            if (deck.hasKeyword("STONE") || deck.hasKeyword("STONE2"))
+                threePhaseApproach_ = Opm::EclStone2Approach;
+            else if (deck.hasKeyword("STONE1"))
+                threePhaseApproach_ = Opm::EclStone1Approach;
+        }
+    }
+
+    // if isReadRegion is not empty, only the tables of the saturation regions for which
+    // it is true are read from the deck. the objects of all other regions must exist.
+    void initFromDeck_(const Opm::Deck& deck,
+                       const Opm::EclipseState& eclState,
+                       const std::vector<int>& compressedToCartesianElemIdx,
+                       const std::vector<bool>& isReadRegion)
+    {
+        // get the number of cells in the deck
+        size_t numCompressedElems = compressedToCartesianElemIdx.size();
+
+        // copy the SATNUM grid property. in some cases this is not necessary, but it
+        // should not require much memory anyway...
+        satnumRegionArray_.resize(numCompressedElems);
+        if (eclState.get3DProperties().hasDeckIntGridProperty("SATNUM")) {
+            const auto& satnumRawData = eclState.get3DProperties().getIntGridProperty("SATNUM").getData();
+            for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
+                unsigned cartesianElemIdx = static_cast<unsigned>(compressedToCartesianElemIdx[elemIdx]);
+                satnumRegionArray_[elemIdx] = satnumRawData[cartesianElemIdx] - 1;
+            }
+        }
+        else
+            std::fill(satnumRegionArray_.begin(), satnumRegionArray_.end(), 0);
+
+        initRegionData_(deck, eclState);
+
+        EclEpsGridProperties epsGridProperties, epsImbGridProperties;
+        epsGridProperties.initFromDeck(deck, eclState, /*imbibition=*/false);
+        if (enableHysteresis())
+            epsImbGridProperties.initFromDeck(deck, eclState, /*imbibition=*/true);
+
+        initParamsForElements_(deck,
+                               eclState,
+                               epsGridProperties,
+                               epsImbGridProperties,
+                               static_cast<unsigned>(numCompressedElems),
+                               isReadRegion,
+                               [&compressedToCartesianElemIdx](unsigned elemIdx)
+                               { return static_cast<unsigned>(compressedToCartesianElemIdx[elemIdx]); });
+    }
+
+    // read the global options and allocate the unscaled end points of the saturation
+    // regions. the end points are read by readRegionTables_().
+    void initRegionData_(const Opm::Deck& deck, const Opm::EclipseState& eclState)
+    {
+        const size_t numSatRegions = eclState.runspec().tabdims().getNumSatTables();
+
+        readGlobalEpsOptions_(deck, eclState);
+        readGlobalHysteresisOptions_(deck);
+        readGlobalThreePhaseOptions_(deck);
+        checkLayers_();
+
+        unscaledEpsInfo_.resize(numSatRegions);
+    }
+
+    // read the saturation function tables and the unscaled end points of a saturation
+    // region from the deck
+    void readRegionTables_(const Opm::Deck& deck,
+                           const Opm::EclipseState& eclState,
+                           std::shared_ptr<EclEpsConfig> gasOilConfig,
+                           std::shared_ptr<EclEpsConfig> oilWaterConfig,
+                           unsigned satRegionIdx)
+    {
+        // the end point scaling info of the saturation region. the unscaled points are
+        // initialized from it.
+        unscaledEpsInfo_[satRegionIdx].extractUnscaled(deck, eclState, satRegionIdx);
+
+        // unscaled points for end-point scaling
+        readGasOilUnscaledPoints_(gasOilUnscaledPointsVector_, gasOilConfig, deck, eclState, satRegionIdx);
+        readOilWaterUnscaledPoints_(oilWaterUnscaledPointsVector_, oilWaterConfig, deck, eclState, satRegionIdx);
+
+        // the parameters for the effective two-phase matererial laws
+        readGasOilEffectiveParameters_(gasOilEffectiveParamVector_, deck, eclState, satRegionIdx);
+        readOilWaterEffectiveParameters_(oilWaterEffectiveParamVector_, deck, eclState, satRegionIdx);
+    }
+
+    // the grid properties are accessed using the index returned by propertyIdx for each
+    // element, i.e., the cartesian index for the global arrays of the EclipseState and
+    // the element index for distributed ones.
+    template <class PropertyIndexFunction>
+    void initParamsForElements_(const Deck& deck, const EclipseState& eclState,
+                                const EclEpsGridProperties& epsGridProperties,
+                                const EclEpsGridProperties& epsImbGridProperties,
+                                unsigned numCompressedElems,
+                                const std::vector<bool>& isReadRegion,
+                                const PropertyIndexFunction& propertyIdx)
+    {
+        const size_t numSatRegions = eclState.runspec().tabdims().getNumSatTables();
+        const std::vector<int>& satnumRegionArray = satnumRegionArray_;
+
+        // read the end point scaling configuration. this needs to be done only once per
+        // deck.
+        auto gasOilConfig = std::make_shared<Opm::EclEpsConfig>();
+        auto oilWaterConfig = std::make_shared<Opm::EclEpsConfig>();
+        gasOilConfig->initFromDeck(deck, eclState, Opm::EclGasOilSystem);
+        oilWaterConfig->initFromDeck(deck, eclState, Opm::EclOilWaterSystem);
+
+        // remember the porosities which are used for the Leverett scaling factors, so
+        // that the factors can be updated if the porosity changes
+        leverettPorosity_.clear();
+        maxPcowMultiplier_.clear();
+        if (eclState.getTableManager().useJFunc()
+            && (gasOilConfig->enableLeverettScaling() || oilWaterConfig->enableLeverettScaling()))
+        {
+            leverettPorosityExponent_ = eclState.getTableManager().getJFunc().alphaFactor();
+            leverettPorosity_.resize(numCompressedElems);
+            for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx)
+                leverettPorosity_[elemIdx] = (*epsGridProperties.poro)[propertyIdx(elemIdx)];
+        }
+
+        // read the saturation region specific parameters from the deck
+        gasOilUnscaledPointsVector_.resize(numSatRegions);
+        oilWaterUnscaledPointsVector_.resize(numSatRegions);
+        gasOilEffectiveParamVector_.resize(numSatRegions);
+        oilWaterEffectiveParamVector_.resize(numSatRegions);
+        for (unsigned satRegionIdx = 0; satRegionIdx < numSatRegions; ++satRegionIdx)
+            if (isReadRegion.empty() || isReadRegion[satRegionIdx])
+                readRegionTables_(deck, eclState, gasOilConfig, oilWaterConfig, satRegionIdx);
+
+        // decks often specify the same saturation functions for many regions. these
+        // regions use the parameter objects of the first one.
+        shareIdenticalObjects(gasOilUnscaledPointsVector_);
+        shareIdenticalObjects(oilWaterUnscaledPointsVector_);
+        shareIdenticalObjects(gasOilEffectiveParamVector_);
+        shareIdenticalObjects(oilWaterEffectiveParamVector_);
+
+        // the scaling info objects which are referenced by the elements that do not
+        // exhibit scaled end points of their own
+        ScalingInfoVector regionEpsInfo(numSatRegions);
+        for (unsigned satRegionIdx = 0; satRegionIdx < numSatRegions; ++satRegionIdx)
+            regionEpsInfo[satRegionIdx] =
+                std::make_shared<EclEpsScalingPointsInfo<Scalar> >(unscaledEpsInfo_[satRegionIdx]);
+
+        // read the scaled end point scaling parameters which are specific for each
+        // element
+        GasOilScalingInfoVector gasOilScaledInfoVector(numCompressedElems);
+        oilWaterScaledEpsInfoDrainage_.resize(numCompressedElems);
+        GasOilScalingInfoVector gasOilScaledImbInfoVector;
+        OilWaterScalingInfoVector oilWaterScaledImbInfoVector;
+
+        GasOilScalingPointsVector gasOilScaledPointsVector(numCompressedElems);
+        GasOilScalingPointsVector oilWaterScaledEpsPointsDrainage(numCompressedElems);
+        GasOilScalingPointsVector gasOilScaledImbPointsVector;
+        OilWaterScalingPointsVector oilWaterScaledImbPointsVector;
+
+        if (enableHysteresis()) {
+            gasOilScaledImbInfoVector.resize(numCompressedElems);
+            gasOilScaledImbPointsVector.resize(numCompressedElems);
+            oilWaterScaledImbInfoVector.resize(numCompressedElems);
+            oilWaterScaledImbPointsVector.resize(numCompressedElems);
+        }
+
+        // extract the scaled end points of all elements. this is done one grid property
+        // at a time, and the result is used for both, the gas-oil and the oil-water
+        // system.
+        std::vector<EclEpsScalingPointsInfo<Scalar> > scaledInfo;
+        std::vector<EclEpsScalingPointsInfo<Scalar> > scaledImbInfo;
+        extractScaledEpsInfo_(scaledInfo, eclState, epsGridProperties, numCompressedElems, propertyIdx);
+        if (enableHysteresis())
+            extractScaledEpsInfo_(scaledImbInfo, eclState, epsImbGridProperties, numCompressedElems, propertyIdx);
+
+        // if the scaling points are quantized, the maxima of the capillary pressure and
+        // of the relative permeabilities are stored relative to scales which are shared
+        // by all elements of a saturation region
+        QuantizationScalesVector gasOilRegionScales;
+        QuantizationScalesVector oilWaterRegionScales;
+        if (ScalingPointsStorageTraits::isQuantized) {
+            std::vector<unsigned> imbRegionIdx;
+            if (enableHysteresis()) {
+                imbRegionIdx.resize(numCompressedElems);
+                for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx)
+                    imbRegionIdx[elemIdx] =
+                        static_cast<unsigned>((*epsImbGridProperties.satnum)[propertyIdx(elemIdx)]) - 1;
+            }
+
+            computeRegionScales_(gasOilRegionScales, *gasOilConfig, EclGasOilSystem,
+                                 numSatRegions, satnumRegionArray, scaledInfo,
+                                 imbRegionIdx, scaledImbInfo);
+            computeRegionScales_(oilWaterRegionScales, *oilWaterConfig, EclOilWaterSystem,
+                                 numSatRegions, satnumRegionArray, scaledInfo,
+                                 imbRegionIdx, scaledImbInfo);
+        }
+
+        // the parameters of the individual elements are independent of each other and
+        // the shared objects are only read in the loops below. thus, they are computed
+        // concurrently if OpenMP is available, each element by the thread which is going
+        // to use it.
+        forEachElementOnOwnerThread_(numCompressedElems, [&](unsigned elemIdx) {
+            unsigned cartElemIdx = propertyIdx(elemIdx);
+            unsigned satRegionIdx = static_cast<unsigned>((*epsGridProperties.satnum)[cartElemIdx]) - 1; // ECL uses Fortran indices!
+            readGasOilScaledPoints_(gasOilScaledInfoVector,
+                                    gasOilScaledPointsVector,
+                                    gasOilConfig,
+                                    scaledInfo[elemIdx],
+                                    elemIdx,
+                                    satRegionIdx,
+                                    regionEpsInfo,
+                                    gasOilRegionScales);
+            readOilWaterScaledPoints_(oilWaterScaledEpsInfoDrainage_,
+                                      oilWaterScaledEpsPointsDrainage,
+                                      oilWaterConfig,
+                                      scaledInfo[elemIdx],
+                                      elemIdx,
+                                      satRegionIdx,
+                                      regionEpsInfo,
+                                      oilWaterRegionScales);
+
+            if (enableHysteresis()) {
+                unsigned imbRegionIdx = static_cast<unsigned>((*epsImbGridProperties.satnum)[cartElemIdx]) - 1;
+                readGasOilScaledPoints_(gasOilScaledImbInfoVector,
+                                        gasOilScaledImbPointsVector,
+                                        gasOilConfig,
+                                        scaledImbInfo[elemIdx],
+                                        elemIdx,
+                                        imbRegionIdx,
+                                        regionEpsInfo,
+                                        gasOilRegionScales);
+                readOilWaterScaledPoints_(oilWaterScaledImbInfoVector,
+                                          oilWaterScaledImbPointsVector,
+                                          oilWaterConfig,
+                                          scaledImbInfo[elemIdx],
+                                          elemIdx,
+                                          imbRegionIdx,
+                                          regionEpsInfo,
+                                          oilWaterRegionScales);
+            }
+        });
+
+        // determine the elements which can use the parameter objects of another one
+        std::vector<unsigned> paramsSourceElemIdx;
+        findIdenticalElements_(paramsSourceElemIdx,
+                               satnumRegionArray,
+                               gasOilScaledInfoVector,
+                               oilWaterScaledEpsInfoDrainage_);
+
+        // the parameter objects of the distinct elements are stored contiguously in
+        // element order. this avoids a large number of small allocations and improves
+        // the memory locality when the elements are processed in sequence. the objects
+        // are constructed by the threads which initialize the elements, so that their
+        // memory is placed on the NUMA node of these threads.
+        std::vector<unsigned> arenaIdx(numCompressedElems);
+        unsigned numDistinctElems = 0;
+        for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx)
+            if (paramsSourceElemIdx[elemIdx] == elemIdx)
+                arenaIdx[elemIdx] = numDistinctElems++;
+
+        // if only two phases are active, the parameter objects of the two-phase system
+        // which is not used by the material law are not created at all.
+        storeGasOilParams_ =
+            threePhaseApproach_ != EclTwoPhaseApproach || twoPhaseApproach_ != EclTwoPhaseOilWater;
+        storeOilWaterParams_ =
+            threePhaseApproach_ != EclTwoPhaseApproach || twoPhaseApproach_ != EclTwoPhaseGasOil;
+
+        auto gasOilParamsArena =
+            std::make_shared<FirstTouchArray<GasOilTwoPhaseHystParams> >(storeGasOilParams_ ? numDistinctElems : 0);
+        auto oilWaterParamsArena =
+            std::make_shared<FirstTouchArray<OilWaterTwoPhaseHystParams> >(storeOilWaterParams_ ? numDistinctElems : 0);
+        auto materialLawParamsArena =
+            std::make_shared<FirstTouchArray<MaterialLawParams> >(numDistinctElems);
+
+        // create the parameter objects for the two-phase laws
+        GasOilParamVector gasOilParams(numCompressedElems);
+        OilWaterParamVector oilWaterParams(numCompressedElems);
+        GasOilParamVector gasOilImbParams;
+        OilWaterParamVector oilWaterImbParams;
+
+        if (enableHysteresis()) {
+            gasOilImbParams.resize(numCompressedElems);
+            oilWaterImbParams.resize(numCompressedElems);
+        }
+
+        bool hasGas = deck.hasKeyword("GAS");
+        bool hasOil = deck.hasKeyword("OIL");
+        bool hasWater = deck.hasKeyword("WATER");
+        hasGasOilParams_ = hasGas && hasOil;
+        hasOilWaterParams_ = hasOil && hasWater;
+
+        assert(numCompressedElems == satnumRegionArray.size());
+        forEachElementOnOwnerThread_(numCompressedElems, [&](unsigned elemIdx) {
+            if (paramsSourceElemIdx[elemIdx] != elemIdx)
+                return;
+
+            unsigned satRegionIdx = static_cast<unsigned>(satnumRegionArray[elemIdx]);
+
+            if (storeGasOilParams_) {
+                gasOilParamsArena->construct(arenaIdx[elemIdx]);
+                gasOilParams[elemIdx] = arenaEntry_(gasOilParamsArena, arenaIdx[elemIdx]);
+                gasOilParams[elemIdx]->setConfig(hysteresisConfig_);
+            }
+            if (storeOilWaterParams_) {
+                oilWaterParamsArena->construct(arenaIdx[elemIdx]);
+                oilWaterParams[elemIdx] = arenaEntry_(oilWaterParamsArena, arenaIdx[elemIdx]);
+                oilWaterParams[elemIdx]->setConfig(hysteresisConfig_);
+            }
+
+            if (hasGas && hasOil) {
+                auto gasOilDrainParams = std::make_shared<GasOilEpsTwoPhaseParams>();
+                gasOilDrainParams->setConfig(gasOilConfig);
+                gasOilDrainParams->setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
+                gasOilDrainParams->setScaledPoints(gasOilScaledPointsVector[elemIdx]);
+                gasOilDrainParams->setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
+                gasOilDrainParams->finalize();
+
+                gasOilParams[elemIdx]->setDrainageParams(gasOilDrainParams,
+                                                         *gasOilScaledInfoVector[elemIdx],
+                                                         EclGasOilSystem);
+            }
+
+            if (hasOil && hasWater) {
+                auto oilWaterDrainParams = std::make_shared<OilWaterEpsTwoPhaseParams>();
+                oilWaterDrainParams->setConfig(oilWaterConfig);
+                oilWaterDrainParams->setUnscaledPoints(oilWaterUnscaledPointsVector_[satRegionIdx]);
+                oilWaterDrainParams->setScaledPoints(oilWaterScaledEpsPointsDrainage[elemIdx]);
+                oilWaterDrainParams->setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
+                oilWaterDrainParams->finalize();
+
+                oilWaterParams[elemIdx]->setDrainageParams(oilWaterDrainParams,
+                                                           *oilWaterScaledEpsInfoDrainage_[elemIdx],
+                                                           EclOilWaterSystem);
+            }
+
+            if (enableHysteresis()) {
+                unsigned imbRegionIdx =
+                    static_cast<unsigned>((*epsImbGridProperties.satnum)[propertyIdx(elemIdx)]) - 1;
+
+                if (hasGas && hasOil) {
+                    auto gasOilImbParamsHyst = std::make_shared<GasOilEpsTwoPhaseParams>();
+                    gasOilImbParamsHyst->setConfig(gasOilConfig);
+                    gasOilImbParamsHyst->setUnscaledPoints(gasOilUnscaledPointsVector_[imbRegionIdx]);
+                    gasOilImbParamsHyst->setScaledPoints(gasOilScaledImbPointsVector[elemIdx]);
+                    gasOilImbParamsHyst->setEffectiveLawParams(gasOilEffectiveParamVector_[imbRegionIdx]);
+                    gasOilImbParamsHyst->finalize();
+
+                    gasOilParams[elemIdx]->setImbibitionParams(gasOilImbParamsHyst,
+                                                               *gasOilScaledImbInfoVector[elemIdx],
+                                                               EclGasOilSystem);
+                }
+
+                if (hasOil && hasWater) {
+                    auto oilWaterImbParamsHyst = std::make_shared<OilWaterEpsTwoPhaseParams>();
+                    oilWaterImbParamsHyst->setConfig(oilWaterConfig);
+                    oilWaterImbParamsHyst->setUnscaledPoints(oilWaterUnscaledPointsVector_[imbRegionIdx]);
+                    oilWaterImbParamsHyst->setScaledPoints(oilWaterScaledImbPointsVector[elemIdx]);
+                    oilWaterImbParamsHyst->setEffectiveLawParams(oilWaterEffectiveParamVector_[imbRegionIdx]);
+                    oilWaterImbParamsHyst->finalize();
+
+                    oilWaterParams[elemIdx]->setImbibitionParams(oilWaterImbParamsHyst,
+                                                                 *gasOilScaledImbInfoVector[elemIdx],
+                                                                 EclGasOilSystem);
+                }
+            }
+
+            if (hasGas && hasOil)
+                gasOilParams[elemIdx]->finalize();
+
+            if (hasOil && hasWater)
+                oilWaterParams[elemIdx]->finalize();
+        });
+
+        // the exponents of the Stone 1 model are read from the deck before the parallel
+        // loop, so that an incomplete STONE1EX keyword is reported as an error
+        std::vector<Scalar> stone1Eta;
+        readStone1Exponents_(stone1Eta, deck, numSatRegions);
+
+        // create the parameter objects for the three-phase law
+        materialLawParams_.resize(numCompressedElems);
+        forEachElementOnOwnerThread_(numCompressedElems, [&](unsigned elemIdx) {
+            if (paramsSourceElemIdx[elemIdx] != elemIdx)
+                return;
+
+            materialLawParamsArena->construct(arenaIdx[elemIdx]);
+            materialLawParams_[elemIdx] = arenaEntry_(materialLawParamsArena, arenaIdx[elemIdx]);
+            unsigned satRegionIdx = static_cast<unsigned>(satnumRegionArray[elemIdx]);
+
+            initThreePhaseParams_(*materialLawParams_[elemIdx],
+                                  stone1Eta[satRegionIdx],
+                                  *oilWaterScaledEpsInfoDrainage_[elemIdx],
+                                  oilWaterParams[elemIdx],
+                                  gasOilParams[elemIdx]);
+
+            materialLawParams_[elemIdx]->finalize();
+        });
+
+        // let the remaining elements point to the objects of their source element
+        elemParamsAreShared_.assign(numCompressedElems, false);
+        for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
+            unsigned srcElemIdx = paramsSourceElemIdx[elemIdx];
+            if (srcElemIdx == elemIdx)
+                continue;
+
+            materialLawParams_[elemIdx] = materialLawParams_[srcElemIdx];
+            elemParamsAreShared_[elemIdx] = true;
+            elemParamsAreShared_[srcElemIdx] = true;
+        }
+
+        updateSatnumRegionOrder_();
+    }
+
+    template <Opm::EclMultiplexerApproach approachV>
+    void bakeThreePhaseParams_(MaterialLawParams& params)
+    {
+        auto& realParams = params.template getRealParams<approachV>();
+
+        if (hasGasOilParams_) {
+            auto& gasOilParams = realParams.gasOilParams();
+            GasOilEpsTwoPhaseLaw::bakeScaling(gasOilParams.drainageParams());
+            if (enableHysteresis())
+                GasOilEpsTwoPhaseLaw::bakeScaling(gasOilParams.imbibitionParams());
+        }
+
+        if (hasOilWaterParams_) {
+            auto& oilWaterParams = realParams.oilWaterParams();
+            OilWaterEpsTwoPhaseLaw::bakeScaling(oilWaterParams.drainageParams());
+            if (enableHysteresis())
+                OilWaterEpsTwoPhaseLaw::bakeScaling(oilWaterParams.imbibitionParams());
+        }
+    }
+
+    void addMaterialLawMemoryUsage_(MemoryUsage& usage,
+                                    std::unordered_set<const void*>& visited,
+                                    const MaterialLawParams& params) const
+    {
+        if (!visited.insert(&params).second)
+            return;
+
+        usage.add("multiplexer params", sizeof(MaterialLawParams));
+        switch (params.approach()) {
+        case EclStone1Approach:
+            addThreePhaseMemoryUsage_<EclStone1Approach>(usage, visited, params);
+            break;
+
+        case EclStone2Approach:
+            addThreePhaseMemoryUsage_<EclStone2Approach>(usage, visited, params);
+            break;
+
+        case EclDefaultApproach:
+            addThreePhaseMemoryUsage_<EclDefaultApproach>(usage, visited, params);
+            break;
+
+        case EclTwoPhaseApproach:
+            addThreePhaseMemoryUsage_<EclTwoPhaseApproach>(usage, visited, params);
+            break;
+        }
+    }
+
+    template <Opm::EclMultiplexerApproach approachV>
+    void addThreePhaseMemoryUsage_(MemoryUsage& usage,
+                                   std::unordered_set<const void*>& visited,
+                                   const MaterialLawParams& params) const
+    {
+        const auto& realParams = params.template getRealParams<approachV>();
+
+        if (storeGasOilParams_)
+            addHysteresisMemoryUsage_(usage, visited, realParams.gasOilParams());
+        if (storeOilWaterParams_)
+            addHysteresisMemoryUsage_(usage, visited, realParams.oilWaterParams());
+        addKroTableMemoryUsage_(usage, visited, realParams, 0);
+    }
+
+    // the tables of the three-phase oil relperm, see tabulateThreePhaseKro(). the
+    // parameters of the two-phase approach do not have one.
+    template <class ThreePhaseParams>
+    static auto addKroTableMemoryUsage_(MemoryUsage& usage,
+                                        std::unordered_set<const void*>& visited,
+                                        const ThreePhaseParams& params,
+                                        int)
+        -> decltype(params.kroTable(), void())
+    {
+        const auto* kroTable = params.kroTable();
+        if (kroTable && visited.insert(kroTable).second)
+            usage.add("three-phase kro tables", sizeof(*kroTable) + kroTable->heapMemoryUsage());
+    }
+
+    template <class ThreePhaseParams>
+    static void addKroTableMemoryUsage_(MemoryUsage&,
+                                        std::unordered_set<const void*>&,
+                                        const ThreePhaseParams&,
+                                        long)
+    { }
+
+    template <class ThreePhaseParams>
+    static auto dropKroTable_(ThreePhaseParams& params, int)
+        -> decltype(params.setKroTable(nullptr), void())
+    { params.setKroTable(nullptr); }
+
+    template <class ThreePhaseParams>
+    static void dropKroTable_(ThreePhaseParams&, long)
+    { }
+
+    template <class ThreePhaseLaw, Opm::EclMultiplexerApproach approachV>
+    unsigned tabulateThreePhaseKro_(Scalar tolerance, unsigned maxNumSamples)
+    {
+        typedef typename ThreePhaseLaw::Params ThreePhaseParams;
+        typedef typename ThreePhaseParams::KroTable KroTable;
+
+        // the table of each region is computed when it is needed for the first time.
+        // regions for which this failed are marked as such.
+        std::vector<std::shared_ptr<KroTable> > regionTables(numSatnumRegions());
+        std::vector<bool> regionTried(numSatnumRegions(), false);
+
+        unsigned numTabulatedElems = 0;
+        for (unsigned elemIdx = 0; elemIdx < materialLawParams_.size(); ++elemIdx) {
+            const unsigned satRegionIdx = static_cast<unsigned>(satnumRegionArray_[elemIdx]);
+            if (!elemParamsAreShared_[elemIdx]
+                || !(*oilWaterScaledEpsInfoDrainage_[elemIdx] == unscaledEpsInfo_[satRegionIdx]))
+                continue;
+
+            auto& params = materialLawParams_[elemIdx]->template getRealParams<approachV>();
+            if (!regionTried[satRegionIdx]) {
+                regionTried[satRegionIdx] = true;
+                regionTables[satRegionIdx] =
+                    tabulateEclThreePhaseKro<ThreePhaseLaw>(params, tolerance, maxNumSamples);
+            }
+
+            if (!regionTables[satRegionIdx])
+                continue;
+
+            params.setKroTable(regionTables[satRegionIdx]);
+            ++numTabulatedElems;
+        }
+
+        return numTabulatedElems;
+    }
+
+    template <class HystParams>
+    void addHysteresisMemoryUsage_(MemoryUsage& usage,
+                                   std::unordered_set<const void*>& visited,
+                                   const HystParams& hystParams) const
+    {
+        if (!visited.insert(&hystParams).second)
+            return;
+
+        // the parameters of the drainage and imbibition curves are stored inline, and
+        // so are their scaled points
+        usage.add("hysteresis params", sizeof(HystParams) - 2*sizeof(ScalingPoints));
+        usage.add("scaling points", 2*sizeof(ScalingPoints));
+
+        addEpsMemoryUsage_(usage, visited, hystParams.drainageParams());
+        if (enableHysteresis())
+            addEpsMemoryUsage_(usage, visited, hystParams.imbibitionParams());
+    }
+
+    template <class EpsParams>
+    void addEpsMemoryUsage_(MemoryUsage& usage,
+                            std::unordered_set<const void*>& visited,
+                            const EpsParams& epsParams) const
+    {
+        if (epsParams.hasBakedLawParams())
+            addEffectiveMemoryUsage_(usage, visited, &epsParams.bakedLawParams());
+    }
+
+    template <class EffParams>
+    void addEffectiveMemoryUsage_(MemoryUsage& usage,
+                                  std::unordered_set<const void*>& visited,
+                                  const EffParams* effParams) const
+    {
+        if (!effParams || !visited.insert(effParams).second)
+            return;
+
+        usage.add("effective params", sizeof(EffParams) + effParams->heapMemoryUsage());
+    }
+
+    template <class T>
+    void addSharedMemoryUsage_(MemoryUsage& usage,
+                               std::unordered_set<const void*>& visited,
+                               const std::string& category,
+                               const std::vector<std::shared_ptr<T> >& objects) const
+    {
+        for (const auto& object : objects)
+            if (object && visited.insert(object.get()).second)
+                usage.add(category, sizeof(T));
+    }
+
+    // 'fluidStates[i]' is the fluid state of the element 'fluidStatesBeginIdx + i'
+    template <class FluidStateContainer>
+    unsigned updateHysteresisBlock_(const FluidStateContainer& fluidStates,
+                                    unsigned fluidStatesBeginIdx,
+                                    unsigned beginElemIdx,
+                                    unsigned endElemIdx,
+                                    std::vector<unsigned>* updatedElems)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMaterialLawManager::updateHysteresis");
+
+        switch (threePhaseApproach_) {
+        case EclStone1Approach:
+            return updateHysteresisRange_<typename MaterialLaw::Stone1Material, EclStone1Approach>
+                (fluidStates, fluidStatesBeginIdx, beginElemIdx, endElemIdx, updatedElems);
+
+        case EclStone2Approach:
+            return updateHysteresisRange_<typename MaterialLaw::Stone2Material, EclStone2Approach>
+                (fluidStates, fluidStatesBeginIdx, beginElemIdx, endElemIdx, updatedElems);
+
+        case EclDefaultApproach:
+            return updateHysteresisRange_<typename MaterialLaw::DefaultMaterial, EclDefaultApproach>
+                (fluidStates, fluidStatesBeginIdx, beginElemIdx, endElemIdx, updatedElems);
+
+        case EclTwoPhaseApproach:
+            return updateHysteresisRange_<typename MaterialLaw::TwoPhaseMaterial, EclTwoPhaseApproach>
+                (fluidStates, fluidStatesBeginIdx, beginElemIdx, endElemIdx, updatedElems);
+        }
+
+        return 0;
+    }
+
+    template <class ThreePhaseLaw,
+              Opm::EclMultiplexerApproach approachV,
+              class FluidStateContainer>
+    unsigned updateHysteresisRange_(const FluidStateContainer& fluidStates,
+                                    unsigned fluidStatesBeginIdx,
+                                    unsigned beginElemIdx,
+                                    unsigned endElemIdx,
+                                    std::vector<unsigned>* updatedElems)
+    {
+        assert(fluidStatesBeginIdx <= beginElemIdx);
+        assert(beginElemIdx <= endElemIdx && endElemIdx <= materialLawParams_.size());
+        unsigned numUpdated = 0;
+        for (unsigned elemIdx = beginElemIdx; elemIdx < endElemIdx; ++elemIdx) {
+            auto& params = materialLawParams_[elemIdx]->template getRealParams<approachV>();
+            if (!ThreePhaseLaw::updateHysteresis(params, fluidStates[elemIdx - fluidStatesBeginIdx]))
+                continue;
+
+            ++numUpdated;
+            if (updatedElems)
+                updatedElems->push_back(elemIdx);
+
+            // the connection objects of an element are not shared with other elements,
+            // so this is safe if the threads process disjoint ranges of elements
+            updateConnectionHysteresis_(elemIdx);
+        }
+
+        return numUpdated;
+    }
+
+    // copy the hysteresis state of an element to the parameter objects of its well
+    // connections
+    void updateConnectionHysteresis_(unsigned elemIdx) const
+    {
+        if (hysteresisConnections_.empty())
+            return;
+
+        const auto connRange = hysteresisConnections_.equal_range(elemIdx);
+        for (auto connIt = connRange.first; connIt != connRange.second; ++connIt)
+            updateConnectionHysteresis_(*materialLawParams_[elemIdx], *connIt->second);
+    }
+
+    void updateConnectionHysteresis_(const MaterialLawParams& elemParams,
+                                     MaterialLawParams& connParams) const
+    {
+        Scalar pcSwMdc;
+        Scalar krnSwMdc;
+        if (storeOilWaterParams_) {
+            MaterialLaw::oilWaterHysteresisParams(pcSwMdc, krnSwMdc, elemParams);
+            MaterialLaw::setOilWaterHysteresisParams(pcSwMdc, krnSwMdc, connParams);
+        }
+
+        if (storeGasOilParams_) {
+            MaterialLaw::gasOilHysteresisParams(pcSwMdc, krnSwMdc, elemParams);
+            MaterialLaw::setGasOilHysteresisParams(pcSwMdc, krnSwMdc, connParams);
+        }
+    }
+
+    // call the functor with a compile-time constant for the three-phase approach
+    template <class Functor>
+    void dispatchApproach_(const Functor& functor) const
+    {
+        switch (threePhaseApproach_) {
+        case EclStone1Approach:
+            functor.template apply<EclStone1Approach>();
+            break;
+
+        case EclStone2Approach:
+            functor.template apply<EclStone2Approach>();
+            break;
+
+        case EclDefaultApproach:
+            functor.template apply<EclDefaultApproach>();
+            break;
+
+        case EclTwoPhaseApproach:
+            functor.template apply<EclTwoPhaseApproach>();
+            break;
+        }
+    }
+
+    struct HysteresisStateSaver_
+    {
+        HysteresisStateSaver_(const EclMaterialLawManager& manager, HysteresisState& state)
+            : manager_(manager), state_(state)
+        {}
+
+        template <Opm::EclMultiplexerApproach approachV>
+        void apply() const
+        {
+            const auto& paramsVector = manager_.materialLawParams_;
+            for (size_t elemIdx = 0; elemIdx < paramsVector.size(); ++elemIdx) {
+                const auto& params = paramsVector[elemIdx]->template getRealParams<approachV>();
+
+                if (manager_.hasOilWaterParams_) {
+                    const auto& oilWaterParams = params.oilWaterParams();
+                    state_.oilWaterPcSwMdc[elemIdx] = oilWaterParams.pcSwMdc();
+                    state_.oilWaterKrnSwMdc[elemIdx] = oilWaterParams.krnSwMdc();
+                    state_.oilWaterDeltaSwImbKrn[elemIdx] = oilWaterParams.deltaSwImbKrn();
+                }
+
+                if (manager_.hasGasOilParams_) {
+                    const auto& gasOilParams = params.gasOilParams();
+                    state_.gasOilPcSwMdc[elemIdx] = gasOilParams.pcSwMdc();
+                    state_.gasOilKrnSwMdc[elemIdx] = gasOilParams.krnSwMdc();
+                    state_.gasOilDeltaSwImbKrn[elemIdx] = gasOilParams.deltaSwImbKrn();
+                }
+            }
+        }
+
+        const EclMaterialLawManager& manager_;
+        HysteresisState& state_;
+    };
+
+    struct HysteresisStateRestorer_
+    {
+        HysteresisStateRestorer_(const EclMaterialLawManager& manager, const HysteresisState& state)
+            : manager_(manager), state_(state)
+        {}
+
+        template <Opm::EclMultiplexerApproach approachV>
+        void apply() const
+        {
+            const auto& paramsVector = manager_.materialLawParams_;
+            for (size_t elemIdx = 0; elemIdx < paramsVector.size(); ++elemIdx) {
+                auto& params = paramsVector[elemIdx]->template getRealParams<approachV>();
+
+                if (manager_.hasOilWaterParams_) {
+                    auto& oilWaterParams = params.oilWaterParams();
+                    oilWaterParams.setPcSwMdc(state_.oilWaterPcSwMdc[elemIdx]);
+                    oilWaterParams.setKrnSwMdc(state_.oilWaterKrnSwMdc[elemIdx]);
+                    oilWaterParams.setDeltaSwImbKrn(state_.oilWaterDeltaSwImbKrn[elemIdx]);
+                }
+
+                if (manager_.hasGasOilParams_) {
+                    auto& gasOilParams = params.gasOilParams();
+                    gasOilParams.setPcSwMdc(state_.gasOilPcSwMdc[elemIdx]);
+                    gasOilParams.setKrnSwMdc(state_.gasOilKrnSwMdc[elemIdx]);
+                    gasOilParams.setDeltaSwImbKrn(state_.gasOilDeltaSwImbKrn[elemIdx]);
+                }
+            }
+        }
+
+        const EclMaterialLawManager& manager_;
+        const HysteresisState& state_;
+    };
+
+    template <bool computeKr, class Evaluation>
+    void evalRange_(Evaluation* const* result,
+                    const Evaluation* const* saturations,
+                    unsigned beginElemIdx,
+                    unsigned endElemIdx) const
+    {
+        switch (threePhaseApproach_) {
+        case EclStone1Approach:
+            if (computeKr)
+                evalStoneKrRange_<typename MaterialLaw::Stone1Material, EclStone1Approach>
+                    (result, saturations, beginElemIdx, endElemIdx);
+            else
+                evalRangeWith_<typename MaterialLaw::Stone1Material, EclStone1Approach, computeKr>
+                    (result, saturations, beginElemIdx, endElemIdx);
+            break;
+
+        case EclStone2Approach:
+            if (computeKr)
+                evalStoneKrRange_<typename MaterialLaw::Stone2Material, EclStone2Approach>
+                    (result, saturations, beginElemIdx, endElemIdx);
+            else
+                evalRangeWith_<typename MaterialLaw::Stone2Material, EclStone2Approach, computeKr>
+                    (result, saturations, beginElemIdx, endElemIdx);
+            break;
+
+        case EclDefaultApproach:
+            evalRangeWith_<typename MaterialLaw::DefaultMaterial, EclDefaultApproach, computeKr>
+                (result, saturations, beginElemIdx, endElemIdx);
+            break;
+
+        case EclTwoPhaseApproach:
+            if (twoPhaseApproach_ == EclTwoPhaseOilWater)
+                evalOilWaterRange_<computeKr>(result, saturations, beginElemIdx, endElemIdx);
+            else
+                evalRangeWith_<typename MaterialLaw::TwoPhaseMaterial, EclTwoPhaseApproach, computeKr>
+                    (result, saturations, beginElemIdx, endElemIdx);
+            break;
+        }
+    }
+
+    // evaluate a set of elements whose data is indexed by the element index. runs of
+    // consecutive elements are evaluated by evalRange_().
+    template <bool computeKr, class InputEvaluation, class Evaluation>
+    void evalElements_(Evaluation* const* result,
+                       const InputEvaluation* const* saturations,
+                       const unsigned* elemIdxBegin,
+                       const unsigned* elemIdxEnd) const
+    {
+        Evaluation* runResult[numPhases];
+        const InputEvaluation* runSaturations[numPhases];
+        Opm::DecayedArrays<Evaluation, InputEvaluation, numPhases> runSat;
+
+        const unsigned* runBegin = elemIdxBegin;
+        while (runBegin != elemIdxEnd) {
+            const unsigned* runEnd = runBegin + 1;
+            while (runEnd != elemIdxEnd && *runEnd == *(runEnd - 1) + 1)
+                ++runEnd;
+
+            unsigned beginElemIdx = *runBegin;
+            unsigned endElemIdx = *(runEnd - 1) + 1;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                runResult[phaseIdx] = result[phaseIdx] + beginElemIdx;
+                runSaturations[phaseIdx] = saturations[phaseIdx] + beginElemIdx;
+            }
+
+            runSat.assign(runSaturations, endElemIdx - beginElemIdx);
+            evalRange_<computeKr>(runResult, runSat.arrays(), beginElemIdx, endElemIdx);
+            runBegin = runEnd;
+        }
+    }
+
+    // sort the elements by their saturation region using a counting sort
+    void updateSatnumRegionOrder_()
+    {
+        unsigned numRegions = numSatnumRegions();
+        satnumRegionOffsets_.assign(numRegions + 1, 0);
+        for (int satRegionIdx : satnumRegionArray_)
+            ++satnumRegionOffsets_[satRegionIdx + 1];
+        for (unsigned satRegionIdx = 0; satRegionIdx < numRegions; ++satRegionIdx)
+            satnumRegionOffsets_[satRegionIdx + 1] += satnumRegionOffsets_[satRegionIdx];
+
+        std::vector<unsigned> nextPos(satnumRegionOffsets_.begin(), satnumRegionOffsets_.end() - 1);
+        satnumRegionOrder_.resize(satnumRegionArray_.size());
+        for (unsigned elemIdx = 0; elemIdx < satnumRegionArray_.size(); ++elemIdx)
+            satnumRegionOrder_[nextPos[satnumRegionArray_[elemIdx]]++] = elemIdx;
+    }
+
+    // if only oil and water are active, the two-phase law of the oil-water system is
+    // evaluated directly. this avoids setting up a fluid state and dispatching on the
+    // two-phase approach for each element.
+    template <bool computeKr, class Evaluation>
+    void evalOilWaterRange_(Evaluation* const* result,
+                            const Evaluation* const* saturations,
+                            unsigned beginElemIdx,
+                            unsigned endElemIdx) const
+    {
+        assert(beginElemIdx <= endElemIdx && endElemIdx <= materialLawParams_.size());
+        const Evaluation* Sw = saturations[waterPhaseIdx];
+        unsigned numElems = endElemIdx - beginElemIdx;
+
+        if (computeKr) {
+            // the hysteresis law sorts the elements by the curve they are on
+            const auto& paramsVector = materialLawParams_;
+            auto paramsOf = [&paramsVector, beginElemIdx](size_t i) -> const OilWaterTwoPhaseHystParams& {
+                return paramsVector[beginElemIdx + i]->template getRealParams<EclTwoPhaseApproach>().oilWaterParams();
+            };
+            OilWaterTwoPhaseLaw::twoPhaseSatKrMany(result[waterPhaseIdx],
+                                                   result[oilPhaseIdx],
+                                                   paramsOf,
+                                                   Sw,
+                                                   numElems);
+        }
+
+        for (unsigned i = 0; i < numElems; ++i) {
+            if (!computeKr) {
+                const auto& params =
+                    materialLawParams_[beginElemIdx + i]->template getRealParams<EclTwoPhaseApproach>().oilWaterParams();
+                result[waterPhaseIdx][i] = 0.0;
+                result[oilPhaseIdx][i] = OilWaterTwoPhaseLaw::twoPhaseSatPcnw(params, Sw[i]);
+            }
+            result[gasPhaseIdx][i] = 0.0;
+        }
+    }
+
+    template <class ThreePhaseLaw,
+              Opm::EclMultiplexerApproach approachV,
+              bool computeKr,
+              class Evaluation>
+    void evalRangeWith_(Evaluation* const* result,
+                        const Evaluation* const* saturations,
+                        unsigned beginElemIdx,
+                        unsigned endElemIdx) const
+    {
+        typedef Opm::SimpleModularFluidState<Evaluation,
+                                             numPhases,
+                                             /*numComponents=*/0,
+                                             /*FluidSystem=*/void, /* -> don't care */
+                                             /*storePressure=*/false,
+                                             /*storeTemperature=*/false,
+                                             /*storeComposition=*/false,
+                                             /*storeFugacity=*/false,
+                                             /*storeSaturation=*/true,
+                                             /*storeDensity=*/false,
+                                             /*storeViscosity=*/false,
+                                             /*storeEnthalpy=*/false> FluidState;
+        FluidState fs;
+        Evaluation values[numPhases];
+
+        assert(beginElemIdx <= endElemIdx && endElemIdx <= materialLawParams_.size());
+        for (unsigned elemIdx = beginElemIdx; elemIdx < endElemIdx; ++elemIdx) {
+            unsigned i = elemIdx - beginElemIdx;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                fs.setSaturation(phaseIdx, saturations[phaseIdx][i]);
+
+            const auto& params = materialLawParams_[elemIdx]->template getRealParams<approachV>();
+            if (computeKr)
+                ThreePhaseLaw::relativePermeabilities(values, params, fs);
+            else
+                ThreePhaseLaw::capillaryPressures(values, params, fs);
+
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                result[phaseIdx][i] = values[phaseIdx];
+        }
+    }
+
+    // the Stone laws provide a kernel which computes the relative permeabilities for
+    // arrays of saturations that use the same parameters. Since the parameters of
+    // identical elements are shared, the range is split into runs of consecutive
+    // elements which use the same parameter object.
+    template <class ThreePhaseLaw,
+              Opm::EclMultiplexerApproach approachV,
+              class Evaluation>
+    void evalStoneKrRange_(Evaluation* const* kr,
+                           const Evaluation* const* saturations,
+                           unsigned beginElemIdx,
+                           unsigned endElemIdx) const
+    {
+        Evaluation* runKr[numPhases];
+        const Evaluation* runSaturations[numPhases];
+
+        assert(beginElemIdx <= endElemIdx && endElemIdx <= materialLawParams_.size());
+        unsigned runBeginIdx = beginElemIdx;
+        while (runBeginIdx < endElemIdx) {
+            const MaterialLawParams* runParams = materialLawParams_[runBeginIdx].get();
+            unsigned runEndIdx = runBeginIdx + 1;
+            while (runEndIdx < endElemIdx && materialLawParams_[runEndIdx].get() == runParams)
+                ++runEndIdx;
+
+            unsigned offset = runBeginIdx - beginElemIdx;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                runKr[phaseIdx] = kr[phaseIdx] + offset;
+                runSaturations[phaseIdx] = saturations[phaseIdx] + offset;
+            }
+
+            ThreePhaseLaw::relativePermeabilitiesMany(runKr,
+                                                      runParams->template getRealParams<approachV>(),
+                                                      runSaturations,
+                                                      runEndIdx - runBeginIdx);
+            runBeginIdx = runEndIdx;
+        }
+    }
+
+    /*!
+     * \brief Returns a pointer to an object of an arena which keeps the arena alive.
+     */
+    template <class Arena>
+    static std::shared_ptr<typename Arena::value_type> arenaEntry_(const std::shared_ptr<Arena>& arena,
+                                                                   unsigned idx)
+    { return std::shared_ptr<typename Arena::value_type>(arena, &(*arena)[idx]); }
+
+    /*!
+     * \brief Call a function for each element on the thread which the element is
+     *        mapped to.
+     *
+     * See setElementThreadMapping(). Without OpenMP, the elements are processed in
+     * ascending order. Exceptions must not escape from an OpenMP region, so the first
+     * exception thrown by the function is caught and rethrown after all threads are
+     * done. The remaining elements are skipped in this case.
+     */
+    template <class Function>
+    void forEachElementOnOwnerThread_(unsigned numElems, const Function& fn) const
+    {
+        if (!elemThreadMapping_.empty() && elemThreadMapping_.size() != numElems)
+            OPM_THROW(std::invalid_argument,
+                      "The thread mapping must specify a thread for each of the "
+                      << numElems << " elements (has " << elemThreadMapping_.size() << ")");
+
+        std::exception_ptr exception;
+        bool failed = false;
+        auto guardedFn = [&fn, &exception, &failed](unsigned elemIdx) {
+            bool skip;
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+            skip = failed;
+            if (skip)
+                return;
+
+            try {
+                fn(elemIdx);
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical(EclMaterialLawManagerException)
+#endif
+                {
+                    if (!exception)
+                        exception = std::current_exception();
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                    failed = true;
+                }
+            }
+        };
+
+#ifdef _OPENMP
+        if (!elemThreadMapping_.empty()) {
+            const std::vector<unsigned>& threadOfElem = elemThreadMapping_;
+#pragma omp parallel
+            {
+                unsigned threadIdx = static_cast<unsigned>(omp_get_thread_num());
+                unsigned numThreads = static_cast<unsigned>(omp_get_num_threads());
+                for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+                    if (threadOfElem[elemIdx] % numThreads == threadIdx)
+                        guardedFn(elemIdx);
+            }
+        }
+        else {
+#pragma omp parallel for schedule(static)
+#endif
+            for (int elemIdx = 0; elemIdx < static_cast<int>(numElems); ++elemIdx)
+                guardedFn(static_cast<unsigned>(elemIdx));
+#ifdef _OPENMP
+        }
+#endif
+
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    /*!
+     * \brief Find the elements which exhibit the same material law parameters.
+     *
+     * This is the case if two elements are located in the same saturation region and
+     * their scaled end points are identical. Since the hysteresis parameters carry state
+     * which is specific for each element, no parameter objects are shared if hysteresis
+     * is enabled. For each element, the index of the element whose parameter objects it
+     * uses is stored in 'srcElemIdx'.
+     */
+    void findIdenticalElements_(std::vector<unsigned>& srcElemIdx,
+                                const std::vector<int>& satnumRegionArray,
+                                const GasOilScalingInfoVector& gasOilScaledInfoVector,
+                                OilWaterScalingInfoVector& oilWaterScaledInfoVector) const
+    {
+        unsigned numCompressedElems = static_cast<unsigned>(satnumRegionArray.size());
+        srcElemIdx.resize(numCompressedElems);
+        for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx)
+            srcElemIdx[elemIdx] = elemIdx;
+
+        if (enableHysteresis())
+            return;
+
+        // the candidates of each hash value. the hash only considers a few of the
+        // scaling points, the equality is checked for all of them.
+        std::hash<Scalar> scalarHash;
+        std::unordered_map<size_t, std::vector<unsigned> > candidates;
+        for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
+            const auto& gasOilInfo = *gasOilScaledInfoVector[elemIdx];
+            const auto& oilWaterInfo = *oilWaterScaledInfoVector[elemIdx];
+
+            size_t hash = static_cast<size_t>(satnumRegionArray[elemIdx]);
+            hash = hash*31 + scalarHash(oilWaterInfo.Swl);
+            hash = hash*31 + scalarHash(oilWaterInfo.Swcr);
+            hash = hash*31 + scalarHash(oilWaterInfo.Swu);
+            hash = hash*31 + scalarHash(oilWaterInfo.maxPcow);
+            hash = hash*31 + scalarHash(gasOilInfo.Sgl);
+            hash = hash*31 + scalarHash(gasOilInfo.Sgcr);
+            hash = hash*31 + scalarHash(gasOilInfo.Sgu);
+            hash = hash*31 + scalarHash(gasOilInfo.maxPcgo);
+
+            auto& hashCandidates = candidates[hash];
+            for (unsigned candidateIdx : hashCandidates) {
+                if (satnumRegionArray[candidateIdx] == satnumRegionArray[elemIdx]
+                    && *gasOilScaledInfoVector[candidateIdx] == gasOilInfo
+                    && *oilWaterScaledInfoVector[candidateIdx] == oilWaterInfo)
+                {
+                    srcElemIdx[elemIdx] = candidateIdx;
+                    break;
+                }
+            }
+
+            if (srcElemIdx[elemIdx] == elemIdx)
+                hashCandidates.push_back(elemIdx);
+            else
+                // the scaling info of the element is identical to the one of the source
+                oilWaterScaledInfoVector[elemIdx] = oilWaterScaledInfoVector[srcElemIdx[elemIdx]];
+        }
+    }
+
+    // the data which is not specific to individual elements
+    void serializeRegionData_(BinaryWriter& writer) const
+    {
+        writer.write(enableEndPointScaling_);
+        writer.write(hasGasOilParams_);
+        writer.write(hasOilWaterParams_);
+        writer.write(storeGasOilParams_);
+        writer.write(storeOilWaterParams_);
+        writer.writeShared(hysteresisConfig_);
+        writer.writeShared(oilWaterEclEpsConfig_);
+        writer.write(static_cast<std::int32_t>(threePhaseApproach_));
+        writer.write(static_cast<std::int32_t>(twoPhaseApproach_));
+
+        writer.write(unscaledEpsInfo_);
+        writer.writeSharedObjects(gasOilUnscaledPointsVector_);
+        writer.writeSharedObjects(oilWaterUnscaledPointsVector_);
+        writer.writeSharedObjects(gasOilEffectiveParamVector_);
+        writer.writeSharedObjects(oilWaterEffectiveParamVector_);
+
+        bool hasLeverettPorosity = !leverettPorosity_.empty();
+        writer.write(leverettPorosityExponent_);
+        writer.write(hasLeverettPorosity);
+
+        bool hasMaxPcowMultiplier = !maxPcowMultiplier_.empty();
+        writer.write(hasMaxPcowMultiplier);
+    }
+
+    void serializeElement_(BinaryWriter& writer, unsigned elemIdx) const
     {
-        hysteresisConfig_ = std::make_shared<Opm::EclHysteresisConfig>();
-        hysteresisConfig_->initFromDeck(deck);
+        writer.writeShared(oilWaterScaledEpsInfoDrainage_[elemIdx]);
+        writer.writeShared(materialLawParams_[elemIdx]);
+        writer.write(static_cast<std::uint8_t>(elemParamsAreShared_[elemIdx]));
+        writer.write(static_cast<std::int32_t>(satnumRegionArray_[elemIdx]));
+        if (!leverettPorosity_.empty())
+            writer.write(leverettPorosity_[elemIdx]);
+        if (!maxPcowMultiplier_.empty())
+            writer.write(maxPcowMultiplier_[elemIdx]);
     }
 
-    void readGlobalThreePhaseOptions_(const Opm::Deck& deck)
+    // adjust the water saturation of an element for SWATINIT and return the factor by
+    // which its maximum oil-water capillary pressure needs to be scaled. if the
+    // element does not need to be modified, a negative value is returned.
+    Scalar swatinitMaxPcowFactor_(unsigned elemIdx, Scalar pcow, Scalar& Sw) const
     {
-        bool gasEnabled = deck.hasKeyword("GAS");
-        bool oilEnabled = deck.hasKeyword("OIL");
-        bool waterEnabled = deck.hasKeyword("WATER");
-
-        int numEnabled =
-            (gasEnabled?1:0)
-            + (oilEnabled?1:0)
-            + (waterEnabled?1:0);
+        const auto& elemScaledEpsInfo = *oilWaterScaledEpsInfoDrainage_[elemIdx];
 
-        if (numEnabled < 2)
-            OPM_THROW(std::runtime_error,
-                      "At least two fluid phases must be enabled. (Is: " << numEnabled << ")");
+        // TODO: Mixed wettability systems - see ecl kw OPTIONS switch 74
 
-        if (numEnabled == 2) {
-            threePhaseApproach_ = Opm::EclTwoPhaseApproach;
-            if (!gasEnabled)
-                twoPhaseApproach_ = Opm::EclTwoPhaseOilWater;
-            else if (!oilEnabled)
-                twoPhaseApproach_ = Opm::EclTwoPhaseGasWater;
-            else if (!waterEnabled)
-                twoPhaseApproach_ = Opm::EclTwoPhaseGasOil;
+        if (pcow < 0.0) {
+            Sw = elemScaledEpsInfo.Swu;
+            return -1.0;
         }
-        else {
-            assert(numEnabled == 3);
 
-            threePhaseApproach_ = Opm::EclDefaultApproach;
-            if (deck.hasKeyword("STONE") || deck.hasKeyword("STONE2"))
-                threePhaseApproach_ = Opm::EclStone2Approach;
-            else if (deck.hasKeyword("STONE1"))
-                threePhaseApproach_ = Opm::EclStone1Approach;
-        }
+        if (Sw <= elemScaledEpsInfo.Swl)
+            Sw = elemScaledEpsInfo.Swl;
+
+        Scalar pcowAtSw = oilWaterPcnw_(*materialLawParams_[elemIdx], Sw);
+        if (pcowAtSw > 0.0)
+            return pcow/pcowAtSw;
+
+        return -1.0;
     }
 
-    void initParamsForElements_(const Deck& deck, const EclipseState& eclState,
-                                const std::vector<int>& compressedToCartesianElemIdx,
-                                const std::vector<int>& satnumRegionArray)
+    // the oil-water capillary pressure at a given water saturation if neither oil nor
+    // gas are present. this is what the three-phase laws yield for pc_o - pc_w, but
+    // only the two-phase law of the oil-water system needs to be evaluated.
+    Scalar oilWaterPcnw_(const MaterialLawParams& params, Scalar Sw) const
     {
-        const size_t numSatRegions = eclState.runspec().tabdims().getNumSatTables();
-        unsigned numCompressedElems = static_cast<unsigned>(compressedToCartesianElemIdx.size());
-
-        // read the end point scaling configuration. this needs to be done only once per
-        // deck.
-        auto gasOilConfig = std::make_shared<Opm::EclEpsConfig>();
-        auto oilWaterConfig = std::make_shared<Opm::EclEpsConfig>();
-        gasOilConfig->initFromDeck(deck, eclState, Opm::EclGasOilSystem);
-        oilWaterConfig->initFromDeck(deck, eclState, Opm::EclOilWaterSystem);
+        switch (params.approach()) {
+        case EclStone1Approach:
+            return OilWaterTwoPhaseLaw::twoPhaseSatPcnw(
+                params.template getRealParams<EclStone1Approach>().oilWaterParams(), Sw);
+
+        case EclStone2Approach:
+            return OilWaterTwoPhaseLaw::twoPhaseSatPcnw(
+                params.template getRealParams<EclStone2Approach>().oilWaterParams(), Sw);
+
+        case EclDefaultApproach:
+            return OilWaterTwoPhaseLaw::twoPhaseSatPcnw(
+                params.template getRealParams<EclDefaultApproach>().oilWaterParams(), Sw);
+
+        case EclTwoPhaseApproach:
+            // the two-phase gas-oil and gas-water systems do not exhibit an oil-water
+            // capillary pressure
+            if (twoPhaseApproach_ != EclTwoPhaseOilWater)
+                return 0.0;
+            return OilWaterTwoPhaseLaw::twoPhaseSatPcnw(
+                params.template getRealParams<EclTwoPhaseApproach>().oilWaterParams(), Sw);
+        }
 
-        // read the saturation region specific parameters from the deck
-        gasOilUnscaledPointsVector_.resize(numSatRegions);
-        oilWaterUnscaledPointsVector_.resize(numSatRegions);
-        gasOilEffectiveParamVector_.resize(numSatRegions);
-        oilWaterEffectiveParamVector_.resize(numSatRegions);
-        for (unsigned satRegionIdx = 0; satRegionIdx < numSatRegions; ++satRegionIdx) {
-            // unscaled points for end-point scaling
-            readGasOilUnscaledPoints_(gasOilUnscaledPointsVector_, gasOilConfig, deck, eclState, satRegionIdx);
-            readOilWaterUnscaledPoints_(oilWaterUnscaledPointsVector_, oilWaterConfig, deck, eclState, satRegionIdx);
+        return 0.0;
+    }
 
-            // the parameters for the effective two-phase matererial laws
-            readGasOilEffectiveParameters_(gasOilEffectiveParamVector_, deck, eclState, satRegionIdx);
-            readOilWaterEffectiveParameters_(oilWaterEffectiveParamVector_, deck, eclState, satRegionIdx);
+    // scale the maximum oil-water capillary pressure of an element which does not share
+    // its parameter objects. the scaling info is left alone, so that it can stay
+    // shared with the other elements of the saturation region.
+    void scaleMaxPcow_(unsigned elemIdx, Scalar factor)
+    {
+        maxPcowMultiplier_[elemIdx] *= factor;
 
-            // read the end point scaling info for the saturation region
-            unscaledEpsInfo_[satRegionIdx].extractUnscaled(deck, eclState, satRegionIdx);
+        auto& elemEclEpsScalingPoints = oilWaterScaledEpsPointsDrainage(elemIdx);
+        elemEclEpsScalingPoints.init(oilWaterScaledEpsInfoDrainage(elemIdx),
+                                     *oilWaterEclEpsConfig_,
+                                     Opm::EclOilWaterSystem);
+    }
 
-        }
+    // the multipliers of the maximum oil-water capillary pressure are only stored
+    // once an element has been modified by SWATINIT
+    void allocateMaxPcowMultipliers_()
+    {
+        if (maxPcowMultiplier_.empty())
+            maxPcowMultiplier_.resize(materialLawParams_.size(), 1.0);
+    }
 
-        // read the scaled end point scaling parameters which are specific for each
-        // element
-        GasOilScalingInfoVector gasOilScaledInfoVector(numCompressedElems);
-        oilWaterScaledEpsInfoDrainage_.resize(numCompressedElems);
-        GasOilScalingInfoVector gasOilScaledImbInfoVector;
-        OilWaterScalingInfoVector oilWaterScaledImbInfoVector;
+    /*!
+     * \brief Give an element its own copy of the oil-water scaling info.
+     *
+     * Elements without scaled end points of their own reference the info object of
+     * their saturation region, so it must be copied before it is modified.
+     */
+    void makeElemEpsInfoUnique_(unsigned elemIdx)
+    {
+        auto& info = oilWaterScaledEpsInfoDrainage_[elemIdx];
+        if (info.use_count() > 1)
+            info = std::make_shared<EclEpsScalingPointsInfo<Scalar> >(*info);
+    }
 
-        GasOilScalingPointsVector gasOilScaledPointsVector(numCompressedElems);
-        GasOilScalingPointsVector oilWaterScaledEpsPointsDrainage(numCompressedElems);
-        GasOilScalingPointsVector gasOilScaledImbPointsVector;
-        OilWaterScalingPointsVector oilWaterScaledImbPointsVector;
+    /*!
+     * \brief Give an element its own copy of the parameter objects which depend on its
+     *        scaled end points.
+     *
+     * The oil-water scaling info is not copied, see makeElemEpsInfoUnique_().
+     */
+    void makeElemParamsUnique_(unsigned elemIdx)
+    {
+        const MaterialLawParams& srcParams = *materialLawParams_[elemIdx];
+        auto destParams = std::make_shared<MaterialLawParams>();
+        destParams->setApproach(srcParams.approach());
+        switch (srcParams.approach()) {
+        case EclStone1Approach:
+            copyThreePhaseParams_<EclStone1Approach>(*destParams, srcParams);
+            break;
 
-        if (enableHysteresis()) {
-            gasOilScaledImbInfoVector.resize(numCompressedElems);
-            gasOilScaledImbPointsVector.resize(numCompressedElems);
-            oilWaterScaledImbInfoVector.resize(numCompressedElems);
-            oilWaterScaledImbPointsVector.resize(numCompressedElems);
-        }
+        case EclStone2Approach:
+            copyThreePhaseParams_<EclStone2Approach>(*destParams, srcParams);
+            break;
 
-        EclEpsGridProperties epsGridProperties, epsImbGridProperties;
-        epsGridProperties.initFromDeck(deck, eclState, /*imbibition=*/false);
-        if (enableHysteresis())
-            epsImbGridProperties.initFromDeck(deck, eclState, /*imbibition=*/true);
-        for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
-            unsigned cartElemIdx = static_cast<unsigned>(compressedToCartesianElemIdx[elemIdx]);
-            readGasOilScaledPoints_(gasOilScaledInfoVector,
-                                    gasOilScaledPointsVector,
-                                    gasOilConfig,
-                                    eclState,
-                                    epsGridProperties,
-                                    elemIdx,
-                                    cartElemIdx);
-            readOilWaterScaledPoints_(oilWaterScaledEpsInfoDrainage_,
-                                      oilWaterScaledEpsPointsDrainage,
-                                      oilWaterConfig,
-                                      eclState,
-                                      epsGridProperties,
-                                      elemIdx,
-                                      cartElemIdx);
+        case EclDefaultApproach:
+            copyThreePhaseParams_<EclDefaultApproach>(*destParams, srcParams);
+            break;
 
-            if (enableHysteresis()) {
-                readGasOilScaledPoints_(gasOilScaledImbInfoVector,
-                                        gasOilScaledImbPointsVector,
-                                        gasOilConfig,
-                                        eclState,
-                                        epsImbGridProperties,
-                                        elemIdx,
-                                        cartElemIdx);
-                readOilWaterScaledPoints_(oilWaterScaledImbInfoVector,
-                                          oilWaterScaledImbPointsVector,
-                                          oilWaterConfig,
-                                          eclState,
-                                          epsImbGridProperties,
-                                          elemIdx,
-                                          cartElemIdx);
-            }
+        case EclTwoPhaseApproach:
+            copyThreePhaseParams_<EclTwoPhaseApproach>(*destParams, srcParams);
+            break;
         }
+        destParams->finalize();
 
-        // create the parameter objects for the two-phase laws
-        GasOilParamVector gasOilParams(numCompressedElems);
-        OilWaterParamVector oilWaterParams(numCompressedElems);
-        GasOilParamVector gasOilImbParams;
-        OilWaterParamVector oilWaterImbParams;
+        materialLawParams_[elemIdx] = destParams;
+        elemParamsAreShared_[elemIdx] = false;
+    }
 
-        if (enableHysteresis()) {
-            gasOilImbParams.resize(numCompressedElems);
-            oilWaterImbParams.resize(numCompressedElems);
+    template <Opm::EclMultiplexerApproach approachV>
+    void copyThreePhaseParams_(MaterialLawParams& destParams,
+                               const MaterialLawParams& srcParams) const
+    {
+        // the gas-oil parameters are only modified after the initialization if their
+        // Leverett factors are updated, so they can stay shared otherwise
+        auto& destRealParams = destParams.template getRealParams<approachV>();
+        destRealParams = srcParams.template getRealParams<approachV>();
+
+        // the end points of the copy may be modified, so the oil relperm is not
+        // looked up in the table of the region anymore
+        dropKroTable_(destRealParams, 0);
+
+        if (storeGasOilParams_ && !leverettPorosity_.empty()) {
+            auto gasOilParams =
+                std::make_shared<GasOilTwoPhaseHystParams>(destRealParams.gasOilParams());
+            destRealParams.setGasOilParams(gasOilParams);
         }
 
-        bool hasGas = deck.hasKeyword("GAS");
-        bool hasOil = deck.hasKeyword("OIL");
-        bool hasWater = deck.hasKeyword("WATER");
-
-        const auto& imbnumData = eclState.get3DProperties().getIntGridProperty("IMBNUM").getData();
-        assert(numCompressedElems == satnumRegionArray.size());
-        for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
-            unsigned satRegionIdx = static_cast<unsigned>(satnumRegionArray[elemIdx]);
-
-            gasOilParams[elemIdx] = std::make_shared<GasOilTwoPhaseHystParams>();
-            oilWaterParams[elemIdx] = std::make_shared<OilWaterTwoPhaseHystParams>();
-
-            gasOilParams[elemIdx]->setConfig(hysteresisConfig_);
-            oilWaterParams[elemIdx]->setConfig(hysteresisConfig_);
+        if (!storeOilWaterParams_)
+            return;
 
-            if (hasGas && hasOil) {
-                auto gasOilDrainParams = std::make_shared<GasOilEpsTwoPhaseParams>();
-                gasOilDrainParams->setConfig(gasOilConfig);
-                gasOilDrainParams->setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
-                gasOilDrainParams->setScaledPoints(gasOilScaledPointsVector[elemIdx]);
-                gasOilDrainParams->setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
-                gasOilDrainParams->finalize();
+        auto oilWaterParams =
+            std::make_shared<OilWaterTwoPhaseHystParams>(destRealParams.oilWaterParams());
+        destRealParams.setOilWaterParams(oilWaterParams);
+    }
 
-                gasOilParams[elemIdx]->setDrainageParams(gasOilDrainParams,
-                                                         *gasOilScaledInfoVector[elemIdx],
-                                                         EclGasOilSystem);
-            }
+    template <Opm::EclMultiplexerApproach approachV>
+    void rescaleLeverettFactors_(MaterialLawParams& params, Scalar factor) const
+    {
+        auto& realParams = params.template getRealParams<approachV>();
 
-            if (hasOil && hasWater) {
-                auto oilWaterDrainParams = std::make_shared<OilWaterEpsTwoPhaseParams>();
-                oilWaterDrainParams->setConfig(oilWaterConfig);
-                oilWaterDrainParams->setUnscaledPoints(oilWaterUnscaledPointsVector_[satRegionIdx]);
-                oilWaterDrainParams->setScaledPoints(oilWaterScaledEpsPointsDrainage[elemIdx]);
-                oilWaterDrainParams->setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
-                oilWaterDrainParams->finalize();
+        if (hasGasOilParams_) {
+            auto& gasOilParams = realParams.gasOilParams();
+            rescaleLeverettFactor_<GasOilEpsTwoPhaseLaw>(gasOilParams.drainageParams(), factor);
+            if (enableHysteresis())
+                rescaleLeverettFactor_<GasOilEpsTwoPhaseLaw>(gasOilParams.imbibitionParams(), factor);
+        }
 
-                oilWaterParams[elemIdx]->setDrainageParams(oilWaterDrainParams,
-                                                           *oilWaterScaledEpsInfoDrainage_[elemIdx],
-                                                           EclOilWaterSystem);
-            }
+        if (hasOilWaterParams_) {
+            auto& oilWaterParams = realParams.oilWaterParams();
+            rescaleLeverettFactor_<OilWaterEpsTwoPhaseLaw>(oilWaterParams.drainageParams(), factor);
+            if (enableHysteresis())
+                rescaleLeverettFactor_<OilWaterEpsTwoPhaseLaw>(oilWaterParams.imbibitionParams(), factor);
+        }
+    }
 
-            if (enableHysteresis()) {
-                unsigned imbRegionIdx = static_cast<unsigned>(imbnumData[elemIdx]) - 1;
+    // accessing the scaled points for modification drops the baked tables, so they are
+    // recomputed if they were present before
+    template <class EpsTwoPhaseLaw>
+    static void rescaleLeverettFactor_(typename EpsTwoPhaseLaw::Params& params, Scalar factor)
+    {
+        if (!params.config().enableLeverettScaling())
+            return;
 
-                if (hasGas && hasOil) {
-                    auto gasOilImbParamsHyst = std::make_shared<GasOilEpsTwoPhaseParams>();
-                    gasOilImbParamsHyst->setConfig(gasOilConfig);
-                    gasOilImbParamsHyst->setUnscaledPoints(gasOilUnscaledPointsVector_[imbRegionIdx]);
-                    gasOilImbParamsHyst->setScaledPoints(gasOilScaledImbPointsVector[elemIdx]);
-                    gasOilImbParamsHyst->setEffectiveLawParams(gasOilEffectiveParamVector_[imbRegionIdx]);
-                    gasOilImbParamsHyst->finalize();
+        bool isBaked = params.hasBakedLawParams();
+        auto& scaledPoints = params.scaledPoints();
+        scaledPoints.setLeverettFactor(scaledPoints.leverettFactor()*factor);
+        if (isBaked)
+            EpsTwoPhaseLaw::bakeScaling(params);
+    }
 
-                    gasOilParams[elemIdx]->setImbibitionParams(gasOilImbParamsHyst,
-                                                               *gasOilScaledImbInfoVector[elemIdx],
-                                                               EclGasOilSystem);
-                }
+    static std::uint64_t connectionKey_(unsigned elemIdx, unsigned satRegionIdx)
+    { return (static_cast<std::uint64_t>(elemIdx) << 32) | satRegionIdx; }
 
-                if (hasOil && hasWater) {
-                    auto oilWaterImbParamsHyst = std::make_shared<OilWaterEpsTwoPhaseParams>();
-                    oilWaterImbParamsHyst->setConfig(oilWaterConfig);
-                    oilWaterImbParamsHyst->setUnscaledPoints(oilWaterUnscaledPointsVector_[imbRegionIdx]);
-                    oilWaterImbParamsHyst->setScaledPoints(oilWaterScaledImbPointsVector[elemIdx]);
-                    oilWaterImbParamsHyst->setEffectiveLawParams(oilWaterEffectiveParamVector_[imbRegionIdx]);
-                    oilWaterImbParamsHyst->finalize();
+    // create a parameter object which uses the tables of a saturation region and the
+    // scaled end points and hysteresis parameters of an element
+    std::shared_ptr<MaterialLawParams> makeConnectionParams_(const MaterialLawParams& elemParams,
+                                                             unsigned satRegionIdx) const
+    {
+        auto params = std::make_shared<MaterialLawParams>();
+        params->setApproach(elemParams.approach());
+        switch (elemParams.approach()) {
+        case EclStone1Approach:
+            makeConnectionThreePhaseParams_<EclStone1Approach>(*params, elemParams, satRegionIdx);
+            break;
 
-                    oilWaterParams[elemIdx]->setImbibitionParams(oilWaterImbParamsHyst,
-                                                                 *gasOilScaledImbInfoVector[elemIdx],
-                                                                 EclGasOilSystem);
-                }
-            }
+        case EclStone2Approach:
+            makeConnectionThreePhaseParams_<EclStone2Approach>(*params, elemParams, satRegionIdx);
+            break;
 
-            if (hasGas && hasOil)
-                gasOilParams[elemIdx]->finalize();
+        case EclDefaultApproach:
+            makeConnectionThreePhaseParams_<EclDefaultApproach>(*params, elemParams, satRegionIdx);
+            break;
 
-            if (hasOil && hasWater)
-                oilWaterParams[elemIdx]->finalize();
+        case EclTwoPhaseApproach:
+            makeConnectionThreePhaseParams_<EclTwoPhaseApproach>(*params, elemParams, satRegionIdx);
+            break;
         }
+        params->finalize();
 
-        // create the parameter objects for the three-phase law
-        materialLawParams_.resize(numCompressedElems);
-        for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
-            materialLawParams_[elemIdx] = std::make_shared<MaterialLawParams>();
-            unsigned satRegionIdx = static_cast<unsigned>(satnumRegionArray[elemIdx]);
+        return params;
+    }
 
-            initThreePhaseParams_(deck,
-                                  eclState,
-                                  *materialLawParams_[elemIdx],
-                                  satRegionIdx,
-                                  *oilWaterScaledEpsInfoDrainage_[elemIdx],
-                                  oilWaterParams[elemIdx],
-                                  gasOilParams[elemIdx]);
+    template <Opm::EclMultiplexerApproach approachV>
+    void makeConnectionThreePhaseParams_(MaterialLawParams& destParams,
+                                         const MaterialLawParams& srcParams,
+                                         unsigned satRegionIdx) const
+    {
+        // the two-phase parameters of the element may be shared with other elements,
+        // so they are copied before the drainage curves are exchanged
+        auto& destRealParams = destParams.template getRealParams<approachV>();
+        destRealParams = srcParams.template getRealParams<approachV>();
+        dropKroTable_(destRealParams, 0);
+
+        if (storeGasOilParams_) {
+            auto gasOilParams =
+                std::make_shared<GasOilTwoPhaseHystParams>(destRealParams.gasOilParams());
+            gasOilParams->drainageParams().setUnscaledPoints(gasOilUnscaledPointsVector_[satRegionIdx]);
+            gasOilParams->drainageParams().setEffectiveLawParams(gasOilEffectiveParamVector_[satRegionIdx]);
+            destRealParams.setGasOilParams(gasOilParams);
+        }
 
-            materialLawParams_[elemIdx]->finalize();
+        if (storeOilWaterParams_) {
+            auto oilWaterParams =
+                std::make_shared<OilWaterTwoPhaseHystParams>(destRealParams.oilWaterParams());
+            oilWaterParams->drainageParams().setUnscaledPoints(oilWaterUnscaledPointsVector_[satRegionIdx]);
+            oilWaterParams->drainageParams().setEffectiveLawParams(oilWaterEffectiveParamVector_[satRegionIdx]);
+            destRealParams.setOilWaterParams(oilWaterParams);
         }
     }
 
@@ -749,14 +2856,18 @@ private:
         {
             const TableContainer& sgofTables = tableManager.getSgofTables();
             const TableContainer& slgofTables = tableManager.getSlgofTables();
-            if (!sgofTables.empty())
+            if (!sgofTables.empty()) {
+                effParams.setProfileName("SGOF region " + std::to_string(satRegionIdx + 1));
                 readGasOilEffectiveParametersSgof_(effParams,
                                                    Swco,
                                                    sgofTables.getTable<SgofTable>(satRegionIdx));
-            else if (!slgofTables.empty())
+            }
+            else if (!slgofTables.empty()) {
+                effParams.setProfileName("SLGOF region " + std::to_string(satRegionIdx + 1));
                 readGasOilEffectiveParametersSlgof_(effParams,
                                                     Swco,
                                                     slgofTables.getTable<SlgofTable>(satRegionIdx));
+            }
             break;
         }
 
@@ -764,6 +2875,7 @@ private:
         {
             const Sof3Table& sof3Table = tableManager.getSof3Tables().getTable<Sof3Table>( satRegionIdx );
             const SgfnTable& sgfnTable = tableManager.getSgfnTables().getTable<SgfnTable>( satRegionIdx );
+            effParams.setProfileName("SOF3/SGFN region " + std::to_string(satRegionIdx + 1));
             readGasOilEffectiveParametersFamily2_(effParams,
                                                   Swco,
                                                   sof3Table,
@@ -790,9 +2902,9 @@ private:
             SoKroSamples[sampleIdx] = SoSamples[sampleIdx] - Swco;
         }
 
-        effParams.setKrwSamples(SoKroSamples, sgofTable.getColumn("KROG").vectorCopy());
+        effParams.setKrwSamples(std::move(SoKroSamples), sgofTable.getColumn("KROG").vectorCopy());
         effParams.setKrnSamples(SoSamples, sgofTable.getColumn("KRG").vectorCopy());
-        effParams.setPcnwSamples(SoSamples, sgofTable.getColumn("PCOG").vectorCopy());
+        effParams.setPcnwSamples(std::move(SoSamples), sgofTable.getColumn("PCOG").vectorCopy());
         effParams.finalize();
     }
 
@@ -808,9 +2920,9 @@ private:
             SoKroSamples[sampleIdx] = slgofTable.get("SL", sampleIdx) - Swco;
         }
 
-        effParams.setKrwSamples(SoKroSamples, slgofTable.getColumn("KROG").vectorCopy());
+        effParams.setKrwSamples(std::move(SoKroSamples), slgofTable.getColumn("KROG").vectorCopy());
         effParams.setKrnSamples(SoSamples, slgofTable.getColumn("KRG").vectorCopy());
-        effParams.setPcnwSamples(SoSamples, slgofTable.getColumn("PCOG").vectorCopy());
+        effParams.setPcnwSamples(std::move(SoSamples), slgofTable.getColumn("PCOG").vectorCopy());
         effParams.finalize();
     }
 
@@ -821,14 +2933,13 @@ private:
     {
         // convert the saturations of the SGFN keyword from gas to oil saturations
         std::vector<double> SoSamples(sgfnTable.numRows());
-        std::vector<double> SoColumn = sof3Table.getColumn("SO").vectorCopy();
         for (size_t sampleIdx = 0; sampleIdx < sgfnTable.numRows(); ++ sampleIdx) {
             SoSamples[sampleIdx] = 1 - sgfnTable.get("SG", sampleIdx);
         }
 
-        effParams.setKrwSamples(SoColumn, sof3Table.getColumn("KROG").vectorCopy());
+        effParams.setKrwSamples(sof3Table.getColumn("SO").vectorCopy(), sof3Table.getColumn("KROG").vectorCopy());
         effParams.setKrnSamples(SoSamples, sgfnTable.getColumn("KRG").vectorCopy());
-        effParams.setPcnwSamples(SoSamples, sgfnTable.getColumn("PCOG").vectorCopy());
+        effParams.setPcnwSamples(std::move(SoSamples), sgfnTable.getColumn("PCOG").vectorCopy());
         effParams.finalize();
     }
 
@@ -855,9 +2966,10 @@ private:
             const auto& swofTable = tableManager.getSwofTables().getTable<SwofTable>(satRegionIdx);
             std::vector<double> SwColumn = swofTable.getColumn("SW").vectorCopy();
 
+            effParams.setProfileName("SWOF region " + std::to_string(satRegionIdx + 1));
             effParams.setKrwSamples(SwColumn, swofTable.getColumn("KRW").vectorCopy());
             effParams.setKrnSamples(SwColumn, swofTable.getColumn("KROW").vectorCopy());
-            effParams.setPcnwSamples(SwColumn, swofTable.getColumn("PCOW").vectorCopy());
+            effParams.setPcnwSamples(std::move(SwColumn), swofTable.getColumn("PCOW").vectorCopy());
             effParams.finalize();
             break;
         }
@@ -872,9 +2984,10 @@ private:
             for (size_t sampleIdx = 0; sampleIdx < sof3Table.numRows(); ++ sampleIdx)
                 SwSamples[sampleIdx] = 1 - sof3Table.get("SO", sampleIdx);
 
+            effParams.setProfileName("SWFN/SOF3 region " + std::to_string(satRegionIdx + 1));
             effParams.setKrwSamples(SwColumn, swfnTable.getColumn("KRW").vectorCopy());
-            effParams.setKrnSamples(SwSamples, sof3Table.getColumn("KROW").vectorCopy());
-            effParams.setPcnwSamples(SwColumn, swfnTable.getColumn("PCOW").vectorCopy());
+            effParams.setKrnSamples(std::move(SwSamples), sof3Table.getColumn("KROW").vectorCopy());
+            effParams.setPcnwSamples(std::move(SwColumn), swfnTable.getColumn("PCOW").vectorCopy());
             effParams.finalize();
             break;
         }
@@ -901,7 +3014,7 @@ private:
             // we don't read anything if either the gas or the oil phase is not active
             return;
 
-        dest[satRegionIdx] = std::make_shared<EclEpsScalingPoints<Scalar> >();
+        dest[satRegionIdx] = std::make_shared<ScalingPoints>();
         dest[satRegionIdx]->init(unscaledEpsInfo_[satRegionIdx], *config, EclGasOilSystem);
     }
 
@@ -919,25 +3032,54 @@ private:
             // we don't read anything if either the water or the oil phase is not active
             return;
 
-        dest[satRegionIdx] = std::make_shared<EclEpsScalingPoints<Scalar> >();
+        dest[satRegionIdx] = std::make_shared<ScalingPoints>();
         dest[satRegionIdx]->init(unscaledEpsInfo_[satRegionIdx], *config, EclOilWaterSystem);
     }
 
+    // initialize the scaling info of each element with the one of its saturation region
+    // and overwrite the values which are specified by the grid properties.
+    template <class PropertyIndexFunction>
+    void extractScaledEpsInfo_(std::vector<EclEpsScalingPointsInfo<Scalar> >& dest,
+                               const Opm::EclipseState& eclState,
+                               const EclEpsGridProperties& epsGridProperties,
+                               unsigned numCompressedElems,
+                               const PropertyIndexFunction& propertyIdx)
+    {
+        dest.resize(numCompressedElems);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
+            unsigned satRegionIdx = static_cast<unsigned>((*epsGridProperties.satnum)[propertyIdx(elemIdx)]) - 1; // ECL uses Fortran indices!
+            dest[elemIdx] = unscaledEpsInfo_[satRegionIdx];
+        }
+
+        EclEpsScalingPointsInfo<Scalar>::extractScaled(dest, eclState, epsGridProperties, propertyIdx);
+    }
+
     template <class InfoContainer, class PointsContainer>
     void readGasOilScaledPoints_(InfoContainer& destInfo,
                                  PointsContainer& destPoints,
                                  std::shared_ptr<EclEpsConfig> config,
-                                 const Opm::EclipseState& eclState,
-                                 const EclEpsGridProperties& epsGridProperties,
+                                 const EclEpsScalingPointsInfo<Scalar>& elemInfo,
                                  unsigned elemIdx,
-                                 unsigned cartElemIdx)
+                                 unsigned satRegionIdx,
+                                 const ScalingInfoVector& regionInfo,
+                                 const QuantizationScalesVector& regionScales)
     {
-        unsigned satRegionIdx = static_cast<unsigned>((*epsGridProperties.satnum)[cartElemIdx]) - 1; // ECL uses Fortran indices!
-
-        destInfo[elemIdx] = std::make_shared<EclEpsScalingPointsInfo<Scalar> >(unscaledEpsInfo_[satRegionIdx]);
-        destInfo[elemIdx]->extractScaled(eclState, epsGridProperties, cartElemIdx);
+        // if the grid properties do not modify any of the end points of the saturation
+        // region, the element references the objects of its region instead of
+        // allocating its own ones.
+        if (elemInfo == unscaledEpsInfo_[satRegionIdx] && gasOilUnscaledPointsVector_[satRegionIdx]) {
+            destInfo[elemIdx] = regionInfo[satRegionIdx];
+            destPoints[elemIdx] = gasOilUnscaledPointsVector_[satRegionIdx];
+            return;
+        }
 
-        destPoints[elemIdx] = std::make_shared<EclEpsScalingPoints<Scalar> >();
+        destInfo[elemIdx] = std::make_shared<EclEpsScalingPointsInfo<Scalar> >(elemInfo);
+        destPoints[elemIdx] = std::make_shared<ScalingPoints>();
+        if (!regionScales.empty())
+            setRegionScales_(*destPoints[elemIdx], regionScales[satRegionIdx]);
         destPoints[elemIdx]->init(*destInfo[elemIdx], *config, EclGasOilSystem);
     }
 
@@ -945,24 +3087,82 @@ private:
     void readOilWaterScaledPoints_(InfoContainer& destInfo,
                                    PointsContainer& destPoints,
                                    std::shared_ptr<EclEpsConfig> config,
-                                   const Opm::EclipseState& eclState,
-                                   const EclEpsGridProperties& epsGridProperties,
+                                   const EclEpsScalingPointsInfo<Scalar>& elemInfo,
                                    unsigned elemIdx,
-                                   unsigned cartElemIdx)
+                                   unsigned satRegionIdx,
+                                   const ScalingInfoVector& regionInfo,
+                                   const QuantizationScalesVector& regionScales)
     {
-        unsigned satRegionIdx = static_cast<unsigned>((*epsGridProperties.satnum)[cartElemIdx]) - 1; // ECL uses Fortran indices!
-
-        destInfo[elemIdx] = std::make_shared<EclEpsScalingPointsInfo<Scalar> >(unscaledEpsInfo_[satRegionIdx]);
-        destInfo[elemIdx]->extractScaled(eclState, epsGridProperties, cartElemIdx);
+        // if the grid properties do not modify any of the end points of the saturation
+        // region, the element references the objects of its region instead of
+        // allocating its own ones.
+        if (elemInfo == unscaledEpsInfo_[satRegionIdx] && oilWaterUnscaledPointsVector_[satRegionIdx]) {
+            destInfo[elemIdx] = regionInfo[satRegionIdx];
+            destPoints[elemIdx] = oilWaterUnscaledPointsVector_[satRegionIdx];
+            return;
+        }
 
-        destPoints[elemIdx] = std::make_shared<EclEpsScalingPoints<Scalar> >();
+        destInfo[elemIdx] = std::make_shared<EclEpsScalingPointsInfo<Scalar> >(elemInfo);
+        destPoints[elemIdx] = std::make_shared<ScalingPoints>();
+        if (!regionScales.empty())
+            setRegionScales_(*destPoints[elemIdx], regionScales[satRegionIdx]);
         destPoints[elemIdx]->init(*destInfo[elemIdx], *config, EclOilWaterSystem);
     }
 
-    void initThreePhaseParams_(const Opm::Deck& deck,
-                               const Opm::EclipseState& /* eclState */,
-                               MaterialLawParams& materialParams,
-                               unsigned satRegionIdx,
+    // the scales of the quantized maxima of each saturation region. they cover the
+    // scaled end points of all elements of the region, both for drainage and imbibition.
+    void computeRegionScales_(QuantizationScalesVector& regionScales,
+                              const EclEpsConfig& config,
+                              EclTwoPhaseSystemType systemType,
+                              unsigned numSatRegions,
+                              const std::vector<int>& satnumRegionArray,
+                              const std::vector<EclEpsScalingPointsInfo<Scalar> >& scaledInfo,
+                              const std::vector<unsigned>& imbRegionIdx,
+                              const std::vector<EclEpsScalingPointsInfo<Scalar> >& scaledImbInfo) const
+    {
+        regionScales.resize(numSatRegions);
+        for (unsigned satRegionIdx = 0; satRegionIdx < numSatRegions; ++satRegionIdx)
+            regionScales[satRegionIdx] = std::make_shared<QuantizationScales>();
+
+        for (size_t elemIdx = 0; elemIdx < scaledInfo.size(); ++elemIdx)
+            regionScales[static_cast<unsigned>(satnumRegionArray[elemIdx])]->include(scaledInfo[elemIdx], config, systemType);
+        for (size_t elemIdx = 0; elemIdx < imbRegionIdx.size(); ++elemIdx)
+            regionScales[imbRegionIdx[elemIdx]]->include(scaledImbInfo[elemIdx], config, systemType);
+    }
+
+    template <class Points>
+    static void setRegionScales_(Points& /* points */,
+                                 const std::shared_ptr<QuantizationScales>& /* scales */)
+    { }
+
+    template <class S>
+    static void setRegionScales_(EclEpsQuantizedScalingPoints<S>& points,
+                                 const std::shared_ptr<QuantizationScales>& scales)
+    { points.setScales(scales); }
+
+    // the exponent of the Stone 1 model of each saturation region. (STONE1EX, 1 if the
+    // keyword is not present.)
+    static void readStone1Exponents_(std::vector<Scalar>& eta,
+                                     const Opm::Deck& deck,
+                                     size_t numSatRegions)
+    {
+        eta.assign(numSatRegions, 1.0);
+        if (!deck.hasKeyword("STONE1EX"))
+            return;
+
+        const auto& stone1exKeyword = deck.getKeyword("STONE1EX");
+        if (stone1exKeyword.size() < numSatRegions)
+            OPM_THROW(std::runtime_error,
+                      "The STONE1EX keyword must specify the exponent of all "
+                      << numSatRegions << " saturation regions (has "
+                      << stone1exKeyword.size() << " records)");
+
+        for (unsigned satRegionIdx = 0; satRegionIdx < numSatRegions; ++satRegionIdx)
+            eta[satRegionIdx] = stone1exKeyword.getRecord(satRegionIdx).getItem(0).getSIDouble(0);
+    }
+
+    void initThreePhaseParams_(MaterialLawParams& materialParams,
+                               Scalar stone1Eta,
                                const EclEpsScalingPointsInfo<Scalar>& epsInfo,
                                std::shared_ptr<OilWaterTwoPhaseHystParams> oilWaterParams,
                                std::shared_ptr<GasOilTwoPhaseHystParams> gasOilParams)
@@ -975,14 +3175,7 @@ private:
             realParams.setGasOilParams(gasOilParams);
             realParams.setOilWaterParams(oilWaterParams);
             realParams.setSwl(epsInfo.Swl);
-
-            if (deck.hasKeyword("STONE1EX")) {
-                Scalar eta =
-                    deck.getKeyword("STONE1EX").getRecord(satRegionIdx).getItem(0).getSIDouble(0);
-                realParams.setEta(eta);
-            }
-            else
-                realParams.setEta(1.0);
+            realParams.setEta(stone1Eta);
             realParams.finalize();
             break;
         }
@@ -1017,6 +3210,10 @@ private:
     }
 
     bool enableEndPointScaling_;
+    bool hasGasOilParams_;
+    bool hasOilWaterParams_;
+    bool storeGasOilParams_;
+    bool storeOilWaterParams_;
     std::shared_ptr<EclHysteresisConfig> hysteresisConfig_;
 
     std::shared_ptr<EclEpsConfig> oilWaterEclEpsConfig_;
@@ -1033,9 +3230,86 @@ private:
     enum EclTwoPhaseApproach twoPhaseApproach_;
 
     std::vector<std::shared_ptr<MaterialLawParams> > materialLawParams_;
+    std::vector<bool> elemParamsAreShared_;
 
     std::vector<int> satnumRegionArray_;
+
+    // the element indices sorted by saturation region and the position of the first
+    // element of each region within them
+    std::vector<unsigned> satnumRegionOrder_;
+    std::vector<unsigned> satnumRegionOffsets_;
+
+    // the OpenMP thread which initializes each element. this is empty if the elements
+    // are split into contiguous blocks.
+    std::vector<unsigned> elemThreadMapping_;
+
+    // the porosities on which the Leverett capillary pressure scaling factors of the
+    // elements are based. this is empty if Leverett scaling is not used.
+    std::vector<Scalar> leverettPorosity_;
+    Scalar leverettPorosityExponent_;
+
+    // the factors by which SWATINIT scaled the maximum oil-water capillary pressure of
+    // the elements. this is empty if no element was modified.
+    std::vector<Scalar> maxPcowMultiplier_;
+
+    // the parameter objects of the well connections whose saturation region differs
+    // from the one of their element
+    typedef std::unordered_map<std::uint64_t, std::shared_ptr<MaterialLawParams> > ConnectionParamsMap;
+    ConnectionParamsMap connectionParams_;
+
+    // the connection parameter objects which follow the hysteresis state of their
+    // element. this is empty if hysteresis is disabled.
+    std::unordered_multimap<unsigned, MaterialLawParams*> hysteresisConnections_;
 };
+
+/*!
+ * \ingroup fluidmatrixinteractions
+ *
+ * \brief Calls a functor with the slimmest instantiation of EclMaterialLawManager
+ *        which supports a deck.
+ *
+ * The end-point scaling layer is only kept if the deck uses the ENDSCALE keyword and
+ * the hysteresis layer only if the SATOPTS keyword specifies the HYSTER option. The
+ * manager type is passed as the template argument of the apply() method of the
+ * functor, i.e., 'functor.template apply<Manager>()' is called. The functor is then
+ * responsible for creating and initializing the manager. The storage type of the
+ * scaling points is passed through unmodified.
+ */
+template <class Traits,
+          class StorageScalar = typename Traits::Scalar,
+          class ScalingPointsStorage = StorageScalar,
+          class Functor>
+void dispatchEclMaterialLawManager(const Opm::Deck& deck, Functor& functor)
+{
+    EclHysteresisConfig hysteresisConfig;
+    hysteresisConfig.initFromDeck(deck);
+
+    bool needsEps = deck.hasKeyword("ENDSCALE");
+    bool needsHysteresis = hysteresisConfig.enableHysteresis();
+
+    if (needsEps && needsHysteresis)
+        functor.template apply<EclMaterialLawManager<Traits, StorageScalar, true, true, ScalingPointsStorage> >();
+    else if (needsEps)
+        functor.template apply<EclMaterialLawManager<Traits, StorageScalar, true, false, ScalingPointsStorage> >();
+    else if (needsHysteresis)
+        functor.template apply<EclMaterialLawManager<Traits, StorageScalar, false, true, ScalingPointsStorage> >();
+    else
+        functor.template apply<EclMaterialLawManager<Traits, StorageScalar, false, false, ScalingPointsStorage> >();
+}
+} // namespace Opm
+
+// the instantiation which is part of the library of precompiled instantiations (see
+// opm/material/common/PrecompiledInstantiations.hpp). it uses the phase indices of the
+// black-oil fluid system.
+#include <opm/material/common/PrecompiledInstantiations.hpp>
+
+#if OPM_MATERIAL_EXTERN_TEMPLATES
+namespace Opm {
+extern template class EclMaterialLawManager<ThreePhaseMaterialTraits<double,
+                                                                     /*wettingPhaseIdx=*/0,
+                                                                     /*nonWettingPhaseIdx=*/1,
+                                                                     /*gasPhaseIdx=*/2> >;
 } // namespace Opm
+#endif
 
 #endif
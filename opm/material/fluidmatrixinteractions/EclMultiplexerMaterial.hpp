@@ -35,6 +35,7 @@
 
 #include <opm/common/Valgrind.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Tracing.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
@@ -132,6 +133,8 @@ public:
                                    const Params& params,
                                    const FluidState& fluidState)
     {
+        OPM_MATERIAL_TRACE_SCOPE("EclMultiplexerMaterial::capillaryPressures");
+
         switch (params.approach()) {
         case EclStone1Approach:
             Stone1Material::capillaryPressures(values,
@@ -384,6 +387,8 @@ public:
                                        const Params& params,
                                        const FluidState& fluidState)
     {
+        OPM_MATERIAL_TRACE_SCOPE("EclMultiplexerMaterial::relativePermeabilities");
+
         switch (params.approach()) {
         case EclStone1Approach:
             Stone1Material::relativePermeabilities(values,
@@ -411,6 +416,51 @@ public:
         }
     }
 
+    /*!
+     * \brief The capillary pressures and the relative permeabilities of all phases.
+     *
+     * This forwards to the capillaryPressuresAndRelativePermeabilities() method of the
+     * material law which is selected for the parameter object.
+     */
+    template <class PcContainerT, class KrContainerT, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainerT& pcValues,
+                                                            KrContainerT& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fluidState)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("EclMultiplexerMaterial::capillaryPressuresAndRelativePermeabilities");
+
+        switch (params.approach()) {
+        case EclStone1Approach:
+            Stone1Material::capillaryPressuresAndRelativePermeabilities(pcValues,
+                                                                        krValues,
+                                                                        params.template getRealParams<EclStone1Approach>(),
+                                                                        fluidState);
+            break;
+
+        case EclStone2Approach:
+            Stone2Material::capillaryPressuresAndRelativePermeabilities(pcValues,
+                                                                        krValues,
+                                                                        params.template getRealParams<EclStone2Approach>(),
+                                                                        fluidState);
+            break;
+
+        case EclDefaultApproach:
+            DefaultMaterial::capillaryPressuresAndRelativePermeabilities(pcValues,
+                                                                         krValues,
+                                                                         params.template getRealParams<EclDefaultApproach>(),
+                                                                         fluidState);
+            break;
+
+        case EclTwoPhaseApproach:
+            TwoPhaseMaterial::capillaryPressuresAndRelativePermeabilities(pcValues,
+                                                                          krValues,
+                                                                          params.template getRealParams<EclTwoPhaseApproach>(),
+                                                                          fluidState);
+            break;
+        }
+    }
+
     /*!
      * \brief The relative permeability of the gas phase.
      */
@@ -447,32 +497,33 @@ public:
      *
      * This assumes that the nested two-phase material laws are parameters for
      * EclHysteresisLaw. If they are not, calling this methid will cause a compiler
-     * error. (But not calling it will still work.)
+     * error. (But not calling it will still work.) The return value is true if the
+     * scanning curves of any of the nested laws were modified.
      */
     template <class FluidState>
-    static void updateHysteresis(Params& params, const FluidState& fluidState)
+    static bool updateHysteresis(Params& params, const FluidState& fluidState)
     {
+        OPM_MATERIAL_TRACE_SCOPE("EclMultiplexerMaterial::updateHysteresis");
+
         switch (params.approach()) {
         case EclStone1Approach:
-            Stone1Material::updateHysteresis(params.template getRealParams<EclStone1Approach>(),
-                                             fluidState);
-            break;
+            return Stone1Material::updateHysteresis(params.template getRealParams<EclStone1Approach>(),
+                                                    fluidState);
 
         case EclStone2Approach:
-            Stone2Material::updateHysteresis(params.template getRealParams<EclStone2Approach>(),
-                                             fluidState);
-            break;
+            return Stone2Material::updateHysteresis(params.template getRealParams<EclStone2Approach>(),
+                                                    fluidState);
 
         case EclDefaultApproach:
-            DefaultMaterial::updateHysteresis(params.template getRealParams<EclDefaultApproach>(),
-                                              fluidState);
-            break;
+            return DefaultMaterial::updateHysteresis(params.template getRealParams<EclDefaultApproach>(),
+                                                     fluidState);
 
         case EclTwoPhaseApproach:
-            TwoPhaseMaterial::updateHysteresis(params.template getRealParams<EclTwoPhaseApproach>(),
-                                               fluidState);
-            break;
+            return TwoPhaseMaterial::updateHysteresis(params.template getRealParams<EclTwoPhaseApproach>(),
+                                                      fluidState);
         }
+
+        return false;
     }
 };
 } // namespace Opm
@@ -34,8 +34,11 @@
 
 #include <type_traits>
 #include <cassert>
-#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 
+#include <opm/material/common/BinarySerialization.hpp>
 #include <opm/material/common/EnsureFinalized.hpp>
 
 namespace Opm {
@@ -52,7 +55,8 @@ enum EclMultiplexerApproach {
  *        multiplexed three-phase material law.
  *
  * Essentially, this class just stores parameter object for the "nested" material law and
- * provides some methods to convert to it.
+ * provides some methods to convert to it. The parameter object is stored inline, i.e.,
+ * accessing it does not require an additional indirection.
  */
 template<class Traits, class GasOilMaterialLawT, class OilWaterMaterialLawT>
 class EclMultiplexerMaterialParams : public Traits, public EnsureFinalized
@@ -70,16 +74,18 @@ class EclMultiplexerMaterialParams : public Traits, public EnsureFinalized
     typedef typename DefaultMaterial::Params DefaultParams;
     typedef typename TwoPhaseMaterial::Params TwoPhaseParams;
 
-    template <class ParamT>
-    struct Deleter
-    {
-        inline void operator () ( void* ptr )
-        {
-            delete static_cast< ParamT* > (ptr);
-        }
-    };
+    static constexpr size_t maxOf_(size_t a, size_t b)
+    { return (a > b) ? a : b; }
 
-    typedef std::shared_ptr< void > ParamPointerType;
+    // the parameter objects of all approaches are stored in the same inline buffer
+    static constexpr size_t storageSize_ =
+        maxOf_(maxOf_(sizeof(Stone1Params), sizeof(Stone2Params)),
+               maxOf_(sizeof(DefaultParams), sizeof(TwoPhaseParams)));
+    static constexpr size_t storageAlignment_ =
+        maxOf_(maxOf_(alignof(Stone1Params), alignof(Stone2Params)),
+               maxOf_(alignof(DefaultParams), alignof(TwoPhaseParams)));
+
+    typedef typename std::aligned_storage<storageSize_, storageAlignment_>::type StorageType;
 
 public:
     using EnsureFinalized :: finalize;
@@ -87,45 +93,55 @@ public:
     /*!
      * \brief The multiplexer constructor.
      */
-    EclMultiplexerMaterialParams() : realParams_()
+    EclMultiplexerMaterialParams()
+        : hasRealParams_(false)
     {
     }
 
     EclMultiplexerMaterialParams(const EclMultiplexerMaterialParams& other)
-        : realParams_()
+        : EnsureFinalized(other)
+        , hasRealParams_(false)
     {
-        setApproach( other.approach() );
+        copyRealParams_(other);
     }
 
+    ~EclMultiplexerMaterialParams()
+    { destroyRealParams_(); }
+
     EclMultiplexerMaterialParams& operator= ( const EclMultiplexerMaterialParams& other )
     {
-        realParams_.reset();
-        setApproach( other.approach() );
+        if (this == &other)
+            return *this;
+
+        EnsureFinalized::operator=(other);
+        destroyRealParams_();
+        copyRealParams_(other);
         return *this;
     }
 
     void setApproach(EclMultiplexerApproach newApproach)
     {
-        assert(realParams_ == 0);
+        assert(!hasRealParams_);
         approach_ = newApproach;
 
         switch (approach()) {
         case EclStone1Approach:
-            realParams_ = ParamPointerType(new Stone1Params, Deleter< Stone1Params > () );
+            new (&realParams_) Stone1Params;
             break;
 
         case EclStone2Approach:
-            realParams_ = ParamPointerType(new Stone2Params, Deleter< Stone2Params > () );
+            new (&realParams_) Stone2Params;
             break;
 
         case EclDefaultApproach:
-            realParams_ = ParamPointerType(new DefaultParams, Deleter< DefaultParams > () );
+            new (&realParams_) DefaultParams;
             break;
 
         case EclTwoPhaseApproach:
-            realParams_ = ParamPointerType(new TwoPhaseParams, Deleter< TwoPhaseParams > () );
+            new (&realParams_) TwoPhaseParams;
             break;
         }
+        hasRealParams_ = true;
     }
 
     EclMultiplexerApproach approach() const
@@ -199,21 +215,141 @@ public:
         return this->template castTo<TwoPhaseParams>();
     }
 
+    /*!
+     * \brief Write the approach and the finalized parameters of the nested law to a
+     *        binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        EnsureFinalized::check();
+        assert(hasRealParams_);
+
+        writer.write(static_cast<std::int32_t>(approach_));
+        switch (approach()) {
+        case EclStone1Approach:
+            castTo<Stone1Params>().serialize(writer);
+            break;
+
+        case EclStone2Approach:
+            castTo<Stone2Params>().serialize(writer);
+            break;
+
+        case EclDefaultApproach:
+            castTo<DefaultParams>().serialize(writer);
+            break;
+
+        case EclTwoPhaseApproach:
+            castTo<TwoPhaseParams>().serialize(writer);
+            break;
+        }
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     *
+     * Any parameters of the nested law which were set before are replaced.
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        std::int32_t approach;
+        reader.read(approach);
+        if (approach < EclDefaultApproach || approach > EclTwoPhaseApproach)
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: invalid three-phase approach " << approach);
+
+        destroyRealParams_();
+        setApproach(static_cast<EclMultiplexerApproach>(approach));
+        switch (this->approach()) {
+        case EclStone1Approach:
+            castTo<Stone1Params>().deserialize(reader);
+            break;
+
+        case EclStone2Approach:
+            castTo<Stone2Params>().deserialize(reader);
+            break;
+
+        case EclDefaultApproach:
+            castTo<DefaultParams>().deserialize(reader);
+            break;
+
+        case EclTwoPhaseApproach:
+            castTo<TwoPhaseParams>().deserialize(reader);
+            break;
+        }
+
+        EnsureFinalized::finalize();
+    }
+
 private:
     template <class ParamT>
     ParamT& castTo()
     {
-        return *(static_cast<ParamT *> (realParams_.operator->()));
+        assert(hasRealParams_);
+        return *reinterpret_cast<ParamT*>(&realParams_);
     }
 
     template <class ParamT>
     const ParamT& castTo() const
     {
-        return *(static_cast<const ParamT *> (realParams_.operator->()));
+        assert(hasRealParams_);
+        return *reinterpret_cast<const ParamT*>(&realParams_);
+    }
+
+    void copyRealParams_(const EclMultiplexerMaterialParams& other)
+    {
+        assert(!hasRealParams_);
+        if (!other.hasRealParams_)
+            return;
+
+        approach_ = other.approach_;
+        switch (approach()) {
+        case EclStone1Approach:
+            new (&realParams_) Stone1Params(other.template castTo<Stone1Params>());
+            break;
+
+        case EclStone2Approach:
+            new (&realParams_) Stone2Params(other.template castTo<Stone2Params>());
+            break;
+
+        case EclDefaultApproach:
+            new (&realParams_) DefaultParams(other.template castTo<DefaultParams>());
+            break;
+
+        case EclTwoPhaseApproach:
+            new (&realParams_) TwoPhaseParams(other.template castTo<TwoPhaseParams>());
+            break;
+        }
+        hasRealParams_ = true;
+    }
+
+    void destroyRealParams_()
+    {
+        if (!hasRealParams_)
+            return;
+
+        switch (approach()) {
+        case EclStone1Approach:
+            castTo<Stone1Params>().~Stone1Params();
+            break;
+
+        case EclStone2Approach:
+            castTo<Stone2Params>().~Stone2Params();
+            break;
+
+        case EclDefaultApproach:
+            castTo<DefaultParams>().~DefaultParams();
+            break;
+
+        case EclTwoPhaseApproach:
+            castTo<TwoPhaseParams>().~TwoPhaseParams();
+            break;
+        }
+        hasRealParams_ = false;
     }
 
     EclMultiplexerApproach approach_;
-    ParamPointerType realParams_;
+    bool hasRealParams_;
+    StorageType realParams_;
 };
 } // namespace Opm
 
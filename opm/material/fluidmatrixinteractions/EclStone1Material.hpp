@@ -28,6 +28,7 @@
 #define OPM_ECL_STONE1_MATERIAL_HPP
 
 #include "EclStone1MaterialParams.hpp"
+#include "MaterialLawCombinedEvaluation.hpp"
 
 #include <opm/common/Valgrind.hpp>
 #include <opm/material/common/MathToolbox.hpp>
@@ -313,6 +314,114 @@ public:
         values[gasPhaseIdx] = krg<FluidState, Evaluation>(params, fluidState);
     }
 
+    /*!
+     * \brief The capillary pressures and the relative permeabilities of all phases.
+     *
+     * This yields the same results as capillaryPressures() and
+     * relativePermeabilities(), but all quantities of the oil-water system are
+     * evaluated at the water saturation and the capillary pressure and the gas
+     * relative permeability of the gas-oil system at the same saturation, so the
+     * nested two-phase laws are asked for them in a single call each.
+     */
+    template <class PcContainerT, class KrContainerT, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainerT& pcValues,
+                                                            KrContainerT& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fluidState)
+    {
+        typedef typename std::remove_reference<decltype(pcValues[0])>::type Evaluation;
+
+        const Evaluation& Sw = Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
+        const Evaluation& Sg = Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
+
+        Evaluation pcow;
+        Evaluation krw;
+        Evaluation kro_ow;
+        Opm::twoPhaseSatPcnwAndKr<OilWaterMaterialLaw, Evaluation>(&pcow, &krw, &kro_ow,
+                                                                   params.oilWaterParams(), Sw);
+
+        Evaluation pcgo;
+        Evaluation krg;
+        Opm::twoPhaseSatPcnwAndKr<GasOilMaterialLaw, Evaluation>(&pcgo, nullptr, &krg,
+                                                                 params.gasOilParams(), 1 - Sg);
+
+        pcValues[gasPhaseIdx] = pcgo;
+        pcValues[oilPhaseIdx] = 0;
+        pcValues[waterPhaseIdx] = - pcow;
+
+        krValues[waterPhaseIdx] = krw;
+        if (!tabulatedKrn_(krValues[oilPhaseIdx], params, Sw, Sg))
+            krValues[oilPhaseIdx] = krn_(params, Sw, Sg, kro_ow);
+        krValues[gasPhaseIdx] = krg;
+    }
+
+    /*!
+     * \brief The relative permeabilities of all phases for an array of saturations.
+     *
+     * This computes the same values as calling relativePermeabilities() for each entry
+     * of the arrays, but all entries must use the same parameter object: The array
+     * 'saturations[phaseIdx]' stores the saturations of the phase for each of the
+     * numValues entries and 'kr[phaseIdx]' receives the corresponding relative
+     * permeabilities. The lookups in the two-phase tables are done in separate passes
+     * over the arrays so that the table which is used stays in the cache and the
+     * segment searches look at the same data, while the Stone combination is done in a
+     * single pass with only one data dependent branch per entry. The result arrays
+     * must not overlap with the saturation arrays.
+     */
+    template <class Evaluation>
+    static void relativePermeabilitiesMany(Evaluation* const* kr,
+                                           const Params& params,
+                                           const Evaluation* const* saturations,
+                                           size_t numValues)
+    {
+        const Evaluation* Sw = saturations[waterPhaseIdx];
+        const Evaluation* Sg = saturations[gasPhaseIdx];
+        Evaluation* krwValues = kr[waterPhaseIdx];
+        Evaluation* kroValues = kr[oilPhaseIdx];
+        Evaluation* krgValues = kr[gasPhaseIdx];
+
+        for (size_t i = 0; i < numValues; ++i)
+            krwValues[i] = OilWaterMaterialLaw::twoPhaseSatKrw(params.oilWaterParams(), Sw[i]);
+
+        for (size_t i = 0; i < numValues; ++i)
+            krgValues[i] = GasOilMaterialLaw::twoPhaseSatKrn(params.gasOilParams(), 1 - Sg[i]);
+
+        if (params.kroTable()) {
+            // the oil relperm is looked up in the table. only the entries outside of its
+            // range use the Stone combination
+            for (size_t i = 0; i < numValues; ++i) {
+                if (tabulatedKrn_(kroValues[i], params, Sw[i], Sg[i]))
+                    continue;
+
+                const Evaluation& kro_ow = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw[i]);
+                kroValues[i] = krn_(params, Sw[i], Sg[i], kro_ow);
+            }
+            return;
+        }
+
+        // the oil relperm of the oil-water system is stored in the output array of the oil
+        // phase until it is combined with the one of the gas-oil system below.
+        for (size_t i = 0; i < numValues; ++i)
+            kroValues[i] = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw[i]);
+
+        Scalar Swco = params.Swl();
+        Scalar krocw = params.krocw();
+        Scalar eta = params.eta();
+        for (size_t i = 0; i < numValues; ++i) {
+            const Evaluation& kro_go =
+                GasOilMaterialLaw::twoPhaseSatKrw(params.gasOilParams(), 1 - Sg[i] - Swco);
+
+            // see krn() for the computation of beta
+            const Evaluation& SSw = (Sw[i] - Swco)/(1.0 - Swco);
+            const Evaluation& SSg = Sg[i]/(1.0 - Swco);
+            Evaluation beta = 1.0;
+            if (!(Sw[i] <= Swco || SSw >= 1.0 || SSg >= 1.0))
+                beta = Opm::pow((1.0 - SSw - SSg)/((1 - SSw)*(1 - SSg)), eta);
+
+            kroValues[i] = Opm::max(0.0, Opm::min(1.0, beta*kroValues[i]*kro_go/krocw));
+        }
+    }
+
     /*!
      * \brief The relative permeability of the gas phase.
      */
@@ -341,6 +450,61 @@ public:
     template <class FluidState, class Evaluation = typename FluidState::Scalar>
     static Evaluation krn(const Params& params,
                           const FluidState& fluidState)
+    {
+        const Evaluation& Sw = Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
+        const Evaluation& Sg = Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
+
+        Evaluation kro;
+        if (tabulatedKrn_(kro, params, Sw, Sg))
+            return kro;
+
+        const Evaluation& kro_ow = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw);
+        return krn_(params, Sw, Sg, kro_ow);
+    }
+
+    /*!
+     * \brief Update the hysteresis parameters after a time step.
+     *
+     * This assumes that the nested two-phase material laws are parameters for
+     * EclHysteresisLaw. If they are not, calling this methid will cause a compiler
+     * error. (But not calling it will still work.) The return value is true if the
+     * scanning curves of any of the nested laws were modified.
+     */
+    template <class FluidState>
+    static bool updateHysteresis(Params& params, const FluidState& fluidState)
+    {
+        Scalar Sw = Opm::scalarValue(fluidState.saturation(waterPhaseIdx));
+        Scalar Sg = Opm::scalarValue(fluidState.saturation(gasPhaseIdx));
+
+        bool changed = params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/Sw, /*krnSw=*/Sw);
+        changed = params.gasOilParams().update(/*pcSw=*/1 - Sg, /*krwSw=*/1 - Sg, /*krnSw=*/1 - Sg) || changed;
+        return changed;
+    }
+
+private:
+    // look the oil relperm up in the table of the parameters if there is one and the
+    // saturations are within the triangle covered by it
+    template <class Evaluation>
+    static bool tabulatedKrn_(Evaluation& kro,
+                              const Params& params,
+                              const Evaluation& Sw,
+                              const Evaluation& Sg)
+    {
+        const auto* kroTable = params.kroTable();
+        if (!kroTable || !kroTable->applies(Sw, Sg) || Sw + Sg > 1.0)
+            return false;
+
+        kro = kroTable->eval(Sw, Sg);
+        return true;
+    }
+
+    // the Stone 1 combination for the oil relative permeability given the one of the
+    // oil-water system
+    template <class Evaluation>
+    static Evaluation krn_(const Params& params,
+                           const Evaluation& Sw,
+                           const Evaluation& Sg,
+                           const Evaluation& kro_ow)
     {
         // the Eclipse docu is inconsistent with naming the variable of connate water: In
         // some places the connate water saturation is represented by "Swl", in others
@@ -350,10 +514,6 @@ public:
         // oil relperm at connate water saturations (with Sg=0)
         Scalar krocw = params.krocw();
 
-        const Evaluation& Sw = Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
-        const Evaluation& Sg = Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
-
-        Evaluation kro_ow = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw);
         Evaluation kro_go = GasOilMaterialLaw::twoPhaseSatKrw(params.gasOilParams(), 1 - Sg - Swco);
 
         Evaluation beta;
@@ -375,23 +535,6 @@ public:
 
         return Opm::max(0.0, Opm::min(1.0, beta*kro_ow*kro_go/krocw));
     }
-
-    /*!
-     * \brief Update the hysteresis parameters after a time step.
-     *
-     * This assumes that the nested two-phase material laws are parameters for
-     * EclHysteresisLaw. If they are not, calling this methid will cause a compiler
-     * error. (But not calling it will still work.)
-     */
-    template <class FluidState>
-    static void updateHysteresis(Params& params, const FluidState& fluidState)
-    {
-        Scalar Sw = Opm::scalarValue(fluidState.saturation(waterPhaseIdx));
-        Scalar Sg = Opm::scalarValue(fluidState.saturation(gasPhaseIdx));
-
-        params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/Sw, /*krnSw=*/Sw);
-        params.gasOilParams().update(/*pcSw=*/1 - Sg, /*krwSw=*/1 - Sg, /*krnSw=*/1 - Sg);
-    }
 };
 } // namespace Opm
 
@@ -28,6 +28,7 @@
 #define OPM_ECL_STONE2_MATERIAL_HPP
 
 #include "EclStone2MaterialParams.hpp"
+#include "MaterialLawCombinedEvaluation.hpp"
 
 #include <opm/common/Valgrind.hpp>
 #include <opm/material/common/MathToolbox.hpp>
@@ -55,9 +56,7 @@ namespace Opm {
 template <class TraitsT,
           class GasOilMaterialLawT,
           class OilWaterMaterialLawT,
-          class ParamsT = EclStone2MaterialParams<TraitsT,
-                                                   typename GasOilMaterialLawT::Params,
-                                                   typename OilWaterMaterialLawT::Params> >
+          class ParamsT = EclStone2MaterialParams<TraitsT, GasOilMaterialLawT, OilWaterMaterialLawT> >
 class EclStone2Material : public TraitsT
 {
 public:
@@ -314,6 +313,109 @@ public:
         values[gasPhaseIdx] = krg<FluidState, Evaluation>(params, fluidState);
     }
 
+    /*!
+     * \brief The capillary pressures and the relative permeabilities of all phases.
+     *
+     * This yields the same results as capillaryPressures() and
+     * relativePermeabilities(), but since the Stone 2 model evaluates all quantities
+     * of the oil-water system at the water saturation and all quantities of the
+     * gas-oil system at one minus the gas saturation, each of the nested two-phase
+     * laws is only asked once.
+     */
+    template <class PcContainerT, class KrContainerT, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainerT& pcValues,
+                                                            KrContainerT& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fluidState)
+    {
+        typedef typename std::remove_reference<decltype(pcValues[0])>::type Evaluation;
+
+        const Evaluation& Sw = Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
+        const Evaluation& Sg = Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
+
+        Evaluation pcow;
+        Evaluation krw;
+        Evaluation krow;
+        Opm::twoPhaseSatPcnwAndKr<OilWaterMaterialLaw, Evaluation>(&pcow, &krw, &krow,
+                                                                   params.oilWaterParams(), Sw);
+
+        Evaluation pcgo;
+        Evaluation krog;
+        Evaluation krg;
+        Opm::twoPhaseSatPcnwAndKr<GasOilMaterialLaw, Evaluation>(&pcgo, &krog, &krg,
+                                                                 params.gasOilParams(), 1 - Sg);
+
+        pcValues[gasPhaseIdx] = pcgo;
+        pcValues[oilPhaseIdx] = 0;
+        pcValues[waterPhaseIdx] = - pcow;
+
+        krValues[waterPhaseIdx] = krw;
+        if (!tabulatedKrn_(krValues[oilPhaseIdx], params, Sw, Sg))
+            krValues[oilPhaseIdx] = krn_(params, krow, krw, krog, krg);
+        krValues[gasPhaseIdx] = krg;
+    }
+
+    /*!
+     * \brief The relative permeabilities of all phases for an array of saturations.
+     *
+     * This computes the same values as calling relativePermeabilities() for each entry
+     * of the arrays, but all entries must use the same parameter object: The array
+     * 'saturations[phaseIdx]' stores the saturations of the phase for each of the
+     * numValues entries and 'kr[phaseIdx]' receives the corresponding relative
+     * permeabilities. The lookups in the two-phase tables are done in separate passes
+     * over the arrays so that the table which is used stays in the cache and the
+     * segment searches look at the same data. The result arrays must not overlap with
+     * the saturation arrays.
+     */
+    template <class Evaluation>
+    static void relativePermeabilitiesMany(Evaluation* const* kr,
+                                           const Params& params,
+                                           const Evaluation* const* saturations,
+                                           size_t numValues)
+    {
+        const Evaluation* Sw = saturations[waterPhaseIdx];
+        const Evaluation* Sg = saturations[gasPhaseIdx];
+        Evaluation* krwValues = kr[waterPhaseIdx];
+        Evaluation* kroValues = kr[oilPhaseIdx];
+        Evaluation* krgValues = kr[gasPhaseIdx];
+
+        for (size_t i = 0; i < numValues; ++i)
+            krwValues[i] = OilWaterMaterialLaw::twoPhaseSatKrw(params.oilWaterParams(), Sw[i]);
+
+        for (size_t i = 0; i < numValues; ++i)
+            krgValues[i] = GasOilMaterialLaw::twoPhaseSatKrn(params.gasOilParams(), 1 - Sg[i]);
+
+        if (params.kroTable()) {
+            // the oil relperm is looked up in the table. only the entries outside of its
+            // range use the Stone combination
+            for (size_t i = 0; i < numValues; ++i) {
+                if (tabulatedKrn_(kroValues[i], params, Sw[i], Sg[i]))
+                    continue;
+
+                const Evaluation& krow = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw[i]);
+                const Evaluation& krog = GasOilMaterialLaw::twoPhaseSatKrw(params.gasOilParams(), 1 - Sg[i]);
+                kroValues[i] = krn_(params, krow, krwValues[i], krog, krgValues[i]);
+            }
+            return;
+        }
+
+        // the oil relperm of the oil-water system is stored in the output array of the
+        // oil phase until it is combined with the one of the gas-oil system below.
+        for (size_t i = 0; i < numValues; ++i)
+            kroValues[i] = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw[i]);
+
+        Scalar krocw = params.krocw();
+        for (size_t i = 0; i < numValues; ++i) {
+            const Evaluation& krog =
+                GasOilMaterialLaw::twoPhaseSatKrw(params.gasOilParams(), 1 - Sg[i]);
+            const Evaluation krow = kroValues[i];
+
+            kroValues[i] =
+                krocw*((krow/krocw + krwValues[i])*(krog/krocw + krgValues[i])
+                       - krwValues[i] - krgValues[i]);
+        }
+    }
+
     /*!
      * \brief The relative permeability of the gas phase.
      */
@@ -343,17 +445,19 @@ public:
     static Evaluation krn(const Params& params,
                           const FluidState& fluidState)
     {
-        Scalar Swco = params.Swl();
         const Evaluation& Sw = Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
         const Evaluation& Sg = Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
 
-        Scalar krocw = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Swco);
+        Evaluation kro;
+        if (tabulatedKrn_(kro, params, Sw, Sg))
+            return kro;
+
         Evaluation krow = OilWaterMaterialLaw::twoPhaseSatKrn(params.oilWaterParams(), Sw);
         Evaluation krw = OilWaterMaterialLaw::twoPhaseSatKrw(params.oilWaterParams(), Sw);
         Evaluation krg = GasOilMaterialLaw::twoPhaseSatKrn(params.gasOilParams(), 1 - Sg);
         Evaluation krog = GasOilMaterialLaw::twoPhaseSatKrw(params.gasOilParams(), 1 - Sg);
 
-        return krocw*((krow/krocw + krw)*(krog/krocw + krg) - krw - krg);
+        return krn_(params, krow, krw, krog, krg);
     }
 
     /*!
@@ -361,16 +465,49 @@ public:
      *
      * This assumes that the nested two-phase material laws are parameters for
      * EclHysteresisLaw. If they are not, calling this methid will cause a compiler
-     * error. (But not calling it will still work.)
+     * error. (But not calling it will still work.) The return value is true if the
+     * scanning curves of any of the nested laws were modified.
      */
     template <class FluidState>
-    static void updateHysteresis(Params& params, const FluidState& fluidState)
+    static bool updateHysteresis(Params& params, const FluidState& fluidState)
     {
         Scalar Sw = Opm::scalarValue(fluidState.saturation(waterPhaseIdx));
         Scalar Sg = Opm::scalarValue(fluidState.saturation(gasPhaseIdx));
 
-        params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/Sw, /*krnSw=*/Sw);
-        params.gasOilParams().update(/*pcSw=*/1 - Sg, /*krwSw=*/1 - Sg, /*krnSw=*/1 - Sg);
+        bool changed = params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/Sw, /*krnSw=*/Sw);
+        changed = params.gasOilParams().update(/*pcSw=*/1 - Sg, /*krwSw=*/1 - Sg, /*krnSw=*/1 - Sg) || changed;
+        return changed;
+    }
+
+private:
+    // look the oil relperm up in the table of the parameters if there is one and the
+    // saturations are within the triangle covered by it
+    template <class Evaluation>
+    static bool tabulatedKrn_(Evaluation& kro,
+                              const Params& params,
+                              const Evaluation& Sw,
+                              const Evaluation& Sg)
+    {
+        const auto* kroTable = params.kroTable();
+        if (!kroTable || !kroTable->applies(Sw, Sg) || Sw + Sg > 1.0)
+            return false;
+
+        kro = kroTable->eval(Sw, Sg);
+        return true;
+    }
+
+    // the Stone 2 combination for the oil relative permeability given the relative
+    // permeabilities of the two-phase systems
+    template <class Evaluation>
+    static Evaluation krn_(const Params& params,
+                           const Evaluation& krow,
+                           const Evaluation& krw,
+                           const Evaluation& krog,
+                           const Evaluation& krg)
+    {
+        Scalar krocw = params.krocw();
+
+        return krocw*((krow/krocw + krw)*(krog/krocw + krg) - krw - krg);
     }
 };
 } // namespace Opm
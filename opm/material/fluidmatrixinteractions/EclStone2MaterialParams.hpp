@@ -27,6 +27,8 @@
 #ifndef OPM_ECL_STONE2_MATERIAL_PARAMS_HPP
 #define OPM_ECL_STONE2_MATERIAL_PARAMS_HPP
 
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
 #include <opm/material/common/EnsureFinalized.hpp>
 
 #include <type_traits>
@@ -43,16 +45,15 @@ namespace Opm {
  * Essentially, this class just stores the two parameter objects for
  * the twophase capillary pressure laws.
  */
-template<class Traits, class GasOilParamsT, class OilWaterParamsT>
+template<class Traits, class GasOilLawT, class OilWaterLawT>
 class EclStone2MaterialParams : public EnsureFinalized
 {
     typedef typename Traits::Scalar Scalar;
     enum { numPhases = 3 };
 public:
-    using EnsureFinalized :: finalize;
-
-    typedef GasOilParamsT GasOilParams;
-    typedef OilWaterParamsT OilWaterParams;
+    typedef typename GasOilLawT::Params GasOilParams;
+    typedef typename OilWaterLawT::Params OilWaterParams;
+    typedef UniformTabulated2DFunction<Scalar> KroTable;
 
     /*!
      * \brief The default constructor.
@@ -61,6 +62,16 @@ public:
     {
     }
 
+    /*!
+     * \brief Finish the initialization of the parameter object.
+     */
+    void finalize()
+    {
+        krocw_ = OilWaterLawT::twoPhaseSatKrn(*oilWaterParams_, Swl_);
+
+        EnsureFinalized :: finalize();
+    }
+
     /*!
      * \brief The parameter object for the gas-oil twophase law.
      */
@@ -117,11 +128,71 @@ public:
     Scalar Swl() const
     { EnsureFinalized::check(); return Swl_; }
 
+    /*!
+     * \brief Return the oil relperm for the oil-water system at the connate water
+     *        saturation.
+     */
+    Scalar krocw() const
+    { EnsureFinalized::check(); return krocw_; }
+
+    /*!
+     * \brief Set the table of the three-phase oil relative permeability.
+     *
+     * If a table is specified, the oil relperm is looked up in it as a function of the
+     * water and the gas saturations instead of combining the oil relperms of the
+     * two-phase systems whenever the saturations are within the range of the table.
+     * The table must be consistent with the two-phase laws, see
+     * EclMaterialLawManager::tabulateThreePhaseKro().
+     */
+    void setKroTable(std::shared_ptr<KroTable> val)
+    { kroTable_ = val; }
+
+    /*!
+     * \brief Returns the table of the three-phase oil relative permeability or
+     *        nullptr if the oil relperm is not tabulated.
+     */
+    const KroTable* kroTable() const
+    { return kroTable_.get(); }
+
+    /*!
+     * \brief Write the finalized parameters to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        EnsureFinalized::check();
+
+        writer.writeShared(gasOilParams_);
+        writer.writeShared(oilWaterParams_);
+        writer.writeShared(kroTable_);
+        writer.write(Swl_);
+        writer.write(krocw_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.readShared(gasOilParams_);
+        reader.readShared(oilWaterParams_);
+        reader.readShared(kroTable_);
+        reader.read(Swl_);
+        reader.read(krocw_);
+
+        if (!gasOilParams_ || !oilWaterParams_)
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: incomplete three-phase parameters");
+
+        EnsureFinalized::finalize();
+    }
+
 private:
     std::shared_ptr<GasOilParams> gasOilParams_;
     std::shared_ptr<OilWaterParams> oilWaterParams_;
+    std::shared_ptr<KroTable> kroTable_;
 
     Scalar Swl_;
+    Scalar krocw_;
 };
 } // namespace Opm
 
@@ -0,0 +1,190 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Tabulate the three-phase oil relative permeability of the ECL three-phase
+ *        laws.
+ *
+ * Without end-point scaling and hysteresis, the oil relative permeability of
+ * EclDefaultMaterial, EclStone1Material and EclStone2Material only depends on the
+ * water and the gas saturations. tabulateEclThreePhaseKro() samples it on a uniform
+ * grid which is refined until the bi-linear interpolation is accurate enough. If the
+ * resulting table is passed to the parameter object using setKroTable(), the laws
+ * obtain the oil relperm by a single lookup instead of evaluating the oil relperms of
+ * both two-phase systems and combining them.
+ */
+#ifndef OPM_ECL_THREE_PHASE_KRO_TABLE_HPP
+#define OPM_ECL_THREE_PHASE_KRO_TABLE_HPP
+
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
+#include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace Opm {
+namespace EclThreePhaseKroTableDetail {
+// the oil relperm of the law computed from the two-phase systems. the saturations
+// outside of the triangle Sw + Sg <= 1 are mapped to its boundary, so that the cells
+// of the table which are cut by it do not see non-physical values. the boundary is
+// moved inwards by a few units of roundoff because the laws may compute a slightly
+// negative oil saturation there, which is not defined for the Stone 1 model.
+template <class ThreePhaseLaw>
+typename ThreePhaseLaw::Scalar exactKrn(const typename ThreePhaseLaw::Params& params,
+                                        typename ThreePhaseLaw::Scalar Sw,
+                                        typename ThreePhaseLaw::Scalar Sg)
+{
+    typedef typename ThreePhaseLaw::Scalar Scalar;
+    typedef Opm::SimpleModularFluidState<Scalar,
+                                         ThreePhaseLaw::numPhases,
+                                         /*numComponents=*/0,
+                                         /*FluidSystem=*/void, /* -> don't care */
+                                         /*storePressure=*/false,
+                                         /*storeTemperature=*/false,
+                                         /*storeComposition=*/false,
+                                         /*storeFugacity=*/false,
+                                         /*storeSaturation=*/true,
+                                         /*storeDensity=*/false,
+                                         /*storeViscosity=*/false,
+                                         /*storeEnthalpy=*/false> FluidState;
+
+    Sg = std::min(Sg, Scalar(1.0) - Sw - 16*std::numeric_limits<Scalar>::epsilon());
+
+    FluidState fs;
+    fs.setSaturation(ThreePhaseLaw::waterPhaseIdx, Sw);
+    fs.setSaturation(ThreePhaseLaw::gasPhaseIdx, Sg);
+    fs.setSaturation(ThreePhaseLaw::oilPhaseIdx, 1.0 - Sw - Sg);
+    return ThreePhaseLaw::template krn<FluidState, Scalar>(params, fs);
+}
+} // namespace EclThreePhaseKroTableDetail
+
+/*!
+ * \brief Sample the three-phase oil relative permeability of a parameter object.
+ *
+ * The table covers water saturations between the connate one and 1 and gas
+ * saturations between 0 and one minus the connate water saturation. The laws only use
+ * it for saturations within this range whose sum does not exceed 1 and compute the oil
+ * relperm from the two-phase systems otherwise.
+ *
+ * The sampling starts with 9 points per direction and the number of intervals is
+ * doubled until the bi-linear interpolation of the coarser sampling deviates by at
+ * most 'tolerance' from the exact oil relperm at all points of the finer one which
+ * satisfy Sw + Sg <= 1. The coarser sampling is returned in this case. If the number
+ * of points per direction would exceed 'maxNumSamples' before that, nullptr is
+ * returned.
+ *
+ * Any table which is set on the parameter object is ignored for the sampling, and the
+ * parameter object must not use hysteresis or end-point scaling which differs between
+ * the elements that are supposed to share the table.
+ */
+template <class ThreePhaseLaw>
+std::shared_ptr<UniformTabulated2DFunction<typename ThreePhaseLaw::Scalar> >
+tabulateEclThreePhaseKro(const typename ThreePhaseLaw::Params& params,
+                         typename ThreePhaseLaw::Scalar tolerance,
+                         unsigned maxNumSamples)
+{
+    typedef typename ThreePhaseLaw::Scalar Scalar;
+    typedef typename ThreePhaseLaw::Params Params;
+    typedef UniformTabulated2DFunction<Scalar> KroTable;
+
+    const Scalar Swl = params.Swl();
+    if (!(Swl < 1.0))
+        return nullptr;
+
+    Params exactParams(params);
+    exactParams.setKroTable(nullptr);
+
+    const Scalar SwMin = Swl;
+    const Scalar SwMax = 1.0;
+    const Scalar SgMin = 0.0;
+    const Scalar SgMax = 1.0 - Swl;
+    auto position = [](Scalar minValue, Scalar maxValue, unsigned idx, unsigned n) {
+        return minValue + (maxValue - minValue)*idx/(n - 1);
+    };
+
+    // the samples are stored in row major order with the water saturation as the
+    // fast index
+    unsigned n = 9;
+    std::vector<Scalar> samples(n*n);
+    for (unsigned j = 0; j < n; ++j)
+        for (unsigned i = 0; i < n; ++i)
+            samples[j*n + i] =
+                EclThreePhaseKroTableDetail::exactKrn<ThreePhaseLaw>(exactParams,
+                                                                     position(SwMin, SwMax, i, n),
+                                                                     position(SgMin, SgMax, j, n));
+
+    std::vector<Scalar> fineSamples;
+    while (2*n - 1 <= maxNumSamples) {
+        // sample the function at the midpoints of the current sampling and compare
+        // the values to the interpolated ones
+        const unsigned nFine = 2*n - 1;
+        fineSamples.resize(nFine*nFine);
+        Scalar maxError = 0.0;
+        for (unsigned j = 0; j < nFine; ++j) {
+            const Scalar Sg = position(SgMin, SgMax, j, nFine);
+            for (unsigned i = 0; i < nFine; ++i) {
+                const unsigned iLow = i/2;
+                const unsigned iHigh = (i + 1)/2;
+                const unsigned jLow = j/2;
+                const unsigned jHigh = (j + 1)/2;
+                if (iLow == iHigh && jLow == jHigh) {
+                    fineSamples[j*nFine + i] = samples[jLow*n + iLow];
+                    continue;
+                }
+
+                const Scalar Sw = position(SwMin, SwMax, i, nFine);
+                const Scalar value = EclThreePhaseKroTableDetail::exactKrn<ThreePhaseLaw>(exactParams, Sw, Sg);
+                fineSamples[j*nFine + i] = value;
+
+                if (Sw + Sg > 1.0)
+                    continue;
+
+                const Scalar interpolated =
+                    (samples[jLow*n + iLow] + samples[jLow*n + iHigh]
+                     + samples[jHigh*n + iLow] + samples[jHigh*n + iHigh])/4;
+                maxError = std::max(maxError, std::abs(value - interpolated));
+            }
+        }
+
+        if (maxError <= tolerance) {
+            auto table = std::make_shared<KroTable>(SwMin, SwMax, n, SgMin, SgMax, n);
+            for (unsigned j = 0; j < n; ++j)
+                for (unsigned i = 0; i < n; ++i)
+                    table->setSamplePoint(i, j, samples[j*n + i]);
+            return table;
+        }
+
+        n = nFine;
+        samples.swap(fineSamples);
+    }
+
+    return nullptr;
+}
+
+} // namespace Opm
+
+#endif
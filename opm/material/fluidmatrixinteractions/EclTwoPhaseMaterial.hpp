@@ -28,6 +28,7 @@
 #define OPM_ECL_TWO_PHASE_MATERIAL_HPP
 
 #include "EclTwoPhaseMaterialParams.hpp"
+#include "MaterialLawCombinedEvaluation.hpp"
 
 #include <opm/common/Valgrind.hpp>
 #include <opm/material/common/MathToolbox.hpp>
@@ -349,6 +350,76 @@ public:
         }
     }
 
+    /*!
+     * \brief The capillary pressures and the relative permeabilities of all phases.
+     *
+     * This yields the same results as capillaryPressures() and
+     * relativePermeabilities(), but the quantities of a two-phase system which are
+     * evaluated at the same saturation are computed using a single call to the
+     * nested law.
+     */
+    template <class PcContainerT, class KrContainerT, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainerT& pcValues,
+                                                            KrContainerT& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fluidState)
+    {
+        typedef typename std::remove_reference<decltype(pcValues[0])>::type Evaluation;
+
+        switch (params.approach()) {
+        case EclTwoPhaseGasOil: {
+            const Evaluation& So =
+                Opm::decay<Evaluation>(fluidState.saturation(oilPhaseIdx));
+
+            Evaluation pcgo;
+            Evaluation kro;
+            Evaluation krg;
+            Opm::twoPhaseSatPcnwAndKr<GasOilMaterialLaw, Evaluation>(&pcgo, &kro, &krg,
+                                                                     params.gasOilParams(), So);
+
+            pcValues[oilPhaseIdx] = 0.0;
+            pcValues[gasPhaseIdx] = pcgo;
+            krValues[oilPhaseIdx] = kro;
+            krValues[gasPhaseIdx] = krg;
+            break;
+        }
+
+        case EclTwoPhaseOilWater: {
+            const Evaluation& Sw =
+                Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
+
+            Evaluation pcow;
+            Evaluation krw;
+            Evaluation kro;
+            Opm::twoPhaseSatPcnwAndKr<OilWaterMaterialLaw, Evaluation>(&pcow, &krw, &kro,
+                                                                       params.oilWaterParams(), Sw);
+
+            pcValues[waterPhaseIdx] = 0.0;
+            pcValues[oilPhaseIdx] = pcow;
+            krValues[waterPhaseIdx] = krw;
+            krValues[oilPhaseIdx] = kro;
+            break;
+        }
+
+        case EclTwoPhaseGasWater: {
+            const Evaluation& Sw =
+                Opm::decay<Evaluation>(fluidState.saturation(waterPhaseIdx));
+
+            Evaluation pcow;
+            Evaluation krw;
+            Opm::twoPhaseSatPcnwAndKr<OilWaterMaterialLaw, Evaluation>(&pcow, &krw, nullptr,
+                                                                       params.oilWaterParams(), Sw);
+
+            pcValues[waterPhaseIdx] = 0.0;
+            pcValues[gasPhaseIdx] =
+                pcow + GasOilMaterialLaw::twoPhaseSatPcnw(params.gasOilParams(), 0.0);
+            krValues[waterPhaseIdx] = krw;
+            krValues[gasPhaseIdx] = GasOilMaterialLaw::twoPhaseSatKrn(params.gasOilParams(), Sw);
+            break;
+        }
+        }
+    }
+
     /*!
      * \brief The relative permeability of the gas phase.
      */
@@ -385,34 +456,35 @@ public:
      *
      * This assumes that the nested two-phase material laws are parameters for
      * EclHysteresisLaw. If they are not, calling this methid will cause a compiler
-     * error. (But not calling it will still work.)
+     * error. (But not calling it will still work.) The return value is true if the
+     * scanning curves of any of the nested laws were modified.
      */
     template <class FluidState>
-    static void updateHysteresis(Params& params, const FluidState& fluidState)
+    static bool updateHysteresis(Params& params, const FluidState& fluidState)
     {
         switch (params.approach()) {
         case EclTwoPhaseGasOil: {
             Scalar So = Opm::scalarValue(fluidState.saturation(oilPhaseIdx));
 
-            params.gasOilParams().update(/*pcSw=*/So, /*krwSw=*/So, /*krnSw=*/So);
-            break;
+            return params.gasOilParams().update(/*pcSw=*/So, /*krwSw=*/So, /*krnSw=*/So);
         }
 
         case EclTwoPhaseOilWater: {
             Scalar Sw = Opm::scalarValue(fluidState.saturation(waterPhaseIdx));
 
-            params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/Sw, /*krnSw=*/Sw);
-            break;
+            return params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/Sw, /*krnSw=*/Sw);
         }
 
         case EclTwoPhaseGasWater: {
             Scalar Sw = Opm::scalarValue(fluidState.saturation(waterPhaseIdx));
 
-            params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/Sw, /*krnSw=*/0);
-            params.gasOilParams().update(/*pcSw=*/1.0, /*krwSw=*/0.0, /*krnSw=*/Sw);
-            break;
+            bool changed = params.oilWaterParams().update(/*pcSw=*/Sw, /*krwSw=*/Sw, /*krnSw=*/0);
+            changed = params.gasOilParams().update(/*pcSw=*/1.0, /*krwSw=*/0.0, /*krnSw=*/Sw) || changed;
+            return changed;
         }
         }
+
+        return false;
     }
 };
 } // namespace Opm
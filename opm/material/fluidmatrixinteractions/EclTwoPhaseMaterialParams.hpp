@@ -27,10 +27,12 @@
 #ifndef OPM_ECL_TWO_PHASE_MATERIAL_PARAMS_HPP
 #define OPM_ECL_TWO_PHASE_MATERIAL_PARAMS_HPP
 
+#include <cstdint>
 #include <type_traits>
 #include <cassert>
 #include <memory>
 
+#include <opm/material/common/BinarySerialization.hpp>
 #include <opm/material/common/EnsureFinalized.hpp>
 
 namespace Opm {
@@ -108,6 +110,41 @@ public:
     void setOilWaterParams(std::shared_ptr<OilWaterParams> val)
     { oilWaterParams_ = val; }
 
+    /*!
+     * \brief Write the finalized parameters to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        EnsureFinalized::check();
+
+        writer.write(static_cast<std::int32_t>(approach_));
+        writer.writeShared(gasOilParams_);
+        writer.writeShared(oilWaterParams_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        std::int32_t approach;
+        reader.read(approach);
+        if (approach < EclTwoPhaseGasOil || approach > EclTwoPhaseGasWater)
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: invalid two-phase approach " << approach);
+        approach_ = static_cast<EclTwoPhaseApproach>(approach);
+        reader.readShared(gasOilParams_);
+        reader.readShared(oilWaterParams_);
+
+        // the parameters of the two-phase system which is not used may be absent
+        if ((approach_ != EclTwoPhaseOilWater && !gasOilParams_)
+            || (approach_ != EclTwoPhaseGasOil && !oilWaterParams_))
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: incomplete two-phase parameters");
+
+        EnsureFinalized::finalize();
+    }
+
 private:
     EclTwoPhaseApproach approach_;
 
@@ -28,6 +28,7 @@
 #define OPM_EFF_TO_ABS_LAW_HPP
 
 #include "EffToAbsLawParams.hpp"
+#include "MaterialLawCombinedEvaluation.hpp"
 
 #include <opm/material/fluidstates/SaturationOverlayFluidState.hpp>
 
@@ -119,12 +120,7 @@ public:
         typedef Opm::SaturationOverlayFluidState<FluidState> OverlayFluidState;
 
         OverlayFluidState overlayFs(fs);
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            overlayFs.setSaturation(phaseIdx,
-                                    effectiveSaturation(params,
-                                                        fs.saturation(phaseIdx),
-                                                        phaseIdx));
-        }
+        setEffectiveSaturations_(overlayFs, params, fs);
 
         EffLaw::template capillaryPressures<Container, OverlayFluidState>(values, params, overlayFs);
     }
@@ -145,16 +141,35 @@ public:
         typedef Opm::SaturationOverlayFluidState<FluidState> OverlayFluidState;
 
         OverlayFluidState overlayFs(fs);
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            overlayFs.setSaturation(phaseIdx,
-                                    effectiveSaturation(params,
-                                                        fs.saturation(phaseIdx),
-                                                        phaseIdx));
-        }
+        setEffectiveSaturations_(overlayFs, params, fs);
 
         EffLaw::template relativePermeabilities<Container, OverlayFluidState>(values, params, overlayFs);
     }
 
+    /*!
+     * \brief Compute the capillary pressures and the relative permeabilities of all
+     *        phases at once.
+     *
+     * The absolute saturations are only converted to effective ones once for both
+     * quantities. If the wrapped law provides a
+     * capillaryPressuresAndRelativePermeabilities() method, it is used to evaluate
+     * them, else its capillaryPressures() and relativePermeabilities() methods are
+     * called.
+     */
+    template <class PcContainer, class KrContainer, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainer& pcValues,
+                                                            KrContainer& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fs)
+    {
+        typedef Opm::SaturationOverlayFluidState<FluidState> OverlayFluidState;
+
+        OverlayFluidState overlayFs(fs);
+        setEffectiveSaturations_(overlayFs, params, fs);
+
+        Opm::capillaryPressuresAndRelativePermeabilities<EffLaw>(pcValues, krValues, params, overlayFs);
+    }
+
     /*!
      * \brief The capillary pressure-saturation curve.
      *
@@ -176,12 +191,7 @@ public:
                       "number of phases!");
 
         OverlayFluidState overlayFs(fs);
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            overlayFs.setSaturation(phaseIdx,
-                                    effectiveSaturation(params,
-                                                        fs.saturation(phaseIdx),
-                                                        phaseIdx));
-        }
+        setEffectiveSaturations_(overlayFs, params, fs);
 
         return EffLaw::template pcnw<OverlayFluidState, Evaluation>(params, overlayFs);
     }
@@ -281,12 +291,7 @@ public:
                       "number of phases!");
 
         OverlayFluidState overlayFs(fs);
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            overlayFs.setSaturation(phaseIdx,
-                                    effectiveSaturation(params,
-                                                        fs.saturation(phaseIdx),
-                                                        phaseIdx));
-        }
+        setEffectiveSaturations_(overlayFs, params, fs);
 
         return EffLaw::template krw<OverlayFluidState, Evaluation>(params, overlayFs);
     }
@@ -309,12 +314,7 @@ public:
                       "number of phases!");
 
         OverlayFluidState overlayFs(fs);
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            overlayFs.setSaturation(phaseIdx,
-                                    effectiveSaturation(params,
-                                                        fs.saturation(phaseIdx),
-                                                        phaseIdx));
-        }
+        setEffectiveSaturations_(overlayFs, params, fs);
 
         return EffLaw::template krn<OverlayFluidState, Evaluation>(params, overlayFs);
     }
@@ -340,12 +340,7 @@ public:
                       "number of phases!");
 
         OverlayFluidState overlayFs(fs);
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            overlayFs.setSaturation(phaseIdx,
-                                    effectiveSaturation(params,
-                                                        fs.saturation(phaseIdx),
-                                                        phaseIdx));
-        }
+        setEffectiveSaturations_(overlayFs, params, fs);
 
         return EffLaw::template krg<OverlayFluidState, Evaluation>(params, overlayFs);
     }
@@ -365,6 +360,19 @@ public:
     { return S*(1.0 - params.sumResidualSaturations()) + params.residualSaturation(phaseIdx); }
 
 private:
+    template <class OverlayFluidState, class FluidState>
+    static void setEffectiveSaturations_(OverlayFluidState& overlayFs,
+                                         const Params& params,
+                                         const FluidState& fs)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            overlayFs.setSaturation(phaseIdx,
+                                    effectiveSaturation(params,
+                                                        fs.saturation(phaseIdx),
+                                                        phaseIdx));
+        }
+    }
+
     /*!
      * \brief           Derivative of the effective saturation w.r.t. the absolute saturation.
      *
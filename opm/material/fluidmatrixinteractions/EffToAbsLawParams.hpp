@@ -69,6 +69,22 @@ public:
         EffLawParams::finalize();
     }
 
+    /*!
+     * \brief Returns true if the independent quantities of two parameter
+     *        objects are identical.
+     */
+    bool operator==(const EffToAbsLawParams& other) const
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (residualSaturation_[phaseIdx] != other.residualSaturation_[phaseIdx])
+                return false;
+
+        return EffLawParams::operator==(other);
+    }
+
+    bool operator!=(const EffToAbsLawParams& other) const
+    { return !(*this == other); }
+
     /*!
      * \brief Return the residual saturation of a phase.
      */
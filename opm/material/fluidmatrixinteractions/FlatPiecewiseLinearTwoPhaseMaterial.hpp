@@ -0,0 +1,91 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::FlatPiecewiseLinearTwoPhaseMaterialParams
+ */
+#ifndef OPM_FLAT_PIECEWISE_LINEAR_TWO_PHASE_MATERIAL_HPP
+#define OPM_FLAT_PIECEWISE_LINEAR_TWO_PHASE_MATERIAL_HPP
+
+#include <opm/material/common/FlatTables.hpp>
+
+#include <type_traits>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Flat representation of the parameters of a piecewise linear two-phase
+ *        material law which can be evaluated by device code.
+ *
+ * The descriptor is produced by PiecewiseLinearTwoPhaseMaterialParams::exportFlat()
+ * and its methods yield the same results as the ones of
+ * Opm::PiecewiseLinearTwoPhaseMaterial. See opm/material/common/FlatTables.hpp.
+ */
+template <class Scalar>
+struct FlatPiecewiseLinearTwoPhaseMaterialParams
+{
+    FlatTabulated1DFunction<Scalar> pcnw;
+    FlatTabulated1DFunction<Scalar> krw;
+    FlatTabulated1DFunction<Scalar> krn;
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation twoPhaseSatPcnw(const FlatTableData<Scalar>& data, const Evaluation& Sw) const
+    { return pcnw.eval(data, Sw); }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation twoPhaseSatKrw(const FlatTableData<Scalar>& data, const Evaluation& Sw) const
+    { return krw.eval(data, Sw); }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation twoPhaseSatKrn(const FlatTableData<Scalar>& data, const Evaluation& Sw) const
+    { return krn.eval(data, Sw); }
+
+    /*!
+     * \brief The capillary pressure and the relative permeabilities at a given
+     *        wetting phase saturation.
+     *
+     * Only the quantities for which a non-null pointer is passed are computed.
+     */
+    template <class Evaluation>
+    OPM_HOST_DEVICE void twoPhaseSatPcnwAndKr(Evaluation* pcnwValue,
+                                              Evaluation* krwValue,
+                                              Evaluation* krnValue,
+                                              const FlatTableData<Scalar>& data,
+                                              const Evaluation& Sw) const
+    {
+        if (pcnwValue)
+            *pcnwValue = pcnw.eval(data, Sw);
+        if (krwValue)
+            *krwValue = krw.eval(data, Sw);
+        if (krnValue)
+            *krnValue = krn.eval(data, Sw);
+    }
+};
+
+static_assert(std::is_pod<FlatPiecewiseLinearTwoPhaseMaterialParams<double> >::value,
+              "The descriptors of flat tables must be plain old data");
+
+} // namespace Opm
+
+#endif
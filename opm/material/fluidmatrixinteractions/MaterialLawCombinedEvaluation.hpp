@@ -0,0 +1,157 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Evaluate the capillary pressures and the relative permeabilities of a
+ *        material law using a single call.
+ *
+ * Material laws may optionally provide the static methods
+ *
+ * \code
+ * template <class PcContainer, class KrContainer, class FluidState>
+ * static void capillaryPressuresAndRelativePermeabilities(PcContainer& pcValues,
+ *                                                         KrContainer& krValues,
+ *                                                         const Params& params,
+ *                                                         const FluidState& fs);
+ *
+ * template <class Evaluation>
+ * static void twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+ *                                  Evaluation* krw,
+ *                                  Evaluation* krn,
+ *                                  const Params& params,
+ *                                  const Evaluation& Sw);
+ * \endcode
+ *
+ * which compute the same values as the individual methods but are allowed to share
+ * the work which is common to them, e.g., the conversion of the saturations, the
+ * end-point scaling or the segment searches in tables. For the two-phase variant, a
+ * null pointer means that the respective quantity is not required.
+ *
+ * The functions of this file call these methods if the material law provides them
+ * and fall back to the individual methods otherwise. Composite laws should thus use
+ * them to evaluate their nested laws.
+ */
+#ifndef OPM_MATERIAL_LAW_COMBINED_EVALUATION_HPP
+#define OPM_MATERIAL_LAW_COMBINED_EVALUATION_HPP
+
+namespace Opm {
+namespace CombinedEvaluationDetail {
+// use the combined method of the material law if it exists...
+template <class MaterialLaw, class PcContainer, class KrContainer, class FluidState>
+auto capillaryPressuresAndRelativePermeabilities(PcContainer& pcValues,
+                                                 KrContainer& krValues,
+                                                 const typename MaterialLaw::Params& params,
+                                                 const FluidState& fs,
+                                                 int)
+    -> decltype(MaterialLaw::capillaryPressuresAndRelativePermeabilities(pcValues, krValues, params, fs))
+{ MaterialLaw::capillaryPressuresAndRelativePermeabilities(pcValues, krValues, params, fs); }
+
+// ... else evaluate both quantities separately
+template <class MaterialLaw, class PcContainer, class KrContainer, class FluidState>
+void capillaryPressuresAndRelativePermeabilities(PcContainer& pcValues,
+                                                 KrContainer& krValues,
+                                                 const typename MaterialLaw::Params& params,
+                                                 const FluidState& fs,
+                                                 long)
+{
+    MaterialLaw::template capillaryPressures<PcContainer, FluidState>(pcValues, params, fs);
+    MaterialLaw::template relativePermeabilities<KrContainer, FluidState>(krValues, params, fs);
+}
+
+template <class TwoPhaseLaw, class Evaluation>
+auto twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+                          Evaluation* krw,
+                          Evaluation* krn,
+                          const typename TwoPhaseLaw::Params& params,
+                          const Evaluation& Sw,
+                          int)
+    -> decltype(TwoPhaseLaw::twoPhaseSatPcnwAndKr(pcnw, krw, krn, params, Sw))
+{ TwoPhaseLaw::twoPhaseSatPcnwAndKr(pcnw, krw, krn, params, Sw); }
+
+template <class TwoPhaseLaw, class Evaluation>
+void twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+                          Evaluation* krw,
+                          Evaluation* krn,
+                          const typename TwoPhaseLaw::Params& params,
+                          const Evaluation& Sw,
+                          long)
+{
+    if (pcnw)
+        *pcnw = TwoPhaseLaw::twoPhaseSatPcnw(params, Sw);
+    if (krw)
+        *krw = TwoPhaseLaw::twoPhaseSatKrw(params, Sw);
+    if (krn)
+        *krn = TwoPhaseLaw::twoPhaseSatKrn(params, Sw);
+}
+} // namespace CombinedEvaluationDetail
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Compute the capillary pressures and the relative permeabilities of all
+ *        phases of a material law.
+ *
+ * If the law does not provide a capillaryPressuresAndRelativePermeabilities()
+ * method, its capillaryPressures() and relativePermeabilities() methods are called.
+ */
+template <class MaterialLaw, class PcContainer, class KrContainer, class FluidState>
+void capillaryPressuresAndRelativePermeabilities(PcContainer& pcValues,
+                                                 KrContainer& krValues,
+                                                 const typename MaterialLaw::Params& params,
+                                                 const FluidState& fs)
+{
+    CombinedEvaluationDetail::capillaryPressuresAndRelativePermeabilities<MaterialLaw>(pcValues,
+                                                                                       krValues,
+                                                                                       params,
+                                                                                       fs,
+                                                                                       /*preferCombined=*/0);
+}
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Compute the capillary pressure and the relative permeabilities of a
+ *        two-phase material law at a given wetting phase saturation.
+ *
+ * Only the quantities for which a non-null pointer is passed are computed. If the
+ * law does not provide a twoPhaseSatPcnwAndKr() method, its twoPhaseSatPcnw(),
+ * twoPhaseSatKrw() and twoPhaseSatKrn() methods are called.
+ */
+template <class TwoPhaseLaw, class Evaluation>
+void twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+                          Evaluation* krw,
+                          Evaluation* krn,
+                          const typename TwoPhaseLaw::Params& params,
+                          const Evaluation& Sw)
+{
+    CombinedEvaluationDetail::twoPhaseSatPcnwAndKr<TwoPhaseLaw>(pcnw,
+                                                                krw,
+                                                                krn,
+                                                                params,
+                                                                Sw,
+                                                                /*preferCombined=*/0);
+}
+} // namespace Opm
+
+#endif
@@ -0,0 +1,186 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::MaterialLawParamsRegistry
+ */
+#ifndef OPM_MATERIAL_LAW_PARAMS_REGISTRY_HPP
+#define OPM_MATERIAL_LAW_PARAMS_REGISTRY_HPP
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <cassert>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Stores each distinct parameter object of a material law only once and
+ *        maps the cells of a grid to them.
+ *
+ * Heterogeneous models usually assign one of a few rock types to a large number of
+ * cells. Instead of keeping a finalized parameter object for each cell, the cells
+ * only hold the index of the parameter object of their rock type. This reduces the
+ * memory footprint, the dependent quantities of the parameter objects are
+ * calculated only once per rock type, and the cells can be grouped by rock type for
+ * evaluating the material law.
+ *
+ * Two parameter objects are considered to be identical if their operator== says
+ * so. This operator is provided by the parameter objects of the analytic laws
+ * (e.g., VanGenuchtenParams, RegularizedBrooksCoreyParams and EffToAbsLawParams)
+ * and only compares their independent quantities. Since the number of distinct
+ * parameter objects is expected to be small, they are looked up by a linear
+ * search.
+ *
+ * References to the stored parameter objects stay valid when further objects are
+ * added to the registry.
+ */
+template <class ParamsT, class IndexT = unsigned>
+class MaterialLawParamsRegistry
+{
+public:
+    typedef ParamsT Params;
+    typedef IndexT Index;
+
+    /*!
+     * \brief Returns the index of a parameter object which is identical to the
+     *        argument.
+     *
+     * If no such object is registered yet, a copy of the argument is added. The
+     * argument must already be finalized.
+     */
+    Index intern(const Params& params)
+    {
+        for (size_t paramsIdx = 0; paramsIdx < params_.size(); ++paramsIdx)
+            if (params_[paramsIdx] == params)
+                return static_cast<Index>(paramsIdx);
+
+        if (params_.size() >= static_cast<size_t>(std::numeric_limits<Index>::max()))
+            OPM_THROW(std::logic_error,
+                      "Too many distinct parameter objects for the index type of the registry");
+
+        params_.push_back(params);
+        return static_cast<Index>(params_.size() - 1);
+    }
+
+    /*!
+     * \brief Returns the number of distinct parameter objects.
+     */
+    size_t numParams() const
+    { return params_.size(); }
+
+    /*!
+     * \brief Returns a parameter object given its index.
+     */
+    const Params& params(Index paramsIdx) const
+    {
+        assert(static_cast<size_t>(paramsIdx) < params_.size());
+        return params_[paramsIdx];
+    }
+
+    /*!
+     * \brief Set the number of cells which are mapped to parameter objects.
+     *
+     * Newly added cells are mapped to the parameter object with index 0.
+     */
+    void setNumCells(size_t numCells)
+    { cellParamsIdx_.resize(numCells, 0); }
+
+    /*!
+     * \brief Returns the number of cells which are mapped to parameter objects.
+     */
+    size_t numCells() const
+    { return cellParamsIdx_.size(); }
+
+    /*!
+     * \brief Map a cell to a parameter object which is identical to the argument.
+     *
+     * If the cell index is beyond the number of cells, the number of cells is
+     * increased accordingly.
+     */
+    void setCellParams(size_t cellIdx, const Params& params)
+    { setCellParamsIndex(cellIdx, intern(params)); }
+
+    /*!
+     * \brief Map a cell to the parameter object with a given index.
+     */
+    void setCellParamsIndex(size_t cellIdx, Index paramsIdx)
+    {
+        assert(static_cast<size_t>(paramsIdx) < params_.size());
+        if (cellIdx >= cellParamsIdx_.size())
+            cellParamsIdx_.resize(cellIdx + 1, 0);
+        cellParamsIdx_[cellIdx] = paramsIdx;
+    }
+
+    /*!
+     * \brief Returns the index of the parameter object of a cell.
+     */
+    Index cellParamsIndex(size_t cellIdx) const
+    {
+        assert(cellIdx < cellParamsIdx_.size());
+        return cellParamsIdx_[cellIdx];
+    }
+
+    /*!
+     * \brief Returns the parameter object of a cell.
+     */
+    const Params& cellParams(size_t cellIdx) const
+    { return params(cellParamsIndex(cellIdx)); }
+
+    /*!
+     * \brief Group the cells by their parameter objects.
+     *
+     * After this method has been called, cellsOfParams[paramsIdx] contains the
+     * indices of all cells which use the parameter object with index paramsIdx in
+     * ascending order.
+     */
+    void groupCells(std::vector<std::vector<size_t> >& cellsOfParams) const
+    {
+        cellsOfParams.resize(params_.size());
+        for (auto& cells : cellsOfParams)
+            cells.clear();
+
+        for (size_t cellIdx = 0; cellIdx < cellParamsIdx_.size(); ++cellIdx)
+            cellsOfParams[cellParamsIdx_[cellIdx]].push_back(cellIdx);
+    }
+
+    /*!
+     * \brief Remove all parameter objects and cells from the registry.
+     */
+    void clear()
+    {
+        params_.clear();
+        cellParamsIdx_.clear();
+    }
+
+private:
+    std::deque<Params> params_;
+    std::vector<Index> cellParamsIdx_;
+};
+} // namespace Opm
+
+#endif
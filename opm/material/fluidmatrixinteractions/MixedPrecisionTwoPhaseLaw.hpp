@@ -0,0 +1,313 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::MixedPrecisionTwoPhaseLaw
+ */
+#ifndef OPM_MIXED_PRECISION_TWO_PHASE_LAW_HPP
+#define OPM_MIXED_PRECISION_TWO_PHASE_LAW_HPP
+
+#include "MaterialLawCombinedEvaluation.hpp"
+
+#include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/densead/PrecisionCast.hpp>
+
+#include <type_traits>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Evaluates a two-phase material law in a lower floating point precision than
+ *        the one used by the caller.
+ *
+ * The wrapped law is instantiated for a lower precision scalar, e.g.,
+ *
+ * \code
+ * typedef Opm::TwoPhaseMaterialTraits<double, wPhaseIdx, nPhaseIdx> Traits;
+ * typedef Opm::TwoPhaseMaterialTraits<float, wPhaseIdx, nPhaseIdx> FloatTraits;
+ * typedef Opm::MixedPrecisionTwoPhaseLaw<Traits,
+ *                                        Opm::PiecewiseLinearTwoPhaseMaterial<FloatTraits> > MaterialLaw;
+ * \endcode
+ *
+ * and its parameter objects are used directly. The saturations (or capillary
+ * pressures) passed to the law are converted to the low-precision evaluation type,
+ * the law is evaluated in that precision and the results including their derivatives
+ * are converted back. This halves the size of the tables and of the derivatives of
+ * the intermediate results at the price of the precision of the results.
+ */
+template <class TraitsT, class LowPrecisionLawT>
+class MixedPrecisionTwoPhaseLaw : public TraitsT
+{
+    typedef LowPrecisionLawT LowPrecisionLaw;
+    typedef typename LowPrecisionLaw::Scalar LowScalar;
+
+    template <class Evaluation>
+    struct LowEvaluation_
+        : public ChangeScalarType<Evaluation, LowScalar>
+    {};
+
+public:
+    //! The traits class for this material law
+    typedef TraitsT Traits;
+
+    //! The type of the parameter objects for this law
+    typedef typename LowPrecisionLaw::Params Params;
+
+    //! The type of the scalar values for this law
+    typedef typename Traits::Scalar Scalar;
+
+    //! The number of fluid phases
+    static const int numPhases = Traits::numPhases;
+    static_assert(numPhases == 2,
+                  "The mixed-precision adapter only supports two-phase laws");
+    static_assert(numPhases == LowPrecisionLaw::numPhases,
+                  "The wrapped law must exhibit the same number of phases");
+
+    //! Specify whether this material law implements the two-phase
+    //! convenience API
+    static const bool implementsTwoPhaseApi = true;
+
+    //! Specify whether this material law implements the two-phase
+    //! convenience API which only depends on the phase saturations
+    static const bool implementsTwoPhaseSatApi = true;
+
+    //! Specify whether the quantities defined by this material law
+    //! are saturation dependent
+    static const bool isSaturationDependent = LowPrecisionLaw::isSaturationDependent;
+
+    //! Specify whether the quantities defined by this material law
+    //! are dependent on the absolute pressure
+    static const bool isPressureDependent = false;
+
+    //! Specify whether the quantities defined by this material law
+    //! are temperature dependent
+    static const bool isTemperatureDependent = false;
+
+    //! Specify whether the quantities defined by this material law
+    //! are dependent on the phase composition
+    static const bool isCompositionDependent = false;
+
+    static_assert(LowPrecisionLaw::implementsTwoPhaseSatApi,
+                  "The wrapped law must implement the two-phase saturation API");
+    static_assert(!LowPrecisionLaw::isPressureDependent
+                  && !LowPrecisionLaw::isTemperatureDependent
+                  && !LowPrecisionLaw::isCompositionDependent,
+                  "The wrapped law may only depend on the saturations");
+
+    /*!
+     * \brief The capillary pressure-saturation curves.
+     */
+    template <class Container, class FluidState>
+    static void capillaryPressures(Container& values, const Params& params, const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(values[0])>::type Evaluation;
+
+        values[Traits::wettingPhaseIdx] = 0.0; // reference phase
+        values[Traits::nonWettingPhaseIdx] = pcnw<FluidState, Evaluation>(params, fs);
+    }
+
+    /*!
+     * \brief The saturations of the fluid phases starting from their
+     *        pressure differences.
+     */
+    template <class Container, class FluidState>
+    static void saturations(Container& values, const Params& params, const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(values[0])>::type Evaluation;
+
+        values[Traits::wettingPhaseIdx] = Sw<FluidState, Evaluation>(params, fs);
+        values[Traits::nonWettingPhaseIdx] = 1.0 - values[Traits::wettingPhaseIdx];
+    }
+
+    /*!
+     * \brief The relative permeability-saturation curves.
+     */
+    template <class Container, class FluidState>
+    static void relativePermeabilities(Container& values, const Params& params, const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(values[0])>::type Evaluation;
+
+        values[Traits::wettingPhaseIdx] = krw<FluidState, Evaluation>(params, fs);
+        values[Traits::nonWettingPhaseIdx] = krn<FluidState, Evaluation>(params, fs);
+    }
+
+    /*!
+     * \brief The capillary pressures and the relative permeabilities.
+     *
+     * The saturation is only converted once and the quantities are evaluated using
+     * twoPhaseSatPcnwAndKr().
+     */
+    template <class PcContainer, class KrContainer, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainer& pcValues,
+                                                            KrContainer& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(pcValues[0])>::type Evaluation;
+
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        Evaluation pcnw;
+        Evaluation krw;
+        Evaluation krn;
+        twoPhaseSatPcnwAndKr(&pcnw, &krw, &krn, params, Sw);
+
+        pcValues[Traits::wettingPhaseIdx] = 0.0; // reference phase
+        pcValues[Traits::nonWettingPhaseIdx] = pcnw;
+        krValues[Traits::wettingPhaseIdx] = krw;
+        krValues[Traits::nonWettingPhaseIdx] = krn;
+    }
+
+    /*!
+     * \brief The capillary pressure and the relative permeabilities at a given
+     *        wetting phase saturation.
+     *
+     * Only the quantities for which a non-null pointer is passed are computed.
+     */
+    template <class Evaluation>
+    static void twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+                                     Evaluation* krw,
+                                     Evaluation* krn,
+                                     const Params& params,
+                                     const Evaluation& Sw)
+    {
+        typedef typename LowEvaluation_<Evaluation>::type LowEval;
+
+        LowEval lowPcnw;
+        LowEval lowKrw;
+        LowEval lowKrn;
+        Opm::twoPhaseSatPcnwAndKr<LowPrecisionLaw, LowEval>(pcnw ? &lowPcnw : nullptr,
+                                                            krw ? &lowKrw : nullptr,
+                                                            krn ? &lowKrn : nullptr,
+                                                            params,
+                                                            toLow_(Sw));
+        if (pcnw)
+            *pcnw = toHigh_<Evaluation>(lowPcnw);
+        if (krw)
+            *krw = toHigh_<Evaluation>(lowKrw);
+        if (krn)
+            *krn = toHigh_<Evaluation>(lowKrn);
+    }
+
+    /*!
+     * \brief The capillary pressure-saturation curve
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation pcnw(const Params& params, const FluidState& fs)
+    {
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        return twoPhaseSatPcnw(params, Sw);
+    }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& Sw)
+    { return toHigh_<Evaluation>(LowPrecisionLaw::twoPhaseSatPcnw(params, toLow_(Sw))); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatPcnwInv(const Params& params, const Evaluation& pcnw)
+    { return toHigh_<Evaluation>(LowPrecisionLaw::twoPhaseSatPcnwInv(params, toLow_(pcnw))); }
+
+    /*!
+     * \brief The wetting phase saturation given the phase pressures.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation Sw(const Params& params, const FluidState& fs)
+    {
+        const Evaluation& pC =
+            Opm::decay<Evaluation>(fs.pressure(Traits::nonWettingPhaseIdx))
+            - Opm::decay<Evaluation>(fs.pressure(Traits::wettingPhaseIdx));
+
+        return twoPhaseSatSw(params, pC);
+    }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatSw(const Params& params, const Evaluation& pC)
+    { return toHigh_<Evaluation>(LowPrecisionLaw::twoPhaseSatSw(params, toLow_(pC))); }
+
+    /*!
+     * \brief The non-wetting phase saturation given the phase pressures.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation Sn(const Params& params, const FluidState& fs)
+    { return 1.0 - Sw<FluidState, Evaluation>(params, fs); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatSn(const Params& params, const Evaluation& pC)
+    { return 1.0 - twoPhaseSatSw(params, pC); }
+
+    /*!
+     * \brief The relative permeability for the wetting phase
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation krw(const Params& params, const FluidState& fs)
+    {
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        return twoPhaseSatKrw(params, Sw);
+    }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrw(const Params& params, const Evaluation& Sw)
+    { return toHigh_<Evaluation>(LowPrecisionLaw::twoPhaseSatKrw(params, toLow_(Sw))); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrwInv(const Params& params, const Evaluation& krw)
+    { return toHigh_<Evaluation>(LowPrecisionLaw::twoPhaseSatKrwInv(params, toLow_(krw))); }
+
+    /*!
+     * \brief The relative permeability for the non-wetting phase
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation krn(const Params& params, const FluidState& fs)
+    {
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        return twoPhaseSatKrn(params, Sw);
+    }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrn(const Params& params, const Evaluation& Sw)
+    { return toHigh_<Evaluation>(LowPrecisionLaw::twoPhaseSatKrn(params, toLow_(Sw))); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrnInv(const Params& params, const Evaluation& krn)
+    { return toHigh_<Evaluation>(LowPrecisionLaw::twoPhaseSatKrnInv(params, toLow_(krn))); }
+
+private:
+    template <class Evaluation>
+    static typename LowEvaluation_<Evaluation>::type toLow_(const Evaluation& value)
+    { return Opm::precisionCast<typename LowEvaluation_<Evaluation>::type>(value); }
+
+    template <class Evaluation, class LowEval>
+    static Evaluation toHigh_(const LowEval& value)
+    { return Opm::precisionCast<Evaluation>(value); }
+};
+} // namespace Opm
+
+#endif
@@ -81,6 +81,11 @@ public:
     //! are dependent on the phase composition
     static const bool isCompositionDependent = false;
 
+    //! Specify whether the capillary pressure is zero for all
+    //! states. This allows the flash solvers to assume that all
+    //! phases exhibit the same pressure.
+    static const bool hasZeroCapillaryPressure = true;
+
     /*!
      * \brief Returns constant 0 for all phases.
      *
@@ -39,9 +39,11 @@ namespace Opm {
 /*!
  * \brief Represents a scanning curve in the Parker-Lenhard hysteresis model.
  *
- * The class has pointers to the scanning curves
- * with higher and lower loop number, this saving
- * the history of the imbibitions and drainages.
+ * The scanning curves of a cell form a chain sorted by their loop number, which
+ * saves the history of the imbibitions and drainages. This chain is stored in a
+ * contiguous array of fixed capacity which is owned by the main drainage curve and
+ * which is allocated only once, so saturation reversals do not allocate any memory.
+ * If the maximum number of loops is reached, further reversals are ignored.
  */
 template <class ScalarT>
 class PLScanningCurve
@@ -49,60 +51,105 @@ class PLScanningCurve
 public:
     typedef ScalarT Scalar;
 
+    //! The default number of scanning curves for reversals which are remembered
+    static const unsigned defaultMaxLoops = 32;
+
     /*!
-     * \brief Constructs main imbibition curve.
+     * \brief Constructs main drainage curve.
      *
-     * Further scanning curves can be added with
-     * setNext.
+     * Further scanning curves can be added with setNext(). At most maxLoops
+     * scanning curves are added on top of the main drainage curve.
      */
-    PLScanningCurve(Scalar Swr)
+    PLScanningCurve(Scalar Swr, unsigned maxLoops = defaultMaxLoops)
     {
-        loopNum_ = 0;
-        prev_ = new PLScanningCurve(NULL, // prev
-                                    this, // next
-                                    -1, // loop number
-                                    Swr, // Sw
-                                    1e12, // pcnw
-                                    Swr, // SwMic
-                                    Swr); // SwMdc
-        next_ = NULL;
+        root_ = this;
+        maxLoops_ = maxLoops;
+        // index 0 is the curve before the MDC, index 1 is the MDC itself, which is
+        // represented by this object.
+        curves_ = new PLScanningCurve[maxLoops + 2];
+        for (unsigned i = 0; i < maxLoops + 2; ++i)
+            curves_[i].root_ = this;
+
+        reset(Swr);
+    }
+
+    /*!
+     * \brief Destructor. After it was called all references to the
+     *        scanning curves of the main drainage curve are invalid!
+     */
+    ~PLScanningCurve()
+    {
+        if (root_ == this)
+            delete [] curves_;
+    }
+
+    /*!
+     * \brief Forget all reversals of the main drainage curve.
+     *
+     * This method may only be called for the main drainage curve and does not
+     * allocate any memory.
+     */
+    void reset(Scalar Swr)
+    {
+        assert(root_ == this);
+
+        PLScanningCurve& before = curves_[0];
+        before.loopNum_ = -1;
+        before.Sw_ = Swr;
+        before.pcnw_ = 1e12;
+        before.SwMic_ = Swr;
+        before.SwMdc_ = Swr;
 
+        loopNum_ = 0;
         Sw_ = 1.0;
         pcnw_ = 0.0;
         SwMic_ = 1.0;
         SwMdc_ = 1.0;
+
+        numCurves_ = 2;
     }
 
-protected:
-    PLScanningCurve(PLScanningCurve* prevSC,
-                    PLScanningCurve* nextSC,
-                    int loopN,
-                    Scalar SwReversal,
-                    Scalar pcnwReversal,
-                    Scalar SwMiCurve,
-                    Scalar SwMdCurve)
+    /*!
+     * \brief Copy the history of the reversals of another main drainage curve.
+     *
+     * This method may only be called for main drainage curves. Afterwards,
+     * curveForLoop() returns the counterparts of the other curve's scanning curves,
+     * i.e., a checkpoint of the hysteresis state consists of the copied object and
+     * the loop numbers of the scanning curves which are referred to.
+     */
+    void assign(const PLScanningCurve& other)
     {
-        prev_ = prevSC;
-        next_ = nextSC;
-        loopNum_ = loopN;
-        Sw_ = SwReversal;
-        pcnw_ = pcnwReversal;
-        SwMic_ = SwMiCurve;
-        SwMdc_ = SwMdCurve;
+        assert(root_ == this && other.root_ == &other);
+
+        if (maxLoops_ != other.maxLoops_) {
+            delete [] curves_;
+            maxLoops_ = other.maxLoops_;
+            curves_ = new PLScanningCurve[maxLoops_ + 2];
+        }
+
+        numCurves_ = other.numCurves_;
+        for (unsigned i = 0; i < numCurves_; ++i) {
+            if (i != 1)
+                curves_[i].assignValues_(other.curves_[i]);
+            curves_[i].root_ = this;
+        }
+        for (unsigned i = numCurves_; i < maxLoops_ + 2; ++i)
+            curves_[i].root_ = this;
+        assignValues_(other);
     }
 
-public:
     /*!
-     * \brief Destructor. After it was called
-     *        all references to the next() curve are
-     *        invalid!
+     * \brief Return the scanning curve of a given loop number.
+     *
+     * The loop number -1 stands for the curve before the main drainage curve. If no
+     * scanning curve exists for the loop number, NULL is returned.
      */
-    ~PLScanningCurve()
+    PLScanningCurve* curveForLoop(int loopN) const
     {
-        if (loopNum_ == 0)
-            delete prev_;
-        if (loopNum_ >= 0)
-            delete next_;
+        unsigned idx = static_cast<unsigned>(loopN + 1);
+        if (loopN < -1 || idx >= root_->numCurves_)
+            return NULL;
+        return root_->curve_(idx);
     }
 
     /*!
@@ -110,14 +157,18 @@ public:
      *        with one less reversal than the current one.
      */
     PLScanningCurve* prev() const
-    { return prev_; }
+    {
+        if (loopNum_ < 0)
+            return NULL;
+        return root_->curve_(static_cast<unsigned>(loopNum_));
+    }
 
     /*!
      * \brief Return the next scanning curve, i.e. the curve
      *        with one more reversal than the current one.
      */
     PLScanningCurve* next() const
-    { return next_; }
+    { return curveForLoop(loopNum_ + 1); }
 
     /*!
      * \brief Set the next scanning curve.
@@ -125,24 +176,29 @@ public:
      * Next in the sense of the number of reversals
      * from imbibition to drainage or vince versa. If this
      * curve already has a list of next curves, it is
-     * deleted and thus forgotten.
+     * thus forgotten. If the maximum number of loops is
+     * exceeded, the curve does not have a next curve
+     * afterwards.
      */
     void setNext(Scalar SwReversal,
                  Scalar pcnwReversal,
                  Scalar SwMiCurve,
                  Scalar SwMdCurve)
     {
-        // if next_ is NULL, delete does nothing, so
-        // this is valid!!
-        delete next_;
-
-        next_ = new PLScanningCurve(this, // prev
-                                    NULL, // next
-                                    loopNum() + 1,
-                                    SwReversal,
-                                    pcnwReversal,
-                                    SwMiCurve,
-                                    SwMdCurve);
+        PLScanningCurve* root = root_;
+        unsigned idx = static_cast<unsigned>(loopNum_ + 2);
+        if (idx >= root->maxLoops_ + 2) {
+            root->numCurves_ = idx;
+            return;
+        }
+
+        PLScanningCurve& nextCurve = root->curves_[idx];
+        nextCurve.loopNum_ = loopNum_ + 1;
+        nextCurve.Sw_ = SwReversal;
+        nextCurve.pcnw_ = pcnwReversal;
+        nextCurve.SwMic_ = SwMiCurve;
+        nextCurve.SwMdc_ = SwMdCurve;
+        root->numCurves_ = idx + 1;
     }
 
     /*!
@@ -158,13 +214,13 @@ public:
             // must be between the start of the
             // current imbibition and the the start
             // of the last drainage
-            return this->Sw() < SwReversal && SwReversal < prev_->Sw();
+            return this->Sw() < SwReversal && SwReversal < prev()->Sw();
         else
             // for drainage the given saturation
             // must be between the start of the
             // last imbibition and the start
             // of the current drainage
-            return prev_->Sw() < SwReversal && SwReversal < this->Sw();
+            return prev()->Sw() < SwReversal && SwReversal < this->Sw();
     }
 
     /*!
@@ -189,6 +245,12 @@ public:
     int loopNum()
     { return loopNum_; }
 
+    /*!
+     * \brief The maximum number of loops which are stored on top of the MDC.
+     */
+    unsigned maxLoops() const
+    { return root_->maxLoops_; }
+
     /*!
      * \brief Absolute wetting-phase saturation at the
      *        scanning curve's reversal point.
@@ -217,8 +279,38 @@ public:
     { return SwMdc_; }
 
 private:
-    PLScanningCurve* prev_;
-    PLScanningCurve* next_;
+    // the curves which are stored in the array of the MDC
+    PLScanningCurve()
+        : root_(NULL)
+        , curves_(NULL)
+        , numCurves_(0)
+        , maxLoops_(0)
+        , loopNum_(0)
+    {}
+
+    // the curves cannot be copied because they refer to the array of the MDC
+    PLScanningCurve(const PLScanningCurve&) = delete;
+    PLScanningCurve& operator=(const PLScanningCurve&) = delete;
+
+    PLScanningCurve* curve_(unsigned idx)
+    { return (idx == 1) ? this : curves_ + idx; }
+
+    void assignValues_(const PLScanningCurve& other)
+    {
+        loopNum_ = other.loopNum_;
+        Sw_ = other.Sw_;
+        pcnw_ = other.pcnw_;
+        SwMdc_ = other.SwMdc_;
+        SwMic_ = other.SwMic_;
+    }
+
+    // the main drainage curve which owns the storage of the scanning curves
+    PLScanningCurve* root_;
+
+    // the storage of the scanning curves, only used by the MDC
+    PLScanningCurve* curves_;
+    unsigned numCurves_;
+    unsigned maxLoops_;
 
     int loopNum_;
 
@@ -288,8 +380,12 @@ public:
      */
     static void reset(Params& params)
     {
-        delete params.mdc(); // this will work even if mdc_ == NULL!
-        params.setMdc(new ScanningCurve(params.SwrPc()));
+        // the storage of the scanning curves is reused, so this does not allocate
+        // memory except if the parameter object does not have a MDC yet
+        if (params.mdc())
+            params.mdc()->reset(params.SwrPc());
+        else
+            params.setMdc(new ScanningCurve(params.SwrPc()));
         params.setCsc(params.mdc());
         params.setPisc(NULL);
         params.setCurrentSnr(0.0);
@@ -618,6 +714,9 @@ private:
         }
 
         ScanningCurve* curve = params.csc()->next();
+        if (!curve)
+            // the current scanning curve is the last one which can be stored
+            curve = params.csc();
         while (true) {
             assert(curve != params.mdc()->prev());
             if (curve->isValidAt_Sw(Sw)) {
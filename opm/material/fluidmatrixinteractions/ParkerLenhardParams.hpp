@@ -65,7 +65,7 @@ public:
     {
         currentSnr_ = 0;
         SwrPc_ = p.SwrPc_;
-        mdc_ = new ScanningCurve(SwrPc_);
+        mdc_ = new ScanningCurve(SwrPc_, p.mdc_->maxLoops());
         pisc_ = csc_ = NULL;
     }
 
@@ -149,6 +149,22 @@ public:
     void setCurrentSnr(Scalar val)
     { currentSnr_ = val; }
 
+    /*!
+     * \brief Set the maximum number of scanning curves which are remembered on top of
+     *        the main drainage curve.
+     *
+     * The storage for the scanning curves is allocated by this method, so saturation
+     * reversals do not allocate memory. Calling this method forgets the history of
+     * the hysteresis model.
+     */
+    void setMaxScanningLoops(unsigned maxLoops)
+    {
+        delete mdc_;
+        mdc_ = new ScanningCurve(SwrPc_, maxLoops);
+        pisc_ = csc_ = NULL;
+        currentSnr_ = 0;
+    }
+
     /*!
      * \brief Returns the main drainage curve
      */
@@ -31,7 +31,9 @@
 
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
+#include <opm/common/Unused.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/TabulationLookupHint.hpp>
 
 #include <algorithm>
 #include <cmath>
@@ -46,7 +48,10 @@ namespace Opm {
  *
  * It would be equally possible to use cubic splines, but since the
  * ECLIPSE reservoir simulator uses linear interpolation for capillary
- * pressure and relperm curves, we do the same.
+ * pressure and relperm curves, we do the same by default. If the kinks of
+ * the curves at the sampling points hamper the convergence of the Newton
+ * method, the parameter object can be told to use monotone cubic
+ * interpolation instead (see PiecewiseLinearTwoPhaseMaterialParams::setInterpolation()).
  */
 template <class TraitsT, class ParamsT = PiecewiseLinearTwoPhaseMaterialParams<TraitsT> >
 class PiecewiseLinearTwoPhaseMaterial : public TraitsT
@@ -63,6 +68,10 @@ public:
     //! The type of the scalar values for this law
     typedef typename Traits::Scalar Scalar;
 
+    //! The type of the objects which cache the segment found by the last lookup of a
+    //! curve. Callers need to keep a separate object for each curve and each cell.
+    typedef TabulationLookupHint<1> LookupHint;
+
     //! The number of fluid phases
     static const int numPhases = Traits::numPhases;
     static_assert(numPhases == 2,
@@ -125,6 +134,70 @@ public:
         values[Traits::nonWettingPhaseIdx] = krn<FluidState, Evaluation>(params, fs);
     }
 
+    /*!
+     * \brief The capillary pressures and the relative permeabilities.
+     *
+     * The curves share their segment lookup, see twoPhaseSatPcnwAndKr().
+     */
+    template <class PcContainer, class KrContainer, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainer& pcValues,
+                                                            KrContainer& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(pcValues[0])>::type Evaluation;
+
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        Evaluation pcnw;
+        Evaluation krw;
+        Evaluation krn;
+        twoPhaseSatPcnwAndKr(&pcnw, &krw, &krn, params, Sw);
+
+        pcValues[Traits::wettingPhaseIdx] = 0.0; // reference phase
+        pcValues[Traits::nonWettingPhaseIdx] = pcnw;
+        krValues[Traits::wettingPhaseIdx] = krw;
+        krValues[Traits::nonWettingPhaseIdx] = krn;
+    }
+
+    /*!
+     * \brief The capillary pressure and the relative permeabilities at a given
+     *        wetting phase saturation.
+     *
+     * Only the quantities for which a non-null pointer is passed are computed. If all
+     * curves use the same saturation sampling points (which is usually the case for
+     * tables that stem from ECL decks), they are interpolated using the fused table of
+     * the parameter object and a single segment search. Otherwise, the segment found
+     * for the first curve is tried first for the remaining ones.
+     */
+    template <class Evaluation>
+    static void twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+                                     Evaluation* krw,
+                                     Evaluation* krn,
+                                     const Params& params,
+                                     const Evaluation& Sw)
+    {
+        if (params.hasSharedSamples()) {
+            evalFused_(pcnw, krw, krn, params, Sw);
+            return;
+        }
+
+        LookupHint hint;
+        if (pcnw)
+            *pcnw = eval_(params.SwPcwnSamples(), params.pcnwSamples(), Sw, &hint, params.uniformSamplesInvSpacing(),
+                          params.pcnwProfile(), params.pcnwSlopes().data(),
+                          cubicCoeffs_(params.pcnwCubicCoeffs()));
+        if (krw)
+            *krw = eval_(params.SwKrwSamples(), params.krwSamples(), Sw, &hint, params.uniformSamplesInvSpacing(),
+                         params.krwProfile(), params.krwSlopes().data(),
+                         cubicCoeffs_(params.krwCubicCoeffs()));
+        if (krn)
+            *krn = eval_(params.SwKrnSamples(), params.krnSamples(), Sw, &hint, params.uniformSamplesInvSpacing(),
+                         params.krnProfile(), params.krnSlopes().data(),
+                         cubicCoeffs_(params.krnCubicCoeffs()));
+    }
+
     /*!
      * \brief The capillary pressure-saturation curve
      */
@@ -142,11 +215,29 @@ public:
      */
     template <class Evaluation>
     static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& Sw)
-    { return eval_(params.SwPcwnSamples(), params.pcnwSamples(), Sw); }
+    { return eval_(params.SwPcwnSamples(), params.pcnwSamples(), Sw, nullptr, params.uniformSamplesInvSpacing(),
+                   params.pcnwProfile(), params.pcnwSlopes().data(),
+                   cubicCoeffs_(params.pcnwCubicCoeffs())); }
+
+    /*!
+     * \brief The saturation-capillary pressure curve using a lookup hint
+     */
+    template <class Evaluation>
+    static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& Sw, LookupHint& hint)
+    { return eval_(params.SwPcwnSamples(), params.pcnwSamples(), Sw, &hint, params.uniformSamplesInvSpacing(),
+                   params.pcnwProfile(), params.pcnwSlopes().data(),
+                   cubicCoeffs_(params.pcnwCubicCoeffs())); }
 
     template <class Evaluation>
     static Evaluation twoPhaseSatPcnwInv(const Params& params, const Evaluation& pcnw)
-    { return eval_(params.pcnwSamples(), params.SwPcwnSamples(), pcnw); }
+    {
+        if (params.hasPcnwInverse())
+            return evalAscending_(params.pcnwInverseSamples(), params.SwPcnwInverseSamples(), pcnw,
+                                  /*hint=*/nullptr, /*invSpacing=*/0.0, /*profile=*/nullptr,
+                                  params.pcnwInverseSlopes().data());
+
+        return eval_(params.pcnwSamples(), params.SwPcwnSamples(), pcnw);
+    }
 
     /*!
      * \brief The saturation-capillary pressure curve
@@ -186,11 +277,29 @@ public:
 
     template <class Evaluation>
     static Evaluation twoPhaseSatKrw(const Params& params, const Evaluation& Sw)
-    { return eval_(params.SwKrwSamples(), params.krwSamples(), Sw); }
+    { return eval_(params.SwKrwSamples(), params.krwSamples(), Sw, nullptr, params.uniformSamplesInvSpacing(),
+                   params.krwProfile(), params.krwSlopes().data(),
+                   cubicCoeffs_(params.krwCubicCoeffs())); }
+
+    /*!
+     * \brief The relative permeability for the wetting phase using a lookup hint
+     */
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrw(const Params& params, const Evaluation& Sw, LookupHint& hint)
+    { return eval_(params.SwKrwSamples(), params.krwSamples(), Sw, &hint, params.uniformSamplesInvSpacing(),
+                   params.krwProfile(), params.krwSlopes().data(),
+                   cubicCoeffs_(params.krwCubicCoeffs())); }
 
     template <class Evaluation>
     static Evaluation twoPhaseSatKrwInv(const Params& params, const Evaluation& krw)
-    { return eval_(params.krwSamples(), params.SwKrwSamples(), krw); }
+    {
+        if (params.hasKrwInverse())
+            return evalAscending_(params.krwInverseSamples(), params.SwKrwInverseSamples(), krw,
+                                  /*hint=*/nullptr, /*invSpacing=*/0.0, /*profile=*/nullptr,
+                                  params.krwInverseSlopes().data());
+
+        return eval_(params.krwSamples(), params.SwKrwSamples(), krw);
+    }
 
     /*!
      * \brief The relative permeability for the non-wetting phase
@@ -207,69 +316,256 @@ public:
 
     template <class Evaluation>
     static Evaluation twoPhaseSatKrn(const Params& params, const Evaluation& Sw)
-    { return eval_(params.SwKrnSamples(), params.krnSamples(), Sw); }
+    { return eval_(params.SwKrnSamples(), params.krnSamples(), Sw, nullptr, params.uniformSamplesInvSpacing(),
+                   params.krnProfile(), params.krnSlopes().data(),
+                   cubicCoeffs_(params.krnCubicCoeffs())); }
+
+    /*!
+     * \brief The relative permeability for the non-wetting phase using a lookup hint
+     */
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrn(const Params& params, const Evaluation& Sw, LookupHint& hint)
+    { return eval_(params.SwKrnSamples(), params.krnSamples(), Sw, &hint, params.uniformSamplesInvSpacing(),
+                   params.krnProfile(), params.krnSlopes().data(),
+                   cubicCoeffs_(params.krnCubicCoeffs())); }
 
     template <class Evaluation>
     static Evaluation twoPhaseSatKrnInv(const Params& params, const Evaluation& krn)
-    { return eval_(params.krnSamples(), params.SwKrnSamples(), krn); }
+    {
+        if (params.hasKrnInverse())
+            return evalAscending_(params.krnInverseSamples(), params.SwKrnInverseSamples(), krn,
+                                  /*hint=*/nullptr, /*invSpacing=*/0.0, /*profile=*/nullptr,
+                                  params.krnInverseSlopes().data());
+
+        return eval_(params.krnSamples(), params.SwKrnSamples(), krn);
+    }
 
 private:
+    typedef MonotoneCubicInterpolation<Scalar> MonotoneCubic;
+
+    // interpolate the fused table of the parameter object. the results are the same as
+    // the ones of evalAscending_() for the individual curves.
+    template <class Evaluation>
+    static void evalFused_(Evaluation* pcnw,
+                           Evaluation* krw,
+                           Evaluation* krn,
+                           const Params& params,
+                           const Evaluation& Sw)
+    {
+        const ValueVector& SwValues = params.SwPcwnSamples();
+        const ValueVector& fusedValues = params.fusedSamples();
+        const unsigned numQuantities = Params::numFusedQuantities;
+
+        size_t sampleIdx;
+        if (Sw <= SwValues.front())
+            sampleIdx = 0;
+        else if (Sw >= SwValues.back())
+            sampleIdx = SwValues.size() - 1;
+        else {
+            size_t segIdx =
+                findSegmentIndex_(SwValues, Opm::scalarValue(Sw), params.uniformSamplesInvSpacing());
+            profileFusedLookup_(pcnw, krw, krn, params, segIdx, /*extrapolated=*/false);
+
+            Scalar x0 = SwValues[segIdx];
+            const Evaluation& dx = Sw - x0;
+
+            // the curves share their sampling points, so the slopes of their individual
+            // tables also apply to the fused one
+            const auto* y0 = &fusedValues[numQuantities*segIdx];
+            if (params.interpolation() == TableInterpolation::MonotoneCubic) {
+                const auto* y1 = y0 + numQuantities;
+                Scalar x1 = SwValues[segIdx + 1];
+                size_t coeffIdx = MonotoneCubic::numCoeffs*segIdx;
+                if (pcnw)
+                    *pcnw = MonotoneCubic::eval(&params.pcnwCubicCoeffs()[coeffIdx], x0, x1,
+                                                Scalar(y0[Params::fusedPcnwIdx]),
+                                                Scalar(y1[Params::fusedPcnwIdx]), Sw);
+                if (krw)
+                    *krw = MonotoneCubic::eval(&params.krwCubicCoeffs()[coeffIdx], x0, x1,
+                                               Scalar(y0[Params::fusedKrwIdx]),
+                                               Scalar(y1[Params::fusedKrwIdx]), Sw);
+                if (krn)
+                    *krn = MonotoneCubic::eval(&params.krnCubicCoeffs()[coeffIdx], x0, x1,
+                                               Scalar(y0[Params::fusedKrnIdx]),
+                                               Scalar(y1[Params::fusedKrnIdx]), Sw);
+                return;
+            }
+
+            if (pcnw)
+                *pcnw = Scalar(y0[Params::fusedPcnwIdx]) + dx*params.pcnwSlopes()[segIdx];
+            if (krw)
+                *krw = Scalar(y0[Params::fusedKrwIdx]) + dx*params.krwSlopes()[segIdx];
+            if (krn)
+                *krn = Scalar(y0[Params::fusedKrnIdx]) + dx*params.krnSlopes()[segIdx];
+            return;
+        }
+
+        // outside of the table all curves are constant
+        profileFusedLookup_(pcnw, krw, krn, params,
+                            std::min(sampleIdx, SwValues.size() - 2), /*extrapolated=*/true);
+        const auto* y = &fusedValues[numQuantities*sampleIdx];
+        if (pcnw)
+            *pcnw = y[Params::fusedPcnwIdx];
+        if (krw)
+            *krw = y[Params::fusedKrwIdx];
+        if (krn)
+            *krn = y[Params::fusedKrnIdx];
+    }
+
+    static void profileLookup_(const TableProfile* profile OPM_UNUSED,
+                               size_t segIdx OPM_UNUSED,
+                               bool extrapolated OPM_UNUSED)
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        if (profile)
+            profile->record(segIdx, extrapolated);
+#endif
+    }
+
+    // a lookup in the fused table counts as a lookup of each requested curve
+    template <class Evaluation>
+    static void profileFusedLookup_(const Evaluation* pcnw OPM_UNUSED,
+                                    const Evaluation* krw OPM_UNUSED,
+                                    const Evaluation* krn OPM_UNUSED,
+                                    const Params& params OPM_UNUSED,
+                                    size_t segIdx OPM_UNUSED,
+                                    bool extrapolated OPM_UNUSED)
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        if (pcnw)
+            profileLookup_(params.pcnwProfile(), segIdx, extrapolated);
+        if (krw)
+            profileLookup_(params.krwProfile(), segIdx, extrapolated);
+        if (krn)
+            profileLookup_(params.krnProfile(), segIdx, extrapolated);
+#endif
+    }
+
+    // invSpacing is the inverse distance of the sampling points if they are uniformly
+    // distributed and ascending, else 0
+    // the lookups are recorded by the profile if it is not null
+    // slopes points to the precomputed slopes of the segments. if it is null, they are
+    // computed from the sampling points.
+    // cubicCoeffs points to the coefficients of the cubic segments if the curve uses
+    // monotone cubic interpolation. they are only available for ascending curves.
     template <class Evaluation>
     static Evaluation eval_(const ValueVector& xValues,
                             const ValueVector& yValues,
-                            const Evaluation& x)
+                            const Evaluation& x,
+                            LookupHint* hint = nullptr,
+                            Scalar invSpacing = 0.0,
+                            const TableProfile* profile = nullptr,
+                            const Scalar* slopes = nullptr,
+                            const Scalar* cubicCoeffs = nullptr)
     {
         if (xValues.front() < xValues.back())
-            return evalAscending_(xValues, yValues, x);
-        return evalDescending_(xValues, yValues, x);
+            return evalAscending_(xValues, yValues, x, hint, invSpacing, profile, slopes, cubicCoeffs);
+        return evalDescending_(xValues, yValues, x, hint, profile, slopes);
     }
 
+    // the coefficients of the cubic segments of a curve or null if it is piecewise
+    // linear
+    static const Scalar* cubicCoeffs_(const typename Params::SlopeVector& coeffs)
+    { return coeffs.empty() ? nullptr : coeffs.data(); }
+
     template <class Evaluation>
     static Evaluation evalAscending_(const ValueVector& xValues,
                                      const ValueVector& yValues,
-                                     const Evaluation& x)
+                                     const Evaluation& x,
+                                     LookupHint* hint = nullptr,
+                                     Scalar invSpacing = 0.0,
+                                     const TableProfile* profile = nullptr,
+                                     const Scalar* slopes = nullptr,
+                                     const Scalar* cubicCoeffs = nullptr)
     {
-        if (x <= xValues.front())
+        if (x <= xValues.front()) {
+            profileLookup_(profile, 0, /*extrapolated=*/true);
             return yValues.front();
-        if (x >= xValues.back())
+        }
+        if (x >= xValues.back()) {
+            profileLookup_(profile, xValues.size() - 2, /*extrapolated=*/true);
             return yValues.back();
+        }
 
-        size_t segIdx = findSegmentIndex_(xValues, Opm::scalarValue(x));
-
-        Scalar x0 = xValues[segIdx];
-        Scalar x1 = xValues[segIdx + 1];
-
-        Scalar y0 = yValues[segIdx];
-        Scalar y1 = yValues[segIdx + 1];
-
-        Scalar m = (y1 - y0)/(x1 - x0);
-
-        return y0 + (x - x0)*m;
+        size_t segIdx;
+        if (hint && segmentContains_(xValues, Opm::scalarValue(x), hint->segmentIdx()))
+            segIdx = hint->segmentIdx();
+        else {
+            segIdx = findSegmentIndex_(xValues, Opm::scalarValue(x), invSpacing);
+            if (hint)
+                hint->setSegmentIdx(0, static_cast<unsigned>(segIdx));
+        }
+        profileLookup_(profile, segIdx, /*extrapolated=*/false);
+
+        if (cubicCoeffs)
+            return MonotoneCubic::eval(&cubicCoeffs[MonotoneCubic::numCoeffs*segIdx],
+                                       xValues[segIdx], xValues[segIdx + 1],
+                                       yValues[segIdx], yValues[segIdx + 1],
+                                       x);
+        return interpolate_(xValues, yValues, x, segIdx, slopes);
     }
 
     template <class Evaluation>
     static Evaluation evalDescending_(const ValueVector& xValues,
                                       const ValueVector& yValues,
-                                      const Evaluation& x)
+                                      const Evaluation& x,
+                                      LookupHint* hint = nullptr,
+                                      const TableProfile* profile = nullptr,
+                                      const Scalar* slopes = nullptr)
     {
-        if (x >= xValues.front())
+        if (x >= xValues.front()) {
+            profileLookup_(profile, 0, /*extrapolated=*/true);
             return yValues.front();
-        if (x <= xValues.back())
+        }
+        if (x <= xValues.back()) {
+            profileLookup_(profile, xValues.size() - 2, /*extrapolated=*/true);
             return yValues.back();
+        }
 
-        size_t segIdx = findSegmentIndexDescending_(xValues, Opm::scalarValue(x));
+        size_t segIdx;
+        if (hint && segmentContainsDescending_(xValues, Opm::scalarValue(x), hint->segmentIdx()))
+            segIdx = hint->segmentIdx();
+        else {
+            segIdx = findSegmentIndexDescending_(xValues, Opm::scalarValue(x));
+            if (hint)
+                hint->setSegmentIdx(0, static_cast<unsigned>(segIdx));
+        }
+        profileLookup_(profile, segIdx, /*extrapolated=*/false);
 
-        Scalar x0 = xValues[segIdx];
-        Scalar x1 = xValues[segIdx + 1];
+        return interpolate_(xValues, yValues, x, segIdx, slopes);
+    }
 
+    template <class Evaluation>
+    static Evaluation interpolate_(const ValueVector& xValues,
+                                   const ValueVector& yValues,
+                                   const Evaluation& x,
+                                   size_t segIdx,
+                                   const Scalar* slopes)
+    {
+        Scalar x0 = xValues[segIdx];
         Scalar y0 = yValues[segIdx];
-        Scalar y1 = yValues[segIdx + 1];
 
-        Scalar m = (y1 - y0)/(x1 - x0);
+        Scalar m;
+        if (slopes)
+            m = slopes[segIdx];
+        else {
+            Scalar x1 = xValues[segIdx + 1];
+            Scalar y1 = yValues[segIdx + 1];
+            m = (y1 - y0)/(x1 - x0);
+        }
 
         return y0 + (x - x0)*m;
     }
 
+    // returns true if the segment segIdx is the one which would be found by
+    // findSegmentIndex_() for a value which is within the range of the table
+    static bool segmentContains_(const ValueVector& xValues, Scalar x, size_t segIdx)
+    { return segIdx + 1 < xValues.size() && xValues[segIdx] < x && x <= xValues[segIdx + 1]; }
+
+    // the same as segmentContains_() but for findSegmentIndexDescending_()
+    static bool segmentContainsDescending_(const ValueVector& xValues, Scalar x, size_t segIdx)
+    { return segIdx + 1 < xValues.size() && xValues[segIdx] >= x && x > xValues[segIdx + 1]; }
+
     template <class Evaluation>
     static Evaluation evalDeriv_(const ValueVector& xValues,
                                  const ValueVector& yValues,
@@ -291,7 +587,7 @@ private:
         return (y1 - y0)/(x1 - x0);
     }
 
-    static size_t findSegmentIndex_(const ValueVector& xValues, Scalar x)
+    static size_t findSegmentIndex_(const ValueVector& xValues, Scalar x, Scalar invSpacing = 0.0)
     {
         assert(xValues.size() > 1); // we need at least two sampling points!
         size_t n = xValues.size() - 1;
@@ -300,6 +596,18 @@ private:
         else if (x <= xValues.front())
             return 0;
 
+        if (invSpacing > 0.0) {
+            // uniform sampling points: compute the segment directly. round-off may put
+            // x into a neighbor of the segment which the bisection would find, so this
+            // is corrected.
+            size_t segIdx = std::min(n - 1, static_cast<size_t>((x - xValues.front())*invSpacing));
+            if (segIdx > 0 && x <= xValues[segIdx])
+                -- segIdx;
+            else if (segIdx + 1 < n && xValues[segIdx + 1] < x)
+                ++ segIdx;
+            return segIdx;
+        }
+
         // bisection
         size_t lowIdx = 0, highIdx = n;
         while (lowIdx + 1 < highIdx) {
@@ -27,11 +27,22 @@
 #ifndef OPM_PIECEWISE_LINEAR_TWO_PHASE_MATERIAL_PARAMS_HPP
 #define OPM_PIECEWISE_LINEAR_TWO_PHASE_MATERIAL_PARAMS_HPP
 
+#include <algorithm>
 #include <vector>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
 
+#include <opm/material/common/BinarySerialization.hpp>
 #include <opm/material/common/EnsureFinalized.hpp>
+#include <opm/material/fluidmatrixinteractions/FlatPiecewiseLinearTwoPhaseMaterial.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/MonotoneCubicInterpolation.hpp>
+#include <opm/material/common/TableProfiler.hpp>
+#include <opm/material/common/TableSimplification.hpp>
 
 namespace Opm {
 /*!
@@ -39,21 +50,108 @@ namespace Opm {
  *
  * \brief Specification of the material parameters for a two-phase material law which
  *        uses a table and piecewise constant interpolation.
+ *
+ * The sampling points are stored using the StorageScalarT type. Since the accuracy of
+ * saturation function tables is limited by their sampling anyway, it can be set to
+ * float in order to halve the memory required by the tables while the
+ * material law still computes in terms of the scalar type of the traits.
  */
-template<class TraitsT>
+template<class TraitsT, class StorageScalarT = typename TraitsT::Scalar>
 class PiecewiseLinearTwoPhaseMaterialParams : public EnsureFinalized
 {
     typedef typename TraitsT::Scalar Scalar;
 
 public:
-    typedef std::vector<Scalar> ValueVector;
+    typedef StorageScalarT StorageScalar;
+    typedef std::vector<StorageScalar> ValueVector;
+    typedef std::vector<Scalar> SlopeVector;
 
     typedef TraitsT Traits;
 
+    //! The positions of the quantities of a sampling point within the fused table
+    enum { fusedPcnwIdx = 0, fusedKrwIdx = 1, fusedKrnIdx = 2, numFusedQuantities = 3 };
+
     PiecewiseLinearTwoPhaseMaterialParams()
+        : uniformResamplingTolerance_(0.0)
+        , maxUniformSamples_(0)
+        , uniformSamplesInvSpacing_(0.0)
+        , simplificationTolerance_(0.0)
+        , interpolation_(TableInterpolation::Linear)
     {
     }
 
+    /*!
+     * \brief Set the scheme which is used to interpolate between the sampling points
+     *        of the capillary pressure and the relative permeability curves.
+     *
+     * By default, the curves are piecewise linear. With
+     * TableInterpolation::MonotoneCubic, they are interpolated using the monotone cubic
+     * Hermite polynomials of MonotoneCubicInterpolation, so that their derivatives are
+     * continuous. The sampling points are still reproduced exactly, the curves are
+     * constant outside of the tables and they do not overshoot. The inverse tables as
+     * well as the simplification and the resampling of the curves are unaffected, i.e.,
+     * they are based on the piecewise linear curves. This must be set before
+     * finalize() is called.
+     */
+    void setInterpolation(TableInterpolation value)
+    { interpolation_ = value; }
+
+    /*!
+     * \brief Returns the scheme which is used to interpolate between the sampling
+     *        points of the curves.
+     */
+    TableInterpolation interpolation() const
+    { return interpolation_; }
+
+    /*!
+     * \brief Remove the sampling points of the curves which can be interpolated from
+     *        their neighbors at finalize().
+     *
+     * A sampling point is removed if the simplified curve deviates from the original
+     * one by at most the tolerance relative to the range of values of the curve. If
+     * all curves use the same saturations, a sampling point is only removed if this
+     * holds for all of them, so that they still share their sampling points
+     * afterwards. The first and the last sampling point as well as the ones of jumps
+     * are always kept. The simplification is done before the curves are resampled
+     * uniformly.
+     *
+     * By default, the curves are not simplified. A tolerance of zero disables the
+     * simplification.
+     */
+    void setTableSimplification(Scalar tolerance)
+    { simplificationTolerance_ = tolerance; }
+
+    /*!
+     * \brief Return the number of sampling points of all curves before and after they
+     *        were simplified by finalize().
+     *
+     * The statistics are not part of the serialized parameters.
+     */
+    const TableSimplificationStats& tableSimplificationStats() const
+    { return simplificationStats_; }
+
+    /*!
+     * \brief Convert the curves to a common uniform saturation grid at finalize().
+     *
+     * With uniform sampling points, the segment which contains a saturation can be
+     * computed directly instead of being searched. The grid is refined until the
+     * resampled curves deviate from the original ones by at most the tolerance
+     * relative to the range of values of the respective curve. Since all curves are
+     * piecewise linear, the largest deviations occur at the original sampling points,
+     * so it is sufficient to check them. If the required accuracy cannot be reached
+     * using at most maxSamples sampling points or if the saturations of a curve are
+     * not strictly increasing, i.e., if it exhibits a jump, the original tables are
+     * kept.
+     *
+     * By default, no resampling is done, i.e., the sampling points of the tables are
+     * reproduced exactly. A tolerance of zero disables the resampling.
+     */
+    void setUniformResampling(Scalar tolerance, unsigned maxSamples = 1025)
+    {
+        uniformResamplingTolerance_ = tolerance;
+        maxUniformSamples_ = maxSamples;
+    }
+
     /*!
      * \brief Calculate all dependent quantities once the independent
      *        quantities of the parameter object have been set.
@@ -74,8 +172,232 @@ public:
         if (SwKrnSamples_.front() > SwKrnSamples_.back())
             swapOrder_(SwKrnSamples_, krnSamples_);
 
+        simplificationStats_.clear();
+        if (simplificationTolerance_ > 0.0)
+            simplifyCurves_();
+
+        uniformSamplesInvSpacing_ = 0.0;
+        if (uniformResamplingTolerance_ > 0.0)
+            resampleUniformly_();
+
+        updateFusedSamples_();
+
+        buildInverse_(pcnwInverseSamples_, SwPcnwInverseSamples_, SwPcwnSamples_, pcwnSamples_);
+        buildInverse_(krwInverseSamples_, SwKrwInverseSamples_, SwKrwSamples_, krwSamples_);
+        buildInverse_(krnInverseSamples_, SwKrnInverseSamples_, SwKrnSamples_, krnSamples_);
+
+        updateSlopes_();
     }
 
+    /*!
+     * \brief Append the curves to a flat table buffer and return the descriptor of the
+     *        parameters.
+     *
+     * The parameter object must be finalized and the curves must be piecewise linear.
+     */
+    template <class FlatScalar>
+    FlatPiecewiseLinearTwoPhaseMaterialParams<FlatScalar> exportFlat(FlatTableBuffer<FlatScalar>& buffer) const
+    {
+        EnsureFinalized::check();
+        if (interpolation_ != TableInterpolation::Linear)
+            OPM_THROW(std::logic_error, "Only piecewise linear saturation functions can be exported");
+
+        FlatPiecewiseLinearTwoPhaseMaterialParams<FlatScalar> result;
+        result.pcnw = exportFlatCurve_(buffer, SwPcwnSamples_, pcwnSamples_);
+        result.krw = exportFlatCurve_(buffer, SwKrwSamples_, krwSamples_);
+        result.krn = exportFlatCurve_(buffer, SwKrnSamples_, krnSamples_);
+        return result;
+    }
+
+    /*!
+     * \brief Returns true iff the table of the inverse of the capillary pressure curve
+     *        is available.
+     *
+     * The inverse tables are built by finalize() for all curves which are monotonic.
+     * Their values are sorted in ascending order and each flat section of the curve is
+     * represented by its two end points, so a segment search over them is always
+     * well-defined. For curves which are not monotonic, they are empty.
+     */
+    bool hasPcnwInverse() const
+    { EnsureFinalized::check(); return !pcnwInverseSamples_.empty(); }
+
+    /*!
+     * \brief The capillary pressures of the inverse table in ascending order.
+     */
+    const ValueVector& pcnwInverseSamples() const
+    { EnsureFinalized::check(); return pcnwInverseSamples_; }
+
+    /*!
+     * \brief The wetting phase saturations of the inverse capillary pressure table.
+     */
+    const ValueVector& SwPcnwInverseSamples() const
+    { EnsureFinalized::check(); return SwPcnwInverseSamples_; }
+
+    /*!
+     * \brief Returns true iff the table of the inverse of the wetting phase relative
+     *        permeability curve is available.
+     *
+     * \copydetails hasPcnwInverse()
+     */
+    bool hasKrwInverse() const
+    { EnsureFinalized::check(); return !krwInverseSamples_.empty(); }
+
+    /*!
+     * \brief The wetting phase relative permeabilities of the inverse table in
+     *        ascending order.
+     */
+    const ValueVector& krwInverseSamples() const
+    { EnsureFinalized::check(); return krwInverseSamples_; }
+
+    /*!
+     * \brief The wetting phase saturations of the inverse wetting phase relative
+     *        permeability table.
+     */
+    const ValueVector& SwKrwInverseSamples() const
+    { EnsureFinalized::check(); return SwKrwInverseSamples_; }
+
+    /*!
+     * \brief Returns true iff the table of the inverse of the non-wetting phase
+     *        relative permeability curve is available.
+     *
+     * \copydetails hasPcnwInverse()
+     */
+    bool hasKrnInverse() const
+    { EnsureFinalized::check(); return !krnInverseSamples_.empty(); }
+
+    /*!
+     * \brief The non-wetting phase relative permeabilities of the inverse table in
+     *        ascending order.
+     */
+    const ValueVector& krnInverseSamples() const
+    { EnsureFinalized::check(); return krnInverseSamples_; }
+
+    /*!
+     * \brief The wetting phase saturations of the inverse non-wetting phase relative
+     *        permeability table.
+     */
+    const ValueVector& SwKrnInverseSamples() const
+    { EnsureFinalized::check(); return SwKrnInverseSamples_; }
+
+    /*!
+     * \brief Returns true iff the curves have been converted to a uniform saturation
+     *        grid.
+     *
+     * \see setUniformResampling()
+     */
+    bool hasUniformSamples() const
+    { EnsureFinalized::check(); return uniformSamplesInvSpacing_ > 0.0; }
+
+    /*!
+     * \brief Return the inverse of the distance between two saturation sampling points
+     *        if the curves use a uniform grid, or 0 if they do not.
+     */
+    Scalar uniformSamplesInvSpacing() const
+    { EnsureFinalized::check(); return uniformSamplesInvSpacing_; }
+
+    /*!
+     * \brief Returns true iff all three curves use the same ascending saturation
+     *        sampling points.
+     *
+     * This is usually the case for tables which stem from keywords that specify all
+     * curves in one table like SWOF or SGOF. The curves are then also available as a
+     * single fused table, so that one segment search serves all of them.
+     */
+    bool hasSharedSamples() const
+    { EnsureFinalized::check(); return !fusedSamples_.empty(); }
+
+    /*!
+     * \brief Return the values of the fused table.
+     *
+     * The capillary pressure and the relative permeabilities of the wetting and the
+     * non-wetting phases for each sampling point of SwPcwnSamples() are stored next to
+     * each other at the positions given by fusedPcnwIdx, fusedKrwIdx and fusedKrnIdx.
+     * This is empty if hasSharedSamples() is false.
+     */
+    const ValueVector& fusedSamples() const
+    { EnsureFinalized::check(); return fusedSamples_; }
+
+    /*!
+     * \brief Return the slopes of the segments of the capillary pressure curve.
+     *
+     * The slope of the segment between the sampling points i and i + 1 is stored at
+     * index i, so that the interpolation does not need to divide. The slopes are
+     * stored using the scalar type of the traits, i.e., the results are the same as
+     * if they were computed from the sampling points by each lookup.
+     */
+    const SlopeVector& pcnwSlopes() const
+    { EnsureFinalized::check(); return pcnwSlopes_; }
+
+    /*!
+     * \brief Return the slopes of the segments of the wetting phase relative
+     *        permeability curve.
+     *
+     * \copydetails pcnwSlopes()
+     */
+    const SlopeVector& krwSlopes() const
+    { EnsureFinalized::check(); return krwSlopes_; }
+
+    /*!
+     * \brief Return the slopes of the segments of the non-wetting phase relative
+     *        permeability curve.
+     *
+     * \copydetails pcnwSlopes()
+     */
+    const SlopeVector& krnSlopes() const
+    { EnsureFinalized::check(); return krnSlopes_; }
+
+    /*!
+     * \brief Return the coefficients of the cubic segments of the capillary pressure
+     *        curve, or an empty vector if the curves are piecewise linear.
+     *
+     * The MonotoneCubicInterpolation::numCoeffs coefficients of the segment between
+     * the sampling points i and i + 1 are stored starting at index
+     * i*MonotoneCubicInterpolation::numCoeffs.
+     */
+    const SlopeVector& pcnwCubicCoeffs() const
+    { EnsureFinalized::check(); return pcnwCubicCoeffs_; }
+
+    /*!
+     * \brief Return the coefficients of the cubic segments of the wetting phase
+     *        relative permeability curve, or an empty vector if the curves are
+     *        piecewise linear.
+     *
+     * \copydetails pcnwCubicCoeffs()
+     */
+    const SlopeVector& krwCubicCoeffs() const
+    { EnsureFinalized::check(); return krwCubicCoeffs_; }
+
+    /*!
+     * \brief Return the coefficients of the cubic segments of the non-wetting phase
+     *        relative permeability curve, or an empty vector if the curves are
+     *        piecewise linear.
+     *
+     * \copydetails pcnwCubicCoeffs()
+     */
+    const SlopeVector& krnCubicCoeffs() const
+    { EnsureFinalized::check(); return krnCubicCoeffs_; }
+
+    /*!
+     * \brief Return the slopes of the segments of the inverse capillary pressure
+     *        table, or an empty vector if it is not available.
+     */
+    const SlopeVector& pcnwInverseSlopes() const
+    { EnsureFinalized::check(); return pcnwInverseSlopes_; }
+
+    /*!
+     * \brief Return the slopes of the segments of the inverse wetting phase relative
+     *        permeability table, or an empty vector if it is not available.
+     */
+    const SlopeVector& krwInverseSlopes() const
+    { EnsureFinalized::check(); return krwInverseSlopes_; }
+
+    /*!
+     * \brief Return the slopes of the segments of the inverse non-wetting phase
+     *        relative permeability table, or an empty vector if it is not available.
+     */
+    const SlopeVector& krnInverseSlopes() const
+    { EnsureFinalized::check(); return krnInverseSlopes_; }
+
     /*!
      * \brief Return the wetting-phase saturation values of all sampling points.
      */
@@ -120,6 +442,17 @@ public:
         std::copy(values.begin(), values.end(), pcwnSamples_.begin());
     }
 
+    /*!
+     * \brief Set the sampling points for the capillary pressure curve without copying them.
+     */
+    void setPcnwSamples(ValueVector&& SwValues, ValueVector&& values)
+    {
+        assert(SwValues.size() == values.size());
+
+        SwPcwnSamples_ = std::move(SwValues);
+        pcwnSamples_ = std::move(values);
+    }
+
     /*!
      * \brief Return the sampling points for the relative permeability
      *        curve of the wetting phase.
@@ -148,6 +481,17 @@ public:
         std::copy(values.begin(), values.end(), krwSamples_.begin());
     }
 
+    /*!
+     * \brief Set the sampling points for the wetting phase relative permeability curve without copying them.
+     */
+    void setKrwSamples(ValueVector&& SwValues, ValueVector&& values)
+    {
+        assert(SwValues.size() == values.size());
+
+        SwKrwSamples_ = std::move(SwValues);
+        krwSamples_ = std::move(values);
+    }
+
     /*!
      * \brief Return the sampling points for the relative permeability
      *        curve of the non-wetting phase.
@@ -176,10 +520,442 @@ public:
         std::copy(values.begin(), values.end(), krnSamples_.begin());
     }
 
+    /*!
+     * \brief Set the sampling points for the non-wetting phase relative permeability curve without copying them.
+     */
+    void setKrnSamples(ValueVector&& SwValues, ValueVector&& values)
+    {
+        assert(SwValues.size() == values.size());
+
+        SwKrnSamples_ = std::move(SwValues);
+        krnSamples_ = std::move(values);
+    }
+
+    /*!
+     * \brief Set the names under which the lookups of the curves are reported if table
+     *        profiling is enabled.
+     *
+     * The curves are reported as "<name> pcnw", "<name> krw" and "<name> krn". See
+     * opm/material/common/TableProfiler.hpp. If profiling is disabled, this method
+     * does nothing.
+     */
+    void setProfileName(const std::string& name)
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        pcnwProfile_.setName(name + " pcnw");
+        krwProfile_.setName(name + " krw");
+        krnProfile_.setName(name + " krn");
+#else
+        (void) name;
+#endif
+    }
+
+    /*!
+     * \brief Returns the number of bytes allocated for the sampling points of the
+     *        curves, including the fused and the inverse ones and the slopes of their
+     *        segments.
+     *
+     * The size of the object itself is not included.
+     */
+    std::size_t heapMemoryUsage() const
+    {
+        return
+            vectorMemoryUsage(SwPcwnSamples_)
+            + vectorMemoryUsage(SwKrwSamples_)
+            + vectorMemoryUsage(SwKrnSamples_)
+            + vectorMemoryUsage(pcwnSamples_)
+            + vectorMemoryUsage(krwSamples_)
+            + vectorMemoryUsage(krnSamples_)
+            + vectorMemoryUsage(fusedSamples_)
+            + vectorMemoryUsage(pcnwInverseSamples_)
+            + vectorMemoryUsage(SwPcnwInverseSamples_)
+            + vectorMemoryUsage(krwInverseSamples_)
+            + vectorMemoryUsage(SwKrwInverseSamples_)
+            + vectorMemoryUsage(krnInverseSamples_)
+            + vectorMemoryUsage(SwKrnInverseSamples_)
+            + vectorMemoryUsage(pcnwSlopes_)
+            + vectorMemoryUsage(krwSlopes_)
+            + vectorMemoryUsage(krnSlopes_)
+            + vectorMemoryUsage(pcnwInverseSlopes_)
+            + vectorMemoryUsage(krwInverseSlopes_)
+            + vectorMemoryUsage(krnInverseSlopes_)
+            + vectorMemoryUsage(pcnwCubicCoeffs_)
+            + vectorMemoryUsage(krwCubicCoeffs_)
+            + vectorMemoryUsage(krnCubicCoeffs_);
+    }
+
+    /*!
+     * \brief Write the finalized parameters to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        EnsureFinalized::check();
+
+        writer.write(SwPcwnSamples_);
+        writer.write(SwKrwSamples_);
+        writer.write(SwKrnSamples_);
+        writer.write(pcwnSamples_);
+        writer.write(krwSamples_);
+        writer.write(krnSamples_);
+        writer.write(fusedSamples_);
+        writer.write(pcnwInverseSamples_);
+        writer.write(SwPcnwInverseSamples_);
+        writer.write(krwInverseSamples_);
+        writer.write(SwKrwInverseSamples_);
+        writer.write(krnInverseSamples_);
+        writer.write(SwKrnInverseSamples_);
+        writer.write(uniformResamplingTolerance_);
+        writer.write(maxUniformSamples_);
+        writer.write(uniformSamplesInvSpacing_);
+        writer.write(simplificationTolerance_);
+        writer.write(static_cast<std::int32_t>(interpolation_));
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     *
+     * The parameters are finalized afterwards. The names used for table profiling are
+     * not part of the blob.
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(SwPcwnSamples_);
+        reader.read(SwKrwSamples_);
+        reader.read(SwKrnSamples_);
+        reader.read(pcwnSamples_);
+        reader.read(krwSamples_);
+        reader.read(krnSamples_);
+        reader.read(fusedSamples_);
+        reader.read(pcnwInverseSamples_);
+        reader.read(SwPcnwInverseSamples_);
+        reader.read(krwInverseSamples_);
+        reader.read(SwKrwInverseSamples_);
+        reader.read(krnInverseSamples_);
+        reader.read(SwKrnInverseSamples_);
+        reader.read(uniformResamplingTolerance_);
+        reader.read(maxUniformSamples_);
+        reader.read(uniformSamplesInvSpacing_);
+        reader.read(simplificationTolerance_);
+        std::int32_t interpolation;
+        reader.read(interpolation);
+
+        if (pcwnSamples_.size() != SwPcwnSamples_.size()
+            || krwSamples_.size() != SwKrwSamples_.size()
+            || krnSamples_.size() != SwKrnSamples_.size())
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: inconsistent saturation function table");
+        if (interpolation < static_cast<std::int32_t>(TableInterpolation::Linear)
+            || interpolation > static_cast<std::int32_t>(TableInterpolation::MonotoneCubic))
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: invalid interpolation scheme " << interpolation);
+        interpolation_ = static_cast<TableInterpolation>(interpolation);
+
+        // the slopes and the coefficients of the cubic segments are not part of the
+        // blob because they can be cheaply recomputed
+        updateSlopes_();
+
+        EnsureFinalized::finalize();
+    }
+
+    /*!
+     * \brief Return the object which records the lookups of the capillary pressure
+     *        curve or nullptr if table profiling is disabled.
+     */
+    const TableProfile* pcnwProfile() const
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        return &pcnwProfile_;
+#else
+        return nullptr;
+#endif
+    }
+
+    /*!
+     * \brief Return the object which records the lookups of the relative permeability
+     *        curve of the wetting phase or nullptr if table profiling is disabled.
+     */
+    const TableProfile* krwProfile() const
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        return &krwProfile_;
+#else
+        return nullptr;
+#endif
+    }
+
+    /*!
+     * \brief Return the object which records the lookups of the relative permeability
+     *        curve of the non-wetting phase or nullptr if table profiling is disabled.
+     */
+    const TableProfile* krnProfile() const
+    {
+#if OPM_MATERIAL_PROFILE_TABLES
+        return &krnProfile_;
+#else
+        return nullptr;
+#endif
+    }
+
 private:
+    void simplifyCurves_()
+    {
+        const Scalar pcnwTol = simplificationTolerance_*valueRange(pcwnSamples_);
+        const Scalar krwTol = simplificationTolerance_*valueRange(krwSamples_);
+        const Scalar krnTol = simplificationTolerance_*valueRange(krnSamples_);
+
+        // curves which share their sampling points are simplified together, so that
+        // they can still be used as a fused table
+        if (SwKrwSamples_ == SwPcwnSamples_ && SwKrnSamples_ == SwPcwnSamples_) {
+            const ValueVector& SwValues = SwPcwnSamples_;
+            std::vector<bool> isRequired =
+                findRequiredSamples(SwValues.size(), [&](size_t lowerIdx, size_t sampleIdx, size_t upperIdx) {
+                        return isNearlyCollinear(SwValues, pcwnSamples_, lowerIdx, sampleIdx, upperIdx, pcnwTol)
+                            && isNearlyCollinear(SwValues, krwSamples_, lowerIdx, sampleIdx, upperIdx, krwTol)
+                            && isNearlyCollinear(SwValues, krnSamples_, lowerIdx, sampleIdx, upperIdx, krnTol);
+                    });
+
+            simplificationStats_.add(3*SwValues.size(),
+                                     3*std::count(isRequired.begin(), isRequired.end(), true));
+            selectSamples(pcwnSamples_, isRequired);
+            selectSamples(krwSamples_, isRequired);
+            selectSamples(krnSamples_, isRequired);
+            selectSamples(SwPcwnSamples_, isRequired);
+            SwKrwSamples_ = SwPcwnSamples_;
+            SwKrnSamples_ = SwPcwnSamples_;
+            return;
+        }
+
+        simplifyCurve_(SwPcwnSamples_, pcwnSamples_, pcnwTol);
+        simplifyCurve_(SwKrwSamples_, krwSamples_, krwTol);
+        simplifyCurve_(SwKrnSamples_, krnSamples_, krnTol);
+    }
+
+    void simplifyCurve_(ValueVector& SwValues, ValueVector& values, Scalar tolerance)
+    {
+        std::vector<bool> isRequired =
+            findRequiredSamples(SwValues.size(), [&](size_t lowerIdx, size_t sampleIdx, size_t upperIdx) {
+                    return isNearlyCollinear(SwValues, values, lowerIdx, sampleIdx, upperIdx, tolerance);
+                });
+
+        simplificationStats_.add(SwValues.size(), std::count(isRequired.begin(), isRequired.end(), true));
+        selectSamples(SwValues, isRequired);
+        selectSamples(values, isRequired);
+    }
+
+    void resampleUniformly_()
+    {
+        // curves which exhibit jumps cannot be represented on a uniform grid
+        if (!isStrictlyAscending_(SwPcwnSamples_)
+            || !isStrictlyAscending_(SwKrwSamples_)
+            || !isStrictlyAscending_(SwKrnSamples_))
+            return;
+
+        Scalar SwMin = std::min<Scalar>({SwPcwnSamples_.front(), SwKrwSamples_.front(), SwKrnSamples_.front()});
+        Scalar SwMax = std::max<Scalar>({SwPcwnSamples_.back(), SwKrwSamples_.back(), SwKrnSamples_.back()});
+
+        // start with the number of segments of the most finely sampled curve and double
+        // it until the resampled curves are accurate enough
+        size_t numSegments =
+            std::max({SwPcwnSamples_.size(), SwKrwSamples_.size(), SwKrnSamples_.size()}) - 1;
+        for (; numSegments + 1 <= maxUniformSamples_; numSegments *= 2) {
+            ValueVector SwValues(numSegments + 1);
+            for (size_t sampleIdx = 0; sampleIdx < numSegments; ++sampleIdx)
+                SwValues[sampleIdx] = SwMin + (SwMax - SwMin)*sampleIdx/numSegments;
+            SwValues.back() = SwMax;
+
+            ValueVector pcnwValues;
+            ValueVector krwValues;
+            ValueVector krnValues;
+            if (!resampleCurve_(pcnwValues, SwValues, SwPcwnSamples_, pcwnSamples_)
+                || !resampleCurve_(krwValues, SwValues, SwKrwSamples_, krwSamples_)
+                || !resampleCurve_(krnValues, SwValues, SwKrnSamples_, krnSamples_))
+                continue;
+
+            SwPcwnSamples_ = SwValues;
+            SwKrwSamples_ = SwValues;
+            SwKrnSamples_ = SwValues;
+            pcwnSamples_ = pcnwValues;
+            krwSamples_ = krwValues;
+            krnSamples_ = krnValues;
+            uniformSamplesInvSpacing_ = numSegments/(SwMax - SwMin);
+            return;
+        }
+    }
+
+    // sample a curve at the given saturations and check whether the result is accurate
+    // enough at the original sampling points
+    bool resampleCurve_(ValueVector& values,
+                        const ValueVector& SwValues,
+                        const ValueVector& SwOrig,
+                        const ValueVector& valuesOrig) const
+    {
+        values.resize(SwValues.size());
+        for (size_t sampleIdx = 0; sampleIdx < SwValues.size(); ++sampleIdx)
+            values[sampleIdx] = interpolate_(SwOrig, valuesOrig, SwValues[sampleIdx]);
+
+        const auto& minMax = std::minmax_element(valuesOrig.begin(), valuesOrig.end());
+        Scalar tolerance = uniformResamplingTolerance_*(*minMax.second - *minMax.first);
+        for (size_t sampleIdx = 0; sampleIdx < SwOrig.size(); ++sampleIdx) {
+            Scalar deviation =
+                interpolate_(SwValues, values, SwOrig[sampleIdx])
+                - interpolate_(SwOrig, valuesOrig, SwOrig[sampleIdx]);
+            if (std::abs(deviation) > tolerance)
+                return false;
+        }
+
+        return true;
+    }
+
+    // evaluate a piecewise linear curve with ascending sampling points
+    static Scalar interpolate_(const ValueVector& xValues, const ValueVector& yValues, Scalar x)
+    {
+        if (x <= xValues.front())
+            return yValues.front();
+        if (x >= xValues.back())
+            return yValues.back();
+
+        size_t segIdx = std::upper_bound(xValues.begin(), xValues.end(), x) - xValues.begin() - 1;
+        Scalar x0 = xValues[segIdx];
+        Scalar x1 = xValues[segIdx + 1];
+        Scalar y0 = yValues[segIdx];
+        Scalar y1 = yValues[segIdx + 1];
+        return y0 + (x - x0)*(y1 - y0)/(x1 - x0);
+    }
+
+    static bool isStrictlyAscending_(const ValueVector& xValues)
+    {
+        if (xValues.size() < 2)
+            return false;
+
+        for (size_t sampleIdx = 1; sampleIdx < xValues.size(); ++sampleIdx)
+            if (!(xValues[sampleIdx - 1] < xValues[sampleIdx]))
+                return false;
+
+        return true;
+    }
+
+    // build the table of the inverse of a curve. if the curve is not monotonic or
+    // constant, the table is left empty.
+    static void buildInverse_(ValueVector& invValues,
+                              ValueVector& invSwValues,
+                              const ValueVector& SwValues,
+                              const ValueVector& values)
+    {
+        invValues.clear();
+        invSwValues.clear();
+
+        int direction = 0;
+        for (size_t sampleIdx = 1; sampleIdx < values.size(); ++sampleIdx) {
+            if (values[sampleIdx] == values[sampleIdx - 1])
+                continue;
+
+            int segDirection = (values[sampleIdx] > values[sampleIdx - 1]) ? 1 : -1;
+            if (direction == 0)
+                direction = segDirection;
+            else if (segDirection != direction)
+                return;
+        }
+
+        if (direction == 0)
+            return;
+
+        // only keep the end points of flat sections
+        size_t n = values.size();
+        for (size_t sampleIdx = 0; sampleIdx < n; ++sampleIdx) {
+            if (0 < sampleIdx && sampleIdx + 1 < n
+                && values[sampleIdx - 1] == values[sampleIdx]
+                && values[sampleIdx] == values[sampleIdx + 1])
+                continue;
+
+            invValues.push_back(values[sampleIdx]);
+            invSwValues.push_back(SwValues[sampleIdx]);
+        }
+
+        if (direction < 0) {
+            std::reverse(invValues.begin(), invValues.end());
+            std::reverse(invSwValues.begin(), invSwValues.end());
+        }
+    }
+
+    void updateFusedSamples_()
+    {
+        fusedSamples_.clear();
+
+        size_t n = SwPcwnSamples_.size();
+        if (n < 2
+            || !(SwPcwnSamples_.front() < SwPcwnSamples_.back())
+            || SwKrwSamples_ != SwPcwnSamples_
+            || SwKrnSamples_ != SwPcwnSamples_)
+            return;
+
+        fusedSamples_.resize(numFusedQuantities*n);
+        for (size_t sampleIdx = 0; sampleIdx < n; ++sampleIdx) {
+            StorageScalar* values = &fusedSamples_[numFusedQuantities*sampleIdx];
+            values[fusedPcnwIdx] = pcwnSamples_[sampleIdx];
+            values[fusedKrwIdx] = krwSamples_[sampleIdx];
+            values[fusedKrnIdx] = krnSamples_[sampleIdx];
+        }
+    }
+
+    void updateSlopes_()
+    {
+        computeSlopes_(pcnwSlopes_, SwPcwnSamples_, pcwnSamples_);
+        computeSlopes_(krwSlopes_, SwKrwSamples_, krwSamples_);
+        computeSlopes_(krnSlopes_, SwKrnSamples_, krnSamples_);
+        computeSlopes_(pcnwInverseSlopes_, pcnwInverseSamples_, SwPcnwInverseSamples_);
+        computeSlopes_(krwInverseSlopes_, krwInverseSamples_, SwKrwInverseSamples_);
+        computeSlopes_(krnInverseSlopes_, krnInverseSamples_, SwKrnInverseSamples_);
+
+        pcnwCubicCoeffs_.clear();
+        krwCubicCoeffs_.clear();
+        krnCubicCoeffs_.clear();
+        if (interpolation_ == TableInterpolation::MonotoneCubic) {
+            computeCubicCoeffs_(pcnwCubicCoeffs_, SwPcwnSamples_, pcwnSamples_);
+            computeCubicCoeffs_(krwCubicCoeffs_, SwKrwSamples_, krwSamples_);
+            computeCubicCoeffs_(krnCubicCoeffs_, SwKrnSamples_, krnSamples_);
+        }
+    }
+
+    static void computeCubicCoeffs_(SlopeVector& coeffs, const ValueVector& xValues, const ValueVector& yValues)
+    {
+        MonotoneCubicInterpolation<Scalar>::computeCoefficients(coeffs, xValues.size(), xValues, yValues);
+    }
+
+    // the segments of jumps are never used for the interpolation, so their slope is
+    // set to zero instead of an infinite value
+    static void computeSlopes_(SlopeVector& slopes, const ValueVector& xValues, const ValueVector& yValues)
+    {
+        size_t n = xValues.size();
+        slopes.resize(n > 0 ? n - 1 : 0);
+        for (size_t segIdx = 0; segIdx + 1 < n; ++segIdx) {
+            Scalar x0 = xValues[segIdx];
+            Scalar x1 = xValues[segIdx + 1];
+            Scalar y0 = yValues[segIdx];
+            Scalar y1 = yValues[segIdx + 1];
+            slopes[segIdx] = (x0 == x1) ? 0.0 : (y1 - y0)/(x1 - x0);
+        }
+    }
+
+    template <class FlatScalar>
+    static FlatTabulated1DFunction<FlatScalar> exportFlatCurve_(FlatTableBuffer<FlatScalar>& buffer,
+                                                               const ValueVector& SwValues,
+                                                               const ValueVector& values)
+    {
+        if (SwValues.empty())
+            OPM_THROW(std::logic_error, "Only curves with at least one sampling point can be exported");
+
+        // finalize() sorts the sampling points in ascending order
+        FlatTabulated1DFunction<FlatScalar> result;
+        result.xOffset = buffer.appendScalars(SwValues.begin(), SwValues.end());
+        result.yOffset = buffer.appendScalars(values.begin(), values.end());
+        result.numSamples = static_cast<unsigned>(SwValues.size());
+        result.clampRange = true;
+        return result;
+    }
+
     void swapOrder_(ValueVector& swValues, ValueVector& values) const
     {
-        if (swValues.front() > values.back()) {
+        if (swValues.front() > swValues.back()) {
             for (unsigned origSampleIdx = 0;
                  origSampleIdx < swValues.size() / 2;
                  ++ origSampleIdx)
@@ -198,6 +974,41 @@ private:
     ValueVector pcwnSamples_;
     ValueVector krwSamples_;
     ValueVector krnSamples_;
+    ValueVector fusedSamples_;
+    ValueVector pcnwInverseSamples_;
+    ValueVector SwPcnwInverseSamples_;
+    ValueVector krwInverseSamples_;
+    ValueVector SwKrwInverseSamples_;
+    ValueVector krnInverseSamples_;
+    ValueVector SwKrnInverseSamples_;
+
+    SlopeVector pcnwSlopes_;
+    SlopeVector krwSlopes_;
+    SlopeVector krnSlopes_;
+    SlopeVector pcnwInverseSlopes_;
+    SlopeVector krwInverseSlopes_;
+    SlopeVector krnInverseSlopes_;
+
+    // the coefficients of the cubic segments of the curves if monotone cubic
+    // interpolation is used, else empty
+    SlopeVector pcnwCubicCoeffs_;
+    SlopeVector krwCubicCoeffs_;
+    SlopeVector krnCubicCoeffs_;
+
+    Scalar uniformResamplingTolerance_;
+    unsigned maxUniformSamples_;
+    Scalar uniformSamplesInvSpacing_;
+
+    Scalar simplificationTolerance_;
+    TableSimplificationStats simplificationStats_;
+
+    TableInterpolation interpolation_;
+
+#if OPM_MATERIAL_PROFILE_TABLES
+    TableProfile pcnwProfile_;
+    TableProfile krwProfile_;
+    TableProfile krnProfile_;
+#endif
 };
 } // namespace Opm
 
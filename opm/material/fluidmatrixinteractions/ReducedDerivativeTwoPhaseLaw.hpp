@@ -0,0 +1,312 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ReducedDerivativeTwoPhaseLaw
+ */
+#ifndef OPM_REDUCED_DERIVATIVE_TWO_PHASE_LAW_HPP
+#define OPM_REDUCED_DERIVATIVE_TWO_PHASE_LAW_HPP
+
+#include "MaterialLawCombinedEvaluation.hpp"
+
+#include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/densead/DerivativeExpansion.hpp>
+
+#include <type_traits>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Evaluates a two-phase material law using evaluations which only consider the
+ *        derivative with regard to the saturation (or capillary pressure) argument.
+ *
+ * The quantities of two-phase laws only depend on a single argument, while the
+ * evaluations of the caller usually carry the derivatives with regard to all primary
+ * variables of a cell. The argument is thus narrowed to an evaluation with a single
+ * derivative, the wrapped law is evaluated and the derivative of the result is
+ * expanded to the caller's primary variables using the chain rule, e.g.
+ *
+ * \code
+ * typedef Opm::TwoPhaseMaterialTraits<double, wPhaseIdx, nPhaseIdx> Traits;
+ * typedef Opm::ReducedDerivativeTwoPhaseLaw<Traits,
+ *                                           Opm::PiecewiseLinearTwoPhaseMaterial<Traits> > MaterialLaw;
+ * \endcode
+ *
+ * The parameter objects of the wrapped law are used directly. The results are
+ * identical to evaluating the wrapped law directly up to round-off.
+ */
+template <class TraitsT, class WrappedLawT>
+class ReducedDerivativeTwoPhaseLaw : public TraitsT
+{
+    typedef WrappedLawT WrappedLaw;
+
+    template <class Evaluation>
+    struct ReducedEvaluation_
+        : public ReducedEvaluation<Evaluation, 1>
+    {};
+
+public:
+    //! The traits class for this material law
+    typedef TraitsT Traits;
+
+    //! The type of the parameter objects for this law
+    typedef typename WrappedLaw::Params Params;
+
+    //! The type of the scalar values for this law
+    typedef typename Traits::Scalar Scalar;
+
+    //! The number of fluid phases
+    static const int numPhases = Traits::numPhases;
+    static_assert(numPhases == 2,
+                  "The reduced-derivative adapter only supports two-phase laws");
+    static_assert(numPhases == WrappedLaw::numPhases,
+                  "The wrapped law must exhibit the same number of phases");
+
+    //! Specify whether this material law implements the two-phase
+    //! convenience API
+    static const bool implementsTwoPhaseApi = true;
+
+    //! Specify whether this material law implements the two-phase
+    //! convenience API which only depends on the phase saturations
+    static const bool implementsTwoPhaseSatApi = true;
+
+    //! Specify whether the quantities defined by this material law
+    //! are saturation dependent
+    static const bool isSaturationDependent = WrappedLaw::isSaturationDependent;
+
+    //! Specify whether the quantities defined by this material law
+    //! are dependent on the absolute pressure
+    static const bool isPressureDependent = false;
+
+    //! Specify whether the quantities defined by this material law
+    //! are temperature dependent
+    static const bool isTemperatureDependent = false;
+
+    //! Specify whether the quantities defined by this material law
+    //! are dependent on the phase composition
+    static const bool isCompositionDependent = false;
+
+    static_assert(WrappedLaw::implementsTwoPhaseSatApi,
+                  "The wrapped law must implement the two-phase saturation API");
+    static_assert(!WrappedLaw::isPressureDependent
+                  && !WrappedLaw::isTemperatureDependent
+                  && !WrappedLaw::isCompositionDependent,
+                  "The wrapped law may only depend on the saturations");
+
+    /*!
+     * \brief The capillary pressure-saturation curves.
+     */
+    template <class Container, class FluidState>
+    static void capillaryPressures(Container& values, const Params& params, const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(values[0])>::type Evaluation;
+
+        values[Traits::wettingPhaseIdx] = 0.0; // reference phase
+        values[Traits::nonWettingPhaseIdx] = pcnw<FluidState, Evaluation>(params, fs);
+    }
+
+    /*!
+     * \brief The saturations of the fluid phases starting from their
+     *        pressure differences.
+     */
+    template <class Container, class FluidState>
+    static void saturations(Container& values, const Params& params, const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(values[0])>::type Evaluation;
+
+        values[Traits::wettingPhaseIdx] = Sw<FluidState, Evaluation>(params, fs);
+        values[Traits::nonWettingPhaseIdx] = 1.0 - values[Traits::wettingPhaseIdx];
+    }
+
+    /*!
+     * \brief The relative permeability-saturation curves.
+     */
+    template <class Container, class FluidState>
+    static void relativePermeabilities(Container& values, const Params& params, const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(values[0])>::type Evaluation;
+
+        values[Traits::wettingPhaseIdx] = krw<FluidState, Evaluation>(params, fs);
+        values[Traits::nonWettingPhaseIdx] = krn<FluidState, Evaluation>(params, fs);
+    }
+
+    /*!
+     * \brief The capillary pressures and the relative permeabilities.
+     *
+     * The saturation is only narrowed once and the quantities are evaluated using
+     * twoPhaseSatPcnwAndKr().
+     */
+    template <class PcContainer, class KrContainer, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainer& pcValues,
+                                                            KrContainer& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(pcValues[0])>::type Evaluation;
+
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        Evaluation pcnw;
+        Evaluation krw;
+        Evaluation krn;
+        twoPhaseSatPcnwAndKr(&pcnw, &krw, &krn, params, Sw);
+
+        pcValues[Traits::wettingPhaseIdx] = 0.0; // reference phase
+        pcValues[Traits::nonWettingPhaseIdx] = pcnw;
+        krValues[Traits::wettingPhaseIdx] = krw;
+        krValues[Traits::nonWettingPhaseIdx] = krn;
+    }
+
+    /*!
+     * \brief The capillary pressure and the relative permeabilities at a given
+     *        wetting phase saturation.
+     *
+     * Only the quantities for which a non-null pointer is passed are computed.
+     */
+    template <class Evaluation>
+    static void twoPhaseSatPcnwAndKr(Evaluation* pcnw,
+                                     Evaluation* krw,
+                                     Evaluation* krn,
+                                     const Params& params,
+                                     const Evaluation& Sw)
+    {
+        typedef typename ReducedEvaluation_<Evaluation>::type ReducedEval;
+
+        ReducedEval reducedPcnw;
+        ReducedEval reducedKrw;
+        ReducedEval reducedKrn;
+        Opm::twoPhaseSatPcnwAndKr<WrappedLaw, ReducedEval>(pcnw ? &reducedPcnw : nullptr,
+                                                           krw ? &reducedKrw : nullptr,
+                                                           krn ? &reducedKrn : nullptr,
+                                                           params,
+                                                           narrow_(Sw));
+        if (pcnw)
+            *pcnw = expand_<Evaluation>(reducedPcnw, Sw);
+        if (krw)
+            *krw = expand_<Evaluation>(reducedKrw, Sw);
+        if (krn)
+            *krn = expand_<Evaluation>(reducedKrn, Sw);
+    }
+
+    /*!
+     * \brief The capillary pressure-saturation curve
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation pcnw(const Params& params, const FluidState& fs)
+    {
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        return twoPhaseSatPcnw(params, Sw);
+    }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& Sw)
+    { return expand_<Evaluation>(WrappedLaw::twoPhaseSatPcnw(params, narrow_(Sw)), Sw); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatPcnwInv(const Params& params, const Evaluation& pcnw)
+    { return expand_<Evaluation>(WrappedLaw::twoPhaseSatPcnwInv(params, narrow_(pcnw)), pcnw); }
+
+    /*!
+     * \brief The wetting phase saturation given the phase pressures.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation Sw(const Params& params, const FluidState& fs)
+    {
+        const Evaluation& pC =
+            Opm::decay<Evaluation>(fs.pressure(Traits::nonWettingPhaseIdx))
+            - Opm::decay<Evaluation>(fs.pressure(Traits::wettingPhaseIdx));
+
+        return twoPhaseSatSw(params, pC);
+    }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatSw(const Params& params, const Evaluation& pC)
+    { return expand_<Evaluation>(WrappedLaw::twoPhaseSatSw(params, narrow_(pC)), pC); }
+
+    /*!
+     * \brief The non-wetting phase saturation given the phase pressures.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation Sn(const Params& params, const FluidState& fs)
+    { return 1.0 - Sw<FluidState, Evaluation>(params, fs); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatSn(const Params& params, const Evaluation& pC)
+    { return 1.0 - twoPhaseSatSw(params, pC); }
+
+    /*!
+     * \brief The relative permeability for the wetting phase
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation krw(const Params& params, const FluidState& fs)
+    {
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        return twoPhaseSatKrw(params, Sw);
+    }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrw(const Params& params, const Evaluation& Sw)
+    { return expand_<Evaluation>(WrappedLaw::twoPhaseSatKrw(params, narrow_(Sw)), Sw); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrwInv(const Params& params, const Evaluation& krw)
+    { return expand_<Evaluation>(WrappedLaw::twoPhaseSatKrwInv(params, narrow_(krw)), krw); }
+
+    /*!
+     * \brief The relative permeability for the non-wetting phase
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation krn(const Params& params, const FluidState& fs)
+    {
+        const auto& Sw =
+            Opm::decay<Evaluation>(fs.saturation(Traits::wettingPhaseIdx));
+
+        return twoPhaseSatKrn(params, Sw);
+    }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrn(const Params& params, const Evaluation& Sw)
+    { return expand_<Evaluation>(WrappedLaw::twoPhaseSatKrn(params, narrow_(Sw)), Sw); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrnInv(const Params& params, const Evaluation& krn)
+    { return expand_<Evaluation>(WrappedLaw::twoPhaseSatKrnInv(params, narrow_(krn)), krn); }
+
+private:
+    template <class Evaluation>
+    static typename ReducedEvaluation_<Evaluation>::type narrow_(const Evaluation& value)
+    { return Opm::narrowToVariable<typename ReducedEvaluation_<Evaluation>::type>(value, 0); }
+
+    template <class Evaluation, class ReducedEval>
+    static Evaluation expand_(const ReducedEval& value, const Evaluation& arg)
+    { return Opm::expandDerivatives<Evaluation>(value, arg); }
+};
+} // namespace Opm
+
+#endif
@@ -182,20 +182,19 @@ public:
     {
         const Scalar Sthres = params.pcnwLowSw();
 
-        if (Sw <= Sthres) {
-            Scalar m = params.pcnwSlopeLow();
-            Scalar pcnw_SwLow = params.pcnwLow();
-            return pcnw_SwLow + m*(Sw - Sthres);
-        }
-        else if (Sw >= 1.0) {
-            Scalar m = params.pcnwSlopeHigh();
-            Scalar pcnw_SwHigh = params.pcnwHigh();
-            return pcnw_SwHigh + m*(Sw - 1.0);
-        }
-
         // if the effective saturation is in an 'reasonable'
         // range, we use the real Brooks-Corey law...
-        return BrooksCorey::twoPhaseSatPcnw(params, Sw);
+        if (Sthres < Sw && Sw < 1.0)
+            return BrooksCorey::twoPhaseSatPcnw(params, Sw);
+
+        // ...else we extrapolate using a straight line. since both
+        // regularizations are linear, only their coefficients need to be
+        // selected.
+        const bool isLow = Sw <= Sthres;
+        const Scalar Sw0 = isLow ? Sthres : 1.0;
+        const Scalar pcnw0 = isLow ? params.pcnwLow() : params.pcnwHigh();
+        const Scalar m = isLow ? params.pcnwSlopeLow() : params.pcnwSlopeHigh();
+        return pcnw0 + m*(Sw - Sw0);
     }
 
     /*!
@@ -233,19 +232,15 @@ public:
         // derivative calculated numerically) in order to get the
         // saturation moving to the right direction if it
         // temporarily is in an 'illegal' range.
-        if (Sw <= Sthres) {
-            // invert the low saturation regularization of pcnw()
-            Scalar m = params.pcnwSlopeLow();
-            Scalar pcnw_SwLow = params.pcnwLow();
-            return Sthres + (pcnw - pcnw_SwLow)/m;
-        }
-        else if (Sw > 1.0) {
-            Scalar m = params.pcnwSlopeHigh();
-            Scalar pcnw_SwHigh = params.pcnwHigh();
-            return 1.0 + (pcnw - pcnw_SwHigh)/m;;
-        }
-
-        return BrooksCorey::twoPhaseSatSw(params, pcnw);
+        if (Sthres < Sw && Sw <= 1.0)
+            return Sw;
+
+        // invert the regularization of pcnw()
+        const bool isLow = Sw <= Sthres;
+        const Scalar Sw0 = isLow ? Sthres : 1.0;
+        const Scalar pcnw0 = isLow ? params.pcnwLow() : params.pcnwHigh();
+        const Scalar m = isLow ? params.pcnwSlopeLow() : params.pcnwSlopeHigh();
+        return Sw0 + (pcnw - pcnw0)/m;
     }
 
     /*!
@@ -76,6 +76,20 @@ public:
         pcnwSlopeHigh_ = dPcnw_dSw_(1.0);
     }
 
+    /*!
+     * \brief Returns true if the independent quantities of two parameter
+     *        objects are identical.
+     */
+    bool operator==(const RegularizedBrooksCoreyParams& other) const
+    {
+        return
+            BrooksCoreyParams::operator==(other)
+            && pcnwLowSw_ == other.pcnwLowSw_;
+    }
+
+    bool operator!=(const RegularizedBrooksCoreyParams& other) const
+    { return !(*this == other); }
+
     /*!
      * \brief Return the threshold saturation below which the
      *        capillary pressure is regularized.
@@ -174,34 +174,32 @@ public:
         const Scalar SwThLow = params.pcnwLowSw();
         const Scalar SwThHigh = params.pcnwHighSw();
 
+        // if the effective saturation is in an 'reasonable'
+        // range, we use the real van genuchten law...
+        if (SwThLow <= Sw && Sw <= SwThHigh)
+            return VanGenuchten::twoPhaseSatPcnw(params, Sw);
+
+        // use the spline between the high threshold saturation and 1.0. its
+        // coefficients have been precomputed by the parameter object
+        if (SwThHigh < Sw && Sw < 1.0) {
+            const Evaluation& x = Sw - SwThHigh;
+            return
+                ((params.pcnwHighCoeff(3)*x + params.pcnwHighCoeff(2))*x
+                 + params.pcnwHighCoeff(1))*x + params.pcnwHighCoeff(0);
+        }
+
         // make sure that the capillary pressure observes a derivative
         // != 0 for 'illegal' saturations. This is favourable for the
         // newton solver (if the derivative is calculated numerically)
         // in order to get the saturation moving to the right
-        // direction if it temporarily is in an 'illegal' range.
-        if (Sw < SwThLow) {
-            return params.pcnwLow() + params.pcnwSlopeLow()*(Sw - SwThLow);
-        }
-        else if (Sw > SwThHigh)
-        {
-            Scalar yTh = params.pcnwHigh();
-            Scalar m1 = (0.0 - yTh)/(1.0 - SwThHigh)*2;
-
-            if (Sw < 1.0) {
-                // use spline between threshold Sw and 1.0
-                const Spline<Scalar>& sp = params.pcnwHighSpline();
-
-                return sp.eval(Sw);
-            }
-            else {
-                // straight line for Sw > 1.0
-                return m1*(Sw - 1.0) + 0.0;
-            }
-        }
-
-        // if the effective saturation is in an 'reasonable'
-        // range, we use the real van genuchten law...
-        return VanGenuchten::twoPhaseSatPcnw(params, Sw);
+        // direction if it temporarily is in an 'illegal' range. both
+        // regularizations are straight lines, so only their coefficients
+        // need to be selected.
+        const bool isLow = Sw < SwThLow;
+        const Scalar Sw0 = isLow ? SwThLow : 1.0;
+        const Scalar pcnw0 = isLow ? params.pcnwLow() : 0.0;
+        const Scalar m = isLow ? params.pcnwSlopeLow() : params.pcnwSlopeHigh();
+        return pcnw0 + m*(Sw - Sw0);
     }
 
     /*!
@@ -249,8 +247,7 @@ public:
         // invert the regularization if necessary
         if (Sw <= SwThLow) {
             // invert the low saturation regularization of pC()
-            Scalar pC_SwLow = VanGenuchten::twoPhaseSatPcnw(params, SwThLow);
-            return (pC - pC_SwLow)/params.pcnwSlopeLow() + SwThLow;
+            return (pC - params.pcnwLow())/params.pcnwSlopeLow() + SwThLow;
         }
         else if (SwThHigh < Sw /* && Sw < 1.0*/)
         {
@@ -85,8 +85,34 @@ public:
         pcnwHighSpline_.set(pcnwHighSw_, 1.0, // x0, x1
                             pcnwHigh_, 0, // y0, y1
                             mThreshold, pcnwSlopeHigh_); // m0, m1
+
+        // the spline only consists of a single segment, i.e., it is the cubic
+        // Hermite polynomial given by the values and slopes at its end points. We
+        // store its coefficients in terms of (Sw - pcnwHighSw) so that it can be
+        // evaluated without looking up the segment.
+        Scalar h = 1.0 - pcnwHighSw_;
+        Scalar delta = (0.0 - pcnwHigh_)/h;
+        pcnwHighCoeffs_[0] = pcnwHigh_;
+        pcnwHighCoeffs_[1] = mThreshold;
+        pcnwHighCoeffs_[2] = (3*delta - 2*mThreshold - pcnwSlopeHigh_)/h;
+        pcnwHighCoeffs_[3] = (mThreshold + pcnwSlopeHigh_ - 2*delta)/(h*h);
     }
 
+    /*!
+     * \brief Returns true if the independent quantities of two parameter
+     *        objects are identical.
+     */
+    bool operator==(const RegularizedVanGenuchtenParams& other) const
+    {
+        return
+            Parent::operator==(other)
+            && pcnwLowSw_ == other.pcnwLowSw_
+            && pcnwHighSw_ == other.pcnwHighSw_;
+    }
+
+    bool operator!=(const RegularizedVanGenuchtenParams& other) const
+    { return !(*this == other); }
+
     /*!
      * \brief Return the threshold saturation below which the
      *        capillary pressure is regularized.
@@ -138,6 +164,15 @@ public:
     const Spline<Scalar>& pcnwHighSpline() const
     { EnsureFinalized::check(); return pcnwHighSpline_; }
 
+    /*!
+     * \brief Return a coefficient of the polynomial representation of the
+     *        spline curve between the upper threshold saturation and 1.
+     *
+     * The spline is given by \f$\sum_{i=0}^3 c_i (S_w - S_{w,high})^i\f$.
+     */
+    Scalar pcnwHighCoeff(unsigned i) const
+    { EnsureFinalized::check(); assert(i < 4); return pcnwHighCoeffs_[i]; }
+
     /*!
      * \brief Return the slope capillary pressure curve if Sw is
      *        larger or equal to 1.
@@ -175,6 +210,7 @@ private:
     Scalar pcnwSlopeHigh_;
 
     Spline<Scalar> pcnwHighSpline_;
+    Scalar pcnwHighCoeffs_[4];
 };
 } // namespace Opm
 
@@ -77,6 +77,7 @@ public:
     {
         assert(SwSamplePoints.size() == pcnwSamplePoints.size());
         pcwnSpline_.setXYContainers(SwSamplePoints, pcnwSamplePoints, splineType);
+        pcwnSpline_.precomputeCoefficients();
     }
 
     /*!
@@ -100,6 +101,7 @@ public:
     {
         assert(SwSamplePoints.size() == krwSamplePoints.size());
         krwSpline_.setXYContainers(SwSamplePoints, krwSamplePoints, splineType);
+        krwSpline_.precomputeCoefficients();
     }
 
     /*!
@@ -123,6 +125,7 @@ public:
     {
         assert(SwSamplePoints.size() == krnSamplePoints.size());
         krnSpline_.setXYContainers(SwSamplePoints, krnSamplePoints, splineType);
+        krnSpline_.precomputeCoefficients();
     }
 
 private:
@@ -0,0 +1,121 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::TabulatedTwoPhaseMaterial
+ */
+#ifndef OPM_TABULATED_TWO_PHASE_MATERIAL_HPP
+#define OPM_TABULATED_TWO_PHASE_MATERIAL_HPP
+
+#include "TabulatedTwoPhaseMaterialParams.hpp"
+#include "PiecewiseLinearTwoPhaseMaterial.hpp"
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <type_traits>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Adaptor which evaluates an analytic two-phase material law using piecewise
+ *        linear tables.
+ *
+ * The curves of the raw law are sampled once per parameter object (see
+ * TabulatedTwoPhaseMaterialParams), so evaluating the capillary pressure and the
+ * relative permeabilities only requires a table lookup instead of the transcendental
+ * functions used by laws like VanGenuchten or BrooksCorey. In contrast to
+ * PiecewiseLinearTwoPhaseMaterial, the saturations can also be calculated from the
+ * capillary pressure, because the tabulated curve is monotonic if the raw one is.
+ */
+template <class RawLawT, class ParamsT = TabulatedTwoPhaseMaterialParams<RawLawT> >
+class TabulatedTwoPhaseMaterial
+    : public PiecewiseLinearTwoPhaseMaterial<typename RawLawT::Traits, ParamsT>
+{
+    typedef PiecewiseLinearTwoPhaseMaterial<typename RawLawT::Traits, ParamsT> ParentType;
+
+public:
+    //! The raw material law which is tabulated
+    typedef RawLawT RawLaw;
+
+    //! The traits class for this material law
+    typedef typename RawLaw::Traits Traits;
+
+    //! The type of the parameter objects for this law
+    typedef ParamsT Params;
+
+    //! The type of the scalar values for this law
+    typedef typename Traits::Scalar Scalar;
+
+    /*!
+     * \brief Calculate the saturations of the phases starting from
+     *        their pressure differences.
+     */
+    template <class Container, class FluidState>
+    static void saturations(Container& values, const Params& params, const FluidState& fs)
+    {
+        typedef typename std::remove_reference<decltype(values[0])>::type Evaluation;
+
+        values[Traits::wettingPhaseIdx] = Sw<FluidState, Evaluation>(params, fs);
+        values[Traits::nonWettingPhaseIdx] = 1 - values[Traits::wettingPhaseIdx];
+    }
+
+    /*!
+     * \brief Calculate the wetting phase saturations depending on
+     *        the phase pressures.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation Sw(const Params& params, const FluidState& fs)
+    {
+        Evaluation pC =
+            Opm::decay<Evaluation>(fs.pressure(Traits::nonWettingPhaseIdx))
+            - Opm::decay<Evaluation>(fs.pressure(Traits::wettingPhaseIdx));
+        return twoPhaseSatSw(params, pC);
+    }
+
+    /*!
+     * \brief The saturation-capillary pressure curve.
+     */
+    template <class Evaluation>
+    static Evaluation twoPhaseSatSw(const Params& params, const Evaluation& pC)
+    { return ParentType::twoPhaseSatPcnwInv(params, pC); }
+
+    /*!
+     * \brief Calculate the non-wetting phase saturations depending on
+     *        the phase pressures.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    static Evaluation Sn(const Params& params, const FluidState& fs)
+    { return 1 - Sw<FluidState, Evaluation>(params, fs); }
+
+    /*!
+     * \brief Calculate the non-wetting phase saturation depending on
+     *        the capillary pressure.
+     */
+    template <class Evaluation>
+    static Evaluation twoPhaseSatSn(const Params& params, const Evaluation& pC)
+    { return 1 - twoPhaseSatSw(params, pC); }
+};
+} // namespace Opm
+
+#endif
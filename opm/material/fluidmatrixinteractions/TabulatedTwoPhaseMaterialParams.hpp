@@ -0,0 +1,226 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::TabulatedTwoPhaseMaterialParams
+ */
+#ifndef OPM_TABULATED_TWO_PHASE_MATERIAL_PARAMS_HPP
+#define OPM_TABULATED_TWO_PHASE_MATERIAL_PARAMS_HPP
+
+#include "PiecewiseLinearTwoPhaseMaterialParams.hpp"
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace Opm {
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Specification of the material parameters for a two-phase material law
+ *        which uses piecewise linear tables that were sampled from an analytic
+ *        two-phase law.
+ *
+ * The sampling points are placed adaptively: An interval is bisected until the
+ * linear interpolation deviates from the raw law by less than the tolerance at its
+ * center. The tolerance is relative to the value of the curve, but it becomes
+ * absolute for values which are smaller than the characteristic magnitude of the
+ * curve, i.e., 1 for the relative permeabilities and the capillary pressure at a
+ * wetting phase saturation of 0.5 for the capillary pressure. If the raw law is not
+ * finite at a saturation of 0 or 1, the first or last sampling point is moved inward
+ * until it is, i.e., the tabulated curve is then constant beyond it.
+ */
+template <class RawLawT>
+class TabulatedTwoPhaseMaterialParams
+    : public PiecewiseLinearTwoPhaseMaterialParams<typename RawLawT::Traits>
+{
+    typedef PiecewiseLinearTwoPhaseMaterialParams<typename RawLawT::Traits> ParentType;
+    typedef typename RawLawT::Traits::Scalar Scalar;
+
+public:
+    typedef RawLawT RawLaw;
+    typedef typename RawLaw::Params RawParams;
+
+    TabulatedTwoPhaseMaterialParams()
+        : rawParams_(nullptr)
+        , tolerance_(1e-4)
+        , maxRefinements_(24)
+    {}
+
+    /*!
+     * \brief Set the parameters of the raw law which is tabulated.
+     *
+     * The parameter object must already be finalized. It is only accessed by
+     * finalize(), so it may be destroyed afterwards.
+     */
+    void setRawParams(const RawParams* rawParams)
+    { rawParams_ = rawParams; }
+
+    /*!
+     * \brief Set the maximum deviation of the tables from the raw law.
+     */
+    void setTolerance(Scalar value)
+    {
+        assert(value > 0);
+        tolerance_ = value;
+    }
+
+    /*!
+     * \brief Returns the maximum deviation of the tables from the raw law.
+     */
+    Scalar tolerance() const
+    { return tolerance_; }
+
+    /*!
+     * \brief Set the maximum number of times an interval of the initial sampling
+     *        points is bisected.
+     *
+     * This limits the number of sampling points in regions where the raw law is
+     * not smooth enough to reach the tolerance.
+     */
+    void setMaxRefinements(unsigned value)
+    { maxRefinements_ = value; }
+
+    /*!
+     * \brief Sample the raw law and calculate all dependent quantities.
+     */
+    void finalize()
+    {
+        if (!rawParams_)
+            OPM_THROW(std::logic_error,
+                      "The parameters of the raw law must be specified before the "
+                      "tabulated two-phase material law can be finalized");
+
+        const RawParams& rawParams = *rawParams_;
+        std::vector<Scalar> SwValues;
+        std::vector<Scalar> values;
+
+        sampleCurve_(SwValues, values,
+                     [&](Scalar Sw) { return RawLaw::twoPhaseSatPcnw(rawParams, Sw); },
+                     std::abs(Scalar(RawLaw::twoPhaseSatPcnw(rawParams, Scalar(0.5)))));
+        this->setPcnwSamples(SwValues, values);
+
+        sampleCurve_(SwValues, values,
+                     [&](Scalar Sw) { return RawLaw::twoPhaseSatKrw(rawParams, Sw); },
+                     /*scale=*/1.0);
+        this->setKrwSamples(SwValues, values);
+
+        sampleCurve_(SwValues, values,
+                     [&](Scalar Sw) { return RawLaw::twoPhaseSatKrn(rawParams, Sw); },
+                     /*scale=*/1.0);
+        this->setKrnSamples(SwValues, values);
+
+        ParentType::finalize();
+    }
+
+private:
+    template <class Fn>
+    void sampleCurve_(std::vector<Scalar>& SwValues,
+                      std::vector<Scalar>& values,
+                      const Fn& fn,
+                      Scalar scale) const
+    {
+        static const unsigned numInitialIntervals = 16;
+
+        SwValues.clear();
+        values.clear();
+
+        Scalar SwMin = finiteEndPoint_(fn, 0.0, 1.0/numInitialIntervals);
+        Scalar SwMax = finiteEndPoint_(fn, 1.0, 1.0 - 1.0/numInitialIntervals);
+        if (!std::isfinite(scale) || scale <= 0.0)
+            scale = 1.0;
+
+        Scalar x0 = SwMin;
+        Scalar y0 = fn(x0);
+        SwValues.push_back(x0);
+        values.push_back(y0);
+        for (unsigned intervalIdx = 1; intervalIdx <= numInitialIntervals; ++intervalIdx) {
+            Scalar x1 =
+                (intervalIdx == numInitialIntervals)
+                ? SwMax
+                : SwMin + (SwMax - SwMin)*intervalIdx/numInitialIntervals;
+            Scalar y1 = fn(x1);
+            refine_(SwValues, values, fn, x0, y0, x1, y1, scale, /*depth=*/0);
+            x0 = x1;
+            y0 = y1;
+        }
+    }
+
+    // append the sampling points of the interval (x0, x1] to the tables
+    template <class Fn>
+    void refine_(std::vector<Scalar>& SwValues,
+                 std::vector<Scalar>& values,
+                 const Fn& fn,
+                 Scalar x0, Scalar y0,
+                 Scalar x1, Scalar y1,
+                 Scalar scale,
+                 unsigned depth) const
+    {
+        Scalar xMid = (x0 + x1)/2;
+        Scalar yMid = fn(xMid);
+        Scalar deviation = std::abs(yMid - (y0 + y1)/2);
+        if (depth < maxRefinements_
+            && deviation > tolerance_*std::max(std::abs(yMid), scale))
+        {
+            refine_(SwValues, values, fn, x0, y0, xMid, yMid, scale, depth + 1);
+            refine_(SwValues, values, fn, xMid, yMid, x1, y1, scale, depth + 1);
+            return;
+        }
+
+        SwValues.push_back(x1);
+        values.push_back(y1);
+    }
+
+    // move an end point of the sampling range towards the inside of the range until
+    // the raw law is finite
+    template <class Fn>
+    static Scalar finiteEndPoint_(const Fn& fn, Scalar endPoint, Scalar innerPoint)
+    {
+        if (std::isfinite(fn(endPoint)))
+            return endPoint;
+
+        Scalar distance = 1e-10;
+        while (distance < std::abs(innerPoint - endPoint)) {
+            Scalar x = (endPoint < innerPoint) ? endPoint + distance : endPoint - distance;
+            if (std::isfinite(fn(x)))
+                return x;
+            distance *= 10;
+        }
+
+        if (!std::isfinite(fn(innerPoint)))
+            OPM_THROW(NumericalProblem,
+                      "The raw two-phase material law is not finite close to Sw = " << endPoint);
+        return innerPoint;
+    }
+
+    const RawParams* rawParams_;
+    Scalar tolerance_;
+    unsigned maxRefinements_;
+};
+} // namespace Opm
+
+#endif
@@ -122,45 +122,12 @@ public:
     template <class FluidState, class Evaluation = typename FluidState::Scalar>
     static Evaluation pcgn(const Params& params, const FluidState& fluidState)
     {
-        Scalar PC_VG_REG = 0.01;
-
         // sum of liquid saturations
         const auto& St =
             Opm::decay<Evaluation>(fluidState.saturation(wettingPhaseIdx))
             + Opm::decay<Evaluation>(fluidState.saturation(nonWettingPhaseIdx));
 
-        Evaluation Se = (St - params.Swrx())/(1. - params.Swrx());
-
-        // regularization
-        if (Se < 0.0)
-            Se=0.0;
-        if (Se > 1.0)
-            Se=1.0;
-
-        if (Se>PC_VG_REG && Se<1-PC_VG_REG)
-        {
-            const Evaluation& x = Opm::pow(Se,-1/params.vgM()) - 1;
-            return Opm::pow(x, 1.0 - params.vgM())/params.vgAlpha();
-        }
-
-        // value and derivative at regularization point
-        Scalar Se_regu;
-        if (Se<=PC_VG_REG)
-            Se_regu = PC_VG_REG;
-        else
-            Se_regu = 1-PC_VG_REG;
-        const Evaluation& x = std::pow(Se_regu,-1/params.vgM())-1;
-        const Evaluation& pc = Opm::pow(x, 1.0/params.vgN())/params.vgAlpha();
-        const Evaluation& pc_prime =
-            Opm::pow(x, 1/params.vgN()-1)
-            * std::pow(Se_regu,-1/params.vgM()-1)
-            / (-params.vgM())
-            / params.vgAlpha()
-            / (1 - params.Sgr() - params.Swrx())
-            / params.vgN();
-
-        // evaluate tangential
-        return ((Se-Se_regu)*pc_prime + pc)/params.betaGN();
+        return pcgn_(params, St);
     }
 
     /*!
@@ -177,41 +144,8 @@ public:
     {
         const Evaluation& Sw =
             Opm::decay<Evaluation>(fluidState.saturation(wettingPhaseIdx));
-        Evaluation Se = (Sw-params.Swr())/(1.-params.Snr());
-
-        Scalar PC_VG_REG = 0.01;
-
-        // regularization
-        if (Se<0.0)
-            Se=0.0;
-        if (Se>1.0)
-            Se=1.0;
 
-        if (Se>PC_VG_REG && Se<1-PC_VG_REG) {
-            Evaluation x = Opm::pow(Se,-1/params.vgM()) - 1.0;
-            x = Opm::pow(x, 1 - params.vgM());
-            return x/params.vgAlpha();
-        }
-
-        // value and derivative at regularization point
-        Scalar Se_regu;
-        if (Se<=PC_VG_REG)
-            Se_regu = PC_VG_REG;
-        else
-            Se_regu = 1.0 - PC_VG_REG;
-
-        const Evaluation& x = std::pow(Se_regu,-1/params.vgM())-1;
-        const Evaluation& pc = Opm::pow(x, 1/params.vgN())/params.vgAlpha();
-        const Evaluation& pc_prime =
-            Opm::pow(x,1/params.vgN()-1)
-            * std::pow(Se_regu, -1.0/params.vgM() - 1)
-            / (-params.vgM())
-            / params.vgAlpha()
-            / (1-params.Snr()-params.Swr())
-            / params.vgN();
-
-        // evaluate tangential
-        return ((Se-Se_regu)*pc_prime + pc)/params.betaNW();
+        return pcnw_(params, Sw);
     }
 
     /*!
@@ -260,6 +194,44 @@ public:
         values[gasPhaseIdx] = krg<FluidState, Evaluation>(params, fluidState);
     }
 
+    /*!
+     * \brief Compute the capillary pressures and the relative permeabilities of all
+     *        phases at once.
+     *
+     * The results are the same as the ones of capillaryPressures() and
+     * relativePermeabilities(), but the saturations are only retrieved from the fluid
+     * state once and the van Genuchten term of the effective wetting phase saturation
+     * is shared by the relative permeabilities of the wetting and the non-wetting
+     * phases.
+     */
+    template <class PcContainerT, class KrContainerT, class FluidState>
+    static void capillaryPressuresAndRelativePermeabilities(PcContainerT& pcValues,
+                                                            KrContainerT& krValues,
+                                                            const Params& params,
+                                                            const FluidState& fluidState)
+    {
+        typedef typename std::remove_reference<decltype(pcValues[0])>::type Evaluation;
+
+        const Evaluation& Sw =
+            Opm::decay<Evaluation>(fluidState.saturation(wettingPhaseIdx));
+        const Evaluation& Sn =
+            Opm::decay<Evaluation>(fluidState.saturation(nonWettingPhaseIdx));
+        const Evaluation& Sg =
+            Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
+
+        pcValues[gasPhaseIdx] = pcgn_(params, Evaluation(Sw + Sn));
+        pcValues[nonWettingPhaseIdx] = 0;
+        pcValues[wettingPhaseIdx] = - pcnw_(params, Sw);
+
+        const Evaluation& Swe = (Sw - params.Swr()) / (1 - params.Swr());
+        const Evaluation& SweRegularized = regularizeKrnSaturation_(Swe);
+        const Evaluation& vgTermW = vgTerm_(params, SweRegularized);
+
+        krValues[wettingPhaseIdx] = krw_(Swe, vgTermW);
+        krValues[nonWettingPhaseIdx] = krn_(params, Sw, Sn, SweRegularized, vgTermW);
+        krValues[gasPhaseIdx] = krg_(params, Sg);
+    }
+
     /*!
      * \brief The relative permeability for the wetting phase of the
      *        medium implied by van Genuchten's parameterization.
@@ -280,8 +252,7 @@ public:
         if(Se > 1.0) return 1.;
         if(Se < 0.0) return 0.;
 
-        const Evaluation& r = 1. - Opm::pow(1 - Opm::pow(Se, 1/params.vgM()), params.vgM());
-        return Opm::sqrt(Se)*r*r;
+        return krw_(Se, vgTerm_(params, Se));
     }
 
     /*!
@@ -303,31 +274,10 @@ public:
             Opm::decay<Evaluation>(fluidState.saturation(nonWettingPhaseIdx));
         const Evaluation& Sw =
             Opm::decay<Evaluation>(fluidState.saturation(wettingPhaseIdx));
-        Evaluation Swe = Opm::min((Sw - params.Swr()) / (1 - params.Swr()), 1.);
-        Evaluation Ste = Opm::min((Sw + Sn - params.Swr()) / (1 - params.Swr()), 1.);
+        const Evaluation& Swe =
+            regularizeKrnSaturation_(Evaluation((Sw - params.Swr()) / (1 - params.Swr())));
 
-        // regularization
-        if(Swe <= 0.0) Swe = 0.;
-        if(Ste <= 0.0) Ste = 0.;
-        if(Ste - Swe <= 0.0) return 0.;
-
-        Evaluation krn_;
-        krn_ = Opm::pow(1 - Opm::pow(Swe, 1/params.vgM()), params.vgM());
-        krn_ -= Opm::pow(1 - Opm::pow(Ste, 1/params.vgM()), params.vgM());
-        krn_ *= krn_;
-
-        if (params.krRegardsSnr())
-        {
-            // regard Snr in the permeability of the non-wetting
-            // phase, see Helmig1997
-            const Evaluation& resIncluded =
-                Opm::max(Opm::min(Sw - params.Snr() / (1-params.Swr()), 1.0), 0.0);
-            krn_ *= Opm::sqrt(resIncluded );
-        }
-        else
-            krn_ *= Opm::sqrt(Sn / (1 - params.Swr()));
-
-        return krn_;
+        return krn_(params, Sw, Sn, Swe, vgTerm_(params, Swe));
     }
 
 
@@ -346,6 +296,152 @@ public:
     {
         const Evaluation& Sg =
             Opm::decay<Evaluation>(fluidState.saturation(gasPhaseIdx));
+
+        return krg_(params, Sg);
+    }
+
+private:
+    template <class Evaluation>
+    static Evaluation pcgn_(const Params& params, const Evaluation& St)
+    {
+        Scalar PC_VG_REG = 0.01;
+
+        Evaluation Se = (St - params.Swrx())/(1. - params.Swrx());
+
+        // regularization
+        if (Se < 0.0)
+            Se=0.0;
+        if (Se > 1.0)
+            Se=1.0;
+
+        if (Se>PC_VG_REG && Se<1-PC_VG_REG)
+        {
+            const Evaluation& x = Opm::pow(Se,-1/params.vgM()) - 1;
+            return Opm::pow(x, 1.0 - params.vgM())/params.vgAlpha();
+        }
+
+        // value and derivative at regularization point
+        Scalar Se_regu;
+        if (Se<=PC_VG_REG)
+            Se_regu = PC_VG_REG;
+        else
+            Se_regu = 1-PC_VG_REG;
+        const Evaluation& x = std::pow(Se_regu,-1/params.vgM())-1;
+        const Evaluation& pc = Opm::pow(x, 1.0/params.vgN())/params.vgAlpha();
+        const Evaluation& pc_prime =
+            Opm::pow(x, 1/params.vgN()-1)
+            * std::pow(Se_regu,-1/params.vgM()-1)
+            / (-params.vgM())
+            / params.vgAlpha()
+            / (1 - params.Sgr() - params.Swrx())
+            / params.vgN();
+
+        // evaluate tangential
+        return ((Se-Se_regu)*pc_prime + pc)/params.betaGN();
+    }
+
+    template <class Evaluation>
+    static Evaluation pcnw_(const Params& params, const Evaluation& Sw)
+    {
+        Evaluation Se = (Sw-params.Swr())/(1.-params.Snr());
+
+        Scalar PC_VG_REG = 0.01;
+
+        // regularization
+        if (Se<0.0)
+            Se=0.0;
+        if (Se>1.0)
+            Se=1.0;
+
+        if (Se>PC_VG_REG && Se<1-PC_VG_REG) {
+            Evaluation x = Opm::pow(Se,-1/params.vgM()) - 1.0;
+            x = Opm::pow(x, 1 - params.vgM());
+            return x/params.vgAlpha();
+        }
+
+        // value and derivative at regularization point
+        Scalar Se_regu;
+        if (Se<=PC_VG_REG)
+            Se_regu = PC_VG_REG;
+        else
+            Se_regu = 1.0 - PC_VG_REG;
+
+        const Evaluation& x = std::pow(Se_regu,-1/params.vgM())-1;
+        const Evaluation& pc = Opm::pow(x, 1/params.vgN())/params.vgAlpha();
+        const Evaluation& pc_prime =
+            Opm::pow(x,1/params.vgN()-1)
+            * std::pow(Se_regu, -1.0/params.vgM() - 1)
+            / (-params.vgM())
+            / params.vgAlpha()
+            / (1-params.Snr()-params.Swr())
+            / params.vgN();
+
+        // evaluate tangential
+        return ((Se-Se_regu)*pc_prime + pc)/params.betaNW();
+    }
+
+    // the term (1 - Se^(1/m))^m which is used by the relative permeabilities of the
+    // liquid phases
+    template <class Evaluation>
+    static Evaluation vgTerm_(const Params& params, const Evaluation& Se)
+    { return Opm::pow(1 - Opm::pow(Se, 1/params.vgM()), params.vgM()); }
+
+    // regularize an effective saturation in the way expected by krn_()
+    template <class Evaluation>
+    static Evaluation regularizeKrnSaturation_(Evaluation Se)
+    {
+        Se = Opm::min(Se, 1.);
+        if(Se <= 0.0) Se = 0.;
+        return Se;
+    }
+
+    // vgTermSe must be vgTerm_(Se) if Se is within [0, 1]
+    template <class Evaluation>
+    static Evaluation krw_(const Evaluation& Se, const Evaluation& vgTermSe)
+    {
+        // regularization
+        if(Se > 1.0) return 1.;
+        if(Se < 0.0) return 0.;
+
+        const Evaluation& r = 1. - vgTermSe;
+        return Opm::sqrt(Se)*r*r;
+    }
+
+    // Swe must be regularized by regularizeKrnSaturation_() and vgTermW must be
+    // vgTerm_(Swe)
+    template <class Evaluation>
+    static Evaluation krn_(const Params& params,
+                           const Evaluation& Sw,
+                           const Evaluation& Sn,
+                           const Evaluation& Swe,
+                           const Evaluation& vgTermW)
+    {
+        const Evaluation& Ste =
+            regularizeKrnSaturation_(Evaluation((Sw + Sn - params.Swr()) / (1 - params.Swr())));
+
+        // regularization
+        if(Ste - Swe <= 0.0) return 0.;
+
+        Evaluation kr = vgTermW - vgTerm_(params, Ste);
+        kr *= kr;
+
+        if (params.krRegardsSnr())
+        {
+            // regard Snr in the permeability of the non-wetting
+            // phase, see Helmig1997
+            const Evaluation& resIncluded =
+                Opm::max(Opm::min(Sw - params.Snr() / (1-params.Swr()), 1.0), 0.0);
+            kr *= Opm::sqrt(resIncluded );
+        }
+        else
+            kr *= Opm::sqrt(Sn / (1 - params.Swr()));
+
+        return kr;
+    }
+
+    template <class Evaluation>
+    static Evaluation krg_(const Params& params, const Evaluation& Sg)
+    {
         const Evaluation& Se = Opm::min(((1-Sg) - params.Sgr()) / (1 - params.Sgr()), 1.);
 
         // regularization
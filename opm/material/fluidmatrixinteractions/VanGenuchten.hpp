@@ -193,7 +193,7 @@ public:
     template <class Evaluation>
     static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& Sw)
     {
-        return Opm::pow(Opm::pow(Sw, -1.0/params.vgM()) - 1, 1.0/params.vgN())/params.vgAlpha();
+        return Opm::pow(Opm::pow(Sw, -params.vgInvM()) - 1, params.vgInvN())/params.vgAlpha();
     }
 
     /*!
@@ -261,7 +261,7 @@ public:
     {
         assert(0.0 <= Sw && Sw <= 1.0);
 
-        Evaluation r = 1.0 - Opm::pow(1.0 - Opm::pow(Sw, 1/params.vgM()), params.vgM());
+        Evaluation r = 1.0 - Opm::pow(1.0 - Opm::pow(Sw, params.vgInvM()), params.vgM());
         return Opm::sqrt(Sw)*r*r;
     }
 
@@ -290,7 +290,7 @@ public:
 
         return
             Opm::pow(1 - Sw, 1.0/3) *
-            Opm::pow(1 - Opm::pow(Sw, 1/params.vgM()), 2*params.vgM());
+            Opm::pow(1 - Opm::pow(Sw, params.vgInvM()), 2*params.vgM());
     }
 };
 } // namespace Opm
@@ -48,8 +48,6 @@ class VanGenuchtenParams : public EnsureFinalized
     typedef typename TraitsT::Scalar Scalar;
 
 public:
-    using EnsureFinalized :: finalize;
-
     typedef TraitsT Traits;
 
     VanGenuchtenParams()
@@ -63,6 +61,33 @@ public:
         finalize();
     }
 
+    /*!
+     * \brief Calculate all dependent quantities once the independent
+     *        quantities of the parameter object have been set.
+     */
+    void finalize()
+    {
+        vgInvM_ = 1/vgM_;
+        vgInvN_ = 1/vgN_;
+
+        EnsureFinalized::finalize();
+    }
+
+    /*!
+     * \brief Returns true if the independent quantities of two parameter
+     *        objects are identical.
+     */
+    bool operator==(const VanGenuchtenParams& other) const
+    {
+        return
+            vgAlpha_ == other.vgAlpha_
+            && vgM_ == other.vgM_
+            && vgN_ == other.vgN_;
+    }
+
+    bool operator!=(const VanGenuchtenParams& other) const
+    { return !(*this == other); }
+
     /*!
      * \brief Return the \f$\alpha\f$ shape parameter of van Genuchten's
      *        curve.
@@ -109,10 +134,25 @@ public:
     void setVgN(Scalar n)
     { vgN_ = n; vgM_ = 1 - 1/vgN_; }
 
+    /*!
+     * \brief Return \f$1/m\f$.
+     */
+    Scalar vgInvM() const
+    { EnsureFinalized::check(); return vgInvM_; }
+
+    /*!
+     * \brief Return \f$1/n\f$.
+     */
+    Scalar vgInvN() const
+    { EnsureFinalized::check(); return vgInvN_; }
+
 private:
     Scalar vgAlpha_;
     Scalar vgM_;
     Scalar vgN_;
+
+    Scalar vgInvM_;
+    Scalar vgInvN_;
 };
 } // namespace Opm
 
@@ -0,0 +1,400 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::BlackOilFluidState
+ */
+#ifndef OPM_BLACK_OIL_FLUID_STATE_HPP
+#define OPM_BLACK_OIL_FLUID_STATE_HPP
+
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <opm/common/Valgrind.hpp>
+#include <opm/common/Exceptions.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+namespace Opm {
+
+/*!
+ * \brief A fluid state which only stores the quantities of the black-oil model.
+ *
+ * In contrast to the generic fluid states, the composition of the phases is not
+ * stored as mole fractions. Instead, the gas dissolution factor \f$R_s\f$ and the oil
+ * vaporization factor \f$R_v\f$ are stored and the mass and mole fractions are computed
+ * from them on demand. Since the black-oil fluid system uses the \f$R_s\f$ and
+ * \f$R_v\f$ methods of fluid states which provide them, it does not need to convert
+ * the composition back. Fugacities and enthalpies are not stored at all because the
+ * black-oil model is isothermal and does not need them. In addition, the inverse
+ * formation volume factors of the phases can be stored alongside the densities and the
+ * viscosities.
+ *
+ * Compared to Opm::CompositionalFluidState, this reduces the number of stored values
+ * from 40 to 18, which is noticeable if the scalar type is a function evaluation.
+ *
+ * \tparam ScalarT The type used for scalar values
+ * \tparam FluidSystem The black-oil fluid system
+ */
+template <class ScalarT, class FluidSystem>
+class BlackOilFluidState
+{
+    enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
+    enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+    enum { waterCompIdx = FluidSystem::waterCompIdx };
+    enum { oilCompIdx = FluidSystem::oilCompIdx };
+    enum { gasCompIdx = FluidSystem::gasCompIdx };
+
+public:
+    typedef ScalarT Scalar;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    BlackOilFluidState()
+        : pvtRegionIdx_(0)
+    {
+        Valgrind::SetUndefined(pressure_);
+        Valgrind::SetUndefined(temperature_);
+        Valgrind::SetUndefined(saturation_);
+        Valgrind::SetUndefined(Rs_);
+        Valgrind::SetUndefined(Rv_);
+        Valgrind::SetUndefined(invB_);
+        Valgrind::SetUndefined(density_);
+        Valgrind::SetUndefined(viscosity_);
+    }
+
+    /*!
+     * \brief Make sure that all attributes are defined.
+     *
+     * This method does not do anything if the program is not run
+     * under valgrind. If it is, then valgrind will print an error
+     * message if some attributes of the object have not been properly
+     * defined.
+     */
+    void checkDefined() const
+    {
+        Valgrind::CheckDefined(pvtRegionIdx_);
+        Valgrind::CheckDefined(pressure_);
+        Valgrind::CheckDefined(temperature_);
+        Valgrind::CheckDefined(saturation_);
+        Valgrind::CheckDefined(Rs_);
+        Valgrind::CheckDefined(Rv_);
+        Valgrind::CheckDefined(invB_);
+        Valgrind::CheckDefined(density_);
+        Valgrind::CheckDefined(viscosity_);
+    }
+
+    /*!
+     * \brief Retrieve all parameters from an arbitrary fluid state.
+     *
+     * The dissolution factors are determined using the fluid system and the inverse
+     * formation volume factors are computed from the densities. The PVT region index
+     * of this object must already be set.
+     */
+    template <class FluidState>
+    void assign(const FluidState& fs)
+    {
+        temperature_ = Opm::decay<Scalar>(fs.temperature(/*phaseIdx=*/0));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            pressure_[phaseIdx] = Opm::decay<Scalar>(fs.pressure(phaseIdx));
+            saturation_[phaseIdx] = Opm::decay<Scalar>(fs.saturation(phaseIdx));
+            density_[phaseIdx] = Opm::decay<Scalar>(fs.density(phaseIdx));
+            viscosity_[phaseIdx] = Opm::decay<Scalar>(fs.viscosity(phaseIdx));
+        }
+
+        Rs_ = 0.0;
+        Rv_ = 0.0;
+        if (FluidSystem::enableDissolvedGas())
+            Rs_ = Opm::BlackOil::template getRs_<FluidSystem, Scalar, FluidState>(fs, pvtRegionIdx_);
+        if (FluidSystem::enableVaporizedOil())
+            Rv_ = Opm::BlackOil::template getRv_<FluidSystem, Scalar, FluidState>(fs, pvtRegionIdx_);
+
+        // invert the relation between the inverse formation volume factors and the
+        // densities used by the fluid system
+        const Scalar rhoRefW = FluidSystem::referenceDensity(waterPhaseIdx, pvtRegionIdx_);
+        const Scalar rhoRefO = FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx_);
+        const Scalar rhoRefG = FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx_);
+        invB_[waterPhaseIdx] = density_[waterPhaseIdx]/rhoRefW;
+        invB_[oilPhaseIdx] = density_[oilPhaseIdx]/(rhoRefO + Rs_*rhoRefG);
+        invB_[gasPhaseIdx] = density_[gasPhaseIdx]/(rhoRefG + Rv_*rhoRefO);
+    }
+
+    /*!
+     * \brief Return the index of the PVT region which is used to convert the
+     *        dissolution factors to mass and mole fractions.
+     */
+    unsigned pvtRegionIndex() const
+    { return pvtRegionIdx_; }
+
+    /*!
+     * \brief Set the index of the PVT region.
+     */
+    void setPvtRegionIndex(unsigned value)
+    { pvtRegionIdx_ = static_cast<unsigned short>(value); }
+
+    /*!
+     * \brief The pressure of a fluid phase [Pa]
+     */
+    const Scalar& pressure(unsigned phaseIdx) const
+    { return pressure_[phaseIdx]; }
+
+    /*!
+     * \brief Set the pressure of a phase [Pa]
+     */
+    void setPressure(unsigned phaseIdx, const Scalar& value)
+    { pressure_[phaseIdx] = value; }
+
+    /*!
+     * \brief The temperature of a fluid phase [K]
+     *
+     * All phases exhibit the same temperature.
+     */
+    const Scalar& temperature(unsigned /*phaseIdx*/) const
+    { return temperature_; }
+
+    /*!
+     * \brief Set the temperature of all phases [K]
+     */
+    void setTemperature(const Scalar& value)
+    { temperature_ = value; }
+
+    /*!
+     * \brief The saturation of a fluid phase [-]
+     */
+    const Scalar& saturation(unsigned phaseIdx) const
+    { return saturation_[phaseIdx]; }
+
+    /*!
+     * \brief Returns true iff a fluid phase shall be assumed to be present.
+     */
+    bool phaseIsPresent(unsigned phaseIdx) const
+    { return saturation_[phaseIdx] > 0.0; }
+
+    /*!
+     * \brief Set the saturation of a phase [-]
+     */
+    void setSaturation(unsigned phaseIdx, const Scalar& value)
+    { saturation_[phaseIdx] = value; }
+
+    /*!
+     * \brief The gas dissolution factor of the oil phase [m^3/m^3]
+     */
+    const Scalar& Rs() const
+    { return Rs_; }
+
+    /*!
+     * \brief Set the gas dissolution factor of the oil phase [m^3/m^3]
+     */
+    void setRs(const Scalar& value)
+    { Rs_ = value; }
+
+    /*!
+     * \brief The oil vaporization factor of the gas phase [m^3/m^3]
+     */
+    const Scalar& Rv() const
+    { return Rv_; }
+
+    /*!
+     * \brief Set the oil vaporization factor of the gas phase [m^3/m^3]
+     */
+    void setRv(const Scalar& value)
+    { Rv_ = value; }
+
+    /*!
+     * \brief The inverse formation volume factor of a fluid phase [-]
+     */
+    const Scalar& invB(unsigned phaseIdx) const
+    { return invB_[phaseIdx]; }
+
+    /*!
+     * \brief Set the inverse formation volume factor of a fluid phase [-]
+     */
+    void setInvB(unsigned phaseIdx, const Scalar& value)
+    { invB_[phaseIdx] = value; }
+
+    /*!
+     * \brief The density of a fluid phase [kg/m^3]
+     */
+    const Scalar& density(unsigned phaseIdx) const
+    { return density_[phaseIdx]; }
+
+    /*!
+     * \brief Set the density of a phase [kg/m^3]
+     */
+    void setDensity(unsigned phaseIdx, const Scalar& value)
+    { density_[phaseIdx] = value; }
+
+    /*!
+     * \brief The dynamic viscosity of a fluid phase [Pa s]
+     */
+    const Scalar& viscosity(unsigned phaseIdx) const
+    { return viscosity_[phaseIdx]; }
+
+    /*!
+     * \brief Set the dynamic viscosity of a phase [Pa s]
+     */
+    void setViscosity(unsigned phaseIdx, const Scalar& value)
+    { viscosity_[phaseIdx] = value; }
+
+    /*!
+     * \brief The mass fraction of a component in a phase []
+     *
+     * This is computed from the dissolution factors.
+     */
+    Scalar massFraction(unsigned phaseIdx, unsigned compIdx) const
+    {
+        switch (phaseIdx) {
+        case waterPhaseIdx:
+            return (compIdx == waterCompIdx)?1.0:0.0;
+
+        case oilPhaseIdx: {
+            const Scalar& XoG = oilMassFractionGas_();
+            if (compIdx == gasCompIdx)
+                return XoG;
+            return (compIdx == oilCompIdx)?(1.0 - XoG):Scalar(0.0);
+        }
+
+        case gasPhaseIdx: {
+            const Scalar& XgO = gasMassFractionOil_();
+            if (compIdx == oilCompIdx)
+                return XgO;
+            return (compIdx == gasCompIdx)?(1.0 - XgO):Scalar(0.0);
+        }
+        }
+
+        OPM_THROW(std::logic_error, "Invalid phase index " << phaseIdx);
+    }
+
+    /*!
+     * \brief The mole fraction of a component in a phase []
+     *
+     * This is computed from the dissolution factors.
+     */
+    Scalar moleFraction(unsigned phaseIdx, unsigned compIdx) const
+    {
+        switch (phaseIdx) {
+        case waterPhaseIdx:
+            return (compIdx == waterCompIdx)?1.0:0.0;
+
+        case oilPhaseIdx: {
+            const Scalar& xoG = FluidSystem::convertXoGToxoG(oilMassFractionGas_(), pvtRegionIdx_);
+            if (compIdx == gasCompIdx)
+                return xoG;
+            return (compIdx == oilCompIdx)?(1.0 - xoG):Scalar(0.0);
+        }
+
+        case gasPhaseIdx: {
+            const Scalar& xgO = FluidSystem::convertXgOToxgO(gasMassFractionOil_(), pvtRegionIdx_);
+            if (compIdx == oilCompIdx)
+                return xgO;
+            return (compIdx == gasCompIdx)?(1.0 - xgO):Scalar(0.0);
+        }
+        }
+
+        OPM_THROW(std::logic_error, "Invalid phase index " << phaseIdx);
+    }
+
+    /*!
+     * \brief The average molar mass of a fluid phase [kg/mol]
+     */
+    Scalar averageMolarMass(unsigned phaseIdx) const
+    {
+        Scalar result = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            result += moleFraction(phaseIdx, compIdx)*FluidSystem::molarMass(compIdx, pvtRegionIdx_);
+        return result;
+    }
+
+    /*!
+     * \brief The molar concentration of a component in a phase [mol/m^3]
+     */
+    Scalar molarity(unsigned phaseIdx, unsigned compIdx) const
+    { return molarDensity(phaseIdx)*moleFraction(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The molar density of a fluid phase [mol/m^3]
+     */
+    Scalar molarDensity(unsigned phaseIdx) const
+    { return density_[phaseIdx]/averageMolarMass(phaseIdx); }
+
+    /*!
+     * \brief The molar volume of a fluid phase [m^3/mol]
+     */
+    Scalar molarVolume(unsigned phaseIdx) const
+    { return 1.0/molarDensity(phaseIdx); }
+
+    /*!
+     * \brief The fugacity coefficient of a component in a phase []
+     */
+    const Scalar& fugacityCoefficient(unsigned /* phaseIdx */, unsigned /* compIdx */) const
+    { OPM_THROW(std::logic_error, "Fugacity coefficients are not provided by the black-oil fluid state"); }
+
+    /*!
+     * \brief The fugacity of a component in a phase [Pa]
+     */
+    const Scalar& fugacity(unsigned /* phaseIdx */, unsigned /* compIdx */) const
+    { OPM_THROW(std::logic_error, "Fugacities are not provided by the black-oil fluid state"); }
+
+    /*!
+     * \brief The specific enthalpy of a fluid phase [J/kg]
+     */
+    const Scalar& enthalpy(unsigned /* phaseIdx */) const
+    { OPM_THROW(std::logic_error, "Enthalpies are not provided by the black-oil fluid state"); }
+
+    /*!
+     * \brief The specific internal energy of a fluid phase [J/kg]
+     */
+    const Scalar& internalEnergy(unsigned /* phaseIdx */) const
+    { OPM_THROW(std::logic_error, "Internal energies are not provided by the black-oil fluid state"); }
+
+private:
+    Scalar oilMassFractionGas_() const
+    {
+        if (!FluidSystem::enableDissolvedGas())
+            return 0.0;
+        return FluidSystem::convertRsToXoG(Rs_, pvtRegionIdx_);
+    }
+
+    Scalar gasMassFractionOil_() const
+    {
+        if (!FluidSystem::enableVaporizedOil())
+            return 0.0;
+        return FluidSystem::convertRvToXgO(Rv_, pvtRegionIdx_);
+    }
+
+    Scalar pressure_[numPhases];
+    Scalar temperature_;
+    Scalar saturation_[numPhases];
+    Scalar Rs_;
+    Scalar Rv_;
+    Scalar invB_[numPhases];
+    Scalar density_[numPhases];
+    Scalar viscosity_[numPhases];
+    unsigned short pvtRegionIdx_;
+};
+
+} // namespace Opm
+
+#endif
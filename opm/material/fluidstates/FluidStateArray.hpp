@@ -0,0 +1,376 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::FluidStateArray
+ */
+#ifndef OPM_FLUID_STATE_ARRAY_HPP
+#define OPM_FLUID_STATE_ARRAY_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+#include <opm/common/Valgrind.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Stores the thermodynamic state of the fluids in a set of cells.
+ *
+ * Storing an array of CompositionalFluidState objects places all quantities of a cell
+ * next to each other. This container instead stores each quantity (e.g., the pressure of
+ * a given phase) contiguously for all cells, which is the layout that is desirable if
+ * a single quantity is processed for many cells at once. The raw arrays of the
+ * individual quantities can be accessed by the *Data() methods.
+ *
+ * The state of an individual cell is accessed via lightweight view objects which are
+ * returned by operator[]. They satisfy the same fluid state API as
+ * CompositionalFluidState, i.e., they can be passed to material laws, fluid systems
+ * and constraint solvers unchanged. The views only refer to the container, so they
+ * are invalidated if it is resized.
+ *
+ * The temperature is assumed to be the same for all phases of a cell.
+ *
+ * \tparam ScalarT The type used for the quantities
+ * \tparam FluidSystem The fluid system whose phases and components are stored
+ */
+template <class ScalarT, class FluidSystem>
+class FluidStateArray
+{
+public:
+    typedef ScalarT Scalar;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    /*!
+     * \brief A read-only view of the fluid state of a single cell.
+     */
+    class ConstCellView
+    {
+    public:
+        typedef ScalarT Scalar;
+        enum { numPhases = FluidSystem::numPhases };
+        enum { numComponents = FluidSystem::numComponents };
+
+        ConstCellView(const FluidStateArray& array, std::size_t cellIdx)
+            : array_(&array)
+            , cellIdx_(cellIdx)
+        { assert(cellIdx < array.numCells()); }
+
+        /*!
+         * \brief The index of the cell which is represented by the view.
+         */
+        std::size_t cellIndex() const
+        { return cellIdx_; }
+
+        const Scalar& temperature(unsigned /*phaseIdx*/) const
+        { return array_->temperature_[cellIdx_]; }
+
+        const Scalar& pressure(unsigned phaseIdx) const
+        { return array_->pressure_[array_->phaseIdx_(phaseIdx, cellIdx_)]; }
+
+        const Scalar& saturation(unsigned phaseIdx) const
+        { return array_->saturation_[array_->phaseIdx_(phaseIdx, cellIdx_)]; }
+
+        bool phaseIsPresent(unsigned phaseIdx) const
+        { return saturation(phaseIdx) > 0.0; }
+
+        const Scalar& moleFraction(unsigned phaseIdx, unsigned compIdx) const
+        { return array_->moleFraction_[array_->compIdx_(phaseIdx, compIdx, cellIdx_)]; }
+
+        Scalar massFraction(unsigned phaseIdx, unsigned compIdx) const
+        {
+            return
+                Opm::abs(sumMoleFractions_(phaseIdx))
+                *moleFraction(phaseIdx, compIdx)
+                *FluidSystem::molarMass(compIdx)
+                / Opm::max(1e-40, Opm::abs(averageMolarMass(phaseIdx)));
+        }
+
+        const Scalar& averageMolarMass(unsigned phaseIdx) const
+        { return array_->averageMolarMass_[array_->phaseIdx_(phaseIdx, cellIdx_)]; }
+
+        Scalar molarity(unsigned phaseIdx, unsigned compIdx) const
+        { return molarDensity(phaseIdx)*moleFraction(phaseIdx, compIdx); }
+
+        const Scalar& fugacityCoefficient(unsigned phaseIdx, unsigned compIdx) const
+        { return array_->fugacityCoefficient_[array_->compIdx_(phaseIdx, compIdx, cellIdx_)]; }
+
+        Scalar fugacity(unsigned phaseIdx, unsigned compIdx) const
+        { return pressure(phaseIdx)*fugacityCoefficient(phaseIdx, compIdx)*moleFraction(phaseIdx, compIdx); }
+
+        const Scalar& density(unsigned phaseIdx) const
+        { return array_->density_[array_->phaseIdx_(phaseIdx, cellIdx_)]; }
+
+        Scalar molarDensity(unsigned phaseIdx) const
+        { return density(phaseIdx)/averageMolarMass(phaseIdx); }
+
+        Scalar molarVolume(unsigned phaseIdx) const
+        { return 1/molarDensity(phaseIdx); }
+
+        const Scalar& viscosity(unsigned phaseIdx) const
+        { return array_->viscosity_[array_->phaseIdx_(phaseIdx, cellIdx_)]; }
+
+        const Scalar& enthalpy(unsigned phaseIdx) const
+        { return array_->enthalpy_[array_->phaseIdx_(phaseIdx, cellIdx_)]; }
+
+        Scalar internalEnergy(unsigned phaseIdx) const
+        { return enthalpy(phaseIdx) - pressure(phaseIdx)/density(phaseIdx); }
+
+        /*!
+         * \brief Make sure that all attributes are defined.
+         *
+         * This method does not do anything if the program is not run
+         * under valgrind. If it is, then valgrind will print an error
+         * message if some attributes of the cell have not been properly
+         * defined.
+         */
+        void checkDefined() const
+        {
+            Valgrind::CheckDefined(temperature(0));
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                Valgrind::CheckDefined(pressure(phaseIdx));
+                Valgrind::CheckDefined(saturation(phaseIdx));
+                Valgrind::CheckDefined(averageMolarMass(phaseIdx));
+                Valgrind::CheckDefined(density(phaseIdx));
+                Valgrind::CheckDefined(viscosity(phaseIdx));
+                Valgrind::CheckDefined(enthalpy(phaseIdx));
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                    Valgrind::CheckDefined(moleFraction(phaseIdx, compIdx));
+            }
+        }
+
+    protected:
+        const Scalar& sumMoleFractions_(unsigned phaseIdx) const
+        { return array_->sumMoleFractions_[array_->phaseIdx_(phaseIdx, cellIdx_)]; }
+
+        const FluidStateArray* array_;
+        std::size_t cellIdx_;
+    };
+
+    /*!
+     * \brief A view of the fluid state of a single cell which also allows to modify it.
+     */
+    class CellView : public ConstCellView
+    {
+        using ConstCellView::cellIdx_;
+
+    public:
+        CellView(FluidStateArray& array, std::size_t cellIdx)
+            : ConstCellView(array, cellIdx)
+        { }
+
+        void setTemperature(const Scalar& value)
+        { mutableArray_()->temperature_[cellIdx_] = value; }
+
+        void setPressure(unsigned phaseIdx, const Scalar& value)
+        { mutableArray_()->pressure_[mutableArray_()->phaseIdx_(phaseIdx, cellIdx_)] = value; }
+
+        void setSaturation(unsigned phaseIdx, const Scalar& value)
+        { mutableArray_()->saturation_[mutableArray_()->phaseIdx_(phaseIdx, cellIdx_)] = value; }
+
+        /*!
+         * \brief Set the mole fraction of a component in a phase []
+         *        and update the average molar mass [kg/mol] according
+         *        to the current composition of the phase
+         */
+        void setMoleFraction(unsigned phaseIdx, unsigned compIdx, const Scalar& value)
+        {
+            Valgrind::CheckDefined(value);
+            mutableArray_()->moleFraction_[mutableArray_()->compIdx_(phaseIdx, compIdx, cellIdx_)] = value;
+            updateAverageMolarMass_(phaseIdx);
+        }
+
+        /*!
+         * \brief Set the mole fractions of all components in a phase []
+         *        and update the average molar mass [kg/mol] of the phase
+         */
+        template <class MoleFractionVector>
+        void setMoleFractions(unsigned phaseIdx, const MoleFractionVector& values)
+        {
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                Valgrind::CheckDefined(values[compIdx]);
+                mutableArray_()->moleFraction_[mutableArray_()->compIdx_(phaseIdx, compIdx, cellIdx_)] = values[compIdx];
+            }
+            updateAverageMolarMass_(phaseIdx);
+        }
+
+        void setFugacityCoefficient(unsigned phaseIdx, unsigned compIdx, const Scalar& value)
+        { mutableArray_()->fugacityCoefficient_[mutableArray_()->compIdx_(phaseIdx, compIdx, cellIdx_)] = value; }
+
+        void setDensity(unsigned phaseIdx, const Scalar& value)
+        { mutableArray_()->density_[mutableArray_()->phaseIdx_(phaseIdx, cellIdx_)] = value; }
+
+        void setViscosity(unsigned phaseIdx, const Scalar& value)
+        { mutableArray_()->viscosity_[mutableArray_()->phaseIdx_(phaseIdx, cellIdx_)] = value; }
+
+        void setEnthalpy(unsigned phaseIdx, const Scalar& value)
+        { mutableArray_()->enthalpy_[mutableArray_()->phaseIdx_(phaseIdx, cellIdx_)] = value; }
+
+        /*!
+         * \brief Retrieve all parameters from an arbitrary fluid
+         *        state.
+         */
+        template <class FluidState>
+        void assign(const FluidState& fs)
+        {
+            setTemperature(Opm::decay<Scalar>(fs.temperature(/*phaseIdx=*/0)));
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                setPressure(phaseIdx, Opm::decay<Scalar>(fs.pressure(phaseIdx)));
+                setSaturation(phaseIdx, Opm::decay<Scalar>(fs.saturation(phaseIdx)));
+                setDensity(phaseIdx, Opm::decay<Scalar>(fs.density(phaseIdx)));
+                setViscosity(phaseIdx, Opm::decay<Scalar>(fs.viscosity(phaseIdx)));
+                setEnthalpy(phaseIdx, Opm::decay<Scalar>(fs.enthalpy(phaseIdx)));
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                    mutableArray_()->moleFraction_[mutableArray_()->compIdx_(phaseIdx, compIdx, cellIdx_)] =
+                        Opm::decay<Scalar>(fs.moleFraction(phaseIdx, compIdx));
+                    setFugacityCoefficient(phaseIdx, compIdx,
+                                           Opm::decay<Scalar>(fs.fugacityCoefficient(phaseIdx, compIdx)));
+                }
+                updateAverageMolarMass_(phaseIdx);
+            }
+        }
+
+    private:
+        // the view was created from a non-const container
+        FluidStateArray* mutableArray_() const
+        { return const_cast<FluidStateArray*>(ConstCellView::array_); }
+
+        void updateAverageMolarMass_(unsigned phaseIdx)
+        {
+            FluidStateArray& a = *mutableArray_();
+            std::size_t idx = a.phaseIdx_(phaseIdx, cellIdx_);
+            a.sumMoleFractions_[idx] = 0.0;
+            a.averageMolarMass_[idx] = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const Scalar& x = a.moleFraction_[a.compIdx_(phaseIdx, compIdx, cellIdx_)];
+                a.sumMoleFractions_[idx] += x;
+                a.averageMolarMass_[idx] += x*FluidSystem::molarMass(compIdx);
+            }
+        }
+    };
+
+    explicit FluidStateArray(std::size_t numCells = 0)
+    { resize(numCells); }
+
+    /*!
+     * \brief Change the number of cells.
+     *
+     * This invalidates all views and the pointers to the raw data.
+     */
+    void resize(std::size_t numCells)
+    {
+        numCells_ = numCells;
+
+        temperature_.resize(numCells);
+        pressure_.resize(numPhases*numCells);
+        saturation_.resize(numPhases*numCells);
+        averageMolarMass_.resize(numPhases*numCells);
+        sumMoleFractions_.resize(numPhases*numCells);
+        density_.resize(numPhases*numCells);
+        viscosity_.resize(numPhases*numCells);
+        enthalpy_.resize(numPhases*numCells);
+        moleFraction_.resize(numPhases*numComponents*numCells);
+        fugacityCoefficient_.resize(numPhases*numComponents*numCells);
+    }
+
+    /*!
+     * \brief The number of cells for which the fluid state is stored.
+     */
+    std::size_t numCells() const
+    { return numCells_; }
+
+    /*!
+     * \brief Return a view of the fluid state of a cell.
+     */
+    CellView operator[](std::size_t cellIdx)
+    { return CellView(*this, cellIdx); }
+
+    /*!
+     * \brief Return a read-only view of the fluid state of a cell.
+     */
+    ConstCellView operator[](std::size_t cellIdx) const
+    { return ConstCellView(*this, cellIdx); }
+
+    /*!
+     * \brief The temperatures of all cells.
+     */
+    const Scalar* temperatureData() const
+    { return temperature_.data(); }
+
+    /*!
+     * \brief The pressures of a phase for all cells.
+     */
+    const Scalar* pressureData(unsigned phaseIdx) const
+    { return &pressure_[phaseIdx_(phaseIdx, 0)]; }
+
+    /*!
+     * \brief The saturations of a phase for all cells.
+     */
+    const Scalar* saturationData(unsigned phaseIdx) const
+    { return &saturation_[phaseIdx_(phaseIdx, 0)]; }
+
+    /*!
+     * \brief The mole fractions of a component in a phase for all cells.
+     */
+    const Scalar* moleFractionData(unsigned phaseIdx, unsigned compIdx) const
+    { return &moleFraction_[compIdx_(phaseIdx, compIdx, 0)]; }
+
+    /*!
+     * \brief The densities of a phase for all cells.
+     */
+    const Scalar* densityData(unsigned phaseIdx) const
+    { return &density_[phaseIdx_(phaseIdx, 0)]; }
+
+    /*!
+     * \brief The viscosities of a phase for all cells.
+     */
+    const Scalar* viscosityData(unsigned phaseIdx) const
+    { return &viscosity_[phaseIdx_(phaseIdx, 0)]; }
+
+private:
+    std::size_t phaseIdx_(unsigned phaseIdx, std::size_t cellIdx) const
+    { return phaseIdx*numCells_ + cellIdx; }
+
+    std::size_t compIdx_(unsigned phaseIdx, unsigned compIdx, std::size_t cellIdx) const
+    { return (phaseIdx*numComponents + compIdx)*numCells_ + cellIdx; }
+
+    std::size_t numCells_;
+
+    std::vector<Scalar> temperature_;
+    std::vector<Scalar> pressure_;
+    std::vector<Scalar> saturation_;
+    std::vector<Scalar> averageMolarMass_;
+    std::vector<Scalar> sumMoleFractions_;
+    std::vector<Scalar> density_;
+    std::vector<Scalar> viscosity_;
+    std::vector<Scalar> enthalpy_;
+    std::vector<Scalar> moleFraction_;
+    std::vector<Scalar> fugacityCoefficient_;
+};
+
+} // namespace Opm
+
+#endif
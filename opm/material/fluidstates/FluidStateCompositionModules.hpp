@@ -127,6 +127,34 @@ public:
         }
     }
 
+    /*!
+     * \brief Set the mole fractions of all components in a phase []
+     *        and update the average molar mass [kg/mol] of the phase
+     *
+     * This yields the same result as calling setMoleFraction() for
+     * each component, but the average molar mass and the sum of the
+     * mole fractions are only computed once, i.e., it is linear
+     * instead of quadratic in the number of components.
+     *
+     * \param phaseIdx The index of the phase
+     * \param values The mole fractions of all components. This can
+     *               be any object which provides them via operator[],
+     *               e.g. an array or a Dune::FieldVector.
+     */
+    template <class MoleFractionVector>
+    void setMoleFractions(unsigned phaseIdx, const MoleFractionVector& values)
+    {
+        sumMoleFractions_[phaseIdx] = 0.0;
+        averageMolarMass_[phaseIdx] = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Valgrind::CheckDefined(values[compIdx]);
+            moleFraction_[phaseIdx][compIdx] = values[compIdx];
+
+            sumMoleFractions_[phaseIdx] += moleFraction_[phaseIdx][compIdx];
+            averageMolarMass_[phaseIdx] += moleFraction_[phaseIdx][compIdx]*FluidSystem::molarMass(compIdx);
+        }
+    }
+
     /*!
      * \brief Retrieve all parameters from an arbitrary fluid
      *        state.
@@ -107,6 +107,127 @@ protected:
     Scalar density_[numPhases];
 };
 
+/*!
+ * \brief Module for the modular fluid state which computes the densities
+ *        on demand.
+ *
+ * The density of a phase is calculated by the fluid system when it is accessed for
+ * the first time and it is memoized afterwards. Thus, the densities of phases which
+ * are never looked at do not cost anything. Since the module does not know when the
+ * quantities which the density depends on are modified, invalidateDensities() must be
+ * called after changing the pressure, the temperature or the composition of the
+ * fluid state. The parameter cache which is passed to the fluid system must outlive
+ * the fluid state or be replaced by calling setDensityParameterCache() again.
+ */
+template <class Scalar,
+          class FluidSystem,
+          class Implementation>
+class FluidStateLazyDensityModule
+{
+    enum { numPhases = FluidSystem::numPhases };
+
+public:
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+
+    FluidStateLazyDensityModule()
+        : paramCache_(nullptr)
+    {
+        Valgrind::SetUndefined(density_);
+        invalidateDensities();
+    }
+
+    /*!
+     * \brief Set the parameter cache which is used to compute the densities.
+     *
+     * This invalidates all densities which have been computed so far.
+     */
+    void setDensityParameterCache(const ParameterCache& paramCache)
+    {
+        paramCache_ = &paramCache;
+        invalidateDensities();
+    }
+
+    /*!
+     * \brief The density of a fluid phase [kg/m^3]
+     */
+    const Scalar& density(unsigned phaseIdx) const
+    {
+        if (!densityIsValid_[phaseIdx]) {
+            if (!paramCache_)
+                OPM_THROW(std::logic_error,
+                          "The parameter cache must be set before the density can be computed");
+
+            density_[phaseIdx] = FluidSystem::density(asImp_(), *paramCache_, phaseIdx);
+            densityIsValid_[phaseIdx] = true;
+        }
+
+        return density_[phaseIdx];
+    }
+
+    /*!
+     * \brief The molar density of a fluid phase [mol/m^3]
+     */
+    Scalar molarDensity(unsigned phaseIdx) const
+    { return density(phaseIdx)/asImp_().averageMolarMass(phaseIdx); }
+
+    /*!
+     * \brief The molar volume of a fluid phase [m^3/mol]
+     */
+    Scalar molarVolume(unsigned phaseIdx) const
+    { return 1/molarDensity(phaseIdx); }
+
+    /*!
+     * \brief Set the density of a phase [kg/m^3]
+     *
+     * The value is used until the densities are invalidated.
+     */
+    void setDensity(unsigned phaseIdx, const Scalar& value)
+    {
+        density_[phaseIdx] = value;
+        densityIsValid_[phaseIdx] = true;
+    }
+
+    /*!
+     * \brief Discard the memoized densities of all phases.
+     */
+    void invalidateDensities()
+    { std::fill(densityIsValid_, densityIsValid_ + numPhases, false); }
+
+    /*!
+     * \brief Retrieve all parameters from an arbitrary fluid
+     *        state.
+     */
+    template <class FluidState>
+    void assign(const FluidState& fs)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            setDensity(phaseIdx, Opm::decay<Scalar>(fs.density(phaseIdx)));
+    }
+
+    /*!
+     * \brief Make sure that all attributes are defined.
+     *
+     * This method does not do anything if the program is not run
+     * under valgrind. If it is, then valgrind will print an error
+     * message if some of the densities which have already been
+     * computed are not properly defined.
+     */
+    void checkDefined() const
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (densityIsValid_[phaseIdx])
+                Valgrind::CheckDefined(density_[phaseIdx]);
+    }
+
+protected:
+    const Implementation& asImp_() const
+    { return *static_cast<const Implementation*>(this); }
+
+    const ParameterCache* paramCache_;
+    mutable Scalar density_[numPhases];
+    mutable bool densityIsValid_[numPhases];
+};
+
 /*!
  * \brief Module for the modular fluid state which does not  the
  *        densities but throws std::logic_error instead.
@@ -28,6 +28,7 @@
 #ifndef OPM_FLUID_STATE_FUGACITY_MODULES_HPP
 #define OPM_FLUID_STATE_FUGACITY_MODULES_HPP
 
+#include <opm/material/common/MathToolbox.hpp>
 #include <opm/common/Valgrind.hpp>
 
 #include <opm/common/ErrorMacros.hpp>
@@ -81,7 +82,8 @@ public:
     {
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                fugacityCoefficient_[phaseIdx][compIdx] = fs.fugacityCoefficient(phaseIdx, compIdx);
+                fugacityCoefficient_[phaseIdx][compIdx] =
+                    Opm::decay<Scalar>(fs.fugacityCoefficient(phaseIdx, compIdx));
             }
         }
     }
@@ -149,7 +151,8 @@ public:
     void assign(const FluidState& fs)
     {
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            fugacityCoefficient_[phaseIdx] = fs.fugacityCoefficient(phaseIdx, /*compIdx=*/phaseIdx);
+            fugacityCoefficient_[phaseIdx] =
+                Opm::decay<Scalar>(fs.fugacityCoefficient(phaseIdx, /*compIdx=*/phaseIdx));
         }
     }
 
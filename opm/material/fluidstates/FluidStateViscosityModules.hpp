@@ -91,6 +91,112 @@ protected:
     Scalar viscosity_[numPhases];
 };
 
+/*!
+ * \brief Module for the modular fluid state which computes the viscosities
+ *        on demand.
+ *
+ * The viscosity of a phase is calculated by the fluid system when it is accessed for
+ * the first time and it is memoized afterwards. Like for
+ * FluidStateLazyDensityModule, invalidateViscosities() must be called after the
+ * quantities which the viscosity depends on have been modified.
+ */
+template <class Scalar,
+          class FluidSystem,
+          class Implementation>
+class FluidStateLazyViscosityModule
+{
+    enum { numPhases = FluidSystem::numPhases };
+
+public:
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+
+    FluidStateLazyViscosityModule()
+        : paramCache_(nullptr)
+    {
+        Valgrind::SetUndefined(viscosity_);
+        invalidateViscosities();
+    }
+
+    /*!
+     * \brief Set the parameter cache which is used to compute the viscosities.
+     *
+     * This invalidates all viscosities which have been computed so far.
+     */
+    void setViscosityParameterCache(const ParameterCache& paramCache)
+    {
+        paramCache_ = &paramCache;
+        invalidateViscosities();
+    }
+
+    /*!
+     * \brief The viscosity of a fluid phase [-]
+     */
+    const Scalar& viscosity(unsigned phaseIdx) const
+    {
+        if (!viscosityIsValid_[phaseIdx]) {
+            if (!paramCache_)
+                OPM_THROW(std::logic_error,
+                          "The parameter cache must be set before the viscosity can be computed");
+
+            viscosity_[phaseIdx] = FluidSystem::viscosity(asImp_(), *paramCache_, phaseIdx);
+            viscosityIsValid_[phaseIdx] = true;
+        }
+
+        return viscosity_[phaseIdx];
+    }
+
+    /*!
+     * \brief Set the dynamic viscosity of a phase [Pa s]
+     *
+     * The value is used until the viscosities are invalidated.
+     */
+    void setViscosity(unsigned phaseIdx, Scalar value)
+    {
+        viscosity_[phaseIdx] = value;
+        viscosityIsValid_[phaseIdx] = true;
+    }
+
+    /*!
+     * \brief Discard the memoized viscosities of all phases.
+     */
+    void invalidateViscosities()
+    { std::fill(viscosityIsValid_, viscosityIsValid_ + numPhases, false); }
+
+    /*!
+     * \brief Retrieve all parameters from an arbitrary fluid
+     *        state.
+     */
+    template <class FluidState>
+    void assign(const FluidState& fs)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            setViscosity(phaseIdx, Opm::decay<Scalar>(fs.viscosity(phaseIdx)));
+    }
+
+    /*!
+     * \brief Make sure that all attributes are defined.
+     *
+     * This method does not do anything if the program is not run
+     * under valgrind. If it is, then valgrind will print an error
+     * message if some of the viscosities which have already been
+     * computed are not properly defined.
+     */
+    void checkDefined() const
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (viscosityIsValid_[phaseIdx])
+                Valgrind::CheckDefined(viscosity_[phaseIdx]);
+    }
+
+protected:
+    const Implementation& asImp_() const
+    { return *static_cast<const Implementation*>(this); }
+
+    const ParameterCache* paramCache_;
+    mutable Scalar viscosity_[numPhases];
+    mutable bool viscosityIsValid_[numPhases];
+};
+
 /*!
  * \brief Module for the modular fluid state which does not  the
  *        viscosities but throws std::logic_error instead.
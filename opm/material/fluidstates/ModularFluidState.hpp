@@ -38,6 +38,7 @@
 
 #include <opm/common/Valgrind.hpp>
 #include <algorithm>
+#include <type_traits>
 
 namespace Opm {
 
@@ -97,9 +98,22 @@ public:
     /*!
      * \brief Retrieve all parameters from an arbitrary fluid
      *        state.
+     *
+     * If the argument is a fluid state of the same type, its attributes are copied
+     * directly. Otherwise, each module retrieves its quantities from the argument and
+     * converts them to the scalar type of this fluid state.
      */
     template <class FluidState>
     void assign(const FluidState& fs)
+    { assign_(fs, std::is_base_of<ModularFluidState, FluidState>()); }
+
+private:
+    template <class FluidState>
+    void assign_(const FluidState& fs, std::true_type /*sameFluidState*/)
+    { static_cast<ModularFluidState&>(*this) = static_cast<const ModularFluidState&>(fs); }
+
+    template <class FluidState>
+    void assign_(const FluidState& fs, std::false_type /*sameFluidState*/)
     {
         PressureModule::assign(fs);
         TemperatureModule::assign(fs);
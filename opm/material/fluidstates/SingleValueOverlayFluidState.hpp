@@ -0,0 +1,338 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::SingleValueOverlayFluidState
+ */
+#ifndef OPM_SINGLE_VALUE_OVERLAY_FLUID_STATE_HPP
+#define OPM_SINGLE_VALUE_OVERLAY_FLUID_STATE_HPP
+
+#include <opm/common/Valgrind.hpp>
+
+#include <utility>
+
+namespace Opm {
+
+/*!
+ * \brief The quantities which can be overridden by a SingleValueOverlayFluidState.
+ */
+enum class OverlayQuantity {
+    //! The temperature of all fluid phases
+    Temperature,
+    //! The pressure of a fluid phase
+    Pressure,
+    //! The saturation of a fluid phase
+    Saturation,
+    //! The mole fraction of a component in a fluid phase
+    MoleFraction
+};
+
+template <class FluidState, OverlayQuantity quantity>
+class SingleValueOverlayFluidState;
+
+namespace OverlayDetail {
+// fluid states which are not overlays are referenced, overlays are stored by value.
+// This allows to nest overlays without the intermediate objects needing to stay alive
+// and it is cheap because an overlay only consists of a handful of words.
+template <class FluidState>
+struct InnerStorage
+{
+    InnerStorage(const FluidState& fs) : fs_(&fs) {}
+    const FluidState& get() const { return *fs_; }
+
+private:
+    const FluidState* fs_;
+};
+
+template <class FluidState, OverlayQuantity quantity>
+struct InnerStorage<SingleValueOverlayFluidState<FluidState, quantity> >
+{
+    typedef SingleValueOverlayFluidState<FluidState, quantity> Overlay;
+
+    InnerStorage(const Overlay& fs) : fs_(fs) {}
+    const Overlay& get() const { return fs_; }
+
+private:
+    Overlay fs_;
+};
+} // namespace OverlayDetail
+
+/*!
+ * \brief A fluid state which overrides a single value of another fluid state.
+ *
+ * In contrast to PressureOverlayFluidState and friends, this overlay does not copy
+ * any arrays from the underlying fluid state: It only stores the index of the phase
+ * (and component) which is overridden and the new value. This makes it suitable for
+ * finite difference or sensitivity computations which perturb one unknown at a time.
+ * All quantities except the overridden one are forwarded to the underlying fluid
+ * state unmodified, i.e., derived quantities like the fugacity or the mass fractions
+ * are not updated.
+ *
+ * Overlays can be nested to override several values. If the underlying fluid state is
+ * an overlay itself, it is stored by value, i.e.,
+ * \code
+ * typedef SingleValueOverlayFluidState<FluidState, OverlayQuantity::Pressure> PressureOverlay;
+ * SingleValueOverlayFluidState<PressureOverlay, OverlayQuantity::Temperature>
+ *     overlayFs(PressureOverlay(fs, phaseIdx, p), 0, T);
+ * \endcode
+ * is valid as long as \c fs is alive. NestedOverlayFluidState can be used to compose
+ * the type of such overlays.
+ *
+ * \tparam FluidState The type of the underlying fluid state
+ * \tparam quantity The quantity which is overridden
+ */
+template <class FluidState, OverlayQuantity quantity>
+class SingleValueOverlayFluidState
+{
+public:
+    typedef typename FluidState::Scalar Scalar;
+
+    enum { numPhases = FluidState::numPhases };
+    enum { numComponents = FluidState::numComponents };
+
+    /*!
+     * \brief Constructor
+     *
+     * \param fs The underlying fluid state
+     * \param phaseIdx The index of the phase whose quantity is overridden. It is
+     *                 ignored for the temperature, which is overridden for all phases
+     * \param compIdx The index of the component whose mole fraction is overridden. It
+     *                is ignored for all other quantities
+     * \param value The value of the overridden quantity
+     */
+    SingleValueOverlayFluidState(const FluidState& fs,
+                                 unsigned phaseIdx,
+                                 unsigned compIdx,
+                                 const Scalar& value)
+        : fs_(fs)
+        , phaseIdx_(phaseIdx)
+        , compIdx_(compIdx)
+        , value_(value)
+    { }
+
+    /*!
+     * \brief Constructor for the quantities which do not depend on a component.
+     */
+    SingleValueOverlayFluidState(const FluidState& fs,
+                                 unsigned phaseIdx,
+                                 const Scalar& value)
+        : SingleValueOverlayFluidState(fs, phaseIdx, /*compIdx=*/0, value)
+    { }
+
+    /*!
+     * \brief Change the value of the overridden quantity.
+     */
+    void setValue(const Scalar& value)
+    { value_ = value; }
+
+    /*!
+     * \brief Change which value is overridden.
+     */
+    void setIndex(unsigned phaseIdx, unsigned compIdx = 0)
+    {
+        phaseIdx_ = phaseIdx;
+        compIdx_ = compIdx;
+    }
+
+    /*!
+     * \brief The value of the overridden quantity.
+     */
+    const Scalar& value() const
+    { return value_; }
+
+    /*!
+     * \brief Returns the saturation of a phase []
+     */
+    auto saturation(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().saturation(phaseIdx))
+    {
+        if (quantity == OverlayQuantity::Saturation && phaseIdx == phaseIdx_)
+            return value_;
+        return fs_.get().saturation(phaseIdx);
+    }
+
+    /*!
+     * \brief Returns true iff a fluid phase shall be assumed to be present.
+     */
+    bool phaseIsPresent(unsigned phaseIdx) const
+    {
+        if (quantity == OverlayQuantity::Saturation && phaseIdx == phaseIdx_)
+            return value_ > 0.0;
+        return fs_.get().phaseIsPresent(phaseIdx);
+    }
+
+    /*!
+     * \brief The mole fraction of a component in a phase []
+     */
+    auto moleFraction(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().moleFraction(phaseIdx, compIdx))
+    {
+        if (quantity == OverlayQuantity::MoleFraction && phaseIdx == phaseIdx_ && compIdx == compIdx_)
+            return value_;
+        return fs_.get().moleFraction(phaseIdx, compIdx);
+    }
+
+    /*!
+     * \brief The mass fraction of a component in a phase []
+     */
+    auto massFraction(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().massFraction(phaseIdx, compIdx))
+    { return fs_.get().massFraction(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The average molar mass of a fluid phase [kg/mol]
+     */
+    auto averageMolarMass(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().averageMolarMass(phaseIdx))
+    { return fs_.get().averageMolarMass(phaseIdx); }
+
+    /*!
+     * \brief The molar concentration of a component in a phase [mol/m^3]
+     */
+    auto molarity(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().molarity(phaseIdx, compIdx))
+    { return fs_.get().molarity(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The fugacity of a component in a phase [Pa]
+     */
+    auto fugacity(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().fugacity(phaseIdx, compIdx))
+    { return fs_.get().fugacity(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The fugacity coefficient of a component in a phase [-]
+     */
+    auto fugacityCoefficient(unsigned phaseIdx, unsigned compIdx) const
+        -> decltype(std::declval<FluidState>().fugacityCoefficient(phaseIdx, compIdx))
+    { return fs_.get().fugacityCoefficient(phaseIdx, compIdx); }
+
+    /*!
+     * \brief The molar volume of a fluid phase [m^3/mol]
+     */
+    auto molarVolume(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().molarVolume(phaseIdx))
+    { return fs_.get().molarVolume(phaseIdx); }
+
+    /*!
+     * \brief The mass density of a fluid phase [kg/m^3]
+     */
+    auto density(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().density(phaseIdx))
+    { return fs_.get().density(phaseIdx); }
+
+    /*!
+     * \brief The molar density of a fluid phase [mol/m^3]
+     */
+    auto molarDensity(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().molarDensity(phaseIdx))
+    { return fs_.get().molarDensity(phaseIdx); }
+
+    /*!
+     * \brief The temperature of a fluid phase [K]
+     */
+    auto temperature(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().temperature(phaseIdx))
+    {
+        if (quantity == OverlayQuantity::Temperature)
+            return value_;
+        return fs_.get().temperature(phaseIdx);
+    }
+
+    /*!
+     * \brief The pressure of a fluid phase [Pa]
+     */
+    auto pressure(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().pressure(phaseIdx))
+    {
+        if (quantity == OverlayQuantity::Pressure && phaseIdx == phaseIdx_)
+            return value_;
+        return fs_.get().pressure(phaseIdx);
+    }
+
+    /*!
+     * \brief The specific enthalpy of a fluid phase [J/kg]
+     */
+    auto enthalpy(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().enthalpy(phaseIdx))
+    { return fs_.get().enthalpy(phaseIdx); }
+
+    /*!
+     * \brief The specific internal energy of a fluid phase [J/kg]
+     */
+    auto internalEnergy(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().internalEnergy(phaseIdx))
+    { return fs_.get().internalEnergy(phaseIdx); }
+
+    /*!
+     * \brief The dynamic viscosity of a fluid phase [Pa s]
+     */
+    auto viscosity(unsigned phaseIdx) const
+        -> decltype(std::declval<FluidState>().viscosity(phaseIdx))
+    { return fs_.get().viscosity(phaseIdx); }
+
+    /*!
+     * \brief Make sure that all attributes are defined.
+     *
+     * This method does not do anything if the program is not run
+     * under valgrind. If it is, then valgrind will print an error
+     * message if some attributes of the object have not been properly
+     * defined.
+     */
+    void checkDefined() const
+    {
+        Valgrind::CheckDefined(value_);
+    }
+
+protected:
+    OverlayDetail::InnerStorage<FluidState> fs_;
+    unsigned phaseIdx_;
+    unsigned compIdx_;
+    Scalar value_;
+};
+
+/*!
+ * \brief Composes the type of nested single value overlays.
+ *
+ * NestedOverlayFluidState<FluidState, q1, q2>::type overrides one value of quantity
+ * q1 and one of quantity q2; the last quantity corresponds to the outermost overlay.
+ */
+template <class FluidState, OverlayQuantity... quantities>
+struct NestedOverlayFluidState;
+
+template <class FluidState>
+struct NestedOverlayFluidState<FluidState>
+{
+    typedef FluidState type;
+};
+
+template <class FluidState, OverlayQuantity quantity, OverlayQuantity... remainingQuantities>
+struct NestedOverlayFluidState<FluidState, quantity, remainingQuantities...>
+{
+    typedef typename NestedOverlayFluidState<SingleValueOverlayFluidState<FluidState, quantity>,
+                                             remainingQuantities...>::type type;
+};
+
+} // namespace Opm
+
+#endif
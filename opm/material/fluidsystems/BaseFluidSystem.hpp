@@ -33,6 +33,9 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <dune/common/classname.hh>
 
+#include <cstddef>
+#include <type_traits>
+
 namespace Opm {
 
 /*!
@@ -201,6 +204,64 @@ public:
         OPM_THROW(std::runtime_error, "Not implemented: The fluid system '" << Dune::className<Implementation>() << "'  does not provide a fugacityCoefficient() method!");
     }
 
+    /*!
+     * \brief Calculate the fugacity coefficients of all components in a fluid phase
+     *
+     * After calling this method, fugCoeffs[compIdx] is the result of
+     * fugacityCoefficient() for the component. The default implementation calls
+     * fugacityCoefficient() for each component, fluid systems for which the
+     * coefficients share expensive terms should overload it.
+     *
+     * \copydoc Doxygen::fluidSystemBaseParams
+     * \copydoc Doxygen::phaseIdxParam
+     */
+    template <class FluidState, class Container, class ParamCache>
+    static void fugacityCoefficients(const FluidState& fluidState,
+                                     ParamCache& paramCache,
+                                     unsigned phaseIdx,
+                                     Container& fugCoeffs)
+    {
+        for (unsigned compIdx = 0; compIdx < Implementation::numComponents; ++compIdx)
+            fugCoeffs[compIdx] =
+                Implementation::fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx);
+    }
+
+    /*!
+     * \brief Returns true if and only if the fluid system provides the derivatives of
+     *        the fugacity coefficients of a phase in closed form.
+     *
+     * If this method returns true, lnFugacityCoefficientDerivatives() must be
+     * implemented for the phase. Returning false is always safe; the constraint
+     * solvers then approximate the derivatives numerically.
+     *
+     * \copydoc Doxygen::phaseIdxParam
+     */
+    static bool hasAnalyticFugacityDerivatives(unsigned /*phaseIdx*/)
+    { return false; }
+
+    /*!
+     * \brief Calculate the partial derivatives of the logarithms of the fugacity
+     *        coefficients of all components in a phase with regard to the phase's
+     *        mole fractions.
+     *
+     * After calling this method, dLnPhi[i][k] is \f$\partial \ln \phi_i / \partial
+     * x_k\f$ at constant pressure and temperature.
+     *
+     * \return false if the derivatives are not available for the given fluid state.
+     *         In this case, the caller must fall back to numerical differentiation.
+     *
+     * \copydoc Doxygen::fluidSystemBaseParams
+     * \copydoc Doxygen::phaseIdxParam
+     */
+    template <class FluidState, class Matrix, class ParamCache>
+    static bool lnFugacityCoefficientDerivatives(Matrix& /*dLnPhi*/,
+                                                 const FluidState& /*fluidState*/,
+                                                 ParamCache& /*paramCache*/,
+                                                 unsigned /*phaseIdx*/)
+    {
+        OPM_THROW(std::runtime_error, "Not implemented: The fluid system '" << Dune::className<Implementation>() << "'  does not provide a lnFugacityCoefficientDerivatives() method!");
+    }
+
     /*!
      * \brief Calculate the dynamic viscosity of a fluid phase [Pa*s]
      *
@@ -283,6 +344,128 @@ public:
     {
         OPM_THROW(std::runtime_error, "Not implemented: The fluid system '" << Dune::className<Implementation>() << "'  does not provide a heatCapacity() method!");
     }
+
+    /****************************************
+     * Array-valued methods
+     *
+     * These compute a quantity of a phase for the first numValues entries of a range
+     * of fluid states, e.g., a FluidStateArray or a std::vector of fluid states,
+     * each of which comes with its own parameter cache. The default implementations
+     * simply call the method for a single fluid state of the fluid system for each
+     * entry. Fluid systems for which a loop over the entries can be implemented more
+     * efficiently override them, e.g., by dispatching the phase index once instead of
+     * for each entry or by calling the array-valued methods of their components.
+     *
+     * The parameter caches are passed as an array with one entry for each fluid
+     * state, and the results are written to values[0] to values[numValues - 1].
+     ****************************************/
+
+    /*!
+     * \brief Calculate the density [kg/m^3] of a fluid phase for a range of fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void densityBatch(size_t numValues,
+                             const FluidStateRange& fluidStates,
+                             ParamCache* paramCaches,
+                             unsigned phaseIdx,
+                             LhsEval* values)
+    {
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::template density<FluidState, LhsEval>(fluidStates[i], paramCaches[i], phaseIdx);
+    }
+
+    /*!
+     * \brief Calculate the fugacity coefficient of a component of a fluid phase for a range of fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void fugacityCoefficientBatch(size_t numValues,
+                                         const FluidStateRange& fluidStates,
+                                         ParamCache* paramCaches,
+                                         unsigned phaseIdx,
+                                         unsigned compIdx,
+                                         LhsEval* values)
+    {
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::template fugacityCoefficient<FluidState, LhsEval>(fluidStates[i], paramCaches[i], phaseIdx, compIdx);
+    }
+
+    /*!
+     * \brief Calculate the dynamic viscosity [Pa*s] of a fluid phase for a range of fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void viscosityBatch(size_t numValues,
+                               const FluidStateRange& fluidStates,
+                               ParamCache* paramCaches,
+                               unsigned phaseIdx,
+                               LhsEval* values)
+    {
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::template viscosity<FluidState, LhsEval>(fluidStates[i], paramCaches[i], phaseIdx);
+    }
+
+    /*!
+     * \brief Calculate the binary molecular diffusion coefficient of a component of a fluid phase for a range of fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void diffusionCoefficientBatch(size_t numValues,
+                                          const FluidStateRange& fluidStates,
+                                          ParamCache* paramCaches,
+                                          unsigned phaseIdx,
+                                          unsigned compIdx,
+                                          LhsEval* values)
+    {
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::template diffusionCoefficient<FluidState, LhsEval>(fluidStates[i], paramCaches[i], phaseIdx, compIdx);
+    }
+
+    /*!
+     * \brief Calculate the specific enthalpy [J/kg] of a fluid phase for a range of fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void enthalpyBatch(size_t numValues,
+                              const FluidStateRange& fluidStates,
+                              ParamCache* paramCaches,
+                              unsigned phaseIdx,
+                              LhsEval* values)
+    {
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::template enthalpy<FluidState, LhsEval>(fluidStates[i], paramCaches[i], phaseIdx);
+    }
+
+    /*!
+     * \brief Calculate the thermal conductivity [W/(m K)] of a fluid phase for a range of fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void thermalConductivityBatch(size_t numValues,
+                                         const FluidStateRange& fluidStates,
+                                         ParamCache* paramCaches,
+                                         unsigned phaseIdx,
+                                         LhsEval* values)
+    {
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::template thermalConductivity<FluidState, LhsEval>(fluidStates[i], paramCaches[i], phaseIdx);
+    }
+
+    /*!
+     * \brief Calculate the specific isobaric heat capacity [J/kg] of a fluid phase for a range of fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void heatCapacityBatch(size_t numValues,
+                                  const FluidStateRange& fluidStates,
+                                  ParamCache* paramCaches,
+                                  unsigned phaseIdx,
+                                  LhsEval* values)
+    {
+        typedef typename std::decay<decltype(fluidStates[0])>::type FluidState;
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = Implementation::template heatCapacity<FluidState, LhsEval>(fluidStates[i], paramCaches[i], phaseIdx);
+    }
 };
 
 } // namespace Opm
@@ -32,14 +32,19 @@
 #include "blackoilpvt/WaterPvtMultiplexer.hpp"
 
 #include <opm/material/fluidsystems/BaseFluidSystem.hpp>
+#include <opm/material/fluidsystems/ParameterCacheBase.hpp>
 #include <opm/material/Constants.hpp>
 
+#include <opm/material/common/BinarySerialization.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Tracing.hpp>
 #include <opm/common/Valgrind.hpp>
 #include <opm/material/common/HasMemberGeneratorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <array>
@@ -86,37 +91,361 @@ auto getRv_(typename std::enable_if<HasMember_Rv<FluidState>::value, const Fluid
 {
     return Opm::decay<LhsEval>(fluidState.Rv());
 }
+
+// the inverse formation volume factor and the viscosity of the oil or gas phase for a
+// given dissolution factor. if the PVT object provides a combined method, both
+// quantities share a single set of table lookups
+template <class Pvt, class LhsEval>
+auto invBAndViscosity_(const Pvt& pvt,
+                       unsigned regionIdx,
+                       const LhsEval& T,
+                       const LhsEval& p,
+                       const LhsEval& Rx,
+                       LhsEval& invB,
+                       LhsEval& mu,
+                       int)
+    -> decltype(pvt.inverseFormationVolumeFactorAndViscosity(regionIdx, T, p, Rx, invB, mu))
+{ pvt.inverseFormationVolumeFactorAndViscosity(regionIdx, T, p, Rx, invB, mu); }
+
+template <class Pvt, class LhsEval>
+void invBAndViscosity_(const Pvt& pvt,
+                       unsigned regionIdx,
+                       const LhsEval& T,
+                       const LhsEval& p,
+                       const LhsEval& Rx,
+                       LhsEval& invB,
+                       LhsEval& mu,
+                       long)
+{
+    invB = pvt.inverseFormationVolumeFactor(regionIdx, T, p, Rx);
+    mu = pvt.viscosity(regionIdx, T, p, Rx);
+}
+
+// the same as invBAndViscosity_() for the saturated fluid
+template <class Pvt, class LhsEval>
+auto saturatedInvBAndViscosity_(const Pvt& pvt,
+                                unsigned regionIdx,
+                                const LhsEval& T,
+                                const LhsEval& p,
+                                LhsEval& invB,
+                                LhsEval& mu,
+                                int)
+    -> decltype(pvt.saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, T, p, invB, mu))
+{ pvt.saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, T, p, invB, mu); }
+
+template <class Pvt, class LhsEval>
+void saturatedInvBAndViscosity_(const Pvt& pvt,
+                                unsigned regionIdx,
+                                const LhsEval& T,
+                                const LhsEval& p,
+                                LhsEval& invB,
+                                LhsEval& mu,
+                                long)
+{
+    invB = pvt.saturatedInverseFormationVolumeFactor(regionIdx, T, p);
+    mu = pvt.saturatedViscosity(regionIdx, T, p);
+}
+
+// the fluid state API on top of the input arrays of
+// FluidSystems::BlackOil::exportPhaseProperties()
+template <class ScalarT, class PropertyExportInput>
+class PropertyExportCellState
+{
+public:
+    typedef ScalarT Scalar;
+
+    PropertyExportCellState(const PropertyExportInput& input,
+                            size_t cellIdx,
+                            Scalar defaultTemperature)
+        : input_(input)
+        , cellIdx_(cellIdx)
+        , defaultTemperature_(defaultTemperature)
+    {}
+
+    Scalar temperature(unsigned /*phaseIdx*/) const
+    { return input_.temperature ? input_.temperature[cellIdx_] : defaultTemperature_; }
+
+    Scalar pressure(unsigned phaseIdx) const
+    { return input_.pressure[phaseIdx][cellIdx_]; }
+
+    Scalar saturation(unsigned phaseIdx) const
+    { return input_.saturation[phaseIdx] ? input_.saturation[phaseIdx][cellIdx_] : 0.0; }
+
+    bool phaseIsPresent(unsigned phaseIdx) const
+    { return saturation(phaseIdx) > 0.0; }
+
+    Scalar Rs() const
+    { return input_.Rs[cellIdx_]; }
+
+    Scalar Rv() const
+    { return input_.Rv[cellIdx_]; }
+
+private:
+    const PropertyExportInput& input_;
+    size_t cellIdx_;
+    Scalar defaultTemperature_;
+};
 }
 
 namespace FluidSystems {
 
+/*!
+ * \brief Phase configuration of the black-oil fluid system which selects the active
+ *        phases and the miscibility of oil and gas at runtime.
+ *
+ * This is the default. The configuration is taken from the deck or from the
+ * initialization methods of the fluid system.
+ */
+struct BlackOilRuntimePhases
+{
+    static const bool isStatic = false;
+
+    static constexpr bool phaseIsActive(unsigned /*phaseIdx*/)
+    { return true; }
+
+    static constexpr unsigned numActivePhases()
+    { return 3; }
+
+    static constexpr bool enableDissolvedGas()
+    { return false; }
+
+    static constexpr bool enableVaporizedOil()
+    { return false; }
+};
+
+/*!
+ * \brief Phase configuration of the black-oil fluid system which fixes the active
+ *        phases and the miscibility of oil and gas at compile time.
+ *
+ * The queries of the fluid system then are compile-time constants, so the compiler
+ * removes the code for inactive phases and for the disabled dissolution of gas in oil
+ * (DISGAS) and of oil in gas (VAPOIL) from the thermodynamic methods. The deck or the
+ * initialization code must agree with this configuration: initEnd() throws if it does
+ * not.
+ */
+template <bool waterIsActive, bool oilIsActive, bool gasIsActive,
+          bool enableDisgas, bool enableVapoil>
+struct BlackOilStaticPhases
+{
+    static_assert(waterIsActive + oilIsActive + gasIsActive >= 2,
+                  "The black-oil fluid system requires at least two active phases");
+
+    static const bool isStatic = true;
+
+    // the indices correspond to BlackOil::waterPhaseIdx, oilPhaseIdx and gasPhaseIdx
+    static constexpr bool phaseIsActive(unsigned phaseIdx)
+    { return (phaseIdx == 0)?waterIsActive:((phaseIdx == 1)?oilIsActive:gasIsActive); }
+
+    static constexpr unsigned numActivePhases()
+    { return waterIsActive + oilIsActive + gasIsActive; }
+
+    static constexpr bool enableDissolvedGas()
+    { return enableDisgas; }
+
+    static constexpr bool enableVaporizedOil()
+    { return enableVapoil; }
+};
+
 /*!
  * \brief A fluid system which uses the black-oil model assumptions to calculate
  *        termodynamically meaningful quantities.
  *
+ * By default, the PVT relations of the phases are selected at runtime using the
+ * PVT multiplexer classes. If the PVT approaches which are used by a deck are known
+ * at compile time, the concrete PVT classes can be specified instead, e.g.
+ *
+ * \code
+ * typedef Opm::FluidSystems::BlackOil<double,
+ *                                     Opm::LiveOilPvt<double>,
+ *                                     Opm::WetGasPvt<double>,
+ *                                     Opm::ConstantCompressibilityWaterPvt<double> > FluidSystem;
+ * \endcode
+ *
+ * This avoids the runtime dispatch of the multiplexers and allows the compiler to
+ * inline the PVT functions. The concrete PVT classes provide the same interface as
+ * the multiplexers (except for the methods which select the approach at runtime).
+ *
+ * Similarly, the set of active phases and the DISGAS/VAPOIL settings can be fixed at
+ * compile time using BlackOilStaticPhases, e.g. for a dead-oil--water system:
+ *
+ * \code
+ * typedef Opm::FluidSystems::BlackOil<double,
+ *                                     Opm::DeadOilPvt<double>,
+ *                                     Opm::DryGasPvt<double>,
+ *                                     Opm::ConstantCompressibilityWaterPvt<double>,
+ *                                     Opm::FluidSystems::BlackOilStaticPhases<true, true, false,
+ *                                                                             false, false> > FluidSystem;
+ * \endcode
+ *
  * \tparam Scalar The type used for scalar floating point values
+ * \tparam OilPvtT The class which implements the PVT relations of the oil phase
+ * \tparam GasPvtT The class which implements the PVT relations of the gas phase
+ * \tparam WaterPvtT The class which implements the PVT relations of the water phase
+ * \tparam PhaseConfigT Selects whether the active phases and the miscibility are
+ *                      runtime parameters (BlackOilRuntimePhases) or compile-time
+ *                      constants (BlackOilStaticPhases)
  */
-template <class Scalar>
-class BlackOil : public BaseFluidSystem<Scalar, BlackOil<Scalar> >
+template <class Scalar,
+          class OilPvtT = Opm::OilPvtMultiplexer<Scalar>,
+          class GasPvtT = Opm::GasPvtMultiplexer<Scalar>,
+          class WaterPvtT = Opm::WaterPvtMultiplexer<Scalar>,
+          class PhaseConfigT = BlackOilRuntimePhases>
+class BlackOil : public BaseFluidSystem<Scalar, BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT> >
 {
     typedef BlackOil ThisType;
 
 public:
-    typedef Opm::GasPvtMultiplexer<Scalar> GasPvt;
-    typedef Opm::OilPvtMultiplexer<Scalar> OilPvt;
-    typedef Opm::WaterPvtMultiplexer<Scalar> WaterPvt;
+    typedef GasPvtT GasPvt;
+    typedef OilPvtT OilPvt;
+    typedef WaterPvtT WaterPvt;
+    typedef PhaseConfigT PhaseConfig;
+
+    /*!
+     * \brief The functions which blend the saturated and the undersaturated quantities
+     *        of the oil and gas phases if the other hydrocarbon phase is about to vanish.
+     *
+     * The argument of the function is the saturation of the vanishing phase divided by
+     * the width of the transition zone. 'Linear' is continuous in value only and
+     * leaves a kink at the end of the zone, 'SmoothStep' (3x^2 - 2x^3) is
+     * continuously differentiable and 'SmootherStep' (6x^5 - 15x^4 + 10x^3) is twice
+     * continuously differentiable.
+     */
+    enum class SaturatedSwitchFunction
+    {
+        Linear,
+        SmoothStep,
+        SmootherStep
+    };
 
-    //! \copydoc BaseFluidSystem::ParameterCache
+    /*!
+     * \brief The complete state of the black-oil fluid system.
+     *
+     * This comprises the PVT objects of all phases, the reference densities and molar
+     * masses of all PVT regions, the set of active phases and the miscibility
+     * settings. All static methods of the fluid system (including the initialization
+     * methods) operate on the context which is active for the calling thread. Unless
+     * another context was activated using ScopedContext or setActiveContext(), this is
+     * a process-wide default context, i.e., code which is not aware of contexts uses
+     * the fluid system exactly like before.
+     *
+     * Multiple contexts allow to use e.g., several models with different PVT
+     * properties within the same process and the same thread pool: Each model owns its
+     * own context and activates it before initializing or using the fluid system.
+     */
+    struct Context
+    {
+        Context()
+            : enableDissolvedGas(false)
+            , enableVaporizedOil(false)
+            , numActivePhases(0)
+            , reservoirTemperature(0.0)
+            , saturatedSwitchWidth(1e-4)
+            , saturatedSwitchFunction(SaturatedSwitchFunction::Linear)
+            , isInitialized(false)
+        { phaseIsActive.fill(false); }
+
+        std::shared_ptr<GasPvt> gasPvt;
+        std::shared_ptr<OilPvt> oilPvt;
+        std::shared_ptr<WaterPvt> waterPvt;
+
+        bool enableDissolvedGas;
+        bool enableVaporizedOil;
+
+        // HACK for GCC 4.4: the array size has to be specified using the literal value
+        // '3' here, because GCC 4.4 seems to be unable to determine the number of phases
+        // from the BlackOil fluid system in the attribute declarations below...
+        std::array<bool, /*numPhases=*/3> phaseIsActive;
+        unsigned char numActivePhases;
+
+        std::vector<std::array<Scalar, /*numPhases=*/3> > referenceDensity;
+        std::vector<std::array<Scalar, /*numComponents=*/3> > molarMass;
+
+        Scalar reservoirTemperature;
+
+        Scalar saturatedSwitchWidth;
+        SaturatedSwitchFunction saturatedSwitchFunction;
+
+        bool isInitialized;
+    };
+
+    /*!
+     * \brief Activates a context of the fluid system for the calling thread for the
+     *        lifetime of the object.
+     *
+     * When the object is destroyed, the previously active context is restored.
+     */
+    class ScopedContext
+    {
+    public:
+        explicit ScopedContext(Context& context)
+            : previousContext_(activeContext_)
+        { activeContext_ = &context; }
+
+        ~ScopedContext()
+        { activeContext_ = previousContext_; }
+
+    private:
+        ScopedContext(const ScopedContext&) = delete;
+        ScopedContext& operator=(const ScopedContext&) = delete;
+
+        Context* previousContext_;
+    };
+
+    /*!
+     * \brief Returns the context of the fluid system which is active for the calling
+     *        thread.
+     */
+    static Context& activeContext()
+    { return *activeContext_; }
+
+    /*!
+     * \brief Use a given context for all calls of the fluid system's methods by the
+     *        calling thread.
+     *
+     * The context object must stay alive as long as it is active.
+     */
+    static void setActiveContext(Context& context)
+    { activeContext_ = &context; }
+
+    /*!
+     * \brief Make the calling thread use the process-wide default context again.
+     */
+    static void resetActiveContext()
+    { activeContext_ = &defaultContext_; }
+
+    /*!
+     * \brief The parameter cache of the black-oil fluid system
+     *
+     * Besides the PVT region and the maximum oil saturation, the cache stores the
+     * inverse formation volume factors and the viscosities of all phases as well as the
+     * saturated dissolution factors at the pressure of the oil and gas phases. These
+     * quantities are computed by updateAll() or updatePhase(). The black-oil specific
+     * methods of the fluid system which accept a parameter cache then use the cached
+     * values instead of evaluating the PVT curves again.
+     *
+     * All cached quantities are stored in fixed-size arrays, i.e., updating the cache
+     * does not allocate memory and the same cache object can be reused for an
+     * arbitrary number of fluid states.
+     */
     template <class EvaluationT>
-    struct ParameterCache : public Opm::NullParameterCache<EvaluationT>
+    struct ParameterCache : public Opm::ParameterCacheBase<ParameterCache<EvaluationT> >
     {
         typedef EvaluationT Evaluation;
+        typedef Opm::ParameterCacheBase<ParameterCache<EvaluationT> > ParentType;
 
     public:
         ParameterCache(Scalar maxOilSat = 1.0, unsigned regionIdx=0)
         {
             maxOilSat_ = maxOilSat;
             regionIdx_ = regionIdx;
+
+            invalidate();
+            for (unsigned phaseIdx = 0; phaseIdx < /*numPhases=*/3; ++phaseIdx) {
+                Valgrind::SetUndefined(invB_[phaseIdx]);
+                Valgrind::SetUndefined(mu_[phaseIdx]);
+                Valgrind::SetUndefined(saturatedRs_[phaseIdx]);
+                Valgrind::SetUndefined(saturatedRv_[phaseIdx]);
+            }
         }
 
         /*!
@@ -133,6 +462,123 @@ public:
             maxOilSat_ = other.maxOilSat();
         }
 
+        //! \copydoc ParameterCacheBase::updateAll
+        template <class FluidState>
+        void updateAll(const FluidState& fluidState, int exceptQuantities = ParentType::None)
+        {
+            for (unsigned phaseIdx = 0; phaseIdx < /*numPhases=*/3; ++phaseIdx) {
+                if (!phaseIsActive(phaseIdx))
+                    continue;
+
+                updatePhase(fluidState, phaseIdx, exceptQuantities);
+            }
+        }
+
+        /*!
+         * \copydoc ParameterCacheBase::updatePhase
+         *
+         * For the oil and gas phases, the saturated and the undersaturated PVT curves
+         * are evaluated at most once each, independent of how many quantities are
+         * queried afterwards. If the phase is up to date and neither its temperature
+         * nor its pressure changed, the saturated dissolution factors are kept and only
+         * the quantities which depend on the composition are recomputed. The water
+         * phase does not depend on the composition at all.
+         */
+        template <class FluidState>
+        void updatePhase(const FluidState& fluidState,
+                         unsigned phaseIdx,
+                         int exceptQuantities = ParentType::None)
+        {
+            assert(phaseIdx < /*numPhases=*/3);
+
+            const int TpMask = ParentType::Temperature | ParentType::Pressure;
+            const bool TpUnchanged =
+                phaseIsUpToDate(phaseIdx) && (exceptQuantities & TpMask) == TpMask;
+            if (TpUnchanged
+                && (phaseIdx == waterPhaseIdx || (exceptQuantities & ParentType::Composition)))
+                return;
+
+            const auto& p = Opm::decay<Evaluation>(fluidState.pressure(phaseIdx));
+            const auto& T = Opm::decay<Evaluation>(fluidState.temperature(phaseIdx));
+
+            switch (phaseIdx) {
+            case oilPhaseIdx:
+                updateOilPhase_(fluidState, T, p, /*updateSaturated=*/!TpUnchanged);
+                break;
+
+            case gasPhaseIdx:
+                updateGasPhase_(fluidState, T, p, /*updateSaturated=*/!TpUnchanged);
+                break;
+
+            case waterPhaseIdx:
+                invB_[waterPhaseIdx] = context_().waterPvt->inverseFormationVolumeFactor(regionIdx_, T, p);
+                mu_[waterPhaseIdx] = context_().waterPvt->viscosity(regionIdx_, T, p);
+                break;
+            }
+
+            upToDate_ |= 1u << phaseIdx;
+        }
+
+        /*!
+         * \brief Mark the cached quantities of all phases as outdated.
+         *
+         * Afterwards, the methods of the fluid system compute all quantities from
+         * scratch until the cache is updated again.
+         */
+        void invalidate()
+        { upToDate_ = 0; }
+
+        /*!
+         * \brief Returns true iff the cached quantities of a phase correspond to the
+         *        fluid state passed to the last call of updateAll() or updatePhase().
+         */
+        bool phaseIsUpToDate(unsigned phaseIdx) const
+        { return (upToDate_ & (1u << phaseIdx)) != 0; }
+
+        /*!
+         * \brief Return the cached inverse formation volume factor of a fluid phase.
+         */
+        const Evaluation& inverseFormationVolumeFactor(unsigned phaseIdx) const
+        {
+            assert(phaseIsUpToDate(phaseIdx));
+            return invB_[phaseIdx];
+        }
+
+        /*!
+         * \brief Return the cached viscosity of a fluid phase.
+         */
+        const Evaluation& viscosity(unsigned phaseIdx) const
+        {
+            assert(phaseIsUpToDate(phaseIdx));
+            return mu_[phaseIdx];
+        }
+
+        /*!
+         * \brief Return the gas dissolution factor of saturated oil at the pressure of
+         *        a given phase.
+         *
+         * This is only available for the oil phase if dissolved gas is enabled and for
+         * the gas phase if vaporized oil is enabled.
+         */
+        const Evaluation& saturatedRs(unsigned phaseIdx) const
+        {
+            assert(phaseIsUpToDate(phaseIdx));
+            return saturatedRs_[phaseIdx];
+        }
+
+        /*!
+         * \brief Return the oil vaporization factor of saturated gas at the pressure of
+         *        a given phase.
+         *
+         * This is only available for the oil phase if dissolved gas is enabled and for
+         * the gas phase if vaporized oil is enabled.
+         */
+        const Evaluation& saturatedRv(unsigned phaseIdx) const
+        {
+            assert(phaseIsUpToDate(phaseIdx));
+            return saturatedRv_[phaseIdx];
+        }
+
         /*!
          * \brief Return the index of the region which should be used to determine the
          *        thermodynamic properties
@@ -149,9 +595,14 @@ public:
          *
          * This is only required because "oil" and "gas" are pseudo-components, i.e. for
          * more comprehensive equations of state there would only be one "region".
+         *
+         * Since the PVT curves depend on the region, this invalidates the cache.
          */
         void setRegionIndex(unsigned val)
-        { regionIdx_ = val; }
+        {
+            regionIdx_ = val;
+            invalidate();
+        }
 
         const Scalar maxOilSat() const
         { return maxOilSat_; }
@@ -160,6 +611,55 @@ public:
         { maxOilSat_ = val; }
 
     private:
+        template <class FluidState>
+        void updateOilPhase_(const FluidState& fluidState,
+                             const Evaluation& T,
+                             const Evaluation& p,
+                             bool updateSaturated)
+        {
+            if (!enableDissolvedGas()) {
+                const Evaluation Rs(0.0);
+                oilInvBAndViscosity_(invB_[oilPhaseIdx], mu_[oilPhaseIdx], fluidState, T, p, Rs, regionIdx_);
+                return;
+            }
+
+            if (updateSaturated) {
+                saturatedRs_[oilPhaseIdx] = context_().oilPvt->saturatedGasDissolutionFactor(regionIdx_, T, p);
+                saturatedRv_[oilPhaseIdx] = context_().gasPvt->saturatedOilVaporizationFactor(regionIdx_, T, p);
+            }
+
+            const auto& Rs = Opm::BlackOil::template getRs_<ThisType, Evaluation, FluidState>(fluidState, regionIdx_);
+            oilInvBAndViscosity_(invB_[oilPhaseIdx], mu_[oilPhaseIdx], fluidState, T, p, Rs, regionIdx_);
+        }
+
+        template <class FluidState>
+        void updateGasPhase_(const FluidState& fluidState,
+                             const Evaluation& T,
+                             const Evaluation& p,
+                             bool updateSaturated)
+        {
+            if (!enableVaporizedOil()) {
+                const Evaluation Rv(0.0);
+                gasInvBAndViscosity_(invB_[gasPhaseIdx], mu_[gasPhaseIdx], fluidState, T, p, Rv, regionIdx_);
+                return;
+            }
+
+            if (updateSaturated) {
+                saturatedRs_[gasPhaseIdx] = context_().oilPvt->saturatedGasDissolutionFactor(regionIdx_, T, p);
+                saturatedRv_[gasPhaseIdx] = context_().gasPvt->saturatedOilVaporizationFactor(regionIdx_, T, p);
+            }
+
+            const auto& Rv = Opm::BlackOil::template getRv_<ThisType, Evaluation, FluidState>(fluidState, regionIdx_);
+            gasInvBAndViscosity_(invB_[gasPhaseIdx], mu_[gasPhaseIdx], fluidState, T, p, Rv, regionIdx_);
+        }
+
+        // HACK for GCC 4.4: see the comment for Context::phaseIsActive
+        std::array<Evaluation, /*numPhases=*/3> invB_;
+        std::array<Evaluation, /*numPhases=*/3> mu_;
+        std::array<Evaluation, /*numPhases=*/3> saturatedRs_;
+        std::array<Evaluation, /*numPhases=*/3> saturatedRv_;
+        unsigned upToDate_;
+
         Scalar maxOilSat_;
         unsigned regionIdx_;
     };
@@ -177,22 +677,22 @@ public:
         size_t numRegions = densityKeyword.size();
         initBegin(numRegions);
 
-        numActivePhases_ = 0;
-        std::fill(&phaseIsActive_[0], &phaseIsActive_[numPhases], false);
+        context_().numActivePhases = 0;
+        context_().phaseIsActive.fill(false);
 
         if (deck.hasKeyword("OIL")) {
-            phaseIsActive_[oilPhaseIdx] = true;
-            ++ numActivePhases_;
+            context_().phaseIsActive[oilPhaseIdx] = true;
+            ++ context_().numActivePhases;
         }
 
         if (deck.hasKeyword("GAS")) {
-            phaseIsActive_[gasPhaseIdx] = true;
-            ++ numActivePhases_;
+            context_().phaseIsActive[gasPhaseIdx] = true;
+            ++ context_().numActivePhases;
         }
 
         if (deck.hasKeyword("WATER")) {
-            phaseIsActive_[waterPhaseIdx] = true;
-            ++ numActivePhases_;
+            context_().phaseIsActive[waterPhaseIdx] = true;
+            ++ context_().numActivePhases;
         }
 
         // The reservoir temperature does not really belong into the table manager. TODO:
@@ -200,7 +700,7 @@ public:
         setReservoirTemperature(eclState.getTableManager().rtemp());
 
         // this fluidsystem only supports two or three phases
-        assert(numActivePhases_ >= 2 && numActivePhases_ <= 3);
+        assert(context_().numActivePhases >= 2 && context_().numActivePhases <= 3);
 
         setEnableDissolvedGas(deck.hasKeyword("DISGAS"));
         setEnableVaporizedOil(deck.hasKeyword("VAPOIL"));
@@ -215,18 +715,18 @@ public:
         }
 
         if (phaseIsActive(gasPhaseIdx)) {
-            gasPvt_ = std::make_shared<GasPvt>();
-            gasPvt_->initFromDeck(deck, eclState);
+            context_().gasPvt = std::make_shared<GasPvt>();
+            context_().gasPvt->initFromDeck(deck, eclState);
         }
 
         if (phaseIsActive(oilPhaseIdx)) {
-            oilPvt_ = std::make_shared<OilPvt>();
-            oilPvt_->initFromDeck(deck, eclState);
+            context_().oilPvt = std::make_shared<OilPvt>();
+            context_().oilPvt->initFromDeck(deck, eclState);
         }
 
         if (phaseIsActive(waterPhaseIdx)) {
-            waterPvt_ = std::make_shared<WaterPvt>();
-            waterPvt_->initFromDeck(deck, eclState);
+            context_().waterPvt = std::make_shared<WaterPvt>();
+            context_().waterPvt->initFromDeck(deck, eclState);
         }
 
         initEnd();
@@ -243,11 +743,21 @@ public:
      */
     static void initBegin(size_t numPvtRegions)
     {
-        enableDissolvedGas_ = true;
-        enableVaporizedOil_ = false;
+        if (PhaseConfig::isStatic) {
+            context_().enableDissolvedGas = PhaseConfig::enableDissolvedGas();
+            context_().enableVaporizedOil = PhaseConfig::enableVaporizedOil();
+
+            context_().numActivePhases = PhaseConfig::numActivePhases();
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                context_().phaseIsActive[phaseIdx] = PhaseConfig::phaseIsActive(phaseIdx);
+        }
+        else {
+            context_().enableDissolvedGas = true;
+            context_().enableVaporizedOil = false;
 
-        numActivePhases_ = numPhases;
-        std::fill(&phaseIsActive_[0], &phaseIsActive_[numPhases], true);
+            context_().numActivePhases = numPhases;
+            context_().phaseIsActive.fill(true);
+        }
 
         resizeArrays_(numPvtRegions);
 
@@ -261,7 +771,7 @@ public:
      * By default, dissolved gas is considered.
      */
     static void setEnableDissolvedGas(bool yesno)
-    { enableDissolvedGas_ = yesno; }
+    { context_().enableDissolvedGas = yesno; }
 
     /*!
      * \brief Specify whether the fluid system should consider that the oil component can
@@ -270,25 +780,50 @@ public:
      * By default, vaporized oil is not considered.
      */
     static void setEnableVaporizedOil(bool yesno)
-    { enableVaporizedOil_ = yesno; }
+    { context_().enableVaporizedOil = yesno; }
+
+    /*!
+     * \brief Specify the width of the saturation interval in which the saturated and
+     *        the undersaturated quantities of the oil and gas phases are blended.
+     *
+     * If the saturation of the gas (oil) phase is below this value, the properties of
+     * the oil (gas) phase are a mixture of the ones of the saturated and the
+     * undersaturated fluid. By default, the width is 10^-4.
+     */
+    static void setSaturatedSwitchWidth(Scalar value)
+    {
+        if (!(value > 0.0))
+            OPM_THROW(std::invalid_argument,
+                      "The width of the saturated/undersaturated transition must be positive");
+        context_().saturatedSwitchWidth = value;
+    }
+
+    /*!
+     * \brief Specify the function which blends the saturated and the undersaturated
+     *        quantities of the oil and gas phases.
+     *
+     * By default, the quantities are blended linearly.
+     */
+    static void setSaturatedSwitchFunction(SaturatedSwitchFunction value)
+    { context_().saturatedSwitchFunction = value; }
 
     /*!
      * \brief Set the pressure-volume-saturation (PVT) relations for the gas phase.
      */
     static void setGasPvt(std::shared_ptr<GasPvt> pvtObj)
-    { gasPvt_ = pvtObj; }
+    { context_().gasPvt = pvtObj; }
 
     /*!
      * \brief Set the pressure-volume-saturation (PVT) relations for the oil phase.
      */
     static void setOilPvt(std::shared_ptr<OilPvt> pvtObj)
-    { oilPvt_ = pvtObj; }
+    { context_().oilPvt = pvtObj; }
 
     /*!
      * \brief Set the pressure-volume-saturation (PVT) relations for the water phase.
      */
     static void setWaterPvt(std::shared_ptr<WaterPvt> pvtObj)
-    { waterPvt_ = pvtObj; }
+    { context_().waterPvt = pvtObj; }
 
     /*!
      * \brief Initialize the values of the reference densities
@@ -302,9 +837,9 @@ public:
                                       Scalar rhoGas,
                                       unsigned regionIdx)
     {
-        referenceDensity_[regionIdx][oilPhaseIdx] = rhoOil;
-        referenceDensity_[regionIdx][waterPhaseIdx] = rhoWater;
-        referenceDensity_[regionIdx][gasPhaseIdx] = rhoGas;
+        context_().referenceDensity[regionIdx][oilPhaseIdx] = rhoOil;
+        context_().referenceDensity[regionIdx][waterPhaseIdx] = rhoWater;
+        context_().referenceDensity[regionIdx][gasPhaseIdx] = rhoGas;
     }
 
     /*!
@@ -312,34 +847,116 @@ public:
      */
     static void initEnd()
     {
+        checkPhaseConfig_();
+
         // calculate the final 2D functions which are used for interpolation.
-        size_t numRegions = molarMass_.size();
+        size_t numRegions = context_().molarMass.size();
         for (unsigned regionIdx = 0; regionIdx < numRegions; ++ regionIdx) {
             // calculate molar masses
 
             // water is simple: 18 g/mol
-            molarMass_[regionIdx][waterCompIdx] = 18e-3;
+            context_().molarMass[regionIdx][waterCompIdx] = 18e-3;
 
             if (phaseIsActive(gasPhaseIdx)) {
                 // for gas, we take the density at standard conditions and assume it to be ideal
                 Scalar p = surfacePressure;
                 Scalar T = surfaceTemperature;
-                Scalar rho_g = referenceDensity_[/*regionIdx=*/0][gasPhaseIdx];
-                molarMass_[regionIdx][gasCompIdx] = Opm::Constants<Scalar>::R*T*rho_g / p;
+                Scalar rho_g = context_().referenceDensity[/*regionIdx=*/0][gasPhaseIdx];
+                context_().molarMass[regionIdx][gasCompIdx] = Opm::Constants<Scalar>::R*T*rho_g / p;
             }
             else
                 // hydrogen gas. we just set this do avoid NaNs later
-                molarMass_[regionIdx][gasCompIdx] = 2e-3;
+                context_().molarMass[regionIdx][gasCompIdx] = 2e-3;
 
             // finally, for oil phase, we take the molar mass from the spe9 paper
-            molarMass_[regionIdx][oilCompIdx] = 175e-3; // kg/mol
+            context_().molarMass[regionIdx][oilCompIdx] = 175e-3; // kg/mol
         }
 
-        isInitialized_ = true;
+        context_().isInitialized = true;
     }
 
     static bool isInitialized()
-    { return isInitialized_; }
+    { return context_().isInitialized; }
+
+    /*!
+     * \brief Write the state of the fluid system including the PVT objects of all
+     *        phases to a binary blob.
+     *
+     * The blob can be used to initialize the fluid system using deserialize() instead
+     * of initFromDeck(), e.g., if many runs use the same PVT properties.
+     */
+    static void serialize(BinaryWriter& writer)
+    {
+        const auto& ctx = context_();
+        if (!ctx.isInitialized)
+            OPM_THROW(std::logic_error, "Cannot serialize an uninitialized fluid system");
+
+        writer.write(ctx.enableDissolvedGas);
+        writer.write(ctx.enableVaporizedOil);
+        writer.write(ctx.phaseIsActive);
+        writer.write(ctx.numActivePhases);
+        writer.write(ctx.referenceDensity);
+        writer.write(ctx.reservoirTemperature);
+        writer.write(ctx.saturatedSwitchWidth);
+        writer.write(static_cast<std::int32_t>(ctx.saturatedSwitchFunction));
+
+        writer.write(static_cast<std::uint8_t>(ctx.gasPvt != nullptr));
+        if (ctx.gasPvt)
+            ctx.gasPvt->serialize(writer);
+        writer.write(static_cast<std::uint8_t>(ctx.oilPvt != nullptr));
+        if (ctx.oilPvt)
+            ctx.oilPvt->serialize(writer);
+        writer.write(static_cast<std::uint8_t>(ctx.waterPvt != nullptr));
+        if (ctx.waterPvt)
+            ctx.waterPvt->serialize(writer);
+    }
+
+    /*!
+     * \brief Initialize the fluid system from a blob which was written by serialize().
+     *
+     * This replaces the calls to initBegin(), the setters and initEnd().
+     */
+    static void deserialize(BinaryReader& reader)
+    {
+        auto& ctx = context_();
+        reader.read(ctx.enableDissolvedGas);
+        reader.read(ctx.enableVaporizedOil);
+        reader.read(ctx.phaseIsActive);
+        reader.read(ctx.numActivePhases);
+        reader.read(ctx.referenceDensity);
+        reader.read(ctx.reservoirTemperature);
+        reader.read(ctx.saturatedSwitchWidth);
+        std::int32_t switchFunction;
+        reader.read(switchFunction);
+        if (switchFunction < static_cast<std::int32_t>(SaturatedSwitchFunction::Linear)
+            || switchFunction > static_cast<std::int32_t>(SaturatedSwitchFunction::SmootherStep))
+            OPM_THROW(std::runtime_error,
+                      "Corrupt serialized data: invalid saturated switch function " << switchFunction);
+        ctx.saturatedSwitchFunction = static_cast<SaturatedSwitchFunction>(switchFunction);
+        resizeArrays_(ctx.referenceDensity.size());
+
+        std::uint8_t hasPvt;
+        reader.read(hasPvt);
+        ctx.gasPvt.reset();
+        if (hasPvt) {
+            ctx.gasPvt = std::make_shared<GasPvt>();
+            ctx.gasPvt->deserialize(reader);
+        }
+        reader.read(hasPvt);
+        ctx.oilPvt.reset();
+        if (hasPvt) {
+            ctx.oilPvt = std::make_shared<OilPvt>();
+            ctx.oilPvt->deserialize(reader);
+        }
+        reader.read(hasPvt);
+        ctx.waterPvt.reset();
+        if (hasPvt) {
+            ctx.waterPvt = std::make_shared<WaterPvt>();
+            ctx.waterPvt->deserialize(reader);
+        }
+
+        initEnd();
+    }
 
     /****************************************
      * Generic phase properties
@@ -395,19 +1012,22 @@ protected:
     static const int phaseToSolventCompIdx_[3];
     static const int phaseToSoluteCompIdx_[3];
 
-    static unsigned char numActivePhases_;
-    static bool phaseIsActive_[numPhases];
-
 public:
     //! \brief Returns the number of active fluid phases (i.e., usually three)
     static unsigned numActivePhases()
-    { return numActivePhases_; }
+    {
+        if (PhaseConfig::isStatic)
+            return PhaseConfig::numActivePhases();
+        return context_().numActivePhases;
+    }
 
     //! \brief Returns whether a fluid phase is active
     static unsigned phaseIsActive(unsigned phaseIdx)
     {
         assert(phaseIdx < numPhases);
-        return phaseIsActive_[phaseIdx];
+        if (PhaseConfig::isStatic)
+            return PhaseConfig::phaseIsActive(phaseIdx);
+        return context_().phaseIsActive[phaseIdx];
     }
 
     //! \brief returns the index of "primary" component of a phase (solvent)
@@ -429,7 +1049,7 @@ public:
 
     //! \copydoc BaseFluidSystem::molarMass
     static Scalar molarMass(unsigned compIdx, unsigned regionIdx = 0)
-    { return molarMass_[regionIdx][compIdx]; }
+    { return context_().molarMass[regionIdx][compIdx]; }
 
     //! \copydoc BaseFluidSystem::isIdealMixture
     static bool isIdealMixture(unsigned /*phaseIdx*/)
@@ -457,7 +1077,7 @@ public:
      * By default, this is 1.
      */
     static size_t numRegions()
-    { return molarMass_.size(); }
+    { return context_().molarMass.size(); }
 
     /*!
      * \brief Returns whether the fluid system should consider that the gas component can
@@ -466,7 +1086,11 @@ public:
      * By default, dissolved gas is considered.
      */
     static bool enableDissolvedGas()
-    { return enableDissolvedGas_; }
+    {
+        if (PhaseConfig::isStatic)
+            return PhaseConfig::enableDissolvedGas();
+        return context_().enableDissolvedGas;
+    }
 
     /*!
      * \brief Returns whether the fluid system should consider that the oil component can
@@ -475,7 +1099,25 @@ public:
      * By default, vaporized oil is not considered.
      */
     static bool enableVaporizedOil()
-    { return enableVaporizedOil_; }
+    {
+        if (PhaseConfig::isStatic)
+            return PhaseConfig::enableVaporizedOil();
+        return context_().enableVaporizedOil;
+    }
+
+    /*!
+     * \brief Returns the width of the saturation interval in which the saturated and
+     *        the undersaturated quantities of the oil and gas phases are blended.
+     */
+    static Scalar saturatedSwitchWidth()
+    { return context_().saturatedSwitchWidth; }
+
+    /*!
+     * \brief Returns the function which blends the saturated and the undersaturated
+     *        quantities of the oil and gas phases.
+     */
+    static SaturatedSwitchFunction saturatedSwitchFunction()
+    { return context_().saturatedSwitchFunction; }
 
     /*!
      * \brief Returns the density of a fluid phase at surface pressure [kg/m^3]
@@ -483,7 +1125,7 @@ public:
      * \copydoc Doxygen::phaseIdxParam
      */
     static Scalar referenceDensity(unsigned phaseIdx, unsigned regionIdx)
-    { return referenceDensity_[regionIdx][phaseIdx]; }
+    { return context_().referenceDensity[regionIdx][phaseIdx]; }
 
     /****************************************
      * thermodynamic quantities (generic version, only isothermal)
@@ -493,7 +1135,15 @@ public:
     static LhsEval density(const FluidState& fluidState,
                            const ParameterCache<ParamCacheEval>& paramCache,
                            unsigned phaseIdx)
-    { return density<FluidState, LhsEval>(fluidState, phaseIdx, paramCache.regionIndex()); }
+    {
+        unsigned regionIdx = paramCache.regionIndex();
+        LhsEval b;
+        if (paramCache.phaseIsUpToDate(phaseIdx)
+            && decayCached_(b, paramCache.inverseFormationVolumeFactor(phaseIdx)))
+            return densityFromInvB_<FluidState, LhsEval>(fluidState, b, phaseIdx, regionIdx);
+
+        return density<FluidState, LhsEval>(fluidState, phaseIdx, regionIdx);
+    }
 
     //! \copydoc BaseFluidSystem::fugacityCoefficient
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
@@ -502,10 +1152,42 @@ public:
                                        unsigned phaseIdx,
                                        unsigned compIdx)
     {
+        unsigned regionIdx = paramCache.regionIndex();
+
+        // only the fugacity coefficients of the dissolved components depend on
+        // quantities which are expensive to compute
+        bool isSoluteInGas =
+            phaseIdx == gasPhaseIdx && compIdx == oilCompIdx && enableVaporizedOil();
+        bool isSoluteInOil =
+            phaseIdx == oilPhaseIdx && compIdx == gasCompIdx && enableDissolvedGas();
+
+        LhsEval RsSat;
+        LhsEval RvSat;
+        if ((isSoluteInGas || isSoluteInOil)
+            && paramCache.phaseIsUpToDate(phaseIdx)
+            && decayCached_(RsSat, paramCache.saturatedRs(phaseIdx))
+            && decayCached_(RvSat, paramCache.saturatedRv(phaseIdx)))
+        {
+            if (isSoluteInGas)
+                return gasPhaseOilFugacityCoefficient_<FluidState, LhsEval>(fluidState, RsSat, RvSat, regionIdx);
+            return oilPhaseGasFugacityCoefficient_<FluidState, LhsEval>(fluidState, RsSat, RvSat, regionIdx);
+        }
+
         return fugacityCoefficient<FluidState, LhsEval>(fluidState,
                                                         phaseIdx,
                                                         compIdx,
-                                                        paramCache.regionIndex());
+                                                        regionIdx);
+    }
+
+    //! \copydoc BaseFluidSystem::fugacityCoefficients
+    template <class FluidState, class Container, class ParamCacheEval>
+    static void fugacityCoefficients(const FluidState& fluidState,
+                                     const ParameterCache<ParamCacheEval>& paramCache,
+                                     unsigned phaseIdx,
+                                     Container& fugCoeffs)
+    {
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            fugCoeffs[compIdx] = fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx);
     }
 
     //! \copydoc BaseFluidSystem::viscosity
@@ -513,62 +1195,266 @@ public:
     static LhsEval viscosity(const FluidState& fluidState,
                              const ParameterCache<ParamCacheEval>& paramCache,
                              unsigned phaseIdx)
-    { return viscosity<FluidState, LhsEval>(fluidState, phaseIdx, paramCache.regionIndex()); }
+    {
+        LhsEval mu;
+        if (paramCache.phaseIsUpToDate(phaseIdx)
+            && decayCached_(mu, paramCache.viscosity(phaseIdx)))
+            return mu;
 
+        return viscosity<FluidState, LhsEval>(fluidState, phaseIdx, paramCache.regionIndex());
+    }
 
-    /****************************************
-     * thermodynamic quantities (black-oil specific version: Note that the PVT region
-     * index is explicitly passed instead of a parameter cache object)
-     ****************************************/
-    //! \copydoc BaseFluidSystem::density
+    /*!
+     * \brief Returns the inverse formation volume factor of a fluid phase using the
+     *        quantities stored by a parameter cache.
+     *
+     * If the parameter cache is not up to date for the given phase, the quantity is
+     * computed from scratch.
+     */
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval inverseFormationVolumeFactor(const FluidState& fluidState,
+                                                const ParameterCache<ParamCacheEval>& paramCache,
+                                                unsigned phaseIdx)
+    {
+        LhsEval b;
+        if (paramCache.phaseIsUpToDate(phaseIdx)
+            && decayCached_(b, paramCache.inverseFormationVolumeFactor(phaseIdx)))
+            return b;
+
+        return inverseFormationVolumeFactor<FluidState, LhsEval>(fluidState, phaseIdx, paramCache.regionIndex());
+    }
+
+    /*!
+     * \brief The properties of all fluid phases as computed by
+     *        computeAllPhaseProperties()
+     *
+     * The entries of inactive phases are not touched by computeAllPhaseProperties().
+     */
+    template <class LhsEval>
+    struct PhaseProperties
+    {
+        //! The inverse formation volume factors 1/B of the phases
+        std::array<LhsEval, /*numPhases=*/3> invB;
+
+        //! The densities of the phases [kg/m^3]
+        std::array<LhsEval, /*numPhases=*/3> density;
+
+        //! The viscosities of the phases [Pa s]
+        std::array<LhsEval, /*numPhases=*/3> viscosity;
+
+        //! The dissolution factors of the saturated phases, i.e., R_s for oil, R_v for
+        //! gas and 0 for water (cf. saturatedDissolutionFactor())
+        std::array<LhsEval, /*numPhases=*/3> saturatedDissolutionFactor;
+    };
+
+    /*!
+     * \brief Compute the inverse formation volume factor, the density, the viscosity
+     *        and the saturated dissolution factor of all active phases at once.
+     *
+     * The results are the same as the ones of the individual methods, but the
+     * pressure, temperature and R_s/R_v of each phase are only determined once and
+     * each PVT curve is evaluated at most once per phase.
+     */
     template <class FluidState, class LhsEval = typename FluidState::Scalar>
-    static LhsEval density(const FluidState& fluidState,
-                           unsigned phaseIdx,
-                           unsigned regionIdx)
+    static void computeAllPhaseProperties(const FluidState& fluidState,
+                                          unsigned regionIdx,
+                                          PhaseProperties<LhsEval>& result)
     {
-        assert(0 <= phaseIdx && phaseIdx <= numPhases);
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::computeAllPhaseProperties");
+
         assert(0 <= regionIdx && regionIdx <= numRegions());
 
-        switch (phaseIdx) {
-        case oilPhaseIdx: {
-            if (!enableDissolvedGas()) {
-                // immiscible oil
-                const auto& bo = inverseFormationVolumeFactor<FluidState, LhsEval>(fluidState, oilPhaseIdx, regionIdx);
-                return referenceDensity(phaseIdx, regionIdx)*bo;
-            }
+        if (phaseIsActive(waterPhaseIdx)) {
+            const auto& p = Opm::decay<LhsEval>(fluidState.pressure(waterPhaseIdx));
+            const auto& T = Opm::decay<LhsEval>(fluidState.temperature(waterPhaseIdx));
+
+            const auto& b = context_().waterPvt->inverseFormationVolumeFactor(regionIdx, T, p);
+            result.invB[waterPhaseIdx] = b;
+            result.density[waterPhaseIdx] = referenceDensity(waterPhaseIdx, regionIdx)*b;
+            result.viscosity[waterPhaseIdx] = context_().waterPvt->viscosity(regionIdx, T, p);
+            result.saturatedDissolutionFactor[waterPhaseIdx] = 0.0;
+        }
 
-            // miscible oil
-            const auto& bo = inverseFormationVolumeFactor<FluidState, LhsEval>(fluidState, oilPhaseIdx, regionIdx);
-            const auto& Rs = Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
+        if (phaseIsActive(oilPhaseIdx)) {
+            const auto& p = Opm::decay<LhsEval>(fluidState.pressure(oilPhaseIdx));
+            const auto& T = Opm::decay<LhsEval>(fluidState.temperature(oilPhaseIdx));
 
-            return
-                bo*referenceDensity(oilPhaseIdx, regionIdx)
-                + Rs*bo*referenceDensity(gasPhaseIdx, regionIdx);
+            LhsEval& b = result.invB[oilPhaseIdx];
+            if (enableDissolvedGas()) {
+                const auto& Rs = Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
+                oilInvBAndViscosity_(b, result.viscosity[oilPhaseIdx], fluidState, T, p, Rs, regionIdx);
+                result.density[oilPhaseIdx] =
+                    b*referenceDensity(oilPhaseIdx, regionIdx)
+                    + Rs*b*referenceDensity(gasPhaseIdx, regionIdx);
+            }
+            else {
+                const LhsEval Rs(0.0);
+                oilInvBAndViscosity_(b, result.viscosity[oilPhaseIdx], fluidState, T, p, Rs, regionIdx);
+                result.density[oilPhaseIdx] = referenceDensity(oilPhaseIdx, regionIdx)*b;
+            }
+            result.saturatedDissolutionFactor[oilPhaseIdx] =
+                context_().oilPvt->saturatedGasDissolutionFactor(regionIdx, T, p);
         }
 
-        case gasPhaseIdx: {
-            if (!enableVaporizedOil()) {
-                // immiscible gas
-                const auto& bg = inverseFormationVolumeFactor<FluidState, LhsEval>(fluidState, gasPhaseIdx, regionIdx);
-                return bg*referenceDensity(phaseIdx, regionIdx);
+        if (phaseIsActive(gasPhaseIdx)) {
+            const auto& p = Opm::decay<LhsEval>(fluidState.pressure(gasPhaseIdx));
+            const auto& T = Opm::decay<LhsEval>(fluidState.temperature(gasPhaseIdx));
+
+            LhsEval& b = result.invB[gasPhaseIdx];
+            if (enableVaporizedOil()) {
+                const auto& Rv = Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
+                gasInvBAndViscosity_(b, result.viscosity[gasPhaseIdx], fluidState, T, p, Rv, regionIdx);
+                result.density[gasPhaseIdx] =
+                    b*referenceDensity(gasPhaseIdx, regionIdx)
+                    + Rv*b*referenceDensity(oilPhaseIdx, regionIdx);
             }
+            else {
+                const LhsEval Rv(0.0);
+                gasInvBAndViscosity_(b, result.viscosity[gasPhaseIdx], fluidState, T, p, Rv, regionIdx);
+                result.density[gasPhaseIdx] = b*referenceDensity(gasPhaseIdx, regionIdx);
+            }
+            result.saturatedDissolutionFactor[gasPhaseIdx] =
+                context_().gasPvt->saturatedOilVaporizationFactor(regionIdx, T, p);
+        }
+    }
 
-            // miscible gas
-            const auto& bg = inverseFormationVolumeFactor<FluidState, LhsEval>(fluidState, gasPhaseIdx, regionIdx);
-            const auto& Rv = Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
 
-            return
-                bg*referenceDensity(gasPhaseIdx, regionIdx)
-                + Rv*bg*referenceDensity(oilPhaseIdx, regionIdx);
+    /*!
+     * \brief The per-cell input quantities of exportPhaseProperties().
+     *
+     * All arrays are indexed by the cell. The pressures are only required for the
+     * active phases, R_s only if dissolved gas is enabled and R_v only if vaporized oil
+     * is enabled.
+     */
+    struct PropertyExportInput
+    {
+        PropertyExportInput()
+            : numCells(0)
+            , regionIdx(nullptr)
+            , temperature(nullptr)
+            , Rs(nullptr)
+            , Rv(nullptr)
+        {
+            pressure.fill(nullptr);
+            saturation.fill(nullptr);
         }
 
-        case waterPhaseIdx:
-            return
-                referenceDensity(waterPhaseIdx, regionIdx)
-                *inverseFormationVolumeFactor<FluidState, LhsEval>(fluidState, waterPhaseIdx, regionIdx);
+        //! The number of cells
+        size_t numCells;
+
+        //! The PVT region of each cell. If it is nullptr, all cells are in region 0.
+        const unsigned* regionIdx;
+
+        //! The temperature of each cell. If it is nullptr, the reservoir temperature
+        //! is used.
+        const Scalar* temperature;
+
+        //! The pressures of the phases
+        std::array<const Scalar*, /*numPhases=*/3> pressure;
+
+        //! The saturations of the phases. Without them, all phases are considered to
+        //! be absent, i.e., the undersaturated curves are used for R_s and R_v.
+        std::array<const Scalar*, /*numPhases=*/3> saturation;
+
+        //! The gas dissolution factors of the oil phase
+        const Scalar* Rs;
+
+        //! The oil vaporization factors of the gas phase
+        const Scalar* Rv;
+    };
+
+    /*!
+     * \brief The arrays which receive the results of exportPhaseProperties().
+     *
+     * Only the quantities of the phases whose array is not nullptr are written. The
+     * meaning of the quantities is the same as for PhaseProperties.
+     */
+    struct PropertyExportOutput
+    {
+        PropertyExportOutput()
+        {
+            invB.fill(nullptr);
+            density.fill(nullptr);
+            viscosity.fill(nullptr);
+            saturatedDissolutionFactor.fill(nullptr);
         }
 
-        OPM_THROW(std::logic_error, "Unhandled phase index " << phaseIdx);
+        std::array<Scalar*, /*numPhases=*/3> invB;
+        std::array<Scalar*, /*numPhases=*/3> density;
+        std::array<Scalar*, /*numPhases=*/3> viscosity;
+        std::array<Scalar*, /*numPhases=*/3> saturatedDissolutionFactor;
+    };
+
+    /*!
+     * \brief Compute the properties of the phases for many cells at once and store the
+     *        requested ones in the arrays provided by the caller.
+     *
+     * This is intended for writing the results of a report step: The inputs and the
+     * results are plain scalars, i.e., no derivatives are computed and no fluid state
+     * objects are required. The cells are distributed among the OpenMP threads, which
+     * all use the context of the calling thread. The values are the same as the ones
+     * of computeAllPhaseProperties() for a fluid state with the given quantities.
+     */
+    static void exportPhaseProperties(const PropertyExportInput& input,
+                                      const PropertyExportOutput& output)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::exportPhaseProperties");
+
+        Context& callerContext = context_();
+        const long numCells = static_cast<long>(input.numCells);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ScopedContext scopedContext(callerContext);
+            PhaseProperties<Scalar> props;
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (long i = 0; i < numCells; ++i) {
+                const size_t cellIdx = static_cast<size_t>(i);
+                const Opm::BlackOil::PropertyExportCellState<Scalar, PropertyExportInput>
+                    fluidState(input, cellIdx, callerContext.reservoirTemperature);
+                const unsigned regionIdx = input.regionIdx ? input.regionIdx[cellIdx] : 0;
+                computeAllPhaseProperties(fluidState, regionIdx, props);
+
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                    if (!phaseIsActive(phaseIdx))
+                        continue;
+
+                    if (output.invB[phaseIdx])
+                        output.invB[phaseIdx][cellIdx] = props.invB[phaseIdx];
+                    if (output.density[phaseIdx])
+                        output.density[phaseIdx][cellIdx] = props.density[phaseIdx];
+                    if (output.viscosity[phaseIdx])
+                        output.viscosity[phaseIdx][cellIdx] = props.viscosity[phaseIdx];
+                    if (output.saturatedDissolutionFactor[phaseIdx])
+                        output.saturatedDissolutionFactor[phaseIdx][cellIdx] =
+                            props.saturatedDissolutionFactor[phaseIdx];
+                }
+            }
+        }
+    }
+
+    /****************************************
+     * thermodynamic quantities (black-oil specific version: Note that the PVT region
+     * index is explicitly passed instead of a parameter cache object)
+     ****************************************/
+    //! \copydoc BaseFluidSystem::density
+    template <class FluidState, class LhsEval = typename FluidState::Scalar>
+    static LhsEval density(const FluidState& fluidState,
+                           unsigned phaseIdx,
+                           unsigned regionIdx)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::density");
+
+        assert(0 <= phaseIdx && phaseIdx <= numPhases);
+        assert(0 <= regionIdx && regionIdx <= numRegions());
+
+        const auto& b = inverseFormationVolumeFactor<FluidState, LhsEval>(fluidState, phaseIdx, regionIdx);
+        return densityFromInvB_<FluidState, LhsEval>(fluidState, b, phaseIdx, regionIdx);
     }
 
     /*!
@@ -641,6 +1527,8 @@ public:
                                                 unsigned phaseIdx,
                                                 unsigned regionIdx)
     {
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::inverseFormationVolumeFactor");
+
         assert(0 <= phaseIdx && phaseIdx <= numPhases);
         assert(0 <= regionIdx && regionIdx <= numRegions());
 
@@ -651,53 +1539,53 @@ public:
         case oilPhaseIdx: {
             if (enableDissolvedGas()) {
                 if (fluidState.phaseIsPresent(gasPhaseIdx)) {
-                    if (fluidState.saturation(gasPhaseIdx) < 1e-4) {
+                    if (fluidState.saturation(gasPhaseIdx) < saturatedSwitchWidth()) {
                         // here comes the relatively expensive case: first calculate and then
                         // interpolate between the saturated and undersaturated quantities to
                         // avoid a discontinuity
                         const auto& Rs = Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
-                        const auto& alpha = Opm::decay<LhsEval>(fluidState.saturation(gasPhaseIdx))/1e-4;
-                        const auto& bSat = oilPvt_->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
-                        const auto& bUndersat = oilPvt_->inverseFormationVolumeFactor(regionIdx, T, p, Rs);
+                        const auto& alpha = saturatedSwitchWeight_<LhsEval>(fluidState.saturation(gasPhaseIdx));
+                        const auto& bSat = context_().oilPvt->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
+                        const auto& bUndersat = context_().oilPvt->inverseFormationVolumeFactor(regionIdx, T, p, Rs);
                         return alpha*bSat + (1.0 - alpha)*bUndersat;
                     }
 
-                    return oilPvt_->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
+                    return context_().oilPvt->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
                 }
 
                 const auto& Rs = Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
-                return oilPvt_->inverseFormationVolumeFactor(regionIdx, T, p, Rs);
+                return context_().oilPvt->inverseFormationVolumeFactor(regionIdx, T, p, Rs);
             }
 
             const LhsEval Rs(0.0);
-            return oilPvt_->inverseFormationVolumeFactor(regionIdx, T, p, Rs);
+            return context_().oilPvt->inverseFormationVolumeFactor(regionIdx, T, p, Rs);
         }
         case gasPhaseIdx: {
             if (enableVaporizedOil()) {
                 if (fluidState.phaseIsPresent(oilPhaseIdx)) {
-                    if (fluidState.saturation(oilPhaseIdx) < 1e-4) {
+                    if (fluidState.saturation(oilPhaseIdx) < saturatedSwitchWidth()) {
                         // here comes the relatively expensive case: first calculate and then
                         // interpolate between the saturated and undersaturated quantities to
                         // avoid a discontinuity
                         const auto& Rv = Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
-                        const auto& alpha = Opm::decay<LhsEval>(fluidState.saturation(oilPhaseIdx))/1e-4;
-                        const auto& bSat = gasPvt_->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
-                        const auto& bUndersat = gasPvt_->inverseFormationVolumeFactor(regionIdx, T, p, Rv);
+                        const auto& alpha = saturatedSwitchWeight_<LhsEval>(fluidState.saturation(oilPhaseIdx));
+                        const auto& bSat = context_().gasPvt->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
+                        const auto& bUndersat = context_().gasPvt->inverseFormationVolumeFactor(regionIdx, T, p, Rv);
                         return alpha*bSat + (1.0 - alpha)*bUndersat;
                     }
 
-                    return gasPvt_->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
+                    return context_().gasPvt->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
                 }
 
                 const auto& Rv = Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
-                return gasPvt_->inverseFormationVolumeFactor(regionIdx, T, p, Rv);
+                return context_().gasPvt->inverseFormationVolumeFactor(regionIdx, T, p, Rv);
             }
 
             const LhsEval Rv(0.0);
-            return gasPvt_->inverseFormationVolumeFactor(regionIdx, T, p, Rv);
+            return context_().gasPvt->inverseFormationVolumeFactor(regionIdx, T, p, Rv);
         }
         case waterPhaseIdx:
-            return waterPvt_->inverseFormationVolumeFactor(regionIdx, T, p);
+            return context_().waterPvt->inverseFormationVolumeFactor(regionIdx, T, p);
         default: OPM_THROW(std::logic_error, "Unhandled phase index " << phaseIdx);
         }
     }
@@ -721,9 +1609,9 @@ public:
         const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
 
         switch (phaseIdx) {
-        case oilPhaseIdx: return oilPvt_->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
-        case gasPhaseIdx: return gasPvt_->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
-        case waterPhaseIdx: return waterPvt_->inverseFormationVolumeFactor(regionIdx, T, p);
+        case oilPhaseIdx: return context_().oilPvt->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
+        case gasPhaseIdx: return context_().gasPvt->saturatedInverseFormationVolumeFactor(regionIdx, T, p);
+        case waterPhaseIdx: return context_().waterPvt->inverseFormationVolumeFactor(regionIdx, T, p);
         default: OPM_THROW(std::logic_error, "Unhandled phase index " << phaseIdx);
         }
     }
@@ -735,6 +1623,8 @@ public:
                                        unsigned compIdx,
                                        unsigned regionIdx)
     {
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::fugacityCoefficient");
+
         assert(0 <= phaseIdx && phaseIdx <= numPhases);
         assert(0 <= compIdx && compIdx <= numComponents);
         assert(0 <= regionIdx && regionIdx <= numRegions());
@@ -770,19 +1660,9 @@ public:
                     // immiscible with the oil component
                     return phi_gG*1e6;
 
-                const auto& R_vSat = gasPvt_->saturatedOilVaporizationFactor(regionIdx, T, p);
-                const auto& X_gOSat = convertRvToXgO(R_vSat, regionIdx);
-                const auto& x_gOSat = convertXgOToxgO(X_gOSat, regionIdx);
-
-                const auto& R_sSat = oilPvt_->saturatedGasDissolutionFactor(regionIdx, T, p);
-                const auto& X_oGSat = convertRsToXoG(R_sSat, regionIdx);
-                const auto& x_oGSat = convertXoGToxoG(X_oGSat, regionIdx);
-                const auto& x_oOSat = 1.0 - x_oGSat;
-
-                const auto& p_o = Opm::decay<LhsEval>(fluidState.pressure(oilPhaseIdx));
-                const auto& p_g = Opm::decay<LhsEval>(fluidState.pressure(gasPhaseIdx));
-
-                return phi_oO*p_o*x_oOSat / (p_g*x_gOSat);
+                const auto& R_vSat = context_().gasPvt->saturatedOilVaporizationFactor(regionIdx, T, p);
+                const auto& R_sSat = context_().oilPvt->saturatedGasDissolutionFactor(regionIdx, T, p);
+                return gasPhaseOilFugacityCoefficient_<FluidState, LhsEval>(fluidState, R_sSat, R_vSat, regionIdx);
             }
 
             case waterCompIdx:
@@ -807,19 +1687,9 @@ public:
                     // immiscible with the gas component
                     return phi_oO*1e6;
 
-                const auto& R_vSat = gasPvt_->saturatedOilVaporizationFactor(regionIdx, T, p);
-                const auto& X_gOSat = convertRvToXgO(R_vSat, regionIdx);
-                const auto& x_gOSat = convertXgOToxgO(X_gOSat, regionIdx);
-                const auto& x_gGSat = 1.0 - x_gOSat;
-
-                const auto& R_sSat = oilPvt_->saturatedGasDissolutionFactor(regionIdx, T, p);
-                const auto& X_oGSat = convertRsToXoG(R_sSat, regionIdx);
-                const auto& x_oGSat = convertXoGToxoG(X_oGSat, regionIdx);
-
-                const auto& p_o = Opm::decay<LhsEval>(fluidState.pressure(oilPhaseIdx));
-                const auto& p_g = Opm::decay<LhsEval>(fluidState.pressure(gasPhaseIdx));
-
-                return phi_gG*p_g*x_gGSat / (p_o*x_oGSat);
+                const auto& R_vSat = context_().gasPvt->saturatedOilVaporizationFactor(regionIdx, T, p);
+                const auto& R_sSat = context_().oilPvt->saturatedGasDissolutionFactor(regionIdx, T, p);
+                return oilPhaseGasFugacityCoefficient_<FluidState, LhsEval>(fluidState, R_sSat, R_vSat, regionIdx);
             }
 
             case waterCompIdx:
@@ -854,12 +1724,92 @@ public:
         OPM_THROW(std::logic_error, "Unhandled phase or component index");
     }
 
+    /*!
+     * \brief Compute the fugacity coefficients of all components in all phases.
+     *
+     * 'result[phaseIdx][compIdx]' is set to the value of fugacityCoefficient() for the
+     * respective phase and component. The saturated R_s and R_v factors are only
+     * determined once per phase pressure and temperature, i.e., only once if the oil
+     * and the gas phase are at the same conditions, and the conversions to mole
+     * fractions are shared by both dissolved components.
+     */
+    template <class FluidState, class LhsEval = typename FluidState::Scalar>
+    static void fugacityCoefficients(const FluidState& fluidState,
+                                     unsigned regionIdx,
+                                     LhsEval (&result)[numPhases][numComponents])
+    {
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::fugacityCoefficients");
+
+        assert(0 <= regionIdx && regionIdx <= numRegions());
+
+        const auto& p_o = Opm::decay<LhsEval>(fluidState.pressure(oilPhaseIdx));
+        const auto& p_g = Opm::decay<LhsEval>(fluidState.pressure(gasPhaseIdx));
+        const auto& p_w = Opm::decay<LhsEval>(fluidState.pressure(waterPhaseIdx));
+
+        // see fugacityCoefficient() for the rationale of these values
+        const LhsEval phi_oO = 20e3/p_o;
+        const Scalar phi_gG = 1.0;
+        const LhsEval phi_wW = 30e3/p_w;
+
+        result[gasPhaseIdx][gasCompIdx] = phi_gG;
+        result[gasPhaseIdx][oilCompIdx] = phi_gG*1e6;
+        result[gasPhaseIdx][waterCompIdx] = phi_gG*1e6;
+
+        result[oilPhaseIdx][oilCompIdx] = phi_oO;
+        result[oilPhaseIdx][gasCompIdx] = phi_oO*1e6;
+        result[oilPhaseIdx][waterCompIdx] = phi_oO*1e6;
+
+        result[waterPhaseIdx][waterCompIdx] = phi_wW;
+        result[waterPhaseIdx][oilCompIdx] = 1.1e6*phi_wW;
+        result[waterPhaseIdx][gasCompIdx] = 1e6*phi_wW;
+
+        if (!enableVaporizedOil() && !enableDissolvedGas())
+            return;
+
+        const auto& T_o = Opm::decay<LhsEval>(fluidState.temperature(oilPhaseIdx));
+        const auto& T_g = Opm::decay<LhsEval>(fluidState.temperature(gasPhaseIdx));
+        bool sameConditions = (p_o == p_g && T_o == T_g);
+
+        // the saturated dissolution factors at the conditions of the gas phase
+        LhsEval R_sSat;
+        LhsEval R_vSat;
+        if (enableVaporizedOil() || sameConditions) {
+            R_vSat = context_().gasPvt->saturatedOilVaporizationFactor(regionIdx, T_g, p_g);
+            R_sSat = context_().oilPvt->saturatedGasDissolutionFactor(regionIdx, T_g, p_g);
+        }
+
+        if (enableVaporizedOil() && enableDissolvedGas() && sameConditions) {
+            dissolvedFugacityCoefficients_<FluidState, LhsEval>(result[gasPhaseIdx][oilCompIdx],
+                                                                result[oilPhaseIdx][gasCompIdx],
+                                                                fluidState,
+                                                                R_sSat,
+                                                                R_vSat,
+                                                                regionIdx);
+            return;
+        }
+
+        if (enableVaporizedOil())
+            result[gasPhaseIdx][oilCompIdx] =
+                gasPhaseOilFugacityCoefficient_<FluidState, LhsEval>(fluidState, R_sSat, R_vSat, regionIdx);
+
+        if (enableDissolvedGas()) {
+            if (!sameConditions) {
+                R_vSat = context_().gasPvt->saturatedOilVaporizationFactor(regionIdx, T_o, p_o);
+                R_sSat = context_().oilPvt->saturatedGasDissolutionFactor(regionIdx, T_o, p_o);
+            }
+            result[oilPhaseIdx][gasCompIdx] =
+                oilPhaseGasFugacityCoefficient_<FluidState, LhsEval>(fluidState, R_sSat, R_vSat, regionIdx);
+        }
+    }
+
     //! \copydoc BaseFluidSystem::viscosity
     template <class FluidState, class LhsEval = typename FluidState::Scalar>
     static LhsEval viscosity(const FluidState& fluidState,
                              unsigned phaseIdx,
                              unsigned regionIdx)
     {
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::viscosity");
+
         assert(0 <= phaseIdx && phaseIdx <= numPhases);
         assert(0 <= regionIdx && regionIdx <= numRegions());
 
@@ -870,57 +1820,57 @@ public:
         case oilPhaseIdx: {
             if (enableDissolvedGas()) {
                 if (fluidState.phaseIsPresent(gasPhaseIdx)) {
-                    if (fluidState.saturation(gasPhaseIdx) < 1e-4) {
+                    if (fluidState.saturation(gasPhaseIdx) < saturatedSwitchWidth()) {
                         // here comes the relatively expensive case: first calculate and then
                         // interpolate between the saturated and undersaturated quantities to
                         // avoid a discontinuity
                         const auto& Rs = Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
-                        const auto& alpha = Opm::decay<LhsEval>(fluidState.saturation(gasPhaseIdx))/1e-4;
-                        const auto& muSat = oilPvt_->saturatedViscosity(regionIdx, T, p);
-                        const auto& muUndersat = oilPvt_->viscosity(regionIdx, T, p, Rs);
+                        const auto& alpha = saturatedSwitchWeight_<LhsEval>(fluidState.saturation(gasPhaseIdx));
+                        const auto& muSat = context_().oilPvt->saturatedViscosity(regionIdx, T, p);
+                        const auto& muUndersat = context_().oilPvt->viscosity(regionIdx, T, p, Rs);
                         return alpha*muSat + (1.0 - alpha)*muUndersat;
                     }
 
-                    return oilPvt_->saturatedViscosity(regionIdx, T, p);
+                    return context_().oilPvt->saturatedViscosity(regionIdx, T, p);
                 }
 
                 const auto& Rs = Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
-                return oilPvt_->viscosity(regionIdx, T, p, Rs);
+                return context_().oilPvt->viscosity(regionIdx, T, p, Rs);
             }
 
             const LhsEval Rs(0.0);
-            return oilPvt_->viscosity(regionIdx, T, p, Rs);
+            return context_().oilPvt->viscosity(regionIdx, T, p, Rs);
         }
 
         case gasPhaseIdx: {
             if (enableVaporizedOil()) {
                 if (fluidState.phaseIsPresent(oilPhaseIdx)) {
-                    if (fluidState.saturation(oilPhaseIdx) < 1e-4) {
+                    if (fluidState.saturation(oilPhaseIdx) < saturatedSwitchWidth()) {
                         // here comes the relatively expensive case: first calculate and then
                         // interpolate between the saturated and undersaturated quantities to
                         // avoid a discontinuity
                         const auto& Rv = Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
-                        const auto& alpha = Opm::decay<LhsEval>(fluidState.saturation(oilPhaseIdx))/1e-4;
-                        const auto& muSat = gasPvt_->saturatedViscosity(regionIdx, T, p);
-                        const auto& muUndersat = gasPvt_->viscosity(regionIdx, T, p, Rv);
+                        const auto& alpha = saturatedSwitchWeight_<LhsEval>(fluidState.saturation(oilPhaseIdx));
+                        const auto& muSat = context_().gasPvt->saturatedViscosity(regionIdx, T, p);
+                        const auto& muUndersat = context_().gasPvt->viscosity(regionIdx, T, p, Rv);
                         return alpha*muSat + (1.0 - alpha)*muUndersat;
                     }
 
-                    return gasPvt_->saturatedViscosity(regionIdx, T, p);
+                    return context_().gasPvt->saturatedViscosity(regionIdx, T, p);
                 }
 
                 const auto& Rv = Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
-                return gasPvt_->viscosity(regionIdx, T, p, Rv);
+                return context_().gasPvt->viscosity(regionIdx, T, p, Rv);
             }
 
             const LhsEval Rv(0.0);
-            return gasPvt_->viscosity(regionIdx, T, p, Rv);
+            return context_().gasPvt->viscosity(regionIdx, T, p, Rv);
         }
 
         case waterPhaseIdx:
             // since water is always assumed to be immiscible in the black-oil model,
             // there is no "saturated water"
-            return waterPvt_->viscosity(regionIdx, T, p);
+            return context_().waterPvt->viscosity(regionIdx, T, p);
         }
 
         OPM_THROW(std::logic_error, "Unhandled phase index " << phaseIdx);
@@ -946,8 +1896,8 @@ public:
         const auto& So = Opm::decay<LhsEval>(fluidState.saturation(oilPhaseIdx));
 
         switch (phaseIdx) {
-        case oilPhaseIdx: return oilPvt_->saturatedGasDissolutionFactor(regionIdx, T, p, So, maxOilSaturation);
-        case gasPhaseIdx: return gasPvt_->saturatedOilVaporizationFactor(regionIdx, T, p, So, maxOilSaturation);
+        case oilPhaseIdx: return context_().oilPvt->saturatedGasDissolutionFactor(regionIdx, T, p, So, maxOilSaturation);
+        case gasPhaseIdx: return context_().gasPvt->saturatedOilVaporizationFactor(regionIdx, T, p, So, maxOilSaturation);
         case waterPhaseIdx: return 0.0;
         default: OPM_THROW(std::logic_error, "Unhandled phase index " << phaseIdx);
         }
@@ -973,8 +1923,8 @@ public:
         const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
 
         switch (phaseIdx) {
-        case oilPhaseIdx: return oilPvt_->saturatedGasDissolutionFactor(regionIdx, T, p);
-        case gasPhaseIdx: return gasPvt_->saturatedOilVaporizationFactor(regionIdx, T, p);
+        case oilPhaseIdx: return context_().oilPvt->saturatedGasDissolutionFactor(regionIdx, T, p);
+        case gasPhaseIdx: return context_().gasPvt->saturatedOilVaporizationFactor(regionIdx, T, p);
         case waterPhaseIdx: return 0.0;
         default: OPM_THROW(std::logic_error, "Unhandled phase index " << phaseIdx);
         }
@@ -1016,14 +1966,16 @@ public:
                                       unsigned phaseIdx,
                                       unsigned regionIdx)
     {
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::saturationPressure");
+
         assert(0 <= phaseIdx && phaseIdx <= numPhases);
         assert(0 <= regionIdx && regionIdx <= numRegions());
 
         const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
 
         switch (phaseIdx) {
-        case oilPhaseIdx: return oilPvt_->saturationPressure(regionIdx, T, Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx));
-        case gasPhaseIdx: return gasPvt_->saturationPressure(regionIdx, T, Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx));
+        case oilPhaseIdx: return context_().oilPvt->saturationPressure(regionIdx, T, Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx));
+        case gasPhaseIdx: return context_().gasPvt->saturationPressure(regionIdx, T, Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx));
         case waterPhaseIdx: return 0.0;
         default: OPM_THROW(std::logic_error, "Unhandled phase index " << phaseIdx);
         }
@@ -1039,8 +1991,8 @@ public:
     template <class LhsEval>
     static LhsEval convertXoGToRs(const LhsEval& XoG, unsigned regionIdx)
     {
-        Scalar rho_oRef = referenceDensity_[regionIdx][oilPhaseIdx];
-        Scalar rho_gRef = referenceDensity_[regionIdx][gasPhaseIdx];
+        Scalar rho_oRef = context_().referenceDensity[regionIdx][oilPhaseIdx];
+        Scalar rho_gRef = context_().referenceDensity[regionIdx][gasPhaseIdx];
 
         return XoG/(1.0 - XoG)*(rho_oRef/rho_gRef);
     }
@@ -1052,8 +2004,8 @@ public:
     template <class LhsEval>
     static LhsEval convertXgOToRv(const LhsEval& XgO, unsigned regionIdx)
     {
-        Scalar rho_oRef = referenceDensity_[regionIdx][oilPhaseIdx];
-        Scalar rho_gRef = referenceDensity_[regionIdx][gasPhaseIdx];
+        Scalar rho_oRef = context_().referenceDensity[regionIdx][oilPhaseIdx];
+        Scalar rho_gRef = context_().referenceDensity[regionIdx][gasPhaseIdx];
 
         return XgO/(1.0 - XgO)*(rho_gRef/rho_oRef);
     }
@@ -1065,8 +2017,8 @@ public:
     template <class LhsEval>
     static LhsEval convertRsToXoG(const LhsEval& Rs, unsigned regionIdx)
     {
-        Scalar rho_oRef = referenceDensity_[regionIdx][oilPhaseIdx];
-        Scalar rho_gRef = referenceDensity_[regionIdx][gasPhaseIdx];
+        Scalar rho_oRef = context_().referenceDensity[regionIdx][oilPhaseIdx];
+        Scalar rho_gRef = context_().referenceDensity[regionIdx][gasPhaseIdx];
 
         const LhsEval& rho_oG = Rs*rho_gRef;
         return rho_oG/(rho_oRef + rho_oG);
@@ -1079,8 +2031,8 @@ public:
     template <class LhsEval>
     static LhsEval convertRvToXgO(const LhsEval& Rv, unsigned regionIdx)
     {
-        Scalar rho_oRef = referenceDensity_[regionIdx][oilPhaseIdx];
-        Scalar rho_gRef = referenceDensity_[regionIdx][gasPhaseIdx];
+        Scalar rho_oRef = context_().referenceDensity[regionIdx][oilPhaseIdx];
+        Scalar rho_gRef = context_().referenceDensity[regionIdx][gasPhaseIdx];
 
         const LhsEval& rho_gO = Rv*rho_oRef;
         return rho_gO/(rho_gRef + rho_gO);
@@ -1092,8 +2044,8 @@ public:
     template <class LhsEval>
     static LhsEval convertXoGToxoG(const LhsEval& XoG, unsigned regionIdx)
     {
-        Scalar MO = molarMass_[regionIdx][oilCompIdx];
-        Scalar MG = molarMass_[regionIdx][gasCompIdx];
+        Scalar MO = context_().molarMass[regionIdx][oilCompIdx];
+        Scalar MG = context_().molarMass[regionIdx][gasCompIdx];
 
         return XoG*MO / (MG*(1 - XoG) + XoG*MO);
     }
@@ -1104,8 +2056,8 @@ public:
     template <class LhsEval>
     static LhsEval convertxoGToXoG(const LhsEval& xoG, unsigned regionIdx)
     {
-        Scalar MO = molarMass_[regionIdx][oilCompIdx];
-        Scalar MG = molarMass_[regionIdx][gasCompIdx];
+        Scalar MO = context_().molarMass[regionIdx][oilCompIdx];
+        Scalar MG = context_().molarMass[regionIdx][gasCompIdx];
 
         return xoG*MG / (xoG*(MG - MO) + MO);
     }
@@ -1116,8 +2068,8 @@ public:
     template <class LhsEval>
     static LhsEval convertXgOToxgO(const LhsEval& XgO, unsigned regionIdx)
     {
-        Scalar MO = molarMass_[regionIdx][oilCompIdx];
-        Scalar MG = molarMass_[regionIdx][gasCompIdx];
+        Scalar MO = context_().molarMass[regionIdx][oilCompIdx];
+        Scalar MG = context_().molarMass[regionIdx][gasCompIdx];
 
         return XgO*MG / (MO*(1 - XgO) + XgO*MG);
     }
@@ -1128,12 +2080,140 @@ public:
     template <class LhsEval>
     static LhsEval convertxgOToXgO(const LhsEval& xgO, unsigned regionIdx)
     {
-        Scalar MO = molarMass_[regionIdx][oilCompIdx];
-        Scalar MG = molarMass_[regionIdx][gasCompIdx];
+        Scalar MO = context_().molarMass[regionIdx][oilCompIdx];
+        Scalar MG = context_().molarMass[regionIdx][gasCompIdx];
 
         return xgO*MO / (xgO*(MO - MG) + MG);
     }
 
+    /*!
+     * \brief The per-entry input quantities of reservoirToSurfaceVolumes().
+     *
+     * All arrays are indexed by the entry, e.g., the connections of a well. The
+     * reservoir volumes and the inverse formation volume factors are only required for
+     * the active phases. The dissolved gas in the oil phase can be specified either by
+     * R_s or by the mass fraction of the gas component X_o^G, the vaporized oil in the
+     * gas phase either by R_v or by X_g^O. If neither is given, the respective phase is
+     * assumed to contain no dissolved component.
+     */
+    template <class Evaluation>
+    struct SurfaceVolumeInput
+    {
+        SurfaceVolumeInput()
+            : numValues(0)
+            , regionIdx(nullptr)
+            , Rs(nullptr)
+            , Rv(nullptr)
+            , XoG(nullptr)
+            , XgO(nullptr)
+        {
+            reservoirVolume.fill(nullptr);
+            invB.fill(nullptr);
+        }
+
+        //! The number of entries
+        size_t numValues;
+
+        //! The PVT region of each entry. If it is nullptr, all entries are in region 0.
+        const unsigned* regionIdx;
+
+        //! The volumes (or volumetric rates) of the phases at reservoir conditions
+        std::array<const Evaluation*, /*numPhases=*/3> reservoirVolume;
+
+        //! The inverse formation volume factors of the phases
+        std::array<const Evaluation*, /*numPhases=*/3> invB;
+
+        //! The gas dissolution factors of the oil phase
+        const Evaluation* Rs;
+
+        //! The oil vaporization factors of the gas phase
+        const Evaluation* Rv;
+
+        //! The mass fractions of the gas component in the oil phase
+        const Evaluation* XoG;
+
+        //! The mass fractions of the oil component in the gas phase
+        const Evaluation* XgO;
+    };
+
+    /*!
+     * \brief Convert the volumes of the phases at reservoir conditions to the volumes
+     *        of the components at surface conditions for many entries at once.
+     *
+     * The surface volume of the water component is \f$b_w q_w\f$, the one of the oil
+     * component is \f$b_o q_o + R_v b_g q_g\f$ and the one of the gas component is
+     * \f$b_g q_g + R_s b_o q_o\f$, where \f$q_\alpha\f$ is the reservoir volume of
+     * phase \f$\alpha\f$. If the inputs are function evaluations, the results include
+     * their derivatives. Only the surface volumes of the active phases whose array is
+     * not nullptr are written. The reference densities which are needed to convert the
+     * mass fractions are only looked up when the PVT region changes from one entry to
+     * the next, i.e., the inputs should be ordered by the PVT region if possible.
+     */
+    template <class Evaluation>
+    static void reservoirToSurfaceVolumes(const SurfaceVolumeInput<Evaluation>& input,
+                                          const std::array<Evaluation*, /*numPhases=*/3>& surfaceVolume)
+    {
+        OPM_MATERIAL_TRACE_SCOPE("BlackOilFluidSystem::reservoirToSurfaceVolumes");
+
+        const Context& ctx = context_();
+        const bool waterIsActive = ctx.phaseIsActive[waterPhaseIdx];
+        const bool oilIsActive = ctx.phaseIsActive[oilPhaseIdx];
+        const bool gasIsActive = ctx.phaseIsActive[gasPhaseIdx];
+        const bool hasDissolvedGas =
+            oilIsActive && gasIsActive && ctx.enableDissolvedGas && (input.Rs || input.XoG);
+        const bool hasVaporizedOil =
+            oilIsActive && gasIsActive && ctx.enableVaporizedOil && (input.Rv || input.XgO);
+
+        unsigned lastRegionIdx = static_cast<unsigned>(ctx.referenceDensity.size());
+        Scalar rho_oRef = 0.0;
+        Scalar rho_gRef = 0.0;
+        for (size_t i = 0; i < input.numValues; ++i) {
+            const unsigned regionIdx = input.regionIdx ? input.regionIdx[i] : 0;
+            if (regionIdx != lastRegionIdx) {
+                lastRegionIdx = regionIdx;
+                rho_oRef = ctx.referenceDensity[regionIdx][oilPhaseIdx];
+                rho_gRef = ctx.referenceDensity[regionIdx][gasPhaseIdx];
+            }
+
+            if (waterIsActive && surfaceVolume[waterPhaseIdx])
+                surfaceVolume[waterPhaseIdx][i] =
+                    input.reservoirVolume[waterPhaseIdx][i]*input.invB[waterPhaseIdx][i];
+
+            Evaluation freeOil = 0.0;
+            Evaluation freeGas = 0.0;
+            if (oilIsActive)
+                freeOil = input.reservoirVolume[oilPhaseIdx][i]*input.invB[oilPhaseIdx][i];
+            if (gasIsActive)
+                freeGas = input.reservoirVolume[gasPhaseIdx][i]*input.invB[gasPhaseIdx][i];
+
+            if (oilIsActive && surfaceVolume[oilPhaseIdx]) {
+                Evaluation& result = surfaceVolume[oilPhaseIdx][i];
+                result = freeOil;
+                if (hasVaporizedOil) {
+                    if (input.Rv)
+                        result += input.Rv[i]*freeGas;
+                    else {
+                        const Evaluation& XgO = input.XgO[i];
+                        result += XgO/(1.0 - XgO)*(rho_gRef/rho_oRef)*freeGas;
+                    }
+                }
+            }
+
+            if (gasIsActive && surfaceVolume[gasPhaseIdx]) {
+                Evaluation& result = surfaceVolume[gasPhaseIdx][i];
+                result = freeGas;
+                if (hasDissolvedGas) {
+                    if (input.Rs)
+                        result += input.Rs[i]*freeOil;
+                    else {
+                        const Evaluation& XoG = input.XoG[i];
+                        result += XoG/(1.0 - XoG)*(rho_oRef/rho_gRef)*freeOil;
+                    }
+                }
+            }
+        }
+    }
+
     /*!
      * \brief Return a reference to the low-level object which calculates the gas phase
      *        quantities.
@@ -1142,7 +2222,7 @@ public:
      *       specific methods of the fluid systems from above should be used instead.
      */
     static const GasPvt& gasPvt()
-    { return *gasPvt_; }
+    { return *context_().gasPvt; }
 
     /*!
      * \brief Return a reference to the low-level object which calculates the oil phase
@@ -1152,7 +2232,7 @@ public:
      *       specific methods of the fluid systems from above should be used instead.
      */
     static const OilPvt& oilPvt()
-    { return *oilPvt_; }
+    { return *context_().oilPvt; }
 
     /*!
      * \brief Return a reference to the low-level object which calculates the water phase
@@ -1162,7 +2242,7 @@ public:
      *       specific methods of the fluid systems from above should be used instead.
      */
     static const WaterPvt& waterPvt()
-    { return *waterPvt_; }
+    { return *context_().waterPvt; }
 
     /*!
      * \brief Set the temperature of the reservoir.
@@ -1170,7 +2250,7 @@ public:
      * This method is black-oil specific and only makes sense for isothermal simulations.
      */
     static Scalar reservoirTemperature(unsigned pvtRegionIdx OPM_UNUSED = 0)
-    { return reservoirTemperature_; }
+    { return context_().reservoirTemperature; }
 
     /*!
      * \brief Return the temperature of the reservoir.
@@ -1178,35 +2258,268 @@ public:
      * This method is black-oil specific and only makes sense for isothermal simulations.
      */
     static void setReservoirTemperature(Scalar value)
-    { reservoirTemperature_ = value; }
+    { context_().reservoirTemperature = value; }
 
 private:
-    static void resizeArrays_(size_t numRegions)
+    // compute the inverse formation volume factor and the viscosity of the oil phase
+    // for a given R_s. if the oil is saturated, the undersaturated curves are only
+    // evaluated in the region where the result is blended with the saturated ones.
+    template <class FluidState, class LhsEval>
+    static void oilInvBAndViscosity_(LhsEval& invB,
+                                     LhsEval& mu,
+                                     const FluidState& fluidState,
+                                     const LhsEval& T,
+                                     const LhsEval& p,
+                                     const LhsEval& Rs,
+                                     unsigned regionIdx)
+    {
+        const auto& oilPvt = *context_().oilPvt;
+        if (!enableDissolvedGas() || !fluidState.phaseIsPresent(gasPhaseIdx)) {
+            Opm::BlackOil::invBAndViscosity_(oilPvt, regionIdx, T, p, Rs, invB, mu, /*preferCombined=*/0);
+            return;
+        }
+
+        Opm::BlackOil::saturatedInvBAndViscosity_(oilPvt, regionIdx, T, p, invB, mu, /*preferCombined=*/0);
+        if (fluidState.saturation(gasPhaseIdx) < saturatedSwitchWidth()) {
+            // blend the saturated and undersaturated quantities to avoid a
+            // discontinuity (cf. inverseFormationVolumeFactor())
+            LhsEval bUndersat;
+            LhsEval muUndersat;
+            Opm::BlackOil::invBAndViscosity_(oilPvt, regionIdx, T, p, Rs, bUndersat, muUndersat, /*preferCombined=*/0);
+            const auto& alpha = saturatedSwitchWeight_<LhsEval>(fluidState.saturation(gasPhaseIdx));
+            invB = alpha*invB + (1.0 - alpha)*bUndersat;
+            mu = alpha*mu + (1.0 - alpha)*muUndersat;
+        }
+    }
+
+    // the same as oilInvBAndViscosity_() for the gas phase
+    template <class FluidState, class LhsEval>
+    static void gasInvBAndViscosity_(LhsEval& invB,
+                                     LhsEval& mu,
+                                     const FluidState& fluidState,
+                                     const LhsEval& T,
+                                     const LhsEval& p,
+                                     const LhsEval& Rv,
+                                     unsigned regionIdx)
+    {
+        const auto& gasPvt = *context_().gasPvt;
+        if (!enableVaporizedOil() || !fluidState.phaseIsPresent(oilPhaseIdx)) {
+            Opm::BlackOil::invBAndViscosity_(gasPvt, regionIdx, T, p, Rv, invB, mu, /*preferCombined=*/0);
+            return;
+        }
+
+        Opm::BlackOil::saturatedInvBAndViscosity_(gasPvt, regionIdx, T, p, invB, mu, /*preferCombined=*/0);
+        if (fluidState.saturation(oilPhaseIdx) < saturatedSwitchWidth()) {
+            // blend the saturated and undersaturated quantities to avoid a
+            // discontinuity (cf. inverseFormationVolumeFactor())
+            LhsEval bUndersat;
+            LhsEval muUndersat;
+            Opm::BlackOil::invBAndViscosity_(gasPvt, regionIdx, T, p, Rv, bUndersat, muUndersat, /*preferCombined=*/0);
+            const auto& alpha = saturatedSwitchWeight_<LhsEval>(fluidState.saturation(oilPhaseIdx));
+            invB = alpha*invB + (1.0 - alpha)*bUndersat;
+            mu = alpha*mu + (1.0 - alpha)*muUndersat;
+        }
+    }
+
+    // the weight of the saturated quantities if the saturation of the other
+    // hydrocarbon phase is below the width of the transition zone. the linear
+    // function is extrapolated for negative saturations like it always was, the
+    // smooth ones are clamped to the undersaturated quantities.
+    template <class LhsEval, class SatEval>
+    static LhsEval saturatedSwitchWeight_(const SatEval& saturation)
+    {
+        const LhsEval& x = Opm::decay<LhsEval>(saturation)/saturatedSwitchWidth();
+        switch (saturatedSwitchFunction()) {
+        case SaturatedSwitchFunction::Linear:
+            break;
+
+        case SaturatedSwitchFunction::SmoothStep:
+            if (Opm::scalarValue(x) <= 0.0)
+                return LhsEval(0.0);
+            return x*x*(3.0 - 2.0*x);
+
+        case SaturatedSwitchFunction::SmootherStep:
+            if (Opm::scalarValue(x) <= 0.0)
+                return LhsEval(0.0);
+            return x*x*x*(x*(6.0*x - 15.0) + 10.0);
+        }
+
+        return x;
+    }
+
+    template <class FluidState, class LhsEval>
+    static LhsEval densityFromInvB_(const FluidState& fluidState,
+                                    const LhsEval& b,
+                                    unsigned phaseIdx,
+                                    unsigned regionIdx)
+    {
+        switch (phaseIdx) {
+        case oilPhaseIdx: {
+            if (!enableDissolvedGas())
+                // immiscible oil
+                return referenceDensity(phaseIdx, regionIdx)*b;
+
+            // miscible oil
+            const auto& Rs = Opm::BlackOil::template getRs_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
+
+            return
+                b*referenceDensity(oilPhaseIdx, regionIdx)
+                + Rs*b*referenceDensity(gasPhaseIdx, regionIdx);
+        }
+
+        case gasPhaseIdx: {
+            if (!enableVaporizedOil())
+                // immiscible gas
+                return b*referenceDensity(phaseIdx, regionIdx);
+
+            // miscible gas
+            const auto& Rv = Opm::BlackOil::template getRv_<ThisType, LhsEval, FluidState>(fluidState, regionIdx);
+
+            return
+                b*referenceDensity(gasPhaseIdx, regionIdx)
+                + Rv*b*referenceDensity(oilPhaseIdx, regionIdx);
+        }
+
+        case waterPhaseIdx:
+            return referenceDensity(waterPhaseIdx, regionIdx)*b;
+        }
+
+        OPM_THROW(std::logic_error, "Unhandled phase index " << phaseIdx);
+    }
+
+    // fugacity coefficient of the oil component in the gas phase. we assume that in
+    // equilibrium the fugacities of the oil component is the same in both phases.
+    template <class FluidState, class LhsEval>
+    static LhsEval gasPhaseOilFugacityCoefficient_(const FluidState& fluidState,
+                                                   const LhsEval& R_sSat,
+                                                   const LhsEval& R_vSat,
+                                                   unsigned regionIdx)
+    {
+        const auto& X_gOSat = convertRvToXgO(R_vSat, regionIdx);
+        const auto& x_gOSat = convertXgOToxgO(X_gOSat, regionIdx);
+
+        const auto& X_oGSat = convertRsToXoG(R_sSat, regionIdx);
+        const auto& x_oGSat = convertXoGToxoG(X_oGSat, regionIdx);
+        const auto& x_oOSat = 1.0 - x_oGSat;
+
+        const auto& p_o = Opm::decay<LhsEval>(fluidState.pressure(oilPhaseIdx));
+        const auto& p_g = Opm::decay<LhsEval>(fluidState.pressure(gasPhaseIdx));
+        const LhsEval phi_oO = 20e3/p_g;
+
+        return phi_oO*p_o*x_oOSat / (p_g*x_gOSat);
+    }
+
+    // fugacity coefficient of the gas component in the oil phase, analogous to
+    // gasPhaseOilFugacityCoefficient_()
+    template <class FluidState, class LhsEval>
+    static LhsEval oilPhaseGasFugacityCoefficient_(const FluidState& fluidState,
+                                                   const LhsEval& R_sSat,
+                                                   const LhsEval& R_vSat,
+                                                   unsigned regionIdx)
+    {
+        const Scalar phi_gG = 1.0;
+
+        const auto& X_gOSat = convertRvToXgO(R_vSat, regionIdx);
+        const auto& x_gOSat = convertXgOToxgO(X_gOSat, regionIdx);
+        const auto& x_gGSat = 1.0 - x_gOSat;
+
+        const auto& X_oGSat = convertRsToXoG(R_sSat, regionIdx);
+        const auto& x_oGSat = convertXoGToxoG(X_oGSat, regionIdx);
+
+        const auto& p_o = Opm::decay<LhsEval>(fluidState.pressure(oilPhaseIdx));
+        const auto& p_g = Opm::decay<LhsEval>(fluidState.pressure(gasPhaseIdx));
+
+        return phi_gG*p_g*x_gGSat / (p_o*x_oGSat);
+    }
+
+    // the fugacity coefficients of the oil component in the gas phase and of the gas
+    // component in the oil phase for the same saturated dissolution factors. this
+    // yields the same values as gasPhaseOilFugacityCoefficient_() and
+    // oilPhaseGasFugacityCoefficient_(), but the mole fractions are only computed once.
+    template <class FluidState, class LhsEval>
+    static void dissolvedFugacityCoefficients_(LhsEval& phiGasPhaseOil,
+                                               LhsEval& phiOilPhaseGas,
+                                               const FluidState& fluidState,
+                                               const LhsEval& R_sSat,
+                                               const LhsEval& R_vSat,
+                                               unsigned regionIdx)
+    {
+        const auto& X_gOSat = convertRvToXgO(R_vSat, regionIdx);
+        const auto& x_gOSat = convertXgOToxgO(X_gOSat, regionIdx);
+        const auto& x_gGSat = 1.0 - x_gOSat;
+
+        const auto& X_oGSat = convertRsToXoG(R_sSat, regionIdx);
+        const auto& x_oGSat = convertXoGToxoG(X_oGSat, regionIdx);
+        const auto& x_oOSat = 1.0 - x_oGSat;
+
+        const auto& p_o = Opm::decay<LhsEval>(fluidState.pressure(oilPhaseIdx));
+        const auto& p_g = Opm::decay<LhsEval>(fluidState.pressure(gasPhaseIdx));
+        const LhsEval phi_oO = 20e3/p_g;
+        const Scalar phi_gG = 1.0;
+
+        phiGasPhaseOil = phi_oO*p_o*x_oOSat / (p_g*x_gOSat);
+        phiOilPhaseGas = phi_gG*p_g*x_gGSat / (p_o*x_oGSat);
+    }
+
+    // convert a quantity stored by a parameter cache to the type of the result. this
+    // is only possible if the types are identical or if the result is a plain scalar.
+    template <class LhsEval, class CacheEval>
+    static typename std::enable_if<std::is_same<LhsEval, CacheEval>::value
+                                   || std::is_floating_point<LhsEval>::value,
+                                   bool>::type
+    decayCached_(LhsEval& result, const CacheEval& cachedValue)
     {
-        molarMass_.resize(numRegions);
-        referenceDensity_.resize(numRegions);
+        result = Opm::decay<LhsEval>(cachedValue);
+        return true;
     }
 
-    static Scalar reservoirTemperature_;
+    template <class LhsEval, class CacheEval>
+    static typename std::enable_if<!std::is_same<LhsEval, CacheEval>::value
+                                   && !std::is_floating_point<LhsEval>::value,
+                                   bool>::type
+    decayCached_(LhsEval& /*result*/, const CacheEval& /*cachedValue*/)
+    { return false; }
 
-    static std::shared_ptr<GasPvt> gasPvt_;
-    static std::shared_ptr<OilPvt> oilPvt_;
-    static std::shared_ptr<WaterPvt> waterPvt_;
+    // make sure that the runtime settings agree with a compile-time phase configuration
+    static void checkPhaseConfig_()
+    {
+        if (!PhaseConfig::isStatic)
+            return;
+
+        const auto& ctx = context_();
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (ctx.phaseIsActive[phaseIdx] != PhaseConfig::phaseIsActive(phaseIdx))
+                OPM_THROW(std::logic_error,
+                          "The " << phaseName(phaseIdx) << " phase is "
+                          << (ctx.phaseIsActive[phaseIdx]?"active":"inactive")
+                          << ", but the fluid system was compiled for the opposite");
+
+        if (ctx.enableDissolvedGas != PhaseConfig::enableDissolvedGas())
+            OPM_THROW(std::logic_error,
+                      "Dissolved gas is " << (ctx.enableDissolvedGas?"enabled":"disabled")
+                      << ", but the fluid system was compiled for the opposite");
+
+        if (ctx.enableVaporizedOil != PhaseConfig::enableVaporizedOil())
+            OPM_THROW(std::logic_error,
+                      "Vaporized oil is " << (ctx.enableVaporizedOil?"enabled":"disabled")
+                      << ", but the fluid system was compiled for the opposite");
+    }
 
-    static bool enableDissolvedGas_;
-    static bool enableVaporizedOil_;
+    static void resizeArrays_(size_t numRegions)
+    {
+        context_().molarMass.resize(numRegions);
+        context_().referenceDensity.resize(numRegions);
+    }
 
-    // HACK for GCC 4.4: the array size has to be specified using the literal value '3'
-    // here, because GCC 4.4 seems to be unable to determine the number of phases from
-    // the BlackOil fluid system in the attribute declaration below...
-    static std::vector<std::array<Scalar, /*numPhases=*/3> > referenceDensity_;
-    static std::vector<std::array<Scalar, /*numComponents=*/3> > molarMass_;
+    static Context& context_()
+    { return *activeContext_; }
 
-    static bool isInitialized_;
+    static Context defaultContext_;
+    static thread_local Context* activeContext_;
 };
 
-template <class Scalar>
-const int BlackOil<Scalar>::phaseToSolventCompIdx_[3] =
+template <class Scalar, class OilPvtT, class GasPvtT, class WaterPvtT, class PhaseConfigT>
+const int BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::phaseToSolventCompIdx_[3] =
 {
     waterCompIdx, // water phase
     oilCompIdx, // oil phase
@@ -1214,61 +2527,42 @@ const int BlackOil<Scalar>::phaseToSolventCompIdx_[3] =
 };
 
 
-template <class Scalar>
-const int BlackOil<Scalar>::phaseToSoluteCompIdx_[3] =
+template <class Scalar, class OilPvtT, class GasPvtT, class WaterPvtT, class PhaseConfigT>
+const int BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::phaseToSoluteCompIdx_[3] =
 {
     -1, // water phase
     gasCompIdx, // oil phase
     oilCompIdx // gas phase
 };
 
-template <class Scalar>
-unsigned char BlackOil<Scalar>::numActivePhases_;
-
-template <class Scalar>
-bool BlackOil<Scalar>::phaseIsActive_[numPhases];
-
-template <class Scalar>
+template <class Scalar, class OilPvtT, class GasPvtT, class WaterPvtT, class PhaseConfigT>
 const Scalar
-BlackOil<Scalar>::surfaceTemperature = 273.15 + 15.56; // [K]
+BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::surfaceTemperature = 273.15 + 15.56; // [K]
 
-template <class Scalar>
+template <class Scalar, class OilPvtT, class GasPvtT, class WaterPvtT, class PhaseConfigT>
 const Scalar
-BlackOil<Scalar>::surfacePressure = 101325.0; // [Pa]
-
-template <class Scalar>
-Scalar
-BlackOil<Scalar>::reservoirTemperature_;
-
-template <class Scalar>
-bool BlackOil<Scalar>::enableDissolvedGas_;
+BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::surfacePressure = 101325.0; // [Pa]
 
-template <class Scalar>
-bool BlackOil<Scalar>::enableVaporizedOil_;
+template <class Scalar, class OilPvtT, class GasPvtT, class WaterPvtT, class PhaseConfigT>
+typename BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::Context
+BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::defaultContext_;
 
-template <class Scalar>
-std::shared_ptr<OilPvtMultiplexer<Scalar> >
-BlackOil<Scalar>::oilPvt_;
+template <class Scalar, class OilPvtT, class GasPvtT, class WaterPvtT, class PhaseConfigT>
+thread_local typename BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::Context*
+BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::activeContext_ = &BlackOil<Scalar, OilPvtT, GasPvtT, WaterPvtT, PhaseConfigT>::defaultContext_;
 
-template <class Scalar>
-std::shared_ptr<Opm::GasPvtMultiplexer<Scalar> >
-BlackOil<Scalar>::gasPvt_;
-
-template <class Scalar>
-std::shared_ptr<WaterPvtMultiplexer<Scalar> >
-BlackOil<Scalar>::waterPvt_;
-
-template <class Scalar>
-std::vector<std::array<Scalar, 3> >
-BlackOil<Scalar>::referenceDensity_;
-
-template <class Scalar>
-std::vector<std::array<Scalar, 3> >
-BlackOil<Scalar>::molarMass_;
+}} // namespace Opm, FluidSystems
 
-template <class Scalar>
-bool BlackOil<Scalar>::isInitialized_ = false;
+// the instantiation which is part of the library of precompiled instantiations (see
+// opm/material/common/PrecompiledInstantiations.hpp). the PVT multiplexers are
+// declared by their respective headers.
+#include <opm/material/common/PrecompiledInstantiations.hpp>
 
+#if OPM_MATERIAL_EXTERN_TEMPLATES
+namespace Opm {
+namespace FluidSystems {
+extern template class BlackOil<double>;
 }} // namespace Opm, FluidSystems
+#endif
 
 #endif
@@ -29,9 +29,10 @@
 #define OPM_BRINE_CO2_SYSTEM_HPP
 
 #include "BaseFluidSystem.hpp"
-#include "NullParameterCache.hpp"
+#include "ParameterCacheBase.hpp"
 
 #include <opm/material/IdealGas.hpp>
+#include <opm/material/fluidstates/FluidStateArray.hpp>
 
 #include <opm/material/components/Brine.hpp>
 #include <opm/material/components/CO2.hpp>
@@ -45,7 +46,9 @@
 
 #include <opm/common/Unused.hpp>
 
+#include <cstddef>
 #include <iostream>
+#include <vector>
 
 namespace Opm {
 namespace FluidSystems {
@@ -61,6 +64,7 @@ template <class Scalar, class CO2Tables>
 class BrineCO2
     : public BaseFluidSystem<Scalar, BrineCO2<Scalar, CO2Tables> >
 {
+    typedef Opm::BaseFluidSystem<Scalar, BrineCO2<Scalar, CO2Tables> > ParentType;
     typedef Opm::H2O<Scalar> H2O_IAPWS;
     typedef Opm::Brine<Scalar, H2O_IAPWS> Brine_IAPWS;
     typedef Opm::TabulatedComponent<Scalar, H2O_IAPWS> H2O_Tabulated;
@@ -69,9 +73,158 @@ class BrineCO2
     typedef H2O_Tabulated H2O;
 
 public:
+    /*!
+     * \brief The parameter cache of the brine-CO2 fluid system.
+     *
+     * It stores the mutual solubilities of brine and CO2 at the temperature and
+     * pressure of the liquid phase and the density of CO2 at the conditions of the gas
+     * phase. These quantities are used by several methods of the fluid system, but
+     * they only depend on temperature and pressure. The cached values are only used
+     * if the fluid state passed to the fluid system exhibits the same temperature and
+     * pressure as the one which was used to update the cache, otherwise they are
+     * recomputed.
+     */
     template <class Evaluation>
-    struct ParameterCache : public Opm::NullParameterCache<Evaluation>
-    {};
+    struct ParameterCache : public Opm::ParameterCacheBase<ParameterCache<Evaluation> >
+    {
+        typedef Opm::ParameterCacheBase<ParameterCache<Evaluation> > ParentType;
+
+        ParameterCache()
+            : hasSolubility_(false)
+            , hasGasDensity_(false)
+        { }
+
+        using ParentType::updateAll;
+
+        /*!
+         * \brief Update the parameter caches of many cells at once.
+         *
+         * The mutual solubilities are computed for all cells in one batch, cf.
+         * BinaryCoeff::Brine_CO2::calculateMoleFractions().
+         */
+        template <class FluidState>
+        static void updateAll(ParameterCache* paramCaches,
+                              const FluidState* fluidStates,
+                              std::size_t numCells)
+        {
+            std::vector<Evaluation> T(numCells);
+            std::vector<Evaluation> pl(numCells);
+            std::vector<Scalar> salinity(numCells, Brine_IAPWS::salinity);
+            std::vector<Evaluation> xlCO2(numCells);
+            std::vector<Evaluation> xgH2O(numCells);
+            for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                T[cellIdx] = Opm::decay<Evaluation>(fluidStates[cellIdx].temperature(liquidPhaseIdx));
+                pl[cellIdx] = Opm::decay<Evaluation>(fluidStates[cellIdx].pressure(liquidPhaseIdx));
+            }
+
+            BinaryCoeffBrineCO2::calculateMoleFractions(T.data(),
+                                                        pl.data(),
+                                                        salinity.data(),
+                                                        /*knownPhaseIdx=*/nullptr,
+                                                        xlCO2.data(),
+                                                        xgH2O.data(),
+                                                        numCells);
+
+            const long n = static_cast<long>(numCells);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (long cellIdx = 0; cellIdx < n; ++cellIdx) {
+                ParameterCache& paramCache = paramCaches[cellIdx];
+                paramCache.liquidT_ = T[cellIdx];
+                paramCache.liquidP_ = pl[cellIdx];
+                paramCache.xlCO2_ = xlCO2[cellIdx];
+                paramCache.xgH2O_ = xgH2O[cellIdx];
+                paramCache.hasSolubility_ = true;
+
+                paramCache.updateGasDensity_(fluidStates[cellIdx]);
+            }
+        }
+
+        //! \copydoc ParameterCacheBase::updatePhase
+        template <class FluidState>
+        void updatePhase(const FluidState& fluidState,
+                         unsigned phaseIdx,
+                         int exceptQuantities = ParentType::None)
+        {
+            // none of the cached quantities depends on the composition, so nothing needs
+            // to be done if the cache of the phase is valid and neither the temperature
+            // nor the pressure changed
+            const bool isValid = (phaseIdx == liquidPhaseIdx) ? hasSolubility_ : hasGasDensity_;
+            if (isValid
+                && (exceptQuantities & ParentType::Temperature)
+                && (exceptQuantities & ParentType::Pressure))
+                return;
+
+            if (phaseIdx == liquidPhaseIdx) {
+                liquidT_ = Opm::decay<Evaluation>(fluidState.temperature(liquidPhaseIdx));
+                liquidP_ = Opm::decay<Evaluation>(fluidState.pressure(liquidPhaseIdx));
+                BinaryCoeffBrineCO2::calculateMoleFractions(liquidT_,
+                                                            liquidP_,
+                                                            Brine_IAPWS::salinity,
+                                                            /*knownPhaseIdx=*/-1,
+                                                            xlCO2_,
+                                                            xgH2O_);
+                hasSolubility_ = true;
+            }
+            else
+                updateGasDensity_(fluidState);
+        }
+
+        /*!
+         * \brief Returns true if the cached mutual solubilities of brine and CO2 apply
+         *        to a given temperature and liquid pressure.
+         */
+        bool hasMutualSolubility(const Evaluation& T, const Evaluation& pl) const
+        { return hasSolubility_ && T == liquidT_ && pl == liquidP_; }
+
+        /*!
+         * \brief The cached mole fraction of CO2 in the liquid phase [-]
+         */
+        const Evaluation& xlCO2() const
+        { return xlCO2_; }
+
+        /*!
+         * \brief The cached mole fraction of water in the gas phase [-]
+         */
+        const Evaluation& xgH2O() const
+        { return xgH2O_; }
+
+        /*!
+         * \brief Returns true if the cached density of CO2 applies to a given
+         *        temperature and gas pressure.
+         */
+        bool hasGasDensity(const Evaluation& T, const Evaluation& pg) const
+        { return hasGasDensity_ && T == gasT_ && pg == gasP_; }
+
+        /*!
+         * \brief The cached density of CO2 at the conditions of the gas phase [kg/m^3]
+         */
+        const Evaluation& gasDensity() const
+        { return gasDensity_; }
+
+    private:
+        template <class FluidState>
+        void updateGasDensity_(const FluidState& fluidState)
+        {
+            gasT_ = Opm::decay<Evaluation>(fluidState.temperature(gasPhaseIdx));
+            gasP_ = Opm::decay<Evaluation>(fluidState.pressure(gasPhaseIdx));
+            gasDensity_ = CO2::gasDensity(gasT_, gasP_);
+            hasGasDensity_ = true;
+        }
+
+        bool hasSolubility_;
+        bool hasGasDensity_;
+
+        Evaluation liquidT_;
+        Evaluation liquidP_;
+        Evaluation xlCO2_;
+        Evaluation xgH2O_;
+
+        Evaluation gasT_;
+        Evaluation gasP_;
+        Evaluation gasDensity_;
+    };
 
     //! The binary coefficients for brine and CO2 used by this fluid system
     typedef Opm::BinaryCoeff::Brine_CO2<Scalar, CO2Tables> BinaryCoeffBrineCO2;
@@ -231,7 +384,7 @@ public:
      */
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval density(const FluidState& fluidState,
-                           const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                           const ParameterCache<ParamCacheEval>& paramCache,
                            unsigned phaseIdx)
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
@@ -269,10 +422,12 @@ public:
         xgBrine /= sumx;
         xgCO2 /= sumx;
 
-        LhsEval result = gasDensity_(temperature,
-                                     pressure,
-                                     xgBrine,
-                                     xgCO2);
+        LhsEval result;
+        if (!cachedGasDensity_(result, paramCache, temperature, pressure))
+            result = gasDensity_(temperature,
+                                 pressure,
+                                 xgBrine,
+                                 xgCO2);
         Valgrind::CheckDefined(result);
         return result;
     }
@@ -282,7 +437,7 @@ public:
      */
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval viscosity(const FluidState& fluidState,
-                             const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                             const ParameterCache<ParamCacheEval>& paramCache,
                              unsigned phaseIdx)
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
@@ -299,7 +454,16 @@ public:
         }
 
         assert(phaseIdx == gasPhaseIdx);
-        LhsEval result = CO2::gasViscosity(temperature, pressure);
+
+        // the viscosity of CO2 is based on its density. (the temperature of the
+        // correlation is regularized, so the cached density can only be used above
+        // 275 K.)
+        LhsEval result;
+        LhsEval rho;
+        if (temperature >= 275.0 && cachedGasDensity_(rho, paramCache, temperature, pressure))
+            result = CO2::gasViscosityFromDensity(temperature, rho);
+        else
+            result = CO2::gasViscosity(temperature, pressure);
         Valgrind::CheckDefined(result);
         return result;
     }
@@ -309,7 +473,7 @@ public:
      */
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval fugacityCoefficient(const FluidState& fluidState,
-                                       const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                       const ParameterCache<ParamCacheEval>& paramCache,
                                        unsigned phaseIdx,
                                        unsigned compIdx)
     {
@@ -328,16 +492,16 @@ public:
         assert(pressure > 0);
 
         // calulate the equilibrium composition for the given
-        // temperature and pressure. TODO: calculateMoleFractions()
-        // could use some cleanup.
+        // temperature and pressure if it is not provided by the parameter cache
         LhsEval xlH2O, xgH2O;
         LhsEval xlCO2, xgCO2;
-        BinaryCoeffBrineCO2::calculateMoleFractions(temperature,
-                                                    pressure,
-                                                    Brine_IAPWS::salinity,
-                                                    /*knownPhaseIdx=*/-1,
-                                                    xlCO2,
-                                                    xgH2O);
+        if (!cachedMutualSolubility_(xlCO2, xgH2O, paramCache, temperature, pressure))
+            BinaryCoeffBrineCO2::calculateMoleFractions(temperature,
+                                                        pressure,
+                                                        Brine_IAPWS::salinity,
+                                                        /*knownPhaseIdx=*/-1,
+                                                        xlCO2,
+                                                        xgH2O);
 
         // normalize the phase compositions
         xlCO2 = Opm::max(0.0, Opm::min(1.0, xlCO2));
@@ -454,7 +618,108 @@ public:
             return CO2::gasHeatCapacity(temperature, pressure);
     }
 
+    using ParentType::viscosityBatch;
+    using ParentType::heatCapacityBatch;
+
+    /*!
+     * \brief Calculate the dynamic viscosity of a fluid phase for the cells of a
+     *        fluid state array.
+     *
+     * The liquid phase is assumed to be pure brine, so its viscosity only depends on
+     * the temperature and the pressure. It is thus computed by the array-valued method
+     * of the brine component directly from the arrays of the fluid state array. For
+     * the gas phase, the generic loop over the cells is used.
+     */
+    template <class Evaluation, class ParamCache>
+    static void viscosityBatch(size_t numValues,
+                               const FluidStateArray<Evaluation, BrineCO2>& fluidStates,
+                               ParamCache* paramCaches,
+                               unsigned phaseIdx,
+                               Evaluation* values)
+    {
+        assert(0 <= phaseIdx && phaseIdx < numPhases);
+
+        if (phaseIdx == liquidPhaseIdx)
+            Brine::liquidViscosityBatch(numValues,
+                                        fluidStates.temperatureData(),
+                                        fluidStates.pressureData(liquidPhaseIdx),
+                                        values);
+        else
+            ParentType::viscosityBatch(numValues, fluidStates, paramCaches, phaseIdx, values);
+    }
+
+    /*!
+     * \brief Calculate the specific isobaric heat capacity of a fluid phase for the
+     *        cells of a fluid state array.
+     *
+     * The heat capacities of both phases are the ones of the pure components, so they
+     * are computed by the array-valued methods of the components directly from the
+     * arrays of the fluid state array.
+     */
+    template <class Evaluation, class ParamCache>
+    static void heatCapacityBatch(size_t numValues,
+                                  const FluidStateArray<Evaluation, BrineCO2>& fluidStates,
+                                  ParamCache* /*paramCaches*/,
+                                  unsigned phaseIdx,
+                                  Evaluation* values)
+    {
+        assert(0 <= phaseIdx && phaseIdx < numPhases);
+
+        const Evaluation* temperature = fluidStates.temperatureData();
+        const Evaluation* pressure = fluidStates.pressureData(phaseIdx);
+        if (phaseIdx == liquidPhaseIdx)
+            H2O::liquidHeatCapacityBatch(numValues, temperature, pressure, values);
+        else
+            CO2::gasHeatCapacityBatch(numValues, temperature, pressure, values);
+    }
+
 private:
+    // retrieve the mutual solubilities from the parameter cache. This is only
+    // possible if the cache uses the same type of evaluation as the result.
+    template <class LhsEval, class ParamCacheEval>
+    static bool cachedMutualSolubility_(LhsEval& /*xlCO2*/,
+                                        LhsEval& /*xgH2O*/,
+                                        const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                        const LhsEval& /*T*/,
+                                        const LhsEval& /*pl*/)
+    { return false; }
+
+    template <class LhsEval>
+    static bool cachedMutualSolubility_(LhsEval& xlCO2,
+                                        LhsEval& xgH2O,
+                                        const ParameterCache<LhsEval>& paramCache,
+                                        const LhsEval& T,
+                                        const LhsEval& pl)
+    {
+        if (!paramCache.hasMutualSolubility(T, pl))
+            return false;
+
+        xlCO2 = paramCache.xlCO2();
+        xgH2O = paramCache.xgH2O();
+        return true;
+    }
+
+    // retrieve the density of CO2 from the parameter cache, see above
+    template <class LhsEval, class ParamCacheEval>
+    static bool cachedGasDensity_(LhsEval& /*rho*/,
+                                  const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                  const LhsEval& /*T*/,
+                                  const LhsEval& /*pg*/)
+    { return false; }
+
+    template <class LhsEval>
+    static bool cachedGasDensity_(LhsEval& rho,
+                                  const ParameterCache<LhsEval>& paramCache,
+                                  const LhsEval& T,
+                                  const LhsEval& pg)
+    {
+        if (!paramCache.hasGasDensity(T, pg))
+            return false;
+
+        rho = paramCache.gasDensity();
+        return true;
+    }
+
     template <class LhsEval>
     static LhsEval gasDensity_(const LhsEval& T,
                                const LhsEval& pg,
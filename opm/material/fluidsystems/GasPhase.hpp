@@ -66,6 +66,18 @@ public:
     static bool isIdealGas()
     { return Component::gasIsIdeal(); }
 
+    /*!
+     * \brief Specify which properties of the phase do not depend on temperature and
+     *        pressure.
+     *
+     * The values of these properties are returned by constantDensity(),
+     * constantViscosity(), etc.
+     */
+    static const bool densityIsConstant = Component::gasDensityIsConstant;
+    static const bool viscosityIsConstant = Component::gasViscosityIsConstant;
+    static const bool thermalConductivityIsConstant = Component::gasThermalConductivityIsConstant;
+    static const bool heatCapacityIsConstant = Component::gasHeatCapacityIsConstant;
+
     /*!
      * \brief The mass in [kg] of one mole of the component.
      */
@@ -169,6 +181,34 @@ public:
     template <class Evaluation>
     static Evaluation heatCapacity(const Evaluation& temperature, const Evaluation& pressure)
     { return Component::gasHeatCapacity(temperature, pressure); }
+
+    /*!
+     * \brief The density [kg/m^3] of the phase if it does not depend on temperature
+     *        and pressure.
+     */
+    static Scalar constantDensity()
+    { return density(Scalar(293.15), Scalar(1e5)); }
+
+    /*!
+     * \brief The dynamic viscosity [Pa s] of the phase if it does not depend on
+     *        temperature and pressure.
+     */
+    static Scalar constantViscosity()
+    { return viscosity(Scalar(293.15), Scalar(1e5)); }
+
+    /*!
+     * \brief The thermal conductivity [W/(m^2 K/m)] of the phase if it does not depend
+     *        on temperature and pressure.
+     */
+    static Scalar constantThermalConductivity()
+    { return thermalConductivity(Scalar(293.15), Scalar(1e5)); }
+
+    /*!
+     * \brief The specific isobaric heat capacity [J/kg] of the phase if it does not
+     *        depend on temperature and pressure.
+     */
+    static Scalar constantHeatCapacity()
+    { return heatCapacity(Scalar(293.15), Scalar(1e5)); }
 };
 } // namespace Opm
 
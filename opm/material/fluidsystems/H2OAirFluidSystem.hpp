@@ -28,9 +28,11 @@
 #define OPM_H2O_AIR_SYSTEM_HPP
 
 #include "BaseFluidSystem.hpp"
-#include "NullParameterCache.hpp"
+#include "ParameterCacheBase.hpp"
+#include "WilkeViscosityMixing.hpp"
 
 #include <opm/material/IdealGas.hpp>
+#include <opm/material/common/UniformTabulated2DMultiFunction.hpp>
 #include <opm/material/binarycoefficients/H2O_Air.hpp>
 #include <opm/material/components/Air.hpp>
 #include <opm/material/components/H2O.hpp>
@@ -40,6 +42,7 @@
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
+#include <array>
 #include <iostream>
 #include <cassert>
 
@@ -66,10 +69,99 @@ class H2OAir
     typedef BaseFluidSystem <Scalar, ThisType> Base;
     typedef Opm::IdealGas<Scalar> IdealGas;
 
+    // the mixture properties which are stored by the table of initMixtureTables()
+    enum {
+        h2oVaporPressureIdx_,
+        h2oGasViscosityIdx_,
+        airGasViscosityIdx_,
+        airHenryIdx_,
+        liquidDiffCoeffIdx_,
+        gasDiffCoeffIdx_,
+        numMixtureValues_
+    };
+    typedef Opm::UniformTabulated2DMultiFunction<Scalar, numMixtureValues_> MixtureTable;
+
 public:
+    /*!
+     * \brief The parameter cache of the H2O-air fluid system
+     *
+     * The cache stores the quantities of each phase which only depend on its
+     * temperature and pressure, i.e., the mixture properties which are tabulated by
+     * initMixtureTables() and, for the liquid phase, the density and the viscosity of
+     * pure water. Updates which only change the composition thus do not recompute
+     * anything. The cached values are only used if the fluid state passed to the fluid
+     * system exhibits the temperature and pressure of the last update of the phase.
+     */
     template <class Evaluation>
-    struct ParameterCache : public Opm::NullParameterCache<Evaluation>
-    {};
+    struct ParameterCache : public Opm::ParameterCacheBase<ParameterCache<Evaluation> >
+    {
+        typedef Opm::ParameterCacheBase<ParameterCache<Evaluation> > ParentType;
+
+        ParameterCache()
+        { isValid_.fill(false); }
+
+        //! \copydoc ParameterCacheBase::updatePhase
+        template <class FluidState>
+        void updatePhase(const FluidState& fluidState,
+                         unsigned phaseIdx,
+                         int exceptQuantities = ParentType::None)
+        {
+            // none of the cached quantities depends on the composition
+            if (isValid_[phaseIdx]
+                && (exceptQuantities & ParentType::Temperature)
+                && (exceptQuantities & ParentType::Pressure))
+                return;
+
+            const auto& T = T_[phaseIdx] = Opm::decay<Evaluation>(fluidState.temperature(phaseIdx));
+            const auto& p = p_[phaseIdx] = Opm::decay<Evaluation>(fluidState.pressure(phaseIdx));
+
+            auto& values = mixtureValues_[phaseIdx];
+            if (!lookupMixtureTable_(T, p, values))
+                computeMixtureValues_(T, p, values);
+
+            if (phaseIdx == liquidPhaseIdx) {
+                waterDensity_ = H2O::liquidDensity(T, p);
+                waterViscosity_ = H2O::liquidViscosity(T, p);
+            }
+
+            isValid_[phaseIdx] = true;
+        }
+
+        /*!
+         * \brief Returns true if the cached quantities of a phase apply to a given
+         *        temperature and pressure.
+         */
+        bool applies(unsigned phaseIdx, const Evaluation& T, const Evaluation& p) const
+        { return isValid_[phaseIdx] && T == T_[phaseIdx] && p == p_[phaseIdx]; }
+
+        /*!
+         * \brief The cached mixture properties of a phase.
+         */
+        const std::array<Evaluation, numMixtureValues_>& mixtureValues(unsigned phaseIdx) const
+        { return mixtureValues_[phaseIdx]; }
+
+        /*!
+         * \brief The cached density of pure water at the conditions of the liquid
+         *        phase [kg/m^3]
+         */
+        const Evaluation& waterDensity() const
+        { return waterDensity_; }
+
+        /*!
+         * \brief The cached viscosity of pure water at the conditions of the liquid
+         *        phase [Pa s]
+         */
+        const Evaluation& waterViscosity() const
+        { return waterViscosity_; }
+
+    private:
+        std::array<Evaluation, /*numPhases=*/2> T_;
+        std::array<Evaluation, /*numPhases=*/2> p_;
+        std::array<std::array<Evaluation, numMixtureValues_>, /*numPhases=*/2> mixtureValues_;
+        Evaluation waterDensity_;
+        Evaluation waterViscosity_;
+        std::array<bool, /*numPhases=*/2> isValid_;
+    };
 
     //! The type of the water component used for this fluid system
     typedef H2Otype H2O;
@@ -253,10 +345,38 @@ public:
         }
     }
 
+    /*!
+     * \brief Tabulate the mixture properties which only depend on temperature and
+     *        pressure.
+     *
+     * After this method has been called, the vapor pressure and the gas viscosity of
+     * water, the gas viscosity and the Henry coefficient of air and the binary
+     * diffusion coefficients are determined by a single lookup into a table which
+     * stores all of these quantities for each sampling point. Outside of the tabulated
+     * range, they are still evaluated analytically. Since the quantities are
+     * interpolated bi-linearly, the accuracy depends on the resolution of the table.
+     *
+     * \param tempMin The minimum temperature of the table [K]
+     * \param tempMax The maximum temperature of the table [K]
+     * \param nTemp The number of sampling points on the temperature axis
+     * \param pressMin The minimum pressure of the table [Pa]
+     * \param pressMax The maximum pressure of the table [Pa]
+     * \param nPress The number of sampling points on the pressure axis
+     */
+    static void initMixtureTables(Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                                  Scalar pressMin, Scalar pressMax, unsigned nPress)
+    {
+        MixtureTable& table = mixtureTable_();
+        table.resize(tempMin, tempMax, nTemp, pressMin, pressMax, nPress);
+        table.sample([](Scalar T, Scalar p, typename MixtureTable::ValueArray& values) {
+                computeMixtureValues_(T, p, values);
+            });
+    }
+
     //! \copydoc BaseFluidSystem::density
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval density(const FluidState& fluidState,
-                           const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                           const ParameterCache<ParamCacheEval>& paramCache,
                            unsigned phaseIdx)
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
@@ -281,11 +401,11 @@ public:
         {
             if (!useComplexRelations)
                 // assume pure water
-                return H2O::liquidDensity(T, p);
+                return cachedWaterDensity_(paramCache, T, p);
             else
             {
                 // See: Ochs 2008 (2.6)
-                const LhsEval& rholH2O = H2O::liquidDensity(T, p);
+                const LhsEval& rholH2O = cachedWaterDensity_(paramCache, T, p);
                 const LhsEval& clH2O = rholH2O/H2O::molarMass();
 
                 const auto& xlH2O = Opm::decay<LhsEval>(fluidState.moleFraction(liquidPhaseIdx, H2OIdx));
@@ -319,7 +439,7 @@ public:
     //! \copydoc BaseFluidSystem::viscosity
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval viscosity(const FluidState& fluidState,
-                             const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                             const ParameterCache<ParamCacheEval>& paramCache,
                              unsigned phaseIdx)
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
@@ -332,51 +452,36 @@ public:
             // assume pure water for the liquid phase
             // TODO: viscosity of mixture
             // couldn't find a way to solve the mixture problem
-            return H2O::liquidViscosity(T, p);
+            return cachedWaterViscosity_(paramCache, T, p);
         }
         else if (phaseIdx == gasPhaseIdx)
         {
+            std::array<LhsEval, numMixtureValues_> tab;
+            const auto* values = cachedMixtureValues_(paramCache, gasPhaseIdx, T, p, tab);
+
             if(!useComplexRelations){
+                if (values)
+                    return (*values)[airGasViscosityIdx_];
                 return Air::gasViscosity(T, p);
             }
             else //using a complicated version of this fluid system
             {
-                /* Wilke method. See:
-                 *
-                 * See: R. Reid, et al.: The Properties of Gases and Liquids,
-                 * 4th edition, McGraw-Hill, 1987, 407-410 or
-                 * 5th edition, McGraw-Hill, 2000, p. 9.21/22
-                 *
-                 */
-
-                LhsEval muResult = 0;
-                const LhsEval mu[numComponents] = {
-                    H2O::gasViscosity(T, H2O::vaporPressure(T)),
-                    Air::gasViscosity(T, p)
-                };
-
-                // molar masses
-                const Scalar M[numComponents] =  {
-                    H2O::molarMass(),
-                    Air::molarMass()
-                };
-
-                for (unsigned i = 0; i < numComponents; ++i) {
-                    LhsEval divisor = 0;
-                    for (unsigned j = 0; j < numComponents; ++j) {
-                        LhsEval phiIJ =
-                            1 +
-                            Opm::sqrt(mu[i]/mu[j]) * // 1 + (mu[i]/mu[j]^1/2
-                            std::pow(M[j]/M[i], 1./4.0);   // (M[i]/M[j])^1/4
-
-                        phiIJ *= phiIJ;
-                        phiIJ /= std::sqrt(8*(1 + M[i]/M[j]));
-                        divisor += Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, j))*phiIJ;
-                    }
-                    const auto& xAlphaI = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, i));
-                    muResult += xAlphaI*mu[i]/divisor;
+                // Wilke method, see Opm::WilkeViscosityMixing
+                LhsEval mu[numComponents];
+                if (values) {
+                    mu[H2OIdx] = (*values)[h2oGasViscosityIdx_];
+                    mu[AirIdx] = (*values)[airGasViscosityIdx_];
+                }
+                else {
+                    mu[H2OIdx] = H2O::gasViscosity(T, H2O::vaporPressure(T));
+                    mu[AirIdx] = Air::gasViscosity(T, p);
                 }
-                return muResult;
+
+                LhsEval x[numComponents];
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                    x[compIdx] = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, compIdx));
+
+                return gasViscosityMixing_().viscosity(mu, x);
             }
         }
         OPM_THROW(std::logic_error, "Invalid phase index " << phaseIdx);
@@ -385,7 +490,7 @@ public:
     //! \copydoc BaseFluidSystem::fugacityCoefficient
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval fugacityCoefficient(const FluidState& fluidState,
-                                       const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                       const ParameterCache<ParamCacheEval>& paramCache,
                                        unsigned phaseIdx,
                                        unsigned compIdx)
     {
@@ -396,6 +501,10 @@ public:
         const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
 
         if (phaseIdx == liquidPhaseIdx) {
+            std::array<LhsEval, numMixtureValues_> tab;
+            if (const auto* values = cachedMixtureValues_(paramCache, liquidPhaseIdx, T, p, tab))
+                return (*values)[(compIdx == H2OIdx) ? h2oVaporPressureIdx_ : airHenryIdx_]/p;
+
             if (compIdx == H2OIdx)
                 return H2O::vaporPressure(T)/p;
             return Opm::BinaryCoeff::H2O_Air::henry(T)/p;
@@ -409,13 +518,17 @@ public:
     //! \copydoc BaseFluidSystem::diffusionCoefficient
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval binaryDiffusionCoefficient(const FluidState& fluidState,
-                                              const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                              const ParameterCache<ParamCacheEval>& paramCache,
                                               unsigned phaseIdx,
                                               unsigned /*compIdx*/)
     {
         const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
         const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
 
+        std::array<LhsEval, numMixtureValues_> tab;
+        if (const auto* values = cachedMixtureValues_(paramCache, phaseIdx, T, p, tab))
+            return (*values)[(phaseIdx == liquidPhaseIdx) ? liquidDiffCoeffIdx_ : gasDiffCoeffIdx_];
+
         if (phaseIdx == liquidPhaseIdx)
             return BinaryCoeff::H2O_Air::liquidDiffCoeff(T, p);
 
@@ -492,6 +605,114 @@ public:
                 return lambdaDryAir; // conductivity of Nitrogen [W / (m K ) ]
         }
     }
+
+private:
+    static MixtureTable& mixtureTable_()
+    {
+        static MixtureTable table;
+        return table;
+    }
+
+    // the factors of the Wilke mixing rule for the gas viscosity. they only depend on
+    // the molar masses of the components, so they are computed on first use.
+    static const WilkeViscosityMixing<Scalar, numComponents>& gasViscosityMixing_()
+    {
+        Scalar M[numComponents];
+        M[H2OIdx] = H2O::molarMass();
+        M[AirIdx] = Air::molarMass();
+        static const WilkeViscosityMixing<Scalar, numComponents> mixing(M);
+        return mixing;
+    }
+
+    // retrieve the tabulated mixture properties. returns false if the mixture
+    // properties are not tabulated or if the position is outside the table.
+    template <class LhsEval>
+    static bool lookupMixtureTable_(const LhsEval& T,
+                                    const LhsEval& p,
+                                    std::array<LhsEval, numMixtureValues_>& values)
+    {
+        const MixtureTable& table = mixtureTable_();
+        if (!table.applies(T, p))
+            return false;
+
+        table.eval(T, p, values);
+        return true;
+    }
+
+    // evaluate the mixture properties which are stored by the table of
+    // initMixtureTables() analytically
+    template <class LhsEval>
+    static void computeMixtureValues_(const LhsEval& T,
+                                      const LhsEval& p,
+                                      std::array<LhsEval, numMixtureValues_>& values)
+    {
+        const LhsEval& pSat = H2O::vaporPressure(T);
+        values[h2oVaporPressureIdx_] = pSat;
+        values[h2oGasViscosityIdx_] = H2O::gasViscosity(T, pSat);
+        values[airGasViscosityIdx_] = Air::gasViscosity(T, p);
+        values[airHenryIdx_] = BinaryCoeff::H2O_Air::henry(T);
+        values[liquidDiffCoeffIdx_] = BinaryCoeff::H2O_Air::liquidDiffCoeff(T, p);
+        values[gasDiffCoeffIdx_] = BinaryCoeff::H2O_Air::gasDiffCoeff(T, p);
+    }
+
+    // retrieve the mixture properties of a phase from the parameter cache or from the
+    // mixture table. The cache can only be used if it uses the same type of
+    // evaluation as the result. returns nullptr if neither is applicable.
+    template <class LhsEval, class ParamCacheEval>
+    static const std::array<LhsEval, numMixtureValues_>*
+    cachedMixtureValues_(const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                         unsigned /*phaseIdx*/,
+                         const LhsEval& T,
+                         const LhsEval& p,
+                         std::array<LhsEval, numMixtureValues_>& tab)
+    { return lookupMixtureTable_(T, p, tab) ? &tab : nullptr; }
+
+    template <class LhsEval>
+    static const std::array<LhsEval, numMixtureValues_>*
+    cachedMixtureValues_(const ParameterCache<LhsEval>& paramCache,
+                         unsigned phaseIdx,
+                         const LhsEval& T,
+                         const LhsEval& p,
+                         std::array<LhsEval, numMixtureValues_>& tab)
+    {
+        if (paramCache.applies(phaseIdx, T, p))
+            return &paramCache.mixtureValues(phaseIdx);
+        return lookupMixtureTable_(T, p, tab) ? &tab : nullptr;
+    }
+
+    // retrieve the density and the viscosity of pure water from the parameter cache,
+    // see above
+    template <class LhsEval, class ParamCacheEval>
+    static LhsEval cachedWaterDensity_(const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                       const LhsEval& T,
+                                       const LhsEval& p)
+    { return H2O::liquidDensity(T, p); }
+
+    template <class LhsEval>
+    static LhsEval cachedWaterDensity_(const ParameterCache<LhsEval>& paramCache,
+                                       const LhsEval& T,
+                                       const LhsEval& p)
+    {
+        if (paramCache.applies(liquidPhaseIdx, T, p))
+            return paramCache.waterDensity();
+        return H2O::liquidDensity(T, p);
+    }
+
+    template <class LhsEval, class ParamCacheEval>
+    static LhsEval cachedWaterViscosity_(const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                         const LhsEval& T,
+                                         const LhsEval& p)
+    { return H2O::liquidViscosity(T, p); }
+
+    template <class LhsEval>
+    static LhsEval cachedWaterViscosity_(const ParameterCache<LhsEval>& paramCache,
+                                         const LhsEval& T,
+                                         const LhsEval& p)
+    {
+        if (paramCache.applies(liquidPhaseIdx, T, p))
+            return paramCache.waterViscosity();
+        return H2O::liquidViscosity(T, p);
+    }
 };
 
 } // namespace FluidSystems
@@ -31,6 +31,7 @@
 #include "NullParameterCache.hpp"
 
 #include <opm/material/IdealGas.hpp>
+#include <opm/material/common/UniformTabulated2DMultiFunction.hpp>
 #include <opm/material/components/N2.hpp>
 #include <opm/material/components/Air.hpp>
 #include <opm/material/components/H2O.hpp>
@@ -42,6 +43,7 @@
 #include <opm/material/binarycoefficients/H2O_Mesitylene.hpp>
 #include <opm/material/binarycoefficients/Air_Mesitylene.hpp>
 
+#include <array>
 #include <iostream>
 
 namespace Opm {
@@ -62,6 +64,19 @@ class H2OAirMesitylene
     typedef Opm::H2O<Scalar> IapwsH2O;
     typedef Opm::TabulatedComponent<Scalar, IapwsH2O, /*alongVaporPressure=*/false> TabulatedH2O;
 
+    // the mixture properties which are stored by the table of initMixtureTables()
+    enum {
+        h2oVaporPressureIdx_,
+        naplVaporPressureIdx_,
+        h2oGasViscosityIdx_,
+        airGasViscosityIdx_,
+        naplGasViscosityIdx_,
+        airHenryIdx_,
+        naplHenryIdx_,
+        numMixtureValues_
+    };
+    typedef Opm::UniformTabulated2DMultiFunction<Scalar, numMixtureValues_> MixtureTable;
+
 public:
     template <class Evaluation>
     struct ParameterCache : public Opm::NullParameterCache<Evaluation>
@@ -128,6 +143,39 @@ public:
         }
     }
 
+    /*!
+     * \brief Tabulate the mixture properties which only depend on temperature and
+     *        pressure.
+     *
+     * After this method has been called, the vapor pressures and the gas viscosities
+     * of water and mesitylene, the gas viscosity of air and the Henry coefficients are
+     * determined by a single lookup into a table which stores all of these quantities
+     * for each sampling point. Outside of the tabulated range, they are still
+     * evaluated analytically.
+     *
+     * \param tempMin The minimum temperature of the table [K]
+     * \param tempMax The maximum temperature of the table [K]
+     * \param nTemp The number of sampling points on the temperature axis
+     * \param pressMin The minimum pressure of the table [Pa]
+     * \param pressMax The maximum pressure of the table [Pa]
+     * \param nPress The number of sampling points on the pressure axis
+     */
+    static void initMixtureTables(Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                                  Scalar pressMin, Scalar pressMax, unsigned nPress)
+    {
+        MixtureTable& table = mixtureTable_();
+        table.resize(tempMin, tempMax, nTemp, pressMin, pressMax, nPress);
+        table.sample([](Scalar T, Scalar p, typename MixtureTable::ValueArray& values) {
+                values[h2oVaporPressureIdx_] = H2O::vaporPressure(T);
+                values[naplVaporPressureIdx_] = NAPL::vaporPressure(T);
+                values[h2oGasViscosityIdx_] = H2O::gasViscosity(T, values[h2oVaporPressureIdx_]);
+                values[airGasViscosityIdx_] = Air::gasViscosity(T, p);
+                values[naplGasViscosityIdx_] = NAPL::gasViscosity(T, values[naplVaporPressureIdx_]);
+                values[airHenryIdx_] = BinaryCoeff::H2O_N2::henry(T);
+                values[naplHenryIdx_] = BinaryCoeff::H2O_Mesitylene::henry(T);
+            });
+    }
+
     //! \copydoc BaseFluidSystem::isLiquid
     static bool isLiquid(unsigned phaseIdx)
     {
@@ -275,11 +323,18 @@ public:
          * divisions
          * -- compare e.g. with Promo Class p. 32/33
          */
-        const LhsEval mu[numComponents] = {
-            H2O::gasViscosity(T, H2O::vaporPressure(T)),
-            Air::gasViscosity(T, p),
-            NAPL::gasViscosity(T, NAPL::vaporPressure(T))
-        };
+        LhsEval mu[numComponents];
+        std::array<LhsEval, numMixtureValues_> tab;
+        if (lookupMixtureTable_(T, p, tab)) {
+            mu[H2OIdx] = tab[h2oGasViscosityIdx_];
+            mu[airIdx] = tab[airGasViscosityIdx_];
+            mu[NAPLIdx] = tab[naplGasViscosityIdx_];
+        }
+        else {
+            mu[H2OIdx] = H2O::gasViscosity(T, H2O::vaporPressure(T));
+            mu[airIdx] = Air::gasViscosity(T, p);
+            mu[NAPLIdx] = NAPL::gasViscosity(T, NAPL::vaporPressure(T));
+        }
         // molar masses
         const Scalar M[numComponents] = {
             H2O::molarMass(),
@@ -380,7 +435,19 @@ public:
         Valgrind::CheckDefined(T);
         Valgrind::CheckDefined(p);
 
+        std::array<LhsEval, numMixtureValues_> tab;
+        bool isTabulated = lookupMixtureTable_(T, p, tab);
+
         if (phaseIdx == waterPhaseIdx) {
+            if (isTabulated) {
+                if (compIdx == H2OIdx)
+                    return tab[h2oVaporPressureIdx_]/p;
+                else if (compIdx == airIdx)
+                    return tab[airHenryIdx_]/p;
+                else if (compIdx == NAPLIdx)
+                    return tab[naplHenryIdx_]/p;
+            }
+
             if (compIdx == H2OIdx)
                 return H2O::vaporPressure(T)/p;
             else if (compIdx == airIdx)
@@ -395,7 +462,8 @@ public:
         // other components, i.e. the fugacity cofficient is much
         // smaller.
         else if (phaseIdx == naplPhaseIdx) {
-            const LhsEval& phiNapl = NAPL::vaporPressure(T)/p;
+            const LhsEval& phiNapl =
+                (isTabulated ? tab[naplVaporPressureIdx_] : NAPL::vaporPressure(T))/p;
             if (compIdx == NAPLIdx)
                 return phiNapl;
             else if (compIdx == airIdx)
@@ -471,6 +539,28 @@ public:
         // 344e-6 cal/(s cm K) = 0.0143964 J/(s m K)
         return 0.0143964;
     }
+
+private:
+    static MixtureTable& mixtureTable_()
+    {
+        static MixtureTable table;
+        return table;
+    }
+
+    // retrieve the tabulated mixture properties. returns false if the mixture
+    // properties are not tabulated or if the position is outside the table.
+    template <class LhsEval>
+    static bool lookupMixtureTable_(const LhsEval& T,
+                                    const LhsEval& p,
+                                    std::array<LhsEval, numMixtureValues_>& values)
+    {
+        const MixtureTable& table = mixtureTable_();
+        if (!table.applies(T, p))
+            return false;
+
+        table.eval(T, p, values);
+        return true;
+    }
 };
 } // namespace FluidSystems
 } // namespace Opm
@@ -28,6 +28,7 @@
 #define OPM_H2O_AIR_XYLENE_FLUID_SYSTEM_HPP
 
 #include <opm/material/IdealGas.hpp>
+#include <opm/material/common/UniformTabulated2DMultiFunction.hpp>
 #include <opm/material/components/Air.hpp>
 #include <opm/material/components/H2O.hpp>
 #include <opm/material/components/Xylene.hpp>
@@ -40,6 +41,8 @@
 #include "BaseFluidSystem.hpp"
 #include "NullParameterCache.hpp"
 
+#include <array>
+
 namespace Opm {
 namespace FluidSystems {
 
@@ -55,6 +58,22 @@ class H2OAirXylene
     typedef H2OAirXylene<Scalar> ThisType;
     typedef BaseFluidSystem<Scalar, ThisType> Base;
 
+    // the mixture properties which are stored by the table of initMixtureTables()
+    enum {
+        h2oVaporPressureIdx_,
+        naplVaporPressureIdx_,
+        h2oGasViscosityIdx_,
+        airGasViscosityIdx_,
+        naplGasViscosityIdx_,
+        airHenryIdx_,
+        naplHenryIdx_,
+        airXyleneGasDiffCoeffIdx_,
+        h2oXyleneGasDiffCoeffIdx_,
+        h2oAirGasDiffCoeffIdx_,
+        numMixtureValues_
+    };
+    typedef Opm::UniformTabulated2DMultiFunction<Scalar, numMixtureValues_> MixtureTable;
+
 public:
     template <class Evaluation>
     struct ParameterCache : public Opm::NullParameterCache<Evaluation>
@@ -90,6 +109,43 @@ public:
     static void init()
     { }
 
+    /*!
+     * \brief Tabulate the mixture properties which only depend on temperature and
+     *        pressure.
+     *
+     * After this method has been called, the vapor pressures and the gas viscosities
+     * of water and xylene, the gas viscosity of air and the Henry coefficients and the binary
+     * gas diffusion coefficients are
+     * determined by a single lookup into a table which stores all of these quantities
+     * for each sampling point. Outside of the tabulated range, they are still
+     * evaluated analytically.
+     *
+     * \param tempMin The minimum temperature of the table [K]
+     * \param tempMax The maximum temperature of the table [K]
+     * \param nTemp The number of sampling points on the temperature axis
+     * \param pressMin The minimum pressure of the table [Pa]
+     * \param pressMax The maximum pressure of the table [Pa]
+     * \param nPress The number of sampling points on the pressure axis
+     */
+    static void initMixtureTables(Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                                  Scalar pressMin, Scalar pressMax, unsigned nPress)
+    {
+        MixtureTable& table = mixtureTable_();
+        table.resize(tempMin, tempMax, nTemp, pressMin, pressMax, nPress);
+        table.sample([](Scalar T, Scalar p, typename MixtureTable::ValueArray& values) {
+                values[h2oVaporPressureIdx_] = H2O::vaporPressure(T);
+                values[naplVaporPressureIdx_] = NAPL::vaporPressure(T);
+                values[h2oGasViscosityIdx_] = H2O::gasViscosity(T, values[h2oVaporPressureIdx_]);
+                values[airGasViscosityIdx_] = Air::simpleGasViscosity(T, p);
+                values[naplGasViscosityIdx_] = NAPL::gasViscosity(T, values[naplVaporPressureIdx_]);
+                values[airHenryIdx_] = BinaryCoeff::H2O_Air::henry(T);
+                values[naplHenryIdx_] = BinaryCoeff::H2O_Xylene::henry(T);
+                values[airXyleneGasDiffCoeffIdx_] = BinaryCoeff::Air_Xylene::gasDiffCoeff(T, p);
+                values[h2oXyleneGasDiffCoeffIdx_] = BinaryCoeff::H2O_Xylene::gasDiffCoeff(T, p);
+                values[h2oAirGasDiffCoeffIdx_] = BinaryCoeff::H2O_Air::gasDiffCoeff(T, p);
+            });
+    }
+
     //! \copydoc BaseFluidSystem::isLiquid
     static bool isLiquid(unsigned phaseIdx)
     {
@@ -236,11 +292,18 @@ public:
          * divisions
          * -- compare e.g. with Promo Class p. 32/33
          */
-        const LhsEval mu[numComponents] = {
-            H2O::gasViscosity(T, H2O::vaporPressure(T)),
-            Air::simpleGasViscosity(T, p),
-            NAPL::gasViscosity(T, NAPL::vaporPressure(T))
-        };
+        LhsEval mu[numComponents];
+        std::array<LhsEval, numMixtureValues_> tab;
+        if (lookupMixtureTable_(T, p, tab)) {
+            mu[H2OIdx] = tab[h2oGasViscosityIdx_];
+            mu[airIdx] = tab[airGasViscosityIdx_];
+            mu[NAPLIdx] = tab[naplGasViscosityIdx_];
+        }
+        else {
+            mu[H2OIdx] = H2O::gasViscosity(T, H2O::vaporPressure(T));
+            mu[airIdx] = Air::simpleGasViscosity(T, p);
+            mu[NAPLIdx] = NAPL::gasViscosity(T, NAPL::vaporPressure(T));
+        }
         // molar masses
         const Scalar M[numComponents] = {
             H2O::molarMass(),
@@ -278,9 +341,18 @@ public:
             const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
             const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
 
-            const LhsEval& diffAC = Opm::BinaryCoeff::Air_Xylene::gasDiffCoeff(T, p);
-            const LhsEval& diffWC = Opm::BinaryCoeff::H2O_Xylene::gasDiffCoeff(T, p);
-            const LhsEval& diffAW = Opm::BinaryCoeff::H2O_Air::gasDiffCoeff(T, p);
+            LhsEval diffAC, diffWC, diffAW;
+            std::array<LhsEval, numMixtureValues_> tab;
+            if (lookupMixtureTable_(T, p, tab)) {
+                diffAC = tab[airXyleneGasDiffCoeffIdx_];
+                diffWC = tab[h2oXyleneGasDiffCoeffIdx_];
+                diffAW = tab[h2oAirGasDiffCoeffIdx_];
+            }
+            else {
+                diffAC = Opm::BinaryCoeff::Air_Xylene::gasDiffCoeff(T, p);
+                diffWC = Opm::BinaryCoeff::H2O_Xylene::gasDiffCoeff(T, p);
+                diffAW = Opm::BinaryCoeff::H2O_Air::gasDiffCoeff(T, p);
+            }
 
             const LhsEval& xga = Opm::decay<LhsEval>(fluidState.moleFraction(gasPhaseIdx, airIdx));
             const LhsEval& xgw = Opm::decay<LhsEval>(fluidState.moleFraction(gasPhaseIdx, H2OIdx));
@@ -332,7 +404,19 @@ public:
         const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
         const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
 
+        std::array<LhsEval, numMixtureValues_> tab;
+        bool isTabulated = lookupMixtureTable_(T, p, tab);
+
         if (phaseIdx == waterPhaseIdx) {
+            if (isTabulated) {
+                if (compIdx == H2OIdx)
+                    return tab[h2oVaporPressureIdx_]/p;
+                else if (compIdx == airIdx)
+                    return tab[airHenryIdx_]/p;
+                else if (compIdx == NAPLIdx)
+                    return tab[naplHenryIdx_]/p;
+            }
+
             if (compIdx == H2OIdx)
                 return H2O::vaporPressure(T)/p;
             else if (compIdx == airIdx)
@@ -347,7 +431,8 @@ public:
         // other components, i.e. the fugacity cofficient is much
         // smaller.
         if (phaseIdx == naplPhaseIdx) {
-            const LhsEval& phiNapl = NAPL::vaporPressure(T)/p;
+            const LhsEval& phiNapl =
+                (isTabulated ? tab[naplVaporPressureIdx_] : NAPL::vaporPressure(T))/p;
             if (compIdx == NAPLIdx)
                 return phiNapl;
             else if (compIdx == airIdx)
@@ -393,6 +478,27 @@ public:
     }
 
 private:
+    static MixtureTable& mixtureTable_()
+    {
+        static MixtureTable table;
+        return table;
+    }
+
+    // retrieve the tabulated mixture properties. returns false if the mixture
+    // properties are not tabulated or if the position is outside the table.
+    template <class LhsEval>
+    static bool lookupMixtureTable_(const LhsEval& T,
+                                    const LhsEval& p,
+                                    std::array<LhsEval, numMixtureValues_>& values)
+    {
+        const MixtureTable& table = mixtureTable_();
+        if (!table.applies(T, p))
+            return false;
+
+        table.eval(T, p, values);
+        return true;
+    }
+
     template <class LhsEval>
     static LhsEval waterPhaseDensity_(const LhsEval& T,
                                       const LhsEval& pw,
@@ -28,9 +28,11 @@
 #define OPM_H2O_N2_FLUID_SYSTEM_HPP
 
 #include "BaseFluidSystem.hpp"
-#include "NullParameterCache.hpp"
+#include "ParameterCacheBase.hpp"
+#include "WilkeViscosityMixing.hpp"
 
 #include <opm/material/IdealGas.hpp>
+#include <opm/material/common/UniformTabulated2DMultiFunction.hpp>
 #include <opm/material/components/N2.hpp>
 #include <opm/material/components/H2O.hpp>
 #include <opm/material/components/SimpleH2O.hpp>
@@ -41,6 +43,9 @@
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
+#include <array>
+#include <cstddef>
+#include <type_traits>
 #include <iostream>
 #include <cassert>
 
@@ -65,10 +70,99 @@ class H2ON2
     typedef Opm::TabulatedComponent<Scalar, IapwsH2O > TabulatedH2O;
     typedef Opm::N2<Scalar> SimpleN2;
 
+    // the mixture properties which are stored by the table of initMixtureTables()
+    enum {
+        h2oVaporPressureIdx_,
+        h2oGasViscosityIdx_,
+        n2GasViscosityIdx_,
+        n2HenryIdx_,
+        liquidDiffCoeffIdx_,
+        gasDiffCoeffIdx_,
+        numMixtureValues_
+    };
+    typedef Opm::UniformTabulated2DMultiFunction<Scalar, numMixtureValues_> MixtureTable;
+
 public:
-    //! \copydoc BaseFluidSystem::ParameterCache
+    /*!
+     * \brief The parameter cache of the H2O-N2 fluid system
+     *
+     * The cache stores the quantities of each phase which only depend on its
+     * temperature and pressure, i.e., the mixture properties which are tabulated by
+     * initMixtureTables() and, for the liquid phase, the density and the viscosity of
+     * pure water. Updates which only change the composition thus do not recompute
+     * anything. The cached values are only used if the fluid state passed to the fluid
+     * system exhibits the temperature and pressure of the last update of the phase.
+     */
     template <class Evaluation>
-    using ParameterCache = NullParameterCache<Evaluation>;
+    struct ParameterCache : public Opm::ParameterCacheBase<ParameterCache<Evaluation> >
+    {
+        typedef Opm::ParameterCacheBase<ParameterCache<Evaluation> > ParentType;
+
+        ParameterCache()
+        { isValid_.fill(false); }
+
+        //! \copydoc ParameterCacheBase::updatePhase
+        template <class FluidState>
+        void updatePhase(const FluidState& fluidState,
+                         unsigned phaseIdx,
+                         int exceptQuantities = ParentType::None)
+        {
+            // none of the cached quantities depends on the composition
+            if (isValid_[phaseIdx]
+                && (exceptQuantities & ParentType::Temperature)
+                && (exceptQuantities & ParentType::Pressure))
+                return;
+
+            const auto& T = T_[phaseIdx] = Opm::decay<Evaluation>(fluidState.temperature(phaseIdx));
+            const auto& p = p_[phaseIdx] = Opm::decay<Evaluation>(fluidState.pressure(phaseIdx));
+
+            auto& values = mixtureValues_[phaseIdx];
+            if (!lookupMixtureTable_(T, p, values))
+                computeMixtureValues_(T, p, values);
+
+            if (phaseIdx == liquidPhaseIdx) {
+                waterDensity_ = H2O::liquidDensity(T, p);
+                waterViscosity_ = H2O::liquidViscosity(T, p);
+            }
+
+            isValid_[phaseIdx] = true;
+        }
+
+        /*!
+         * \brief Returns true if the cached quantities of a phase apply to a given
+         *        temperature and pressure.
+         */
+        bool applies(unsigned phaseIdx, const Evaluation& T, const Evaluation& p) const
+        { return isValid_[phaseIdx] && T == T_[phaseIdx] && p == p_[phaseIdx]; }
+
+        /*!
+         * \brief The cached mixture properties of a phase.
+         */
+        const std::array<Evaluation, numMixtureValues_>& mixtureValues(unsigned phaseIdx) const
+        { return mixtureValues_[phaseIdx]; }
+
+        /*!
+         * \brief The cached density of pure water at the conditions of the liquid
+         *        phase [kg/m^3]
+         */
+        const Evaluation& waterDensity() const
+        { return waterDensity_; }
+
+        /*!
+         * \brief The cached viscosity of pure water at the conditions of the liquid
+         *        phase [Pa s]
+         */
+        const Evaluation& waterViscosity() const
+        { return waterViscosity_; }
+
+    private:
+        std::array<Evaluation, /*numPhases=*/2> T_;
+        std::array<Evaluation, /*numPhases=*/2> p_;
+        std::array<std::array<Evaluation, numMixtureValues_>, /*numPhases=*/2> mixtureValues_;
+        Evaluation waterDensity_;
+        Evaluation waterViscosity_;
+        std::array<bool, /*numPhases=*/2> isValid_;
+    };
 
     /****************************************
      * Fluid phase related static parameters
@@ -166,7 +260,7 @@ public:
     }
 
     //! \copydoc BaseFluidSystem::molarMass
-    static Scalar molarMass(unsigned compIdx)
+    static constexpr Scalar molarMass(unsigned compIdx)
     {
         //assert(0 <= compIdx && compIdx < numComponents);
         return (compIdx == H2OIdx)
@@ -181,7 +275,7 @@ public:
      *
      * \copydetails Doxygen::compIdxParam
      */
-    static Scalar criticalTemperature(unsigned compIdx)
+    static constexpr Scalar criticalTemperature(unsigned compIdx)
     {
         return (compIdx == H2OIdx)
             ? H2O::criticalTemperature()
@@ -195,7 +289,7 @@ public:
      *
      * \copydetails Doxygen::compIdxParam
      */
-    static Scalar criticalPressure(unsigned compIdx)
+    static constexpr Scalar criticalPressure(unsigned compIdx)
     {
         return (compIdx == H2OIdx)
             ? H2O::criticalPressure()
@@ -209,7 +303,7 @@ public:
      *
      * \copydetails Doxygen::compIdxParam
      */
-    static Scalar acentricFactor(unsigned compIdx)
+    static constexpr Scalar acentricFactor(unsigned compIdx)
     {
         return (compIdx == H2OIdx)
             ? H2O::acentricFactor()
@@ -258,6 +352,33 @@ public:
         }
     }
 
+    /*!
+     * \brief Tabulate the mixture properties which only depend on temperature and
+     *        pressure.
+     *
+     * After this method has been called, the vapor pressure and the gas viscosity of
+     * water, the gas viscosity and the Henry coefficient of nitrogen and the binary
+     * diffusion coefficients are determined by a single lookup into a table which
+     * stores all of these quantities for each sampling point. Outside of the tabulated
+     * range, they are still evaluated analytically.
+     *
+     * \param tempMin The minimum temperature of the table [K]
+     * \param tempMax The maximum temperature of the table [K]
+     * \param nTemp The number of sampling points on the temperature axis
+     * \param pressMin The minimum pressure of the table [Pa]
+     * \param pressMax The maximum pressure of the table [Pa]
+     * \param nPress The number of sampling points on the pressure axis
+     */
+    static void initMixtureTables(Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                                  Scalar pressMin, Scalar pressMax, unsigned nPress)
+    {
+        MixtureTable& table = mixtureTable_();
+        table.resize(tempMin, tempMax, nTemp, pressMin, pressMax, nPress);
+        table.sample([](Scalar T, Scalar p, typename MixtureTable::ValueArray& values) {
+                computeMixtureValues_(T, p, values);
+            });
+    }
+
     /*!
      * \copydoc BaseFluidSystem::density
      *
@@ -267,8 +388,345 @@ public:
      */
     template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
     static LhsEval density(const FluidState& fluidState,
-                           const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                           const ParameterCache<ParamCacheEval>& paramCache,
                            unsigned phaseIdx)
+    { return density_<LhsEval>(fluidState, paramCache, phaseIdx); }
+
+    /*!
+     * \brief Calculate the density of a fluid phase which is known at compile time.
+     *
+     * The result is the same as the one of the variant which takes the phase index as
+     * an argument, but the branches for the other phase are removed at compile time.
+     */
+    template <unsigned phaseIdx, class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval density(const FluidState& fluidState,
+                           const ParameterCache<ParamCacheEval>& paramCache)
+    {
+        static_assert(phaseIdx < static_cast<unsigned>(numPhases), "Invalid phase index");
+        return density_<LhsEval>(fluidState, paramCache, std::integral_constant<unsigned, phaseIdx>());
+    }
+
+    //! \copydoc BaseFluidSystem::viscosity
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval viscosity(const FluidState& fluidState,
+                             const ParameterCache<ParamCacheEval>& paramCache,
+                             unsigned phaseIdx)
+    { return viscosity_<LhsEval>(fluidState, paramCache, phaseIdx); }
+
+    /*!
+     * \brief Calculate the dynamic viscosity of a fluid phase which is known at compile time.
+     *
+     * The result is the same as the one of the variant which takes the phase index as
+     * an argument, but the branches for the other phase are removed at compile time.
+     */
+    template <unsigned phaseIdx, class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval viscosity(const FluidState& fluidState,
+                             const ParameterCache<ParamCacheEval>& paramCache)
+    {
+        static_assert(phaseIdx < static_cast<unsigned>(numPhases), "Invalid phase index");
+        return viscosity_<LhsEval>(fluidState, paramCache, std::integral_constant<unsigned, phaseIdx>());
+    }
+
+    //! \copydoc BaseFluidSystem::fugacityCoefficient
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval fugacityCoefficient(const FluidState& fluidState,
+                                       const ParameterCache<ParamCacheEval>& paramCache,
+                                       unsigned phaseIdx,
+                                       unsigned compIdx)
+    { return fugacityCoefficient_<LhsEval>(fluidState, paramCache, phaseIdx, compIdx); }
+
+    /*!
+     * \brief Calculate the fugacity coefficient of a component in a fluid phase, both
+     *        of which are known at compile time.
+     *
+     * The result is the same as the one of the variant which takes the indices as
+     * arguments, but the branches for the other phase and component are removed at
+     * compile time.
+     */
+    template <unsigned phaseIdx, unsigned compIdx, class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval fugacityCoefficient(const FluidState& fluidState,
+                                       const ParameterCache<ParamCacheEval>& paramCache)
+    {
+        static_assert(phaseIdx < static_cast<unsigned>(numPhases), "Invalid phase index");
+        static_assert(compIdx < static_cast<unsigned>(numComponents), "Invalid component index");
+        return fugacityCoefficient_<LhsEval>(fluidState,
+                                             paramCache,
+                                             std::integral_constant<unsigned, phaseIdx>(),
+                                             std::integral_constant<unsigned, compIdx>());
+    }
+
+    //! \copydoc BaseFluidSystem::diffusionCoefficient
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval diffusionCoefficient(const FluidState& fluidState,
+                                        const ParameterCache<ParamCacheEval>& paramCache,
+                                        unsigned phaseIdx,
+                                        unsigned /*compIdx*/)
+
+    {
+        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
+        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
+
+        std::array<LhsEval, numMixtureValues_> tab;
+        if (const auto* values = cachedMixtureValues_(paramCache, phaseIdx, T, p, tab))
+            return (*values)[(phaseIdx == liquidPhaseIdx) ? liquidDiffCoeffIdx_ : gasDiffCoeffIdx_];
+
+        // liquid phase
+        if (phaseIdx == liquidPhaseIdx)
+            return BinaryCoeff::H2O_N2::liquidDiffCoeff(T, p);
+
+        // gas phase
+        assert(phaseIdx == gasPhaseIdx);
+        return BinaryCoeff::H2O_N2::gasDiffCoeff(T, p);
+    }
+
+    //! \copydoc BaseFluidSystem::enthalpy
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval enthalpy(const FluidState& fluidState,
+                            const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                            unsigned phaseIdx)
+    { return enthalpy_<LhsEval>(fluidState, phaseIdx); }
+
+    /*!
+     * \brief Calculate the specific enthalpy of a fluid phase which is known at compile time.
+     *
+     * The result is the same as the one of the variant which takes the phase index as
+     * an argument, but the branches for the other phase are removed at compile time.
+     */
+    template <unsigned phaseIdx, class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval enthalpy(const FluidState& fluidState,
+                            const ParameterCache<ParamCacheEval>& /*paramCache*/)
+    {
+        static_assert(phaseIdx < static_cast<unsigned>(numPhases), "Invalid phase index");
+        return enthalpy_<LhsEval>(fluidState, std::integral_constant<unsigned, phaseIdx>());
+    }
+
+    //! \copydoc BaseFluidSystem::thermalConductivity
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval thermalConductivity(const FluidState& fluidState,
+                                       const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                       unsigned phaseIdx)
+    {
+        assert(0 <= phaseIdx && phaseIdx < numPhases);
+
+        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
+        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
+        if (phaseIdx == liquidPhaseIdx) // liquid phase
+            return H2O::liquidThermalConductivity(T, p);
+
+        // gas phase
+        assert(phaseIdx == gasPhaseIdx);
+
+        if (useComplexRelations){
+            // return the sum of the partial conductivity of Nitrogen and Steam
+            const auto& xH2O = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, H2OIdx));
+            const auto& xN2 = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, N2Idx));
+
+            // Assuming Raoult's, Daltons law and ideal gas in order to obtain the
+            // partial pressures in the gas phase
+            const auto& lambdaN2 = N2::gasThermalConductivity(T, p*xN2);
+            const auto& lambdaH2O = H2O::gasThermalConductivity(T, p*xH2O);
+
+            return lambdaN2 + lambdaH2O;
+        }
+        else
+            // return the conductivity of dry Nitrogen
+            return N2::gasThermalConductivity(T, p);
+    }
+
+    //! \copydoc BaseFluidSystem::heatCapacity
+    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
+    static LhsEval heatCapacity(const FluidState& fluidState,
+                                const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                unsigned phaseIdx)
+    {
+        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
+        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
+        const auto& xAlphaH2O = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, H2OIdx));
+        const auto& xAlphaN2 = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, N2Idx));
+        const auto& XAlphaH2O = Opm::decay<LhsEval>(fluidState.massFraction(phaseIdx, H2OIdx));
+        const auto& XAlphaN2 = Opm::decay<LhsEval>(fluidState.massFraction(phaseIdx, N2Idx));
+
+        if (phaseIdx == liquidPhaseIdx)
+            return H2O::liquidHeatCapacity(T, p);
+
+        assert(phaseIdx == gasPhaseIdx);
+
+        // for the gas phase, assume ideal mixture, i.e. molecules of
+        // one component don't "see" the molecules of the other
+        // component
+        LhsEval c_pN2;
+        LhsEval c_pH2O;
+        // let the water and nitrogen components do things their own way
+        if (useComplexRelations) {
+            c_pN2 = N2::gasHeatCapacity(T, p*xAlphaN2);
+            c_pH2O = H2O::gasHeatCapacity(T, p*xAlphaH2O);
+        }
+        else {
+            // assume an ideal gas for both components. See:
+            //
+            // http://en.wikipedia.org/wiki/Heat_capacity
+            Scalar c_vN2molar = Opm::Constants<Scalar>::R*2.39;
+            Scalar c_pN2molar = Opm::Constants<Scalar>::R + c_vN2molar;
+
+            Scalar c_vH2Omolar = Opm::Constants<Scalar>::R*3.37; // <- correct??
+            Scalar c_pH2Omolar = Opm::Constants<Scalar>::R + c_vH2Omolar;
+
+            c_pN2 = c_pN2molar/molarMass(N2Idx);
+            c_pH2O = c_pH2Omolar/molarMass(H2OIdx);
+        }
+
+        // mingle both components together. this assumes that there is no "cross
+        // interaction" between both flavors of molecules.
+        return XAlphaH2O*c_pH2O + XAlphaN2*c_pN2;
+    }
+
+    /*!
+     * \copydoc BaseFluidSystem::densityBatch
+     *
+     * The phase index is dispatched once for all fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void densityBatch(size_t numValues,
+                             const FluidStateRange& fluidStates,
+                             ParamCache* paramCaches,
+                             unsigned phaseIdx,
+                             LhsEval* values)
+    {
+        assert(0 <= phaseIdx && phaseIdx < numPhases);
+
+        if (phaseIdx == liquidPhaseIdx)
+            densityBatch_(numValues, fluidStates, paramCaches,
+                          std::integral_constant<unsigned, liquidPhaseIdx>(), values);
+        else
+            densityBatch_(numValues, fluidStates, paramCaches,
+                          std::integral_constant<unsigned, gasPhaseIdx>(), values);
+    }
+
+    /*!
+     * \copydoc BaseFluidSystem::viscosityBatch
+     *
+     * The phase index is dispatched once for all fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void viscosityBatch(size_t numValues,
+                               const FluidStateRange& fluidStates,
+                               ParamCache* paramCaches,
+                               unsigned phaseIdx,
+                               LhsEval* values)
+    {
+        assert(0 <= phaseIdx && phaseIdx < numPhases);
+
+        if (phaseIdx == liquidPhaseIdx)
+            viscosityBatch_(numValues, fluidStates, paramCaches,
+                            std::integral_constant<unsigned, liquidPhaseIdx>(), values);
+        else
+            viscosityBatch_(numValues, fluidStates, paramCaches,
+                            std::integral_constant<unsigned, gasPhaseIdx>(), values);
+    }
+
+    /*!
+     * \copydoc BaseFluidSystem::fugacityCoefficientBatch
+     *
+     * The phase and component indices are dispatched once for all fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void fugacityCoefficientBatch(size_t numValues,
+                                         const FluidStateRange& fluidStates,
+                                         ParamCache* paramCaches,
+                                         unsigned phaseIdx,
+                                         unsigned compIdx,
+                                         LhsEval* values)
+    {
+        assert(0 <= phaseIdx && phaseIdx < numPhases);
+        assert(0 <= compIdx && compIdx < numComponents);
+
+        typedef std::integral_constant<unsigned, liquidPhaseIdx> LiquidPhase;
+        typedef std::integral_constant<unsigned, gasPhaseIdx> GasPhase;
+        typedef std::integral_constant<unsigned, H2OIdx> H2OComp;
+        typedef std::integral_constant<unsigned, N2Idx> N2Comp;
+        if (phaseIdx == liquidPhaseIdx) {
+            if (compIdx == H2OIdx)
+                fugacityCoefficientBatch_(numValues, fluidStates, paramCaches, LiquidPhase(), H2OComp(), values);
+            else
+                fugacityCoefficientBatch_(numValues, fluidStates, paramCaches, LiquidPhase(), N2Comp(), values);
+        }
+        else {
+            if (compIdx == H2OIdx)
+                fugacityCoefficientBatch_(numValues, fluidStates, paramCaches, GasPhase(), H2OComp(), values);
+            else
+                fugacityCoefficientBatch_(numValues, fluidStates, paramCaches, GasPhase(), N2Comp(), values);
+        }
+    }
+
+    /*!
+     * \copydoc BaseFluidSystem::enthalpyBatch
+     *
+     * The phase index is dispatched once for all fluid states.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void enthalpyBatch(size_t numValues,
+                              const FluidStateRange& fluidStates,
+                              ParamCache* /*paramCaches*/,
+                              unsigned phaseIdx,
+                              LhsEval* values)
+    {
+        assert(0 <= phaseIdx && phaseIdx < numPhases);
+
+        if (phaseIdx == liquidPhaseIdx)
+            enthalpyBatch_(numValues, fluidStates,
+                           std::integral_constant<unsigned, liquidPhaseIdx>(), values);
+        else
+            enthalpyBatch_(numValues, fluidStates,
+                           std::integral_constant<unsigned, gasPhaseIdx>(), values);
+    }
+
+private:
+    template <class FluidStateRange, class ParamCache, class PhaseIdx, class LhsEval>
+    static void densityBatch_(size_t numValues,
+                              const FluidStateRange& fluidStates,
+                              ParamCache* paramCaches,
+                              PhaseIdx phaseIdx,
+                              LhsEval* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = density_<LhsEval>(fluidStates[i], paramCaches[i], phaseIdx);
+    }
+
+    template <class FluidStateRange, class ParamCache, class PhaseIdx, class LhsEval>
+    static void viscosityBatch_(size_t numValues,
+                                const FluidStateRange& fluidStates,
+                                ParamCache* paramCaches,
+                                PhaseIdx phaseIdx,
+                                LhsEval* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = viscosity_<LhsEval>(fluidStates[i], paramCaches[i], phaseIdx);
+    }
+
+    template <class FluidStateRange, class ParamCache, class PhaseIdx, class CompIdx, class LhsEval>
+    static void fugacityCoefficientBatch_(size_t numValues,
+                                          const FluidStateRange& fluidStates,
+                                          ParamCache* paramCaches,
+                                          PhaseIdx phaseIdx,
+                                          CompIdx compIdx,
+                                          LhsEval* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = fugacityCoefficient_<LhsEval>(fluidStates[i], paramCaches[i], phaseIdx, compIdx);
+    }
+
+    template <class FluidStateRange, class PhaseIdx, class LhsEval>
+    static void enthalpyBatch_(size_t numValues,
+                               const FluidStateRange& fluidStates,
+                               PhaseIdx phaseIdx,
+                               LhsEval* values)
+    {
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = enthalpy_<LhsEval>(fluidStates[i], phaseIdx);
+    }
+
+    template <class LhsEval, class FluidState, class ParamCache, class PhaseIdx>
+    static LhsEval density_(const FluidState& fluidState, const ParamCache& paramCache, PhaseIdx phaseIdx)
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
@@ -283,11 +741,11 @@ public:
         if (phaseIdx == liquidPhaseIdx) {
             if (!useComplexRelations)
                 // assume pure water
-                return H2O::liquidDensity(T, p);
+                return cachedWaterDensity_(paramCache, T, p);
             else
             {
                 // See: Ochs 2008
-                const auto& rholH2O = H2O::liquidDensity(T, p);
+                const auto& rholH2O = cachedWaterDensity_(paramCache, T, p);
                 const auto& clH2O = rholH2O/H2O::molarMass();
 
                 const auto& xlH2O = Opm::decay<LhsEval>(fluidState.moleFraction(liquidPhaseIdx, H2OIdx));
@@ -318,11 +776,8 @@ public:
         return (rho_gH2O + rho_gN2)/Opm::max(1e-5, sumMoleFrac);
     }
 
-    //! \copydoc BaseFluidSystem::viscosity
-    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
-    static LhsEval viscosity(const FluidState& fluidState,
-                             const ParameterCache<ParamCacheEval>& /*paramCache*/,
-                             unsigned phaseIdx)
+    template <class LhsEval, class FluidState, class ParamCache, class PhaseIdx>
+    static LhsEval viscosity_(const FluidState& fluidState, const ParamCache& paramCache, PhaseIdx phaseIdx)
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
@@ -332,56 +787,45 @@ public:
         // liquid phase
         if (phaseIdx == liquidPhaseIdx)
             // assume pure water for the liquid phase
-            return H2O::liquidViscosity(T, p);
+            return cachedWaterViscosity_(paramCache, T, p);
 
         // gas phase
         assert(phaseIdx == gasPhaseIdx);
 
-        if (!useComplexRelations)
+        std::array<LhsEval, numMixtureValues_> tab;
+        const auto* values = cachedMixtureValues_(paramCache, gasPhaseIdx, T, p, tab);
+
+        if (!useComplexRelations) {
             // assume pure nitrogen for the gas phase
+            if (values)
+                return (*values)[n2GasViscosityIdx_];
             return N2::gasViscosity(T, p);
+        }
         else {
-            /* Wilke method. See:
-             *
-             * See: R. Reid, et al.: The Properties of Gases and Liquids,
-             * 4th edition, McGraw-Hill, 1987, 407-410
-             * 5th edition, McGraw-Hill, 20001, p. 9.21/22
-             */
-            LhsEval muResult = 0;
-            const LhsEval mu[numComponents] = {
-                H2O::gasViscosity(T, H2O::vaporPressure(T)),
-                N2::gasViscosity(T, p)
-            };
-
-            LhsEval sumx = 0.0;
-            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
-                sumx += Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, compIdx));
-            sumx = Opm::max(1e-10, sumx);
-
-            for (unsigned i = 0; i < numComponents; ++i) {
-                LhsEval divisor = 0;
-                for (unsigned j = 0; j < numComponents; ++j) {
-                    LhsEval phiIJ = 1 + Opm::sqrt(mu[i]/mu[j]) * std::pow(molarMass(j)/molarMass(i), 1/4.0);
-                    phiIJ *= phiIJ;
-                    phiIJ /= std::sqrt(8*(1 + molarMass(i)/molarMass(j)));
-                    divisor +=
-                        Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, j))
-                        /sumx*phiIJ;
-                }
-                muResult +=
-                    Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, i))
-                    /sumx*mu[i]/divisor;
+            // Wilke method, see Opm::WilkeViscosityMixing
+            LhsEval mu[numComponents];
+            if (values) {
+                mu[H2OIdx] = (*values)[h2oGasViscosityIdx_];
+                mu[N2Idx] = (*values)[n2GasViscosityIdx_];
+            }
+            else {
+                mu[H2OIdx] = H2O::gasViscosity(T, H2O::vaporPressure(T));
+                mu[N2Idx] = N2::gasViscosity(T, p);
             }
-            return muResult;
+
+            LhsEval x[numComponents];
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                x[compIdx] = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, compIdx));
+
+            return gasViscosityMixing_().viscosity(mu, x);
         }
     }
 
-    //! \copydoc BaseFluidSystem::fugacityCoefficient
-    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
-    static LhsEval fugacityCoefficient(const FluidState& fluidState,
-                                       const ParameterCache<ParamCacheEval>& /*paramCache*/,
-                                       unsigned phaseIdx,
-                                       unsigned compIdx)
+    template <class LhsEval, class FluidState, class ParamCache, class PhaseIdx, class CompIdx>
+    static LhsEval fugacityCoefficient_(const FluidState& fluidState,
+                                        const ParamCache& paramCache,
+                                        PhaseIdx phaseIdx,
+                                        CompIdx compIdx)
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
         assert(0 <= compIdx && compIdx < numComponents);
@@ -391,6 +835,10 @@ public:
 
         // liquid phase
         if (phaseIdx == liquidPhaseIdx) {
+            std::array<LhsEval, numMixtureValues_> tab;
+            if (const auto* values = cachedMixtureValues_(paramCache, liquidPhaseIdx, T, p, tab))
+                return (*values)[(compIdx == H2OIdx) ? h2oVaporPressureIdx_ : n2HenryIdx_]/p;
+
             if (compIdx == H2OIdx)
                 return H2O::vaporPressure(T)/p;
             return Opm::BinaryCoeff::H2O_N2::henry(T)/p;
@@ -403,31 +851,8 @@ public:
         return 1.0;
     }
 
-    //! \copydoc BaseFluidSystem::diffusionCoefficient
-    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
-    static LhsEval diffusionCoefficient(const FluidState& fluidState,
-                                        const ParameterCache<ParamCacheEval>& /*paramCache*/,
-                                        unsigned phaseIdx,
-                                        unsigned /*compIdx*/)
-
-    {
-        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
-
-        // liquid phase
-        if (phaseIdx == liquidPhaseIdx)
-            return BinaryCoeff::H2O_N2::liquidDiffCoeff(T, p);
-
-        // gas phase
-        assert(phaseIdx == gasPhaseIdx);
-        return BinaryCoeff::H2O_N2::gasDiffCoeff(T, p);
-    }
-
-    //! \copydoc BaseFluidSystem::enthalpy
-    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
-    static LhsEval enthalpy(const FluidState& fluidState,
-                            const ParameterCache<ParamCacheEval>& /*paramCache*/,
-                            unsigned phaseIdx)
+    template <class LhsEval, class FluidState, class PhaseIdx>
+    static LhsEval enthalpy_(const FluidState& fluidState, PhaseIdx phaseIdx)
     {
         const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
         const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
@@ -455,84 +880,111 @@ public:
         return hH2O + hN2;
     }
 
-    //! \copydoc BaseFluidSystem::thermalConductivity
-    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
-    static LhsEval thermalConductivity(const FluidState& fluidState,
-                                       const ParameterCache<ParamCacheEval>& /*paramCache*/,
-                                       unsigned phaseIdx)
+    static MixtureTable& mixtureTable_()
     {
-        assert(0 <= phaseIdx && phaseIdx < numPhases);
-
-        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
-        if (phaseIdx == liquidPhaseIdx) // liquid phase
-            return H2O::liquidThermalConductivity(T, p);
-
-        // gas phase
-        assert(phaseIdx == gasPhaseIdx);
-
-        if (useComplexRelations){
-            // return the sum of the partial conductivity of Nitrogen and Steam
-            const auto& xH2O = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, H2OIdx));
-            const auto& xN2 = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, N2Idx));
-
-            // Assuming Raoult's, Daltons law and ideal gas in order to obtain the
-            // partial pressures in the gas phase
-            const auto& lambdaN2 = N2::gasThermalConductivity(T, p*xN2);
-            const auto& lambdaH2O = H2O::gasThermalConductivity(T, p*xH2O);
+        static MixtureTable table;
+        return table;
+    }
 
-            return lambdaN2 + lambdaH2O;
-        }
-        else
-            // return the conductivity of dry Nitrogen
-            return N2::gasThermalConductivity(T, p);
+    // the factors of the Wilke mixing rule for the gas viscosity. they only depend on
+    // the molar masses of the components, so they are computed on first use.
+    static const WilkeViscosityMixing<Scalar, numComponents>& gasViscosityMixing_()
+    {
+        Scalar M[numComponents];
+        M[H2OIdx] = H2O::molarMass();
+        M[N2Idx] = N2::molarMass();
+        static const WilkeViscosityMixing<Scalar, numComponents> mixing(M);
+        return mixing;
     }
 
-    //! \copydoc BaseFluidSystem::heatCapacity
-    template <class FluidState, class LhsEval = typename FluidState::Scalar, class ParamCacheEval = LhsEval>
-    static LhsEval heatCapacity(const FluidState& fluidState,
-                                const ParameterCache<ParamCacheEval>& /*paramCache*/,
-                                unsigned phaseIdx)
+    // retrieve the tabulated mixture properties. returns false if the mixture
+    // properties are not tabulated or if the position is outside the table.
+    template <class LhsEval>
+    static bool lookupMixtureTable_(const LhsEval& T,
+                                    const LhsEval& p,
+                                    std::array<LhsEval, numMixtureValues_>& values)
     {
-        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
-        const auto& xAlphaH2O = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, H2OIdx));
-        const auto& xAlphaN2 = Opm::decay<LhsEval>(fluidState.moleFraction(phaseIdx, N2Idx));
-        const auto& XAlphaH2O = Opm::decay<LhsEval>(fluidState.massFraction(phaseIdx, H2OIdx));
-        const auto& XAlphaN2 = Opm::decay<LhsEval>(fluidState.massFraction(phaseIdx, N2Idx));
+        const MixtureTable& table = mixtureTable_();
+        if (!table.applies(T, p))
+            return false;
 
-        if (phaseIdx == liquidPhaseIdx)
-            return H2O::liquidHeatCapacity(T, p);
+        table.eval(T, p, values);
+        return true;
+    }
 
-        assert(phaseIdx == gasPhaseIdx);
+    // evaluate the mixture properties which are stored by the table of
+    // initMixtureTables() analytically
+    template <class LhsEval>
+    static void computeMixtureValues_(const LhsEval& T,
+                                      const LhsEval& p,
+                                      std::array<LhsEval, numMixtureValues_>& values)
+    {
+        const LhsEval& pSat = H2O::vaporPressure(T);
+        values[h2oVaporPressureIdx_] = pSat;
+        values[h2oGasViscosityIdx_] = H2O::gasViscosity(T, pSat);
+        values[n2GasViscosityIdx_] = N2::gasViscosity(T, p);
+        values[n2HenryIdx_] = BinaryCoeff::H2O_N2::henry(T);
+        values[liquidDiffCoeffIdx_] = BinaryCoeff::H2O_N2::liquidDiffCoeff(T, p);
+        values[gasDiffCoeffIdx_] = BinaryCoeff::H2O_N2::gasDiffCoeff(T, p);
+    }
 
-        // for the gas phase, assume ideal mixture, i.e. molecules of
-        // one component don't "see" the molecules of the other
-        // component
-        LhsEval c_pN2;
-        LhsEval c_pH2O;
-        // let the water and nitrogen components do things their own way
-        if (useComplexRelations) {
-            c_pN2 = N2::gasHeatCapacity(T, p*xAlphaN2);
-            c_pH2O = H2O::gasHeatCapacity(T, p*xAlphaH2O);
-        }
-        else {
-            // assume an ideal gas for both components. See:
-            //
-            // http://en.wikipedia.org/wiki/Heat_capacity
-            Scalar c_vN2molar = Opm::Constants<Scalar>::R*2.39;
-            Scalar c_pN2molar = Opm::Constants<Scalar>::R + c_vN2molar;
+    // retrieve the mixture properties of a phase from the parameter cache or from the
+    // mixture table. The cache can only be used if it uses the same type of
+    // evaluation as the result. returns nullptr if neither is applicable.
+    template <class LhsEval, class ParamCacheEval>
+    static const std::array<LhsEval, numMixtureValues_>*
+    cachedMixtureValues_(const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                         unsigned /*phaseIdx*/,
+                         const LhsEval& T,
+                         const LhsEval& p,
+                         std::array<LhsEval, numMixtureValues_>& tab)
+    { return lookupMixtureTable_(T, p, tab) ? &tab : nullptr; }
+
+    template <class LhsEval>
+    static const std::array<LhsEval, numMixtureValues_>*
+    cachedMixtureValues_(const ParameterCache<LhsEval>& paramCache,
+                         unsigned phaseIdx,
+                         const LhsEval& T,
+                         const LhsEval& p,
+                         std::array<LhsEval, numMixtureValues_>& tab)
+    {
+        if (paramCache.applies(phaseIdx, T, p))
+            return &paramCache.mixtureValues(phaseIdx);
+        return lookupMixtureTable_(T, p, tab) ? &tab : nullptr;
+    }
 
-            Scalar c_vH2Omolar = Opm::Constants<Scalar>::R*3.37; // <- correct??
-            Scalar c_pH2Omolar = Opm::Constants<Scalar>::R + c_vH2Omolar;
+    // retrieve the density and the viscosity of pure water from the parameter cache,
+    // see above
+    template <class LhsEval, class ParamCacheEval>
+    static LhsEval cachedWaterDensity_(const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                       const LhsEval& T,
+                                       const LhsEval& p)
+    { return H2O::liquidDensity(T, p); }
+
+    template <class LhsEval>
+    static LhsEval cachedWaterDensity_(const ParameterCache<LhsEval>& paramCache,
+                                       const LhsEval& T,
+                                       const LhsEval& p)
+    {
+        if (paramCache.applies(liquidPhaseIdx, T, p))
+            return paramCache.waterDensity();
+        return H2O::liquidDensity(T, p);
+    }
 
-            c_pN2 = c_pN2molar/molarMass(N2Idx);
-            c_pH2O = c_pH2Omolar/molarMass(H2OIdx);
-        }
+    template <class LhsEval, class ParamCacheEval>
+    static LhsEval cachedWaterViscosity_(const ParameterCache<ParamCacheEval>& /*paramCache*/,
+                                         const LhsEval& T,
+                                         const LhsEval& p)
+    { return H2O::liquidViscosity(T, p); }
 
-        // mingle both components together. this assumes that there is no "cross
-        // interaction" between both flavors of molecules.
-        return XAlphaH2O*c_pH2O + XAlphaN2*c_pN2;
+    template <class LhsEval>
+    static LhsEval cachedWaterViscosity_(const ParameterCache<LhsEval>& paramCache,
+                                         const LhsEval& T,
+                                         const LhsEval& p)
+    {
+        if (paramCache.applies(liquidPhaseIdx, T, p))
+            return paramCache.waterViscosity();
+        return H2O::liquidViscosity(T, p);
     }
 };
 
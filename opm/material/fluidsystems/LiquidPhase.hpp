@@ -56,6 +56,12 @@ public:
     static bool isIdealGas()
     { return false; /* we're a liquid! */ }
 
+    //! \copydoc GasPhase::densityIsConstant
+    static const bool densityIsConstant = Component::liquidDensityIsConstant;
+    static const bool viscosityIsConstant = Component::liquidViscosityIsConstant;
+    static const bool thermalConductivityIsConstant = Component::liquidThermalConductivityIsConstant;
+    static const bool heatCapacityIsConstant = Component::liquidHeatCapacityIsConstant;
+
     //! \copydoc GasPhase::molarMass
     static Scalar molarMass()
     {  return Component::molarMass(); }
@@ -115,6 +121,22 @@ public:
     template <class Evaluation>
     static Evaluation heatCapacity(const Evaluation& temperature, const Evaluation& pressure)
     { return Component::liquidHeatCapacity(temperature, pressure); }
+
+    //! \copydoc GasPhase::constantDensity
+    static Scalar constantDensity()
+    { return density(Scalar(293.15), Scalar(1e5)); }
+
+    //! \copydoc GasPhase::constantViscosity
+    static Scalar constantViscosity()
+    { return viscosity(Scalar(293.15), Scalar(1e5)); }
+
+    //! \copydoc GasPhase::constantThermalConductivity
+    static Scalar constantThermalConductivity()
+    { return thermalConductivity(Scalar(293.15), Scalar(1e5)); }
+
+    //! \copydoc GasPhase::constantHeatCapacity
+    static Scalar constantHeatCapacity()
+    { return heatCapacity(Scalar(293.15), Scalar(1e5)); }
 };
 } // namespace Opm
 
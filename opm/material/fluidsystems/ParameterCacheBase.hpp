@@ -72,10 +72,10 @@ public:
      * \param exceptQuantities The quantities of the fluid state that have not changed since the last update.
      */
     template <class FluidState>
-    void updateAll(const FluidState& fluidState, int /*exceptQuantities*/ = None)
+    void updateAll(const FluidState& fluidState, int exceptQuantities = None)
     {
         for (unsigned phaseIdx = 0; phaseIdx < FluidState::numPhases; ++phaseIdx)
-            asImp_().updatePhase(fluidState, phaseIdx);
+            asImp_().updatePhase(fluidState, phaseIdx, exceptQuantities);
     }
 
     /*!
@@ -102,15 +102,16 @@ public:
      */
     template <class FluidState>
     void updateAllTemperatures(const FluidState& fluidState)
-    {
-        for (unsigned phaseIdx = 0; phaseIdx < FluidState::numPhases; ++phaseIdx)
-            asImp_().updatePhase(fluidState, phaseIdx);
-    }
+    { asImp_().updateAll(fluidState, Pressure | Composition); }
 
 
     /*!
      * \brief Update all cached parameters of a specific fluid phase.
      *
+     * The quantities specified by exceptQuantities must not have changed since the
+     * last update of the phase. Implementations may use this to skip the
+     * recomputation of the cached parameters which only depend on these quantities.
+     *
      * \param fluidState The representation of the thermodynamic system of interest.
      * \param phaseIdx The index of the fluid phase of interest.
      * \param exceptQuantities The quantities of the fluid state that have not changed since the last update.
@@ -133,7 +134,7 @@ public:
     template <class FluidState>
     void updateTemperature(const FluidState& fluidState, unsigned phaseIdx)
     {
-        asImp_().updatePhase(fluidState, phaseIdx);
+        asImp_().updatePhase(fluidState, phaseIdx, /*except=*/Pressure | Composition);
     }
 
     /*!
@@ -150,7 +151,7 @@ public:
     template <class FluidState>
     void updatePressure(const FluidState& fluidState, unsigned phaseIdx)
     {
-        asImp_().updatePhase(fluidState, phaseIdx);
+        asImp_().updatePhase(fluidState, phaseIdx, /*except=*/Temperature | Composition);
     }
 
     /*!
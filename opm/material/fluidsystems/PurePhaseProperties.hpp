@@ -0,0 +1,91 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Evaluate the properties of a single-component phase for the state of a
+ *        phase of a fluid state.
+ *
+ * Properties which the phase declares to be constant are returned without accessing
+ * the fluid state, so their derivatives are zero and the conversion of the
+ * temperature and pressure to the result type is skipped. These functions are used
+ * by the fluid systems which are based on Opm::LiquidPhase and Opm::GasPhase. Other
+ * phase classes must provide the same 'densityIsConstant', 'constantDensity()', etc.
+ * members.
+ */
+#ifndef OPM_PURE_PHASE_PROPERTIES_HPP
+#define OPM_PURE_PHASE_PROPERTIES_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+namespace Opm {
+namespace PurePhaseProperties {
+
+template <class Phase, class LhsEval, class FluidState>
+LhsEval density(const FluidState& fluidState, unsigned phaseIdx)
+{
+    if (Phase::densityIsConstant)
+        return Phase::constantDensity();
+
+    const auto& temperature = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
+    const auto& pressure = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
+    return Phase::density(temperature, pressure);
+}
+
+template <class Phase, class LhsEval, class FluidState>
+LhsEval viscosity(const FluidState& fluidState, unsigned phaseIdx)
+{
+    if (Phase::viscosityIsConstant)
+        return Phase::constantViscosity();
+
+    const auto& temperature = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
+    const auto& pressure = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
+    return Phase::viscosity(temperature, pressure);
+}
+
+template <class Phase, class LhsEval, class FluidState>
+LhsEval thermalConductivity(const FluidState& fluidState, unsigned phaseIdx)
+{
+    if (Phase::thermalConductivityIsConstant)
+        return Phase::constantThermalConductivity();
+
+    const auto& temperature = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
+    const auto& pressure = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
+    return Phase::thermalConductivity(temperature, pressure);
+}
+
+template <class Phase, class LhsEval, class FluidState>
+LhsEval heatCapacity(const FluidState& fluidState, unsigned phaseIdx)
+{
+    if (Phase::heatCapacityIsConstant)
+        return Phase::constantHeatCapacity();
+
+    const auto& temperature = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
+    const auto& pressure = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
+    return Phase::heatCapacity(temperature, pressure);
+}
+
+} // namespace PurePhaseProperties
+} // namespace Opm
+
+#endif
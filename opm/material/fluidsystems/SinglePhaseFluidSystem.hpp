@@ -32,6 +32,7 @@
 
 #include <opm/material/fluidsystems/LiquidPhase.hpp>
 #include <opm/material/fluidsystems/GasPhase.hpp>
+#include <opm/material/fluidsystems/PurePhaseProperties.hpp>
 #include <opm/material/components/SimpleH2O.hpp>
 #include <opm/material/components/H2O.hpp>
 #include <opm/material/components/N2.hpp>
@@ -192,9 +193,7 @@ public:
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
-        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
-        return Fluid::density(T, p);
+        return Opm::PurePhaseProperties::density<Fluid, LhsEval>(fluidState, phaseIdx);
     }
 
     //! \copydoc BaseFluidSystem::viscosity
@@ -205,9 +204,7 @@ public:
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
-        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
-        return Fluid::viscosity(T, p);
+        return Opm::PurePhaseProperties::viscosity<Fluid, LhsEval>(fluidState, phaseIdx);
     }
 
     //! \copydoc BaseFluidSystem::fugacityCoefficient
@@ -250,9 +247,7 @@ public:
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
-        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
-        return Fluid::thermalConductivity(T, p);
+        return Opm::PurePhaseProperties::thermalConductivity<Fluid, LhsEval>(fluidState, phaseIdx);
     }
 
     //! \copydoc BaseFluidSystem::heatCapacity
@@ -263,9 +258,7 @@ public:
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
-        const auto& T = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& p = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
-        return Fluid::heatCapacity(T, p);
+        return Opm::PurePhaseProperties::heatCapacity<Fluid, LhsEval>(fluidState, phaseIdx);
     }
 };
 
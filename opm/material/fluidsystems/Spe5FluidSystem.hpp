@@ -34,6 +34,12 @@
 #include <opm/material/eos/PengRobinsonMixture.hpp>
 
 #include <opm/material/common/Spline.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
 
 namespace Opm {
 namespace FluidSystems {
@@ -304,11 +310,17 @@ public:
      * \param maxT The maximum temperature possibly encountered during the simulation
      * \param minP The minimum pressure possibly encountered during the simulation
      * \param maxP The maximum pressure possibly encountered during the simulation
+     * \param tabulateCriticalPoints Specifies whether the critical points of the
+     *                               Peng-Robinson equation of state are tabulated
+     * \param criticalPointsCacheFile The file used to persist the tabulated critical
+     *                                points. If empty, the table is always computed.
      */
     static void init(Scalar minT = 273.15,
                      Scalar maxT = 373.15,
                      Scalar minP = 1e4,
-                     Scalar maxP = 100e6)
+                     Scalar maxP = 100e6,
+                     bool tabulateCriticalPoints = false,
+                     const std::string& criticalPointsCacheFile = "")
     {
         Opm::PengRobinsonParamsMixture<Scalar, ThisType, gasPhaseIdx, /*useSpe5=*/true> prParams;
 
@@ -354,7 +366,66 @@ public:
         };
 
         PengRobinson::init(/*aMin=*/minA, /*aMax=*/maxA, /*na=*/100,
-                           /*bMin=*/minB, /*bMax=*/maxB, /*nb=*/200);
+                           /*bMin=*/minB, /*bMax=*/maxB, /*nb=*/200,
+                           tabulateCriticalPoints,
+                           criticalPointsCacheFile);
+    }
+
+    /*!
+     * \brief Tabulate the Peng-Robinson vapor pressures of all components.
+     *
+     * The vapor pressure curve of each component is sampled at 'numSamples'
+     * temperatures between min(minT, Tcrit/2) and the critical temperature of the
+     * component. The logarithm of the vapor pressure is interpolated linearly. If
+     * 'tolerance' is positive, the segments of the tables are bisected until the
+     * relative error of the interpolated vapor pressure at their centers is below
+     * this value. If OpenMP is enabled, the components are tabulated in parallel.
+     */
+    static void tabulateVaporPressures(Scalar minT = 273.15,
+                                       unsigned numSamples = 50,
+                                       Scalar tolerance = 0.0)
+    {
+        assert(numSamples >= 2);
+
+        vaporPressuresTabulated_ = false;
+
+        // the components are independent of each other
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int compIdx = 0; compIdx < numComponents; ++compIdx)
+            tabulateVaporPressure_(static_cast<unsigned>(compIdx), minT, numSamples, tolerance);
+
+        vaporPressuresTabulated_ = true;
+    }
+
+    /*!
+     * \brief The vapor pressure of a pure component according to the Peng-Robinson
+     *        equation of state [Pa].
+     *
+     * If the vapor pressures were tabulated using tabulateVaporPressures() and the
+     * temperature is within the range of the table, the result is interpolated. If
+     * 'polish' is true, the interpolated value is used as the initial guess of
+     * Newton's method. Otherwise, Newton's method starts at the estimate of the
+     * Ambrose-Walton method. Above the critical temperature, the critical pressure is
+     * returned.
+     */
+    static Scalar vaporPressure(unsigned compIdx, Scalar temperature, bool polish = false)
+    {
+        assert(0 <= compIdx && compIdx < numComponents);
+
+        if (temperature >= criticalTemperature(compIdx))
+            return criticalPressure(compIdx);
+
+        const auto& table = lnVaporPressureTable_[compIdx];
+        if (vaporPressuresTabulated_ && table.applies(temperature)) {
+            Scalar pVap = std::exp(table.eval(temperature));
+            if (!polish)
+                return pVap;
+            return pengRobinsonVaporPressure_(compIdx, temperature, pVap);
+        }
+
+        return pengRobinsonVaporPressure_(compIdx, temperature);
     }
 
     //! \copydoc BaseFluidSystem::density
@@ -373,23 +444,24 @@ public:
     static LhsEval viscosity(const FluidState& /*fluidState*/,
                              const ParameterCache<ParamCacheEval>& /*paramCache*/,
                              unsigned phaseIdx)
-    {
-        assert(0 <= phaseIdx && phaseIdx <= numPhases);
+    { return constantViscosity_(phaseIdx); }
 
-        if (phaseIdx == gasPhaseIdx) {
-            // given by SPE-5 in table on page 64. we use a constant
-            // viscosity, though...
-            return 0.0170e-2 * 0.1;
-        }
-        else if (phaseIdx == waterPhaseIdx)
-            // given by SPE-5: 0.7 centi-Poise  = 0.0007 Pa s
-            return 0.7e-2 * 0.1;
-        else {
-            assert(phaseIdx == oilPhaseIdx);
-            // given by SPE-5 in table on page 64. we use a constant
-            // viscosity, though...
-            return 0.208e-2 * 0.1;
-        }
+    /*!
+     * \copydoc BaseFluidSystem::viscosityBatch
+     *
+     * The viscosities of all phases are constant, so this does not need to look at
+     * the fluid states at all.
+     */
+    template <class FluidStateRange, class ParamCache, class LhsEval>
+    static void viscosityBatch(size_t numValues,
+                               const FluidStateRange& /*fluidStates*/,
+                               ParamCache* /*paramCaches*/,
+                               unsigned phaseIdx,
+                               LhsEval* values)
+    {
+        const Scalar mu = constantViscosity_(phaseIdx);
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = mu;
     }
 
     //! \copydoc BaseFluidSystem::fugacityCoefficient
@@ -415,7 +487,156 @@ public:
         }
     }
 
+    //! \copydoc BaseFluidSystem::fugacityCoefficients
+    template <class FluidState, class Container, class ParamCacheEval>
+    static void fugacityCoefficients(const FluidState& fluidState,
+                                     const ParameterCache<ParamCacheEval>& paramCache,
+                                     unsigned phaseIdx,
+                                     Container& fugCoeffs)
+    {
+        assert(0 <= phaseIdx && phaseIdx <= numPhases);
+
+        if (phaseIdx == oilPhaseIdx || phaseIdx == gasPhaseIdx)
+            PengRobinsonMixture::computeFugacityCoefficients(fluidState,
+                                                             paramCache,
+                                                             phaseIdx,
+                                                             fugCoeffs);
+        else {
+            assert(phaseIdx == waterPhaseIdx);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fugCoeffs[compIdx] =
+                    henryCoeffWater_(compIdx, fluidState.temperature(waterPhaseIdx))
+                    / fluidState.pressure(waterPhaseIdx);
+        }
+    }
+
+    //! \copydoc BaseFluidSystem::hasAnalyticFugacityDerivatives
+    static bool hasAnalyticFugacityDerivatives(unsigned /*phaseIdx*/)
+    { return true; }
+
+    //! \copydoc BaseFluidSystem::lnFugacityCoefficientDerivatives
+    template <class FluidState, class Matrix, class ParamCacheEval>
+    static bool lnFugacityCoefficientDerivatives(Matrix& dLnPhi,
+                                                 const FluidState& fluidState,
+                                                 const ParameterCache<ParamCacheEval>& paramCache,
+                                                 unsigned phaseIdx)
+    {
+        assert(0 <= phaseIdx && phaseIdx <= numPhases);
+
+        if (phaseIdx == oilPhaseIdx || phaseIdx == gasPhaseIdx)
+            return PengRobinsonMixture::computeLnFugacityCoefficientDerivatives(dLnPhi,
+                                                                                fluidState,
+                                                                                paramCache,
+                                                                                phaseIdx);
+        else {
+            // Henry's law: the fugacity coefficients do not depend on the composition
+            assert(phaseIdx == waterPhaseIdx);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                for (unsigned compKIdx = 0; compKIdx < numComponents; ++compKIdx)
+                    dLnPhi[compIdx][compKIdx] = 0.0;
+            return true;
+        }
+    }
+
 protected:
+    // the vapor pressure of a pure component using Newton's method
+    static Scalar pengRobinsonVaporPressure_(unsigned compIdx, Scalar temperature)
+    {
+        Scalar pInit =
+            PengRobinson::ambroseWaltonVaporPressure(temperature,
+                                                     criticalTemperature(compIdx),
+                                                     criticalPressure(compIdx),
+                                                     acentricFactor(compIdx));
+        return pengRobinsonVaporPressure_(compIdx, temperature, pInit);
+    }
+
+    static Scalar pengRobinsonVaporPressure_(unsigned compIdx, Scalar temperature, Scalar pInit)
+    {
+        Opm::PengRobinsonParamsMixture<Scalar, ThisType, gasPhaseIdx, /*useSpe5=*/true> prParams;
+        prParams.updatePure(temperature, /*pressure=*/pInit);
+        const auto& pureParams = prParams.pureParams(compIdx);
+        return PengRobinson::computeVaporPressure(temperature,
+                                                  pureParams.a(),
+                                                  pureParams.b(),
+                                                  pInit);
+    }
+
+    static void tabulateVaporPressure_(unsigned compIdx,
+                                       Scalar minT,
+                                       unsigned numSamples,
+                                       Scalar tolerance)
+    {
+        const Scalar Tcrit = criticalTemperature(compIdx);
+        const Scalar Tmin = std::min(minT, Tcrit/2);
+
+        // the critical point terminates the vapor pressure curve, so it is the last
+        // sample point
+        std::vector<Scalar> T(numSamples);
+        std::vector<Scalar> lnPVap(numSamples);
+        for (unsigned sampleIdx = 0; sampleIdx < numSamples - 1; ++sampleIdx) {
+            T[sampleIdx] = Tmin + (Tcrit - Tmin)*sampleIdx/(numSamples - 1);
+            lnPVap[sampleIdx] = std::log(pengRobinsonVaporPressure_(compIdx, T[sampleIdx]));
+        }
+        T.back() = Tcrit;
+        lnPVap.back() = std::log(criticalPressure(compIdx));
+
+        // bisect the segments where linear interpolation is not accurate enough. the
+        // number of bisections of each segment is limited because the curvature of the
+        // vapor pressure curve becomes unbounded at the critical point
+        for (unsigned refineIdx = 0; tolerance > 0 && refineIdx < 10; ++refineIdx) {
+            std::vector<Scalar> refinedT;
+            std::vector<Scalar> refinedLnPVap;
+            refinedT.reserve(2*T.size());
+            refinedLnPVap.reserve(2*T.size());
+
+            bool converged = true;
+            for (size_t sampleIdx = 0; sampleIdx + 1 < T.size(); ++sampleIdx) {
+                refinedT.push_back(T[sampleIdx]);
+                refinedLnPVap.push_back(lnPVap[sampleIdx]);
+
+                Scalar Tmid = (T[sampleIdx] + T[sampleIdx + 1])/2;
+                Scalar lnPMid = (lnPVap[sampleIdx] + lnPVap[sampleIdx + 1])/2;
+                Scalar pMid = pengRobinsonVaporPressure_(compIdx, Tmid);
+                if (std::abs(std::exp(lnPMid) - pMid) > tolerance*pMid) {
+                    refinedT.push_back(Tmid);
+                    refinedLnPVap.push_back(std::log(pMid));
+                    converged = false;
+                }
+            }
+            refinedT.push_back(T.back());
+            refinedLnPVap.push_back(lnPVap.back());
+
+            T.swap(refinedT);
+            lnPVap.swap(refinedLnPVap);
+            if (converged)
+                break;
+        }
+
+        lnVaporPressureTable_[compIdx].setXYContainers(std::move(T),
+                                                       std::move(lnPVap),
+                                                       /*sortInputs=*/false);
+    }
+
+    static Scalar constantViscosity_(unsigned phaseIdx)
+    {
+        assert(0 <= phaseIdx && phaseIdx <= numPhases);
+
+        if (phaseIdx == gasPhaseIdx) {
+            // given by SPE-5 in table on page 64. we use a constant
+            // viscosity, though...
+            return 0.0170e-2 * 0.1;
+        }
+        else if (phaseIdx == waterPhaseIdx)
+            // given by SPE-5: 0.7 centi-Poise  = 0.0007 Pa s
+            return 0.7e-2 * 0.1;
+        else {
+            assert(phaseIdx == oilPhaseIdx);
+            // given by SPE-5 in table on page 64. we use a constant
+            // viscosity, though...
+            return 0.208e-2 * 0.1;
+        }
+    }
+
     template <class LhsEval>
     static LhsEval henryCoeffWater_(unsigned compIdx, const LhsEval& temperature)
     {
@@ -435,11 +656,20 @@ protected:
         default: OPM_THROW(std::logic_error, "Unknown component index " << compIdx);
         }
     }
+
+    static bool vaporPressuresTabulated_;
+    static Tabulated1DFunction<Scalar> lnVaporPressureTable_[numComponents];
 };
 
 template <class Scalar>
 const Scalar Spe5<Scalar>::R = Opm::Constants<Scalar>::R;
 
+template <class Scalar>
+bool Spe5<Scalar>::vaporPressuresTabulated_ = false;
+
+template <class Scalar>
+Tabulated1DFunction<Scalar> Spe5<Scalar>::lnVaporPressureTable_[Spe5<Scalar>::numComponents];
+
 } // namespace FluidSystems
 } // namespace Opm
 
@@ -51,6 +51,7 @@ class Spe5ParameterCache
     typedef Opm::PengRobinson<Scalar> PengRobinson;
 
     enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
 
     enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
     enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
@@ -66,6 +67,7 @@ public:
     {
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             VmUpToDate_[phaseIdx] = false;
+            eosParamsValid_[phaseIdx] = false;
             Valgrind::SetUndefined(Vm_[phaseIdx]);
         }
     }
@@ -97,6 +99,7 @@ public:
             oilPhaseParams_.updateSingleMoleFraction(fluidState, compIdx);
         else if (phaseIdx == gasPhaseIdx)
             gasPhaseParams_.updateSingleMoleFraction(fluidState, compIdx);
+        moleFraction_[phaseIdx][compIdx] = fluidState.moleFraction(phaseIdx, compIdx);
 
         // update the phase's molar volume
         updateMolarVolume_(fluidState, phaseIdx);
@@ -209,26 +212,64 @@ public:
      * \param fluidState The representation of the thermodynamic system of interest.
      * \param phaseIdx The index of the fluid phase of interest.
      * \param exceptQuantities The quantities of the fluid state that have not changed since the last update.
+     *
+     * Besides the quantities which are excluded explicitly, this method also skips
+     * the update of everything which does not depend on any quantity that differs
+     * from the last update of the phase. In particular, if only the pressure
+     * changed, the mixture parameters are kept and only the molar volume is
+     * recalculated. This is the most common case for the Newton iterations of the
+     * flash solvers.
      */
     template <class FluidState>
     void updateEosParams(const FluidState& fluidState,
                          unsigned phaseIdx,
                          int exceptQuantities = ParentType::None)
     {
-        if (!(exceptQuantities & ParentType::Temperature))
-        {
+        bool temperatureChanged = false;
+        bool compositionChanged = false;
+        bool pressureChanged = false;
+
+        if (!eosParamsValid_[phaseIdx]) {
+            temperatureChanged = true;
+            compositionChanged = true;
+            pressureChanged = true;
+        }
+        else {
+            if (!(exceptQuantities & ParentType::Temperature))
+                temperatureChanged = fluidState.temperature(phaseIdx) != temperature_[phaseIdx];
+            if (!(exceptQuantities & ParentType::Composition)) {
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                    if (fluidState.moleFraction(phaseIdx, compIdx) != moleFraction_[phaseIdx][compIdx]) {
+                        compositionChanged = true;
+                        break;
+                    }
+                }
+            }
+            if (!(exceptQuantities & ParentType::Pressure))
+                pressureChanged = fluidState.pressure(phaseIdx) != pressure_[phaseIdx];
+        }
+
+        if (temperatureChanged) {
             updatePure_(fluidState, phaseIdx);
             updateMix_(fluidState, phaseIdx);
             VmUpToDate_[phaseIdx] = false;
         }
-        else if (!(exceptQuantities & ParentType::Composition))
-        {
+        else if (compositionChanged) {
             updateMix_(fluidState, phaseIdx);
             VmUpToDate_[phaseIdx] = false;
         }
-        else if (!(exceptQuantities & ParentType::Pressure)) {
+        else if (pressureChanged)
             VmUpToDate_[phaseIdx] = false;
-        }
+
+        // remember the state for which the parameters are valid
+        eosParamsValid_[phaseIdx] = true;
+        if (temperatureChanged)
+            temperature_[phaseIdx] = fluidState.temperature(phaseIdx);
+        if (pressureChanged)
+            pressure_[phaseIdx] = fluidState.pressure(phaseIdx);
+        if (compositionChanged)
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                moleFraction_[phaseIdx][compIdx] = fluidState.moleFraction(phaseIdx, compIdx);
     }
 
 protected:
@@ -333,6 +374,12 @@ protected:
     bool VmUpToDate_[numPhases];
     Scalar Vm_[numPhases];
 
+    // the thermodynamic state of the last update of the parameters of each phase
+    bool eosParamsValid_[numPhases];
+    Scalar temperature_[numPhases];
+    Scalar pressure_[numPhases];
+    Scalar moleFraction_[numPhases][numComponents];
+
     OilPhaseParams oilPhaseParams_;
     GasPhaseParams gasPhaseParams_;
 };
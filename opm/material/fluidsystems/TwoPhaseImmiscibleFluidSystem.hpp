@@ -32,6 +32,7 @@
 
 #include <opm/material/fluidsystems/LiquidPhase.hpp>
 #include <opm/material/fluidsystems/GasPhase.hpp>
+#include <opm/material/fluidsystems/PurePhaseProperties.hpp>
 #include <opm/material/fluidstates/ImmiscibleFluidState.hpp>
 
 #include "BaseFluidSystem.hpp"
@@ -228,11 +229,9 @@ public:
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
-        const auto& temperature = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& pressure = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
         if (phaseIdx == wettingPhaseIdx)
-            return WettingPhase::density(temperature, pressure);
-        return NonwettingPhase::density(temperature, pressure);
+            return Opm::PurePhaseProperties::density<WettingPhase, LhsEval>(fluidState, phaseIdx);
+        return Opm::PurePhaseProperties::density<NonwettingPhase, LhsEval>(fluidState, phaseIdx);
     }
 
     //! \copydoc BaseFluidSystem::viscosity
@@ -243,11 +242,9 @@ public:
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
-        const auto& temperature = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& pressure = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
         if (phaseIdx == wettingPhaseIdx)
-            return WettingPhase::viscosity(temperature, pressure);
-        return NonwettingPhase::viscosity(temperature, pressure);
+            return Opm::PurePhaseProperties::viscosity<WettingPhase, LhsEval>(fluidState, phaseIdx);
+        return Opm::PurePhaseProperties::viscosity<NonwettingPhase, LhsEval>(fluidState, phaseIdx);
     }
 
     //! \copydoc BaseFluidSystem::fugacityCoefficient
@@ -292,11 +289,9 @@ public:
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
-        const auto& temperature = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& pressure = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
         if (phaseIdx == wettingPhaseIdx)
-            return WettingPhase::thermalConductivity(temperature, pressure);
-        return NonwettingPhase::thermalConductivity(temperature, pressure);
+            return Opm::PurePhaseProperties::thermalConductivity<WettingPhase, LhsEval>(fluidState, phaseIdx);
+        return Opm::PurePhaseProperties::thermalConductivity<NonwettingPhase, LhsEval>(fluidState, phaseIdx);
     }
 
     //! \copydoc BaseFluidSystem::heatCapacity
@@ -307,11 +302,9 @@ public:
     {
         assert(0 <= phaseIdx && phaseIdx < numPhases);
 
-        const auto& temperature = Opm::decay<LhsEval>(fluidState.temperature(phaseIdx));
-        const auto& pressure = Opm::decay<LhsEval>(fluidState.pressure(phaseIdx));
         if (phaseIdx == wettingPhaseIdx)
-            return WettingPhase::heatCapacity(temperature, pressure);
-        return NonwettingPhase::heatCapacity(temperature, pressure);
+            return Opm::PurePhaseProperties::heatCapacity<WettingPhase, LhsEval>(fluidState, phaseIdx);
+        return Opm::PurePhaseProperties::heatCapacity<NonwettingPhase, LhsEval>(fluidState, phaseIdx);
     }
 };
 
@@ -0,0 +1,126 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::WilkeViscosityMixing
+ */
+#ifndef OPM_WILKE_VISCOSITY_MIXING_HPP
+#define OPM_WILKE_VISCOSITY_MIXING_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <cmath>
+
+namespace Opm {
+
+/*!
+ * \brief Computes the viscosity of a gas mixture from the viscosities of the pure
+ *        components using the method of Wilke.
+ *
+ * The viscosity of the mixture is given by
+ * \f[
+ \mu = \sum_i \frac{x_i \mu_i}{\sum_j x_j \Phi_{ij}}
+ \quad\text{with}\quad
+ \Phi_{ij} = \frac{\left(1 + (\mu_i/\mu_j)^{1/2} (M_j/M_i)^{1/4}\right)^2}
+                  {\sqrt{8 (1 + M_i/M_j)}}\;.
+ * \f]
+ * See: R. Reid, et al.: The Properties of Gases and Liquids,
+ * 4th edition, McGraw-Hill, 1987, 407-410 or
+ * 5th edition, McGraw-Hill, 2000, p. 9.21/22
+ *
+ * The factors which only depend on the molar masses of the components are computed
+ * when the object is constructed, so an evaluation only requires a square root per
+ * component instead of two square roots and a power function per pair of components.
+ * Since all mole fractions appear in the numerator as well as in the denominator, the
+ * result does not depend on whether the mole fractions are normalized.
+ *
+ * \tparam Scalar The type used for scalar values
+ * \tparam numComponents The number of components of the gas mixture
+ */
+template <class Scalar, int numComponents>
+class WilkeViscosityMixing
+{
+public:
+    /*!
+     * \brief Compute the mixing factors for a given set of molar masses.
+     *
+     * \param molarMass The molar masses of the components \f$\mathrm{[kg/mol]}\f$. This
+     *                  can be any container which provides the molarMass[compIdx]
+     *                  syntax.
+     */
+    template <class MolarMassContainer>
+    explicit WilkeViscosityMixing(const MolarMassContainer& molarMass)
+    {
+        for (unsigned i = 0; i < numComponents; ++i) {
+            for (unsigned j = 0; j < numComponents; ++j) {
+                const Scalar Mi = molarMass[i];
+                const Scalar Mj = molarMass[j];
+                massRatioFactor_[i][j] = std::pow(Mj/Mi, 1/4.0);
+                invDenominator_[i][j] = 1/std::sqrt(8*(1 + Mi/Mj));
+            }
+        }
+    }
+
+    /*!
+     * \brief Return the viscosity of the mixture \f$\mathrm{[Pa s]}\f$.
+     *
+     * \param mu The viscosities of the pure components \f$\mathrm{[Pa s]}\f$
+     * \param moleFraction The mole fractions of the components in the gas phase
+     */
+    template <class Evaluation>
+    Evaluation viscosity(const Evaluation* mu, const Evaluation* moleFraction) const
+    {
+        // (mu_i/mu_j)^(1/2) = sqrt(mu_i)/sqrt(mu_j)
+        Evaluation sqrtMu[numComponents];
+        Evaluation invSqrtMu[numComponents];
+        for (unsigned i = 0; i < numComponents; ++i) {
+            sqrtMu[i] = Opm::sqrt(mu[i]);
+            invSqrtMu[i] = 1.0/sqrtMu[i];
+        }
+
+        Evaluation result = 0.0;
+        for (unsigned i = 0; i < numComponents; ++i) {
+            // Phi_ii is exactly one
+            Evaluation divisor = moleFraction[i];
+            for (unsigned j = 0; j < numComponents; ++j) {
+                if (i == j)
+                    continue;
+
+                Evaluation tmp = 1 + sqrtMu[i]*invSqrtMu[j]*massRatioFactor_[i][j];
+                divisor += moleFraction[j]*tmp*tmp*invDenominator_[i][j];
+            }
+            result += moleFraction[i]*mu[i]/divisor;
+        }
+        return result;
+    }
+
+private:
+    // (M_j/M_i)^(1/4)
+    Scalar massRatioFactor_[numComponents][numComponents];
+    // 1/sqrt(8*(1 + M_i/M_j))
+    Scalar invDenominator_[numComponents][numComponents];
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,522 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::BlackOilTableGenerator
+ */
+#ifndef OPM_BLACK_OIL_TABLE_GENERATOR_HPP
+#define OPM_BLACK_OIL_TABLE_GENERATOR_HPP
+
+#include "LiveOilPvt.hpp"
+#include "WetGasPvt.hpp"
+
+#include <opm/material/common/UniformXTabulated2DFunction.hpp>
+
+#include <opm/material/constraintsolvers/SuccessiveSubstitutionFlash.hpp>
+#include <opm/material/constraintsolvers/FlashStatistics.hpp>
+#include <opm/material/fluidstates/CompositionalFluidState.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fvector.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Generates the tables of the live oil and wet gas PVT relations from a
+ *        compositional fluid system which is described by an equation of state.
+ *
+ * This allows to replace a compositional model, e.g., the Spe5 fluid system, by its
+ * much cheaper black-oil surrogate without generating the PVTO and PVTG tables
+ * externally. The fluid system must be supported by the SuccessiveSubstitutionFlash
+ * solver.
+ *
+ * The reservoir fluid is flashed at the sampled pressures at reservoir temperature.
+ * Each pressure at which the fluid splits into two phases yields a saturated row of
+ * the tables. For constant composition liberation, the original fluid is flashed at
+ * each pressure and the flash calculations are independent of each other. For
+ * differential liberation, the pressure is reduced step by step starting at the
+ * highest pressure and the liberated gas is removed after each step, i.e., the oil
+ * of a step is the feed of the next one.
+ *
+ * The dissolved gas and the vaporized oil factors are determined by flashing the
+ * saturated oil and gas at surface conditions. The reference densities are the
+ * densities of the stock tank oil and the surface gas which stem from the original
+ * fluid. The formation volume factors are chosen such that the densities of the
+ * black-oil model are identical to the ones of the equation of state at all
+ * sampling points. The undersaturated branch of an oil row is obtained by
+ * compressing the saturated oil of the row, the one of a gas row by mixing the
+ * saturated gas with its surface gas.
+ *
+ * If OpenMP is enabled, the flash calculations of the sampling points run in
+ * parallel. For differential liberation, only the depletion sequence itself is
+ * sequential.
+ */
+template <class Scalar, class FluidSystem>
+class BlackOilTableGenerator
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem, /*storeEnthalpy=*/false> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    typedef Opm::SuccessiveSubstitutionFlash<Scalar, FluidSystem> Flash;
+    typedef Opm::UniformXTabulated2DFunction<Scalar> TabulatedTwoDFunction;
+    typedef std::vector<std::pair<Scalar, Scalar> > SamplingPoints;
+
+public:
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+    typedef Opm::LiveOilPvt<Scalar> OilPvt;
+    typedef Opm::WetGasPvt<Scalar> GasPvt;
+
+    enum LiberationProcess {
+        ConstantCompositionLiberation,
+        DifferentialLiberation
+    };
+
+    BlackOilTableGenerator()
+        : temperature_(273.15 + 100.0)
+        , surfacePressure_(1.01325e5)
+        , surfaceTemperature_(273.15 + 15.56)
+        , minPressure_(1e6)
+        , maxPressure_(40e6)
+        , numPressures_(30)
+        , undersaturatedPressureRange_(100e5)
+        , numUndersaturated_(5)
+        , liberationProcess_(DifferentialLiberation)
+        , oilReferenceDensity_(0.0)
+        , gasReferenceDensity_(0.0)
+    {}
+
+    /*!
+     * \brief Set the reservoir temperature at which the tables are generated [K].
+     */
+    void setTemperature(Scalar value)
+    { temperature_ = value; }
+
+    /*!
+     * \brief Set the pressure [Pa] and the temperature [K] at which the reservoir
+     *        fluids are separated into stock tank oil and surface gas.
+     */
+    void setSurfaceConditions(Scalar pressure, Scalar temperature)
+    {
+        surfacePressure_ = pressure;
+        surfaceTemperature_ = temperature;
+    }
+
+    /*!
+     * \brief Set the range of pressures [Pa] and the number of equidistant pressures
+     *        at which the fluid is flashed.
+     */
+    void setPressureSampling(Scalar minPressure, Scalar maxPressure, unsigned numPressures)
+    {
+        if (numPressures < 2 || !(minPressure < maxPressure))
+            OPM_THROW(std::invalid_argument,
+                      "At least two distinct pressures must be sampled");
+
+        minPressure_ = minPressure;
+        maxPressure_ = maxPressure;
+        numPressures_ = numPressures;
+    }
+
+    /*!
+     * \brief Set the sampling of the undersaturated branches of the tables.
+     *
+     * The oil of each row is compressed from its saturation pressure to the
+     * saturation pressure plus 'pressureRange' [Pa]. The gas of each row is sampled
+     * at as many vaporized oil factors between zero and the saturated one.
+     * 'numSamples' includes the saturated sampling point.
+     */
+    void setUndersaturatedSampling(Scalar pressureRange, unsigned numSamples)
+    {
+        if (numSamples < 2 || !(pressureRange > 0.0))
+            OPM_THROW(std::invalid_argument,
+                      "The undersaturated branches need at least two sampling points");
+
+        undersaturatedPressureRange_ = pressureRange;
+        numUndersaturated_ = numSamples;
+    }
+
+    /*!
+     * \brief Set how the gas is liberated from the oil.
+     */
+    void setLiberationProcess(LiberationProcess value)
+    { liberationProcess_ = value; }
+
+    /*!
+     * \brief Generate the tables of a PVT region for a reservoir fluid given by its
+     *        overall mole fractions.
+     *
+     * The number of regions of the PVT objects must have been set before and
+     * initEnd() must be called for them once all regions have been generated.
+     */
+    void generate(OilPvt& oilPvt,
+                  GasPvt& gasPvt,
+                  unsigned regionIdx,
+                  const ComponentVector& globalMoleFractions)
+    {
+        // the reference densities are the ones of the separated original fluid
+        PhaseSplit surface;
+        flash_(surface, globalMoleFractions, surfacePressure_, surfaceTemperature_);
+        if (!(surface.vaporFraction > 0.0 && surface.vaporFraction < 1.0))
+            OPM_THROW(std::runtime_error,
+                      "The reservoir fluid does not separate into stock tank oil and "
+                      "surface gas");
+        oilReferenceDensity_ = surface.density[oilPhaseIdx];
+        gasReferenceDensity_ = surface.density[gasPhaseIdx];
+
+        std::vector<PhaseSplit> reservoir(numPressures_);
+        flashReservoirFluid_(reservoir, globalMoleFractions);
+
+        // only the pressures at which two phases are present yield saturated rows
+        std::vector<unsigned> rowSampleIdx;
+        for (unsigned sampleIdx = 0; sampleIdx < numPressures_; ++sampleIdx)
+            if (reservoir[sampleIdx].vaporFraction > 0.0 && reservoir[sampleIdx].vaporFraction < 1.0)
+                rowSampleIdx.push_back(sampleIdx);
+        if (rowSampleIdx.size() < 2)
+            OPM_THROW(std::runtime_error,
+                      "The reservoir fluid splits into two phases at less than two of the "
+                      "sampled pressures");
+
+        // compute the rows of the tables
+        const int numRows = static_cast<int>(rowSampleIdx.size());
+        std::vector<Row> rows(numRows);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            computeRow_(rows[rowIdx], reservoir[rowSampleIdx[rowIdx]]);
+
+        assembleOilTables_(oilPvt, regionIdx, rows);
+        assembleGasTables_(gasPvt, regionIdx, rows);
+    }
+
+    /*!
+     * \brief Return the density of the stock tank oil of the last generated region
+     *        [kg/m^3].
+     */
+    Scalar oilReferenceDensity() const
+    { return oilReferenceDensity_; }
+
+    /*!
+     * \brief Return the density of the surface gas of the last generated region
+     *        [kg/m^3].
+     */
+    Scalar gasReferenceDensity() const
+    { return gasReferenceDensity_; }
+
+private:
+    // the result of a flash calculation
+    struct PhaseSplit
+    {
+        Scalar pressure;
+        Scalar vaporFraction;
+        ComponentVector moleFraction[numPhases];
+        Scalar density[numPhases];
+        Scalar molarDensity[numPhases];
+        Scalar viscosity[numPhases];
+    };
+
+    // a saturated row of the oil and the gas tables. the oil samples are ordered by
+    // pressure, the gas samples by the vaporized oil factor.
+    struct Row
+    {
+        Scalar pressure;
+        Scalar Rs;
+        Scalar Rv;
+        std::vector<Scalar> oilPressure;
+        std::vector<Scalar> oilB;
+        std::vector<Scalar> oilViscosity;
+        std::vector<Scalar> gasRv;
+        std::vector<Scalar> gasB;
+        std::vector<Scalar> gasViscosity;
+    };
+
+    void flashReservoirFluid_(std::vector<PhaseSplit>& reservoir,
+                              const ComponentVector& globalMoleFractions) const
+    {
+        const int n = static_cast<int>(numPressures_);
+        if (liberationProcess_ == ConstantCompositionLiberation) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (int sampleIdx = 0; sampleIdx < n; ++sampleIdx)
+                flash_(reservoir[sampleIdx], globalMoleFractions, samplePressure_(sampleIdx), temperature_);
+            return;
+        }
+
+        // differential liberation: the oil of each step is the feed of the next
+        // lower pressure
+        ComponentVector feed = globalMoleFractions;
+        for (int sampleIdx = n - 1; sampleIdx >= 0; --sampleIdx) {
+            PhaseSplit& split = reservoir[sampleIdx];
+            flash_(split, feed, samplePressure_(sampleIdx), temperature_);
+            if (split.vaporFraction > 0.0 && split.vaporFraction < 1.0)
+                feed = split.moleFraction[oilPhaseIdx];
+        }
+    }
+
+    void computeRow_(Row& row, const PhaseSplit& saturated) const
+    {
+        row.pressure = saturated.pressure;
+
+        // separate the saturated oil
+        Scalar oilSurfaceVolume, gasSurfaceVolume;
+        PhaseSplit surface;
+        separate_(surface, oilSurfaceVolume, gasSurfaceVolume, saturated.moleFraction[oilPhaseIdx]);
+        if (!(oilSurfaceVolume > 0.0))
+            OPM_THROW(Opm::NumericalProblem,
+                      "The saturated oil at p = " << row.pressure << " does not yield any "
+                      "stock tank oil");
+        row.Rs = gasSurfaceVolume/oilSurfaceVolume;
+
+        // the undersaturated branch of the oil: compress the saturated oil
+        row.oilPressure.resize(numUndersaturated_);
+        row.oilB.resize(numUndersaturated_);
+        row.oilViscosity.resize(numUndersaturated_);
+        const Scalar oilSurfaceMass = oilReferenceDensity_ + row.Rs*gasReferenceDensity_;
+        for (unsigned sampleIdx = 0; sampleIdx < numUndersaturated_; ++sampleIdx) {
+            Scalar p = row.pressure + undersaturatedPressureRange_*sampleIdx/(numUndersaturated_ - 1);
+            Scalar rho = saturated.density[oilPhaseIdx];
+            Scalar mu = saturated.viscosity[oilPhaseIdx];
+            if (sampleIdx > 0)
+                singlePhase_(rho, mu, saturated.moleFraction[oilPhaseIdx], oilPhaseIdx, p);
+
+            row.oilPressure[sampleIdx] = p;
+            row.oilB[sampleIdx] = oilSurfaceMass/rho;
+            row.oilViscosity[sampleIdx] = mu;
+        }
+
+        // separate the saturated gas
+        PhaseSplit gasSurface;
+        separate_(gasSurface, oilSurfaceVolume, gasSurfaceVolume, saturated.moleFraction[gasPhaseIdx]);
+        if (!(gasSurfaceVolume > 0.0))
+            OPM_THROW(Opm::NumericalProblem,
+                      "The saturated gas at p = " << row.pressure << " does not yield any "
+                      "surface gas");
+        row.Rv = oilSurfaceVolume/gasSurfaceVolume;
+
+        // the undersaturated branch of the gas: the saturated gas diluted by its surface
+        // gas, which does not contain any vaporized oil
+        row.gasRv.resize(numUndersaturated_);
+        row.gasB.resize(numUndersaturated_);
+        row.gasViscosity.resize(numUndersaturated_);
+        const ComponentVector& dryGas = gasSurface.moleFraction[gasPhaseIdx];
+        for (unsigned sampleIdx = 0; sampleIdx < numUndersaturated_; ++sampleIdx) {
+            Scalar Rv = row.Rv;
+            Scalar rho = saturated.density[gasPhaseIdx];
+            Scalar mu = saturated.viscosity[gasPhaseIdx];
+            if (sampleIdx < numUndersaturated_ - 1) {
+                Scalar w = Scalar(sampleIdx)/(numUndersaturated_ - 1);
+                ComponentVector mixture;
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                    mixture[compIdx] =
+                        (1.0 - w)*dryGas[compIdx] + w*saturated.moleFraction[gasPhaseIdx][compIdx];
+
+                singlePhase_(rho, mu, mixture, gasPhaseIdx, row.pressure);
+                separate_(surface, oilSurfaceVolume, gasSurfaceVolume, mixture);
+                Rv = oilSurfaceVolume/gasSurfaceVolume;
+            }
+
+            row.gasRv[sampleIdx] = Rv;
+            row.gasB[sampleIdx] = (gasReferenceDensity_ + Rv*oilReferenceDensity_)/rho;
+            row.gasViscosity[sampleIdx] = mu;
+        }
+    }
+
+    void assembleOilTables_(OilPvt& oilPvt, unsigned regionIdx, const std::vector<Row>& rows) const
+    {
+        SamplingPoints saturatedRs;
+        SamplingPoints saturatedViscosity;
+        TabulatedTwoDFunction invB;
+        TabulatedTwoDFunction viscosity;
+        for (unsigned rowIdx = 0; rowIdx < rows.size(); ++rowIdx) {
+            const Row& row = rows[rowIdx];
+            if (rowIdx > 0 && !(row.Rs > rows[rowIdx - 1].Rs))
+                OPM_THROW(Opm::NumericalProblem,
+                          "The dissolved gas factor does not increase with pressure at p = "
+                          << row.pressure);
+
+            saturatedRs.push_back(std::make_pair(row.pressure, row.Rs));
+            saturatedViscosity.push_back(std::make_pair(row.pressure, row.oilViscosity[0]));
+
+            invB.appendXPos(row.Rs);
+            viscosity.appendXPos(row.Rs);
+            for (unsigned sampleIdx = 0; sampleIdx < numUndersaturated_; ++sampleIdx) {
+                invB.appendSamplePoint(rowIdx, row.oilPressure[sampleIdx], 1.0/row.oilB[sampleIdx]);
+                viscosity.appendSamplePoint(rowIdx, row.oilPressure[sampleIdx], row.oilViscosity[sampleIdx]);
+            }
+        }
+
+        oilPvt.setReferenceDensities(regionIdx, oilReferenceDensity_, gasReferenceDensity_, /*rhoRefWater=*/0.0);
+        oilPvt.setSaturatedOilGasDissolutionFactor(regionIdx, saturatedRs);
+        // this guesstimates an undersaturated viscosity table which is replaced below
+        oilPvt.setSaturatedOilViscosity(regionIdx, saturatedViscosity);
+        oilPvt.setInverseOilFormationVolumeFactor(regionIdx, invB);
+        oilPvt.setOilViscosity(regionIdx, viscosity);
+    }
+
+    void assembleGasTables_(GasPvt& gasPvt, unsigned regionIdx, const std::vector<Row>& rows) const
+    {
+        // the rows of dry gas are extended up to the largest vaporized oil factor
+        Scalar maxRv = 0.0;
+        for (unsigned rowIdx = 0; rowIdx < rows.size(); ++rowIdx)
+            maxRv = std::max(maxRv, rows[rowIdx].Rv);
+        if (!(maxRv > 0.0))
+            OPM_THROW(std::runtime_error,
+                      "The gas does not contain any vaporized oil at the sampled pressures");
+
+        SamplingPoints saturatedRv;
+        TabulatedTwoDFunction invB;
+        TabulatedTwoDFunction viscosity;
+        for (unsigned rowIdx = 0; rowIdx < rows.size(); ++rowIdx) {
+            const Row& row = rows[rowIdx];
+            saturatedRv.push_back(std::make_pair(row.pressure, row.Rv));
+
+            invB.appendXPos(row.pressure);
+            viscosity.appendXPos(row.pressure);
+
+            // mixtures which are too lean to yield any stock tank oil exhibit the same
+            // vaporized oil factor. these are skipped, but the saturated gas is always
+            // the last sampling point.
+            Scalar lastRv = -1.0;
+            for (unsigned sampleIdx = 0; sampleIdx < numUndersaturated_; ++sampleIdx) {
+                Scalar Rv = row.gasRv[sampleIdx];
+                bool isSaturated = (sampleIdx == numUndersaturated_ - 1);
+                if (!(Rv > lastRv) || (!isSaturated && !(Rv < row.Rv)))
+                    continue;
+
+                invB.appendSamplePoint(rowIdx, Rv, 1.0/row.gasB[sampleIdx]);
+                viscosity.appendSamplePoint(rowIdx, Rv, row.gasViscosity[sampleIdx]);
+                lastRv = Rv;
+            }
+
+            if (invB.numY(rowIdx) < 2) {
+                // dry gas. since the gas cannot vaporize any oil, its properties do not
+                // depend on the vaporized oil factor
+                invB.appendSamplePoint(rowIdx, maxRv, 1.0/row.gasB[0]);
+                viscosity.appendSamplePoint(rowIdx, maxRv, row.gasViscosity[0]);
+            }
+        }
+
+        gasPvt.setReferenceDensities(regionIdx, oilReferenceDensity_, gasReferenceDensity_, /*rhoRefWater=*/0.0);
+        gasPvt.setSaturatedGasOilVaporizationFactor(regionIdx, saturatedRv);
+        gasPvt.setInverseGasFormationVolumeFactor(regionIdx, invB);
+        gasPvt.setGasViscosity(regionIdx, viscosity);
+    }
+
+    // flash a mixture at surface conditions and return the volumes of the stock tank
+    // oil and of the surface gas per mole of the mixture
+    void separate_(PhaseSplit& surface,
+                   Scalar& oilVolume,
+                   Scalar& gasVolume,
+                   const ComponentVector& moleFractions) const
+    {
+        flash_(surface, moleFractions, surfacePressure_, surfaceTemperature_);
+
+        const Scalar V = surface.vaporFraction;
+        oilVolume = (1.0 - V)/surface.molarDensity[oilPhaseIdx];
+        gasVolume = V/surface.molarDensity[gasPhaseIdx];
+    }
+
+    void flash_(PhaseSplit& split,
+                const ComponentVector& moleFractions,
+                Scalar pressure,
+                Scalar temperature) const
+    {
+        FluidState fluidState;
+        fluidState.setTemperature(temperature);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fluidState.setPressure(phaseIdx, pressure);
+            fluidState.setSaturation(phaseIdx, 0.0);
+        }
+
+        ParameterCache paramCache;
+        Opm::FlashStatistics<Scalar> stats;
+        Flash::solve(fluidState, paramCache, moleFractions, oilPhaseIdx, gasPhaseIdx,
+                     split.vaporFraction, stats);
+        if (!stats.converged)
+            OPM_THROW(Opm::NumericalProblem,
+                      "Flash calculation did not converge at p = " << pressure
+                      << ", T = " << temperature);
+
+        split.pressure = pressure;
+        for (unsigned i = 0; i < 2; ++i) {
+            unsigned phaseIdx = (i == 0) ? static_cast<unsigned>(oilPhaseIdx) : static_cast<unsigned>(gasPhaseIdx);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                split.moleFraction[phaseIdx][compIdx] = fluidState.moleFraction(phaseIdx, compIdx);
+            split.density[phaseIdx] = fluidState.density(phaseIdx);
+            split.molarDensity[phaseIdx] = fluidState.molarDensity(phaseIdx);
+            split.viscosity[phaseIdx] = FluidSystem::viscosity(fluidState, paramCache, phaseIdx);
+        }
+    }
+
+    // density and viscosity of a mixture which is present as a single phase
+    void singlePhase_(Scalar& density,
+                      Scalar& viscosity,
+                      const ComponentVector& moleFractions,
+                      unsigned phaseIdx,
+                      Scalar pressure) const
+    {
+        FluidState fluidState;
+        fluidState.setTemperature(temperature_);
+        fluidState.setPressure(phaseIdx, pressure);
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            fluidState.setMoleFraction(phaseIdx, compIdx, moleFractions[compIdx]);
+
+        ParameterCache paramCache;
+        paramCache.updatePhase(fluidState, phaseIdx);
+        density = FluidSystem::density(fluidState, paramCache, phaseIdx);
+        viscosity = FluidSystem::viscosity(fluidState, paramCache, phaseIdx);
+    }
+
+    Scalar samplePressure_(int sampleIdx) const
+    { return minPressure_ + (maxPressure_ - minPressure_)*sampleIdx/(numPressures_ - 1); }
+
+    Scalar temperature_;
+    Scalar surfacePressure_;
+    Scalar surfaceTemperature_;
+    Scalar minPressure_;
+    Scalar maxPressure_;
+    unsigned numPressures_;
+    Scalar undersaturatedPressureRange_;
+    unsigned numUndersaturated_;
+    LiberationProcess liberationProcess_;
+
+    Scalar oilReferenceDensity_;
+    Scalar gasReferenceDensity_;
+};
+
+} // namespace Opm
+
+#endif
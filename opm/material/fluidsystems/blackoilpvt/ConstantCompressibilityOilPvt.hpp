@@ -30,6 +30,8 @@
 #include <opm/material/common/OpmFinal.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
 #include <opm/material/common/Spline.hpp>
 
 #if HAVE_OPM_PARSER
@@ -163,6 +165,46 @@ public:
     unsigned numRegions() const
     { return oilViscosity_.size(); }
 
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(oilReferenceDensity_)
+                  + vectorMemoryUsage(oilReferencePressure_)
+                  + vectorMemoryUsage(oilReferenceFormationVolumeFactor_)
+                  + vectorMemoryUsage(oilCompressibility_)
+                  + vectorMemoryUsage(oilViscosity_)
+                  + vectorMemoryUsage(oilViscosibility_));
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(oilReferenceDensity_);
+        writer.write(oilReferencePressure_);
+        writer.write(oilReferenceFormationVolumeFactor_);
+        writer.write(oilCompressibility_);
+        writer.write(oilViscosity_);
+        writer.write(oilViscosibility_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(oilReferenceDensity_);
+        reader.read(oilReferencePressure_);
+        reader.read(oilReferenceFormationVolumeFactor_);
+        reader.read(oilCompressibility_);
+        reader.read(oilViscosity_);
+        reader.read(oilViscosibility_);
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of gas saturated oil given a pressure
      *        and a phase composition.
@@ -221,6 +263,68 @@ public:
         return (1 + X*(1 + X/2))/BoRef;
     }
 
+    /*!
+     * \brief Returns the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the fluid phase at once.
+     *
+     * The parameters of the region are only loaded once and the pressure difference to
+     * the reference pressure is shared by both quantities. The results are the same as
+     * the ones of inverseFormationVolumeFactor() and viscosity().
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& temperature,
+                                                  const Evaluation& pressure,
+                                                  const Evaluation& /*Rs*/,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    { saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu); }
+
+    /*!
+     * \brief Returns the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of gas saturated oil at once.
+     */
+    template <class Evaluation>
+    void saturatedInverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                           const Evaluation& /*temperature*/,
+                                                           const Evaluation& pressure,
+                                                           Evaluation& invB,
+                                                           Evaluation& mu) const
+    {
+        const Scalar pRef = oilReferencePressure_[regionIdx];
+        const Scalar BoRef = oilReferenceFormationVolumeFactor_[regionIdx];
+        const Scalar co = oilCompressibility_[regionIdx];
+        const Scalar cvo = co - oilViscosibility_[regionIdx];
+        const Scalar BoMuoRef = oilViscosity_[regionIdx]*BoRef;
+
+        invBAndViscosity_(pRef, BoRef, co, cvo, BoMuoRef, pressure, invB, mu);
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factors [-] and the dynamic
+     *        viscosities [Pa s] for an array of pressures of the same PVT region.
+     *
+     * The parameters of the region are only loaded once for all values, and the loop
+     * does not contain any branches, so the compiler is able to vectorize it if the
+     * Evaluation type is a plain floating point type.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosityBatch(unsigned regionIdx,
+                                                       size_t numValues,
+                                                       const Evaluation* pressure,
+                                                       Evaluation* invB,
+                                                       Evaluation* mu) const
+    {
+        const Scalar pRef = oilReferencePressure_[regionIdx];
+        const Scalar BoRef = oilReferenceFormationVolumeFactor_[regionIdx];
+        const Scalar co = oilCompressibility_[regionIdx];
+        const Scalar cvo = co - oilViscosibility_[regionIdx];
+        const Scalar BoMuoRef = oilViscosity_[regionIdx]*BoRef;
+
+        for (size_t i = 0; i < numValues; ++i)
+            invBAndViscosity_(pRef, BoRef, co, cvo, BoMuoRef, pressure[i], invB[i], mu[i]);
+    }
+
     /*!
      * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of the oil phase.
      */
@@ -254,6 +358,26 @@ public:
     { return 0.0; /* this is dead oil, so there isn't any meaningful saturation pressure! */ }
 
 private:
+    // evaluates the same expressions as saturatedInverseFormationVolumeFactor() and
+    // saturatedViscosity()
+    template <class Evaluation>
+    static void invBAndViscosity_(Scalar pRef,
+                                  Scalar BoRef,
+                                  Scalar co,
+                                  Scalar cvo,
+                                  Scalar BoMuoRef,
+                                  const Evaluation& pressure,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    {
+        const Evaluation& dp = pressure - pRef;
+        const Evaluation& X = co*dp;
+        const Evaluation& Y = cvo*dp;
+
+        invB = (1 + X*(1 + X/2))/BoRef;
+        mu = BoMuoRef*invB/(1.0 + Y*(1.0 + Y/2.0));
+    }
+
     std::vector<Scalar> oilReferenceDensity_;
     std::vector<Scalar> oilReferencePressure_;
     std::vector<Scalar> oilReferenceFormationVolumeFactor_;
@@ -28,6 +28,9 @@
 #define OPM_CONSTANT_COMPRESSIBILITY_WATER_PVT_HPP
 
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/FlatBlackOilPvt.hpp>
 
 #if HAVE_OPM_PARSER
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -159,6 +162,70 @@ public:
     unsigned numRegions() const
     { return waterReferenceDensity_.size(); }
 
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(waterReferenceDensity_)
+                  + vectorMemoryUsage(waterReferencePressure_)
+                  + vectorMemoryUsage(waterReferenceFormationVolumeFactor_)
+                  + vectorMemoryUsage(waterCompressibility_)
+                  + vectorMemoryUsage(waterViscosity_)
+                  + vectorMemoryUsage(waterViscosibility_));
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(waterReferenceDensity_);
+        writer.write(waterReferencePressure_);
+        writer.write(waterReferenceFormationVolumeFactor_);
+        writer.write(waterCompressibility_);
+        writer.write(waterViscosity_);
+        writer.write(waterViscosibility_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(waterReferenceDensity_);
+        reader.read(waterReferencePressure_);
+        reader.read(waterReferenceFormationVolumeFactor_);
+        reader.read(waterCompressibility_);
+        reader.read(waterViscosity_);
+        reader.read(waterViscosibility_);
+    }
+
+    /*!
+     * \brief Return the descriptors of all PVT regions.
+     *
+     * This relation does not use any tables, so the buffer is only accepted for
+     * consistency with the other PVT classes.
+     */
+    template <class FlatScalar>
+    std::vector<FlatConstantCompressibilityWaterPvtRegion<FlatScalar> >
+    exportFlat(FlatTableBuffer<FlatScalar>& /*buffer*/) const
+    {
+        std::vector<FlatConstantCompressibilityWaterPvtRegion<FlatScalar> > result(numRegions());
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            auto& region = result[regionIdx];
+            region.waterReferenceDensity = static_cast<FlatScalar>(waterReferenceDensity_[regionIdx]);
+            region.waterReferencePressure = static_cast<FlatScalar>(waterReferencePressure_[regionIdx]);
+            region.waterReferenceFormationVolumeFactor =
+                static_cast<FlatScalar>(waterReferenceFormationVolumeFactor_[regionIdx]);
+            region.waterCompressibility = static_cast<FlatScalar>(waterCompressibility_[regionIdx]);
+            region.waterViscosity = static_cast<FlatScalar>(waterViscosity_[regionIdx]);
+            region.waterViscosibility = static_cast<FlatScalar>(waterViscosibility_[regionIdx]);
+        }
+        return result;
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -195,7 +262,75 @@ public:
         return (1.0 + X*(1.0 + X/2.0))/BwRef;
     }
 
+    /*!
+     * \brief Returns the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the fluid phase at once.
+     *
+     * The parameters of the region are only loaded once and the pressure difference to
+     * the reference pressure is shared by both quantities. The results are the same as
+     * the ones of inverseFormationVolumeFactor() and viscosity().
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& /*temperature*/,
+                                                  const Evaluation& pressure,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    {
+        const Scalar pRef = waterReferencePressure_[regionIdx];
+        const Scalar BwRef = waterReferenceFormationVolumeFactor_[regionIdx];
+        const Scalar cw = waterCompressibility_[regionIdx];
+        const Scalar cvw = cw - waterViscosibility_[regionIdx];
+        const Scalar BwMuwRef = waterViscosity_[regionIdx]*BwRef;
+
+        invBAndViscosity_(pRef, BwRef, cw, cvw, BwMuwRef, pressure, invB, mu);
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factors [-] and the dynamic
+     *        viscosities [Pa s] for an array of pressures of the same PVT region.
+     *
+     * The parameters of the region are only loaded once for all values, and the loop
+     * does not contain any branches, so the compiler is able to vectorize it if the
+     * Evaluation type is a plain floating point type.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosityBatch(unsigned regionIdx,
+                                                       size_t numValues,
+                                                       const Evaluation* pressure,
+                                                       Evaluation* invB,
+                                                       Evaluation* mu) const
+    {
+        const Scalar pRef = waterReferencePressure_[regionIdx];
+        const Scalar BwRef = waterReferenceFormationVolumeFactor_[regionIdx];
+        const Scalar cw = waterCompressibility_[regionIdx];
+        const Scalar cvw = cw - waterViscosibility_[regionIdx];
+        const Scalar BwMuwRef = waterViscosity_[regionIdx]*BwRef;
+
+        for (size_t i = 0; i < numValues; ++i)
+            invBAndViscosity_(pRef, BwRef, cw, cvw, BwMuwRef, pressure[i], invB[i], mu[i]);
+    }
+
 private:
+    // evaluates the same expressions as inverseFormationVolumeFactor() and viscosity()
+    template <class Evaluation>
+    static void invBAndViscosity_(Scalar pRef,
+                                  Scalar BwRef,
+                                  Scalar cw,
+                                  Scalar cvw,
+                                  Scalar BwMuwRef,
+                                  const Evaluation& pressure,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    {
+        const Evaluation& dp = pressure - pRef;
+        const Evaluation& X = cw*dp;
+        const Evaluation& Y = cvw*dp;
+
+        invB = (1.0 + X*(1.0 + X/2.0))/BwRef;
+        mu = BwMuwRef*invB/(1 + Y*(1 + Y/2));
+    }
+
     std::vector<Scalar> waterReferenceDensity_;
     std::vector<Scalar> waterReferencePressure_;
     std::vector<Scalar> waterReferenceFormationVolumeFactor_;
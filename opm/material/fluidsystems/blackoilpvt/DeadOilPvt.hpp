@@ -29,6 +29,11 @@
 
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/RegionTabulated1DMultiFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/Tracing.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/FlatBlackOilPvt.hpp>
 #include <opm/material/common/Spline.hpp>
 
 #if HAVE_OPM_PARSER
@@ -156,7 +161,16 @@ public:
             inverseOilBMu_[regionIdx].setXYArrays(pressureColumn.size(),
                                                   pressureColumn,
                                                   invBMuColumn);
+
+            // set the names under which the lookups are reported if table profiling is
+            // enabled
+            const std::string prefix = "PVDO region " + std::to_string(regionIdx + 1) + " ";
+            inverseOilB_[regionIdx].setProfileName(prefix + "invB");
+            oilMu_[regionIdx].setProfileName(prefix + "mu");
+            inverseOilBMu_[regionIdx].setProfileName(prefix + "invBMu");
         }
+
+        updateInvBTables_();
     }
 
     /*!
@@ -165,6 +179,61 @@ public:
     unsigned numRegions() const
     { return inverseOilBMu_.size(); }
 
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(oilReferenceDensity_));
+        usage.add("tables",
+                    tableVectorMemoryUsage(inverseOilB_)
+                  + tableVectorMemoryUsage(oilMu_)
+                  + tableVectorMemoryUsage(inverseOilBMu_)
+                  + invBTables_.heapMemoryUsage());
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(oilReferenceDensity_);
+        writer.writeObjects(inverseOilB_);
+        writer.writeObjects(oilMu_);
+        writer.writeObjects(inverseOilBMu_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(oilReferenceDensity_);
+        reader.readObjects(inverseOilB_);
+        reader.readObjects(oilMu_);
+        reader.readObjects(inverseOilBMu_);
+
+        updateInvBTables_();
+    }
+
+    /*!
+     * \brief Append the tables to a flat table buffer and return the descriptors of
+     *        all PVT regions.
+     */
+    template <class FlatScalar>
+    std::vector<FlatDeadOilPvtRegion<FlatScalar> > exportFlat(FlatTableBuffer<FlatScalar>& buffer) const
+    {
+        std::vector<FlatDeadOilPvtRegion<FlatScalar> > result(numRegions());
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            auto& region = result[regionIdx];
+            region.oilReferenceDensity = static_cast<FlatScalar>(oilReferenceDensity_[regionIdx]);
+            region.inverseOilBTable = inverseOilB_[regionIdx].exportFlat(buffer);
+            region.inverseOilBMuTable = inverseOilBMu_[regionIdx].exportFlat(buffer);
+        }
+        return result;
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -183,8 +252,14 @@ public:
                                   const Evaluation& /*temperature*/,
                                   const Evaluation& pressure) const
     {
-        const Evaluation& invBo = inverseOilB_[regionIdx].eval(pressure, /*extrapolate=*/true);
-        const Evaluation& invMuoBo = inverseOilBMu_[regionIdx].eval(pressure, /*extrapolate=*/true);
+        OPM_MATERIAL_TRACE_SCOPE("DeadOilPvt::saturatedViscosity");
+
+        // both quantities use the same sampling points, so the segment only needs to
+        // be searched for once
+        std::array<Evaluation, 2> values;
+        invBTables_.eval(regionIdx, pressure, values);
+        const Evaluation& invBo = values[invBIdx_];
+        const Evaluation& invMuoBo = values[invBMuIdx_];
 
         return invBo/invMuoBo;
     }
@@ -197,7 +272,7 @@ public:
                                             const Evaluation& /*temperature*/,
                                             const Evaluation& pressure,
                                             const Evaluation& /*Rs*/) const
-    { return inverseOilB_[regionIdx].eval(pressure, /*extrapolate=*/true); }
+    { return invBTables_.eval(regionIdx, invBIdx_, pressure); }
 
     /*!
      * \brief Returns the formation volume factor [-] of saturated oil.
@@ -208,7 +283,11 @@ public:
     Evaluation saturatedInverseFormationVolumeFactor(unsigned regionIdx,
                                               const Evaluation& /*temperature*/,
                                               const Evaluation& pressure) const
-    { return inverseOilB_[regionIdx].eval(pressure, /*extrapolate=*/true); }
+    {
+        OPM_MATERIAL_TRACE_SCOPE("DeadOilPvt::saturatedInverseFormationVolumeFactor");
+
+        return invBTables_.eval(regionIdx, invBIdx_, pressure);
+    }
 
     /*!
      * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of the oil phase.
@@ -255,10 +334,41 @@ public:
     { return 0.0; /* this is dead oil! */ }
 
 private:
+    typedef RegionTabulated1DMultiFunction<Scalar, 2> InvBTables;
+
+    // the indices of the quantities in invBTables_
+    enum { invBIdx_ = 0, invBMuIdx_ = 1 };
+
+    // copy the tables which are required for evaluation of all regions into a single
+    // contiguous store
+    void updateInvBTables_()
+    {
+        invBTables_.clear();
+        std::vector<Scalar> pressureValues;
+        std::vector<typename InvBTables::ValueArray> values;
+        for (unsigned regionIdx = 0; regionIdx < inverseOilB_.size(); ++regionIdx) {
+            const auto& invOilB = inverseOilB_[regionIdx];
+            const auto& invOilBMu = inverseOilBMu_[regionIdx];
+
+            pressureValues.resize(invOilB.numSamples());
+            values.resize(invOilB.numSamples());
+            for (unsigned pIdx = 0; pIdx < invOilB.numSamples(); ++pIdx) {
+                pressureValues[pIdx] = invOilB.xAt(pIdx);
+                values[pIdx][invBIdx_] = invOilB.valueAt(pIdx);
+                values[pIdx][invBMuIdx_] = invOilBMu.valueAt(pIdx);
+            }
+            invBTables_.appendRegion(pressureValues, values);
+        }
+    }
+
     std::vector<Scalar> oilReferenceDensity_;
     std::vector<TabulatedOneDFunction> inverseOilB_;
     std::vector<TabulatedOneDFunction> oilMu_;
     std::vector<TabulatedOneDFunction> inverseOilBMu_;
+
+    // the inverse formation volume factor and the inverse of its product with the
+    // viscosity of all regions. the per-region tables above are the primary data
+    InvBTables invBTables_;
 };
 
 } // namespace Opm
@@ -30,6 +30,11 @@
 #include <opm/material/Constants.hpp>
 
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/RegionTabulated1DMultiFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/Tracing.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/FlatBlackOilPvt.hpp>
 
 #if HAVE_OPM_PARSER
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -40,6 +45,8 @@
 #include <opm/parser/eclipse/Deck/DeckRecord.hpp>
 #endif
 
+#include <array>
+#include <string>
 #include <vector>
 
 namespace Opm {
@@ -182,7 +189,16 @@ public:
             }
 
             inverseGasBMu_[regionIdx].setXYContainers(pressureValues, invGasBMuValues);
+
+            // set the names under which the lookups are reported if table profiling is
+            // enabled
+            const std::string prefix = "PVDG region " + std::to_string(regionIdx + 1) + " ";
+            inverseGasB_[regionIdx].setProfileName(prefix + "invB");
+            gasMu_[regionIdx].setProfileName(prefix + "mu");
+            inverseGasBMu_[regionIdx].setProfileName(prefix + "invBMu");
         }
+
+        updateInvBTables_();
     }
 
     /*!
@@ -191,6 +207,61 @@ public:
     unsigned numRegions() const
     { return gasReferenceDensity_.size(); }
 
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(gasReferenceDensity_));
+        usage.add("tables",
+                    tableVectorMemoryUsage(inverseGasB_)
+                  + tableVectorMemoryUsage(gasMu_)
+                  + tableVectorMemoryUsage(inverseGasBMu_)
+                  + invBTables_.heapMemoryUsage());
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(gasReferenceDensity_);
+        writer.writeObjects(inverseGasB_);
+        writer.writeObjects(gasMu_);
+        writer.writeObjects(inverseGasBMu_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(gasReferenceDensity_);
+        reader.readObjects(inverseGasB_);
+        reader.readObjects(gasMu_);
+        reader.readObjects(inverseGasBMu_);
+
+        updateInvBTables_();
+    }
+
+    /*!
+     * \brief Append the tables to a flat table buffer and return the descriptors of
+     *        all PVT regions.
+     */
+    template <class FlatScalar>
+    std::vector<FlatDryGasPvtRegion<FlatScalar> > exportFlat(FlatTableBuffer<FlatScalar>& buffer) const
+    {
+        std::vector<FlatDryGasPvtRegion<FlatScalar> > result(numRegions());
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            auto& region = result[regionIdx];
+            region.gasReferenceDensity = static_cast<FlatScalar>(gasReferenceDensity_[regionIdx]);
+            region.inverseGasBTable = inverseGasB_[regionIdx].exportFlat(buffer);
+            region.inverseGasBMuTable = inverseGasBMu_[regionIdx].exportFlat(buffer);
+        }
+        return result;
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -209,8 +280,14 @@ public:
                                   const Evaluation& /*temperature*/,
                                   const Evaluation& pressure) const
     {
-        const Evaluation& invBg = inverseGasB_[regionIdx].eval(pressure, /*extrapolate=*/true);
-        const Evaluation& invMugBg = inverseGasBMu_[regionIdx].eval(pressure, /*extrapolate=*/true);
+        OPM_MATERIAL_TRACE_SCOPE("DryGasPvt::saturatedViscosity");
+
+        // both quantities use the same sampling points, so the segment only needs to
+        // be searched for once
+        std::array<Evaluation, 2> values;
+        invBTables_.eval(regionIdx, pressure, values);
+        const Evaluation& invBg = values[invBIdx_];
+        const Evaluation& invMugBg = values[invBMuIdx_];
 
         return invBg/invMugBg;
     }
@@ -232,7 +309,11 @@ public:
     Evaluation saturatedInverseFormationVolumeFactor(unsigned regionIdx,
                                                      const Evaluation& /*temperature*/,
                                                      const Evaluation& pressure) const
-    { return inverseGasB_[regionIdx].eval(pressure, /*extrapolate=*/true); }
+    {
+        OPM_MATERIAL_TRACE_SCOPE("DryGasPvt::saturatedInverseFormationVolumeFactor");
+
+        return invBTables_.eval(regionIdx, invBIdx_, pressure);
+    }
 
     /*!
      * \brief Returns the saturation pressure of the gas phase [Pa]
@@ -267,10 +348,41 @@ public:
     { return 0.0; /* this is dry gas! */ }
 
 private:
+    typedef RegionTabulated1DMultiFunction<Scalar, 2> InvBTables;
+
+    // the indices of the quantities in invBTables_
+    enum { invBIdx_ = 0, invBMuIdx_ = 1 };
+
+    // copy the tables which are required for evaluation of all regions into a single
+    // contiguous store
+    void updateInvBTables_()
+    {
+        invBTables_.clear();
+        std::vector<Scalar> pressureValues;
+        std::vector<typename InvBTables::ValueArray> values;
+        for (unsigned regionIdx = 0; regionIdx < inverseGasB_.size(); ++regionIdx) {
+            const auto& invGasB = inverseGasB_[regionIdx];
+            const auto& invGasBMu = inverseGasBMu_[regionIdx];
+
+            pressureValues.resize(invGasB.numSamples());
+            values.resize(invGasB.numSamples());
+            for (unsigned pIdx = 0; pIdx < invGasB.numSamples(); ++pIdx) {
+                pressureValues[pIdx] = invGasB.xAt(pIdx);
+                values[pIdx][invBIdx_] = invGasB.valueAt(pIdx);
+                values[pIdx][invBMuIdx_] = invGasBMu.valueAt(pIdx);
+            }
+            invBTables_.appendRegion(pressureValues, values);
+        }
+    }
+
     std::vector<Scalar> gasReferenceDensity_;
     std::vector<TabulatedOneDFunction> inverseGasB_;
     std::vector<TabulatedOneDFunction> gasMu_;
     std::vector<TabulatedOneDFunction> inverseGasBMu_;
+
+    // the inverse formation volume factor and the inverse of its product with the
+    // viscosity of all regions. the per-region tables above are the primary data
+    InvBTables invBTables_;
 };
 
 } // namespace Opm
@@ -0,0 +1,67 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief Determines which PVT regions of an ECL deck are referenced by its cells.
+ */
+#ifndef OPM_ECL_PVT_REGION_USAGE_HPP
+#define OPM_ECL_PVT_REGION_USAGE_HPP
+
+#if HAVE_OPM_PARSER
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#endif
+
+#include <vector>
+#include <cstddef>
+
+namespace Opm {
+#if HAVE_OPM_PARSER
+/*!
+ * \brief Returns which PVT regions of a deck are referenced by the PVTNUM grid
+ *        property.
+ *
+ * The PVT classes use this to avoid computing the derived tables of regions which do
+ * not contain any cells. If the deck does not specify the PVTNUM property, the usage
+ * of the regions cannot be determined and all regions are considered to be used.
+ */
+inline std::vector<bool> eclUsedPvtRegions(const EclipseState& eclState, size_t numRegions)
+{
+    const auto& props = eclState.get3DProperties();
+    if (!props.hasDeckIntGridProperty("PVTNUM"))
+        return std::vector<bool>(numRegions, true);
+
+    std::vector<bool> regionIsUsed(numRegions, false);
+    const auto& pvtnumData = props.getIntGridProperty("PVTNUM").getData();
+    for (size_t cellIdx = 0; cellIdx < pvtnumData.size(); ++cellIdx) {
+        // PVTNUM is one-based
+        int regionIdx = pvtnumData[cellIdx] - 1;
+        if (0 <= regionIdx && static_cast<size_t>(regionIdx) < numRegions)
+            regionIsUsed[static_cast<size_t>(regionIdx)] = true;
+    }
+
+    return regionIsUsed;
+}
+#endif // HAVE_OPM_PARSER
+} // namespace Opm
+
+#endif
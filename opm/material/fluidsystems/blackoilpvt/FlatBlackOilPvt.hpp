@@ -0,0 +1,186 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Flat representations of the black-oil PVT relations which can be evaluated
+ *        by device code.
+ *
+ * The PVT classes which are based on tables or on closed-form expressions provide an
+ * exportFlat() method which appends their tables to a Opm::FlatTableBuffer and returns
+ * one descriptor per PVT region, e.g.
+ *
+ * \code
+ * Opm::FlatTableBuffer<double> buffer;
+ * std::vector<Opm::FlatLiveOilPvtRegion<double> > oilRegions = liveOilPvt.exportFlat(buffer);
+ *
+ * // copy oilRegions, buffer.scalars() and buffer.indices() to the device, then
+ * const auto& region = oilRegions[pvtRegionIdx]; // in a kernel
+ * double invBo = region.inverseFormationVolumeFactor(data, p, Rs);
+ * \endcode
+ *
+ * The methods of the descriptors yield the same results as the respective methods of
+ * the PVT classes. The temperature arguments are omitted because none of the
+ * supported relations depends on it. See opm/material/common/FlatTables.hpp for the
+ * general concept.
+ */
+#ifndef OPM_FLAT_BLACK_OIL_PVT_HPP
+#define OPM_FLAT_BLACK_OIL_PVT_HPP
+
+#include <opm/material/common/FlatTables.hpp>
+
+#include <type_traits>
+
+namespace Opm {
+
+/*!
+ * \brief The PVT relations of a region of Opm::DeadOilPvt.
+ */
+template <class Scalar>
+struct FlatDeadOilPvtRegion
+{
+    Scalar oilReferenceDensity;
+    FlatTabulated1DFunction<Scalar> inverseOilBTable;
+    FlatTabulated1DFunction<Scalar> inverseOilBMuTable;
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation viscosity(const FlatTableData<Scalar>& data, const Evaluation& pressure) const
+    { return inverseOilBTable.eval(data, pressure)/inverseOilBMuTable.eval(data, pressure); }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation inverseFormationVolumeFactor(const FlatTableData<Scalar>& data,
+                                                            const Evaluation& pressure) const
+    { return inverseOilBTable.eval(data, pressure); }
+};
+
+/*!
+ * \brief The PVT relations of a region of Opm::LiveOilPvt.
+ *
+ * The saturation pressure is not supported because it requires a Newton iteration
+ * which may fail.
+ */
+template <class Scalar>
+struct FlatLiveOilPvtRegion
+{
+    Scalar oilReferenceDensity;
+    // the first axis of the two-dimensional tables is R_s, the second one the pressure
+    FlatUniformXTabulated2DFunction<Scalar> inverseOilBTable;
+    FlatUniformXTabulated2DFunction<Scalar> inverseOilBAndBMuTable;
+    FlatTabulated1DFunction<Scalar> inverseSaturatedOilBTable;
+    FlatTabulated1DFunction<Scalar> inverseSaturatedOilBMuTable;
+    FlatTabulated1DFunction<Scalar> saturatedGasDissolutionFactorTable;
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation viscosity(const FlatTableData<Scalar>& data,
+                                         const Evaluation& pressure,
+                                         const Evaluation& Rs) const
+    {
+        Evaluation invBoAndInvMuoBo[2];
+        inverseOilBAndBMuTable.eval(data, Rs, pressure, invBoAndInvMuoBo);
+        return invBoAndInvMuoBo[0]/invBoAndInvMuoBo[1];
+    }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation saturatedViscosity(const FlatTableData<Scalar>& data,
+                                                  const Evaluation& pressure) const
+    { return inverseSaturatedOilBTable.eval(data, pressure)/inverseSaturatedOilBMuTable.eval(data, pressure); }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation inverseFormationVolumeFactor(const FlatTableData<Scalar>& data,
+                                                            const Evaluation& pressure,
+                                                            const Evaluation& Rs) const
+    { return inverseOilBTable.eval(data, Rs, pressure); }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation saturatedInverseFormationVolumeFactor(const FlatTableData<Scalar>& data,
+                                                                     const Evaluation& pressure) const
+    { return inverseSaturatedOilBTable.eval(data, pressure); }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation saturatedGasDissolutionFactor(const FlatTableData<Scalar>& data,
+                                                               const Evaluation& pressure) const
+    { return saturatedGasDissolutionFactorTable.eval(data, pressure); }
+};
+
+/*!
+ * \brief The PVT relations of a region of Opm::DryGasPvt.
+ */
+template <class Scalar>
+struct FlatDryGasPvtRegion
+{
+    Scalar gasReferenceDensity;
+    FlatTabulated1DFunction<Scalar> inverseGasBTable;
+    FlatTabulated1DFunction<Scalar> inverseGasBMuTable;
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation viscosity(const FlatTableData<Scalar>& data, const Evaluation& pressure) const
+    { return inverseGasBTable.eval(data, pressure)/inverseGasBMuTable.eval(data, pressure); }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation inverseFormationVolumeFactor(const FlatTableData<Scalar>& data,
+                                                            const Evaluation& pressure) const
+    { return inverseGasBTable.eval(data, pressure); }
+};
+
+/*!
+ * \brief The PVT relations of a region of Opm::ConstantCompressibilityWaterPvt.
+ *
+ * Since this relation is not tabulated, the table data is not required.
+ */
+template <class Scalar>
+struct FlatConstantCompressibilityWaterPvtRegion
+{
+    Scalar waterReferenceDensity;
+    Scalar waterReferencePressure;
+    Scalar waterReferenceFormationVolumeFactor;
+    Scalar waterCompressibility;
+    Scalar waterViscosity;
+    Scalar waterViscosibility;
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation viscosity(const Evaluation& pressure) const
+    {
+        const Scalar BwMuwRef = waterViscosity*waterReferenceFormationVolumeFactor;
+        const Evaluation& bw = inverseFormationVolumeFactor(pressure);
+
+        const Evaluation& Y = (waterCompressibility - waterViscosibility)*(pressure - waterReferencePressure);
+        return BwMuwRef*bw/(1 + Y*(1 + Y/2));
+    }
+
+    template <class Evaluation>
+    OPM_HOST_DEVICE Evaluation inverseFormationVolumeFactor(const Evaluation& pressure) const
+    {
+        const Evaluation& X = waterCompressibility*(pressure - waterReferencePressure);
+        return (1.0 + X*(1.0 + X/2.0))/waterReferenceFormationVolumeFactor;
+    }
+};
+
+static_assert(std::is_pod<FlatDeadOilPvtRegion<double> >::value
+              && std::is_pod<FlatLiveOilPvtRegion<double> >::value
+              && std::is_pod<FlatDryGasPvtRegion<double> >::value
+              && std::is_pod<FlatConstantCompressibilityWaterPvtRegion<double> >::value,
+              "The descriptors of flat PVT regions must be plain old data");
+
+} // namespace Opm
+
+#endif
@@ -31,6 +31,9 @@
 #include "WetGasPvt.hpp"
 #include "GasPvtThermal.hpp"
 
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+
 #if HAVE_OPM_PARSER
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -38,6 +41,8 @@
 #include <opm/parser/eclipse/Deck/DeckRecord.hpp>
 #endif
 
+#include <cstdint>
+
 namespace Opm {
 #define OPM_GAS_PVT_MULTIPLEXER_CALL(codeToCall)                        \
     switch (gasPvtApproach_) {                                          \
@@ -165,6 +170,63 @@ public:
     unsigned numRegions() const
     { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.numRegions()); return 1; }
 
+    /*!
+     * \brief Returns the memory used by the multiplexer and by the PVT object of the
+     *        selected approach.
+     */
+    MemoryUsage memoryUsage() const
+    {
+        MemoryUsage usage;
+        usage.add("multiplexer params", sizeof(*this));
+        if (gasPvtApproach_ != NoGasPvt) {
+            OPM_GAS_PVT_MULTIPLEXER_CALL(usage.add("multiplexer params", sizeof(pvtImpl));
+                                         pvtImpl.addMemoryUsage(usage));
+        }
+        return usage;
+    }
+
+    /*!
+     * \brief Write the selected approach and the parameters of its PVT object to a
+     *        binary blob.
+     *
+     * The blob can be used to initialize a multiplexer without processing the deck
+     * using deserialize().
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(static_cast<std::uint32_t>(sizeof(Scalar)));
+        writer.write(static_cast<std::int32_t>(gasPvtApproach_));
+        if (gasPvtApproach_ != NoGasPvt)
+            OPM_GAS_PVT_MULTIPLEXER_CALL(pvtImpl.serialize(writer));
+    }
+
+    /*!
+     * \brief Restore a multiplexer which was written by serialize().
+     *
+     * The multiplexer must not have been initialized before.
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        if (gasPvtApproach_ != NoGasPvt)
+            OPM_THROW(std::logic_error, "Cannot deserialize into an initialized gas PVT object");
+
+        std::uint32_t scalarSize;
+        reader.read(scalarSize);
+        if (scalarSize != sizeof(Scalar))
+            OPM_THROW(std::runtime_error,
+                      "The serialized gas PVT object uses a different scalar type");
+
+        std::int32_t appr;
+        reader.read(appr);
+        if (appr < NoGasPvt || appr > ThermalGasPvt)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: invalid gas PVT approach " << appr);
+        if (appr == NoGasPvt)
+            return;
+
+        setApproach(static_cast<GasPvtApproach>(appr));
+        OPM_GAS_PVT_MULTIPLEXER_CALL(pvtImpl.deserialize(reader));
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -194,6 +256,34 @@ public:
                                             const Evaluation& Rv) const
     { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rv)); return 0; }
 
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the gas phase at once.
+     *
+     * For the wet gas and the thermal PVT relations, this evaluates each table only
+     * once. The other approaches simply compute both quantities individually.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& temperature,
+                                                  const Evaluation& pressure,
+                                                  const Evaluation& Rv,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    { OPM_GAS_PVT_MULTIPLEXER_CALL(invBAndViscosity_(pvtImpl, regionIdx, temperature, pressure, Rv, invB, mu)); }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of oil-saturated gas at once.
+     */
+    template <class Evaluation>
+    void saturatedInverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                           const Evaluation& temperature,
+                                                           const Evaluation& pressure,
+                                                           Evaluation& invB,
+                                                           Evaluation& mu) const
+    { OPM_GAS_PVT_MULTIPLEXER_CALL(saturatedInvBAndViscosity_(pvtImpl, regionIdx, temperature, pressure, invB, mu)); }
+
     /*!
      * \brief Returns the formation volume factor [-] of oil saturated gas given a set of parameters.
      */
@@ -289,6 +379,69 @@ public:
     }
 
 private:
+    template <class Pvt, class Evaluation>
+    static void invBAndViscosity_(const Pvt& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  const Evaluation& Rv,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    {
+        invB = pvt.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rv);
+        mu = pvt.viscosity(regionIdx, temperature, pressure, Rv);
+    }
+
+    template <class Evaluation>
+    static void invBAndViscosity_(const Opm::GasPvtThermal<Scalar>& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  const Evaluation& Rv,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    { pvt.inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, Rv, invB, mu); }
+
+    template <class Evaluation>
+    static void invBAndViscosity_(const Opm::WetGasPvt<Scalar>& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  const Evaluation& Rv,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    { pvt.inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, Rv, invB, mu); }
+
+    template <class Pvt, class Evaluation>
+    static void saturatedInvBAndViscosity_(const Pvt& pvt,
+                                           unsigned regionIdx,
+                                           const Evaluation& temperature,
+                                           const Evaluation& pressure,
+                                           Evaluation& invB,
+                                           Evaluation& mu)
+    {
+        invB = pvt.saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure);
+        mu = pvt.saturatedViscosity(regionIdx, temperature, pressure);
+    }
+
+    template <class Evaluation>
+    static void saturatedInvBAndViscosity_(const Opm::GasPvtThermal<Scalar>& pvt,
+                                           unsigned regionIdx,
+                                           const Evaluation& temperature,
+                                           const Evaluation& pressure,
+                                           Evaluation& invB,
+                                           Evaluation& mu)
+    { pvt.saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu); }
+
+    template <class Evaluation>
+    static void saturatedInvBAndViscosity_(const Opm::WetGasPvt<Scalar>& pvt,
+                                           unsigned regionIdx,
+                                           const Evaluation& temperature,
+                                           const Evaluation& pressure,
+                                           Evaluation& invB,
+                                           Evaluation& mu)
+    { pvt.saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu); }
+
     GasPvtApproach gasPvtApproach_;
     void* realGasPvt_;
 };
@@ -297,4 +450,28 @@ private:
 
 } // namespace Opm
 
+// the instantiations which are part of the library of precompiled instantiations (see
+// opm/material/common/PrecompiledInstantiations.hpp)
+#include <opm/material/common/PrecompiledInstantiations.hpp>
+
+#define OPM_MATERIAL_INSTANTIATE_GAS_PVT_MULTIPLEXER_(PREFIX, Evaluation) \
+    PREFIX template Evaluation GasPvtMultiplexer<double>::viscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation GasPvtMultiplexer<double>::saturatedViscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation GasPvtMultiplexer<double>::inverseFormationVolumeFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&, const Evaluation&) const; \
+    PREFIX template void GasPvtMultiplexer<double>::inverseFormationVolumeFactorAndViscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&, const Evaluation&, Evaluation&, Evaluation&) const; \
+    PREFIX template void GasPvtMultiplexer<double>::saturatedInverseFormationVolumeFactorAndViscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&, Evaluation&, Evaluation&) const; \
+    PREFIX template Evaluation GasPvtMultiplexer<double>::saturatedInverseFormationVolumeFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation GasPvtMultiplexer<double>::saturatedOilVaporizationFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation GasPvtMultiplexer<double>::saturatedOilVaporizationFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&, const Evaluation&, double) const; \
+    PREFIX template Evaluation GasPvtMultiplexer<double>::saturationPressure<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const;
+
+#if OPM_MATERIAL_EXTERN_TEMPLATES
+#include <opm/material/densead/Evaluation.hpp>
+
+namespace Opm {
+extern template class GasPvtMultiplexer<double>;
+OPM_MATERIAL_FOR_EACH_PRECOMPILED_EVALUATION(OPM_MATERIAL_INSTANTIATE_GAS_PVT_MULTIPLEXER_, extern)
+} // namespace Opm
+#endif
+
 #endif
@@ -32,6 +32,8 @@
 #include <opm/material/common/OpmFinal.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
 #include <opm/material/common/Spline.hpp>
 
 #if HAVE_OPM_PARSER
@@ -58,6 +60,14 @@ class GasPvtThermal
     typedef GasPvtMultiplexer<Scalar, /*enableThermal=*/false> IsothermalPvt;
 
 public:
+    GasPvtThermal()
+        : isothermalPvt_(nullptr)
+        , refTemp_(0.0)
+        , invRefTemp_(0.0)
+        , enableThermalDensity_(false)
+        , enableThermalViscosity_(false)
+    {}
+
     ~GasPvtThermal()
     { delete isothermalPvt_; }
 
@@ -92,8 +102,8 @@ public:
             std::string gasvisctColumnName = "Viscosity"+std::to_string(static_cast<long long>(gasCompIdx));
 
             for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
-                const auto& T = gasvisctTables[regionIdx].getColumn("Temperature").vectorCopy();
-                const auto& mu = gasvisctTables[regionIdx].getColumn(gasvisctColumnName).vectorCopy();
+                const auto& T = gasvisctTables[regionIdx].getColumn("Temperature");
+                const auto& mu = gasvisctTables[regionIdx].getColumn(gasvisctColumnName);
                 gasvisctCurves_[regionIdx].setXYContainers(T, mu);
             }
         }
@@ -104,6 +114,8 @@ public:
         if (enableThermalDensity_) {
             refTemp_ = deck.getKeyword("TREF").getRecord(0).getItem("TEMPERATURE").getSIDouble(0);
         }
+
+        initEnd();
     }
 #endif // HAVE_OPM_PARSER
 
@@ -115,13 +127,62 @@ public:
 
     /*!
      * \brief Finish initializing the thermal part of the gas phase PVT properties.
+     *
+     * This computes the temperature independent part of the density correction, so that
+     * it is not re-evaluated by every call.
      */
     void initEnd()
-    { }
+    { invRefTemp_ = 1.0/refTemp_; }
 
     size_t numRegions() const
     { return gasvisctCurves_.size(); }
 
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     *
+     * This includes the memory used by the isothermal PVT object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("tables",
+                    tableVectorMemoryUsage(gasvisctCurves_));
+        if (isothermalPvt_)
+            usage.add(isothermalPvt_->memoryUsage());
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     *
+     * This includes the parameters of the isothermal PVT object.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        if (!isothermalPvt_)
+            OPM_THROW(std::logic_error, "Cannot serialize uninitialized thermal PVT object");
+
+        isothermalPvt_->serialize(writer);
+        writer.writeObjects(gasvisctCurves_);
+        writer.write(refTemp_);
+        writer.write(enableThermalDensity_);
+        writer.write(enableThermalViscosity_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        delete isothermalPvt_;
+        isothermalPvt_ = new IsothermalPvt;
+        isothermalPvt_->deserialize(reader);
+        reader.readObjects(gasvisctCurves_);
+        reader.read(refTemp_);
+        reader.read(enableThermalDensity_);
+        reader.read(enableThermalViscosity_);
+
+        initEnd();
+    }
+
     /*!
      * \brief Returns true iff the density of the gas phase is temperature dependent.
      */
@@ -181,11 +242,7 @@ public:
         if (!enableThermalDensity())
             return b;
 
-        // the Eclipse TD/RM do not explicitly specify the relation of the gas
-        // density and the temperature, but equation (69.49) (for Eclipse 2011.1)
-        // implies that the temperature dependence of the gas phase is rho(T, p) =
-        // rho(tref_, p)*T/T_ref ...
-        return b*temperature/refTemp_;
+        return densityFactor_(temperature)*b;
     }
 
     /*!
@@ -201,11 +258,57 @@ public:
         if (!enableThermalDensity())
             return b;
 
-        // the Eclipse TD/RM do not explicitly specify the relation of the gas
-        // density and the temperature, but equation (69.49) (for Eclipse 2011.1)
-        // implies that the temperature dependence of the gas phase is rho(T, p) =
-        // rho(tref_, p)*T/T_ref ...
-        return b*temperature/refTemp_;
+        return densityFactor_(temperature)*b;
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the gas phase at once.
+     *
+     * The results are the same as the ones of inverseFormationVolumeFactor() and
+     * viscosity(), but each table of the isothermal and the thermal PVT relations is
+     * evaluated only once and the isothermal viscosity is not evaluated at all if it is
+     * replaced by the GASVISCT curve.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& temperature,
+                                                  const Evaluation& pressure,
+                                                  const Evaluation& Rv,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    {
+        if (enableThermalViscosity()) {
+            invB = isothermalPvt_->inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rv);
+            mu = gasvisctCurves_[regionIdx].eval(temperature);
+        }
+        else
+            isothermalPvt_->inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, Rv, invB, mu);
+
+        if (enableThermalDensity())
+            invB *= densityFactor_(temperature);
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the oil-saturated gas phase at once.
+     */
+    template <class Evaluation>
+    void saturatedInverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                           const Evaluation& temperature,
+                                                           const Evaluation& pressure,
+                                                           Evaluation& invB,
+                                                           Evaluation& mu) const
+    {
+        if (enableThermalViscosity()) {
+            invB = isothermalPvt_->saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure);
+            mu = gasvisctCurves_[regionIdx].eval(temperature);
+        }
+        else
+            isothermalPvt_->saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu);
+
+        if (enableThermalDensity())
+            invB *= densityFactor_(temperature);
     }
 
     /*!
@@ -250,6 +353,14 @@ public:
     { return isothermalPvt_->saturationPressure(regionIdx, temperature, pressure); }
 
 private:
+    // the Eclipse TD/RM do not explicitly specify the relation of the gas
+    // density and the temperature, but equation (69.49) (for Eclipse 2011.1)
+    // implies that the temperature dependence of the gas phase is rho(T, p) =
+    // rho(tref_, p)*T/T_ref ...
+    template <class Evaluation>
+    Evaluation densityFactor_(const Evaluation& temperature) const
+    { return temperature*invRefTemp_; }
+
     IsothermalPvt* isothermalPvt_;
 
     // The PVT properties needed for temperature dependence of the viscosity. We need
@@ -261,6 +372,9 @@ private:
     // expansion coefficient of the first EOS...
     Scalar refTemp_;
 
+    // the inverse of refTemp_. this is not serialized but computed by initEnd()
+    Scalar invRefTemp_;
+
     bool enableThermalDensity_;
     bool enableThermalViscosity_;
 };
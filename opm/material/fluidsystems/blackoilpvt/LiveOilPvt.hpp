@@ -31,7 +31,16 @@
 
 #include <opm/material/common/OpmFinal.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
+#include <opm/material/common/UniformXTabulated2DMultiFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/Tracing.hpp>
+#include <opm/material/common/TableSimplification.hpp>
+#include <opm/material/common/TableDeduplication.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/FlatBlackOilPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/EclPvtRegionUsage.hpp>
 
 #if HAVE_OPM_PARSER
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -49,6 +58,7 @@ template <class Scalar>
 class LiveOilPvt
 {
     typedef Opm::UniformXTabulated2DFunction<Scalar> TabulatedTwoDFunction;
+    typedef Opm::UniformXTabulated2DMultiFunction<Scalar, 2> TabulatedTwoDMultiFunction;
     typedef Opm::Tabulated1DFunction<Scalar> TabulatedOneDFunction;
     typedef std::vector<std::pair<Scalar, Scalar> > SamplingPoints;
 
@@ -56,6 +66,7 @@ public:
     LiveOilPvt()
     {
         vapPar2_ = 0.0;
+        tableSimplificationTolerance_ = 0.0;
     }
 
 #if HAVE_OPM_PARSER
@@ -72,6 +83,9 @@ public:
         size_t numRegions = pvtoTables.size();
         setNumRegions(numRegions);
 
+        // the derived tables are only computed for the regions which contain cells
+        regionIsUsed_ = eclUsedPvtRegions(eclState, numRegions);
+
         for (unsigned regionIdx = 0; regionIdx < numRegions; ++ regionIdx) {
             Scalar rhoRefO = densityKeyword.getRecord(regionIdx).getItem("OIL").getSIDouble(0);
             Scalar rhoRefG = densityKeyword.getRecord(regionIdx).getItem("GAS").getSIDouble(0);
@@ -82,6 +96,9 @@ public:
 
         // initialize the internal table objects
         for (unsigned regionIdx = 0; regionIdx < numRegions; ++ regionIdx) {
+            if (!regionIsUsed_[regionIdx])
+                continue;
+
             const auto& pvtoTable = pvtoTables[regionIdx];
 
             const auto& saturatedTable = pvtoTable.getSaturatedTable();
@@ -94,6 +111,15 @@ public:
             auto& gasDissolutionFac = saturatedGasDissolutionFactorTable_[regionIdx];
             std::vector<Scalar> invSatOilBArray;
             std::vector<Scalar> satOilMuArray;
+            invSatOilBArray.reserve(saturatedTable.numRows());
+            satOilMuArray.reserve(saturatedTable.numRows());
+
+            // allocate the memory of the two-dimensional tables only once
+            size_t numSamplePoints = 0;
+            for (unsigned outerIdx = 0; outerIdx < saturatedTable.numRows(); ++ outerIdx)
+                numSamplePoints += pvtoTable.getUnderSaturatedTable(outerIdx).numRows();
+            invOilB.reserve(saturatedTable.numRows(), numSamplePoints);
+            oilMu.reserve(saturatedTable.numRows(), numSamplePoints);
 
             // extract the table for the gas dissolution and the oil formation volume factors
             for (unsigned outerIdx = 0; outerIdx < saturatedTable.numRows(); ++ outerIdx) {
@@ -236,15 +262,46 @@ public:
         oilReferenceDensity_.resize(numRegions);
         gasReferenceDensity_.resize(numRegions);
         inverseOilBTable_.resize(numRegions);
-        inverseOilBMuTable_.resize(numRegions);
+        inverseOilBAndBMuTable_.resize(numRegions);
         inverseSaturatedOilBTable_.resize(numRegions);
         inverseSaturatedOilBMuTable_.resize(numRegions);
         oilMuTable_.resize(numRegions);
         saturatedOilMuTable_.resize(numRegions);
         saturatedGasDissolutionFactorTable_.resize(numRegions);
         saturationPressure_.resize(numRegions);
+        saturationPressureIsExact_.resize(numRegions, false);
+        regionIsUsed_.assign(numRegions, true);
+        tableSimplificationStats_.resize(numRegions);
+        regionTableIdx_.resize(numRegions);
+        for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx)
+            regionTableIdx_[regionIdx] = regionIdx;
     }
 
+    /*!
+     * \brief Remove the sampling points of the tables which can be interpolated from
+     *        their neighbors at initEnd().
+     *
+     * Both, the columns for the individual gas dissolution factors and the pressures
+     * of the undersaturated branch of each column are considered. A sampling point is
+     * removed if the simplified tables deviate from the original ones by at most the
+     * tolerance relative to the range of values of the respective quantity. Since half
+     * of the tolerance is used for each direction, this bounds the total deviation at
+     * the original sampling points. The first and the last sampling point of each
+     * direction are always kept.
+     *
+     * By default, the tables are not simplified. A tolerance of zero disables the
+     * simplification.
+     */
+    void setTableSimplification(Scalar tolerance)
+    { tableSimplificationTolerance_ = tolerance; }
+
+    /*!
+     * \brief Return the number of sampling points of the tables of a PVT region before
+     *        and after they were simplified by initEnd().
+     */
+    const TableSimplificationStats& tableSimplificationStats(unsigned regionIdx) const
+    { return tableSimplificationStats_[regionTableIdx_[regionIdx]]; }
+
     /*!
      * \brief Initialize the reference densities of all fluids for a given PVT region
      */
@@ -355,12 +412,24 @@ public:
 
     /*!
      * \brief Finish initializing the oil phase PVT properties.
+     *
+     * PVT regions which specify the same tables as a previous region use the tables of
+     * that region.
      */
     void initEnd()
     {
+        shareIdenticalRegionTables_();
+
         // calculate the final 2D functions which are used for interpolation.
         size_t numRegions = oilMuTable_.size();
         for (unsigned regionIdx = 0; regionIdx < numRegions; ++ regionIdx) {
+            if (!regionIsUsed_[regionIdx] || regionTableIdx_[regionIdx] != regionIdx)
+                continue;
+
+            tableSimplificationStats_[regionIdx].clear();
+            if (tableSimplificationTolerance_ > 0.0)
+                simplifyTables_(regionIdx);
+
             // calculate the table which stores the inverse of the product of the oil
             // formation volume factor and the oil viscosity
             const auto& oilMu = oilMuTable_[regionIdx];
@@ -368,24 +437,36 @@ public:
             const auto& invOilB = inverseOilBTable_[regionIdx];
             assert(oilMu.numX() == invOilB.numX());
 
-            auto& invOilBMu = inverseOilBMuTable_[regionIdx];
+            auto& invOilBAndBMu = inverseOilBAndBMuTable_[regionIdx];
             auto& invSatOilB = inverseSaturatedOilBTable_[regionIdx];
             auto& invSatOilBMu = inverseSaturatedOilBMuTable_[regionIdx];
 
             std::vector<Scalar> satPressuresArray;
             std::vector<Scalar> invSatOilBArray;
             std::vector<Scalar> invSatOilBMuArray;
+            satPressuresArray.reserve(oilMu.numX());
+            invSatOilBArray.reserve(oilMu.numX());
+            invSatOilBMuArray.reserve(oilMu.numX());
+
+            size_t numSamplePoints = 0;
+            for (unsigned rsIdx = 0; rsIdx < oilMu.numX(); ++rsIdx)
+                numSamplePoints += oilMu.numY(rsIdx);
+            invOilBAndBMu.reserve(oilMu.numX(), numSamplePoints);
+
             for (unsigned rsIdx = 0; rsIdx < oilMu.numX(); ++rsIdx) {
-                invOilBMu.appendXPos(oilMu.xAt(rsIdx));
+                invOilBAndBMu.appendXPos(oilMu.xAt(rsIdx));
 
                 assert(oilMu.numY(rsIdx) == invOilB.numY(rsIdx));
 
+                // the table for the viscosity stores both, 1/B and 1/(B*mu), so that both
+                // quantities can be determined using a single lookup
                 size_t numPressures = oilMu.numY(rsIdx);
                 for (unsigned pIdx = 0; pIdx < numPressures; ++pIdx)
-                    invOilBMu.appendSamplePoint(rsIdx,
-                                                oilMu.yAt(rsIdx, pIdx),
-                                                invOilB.valueAt(rsIdx, pIdx)
-                                                / oilMu.valueAt(rsIdx, pIdx));
+                    invOilBAndBMu.appendSamplePoint(rsIdx,
+                                                    oilMu.yAt(rsIdx, pIdx),
+                                                    {{ invOilB.valueAt(rsIdx, pIdx),
+                                                       invOilB.valueAt(rsIdx, pIdx)
+                                                       / oilMu.valueAt(rsIdx, pIdx) }});
 
                 // the sampling points in UniformXTabulated2DFunction are always sorted
                 // in ascending order. Thus, the value for saturated oil is the first one
@@ -396,9 +477,10 @@ public:
             }
 
             invSatOilB.setXYContainers(satPressuresArray, invSatOilBArray);
-            invSatOilBMu.setXYContainers(satPressuresArray, invSatOilBMuArray);
+            invSatOilBMu.setXYContainers(std::move(satPressuresArray), std::move(invSatOilBMuArray));
 
             updateSaturationPressure_(regionIdx);
+            setProfileNames_(regionIdx);
         }
     }
 
@@ -406,7 +488,135 @@ public:
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
     unsigned numRegions() const
-    { return inverseOilBMuTable_.size(); }
+    { return inverseOilBAndBMuTable_.size(); }
+
+    /*!
+     * \brief Return the index of the PVT region whose tables are used by a region.
+     *
+     * This is the index of the region itself unless its tables are identical to the ones
+     * of a previous region.
+     */
+    unsigned tableRegionIndex(unsigned regionIdx) const
+    { return regionTableIdx_[regionIdx]; }
+
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(gasReferenceDensity_)
+                  + vectorMemoryUsage(oilReferenceDensity_)
+                  + vectorMemoryUsage(saturationPressureIsExact_)
+                  + vectorMemoryUsage(regionIsUsed_)
+                  + vectorMemoryUsage(regionTableIdx_));
+        usage.add("tables",
+                    tableVectorMemoryUsage(inverseOilBTable_)
+                  + tableVectorMemoryUsage(oilMuTable_)
+                  + tableVectorMemoryUsage(inverseOilBAndBMuTable_)
+                  + tableVectorMemoryUsage(saturatedOilMuTable_)
+                  + tableVectorMemoryUsage(inverseSaturatedOilBTable_)
+                  + tableVectorMemoryUsage(inverseSaturatedOilBMuTable_)
+                  + tableVectorMemoryUsage(saturatedGasDissolutionFactorTable_)
+                  + tableVectorMemoryUsage(saturationPressure_));
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(gasReferenceDensity_);
+        writer.write(oilReferenceDensity_);
+        writer.writeObjects(inverseOilBTable_);
+        writer.writeObjects(oilMuTable_);
+        writer.writeObjects(inverseOilBAndBMuTable_);
+        writer.writeObjects(saturatedOilMuTable_);
+        writer.writeObjects(inverseSaturatedOilBTable_);
+        writer.writeObjects(inverseSaturatedOilBMuTable_);
+        writer.writeObjects(saturatedGasDissolutionFactorTable_);
+        writer.writeObjects(saturationPressure_);
+        writer.write(saturationPressureIsExact_);
+        writer.write(regionIsUsed_);
+        writer.write(regionTableIdx_);
+        writer.write(vapPar2_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(gasReferenceDensity_);
+        reader.read(oilReferenceDensity_);
+        reader.readObjects(inverseOilBTable_);
+        reader.readObjects(oilMuTable_);
+        reader.readObjects(inverseOilBAndBMuTable_);
+        reader.readObjects(saturatedOilMuTable_);
+        reader.readObjects(inverseSaturatedOilBTable_);
+        reader.readObjects(inverseSaturatedOilBMuTable_);
+        reader.readObjects(saturatedGasDissolutionFactorTable_);
+        reader.readObjects(saturationPressure_);
+        reader.read(saturationPressureIsExact_);
+        reader.read(regionIsUsed_);
+        reader.read(regionTableIdx_);
+        reader.read(vapPar2_);
+
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx)
+            setProfileNames_(regionIdx);
+    }
+
+    /*!
+     * \brief Append the tables to a flat table buffer and return the descriptors of
+     *        all PVT regions.
+     *
+     * The descriptors of regions which are not used are zero.
+     */
+    template <class FlatScalar>
+    std::vector<FlatLiveOilPvtRegion<FlatScalar> > exportFlat(FlatTableBuffer<FlatScalar>& buffer) const
+    {
+        std::vector<FlatLiveOilPvtRegion<FlatScalar> > result(numRegions(), FlatLiveOilPvtRegion<FlatScalar>());
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            if (!regionIsUsed_[regionIdx])
+                continue;
+
+            auto& region = result[regionIdx];
+            unsigned tableIdx = regionTableIdx_[regionIdx];
+            if (tableIdx != regionIdx) {
+                // the tables are shared with a previous region
+                region = result[tableIdx];
+                region.oilReferenceDensity = static_cast<FlatScalar>(oilReferenceDensity_[regionIdx]);
+                continue;
+            }
+
+            region.oilReferenceDensity = static_cast<FlatScalar>(oilReferenceDensity_[regionIdx]);
+            region.inverseOilBTable = inverseOilBTable_[regionIdx].exportFlat(buffer);
+            region.inverseOilBAndBMuTable = inverseOilBAndBMuTable_[regionIdx].exportFlat(buffer);
+            region.inverseSaturatedOilBTable = inverseSaturatedOilBTable_[regionIdx].exportFlat(buffer);
+            region.inverseSaturatedOilBMuTable = inverseSaturatedOilBMuTable_[regionIdx].exportFlat(buffer);
+            region.saturatedGasDissolutionFactorTable =
+                saturatedGasDissolutionFactorTable_[regionIdx].exportFlat(buffer);
+        }
+        return result;
+    }
+
+    /*!
+     * \brief Returns whether the tables of a PVT region are computed.
+     *
+     * By default, all regions are used. When initializing from a deck, only the regions
+     * which are referenced by the PVTNUM grid property are considered. The quantities
+     * of unused regions must not be evaluated.
+     */
+    bool regionIsUsed(unsigned regionIdx) const
+    { return regionIsUsed_[regionIdx]; }
+
+    /*!
+     * \brief Specify whether the tables of a PVT region should be computed.
+     *
+     * This must be called after setNumRegions() and before initEnd().
+     */
+    void setRegionIsUsed(unsigned regionIdx, bool yesno)
+    { regionIsUsed_[regionIdx] = yesno; }
 
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
@@ -417,11 +627,13 @@ public:
                          const Evaluation& pressure,
                          const Evaluation& Rs) const
     {
+        OPM_MATERIAL_TRACE_SCOPE("LiveOilPvt::viscosity");
+
         // ATTENTION: Rs is the first axis!
-        const Evaluation& invBo = inverseOilBTable_[regionIdx].eval(Rs, pressure, /*extrapolate=*/true);
-        const Evaluation& invMuoBo = inverseOilBMuTable_[regionIdx].eval(Rs, pressure, /*extrapolate=*/true);
+        std::array<Evaluation, 2> invBoAndInvMuoBo;
+        inverseOilBAndBMuTable_[regionTableIdx_[regionIdx]].eval(Rs, pressure, invBoAndInvMuoBo, /*extrapolate=*/true);
 
-        return invBo/invMuoBo;
+        return invBoAndInvMuoBo[0]/invBoAndInvMuoBo[1];
     }
 
     /*!
@@ -432,9 +644,13 @@ public:
                                   const Evaluation& /*temperature*/,
                                   const Evaluation& pressure) const
     {
-        // ATTENTION: Rs is the first axis!
-        const Evaluation& invBo = inverseSaturatedOilBTable_[regionIdx].eval(pressure, /*extrapolate=*/true);
-        const Evaluation& invMuoBo = inverseSaturatedOilBMuTable_[regionIdx].eval(pressure, /*extrapolate=*/true);
+        OPM_MATERIAL_TRACE_SCOPE("LiveOilPvt::saturatedViscosity");
+
+        // both tables use the same sampling points, so the segment which was found
+        // for the first one is reused for the second
+        typename TabulatedOneDFunction::LookupHint hint;
+        const Evaluation& invBo = inverseSaturatedOilBTable_[regionTableIdx_[regionIdx]].eval(pressure, hint, /*extrapolate=*/true);
+        const Evaluation& invMuoBo = inverseSaturatedOilBMuTable_[regionTableIdx_[regionIdx]].eval(pressure, hint, /*extrapolate=*/true);
 
         return invBo/invMuoBo;
     }
@@ -448,8 +664,10 @@ public:
                                             const Evaluation& pressure,
                                             const Evaluation& Rs) const
     {
+        OPM_MATERIAL_TRACE_SCOPE("LiveOilPvt::inverseFormationVolumeFactor");
+
         // ATTENTION: Rs is represented by the _first_ axis!
-        return inverseOilBTable_[regionIdx].eval(Rs, pressure, /*extrapolate=*/true);
+        return inverseOilBTable_[regionTableIdx_[regionIdx]].eval(Rs, pressure, /*extrapolate=*/true);
     }
 
     /*!
@@ -460,8 +678,10 @@ public:
                                                      const Evaluation& /*temperature*/,
                                                      const Evaluation& pressure) const
     {
+        OPM_MATERIAL_TRACE_SCOPE("LiveOilPvt::saturatedInverseFormationVolumeFactor");
+
         // ATTENTION: Rs is represented by the _first_ axis!
-        return inverseSaturatedOilBTable_[regionIdx].eval(pressure, /*extrapolate=*/true);
+        return inverseSaturatedOilBTable_[regionTableIdx_[regionIdx]].eval(pressure, /*extrapolate=*/true);
     }
 
     /*!
@@ -471,7 +691,7 @@ public:
     Evaluation saturatedGasDissolutionFactor(unsigned regionIdx,
                                              const Evaluation& /*temperature*/,
                                              const Evaluation& pressure) const
-    { return saturatedGasDissolutionFactorTable_[regionIdx].eval(pressure, /*extrapolate=*/true); }
+    { return saturatedGasDissolutionFactorTable_[regionTableIdx_[regionIdx]].eval(pressure, /*extrapolate=*/true); }
 
     /*!
      * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of the oil phase.
@@ -488,7 +708,7 @@ public:
                                              Scalar maxOilSaturation) const
     {
         Evaluation tmp =
-            saturatedGasDissolutionFactorTable_[regionIdx].eval(pressure, /*extrapolate=*/true);
+            saturatedGasDissolutionFactorTable_[regionTableIdx_[regionIdx]].eval(pressure, /*extrapolate=*/true);
 
         // apply the vaporization parameters for the gas phase (cf. the Eclipse VAPPARS
         // keyword)
@@ -513,19 +733,35 @@ public:
                                   const Evaluation& temperature OPM_UNUSED,
                                   const Evaluation& Rs) const
     {
+        OPM_MATERIAL_TRACE_SCOPE("LiveOilPvt::saturationPressure");
+
         typedef Opm::MathToolbox<Evaluation> Toolbox;
 
-        const auto& RsTable = saturatedGasDissolutionFactorTable_[regionIdx];
+        OPM_MATERIAL_COUNT(liveOilSaturationPressure);
+        OPM_MATERIAL_TIME_SCOPE(liveOilSaturationPressureTimer);
+
+        if (saturationPressureIsExact_[regionTableIdx_[regionIdx]]) {
+            // the tabulated function is the exact inverse of the Rs table, so a
+            // single lookup is sufficient
+            const Evaluation& pSat = saturationPressure_[regionTableIdx_[regionIdx]].eval(Rs, /*extrapolate=*/true);
+            if (pSat < 0.0)
+                return 0.0;
+            return pSat;
+        }
+
+        const auto& RsTable = saturatedGasDissolutionFactorTable_[regionTableIdx_[regionIdx]];
         const Scalar eps = std::numeric_limits<typename Toolbox::Scalar>::epsilon()*1e6;
 
         // use the saturation pressure function to get a pretty good initial value
-        Evaluation pSat = saturationPressure_[regionIdx].eval(Rs, /*extrapolate=*/true);
+        Evaluation pSat = saturationPressure_[regionTableIdx_[regionIdx]].eval(Rs, /*extrapolate=*/true);
 
         // Newton method to do the remaining work. If the initial
         // value is good, this should only take two to three
         // iterations...
         bool onProbation = false;
         for (int i = 0; i < 20; ++i) {
+            OPM_MATERIAL_COUNT(liveOilSaturationPressureNewtonIteration);
+
             const Evaluation& f = RsTable.eval(pSat, /*extrapolate=*/true) - Rs;
             const Evaluation& fPrime = RsTable.evalDerivative(pSat, /*extrapolate=*/true);
 
@@ -562,11 +798,189 @@ public:
     }
 
 private:
+    // set the names under which the lookups of the tables of a region are reported if
+    // table profiling is enabled
+    void setProfileNames_(unsigned regionIdx)
+    {
+        const std::string prefix = "PVTO region " + std::to_string(regionIdx + 1) + " ";
+        inverseOilBTable_[regionIdx].setProfileName(prefix + "invB");
+        oilMuTable_[regionIdx].setProfileName(prefix + "mu");
+        inverseOilBAndBMuTable_[regionIdx].setProfileName(prefix + "invB and invBMu");
+        saturatedOilMuTable_[regionIdx].setProfileName(prefix + "saturated mu");
+        inverseSaturatedOilBTable_[regionIdx].setProfileName(prefix + "saturated invB");
+        inverseSaturatedOilBMuTable_[regionIdx].setProfileName(prefix + "saturated invBMu");
+        saturatedGasDissolutionFactorTable_[regionIdx].setProfileName(prefix + "Rs");
+        saturationPressure_[regionIdx].setProfileName(prefix + "pSat");
+    }
+
+    // remove the sampling points of the tables of a region which can be interpolated
+    // from their neighbors. this needs to happen before the derived tables are built.
+    // since these interpolate 1/B and 1/(B*mu), the deviations of these quantities are
+    // considered.
+    void simplifyTables_(unsigned regionIdx)
+    {
+        auto& invOilB = inverseOilBTable_[regionIdx];
+        auto& oilMu = oilMuTable_[regionIdx];
+        auto& satOilMu = saturatedOilMuTable_[regionIdx];
+        auto& gasDissolutionFac = saturatedGasDissolutionFactorTable_[regionIdx];
+
+        const size_t numRs = invOilB.numX();
+        assert(oilMu.numX() == numRs);
+        assert(satOilMu.numSamples() == numRs);
+
+        // the columns of the tables and the saturated quantities, which are the first
+        // sampling points of the columns
+        TabulatedTwoDFunction invOilBMu;
+        std::vector<std::vector<Scalar> > pressures(numRs);
+        std::vector<std::vector<Scalar> > invBValues(numRs);
+        std::vector<std::vector<Scalar> > invBMuValues(numRs);
+        std::vector<Scalar> allInvBValues;
+        std::vector<Scalar> allInvBMuValues;
+        std::vector<Scalar> pSat(numRs);
+        std::vector<Scalar> invSatB(numRs);
+        std::vector<Scalar> invSatBMu(numRs);
+        std::vector<Scalar> satMuPressures(numRs);
+        std::vector<Scalar> satMu(numRs);
+        size_t numSamplesBefore = 0;
+        for (unsigned rsIdx = 0; rsIdx < numRs; ++rsIdx) {
+            assert(oilMu.numY(rsIdx) == invOilB.numY(rsIdx));
+            invOilBMu.appendXPos(invOilB.xAt(rsIdx));
+            for (unsigned pIdx = 0; pIdx < invOilB.numY(rsIdx); ++pIdx) {
+                const Scalar p = invOilB.yAt(rsIdx, pIdx);
+                const Scalar invB = invOilB.valueAt(rsIdx, pIdx);
+                pressures[rsIdx].push_back(p);
+                invBValues[rsIdx].push_back(invB);
+                invBMuValues[rsIdx].push_back(invB/oilMu.valueAt(rsIdx, pIdx));
+                invOilBMu.appendSamplePoint(rsIdx, p, invBMuValues[rsIdx].back());
+            }
+            numSamplesBefore += pressures[rsIdx].size();
+            allInvBValues.insert(allInvBValues.end(), invBValues[rsIdx].begin(), invBValues[rsIdx].end());
+            allInvBMuValues.insert(allInvBMuValues.end(), invBMuValues[rsIdx].begin(), invBMuValues[rsIdx].end());
+
+            pSat[rsIdx] = pressures[rsIdx].front();
+            invSatB[rsIdx] = invBValues[rsIdx].front();
+            invSatBMu[rsIdx] = invSatB[rsIdx]/satOilMu.valueAt(rsIdx);
+            satMuPressures[rsIdx] = satOilMu.xAt(rsIdx);
+            satMu[rsIdx] = satOilMu.valueAt(rsIdx);
+        }
+
+        // the gas dissolution factor of saturated oil usually uses the same sampling
+        // points. if it does not, it is kept as is.
+        const bool simplifyRs = gasDissolutionFac.numSamples() == numRs;
+        std::vector<Scalar> RsPressures;
+        std::vector<Scalar> RsValues;
+        for (size_t sampleIdx = 0; simplifyRs && sampleIdx < numRs; ++sampleIdx) {
+            RsPressures.push_back(gasDissolutionFac.xAt(sampleIdx));
+            RsValues.push_back(gasDissolutionFac.valueAt(sampleIdx));
+        }
+
+        const Scalar invBTol = tableSimplificationTolerance_/2*valueRange(allInvBValues);
+        const Scalar invBMuTol = tableSimplificationTolerance_/2*valueRange(allInvBMuValues);
+        const Scalar RsTol = tableSimplificationTolerance_/2*valueRange(RsValues);
+
+        std::vector<bool> isRequiredColumn =
+            findRequiredSamples(numRs, [&](size_t lowerIdx, size_t colIdx, size_t upperIdx) {
+                    return canSkipTableColumn(invOilB, lowerIdx, colIdx, upperIdx, invBTol)
+                        && canSkipTableColumn(invOilBMu, lowerIdx, colIdx, upperIdx, invBMuTol)
+                        && isNearlyCollinear(pSat, invSatB, lowerIdx, colIdx, upperIdx, invBTol)
+                        && isNearlyCollinear(pSat, invSatBMu, lowerIdx, colIdx, upperIdx, invBMuTol)
+                        && (!simplifyRs
+                            || isNearlyCollinear(RsPressures, RsValues, lowerIdx, colIdx, upperIdx, RsTol));
+                });
+
+        std::vector<std::vector<bool> > isRequiredSample(numRs);
+        size_t numSamplesAfter = 0;
+        for (unsigned rsIdx = 0; rsIdx < numRs; ++rsIdx) {
+            if (!isRequiredColumn[rsIdx])
+                continue;
+
+            const auto& p = pressures[rsIdx];
+            const auto& invB = invBValues[rsIdx];
+            const auto& invBMu = invBMuValues[rsIdx];
+            isRequiredSample[rsIdx] =
+                findRequiredSamples(p.size(), [&](size_t lowerIdx, size_t sampleIdx, size_t upperIdx) {
+                        return isNearlyCollinear(p, invB, lowerIdx, sampleIdx, upperIdx, invBTol)
+                            && isNearlyCollinear(p, invBMu, lowerIdx, sampleIdx, upperIdx, invBMuTol);
+                    });
+            numSamplesAfter += std::count(isRequiredSample[rsIdx].begin(), isRequiredSample[rsIdx].end(), true);
+        }
+
+        invOilB = selectTableSamples(invOilB, isRequiredColumn, isRequiredSample);
+        oilMu = selectTableSamples(oilMu, isRequiredColumn, isRequiredSample);
+
+        selectSamples(satMuPressures, isRequiredColumn);
+        selectSamples(satMu, isRequiredColumn);
+        satOilMu.setXYContainers(satMuPressures, satMu);
+
+        if (simplifyRs) {
+            selectSamples(RsPressures, isRequiredColumn);
+            selectSamples(RsValues, isRequiredColumn);
+            gasDissolutionFac.setXYContainers(RsPressures, RsValues);
+        }
+
+        tableSimplificationStats_[regionIdx].add(numSamplesBefore, numSamplesAfter);
+    }
+
+    // let the regions whose tables are identical to the ones of a previous region use
+    // the tables of that region and release their own ones. regions which already use
+    // the tables of another region are compared using these tables.
+    void shareIdenticalRegionTables_()
+    {
+        const std::vector<unsigned>& sourceIdx =
+            findIdenticalEntries(numRegions(), [this](BinaryWriter& writer, unsigned regionIdx) {
+                    unsigned tableIdx = regionTableIdx_[regionIdx];
+                    writer.write(static_cast<std::uint8_t>(regionIsUsed_[regionIdx]));
+                    inverseOilBTable_[tableIdx].serialize(writer);
+                    oilMuTable_[tableIdx].serialize(writer);
+                    saturatedOilMuTable_[tableIdx].serialize(writer);
+                    saturatedGasDissolutionFactorTable_[tableIdx].serialize(writer);
+                });
+
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            regionTableIdx_[regionIdx] = sourceIdx[regionIdx];
+            if (sourceIdx[regionIdx] == regionIdx)
+                continue;
+
+            inverseOilBTable_[regionIdx] = TabulatedTwoDFunction();
+            oilMuTable_[regionIdx] = TabulatedTwoDFunction();
+            inverseOilBAndBMuTable_[regionIdx] = TabulatedTwoDMultiFunction();
+            saturatedOilMuTable_[regionIdx] = TabulatedOneDFunction();
+            inverseSaturatedOilBTable_[regionIdx] = TabulatedOneDFunction();
+            inverseSaturatedOilBMuTable_[regionIdx] = TabulatedOneDFunction();
+            saturatedGasDissolutionFactorTable_[regionIdx] = TabulatedOneDFunction();
+            saturationPressure_[regionIdx] = TabulatedOneDFunction();
+        }
+    }
+
     void updateSaturationPressure_(unsigned regionIdx)
     {
         typedef std::pair<Scalar, Scalar> Pair;
         const auto& gasDissolutionFac = saturatedGasDissolutionFactorTable_[regionIdx];
 
+        // if Rs is strictly increasing with pressure, the inverse of the piecewise linear
+        // function Rs(p) is the piecewise linear function which uses the same sampling
+        // points with swapped coordinates. (this also holds if the functions are linearly
+        // extrapolated.) in this case, the saturation pressure can be determined using
+        // a single table lookup instead of a Newton method.
+        size_t numSamples = gasDissolutionFac.numSamples();
+        bool isStrictlyIncreasing = numSamples > 1;
+        for (size_t i = 1; i < numSamples && isStrictlyIncreasing; ++i)
+            isStrictlyIncreasing = gasDissolutionFac.valueAt(i - 1) < gasDissolutionFac.valueAt(i);
+
+        saturationPressureIsExact_[regionIdx] = isStrictlyIncreasing;
+        if (isStrictlyIncreasing) {
+            std::vector<Scalar> RsValues(numSamples);
+            std::vector<Scalar> pValues(numSamples);
+            for (size_t i = 0; i < numSamples; ++i) {
+                RsValues[i] = gasDissolutionFac.valueAt(i);
+                pValues[i] = gasDissolutionFac.xAt(i);
+            }
+            saturationPressure_[regionIdx].setXYContainers(RsValues, pValues);
+            return;
+        }
+
+        // otherwise, tabulate an approximate inverse which is used as the initial
+        // value for the Newton method.
         // create the function representing saturation pressure depending of the mass
         // fraction in gas
         size_t n = gasDissolutionFac.numSamples();
@@ -596,14 +1010,20 @@ private:
     std::vector<Scalar> oilReferenceDensity_;
     std::vector<TabulatedTwoDFunction> inverseOilBTable_;
     std::vector<TabulatedTwoDFunction> oilMuTable_;
-    std::vector<TabulatedTwoDFunction> inverseOilBMuTable_;
+    std::vector<TabulatedTwoDMultiFunction> inverseOilBAndBMuTable_;
     std::vector<TabulatedOneDFunction> saturatedOilMuTable_;
     std::vector<TabulatedOneDFunction> inverseSaturatedOilBTable_;
     std::vector<TabulatedOneDFunction> inverseSaturatedOilBMuTable_;
     std::vector<TabulatedOneDFunction> saturatedGasDissolutionFactorTable_;
     std::vector<TabulatedOneDFunction> saturationPressure_;
+    std::vector<bool> saturationPressureIsExact_;
+    std::vector<bool> regionIsUsed_;
+    std::vector<TableSimplificationStats> tableSimplificationStats_;
+    // the index of the region whose tables are used by each region
+    std::vector<unsigned> regionTableIdx_;
 
     Scalar vapPar2_;
+    Scalar tableSimplificationTolerance_;
 };
 
 } // namespace Opm
@@ -0,0 +1,552 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::MemoizedPvt
+ */
+#ifndef OPM_MEMOIZED_PVT_HPP
+#define OPM_MEMOIZED_PVT_HPP
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <opm/common/Exceptions.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+namespace MemoizedPvtDetail {
+template <int... indices>
+struct IndexList
+{};
+
+template <int n, int... indices>
+struct MakeIndexList
+    : public MakeIndexList<n - 1, n - 1, indices...>
+{};
+
+template <int... indices>
+struct MakeIndexList<0, indices...>
+{
+    typedef IndexList<indices...> type;
+};
+
+// the unsigned integer type which has the same size as a floating point type
+template <class Scalar>
+struct ScalarBits;
+
+template <>
+struct ScalarBits<float>
+{ typedef std::uint32_t type; };
+
+template <>
+struct ScalarBits<double>
+{ typedef std::uint64_t type; };
+
+// used to evaluate an expression for each element of a parameter pack
+inline void expandPack(std::initializer_list<int>)
+{}
+} // namespace MemoizedPvtDetail
+
+// defines a method which looks up the result in the cache of the calling thread. on a
+// miss, the respective method of the wrapped PVT object is called using evaluations
+// which consider the derivatives with regard to the arguments, and the value and these
+// derivatives are stored. the derivatives of the caller are then obtained by the
+// chain rule.
+#define OPM_MEMOIZED_PVT_METHOD(methodName, methodId)                   \
+    template <class Evaluation, class... Args>                          \
+    Evaluation methodName(unsigned regionIdx,                           \
+                          const Evaluation& arg0,                       \
+                          const Args&... args) const                    \
+    {                                                                   \
+        if (!enabled_)                                                  \
+            return pvt_.methodName(regionIdx, arg0, args...);           \
+                                                                        \
+        typedef typename MemoizedPvtDetail::                            \
+            MakeIndexList<1 + sizeof...(Args)>::type Indices;           \
+        return methodName##Memoized_<Evaluation>(Indices(),             \
+                                                 regionIdx,             \
+                                                 arg0,                  \
+                                                 args...);              \
+    }                                                                   \
+                                                                        \
+    template <class Evaluation, int... indices, class... Args>          \
+    Evaluation methodName##Memoized_(MemoizedPvtDetail::                \
+                                     IndexList<indices...>,             \
+                                     unsigned regionIdx,                \
+                                     const Args&... args) const         \
+    {                                                                   \
+        static_assert(sizeof...(Args) <= maxArgs_,                      \
+                      "Too many arguments for the memoized PVT method"); \
+        Cache_* cache = threadCache_();                                 \
+        if (!cache)                                                     \
+            return pvt_.methodName(regionIdx, args...);                 \
+                                                                        \
+        const Scalar x[] = { Scalar(Opm::scalarValue(args))... };       \
+        bool isHit;                                                     \
+        Entry_& entry = cache->lookup(methodId, regionIdx, x, sizeof...(Args), quantizationMask_, isHit); \
+        if (!isHit) {                                                   \
+            typedef Opm::DenseAd::Evaluation<Scalar, sizeof...(Args)> SlopeEval; \
+            const SlopeEval& result =                                   \
+                pvt_.methodName(regionIdx,                              \
+                                SlopeEval::createVariable(x[indices], indices)...); \
+            entry.value = result.value();                               \
+            MemoizedPvtDetail::expandPack(                              \
+                { (entry.slope[indices] = result.derivative(indices), 0)... }); \
+        }                                                               \
+                                                                        \
+        Evaluation result = entry.value;                                \
+        MemoizedPvtDetail::expandPack(                                  \
+            { (result += entry.slope[indices]*(args - entry.x[indices]), 0)... }); \
+        return result;                                                  \
+    }
+
+/*!
+ * \brief Memoizes the relations of a black-oil PVT class using a cache per thread
+ *        which is keyed on the PVT region and the quantized arguments.
+ *
+ * In large aquifers or gas caps, many cells of a PVT region exhibit almost the same
+ * pressure, dissolution factor and temperature. This class wraps a PVT class or
+ * multiplexer, e.g., Opm::OilPvtMultiplexer or Opm::GasPvtMultiplexer, and remembers
+ * the value of each property together with its derivatives with regard to the
+ * arguments of the method. A subsequent call whose arguments fall into the same
+ * quantization bins is answered by the first order Taylor expansion around the
+ * arguments of the stored evaluation, which also yields the derivatives of the
+ * result with regard to the caller's primary variables by the chain rule, e.g.
+ *
+ * \code
+ * Opm::MemoizedPvt<Opm::OilPvtMultiplexer<double> > oilPvt;
+ * oilPvt.pvt().initFromDeck(deck, eclState);
+ * oilPvt.pvt().initEnd();
+ * oilPvt.enable(1e-8);
+ *
+ * Evaluation invBo = oilPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rs);
+ * ...
+ * std::cout << "hit rate: " << oilPvt.statistics().hitRate() << "\n";
+ * \endcode
+ *
+ * The cache is disabled by default, in which case all calls are forwarded to the
+ * wrapped object. The arguments are quantized by dropping the least significant bits
+ * of their mantissa, so the arguments of a cache hit deviate from the ones of the
+ * stored evaluation by less than maxRelativeInputDeviation() relative to their
+ * magnitude. Since the result is extrapolated linearly, its error is of second order
+ * in this deviation within a segment of the tables. Only across a kink of the tables
+ * (e.g., at the saturation pressure), it is of first order, i.e., bounded by the jump
+ * of the derivatives times the deviation of the arguments. The cache is
+ * direct-mapped: each key can only be stored in a single slot, and a miss replaces
+ * the entry of this slot.
+ *
+ * Each OpenMP thread uses its own cache, so no synchronization is required. The
+ * number of caches is determined by enable() and threads beyond it bypass the caches.
+ * clear() must be called if the wrapped object is modified after enable(). The
+ * statistics are the sum over all threads and must not be retrieved while other
+ * threads evaluate properties.
+ *
+ * \tparam Pvt The PVT class which is wrapped
+ * \tparam Scalar The floating point type of the cached values
+ */
+template <class Pvt, class Scalar = double>
+class MemoizedPvt
+{
+    static const unsigned maxArgs_ = 3;
+
+    typedef typename MemoizedPvtDetail::ScalarBits<Scalar>::type Bits;
+
+    enum MethodId {
+        noMethod,
+        viscosityId,
+        saturatedViscosityId,
+        inverseFormationVolumeFactorId,
+        saturatedInverseFormationVolumeFactorId,
+        saturatedGasDissolutionFactorId,
+        saturatedOilVaporizationFactorId,
+        saturationPressureId
+    };
+
+    struct Entry_
+    {
+        Bits key[maxArgs_];
+        std::uint32_t regionIdx;
+        std::uint32_t methodId;
+
+        Scalar x[maxArgs_];
+        Scalar value;
+        Scalar slope[maxArgs_];
+    };
+
+    struct Cache_
+    {
+        Entry_& lookup(unsigned methodId,
+                       unsigned regionIdx,
+                       const Scalar* x,
+                       unsigned numArgs,
+                       Bits quantizationMask,
+                       bool& isHit)
+        {
+            Bits key[maxArgs_] = { 0 };
+            std::uint64_t hash = methodId*0x9e3779b97f4a7c15ULL ^ regionIdx;
+            for (unsigned argIdx = 0; argIdx < numArgs; ++argIdx) {
+                Bits bits;
+                std::memcpy(&bits, &x[argIdx], sizeof(bits));
+                key[argIdx] = bits & quantizationMask;
+                hash = (hash ^ key[argIdx])*0xff51afd7ed558ccdULL;
+                hash ^= hash >> 32;
+            }
+
+            Entry_& entry = entries[hash & (entries.size() - 1)];
+            isHit =
+                entry.methodId == methodId
+                && entry.regionIdx == regionIdx
+                && std::memcmp(entry.key, key, sizeof(key)) == 0;
+            if (isHit) {
+                ++hits;
+                return entry;
+            }
+
+            ++misses;
+            entry.methodId = methodId;
+            entry.regionIdx = regionIdx;
+            std::memcpy(entry.key, key, sizeof(key));
+            for (unsigned argIdx = 0; argIdx < numArgs; ++argIdx)
+                entry.x[argIdx] = x[argIdx];
+            return entry;
+        }
+
+        std::vector<Entry_> entries;
+        std::uint64_t hits;
+        std::uint64_t misses;
+
+        // prevents the counters of different threads from sharing a cache line
+        char padding[64];
+    };
+
+public:
+    typedef Pvt PvtType;
+
+    /*!
+     * \brief The number of lookups which were answered by the caches and the number
+     *        of lookups which required evaluating the wrapped PVT object.
+     */
+    struct Statistics
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+
+        double hitRate() const
+        {
+            if (hits + misses == 0)
+                return 0.0;
+            return static_cast<double>(hits)/static_cast<double>(hits + misses);
+        }
+    };
+
+    MemoizedPvt()
+        : enabled_(false)
+        , quantizationMask_(~Bits(0))
+        , maxRelativeInputDeviation_(0.0)
+    {}
+
+    explicit MemoizedPvt(Pvt pvt)
+        : pvt_(std::move(pvt))
+        , enabled_(false)
+        , quantizationMask_(~Bits(0))
+        , maxRelativeInputDeviation_(0.0)
+    {}
+
+    /*!
+     * \brief Returns the wrapped PVT object.
+     *
+     * If the object is modified while the caches are enabled, clear() must be called
+     * afterwards.
+     */
+    Pvt& pvt()
+    { return pvt_; }
+
+    /*!
+     * \brief Returns the wrapped PVT object.
+     */
+    const Pvt& pvt() const
+    { return pvt_; }
+
+    /*!
+     * \brief Return the number of PVT regions which are considered by this PVT-object.
+     */
+    unsigned numRegions() const
+    { return pvt_.numRegions(); }
+
+    /*!
+     * \brief Enable the caches.
+     *
+     * \param maxRelativeDeviation The maximum deviation of the arguments of a cache hit
+     *                             from the ones of the stored evaluation relative to
+     *                             their magnitude. The deviation which is actually
+     *                             permitted is the largest power of two which does not
+     *                             exceed this value, see maxRelativeInputDeviation(). If
+     *                             it is smaller than the machine epsilon, only
+     *                             evaluations for identical arguments are memoized.
+     * \param numEntries The number of entries of the cache of each thread. This must be
+     *                   a power of two.
+     */
+    void enable(Scalar maxRelativeDeviation = 1e-8, unsigned numEntries = 4096)
+    {
+        if (numEntries == 0 || (numEntries & (numEntries - 1)) != 0)
+            OPM_THROW(std::invalid_argument,
+                      "The number of cache entries must be a power of two (is "
+                      << numEntries << ")");
+        if (!(maxRelativeDeviation >= 0.0))
+            OPM_THROW(std::invalid_argument,
+                      "The maximum relative deviation of the arguments must not be negative");
+
+        // drop the bits of the mantissa which are below the permitted deviation
+        const int mantissaBits = std::numeric_limits<Scalar>::digits - 1;
+        int droppedBits = 0;
+        if (maxRelativeDeviation > 0.0) {
+            int exponent;
+            std::frexp(maxRelativeDeviation, &exponent);
+            droppedBits = std::max(0, std::min(mantissaBits, exponent - 1 + mantissaBits));
+        }
+        quantizationMask_ = ~((Bits(1) << droppedBits) - 1);
+        maxRelativeInputDeviation_ =
+            (droppedBits > 0) ? std::ldexp(Scalar(1.0), droppedBits - mantissaBits) : 0.0;
+
+        unsigned numThreads = 1;
+#ifdef _OPENMP
+        numThreads = static_cast<unsigned>(omp_get_max_threads());
+#endif
+        caches_.resize(numThreads);
+        for (auto& cache : caches_)
+            cache.entries.resize(numEntries);
+        enabled_ = true;
+        clear();
+        resetStatistics();
+    }
+
+    /*!
+     * \brief Disable the caches and release their memory.
+     */
+    void disable()
+    {
+        enabled_ = false;
+        caches_.clear();
+    }
+
+    /*!
+     * \brief Returns true if the properties are looked up in the caches.
+     */
+    bool isEnabled() const
+    { return enabled_; }
+
+    /*!
+     * \brief Returns the maximum deviation of the arguments of a cache hit from the
+     *        ones of the stored evaluation relative to their magnitude.
+     *
+     * This is zero if the caches are disabled or only identical arguments are
+     * memoized.
+     */
+    Scalar maxRelativeInputDeviation() const
+    { return enabled_ ? maxRelativeInputDeviation_ : 0.0; }
+
+    /*!
+     * \brief Forget the cached values of all threads.
+     */
+    void clear()
+    {
+        for (auto& cache : caches_)
+            for (auto& entry : cache.entries)
+                entry.methodId = noMethod;
+    }
+
+    /*!
+     * \brief Returns the number of hits and misses summed over all threads.
+     */
+    Statistics statistics() const
+    {
+        Statistics stats = { 0, 0 };
+        for (const auto& cache : caches_) {
+            stats.hits += cache.hits;
+            stats.misses += cache.misses;
+        }
+        return stats;
+    }
+
+    /*!
+     * \brief Set the number of hits and misses of all threads to zero.
+     */
+    void resetStatistics()
+    {
+        for (auto& cache : caches_) {
+            cache.hits = 0;
+            cache.misses = 0;
+        }
+    }
+
+    /*!
+     * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of
+     *        parameters.
+     */
+    OPM_MEMOIZED_PVT_METHOD(viscosity, viscosityId)
+
+    /*!
+     * \brief Returns the dynamic viscosity [Pa s] of the fluid phase at saturated
+     *        conditions.
+     */
+    OPM_MEMOIZED_PVT_METHOD(saturatedViscosity, saturatedViscosityId)
+
+    /*!
+     * \brief Returns the formation volume factor [-] of the fluid phase.
+     */
+    OPM_MEMOIZED_PVT_METHOD(inverseFormationVolumeFactor, inverseFormationVolumeFactorId)
+
+    /*!
+     * \brief Returns the formation volume factor [-] of the fluid phase at saturated
+     *        conditions.
+     */
+    OPM_MEMOIZED_PVT_METHOD(saturatedInverseFormationVolumeFactor,
+                            saturatedInverseFormationVolumeFactorId)
+
+    /*!
+     * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of the saturated
+     *        oil phase.
+     */
+    OPM_MEMOIZED_PVT_METHOD(saturatedGasDissolutionFactor, saturatedGasDissolutionFactorId)
+
+    /*!
+     * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of the saturated
+     *        oil phase if the dissolution is limited by the oil saturation.
+     *
+     * This is not memoized.
+     */
+    template <class Evaluation>
+    Evaluation saturatedGasDissolutionFactor(unsigned regionIdx,
+                                             const Evaluation& temperature,
+                                             const Evaluation& pressure,
+                                             const Evaluation& oilSaturation,
+                                             Scalar maxOilSaturation) const
+    { return pvt_.saturatedGasDissolutionFactor(regionIdx, temperature, pressure, oilSaturation, maxOilSaturation); }
+
+    /*!
+     * \brief Returns the oil vaporization factor \f$R_v\f$ [m^3/m^3] of the saturated
+     *        gas phase.
+     */
+    OPM_MEMOIZED_PVT_METHOD(saturatedOilVaporizationFactor, saturatedOilVaporizationFactorId)
+
+    /*!
+     * \brief Returns the oil vaporization factor \f$R_v\f$ [m^3/m^3] of the saturated
+     *        gas phase if the vaporization is limited by the oil saturation.
+     *
+     * This is not memoized.
+     */
+    template <class Evaluation>
+    Evaluation saturatedOilVaporizationFactor(unsigned regionIdx,
+                                              const Evaluation& temperature,
+                                              const Evaluation& pressure,
+                                              const Evaluation& oilSaturation,
+                                              Scalar maxOilSaturation) const
+    { return pvt_.saturatedOilVaporizationFactor(regionIdx, temperature, pressure, oilSaturation, maxOilSaturation); }
+
+    /*!
+     * \brief Returns the saturation pressure [Pa] of the fluid phase given a set of
+     *        parameters.
+     */
+    OPM_MEMOIZED_PVT_METHOD(saturationPressure, saturationPressureId)
+
+    /*!
+     * \brief Returns the inverse formation volume factor [-] and the viscosity [Pa s]
+     *        of the fluid phase.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& temperature,
+                                                  const Evaluation& pressure,
+                                                  const Evaluation& Rx,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    {
+        if (!enabled_) {
+            pvt_.inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, Rx, invB, mu);
+            return;
+        }
+
+        invB = inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rx);
+        mu = viscosity(regionIdx, temperature, pressure, Rx);
+    }
+
+    /*!
+     * \brief Returns the inverse formation volume factor [-] and the viscosity [Pa s]
+     *        of the fluid phase at saturated conditions.
+     */
+    template <class Evaluation>
+    void saturatedInverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                           const Evaluation& temperature,
+                                                           const Evaluation& pressure,
+                                                           Evaluation& invB,
+                                                           Evaluation& mu) const
+    {
+        if (!enabled_) {
+            pvt_.saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu);
+            return;
+        }
+
+        invB = saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure);
+        mu = saturatedViscosity(regionIdx, temperature, pressure);
+    }
+
+private:
+    Cache_* threadCache_() const
+    {
+        unsigned threadIdx = 0;
+#ifdef _OPENMP
+        threadIdx = static_cast<unsigned>(omp_get_thread_num());
+#endif
+        if (threadIdx >= caches_.size())
+            return nullptr;
+        return &caches_[threadIdx];
+    }
+
+    Pvt pvt_;
+
+    bool enabled_;
+    Bits quantizationMask_;
+    Scalar maxRelativeInputDeviation_;
+    mutable std::vector<Cache_> caches_;
+};
+
+#undef OPM_MEMOIZED_PVT_METHOD
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,161 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::MixedPrecisionPvt
+ */
+#ifndef OPM_MIXED_PRECISION_PVT_HPP
+#define OPM_MIXED_PRECISION_PVT_HPP
+
+#include <opm/material/densead/PrecisionCast.hpp>
+
+#include <utility>
+
+namespace Opm {
+
+// defines a method which converts all arguments to the low-precision evaluation
+// type, calls the respective method of the wrapped PVT object and converts the
+// result back
+#define OPM_MIXED_PRECISION_PVT_METHOD(methodName)                      \
+    template <class Evaluation, class... Args>                          \
+    Evaluation methodName(unsigned regionIdx,                           \
+                          const Evaluation& arg0,                       \
+                          const Args&... args) const                    \
+    {                                                                   \
+        typedef typename LowEvaluation_<Evaluation>::type LowEval;      \
+        return Opm::precisionCast<Evaluation>(                          \
+            pvt_.methodName(regionIdx,                                  \
+                            Opm::precisionCast<LowEval>(arg0),          \
+                            Opm::precisionCast<LowEval>(args)...));     \
+    }
+
+/*!
+ * \brief Evaluates the relations of a black-oil PVT class in a lower floating point
+ *        precision than the one used by the caller.
+ *
+ * The wrapped object is a PVT class (or multiplexer) which has been instantiated for
+ * a lower precision scalar, e.g., Opm::OilPvtMultiplexer<float>; the LowScalar
+ * template parameter must be the scalar type of that instantiation. The arguments of
+ * each method are converted to the corresponding low-precision evaluation type, the
+ * property is computed in that precision and the result including its derivatives is
+ * converted back, e.g.
+ *
+ * \code
+ * Opm::MixedPrecisionPvt<Opm::OilPvtMultiplexer<float> > oilPvt;
+ * oilPvt.pvt().initFromDeck(deck, eclState);
+ * oilPvt.pvt().initEnd();
+ *
+ * // Evaluation is based on double
+ * Evaluation invBo = oilPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rs);
+ * \endcode
+ *
+ * This halves the memory bandwidth which is required for the tables and for the
+ * derivatives of the intermediate results at the price of the precision of the
+ * results, which is limited to the one of the low-precision type.
+ */
+template <class LowPrecisionPvt, class LowScalar = float>
+class MixedPrecisionPvt
+{
+    template <class Evaluation>
+    struct LowEvaluation_
+        : public ChangeScalarType<Evaluation, LowScalar>
+    {};
+
+public:
+    typedef LowPrecisionPvt LowPrecisionPvtType;
+
+    MixedPrecisionPvt()
+    {}
+
+    explicit MixedPrecisionPvt(LowPrecisionPvt pvt)
+        : pvt_(std::move(pvt))
+    {}
+
+    /*!
+     * \brief Returns the wrapped low-precision PVT object.
+     */
+    LowPrecisionPvt& pvt()
+    { return pvt_; }
+
+    /*!
+     * \brief Returns the wrapped low-precision PVT object.
+     */
+    const LowPrecisionPvt& pvt() const
+    { return pvt_; }
+
+    /*!
+     * \brief Return the number of PVT regions which are considered by this PVT-object.
+     */
+    unsigned numRegions() const
+    { return pvt_.numRegions(); }
+
+    /*!
+     * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of
+     *        parameters.
+     */
+    OPM_MIXED_PRECISION_PVT_METHOD(viscosity)
+
+    /*!
+     * \brief Returns the dynamic viscosity [Pa s] of the fluid phase at saturated
+     *        conditions.
+     */
+    OPM_MIXED_PRECISION_PVT_METHOD(saturatedViscosity)
+
+    /*!
+     * \brief Returns the formation volume factor [-] of the fluid phase.
+     */
+    OPM_MIXED_PRECISION_PVT_METHOD(inverseFormationVolumeFactor)
+
+    /*!
+     * \brief Returns the formation volume factor [-] of the fluid phase at saturated
+     *        conditions.
+     */
+    OPM_MIXED_PRECISION_PVT_METHOD(saturatedInverseFormationVolumeFactor)
+
+    /*!
+     * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of the saturated
+     *        oil phase.
+     */
+    OPM_MIXED_PRECISION_PVT_METHOD(saturatedGasDissolutionFactor)
+
+    /*!
+     * \brief Returns the oil vaporization factor \f$R_v\f$ [m^3/m^3] of the saturated
+     *        gas phase.
+     */
+    OPM_MIXED_PRECISION_PVT_METHOD(saturatedOilVaporizationFactor)
+
+    /*!
+     * \brief Returns the saturation pressure [Pa] of the fluid phase given a set of
+     *        parameters.
+     */
+    OPM_MIXED_PRECISION_PVT_METHOD(saturationPressure)
+
+private:
+    LowPrecisionPvt pvt_;
+};
+
+#undef OPM_MIXED_PRECISION_PVT_METHOD
+
+} // namespace Opm
+
+#endif
@@ -32,6 +32,11 @@
 #include "LiveOilPvt.hpp"
 #include "OilPvtThermal.hpp"
 
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+
+#include <cstdint>
+
 namespace Opm {
 #define OPM_OIL_PVT_MULTIPLEXER_CALL(codeToCall)                        \
     switch (approach_) {                                                \
@@ -152,6 +157,63 @@ public:
     unsigned numRegions() const
     { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.numRegions()); return 1; }
 
+    /*!
+     * \brief Returns the memory used by the multiplexer and by the PVT object of the
+     *        selected approach.
+     */
+    MemoryUsage memoryUsage() const
+    {
+        MemoryUsage usage;
+        usage.add("multiplexer params", sizeof(*this));
+        if (approach_ != NoOilPvt) {
+            OPM_OIL_PVT_MULTIPLEXER_CALL(usage.add("multiplexer params", sizeof(pvtImpl));
+                                         pvtImpl.addMemoryUsage(usage));
+        }
+        return usage;
+    }
+
+    /*!
+     * \brief Write the selected approach and the parameters of its PVT object to a
+     *        binary blob.
+     *
+     * The blob can be used to initialize a multiplexer without processing the deck
+     * using deserialize().
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(static_cast<std::uint32_t>(sizeof(Scalar)));
+        writer.write(static_cast<std::int32_t>(approach_));
+        if (approach_ != NoOilPvt)
+            OPM_OIL_PVT_MULTIPLEXER_CALL(pvtImpl.serialize(writer));
+    }
+
+    /*!
+     * \brief Restore a multiplexer which was written by serialize().
+     *
+     * The multiplexer must not have been initialized before.
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        if (approach_ != NoOilPvt)
+            OPM_THROW(std::logic_error, "Cannot deserialize into an initialized oil PVT object");
+
+        std::uint32_t scalarSize;
+        reader.read(scalarSize);
+        if (scalarSize != sizeof(Scalar))
+            OPM_THROW(std::runtime_error,
+                      "The serialized oil PVT object uses a different scalar type");
+
+        std::int32_t appr;
+        reader.read(appr);
+        if (appr < NoOilPvt || appr > ThermalOilPvt)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: invalid oil PVT approach " << appr);
+        if (appr == NoOilPvt)
+            return;
+
+        setApproach(static_cast<OilPvtApproach>(appr));
+        OPM_OIL_PVT_MULTIPLEXER_CALL(pvtImpl.deserialize(reader));
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -181,6 +243,35 @@ public:
                                             const Evaluation& Rs) const
     { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rs)); return 0; }
 
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the oil phase at once.
+     *
+     * For the thermal PVT relations, this evaluates each table only once, and for
+     * constant compressibility oil, the parameters of the region are only loaded once.
+     * The other approaches simply compute both quantities individually.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& temperature,
+                                                  const Evaluation& pressure,
+                                                  const Evaluation& Rs,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    { OPM_OIL_PVT_MULTIPLEXER_CALL(invBAndViscosity_(pvtImpl, regionIdx, temperature, pressure, Rs, invB, mu)); }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of gas-saturated oil at once.
+     */
+    template <class Evaluation>
+    void saturatedInverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                           const Evaluation& temperature,
+                                                           const Evaluation& pressure,
+                                                           Evaluation& invB,
+                                                           Evaluation& mu) const
+    { OPM_OIL_PVT_MULTIPLEXER_CALL(saturatedInvBAndViscosity_(pvtImpl, regionIdx, temperature, pressure, invB, mu)); }
+
     /*!
      * \brief Returns the formation volume factor [-] of the fluid phase.
      */
@@ -315,6 +406,69 @@ public:
     }
 
 private:
+    template <class Pvt, class Evaluation>
+    static void invBAndViscosity_(const Pvt& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  const Evaluation& Rs,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    {
+        invB = pvt.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rs);
+        mu = pvt.viscosity(regionIdx, temperature, pressure, Rs);
+    }
+
+    template <class Evaluation>
+    static void invBAndViscosity_(const Opm::OilPvtThermal<Scalar>& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  const Evaluation& Rs,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    { pvt.inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, Rs, invB, mu); }
+
+    template <class Pvt, class Evaluation>
+    static void saturatedInvBAndViscosity_(const Pvt& pvt,
+                                           unsigned regionIdx,
+                                           const Evaluation& temperature,
+                                           const Evaluation& pressure,
+                                           Evaluation& invB,
+                                           Evaluation& mu)
+    {
+        invB = pvt.saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure);
+        mu = pvt.saturatedViscosity(regionIdx, temperature, pressure);
+    }
+
+    template <class Evaluation>
+    static void saturatedInvBAndViscosity_(const Opm::OilPvtThermal<Scalar>& pvt,
+                                           unsigned regionIdx,
+                                           const Evaluation& temperature,
+                                           const Evaluation& pressure,
+                                           Evaluation& invB,
+                                           Evaluation& mu)
+    { pvt.saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu); }
+
+    template <class Evaluation>
+    static void invBAndViscosity_(const Opm::ConstantCompressibilityOilPvt<Scalar>& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  const Evaluation& Rs,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    { pvt.inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, Rs, invB, mu); }
+
+    template <class Evaluation>
+    static void saturatedInvBAndViscosity_(const Opm::ConstantCompressibilityOilPvt<Scalar>& pvt,
+                                           unsigned regionIdx,
+                                           const Evaluation& temperature,
+                                           const Evaluation& pressure,
+                                           Evaluation& invB,
+                                           Evaluation& mu)
+    { pvt.saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu); }
+
     OilPvtApproach approach_;
     void* realOilPvt_;
 };
@@ -323,4 +477,28 @@ private:
 
 } // namespace Opm
 
+// the instantiations which are part of the library of precompiled instantiations (see
+// opm/material/common/PrecompiledInstantiations.hpp)
+#include <opm/material/common/PrecompiledInstantiations.hpp>
+
+#define OPM_MATERIAL_INSTANTIATE_OIL_PVT_MULTIPLEXER_(PREFIX, Evaluation) \
+    PREFIX template Evaluation OilPvtMultiplexer<double>::viscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation OilPvtMultiplexer<double>::saturatedViscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation OilPvtMultiplexer<double>::inverseFormationVolumeFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&, const Evaluation&) const; \
+    PREFIX template void OilPvtMultiplexer<double>::inverseFormationVolumeFactorAndViscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&, const Evaluation&, Evaluation&, Evaluation&) const; \
+    PREFIX template void OilPvtMultiplexer<double>::saturatedInverseFormationVolumeFactorAndViscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&, Evaluation&, Evaluation&) const; \
+    PREFIX template Evaluation OilPvtMultiplexer<double>::saturatedInverseFormationVolumeFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation OilPvtMultiplexer<double>::saturatedGasDissolutionFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation OilPvtMultiplexer<double>::saturatedGasDissolutionFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&, const Evaluation&, double) const; \
+    PREFIX template Evaluation OilPvtMultiplexer<double>::saturationPressure<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const;
+
+#if OPM_MATERIAL_EXTERN_TEMPLATES
+#include <opm/material/densead/Evaluation.hpp>
+
+namespace Opm {
+extern template class OilPvtMultiplexer<double>;
+OPM_MATERIAL_FOR_EACH_PRECOMPILED_EVALUATION(OPM_MATERIAL_INSTANTIATE_OIL_PVT_MULTIPLEXER_, extern)
+} // namespace Opm
+#endif
+
 #endif
@@ -32,7 +32,10 @@
 #include <opm/material/common/OpmFinal.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
 #include <opm/material/common/Spline.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/EclPvtRegionUsage.hpp>
 
 #if HAVE_OPM_PARSER
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -41,6 +44,9 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 #endif
 
+#include <cmath>
+#include <limits>
+
 namespace Opm {
 template <class Scalar, bool enableThermal>
 class OilPvtMultiplexer;
@@ -58,6 +64,16 @@ class OilPvtThermal
     typedef OilPvtMultiplexer<Scalar, /*enableThermal=*/false> IsothermalPvt;
 
 public:
+    OilPvtThermal()
+        : isothermalPvt_(nullptr)
+        , refTemp_(0.0)
+        , refPress_(0.0)
+        , refC_(0.0)
+        , thermex1_(0.0)
+        , enableThermalDensity_(false)
+        , enableThermalViscosity_(false)
+    {}
+
     ~OilPvtThermal()
     { delete isothermalPvt_; }
 
@@ -93,15 +109,23 @@ public:
             assert(oilvisctTables.size() == numRegions);
             assert(viscrefKeyword.size() == numRegions);
 
+            // the isothermal PVT object only computes the tables of the regions which
+            // are referenced by PVTNUM, so the reference viscosity of the other regions
+            // cannot be evaluated. it stays NaN for them.
+            const auto& regionIsUsed = eclUsedPvtRegions(eclState, numRegions);
+
             for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
-                const auto& TCol = oilvisctTables[regionIdx].getColumn("Temperature").vectorCopy();
-                const auto& muCol = oilvisctTables[regionIdx].getColumn("Viscosity").vectorCopy();
+                const auto& TCol = oilvisctTables[regionIdx].getColumn("Temperature");
+                const auto& muCol = oilvisctTables[regionIdx].getColumn("Viscosity");
                 oilvisctCurves_[regionIdx].setXYContainers(TCol, muCol);
 
                 const auto& viscrefRecord = viscrefKeyword.getRecord(regionIdx);
                 viscrefPress_[regionIdx] = viscrefRecord.getItem("REFERENCE_PRESSURE").getSIDouble(0);
                 viscrefRs_[regionIdx] = viscrefRecord.getItem("REFERENCE_RS").getSIDouble(0);
 
+                if (!regionIsUsed[regionIdx])
+                    continue;
+
                 // temperature used to calculate the reference viscosity [K]. the
                 // value does not really matter if the underlying PVT object really
                 // is isothermal...
@@ -128,6 +152,8 @@ public:
             refC_ = deck.getKeyword("CREF").getRecord(0).getItem("COMPRESSIBILITY").getSIDouble(oilCompIdx);
             thermex1_ = deck.getKeyword("THERMEX1").getRecord(0).getItem("EXPANSION_COEFF").getSIDouble(oilCompIdx);
         }
+
+        initEnd();
     }
 #endif // HAVE_OPM_PARSER
 
@@ -139,14 +165,24 @@ public:
         oilvisctCurves_.resize(numRegions);
         viscrefPress_.resize(numRegions);
         viscrefRs_.resize(numRegions);
-        viscRef_.resize(numRegions);
+        viscRef_.resize(numRegions, std::numeric_limits<Scalar>::quiet_NaN());
+        invViscRef_.resize(numRegions);
     }
 
     /*!
      * \brief Finish initializing the thermal part of the oil phase PVT properties.
+     *
+     * This computes the temperature independent part of the viscosity correction of
+     * each region, so that it is not re-evaluated by every call. Regions without a
+     * reference viscosity, i.e., the ones which are not used by any cell, are skipped.
      */
     void initEnd()
-    { }
+    {
+        invViscRef_.assign(viscRef_.size(), std::numeric_limits<Scalar>::quiet_NaN());
+        for (unsigned regionIdx = 0; regionIdx < viscRef_.size(); ++regionIdx)
+            if (!std::isnan(viscRef_[regionIdx]))
+                invViscRef_[regionIdx] = 1.0/viscRef_[regionIdx];
+    }
 
     /*!
      * \brief Returns true iff the density of the oil phase is temperature dependent.
@@ -163,6 +199,69 @@ public:
     size_t numRegions() const
     { return viscrefRs_.size(); }
 
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     *
+     * This includes the memory used by the isothermal PVT object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(viscrefPress_)
+                  + vectorMemoryUsage(viscrefRs_)
+                  + vectorMemoryUsage(viscRef_)
+                  + vectorMemoryUsage(invViscRef_));
+        usage.add("tables",
+                    tableVectorMemoryUsage(oilvisctCurves_));
+        if (isothermalPvt_)
+            usage.add(isothermalPvt_->memoryUsage());
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     *
+     * This includes the parameters of the isothermal PVT object.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        if (!isothermalPvt_)
+            OPM_THROW(std::logic_error, "Cannot serialize uninitialized thermal PVT object");
+
+        isothermalPvt_->serialize(writer);
+        writer.writeObjects(oilvisctCurves_);
+        writer.write(viscrefPress_);
+        writer.write(viscrefRs_);
+        writer.write(viscRef_);
+        writer.write(refTemp_);
+        writer.write(refPress_);
+        writer.write(refC_);
+        writer.write(thermex1_);
+        writer.write(enableThermalDensity_);
+        writer.write(enableThermalViscosity_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        delete isothermalPvt_;
+        isothermalPvt_ = new IsothermalPvt;
+        isothermalPvt_->deserialize(reader);
+        reader.readObjects(oilvisctCurves_);
+        reader.read(viscrefPress_);
+        reader.read(viscrefRs_);
+        reader.read(viscRef_);
+        reader.read(refTemp_);
+        reader.read(refPress_);
+        reader.read(refC_);
+        reader.read(thermex1_);
+        reader.read(enableThermalDensity_);
+        reader.read(enableThermalViscosity_);
+
+        initEnd();
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -176,9 +275,7 @@ public:
         if (!enableThermalViscosity())
             return isothermalMu;
 
-        // compute the viscosity deviation due to temperature
-        const auto& muOilvisct = oilvisctCurves_[regionIdx].eval(temperature);
-        return muOilvisct/viscRef_[regionIdx]*isothermalMu;
+        return viscosityFactor_(regionIdx, temperature)*isothermalMu;
     }
 
     /*!
@@ -193,9 +290,7 @@ public:
         if (!enableThermalViscosity())
             return isothermalMu;
 
-        // compute the viscosity deviation due to temperature
-        const auto& muOilvisct = oilvisctCurves_[regionIdx].eval(temperature);
-        return muOilvisct/viscRef_[regionIdx]*isothermalMu;
+        return viscosityFactor_(regionIdx, temperature)*isothermalMu;
     }
 
 
@@ -213,13 +308,7 @@ public:
         if (!enableThermalDensity())
             return b;
 
-        // we use equation (3.208) from the Eclipse 2011.1 Reference Manual, but we
-        // calculate rho_ref using the isothermal keyword instead of using the value for
-        // the components, so the oil compressibility is already dealt with there. Note
-        // that we only do the part for the oil component here, the part for dissolved
-        // gas is ignored so far.
-        const auto& alpha = 1.0/(1 + thermex1_*(temperature - refTemp_));
-        return alpha*b;
+        return densityFactor_(temperature)*b;
     }
 
     /*!
@@ -235,13 +324,42 @@ public:
         if (!enableThermalDensity())
             return b;
 
-        // we use equation (3.208) from the Eclipse 2011.1 Reference Manual, but we
-        // calculate rho_ref using the isothermal keyword instead of using the value for
-        // the components, so the oil compressibility is already dealt with there. Note
-        // that we only do the part for the oil component here, the part for dissolved
-        // gas is ignored so far.
-        const auto& alpha = 1.0/(1 + thermex1_*(temperature - refTemp_));
-        return alpha*b;
+        return densityFactor_(temperature)*b;
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the oil phase at once.
+     *
+     * The results are the same as the ones of inverseFormationVolumeFactor() and
+     * viscosity(), but each table of the isothermal and the thermal PVT relations is
+     * evaluated only once.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& temperature,
+                                                  const Evaluation& pressure,
+                                                  const Evaluation& Rs,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    {
+        isothermalPvt_->inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, Rs, invB, mu);
+        applyThermal_(regionIdx, temperature, invB, mu);
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the gas-saturated oil phase at once.
+     */
+    template <class Evaluation>
+    void saturatedInverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                           const Evaluation& temperature,
+                                                           const Evaluation& pressure,
+                                                           Evaluation& invB,
+                                                           Evaluation& mu) const
+    {
+        isothermalPvt_->saturatedInverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu);
+        applyThermal_(regionIdx, temperature, invB, mu);
     }
 
     /*!
@@ -286,6 +404,32 @@ public:
     { return isothermalPvt_->saturationPressure(regionIdx, temperature, pressure); }
 
 private:
+    // the factor by which the temperature changes the isothermal viscosity
+    template <class Evaluation>
+    Evaluation viscosityFactor_(unsigned regionIdx, const Evaluation& temperature) const
+    { return oilvisctCurves_[regionIdx].eval(temperature)*invViscRef_[regionIdx]; }
+
+    // we use equation (3.208) from the Eclipse 2011.1 Reference Manual, but we
+    // calculate rho_ref using the isothermal keyword instead of using the value for
+    // the components, so the oil compressibility is already dealt with there. Note
+    // that we only do the part for the oil component here, the part for dissolved
+    // gas is ignored so far.
+    template <class Evaluation>
+    Evaluation densityFactor_(const Evaluation& temperature) const
+    { return 1.0/(1 + thermex1_*(temperature - refTemp_)); }
+
+    template <class Evaluation>
+    void applyThermal_(unsigned regionIdx,
+                       const Evaluation& temperature,
+                       Evaluation& invB,
+                       Evaluation& mu) const
+    {
+        if (enableThermalDensity())
+            invB *= densityFactor_(temperature);
+        if (enableThermalViscosity())
+            mu *= viscosityFactor_(regionIdx, temperature);
+    }
+
     IsothermalPvt* isothermalPvt_;
 
     // The PVT properties needed for temperature dependence of the viscosity. We need
@@ -295,6 +439,9 @@ private:
     std::vector<Scalar> viscrefRs_;
     std::vector<Scalar> viscRef_;
 
+    // the inverse of viscRef_. this is not serialized but computed by initEnd()
+    std::vector<Scalar> invViscRef_;
+
     // The PVT properties needed for temperature dependence of the density. This is
     // specified as one value per EOS in the manual, but we unconditionally use the
     // expansion coefficient of the first EOS...
@@ -0,0 +1,418 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::PvtRegionBatch
+ */
+#ifndef OPM_PVT_REGION_BATCH_HPP
+#define OPM_PVT_REGION_BATCH_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <vector>
+#include <stdexcept>
+#include <cstddef>
+
+namespace Opm {
+
+// evaluates an expression for all cells of the batch. the PVT region of the cells
+// is available as 'regionIdx', the index of the current cell as 'cellIdx'. if a cell
+// mask is set, the cells which are not part of it are skipped.
+#define OPM_PVT_REGION_BATCH_LOOP(expression)                           \
+    for (size_t rangeIdx = 0; rangeIdx < numRanges(); ++rangeIdx) {     \
+        const unsigned regionIdx = rangeRegion_[rangeIdx];              \
+        const size_t rangeEnd = rangeOffset_[rangeIdx + 1];             \
+        if (cellMask_) {                                                \
+            for (size_t cellIdx = rangeOffset_[rangeIdx]; cellIdx < rangeEnd; ++cellIdx) \
+                if (cellMask_[cellIdx])                                 \
+                    expression;                                         \
+        }                                                               \
+        else {                                                          \
+            for (size_t cellIdx = rangeOffset_[rangeIdx]; cellIdx < rangeEnd; ++cellIdx) \
+                expression;                                             \
+        }                                                               \
+    }
+
+/*!
+ * \brief Evaluates the PVT relations of many cells at once, one PVT region at a time.
+ *
+ * The cells of a batch must be sorted by their PVT region index. The quantities of the
+ * cells (pressure, temperature, R_s, ...) are passed as separate arrays which are
+ * indexed by the position of the cell in the batch ("structure of arrays"). All cells
+ * of a region are then processed by one loop, so that the tables of the region stay in
+ * the cache while they are used and the region index is only looked up once per
+ * region.
+ *
+ * The evaluation methods work with any of the black-oil PVT classes (including the
+ * multiplexers) which provide the respective method, e.g.
+ *
+ * \code
+ * Opm::PvtRegionBatch batch;
+ * batch.setRegionIndices(sortedPvtRegionIdx);
+ * batch.inverseFormationVolumeFactor(oilPvt, T.data(), p.data(), Rs.data(), invBo.data());
+ * \endcode
+ *
+ * Setting up a batch for a new set of cells reuses the memory of the previous one.
+ *
+ * If only a subset of the cells needs to be evaluated, e.g., the cells whose inputs
+ * changed according to an Opm::CellChangeDetector, a cell mask can be set. The
+ * entries of the result arrays which belong to the cells outside of the mask are left
+ * untouched, i.e., they keep the results of the previous evaluation.
+ *
+ * The type of the results does not need to be the one of the inputs: If the arrays
+ * of the results are plain scalars while the inputs are Evaluations, only the values
+ * of the inputs are used and the PVT relations are evaluated without derivatives
+ * (see opm/material/common/ValueOnly.hpp).
+ */
+class PvtRegionBatch
+{
+public:
+    PvtRegionBatch()
+        : cellMask_(0)
+    { rangeOffset_.push_back(0); }
+
+    /*!
+     * \brief Set the PVT region indices of the cells of the batch.
+     *
+     * The region indices must be sorted in ascending order.
+     */
+    template <class RegionIndexContainer>
+    void setRegionIndices(const RegionIndexContainer& regionIndices)
+    {
+        rangeRegion_.clear();
+        rangeOffset_.clear();
+        rangeOffset_.push_back(0);
+
+        size_t cellIdx = 0;
+        for (const auto& regionIdx : regionIndices) {
+            if (rangeRegion_.empty() || rangeRegion_.back() != static_cast<unsigned>(regionIdx)) {
+                if (!rangeRegion_.empty() && rangeRegion_.back() > static_cast<unsigned>(regionIdx))
+                    OPM_THROW(std::invalid_argument,
+                              "The cells of a PVT region batch must be sorted by their region "
+                              "index (cell " << cellIdx << " is in region " << regionIdx
+                              << " after a cell in region " << rangeRegion_.back() << ")");
+
+                if (!rangeRegion_.empty())
+                    rangeOffset_.push_back(cellIdx);
+                rangeRegion_.push_back(static_cast<unsigned>(regionIdx));
+            }
+            ++cellIdx;
+        }
+
+        if (!rangeRegion_.empty())
+            rangeOffset_.push_back(cellIdx);
+    }
+
+    /*!
+     * \brief Restrict the evaluation to a subset of the cells of the batch.
+     *
+     * Only the cells whose entry in the mask is non-zero are evaluated by the
+     * subsequent calls. The mask is not copied, i.e., it must stay alive until the mask
+     * is reset or replaced.
+     *
+     * \param mask An array with an entry for each cell of the batch or 0 to evaluate
+     *             all cells
+     */
+    void setCellMask(const unsigned char* mask)
+    { cellMask_ = mask; }
+
+    /*!
+     * \brief Restrict the evaluation to a subset of the cells of the batch.
+     *
+     * \copydetails setCellMask(const unsigned char*)
+     */
+    void setCellMask(const std::vector<unsigned char>& mask)
+    {
+        if (mask.size() != numCells())
+            OPM_THROW(std::invalid_argument,
+                      "The cell mask of a PVT region batch must have an entry for each of its "
+                      << numCells() << " cells (has " << mask.size() << ")");
+        cellMask_ = mask.data();
+    }
+
+    /*!
+     * \brief Evaluate all cells of the batch again.
+     */
+    void resetCellMask()
+    { cellMask_ = 0; }
+
+    /*!
+     * \brief Returns the number of cells in the batch.
+     */
+    size_t numCells() const
+    { return rangeOffset_.back(); }
+
+    /*!
+     * \brief Returns the number of PVT regions which are present in the batch.
+     */
+    size_t numRanges() const
+    { return rangeRegion_.size(); }
+
+    /*!
+     * \brief Returns the PVT region index of the cells of a contiguous range.
+     */
+    unsigned rangeRegionIndex(size_t rangeIdx) const
+    { return rangeRegion_[rangeIdx]; }
+
+    /*!
+     * \brief Returns the position of the first cell of a range within the batch.
+     */
+    size_t rangeBegin(size_t rangeIdx) const
+    { return rangeOffset_[rangeIdx]; }
+
+    /*!
+     * \brief Returns the position after the last cell of a range within the batch.
+     */
+    size_t rangeEnd(size_t rangeIdx) const
+    { return rangeOffset_[rangeIdx + 1]; }
+
+    /*!
+     * \brief Compute the inverse formation volume factors of an oil or gas phase.
+     *
+     * \param R The gas dissolution factors R_s for oil and the oil vaporization factors
+     *          R_v for gas
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void inverseFormationVolumeFactor(const Pvt& pvt,
+                                      const InputEvaluation* temperature,
+                                      const InputEvaluation* pressure,
+                                      const InputEvaluation* R,
+                                      Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+            pvt.inverseFormationVolumeFactor(regionIdx,
+                                             Opm::decay<Evaluation>(temperature[cellIdx]),
+                                             Opm::decay<Evaluation>(pressure[cellIdx]),
+                                             Opm::decay<Evaluation>(R[cellIdx])));
+    }
+
+    /*!
+     * \brief Compute the inverse formation volume factors of the water phase.
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void inverseFormationVolumeFactor(const Pvt& pvt,
+                                      const InputEvaluation* temperature,
+                                      const InputEvaluation* pressure,
+                                      Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+            pvt.inverseFormationVolumeFactor(regionIdx,
+                                             Opm::decay<Evaluation>(temperature[cellIdx]),
+                                             Opm::decay<Evaluation>(pressure[cellIdx])));
+    }
+
+    /*!
+     * \brief Compute the inverse formation volume factors of a saturated oil or gas
+     *        phase.
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void saturatedInverseFormationVolumeFactor(const Pvt& pvt,
+                                               const InputEvaluation* temperature,
+                                               const InputEvaluation* pressure,
+                                               Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+            pvt.saturatedInverseFormationVolumeFactor(regionIdx,
+                                                      Opm::decay<Evaluation>(temperature[cellIdx]),
+                                                      Opm::decay<Evaluation>(pressure[cellIdx])));
+    }
+
+    /*!
+     * \brief Compute the viscosities of an oil or gas phase.
+     *
+     * \param R The gas dissolution factors R_s for oil and the oil vaporization factors
+     *          R_v for gas
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void viscosity(const Pvt& pvt,
+                   const InputEvaluation* temperature,
+                   const InputEvaluation* pressure,
+                   const InputEvaluation* R,
+                   Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+            pvt.viscosity(regionIdx,
+                                                Opm::decay<Evaluation>(temperature[cellIdx]),
+                                                Opm::decay<Evaluation>(pressure[cellIdx]),
+                                                Opm::decay<Evaluation>(R[cellIdx])));
+    }
+
+    /*!
+     * \brief Compute the viscosities of the water phase.
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void viscosity(const Pvt& pvt,
+                   const InputEvaluation* temperature,
+                   const InputEvaluation* pressure,
+                   Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+            pvt.viscosity(regionIdx,
+                                                Opm::decay<Evaluation>(temperature[cellIdx]),
+                                                Opm::decay<Evaluation>(pressure[cellIdx])));
+    }
+
+    /*!
+     * \brief Compute the viscosities of a saturated oil or gas phase.
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void saturatedViscosity(const Pvt& pvt,
+                            const InputEvaluation* temperature,
+                            const InputEvaluation* pressure,
+                            Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+            pvt.saturatedViscosity(regionIdx,
+                                   Opm::decay<Evaluation>(temperature[cellIdx]),
+                                   Opm::decay<Evaluation>(pressure[cellIdx])));
+    }
+
+    /*!
+     * \brief Compute the inverse formation volume factors and the viscosities of an oil
+     *        or gas phase at once.
+     *
+     * This requires a PVT class which provides the method
+     * inverseFormationVolumeFactorAndViscosity(), e.g., the multiplexers or the wet gas
+     * PVT relations.
+     *
+     * \param R The gas dissolution factors R_s for oil and the oil vaporization factors
+     *          R_v for gas
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(const Pvt& pvt,
+                                                  const InputEvaluation* temperature,
+                                                  const InputEvaluation* pressure,
+                                                  const InputEvaluation* R,
+                                                  Evaluation* invB,
+                                                  Evaluation* mu) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(
+            pvt.inverseFormationVolumeFactorAndViscosity(regionIdx,
+                                                         Opm::decay<Evaluation>(temperature[cellIdx]),
+                                                         Opm::decay<Evaluation>(pressure[cellIdx]),
+                                                         Opm::decay<Evaluation>(R[cellIdx]),
+                                                         invB[cellIdx],
+                                                         mu[cellIdx]));
+    }
+
+    /*!
+     * \brief Compute the inverse formation volume factors and the viscosities of the
+     *        water or the solvent phase at once.
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(const Pvt& pvt,
+                                                  const InputEvaluation* temperature,
+                                                  const InputEvaluation* pressure,
+                                                  Evaluation* invB,
+                                                  Evaluation* mu) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(
+            pvt.inverseFormationVolumeFactorAndViscosity(regionIdx,
+                                                         Opm::decay<Evaluation>(temperature[cellIdx]),
+                                                         Opm::decay<Evaluation>(pressure[cellIdx]),
+                                                         invB[cellIdx],
+                                                         mu[cellIdx]));
+    }
+
+    /*!
+     * \brief Compute the inverse formation volume factors and the viscosities of a
+     *        saturated oil or gas phase at once.
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void saturatedInverseFormationVolumeFactorAndViscosity(const Pvt& pvt,
+                                                           const InputEvaluation* temperature,
+                                                           const InputEvaluation* pressure,
+                                                           Evaluation* invB,
+                                                           Evaluation* mu) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(
+            pvt.saturatedInverseFormationVolumeFactorAndViscosity(regionIdx,
+                                                                  Opm::decay<Evaluation>(temperature[cellIdx]),
+                                                                  Opm::decay<Evaluation>(pressure[cellIdx]),
+                                                                  invB[cellIdx],
+                                                                  mu[cellIdx]));
+    }
+
+    /*!
+     * \brief Compute the saturation pressures of an oil or gas phase, i.e., the bubble
+     *        point pressures of oil or the dew point pressures of gas.
+     *
+     * \param R The gas dissolution factors R_s for oil and the oil vaporization factors
+     *          R_v for gas
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void saturationPressure(const Pvt& pvt,
+                            const InputEvaluation* temperature,
+                            const InputEvaluation* R,
+                            Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+            pvt.saturationPressure(regionIdx,
+                                   Opm::decay<Evaluation>(temperature[cellIdx]),
+                                   Opm::decay<Evaluation>(R[cellIdx])));
+    }
+
+    /*!
+     * \brief Compute the gas dissolution factors of saturated oil.
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void saturatedGasDissolutionFactor(const Pvt& oilPvt,
+                                       const InputEvaluation* temperature,
+                                       const InputEvaluation* pressure,
+                                       Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+                                  oilPvt.saturatedGasDissolutionFactor(regionIdx,
+                                                 Opm::decay<Evaluation>(temperature[cellIdx]),
+                                                 Opm::decay<Evaluation>(pressure[cellIdx])));
+    }
+
+    /*!
+     * \brief Compute the oil vaporization factors of saturated gas.
+     */
+    template <class Pvt, class InputEvaluation, class Evaluation>
+    void saturatedOilVaporizationFactor(const Pvt& gasPvt,
+                                        const InputEvaluation* temperature,
+                                        const InputEvaluation* pressure,
+                                        Evaluation* result) const
+    {
+        OPM_PVT_REGION_BATCH_LOOP(result[cellIdx] =
+                                  gasPvt.saturatedOilVaporizationFactor(regionIdx,
+                                                  Opm::decay<Evaluation>(temperature[cellIdx]),
+                                                  Opm::decay<Evaluation>(pressure[cellIdx])));
+    }
+
+private:
+    std::vector<unsigned> rangeRegion_;
+    std::vector<size_t> rangeOffset_;
+    const unsigned char* cellMask_;
+};
+
+#undef OPM_PVT_REGION_BATCH_LOOP
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,189 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ReducedDerivativePvt
+ */
+#ifndef OPM_REDUCED_DERIVATIVE_PVT_HPP
+#define OPM_REDUCED_DERIVATIVE_PVT_HPP
+
+#include <opm/material/densead/DerivativeExpansion.hpp>
+
+#include <utility>
+
+namespace Opm {
+
+namespace ReducedDerivativePvtDetail {
+template <int... indices>
+struct IndexList
+{};
+
+template <int n, int... indices>
+struct MakeIndexList
+    : public MakeIndexList<n - 1, n - 1, indices...>
+{};
+
+template <int... indices>
+struct MakeIndexList<0, indices...>
+{
+    typedef IndexList<indices...> type;
+};
+} // namespace ReducedDerivativePvtDetail
+
+// defines a method which narrows all arguments to an evaluation type that only
+// considers derivatives with regard to the arguments, calls the respective method of
+// the wrapped PVT object and expands the derivatives of the result to the ones of the
+// caller
+#define OPM_REDUCED_DERIVATIVE_PVT_METHOD(methodName)                   \
+    template <class Evaluation, class... Args>                          \
+    Evaluation methodName(unsigned regionIdx,                           \
+                          const Evaluation& arg0,                       \
+                          const Args&... args) const                    \
+    {                                                                   \
+        typedef typename ReducedDerivativePvtDetail::                   \
+            MakeIndexList<1 + sizeof...(Args)>::type Indices;           \
+        return methodName##Reduced_<Evaluation>(Indices(),              \
+                                                regionIdx,              \
+                                                arg0,                   \
+                                                args...);               \
+    }                                                                   \
+                                                                        \
+    template <class Evaluation, int... indices, class... Args>          \
+    Evaluation methodName##Reduced_(ReducedDerivativePvtDetail::        \
+                                    IndexList<indices...>,              \
+                                    unsigned regionIdx,                 \
+                                    const Args&... args) const          \
+    {                                                                   \
+        typedef typename ReducedEvaluation<Evaluation,                  \
+                                           sizeof...(Args)>::type ReducedEval; \
+        return Opm::expandDerivatives<Evaluation>(                      \
+            pvt_.methodName(regionIdx,                                  \
+                            Opm::narrowToVariable<ReducedEval>(args, indices)...), \
+            args...);                                                   \
+    }
+
+/*!
+ * \brief Evaluates the relations of a black-oil PVT class using evaluations which
+ *        only consider the derivatives with regard to the arguments of each method.
+ *
+ * The black-oil PVT relations only depend on the temperature, the pressure and the
+ * dissolution factor, while the evaluations of the caller usually carry the
+ * derivatives with regard to all primary variables of a cell. This class narrows
+ * each argument to an evaluation with one derivative per argument, evaluates the
+ * property using the wrapped PVT object and expands the derivatives of the result to
+ * the caller's primary variables using the chain rule, e.g.
+ *
+ * \code
+ * Opm::ReducedDerivativePvt<Opm::OilPvtMultiplexer<double> > oilPvt;
+ * oilPvt.pvt().initFromDeck(deck, eclState);
+ * oilPvt.pvt().initEnd();
+ *
+ * // Evaluation is Opm::DenseAd::Evaluation<double, numEq>
+ * Evaluation invBo = oilPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rs);
+ * \endcode
+ *
+ * This only pays off if the caller's evaluations exhibit considerably more
+ * derivatives than the number of arguments of the methods. The results are
+ * identical to evaluating the wrapped object directly up to round-off.
+ */
+template <class Pvt>
+class ReducedDerivativePvt
+{
+public:
+    typedef Pvt PvtType;
+
+    ReducedDerivativePvt()
+    {}
+
+    explicit ReducedDerivativePvt(Pvt pvt)
+        : pvt_(std::move(pvt))
+    {}
+
+    /*!
+     * \brief Returns the wrapped PVT object.
+     */
+    Pvt& pvt()
+    { return pvt_; }
+
+    /*!
+     * \brief Returns the wrapped PVT object.
+     */
+    const Pvt& pvt() const
+    { return pvt_; }
+
+    /*!
+     * \brief Return the number of PVT regions which are considered by this PVT-object.
+     */
+    unsigned numRegions() const
+    { return pvt_.numRegions(); }
+
+    /*!
+     * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of
+     *        parameters.
+     */
+    OPM_REDUCED_DERIVATIVE_PVT_METHOD(viscosity)
+
+    /*!
+     * \brief Returns the dynamic viscosity [Pa s] of the fluid phase at saturated
+     *        conditions.
+     */
+    OPM_REDUCED_DERIVATIVE_PVT_METHOD(saturatedViscosity)
+
+    /*!
+     * \brief Returns the formation volume factor [-] of the fluid phase.
+     */
+    OPM_REDUCED_DERIVATIVE_PVT_METHOD(inverseFormationVolumeFactor)
+
+    /*!
+     * \brief Returns the formation volume factor [-] of the fluid phase at saturated
+     *        conditions.
+     */
+    OPM_REDUCED_DERIVATIVE_PVT_METHOD(saturatedInverseFormationVolumeFactor)
+
+    /*!
+     * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of the saturated
+     *        oil phase.
+     */
+    OPM_REDUCED_DERIVATIVE_PVT_METHOD(saturatedGasDissolutionFactor)
+
+    /*!
+     * \brief Returns the oil vaporization factor \f$R_v\f$ [m^3/m^3] of the saturated
+     *        gas phase.
+     */
+    OPM_REDUCED_DERIVATIVE_PVT_METHOD(saturatedOilVaporizationFactor)
+
+    /*!
+     * \brief Returns the saturation pressure [Pa] of the fluid phase given a set of
+     *        parameters.
+     */
+    OPM_REDUCED_DERIVATIVE_PVT_METHOD(saturationPressure)
+
+private:
+    Pvt pvt_;
+};
+
+#undef OPM_REDUCED_DERIVATIVE_PVT_METHOD
+
+} // namespace Opm
+
+#endif
@@ -30,6 +30,9 @@
 #include <opm/material/Constants.hpp>
 
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/RegionTabulated1DMultiFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
 
 #if HAVE_OPM_PARSER
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -40,6 +43,7 @@
 #include <opm/parser/eclipse/Deck/DeckRecord.hpp>
 #endif
 
+#include <array>
 #include <vector>
 
 namespace Opm {
@@ -156,6 +160,8 @@ public:
 
             inverseSolventBMu_[regionIdx].setXYContainers(pressureValues, invSolventBMuValues);
         }
+
+        updateInvBTables_();
     }
 
     /*!
@@ -164,6 +170,44 @@ public:
     unsigned numRegions() const
     { return solventReferenceDensity_.size(); }
 
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(solventReferenceDensity_));
+        usage.add("tables",
+                    tableVectorMemoryUsage(inverseSolventB_)
+                  + tableVectorMemoryUsage(solventMu_)
+                  + tableVectorMemoryUsage(inverseSolventBMu_)
+                  + invBTables_.heapMemoryUsage());
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(solventReferenceDensity_);
+        writer.writeObjects(inverseSolventB_);
+        writer.writeObjects(solventMu_);
+        writer.writeObjects(inverseSolventBMu_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(solventReferenceDensity_);
+        reader.readObjects(inverseSolventB_);
+        reader.readObjects(solventMu_);
+        reader.readObjects(inverseSolventBMu_);
+
+        updateInvBTables_();
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -172,8 +216,12 @@ public:
                                   const Evaluation& temperature OPM_UNUSED,
                                   const Evaluation& pressure) const
     {
-        const Evaluation& invBg = inverseSolventB_[regionIdx].eval(pressure, /*extrapolate=*/true);
-        const Evaluation& invMugBg = inverseSolventBMu_[regionIdx].eval(pressure, /*extrapolate=*/true);
+        // both quantities use the same sampling points, so the segment only needs to
+        // be searched for once
+        std::array<Evaluation, 2> values;
+        invBTables_.eval(regionIdx, pressure, values);
+        const Evaluation& invBg = values[invBIdx_];
+        const Evaluation& invMugBg = values[invBMuIdx_];
 
         return invBg/invMugBg;
     }
@@ -191,13 +239,91 @@ public:
     Evaluation inverseFormationVolumeFactor(unsigned regionIdx,
                                             const Evaluation& temperature OPM_UNUSED,
                                             const Evaluation& pressure) const
-    { return inverseSolventB_[regionIdx].eval(pressure, /*extrapolate=*/true); }
+    { return invBTables_.eval(regionIdx, invBIdx_, pressure); }
+
+    /*!
+     * \brief Returns the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the fluid phase at once.
+     *
+     * The segment of the pressure table is only searched for once and the
+     * interpolated inverse formation volume factor is shared by both quantities. The
+     * results are the same as the ones of inverseFormationVolumeFactor() and
+     * viscosity().
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& /*temperature*/,
+                                                  const Evaluation& pressure,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    {
+        std::array<Evaluation, 2> values;
+        invBTables_.eval(regionIdx, pressure, values);
+        invB = values[invBIdx_];
+        mu = invB/values[invBMuIdx_];
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factors [-] and the dynamic
+     *        viscosities [Pa s] for an array of pressures of the same PVT region.
+     *
+     * The segment of the pressure table which was used for the previous value is
+     * checked first, so the lookup is cheap if neighboring values have similar
+     * pressures. The results are the same as the ones of
+     * inverseFormationVolumeFactorAndViscosity().
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosityBatch(unsigned regionIdx,
+                                                       size_t numValues,
+                                                       const Evaluation* pressure,
+                                                       Evaluation* invB,
+                                                       Evaluation* mu) const
+    {
+        typename InvBTables::LookupHint hint;
+        std::array<Evaluation, 2> values;
+        for (size_t i = 0; i < numValues; ++i) {
+            invBTables_.eval(regionIdx, pressure[i], values, hint);
+            invB[i] = values[invBIdx_];
+            mu[i] = invB[i]/values[invBMuIdx_];
+        }
+    }
 
 private:
+    typedef RegionTabulated1DMultiFunction<Scalar, 2> InvBTables;
+
+    // the indices of the quantities in invBTables_
+    enum { invBIdx_ = 0, invBMuIdx_ = 1 };
+
+    // copy the tables which are required for evaluation of all regions into a single
+    // contiguous store
+    void updateInvBTables_()
+    {
+        invBTables_.clear();
+        std::vector<Scalar> pressureValues;
+        std::vector<typename InvBTables::ValueArray> values;
+        for (unsigned regionIdx = 0; regionIdx < inverseSolventB_.size(); ++regionIdx) {
+            const auto& invSolventB = inverseSolventB_[regionIdx];
+            const auto& invSolventBMu = inverseSolventBMu_[regionIdx];
+
+            pressureValues.resize(invSolventB.numSamples());
+            values.resize(invSolventB.numSamples());
+            for (unsigned pIdx = 0; pIdx < invSolventB.numSamples(); ++pIdx) {
+                pressureValues[pIdx] = invSolventB.xAt(pIdx);
+                values[pIdx][invBIdx_] = invSolventB.valueAt(pIdx);
+                values[pIdx][invBMuIdx_] = invSolventBMu.valueAt(pIdx);
+            }
+            invBTables_.appendRegion(pressureValues, values);
+        }
+    }
+
     std::vector<Scalar> solventReferenceDensity_;
     std::vector<TabulatedOneDFunction> inverseSolventB_;
     std::vector<TabulatedOneDFunction> solventMu_;
     std::vector<TabulatedOneDFunction> inverseSolventBMu_;
+
+    // the inverse formation volume factor and the inverse of its product with the
+    // viscosity of all regions. the per-region tables above are the primary data
+    InvBTables invBTables_;
 };
 
 } // namespace Opm
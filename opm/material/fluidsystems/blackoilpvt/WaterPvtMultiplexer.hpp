@@ -30,6 +30,9 @@
 #include "ConstantCompressibilityWaterPvt.hpp"
 #include "WaterPvtThermal.hpp"
 
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+
 #define OPM_WATER_PVT_MULTIPLEXER_CALL(codeToCall)                      \
     switch (approach_) {                                                \
     case ConstantCompressibilityWaterPvt: {                             \
@@ -46,6 +49,8 @@
         OPM_THROW(std::logic_error, "Not implemented: Water PVT of this deck!"); \
     }
 
+#include <cstdint>
+
 namespace Opm {
 /*!
  * \brief This class represents the Pressure-Volume-Temperature relations of the water
@@ -116,6 +121,63 @@ public:
     unsigned numRegions() const
     { OPM_WATER_PVT_MULTIPLEXER_CALL(return pvtImpl.numRegions()); return 1; }
 
+    /*!
+     * \brief Returns the memory used by the multiplexer and by the PVT object of the
+     *        selected approach.
+     */
+    MemoryUsage memoryUsage() const
+    {
+        MemoryUsage usage;
+        usage.add("multiplexer params", sizeof(*this));
+        if (approach_ != NoWaterPvt) {
+            OPM_WATER_PVT_MULTIPLEXER_CALL(usage.add("multiplexer params", sizeof(pvtImpl));
+                                           pvtImpl.addMemoryUsage(usage));
+        }
+        return usage;
+    }
+
+    /*!
+     * \brief Write the selected approach and the parameters of its PVT object to a
+     *        binary blob.
+     *
+     * The blob can be used to initialize a multiplexer without processing the deck
+     * using deserialize().
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(static_cast<std::uint32_t>(sizeof(Scalar)));
+        writer.write(static_cast<std::int32_t>(approach_));
+        if (approach_ != NoWaterPvt)
+            OPM_WATER_PVT_MULTIPLEXER_CALL(pvtImpl.serialize(writer));
+    }
+
+    /*!
+     * \brief Restore a multiplexer which was written by serialize().
+     *
+     * The multiplexer must not have been initialized before.
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        if (approach_ != NoWaterPvt)
+            OPM_THROW(std::logic_error, "Cannot deserialize into an initialized water PVT object");
+
+        std::uint32_t scalarSize;
+        reader.read(scalarSize);
+        if (scalarSize != sizeof(Scalar))
+            OPM_THROW(std::runtime_error,
+                      "The serialized water PVT object uses a different scalar type");
+
+        std::int32_t appr;
+        reader.read(appr);
+        if (appr < NoWaterPvt || appr > ThermalWaterPvt)
+            OPM_THROW(std::runtime_error, "Corrupt serialized data: invalid water PVT approach " << appr);
+        if (appr == NoWaterPvt)
+            return;
+
+        setApproach(static_cast<WaterPvtApproach>(appr));
+        OPM_WATER_PVT_MULTIPLEXER_CALL(pvtImpl.deserialize(reader));
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -134,6 +196,22 @@ public:
                                             const Evaluation& pressure) const
     { OPM_WATER_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure)); return 0; }
 
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the water phase at once.
+     *
+     * For the thermal PVT relations, this evaluates each table only once, and for
+     * constant compressibility water, the parameters of the region are only loaded
+     * once.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& temperature,
+                                                  const Evaluation& pressure,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    { OPM_WATER_PVT_MULTIPLEXER_CALL(invBAndViscosity_(pvtImpl, regionIdx, temperature, pressure, invB, mu)); }
+
     void setApproach(WaterPvtApproach appr)
     {
         switch (appr) {
@@ -190,6 +268,36 @@ public:
     }
 
 private:
+    template <class Pvt, class Evaluation>
+    static void invBAndViscosity_(const Pvt& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    {
+        invB = pvt.inverseFormationVolumeFactor(regionIdx, temperature, pressure);
+        mu = pvt.viscosity(regionIdx, temperature, pressure);
+    }
+
+    template <class Evaluation>
+    static void invBAndViscosity_(const Opm::WaterPvtThermal<Scalar>& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    { pvt.inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu); }
+
+    template <class Evaluation>
+    static void invBAndViscosity_(const Opm::ConstantCompressibilityWaterPvt<Scalar>& pvt,
+                                  unsigned regionIdx,
+                                  const Evaluation& temperature,
+                                  const Evaluation& pressure,
+                                  Evaluation& invB,
+                                  Evaluation& mu)
+    { pvt.inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu); }
+
     WaterPvtApproach approach_;
     void* realWaterPvt_;
 };
@@ -198,4 +306,22 @@ private:
 
 } // namespace Opm
 
+// the instantiations which are part of the library of precompiled instantiations (see
+// opm/material/common/PrecompiledInstantiations.hpp)
+#include <opm/material/common/PrecompiledInstantiations.hpp>
+
+#define OPM_MATERIAL_INSTANTIATE_WATER_PVT_MULTIPLEXER_(PREFIX, Evaluation) \
+    PREFIX template Evaluation WaterPvtMultiplexer<double>::viscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const; \
+    PREFIX template Evaluation WaterPvtMultiplexer<double>::inverseFormationVolumeFactor<Evaluation>(unsigned, const Evaluation&, const Evaluation&) const; \
+    PREFIX template void WaterPvtMultiplexer<double>::inverseFormationVolumeFactorAndViscosity<Evaluation>(unsigned, const Evaluation&, const Evaluation&, Evaluation&, Evaluation&) const;
+
+#if OPM_MATERIAL_EXTERN_TEMPLATES
+#include <opm/material/densead/Evaluation.hpp>
+
+namespace Opm {
+extern template class WaterPvtMultiplexer<double>;
+OPM_MATERIAL_FOR_EACH_PRECOMPILED_EVALUATION(OPM_MATERIAL_INSTANTIATE_WATER_PVT_MULTIPLEXER_, extern)
+} // namespace Opm
+#endif
+
 #endif
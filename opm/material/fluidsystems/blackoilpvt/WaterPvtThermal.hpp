@@ -32,6 +32,8 @@
 #include <opm/material/common/OpmFinal.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
 #include <opm/material/common/Spline.hpp>
 
 #if HAVE_OPM_PARSER
@@ -58,6 +60,12 @@ class WaterPvtThermal
     typedef WaterPvtMultiplexer<Scalar, /*enableThermal=*/false> IsothermalPvt;
 
 public:
+    WaterPvtThermal()
+        : isothermalPvt_(nullptr)
+        , enableThermalDensity_(false)
+        , enableThermalViscosity_(false)
+    {}
+
     ~WaterPvtThermal()
     { delete isothermalPvt_; }
 
@@ -107,14 +115,16 @@ public:
             assert(viscrefKeyword.size() == numRegions);
 
             for (unsigned regionIdx = 0; regionIdx < numRegions; ++ regionIdx) {
-                const auto& T = watvisctTables[regionIdx].getColumn("Temperature").vectorCopy();
-                const auto& mu = watvisctTables[regionIdx].getColumn("Viscosity").vectorCopy();
+                const auto& T = watvisctTables[regionIdx].getColumn("Temperature");
+                const auto& mu = watvisctTables[regionIdx].getColumn("Viscosity");
                 watvisctCurves_[regionIdx].setXYContainers(T, mu);
 
                 const auto& viscrefRecord = viscrefKeyword.getRecord(regionIdx);
                 viscrefPress_[regionIdx] = viscrefRecord.getItem("REFERENCE_PRESSURE").getSIDouble(0);
             }
         }
+
+        initEnd();
     }
 #endif // HAVE_OPM_PARSER
 
@@ -133,13 +143,24 @@ public:
         watdentRefTemp_.resize(numRegions);
         watdentCT1_.resize(numRegions);
         watdentCT2_.resize(numRegions);
+        invMuRef_.resize(numRegions);
     }
 
     /*!
      * \brief Finish initializing the thermal part of the water phase PVT properties.
+     *
+     * This computes the reference viscosity of each region, which does not depend on
+     * temperature and pressure, so that it is not re-evaluated by every call.
      */
     void initEnd()
-    { }
+    {
+        invMuRef_.resize(pvtwViscosity_.size());
+        for (unsigned regionIdx = 0; regionIdx < pvtwViscosity_.size(); ++regionIdx) {
+            Scalar x = -pvtwViscosibility_[regionIdx]*(viscrefPress_[regionIdx] - pvtwRefPress_[regionIdx]);
+            Scalar muRef = pvtwViscosity_[regionIdx]/(1.0 + x + 0.5*x*x);
+            invMuRef_[regionIdx] = 1.0/muRef;
+        }
+    }
 
     /*!
      * \brief Returns true iff the density of the water phase is temperature dependent.
@@ -156,6 +177,79 @@ public:
     size_t numRegions() const
     { return pvtwRefPress_.size(); }
 
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     *
+     * This includes the memory used by the isothermal PVT object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(viscrefPress_)
+                  + vectorMemoryUsage(watdentRefTemp_)
+                  + vectorMemoryUsage(watdentCT1_)
+                  + vectorMemoryUsage(watdentCT2_)
+                  + vectorMemoryUsage(pvtwRefPress_)
+                  + vectorMemoryUsage(pvtwRefB_)
+                  + vectorMemoryUsage(pvtwCompressibility_)
+                  + vectorMemoryUsage(pvtwViscosity_)
+                  + vectorMemoryUsage(pvtwViscosibility_)
+                  + vectorMemoryUsage(invMuRef_));
+        usage.add("tables",
+                    tableVectorMemoryUsage(watvisctCurves_));
+        if (isothermalPvt_)
+            usage.add(isothermalPvt_->memoryUsage());
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     *
+     * This includes the parameters of the isothermal PVT object.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        if (!isothermalPvt_)
+            OPM_THROW(std::logic_error, "Cannot serialize uninitialized thermal PVT object");
+
+        isothermalPvt_->serialize(writer);
+        writer.write(viscrefPress_);
+        writer.write(watdentRefTemp_);
+        writer.write(watdentCT1_);
+        writer.write(watdentCT2_);
+        writer.write(pvtwRefPress_);
+        writer.write(pvtwRefB_);
+        writer.write(pvtwCompressibility_);
+        writer.write(pvtwViscosity_);
+        writer.write(pvtwViscosibility_);
+        writer.writeObjects(watvisctCurves_);
+        writer.write(enableThermalDensity_);
+        writer.write(enableThermalViscosity_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        delete isothermalPvt_;
+        isothermalPvt_ = new IsothermalPvt;
+        isothermalPvt_->deserialize(reader);
+        reader.read(viscrefPress_);
+        reader.read(watdentRefTemp_);
+        reader.read(watdentCT1_);
+        reader.read(watdentCT2_);
+        reader.read(pvtwRefPress_);
+        reader.read(pvtwRefB_);
+        reader.read(pvtwCompressibility_);
+        reader.read(pvtwViscosity_);
+        reader.read(pvtwViscosibility_);
+        reader.readObjects(watvisctCurves_);
+        reader.read(enableThermalDensity_);
+        reader.read(enableThermalViscosity_);
+
+        initEnd();
+    }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -168,12 +262,7 @@ public:
         if (!enableThermalViscosity())
             return isothermalMu;
 
-        Scalar x = -pvtwViscosibility_[regionIdx]*(viscrefPress_[regionIdx] - pvtwRefPress_[regionIdx]);
-        Scalar muRef = pvtwViscosity_[regionIdx]/(1.0 + x + 0.5*x*x);
-
-        // compute the viscosity deviation due to temperature
-        const auto& muWatvisct = watvisctCurves_[regionIdx].eval(temperature);
-        return isothermalMu * muWatvisct/muRef;
+        return isothermalMu*viscosityFactor_(regionIdx, temperature);
     }
 
     /*!
@@ -187,6 +276,47 @@ public:
         if (!enableThermalDensity())
             return isothermalPvt_->inverseFormationVolumeFactor(regionIdx, temperature, pressure);
 
+        return thermalInverseFormationVolumeFactor_(regionIdx, temperature, pressure);
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the water phase at once.
+     *
+     * The results are the same as the ones of inverseFormationVolumeFactor() and
+     * viscosity(), but each table of the isothermal and the thermal PVT relations is
+     * evaluated only once and the isothermal formation volume factor is not evaluated
+     * at all if it is replaced by the WATDENT relation.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& temperature,
+                                                  const Evaluation& pressure,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    {
+        if (enableThermalDensity()) {
+            invB = thermalInverseFormationVolumeFactor_(regionIdx, temperature, pressure);
+            mu = isothermalPvt_->viscosity(regionIdx, temperature, pressure);
+        }
+        else
+            isothermalPvt_->inverseFormationVolumeFactorAndViscosity(regionIdx, temperature, pressure, invB, mu);
+
+        if (enableThermalViscosity())
+            mu *= viscosityFactor_(regionIdx, temperature);
+    }
+
+private:
+    // the factor by which the temperature changes the isothermal viscosity
+    template <class Evaluation>
+    Evaluation viscosityFactor_(unsigned regionIdx, const Evaluation& temperature) const
+    { return watvisctCurves_[regionIdx].eval(temperature)*invMuRef_[regionIdx]; }
+
+    template <class Evaluation>
+    Evaluation thermalInverseFormationVolumeFactor_(unsigned regionIdx,
+                                                    const Evaluation& temperature,
+                                                    const Evaluation& pressure) const
+    {
         Scalar BwRef = pvtwRefB_[regionIdx];
         Scalar TRef = watdentRefTemp_[regionIdx];
         const Evaluation& X = pvtwCompressibility_[regionIdx]*(pressure - pvtwRefPress_[regionIdx]);
@@ -197,7 +327,6 @@ public:
         return ((1 - X)*(1 + cT1*Y + cT2*Y*Y))/BwRef;
     }
 
-private:
     IsothermalPvt* isothermalPvt_;
 
     // The PVT properties needed for temperature dependence. We need to store one
@@ -214,6 +343,10 @@ private:
     std::vector<Scalar> pvtwViscosity_;
     std::vector<Scalar> pvtwViscosibility_;
 
+    // the inverse reference viscosity of the VISCREF keyword. this is not serialized
+    // but computed by initEnd()
+    std::vector<Scalar> invMuRef_;
+
     std::vector<TabulatedOneDFunction> watvisctCurves_;
 
     bool enableThermalDensity_;
@@ -30,7 +30,15 @@
 #include <opm/material/Constants.hpp>
 #include <opm/material/common/OpmFinal.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
+#include <opm/material/common/UniformXTabulated2DMultiFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/BinarySerialization.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/Tracing.hpp>
+#include <opm/material/common/TableSimplification.hpp>
+#include <opm/material/common/TableDeduplication.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/EclPvtRegionUsage.hpp>
 
 #if HAVE_OPM_PARSER
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -47,6 +55,7 @@ template <class Scalar>
 class WetGasPvt
 {
     typedef Opm::UniformXTabulated2DFunction<Scalar> TabulatedTwoDFunction;
+    typedef Opm::UniformXTabulated2DMultiFunction<Scalar, 2> TabulatedTwoDMultiFunction;
     typedef Opm::Tabulated1DFunction<Scalar> TabulatedOneDFunction;
     typedef std::vector<std::pair<Scalar, Scalar> > SamplingPoints;
 
@@ -54,6 +63,7 @@ public:
     WetGasPvt()
     {
         vapPar1_ = 0.0;
+        tableSimplificationTolerance_ = 0.0;
     }
 
 #if HAVE_OPM_PARSER
@@ -72,6 +82,9 @@ public:
         size_t numRegions = pvtgTables.size();
         setNumRegions(numRegions);
 
+        // the derived tables are only computed for the regions which contain cells
+        regionIsUsed_ = eclUsedPvtRegions(eclState, numRegions);
+
         for (unsigned regionIdx = 0; regionIdx < numRegions; ++ regionIdx) {
             Scalar rhoRefO = densityKeyword.getRecord(regionIdx).getItem("OIL").getSIDouble(0);
             Scalar rhoRefG = densityKeyword.getRecord(regionIdx).getItem("GAS").getSIDouble(0);
@@ -81,6 +94,9 @@ public:
         }
 
         for (unsigned regionIdx = 0; regionIdx < numRegions; ++ regionIdx) {
+            if (!regionIsUsed_[regionIdx])
+                continue;
+
             const auto& pvtgTable = pvtgTables[regionIdx];
 
             const auto& saturatedTable = pvtgTable.getSaturatedTable();
@@ -98,6 +114,15 @@ public:
 
             std::vector<Scalar> invSatGasBArray;
             std::vector<Scalar> invSatGasBMuArray;
+            invSatGasBArray.reserve(saturatedTable.numRows());
+            invSatGasBMuArray.reserve(saturatedTable.numRows());
+
+            // allocate the memory of the two-dimensional tables only once
+            size_t numSamplePoints = 0;
+            for (unsigned outerIdx = 0; outerIdx < saturatedTable.numRows(); ++ outerIdx)
+                numSamplePoints += pvtgTable.getUnderSaturatedTable(outerIdx).numRows();
+            invGasB.reserve(saturatedTable.numRows(), numSamplePoints);
+            gasMu.reserve(saturatedTable.numRows(), numSamplePoints);
 
             // extract the table for the gas dissolution and the oil formation volume factors
             for (unsigned outerIdx = 0; outerIdx < saturatedTable.numRows(); ++ outerIdx) {
@@ -127,7 +152,7 @@ public:
             }
 
             {
-                std::vector<double> tmpPressure =  saturatedTable.getColumn("PG").vectorCopy( );
+                const auto& tmpPressure = saturatedTable.getColumn("PG");
 
                 invSatGasB.setXYContainers(tmpPressure, invSatGasBArray);
                 invSatGasBMu.setXYContainers(tmpPressure, invSatGasBMuArray);
@@ -236,14 +261,44 @@ public:
         oilReferenceDensity_.resize(numRegions);
         gasReferenceDensity_.resize(numRegions);
         inverseGasB_.resize(numRegions);
-        inverseGasBMu_.resize(numRegions);
+        inverseGasBAndBMu_.resize(numRegions);
         inverseSaturatedGasB_.resize(numRegions);
         inverseSaturatedGasBMu_.resize(numRegions);
         gasMu_.resize(numRegions);
         saturatedOilVaporizationFactorTable_.resize(numRegions);
         saturationPressure_.resize(numRegions);
+        saturationPressureIsExact_.resize(numRegions, false);
+        regionIsUsed_.assign(numRegions, true);
+        tableSimplificationStats_.resize(numRegions);
+        regionTableIdx_.resize(numRegions);
+        for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx)
+            regionTableIdx_[regionIdx] = regionIdx;
     }
 
+    /*!
+     * \brief Remove the sampling points of the tables which can be interpolated from
+     *        their neighbors at initEnd().
+     *
+     * Both, the columns for the individual gas pressures and the oil vaporization
+     * factors of each column are considered. A sampling point is removed if the
+     * simplified tables deviate from the original ones by at most the tolerance
+     * relative to the range of values of the respective quantity. Half of the
+     * tolerance is used for each direction. The first and the last sampling point of
+     * each direction are always kept.
+     *
+     * By default, the tables are not simplified. A tolerance of zero disables the
+     * simplification.
+     */
+    void setTableSimplification(Scalar tolerance)
+    { tableSimplificationTolerance_ = tolerance; }
+
+    /*!
+     * \brief Return the number of sampling points of the tables of a PVT region before
+     *        and after they were simplified by initEnd().
+     */
+    const TableSimplificationStats& tableSimplificationStats(unsigned regionIdx) const
+    { return tableSimplificationStats_[regionTableIdx_[regionIdx]]; }
+
     /*!
      * \brief Initialize the reference densities of all fluids for a given PVT region
      */
@@ -386,49 +441,74 @@ public:
 
     /*!
      * \brief Finish initializing the gas phase PVT properties.
+     *
+     * PVT regions which specify the same tables as a previous region use the tables of
+     * that region.
      */
     void initEnd()
     {
+        shareIdenticalRegionTables_();
+
         // calculate the final 2D functions which are used for interpolation.
         size_t numRegions = gasMu_.size();
         for (unsigned regionIdx = 0; regionIdx < numRegions; ++ regionIdx) {
+            if (!regionIsUsed_[regionIdx] || regionTableIdx_[regionIdx] != regionIdx)
+                continue;
+
+            tableSimplificationStats_[regionIdx].clear();
+            if (tableSimplificationTolerance_ > 0.0)
+                simplifyTables_(regionIdx);
+
             // calculate the table which stores the inverse of the product of the gas
             // formation volume factor and the gas viscosity
             const auto& gasMu = gasMu_[regionIdx];
             const auto& invGasB = inverseGasB_[regionIdx];
             assert(gasMu.numX() == invGasB.numX());
 
-            auto& invGasBMu = inverseGasBMu_[regionIdx];
+            auto& invGasBAndBMu = inverseGasBAndBMu_[regionIdx];
             auto& invSatGasB = inverseSaturatedGasB_[regionIdx];
             auto& invSatGasBMu = inverseSaturatedGasBMu_[regionIdx];
 
             std::vector<Scalar> satPressuresArray;
             std::vector<Scalar> invSatGasBArray;
             std::vector<Scalar> invSatGasBMuArray;
+            satPressuresArray.reserve(gasMu.numX());
+            invSatGasBArray.reserve(gasMu.numX());
+            invSatGasBMuArray.reserve(gasMu.numX());
+
+            size_t numSamplePoints = 0;
+            for (size_t pIdx = 0; pIdx < gasMu.numX(); ++pIdx)
+                numSamplePoints += gasMu.numY(pIdx);
+            invGasBAndBMu.reserve(gasMu.numX(), numSamplePoints);
+
             for (size_t pIdx = 0; pIdx < gasMu.numX(); ++pIdx) {
-                invGasBMu.appendXPos(gasMu.xAt(pIdx));
+                invGasBAndBMu.appendXPos(gasMu.xAt(pIdx));
 
                 assert(gasMu.numY(pIdx) == invGasB.numY(pIdx));
 
+                // the table for the viscosity stores both, 1/B and 1/(B*mu), so that both
+                // quantities can be determined using a single lookup
                 size_t numRv = gasMu.numY(pIdx);
                 for (size_t rvIdx = 0; rvIdx < numRv; ++rvIdx)
-                    invGasBMu.appendSamplePoint(pIdx,
-                                                gasMu.yAt(pIdx, rvIdx),
-                                                invGasB.valueAt(pIdx, rvIdx)
-                                                / gasMu.valueAt(pIdx, rvIdx));
+                    invGasBAndBMu.appendSamplePoint(pIdx,
+                                                    gasMu.yAt(pIdx, rvIdx),
+                                                    {{ invGasB.valueAt(pIdx, rvIdx),
+                                                       invGasB.valueAt(pIdx, rvIdx)
+                                                       / gasMu.valueAt(pIdx, rvIdx) }});
 
                 // the sampling points in UniformXTabulated2DFunction are always sorted
                 // in ascending order. Thus, the value for saturated gas is the last one
                 // (i.e., the one with the largest Rv value)
                 satPressuresArray.push_back(gasMu.xAt(pIdx));
                 invSatGasBArray.push_back(invGasB.valueAt(pIdx, numRv - 1));
-                invSatGasBMuArray.push_back(invGasBMu.valueAt(pIdx, numRv - 1));
+                invSatGasBMuArray.push_back(invGasBAndBMu.valueAt(pIdx, numRv - 1, /*valueIdx=*/1));
             }
 
             invSatGasB.setXYContainers(satPressuresArray, invSatGasBArray);
-            invSatGasBMu.setXYContainers(satPressuresArray, invSatGasBMuArray);
+            invSatGasBMu.setXYContainers(std::move(satPressuresArray), std::move(invSatGasBMuArray));
 
             updateSaturationPressure_(regionIdx);
+            setProfileNames_(regionIdx);
         }
     }
 
@@ -438,6 +518,97 @@ public:
     unsigned numRegions() const
     { return gasReferenceDensity_.size(); }
 
+    /*!
+     * \brief Return the index of the PVT region whose tables are used by a region.
+     *
+     * This is the index of the region itself unless its tables are identical to the ones
+     * of a previous region.
+     */
+    unsigned tableRegionIndex(unsigned regionIdx) const
+    { return regionTableIdx_[regionIdx]; }
+
+    /*!
+     * \brief Add the memory used by the parameters of all PVT regions to an object.
+     */
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add("region params",
+                    vectorMemoryUsage(gasReferenceDensity_)
+                  + vectorMemoryUsage(oilReferenceDensity_)
+                  + vectorMemoryUsage(saturationPressureIsExact_)
+                  + vectorMemoryUsage(regionIsUsed_)
+                  + vectorMemoryUsage(regionTableIdx_));
+        usage.add("tables",
+                    tableVectorMemoryUsage(inverseGasB_)
+                  + tableVectorMemoryUsage(inverseSaturatedGasB_)
+                  + tableVectorMemoryUsage(gasMu_)
+                  + tableVectorMemoryUsage(inverseGasBAndBMu_)
+                  + tableVectorMemoryUsage(inverseSaturatedGasBMu_)
+                  + tableVectorMemoryUsage(saturatedOilVaporizationFactorTable_)
+                  + tableVectorMemoryUsage(saturationPressure_));
+    }
+
+    /*!
+     * \brief Write the parameters of all PVT regions to a binary blob.
+     */
+    void serialize(BinaryWriter& writer) const
+    {
+        writer.write(gasReferenceDensity_);
+        writer.write(oilReferenceDensity_);
+        writer.writeObjects(inverseGasB_);
+        writer.writeObjects(inverseSaturatedGasB_);
+        writer.writeObjects(gasMu_);
+        writer.writeObjects(inverseGasBAndBMu_);
+        writer.writeObjects(inverseSaturatedGasBMu_);
+        writer.writeObjects(saturatedOilVaporizationFactorTable_);
+        writer.writeObjects(saturationPressure_);
+        writer.write(saturationPressureIsExact_);
+        writer.write(regionIsUsed_);
+        writer.write(regionTableIdx_);
+        writer.write(vapPar1_);
+    }
+
+    /*!
+     * \brief Restore the parameters which were written by serialize().
+     */
+    void deserialize(BinaryReader& reader)
+    {
+        reader.read(gasReferenceDensity_);
+        reader.read(oilReferenceDensity_);
+        reader.readObjects(inverseGasB_);
+        reader.readObjects(inverseSaturatedGasB_);
+        reader.readObjects(gasMu_);
+        reader.readObjects(inverseGasBAndBMu_);
+        reader.readObjects(inverseSaturatedGasBMu_);
+        reader.readObjects(saturatedOilVaporizationFactorTable_);
+        reader.readObjects(saturationPressure_);
+        reader.read(saturationPressureIsExact_);
+        reader.read(regionIsUsed_);
+        reader.read(regionTableIdx_);
+        reader.read(vapPar1_);
+
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx)
+            setProfileNames_(regionIdx);
+    }
+
+    /*!
+     * \brief Returns whether the tables of a PVT region are computed.
+     *
+     * By default, all regions are used. When initializing from a deck, only the regions
+     * which are referenced by the PVTNUM grid property are considered. The quantities
+     * of unused regions must not be evaluated.
+     */
+    bool regionIsUsed(unsigned regionIdx) const
+    { return regionIsUsed_[regionIdx]; }
+
+    /*!
+     * \brief Specify whether the tables of a PVT region should be computed.
+     *
+     * This must be called after setNumRegions() and before initEnd().
+     */
+    void setRegionIsUsed(unsigned regionIdx, bool yesno)
+    { regionIsUsed_[regionIdx] = yesno; }
+
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
      */
@@ -447,10 +618,12 @@ public:
                          const Evaluation& pressure,
                          const Evaluation& Rv) const
     {
-        const Evaluation& invBg = inverseGasB_[regionIdx].eval(pressure, Rv, /*extrapolate=*/true);
-        const Evaluation& invMugBg = inverseGasBMu_[regionIdx].eval(pressure, Rv, /*extrapolate=*/true);
+        OPM_MATERIAL_TRACE_SCOPE("WetGasPvt::viscosity");
 
-        return invBg/invMugBg;
+        std::array<Evaluation, 2> invBgAndInvMugBg;
+        inverseGasBAndBMu_[regionTableIdx_[regionIdx]].eval(pressure, Rv, invBgAndInvMugBg, /*extrapolate=*/true);
+
+        return invBgAndInvMugBg[0]/invBgAndInvMugBg[1];
     }
 
     /*!
@@ -461,8 +634,13 @@ public:
                                   const Evaluation& /*temperature*/,
                                   const Evaluation& pressure) const
     {
-        const Evaluation& invBg = inverseSaturatedGasB_[regionIdx].eval(pressure, /*extrapolate=*/true);
-        const Evaluation& invMugBg = inverseSaturatedGasBMu_[regionIdx].eval(pressure, /*extrapolate=*/true);
+        OPM_MATERIAL_TRACE_SCOPE("WetGasPvt::saturatedViscosity");
+
+        // both tables use the same sampling points, so the segment which was found
+        // for the first one is reused for the second
+        typename TabulatedOneDFunction::LookupHint hint;
+        const Evaluation& invBg = inverseSaturatedGasB_[regionTableIdx_[regionIdx]].eval(pressure, hint, /*extrapolate=*/true);
+        const Evaluation& invMugBg = inverseSaturatedGasBMu_[regionTableIdx_[regionIdx]].eval(pressure, hint, /*extrapolate=*/true);
 
         return invBg/invMugBg;
     }
@@ -475,7 +653,11 @@ public:
                                             const Evaluation& /*temperature*/,
                                             const Evaluation& pressure,
                                             const Evaluation& Rv) const
-    { return inverseGasB_[regionIdx].eval(pressure, Rv, /*extrapolate=*/true); }
+    {
+        OPM_MATERIAL_TRACE_SCOPE("WetGasPvt::inverseFormationVolumeFactor");
+
+        return inverseGasB_[regionTableIdx_[regionIdx]].eval(pressure, Rv, /*extrapolate=*/true);
+    }
 
     /*!
      * \brief Returns the formation volume factor [-] of oil saturated gas at a given pressure.
@@ -484,7 +666,53 @@ public:
     Evaluation saturatedInverseFormationVolumeFactor(unsigned regionIdx,
                                                      const Evaluation& /*temperature*/,
                                                      const Evaluation& pressure) const
-    { return inverseSaturatedGasB_[regionIdx].eval(pressure, /*extrapolate=*/true); }
+    {
+        OPM_MATERIAL_TRACE_SCOPE("WetGasPvt::saturatedInverseFormationVolumeFactor");
+
+        return inverseSaturatedGasB_[regionTableIdx_[regionIdx]].eval(pressure, /*extrapolate=*/true);
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of the gas phase at once.
+     *
+     * Both quantities are determined by a single lookup into the table which stores
+     * 1/B and 1/(B mu) for each sampling point.
+     */
+    template <class Evaluation>
+    void inverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                  const Evaluation& /*temperature*/,
+                                                  const Evaluation& pressure,
+                                                  const Evaluation& Rv,
+                                                  Evaluation& invB,
+                                                  Evaluation& mu) const
+    {
+        OPM_MATERIAL_TRACE_SCOPE("WetGasPvt::inverseFormationVolumeFactorAndViscosity");
+
+        std::array<Evaluation, 2> invBgAndInvMugBg;
+        inverseGasBAndBMu_[regionTableIdx_[regionIdx]].eval(pressure, Rv, invBgAndInvMugBg, /*extrapolate=*/true);
+
+        invB = invBgAndInvMugBg[0];
+        mu = invBgAndInvMugBg[0]/invBgAndInvMugBg[1];
+    }
+
+    /*!
+     * \brief Computes the inverse formation volume factor [-] and the dynamic viscosity
+     *        [Pa s] of oil saturated gas at once.
+     */
+    template <class Evaluation>
+    void saturatedInverseFormationVolumeFactorAndViscosity(unsigned regionIdx,
+                                                           const Evaluation& /*temperature*/,
+                                                           const Evaluation& pressure,
+                                                           Evaluation& invB,
+                                                           Evaluation& mu) const
+    {
+        OPM_MATERIAL_TRACE_SCOPE("WetGasPvt::saturatedInverseFormationVolumeFactorAndViscosity");
+
+        typename TabulatedOneDFunction::LookupHint hint;
+        invB = inverseSaturatedGasB_[regionTableIdx_[regionIdx]].eval(pressure, hint, /*extrapolate=*/true);
+        mu = invB/inverseSaturatedGasBMu_[regionTableIdx_[regionIdx]].eval(pressure, hint, /*extrapolate=*/true);
+    }
 
     /*!
      * \brief Returns the oil vaporization factor \f$R_v\f$ [m^3/m^3] of the gas phase.
@@ -494,7 +722,7 @@ public:
                                               const Evaluation& /*temperature*/,
                                               const Evaluation& pressure) const
     {
-        return saturatedOilVaporizationFactorTable_[regionIdx].eval(pressure, /*extrapolate=*/true);
+        return saturatedOilVaporizationFactorTable_[regionTableIdx_[regionIdx]].eval(pressure, /*extrapolate=*/true);
     }
 
     /*!
@@ -512,7 +740,7 @@ public:
                                               Scalar maxOilSaturation) const
     {
         Evaluation tmp =
-            saturatedOilVaporizationFactorTable_[regionIdx].eval(pressure, /*extrapolate=*/true);
+            saturatedOilVaporizationFactorTable_[regionTableIdx_[regionIdx]].eval(pressure, /*extrapolate=*/true);
 
         // apply the vaporization parameters for the gas phase (cf. the Eclipse VAPPARS
         // keyword)
@@ -541,21 +769,39 @@ public:
                                   const Evaluation& temperature OPM_UNUSED,
                                   const Evaluation& Rv) const
     {
+        OPM_MATERIAL_TRACE_SCOPE("WetGasPvt::saturationPressure");
+
         typedef Opm::MathToolbox<Evaluation> Toolbox;
 
-        const auto& RvTable = saturatedOilVaporizationFactorTable_[regionIdx];
+        OPM_MATERIAL_COUNT(wetGasSaturationPressure);
+        OPM_MATERIAL_TIME_SCOPE(wetGasSaturationPressureTimer);
+
+        if (saturationPressureIsExact_[regionTableIdx_[regionIdx]]) {
+            // the tabulated function is the exact inverse of the Rv table, so a
+            // single lookup is sufficient
+            const Evaluation& pSat = saturationPressure_[regionTableIdx_[regionIdx]].eval(Rv, /*extrapolate=*/true);
+            if (pSat < 0.0)
+                return 0.0;
+            return pSat;
+        }
+
+        const auto& RvTable = saturatedOilVaporizationFactorTable_[regionTableIdx_[regionIdx]];
         const Scalar eps = std::numeric_limits<typename Toolbox::Scalar>::epsilon()*1e6;
 
         // use the tabulated saturation pressure function to get a pretty good initial value
-        Evaluation pSat = saturationPressure_[regionIdx].eval(Rv, /*extrapolate=*/true);
+        Evaluation pSat = saturationPressure_[regionTableIdx_[regionIdx]].eval(Rv, /*extrapolate=*/true);
 
         // Newton method to do the remaining work. If the initial
         // value is good, this should only take two to three
-        // iterations...
+        // iterations... Rv and its derivative are evaluated on the same
+        // segment, so it only needs to be searched once per iteration.
+        typename TabulatedOneDFunction::LookupHint hint;
         bool onProbation = false;
         for (unsigned i = 0; i < 20; ++i) {
-            const Evaluation& f = RvTable.eval(pSat, /*extrapolate=*/true) - Rv;
-            const Evaluation& fPrime = RvTable.evalDerivative(pSat, /*extrapolate=*/true);
+            OPM_MATERIAL_COUNT(wetGasSaturationPressureNewtonIteration);
+
+            const Evaluation& f = RvTable.eval(pSat, hint, /*extrapolate=*/true) - Rv;
+            const Evaluation& fPrime = RvTable.evalDerivative(pSat, hint, /*extrapolate=*/true);
 
             // If the derivative is "zero" Newton will not converge,
             // so simply return our initial guess.
@@ -590,11 +836,176 @@ public:
     }
 
 private:
+    // set the names under which the lookups of the tables of a region are reported if
+    // table profiling is enabled
+    void setProfileNames_(unsigned regionIdx)
+    {
+        const std::string prefix = "PVTG region " + std::to_string(regionIdx + 1) + " ";
+        inverseGasB_[regionIdx].setProfileName(prefix + "invB");
+        gasMu_[regionIdx].setProfileName(prefix + "mu");
+        inverseGasBAndBMu_[regionIdx].setProfileName(prefix + "invB and invBMu");
+        inverseSaturatedGasB_[regionIdx].setProfileName(prefix + "saturated invB");
+        inverseSaturatedGasBMu_[regionIdx].setProfileName(prefix + "saturated invBMu");
+        saturatedOilVaporizationFactorTable_[regionIdx].setProfileName(prefix + "Rv");
+        saturationPressure_[regionIdx].setProfileName(prefix + "pSat");
+    }
+
+    // remove the sampling points of the tables of a region which can be interpolated
+    // from their neighbors. this needs to happen before the derived tables are built.
+    // since these interpolate 1/B and 1/(B*mu), the deviations of these quantities are
+    // considered.
+    void simplifyTables_(unsigned regionIdx)
+    {
+        auto& invGasB = inverseGasB_[regionIdx];
+        auto& gasMu = gasMu_[regionIdx];
+        auto& oilVaporizationFac = saturatedOilVaporizationFactorTable_[regionIdx];
+
+        const size_t numPressures = invGasB.numX();
+        assert(gasMu.numX() == numPressures);
+
+        // the columns of the tables and the saturated quantities, which are the last
+        // sampling points of the columns
+        TabulatedTwoDFunction invGasBMu;
+        std::vector<std::vector<Scalar> > RvValues(numPressures);
+        std::vector<std::vector<Scalar> > invBValues(numPressures);
+        std::vector<std::vector<Scalar> > invBMuValues(numPressures);
+        std::vector<Scalar> allInvBValues;
+        std::vector<Scalar> allInvBMuValues;
+        std::vector<Scalar> pressures(numPressures);
+        std::vector<Scalar> invSatB(numPressures);
+        std::vector<Scalar> invSatBMu(numPressures);
+        size_t numSamplesBefore = 0;
+        for (unsigned pIdx = 0; pIdx < numPressures; ++pIdx) {
+            assert(gasMu.numY(pIdx) == invGasB.numY(pIdx));
+            invGasBMu.appendXPos(invGasB.xAt(pIdx));
+            for (unsigned rvIdx = 0; rvIdx < invGasB.numY(pIdx); ++rvIdx) {
+                const Scalar Rv = invGasB.yAt(pIdx, rvIdx);
+                const Scalar invB = invGasB.valueAt(pIdx, rvIdx);
+                RvValues[pIdx].push_back(Rv);
+                invBValues[pIdx].push_back(invB);
+                invBMuValues[pIdx].push_back(invB/gasMu.valueAt(pIdx, rvIdx));
+                invGasBMu.appendSamplePoint(pIdx, Rv, invBMuValues[pIdx].back());
+            }
+            numSamplesBefore += RvValues[pIdx].size();
+            allInvBValues.insert(allInvBValues.end(), invBValues[pIdx].begin(), invBValues[pIdx].end());
+            allInvBMuValues.insert(allInvBMuValues.end(), invBMuValues[pIdx].begin(), invBMuValues[pIdx].end());
+
+            pressures[pIdx] = invGasB.xAt(pIdx);
+            invSatB[pIdx] = invBValues[pIdx].back();
+            invSatBMu[pIdx] = invBMuValues[pIdx].back();
+        }
+
+        // the oil vaporization factor of saturated gas usually uses the same sampling
+        // points. if it does not, it is kept as is.
+        const bool simplifyRv = oilVaporizationFac.numSamples() == numPressures;
+        std::vector<Scalar> RvPressures;
+        std::vector<Scalar> RvSat;
+        for (size_t sampleIdx = 0; simplifyRv && sampleIdx < numPressures; ++sampleIdx) {
+            RvPressures.push_back(oilVaporizationFac.xAt(sampleIdx));
+            RvSat.push_back(oilVaporizationFac.valueAt(sampleIdx));
+        }
+
+        const Scalar invBTol = tableSimplificationTolerance_/2*valueRange(allInvBValues);
+        const Scalar invBMuTol = tableSimplificationTolerance_/2*valueRange(allInvBMuValues);
+        const Scalar RvTol = tableSimplificationTolerance_/2*valueRange(RvSat);
+
+        std::vector<bool> isRequiredColumn =
+            findRequiredSamples(numPressures, [&](size_t lowerIdx, size_t colIdx, size_t upperIdx) {
+                    return canSkipTableColumn(invGasB, lowerIdx, colIdx, upperIdx, invBTol)
+                        && canSkipTableColumn(invGasBMu, lowerIdx, colIdx, upperIdx, invBMuTol)
+                        && isNearlyCollinear(pressures, invSatB, lowerIdx, colIdx, upperIdx, invBTol)
+                        && isNearlyCollinear(pressures, invSatBMu, lowerIdx, colIdx, upperIdx, invBMuTol)
+                        && (!simplifyRv
+                            || isNearlyCollinear(RvPressures, RvSat, lowerIdx, colIdx, upperIdx, RvTol));
+                });
+
+        std::vector<std::vector<bool> > isRequiredSample(numPressures);
+        size_t numSamplesAfter = 0;
+        for (unsigned pIdx = 0; pIdx < numPressures; ++pIdx) {
+            if (!isRequiredColumn[pIdx])
+                continue;
+
+            const auto& Rv = RvValues[pIdx];
+            const auto& invB = invBValues[pIdx];
+            const auto& invBMu = invBMuValues[pIdx];
+            isRequiredSample[pIdx] =
+                findRequiredSamples(Rv.size(), [&](size_t lowerIdx, size_t sampleIdx, size_t upperIdx) {
+                        return isNearlyCollinear(Rv, invB, lowerIdx, sampleIdx, upperIdx, invBTol)
+                            && isNearlyCollinear(Rv, invBMu, lowerIdx, sampleIdx, upperIdx, invBMuTol);
+                    });
+            numSamplesAfter += std::count(isRequiredSample[pIdx].begin(), isRequiredSample[pIdx].end(), true);
+        }
+
+        invGasB = selectTableSamples(invGasB, isRequiredColumn, isRequiredSample);
+        gasMu = selectTableSamples(gasMu, isRequiredColumn, isRequiredSample);
+
+        if (simplifyRv) {
+            selectSamples(RvPressures, isRequiredColumn);
+            selectSamples(RvSat, isRequiredColumn);
+            oilVaporizationFac.setXYContainers(RvPressures, RvSat);
+        }
+
+        tableSimplificationStats_[regionIdx].add(numSamplesBefore, numSamplesAfter);
+    }
+
+    // let the regions whose tables are identical to the ones of a previous region use
+    // the tables of that region and release their own ones. regions which already use
+    // the tables of another region are compared using these tables.
+    void shareIdenticalRegionTables_()
+    {
+        const std::vector<unsigned>& sourceIdx =
+            findIdenticalEntries(numRegions(), [this](BinaryWriter& writer, unsigned regionIdx) {
+                    unsigned tableIdx = regionTableIdx_[regionIdx];
+                    writer.write(static_cast<std::uint8_t>(regionIsUsed_[regionIdx]));
+                    inverseGasB_[tableIdx].serialize(writer);
+                    gasMu_[tableIdx].serialize(writer);
+                    saturatedOilVaporizationFactorTable_[tableIdx].serialize(writer);
+                });
+
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            regionTableIdx_[regionIdx] = sourceIdx[regionIdx];
+            if (sourceIdx[regionIdx] == regionIdx)
+                continue;
+
+            inverseGasB_[regionIdx] = TabulatedTwoDFunction();
+            inverseSaturatedGasB_[regionIdx] = TabulatedOneDFunction();
+            gasMu_[regionIdx] = TabulatedTwoDFunction();
+            inverseGasBAndBMu_[regionIdx] = TabulatedTwoDMultiFunction();
+            inverseSaturatedGasBMu_[regionIdx] = TabulatedOneDFunction();
+            saturatedOilVaporizationFactorTable_[regionIdx] = TabulatedOneDFunction();
+            saturationPressure_[regionIdx] = TabulatedOneDFunction();
+        }
+    }
+
     void updateSaturationPressure_(unsigned regionIdx)
     {
         typedef std::pair<Scalar, Scalar> Pair;
         const auto& oilVaporizationFac = saturatedOilVaporizationFactorTable_[regionIdx];
 
+        // if Rv is strictly increasing with pressure, the inverse of the piecewise linear
+        // function Rv(p) is the piecewise linear function which uses the same sampling
+        // points with swapped coordinates. (this also holds if the functions are linearly
+        // extrapolated.) in this case, the saturation pressure can be determined using
+        // a single table lookup instead of a Newton method.
+        size_t numSamples = oilVaporizationFac.numSamples();
+        bool isStrictlyIncreasing = numSamples > 1;
+        for (size_t i = 1; i < numSamples && isStrictlyIncreasing; ++i)
+            isStrictlyIncreasing = oilVaporizationFac.valueAt(i - 1) < oilVaporizationFac.valueAt(i);
+
+        saturationPressureIsExact_[regionIdx] = isStrictlyIncreasing;
+        if (isStrictlyIncreasing) {
+            std::vector<Scalar> RvValues(numSamples);
+            std::vector<Scalar> pValues(numSamples);
+            for (size_t i = 0; i < numSamples; ++i) {
+                RvValues[i] = oilVaporizationFac.valueAt(i);
+                pValues[i] = oilVaporizationFac.xAt(i);
+            }
+            saturationPressure_[regionIdx].setXYContainers(RvValues, pValues);
+            return;
+        }
+
+        // otherwise, tabulate an approximate inverse which is used as the initial
+        // value for the Newton method.
         // create the taublated function representing saturation pressure depending of
         // Rv
         size_t n = oilVaporizationFac.numSamples();
@@ -623,12 +1034,18 @@ private:
     std::vector<TabulatedTwoDFunction> inverseGasB_;
     std::vector<TabulatedOneDFunction> inverseSaturatedGasB_;
     std::vector<TabulatedTwoDFunction> gasMu_;
-    std::vector<TabulatedTwoDFunction> inverseGasBMu_;
+    std::vector<TabulatedTwoDMultiFunction> inverseGasBAndBMu_;
     std::vector<TabulatedOneDFunction> inverseSaturatedGasBMu_;
     std::vector<TabulatedOneDFunction> saturatedOilVaporizationFactorTable_;
     std::vector<TabulatedOneDFunction> saturationPressure_;
+    std::vector<bool> saturationPressureIsExact_;
+    std::vector<bool> regionIsUsed_;
+    std::vector<TableSimplificationStats> tableSimplificationStats_;
+    // the index of the region whose tables are used by each region
+    std::vector<unsigned> regionTableIdx_;
 
     Scalar vapPar1_;
+    Scalar tableSimplificationTolerance_;
 };
 
 } // namespace Opm
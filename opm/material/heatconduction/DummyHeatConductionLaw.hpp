@@ -31,6 +31,8 @@
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
+#include <cstddef>
+
 namespace Opm
 {
 /*!
@@ -61,6 +63,21 @@ public:
         OPM_THROW(std::logic_error,
                    "No heat conduction law specified!");
     }
+
+    /*!
+     * \brief Compute the effective heat conductivities of a range of cells.
+     *
+     * If this method is called an exception is thrown at run time.
+     */
+    template <class FluidStateContainer, class Evaluation>
+    static void heatConductivityMany(Evaluation* lambda OPM_UNUSED,
+                                     const Params& params OPM_UNUSED,
+                                     const FluidStateContainer& fluidStates OPM_UNUSED,
+                                     size_t numCells OPM_UNUSED)
+    {
+        OPM_THROW(std::logic_error,
+                   "No heat conduction law specified!");
+    }
 };
 } // namespace Opm
 
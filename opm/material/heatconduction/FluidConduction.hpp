@@ -29,9 +29,11 @@
 
 #include "FluidConductionParams.hpp"
 
-#include <opm/material/common/Spline.hpp>
+#include <opm/material/fluidstates/CompositionalFluidState.hpp>
+#include <opm/material/common/MathToolbox.hpp>
 
-#include <algorithm>
+#include <cstddef>
+#include <type_traits>
 
 namespace Opm {
 /*!
@@ -49,20 +51,86 @@ public:
     typedef ParamsT Params;
     typedef typename Params::Scalar Scalar;
 
+    /*!
+     * \brief Tabulate the heat conductivity of the fluid phase depending on temperature
+     *        and pressure.
+     *
+     * The composition of the fluid phase is taken from a reference fluid state, so
+     * this is only appropriate if the conductivity of the fluid does not depend on
+     * its composition significantly. Once a table is set, heatConductivity() uses it
+     * for all states within the tabulated range and falls back to the fluid system
+     * outside of it.
+     */
+    template <class FluidState>
+    static void tabulateConductivity(Params& params,
+                                     const FluidState& referenceFluidState,
+                                     Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                                     Scalar pressMin, Scalar pressMax, unsigned nPress)
+    {
+        typedef Opm::CompositionalFluidState<Scalar, FluidSystem> TmpFluidState;
+
+        TmpFluidState fluidState;
+        fluidState.assign(referenceFluidState);
+
+        typename FluidSystem::template ParameterCache<Scalar> paramCache;
+        typename Params::ConductivityTable table(tempMin, tempMax, nTemp,
+                                                 pressMin, pressMax, nPress);
+        for (unsigned i = 0; i < nTemp; ++ i) {
+            fluidState.setTemperature(table.iToX(i));
+            for (unsigned j = 0; j < nPress; ++ j) {
+                fluidState.setPressure(phaseIdx, table.jToY(j));
+                paramCache.updatePhase(fluidState, phaseIdx);
+                const Scalar lambda =
+                    FluidSystem::template thermalConductivity<TmpFluidState, Scalar>(fluidState,
+                                                                                     paramCache,
+                                                                                     phaseIdx);
+                table.setSamplePoint(i, j, lambda);
+            }
+        }
+
+        params.setConductivityTable(table);
+    }
+
     /*!
      * \brief Given a fluid state, return the effective heat conductivity [W/m^2 / (K/m)] of the porous
      *        medium.
      */
     template <class FluidState, class Evaluation = typename FluidState::Scalar>
-    static Evaluation heatConductivity(const Params& params OPM_UNUSED,
+    static Evaluation heatConductivity(const Params& params,
                                        const FluidState& fluidState)
     {
+        if (params.hasConductivityTable()) {
+            const auto& T = Opm::decay<Evaluation>(fluidState.temperature(phaseIdx));
+            const auto& p = Opm::decay<Evaluation>(fluidState.pressure(phaseIdx));
+            const auto& table = params.conductivityTable();
+            if (table.applies(T, p))
+                return table.eval(T, p);
+        }
+
         typename FluidSystem::template ParameterCache<Evaluation> paramCache;
         paramCache.updatePhase(fluidState, phaseIdx);
         return FluidSystem::template thermalConductivity<FluidState, Evaluation>(fluidState,
                                                                                  paramCache,
                                                                                  phaseIdx);
     }
+
+    /*!
+     * \brief Compute the effective heat conductivities of a range of cells which use
+     *        the same parameter object.
+     *
+     * After calling this method, lambda[i] is the same as heatConductivity(params,
+     * fluidStates[i]) for all i < numCells.
+     */
+    template <class FluidStateContainer, class Evaluation>
+    static void heatConductivityMany(Evaluation* lambda,
+                                     const Params& params,
+                                     const FluidStateContainer& fluidStates,
+                                     size_t numCells)
+    {
+        for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            lambda[cellIdx] = heatConductivity<typename std::decay<decltype(fluidStates[cellIdx])>::type,
+                                               Evaluation>(params, fluidStates[cellIdx]);
+    }
 };
 } // namespace Opm
 
@@ -27,6 +27,8 @@
 #ifndef OPM_FLUID_HEAT_CONDUCTION_PARAMS_HPP
 #define OPM_FLUID_HEAT_CONDUCTION_PARAMS_HPP
 
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
+
 namespace Opm {
 /*!
  * \brief Parameters for the heat conduction law which just takes the conductivity of a given fluid phase.
@@ -40,10 +42,39 @@ class FluidHeatConductionParams
 
 public:
     typedef ScalarT Scalar;
+    typedef Opm::UniformTabulated2DFunction<Scalar> ConductivityTable;
 
     FluidHeatConductionParams()
+        : hasConductivityTable_(false)
     { }
 
+    /*!
+     * \brief Specify a table for the heat conductivity of the fluid depending on
+     *        temperature and pressure.
+     *
+     * The x-axis of the table is temperature [K], the y-axis is pressure [Pa].
+     */
+    void setConductivityTable(const ConductivityTable& table)
+    {
+        conductivityTable_ = table;
+        hasConductivityTable_ = true;
+    }
+
+    /*!
+     * \brief Returns true if the heat conductivity of the fluid has been tabulated.
+     */
+    bool hasConductivityTable() const
+    { return hasConductivityTable_; }
+
+    /*!
+     * \brief Returns the table for the heat conductivity of the fluid.
+     */
+    const ConductivityTable& conductivityTable() const
+    { return conductivityTable_; }
+
+private:
+    ConductivityTable conductivityTable_;
+    bool hasConductivityTable_;
 };
 
 } // namespace Opm
@@ -29,12 +29,11 @@
 
 #include "SomertonParams.hpp"
 
-#include <opm/material/common/Spline.hpp>
-
 #include <opm/common/Valgrind.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 
 #include <algorithm>
+#include <cstddef>
 
 namespace Opm
 {
@@ -112,26 +111,61 @@ public:
         return lambda;
     }
 
+    /*!
+     * \brief Compute the effective heat conductivities of a range of cells which use
+     *        the same parameter object.
+     *
+     * After calling this method, lambda[i] is the same as heatConductivity(params,
+     * fluidStates[i]) for all i < numCells. The contribution of the gas phases does
+     * not depend on the fluid state, so it is only computed once for all cells.
+     */
+    template <class FluidStateContainer, class Evaluation>
+    static void heatConductivityMany(Evaluation* lambda,
+                                     const Params& params,
+                                     const FluidStateContainer& fluidStates,
+                                     size_t numCells)
+    {
+        Scalar lambdaOffset = params.vacuumLambda();
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (!FluidSystem::isLiquid(phaseIdx))
+                lambdaOffset += params.fullySaturatedLambda(phaseIdx) - params.vacuumLambda();
+
+        for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            lambda[cellIdx] = lambdaOffset;
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (!FluidSystem::isLiquid(phaseIdx))
+                continue;
+
+            Scalar deltaLambda = params.fullySaturatedLambda(phaseIdx) - params.vacuumLambda();
+            for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                const auto& sat = Opm::decay<Evaluation>(fluidStates[cellIdx].saturation(phaseIdx));
+                lambda[cellIdx] += regularizedSqrt_(Opm::max(0.0, Opm::min(1.0, sat)))*deltaLambda;
+            }
+        }
+    }
+
 protected:
+    // the square root which is regularized by a cubic polynomial for x < xMin: the
+    // polynomial matches the value and the slope of the square root at xMin and it
+    // has the slope 2*sqrt'(xMin) at zero. this is the same as a clamped spline
+    // through (0, 0) and (xMin, sqrt(xMin)), but it is evaluated in closed form:
+    //
+    //   f(x) = sqrt(xMin)*t*(1 + t*(1 - t)/2) with t = x/xMin
     template <class Evaluation>
     static Evaluation regularizedSqrt_(const Evaluation& x)
     {
-        typedef Opm::Spline<Scalar> Spline;
-
-        static const Scalar xMin = 1e-2;
-        static const Scalar sqrtXMin = std::sqrt(xMin);
-        static const Scalar fPrimeXMin = 1.0/(2*std::sqrt(xMin));
-        static const Scalar fPrime0 = 2*fPrimeXMin;
-        static const Spline sqrtRegSpline(0, xMin, // x0, x1
-                                          0, sqrtXMin, // y0, y1
-                                          fPrime0, fPrimeXMin); // m0, m1
+        const Scalar xMin = 1e-2;
+        const Scalar sqrtXMin = 0.1; // = std::sqrt(xMin)
+        const Scalar fPrime0 = 1.0/sqrtXMin;
 
         if (x > xMin)
             return Opm::sqrt(x);
         else if (x <= 0)
             return fPrime0 * x;
-        else
-            return sqrtRegSpline.eval(x);
+
+        const Evaluation& t = x/xMin;
+        return sqrtXMin*t*(1.0 + 0.5*t*(1.0 - t));
     }
 };
 } // namespace Opm
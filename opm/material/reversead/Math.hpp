@@ -0,0 +1,246 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief The mathematical functions and the math toolbox for the variables of the
+ *        reverse-mode automatic differentiation.
+ */
+#ifndef OPM_REVERSEAD_MATH_HPP
+#define OPM_REVERSEAD_MATH_HPP
+
+#include "Variable.hpp"
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <cmath>
+#include <type_traits>
+
+namespace Opm {
+namespace ReverseAd {
+
+template <class Scalar>
+Variable<Scalar> abs(const Variable<Scalar>& x)
+{ return (x > 0.0)?x:-x; }
+
+template <class Scalar>
+Variable<Scalar> min(const Variable<Scalar>& x1, const Variable<Scalar>& x2)
+{ return (x1 < x2)?x1:x2; }
+
+template <class Scalar>
+Variable<Scalar> max(const Variable<Scalar>& x1, const Variable<Scalar>& x2)
+{ return (x1 > x2)?x1:x2; }
+
+template <class Scalar>
+Variable<Scalar> tan(const Variable<Scalar>& x)
+{
+    const Scalar tmp = std::tan(x.value());
+    return Variable<Scalar>::unary(tmp, x, 1 + tmp*tmp);
+}
+
+template <class Scalar>
+Variable<Scalar> atan(const Variable<Scalar>& x)
+{ return Variable<Scalar>::unary(std::atan(x.value()), x, 1/(1 + x.value()*x.value())); }
+
+template <class Scalar>
+Variable<Scalar> atan2(const Variable<Scalar>& x, const Variable<Scalar>& y)
+{
+    const Scalar denom = x.value()*x.value() + y.value()*y.value();
+    return Variable<Scalar>::binary(std::atan2(x.value(), y.value()),
+                                    x, y.value()/denom,
+                                    y, -x.value()/denom);
+}
+
+template <class Scalar>
+Variable<Scalar> sin(const Variable<Scalar>& x)
+{ return Variable<Scalar>::unary(std::sin(x.value()), x, std::cos(x.value())); }
+
+template <class Scalar>
+Variable<Scalar> asin(const Variable<Scalar>& x)
+{ return Variable<Scalar>::unary(std::asin(x.value()), x, 1/std::sqrt(1 - x.value()*x.value())); }
+
+template <class Scalar>
+Variable<Scalar> cos(const Variable<Scalar>& x)
+{ return Variable<Scalar>::unary(std::cos(x.value()), x, -std::sin(x.value())); }
+
+template <class Scalar>
+Variable<Scalar> acos(const Variable<Scalar>& x)
+{ return Variable<Scalar>::unary(std::acos(x.value()), x, -1/std::sqrt(1 - x.value()*x.value())); }
+
+template <class Scalar>
+Variable<Scalar> sqrt(const Variable<Scalar>& x)
+{
+    const Scalar sqrtX = std::sqrt(x.value());
+    return Variable<Scalar>::unary(sqrtX, x, 0.5/sqrtX);
+}
+
+template <class Scalar>
+Variable<Scalar> exp(const Variable<Scalar>& x)
+{
+    const Scalar expX = std::exp(x.value());
+    return Variable<Scalar>::unary(expX, x, expX);
+}
+
+template <class Scalar>
+Variable<Scalar> log(const Variable<Scalar>& x)
+{ return Variable<Scalar>::unary(std::log(x.value()), x, 1/x.value()); }
+
+// exponent is a constant
+template <class Scalar>
+Variable<Scalar> pow(const Variable<Scalar>& base, const Scalar& exp)
+{
+    const Scalar result = std::pow(base.value(), exp);
+    // the derivative is zero for base == 0 and exp > 1. avoid dividing by zero
+    const Scalar partial = (base.value() == 0.0) ? ((exp == 1.0) ? 1.0 : 0.0)
+                                                 : exp*result/base.value();
+    return Variable<Scalar>::unary(result, base, partial);
+}
+
+// base is a constant
+template <class Scalar>
+Variable<Scalar> pow(const Scalar& base, const Variable<Scalar>& exp)
+{
+    const Scalar result = std::pow(base, exp.value());
+    const Scalar partial = (base == 0.0) ? 0.0 : std::log(base)*result;
+    return Variable<Scalar>::unary(result, exp, partial);
+}
+
+template <class Scalar>
+Variable<Scalar> pow(const Variable<Scalar>& base, const Variable<Scalar>& exp)
+{
+    if (!exp.isActive())
+        return pow(base, exp.value());
+    if (!base.isActive())
+        return pow(base.value(), exp);
+
+    const Scalar result = std::pow(base.value(), exp.value());
+    if (base.value() == 0.0)
+        return Variable<Scalar>::binary(result, base, 0.0, exp, 0.0);
+
+    return Variable<Scalar>::binary(result,
+                                    base, exp.value()*result/base.value(),
+                                    exp, std::log(base.value())*result);
+}
+
+} // namespace ReverseAd
+
+template <class ScalarT>
+struct MathToolbox<ReverseAd::Variable<ScalarT> >
+{
+public:
+    typedef ScalarT Scalar;
+    typedef ReverseAd::Variable<Scalar> Evaluation;
+    typedef Scalar ValueType;
+    typedef Opm::MathToolbox<Scalar> InnerToolbox;
+
+    static Scalar value(const Evaluation& eval)
+    { return eval.value(); }
+
+    static Scalar scalarValue(const Evaluation& eval)
+    { return eval.value(); }
+
+    static Evaluation createConstant(Scalar value)
+    { return Evaluation::createConstant(value); }
+
+    // reverse-mode variables do not have a fixed set of derivatives, so the index is
+    // irrelevant and an independent variable is added to the active tape
+    static Evaluation createVariable(Scalar value, unsigned /*varIdx*/)
+    { return Evaluation::createIndependent(value); }
+
+    template <class LhsEval>
+    static typename std::enable_if<std::is_same<Evaluation, LhsEval>::value,
+                                   LhsEval>::type
+    decay(const Evaluation& eval)
+    { return eval; }
+
+    template <class LhsEval>
+    static typename std::enable_if<std::is_floating_point<LhsEval>::value,
+                                   LhsEval>::type
+    decay(const Evaluation& eval)
+    { return eval.value(); }
+
+    // comparison
+    static bool isSame(const Evaluation& a, const Evaluation& b, Scalar tolerance)
+    { return InnerToolbox::isSame(a.value(), b.value(), tolerance); }
+
+    // arithmetic functions
+    template <class Arg1Eval, class Arg2Eval>
+    static Evaluation max(const Arg1Eval& arg1, const Arg2Eval& arg2)
+    { return ReverseAd::max(Evaluation(arg1), Evaluation(arg2)); }
+
+    template <class Arg1Eval, class Arg2Eval>
+    static Evaluation min(const Arg1Eval& arg1, const Arg2Eval& arg2)
+    { return ReverseAd::min(Evaluation(arg1), Evaluation(arg2)); }
+
+    static Evaluation abs(const Evaluation& arg)
+    { return ReverseAd::abs(arg); }
+
+    static Evaluation tan(const Evaluation& arg)
+    { return ReverseAd::tan(arg); }
+
+    static Evaluation atan(const Evaluation& arg)
+    { return ReverseAd::atan(arg); }
+
+    static Evaluation atan2(const Evaluation& arg1, const Evaluation& arg2)
+    { return ReverseAd::atan2(arg1, arg2); }
+
+    static Evaluation sin(const Evaluation& arg)
+    { return ReverseAd::sin(arg); }
+
+    static Evaluation asin(const Evaluation& arg)
+    { return ReverseAd::asin(arg); }
+
+    static Evaluation cos(const Evaluation& arg)
+    { return ReverseAd::cos(arg); }
+
+    static Evaluation acos(const Evaluation& arg)
+    { return ReverseAd::acos(arg); }
+
+    static Evaluation sqrt(const Evaluation& arg)
+    { return ReverseAd::sqrt(arg); }
+
+    static Evaluation exp(const Evaluation& arg)
+    { return ReverseAd::exp(arg); }
+
+    static Evaluation log(const Evaluation& arg)
+    { return ReverseAd::log(arg); }
+
+    static Evaluation pow(const Evaluation& arg1, const Scalar& arg2)
+    { return ReverseAd::pow(arg1, arg2); }
+
+    static Evaluation pow(const Scalar& arg1, const Evaluation& arg2)
+    { return ReverseAd::pow(arg1, arg2); }
+
+    static Evaluation pow(const Evaluation& arg1, const Evaluation& arg2)
+    { return ReverseAd::pow(arg1, arg2); }
+
+    static bool isfinite(const Evaluation& arg)
+    { return std::isfinite(arg.value()); }
+
+    static bool isnan(const Evaluation& arg)
+    { return std::isnan(arg.value()); }
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,309 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ReverseAd::Tape
+ */
+#ifndef OPM_REVERSEAD_TAPE_HPP
+#define OPM_REVERSEAD_TAPE_HPP
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm {
+namespace ReverseAd {
+
+/*!
+ * \brief Records the elementary operations of a computation for reverse-mode
+ *        (adjoint) automatic differentiation.
+ *
+ * Each operation which involves at least one active variable appends a node to the
+ * tape which stores the indices of its arguments and the partial derivatives of the
+ * result with regard to them. Operations which only involve constants are not
+ * recorded. After the computation, the adjoints of all nodes with regard to one output
+ * are determined by a single backward sweep over the tape, i.e., the cost of the
+ * gradient does not depend on the number of inputs.
+ *
+ * The variables record their operations on the tape which is active for the current
+ * thread (see activate()). To limit the size of the tape, self-contained parts of a
+ * computation can be condensed after they have been evaluated using preaccumulate():
+ * the nodes recorded after a checkpoint are replaced by a single node for each output
+ * of the part which directly refers to the inputs of the part.
+ */
+template <class Scalar>
+class Tape
+{
+public:
+    //! The type which identifies a position on the tape
+    typedef std::size_t Position;
+
+    Tape()
+    { argBegin_.push_back(0); }
+
+    ~Tape()
+    {
+        if (active_() == this)
+            active_() = nullptr;
+    }
+
+    /*!
+     * \brief Make this tape the one on which the operations of the current thread get
+     *        recorded.
+     */
+    void activate()
+    { active_() = this; }
+
+    /*!
+     * \brief Stop recording operations on this tape.
+     *
+     * Afterwards, the results of operations are constants.
+     */
+    void deactivate()
+    {
+        if (active_() == this)
+            active_() = nullptr;
+    }
+
+    /*!
+     * \brief Returns the tape which is active for the current thread or nullptr if
+     *        operations are not recorded.
+     */
+    static Tape* active()
+    { return active_(); }
+
+    /*!
+     * \brief Returns the number of nodes on the tape.
+     */
+    std::size_t size() const
+    { return argBegin_.size() - 1; }
+
+    /*!
+     * \brief Remove all nodes from the tape.
+     */
+    void clear()
+    { rewind(0); }
+
+    /*!
+     * \brief Add an independent variable to the tape and return its index.
+     */
+    int registerInput()
+    {
+        argBegin_.push_back(argIdx_.size());
+        return static_cast<int>(size() - 1);
+    }
+
+    /*!
+     * \brief Record the result of an operation with a single argument.
+     *
+     * If the argument is a constant, i.e., its index is negative, nothing is recorded
+     * and -1 is returned.
+     */
+    int record(int argIdx, const Scalar& partial)
+    {
+        if (argIdx < 0)
+            return -1;
+
+        addArg_(argIdx, partial);
+        argBegin_.push_back(argIdx_.size());
+        return static_cast<int>(size() - 1);
+    }
+
+    /*!
+     * \brief Record the result of an operation with two arguments.
+     *
+     * If both arguments are constants, nothing is recorded and -1 is returned.
+     */
+    int record(int arg1Idx, const Scalar& partial1, int arg2Idx, const Scalar& partial2)
+    {
+        if (arg1Idx < 0)
+            return record(arg2Idx, partial2);
+        if (arg2Idx < 0)
+            return record(arg1Idx, partial1);
+
+        addArg_(arg1Idx, partial1);
+        addArg_(arg2Idx, partial2);
+        argBegin_.push_back(argIdx_.size());
+        return static_cast<int>(size() - 1);
+    }
+
+    /*!
+     * \name Checkpointing
+     */
+    //! \{
+
+    /*!
+     * \brief Returns the current end of the tape.
+     *
+     * The position can be passed to rewind() or preaccumulate() later.
+     */
+    Position position() const
+    { return size(); }
+
+    /*!
+     * \brief Remove all nodes which were recorded after a position.
+     *
+     * This can be used to discard the recording of a computation after its gradient
+     * has been determined, e.g. to reuse the tape for the next cell.
+     */
+    void rewind(Position pos)
+    {
+        assert(pos <= size());
+        argBegin_.resize(pos + 1);
+        argIdx_.resize(argBegin_.back());
+        partials_.resize(argBegin_.back());
+        adjoints_.clear();
+    }
+
+    /*!
+     * \brief Replace the nodes recorded after a checkpoint by one node per output.
+     *
+     * The partial derivatives of each output with regard to the nodes recorded before
+     * the checkpoint are determined by local backward sweeps. Then, the tape is
+     * rewound to the checkpoint and a node which refers to these nodes directly is
+     * recorded for each output. The indices of the outputs are updated accordingly.
+     * Outputs which were recorded before the checkpoint are left alone.
+     *
+     * \param checkpoint The position returned by position() before the part of the
+     *                   computation was evaluated
+     * \param outputIndices The indices of the outputs of the part
+     * \param numOutputs The number of outputs
+     */
+    void preaccumulate(Position checkpoint, int* outputIndices, std::size_t numOutputs)
+    {
+        typedef std::map<int, Scalar> PartialMap;
+
+        const int firstLocal = static_cast<int>(checkpoint);
+        std::vector<PartialMap> outputPartials(numOutputs);
+        std::vector<Scalar> localAdjoints;
+        for (std::size_t outIdx = 0; outIdx < numOutputs; ++outIdx) {
+            const int rootIdx = outputIndices[outIdx];
+            if (rootIdx < firstLocal)
+                continue;
+
+            localAdjoints.assign(rootIdx - firstLocal + 1, 0.0);
+            localAdjoints.back() = 1.0;
+            for (int nodeIdx = rootIdx; nodeIdx >= firstLocal; --nodeIdx) {
+                const Scalar adj = localAdjoints[nodeIdx - firstLocal];
+                if (adj == 0.0)
+                    continue;
+
+                for (std::size_t k = argBegin_[nodeIdx]; k < argBegin_[nodeIdx + 1]; ++k) {
+                    const int argIdx = argIdx_[k];
+                    if (argIdx >= firstLocal)
+                        localAdjoints[argIdx - firstLocal] += adj*partials_[k];
+                    else
+                        outputPartials[outIdx][argIdx] += adj*partials_[k];
+                }
+            }
+        }
+
+        rewind(checkpoint);
+        for (std::size_t outIdx = 0; outIdx < numOutputs; ++outIdx) {
+            if (outputIndices[outIdx] < firstLocal)
+                continue;
+
+            const PartialMap& partials = outputPartials[outIdx];
+            if (partials.empty()) {
+                // the output does not depend on any variable recorded before the
+                // checkpoint
+                outputIndices[outIdx] = -1;
+                continue;
+            }
+
+            for (const auto& argAndPartial : partials)
+                addArg_(argAndPartial.first, argAndPartial.second);
+            argBegin_.push_back(argIdx_.size());
+            outputIndices[outIdx] = static_cast<int>(size() - 1);
+        }
+    }
+    //! \}
+
+    /*!
+     * \brief Determine the adjoints of all nodes with regard to an output.
+     *
+     * Afterwards, adjoint() returns the derivative of the output with regard to a node.
+     */
+    void computeAdjoints(int outputIdx, const Scalar& seed = 1.0)
+    {
+        adjoints_.assign(size(), 0.0);
+        if (outputIdx < 0)
+            return;
+
+        if (static_cast<std::size_t>(outputIdx) >= size())
+            OPM_THROW(std::logic_error, "Node " << outputIdx << " is not on the tape");
+
+        adjoints_[outputIdx] = seed;
+        for (int nodeIdx = outputIdx; nodeIdx >= 0; --nodeIdx) {
+            const Scalar adj = adjoints_[nodeIdx];
+            if (adj == 0.0)
+                continue;
+
+            for (std::size_t k = argBegin_[nodeIdx]; k < argBegin_[nodeIdx + 1]; ++k)
+                adjoints_[argIdx_[k]] += adj*partials_[k];
+        }
+    }
+
+    /*!
+     * \brief Returns the adjoint of a node determined by the last call to
+     *        computeAdjoints().
+     *
+     * The adjoint of constants, i.e., negative indices, is zero.
+     */
+    Scalar adjoint(int nodeIdx) const
+    {
+        if (nodeIdx < 0 || static_cast<std::size_t>(nodeIdx) >= adjoints_.size())
+            return 0.0;
+        return adjoints_[nodeIdx];
+    }
+
+private:
+    static Tape*& active_()
+    {
+        static thread_local Tape* tape = nullptr;
+        return tape;
+    }
+
+    void addArg_(int argIdx, const Scalar& partial)
+    {
+        assert(0 <= argIdx && static_cast<std::size_t>(argIdx) < size());
+        argIdx_.push_back(argIdx);
+        partials_.push_back(partial);
+    }
+
+    // the arguments of node i are stored at the positions [argBegin_[i],
+    // argBegin_[i + 1]) of argIdx_ and partials_
+    std::vector<std::size_t> argBegin_;
+    std::vector<int> argIdx_;
+    std::vector<Scalar> partials_;
+    std::vector<Scalar> adjoints_;
+};
+
+} // namespace ReverseAd
+} // namespace Opm
+
+#endif
@@ -0,0 +1,318 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ReverseAd::Variable
+ */
+#ifndef OPM_REVERSEAD_VARIABLE_HPP
+#define OPM_REVERSEAD_VARIABLE_HPP
+
+#include "Tape.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+namespace Opm {
+namespace ReverseAd {
+
+/*!
+ * \brief A scalar whose operations are recorded for reverse-mode automatic
+ *        differentiation.
+ *
+ * The object stores its value and the index of the node of the active tape which
+ * represents it. Variables which are not on the tape, e.g. the ones created from
+ * primitive floating point values, are constants and have a negative index. Variables
+ * can be used as the Evaluation type of the templated material laws and PVT classes:
+ *
+ * \code
+ * typedef Opm::ReverseAd::Variable<double> Evaluation;
+ *
+ * Opm::ReverseAd::Tape<double> tape;
+ * tape.activate();
+ * Evaluation Sw = Evaluation::createIndependent(0.3);
+ * Evaluation kr = MaterialLaw::twoPhaseSatKrw(params, Sw);
+ * tape.computeAdjoints(kr.index());
+ * double dkr_dSw = tape.adjoint(Sw.index());
+ * \endcode
+ */
+template <class ScalarT>
+class Variable
+{
+public:
+    typedef ScalarT Scalar;
+    typedef ReverseAd::Tape<Scalar> Tape;
+
+    //! Construct a constant which is zero
+    Variable()
+        : value_(0.0)
+        , index_(-1)
+    {}
+
+    //! Construct a constant
+    template <class RhsValueType,
+              class = typename std::enable_if<std::is_arithmetic<RhsValueType>::value>::type>
+    Variable(const RhsValueType& value)
+        : value_(value)
+        , index_(-1)
+    {}
+
+    /*!
+     * \brief Create an independent variable on the active tape.
+     *
+     * If no tape is active, the result is a constant.
+     */
+    static Variable createIndependent(const Scalar& value)
+    {
+        Tape* tape = Tape::active();
+        return Variable(value, tape ? tape->registerInput() : -1);
+    }
+
+    //! Create a constant
+    static Variable createConstant(const Scalar& value)
+    { return Variable(value, -1); }
+
+    //! Returns the value of the variable
+    const Scalar& value() const
+    { return value_; }
+
+    /*!
+     * \brief Returns the index of the node on the tape which represents the variable.
+     *
+     * This is negative for constants.
+     */
+    int index() const
+    { return index_; }
+
+    //! Returns true if the variable is recorded on the tape
+    bool isActive() const
+    { return index_ >= 0; }
+
+    /*!
+     * \brief Replace the node of the variable.
+     *
+     * This is used to re-associate the variable after the part of the tape which
+     * computed it has been condensed by Tape::preaccumulate().
+     */
+    void setIndex(int idx)
+    { index_ = idx; }
+
+    /*!
+     * \brief Record an operation with one argument.
+     *
+     * 'partial' is the derivative of the result with regard to the argument.
+     */
+    static Variable unary(const Scalar& value, const Variable& arg, const Scalar& partial)
+    { return Variable(value, record_(arg.index_, partial)); }
+
+    /*!
+     * \brief Record an operation with two arguments.
+     */
+    static Variable binary(const Scalar& value,
+                           const Variable& arg1, const Scalar& partial1,
+                           const Variable& arg2, const Scalar& partial2)
+    { return Variable(value, record_(arg1.index_, partial1, arg2.index_, partial2)); }
+
+    void print(std::ostream& os = std::cout) const
+    { os << "v: " << value_ << " / idx: " << index_; }
+
+    Variable operator-() const
+    { return unary(-value_, *this, -1.0); }
+
+    Variable operator+() const
+    { return *this; }
+
+    Variable& operator+=(const Variable& other)
+    { return *this = *this + other; }
+
+    Variable& operator-=(const Variable& other)
+    { return *this = *this - other; }
+
+    Variable& operator*=(const Variable& other)
+    { return *this = *this * other; }
+
+    Variable& operator/=(const Variable& other)
+    { return *this = *this / other; }
+
+    friend Variable operator+(const Variable& a, const Variable& b)
+    { return binary(a.value_ + b.value_, a, 1.0, b, 1.0); }
+
+    friend Variable operator+(const Variable& a, const Scalar& b)
+    { return unary(a.value_ + b, a, 1.0); }
+
+    friend Variable operator+(const Scalar& a, const Variable& b)
+    { return unary(a + b.value_, b, 1.0); }
+
+    friend Variable operator-(const Variable& a, const Variable& b)
+    { return binary(a.value_ - b.value_, a, 1.0, b, -1.0); }
+
+    friend Variable operator-(const Variable& a, const Scalar& b)
+    { return unary(a.value_ - b, a, 1.0); }
+
+    friend Variable operator-(const Scalar& a, const Variable& b)
+    { return unary(a - b.value_, b, -1.0); }
+
+    friend Variable operator*(const Variable& a, const Variable& b)
+    { return binary(a.value_*b.value_, a, b.value_, b, a.value_); }
+
+    friend Variable operator*(const Variable& a, const Scalar& b)
+    { return unary(a.value_*b, a, b); }
+
+    friend Variable operator*(const Scalar& a, const Variable& b)
+    { return unary(a*b.value_, b, a); }
+
+    friend Variable operator/(const Variable& a, const Variable& b)
+    {
+        const Scalar invB = 1.0/b.value_;
+        const Scalar result = a.value_*invB;
+        return binary(result, a, invB, b, -result*invB);
+    }
+
+    friend Variable operator/(const Variable& a, const Scalar& b)
+    { return unary(a.value_/b, a, 1.0/b); }
+
+    friend Variable operator/(const Scalar& a, const Variable& b)
+    {
+        const Scalar result = a/b.value_;
+        return unary(result, b, -result/b.value_);
+    }
+
+    // the comparison operators only consider the values
+    friend bool operator==(const Variable& a, const Variable& b)
+    { return a.value_ == b.value_; }
+
+    friend bool operator!=(const Variable& a, const Variable& b)
+    { return a.value_ != b.value_; }
+
+    friend bool operator<(const Variable& a, const Variable& b)
+    { return a.value_ < b.value_; }
+
+    friend bool operator>(const Variable& a, const Variable& b)
+    { return a.value_ > b.value_; }
+
+    friend bool operator<=(const Variable& a, const Variable& b)
+    { return a.value_ <= b.value_; }
+
+    friend bool operator>=(const Variable& a, const Variable& b)
+    { return a.value_ >= b.value_; }
+
+    friend bool operator==(const Variable& a, const Scalar& b)
+    { return a.value_ == b; }
+
+    friend bool operator!=(const Variable& a, const Scalar& b)
+    { return a.value_ != b; }
+
+    friend bool operator<(const Variable& a, const Scalar& b)
+    { return a.value_ < b; }
+
+    friend bool operator>(const Variable& a, const Scalar& b)
+    { return a.value_ > b; }
+
+    friend bool operator<=(const Variable& a, const Scalar& b)
+    { return a.value_ <= b; }
+
+    friend bool operator>=(const Variable& a, const Scalar& b)
+    { return a.value_ >= b; }
+
+    friend bool operator==(const Scalar& a, const Variable& b)
+    { return a == b.value_; }
+
+    friend bool operator!=(const Scalar& a, const Variable& b)
+    { return a != b.value_; }
+
+    friend bool operator<(const Scalar& a, const Variable& b)
+    { return a < b.value_; }
+
+    friend bool operator>(const Scalar& a, const Variable& b)
+    { return a > b.value_; }
+
+    friend bool operator<=(const Scalar& a, const Variable& b)
+    { return a <= b.value_; }
+
+    friend bool operator>=(const Scalar& a, const Variable& b)
+    { return a >= b.value_; }
+
+private:
+    Variable(const Scalar& value, int idx)
+        : value_(value)
+        , index_(idx)
+    {}
+
+    static int record_(int argIdx, const Scalar& partial)
+    {
+        if (argIdx < 0)
+            return -1;
+
+        Tape* tape = Tape::active();
+        assert(tape);
+        return tape->record(argIdx, partial);
+    }
+
+    static int record_(int arg1Idx, const Scalar& partial1, int arg2Idx, const Scalar& partial2)
+    {
+        if (arg1Idx < 0 && arg2Idx < 0)
+            return -1;
+
+        Tape* tape = Tape::active();
+        assert(tape);
+        return tape->record(arg1Idx, partial1, arg2Idx, partial2);
+    }
+
+    Scalar value_;
+    int index_;
+};
+
+template <class Scalar>
+std::ostream& operator<<(std::ostream& os, const Variable<Scalar>& var)
+{
+    var.print(os);
+    return os;
+}
+
+/*!
+ * \brief Condense the part of the tape which computed a set of variables.
+ *
+ * This is a convenience wrapper around Tape::preaccumulate() which updates the
+ * indices of the variables.
+ */
+template <class Scalar, class VariableContainer>
+void preaccumulate(Tape<Scalar>& tape,
+                   typename Tape<Scalar>::Position checkpoint,
+                   VariableContainer& outputs)
+{
+    std::vector<int> indices;
+    for (const auto& var : outputs)
+        indices.push_back(var.index());
+
+    tape.preaccumulate(checkpoint, indices.data(), indices.size());
+
+    std::size_t i = 0;
+    for (auto& var : outputs)
+        var.setIndex(indices[i++]);
+}
+
+} // namespace ReverseAd
+} // namespace Opm
+
+#endif
@@ -0,0 +1,234 @@
+# -*- mode: python; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+# vi: set et ts=4 sw=4 sts=4:
+#
+# This file is part of the Open Porous Media project (OPM).
+#
+# OPM is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# OPM is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Consult the COPYING file in the top-level source directory of this
+# module for the precise wording of the license and the list of
+# copyright holders.
+"""NumPy bindings for the array-valued black-oil kernels of opm-material.
+
+The bindings use the C interface of opm/material/capi/OpmMaterialCApi.h, which is
+part of the opm-material library if it is configured with -DOPM_MATERIAL_CAPI=ON.
+The input arrays are passed to the kernels without copying them if they are
+C-contiguous arrays of float64 (uint32 for the PVT regions), and the results are
+written directly into the NumPy arrays which are returned. ctypes releases the GIL
+for the duration of each call, so other Python threads keep running while the
+kernels are processing the cells on all OpenMP threads.
+
+Example:
+
+    model = EclModel("NORNE_ATW2013.DATA")
+    props = model.phase_properties(pressure={OIL: p, GAS: p, WATER: p}, rs=rs)
+    kr = model.relative_permeabilities({WATER: sw, OIL: so, GAS: sg})
+
+The location of the library may be given by the OPM_MATERIAL_LIBRARY environment
+variable, otherwise it is searched for in the default locations.
+"""
+
+import ctypes
+import ctypes.util
+import os
+
+import numpy
+
+# the phase indices of the black-oil fluid system
+WATER = 0
+OIL = 1
+GAS = 2
+NUM_PHASES = 3
+
+_DoublePtr = ctypes.POINTER(ctypes.c_double)
+_UnsignedPtr = ctypes.POINTER(ctypes.c_uint)
+
+
+class _PhasePropertyInput(ctypes.Structure):
+    _fields_ = [("numCells", ctypes.c_size_t),
+                ("regionIdx", _UnsignedPtr),
+                ("temperature", _DoublePtr),
+                ("pressure", _DoublePtr*NUM_PHASES),
+                ("saturation", _DoublePtr*NUM_PHASES),
+                ("Rs", _DoublePtr),
+                ("Rv", _DoublePtr)]
+
+
+class _PhasePropertyOutput(ctypes.Structure):
+    _fields_ = [("invB", _DoublePtr*NUM_PHASES),
+                ("density", _DoublePtr*NUM_PHASES),
+                ("viscosity", _DoublePtr*NUM_PHASES),
+                ("saturatedDissolutionFactor", _DoublePtr*NUM_PHASES)]
+
+
+def _load_library():
+    path = os.environ.get("OPM_MATERIAL_LIBRARY") or ctypes.util.find_library("opmmaterial")
+    if not path:
+        raise OSError("The opm-material library was not found. Set OPM_MATERIAL_LIBRARY.")
+    lib = ctypes.CDLL(path)
+
+    lib.opm_material_last_error.restype = ctypes.c_char_p
+    lib.opm_material_last_error.argtypes = []
+    lib.opm_material_ecl_model_create.restype = ctypes.c_void_p
+    lib.opm_material_ecl_model_create.argtypes = [ctypes.c_char_p]
+    lib.opm_material_ecl_model_destroy.restype = None
+    lib.opm_material_ecl_model_destroy.argtypes = [ctypes.c_void_p]
+    lib.opm_material_ecl_model_num_cells.restype = ctypes.c_size_t
+    lib.opm_material_ecl_model_num_cells.argtypes = [ctypes.c_void_p]
+    lib.opm_material_ecl_model_phase_is_active.restype = ctypes.c_int
+    lib.opm_material_ecl_model_phase_is_active.argtypes = [ctypes.c_void_p, ctypes.c_uint]
+    lib.opm_material_ecl_model_phase_properties.restype = ctypes.c_int
+    lib.opm_material_ecl_model_phase_properties.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(_PhasePropertyInput),
+        ctypes.POINTER(_PhasePropertyOutput)]
+    for name in ("opm_material_ecl_model_relative_permeabilities",
+                 "opm_material_ecl_model_capillary_pressures"):
+        fn = getattr(lib, name)
+        fn.restype = ctypes.c_int
+        fn.argtypes = [ctypes.c_void_p,
+                       ctypes.POINTER(_DoublePtr),
+                       ctypes.POINTER(_DoublePtr),
+                       ctypes.c_size_t,
+                       ctypes.c_size_t]
+    return lib
+
+
+_lib = None
+
+
+def _library():
+    global _lib
+    if _lib is None:
+        _lib = _load_library()
+    return _lib
+
+
+def _check(status):
+    if status != 0:
+        raise RuntimeError(_library().opm_material_last_error().decode())
+
+
+def _input_array(values, num_cells, dtype=numpy.float64):
+    """Returns a view of an input array which can be passed to the C interface.
+
+    Only arrays of a different type or memory layout are copied."""
+    if values is None:
+        return None
+    values = numpy.ascontiguousarray(values, dtype=dtype)
+    if values.shape != (num_cells,):
+        raise ValueError("Expected an array of %d values, got shape %s"
+                         % (num_cells, values.shape))
+    return values
+
+
+def _pointer(values, ptr_type=_DoublePtr):
+    if values is None:
+        return ptr_type()
+    return values.ctypes.data_as(ptr_type)
+
+
+class EclModel(object):
+    """The PVT properties and the saturation functions of an ECL deck."""
+
+    def __init__(self, deck_file_name):
+        lib = _library()
+        self._handle = lib.opm_material_ecl_model_create(deck_file_name.encode())
+        if not self._handle:
+            raise RuntimeError(lib.opm_material_last_error().decode())
+
+    def __del__(self):
+        if getattr(self, "_handle", None):
+            _library().opm_material_ecl_model_destroy(self._handle)
+            self._handle = None
+
+    @property
+    def num_cells(self):
+        """The number of active cells, i.e., the size of the saturation function arrays."""
+        return _library().opm_material_ecl_model_num_cells(self._handle)
+
+    def phase_is_active(self, phase_idx):
+        return bool(_library().opm_material_ecl_model_phase_is_active(self._handle, phase_idx))
+
+    def phase_properties(self, pressure, temperature=None, saturation=None,
+                         rs=None, rv=None, region=None,
+                         quantities=("invB", "density", "viscosity")):
+        """Compute PVT properties of the active phases for arrays of cells.
+
+        'pressure' and 'saturation' map phase indices to arrays. The result maps the
+        names of the requested quantities to dictionaries from the phase index to the
+        array of values. Possible quantities are 'invB', 'density', 'viscosity' and
+        'saturatedDissolutionFactor'."""
+        phases = [phase_idx for phase_idx in range(NUM_PHASES) if self.phase_is_active(phase_idx)]
+        num_cells = len(pressure[phases[0]])
+        saturation = saturation or {}
+
+        # keep references to all arrays until the call has returned
+        inputs = {"regionIdx": _input_array(region, num_cells, numpy.uint32),
+                  "temperature": _input_array(temperature, num_cells),
+                  "Rs": _input_array(rs, num_cells),
+                  "Rv": _input_array(rv, num_cells),
+                  "pressure": [_input_array(pressure.get(i), num_cells) for i in range(NUM_PHASES)],
+                  "saturation": [_input_array(saturation.get(i), num_cells) for i in range(NUM_PHASES)]}
+
+        c_input = _PhasePropertyInput()
+        c_input.numCells = num_cells
+        c_input.regionIdx = _pointer(inputs["regionIdx"], _UnsignedPtr)
+        c_input.temperature = _pointer(inputs["temperature"])
+        c_input.Rs = _pointer(inputs["Rs"])
+        c_input.Rv = _pointer(inputs["Rv"])
+        for phase_idx in range(NUM_PHASES):
+            c_input.pressure[phase_idx] = _pointer(inputs["pressure"][phase_idx])
+            c_input.saturation[phase_idx] = _pointer(inputs["saturation"][phase_idx])
+
+        result = {}
+        c_output = _PhasePropertyOutput()
+        for quantity in quantities:
+            result[quantity] = {}
+            for phase_idx in phases:
+                values = numpy.empty(num_cells)
+                result[quantity][phase_idx] = values
+                getattr(c_output, quantity)[phase_idx] = _pointer(values)
+
+        _check(_library().opm_material_ecl_model_phase_properties(self._handle,
+                                                                  ctypes.byref(c_input),
+                                                                  ctypes.byref(c_output)))
+        return result
+
+    def relative_permeabilities(self, saturations, begin_cell=0):
+        """Relative permeabilities of the cells [begin_cell, begin_cell + n).
+
+        'saturations' maps all three phase indices to arrays of n values; the
+        saturations of inactive phases must be zero."""
+        return self._saturation_functions("opm_material_ecl_model_relative_permeabilities",
+                                          saturations, begin_cell)
+
+    def capillary_pressures(self, saturations, begin_cell=0):
+        """Capillary pressures of the cells [begin_cell, begin_cell + n)."""
+        return self._saturation_functions("opm_material_ecl_model_capillary_pressures",
+                                          saturations, begin_cell)
+
+    def _saturation_functions(self, name, saturations, begin_cell):
+        num_cells = len(saturations[WATER])
+        inputs = [_input_array(saturations[phase_idx], num_cells) for phase_idx in range(NUM_PHASES)]
+        results = [numpy.empty(num_cells) for _ in range(NUM_PHASES)]
+
+        c_saturations = (_DoublePtr*NUM_PHASES)(*[_pointer(values) for values in inputs])
+        c_results = (_DoublePtr*NUM_PHASES)(*[_pointer(values) for values in results])
+        _check(getattr(_library(), name)(self._handle,
+                                         c_results,
+                                         c_saturations,
+                                         begin_cell,
+                                         begin_cell + num_cells))
+        return dict(enumerate(results))
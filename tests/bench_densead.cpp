@@ -0,0 +1,184 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Micro benchmarks for the operators and functions of the dense automatic
+ *        differentiation code.
+ *
+ * For each number of derivatives from 1 to 12, the time per evaluation of the
+ * arithmetic operators, exp(), pow() and sqrt() is measured. This file is compiled
+ * twice: as bench_densead, which uses the specializations of the Evaluation class
+ * generated by bin/genEvalSpecializations.py, and as bench_densead_generic, which
+ * only uses the generic class template (see tests/bench_densead_generic.cpp). Both
+ * programs use the same names for the benchmarks, so the specializations can be
+ * checked against the generic code and against a stored baseline using
+ *
+ * \code
+ * bench_densead_generic --output=generic.txt
+ * bench_densead --reference=generic.txt --reference=baseline.txt
+ * \endcode
+ *
+ * The options are described in tests/benchmarkHarness.hpp.
+ */
+#include "config.h"
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include "benchmarkHarness.hpp"
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+// the number of inputs of each benchmark which are evaluated per run
+static const unsigned numInputs = 1024;
+
+// the largest number of derivatives which is benchmarked. this corresponds to the
+// default of bin/genEvalSpecializations.py
+static const int maxDerivs = 12;
+
+/*!
+ * \brief Create evaluations with uniformly distributed values within [minValue,
+ *        maxValue] and uniformly distributed derivatives within [-1, 1].
+ *
+ * All derivatives are non-zero so that the compiler cannot skip any of them.
+ */
+template <class Evaluation>
+std::vector<Evaluation> createInputs(double minValue, double maxValue, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> valueDistribution(minValue, maxValue);
+    std::uniform_real_distribution<double> derivDistribution(-1.0, 1.0);
+
+    std::vector<Evaluation> inputs(numInputs);
+    for (auto& input : inputs) {
+        input.setValue(valueDistribution(generator));
+        for (int varIdx = 0; varIdx < Evaluation::size; ++varIdx)
+            input.setDerivative(varIdx, derivDistribution(generator));
+    }
+    return inputs;
+}
+
+// the sum of the value and all derivatives of an evaluation
+template <class Evaluation>
+double checksum(const Evaluation& eval)
+{
+    double sum = eval.value();
+    for (int varIdx = 0; varIdx < Evaluation::size; ++varIdx)
+        sum += eval.derivative(varIdx);
+    return sum;
+}
+
+/*!
+ * \brief Benchmark an operation which takes one or two evaluations.
+ *
+ * The results are stored in an array, i.e., the derivatives must be computed even if
+ * the compiler inlines the whole operation.
+ */
+template <class Evaluation, class Op>
+void benchmarkOperation(BenchmarkResults& results,
+                        const std::string& name,
+                        const std::vector<Evaluation>& x,
+                        const std::vector<Evaluation>& y,
+                        const Op& op)
+{
+    std::vector<Evaluation> out(numInputs);
+    runBenchmark(results, name + " [" + EvaluationName<Evaluation>::get() + "]", numInputs,
+                 [&]() {
+                     for (unsigned i = 0; i < numInputs; ++i)
+                         out[i] = op(x[i], y[i]);
+                     return checksum(out.front()) + checksum(out.back());
+                 });
+}
+
+template <int numDerivs>
+void benchmarkNumDerivs(BenchmarkResults& results)
+{
+    typedef Opm::DenseAd::Evaluation<double, numDerivs> Eval;
+
+    // the values are positive and away from zero so that all operations are defined
+    const auto x = createInputs<Eval>(0.5, 2.0, /*seed=*/1);
+    const auto y = createInputs<Eval>(0.5, 2.0, /*seed=*/2);
+
+    benchmarkOperation(results, "operator+", x, y,
+                       [](const Eval& a, const Eval& b) -> Eval { return a + b; });
+    benchmarkOperation(results, "operator-", x, y,
+                       [](const Eval& a, const Eval& b) -> Eval { return a - b; });
+    benchmarkOperation(results, "operator*", x, y,
+                       [](const Eval& a, const Eval& b) -> Eval { return a*b; });
+    benchmarkOperation(results, "operator/", x, y,
+                       [](const Eval& a, const Eval& b) -> Eval { return a/b; });
+    benchmarkOperation(results, "exp", x, y,
+                       [](const Eval& a, const Eval& /* b */) -> Eval { return Opm::exp(a); });
+    benchmarkOperation(results, "pow(x, y)", x, y,
+                       [](const Eval& a, const Eval& b) -> Eval { return Opm::pow(a, b); });
+    benchmarkOperation(results, "pow(x, 2.5)", x, y,
+                       [](const Eval& a, const Eval& /* b */) -> Eval { return Opm::pow(a, 2.5); });
+    benchmarkOperation(results, "sqrt", x, y,
+                       [](const Eval& a, const Eval& /* b */) -> Eval { return Opm::sqrt(a); });
+}
+
+template <int numDerivs>
+struct BenchmarkUpTo
+{
+    static void run(BenchmarkResults& results)
+    {
+        BenchmarkUpTo<numDerivs - 1>::run(results);
+        benchmarkNumDerivs<numDerivs>(results);
+    }
+};
+
+template <>
+struct BenchmarkUpTo<0>
+{
+    static void run(BenchmarkResults& /* results */)
+    {}
+};
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    BenchmarkOptions options;
+    if (!parseBenchmarkOptions(options, argc, argv))
+        return 1;
+
+    if (OPM_DENSEAD_DISABLE_SPECIALIZATIONS)
+        std::cout << "Benchmarking the generic Evaluation class template\n";
+    else
+        std::cout << "Benchmarking the specializations of the Evaluation class\n";
+
+    BenchmarkResults results;
+    BenchmarkUpTo<maxDerivs>::run(results);
+
+    return checkBenchmarkResults(results, options);
+}
@@ -0,0 +1,403 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Throughput benchmarks for the API of all fluid systems.
+ *
+ * This is the timed counterpart of checkFluidSystem() (see
+ * opm/material/checkFluidSystem.hpp): For each fluid system, the methods which are
+ * visited by the API check -- updating the parameter cache, density(), viscosity(),
+ * enthalpy(), heatCapacity(), thermalConductivity(), fugacityCoefficient() and
+ * diffusionCoefficient() -- are called in a loop over a set of fluid states and the
+ * time per call is reported. This allows to compare the fluid systems with each other
+ * and to spot the methods which got slower after a change, e.g., using
+ *
+ * \code
+ * bench_fluidsystems --output=reference.txt
+ * # ... modify the code and rebuild ...
+ * bench_fluidsystems --reference=reference.txt
+ * \endcode
+ *
+ * (See tests/benchmarkHarness.hpp for the options.) Methods which are not provided
+ * by a fluid system or which throw for the benchmarked states are reported as
+ * unavailable and skipped. The black-oil fluid system is only benchmarked if
+ * opm-parser is available.
+ */
+#include "config.h"
+
+#include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <opm/material/fluidstates/CompositionalFluidState.hpp>
+
+#include <opm/material/fluidsystems/SinglePhaseFluidSystem.hpp>
+#include <opm/material/fluidsystems/TwoPhaseImmiscibleFluidSystem.hpp>
+#include <opm/material/fluidsystems/BrineCO2FluidSystem.hpp>
+#include <opm/material/fluidsystems/H2ON2FluidSystem.hpp>
+#include <opm/material/fluidsystems/H2ON2LiquidPhaseFluidSystem.hpp>
+#include <opm/material/fluidsystems/H2OAirFluidSystem.hpp>
+#include <opm/material/fluidsystems/H2OAirMesityleneFluidSystem.hpp>
+#include <opm/material/fluidsystems/H2OAirXyleneFluidSystem.hpp>
+#include <opm/material/fluidsystems/Spe5FluidSystem.hpp>
+
+#include <opm/material/components/SimpleH2O.hpp>
+#include <opm/material/components/H2O.hpp>
+#include <opm/material/components/N2.hpp>
+
+#if HAVE_OPM_PARSER
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#endif
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include "benchmarkHarness.hpp"
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Opm {
+namespace FluidSystemsBenchmark {
+#include <opm/material/components/co2tables.inc>
+}}
+
+namespace {
+// the number of fluid states for which each method is called per run
+static const unsigned numStates = 256;
+
+#if HAVE_OPM_PARSER
+// a deck which specifies the PVT properties of a live oil, a wet gas and water
+static const char* blackOilDeckString =
+    "RUNSPEC\n"
+    "DIMENS\n"
+    "   1 1 1 /\n"
+    "TABDIMS\n"
+    "/\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "DISGAS\n"
+    "VAPOIL\n"
+    "METRIC\n"
+    "GRID\n"
+    "DX\n"
+    "   1*100 /\n"
+    "DY\n"
+    "   1*100 /\n"
+    "DZ\n"
+    "   1*10 /\n"
+    "TOPS\n"
+    "   1*2000 /\n"
+    "PROPS\n"
+    "DENSITY\n"
+    "   800.0 1000.0 0.9 /\n"
+    "PVTW\n"
+    "   200.0 1.02 4.5e-5 0.5 0.0 /\n"
+    "PVTO\n"
+    "   10.0   20.0     1.05  1.50\n"
+    "         300.0     1.03  1.80 /\n"
+    "   50.0  100.0     1.15  1.20\n"
+    "         300.0     1.13  1.40 /\n"
+    "  100.0  200.0     1.25  0.90\n"
+    "         300.0     1.24  1.00 /\n"
+    "/\n"
+    "PVTG\n"
+    "    10.0     1.0e-4  0.100   0.010\n"
+    "             0.0     0.099   0.009 /\n"
+    "   100.0     5.0e-4  0.010   0.015\n"
+    "             0.0     0.0099  0.014 /\n"
+    "   300.0     1.0e-3  0.004   0.025\n"
+    "             0.0     0.0039  0.024 /\n"
+    "/\n";
+#endif
+
+/*!
+ * \brief Create fluid states with random temperatures and pressures.
+ *
+ * Like in checkFluidSystem(), all phases have the same composition. The temperature,
+ * the pressure of the first phase and the mole fraction of the first component are
+ * primary variables if automatic differentiation is used. The random generator is
+ * seeded deterministically so that all runs use the same states.
+ */
+template <class FluidState>
+std::vector<FluidState> createFluidStates(double minPressure, double maxPressure)
+{
+    typedef typename FluidState::Scalar Evaluation;
+    typedef Opm::MathToolbox<Evaluation> Toolbox;
+    typedef typename Toolbox::Scalar Scalar;
+    enum { numPhases = FluidState::numPhases };
+    enum { numComponents = FluidState::numComponents };
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    std::vector<FluidState> fluidStates(numStates);
+    for (auto& fs : fluidStates) {
+        const Scalar T = static_cast<Scalar>(293.15 + 60.0*uniform(generator));
+        const Scalar p = static_cast<Scalar>(minPressure + (maxPressure - minPressure)*uniform(generator));
+        const Scalar x = static_cast<Scalar>(1.0/numComponents);
+
+        fs.setTemperature(Toolbox::createVariable(T, /*varIdx=*/0));
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            // the pressures of the phases differ by a small capillary pressure
+            const Evaluation pPhase = Toolbox::createVariable(p, /*varIdx=*/1) + 1e3*phaseIdx;
+            fs.setPressure(phaseIdx, pPhase);
+            fs.setSaturation(phaseIdx, 1.0/numPhases);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                if (compIdx == 0 && numComponents > 1)
+                    fs.setMoleFraction(phaseIdx, compIdx, Toolbox::createVariable(x, /*varIdx=*/2));
+                else
+                    fs.setMoleFraction(phaseIdx, compIdx, x);
+            }
+        }
+    }
+    return fluidStates;
+}
+
+/*!
+ * \brief Benchmark a method of a fluid system.
+ *
+ * 'fn' calls the method for a single fluid state and parameter cache and returns the
+ * sum of the results; 'callsPerState' is the number of calls of the method this
+ * corresponds to. If 'fn' throws for any of the states, the method is not
+ * benchmarked.
+ */
+template <class FluidState, class ParameterCache, class Fn>
+void benchmarkMethod(BenchmarkResults& results,
+                     const std::string& name,
+                     const std::vector<FluidState>& fluidStates,
+                     std::vector<ParameterCache>& paramCaches,
+                     unsigned callsPerState,
+                     const Fn& fn)
+{
+    try {
+        for (unsigned stateIdx = 0; stateIdx < numStates; ++stateIdx)
+            fn(fluidStates[stateIdx], paramCaches[stateIdx]);
+    }
+    catch (...) {
+        std::cout << std::left << std::setw(72) << name
+                  << std::right << std::setw(20) << "(unavailable)" << "\n";
+        return;
+    }
+
+    runBenchmark(results, name, numStates*callsPerState,
+                 [&]() {
+                     double sum = 0.0;
+                     for (unsigned stateIdx = 0; stateIdx < numStates; ++stateIdx)
+                         sum += static_cast<double>(Opm::scalarValue(fn(fluidStates[stateIdx],
+                                                                        paramCaches[stateIdx])));
+                     return sum;
+                 });
+}
+
+/*!
+ * \brief Benchmark the API of a fluid system which is visited by checkFluidSystem().
+ *
+ * The fluid system must have been initialized. The results are named like
+ * "H2ON2::density [Evaluation<3>]".
+ */
+template <class FluidSystem, class Evaluation, class ParameterCache = typename FluidSystem::template ParameterCache<Evaluation> >
+void benchmarkFluidSystem(BenchmarkResults& results,
+                          const std::string& fluidSystemName,
+                          double minPressure,
+                          double maxPressure,
+                          std::vector<ParameterCache> paramCaches = std::vector<ParameterCache>(numStates))
+{
+    typedef Opm::CompositionalFluidState<Evaluation, FluidSystem> FluidState;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    const auto fluidStates = createFluidStates<FluidState>(minPressure, maxPressure);
+    const std::string suffix = " [" + EvaluationName<Evaluation>::get() + "]";
+    const auto methodName = [&](const std::string& method)
+        { return fluidSystemName + "::" + method + suffix; };
+
+    // the parameter caches are updated first because all other methods use them
+    benchmarkMethod(results, methodName("ParameterCache::updateAll"), fluidStates, paramCaches, 1,
+                    [](const FluidState& fs, ParameterCache& paramCache) {
+                        paramCache.updateAll(fs);
+                        return Evaluation(0.0);
+                    });
+
+    // the quantities of the phases
+    typedef Evaluation (*PhaseMethod)(const FluidState&, const ParameterCache&, unsigned);
+    const std::vector<std::pair<std::string, PhaseMethod> > phaseMethods = {
+        { "density", [](const FluidState& fs, const ParameterCache& pc, unsigned phaseIdx)
+          { return FluidSystem::template density<FluidState, Evaluation>(fs, pc, phaseIdx); } },
+        { "viscosity", [](const FluidState& fs, const ParameterCache& pc, unsigned phaseIdx)
+          { return FluidSystem::template viscosity<FluidState, Evaluation>(fs, pc, phaseIdx); } },
+        { "enthalpy", [](const FluidState& fs, const ParameterCache& pc, unsigned phaseIdx)
+          { return FluidSystem::template enthalpy<FluidState, Evaluation>(fs, pc, phaseIdx); } },
+        { "heatCapacity", [](const FluidState& fs, const ParameterCache& pc, unsigned phaseIdx)
+          { return FluidSystem::template heatCapacity<FluidState, Evaluation>(fs, pc, phaseIdx); } },
+        { "thermalConductivity", [](const FluidState& fs, const ParameterCache& pc, unsigned phaseIdx)
+          { return FluidSystem::template thermalConductivity<FluidState, Evaluation>(fs, pc, phaseIdx); } }
+    };
+    for (const auto& method : phaseMethods) {
+        const PhaseMethod fn = method.second;
+        benchmarkMethod(results, methodName(method.first), fluidStates, paramCaches, numPhases,
+                        [fn](const FluidState& fs, const ParameterCache& paramCache) {
+                            Evaluation sum = 0.0;
+                            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                                sum += fn(fs, paramCache, phaseIdx);
+                            return sum;
+                        });
+    }
+
+    // the quantities of the components in the phases
+    typedef Evaluation (*ComponentMethod)(const FluidState&, const ParameterCache&, unsigned, unsigned);
+    const std::vector<std::pair<std::string, ComponentMethod> > componentMethods = {
+        { "fugacityCoefficient", [](const FluidState& fs, const ParameterCache& pc, unsigned phaseIdx, unsigned compIdx)
+          { return FluidSystem::template fugacityCoefficient<FluidState, Evaluation>(fs, pc, phaseIdx, compIdx); } },
+        { "diffusionCoefficient", [](const FluidState& fs, const ParameterCache& pc, unsigned phaseIdx, unsigned compIdx)
+          { return FluidSystem::template diffusionCoefficient<FluidState, Evaluation>(fs, pc, phaseIdx, compIdx); } }
+    };
+    for (const auto& method : componentMethods) {
+        const ComponentMethod fn = method.second;
+        benchmarkMethod(results, methodName(method.first), fluidStates, paramCaches, numPhases*numComponents,
+                        [fn](const FluidState& fs, const ParameterCache& paramCache) {
+                            Evaluation sum = 0.0;
+                            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                                    sum += fn(fs, paramCache, phaseIdx, compIdx);
+                            return sum;
+                        });
+    }
+}
+
+template <class Evaluation>
+void benchmarkAllFluidSystems(BenchmarkResults& results)
+{
+    typedef double Scalar;
+    typedef Opm::LiquidPhase<Scalar, Opm::H2O<Scalar> > Liquid;
+    typedef Opm::GasPhase<Scalar, Opm::N2<Scalar> > Gas;
+
+    // the pressures of all fluid systems except the ones for reservoir conditions are
+    // close to atmospheric conditions because the vapor of the IAPWS water model
+    // cannot be compressed much further
+    const double minLowPressure = 1e5;
+    const double maxLowPressure = 2e5;
+
+    const double minReservoirPressure = 50e5;
+    const double maxReservoirPressure = 250e5;
+
+#if HAVE_OPM_PARSER
+    {   typedef Opm::FluidSystems::BlackOil<Scalar> FluidSystem;
+        typedef typename FluidSystem::template ParameterCache<Evaluation> ParameterCache;
+        Opm::Parser parser;
+        Opm::ParseContext parseContext;
+        const auto deck = parser.parseString(blackOilDeckString, parseContext);
+        const Opm::EclipseState eclState(deck, parseContext);
+        FluidSystem::initFromDeck(deck, eclState);
+
+        // the parameter cache of the black-oil fluid system is not default constructible
+        std::vector<ParameterCache> paramCaches(numStates, ParameterCache(/*maxOilSat=*/1.0, /*regionIdx=*/0));
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "BlackOil",
+                                                      minReservoirPressure, maxReservoirPressure,
+                                                      paramCaches); }
+#endif
+
+    {   typedef Opm::FluidSystems::BrineCO2<Scalar, Opm::FluidSystemsBenchmark::CO2Tables> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "BrineCO2",
+                                                      minReservoirPressure, maxReservoirPressure); }
+
+    {   typedef Opm::FluidSystems::H2ON2<Scalar, /*enableComplexRelations=*/false> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "H2ON2<simple>",
+                                                      minLowPressure, maxLowPressure); }
+
+    {   typedef Opm::FluidSystems::H2ON2<Scalar, /*enableComplexRelations=*/true> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "H2ON2<complex>",
+                                                      minLowPressure, maxLowPressure); }
+
+    {   typedef Opm::FluidSystems::H2ON2LiquidPhase<Scalar, /*enableComplexRelations=*/true> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "H2ON2LiquidPhase",
+                                                      minLowPressure, maxLowPressure); }
+
+    {   typedef Opm::FluidSystems::H2OAir<Scalar, Opm::SimpleH2O<Scalar>, /*enableComplexRelations=*/true> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "H2OAir<SimpleH2O>",
+                                                      minLowPressure, maxLowPressure); }
+
+    {   typedef Opm::FluidSystems::H2OAir<Scalar, Opm::H2O<Scalar>, /*enableComplexRelations=*/true> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "H2OAir<H2O>",
+                                                      minLowPressure, maxLowPressure); }
+
+    {   typedef Opm::FluidSystems::H2OAirMesitylene<Scalar> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "H2OAirMesitylene",
+                                                      minLowPressure, maxLowPressure); }
+
+    {   typedef Opm::FluidSystems::H2OAirXylene<Scalar> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "H2OAirXylene",
+                                                      minLowPressure, maxLowPressure); }
+
+    {   typedef Opm::FluidSystems::Spe5<Scalar> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "Spe5",
+                                                      minReservoirPressure, maxReservoirPressure); }
+
+    {   typedef Opm::FluidSystems::TwoPhaseImmiscible<Scalar, Liquid, Gas> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "TwoPhaseImmiscible",
+                                                      minLowPressure, maxLowPressure); }
+
+    {   typedef Opm::FluidSystems::SinglePhase<Scalar, Liquid> FluidSystem;
+        FluidSystem::init();
+        benchmarkFluidSystem<FluidSystem, Evaluation>(results, "SinglePhase",
+                                                      minLowPressure, maxLowPressure); }
+}
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    BenchmarkOptions options;
+    if (!parseBenchmarkOptions(options, argc, argv))
+        return 1;
+
+    BenchmarkResults results;
+    benchmarkAllFluidSystems<double>(results);
+    benchmarkAllFluidSystems<Opm::DenseAd::Evaluation<double, 3> >(results);
+
+    return checkBenchmarkResults(results, options);
+}
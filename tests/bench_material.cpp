@@ -0,0 +1,538 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Micro benchmarks for the table lookups, the black-oil PVT classes, the
+ *        ECL saturation functions, the NCP flash solver and some components.
+ *
+ * Each benchmark prints the time per evaluation in nanoseconds, once for scalars
+ * and once for each tested number of derivatives of the automatic differentiation
+ * code. The results can be written to a file using '--output=FILE'; such a file can
+ * then be passed as '--reference=FILE' to later runs. In the latter case, the
+ * program reports the benchmarks which got slower than the reference by more than
+ * the factor given by '--tolerance=FACTOR' (default: 1.25) and exits with a
+ * non-zero status if there are any. (See tests/benchmarkHarness.hpp.) Since the
+ * results depend on the machine and the compiler, the reference must be recorded in
+ * the same environment.
+ *
+ * The benchmarks for the PVT classes and for the EclMaterialLawManager require the
+ * opm-parser module and are skipped if it is unavailable.
+ */
+#include "config.h"
+
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/UniformXTabulated2DFunction.hpp>
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/TableProfiler.hpp>
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <opm/material/constraintsolvers/NcpFlash.hpp>
+#include <opm/material/constraintsolvers/MiscibleMultiPhaseComposition.hpp>
+#include <opm/material/fluidstates/CompositionalFluidState.hpp>
+#include <opm/material/fluidsystems/H2ON2FluidSystem.hpp>
+#include <opm/material/fluidmatrixinteractions/RegularizedBrooksCorey.hpp>
+#include <opm/material/fluidmatrixinteractions/EffToAbsLaw.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
+
+#include <opm/material/components/H2O.hpp>
+#include <opm/material/components/CO2.hpp>
+
+#if HAVE_OPM_PARSER
+#include <opm/material/fluidsystems/blackoilpvt/LiveOilPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/DeadOilPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/ConstantCompressibilityOilPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/WetGasPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/DryGasPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/ConstantCompressibilityWaterPvt.hpp>
+#include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
+
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#endif
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include "benchmarkHarness.hpp"
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Opm {
+namespace MaterialBenchmark {
+#include <opm/material/components/co2tables.inc>
+}}
+
+#if HAVE_OPM_PARSER
+// a deck which specifies one table for each of the black-oil PVT keywords
+static const char* pvtDeckString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   10 10 3 /\n"
+    "\n"
+    "TABDIMS\n"
+    "/\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "\n"
+    "DISGAS\n"
+    "VAPOIL\n"
+    "\n"
+    "METRIC\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "   300*1000 /\n"
+    "DY\n"
+    "   300*1000 /\n"
+    "DZ\n"
+    "   100*20 100*30 100*50 /\n"
+    "\n"
+    "TOPS\n"
+    "   100*1234 /\n"
+    "\n"
+    "PROPS\n"
+    "\n"
+    "DENSITY\n"
+    "   800.0 1000.0 0.9 /\n"
+    "\n"
+    "PVTW\n"
+    "   200.0 1.02 4.5e-5 0.5 0.0 /\n"
+    "\n"
+    "PVCDO\n"
+    "   200.0 1.2 1.5e-4 1.1 2.0e-5 /\n"
+    "\n"
+    "PVDO\n"
+    "   10.0  1.10 1.00\n"
+    "  100.0  1.08 1.05\n"
+    "  200.0  1.06 1.10\n"
+    "  300.0  1.04 1.15 /\n"
+    "\n"
+    "PVTO\n"
+    "-- RS    PRESSURE  BO    VISCOSITY\n"
+    "   10.0   20.0     1.05  1.50\n"
+    "         300.0     1.03  1.80 /\n"
+    "   50.0  100.0     1.15  1.20\n"
+    "         300.0     1.13  1.40 /\n"
+    "  100.0  200.0     1.25  0.90\n"
+    "         300.0     1.24  1.00 /\n"
+    "/\n"
+    "\n"
+    "PVDG\n"
+    "   10.0  0.100  0.010\n"
+    "  100.0  0.010  0.015\n"
+    "  300.0  0.004  0.025 /\n"
+    "\n"
+    "PVTG\n"
+    "-- PRESSURE  RV      BG      VISCOSITY\n"
+    "    10.0     1.0e-4  0.100   0.010\n"
+    "             0.0     0.099   0.009 /\n"
+    "   100.0     5.0e-4  0.010   0.015\n"
+    "             0.0     0.0099  0.014 /\n"
+    "   300.0     1.0e-3  0.004   0.025\n"
+    "             0.0     0.0039  0.024 /\n"
+    "/\n"
+    "\n"
+    "SWOF\n"
+    "0.12  0       1      0\n"
+    "0.24  0.0002  0.997  0\n"
+    "0.36  0.0008  0.7    0\n"
+    "0.48  0.002   0.2    0\n"
+    "0.6   0.003   0.021  0\n"
+    "0.72  0.005   0.001  0\n"
+    "0.84  0.007   0      0\n"
+    "1     0.984   0      0 /\n"
+    "\n"
+    "SGOF\n"
+    "0     0      1      0\n"
+    "0.05  0.005  0.98   0\n"
+    "0.2   0.075  0.35   0\n"
+    "0.3   0.19   0.09   0\n"
+    "0.5   0.72   0.001  0\n"
+    "0.7   0.94   0      0\n"
+    "0.88  0.984  0      0 /\n";
+#endif
+
+namespace {
+// the number of inputs of each benchmark which are evaluated per run
+static const unsigned numInputs = 1024;
+
+/*!
+ * \brief Benchmark a function of the input index.
+ *
+ * The function is called for each of the 'numInputs' inputs.
+ */
+template <class Evaluation, class Fn>
+void benchmarkFunction(BenchmarkResults& results, const std::string& name, const Fn& fn)
+{
+    runBenchmark(results, name + " [" + EvaluationName<Evaluation>::get() + "]", numInputs,
+                 [&fn]() {
+                     double sum = 0.0;
+                     for (unsigned i = 0; i < numInputs; ++i)
+                         sum += static_cast<double>(Opm::scalarValue(fn(i)));
+                     return sum;
+                 });
+}
+
+/*!
+ * \brief Create the inputs for a benchmark.
+ *
+ * The values are uniformly distributed within [minValue, maxValue] and the
+ * derivatives are set up as if the value was a primary variable. The random
+ * generator is seeded deterministically so that all runs use the same inputs.
+ */
+template <class Evaluation, class Scalar>
+std::vector<Evaluation> createInputs(Scalar minValue, Scalar maxValue, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(minValue, maxValue);
+
+    std::vector<Evaluation> inputs(numInputs);
+    for (unsigned i = 0; i < numInputs; ++i) {
+        Scalar value = static_cast<Scalar>(distribution(generator));
+        inputs[i] = Opm::MathToolbox<Evaluation>::createVariable(value, /*varIdx=*/0);
+    }
+    return inputs;
+}
+
+template <class Evaluation>
+void benchmarkTabulation(BenchmarkResults& results)
+{
+    typedef typename Opm::MathToolbox<Evaluation>::Scalar Scalar;
+
+    // a smooth function sampled at irregular positions
+    std::vector<Scalar> x, y;
+    for (unsigned i = 0; i < 100; ++i) {
+        Scalar xi = static_cast<Scalar>(i*i)/(99*99);
+        x.push_back(xi);
+        y.push_back(std::exp(-3*xi) + xi);
+    }
+    Opm::Tabulated1DFunction<Scalar> tab1d(x, y);
+
+    const auto xInputs = createInputs<Evaluation>(Scalar(0.0), Scalar(1.0), /*seed=*/1);
+    benchmarkFunction<Evaluation>(results, "Tabulated1DFunction::eval",
+                                  [&](unsigned i) { return tab1d.eval(xInputs[i]); });
+
+    // twenty columns with a varying number of sampling points each
+    Opm::UniformXTabulated2DFunction<Scalar> tab2d;
+    for (unsigned i = 0; i < 20; ++i) {
+        Scalar xi = static_cast<Scalar>(i)/19;
+        size_t colIdx = tab2d.appendXPos(xi);
+        unsigned numY = 10 + i;
+        for (unsigned j = 0; j < numY; ++j) {
+            Scalar yj = static_cast<Scalar>(j)/(numY - 1);
+            tab2d.appendSamplePoint(colIdx, yj, xi*yj + std::sin(yj));
+        }
+    }
+
+    const auto yInputs = createInputs<Evaluation>(Scalar(0.0), Scalar(1.0), /*seed=*/2);
+    benchmarkFunction<Evaluation>(results, "UniformXTabulated2DFunction::eval",
+                                  [&](unsigned i) { return tab2d.eval(xInputs[i], yInputs[i]); });
+}
+
+template <class Evaluation>
+void benchmarkComponents(BenchmarkResults& results)
+{
+    typedef typename Opm::MathToolbox<Evaluation>::Scalar Scalar;
+    typedef Opm::H2O<Scalar> H2O;
+    typedef Opm::CO2<Scalar, Opm::MaterialBenchmark::CO2Tables> CO2;
+
+    // liquid water
+    const auto TInputs = createInputs<Evaluation>(Scalar(290.0), Scalar(340.0), /*seed=*/3);
+    const auto pInputs = createInputs<Evaluation>(Scalar(1e6), Scalar(3e7), /*seed=*/4);
+
+    benchmarkFunction<Evaluation>(results, "H2O::liquidDensity",
+                                  [&](unsigned i) { return H2O::liquidDensity(TInputs[i], pInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "H2O::liquidViscosity",
+                                  [&](unsigned i) { return H2O::liquidViscosity(TInputs[i], pInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "H2O::liquidEnthalpy",
+                                  [&](unsigned i) { return H2O::liquidEnthalpy(TInputs[i], pInputs[i]); });
+
+    // steam at low pressure
+    const auto pGasInputs = createInputs<Evaluation>(Scalar(1e3), Scalar(5e3), /*seed=*/5);
+    benchmarkFunction<Evaluation>(results, "H2O::gasDensity",
+                                  [&](unsigned i) { return H2O::gasDensity(TInputs[i], pGasInputs[i]); });
+
+    // CO2 within the range of the tables
+    benchmarkFunction<Evaluation>(results, "CO2::gasDensity",
+                                  [&](unsigned i) { return CO2::gasDensity(TInputs[i], pInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "CO2::gasViscosity",
+                                  [&](unsigned i) { return CO2::gasViscosity(TInputs[i], pInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "CO2::gasEnthalpy",
+                                  [&](unsigned i) { return CO2::gasEnthalpy(TInputs[i], pInputs[i]); });
+}
+
+template <class Scalar>
+void benchmarkNcpFlash(BenchmarkResults& results)
+{
+    typedef Opm::FluidSystems::H2ON2<Scalar, false> FluidSystem;
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    typedef Opm::NcpFlash<Scalar, FluidSystem> NcpFlash;
+
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    enum { liquidPhaseIdx = FluidSystem::liquidPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, liquidPhaseIdx, gasPhaseIdx> MaterialTraits;
+    typedef Opm::EffToAbsLaw<Opm::RegularizedBrooksCorey<MaterialTraits> > MaterialLaw;
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+
+    Scalar T = 273.15 + 25;
+    FluidSystem::init(/*Tmin=*/T - 1.0, /*Tmax=*/T + 1.0, /*nT=*/3,
+                      /*pmin=*/0.0, /*pmax=*/2.5e6, /*np=*/100);
+
+    typename MaterialLaw::Params matParams;
+    matParams.setResidualSaturation(MaterialLaw::wettingPhaseIdx, 0.0);
+    matParams.setResidualSaturation(MaterialLaw::nonWettingPhaseIdx, 0.0);
+    matParams.setEntryPressure(1e3);
+    matParams.setLambda(2.0);
+    matParams.finalize();
+
+    // a two-phase state in thermodynamic equilibrium. the capillary pressure is
+    // neglected here because the flash only needs the total molarities.
+    FluidState fsRef;
+    fsRef.setTemperature(T);
+    fsRef.setSaturation(liquidPhaseIdx, 0.5);
+    fsRef.setSaturation(gasPhaseIdx, 0.5);
+    fsRef.setPressure(liquidPhaseIdx, 1e6);
+    fsRef.setPressure(gasPhaseIdx, 1e6);
+
+    ParameterCache paramCache;
+    Opm::MiscibleMultiPhaseComposition<Scalar, FluidSystem>::solve(fsRef, paramCache,
+                                                                   /*setViscosity=*/false,
+                                                                   /*setEnthalpy=*/false);
+
+    ComponentVector globalMolarities(0.0);
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            globalMolarities[compIdx] +=
+                fsRef.saturation(phaseIdx)*fsRef.molarity(phaseIdx, compIdx);
+
+    runBenchmark(results, "NcpFlash::solve (H2O-N2, two-phase) [Scalar]", /*numEvals=*/1,
+                 [&]() {
+                     FluidState fsFlash;
+                     fsFlash.setTemperature(T);
+                     ParameterCache flashParamCache;
+                     flashParamCache.updateAll(fsFlash);
+                     NcpFlash::guessInitial(fsFlash, globalMolarities);
+                     NcpFlash::template solve<MaterialLaw>(fsFlash, matParams, flashParamCache, globalMolarities);
+                     return static_cast<double>(fsFlash.saturation(gasPhaseIdx));
+                 });
+}
+
+#if HAVE_OPM_PARSER
+template <class Evaluation>
+void benchmarkPvt(BenchmarkResults& results, const Opm::Deck& deck, const Opm::EclipseState& eclState)
+{
+    typedef typename Opm::MathToolbox<Evaluation>::Scalar Scalar;
+
+    Opm::LiveOilPvt<Scalar> liveOilPvt;
+    Opm::DeadOilPvt<Scalar> deadOilPvt;
+    Opm::ConstantCompressibilityOilPvt<Scalar> constCompOilPvt;
+    Opm::WetGasPvt<Scalar> wetGasPvt;
+    Opm::DryGasPvt<Scalar> dryGasPvt;
+    Opm::ConstantCompressibilityWaterPvt<Scalar> constCompWaterPvt;
+
+    liveOilPvt.initFromDeck(deck, eclState);
+    deadOilPvt.initFromDeck(deck, eclState);
+    constCompOilPvt.initFromDeck(deck, eclState);
+    wetGasPvt.initFromDeck(deck, eclState);
+    dryGasPvt.initFromDeck(deck, eclState);
+    constCompWaterPvt.initFromDeck(deck, eclState);
+
+    const Evaluation T(273.15 + 60.0);
+    const auto pInputs = createInputs<Evaluation>(Scalar(20e5), Scalar(280e5), /*seed=*/6);
+    const auto RsInputs = createInputs<Evaluation>(Scalar(10.0), Scalar(90.0), /*seed=*/7);
+    const auto RvInputs = createInputs<Evaluation>(Scalar(0.0), Scalar(1e-4), /*seed=*/8);
+
+    benchmarkFunction<Evaluation>(results, "LiveOilPvt::inverseFormationVolumeFactor",
+                                  [&](unsigned i) { return liveOilPvt.inverseFormationVolumeFactor(0, T, pInputs[i], RsInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "LiveOilPvt::viscosity",
+                                  [&](unsigned i) { return liveOilPvt.viscosity(0, T, pInputs[i], RsInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "LiveOilPvt::saturatedGasDissolutionFactor",
+                                  [&](unsigned i) { return liveOilPvt.saturatedGasDissolutionFactor(0, T, pInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "LiveOilPvt::saturationPressure",
+                                  [&](unsigned i) { return liveOilPvt.saturationPressure(0, T, RsInputs[i]); });
+
+    benchmarkFunction<Evaluation>(results, "DeadOilPvt::inverseFormationVolumeFactor",
+                                  [&](unsigned i) { return deadOilPvt.inverseFormationVolumeFactor(0, T, pInputs[i], RsInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "DeadOilPvt::viscosity",
+                                  [&](unsigned i) { return deadOilPvt.viscosity(0, T, pInputs[i], RsInputs[i]); });
+
+    benchmarkFunction<Evaluation>(results, "ConstantCompressibilityOilPvt::inverseFormationVolumeFactor",
+                                  [&](unsigned i) { return constCompOilPvt.inverseFormationVolumeFactor(0, T, pInputs[i], RsInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "ConstantCompressibilityOilPvt::viscosity",
+                                  [&](unsigned i) { return constCompOilPvt.viscosity(0, T, pInputs[i], RsInputs[i]); });
+
+    benchmarkFunction<Evaluation>(results, "WetGasPvt::inverseFormationVolumeFactor",
+                                  [&](unsigned i) { return wetGasPvt.inverseFormationVolumeFactor(0, T, pInputs[i], RvInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "WetGasPvt::viscosity",
+                                  [&](unsigned i) { return wetGasPvt.viscosity(0, T, pInputs[i], RvInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "WetGasPvt::inverseFormationVolumeFactorAndViscosity",
+                                  [&](unsigned i) {
+                                      Evaluation invB, mu;
+                                      wetGasPvt.inverseFormationVolumeFactorAndViscosity(0, T, pInputs[i], RvInputs[i], invB, mu);
+                                      return invB + mu;
+                                  });
+    benchmarkFunction<Evaluation>(results, "WetGasPvt::saturatedOilVaporizationFactor",
+                                  [&](unsigned i) { return wetGasPvt.saturatedOilVaporizationFactor(0, T, pInputs[i]); });
+
+    benchmarkFunction<Evaluation>(results, "DryGasPvt::inverseFormationVolumeFactor",
+                                  [&](unsigned i) { return dryGasPvt.inverseFormationVolumeFactor(0, T, pInputs[i], RvInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "DryGasPvt::viscosity",
+                                  [&](unsigned i) { return dryGasPvt.viscosity(0, T, pInputs[i], RvInputs[i]); });
+
+    benchmarkFunction<Evaluation>(results, "ConstantCompressibilityWaterPvt::inverseFormationVolumeFactor",
+                                  [&](unsigned i) { return constCompWaterPvt.inverseFormationVolumeFactor(0, T, pInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "ConstantCompressibilityWaterPvt::viscosity",
+                                  [&](unsigned i) { return constCompWaterPvt.viscosity(0, T, pInputs[i]); });
+    benchmarkFunction<Evaluation>(results, "ConstantCompressibilityWaterPvt::inverseFormationVolumeFactorAndViscosity",
+                                  [&](unsigned i) {
+                                      Evaluation invB, mu;
+                                      constCompWaterPvt.inverseFormationVolumeFactorAndViscosity(0, T, pInputs[i], invB, mu);
+                                      return invB + mu;
+                                  });
+}
+
+template <class Evaluation>
+void benchmarkMaterialLawManager(BenchmarkResults& results,
+                                 const Opm::Deck& deck,
+                                 const Opm::EclipseState& eclState)
+{
+    typedef typename Opm::MathToolbox<Evaluation>::Scalar Scalar;
+
+    enum { numPhases = 3 };
+    enum { waterPhaseIdx = 0 };
+    enum { oilPhaseIdx = 1 };
+    enum { gasPhaseIdx = 2 };
+    typedef Opm::ThreePhaseMaterialTraits<Scalar,
+                                          /*wettingPhaseIdx=*/waterPhaseIdx,
+                                          /*nonWettingPhaseIdx=*/oilPhaseIdx,
+                                          /*gasPhaseIdx=*/gasPhaseIdx> MaterialTraits;
+    typedef Opm::EclMaterialLawManager<MaterialTraits> MaterialLawManager;
+
+    const auto& eclGrid = eclState.getInputGrid();
+    size_t n = eclGrid.getCartesianSize();
+    std::vector<int> compressedToCartesianIdx(n);
+    for (size_t i = 0; i < n; ++ i)
+        compressedToCartesianIdx[i] = static_cast<int>(i);
+
+    MaterialLawManager materialLawManager;
+    materialLawManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+
+    // the saturations of all elements, one array per phase
+    const auto SwInputs = createInputs<Evaluation>(Scalar(0.12), Scalar(0.8), /*seed=*/9);
+    const auto SgInputs = createInputs<Evaluation>(Scalar(0.0), Scalar(0.2), /*seed=*/10);
+    unsigned numElems = static_cast<unsigned>(std::min<size_t>(n, numInputs));
+
+    std::vector<Evaluation> satValues[numPhases];
+    std::vector<Evaluation> resultValues[numPhases];
+    const Evaluation* satPtrs[numPhases];
+    Evaluation* resultPtrs[numPhases];
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        satValues[phaseIdx].resize(numElems);
+        resultValues[phaseIdx].resize(numElems);
+        satPtrs[phaseIdx] = satValues[phaseIdx].data();
+        resultPtrs[phaseIdx] = resultValues[phaseIdx].data();
+    }
+    for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+        satValues[waterPhaseIdx][elemIdx] = SwInputs[elemIdx];
+        satValues[gasPhaseIdx][elemIdx] = SgInputs[elemIdx];
+        satValues[oilPhaseIdx][elemIdx] = 1.0 - SwInputs[elemIdx] - SgInputs[elemIdx];
+    }
+
+    const std::string evalName = " [" + EvaluationName<Evaluation>::get() + "]";
+    runBenchmark(results, "EclMaterialLawManager::relativePermeabilities" + evalName, numElems,
+                 [&]() {
+                     materialLawManager.relativePermeabilities(resultPtrs, satPtrs, 0, numElems);
+                     return static_cast<double>(Opm::scalarValue(resultValues[oilPhaseIdx][numElems/2]));
+                 });
+    runBenchmark(results, "EclMaterialLawManager::capillaryPressures" + evalName, numElems,
+                 [&]() {
+                     materialLawManager.capillaryPressures(resultPtrs, satPtrs, 0, numElems);
+                     return static_cast<double>(Opm::scalarValue(resultValues[gasPhaseIdx][numElems/2]));
+                 });
+}
+#endif
+
+template <class Evaluation>
+void benchmarkAll(BenchmarkResults& results)
+{
+    benchmarkTabulation<Evaluation>(results);
+    benchmarkComponents<Evaluation>(results);
+
+#if HAVE_OPM_PARSER
+    Opm::Parser parser;
+    Opm::ParseContext parseContext;
+    const auto deck = parser.parseString(pvtDeckString, parseContext);
+    const Opm::EclipseState eclState(deck, parseContext);
+
+    benchmarkPvt<Evaluation>(results, deck, eclState);
+    benchmarkMaterialLawManager<Evaluation>(results, deck, eclState);
+#endif
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    BenchmarkOptions options;
+    if (!parseBenchmarkOptions(options, argc, argv))
+        return 1;
+
+    BenchmarkResults results;
+    benchmarkAll<double>(results);
+    benchmarkAll<Opm::DenseAd::Evaluation<double, 1> >(results);
+    benchmarkAll<Opm::DenseAd::Evaluation<double, 3> >(results);
+    benchmarkAll<Opm::DenseAd::Evaluation<double, 6> >(results);
+    benchmarkNcpFlash<double>(results);
+
+    if (OPM_MATERIAL_INSTRUMENTATION)
+        Opm::Instrumentation::print(std::cout);
+    if (OPM_MATERIAL_PROFILE_TABLES)
+        Opm::printTableProfiles(std::cout);
+
+    return checkBenchmarkResults(results, options);
+}
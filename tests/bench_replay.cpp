@@ -0,0 +1,325 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Benchmark which replays the cell states recorded during a simulation run.
+ *
+ * In contrast to the synthetic inputs of bench_material, the states of a trace
+ * exhibit the branch and memory access patterns of a real simulation. The program
+ * loads an ECL deck using the initFromDeck() methods of the black-oil fluid system
+ * and of the EclMaterialLawManager, reads a trace which was written using
+ * Opm::CellStateTraceWriter (see opm/material/common/CellStateTrace.hpp for the file
+ * format) and reports the throughput of each property family for each requested
+ * number of threads:
+ *
+ * \code
+ * bench_replay DECK_FILE TRACE_FILE [--threads=1,2,4] [--repetitions=5]
+ * \endcode
+ *
+ * The PVT properties of all phases are evaluated at the recorded oil pressure, i.e.,
+ * capillary pressure is neglected. Using more than a single thread requires OpenMP.
+ * If table profiling is enabled (see opm/material/common/TableProfiler.hpp), the
+ * access pattern of each PVT and saturation function table is printed at the end.
+ *
+ * This program requires the presence of opm-parser.
+ */
+#include "config.h"
+
+#if !HAVE_OPM_PARSER
+#error "The replay benchmark requires the opm-parser module"
+#endif
+
+#include <opm/material/common/CellStateTrace.hpp>
+#include <opm/material/common/MemoryUsage.hpp>
+#include <opm/material/common/TableProfiler.hpp>
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+#include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialLawCombinedEvaluation.hpp>
+#include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include "benchmarkHarness.hpp"
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+typedef double Scalar;
+typedef Opm::FluidSystems::BlackOil<Scalar> FluidSystem;
+
+enum { numPhases = FluidSystem::numPhases };
+enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
+enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+typedef Opm::ThreePhaseMaterialTraits<Scalar,
+                                      /*wettingPhaseIdx=*/waterPhaseIdx,
+                                      /*nonWettingPhaseIdx=*/oilPhaseIdx,
+                                      /*gasPhaseIdx=*/gasPhaseIdx> MaterialTraits;
+typedef Opm::EclMaterialLawManager<MaterialTraits> MaterialLawManager;
+typedef MaterialLawManager::MaterialLaw MaterialLaw;
+
+typedef Opm::SimpleModularFluidState<Scalar,
+                                     numPhases,
+                                     /*numComponents=*/3,
+                                     void,
+                                     /*storePressure=*/false,
+                                     /*storeTemperature=*/false,
+                                     /*storeComposition=*/false,
+                                     /*storeFugacity=*/false,
+                                     /*storeSaturation=*/true,
+                                     /*storeDensity=*/false,
+                                     /*storeViscosity=*/false,
+                                     /*storeEnthalpy=*/false> SaturationFluidState;
+
+// everything which is needed to evaluate the properties of the cells of the trace
+struct ReplayContext
+{
+    std::vector<Opm::CellStateRecord> records;
+    std::vector<unsigned> pvtRegionIdx;
+    MaterialLawManager materialLawManager;
+};
+
+// the property families. each of them evaluates the properties of a single record
+// and returns a value which depends on all of them.
+Scalar waterPvt(const ReplayContext& ctx, const Opm::CellStateRecord& rec)
+{
+    unsigned regionIdx = ctx.pvtRegionIdx[rec.elemIdx];
+    const auto& pvt = FluidSystem::waterPvt();
+    return
+        pvt.inverseFormationVolumeFactor(regionIdx, rec.temperature, rec.pressure)
+        + pvt.viscosity(regionIdx, rec.temperature, rec.pressure);
+}
+
+Scalar oilPvt(const ReplayContext& ctx, const Opm::CellStateRecord& rec)
+{
+    unsigned regionIdx = ctx.pvtRegionIdx[rec.elemIdx];
+    const auto& pvt = FluidSystem::oilPvt();
+    return
+        pvt.inverseFormationVolumeFactor(regionIdx, rec.temperature, rec.pressure, rec.Rs)
+        + pvt.viscosity(regionIdx, rec.temperature, rec.pressure, rec.Rs)
+        + pvt.saturatedGasDissolutionFactor(regionIdx, rec.temperature, rec.pressure);
+}
+
+Scalar gasPvt(const ReplayContext& ctx, const Opm::CellStateRecord& rec)
+{
+    unsigned regionIdx = ctx.pvtRegionIdx[rec.elemIdx];
+    const auto& pvt = FluidSystem::gasPvt();
+    return
+        pvt.inverseFormationVolumeFactor(regionIdx, rec.temperature, rec.pressure, rec.Rv)
+        + pvt.viscosity(regionIdx, rec.temperature, rec.pressure, rec.Rv)
+        + pvt.saturatedOilVaporizationFactor(regionIdx, rec.temperature, rec.pressure);
+}
+
+Scalar saturationFunctions(const ReplayContext& ctx, const Opm::CellStateRecord& rec)
+{
+    SaturationFluidState fs;
+    fs.setSaturation(waterPhaseIdx, rec.Sw);
+    fs.setSaturation(oilPhaseIdx, rec.So);
+    fs.setSaturation(gasPhaseIdx, rec.Sg);
+
+    Scalar pc[numPhases];
+    Scalar kr[numPhases];
+    Opm::capillaryPressuresAndRelativePermeabilities<MaterialLaw>(pc,
+                                                                  kr,
+                                                                  ctx.materialLawManager.materialLawParams(rec.elemIdx),
+                                                                  fs);
+
+    Scalar sum = 0.0;
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+        sum += pc[phaseIdx] + kr[phaseIdx];
+    return sum;
+}
+
+typedef Scalar (*PropertyFamily)(const ReplayContext&, const Opm::CellStateRecord&);
+
+// prevent the compiler from optimizing the replayed evaluations away
+volatile double replaySink;
+
+// replay the whole trace once and return the elapsed time in seconds
+double replay(const ReplayContext& ctx, PropertyFamily family, int numThreads)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const long numRecords = static_cast<long>(ctx.records.size());
+    double sum = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(numThreads) schedule(static) reduction(+:sum)
+#endif
+    for (long recIdx = 0; recIdx < numRecords; ++recIdx)
+        sum += family(ctx, ctx.records[static_cast<size_t>(recIdx)]);
+
+    const auto endTime = std::chrono::steady_clock::now();
+    replaySink = sum;
+    (void) numThreads;
+
+    return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+void initContext(ReplayContext& ctx,
+                 const std::string& deckFileName,
+                 const std::string& traceFileName)
+{
+    Opm::Parser parser;
+    Opm::ParseContext parseContext;
+    const auto deck = parser.parseFile(deckFileName, parseContext);
+    const Opm::EclipseState eclState(deck, parseContext);
+
+    FluidSystem::initFromDeck(deck, eclState);
+
+    // the records refer to the active cells of the grid in their natural order
+    const auto& eclGrid = eclState.getInputGrid();
+    std::vector<int> compressedToCartesianIdx;
+    for (size_t cartIdx = 0; cartIdx < eclGrid.getCartesianSize(); ++cartIdx)
+        if (eclGrid.cellActive(cartIdx))
+            compressedToCartesianIdx.push_back(static_cast<int>(cartIdx));
+    const size_t numElems = compressedToCartesianIdx.size();
+
+    ctx.materialLawManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+
+    ctx.pvtRegionIdx.assign(numElems, 0);
+    const auto& props = eclState.get3DProperties();
+    if (props.hasDeckIntGridProperty("PVTNUM")) {
+        const auto& pvtnumData = props.getIntGridProperty("PVTNUM").getData();
+        for (size_t elemIdx = 0; elemIdx < numElems; ++elemIdx)
+            // PVTNUM is one-based
+            ctx.pvtRegionIdx[elemIdx] =
+                static_cast<unsigned>(pvtnumData[static_cast<size_t>(compressedToCartesianIdx[elemIdx])] - 1);
+    }
+
+    ctx.records = Opm::readCellStateTrace(traceFileName);
+    for (const auto& rec : ctx.records)
+        if (rec.elemIdx >= numElems)
+            OPM_THROW(std::runtime_error,
+                      "The trace references cell " << rec.elemIdx
+                      << ", but the deck only has " << numElems << " active cells");
+}
+
+// print how much memory is used by the PVT objects and the material parameters
+void printMemoryUsage(const ReplayContext& ctx)
+{
+    Opm::MemoryUsage pvtUsage;
+    if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx))
+        pvtUsage.add(FluidSystem::waterPvt().memoryUsage());
+    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx))
+        pvtUsage.add(FluidSystem::oilPvt().memoryUsage());
+    if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx))
+        pvtUsage.add(FluidSystem::gasPvt().memoryUsage());
+
+    std::cout << "Memory used by the PVT objects:\n";
+    pvtUsage.print(std::cout);
+    std::cout << "Memory used by the material law manager:\n";
+    ctx.materialLawManager.memoryUsage().print(std::cout);
+}
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    std::vector<std::string> positionalArgs;
+    std::vector<int> threadCounts(1, 1);
+    unsigned numRepetitions = 5;
+    bool validArgs = true;
+    for (int argIdx = 1; argIdx < argc; ++argIdx) {
+        const std::string arg(argv[argIdx]);
+        if (arg.compare(0, 10, "--threads=") == 0)
+            threadCounts = parseThreadCounts(arg.substr(10));
+        else if (arg.compare(0, 14, "--repetitions=") == 0)
+            numRepetitions = static_cast<unsigned>(std::max(1, std::stoi(arg.substr(14))));
+        else if (arg.compare(0, 2, "--") == 0)
+            validArgs = false;
+        else
+            positionalArgs.push_back(arg);
+    }
+
+    if (!validArgs || positionalArgs.size() != 2 || threadCounts.empty()) {
+        std::cerr << "Usage: " << argv[0]
+                  << " DECK_FILE TRACE_FILE [--threads=1,2,4] [--repetitions=5]\n";
+        return 1;
+    }
+
+#ifndef _OPENMP
+    if (threadCounts.size() > 1 || threadCounts[0] > 1)
+        std::cerr << "Warning: Compiled without OpenMP support, all runs use a single thread\n";
+#endif
+
+    ReplayContext ctx;
+    initContext(ctx, positionalArgs[0], positionalArgs[1]);
+    printMemoryUsage(ctx);
+    std::cout << "Replaying " << ctx.records.size() << " cell states\n";
+    if (ctx.records.empty())
+        return 0;
+
+    const std::pair<const char*, PropertyFamily> families[] = {
+        std::make_pair("water PVT", &waterPvt),
+        std::make_pair("oil PVT", &oilPvt),
+        std::make_pair("gas PVT", &gasPvt),
+        std::make_pair("saturation functions", &saturationFunctions)
+    };
+
+    std::cout << std::left << std::setw(24) << "family"
+              << std::right << std::setw(10) << "threads"
+              << std::setw(16) << "Mstates/s"
+              << std::setw(16) << "ns/state" << "\n";
+    for (const auto& family : families) {
+        for (int numThreads : threadCounts) {
+            // the first replay warms up the caches
+            replay(ctx, family.second, numThreads);
+
+            double bestTime = std::numeric_limits<double>::max();
+            for (unsigned repIdx = 0; repIdx < numRepetitions; ++repIdx)
+                bestTime = std::min(bestTime, replay(ctx, family.second, numThreads));
+
+            double numStates = static_cast<double>(ctx.records.size());
+            std::cout << std::left << std::setw(24) << family.first
+                      << std::right << std::setw(10) << numThreads
+                      << std::setw(16) << std::fixed << std::setprecision(3) << numStates/bestTime/1e6
+                      << std::setw(16) << std::fixed << std::setprecision(2) << bestTime/numStates*1e9
+                      << "\n";
+        }
+    }
+
+    if (OPM_MATERIAL_PROFILE_TABLES)
+        Opm::printTableProfiles(std::cout, /*printHistograms=*/true);
+
+    return 0;
+}
@@ -0,0 +1,401 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Benchmark for the scalability of the property evaluations with the number
+ *        of threads.
+ *
+ * The cells of a synthetic grid are partitioned into contiguous ranges, one per
+ * thread, in the same way as an OpenMP-parallelized assembly loop of a simulator
+ * would do it. Each thread then evaluates the properties of its cells, i.e., all
+ * threads concurrently access the same objects:
+ *
+ * - the PVT objects of the black-oil fluid system, which are static members of the
+ *   fluid system class,
+ * - the per-cell parameter objects of the EclMaterialLawManager, which are held by
+ *   shared pointers, and
+ * - the static tables of TabulatedComponent.
+ *
+ * For each property family and each number of threads, the wall time per cell and
+ * the speedup relative to a single thread are reported:
+ *
+ * \code
+ * bench_scaling [--threads=1,2,4,8] [--output=FILE] [--reference=FILE]...
+ * \endcode
+ *
+ * By default, the number of threads is doubled up to the number of threads available
+ * to OpenMP. The time per cell can be stored and checked against a reference as
+ * described in tests/benchmarkHarness.hpp, which also allows to track the scalability
+ * across code changes. Using more than a single thread requires OpenMP; the fluid
+ * system and the material law benchmarks require opm-parser.
+ */
+#include "config.h"
+
+#include <opm/material/components/H2O.hpp>
+#include <opm/material/components/TabulatedComponent.hpp>
+
+#if HAVE_OPM_PARSER
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+#include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialLawCombinedEvaluation.hpp>
+
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#endif
+
+#include "benchmarkHarness.hpp"
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+typedef double Scalar;
+
+// the grid is nx*ny*nz cells large
+static const unsigned nx = 100;
+static const unsigned ny = 100;
+static const unsigned nz = 10;
+static const unsigned numCells = nx*ny*nz;
+
+// the state of a cell. this class provides the parts of the fluid state API which
+// are required by the black-oil fluid system and the material laws.
+class CellState
+{
+public:
+    typedef ::Scalar Scalar;
+
+    Scalar pressure(unsigned /* phaseIdx */) const
+    { return pressure_; }
+
+    Scalar temperature(unsigned /* phaseIdx */) const
+    { return temperature_; }
+
+    Scalar saturation(unsigned phaseIdx) const
+    { return saturation_[phaseIdx]; }
+
+    Scalar Rs() const
+    { return Rs_; }
+
+    Scalar Rv() const
+    { return Rv_; }
+
+    Scalar pressure_;
+    Scalar temperature_;
+    Scalar saturation_[3];
+    Scalar Rs_;
+    Scalar Rv_;
+};
+
+typedef Opm::TabulatedComponent<Scalar, Opm::H2O<Scalar> > TabulatedH2O;
+
+#if HAVE_OPM_PARSER
+typedef Opm::FluidSystems::BlackOil<Scalar> FluidSystem;
+
+enum { numPhases = FluidSystem::numPhases };
+enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
+enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+typedef Opm::ThreePhaseMaterialTraits<Scalar,
+                                      /*wettingPhaseIdx=*/waterPhaseIdx,
+                                      /*nonWettingPhaseIdx=*/oilPhaseIdx,
+                                      /*gasPhaseIdx=*/gasPhaseIdx> MaterialTraits;
+typedef Opm::EclMaterialLawManager<MaterialTraits> MaterialLawManager;
+typedef MaterialLawManager::MaterialLaw MaterialLaw;
+
+// the PVT and saturation function tables of the deck are the same as the ones of
+// bench_material, but the grid is much larger
+std::string createDeckString()
+{
+    const std::string numCellsString = std::to_string(numCells);
+    return
+        "RUNSPEC\n"
+        "DIMENS\n"
+        "   " + std::to_string(nx) + " " + std::to_string(ny) + " " + std::to_string(nz) + " /\n"
+        "TABDIMS\n"
+        "/\n"
+        "OIL\n"
+        "GAS\n"
+        "WATER\n"
+        "DISGAS\n"
+        "VAPOIL\n"
+        "METRIC\n"
+        "GRID\n"
+        "DX\n"
+        "   " + numCellsString + "*100 /\n"
+        "DY\n"
+        "   " + numCellsString + "*100 /\n"
+        "DZ\n"
+        "   " + numCellsString + "*5 /\n"
+        "TOPS\n"
+        "   " + std::to_string(nx*ny) + "*2000 /\n"
+        "PROPS\n"
+        "DENSITY\n"
+        "   800.0 1000.0 0.9 /\n"
+        "PVTW\n"
+        "   200.0 1.02 4.5e-5 0.5 0.0 /\n"
+        "PVTO\n"
+        "   10.0   20.0     1.05  1.50\n"
+        "         300.0     1.03  1.80 /\n"
+        "   50.0  100.0     1.15  1.20\n"
+        "         300.0     1.13  1.40 /\n"
+        "  100.0  200.0     1.25  0.90\n"
+        "         300.0     1.24  1.00 /\n"
+        "/\n"
+        "PVTG\n"
+        "    10.0     1.0e-4  0.100   0.010\n"
+        "             0.0     0.099   0.009 /\n"
+        "   100.0     5.0e-4  0.010   0.015\n"
+        "             0.0     0.0099  0.014 /\n"
+        "   300.0     1.0e-3  0.004   0.025\n"
+        "             0.0     0.0039  0.024 /\n"
+        "/\n"
+        "SWOF\n"
+        "0.12  0       1      0\n"
+        "0.24  0.0002  0.997  0\n"
+        "0.36  0.0008  0.7    0\n"
+        "0.48  0.002   0.2    0\n"
+        "0.6   0.003   0.021  0\n"
+        "0.72  0.005   0.001  0\n"
+        "0.84  0.007   0      0\n"
+        "1     0.984   0      0 /\n"
+        "SGOF\n"
+        "0     0      1      0\n"
+        "0.05  0.005  0.98   0\n"
+        "0.2   0.075  0.35   0\n"
+        "0.3   0.19   0.09   0\n"
+        "0.5   0.72   0.001  0\n"
+        "0.7   0.94   0      0\n"
+        "0.88  0.984  0      0 /\n";
+}
+#endif
+
+// everything which is needed to evaluate the properties of the cells
+struct ScalingContext
+{
+    std::vector<CellState> cellStates;
+#if HAVE_OPM_PARSER
+    MaterialLawManager materialLawManager;
+#endif
+};
+
+// the property families. each of them evaluates the properties of a single cell and
+// returns a value which depends on all of them.
+Scalar tabulatedComponent(const ScalingContext& ctx, unsigned cellIdx)
+{
+    const CellState& cs = ctx.cellStates[cellIdx];
+    const Scalar T = cs.temperature(0);
+    const Scalar p = cs.pressure(0);
+    return
+        TabulatedH2O::liquidDensity(T, p)
+        + TabulatedH2O::liquidViscosity(T, p)
+        + TabulatedH2O::liquidEnthalpy(T, p);
+}
+
+#if HAVE_OPM_PARSER
+Scalar blackOilFluidSystem(const ScalingContext& ctx, unsigned cellIdx)
+{
+    FluidSystem::PhaseProperties<Scalar> props;
+    FluidSystem::computeAllPhaseProperties(ctx.cellStates[cellIdx], /*regionIdx=*/0, props);
+
+    Scalar sum = 0.0;
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+        sum += props.invB[phaseIdx] + props.density[phaseIdx] + props.viscosity[phaseIdx];
+    return sum;
+}
+
+Scalar saturationFunctions(const ScalingContext& ctx, unsigned cellIdx)
+{
+    Scalar pc[numPhases];
+    Scalar kr[numPhases];
+    Opm::capillaryPressuresAndRelativePermeabilities<MaterialLaw>(pc,
+                                                                  kr,
+                                                                  ctx.materialLawManager.materialLawParams(cellIdx),
+                                                                  ctx.cellStates[cellIdx]);
+
+    Scalar sum = 0.0;
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+        sum += pc[phaseIdx] + kr[phaseIdx];
+    return sum;
+}
+#endif
+
+typedef Scalar (*PropertyFamily)(const ScalingContext&, unsigned);
+
+// evaluate the properties of all cells once. each thread processes a contiguous range
+// of cells.
+double sweep(const ScalingContext& ctx, PropertyFamily family, int numThreads)
+{
+    double sum = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(numThreads) reduction(+:sum)
+#endif
+    {
+#ifdef _OPENMP
+        const unsigned threadIdx = static_cast<unsigned>(omp_get_thread_num());
+        const unsigned numActualThreads = static_cast<unsigned>(omp_get_num_threads());
+#else
+        const unsigned threadIdx = 0;
+        const unsigned numActualThreads = 1;
+#endif
+        const unsigned beginIdx = static_cast<unsigned>(static_cast<size_t>(numCells)*threadIdx/numActualThreads);
+        const unsigned endIdx = static_cast<unsigned>(static_cast<size_t>(numCells)*(threadIdx + 1)/numActualThreads);
+        for (unsigned cellIdx = beginIdx; cellIdx < endIdx; ++cellIdx)
+            sum += family(ctx, cellIdx);
+    }
+    (void) numThreads;
+
+    return sum;
+}
+
+void initContext(ScalingContext& ctx)
+{
+    // the water tables cover the pressures and temperatures of the cells
+    TabulatedH2O::init(/*tempMin=*/300.0, /*tempMax=*/400.0, /*nTemp=*/50,
+                       /*pressMin=*/1e5, /*pressMax=*/400e5, /*nPress=*/200);
+
+#if HAVE_OPM_PARSER
+    Opm::Parser parser;
+    Opm::ParseContext parseContext;
+    const auto deck = parser.parseString(createDeckString(), parseContext);
+    const Opm::EclipseState eclState(deck, parseContext);
+
+    FluidSystem::initFromDeck(deck, eclState);
+
+    std::vector<int> compressedToCartesianIdx(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        compressedToCartesianIdx[cellIdx] = static_cast<int>(cellIdx);
+    ctx.materialLawManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+#endif
+
+    // random states which cover the range of the tables. the generator is seeded
+    // deterministically so that all runs use the same states.
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<Scalar> uniform(0.0, 1.0);
+    ctx.cellStates.resize(numCells);
+    for (auto& cs : ctx.cellStates) {
+        cs.pressure_ = 50e5 + 250e5*uniform(generator);
+        cs.temperature_ = 320.0 + 60.0*uniform(generator);
+        cs.Rs_ = 100.0*uniform(generator);
+        cs.Rv_ = 1e-3*uniform(generator);
+
+        const Scalar Sw = 0.12 + 0.88*uniform(generator);
+        const Scalar Sg = (1.0 - Sw)*uniform(generator);
+        cs.saturation_[0] = Sw;
+        cs.saturation_[1] = 1.0 - Sw - Sg;
+        cs.saturation_[2] = Sg;
+    }
+}
+
+std::vector<int> defaultThreadCounts()
+{
+    std::vector<int> threadCounts(1, 1);
+#ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+    for (int n = 2; n < maxThreads; n *= 2)
+        threadCounts.push_back(n);
+    if (maxThreads > 1)
+        threadCounts.push_back(maxThreads);
+#endif
+    return threadCounts;
+}
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    BenchmarkOptions options;
+    std::vector<int> threadCounts = defaultThreadCounts();
+    const auto parseThreadsOption = [&threadCounts](const std::string& arg) {
+        if (arg.compare(0, 10, "--threads=") != 0)
+            return false;
+        threadCounts = parseThreadCounts(arg.substr(10));
+        return true;
+    };
+    if (!parseBenchmarkOptions(options, argc, argv, parseThreadsOption, " [--threads=N1,N2,...]"))
+        return 1;
+
+#ifndef _OPENMP
+    if (threadCounts.size() != 1 || threadCounts[0] != 1)
+        std::cout << "Warning: OpenMP is not available, all benchmarks use a single thread\n";
+#endif
+
+    ScalingContext ctx;
+    initContext(ctx);
+
+    std::vector<std::pair<std::string, PropertyFamily> > families = {
+        std::make_pair("TabulatedComponent<H2O>", &tabulatedComponent)
+    };
+#if HAVE_OPM_PARSER
+    families.push_back(std::make_pair("BlackOilFluidSystem", &blackOilFluidSystem));
+    families.push_back(std::make_pair("EclMaterialLawManager", &saturationFunctions));
+#else
+    std::cout << "opm-parser is not available, only the tabulated component is benchmarked\n";
+#endif
+
+    BenchmarkResults results;
+    std::vector<std::vector<double> > nsPerCell(families.size());
+    for (size_t familyIdx = 0; familyIdx < families.size(); ++familyIdx) {
+        const auto& family = families[familyIdx];
+        for (int numThreads : threadCounts) {
+            runBenchmark(results,
+                         family.first + " [" + std::to_string(numThreads) + " threads]",
+                         numCells,
+                         [&ctx, &family, numThreads]() { return sweep(ctx, family.second, numThreads); });
+            nsPerCell[familyIdx].push_back(results.back().second);
+        }
+    }
+
+    std::cout << "\n" << std::left << std::setw(32) << "family"
+              << std::right << std::setw(10) << "threads"
+              << std::setw(12) << "speedup"
+              << std::setw(14) << "efficiency" << "\n";
+    for (size_t familyIdx = 0; familyIdx < families.size(); ++familyIdx) {
+        for (size_t i = 0; i < threadCounts.size(); ++i) {
+            // the speedup is relative to the first thread count, which usually is 1
+            const double speedup = nsPerCell[familyIdx][0]/nsPerCell[familyIdx][i];
+            const double efficiency = speedup*threadCounts[0]/threadCounts[i];
+            std::cout << std::left << std::setw(32) << families[familyIdx].first
+                      << std::right << std::setw(10) << threadCounts[i]
+                      << std::setw(12) << std::fixed << std::setprecision(2) << speedup
+                      << std::setw(13) << std::setprecision(1) << efficiency*100 << "%\n";
+        }
+    }
+
+    return checkBenchmarkResults(results, options);
+}
@@ -0,0 +1,469 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Compares the accuracy and the speed of TabulatedComponent with the raw
+ *        component which it tabulates.
+ *
+ * The properties of the raw and of the tabulated component are evaluated side by side
+ * at random states within a temperature and pressure region, where the logarithm of
+ * the pressure is uniformly distributed so that the low pressures of the gas phase are
+ * covered as well. The gas properties are only compared at states where the pressure
+ * is below the vapor pressure, the liquid properties only where it is above. For each
+ * property, the maximum and the RMS of the relative error, the time per evaluation of
+ * both variants and the speedup of the tabulated component are reported:
+ *
+ * \code
+ * bench_tabulatedcomponent [--component=H2O] [--temperature=MIN,MAX] [--pressure=MIN,MAX]
+ *                          [--resolution=NTEMP,NPRESS] [--max-error=REL] [--suggest]
+ * \endcode
+ *
+ * The relative error is taken with respect to the raw value; raw values whose
+ * magnitude is smaller than 0.1% of the largest magnitude of the property within the
+ * region are clamped to avoid the division by values close to zero. With '--suggest',
+ * the tables are additionally created for a range of resolutions, and the one with
+ * the smallest number of table entries for which the maximum error of all properties
+ * is below '--max-error' is printed. This requires to fill the tables many times, which
+ * can take a few minutes for H2O.
+ *
+ * The times per evaluation can be stored and checked against a reference as described
+ * in tests/benchmarkHarness.hpp. The program returns 3 if the maximum error of a
+ * property at the given resolution exceeds '--max-error'.
+ */
+#include "config.h"
+
+#include <opm/material/components/H2O.hpp>
+#include <opm/material/components/SimpleH2O.hpp>
+#include <opm/material/components/TabulatedComponent.hpp>
+
+#include "benchmarkHarness.hpp"
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+typedef double Scalar;
+
+// the number of random states within the temperature and pressure region
+static const unsigned numSamples = 10000;
+
+struct TabulationOptions
+{
+    TabulationOptions()
+        : component("H2O")
+        , tempMin(280.0)
+        , tempMax(500.0)
+        , pressMin(1e4)
+        , pressMax(3e7)
+        , nTemp(100)
+        , nPress(200)
+        , maxError(1e-3)
+        , suggest(false)
+    {}
+
+    std::string component;
+    Scalar tempMin;
+    Scalar tempMax;
+    Scalar pressMin;
+    Scalar pressMax;
+    unsigned nTemp;
+    unsigned nPress;
+    Scalar maxError;
+    bool suggest;
+};
+
+enum PropertyPhase { anyPhase, gasPhase, liquidPhase };
+
+typedef Scalar (*PropertyFunction)(const Scalar& temperature, const Scalar& pressure);
+
+struct Property
+{
+    const char* name;
+    PropertyPhase phase;
+    PropertyFunction raw;
+    PropertyFunction tabulated;
+};
+
+template <class Component>
+Scalar vaporPressure_(const Scalar& temperature, const Scalar& /* pressure */)
+{ return Component::vaporPressure(temperature); }
+
+template <class RawComponent, class TabulatedComponent>
+std::vector<Property> properties()
+{
+#define OPM_TABULATION_PROPERTY(name, phase)                          \
+    Property{ #name,                                                  \
+              phase,                                                  \
+              &RawComponent::template name<Scalar>,                   \
+              &TabulatedComponent::template name<Scalar> }
+
+    return {
+        Property{ "vaporPressure",
+                  anyPhase,
+                  &vaporPressure_<RawComponent>,
+                  &vaporPressure_<TabulatedComponent> },
+        OPM_TABULATION_PROPERTY(gasDensity, gasPhase),
+        OPM_TABULATION_PROPERTY(gasEnthalpy, gasPhase),
+        OPM_TABULATION_PROPERTY(gasHeatCapacity, gasPhase),
+        OPM_TABULATION_PROPERTY(gasViscosity, gasPhase),
+        OPM_TABULATION_PROPERTY(gasThermalConductivity, gasPhase),
+        OPM_TABULATION_PROPERTY(liquidDensity, liquidPhase),
+        OPM_TABULATION_PROPERTY(liquidEnthalpy, liquidPhase),
+        OPM_TABULATION_PROPERTY(liquidHeatCapacity, liquidPhase),
+        OPM_TABULATION_PROPERTY(liquidViscosity, liquidPhase),
+        OPM_TABULATION_PROPERTY(liquidThermalConductivity, liquidPhase)
+    };
+
+#undef OPM_TABULATION_PROPERTY
+}
+
+/*!
+ * \brief The states at which a property is compared and the values of the raw
+ *        component at these states.
+ *
+ * The values of the raw component do not depend on the resolution of the tables, so
+ * they are only computed once.
+ */
+struct PropertySamples
+{
+    std::vector<Scalar> temperature;
+    std::vector<Scalar> pressure;
+    std::vector<Scalar> rawValue;
+    Scalar errorScale;
+};
+
+struct PropertyError
+{
+    Scalar max;
+    Scalar rms;
+};
+
+template <class RawComponent>
+std::vector<PropertySamples> createSamples(const std::vector<Property>& props,
+                                           const TabulationOptions& options)
+{
+    std::mt19937 generator(/*seed=*/1);
+    std::uniform_real_distribution<Scalar> tempDistribution(options.tempMin, options.tempMax);
+    std::uniform_real_distribution<Scalar> logPressDistribution(std::log(options.pressMin),
+                                                                std::log(options.pressMax));
+
+    std::vector<PropertySamples> samples(props.size());
+    for (unsigned sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx) {
+        const Scalar T = tempDistribution(generator);
+        const Scalar p = std::exp(logPressDistribution(generator));
+
+        Scalar pSat;
+        try { pSat = RawComponent::vaporPressure(T); }
+        catch (const std::exception&) { continue; }
+
+        for (size_t propIdx = 0; propIdx < props.size(); ++propIdx) {
+            const Property& prop = props[propIdx];
+            if ((prop.phase == gasPhase && p >= pSat) || (prop.phase == liquidPhase && p <= pSat))
+                continue;
+
+            // states at which the raw component is not defined are skipped
+            Scalar value;
+            try { value = prop.raw(T, p); }
+            catch (const std::exception&) { continue; }
+            if (!std::isfinite(value))
+                continue;
+
+            samples[propIdx].temperature.push_back(T);
+            samples[propIdx].pressure.push_back(p);
+            samples[propIdx].rawValue.push_back(value);
+        }
+    }
+
+    for (auto& propSamples : samples) {
+        Scalar maxMagnitude = 0.0;
+        for (Scalar value : propSamples.rawValue)
+            maxMagnitude = std::max(maxMagnitude, std::abs(value));
+        propSamples.errorScale = std::max(1e-3*maxMagnitude, std::numeric_limits<Scalar>::min());
+    }
+
+    return samples;
+}
+
+// format a value using the default floating point notation
+std::string toString(Scalar value)
+{
+    std::ostringstream oss;
+    oss << value;
+    return oss.str();
+}
+
+PropertyError computeError(const Property& prop, const PropertySamples& samples)
+{
+    PropertyError error = { 0.0, 0.0 };
+    const size_t n = samples.rawValue.size();
+    if (n == 0)
+        return error;
+
+    Scalar sumSquares = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const Scalar rawValue = samples.rawValue[i];
+        const Scalar tabulatedValue = prop.tabulated(samples.temperature[i], samples.pressure[i]);
+        const Scalar relError =
+            std::abs(tabulatedValue - rawValue)/std::max(std::abs(rawValue), samples.errorScale);
+
+        // NaN must count as a failure
+        error.max = (relError <= error.max) ? error.max : relError;
+        sumSquares += relError*relError;
+    }
+    error.rms = std::sqrt(sumSquares/static_cast<Scalar>(n));
+    return error;
+}
+
+// the largest maximum error of all properties
+Scalar maxError(const std::vector<Property>& props, const std::vector<PropertySamples>& samples)
+{
+    Scalar result = 0.0;
+    for (size_t propIdx = 0; propIdx < props.size(); ++propIdx) {
+        const Scalar error = computeError(props[propIdx], samples[propIdx]).max;
+        result = (error <= result) ? result : error;
+    }
+    return result;
+}
+
+void benchmarkProperty(BenchmarkResults& results,
+                       const std::string& name,
+                       PropertyFunction fn,
+                       const PropertySamples& samples)
+{
+    const size_t n = samples.temperature.size();
+    runBenchmark(results, name, static_cast<unsigned>(n),
+                 [&samples, fn, n]() {
+                     Scalar sum = 0.0;
+                     for (size_t i = 0; i < n; ++i)
+                         sum += fn(samples.temperature[i], samples.pressure[i]);
+                     return sum;
+                 });
+}
+
+/*!
+ * \brief Find the resolution with the smallest number of table entries for which the
+ *        maximum error of all properties is below the tolerance.
+ *
+ * The candidates for the number of temperature and pressure steps are powers of two.
+ * For each number of temperature steps, the number of pressure steps is found by a
+ * bisection, i.e., the error is assumed to decrease with the number of pressure
+ * steps.
+ */
+template <class TabulatedComponent>
+void suggestResolution(const std::vector<Property>& props,
+                       const std::vector<PropertySamples>& samples,
+                       const TabulationOptions& options)
+{
+    std::vector<unsigned> candidates;
+    for (unsigned n = 16; n <= 1024; n *= 2)
+        candidates.push_back(n);
+
+    unsigned bestNTemp = 0;
+    unsigned bestNPress = 0;
+    for (unsigned nTemp : candidates) {
+        // even the coarsest pressure resolution cannot beat the best resolution so far
+        if (bestNTemp > 0 && nTemp*candidates.front() >= bestNTemp*bestNPress)
+            break;
+
+        size_t lowIdx = 0;
+        size_t highIdx = candidates.size();
+        while (lowIdx < highIdx) {
+            const size_t midIdx = (lowIdx + highIdx)/2;
+            TabulatedComponent::init(options.tempMin, options.tempMax, nTemp,
+                                     options.pressMin, options.pressMax, candidates[midIdx]);
+            const Scalar error = maxError(props, samples);
+            std::cout << "  nTemp=" << std::setw(5) << nTemp
+                      << " nPress=" << std::setw(5) << candidates[midIdx]
+                      << ": max error " << std::scientific << std::setprecision(3) << error
+                      << "\n" << std::flush;
+            if (error <= options.maxError)
+                highIdx = midIdx;
+            else
+                lowIdx = midIdx + 1;
+        }
+
+        if (lowIdx < candidates.size()
+            && (bestNTemp == 0 || nTemp*candidates[lowIdx] < bestNTemp*bestNPress))
+        {
+            bestNTemp = nTemp;
+            bestNPress = candidates[lowIdx];
+        }
+    }
+
+    if (bestNTemp == 0)
+        std::cout << "No resolution up to " << candidates.back() << "x" << candidates.back()
+                  << " meets a maximum error of " << toString(options.maxError) << "\n";
+    else
+        std::cout << "Smallest resolution with a maximum error below " << toString(options.maxError)
+                  << ": nTemp=" << bestNTemp << ", nPress=" << bestNPress
+                  << " (" << bestNTemp*bestNPress << " entries per table)\n";
+}
+
+/*!
+ * \brief Compare a tabulated component with its raw component.
+ *
+ * Returns true if the maximum error of all properties is below the tolerance.
+ */
+template <class RawComponent>
+bool analyzeComponent(BenchmarkResults& results, const TabulationOptions& options)
+{
+    typedef Opm::TabulatedComponent<Scalar, RawComponent> TabulatedComponent;
+
+    const auto props = properties<RawComponent, TabulatedComponent>();
+    const auto samples = createSamples<RawComponent>(props, options);
+
+    TabulatedComponent::init(options.tempMin, options.tempMax, options.nTemp,
+                             options.pressMin, options.pressMax, options.nPress);
+
+    std::vector<PropertyError> errors;
+    std::vector<std::pair<double, double> > nsPerEval;
+    for (size_t propIdx = 0; propIdx < props.size(); ++propIdx) {
+        const Property& prop = props[propIdx];
+        errors.push_back(computeError(prop, samples[propIdx]));
+        if (samples[propIdx].temperature.empty()) {
+            nsPerEval.push_back(std::make_pair(0.0, 0.0));
+            continue;
+        }
+
+        const std::string name = options.component + "::" + prop.name;
+        benchmarkProperty(results, name + " [raw]", prop.raw, samples[propIdx]);
+        benchmarkProperty(results, name + " [tabulated]", prop.tabulated, samples[propIdx]);
+        nsPerEval.push_back(std::make_pair(results[results.size() - 2].second,
+                                           results.back().second));
+    }
+
+    std::cout << "\nResolution: nTemp=" << options.nTemp << ", nPress=" << options.nPress << "\n"
+              << std::left << std::setw(28) << "property"
+              << std::right << std::setw(10) << "samples"
+              << std::setw(14) << "max error"
+              << std::setw(14) << "RMS error"
+              << std::setw(10) << "speedup" << "\n";
+    bool accurate = true;
+    for (size_t propIdx = 0; propIdx < props.size(); ++propIdx) {
+        const size_t n = samples[propIdx].temperature.size();
+        std::cout << std::left << std::setw(28) << props[propIdx].name
+                  << std::right << std::setw(10) << n;
+        if (n == 0) {
+            std::cout << std::setw(14) << "(no states)" << "\n";
+            continue;
+        }
+
+        const PropertyError& error = errors[propIdx];
+        std::cout << std::setw(14) << std::scientific << std::setprecision(3) << error.max
+                  << std::setw(14) << error.rms
+                  << std::setw(10) << std::fixed << std::setprecision(2)
+                  << nsPerEval[propIdx].first/nsPerEval[propIdx].second;
+        if (!(error.max <= options.maxError)) {
+            std::cout << "  (exceeds " << toString(options.maxError) << ")";
+            accurate = false;
+        }
+        std::cout << "\n";
+    }
+
+    if (options.suggest) {
+        std::cout << "\nSearching the smallest resolution for a maximum error of "
+                  << toString(options.maxError) << ":\n";
+        suggestResolution<TabulatedComponent>(props, samples, options);
+    }
+
+    return accurate;
+}
+
+// parse a pair of comma-separated values, e.g. "280,500"
+template <class T>
+void parsePair(T& first, T& second, const std::string& arg, const std::string& value)
+{
+    std::istringstream iss(value);
+    char separator;
+    if (!(iss >> first >> separator >> second) || separator != ',' || !iss.eof())
+        OPM_THROW(std::invalid_argument, "Invalid argument: " << arg);
+}
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    BenchmarkOptions options;
+    TabulationOptions tabOptions;
+    const auto parseTabulationOption = [&tabOptions](const std::string& arg) {
+        if (arg.compare(0, 12, "--component=") == 0)
+            tabOptions.component = arg.substr(12);
+        else if (arg.compare(0, 14, "--temperature=") == 0)
+            parsePair(tabOptions.tempMin, tabOptions.tempMax, arg, arg.substr(14));
+        else if (arg.compare(0, 11, "--pressure=") == 0)
+            parsePair(tabOptions.pressMin, tabOptions.pressMax, arg, arg.substr(11));
+        else if (arg.compare(0, 13, "--resolution=") == 0)
+            parsePair(tabOptions.nTemp, tabOptions.nPress, arg, arg.substr(13));
+        else if (arg.compare(0, 12, "--max-error=") == 0)
+            tabOptions.maxError = std::stod(arg.substr(12));
+        else if (arg == "--suggest")
+            tabOptions.suggest = true;
+        else
+            return false;
+        return true;
+    };
+    if (!parseBenchmarkOptions(options, argc, argv, parseTabulationOption,
+                               " [--component=H2O|SimpleH2O] [--temperature=MIN,MAX]"
+                               " [--pressure=MIN,MAX] [--resolution=NTEMP,NPRESS]"
+                               " [--max-error=REL] [--suggest]"))
+        return 1;
+
+    if (tabOptions.tempMin >= tabOptions.tempMax || tabOptions.pressMin >= tabOptions.pressMax
+        || tabOptions.nTemp < 2 || tabOptions.nPress < 2)
+    {
+        std::cerr << "The temperature and pressure ranges must not be empty and the tables "
+                  << "need at least two steps in each direction\n";
+        return 1;
+    }
+
+    BenchmarkResults results;
+    bool accurate;
+    if (tabOptions.component == "H2O")
+        accurate = analyzeComponent<Opm::H2O<Scalar> >(results, tabOptions);
+    else if (tabOptions.component == "SimpleH2O")
+        accurate = analyzeComponent<Opm::SimpleH2O<Scalar> >(results, tabOptions);
+    else {
+        std::cerr << "Unknown component '" << tabOptions.component << "'\n";
+        return 1;
+    }
+
+    const int status = checkBenchmarkResults(results, options);
+    if (status != 0)
+        return status;
+    return accurate ? 0 : 3;
+}
@@ -0,0 +1,282 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief The infrastructure shared by the micro benchmark programs.
+ *
+ * A benchmark program measures a list of named benchmarks using runBenchmark() and
+ * passes the results to checkBenchmarkResults(). The command line options which are
+ * understood by parseBenchmarkOptions() are:
+ *
+ * - '--output=FILE': write the results to a file.
+ * - '--reference=FILE': report the benchmarks which got slower than in a file written
+ *   by a previous run. This option may be specified multiple times; a benchmark is
+ *   compared with each reference which contains a benchmark of the same name.
+ * - '--tolerance=FACTOR': a benchmark counts as slower if it takes more than FACTOR
+ *   times the reference (default: 1.25).
+ *
+ * If a regression is found, checkBenchmarkResults() returns 2. Since the results depend
+ * on the machine and the compiler, the references must be recorded in the same
+ * environment.
+ */
+#ifndef OPM_BENCHMARK_HARNESS_HPP
+#define OPM_BENCHMARK_HARNESS_HPP
+
+#include <opm/material/densead/Evaluation.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<std::string, double> > BenchmarkResults;
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions()
+        : tolerance(1.25)
+    {}
+
+    std::string outputFileName;
+    std::vector<std::string> referenceFileNames;
+    double tolerance;
+};
+
+/*!
+ * \brief Returns a short name of a scalar or automatic differentiation type.
+ */
+template <class Evaluation>
+struct EvaluationName
+{ static std::string get() { return "Scalar"; } };
+
+template <class Scalar, int numDerivs>
+struct EvaluationName<Opm::DenseAd::Evaluation<Scalar, numDerivs> >
+{
+    static std::string get()
+    {
+        std::ostringstream oss;
+        oss << "Evaluation<" << numDerivs << ">";
+        return oss.str();
+    }
+};
+
+// prevent the compiler from optimizing away the computation of a value by storing it
+// in a volatile variable. (this is a template so that the header can define it.)
+template <class Dummy = void>
+struct BenchmarkSink
+{ static volatile double value; };
+
+template <class Dummy>
+volatile double BenchmarkSink<Dummy>::value;
+
+/*!
+ * \brief Measure the time per evaluation of a benchmark body.
+ *
+ * The body is a functor which carries out 'numEvals' evaluations and returns a
+ * scalar which depends on all of their results. Each measurement lasts at least 20 ms
+ * and the best of five repetitions is reported.
+ */
+template <class Body>
+void runBenchmark(BenchmarkResults& results,
+                  const std::string& name,
+                  unsigned numEvals,
+                  const Body& body)
+{
+    typedef std::chrono::steady_clock Clock;
+    static const std::chrono::milliseconds minMeasurementDuration(20);
+    static const unsigned numRepetitions = 5;
+
+    // warm up the caches
+    double sink = body();
+
+    double bestNsPerEval = std::numeric_limits<double>::max();
+    for (unsigned repIdx = 0; repIdx < numRepetitions; ++repIdx) {
+        unsigned numRuns = 0;
+        const auto startTime = Clock::now();
+        Clock::duration elapsed;
+        do {
+            sink += body();
+            ++ numRuns;
+            elapsed = Clock::now() - startTime;
+        } while (elapsed < minMeasurementDuration);
+
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        bestNsPerEval = std::min(bestNsPerEval, ns/(static_cast<double>(numRuns)*numEvals));
+    }
+    BenchmarkSink<>::value = sink;
+
+    results.push_back(std::make_pair(name, bestNsPerEval));
+    std::cout << std::left << std::setw(72) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+              << bestNsPerEval << " ns/eval\n" << std::flush;
+}
+
+/*!
+ * \brief Parse the command line options of a benchmark program.
+ *
+ * Arguments which are not understood by the harness are passed to
+ * 'parseExtraOption', which returns true if it accepts them. If an argument is not
+ * accepted, a usage message which includes 'extraUsage' is printed and false is
+ * returned.
+ */
+template <class ExtraOptionParser>
+bool parseBenchmarkOptions(BenchmarkOptions& options,
+                           int argc,
+                           char **argv,
+                           const ExtraOptionParser& parseExtraOption,
+                           const std::string& extraUsage)
+{
+    for (int argIdx = 1; argIdx < argc; ++argIdx) {
+        const std::string arg(argv[argIdx]);
+        if (arg.compare(0, 9, "--output=") == 0)
+            options.outputFileName = arg.substr(9);
+        else if (arg.compare(0, 12, "--reference=") == 0)
+            options.referenceFileNames.push_back(arg.substr(12));
+        else if (arg.compare(0, 12, "--tolerance=") == 0)
+            options.tolerance = std::stod(arg.substr(12));
+        else if (!parseExtraOption(arg)) {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--output=FILE] [--reference=FILE]... [--tolerance=FACTOR]"
+                      << extraUsage << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Parse the command line options of a benchmark program which does not
+ *        accept any options besides the ones of the harness.
+ */
+inline bool parseBenchmarkOptions(BenchmarkOptions& options, int argc, char **argv)
+{
+    return parseBenchmarkOptions(options, argc, argv,
+                                 [](const std::string&) { return false; },
+                                 "");
+}
+
+/*!
+ * \brief Parse a comma-separated list of thread counts, e.g. "1,2,4".
+ */
+inline std::vector<int> parseThreadCounts(const std::string& list)
+{
+    std::vector<int> threadCounts;
+    std::istringstream iss(list);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        int n = std::stoi(item);
+        if (n < 1)
+            OPM_THROW(std::invalid_argument, "Invalid number of threads: " << item);
+        threadCounts.push_back(n);
+    }
+    return threadCounts;
+}
+
+inline void writeBenchmarkResults(const BenchmarkResults& results, const std::string& fileName)
+{
+    std::ofstream os(fileName);
+    if (!os)
+        OPM_THROW(std::runtime_error, "Could not open file '" << fileName << "' for writing");
+
+    os << std::setprecision(6);
+    for (const auto& result : results)
+        os << result.second << "\t" << result.first << "\n";
+}
+
+inline std::map<std::string, double> readBenchmarkResults(const std::string& fileName)
+{
+    std::ifstream is(fileName);
+    if (!is)
+        OPM_THROW(std::runtime_error, "Could not open file '" << fileName << "' for reading");
+
+    std::map<std::string, double> results;
+    std::string line;
+    while (std::getline(is, line)) {
+        size_t tabPos = line.find('\t');
+        if (tabPos == std::string::npos)
+            continue;
+        results[line.substr(tabPos + 1)] = std::stod(line.substr(0, tabPos));
+    }
+    return results;
+}
+
+// returns the number of benchmarks which are slower than their reference
+inline unsigned compareBenchmarkResults(const BenchmarkResults& results,
+                                        const std::map<std::string, double>& reference,
+                                        const std::string& referenceName,
+                                        double tolerance)
+{
+    unsigned numRegressions = 0;
+    for (const auto& result : results) {
+        const auto refIt = reference.find(result.first);
+        if (refIt == reference.end())
+            continue;
+
+        if (result.second > tolerance*refIt->second) {
+            std::cout << "REGRESSION: " << result.first << ": "
+                      << result.second << " ns/eval (" << referenceName << ": "
+                      << refIt->second << " ns/eval)\n";
+            ++ numRegressions;
+        }
+    }
+    return numRegressions;
+}
+
+/*!
+ * \brief Write the results and compare them with the references as requested by the
+ *        command line options.
+ *
+ * Returns the exit status of the benchmark program: 0 if no benchmark got slower than
+ * a reference, else 2.
+ */
+inline int checkBenchmarkResults(const BenchmarkResults& results, const BenchmarkOptions& options)
+{
+    if (!options.outputFileName.empty())
+        writeBenchmarkResults(results, options.outputFileName);
+
+    unsigned numRegressions = 0;
+    for (const auto& referenceFileName : options.referenceFileNames)
+        numRegressions += compareBenchmarkResults(results,
+                                                  readBenchmarkResults(referenceFileName),
+                                                  referenceFileName,
+                                                  options.tolerance);
+
+    if (numRegressions > 0) {
+        std::cout << numRegressions << " benchmark(s) are slower than the reference\n";
+        return 2;
+    }
+    return 0;
+}
+
+#endif
@@ -29,8 +29,17 @@
  */
 #include "config.h"
 
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/ErrorStatus.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/UniformTabulated2DFunction.hpp>
+#include <opm/material/common/UniformTabulated3DFunction.hpp>
+#include <opm/material/common/UniformXTabulated2DMultiFunction.hpp>
+#include <opm/material/common/UniformTabulated2DMultiFunction.hpp>
+#include <opm/material/common/RegionTabulated1DMultiFunction.hpp>
+#include <opm/material/common/SharedFlatTables.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
 
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #include <dune/common/parallel/mpihelper.hh>
@@ -39,6 +48,13 @@
 #include <memory>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
 
 
 template <class ScalarT>
@@ -55,6 +71,9 @@ static Scalar testFn2(Scalar /* x */, Scalar y)
 static Scalar testFn3(Scalar x, Scalar y)
 { return x*y; }
 
+static Scalar testFn4(Scalar x, Scalar y)
+{ return std::sin(x)*std::exp(y); }
+
 template <class Fn>
 std::shared_ptr<Opm::UniformTabulated2DFunction<Scalar> >
 createUniformTabulatedFunction(Fn& f)
@@ -164,6 +183,804 @@ bool compareTableWithAnalyticFn(const Table& table,
     return true;
 }
 
+// make sure that bi-cubic interpolation of uniform tables reproduces the sampling
+// points and bi-linear functions, and that it is considerably more accurate than
+// bi-linear interpolation for smooth functions
+bool compareBicubicInterpolation(Scalar tolerance)
+{
+    auto tab = createUniformTabulatedFunction(testFn3);
+    tab->enableBicubicInterpolation();
+    if (!tab->bicubicInterpolationEnabled()) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": bi-cubic interpolation not enabled\n";
+        return false;
+    }
+    if (!compareTableWithAnalyticFn(tab,
+                                    tab->xMin(), tab->xMax(), tab->numX()*5,
+                                    tab->yMin(), tab->yMax(), tab->numY()*5,
+                                    testFn3,
+                                    tolerance))
+        return false;
+    tab->setSamplePoint(0, 0, tab->getSamplePoint(0, 0));
+    if (tab->bicubicInterpolationEnabled()) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": bi-cubic interpolation still enabled\n";
+        return false;
+    }
+
+    Scalar xMin = -2.0;
+    Scalar xMax = 3.0;
+    unsigned m = 21;
+    Scalar yMin = -1.0;
+    Scalar yMax = 1.0;
+    unsigned n = 17;
+    Opm::UniformTabulated2DFunction<Scalar> linearTab(xMin, xMax, m, yMin, yMax, n);
+    for (unsigned i = 0; i < m; ++i)
+        for (unsigned j = 0; j < n; ++j)
+            linearTab.setSamplePoint(i, j, testFn4(linearTab.iToX(i), linearTab.jToY(j)));
+    Opm::UniformTabulated2DFunction<Scalar> cubicTab(linearTab);
+    cubicTab.enableBicubicInterpolation();
+
+    Scalar linearError = 0.0;
+    Scalar cubicError = 0.0;
+    for (unsigned i = 0; i < m; ++i) {
+        for (unsigned j = 0; j < n; ++j) {
+            Scalar x = cubicTab.iToX(i);
+            Scalar y = cubicTab.jToY(j);
+            if (std::abs(cubicTab.eval(x, y) - cubicTab.getSamplePoint(i, j)) > tolerance) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": cubicTab.eval("<<x<<","<<y<<") != "
+                          << cubicTab.getSamplePoint(i, j) << "\n";
+                return false;
+            }
+        }
+    }
+    for (unsigned i = 0; i <= 10*(m - 1); ++i) {
+        Scalar x = xMin + Scalar(i)/(10*(m - 1))*(xMax - xMin);
+        for (unsigned j = 0; j <= 10*(n - 1); ++j) {
+            Scalar y = yMin + Scalar(j)/(10*(n - 1))*(yMax - yMin);
+            linearError = std::max(linearError, std::abs(linearTab.eval(x, y) - testFn4(x, y)));
+            cubicError = std::max(cubicError, std::abs(cubicTab.eval(x, y) - testFn4(x, y)));
+        }
+    }
+    if (!(cubicError < linearError/4)) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": bi-cubic interpolation is not more accurate: "
+                  << cubicError << " vs. " << linearError << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+template <class Fn>
+bool compareCellWiseLayout(Fn& f)
+{
+    // the cell-wise layout and the batched evaluation must not change the results
+    auto tab = createUniformTabulatedFunction(f);
+    Opm::UniformTabulated2DFunction<Scalar> cellWiseTab(*tab);
+    cellWiseTab.enableCellWiseLayout();
+    if (!cellWiseTab.cellWiseLayoutEnabled()) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": cell-wise layout not enabled\n";
+        return false;
+    }
+
+    std::vector<Scalar> xs, ys;
+    for (unsigned i = 0; i <= 3*tab->numX(); ++i) {
+        Scalar x = tab->xMin() + Scalar(i)/(3*tab->numX())*(tab->xMax() - tab->xMin());
+        for (unsigned j = 0; j <= 3*tab->numY(); ++j) {
+            Scalar y = tab->yMin() + Scalar(j)/(3*tab->numY())*(tab->yMax() - tab->yMin());
+            xs.push_back(std::min(x, tab->xMax()));
+            ys.push_back(std::min(y, tab->yMax()));
+        }
+    }
+
+    std::vector<Scalar> results;
+    cellWiseTab.evalMany(xs, ys, results);
+    if (results.size() != xs.size()) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": evalMany() yields the wrong number of results\n";
+        return false;
+    }
+    for (size_t k = 0; k < xs.size(); ++k) {
+        if (cellWiseTab.eval(xs[k], ys[k]) != tab->eval(xs[k], ys[k])
+            || results[k] != tab->eval(xs[k], ys[k]))
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": cell-wise evaluation differs at ("
+                      << xs[k] << "," << ys[k] << ")\n";
+            return false;
+        }
+    }
+
+    // changing a sample point drops the cell-wise copy of the samples
+    cellWiseTab.setSamplePoint(0, 0, cellWiseTab.getSamplePoint(0, 0));
+    if (cellWiseTab.cellWiseLayoutEnabled()) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": cell-wise layout still enabled\n";
+        return false;
+    }
+
+    return true;
+}
+
+template <class Fn>
+bool compareValueOnlyEvaluation(Fn& f)
+{
+    // the value-only mode of evalMany() must yield the results of the evaluation of
+    // scalars and, up to round-off, the values of the evaluation which computes the
+    // derivatives
+    typedef Opm::DenseAd::Evaluation<Scalar, 2> Evaluation;
+
+    auto tab2D = createUniformTabulatedFunction(f);
+    std::vector<Scalar> xValues, yValues;
+    for (unsigned i = 0; i <= tab2D->numX(); ++i) {
+        xValues.push_back(tab2D->xMin() + Scalar(i)/tab2D->numX()*(tab2D->xMax() - tab2D->xMin()));
+        yValues.push_back(f(xValues.back(), Scalar(0.5)));
+    }
+    Opm::Tabulated1DFunction<Scalar> tab1D(xValues, yValues);
+
+    std::vector<Evaluation> xs, ys;
+    for (unsigned i = 0; i <= 3*tab2D->numX(); ++i) {
+        Scalar x = tab2D->xMin() + Scalar(i)/(3*tab2D->numX())*(tab2D->xMax() - tab2D->xMin());
+        Scalar y = tab2D->yMin() + Scalar(i % 7)/7*(tab2D->yMax() - tab2D->yMin());
+        xs.push_back(Evaluation::createVariable(std::min(x, tab2D->xMax()), 0));
+        ys.push_back(Evaluation::createVariable(y, 1));
+    }
+
+    std::vector<Evaluation> results1D, results2D;
+    std::vector<Scalar> values1D, values2D;
+    tab1D.evalMany(xs, results1D);
+    tab1D.evalMany(xs, values1D);
+    tab2D->evalMany(xs, ys, results2D);
+    tab2D->evalMany(xs, ys, values2D);
+    const Scalar tolerance = 1e2*std::numeric_limits<Scalar>::epsilon();
+    for (size_t k = 0; k < xs.size(); ++k) {
+        const Scalar x = xs[k].value();
+        const Scalar y = ys[k].value();
+        if (values1D[k] != tab1D.eval(x)
+            || std::abs(values1D[k] - results1D[k].value()) > tolerance*(1 + std::abs(values1D[k])))
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": value-only tab1D.evalMany() differs at "
+                      << x << "\n";
+            return false;
+        }
+        if (values2D[k] != tab2D->eval(x, y)
+            || std::abs(values2D[k] - results2D[k].value()) > tolerance*(1 + std::abs(values2D[k])))
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": value-only tab2D.evalMany() differs at ("
+                      << x << "," << y << ")\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool compare3DTable(Scalar tolerance)
+{
+    // tri-linear interpolation must be exact for functions which are linear in each
+    // coordinate
+    Opm::UniformTabulated3DFunction<Scalar> tab(-2.0, 3.0, 11,
+                                                -4.0, 5.0, 13,
+                                                0.0, 1.0, 5);
+    for (unsigned k = 0; k < tab.numZ(); ++k)
+        for (unsigned j = 0; j < tab.numY(); ++j)
+            for (unsigned i = 0; i < tab.numX(); ++i)
+                tab.setSamplePoint(i, j, k,
+                                   testFn3(tab.iToX(i), tab.jToY(j))*tab.kToZ(k) + tab.kToZ(k));
+
+    for (unsigned i = 0; i <= 30; ++i) {
+        Scalar x = tab.xMin() + Scalar(i)/30*(tab.xMax() - tab.xMin());
+        for (unsigned j = 0; j <= 30; ++j) {
+            Scalar y = tab.yMin() + Scalar(j)/30*(tab.yMax() - tab.yMin());
+            for (unsigned k = 0; k <= 10; ++k) {
+                Scalar z = tab.zMin() + Scalar(k)/10*(tab.zMax() - tab.zMin());
+                x = std::min(x, tab.xMax());
+                y = std::min(y, tab.yMax());
+                z = std::min(z, tab.zMax());
+
+                if (!tab.applies(x, y, z)) {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": table does not apply to ("
+                              << x << "," << y << "," << z << ")\n";
+                    return false;
+                }
+
+                Scalar expected = testFn3(x, y)*z + z;
+                Scalar value = tab.eval(x, y, z);
+                if (std::abs(value - expected) > tolerance*(1 + std::abs(expected))) {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": 3D table deviates at ("
+                              << x << "," << y << "," << z << "): "
+                              << value << " vs " << expected << "\n";
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (tab.applies(Scalar(0.0), Scalar(0.0), Scalar(1.5))) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": table applies outside of its range\n";
+        return false;
+    }
+
+    return true;
+}
+
+template <class UniformXTablePtr>
+bool compareHintedEvaluation(const UniformXTablePtr& table,
+                             Scalar xMin,
+                             Scalar xMax,
+                             unsigned numX,
+
+                             Scalar yMin,
+                             Scalar yMax,
+                             unsigned numY)
+{
+    // make sure that using a lookup hint does not change the result. the hint is
+    // reused for all evaluations, so sometimes it is spot on and sometimes it is off.
+    typename UniformXTablePtr::element_type::LookupHint hint;
+    for (unsigned i = 0; i <= numX; ++i) {
+        Scalar x = xMin + Scalar(i)/numX*(xMax - xMin);
+
+        for (unsigned j = 0; j <= numY; ++j) {
+            Scalar y = yMin + Scalar((j*7) % (numY + 1))/numY*(yMax - yMin);
+            Scalar valHint = table->eval(x, y, hint, /*extrapolate=*/true);
+            Scalar val = table->eval(x, y, /*extrapolate=*/true);
+            if (valHint != val) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": table->eval("<<x<<","<<y<<", hint) != table->eval("<<x<<","<<y<<"): " << valHint << " != " << val << "\n";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template <class Fn1, class Fn2>
+bool compareMultiTable(Fn1& f1, Fn2& f2)
+{
+    // make sure that a table which stores two quantities per sampling point evaluates
+    // to the same thing as two separate tables
+    auto tab1 = createUniformXTabulatedFunction2(f1);
+    auto tab2 = createUniformXTabulatedFunction2(f2);
+
+    Opm::UniformXTabulated2DMultiFunction<Scalar, 2> multiTab;
+    for (unsigned i = 0; i < tab1->numX(); ++i) {
+        multiTab.appendXPos(tab1->xAt(i));
+        for (unsigned j = 0; j < tab1->numY(i); ++j)
+            multiTab.appendSamplePoint(i, tab1->yAt(i, j), {{ tab1->valueAt(i, j), tab2->valueAt(i, j) }});
+    }
+
+    unsigned m = 100;
+    unsigned n = 100;
+    for (unsigned i = 0; i <= m; ++i) {
+        Scalar x = -2.5 + Scalar(i)/m*6.0;
+        for (unsigned j = 0; j <= n; ++j) {
+            Scalar y = -4.5 + Scalar(j)/n*10.0;
+            std::array<Scalar, 2> values;
+            multiTab.eval(x, y, values, /*extrapolate=*/true);
+            if (values[0] != tab1->eval(x, y, /*extrapolate=*/true)
+                || values[1] != tab2->eval(x, y, /*extrapolate=*/true))
+            {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": multiTab.eval("<<x<<","<<y<<") != (tab1->eval("<<x<<","<<y<<"), tab2->eval("<<x<<","<<y<<"))\n";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template <class Fn1, class Fn2>
+bool compareFlatTables(Fn1& f1, Fn2& f2)
+{
+    // make sure that the flat representations of the tables which can be evaluated by
+    // device code yield the same values as the original tables
+    auto tab1 = createUniformXTabulatedFunction2(f1);
+    auto tab2 = createUniformXTabulatedFunction2(f2);
+
+    Opm::UniformXTabulated2DMultiFunction<Scalar, 2> multiTab;
+    for (unsigned i = 0; i < tab1->numX(); ++i) {
+        multiTab.appendXPos(tab1->xAt(i));
+        for (unsigned j = 0; j < tab1->numY(i); ++j)
+            multiTab.appendSamplePoint(i, tab1->yAt(i, j), {{ tab1->valueAt(i, j), tab2->valueAt(i, j) }});
+    }
+
+    std::vector<Scalar> xValues;
+    std::vector<Scalar> yValues;
+    for (unsigned i = 0; i < 20; ++i) {
+        xValues.push_back(-2.0 + i*i/100.0);
+        yValues.push_back(f1(xValues.back(), 0.5));
+    }
+    Opm::Tabulated1DFunction<Scalar> tab1D(xValues, yValues);
+
+    Opm::FlatTableBuffer<Scalar> buffer;
+    const auto& flatTab1 = tab1->exportFlat(buffer);
+    const auto& flatMultiTab = multiTab.exportFlat(buffer);
+    const auto& flatTab1D = tab1D.exportFlat(buffer);
+    const auto& data = buffer.data();
+
+    unsigned m = 100;
+    unsigned n = 100;
+    for (unsigned i = 0; i <= m; ++i) {
+        Scalar x = -2.5 + Scalar(i)/m*6.0;
+        if (flatTab1D.eval(data, x) != tab1D.eval(x, /*extrapolate=*/true)) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": flatTab1D.eval("<<x<<") != tab1D.eval("<<x<<")\n";
+            return false;
+        }
+
+        for (unsigned j = 0; j <= n; ++j) {
+            Scalar y = -4.5 + Scalar(j)/n*10.0;
+            Scalar values[2];
+            flatMultiTab.eval(data, x, y, values);
+            if (flatTab1.eval(data, x, y) != tab1->eval(x, y, /*extrapolate=*/true)
+                || values[0] != tab1->eval(x, y, /*extrapolate=*/true)
+                || values[1] != tab2->eval(x, y, /*extrapolate=*/true))
+            {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": the flat tables deviate from the original ones at ("<<x<<","<<y<<")\n";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template <class Fn1, class Fn2>
+bool compareSharedFlatTables(Fn1& f1, Fn2& f2)
+{
+    // make sure that the flat tables which are evaluated from a shared memory segment
+    // yield the same values as the original tables
+    auto tab1 = createUniformXTabulatedFunction2(f1);
+    auto tab2 = createUniformXTabulatedFunction2(f2);
+
+    typedef Opm::SharedFlatTableSegment<Scalar> Segment;
+    Opm::FlatTableBuffer<Scalar> buffer;
+    typename Segment::Descriptors descriptors;
+    unsigned blockIdx = descriptors.append(std::vector<Opm::FlatUniformXTabulated2DFunction<Scalar> >
+                                           { tab1->exportFlat(buffer), tab2->exportFlat(buffer) });
+
+    const std::string name =
+        "/opm-test-2dtables-" + std::to_string(getpid()) + "-" + std::to_string(sizeof(Scalar));
+    auto segment = Segment::create(name, buffer, descriptors);
+    auto attachedSegment = Segment::attach(name);
+
+    bool duplicateThrows = false;
+    try { Segment::create(name, buffer, descriptors); }
+    catch (const std::runtime_error&) { duplicateThrows = true; }
+    if (!duplicateThrows) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": creating an existing segment did not fail\n";
+        return false;
+    }
+
+    if (!segment->isOwner() || attachedSegment->isOwner()
+        || attachedSegment->numBlocks() != 1
+        || attachedSegment->numDescriptors(blockIdx) != 2)
+    {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": the attached segment is inconsistent\n";
+        return false;
+    }
+
+    const auto* flatTabs =
+        attachedSegment->template descriptors<Opm::FlatUniformXTabulated2DFunction<Scalar> >(blockIdx);
+    const auto& data = attachedSegment->data();
+    unsigned m = 50;
+    unsigned n = 50;
+    for (unsigned i = 0; i <= m; ++i) {
+        Scalar x = -2.5 + Scalar(i)/m*6.0;
+        for (unsigned j = 0; j <= n; ++j) {
+            Scalar y = -4.5 + Scalar(j)/n*10.0;
+            if (flatTabs[0].eval(data, x, y) != tab1->eval(x, y, /*extrapolate=*/true)
+                || flatTabs[1].eval(data, x, y) != tab2->eval(x, y, /*extrapolate=*/true))
+            {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": the shared tables deviate from the original ones at ("<<x<<","<<y<<")\n";
+                return false;
+            }
+        }
+    }
+
+    // the name of the segment is gone once its creator has released it
+    segment.reset();
+    bool missingThrows = false;
+    try { Segment::attach(name); }
+    catch (const std::runtime_error&) { missingThrows = true; }
+    if (!missingThrows) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": attaching to a removed segment did not fail\n";
+        return false;
+    }
+
+    return true;
+}
+
+template <class Fn>
+bool compareBulkConstruction(Fn& f)
+{
+    // make sure that tables which are filled column-wise or which take over the memory
+    // of their sampling points are identical to the ones filled point by point
+    auto tab = createUniformXTabulatedFunction2(f);
+
+    size_t numSamplePoints = 0;
+    for (unsigned i = 0; i < tab->numX(); ++i)
+        numSamplePoints += tab->numY(i);
+
+    Opm::UniformXTabulated2DFunction<Scalar> bulkTab;
+    bulkTab.reserve(tab->numX(), numSamplePoints);
+    for (unsigned i = 0; i < tab->numX(); ++i)
+        bulkTab.appendXPos(tab->xAt(i));
+
+    // fill the columns in reverse order, so that the subsequent columns need to be
+    // shifted
+    for (unsigned i = static_cast<unsigned>(tab->numX()); i-- > 0; ) {
+        std::vector<Scalar> y;
+        std::vector<Scalar> values;
+        for (unsigned j = 0; j < tab->numY(i); ++j) {
+            y.push_back(tab->yAt(i, j));
+            values.push_back(tab->valueAt(i, j));
+        }
+        bulkTab.appendSamplePoints(i, y, values);
+    }
+
+    for (unsigned i = 0; i < tab->numX(); ++i) {
+        if (bulkTab.numY(i) != tab->numY(i)) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": bulkTab.numY("<<i<<") != tab->numY("<<i<<")\n";
+            return false;
+        }
+        for (unsigned j = 0; j < tab->numY(i); ++j) {
+            if (bulkTab.yAt(i, j) != tab->yAt(i, j) || bulkTab.valueAt(i, j) != tab->valueAt(i, j)) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": bulkTab differs from tab at ("<<i<<","<<j<<")\n";
+                return false;
+            }
+        }
+    }
+
+    bool caughtException = false;
+    try {
+        std::vector<Scalar> y = { 1.0, 0.0 };
+        std::vector<Scalar> values = { 1.0, 2.0 };
+        bulkTab.appendSamplePoints(0, y, values);
+    }
+    catch (const std::invalid_argument&) {
+        caughtException = true;
+    }
+    if (!caughtException) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": appendSamplePoints() accepted unsorted points\n";
+        return false;
+    }
+
+    // one-dimensional functions, with sorted and with unsorted sampling points
+    for (unsigned sorted = 0; sorted < 2; ++sorted) {
+        std::vector<Scalar> xValues;
+        std::vector<Scalar> yValues;
+        for (unsigned i = 0; i < 20; ++i) {
+            Scalar x = sorted ? -2.0 + i*i/100.0 : -2.0 + ((7*i) % 20)/4.0;
+            xValues.push_back(x);
+            yValues.push_back(f(x, 0.5));
+        }
+
+        Opm::Tabulated1DFunction<Scalar> copiedTab(xValues, yValues);
+        Opm::Tabulated1DFunction<Scalar> movedTab(std::move(xValues), std::move(yValues));
+        for (unsigned i = 0; i < copiedTab.numSamples(); ++i) {
+            if (copiedTab.xAt(i) != movedTab.xAt(i) || copiedTab.valueAt(i) != movedTab.valueAt(i)) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": movedTab differs from copiedTab at "<<i<<"\n";
+                return false;
+            }
+            if (i > 0 && !(copiedTab.xAt(i - 1) < copiedTab.xAt(i))) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": sampling points are not sorted\n";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template <class Fn>
+bool compareNoThrowEvaluation(Fn& f)
+{
+    // make sure that the non-throwing variants yield the extrapolated values and that
+    // they record exactly the evaluations which were outside of the tabulated range
+    auto tab = createUniformXTabulatedFunction2(f);
+
+    std::vector<Scalar> xValues;
+    std::vector<Scalar> yValues;
+    for (unsigned i = 0; i < 20; ++i) {
+        xValues.push_back(-2.0 + i*i/100.0);
+        yValues.push_back(f(xValues.back(), 0.5));
+    }
+    Opm::Tabulated1DFunction<Scalar> tab1D(xValues, yValues);
+
+    Opm::ErrorStatus::reset();
+    unsigned numOutside = 0;
+    unsigned m = 50;
+    unsigned n = 50;
+    for (unsigned i = 0; i <= m; ++i) {
+        Scalar x = -2.5 + Scalar(i)/m*6.0;
+        for (unsigned j = 0; j <= n; ++j) {
+            Scalar y = -4.5 + Scalar(j)/n*10.0;
+            if (!tab->applies(x, y))
+                ++ numOutside;
+            if (tab->evalNoThrow(x, y) != tab->eval(x, y, /*extrapolate=*/true)) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": tab->evalNoThrow("<<x<<","<<y<<") != tab->eval("<<x<<","<<y<<", true)\n";
+                return false;
+            }
+        }
+
+        if (!tab1D.applies(x))
+            ++ numOutside;
+        if (tab1D.evalNoThrow(x) != tab1D.eval(x, /*extrapolate=*/true)) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": tab1D.evalNoThrow("<<x<<") != tab1D.eval("<<x<<", true)\n";
+            return false;
+        }
+    }
+
+    std::vector<Scalar> x(m + 1);
+    std::vector<Scalar> result(m + 1);
+    for (unsigned i = 0; i <= m; ++i) {
+        x[i] = -2.5 + Scalar(i)/m*6.0;
+        if (!tab1D.applies(x[i]))
+            ++ numOutside;
+    }
+    tab1D.evalManyNoThrow(x.size(), x.data(), result.data());
+    for (unsigned i = 0; i <= m; ++i) {
+        if (result[i] != tab1D.eval(x[i], /*extrapolate=*/true)) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": tab1D.evalManyNoThrow() differs at x = " << x[i] << "\n";
+            return false;
+        }
+    }
+
+    if (numOutside == 0
+        || Opm::ErrorStatus::count(Opm::ErrorStatus::TableOutOfRange) != numOutside
+        || Opm::ErrorStatus::count(Opm::ErrorStatus::FlashNotConverged) != 0)
+    {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": ErrorStatus recorded "
+                  << Opm::ErrorStatus::count(Opm::ErrorStatus::TableOutOfRange)
+                  << " out of range evaluations instead of " << numOutside << "\n";
+        return false;
+    }
+
+    Opm::ErrorStatus::reset();
+    if (Opm::ErrorStatus::any()) {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": ErrorStatus::any() after reset()\n";
+        return false;
+    }
+
+    return true;
+}
+
+template <class Fn1, class Fn2>
+bool compareUniformMultiTable(Fn1& f1, Fn2& f2, Scalar tolerance)
+{
+    // make sure that a uniform table which stores two quantities per sampling point
+    // evaluates to the same thing as two separate uniform tables
+    auto tab1 = createUniformTabulatedFunction(f1);
+    auto tab2 = createUniformTabulatedFunction(f2);
+
+    Opm::UniformTabulated2DMultiFunction<Scalar, 2> multiTab(tab1->xMin(), tab1->xMax(), tab1->numX(),
+                                                             tab1->yMin(), tab1->yMax(), tab1->numY());
+    multiTab.sample([&](Scalar x, Scalar y, std::array<Scalar, 2>& values) {
+            values[0] = f1(x, y);
+            values[1] = f2(x, y);
+        });
+
+    unsigned m = 100;
+    unsigned n = 100;
+    for (unsigned i = 0; i <= m; ++i) {
+        Scalar x = tab1->xMin() + (i + 0.5)/(m + 1)*(tab1->xMax() - tab1->xMin());
+        for (unsigned j = 0; j <= n; ++j) {
+            Scalar y = tab1->yMin() + (j + 0.5)/(n + 1)*(tab1->yMax() - tab1->yMin());
+            std::array<Scalar, 2> values;
+            multiTab.eval(x, y, values);
+            if (std::abs(values[0] - tab1->eval(x, y)) > tolerance
+                || std::abs(values[1] - tab2->eval(x, y)) > tolerance)
+            {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": multiTab.eval("<<x<<","<<y<<") != (tab1->eval("<<x<<","<<y<<"), tab2->eval("<<x<<","<<y<<"))\n";
+                return false;
+            }
+        }
+    }
+
+    if (multiTab.applies(tab1->xMax() + 1, tab1->yMin()))
+        return false;
+
+    return true;
+}
+
+template <class Fn1, class Fn2>
+bool compareRegionMultiTable(Fn1& f1, Fn2& f2)
+{
+    // make sure that a table which stores two quantities for several regions evaluates
+    // to exactly the same thing as separate 1D tables for each quantity and region
+    typedef Opm::Tabulated1DFunction<Scalar> Table;
+    typedef Opm::RegionTabulated1DMultiFunction<Scalar, 2> RegionTable;
+
+    const unsigned numRegions = 3;
+    std::vector<Table> tabs1(numRegions);
+    std::vector<Table> tabs2(numRegions);
+    RegionTable regionTab;
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+        // use a different, non-uniform sampling for each region
+        const unsigned numSamples = 5 + 7*regionIdx;
+        std::vector<Scalar> xValues(numSamples);
+        std::vector<Scalar> yValues1(numSamples);
+        std::vector<Scalar> yValues2(numSamples);
+        std::vector<typename RegionTable::ValueArray> values(numSamples);
+        for (unsigned i = 0; i < numSamples; ++i) {
+            Scalar alpha = Scalar(i)/(numSamples - 1);
+            xValues[i] = -2.0 + 5.0*alpha*alpha;
+            yValues1[i] = f1(xValues[i], Scalar(regionIdx));
+            yValues2[i] = f2(xValues[i], Scalar(regionIdx));
+            values[i] = {{ yValues1[i], yValues2[i] }};
+        }
+        tabs1[regionIdx].setXYContainers(xValues, yValues1);
+        tabs2[regionIdx].setXYContainers(xValues, yValues2);
+        regionTab.appendRegion(xValues, values);
+    }
+
+    if (regionTab.numRegions() != numRegions)
+        return false;
+
+    unsigned m = 200;
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+        for (unsigned i = 0; i <= m; ++i) {
+            Scalar x = -2.5 + Scalar(i)/m*6.0;
+            std::array<Scalar, 2> values;
+            regionTab.eval(regionIdx, x, values);
+            if (values[0] != tabs1[regionIdx].eval(x, /*extrapolate=*/true)
+                || values[1] != tabs2[regionIdx].eval(x, /*extrapolate=*/true)
+                || regionTab.eval(regionIdx, 1, x) != values[1])
+            {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": regionTab.eval("<<regionIdx<<","<<x<<") != (tabs1["<<regionIdx<<"].eval("<<x<<"), tabs2["<<regionIdx<<"].eval("<<x<<"))\n";
+                return false;
+            }
+        }
+    }
+
+    // lookups which use a hint must yield the same results regardless of whether the
+    // hinted segment is the correct one
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+        typename RegionTable::LookupHint hint;
+        for (unsigned i = 0; i <= m; ++i) {
+            Scalar x = -2.5 + Scalar((i*37) % (m + 1))/m*6.0;
+            if (i > m/2)
+                x = -2.5 + Scalar(i)/m*6.0;
+            std::array<Scalar, 2> values;
+            std::array<Scalar, 2> hintedValues;
+            regionTab.eval(regionIdx, x, values);
+            regionTab.eval(regionIdx, x, hintedValues, hint);
+            if (values != hintedValues) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": hinted regionTab.eval("<<regionIdx<<","<<x<<") != regionTab.eval("<<regionIdx<<","<<x<<")\n";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template <class Fn>
+bool compareMonotoneCubicInterpolation(Fn& f)
+{
+    // the monotone cubic interpolation of the 1D and the 2D tables must reproduce the
+    // sampling points, it must not overshoot them and its derivatives must be
+    // continuous at the sampling points
+    typedef Opm::DenseAd::Evaluation<Scalar, 2> Evaluation;
+    typedef Opm::Tabulated1DFunction<Scalar> Table1D;
+    typedef Opm::UniformXTabulated2DFunction<Scalar> Table2D;
+
+    const unsigned numX = 9;
+    const unsigned numY = 11;
+    std::vector<Scalar> xValues(numX);
+    std::vector<Scalar> yValues(numX);
+    for (unsigned i = 0; i < numX; ++i) {
+        Scalar alpha = Scalar(i)/(numX - 1);
+        xValues[i] = -2.0 + 5.0*alpha*alpha;
+        yValues[i] = f(xValues[i], Scalar(0.5));
+    }
+    Table1D tab1D(xValues, yValues);
+    tab1D.setInterpolation(Opm::TableInterpolation::MonotoneCubic);
+
+    // the interpolation scheme of the 2D table is set before its sampling points
+    Table2D tab2D;
+    tab2D.setInterpolation(Opm::TableInterpolation::MonotoneCubic);
+    for (unsigned i = 0; i < numX; ++i) {
+        tab2D.appendXPos(xValues[i]);
+        for (unsigned j = 0; j < numY; ++j) {
+            Scalar y = -1.0 + 2.0*Scalar(j)/(numY - 1) + 0.05*i;
+            tab2D.appendSamplePoint(i, y, f(xValues[i], y));
+        }
+    }
+
+    const Scalar tolerance = 1e2*std::numeric_limits<Scalar>::epsilon();
+    for (unsigned i = 0; i < numX; ++i) {
+        if (std::abs(tab1D.eval(xValues[i]) - yValues[i]) > tolerance) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": tab1D.eval("<<xValues[i]<<") != "<<yValues[i]<<"\n";
+            return false;
+        }
+        for (unsigned j = 0; j < numY; ++j) {
+            Scalar x = tab2D.xAt(i);
+            Scalar y = tab2D.yAt(i, j);
+            if (std::abs(tab2D.eval(x, y, /*extrapolate=*/true) - tab2D.valueAt(i, j)) > tolerance) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": tab2D.eval("<<x<<","<<y<<") != "<<tab2D.valueAt(i, j)<<"\n";
+                return false;
+            }
+        }
+    }
+
+    // no overshoots between the sampling points of the 1D table and of the columns
+    // of the 2D table
+    const unsigned m = 50;
+    for (unsigned i = 0; i + 1 < numX; ++i) {
+        Scalar yLow = std::min(yValues[i], yValues[i + 1]);
+        Scalar yHigh = std::max(yValues[i], yValues[i + 1]);
+        for (unsigned k = 0; k <= m; ++k) {
+            Scalar x = xValues[i] + (xValues[i + 1] - xValues[i])*Scalar(k)/m;
+            Scalar value = tab1D.eval(x);
+            if (value < yLow - tolerance || value > yHigh + tolerance) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": tab1D.eval("<<x<<") overshoots\n";
+                return false;
+            }
+        }
+
+        for (unsigned j = 0; j + 1 < numY; ++j) {
+            Scalar vLow = std::min(tab2D.valueAt(i, j), tab2D.valueAt(i, j + 1));
+            Scalar vHigh = std::max(tab2D.valueAt(i, j), tab2D.valueAt(i, j + 1));
+            for (unsigned k = 0; k <= m; ++k) {
+                Scalar y = tab2D.yAt(i, j) + (tab2D.yAt(i, j + 1) - tab2D.yAt(i, j))*Scalar(k)/m;
+                Scalar value = tab2D.eval(tab2D.xAt(i), y, /*extrapolate=*/true);
+                if (value < vLow - tolerance || value > vHigh + tolerance) {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": tab2D.eval("<<tab2D.xAt(i)<<","<<y<<") overshoots\n";
+                    return false;
+                }
+            }
+        }
+    }
+
+    // continuity of the derivatives at the interior sampling points
+    const Scalar y0 = 0.3;
+    for (unsigned i = 1; i + 1 < numX; ++i) {
+        Scalar eps = 1e-4*(xValues[i + 1] - xValues[i - 1]);
+        Scalar leftDeriv = tab1D.evalDerivative(xValues[i] - eps);
+        Scalar rightDeriv = tab1D.evalDerivative(xValues[i] + eps);
+        if (std::abs(leftDeriv - rightDeriv) > 1e-2*(1 + std::abs(leftDeriv))) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": the derivative of tab1D is discontinuous at "<<xValues[i]<<"\n";
+            return false;
+        }
+
+        const Evaluation& y = Evaluation::createVariable(y0, 1);
+        const Evaluation& left = tab2D.eval(Evaluation::createVariable(xValues[i] - eps, 0), y, /*extrapolate=*/true);
+        const Evaluation& right = tab2D.eval(Evaluation::createVariable(xValues[i] + eps, 0), y, /*extrapolate=*/true);
+        for (unsigned dirIdx = 0; dirIdx < 2; ++dirIdx) {
+            if (std::abs(left.derivative(dirIdx) - right.derivative(dirIdx))
+                > 1e-2*(1 + std::abs(left.derivative(dirIdx))))
+            {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": the derivative of tab2D is discontinuous at ("<<xValues[i]<<","<<y0<<")\n";
+                return false;
+            }
+        }
+
+        // in y direction at the sampling points of a column
+        const Evaluation& x = Evaluation::createVariable(tab2D.xAt(i), 0);
+        for (unsigned j = 1; j + 1 < numY; ++j) {
+            Scalar yEps = 1e-4*(tab2D.yAt(i, j + 1) - tab2D.yAt(i, j - 1));
+            const Evaluation& below = tab2D.eval(x, Evaluation::createVariable(tab2D.yAt(i, j) - yEps, 1), /*extrapolate=*/true);
+            const Evaluation& above = tab2D.eval(x, Evaluation::createVariable(tab2D.yAt(i, j) + yEps, 1), /*extrapolate=*/true);
+            if (std::abs(below.derivative(1) - above.derivative(1)) > 1e-2*(1 + std::abs(below.derivative(1)))) {
+                std::cerr << __FILE__ << ":" << __LINE__ << ": the derivative of tab2D is discontinuous at ("<<tab2D.xAt(i)<<","<<tab2D.yAt(i, j)<<")\n";
+                return false;
+            }
+        }
+    }
+
+    // the interpolation scheme survives the serialization
+    Opm::BinaryWriter writer;
+    tab2D.serialize(writer);
+    Opm::BinaryReader reader(writer.data());
+    Table2D restoredTab2D;
+    restoredTab2D.deserialize(reader);
+    if (restoredTab2D.interpolation() != Opm::TableInterpolation::MonotoneCubic
+        || restoredTab2D.eval(Scalar(0.7), Scalar(0.1), /*extrapolate=*/true)
+           != tab2D.eval(Scalar(0.7), Scalar(0.1), /*extrapolate=*/true))
+    {
+        std::cerr << __FILE__ << ":" << __LINE__ << ": the restored tab2D differs from the original one\n";
+        return false;
+    }
+
+    return true;
+}
+
 template <class UniformTablePtr, class UniformXTablePtr, class Fn>
 bool compareTables(const UniformTablePtr uTable,
                    const UniformXTablePtr uXTable,
@@ -359,6 +1176,34 @@ inline int testAll( const typename TestType::Scalar tolerance = 1e-6 )
                                     TestType::testFn3,
                                     /*tolerance=*/1e-2))
         return 1;
+    if (!test.compareHintedEvaluation(uniformXTab,
+                                      -2.5, 3.5, 100,
+                                      -4.5, 5.5, 100))
+        return 1;
+    if (!test.compareMultiTable(TestType::testFn1, TestType::testFn3))
+        return 1;
+    if (!test.compareFlatTables(TestType::testFn1, TestType::testFn3))
+        return 1;
+    if (!test.compareSharedFlatTables(TestType::testFn1, TestType::testFn3))
+        return 1;
+    if (!test.compareNoThrowEvaluation(TestType::testFn3))
+        return 1;
+    if (!test.compareBulkConstruction(TestType::testFn3))
+        return 1;
+    if (!test.compareUniformMultiTable(TestType::testFn2, TestType::testFn4, tolerance))
+        return 1;
+    if (!test.compareRegionMultiTable(TestType::testFn3, TestType::testFn4))
+        return 1;
+    if (!test.compareBicubicInterpolation(/*tolerance=*/std::sqrt(tolerance)))
+        return 1;
+    if (!test.compareMonotoneCubicInterpolation(TestType::testFn4))
+        return 1;
+    if (!test.compareCellWiseLayout(TestType::testFn4))
+        return 1;
+    if (!test.compareValueOnlyEvaluation(TestType::testFn4))
+        return 1;
+    if (!test.compare3DTable(/*tolerance=*/std::sqrt(tolerance)*1e-2))
+        return 1;
 
     // CSV output for debugging
 #if 0
@@ -0,0 +1,324 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the C interface to the array-valued black-oil
+ *        kernels.
+ *
+ * It compares the results of the interface with the ones of the C++ kernels which it
+ * wraps. This test requires the presence of opm-parser.
+ */
+#include "config.h"
+
+#if !HAVE_OPM_PARSER
+#error "The test for the C interface requires the opm-parser module"
+#endif
+
+#include <opm/material/capi/OpmMaterialCApi.h>
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+#include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
+
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// a small deck with a live oil and a wet gas
+static const char* deckString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   4 4 2 /\n"
+    "\n"
+    "TABDIMS\n"
+    "/\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "\n"
+    "DISGAS\n"
+    "VAPOIL\n"
+    "\n"
+    "METRIC\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "   32*100 /\n"
+    "DY\n"
+    "   32*100 /\n"
+    "DZ\n"
+    "   32*10 /\n"
+    "\n"
+    "TOPS\n"
+    "   16*1234 /\n"
+    "\n"
+    "PROPS\n"
+    "\n"
+    "DENSITY\n"
+    "   800.0 1000.0 0.9 /\n"
+    "\n"
+    "PVTW\n"
+    "   200.0 1.02 4.5e-5 0.5 0.0 /\n"
+    "\n"
+    "PVTO\n"
+    "-- RS    PRESSURE  BO    VISCOSITY\n"
+    "   10.0   20.0     1.05  1.50\n"
+    "         300.0     1.03  1.80 /\n"
+    "   50.0  100.0     1.15  1.20\n"
+    "         300.0     1.13  1.40 /\n"
+    "  100.0  200.0     1.25  0.90\n"
+    "         300.0     1.24  1.00 /\n"
+    "/\n"
+    "\n"
+    "PVTG\n"
+    "-- PRESSURE  RV      BG      VISCOSITY\n"
+    "    10.0     1.0e-4  0.100   0.010\n"
+    "             0.0     0.099   0.009 /\n"
+    "   100.0     5.0e-4  0.010   0.015\n"
+    "             0.0     0.0099  0.014 /\n"
+    "   300.0     1.0e-3  0.004   0.025\n"
+    "             0.0     0.0039  0.024 /\n"
+    "/\n"
+    "\n"
+    "SWOF\n"
+    "0.12  0       1      0\n"
+    "0.24  0.0002  0.997  0.2\n"
+    "0.36  0.0008  0.7    0.1\n"
+    "0.48  0.002   0.2    0.05\n"
+    "0.6   0.003   0.021  0.02\n"
+    "0.72  0.005   0.001  0.01\n"
+    "0.84  0.007   0      0\n"
+    "1     0.984   0      0 /\n"
+    "\n"
+    "SGOF\n"
+    "0     0      1      0\n"
+    "0.05  0.005  0.98   0.01\n"
+    "0.2   0.075  0.35   0.03\n"
+    "0.3   0.19   0.09   0.05\n"
+    "0.5   0.72   0.001  0.1\n"
+    "0.7   0.94   0      0.2\n"
+    "0.88  0.984  0      0.3 /\n";
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    typedef Opm::FluidSystems::BlackOil<double> FluidSystem;
+    typedef Opm::ThreePhaseMaterialTraits<double,
+                                          /*wettingPhaseIdx=*/FluidSystem::waterPhaseIdx,
+                                          /*nonWettingPhaseIdx=*/FluidSystem::oilPhaseIdx,
+                                          /*gasPhaseIdx=*/FluidSystem::gasPhaseIdx> MaterialTraits;
+    typedef Opm::EclMaterialLawManager<MaterialTraits> MaterialLawManager;
+    enum { numPhases = FluidSystem::numPhases };
+
+    // the interface reads the deck from a file
+    const std::string deckFileName = "test_capi.DATA";
+    {
+        std::ofstream deckFile(deckFileName);
+        deckFile << deckString;
+    }
+
+    OpmMaterialEclModel* model = opm_material_ecl_model_create(deckFileName.c_str());
+    std::remove(deckFileName.c_str());
+    if (!model)
+        OPM_THROW(std::logic_error,
+                  "Could not create the model: " << opm_material_last_error());
+
+    if (opm_material_ecl_model_create("non-existing.DATA") != nullptr
+        || std::string(opm_material_last_error()).empty())
+        OPM_THROW(std::logic_error, "Reading a non-existing deck file must fail");
+
+    // the C++ kernels for the same deck
+    Opm::Parser parser;
+    Opm::ParseContext parseContext;
+    const auto deck = parser.parseString(deckString, parseContext);
+    const Opm::EclipseState eclState(deck, parseContext);
+
+    const size_t n = eclState.getInputGrid().getCartesianSize();
+    if (opm_material_ecl_model_num_cells(model) != n)
+        OPM_THROW(std::logic_error,
+                  "The model is supposed to have " << n << " cells. (has "
+                  << opm_material_ecl_model_num_cells(model) << ")");
+
+    FluidSystem::Context fluidSystemContext;
+    {
+        FluidSystem::ScopedContext scopedContext(fluidSystemContext);
+        FluidSystem::initFromDeck(deck, eclState);
+    }
+
+    std::vector<int> compressedToCartesianIdx(n);
+    for (size_t i = 0; i < n; ++ i)
+        compressedToCartesianIdx[i] = static_cast<int>(i);
+    MaterialLawManager materialLawManager;
+    materialLawManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+        if (opm_material_ecl_model_phase_is_active(model, phaseIdx) != 1)
+            OPM_THROW(std::logic_error, "Phase " << phaseIdx << " is supposed to be active");
+    if (opm_material_ecl_model_phase_is_active(model, numPhases) != 0)
+        OPM_THROW(std::logic_error, "Invalid phase indices must be inactive");
+
+    // the per-cell inputs
+    std::vector<double> pressure[numPhases];
+    std::vector<double> saturation[numPhases];
+    std::vector<double> Rs(n);
+    std::vector<double> Rv(n);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        pressure[phaseIdx].resize(n);
+        saturation[phaseIdx].resize(n);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const double Sw = 0.12 + 0.6*i/n;
+        const double Sg = 0.1*(i % 3);
+        saturation[FluidSystem::waterPhaseIdx][i] = Sw;
+        saturation[FluidSystem::gasPhaseIdx][i] = Sg;
+        saturation[FluidSystem::oilPhaseIdx][i] = 1.0 - Sw - Sg;
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            pressure[phaseIdx][i] = 1e7 + 1e5*i + 1e4*phaseIdx;
+
+        Rs[i] = 20.0 + 0.5*i;
+        Rv[i] = 1e-4*(i % 4);
+    }
+
+    // the PVT properties
+    {
+        std::vector<double> results[4][numPhases];
+        std::vector<double> refResults[4][numPhases];
+
+        OpmMaterialPhasePropertyInput input;
+        input.numCells = n;
+        input.regionIdx = nullptr;
+        input.temperature = nullptr;
+        input.Rs = Rs.data();
+        input.Rv = Rv.data();
+
+        OpmMaterialPhasePropertyOutput output;
+        FluidSystem::PropertyExportInput refInput;
+        refInput.numCells = n;
+        refInput.Rs = Rs.data();
+        refInput.Rv = Rv.data();
+
+        FluidSystem::PropertyExportOutput refOutput;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            input.pressure[phaseIdx] = pressure[phaseIdx].data();
+            input.saturation[phaseIdx] = saturation[phaseIdx].data();
+            refInput.pressure[phaseIdx] = pressure[phaseIdx].data();
+            refInput.saturation[phaseIdx] = saturation[phaseIdx].data();
+
+            for (unsigned quantityIdx = 0; quantityIdx < 4; ++quantityIdx) {
+                results[quantityIdx][phaseIdx].resize(n);
+                refResults[quantityIdx][phaseIdx].resize(n);
+            }
+
+            output.invB[phaseIdx] = results[0][phaseIdx].data();
+            output.density[phaseIdx] = results[1][phaseIdx].data();
+            output.viscosity[phaseIdx] = results[2][phaseIdx].data();
+            output.saturatedDissolutionFactor[phaseIdx] = results[3][phaseIdx].data();
+
+            refOutput.invB[phaseIdx] = refResults[0][phaseIdx].data();
+            refOutput.density[phaseIdx] = refResults[1][phaseIdx].data();
+            refOutput.viscosity[phaseIdx] = refResults[2][phaseIdx].data();
+            refOutput.saturatedDissolutionFactor[phaseIdx] = refResults[3][phaseIdx].data();
+        }
+
+        if (opm_material_ecl_model_phase_properties(model, &input, &output) != 0)
+            OPM_THROW(std::logic_error,
+                      "Could not compute the phase properties: " << opm_material_last_error());
+
+        {
+            FluidSystem::ScopedContext scopedContext(fluidSystemContext);
+            FluidSystem::exportPhaseProperties(refInput, refOutput);
+        }
+
+        for (unsigned quantityIdx = 0; quantityIdx < 4; ++quantityIdx)
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                if (results[quantityIdx][phaseIdx] != refResults[quantityIdx][phaseIdx])
+                    OPM_THROW(std::logic_error,
+                              "Quantity " << quantityIdx << " of phase " << phaseIdx
+                              << " computed by the C interface differs from the C++ result");
+
+        // the pressure of an active phase is mandatory
+        input.pressure[FluidSystem::oilPhaseIdx] = nullptr;
+        if (opm_material_ecl_model_phase_properties(model, &input, &output) == 0)
+            OPM_THROW(std::logic_error, "Omitting the pressure of an active phase must fail");
+    }
+
+    // the saturation functions
+    {
+        std::vector<double> kr[numPhases];
+        std::vector<double> pc[numPhases];
+        std::vector<double> refKr[numPhases];
+        std::vector<double> refPc[numPhases];
+        double* krPtrs[numPhases];
+        double* pcPtrs[numPhases];
+        double* refKrPtrs[numPhases];
+        double* refPcPtrs[numPhases];
+        const double* satPtrs[numPhases];
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            kr[phaseIdx].resize(n);
+            pc[phaseIdx].resize(n);
+            refKr[phaseIdx].resize(n);
+            refPc[phaseIdx].resize(n);
+            krPtrs[phaseIdx] = kr[phaseIdx].data();
+            pcPtrs[phaseIdx] = pc[phaseIdx].data();
+            refKrPtrs[phaseIdx] = refKr[phaseIdx].data();
+            refPcPtrs[phaseIdx] = refPc[phaseIdx].data();
+            satPtrs[phaseIdx] = saturation[phaseIdx].data();
+        }
+
+        if (opm_material_ecl_model_relative_permeabilities(model, krPtrs, satPtrs, 0, n) != 0
+            || opm_material_ecl_model_capillary_pressures(model, pcPtrs, satPtrs, 0, n) != 0)
+            OPM_THROW(std::logic_error,
+                      "Could not evaluate the saturation functions: " << opm_material_last_error());
+
+        materialLawManager.relativePermeabilities(refKrPtrs, satPtrs, 0, static_cast<unsigned>(n));
+        materialLawManager.capillaryPressures(refPcPtrs, satPtrs, 0, static_cast<unsigned>(n));
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (kr[phaseIdx] != refKr[phaseIdx] || pc[phaseIdx] != refPc[phaseIdx])
+                OPM_THROW(std::logic_error,
+                          "The saturation functions of phase " << phaseIdx
+                          << " evaluated by the C interface differ from the C++ result");
+
+        if (opm_material_ecl_model_relative_permeabilities(model, krPtrs, satPtrs, 1, n + 1) == 0)
+            OPM_THROW(std::logic_error, "Evaluating a range beyond the last cell must fail");
+    }
+
+    opm_material_ecl_model_destroy(model);
+
+    return 0;
+}
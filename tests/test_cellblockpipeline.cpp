@@ -0,0 +1,174 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the block-wise evaluation of the properties of
+ *        cells by Opm::CellBlockPipeline.
+ *
+ * The results of a pipeline which evaluates the PVT relations, the relative
+ * permeabilities and the phase mobilities of many cells are compared with the ones of
+ * separate passes over all cells.
+ */
+#include "config.h"
+
+#include <opm/material/common/CellBlockPipeline.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
+#include <opm/material/fluidmatrixinteractions/PiecewiseLinearTwoPhaseMaterial.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/ConstantCompressibilityOilPvt.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+template <class Evaluation>
+void testPipeline(std::size_t numCells, std::size_t blockSize)
+{
+    typedef typename Opm::MathToolbox<Evaluation>::Scalar Scalar;
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+
+    typename MaterialLaw::Params matParams;
+    const std::vector<Scalar> SwSamples = { 0.1, 0.2, 0.35, 0.5, 0.7, 0.9 };
+    const std::vector<Scalar> pcSamples = { 3e5, 1e5, 5e4, 2e4, 1e4, 0.0 };
+    const std::vector<Scalar> krwSamples = { 0.0, 0.05, 0.1, 0.3, 0.6, 1.0 };
+    const std::vector<Scalar> krnSamples = { 1.0, 0.7, 0.4, 0.2, 0.05, 0.0 };
+    matParams.setPcnwSamples(SwSamples, pcSamples);
+    matParams.setKrwSamples(SwSamples, krwSamples);
+    matParams.setKrnSamples(SwSamples, krnSamples);
+    matParams.finalize();
+
+    Opm::ConstantCompressibilityOilPvt<Scalar> oilPvt;
+    oilPvt.setNumRegions(2);
+    for (unsigned regionIdx = 0; regionIdx < 2; ++regionIdx) {
+        oilPvt.setReferenceDensities(regionIdx, 800.0, 1.0, 1000.0);
+        oilPvt.setReferencePressure(regionIdx, 1e5);
+        oilPvt.setReferenceFormationVolumeFactor(regionIdx, 1.1 + 0.05*regionIdx);
+        oilPvt.setCompressibility(regionIdx, 1e-9);
+        oilPvt.setViscosity(regionIdx, 1e-3*(1 + regionIdx));
+        oilPvt.setViscosibility(regionIdx, 2e-9);
+    }
+    oilPvt.initEnd();
+
+    // the primary variables of the cells
+    std::vector<unsigned> pvtRegionIdx(numCells);
+    std::vector<Evaluation> T(numCells), p(numCells), Sw(numCells);
+    for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        pvtRegionIdx[cellIdx] = static_cast<unsigned>(cellIdx % 2);
+        T[cellIdx] = 350.0;
+        p[cellIdx] = Opm::variable<Evaluation>(100e5 + 1e3*cellIdx, 0);
+        Sw[cellIdx] = Opm::variable<Evaluation>(0.1 + 0.8*Scalar(cellIdx)/numCells, 1);
+    }
+
+    // the results of separate passes over all cells
+    const Evaluation Rs = 0.0;
+    std::vector<Evaluation> invBoRef(numCells), muoRef(numCells), krnRef(numCells), mobRef(numCells);
+    for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        invBoRef[cellIdx] = oilPvt.inverseFormationVolumeFactor(pvtRegionIdx[cellIdx], T[cellIdx], p[cellIdx], Rs);
+        muoRef[cellIdx] = oilPvt.viscosity(pvtRegionIdx[cellIdx], T[cellIdx], p[cellIdx], Rs);
+    }
+    for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        krnRef[cellIdx] = MaterialLaw::twoPhaseSatKrn(matParams, Sw[cellIdx]);
+    for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        mobRef[cellIdx] = krnRef[cellIdx]*invBoRef[cellIdx]/muoRef[cellIdx];
+
+    // the same using a pipeline. the last stage depends on the results of the
+    // previous ones
+    std::vector<Evaluation> invBo(numCells), muo(numCells), krn(numCells), mob(numCells);
+    std::vector<int> numVisits(numCells, 0);
+    std::atomic<std::size_t> maxRangeSize(0);
+    auto pipeline =
+        Opm::makeCellBlockPipeline(blockSize,
+                                   [&](std::size_t begin, std::size_t end) {
+                                       std::size_t cur = maxRangeSize;
+                                       while (end - begin > cur && !maxRangeSize.compare_exchange_weak(cur, end - begin))
+                                       {}
+                                       for (std::size_t cellIdx = begin; cellIdx < end; ++cellIdx)
+                                           ++numVisits[cellIdx];
+                                   },
+                                   Opm::makeCellStage([&](std::size_t cellIdx) {
+                                           invBo[cellIdx] = oilPvt.inverseFormationVolumeFactor(pvtRegionIdx[cellIdx], T[cellIdx], p[cellIdx], Rs);
+                                           muo[cellIdx] = oilPvt.viscosity(pvtRegionIdx[cellIdx], T[cellIdx], p[cellIdx], Rs);
+                                       }),
+                                   Opm::makeCellStage([&](std::size_t cellIdx) {
+                                           krn[cellIdx] = MaterialLaw::twoPhaseSatKrn(matParams, Sw[cellIdx]);
+                                       }),
+                                   Opm::makeCellStage([&](std::size_t cellIdx) {
+                                           mob[cellIdx] = krn[cellIdx]*invBo[cellIdx]/muo[cellIdx];
+                                       }));
+
+    if (pipeline.numStages != 4 || pipeline.numBlocks(numCells) != (numCells + blockSize - 1)/blockSize)
+        throw std::logic_error("Unexpected number of stages or blocks of the pipeline");
+
+    for (int serial = 0; serial < 2; ++serial) {
+        std::fill(numVisits.begin(), numVisits.end(), 0);
+        std::fill(mob.begin(), mob.end(), Evaluation(-1.0));
+        if (serial)
+            pipeline.runSerial(numCells);
+        else
+            pipeline.run(numCells);
+
+        if (maxRangeSize > blockSize)
+            OPM_THROW(std::logic_error,
+                      "A stage was called for " << maxRangeSize << " cells at once, but the"
+                      " block size is " << blockSize);
+
+        for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            if (numVisits[cellIdx] != 1)
+                OPM_THROW(std::logic_error,
+                          "Cell " << cellIdx << " was processed " << numVisits[cellIdx] << " times");
+
+            // the stages evaluate the same expressions, so the results must be identical
+            if (invBo[cellIdx] != invBoRef[cellIdx]
+                || muo[cellIdx] != muoRef[cellIdx]
+                || krn[cellIdx] != krnRef[cellIdx]
+                || mob[cellIdx] != mobRef[cellIdx])
+                OPM_THROW(std::logic_error,
+                          "The results of the pipeline for cell " << cellIdx << " differ from"
+                          " the ones of separate passes");
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    typedef Opm::DenseAd::Evaluation<double, 2> Evaluation;
+
+    testPipeline<double>(/*numCells=*/1000, /*blockSize=*/64);
+    testPipeline<Evaluation>(/*numCells=*/1000, /*blockSize=*/64);
+    testPipeline<Evaluation>(/*numCells=*/1, /*blockSize=*/256);
+    testPipeline<Evaluation>(/*numCells=*/513, /*blockSize=*/256);
+    testPipeline<float>(/*numCells=*/0, /*blockSize=*/16);
+
+    return 0;
+}
@@ -0,0 +1,232 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the detection of the cells whose inputs did not
+ *        change between two evaluations.
+ *
+ * It checks that the detector finds exactly the modified cells, both for identical and
+ * for nearly identical inputs, and that evaluating only the changed cells of a PVT
+ * region batch yields the same results as evaluating all of them.
+ */
+#include "config.h"
+
+#include <opm/material/common/CellChangeDetector.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/ConstantCompressibilityWaterPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/PvtRegionBatch.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+template <class Detector>
+void checkStatistics(const Detector& detector,
+                     size_t numEvaluated,
+                     size_t numSkipped,
+                     const char* when)
+{
+    const auto& stats = detector.statistics();
+    if (stats.numEvaluated != numEvaluated || stats.numSkipped != numSkipped)
+        OPM_THROW(std::logic_error,
+                  "Wrong number of evaluated/skipped cells " << when << ": "
+                  << stats.numEvaluated << "/" << stats.numSkipped << " instead of "
+                  << numEvaluated << "/" << numSkipped);
+
+    if (detector.changedCells().size() != numEvaluated)
+        OPM_THROW(std::logic_error,
+                  "The list of changed cells is inconsistent with the statistics " << when);
+    for (unsigned cellIdx : detector.changedCells())
+        if (!detector.changed(cellIdx))
+            OPM_THROW(std::logic_error,
+                      "The mask of changed cells is inconsistent with the list " << when);
+}
+
+template <class Evaluation>
+void testDetector()
+{
+    const size_t numCells = 100;
+    std::vector<Evaluation> p(numCells), T(numCells);
+    for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        p[cellIdx] = Opm::variable<Evaluation>(1e5 + 1e3*cellIdx, 0);
+        T[cellIdx] = Opm::constant<Evaluation>(300.0 + 0.1*cellIdx);
+    }
+
+    Opm::CellChangeDetector<Evaluation> detector;
+
+    // without a previous evaluation, all cells need to be evaluated
+    detector.update(numCells, {T.data(), p.data()});
+    checkStatistics(detector, numCells, 0, "in the first evaluation");
+
+    detector.update(numCells, {T.data(), p.data()});
+    checkStatistics(detector, 0, numCells, "for unchanged inputs");
+
+    // modify a few cells, each in a different input array
+    p[3] += 1.0;
+    T[42] += 1e-12;
+    p[99] *= (1.0 + 1e-14);
+    detector.update(numCells, {T.data(), p.data()});
+    checkStatistics(detector, 3, numCells - 3, "after modifying three cells");
+    if (!detector.changed(3) || !detector.changed(42) || !detector.changed(99))
+        OPM_THROW(std::logic_error, "Modified cells were not detected");
+
+    // with a tolerance, tiny changes are ignored
+    detector.setTolerance(1e-10);
+    p[3] += 1.0;
+    T[42] += 1e-12;
+    p[99] *= (1.0 + 1e-14);
+    detector.update(numCells, {T.data(), p.data()});
+    checkStatistics(detector, 1, numCells - 1, "for changes within the tolerance");
+    if (!detector.changed(3))
+        OPM_THROW(std::logic_error, "Modified cell was not detected");
+    detector.setTolerance(0.0);
+
+    // a different number of cells or inputs invalidates the previous evaluation
+    detector.update(numCells/2, {T.data(), p.data()});
+    checkStatistics(detector, numCells/2, 0, "for a different number of cells");
+    detector.update(numCells/2, {T.data()});
+    checkStatistics(detector, numCells/2, 0, "for a different number of inputs");
+
+    detector.reset();
+    detector.update(numCells/2, {T.data()});
+    checkStatistics(detector, numCells/2, 0, "after a reset");
+}
+
+void testDerivatives()
+{
+    typedef Opm::DenseAd::Evaluation<double, 2> Evaluation;
+
+    const size_t numCells = 10;
+    std::vector<Evaluation> p(numCells);
+    for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        p[cellIdx] = Evaluation::createVariable(1e5 + cellIdx, 0);
+
+    Opm::CellChangeDetector<Evaluation> detector;
+    detector.update(numCells, {p.data()});
+
+    // a cell whose value stays the same but whose derivatives change must be evaluated
+    p[5] = Evaluation::createVariable(p[5].value(), 1);
+    detector.update(numCells, {p.data()});
+    checkStatistics(detector, 1, numCells - 1, "after modifying a derivative");
+    if (!detector.changed(5))
+        OPM_THROW(std::logic_error, "Modified derivative was not detected");
+}
+
+template <class Evaluation>
+void testPvtRegionBatch()
+{
+    typedef Opm::ConstantCompressibilityWaterPvt<double> WaterPvt;
+
+    WaterPvt waterPvt;
+    waterPvt.setNumRegions(2);
+    for (unsigned regionIdx = 0; regionIdx < 2; ++regionIdx) {
+        waterPvt.setReferenceDensities(regionIdx, 800.0, 1000.0, 1.0);
+        waterPvt.setReferencePressure(regionIdx, 1e5);
+        waterPvt.setReferenceFormationVolumeFactor(regionIdx, 1.0 + 0.01*regionIdx);
+        waterPvt.setCompressibility(regionIdx, 4.5e-10);
+        waterPvt.setViscosity(regionIdx, 5e-4 + 1e-4*regionIdx, 1e-10);
+    }
+    waterPvt.initEnd();
+
+    const size_t numCells = 64;
+    std::vector<unsigned> regionIdx(numCells);
+    std::vector<Evaluation> T(numCells), p(numCells);
+    for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        regionIdx[cellIdx] = (cellIdx < numCells/3)?0:1;
+        T[cellIdx] = Opm::constant<Evaluation>(300.0);
+        p[cellIdx] = Opm::variable<Evaluation>(1e5 + 1e4*cellIdx, 0);
+    }
+
+    Opm::PvtRegionBatch batch;
+    batch.setRegionIndices(regionIdx);
+
+    Opm::CellChangeDetector<Evaluation> detector;
+    std::vector<Evaluation> invB(numCells), mu(numCells);
+    for (int iterIdx = 0; iterIdx < 4; ++iterIdx) {
+        // only change a few cells per iteration
+        for (size_t cellIdx = iterIdx; cellIdx < numCells; cellIdx += 7*(iterIdx + 1))
+            p[cellIdx] += 1e3;
+
+        detector.update(numCells, {T.data(), p.data()});
+        batch.setCellMask(detector.changedMask());
+        batch.inverseFormationVolumeFactorAndViscosity(waterPvt, T.data(), p.data(),
+                                                       invB.data(), mu.data());
+
+        if (iterIdx > 0 && detector.statistics().numSkipped == 0)
+            OPM_THROW(std::logic_error, "No cells skipped in iteration " << iterIdx);
+
+        // the results must be the ones of a full evaluation
+        std::vector<Evaluation> refInvB(numCells), refMu(numCells);
+        batch.resetCellMask();
+        batch.inverseFormationVolumeFactorAndViscosity(waterPvt, T.data(), p.data(),
+                                                       refInvB.data(), refMu.data());
+        for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            if (invB[cellIdx] != refInvB[cellIdx] || mu[cellIdx] != refMu[cellIdx])
+                OPM_THROW(std::logic_error,
+                          "Result of cell " << cellIdx << " in iteration " << iterIdx
+                          << " differs from the one of the full evaluation");
+    }
+
+    // the value-only evaluation yields the values of the full one
+    std::vector<double> invBValue(numCells), muValue(numCells);
+    batch.inverseFormationVolumeFactorAndViscosity(waterPvt, T.data(), p.data(),
+                                                   invBValue.data(), muValue.data());
+    for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        if (invBValue[cellIdx] != Opm::scalarValue(invB[cellIdx])
+            || muValue[cellIdx] != Opm::scalarValue(mu[cellIdx]))
+            OPM_THROW(std::logic_error,
+                      "Value-only result of cell " << cellIdx
+                      << " differs from the one of the full evaluation");
+
+    // a mask of the wrong size must be rejected
+    bool caught = false;
+    try {
+        batch.setCellMask(std::vector<unsigned char>(numCells + 1, 1));
+    }
+    catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    if (!caught)
+        OPM_THROW(std::logic_error, "Cell mask of the wrong size was not rejected");
+}
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    testDetector<double>();
+    testDetector<Opm::DenseAd::Evaluation<double, 3> >();
+    testDerivatives();
+    testPvtRegionBatch<double>();
+    testPvtRegionBatch<Opm::DenseAd::Evaluation<double, 2> >();
+
+    return 0;
+}
@@ -45,16 +45,32 @@
 #include <opm/material/components/iapws/Region4.hpp>
 #include <opm/material/components/H2O.hpp>
 #include <opm/material/components/CO2.hpp>
+#include <opm/material/components/BinaryCO2Tables.hpp>
 #include <opm/material/components/Mesitylene.hpp>
 #include <opm/material/components/TabulatedComponent.hpp>
 #include <opm/material/components/Brine.hpp>
+#include <opm/material/components/TabulatedBrine.hpp>
 #include <opm/material/components/N2.hpp>
 #include <opm/material/components/Xylene.hpp>
 #include <opm/material/components/Air.hpp>
 #include <opm/material/components/SimpleCO2.hpp>
 
+#include <opm/material/binarycoefficients/Brine_CO2.hpp>
+#include <opm/material/binarycoefficients/H2O_N2.hpp>
+
+#include <opm/material/common/TemperatureMemoizer.hpp>
+
 #include <opm/material/common/UniformTabulated2DFunction.hpp>
 
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 namespace Opm {
 namespace ComponentsTest {
 #include <opm/material/components/co2tables.inc>
@@ -72,6 +88,7 @@ void testAllComponents()
     checkComponent<Opm::Air<Scalar>, Evaluation>();
     checkComponent<Opm::Brine<Scalar, H2O>, Evaluation>();
     checkComponent<Opm::CO2<Scalar, Opm::ComponentsTest::CO2Tables>, Evaluation>();
+    checkComponent<Opm::CO2<Scalar, Opm::BinaryCO2Tables<> >, Evaluation>();
     checkComponent<Opm::DNAPL<Scalar>, Evaluation>();
     checkComponent<Opm::H2O<Scalar>, Evaluation>();
     checkComponent<Opm::LNAPL<Scalar>, Evaluation>();
@@ -81,13 +98,430 @@ void testAllComponents()
     checkComponent<Opm::SimpleCO2<Scalar>, Evaluation>();
     checkComponent<Opm::SimpleH2O<Scalar>, Evaluation>();
     checkComponent<Opm::TabulatedComponent<Scalar, H2O>, Evaluation>();
+    checkComponent<Opm::TabulatedBrine<Scalar, H2O>, Evaluation>();
     checkComponent<Opm::Unit<Scalar>, Evaluation>();
     checkComponent<Opm::Xylene<Scalar>, Evaluation>();
 }
 
+// make sure that the single pass evaluation of the Gibbs free energy of an IAPWS
+// region yields the same results as the individual methods
+template <class Region, class Scalar>
+void checkIapwsGammaDerivatives(Scalar temperature, Scalar pressure)
+{
+    Scalar g[6];
+    Region::gammaAndDerivatives(g[0], g[1], g[2], g[3], g[4], g[5], temperature, pressure);
+
+    const Scalar gRef[6] = {
+        Region::gamma(temperature, pressure),
+        Region::dgamma_dtau(temperature, pressure),
+        Region::dgamma_dpi(temperature, pressure),
+        Region::ddgamma_dtaudpi(temperature, pressure),
+        Region::ddgamma_ddpi(temperature, pressure),
+        Region::ddgamma_ddtau(temperature, pressure)
+    };
+
+    const Scalar tol = std::sqrt(std::numeric_limits<Scalar>::epsilon());
+    for (unsigned i = 0; i < 6; ++i) {
+        if (!(std::abs(g[i] - gRef[i]) <= tol*std::abs(gRef[i])))
+            OPM_THROW(std::logic_error,
+                      "Single pass IAPWS gamma evaluation deviates from reference for quantity " << i
+                      << " at T=" << temperature << ", p=" << pressure
+                      << ": " << g[i] << " vs " << gRef[i]);
+    }
+}
+
+template <class Scalar>
+void checkPropertyValue(const char* name, Scalar value, Scalar reference, Scalar temperature, Scalar pressure)
+{
+    const Scalar tol = std::sqrt(std::numeric_limits<Scalar>::epsilon());
+    if (!(std::abs(value - reference) <= tol*std::abs(reference)))
+        OPM_THROW(std::logic_error,
+                  "Combined evaluation of the " << name << " of water deviates from reference"
+                  << " at T=" << temperature << ", p=" << pressure
+                  << ": " << value << " vs " << reference);
+}
+
+// make sure that the combined evaluation of the properties of water yields the same
+// results as the individual methods
+template <class Scalar>
+void checkH2OAllProperties(Scalar temperature, Scalar pressure)
+{
+    typedef Opm::H2O<Scalar> H2O;
+
+    if (pressure >= H2O::vaporPressure(temperature) - 1e3) {
+        const auto& props = H2O::computeAllLiquidProperties(temperature, pressure);
+        checkPropertyValue("liquid density", props.density,
+                           H2O::liquidDensity(temperature, pressure), temperature, pressure);
+        checkPropertyValue("liquid enthalpy", props.enthalpy,
+                           H2O::liquidEnthalpy(temperature, pressure), temperature, pressure);
+        checkPropertyValue("liquid internal energy", props.internalEnergy,
+                           H2O::liquidInternalEnergy(temperature, pressure), temperature, pressure);
+        checkPropertyValue("liquid heat capacity", props.heatCapacity,
+                           H2O::liquidHeatCapacity(temperature, pressure), temperature, pressure);
+        checkPropertyValue("liquid viscosity", props.viscosity,
+                           H2O::liquidViscosity(temperature, pressure), temperature, pressure);
+        checkPropertyValue("liquid thermal conductivity", props.thermalConductivity,
+                           H2O::liquidThermalConductivity(temperature, pressure), temperature, pressure);
+    }
+
+    if (pressure <= H2O::vaporPressure(temperature) + 1e3) {
+        const auto& props = H2O::computeAllGasProperties(temperature, pressure);
+        checkPropertyValue("gas density", props.density,
+                           H2O::gasDensity(temperature, pressure), temperature, pressure);
+        checkPropertyValue("gas enthalpy", props.enthalpy,
+                           H2O::gasEnthalpy(temperature, pressure), temperature, pressure);
+        checkPropertyValue("gas internal energy", props.internalEnergy,
+                           H2O::gasInternalEnergy(temperature, pressure), temperature, pressure);
+        checkPropertyValue("gas heat capacity", props.heatCapacity,
+                           H2O::gasHeatCapacity(temperature, pressure), temperature, pressure);
+        checkPropertyValue("gas viscosity", props.viscosity,
+                           H2O::gasViscosity(temperature, pressure), temperature, pressure);
+        checkPropertyValue("gas thermal conductivity", props.thermalConductivity,
+                           H2O::gasThermalConductivity(temperature, pressure), temperature, pressure);
+    }
+}
+
+// convert the compiled-in CO2 tables to the binary format and make sure that
+// reading them back yields the same tables
+void checkBinaryCO2Tables()
+{
+    typedef Opm::ComponentsTest::CO2Tables CompiledTables;
+    typedef Opm::BinaryCO2Tables<> BinaryTables;
+
+    const std::string fileName = "test_components_co2tables.bin";
+    BinaryTables::write(fileName,
+                        CompiledTables::tabulatedEnthalpy,
+                        CompiledTables::tabulatedDensity,
+                        CompiledTables::brineSalinity);
+    BinaryTables::load(fileName);
+    std::remove(fileName.c_str());
+
+    const BinaryTables::TabulatedFunction* tables[2] =
+        { &BinaryTables::tabulatedEnthalpy, &BinaryTables::tabulatedDensity };
+    const BinaryTables::TabulatedFunction* refTables[2] =
+        { &CompiledTables::tabulatedEnthalpy, &CompiledTables::tabulatedDensity };
+    for (unsigned tableIdx = 0; tableIdx < 2; ++tableIdx) {
+        const auto& table = *tables[tableIdx];
+        const auto& refTable = *refTables[tableIdx];
+        if (table.numX() != refTable.numX() || table.numY() != refTable.numY()
+            || table.xMin() != refTable.xMin() || table.xMax() != refTable.xMax()
+            || table.yMin() != refTable.yMin() || table.yMax() != refTable.yMax())
+            OPM_THROW(std::logic_error, "The extent of the binary CO2 table " << tableIdx << " is wrong");
+
+        for (unsigned i = 0; i < table.numX(); ++i)
+            for (unsigned j = 0; j < table.numY(); ++j)
+                if (table.getSamplePoint(i, j) != refTable.getSamplePoint(i, j))
+                    OPM_THROW(std::logic_error,
+                              "The sample point (" << i << ", " << j << ") of the binary CO2 table "
+                              << tableIdx << " is wrong");
+    }
+
+    if (BinaryTables::brineSalinity != CompiledTables::brineSalinity)
+        OPM_THROW(std::logic_error, "The brine salinity of the binary CO2 tables is wrong");
+}
+
+// make sure that the batched computation of the brine-CO2 mutual solubilities yields
+// the same results as the one for individual cells
+template <class Scalar>
+void checkBrineCO2MoleFractions()
+{
+    typedef Opm::BinaryCoeff::Brine_CO2<Scalar, Opm::ComponentsTest::CO2Tables> BinaryCoeff;
+
+    std::vector<Scalar> temperature, pressure, salinity;
+    std::vector<int> knownPhaseIdx;
+    for (Scalar T = 290.0; T < 370.0; T += 20.0) {
+        for (Scalar p = 2e6; p < 4e7; p *= 2) {
+            for (int phaseIdx = -1; phaseIdx <= 1; ++phaseIdx) {
+                temperature.push_back(T);
+                pressure.push_back(p);
+                salinity.push_back((temperature.size() % 4 == 0) ? 0.0 : 0.1);
+                knownPhaseIdx.push_back(phaseIdx);
+            }
+        }
+    }
+
+    std::size_t n = temperature.size();
+    std::vector<Scalar> xlCO2(n, 0.01), ygH2O(n, 0.005);
+    BinaryCoeff::calculateMoleFractions(temperature.data(), pressure.data(), salinity.data(),
+                                        knownPhaseIdx.data(), xlCO2.data(), ygH2O.data(), n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        Scalar xlCO2Ref = 0.01, ygH2ORef = 0.005;
+        BinaryCoeff::calculateMoleFractions(temperature[i], pressure[i], salinity[i],
+                                            knownPhaseIdx[i], xlCO2Ref, ygH2ORef);
+        if (xlCO2[i] != xlCO2Ref || ygH2O[i] != ygH2ORef)
+            OPM_THROW(std::logic_error,
+                      "The batched brine-CO2 mole fractions at T=" << temperature[i]
+                      << ", p=" << pressure[i] << " are wrong");
+
+        // if the composition of the liquid phase was computed by the mutual solubility
+        // function, prescribing it must yield the same composition of the gas phase
+        if (knownPhaseIdx[i] < 0) {
+            Scalar ygH2OLiquidKnown = 0.0;
+            BinaryCoeff::calculateMoleFractions(temperature[i], pressure[i], salinity[i],
+                                                /*knownPhaseIdx=*/0, xlCO2Ref, ygH2OLiquidKnown);
+            if (std::abs(ygH2OLiquidKnown - ygH2ORef) > 1e-5*std::abs(ygH2ORef))
+                OPM_THROW(std::logic_error,
+                          "The brine-CO2 mutual solubilities at T=" << temperature[i]
+                          << ", p=" << pressure[i] << " are inconsistent");
+        }
+    }
+}
+
+// evaluates the vapor pressure of water and counts the number of calls
+template <class Scalar>
+struct CountingVaporPressure
+{
+    template <class Evaluation>
+    Evaluation operator()(const Evaluation& temperature) const
+    {
+        ++numCalls;
+        return Opm::H2O<Scalar>::vaporPressure(temperature);
+    }
+
+    mutable int numCalls = 0;
+};
+
+template <class Memoizer, class Function, class Evaluation>
+void checkMemoizedValue(const char* name, Memoizer& memoizer, const Function& fn,
+                        const Evaluation& temperature, const Evaluation& reference)
+{
+    typedef typename Memoizer::DerivativeEvaluation DerivativeEvaluation;
+    typedef decltype(Opm::scalarValue(reference)) Scalar;
+    Scalar tolerance = 100*std::numeric_limits<Scalar>::epsilon();
+
+    const Evaluation& value = memoizer.eval(temperature, fn);
+    const DerivativeEvaluation& valueEval = DerivativeEvaluation(value);
+    const DerivativeEvaluation& refEval = DerivativeEvaluation(reference);
+    if (valueEval.value() != refEval.value()
+        || std::abs(valueEval.derivative(0) - refEval.derivative(0))
+           > tolerance*std::abs(refEval.derivative(0)))
+        OPM_THROW(std::logic_error,
+                  "The memoized " << name << " at T=" << Opm::scalarValue(temperature) << " is wrong");
+}
+
+// the tabulated brine must approximate the analytic relations for all salinities
+template <class Scalar>
+void checkTabulatedBrine()
+{
+    typedef Opm::H2O<Scalar> H2O;
+    typedef Opm::Brine<Scalar, H2O> Brine;
+    typedef Opm::TabulatedBrine<Scalar, H2O> TabulatedBrine;
+
+    TabulatedBrine::init(/*tempMin=*/280.0, /*tempMax=*/400.0, /*nTemp=*/121,
+                         /*pressMin=*/1e6, /*pressMax=*/5e7, /*nPress=*/50,
+                         /*salinityMin=*/0.0, /*salinityMax=*/0.25, /*nSalinity=*/26);
+
+    for (Scalar T = 283.0; T < 400.0; T += 13.7) {
+        for (Scalar p = 2e6; p < 5e7; p += 4.3e6) {
+            for (Scalar S = 0.003; S < 0.25; S += 0.031) {
+                const Scalar rho = TabulatedBrine::liquidDensity(T, p, S);
+                const Scalar rhoRef = Brine::liquidDensity(T, p, S);
+                const Scalar h = TabulatedBrine::liquidEnthalpy(T, p, S);
+                const Scalar hRef = Brine::liquidEnthalpy(T, p, S);
+                const Scalar mu = TabulatedBrine::liquidViscosity(T, p, S);
+                const Scalar muRef = Brine::liquidViscosity(T, p, S);
+
+                if (!(std::abs(rho - rhoRef) <= 1e-4*rhoRef)
+                    || !(std::abs(h - hRef) <= 1e-3*std::abs(hRef) + 100.0)
+                    || !(std::abs(mu - muRef) <= 1e-2*muRef))
+                    OPM_THROW(std::logic_error,
+                              "Tabulated brine deviates from the analytic relations at T=" << T
+                              << ", p=" << p << ", S=" << S << ": "
+                              << rho << " vs " << rhoRef << ", "
+                              << h << " vs " << hRef << ", "
+                              << mu << " vs " << muRef);
+            }
+        }
+    }
+
+    // without an explicit salinity, the one of the base class is used and outside of
+    // the tabulated range the analytic relations are evaluated
+    const Scalar T = 350.0, p = 1e7;
+    if (TabulatedBrine::liquidDensity(T, p)
+        != TabulatedBrine::liquidDensity(T, p, Brine::salinity))
+        OPM_THROW(std::logic_error, "Tabulated brine does not use the default salinity");
+    if (TabulatedBrine::liquidDensity(T, Scalar(1e5), Scalar(0.1))
+        != Brine::liquidDensity(T, Scalar(1e5), Scalar(0.1)))
+        OPM_THROW(std::logic_error, "Tabulated brine does not fall back to the analytic relations");
+}
+
+// a tabulated component whose tables were never initialized must evaluate the raw
+// component instead of looking up the empty tables
+template <class Scalar>
+void checkUninitializedTabulatedComponent()
+{
+    typedef Opm::SimpleH2O<Scalar> RawComponent;
+    typedef Opm::TabulatedComponent<Scalar, RawComponent> TabulatedComponent;
+
+    const Scalar T = 350.0, p = 1e6;
+    bool ok =
+        TabulatedComponent::vaporPressure(T) == RawComponent::vaporPressure(T)
+        && TabulatedComponent::liquidDensity(T, p) == RawComponent::liquidDensity(T, p)
+        && TabulatedComponent::gasDensity(T, p) == RawComponent::gasDensity(T, p)
+        && TabulatedComponent::liquidEnthalpy(T, p) == RawComponent::liquidEnthalpy(T, p)
+        && TabulatedComponent::gasViscosity(T, p) == RawComponent::gasViscosity(T, p)
+        && TabulatedComponent::gasPressure(T, Scalar(1.0)) == RawComponent::gasPressure(T, Scalar(1.0));
+    if (!ok)
+        OPM_THROW(std::logic_error,
+                  "An uninitialized tabulated component does not fall back to the raw component");
+}
+
+template <class Scalar>
+void checkTemperatureMemoizer()
+{
+    typedef Opm::TemperatureMemoizer<Scalar> Memoizer;
+    typedef typename Memoizer::DerivativeEvaluation DerivativeEvaluation;
+    typedef Opm::H2O<Scalar> H2O;
+    typedef Opm::BinaryCoeff::H2O_N2 H2O_N2;
+    typedef Opm::BinaryCoeff::Brine_CO2<Scalar, Opm::ComponentsTest::CO2Tables> Brine_CO2;
+
+    Memoizer pvMemoizer, henryN2Memoizer, henryCO2Memoizer;
+    for (unsigned i = 0; i < 3; ++i) {
+        for (Scalar T = 280.0; T < 380.0; T += 25.0) {
+            DerivativeEvaluation TEval = DerivativeEvaluation::createVariable(T, 0);
+
+            checkMemoizedValue("vapor pressure", pvMemoizer,
+                               &H2O::template vaporPressure<DerivativeEvaluation>,
+                               TEval, H2O::vaporPressure(TEval));
+            checkMemoizedValue("vapor pressure", pvMemoizer,
+                               &H2O::template vaporPressure<DerivativeEvaluation>,
+                               T, H2O::vaporPressure(T));
+            checkMemoizedValue("N2 Henry coefficient", henryN2Memoizer,
+                               &H2O_N2::template henry<DerivativeEvaluation>,
+                               TEval, H2O_N2::henry(TEval));
+            checkMemoizedValue("CO2 Henry coefficient", henryCO2Memoizer,
+                               &Brine_CO2::template henry<DerivativeEvaluation>,
+                               TEval, Brine_CO2::henry(TEval));
+        }
+    }
+
+    // the memoized function must only be called if the temperature is not cached
+    Memoizer& memoizer = Memoizer::template perThread<CountingVaporPressure<Scalar> >();
+    CountingVaporPressure<Scalar> countingFn;
+    for (unsigned i = 0; i < 10; ++i) {
+        memoizer.eval(Scalar(300.0), countingFn);
+        memoizer.eval(Scalar(310.0), countingFn);
+    }
+    if (countingFn.numCalls != 2 || memoizer.size() != 2)
+        OPM_THROW(std::logic_error, "The temperature memoizer does not cache values");
+
+    for (unsigned i = 0; i < 2*Memoizer::numEntries; ++i)
+        memoizer.eval(Scalar(320.0 + i), countingFn);
+    if (memoizer.size() != Memoizer::numEntries)
+        OPM_THROW(std::logic_error, "The temperature memoizer caches too many values");
+
+    memoizer.clear();
+    if (memoizer.size() != 0)
+        OPM_THROW(std::logic_error, "The temperature memoizer cannot be cleared");
+}
+
+// make sure that the array-valued methods of the components yield the same results as
+// the methods for single values
+template <class Scalar>
+void checkComponentBatch(const char* name,
+                         void (*batchFn)(size_t, const Scalar*, const Scalar*, Scalar*),
+                         Scalar (*fn)(const Scalar&, const Scalar&),
+                         const std::vector<Scalar>& temperature,
+                         const std::vector<Scalar>& pressure)
+{
+    std::vector<Scalar> values(temperature.size());
+    batchFn(temperature.size(), temperature.data(), pressure.data(), values.data());
+    for (size_t i = 0; i < temperature.size(); ++i)
+        if (values[i] != fn(temperature[i], pressure[i]))
+            OPM_THROW(std::logic_error,
+                      "The array-valued " << name << " at T=" << temperature[i]
+                      << ", p=" << pressure[i] << " is wrong");
+}
+
+template <class Scalar>
+void checkComponentBatches()
+{
+    typedef Opm::H2O<Scalar> H2O;
+    typedef Opm::SimpleH2O<Scalar> SimpleH2O;
+    typedef Opm::Brine<Scalar, H2O> Brine;
+    typedef Opm::Brine<Scalar, SimpleH2O> SimpleBrine;
+    typedef Opm::TabulatedBrine<Scalar, H2O> TabulatedBrine;
+    typedef Opm::CO2<Scalar, Opm::ComponentsTest::CO2Tables> CO2;
+
+    // this includes pressures below the vapor pressure of water and points outside of
+    // the range of the tabulated brine
+    std::vector<Scalar> temperature, pressure;
+    for (Scalar T = 290.0; T < 400.0; T += 15.0) {
+        for (Scalar p = 1e5; p < 5e7; p *= 3.1) {
+            temperature.push_back(T);
+            pressure.push_back(p);
+        }
+    }
+
+    checkComponentBatch<Scalar>("density of water",
+                                &H2O::template liquidDensityBatch<Scalar>,
+                                &H2O::template liquidDensity<Scalar>,
+                                temperature, pressure);
+    checkComponentBatch<Scalar>("viscosity of water",
+                                &H2O::template liquidViscosityBatch<Scalar>,
+                                &H2O::template liquidViscosity<Scalar>,
+                                temperature, pressure);
+    checkComponentBatch<Scalar>("density of brine",
+                                &Brine::template liquidDensityBatch<Scalar>,
+                                &Brine::template liquidDensity<Scalar>,
+                                temperature, pressure);
+    checkComponentBatch<Scalar>("density of simple brine",
+                                &SimpleBrine::template liquidDensityBatch<Scalar>,
+                                &SimpleBrine::template liquidDensity<Scalar>,
+                                temperature, pressure);
+    checkComponentBatch<Scalar>("density of tabulated brine",
+                                &TabulatedBrine::template liquidDensityBatch<Scalar>,
+                                &TabulatedBrine::template liquidDensity<Scalar>,
+                                temperature, pressure);
+    checkComponentBatch<Scalar>("enthalpy of tabulated brine",
+                                &TabulatedBrine::template liquidEnthalpyBatch<Scalar>,
+                                &TabulatedBrine::template liquidEnthalpy<Scalar>,
+                                temperature, pressure);
+    checkComponentBatch<Scalar>("density of CO2",
+                                &CO2::template gasDensityBatch<Scalar>,
+                                &CO2::template gasDensity<Scalar>,
+                                temperature, pressure);
+
+    // the range of all values is checked before any density is computed
+    std::vector<Scalar> values(temperature.size(), -1.0);
+    temperature.back() = 700.0;
+    try {
+        H2O::liquidDensityBatch(temperature.size(), temperature.data(), pressure.data(),
+                                values.data());
+        OPM_THROW(std::logic_error, "The array-valued density of water does not check its range");
+    }
+    catch (const Opm::NumericalProblem&) {
+    }
+    if (values.front() != -1.0)
+        OPM_THROW(std::logic_error, "The array-valued density of water was computed out of range");
+}
+
 template <class Scalar>
 inline void testAll()
 {
+    checkIapwsGammaDerivatives<Opm::IAPWS::Region1<Scalar> >(Scalar(300.0), Scalar(1e5));
+    checkIapwsGammaDerivatives<Opm::IAPWS::Region1<Scalar> >(Scalar(550.0), Scalar(5e7));
+    checkIapwsGammaDerivatives<Opm::IAPWS::Region2<Scalar> >(Scalar(400.0), Scalar(1e5));
+    checkIapwsGammaDerivatives<Opm::IAPWS::Region2<Scalar> >(Scalar(600.0), Scalar(5e6));
+
+    // liquid, at and slightly around the vapor pressure, gas and the low-pressure
+    // regularization of gas
+    checkH2OAllProperties(Scalar(300.0), Scalar(1e7));
+    checkH2OAllProperties(Scalar(450.0), Scalar(5e7));
+    checkH2OAllProperties(Scalar(400.0), Opm::H2O<Scalar>::vaporPressure(Scalar(400.0)));
+    checkH2OAllProperties(Scalar(400.0), Opm::H2O<Scalar>::vaporPressure(Scalar(400.0)) - 500);
+    checkH2OAllProperties(Scalar(400.0), Opm::H2O<Scalar>::vaporPressure(Scalar(400.0)) + 500);
+    checkH2OAllProperties(Scalar(400.0), Scalar(1e5));
+    checkH2OAllProperties(Scalar(500.0), Scalar(3e6));
+    checkH2OAllProperties(Scalar(350.0), Scalar(100.0));
+
+    checkBrineCO2MoleFractions<Scalar>();
+    checkTemperatureMemoizer<Scalar>();
+    checkTabulatedBrine<Scalar>();
+    checkUninitializedTabulatedComponent<Scalar>();
+    checkComponentBatches<Scalar>();
+
     typedef Opm::DenseAd::Evaluation<Scalar, 3> Evaluation;
 
     // ensure that all components are API-compliant
@@ -100,6 +534,8 @@ int main(int argc, char **argv)
 {
     Dune::MPIHelper::instance(argc, argv);
 
+    checkBinaryCO2Tables();
+
     testAll<double>();
     testAll<float>();
 
@@ -36,6 +36,13 @@
 
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/material/densead/Math.hpp>
+#include <opm/material/densead/HybridEvaluation.hpp>
+#include <opm/material/densead/ExpressionTemplates.hpp>
+#include <opm/material/densead/SimdEvaluation.hpp>
+#include <opm/material/densead/FastMath.hpp>
+#include <opm/material/densead/JacobianScatter.hpp>
+#include <opm/material/densead/SecondOrderEvaluation.hpp>
+#include <opm/material/common/PolynomialUtils.hpp>
 
 #include <opm/common/Unused.hpp>
 
@@ -48,7 +55,11 @@
 #include <cmath>
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 //static const int numVars = 3;
 
@@ -446,6 +457,44 @@ void testPowExp(Scalar expMin = -100, Scalar expMax = 100)
     }
 }
 
+void testPowInt(Scalar baseMin = -10, Scalar baseMax = 10)
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, numVars> Eval;
+
+    int n = 10*1000;
+    for (int i = 0; i < n; ++ i) {
+        Scalar base = Scalar(i)/(n - 1)*(baseMax - baseMin) + baseMin;
+        const auto& baseEval = Eval::createVariable(base, 0);
+
+        for (int exp = -7; exp <= 7; ++exp) {
+            if (exp < 0 && base == 0.0)
+                continue;
+
+            // pow(Eval, int) must be consistent with pow(Eval, Scalar) for positive
+            // bases and with std::pow() for arbitrary ones
+            const Eval& zEval = pow(baseEval, exp);
+            Scalar z = std::pow(base, Scalar(exp));
+            Scalar zPrime = exp*std::pow(base, Scalar(exp - 1));
+            Scalar tol = std::numeric_limits<Scalar>::epsilon()*1e2;
+
+            if (std::abs(z - zEval.value()) > tol*std::abs(z))
+                throw std::logic_error("oops: pow(Eval, int): value @"+std::to_string((long double) base)
+                                       +"^"+std::to_string(exp));
+            if (std::abs(zPrime - zEval.derivative(0)) > tol*std::abs(zPrime))
+                throw std::logic_error("oops: pow(Eval, int): derivative @"+std::to_string((long double) base)
+                                       +"^"+std::to_string(exp));
+            for (int varIdx = 1; varIdx < numVars; ++varIdx)
+                if (zEval.derivative(varIdx) != 0.0)
+                    throw std::logic_error("oops: pow(Eval, int): derivative");
+        }
+    }
+
+    // the derivative of x^1 is one for x = 0
+    const Eval& zero = Eval::createVariable(0.0, 0);
+    if (pow(zero, 1).derivative(0) != 1.0 || pow(zero, 0).value() != 1.0)
+        throw std::logic_error("oops: pow(Eval, int) at 0");
+}
+
 void testAtan2()
 {
     typedef Opm::DenseAd::Evaluation<Scalar, numVars> Eval;
@@ -537,6 +586,7 @@ inline void testAll()
     std::cout << "testing pow()\n";
     testPowBase();
     testPowExp();
+    testPowInt();
 
     std::cout << "testing abs()\n";
     test1DFunction(Opm::DenseAd::abs<Scalar, numVars>,
@@ -647,6 +697,363 @@ inline void testAll()
 
 };//TestEnv
 
+// make sure that the hybrid evaluations produce the same results as the dense ones
+template <class Scalar, int numVars>
+void testHybridEvaluation(const Scalar tolerance)
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, numVars> Eval;
+    typedef Opm::DenseAd::HybridEvaluation<Scalar, numVars> HybridEval;
+    typedef Opm::MathToolbox<Eval> EvalToolbox;
+
+    const Scalar x = 1.234;
+    const Scalar y = 0.567;
+    const Scalar c = 8.910;
+
+    const int yIdx = numVars - 1;
+    const Eval xEval = Eval::createVariable(x, 0);
+    const Eval yEval = Eval::createVariable(y, yIdx);
+    const HybridEval xHybrid = HybridEval::createVariable(x, 0);
+    const HybridEval yHybrid = HybridEval::createVariable(y, yIdx);
+
+    if (xHybrid.numActiveDerivatives() != 1 || !xHybrid.isActive(0))
+        throw std::logic_error("oops: HybridEvaluation::createVariable");
+
+    auto compare = [&](const Eval& dense, const HybridEval& hybrid, const char* what) {
+        if (!EvalToolbox::isSame(dense, hybrid.toDense(), tolerance))
+            throw std::logic_error(std::string("oops: HybridEvaluation ")+what);
+    };
+
+    {
+        const Eval a = (xEval + c)*yEval - xEval/yEval;
+        const HybridEval b = (xHybrid + c)*yHybrid - xHybrid/yHybrid;
+        compare(a, b, "arithmetic");
+        if (numVars > 2 && b.numActiveDerivatives() != 2)
+            throw std::logic_error("oops: HybridEvaluation: active derivatives");
+    }
+
+    {
+        Eval a = c - xEval;
+        a *= yEval;
+        a /= (c + yEval);
+        a += 2.0*xEval;
+        a -= yEval/c;
+        HybridEval b = c - xHybrid;
+        b *= yHybrid;
+        b /= (c + yHybrid);
+        b += 2.0*xHybrid;
+        b -= yHybrid/c;
+        compare(a, b, "inplace arithmetic");
+    }
+
+    compare(Opm::DenseAd::exp(xEval*yEval), Opm::DenseAd::exp(xHybrid*yHybrid), "exp()");
+    compare(Opm::DenseAd::log(xEval), Opm::DenseAd::log(xHybrid), "log()");
+    compare(Opm::DenseAd::sqrt(xEval), Opm::DenseAd::sqrt(xHybrid), "sqrt()");
+    compare(Opm::DenseAd::sin(yEval), Opm::DenseAd::sin(yHybrid), "sin()");
+    compare(Opm::DenseAd::cos(yEval), Opm::DenseAd::cos(yHybrid), "cos()");
+    compare(Opm::DenseAd::tan(yEval), Opm::DenseAd::tan(yHybrid), "tan()");
+    compare(Opm::DenseAd::asin(yEval), Opm::DenseAd::asin(yHybrid), "asin()");
+    compare(Opm::DenseAd::acos(yEval), Opm::DenseAd::acos(yHybrid), "acos()");
+    compare(Opm::DenseAd::atan(yEval), Opm::DenseAd::atan(yHybrid), "atan()");
+    compare(Opm::DenseAd::atan2(xEval, yEval), Opm::DenseAd::atan2(xHybrid, yHybrid), "atan2()");
+    compare(Opm::DenseAd::pow(xEval, c), Opm::DenseAd::pow(xHybrid, c), "pow()");
+    compare(Opm::DenseAd::pow(c, xEval), Opm::DenseAd::pow(c, xHybrid), "pow()");
+    compare(Opm::DenseAd::pow(xEval, yEval), Opm::DenseAd::pow(xHybrid, yHybrid), "pow()");
+    compare(Opm::max(xEval, yEval), Opm::max(xHybrid, yHybrid), "max()");
+    compare(Opm::min(xEval, c), Opm::min(xHybrid, c), "min()");
+    compare(Opm::abs(-xEval), Opm::abs(-xHybrid), "abs()");
+
+    // conversion of dense evaluations
+    const Eval dense = xEval*yEval;
+    compare(dense, HybridEval(dense), "conversion");
+}
+
+
+// make sure that lazily evaluated expressions produce the same results as the eager ones
+template <class Scalar, int numVars>
+void testExpressionTemplates()
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, numVars> Eval;
+    using Opm::DenseAd::lazy;
+    using Opm::DenseAd::evaluate;
+
+    const Eval x = Eval::createVariable(1.234, 0);
+    const Eval y = Eval::createVariable(0.567, numVars - 1);
+    const Scalar x0 = 0.5;
+    const Scalar x1 = 2.0;
+    const Scalar y0 = 3.0;
+    const Scalar y1 = -1.0;
+
+    const Eval a = y0 + (y1 - y0)*(x - x0)/(x1 - x0);
+    const Eval b = evaluate(y0 + (y1 - y0)*(lazy(x) - x0)/(x1 - x0));
+    if (a != b)
+        throw std::logic_error("oops: expression templates: linear interpolation");
+
+    const Eval c = x*y/(x + y) - 2.0/y + (1.0 - x)*y - (-x);
+    const Eval d = evaluate(lazy(x)*lazy(y)/(lazy(x) + lazy(y)) - 2.0/lazy(y)
+                            + (1.0 - lazy(x))*lazy(y) - (-lazy(x)));
+    if (c != d)
+        throw std::logic_error("oops: expression templates: arithmetic");
+
+    // scalars pass through unchanged
+    const Scalar e = evaluate(lazy(x0)*x1);
+    if (e != x0*x1)
+        throw std::logic_error("oops: expression templates: scalars");
+}
+
+template <class Eval>
+Eval simdTestFunction(const Eval& x, const Eval& y)
+{
+    Eval result = Opm::pow(x, 1.3)*Opm::exp(y)/(x + y) + Opm::abs(x - y);
+    result += Opm::max(x, 0.5) - Opm::min(y, x) + Opm::sqrt(x*y);
+    result *= Opm::pow(x, y)/Opm::pow(2.0, y);
+    return result;
+}
+
+// make sure that evaluations for several cells yield the same results as the ones for
+// individual cells
+template <class Scalar, int numVars, int width>
+void testSimdEvaluation(const Scalar tolerance)
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, numVars> Eval;
+    typedef Opm::SimdValue<Scalar, width> Pack;
+    typedef Opm::DenseAd::Evaluation<Pack, numVars> PackEval;
+    typedef Opm::MathToolbox<Eval> EvalToolbox;
+
+    std::array<Eval, width> xs, ys;
+    PackEval xPack, yPack;
+    for (int laneIdx = 0; laneIdx < width; ++laneIdx) {
+        xs[laneIdx] = Eval::createVariable(0.25 + 0.5*laneIdx, 0);
+        ys[laneIdx] = Eval::createVariable(1.2 + 0.1*laneIdx, numVars - 1);
+        Opm::setLane(xPack, laneIdx, xs[laneIdx]);
+        Opm::setLane(yPack, laneIdx, ys[laneIdx]);
+    }
+
+    const PackEval resultPack = simdTestFunction(xPack, yPack);
+    for (int laneIdx = 0; laneIdx < width; ++laneIdx) {
+        const Eval result = simdTestFunction(xs[laneIdx], ys[laneIdx]);
+        if (!EvalToolbox::isSame(result, Opm::getLane(resultPack, laneIdx), tolerance))
+            throw std::logic_error("oops: SIMD evaluation");
+    }
+
+    // masked branching
+    const Opm::SimdMask<width> mask = xPack.value() < yPack.value();
+    const PackEval selected = Opm::select(mask, xPack, yPack);
+    for (int laneIdx = 0; laneIdx < width; ++laneIdx) {
+        const Eval& expected = (xs[laneIdx] < ys[laneIdx]) ? xs[laneIdx] : ys[laneIdx];
+        if (!EvalToolbox::isSame(expected, Opm::getLane(selected, laneIdx), tolerance))
+            throw std::logic_error("oops: SIMD evaluation: select()");
+    }
+    if (!Opm::anyTrue(mask) || Opm::allTrue(mask))
+        throw std::logic_error("oops: SIMD evaluation: anyTrue()/allTrue()");
+}
+
+// the scatter functions must yield the same blocks as copying the derivatives entry by
+// entry
+template <class Scalar, int numEqs, int numVars>
+void testJacobianScatter()
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, numVars> Eval;
+    typedef Dune::FieldMatrix<Scalar, numEqs, numVars> Block;
+    typedef Dune::FieldVector<Scalar, numEqs> Vector;
+
+    std::array<Eval, numEqs> flux;
+    for (int eqIdx = 0; eqIdx < numEqs; ++eqIdx) {
+        flux[eqIdx] = 1.0 + eqIdx;
+        for (int varIdx = 0; varIdx < numVars; ++varIdx)
+            flux[eqIdx].setDerivative(varIdx, 0.5*eqIdx - 0.25*varIdx + 1.0/(1 + varIdx));
+    }
+
+    Block block(0.0);
+    Opm::DenseAd::scatterDerivatives(block, flux);
+    for (int eqIdx = 0; eqIdx < numEqs; ++eqIdx)
+        for (int varIdx = 0; varIdx < numVars; ++varIdx)
+            if (block[eqIdx][varIdx] != flux[eqIdx].derivative(varIdx))
+                throw std::logic_error("oops: scatterDerivatives() for Dune::FieldMatrix");
+
+    // raw pointer with a stride which is larger than the number of derivatives
+    const int rowStride = numVars + 3;
+    std::vector<Scalar> rawBlock(numEqs*rowStride, -1.0);
+    Opm::DenseAd::scatterDerivatives(rawBlock.data(), rowStride, flux.data(), numEqs);
+    for (int eqIdx = 0; eqIdx < numEqs; ++eqIdx) {
+        for (int i = 0; i < rowStride; ++i) {
+            const Scalar expected = (i < numVars) ? flux[eqIdx].derivative(i) : Scalar(-1.0);
+            if (rawBlock[eqIdx*rowStride + i] != expected)
+                throw std::logic_error("oops: scatterDerivatives() with a row stride");
+        }
+    }
+
+    // residual += flux and residual -= 2*flux
+    Vector residual(1.0);
+    Block jacobian(1.0);
+    Opm::DenseAd::accumulateResidualAndJacobian(residual, jacobian, flux);
+    Opm::DenseAd::accumulateResidualAndJacobian(residual, jacobian, flux, Scalar(-2.0));
+
+    std::vector<Scalar> rawResidual(numEqs, 1.0);
+    std::vector<Scalar> rawJacobian(numEqs*rowStride, 1.0);
+    Opm::DenseAd::accumulateResidualAndJacobian(rawResidual.data(), rawJacobian.data(), rowStride,
+                                                flux.data(), numEqs);
+    Opm::DenseAd::accumulateResidualAndJacobian(rawResidual.data(), rawJacobian.data(), rowStride,
+                                                flux.data(), numEqs, Scalar(-2.0));
+
+    // the order of the operations differs from the one of the kernels, so the results
+    // are only equal up to rounding
+    const Scalar tol = std::numeric_limits<Scalar>::epsilon()*10;
+    for (int eqIdx = 0; eqIdx < numEqs; ++eqIdx) {
+        const Scalar expectedValue = 1.0 - flux[eqIdx].value();
+        if (std::abs(residual[eqIdx] - expectedValue) > tol*std::abs(expectedValue)
+            || residual[eqIdx] != rawResidual[eqIdx])
+            throw std::logic_error("oops: accumulateResidualAndJacobian(): residual");
+        for (int varIdx = 0; varIdx < numVars; ++varIdx) {
+            const Scalar expectedDeriv = 1.0 - flux[eqIdx].derivative(varIdx);
+            if (std::abs(jacobian[eqIdx][varIdx] - expectedDeriv) > tol*(1 + std::abs(expectedDeriv))
+                || jacobian[eqIdx][varIdx] != rawJacobian[eqIdx*rowStride + varIdx])
+                throw std::logic_error("oops: accumulateResidualAndJacobian(): Jacobian");
+        }
+        for (int i = numVars; i < rowStride; ++i)
+            if (rawJacobian[eqIdx*rowStride + i] != 1.0)
+                throw std::logic_error("oops: accumulateResidualAndJacobian() writes beyond a row");
+    }
+}
+
+// check that the roots of cubic polynomials get the correct derivatives with regard to
+// the coefficients
+// second derivatives obtained using nested evaluations must match the analytic ones
+template <class Scalar>
+void testSecondOrderEvaluation(const Scalar tolerance)
+{
+    typedef Opm::DenseAd::SecondOrderEvaluation<Scalar, 2> Eval;
+    typedef Opm::DenseAd::Evaluation<Scalar, 2> FirstOrderEval;
+
+    const Scalar xv = 1.3;
+    const Scalar yv = 0.7;
+    const Eval x = Opm::DenseAd::createSecondOrderVariable<Scalar, 2>(xv, 0);
+    const Eval y = Opm::DenseAd::createSecondOrderVariable<Scalar, 2>(yv, 1);
+    const Eval two = Opm::DenseAd::createSecondOrderConstant<Scalar, 2>(2.0);
+
+    // f(x, y) = x^3*y^2 + exp(x*y) + log(x)*sqrt(y) + 2
+    const Eval f = Opm::pow(x, 3.0)*y*y + Opm::exp(x*y) + Opm::log(x)*Opm::sqrt(y) + two;
+
+    const Scalar exy = std::exp(xv*yv);
+    const Scalar sy = std::sqrt(yv);
+    const Scalar fExpected = xv*xv*xv*yv*yv + exy + std::log(xv)*sy + 2;
+    const Scalar dfdx = 3*xv*xv*yv*yv + yv*exy + sy/xv;
+    const Scalar dfdy = 2*xv*xv*xv*yv + xv*exy + std::log(xv)/(2*sy);
+    const Scalar d2fdx2 = 6*xv*yv*yv + yv*yv*exy - sy/(xv*xv);
+    const Scalar d2fdxdy = 6*xv*xv*yv + exy*(1 + xv*yv) + 1/(2*xv*sy);
+    const Scalar d2fdy2 = 2*xv*xv*xv + xv*xv*exy - std::log(xv)/(4*yv*sy);
+
+    const Opm::DenseAd::SymmetricHessian<Scalar, 2> H(f);
+    if (!Opm::MathToolbox<Scalar>::isSame(H.value(), fExpected, tolerance)
+        || !Opm::MathToolbox<Scalar>::isSame(H.gradient(0), dfdx, tolerance)
+        || !Opm::MathToolbox<Scalar>::isSame(H.gradient(1), dfdy, tolerance))
+        throw std::logic_error("oops: value or gradient of a second-order evaluation");
+
+    if (!Opm::MathToolbox<Scalar>::isSame(H(0, 0), d2fdx2, tolerance)
+        || !Opm::MathToolbox<Scalar>::isSame(H(1, 0), d2fdxdy, tolerance)
+        || H(0, 1) != H(1, 0)
+        || !Opm::MathToolbox<Scalar>::isSame(H(1, 1), d2fdy2, tolerance))
+        throw std::logic_error("oops: Hessian of a second-order evaluation");
+
+    // the mixed derivatives of the nested evaluation agree up to rounding
+    if (!Opm::MathToolbox<Scalar>::isSame(f.derivative(0).derivative(1),
+                                          f.derivative(1).derivative(0),
+                                          tolerance))
+        throw std::logic_error("oops: asymmetric second derivatives");
+
+    // decaying yields the values and the first derivatives
+    if (Opm::scalarValue(f) != H.value() || Opm::decay<Scalar>(f) != H.value())
+        throw std::logic_error("oops: decay of a second-order evaluation to a scalar");
+
+    const FirstOrderEval firstOrder = Opm::decay<FirstOrderEval>(f);
+    if (firstOrder.value() != H.value()
+        || firstOrder.derivative(0) != H.gradient(0)
+        || firstOrder.derivative(1) != H.gradient(1))
+        throw std::logic_error("oops: decay of a second-order evaluation to a first-order one");
+}
+
+template <class Scalar>
+void testCubicRoots(const Scalar tolerance)
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, 3> Eval;
+
+    // three real roots: p(x) = 2*(x - r0)*(x - r1)*(x - r2), the roots are the
+    // primary variables
+    const Eval& r0 = Eval::createVariable(-1.5, 0);
+    const Eval& r1 = Eval::createVariable(0.5, 1);
+    const Eval& r2 = Eval::createVariable(3.0, 2);
+
+    Eval sol[3];
+    unsigned numSol =
+        Opm::invertCubicPolynomial(sol,
+                                   Eval(2.0),
+                                   -2*(r0 + r1 + r2),
+                                   2*(r0*r1 + r0*r2 + r1*r2),
+                                   -2*r0*r1*r2);
+    if (numSol != 3)
+        throw std::logic_error("oops: invertCubicPolynomial: wrong number of roots");
+
+    const Eval* roots[3] = { &r0, &r1, &r2 };
+    for (unsigned i = 0; i < 3; ++i) {
+        if (std::abs(sol[i].value() - roots[i]->value()) > tolerance)
+            throw std::logic_error("oops: invertCubicPolynomial: value");
+        for (unsigned varIdx = 0; varIdx < 3; ++varIdx)
+            if (std::abs(sol[i].derivative(varIdx) - (i == varIdx ? 1.0 : 0.0)) > tolerance)
+                throw std::logic_error("oops: invertCubicPolynomial: derivative");
+    }
+
+    // a single real root: p(x) = (x - r0)*(x^2 + 1)
+    numSol = Opm::invertCubicPolynomial(sol, Eval(1.0), -r0, Eval(1.0), -r0);
+    if (numSol != 1
+        || std::abs(sol[0].value() - r0.value()) > tolerance
+        || std::abs(sol[0].derivative(0) - 1.0) > tolerance
+        || std::abs(sol[0].derivative(1)) > tolerance)
+        throw std::logic_error("oops: invertCubicPolynomial: single root");
+}
+
+// check the approximations which are used by the DenseAd functions if
+// OPM_DENSEAD_FAST_MATH is enabled against the ones of the C library
+template <class Scalar>
+void testFastMath(const Scalar tolerance)
+{
+    typedef Opm::DenseAd::FastMathToolbox<Scalar> FastToolbox;
+
+    const int n = 100000;
+    for (int i = 0; i <= n; ++i) {
+        // exp() for the full range of arguments which do not over- or underflow
+        Scalar x = -700 + Scalar(1400.0)*i/n;
+        if (std::is_same<Scalar, float>::value)
+            x = -80 + Scalar(160.0)*i/n;
+        Scalar expRef = std::exp(x);
+        if (std::abs(FastToolbox::exp(x) - expRef) > tolerance*expRef)
+            throw std::logic_error("oops: fast math: exp("+std::to_string(x)+")");
+
+        // log() for arguments from 1e-10 to 1e10 and close to 1
+        Scalar y = std::pow(Scalar(10.0), Scalar(-10.0 + 20.0*i/n));
+        Scalar z = Scalar(0.9) + Scalar(0.2)*i/n;
+        for (Scalar arg : { y, z }) {
+            Scalar logRef = std::log(arg);
+            if (std::abs(FastToolbox::log(arg) - logRef) > tolerance*std::abs(logRef))
+                throw std::logic_error("oops: fast math: log("+std::to_string(arg)+")");
+        }
+
+        // pow() with exponents between -3 and 3
+        Scalar e = -3 + Scalar(6.0)*i/n;
+        Scalar powRef = std::pow(y, e);
+        if (std::abs(FastToolbox::pow(y, e) - powRef)
+            > tolerance*(1 + std::abs(e*std::log(y)))*powRef)
+            throw std::logic_error("oops: fast math: pow("+std::to_string(y)+", "+std::to_string(e)+")");
+    }
+
+    // arguments which are passed to the C library
+    if (FastToolbox::exp(Scalar(1e4)) != std::numeric_limits<Scalar>::infinity()
+        || FastToolbox::exp(Scalar(-1e4)) != 0.0
+        || FastToolbox::log(Scalar(0.0)) != -std::numeric_limits<Scalar>::infinity()
+        || !std::isnan(FastToolbox::log(Scalar(-1.0)))
+        || FastToolbox::pow(Scalar(-2.0), 3) != -8.0
+        || FastToolbox::exp(Scalar(0.0)) != 1.0
+        || FastToolbox::log(Scalar(1.0)) != 0.0)
+        throw std::logic_error("oops: fast math: special arguments");
+}
 
 int main(int argc, char **argv)
 {
@@ -657,5 +1064,29 @@ int main(int argc, char **argv)
     TestEnv<float, 15>().testAll();
     TestEnv<float, 2>().testAll();
 
+    testHybridEvaluation<double, 15>(1e-10);
+    testHybridEvaluation<double, 2>(1e-10);
+    testHybridEvaluation<float, 15>(1e-5);
+
+    testExpressionTemplates<double, 15>();
+    testExpressionTemplates<double, 2>();
+    testExpressionTemplates<float, 3>();
+
+    testSimdEvaluation<double, 3, 4>(1e-12);
+    testSimdEvaluation<float, 5, 8>(1e-5);
+
+    testSecondOrderEvaluation<double>(/*tolerance=*/1e-10);
+    testSecondOrderEvaluation<float>(/*tolerance=*/1e-3);
+
+    testJacobianScatter<double, 3, 3>();
+    testJacobianScatter<double, 4, 12>();
+    testJacobianScatter<float, 2, 15>();
+
+    testCubicRoots<double>(1e-10);
+    testCubicRoots<float>(1e-4);
+
+    testFastMath<double>(1e-14);
+    testFastMath<float>(1e-6);
+
     return 0;
 }
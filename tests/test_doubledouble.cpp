@@ -0,0 +1,212 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the double-double floating point type.
+ *
+ * It checks the precision of the arithmetic operations and the mathematical
+ * functions against reference values with 35 significant digits and makes sure that
+ * the components and the automatic differentiation code can be instantiated with it.
+ */
+#include "config.h"
+
+#include <opm/material/common/DoubleDouble.hpp>
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <opm/material/components/Air.hpp>
+#include <opm/material/components/H2O.hpp>
+#include <opm/material/components/N2.hpp>
+#include <opm/material/components/SimpleH2O.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+typedef Opm::DoubleDouble DoubleDouble;
+
+DoubleDouble parse(const std::string& str)
+{
+    DoubleDouble result;
+    std::istringstream is(str);
+    is >> result;
+    if (!is)
+        OPM_THROW(std::logic_error, "Could not parse '" << str << "'");
+    return result;
+}
+
+void checkValue(const std::string& name,
+                const DoubleDouble& value,
+                const std::string& reference,
+                double tolerance = 1e-30)
+{
+    const DoubleDouble& ref = parse(reference);
+    const DoubleDouble& relError = std::abs((value - ref)/ref);
+    if (!(relError < tolerance))
+        OPM_THROW(std::logic_error,
+                  "The double-double value of " << name << " deviates from the reference: "
+                  << std::setprecision(35) << value << " vs. " << reference
+                  << " (relative error: " << std::setprecision(3) << relError << ")");
+}
+
+void checkArithmetic()
+{
+    const DoubleDouble one = 1.0;
+    const DoubleDouble third = one/3.0;
+
+    checkValue("1/3", third, "0.33333333333333333333333333333333333");
+    checkValue("1/7", one/DoubleDouble(7.0), "0.14285714285714285714285714285714286");
+    checkValue("(1/3)*3", third*3.0, "1.0");
+    checkValue("1 + 2^-80", one + std::ldexp(1.0, -80), "1.0000000000000000000000008271806125530277");
+    checkValue("(1 + 2^-80) - 1", (one + std::ldexp(1.0, -80)) - 1.0, "8.271806125530276748714086920699e-25");
+    checkValue("sqrt(2)", std::sqrt(DoubleDouble(2.0)), "1.4142135623730950488016887242096981");
+    checkValue("sqrt(2)^2", std::sqrt(DoubleDouble(2.0))*std::sqrt(DoubleDouble(2.0)), "2.0");
+
+    if (!(third*3.0 == one) || !(third < 0.34) || !(third > 0.33) || !(-third <= 0.0))
+        OPM_THROW(std::logic_error, "Comparison of double-double values failed");
+
+    // the low part makes a difference
+    if (!(DoubleDouble(1.0, 1e-20) > 1.0) || !(DoubleDouble(1.0, -1e-20) < 1.0))
+        OPM_THROW(std::logic_error, "Comparison of double-double values ignores the low part");
+}
+
+void checkFunctions()
+{
+    checkValue("exp(1)", std::exp(DoubleDouble(1.0)), "2.7182818284590452353602874713526625");
+    checkValue("exp(-20.5)", std::exp(DoubleDouble(-20.5)), "1.2501528663867426289375531192312222e-9");
+    checkValue("exp(300)", std::exp(DoubleDouble(300.0)), "1.9424263952412559365842088360176992e130");
+    checkValue("log(2)", std::log(DoubleDouble(2.0)), "0.69314718055994530941723212145817657");
+    checkValue("log(1e-10)", std::log(parse("1e-10")), "-23.025850929940456840179914546843642", 1e-29);
+    checkValue("log10(2)", std::log10(DoubleDouble(2.0)), "0.30102999566398119521373889472449303");
+    checkValue("pow(2, 0.5)", std::pow(DoubleDouble(2.0), 0.5), "1.4142135623730950488016887242096981");
+    checkValue("pow(1.5, -3)", std::pow(DoubleDouble(1.5), -3), "0.29629629629629629629629629629629630");
+    checkValue("pow(-2, 3)", std::pow(DoubleDouble(-2.0), DoubleDouble(3.0)), "-8.0");
+    checkValue("sin(1)", std::sin(DoubleDouble(1.0)), "0.84147098480789650665250232163029900");
+    checkValue("cos(1)", std::cos(DoubleDouble(1.0)), "0.54030230586813971740093660744297661");
+    checkValue("sin(10)", std::sin(DoubleDouble(10.0)), "-0.54402111088936981340474766185137728", 1e-29);
+    checkValue("tan(0.5)", std::tan(DoubleDouble(0.5)), "0.54630248984379051325517946578028538");
+    checkValue("4*atan(1)", 4.0*std::atan(DoubleDouble(1.0)), "3.1415926535897932384626433832795029");
+    checkValue("atan2(-1, -3)", std::atan2(DoubleDouble(-1.0), DoubleDouble(-3.0)), "-2.8198420991931510450612387689208416");
+    checkValue("3*acos(0.5)", 3.0*std::acos(DoubleDouble(0.5)), "3.1415926535897932384626433832795029");
+    checkValue("2*asin(1)", 2.0*std::asin(DoubleDouble(1.0)), "3.1415926535897932384626433832795029");
+    checkValue("floor(-2.5)", std::floor(DoubleDouble(-2.5)), "-3.0");
+    checkValue("round(-2.5)", std::round(DoubleDouble(-2.5)), "-3.0");
+    checkValue("ceil(1 + 2^-80)", std::ceil(DoubleDouble(1.0) + std::ldexp(1.0, -80)), "2.0");
+
+    if (!std::isnan(std::log(DoubleDouble(-1.0))) || !std::isinf(std::exp(DoubleDouble(1000.0))))
+        OPM_THROW(std::logic_error, "Special values of double-double functions are wrong");
+
+    // printing and reading back a value only changes its last bits
+    const DoubleDouble value = std::exp(DoubleDouble(-1.0));
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<DoubleDouble>::max_digits10) << value;
+    if (!(std::abs(parse(os.str()) - value) < 4*std::numeric_limits<DoubleDouble>::epsilon()*value))
+        OPM_THROW(std::logic_error, "Printing and reading back " << os.str() << " changes the value");
+}
+
+void checkAutomaticDifferentiation()
+{
+    typedef Opm::DenseAd::Evaluation<DoubleDouble, 2> Evaluation;
+
+    // f(x, y) = exp(x)*sqrt(y) + x^2.5 at (2, 3)
+    const Evaluation& x = Evaluation::createVariable(DoubleDouble(2.0), 0);
+    const Evaluation& y = Evaluation::createVariable(DoubleDouble(3.0), 1);
+    const Evaluation& f = Opm::exp(x)*Opm::sqrt(y) + Opm::pow(x, DoubleDouble(2.5));
+
+    checkValue("f(2, 3)", f.value(), "18.455074832816950993598089257442001");
+    checkValue("df/dx(2, 3)", f.derivative(0), "19.869288395190046042399777981651699");
+    checkValue("df/dy(2, 3)", f.derivative(1), "2.1330367638874284663985557267672014");
+}
+
+void compareToDouble(const std::string& name, const DoubleDouble& value, double reference)
+{
+    double relError = std::abs((value.hi() - reference)/reference);
+    if (!(relError < 1e-10))
+        OPM_THROW(std::logic_error,
+                  "The " << name << " computed in double-double precision deviates "
+                  << "from the double precision one: " << value << " vs. " << reference);
+}
+
+// the components yield the same results for double and double-double precision up
+// to the precision of the double precision code
+template <template <class> class Component>
+void compareGasProperties(const std::string& name, double T, double p)
+{
+    typedef Component<double> DoubleComponent;
+    typedef Component<DoubleDouble> DoubleDoubleComponent;
+
+    const DoubleDouble ddT = T;
+    const DoubleDouble ddP = p;
+    compareToDouble(name + " gas density",
+                    DoubleDoubleComponent::gasDensity(ddT, ddP),
+                    DoubleComponent::gasDensity(T, p));
+    compareToDouble(name + " gas enthalpy",
+                    DoubleDoubleComponent::gasEnthalpy(ddT, ddP),
+                    DoubleComponent::gasEnthalpy(T, p));
+}
+
+template <template <class> class Component>
+void compareLiquidProperties(const std::string& name, double T, double p)
+{
+    typedef Component<double> DoubleComponent;
+    typedef Component<DoubleDouble> DoubleDoubleComponent;
+
+    const DoubleDouble ddT = T;
+    const DoubleDouble ddP = p;
+    compareToDouble(name + " liquid density",
+                    DoubleDoubleComponent::liquidDensity(ddT, ddP),
+                    DoubleComponent::liquidDensity(T, p));
+    compareToDouble(name + " liquid enthalpy",
+                    DoubleDoubleComponent::liquidEnthalpy(ddT, ddP),
+                    DoubleComponent::liquidEnthalpy(T, p));
+}
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    checkArithmetic();
+    checkFunctions();
+    checkAutomaticDifferentiation();
+
+    compareGasProperties<Opm::Air>("air", 300.0, 1e5);
+    compareGasProperties<Opm::N2>("N2", 300.0, 1e5);
+    compareGasProperties<Opm::H2O>("H2O", 450.0, 1e5);
+    compareLiquidProperties<Opm::H2O>("H2O", 350.0, 2e5);
+    compareGasProperties<Opm::SimpleH2O>("SimpleH2O", 450.0, 1e5);
+    compareLiquidProperties<Opm::SimpleH2O>("SimpleH2O", 350.0, 2e5);
+
+    return 0;
+}
@@ -39,10 +39,14 @@
 #include <opm/material/fluidsystems/blackoilpvt/WetGasPvt.hpp>
 #include <opm/material/fluidsystems/blackoilpvt/DryGasPvt.hpp>
 #include <opm/material/fluidsystems/blackoilpvt/ConstantCompressibilityWaterPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/EclPvtRegionUsage.hpp>
 
 #include <opm/material/fluidsystems/blackoilpvt/GasPvtMultiplexer.hpp>
 #include <opm/material/fluidsystems/blackoilpvt/OilPvtMultiplexer.hpp>
 #include <opm/material/fluidsystems/blackoilpvt/WaterPvtMultiplexer.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/PvtRegionBatch.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/ReducedDerivativePvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/MemoizedPvt.hpp>
 
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/material/densead/Math.hpp>
@@ -58,6 +62,9 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <cmath>
+#include <string>
+
 // values of strings based on the first SPE1 test case of opm-data.  note that in the
 // real world it does not make much sense to specify a fluid phase using more than a
 // single keyword, but for a unit test, this saves a lot of boiler-plate code.
@@ -134,6 +141,81 @@ static const char* deckString1 =
     "/\n"
     "\n";
 
+// a deck with two PVT regions and a temperature dependent oil viscosity. the keywords
+// of the REGIONS section are passed in to be able to leave regions unreferenced.
+static std::string thermalDeckString(const std::string& regionsSection)
+{
+    return
+        "RUNSPEC\n"
+        "\n"
+        "DIMENS\n"
+        "   2 1 1 /\n"
+        "\n"
+        "TABDIMS\n"
+        " * 2 /\n"
+        "\n"
+        "OIL\n"
+        "GAS\n"
+        "WATER\n"
+        "\n"
+        "DISGAS\n"
+        "\n"
+        "METRIC\n"
+        "\n"
+        "GRID\n"
+        "\n"
+        "DX\n"
+        "   2*100 /\n"
+        "DY\n"
+        "   2*100 /\n"
+        "DZ\n"
+        "   2*10 /\n"
+        "\n"
+        "TOPS\n"
+        "   2*1234 /\n"
+        "\n"
+        "PROPS\n"
+        "\n"
+        "DENSITY\n"
+        "   800.0 1000.0 0.9 /\n"
+        "   810.0 1010.0 0.8 /\n"
+        "\n"
+        "PVTW\n"
+        "   200.0 1.02 4.5e-5 0.5 0.0 /\n"
+        "   200.0 1.03 4.5e-5 0.6 0.0 /\n"
+        "\n"
+        "PVTO\n"
+        "-- RS    PRESSURE  BO    VISCOSITY\n"
+        "   10.0   20.0     1.05  1.50\n"
+        "         300.0     1.03  1.80 /\n"
+        "  100.0  200.0     1.25  0.90\n"
+        "         300.0     1.24  1.00 /\n"
+        "/\n"
+        "   20.0   20.0     1.10  1.40\n"
+        "         300.0     1.08  1.70 /\n"
+        "  120.0  200.0     1.30  0.80\n"
+        "         300.0     1.29  0.90 /\n"
+        "/\n"
+        "\n"
+        "PVDG\n"
+        "   10.0  0.100  0.010\n"
+        "  300.0  0.004  0.025 /\n"
+        "   10.0  0.110  0.011\n"
+        "  300.0  0.005  0.026 /\n"
+        "\n"
+        "OILVISCT\n"
+        "   20.0  1.0\n"
+        "   80.0  0.5 /\n"
+        "   20.0  2.0\n"
+        "   80.0  1.0 /\n"
+        "\n"
+        "VISCREF\n"
+        "   100.0  50.0 /\n"
+        "   100.0  60.0 /\n"
+        "\n"
+        + regionsSection;
+}
+
 template <class Evaluation, class OilPvt, class GasPvt, class WaterPvt>
 void ensurePvtApi(const OilPvt& oilPvt, const GasPvt& gasPvt, const WaterPvt& waterPvt)
 {
@@ -216,6 +298,17 @@ void ensurePvtApi(const OilPvt& oilPvt, const GasPvt& gasPvt, const WaterPvt& wa
                                                     pressure,
                                                     So,
                                                     maxSo);
+        gasPvt.inverseFormationVolumeFactorAndViscosity(/*regionIdx=*/0,
+                                                        temperature,
+                                                        pressure,
+                                                        Rv,
+                                                        tmp,
+                                                        tmp);
+        gasPvt.saturatedInverseFormationVolumeFactorAndViscosity(/*regionIdx=*/0,
+                                                                 temperature,
+                                                                 pressure,
+                                                                 tmp,
+                                                                 tmp);
 
         // prevent GCC from producing a "variable assigned but unused" warning
         tmp = 2.0*tmp;
@@ -269,6 +362,58 @@ inline void testAll()
                   "The reference water viscosity at region 1 is supposed to be " << refTmp
                   << ". (is " << tmp << ")");
 
+    // evaluate the water viscosity of cells in both PVT regions using a batch. the
+    // results must be identical to the ones of the cell-wise method.
+    {
+        std::vector<unsigned> cellRegionIdx = { 0, 0, 1, 1, 1 };
+        std::vector<Scalar> T(cellRegionIdx.size(), 273.15 + 20.0);
+        std::vector<Scalar> p = { 1e5, 2e5, 2e5, 3e5, 4e5 };
+        std::vector<Scalar> mu(cellRegionIdx.size());
+
+        Opm::PvtRegionBatch batch;
+        batch.setRegionIndices(cellRegionIdx);
+        if (batch.numCells() != cellRegionIdx.size() || batch.numRanges() != 2)
+            OPM_THROW(std::logic_error,
+                      "The PVT region batch is supposed to consist of 2 regions and "
+                      << cellRegionIdx.size() << " cells");
+
+        batch.viscosity(constCompWaterPvt, T.data(), p.data(), mu.data());
+        for (unsigned cellIdx = 0; cellIdx < cellRegionIdx.size(); ++cellIdx) {
+            refTmp = constCompWaterPvt.viscosity(cellRegionIdx[cellIdx], T[cellIdx], p[cellIdx]);
+            if (mu[cellIdx] != refTmp)
+                OPM_THROW(std::logic_error,
+                          "The batched water viscosity of cell " << cellIdx
+                          << " is supposed to be " << refTmp << ". (is " << mu[cellIdx] << ")");
+        }
+
+        // the fused evaluation of both quantities must yield exactly the same results
+        std::vector<Scalar> invB(cellRegionIdx.size());
+        batch.inverseFormationVolumeFactorAndViscosity(constCompWaterPvt, T.data(), p.data(),
+                                                       invB.data(), mu.data());
+        for (unsigned cellIdx = 0; cellIdx < cellRegionIdx.size(); ++cellIdx) {
+            unsigned regionIdx = cellRegionIdx[cellIdx];
+            if (invB[cellIdx] != constCompWaterPvt.inverseFormationVolumeFactor(regionIdx, T[cellIdx], p[cellIdx])
+                || mu[cellIdx] != constCompWaterPvt.viscosity(regionIdx, T[cellIdx], p[cellIdx]))
+                OPM_THROW(std::logic_error,
+                          "The fused water quantities of cell " << cellIdx << " are wrong");
+        }
+
+        // the same applies for the kernel which processes all pressures of a region
+        std::vector<Scalar> invBRegion(cellRegionIdx.size());
+        std::vector<Scalar> muRegion(cellRegionIdx.size());
+        for (size_t rangeIdx = 0; rangeIdx < batch.numRanges(); ++rangeIdx) {
+            size_t begin = batch.rangeBegin(rangeIdx);
+            constCompWaterPvt.inverseFormationVolumeFactorAndViscosityBatch(batch.rangeRegionIndex(rangeIdx),
+                                                                            batch.rangeEnd(rangeIdx) - begin,
+                                                                            p.data() + begin,
+                                                                            invBRegion.data() + begin,
+                                                                            muRegion.data() + begin);
+        }
+        if (invBRegion != invB || muRegion != mu)
+            OPM_THROW(std::logic_error,
+                      "The water quantities of the per-region kernel are wrong");
+    }
+
     //////////
     // the gas and oil PVT classes.
     //
@@ -286,9 +431,354 @@ inline void testAll()
     ensurePvtApi<Scalar>(oilPvt, gasPvt, waterPvt);
     ensurePvtApi<FooEval>(oilPvt, gasPvt, waterPvt);
 
+    // evaluating the PVT relations using evaluations which only consider the
+    // derivatives with regard to the arguments must yield the same values and
+    // derivatives as evaluating them with all derivatives of the caller
+    {
+        typedef Opm::DenseAd::Evaluation<Scalar, 6> Evaluation;
+        Opm::ReducedDerivativePvt<Opm::OilPvtMultiplexer<Scalar> > reducedOilPvt(oilPvt);
+        Opm::ReducedDerivativePvt<Opm::GasPvtMultiplexer<Scalar> > reducedGasPvt(gasPvt);
+
+        auto close = [](const Evaluation& a, const Evaluation& b) {
+            const Scalar tol = std::numeric_limits<Scalar>::epsilon()*1e2;
+            if (std::abs(a.value() - b.value()) > tol*std::abs(b.value()))
+                return false;
+            for (int varIdx = 0; varIdx < Evaluation::size; ++varIdx)
+                if (std::abs(a.derivative(varIdx) - b.derivative(varIdx))
+                    > tol*(std::abs(b.derivative(varIdx)) + std::abs(b.value())))
+                    return false;
+            return true;
+        };
+
+        // the arguments depend on several primary variables
+        Evaluation T = 273.15 + 20.0;
+        T.setDerivative(5, 1.0);
+        for (Scalar pValue = 1e6; pValue < 3e7; pValue *= 2) {
+            Evaluation p = Evaluation::createVariable(pValue, 0);
+            p.setDerivative(1, 0.5*pValue);
+            Evaluation Rs = 0.5*oilPvt.saturatedGasDissolutionFactor(/*regionIdx=*/0, T, p);
+            Rs.setDerivative(2, Rs.derivative(2) + 10.0);
+            Evaluation Rv = 0.5*gasPvt.saturatedOilVaporizationFactor(/*regionIdx=*/0, T, p);
+            Rv.setDerivative(3, Rv.derivative(3) + 1e-4);
+
+            for (unsigned regionIdx = 0; regionIdx < numPvtRegions; ++regionIdx) {
+                const Evaluation values[] = {
+                    reducedOilPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rs),
+                    reducedOilPvt.viscosity(regionIdx, T, p, Rs),
+                    reducedOilPvt.saturatedGasDissolutionFactor(regionIdx, T, p),
+                    reducedOilPvt.saturationPressure(regionIdx, T, Rs),
+                    reducedGasPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rv),
+                    reducedGasPvt.viscosity(regionIdx, T, p, Rv),
+                    reducedGasPvt.saturatedOilVaporizationFactor(regionIdx, T, p)
+                };
+                const Evaluation refValues[] = {
+                    oilPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rs),
+                    oilPvt.viscosity(regionIdx, T, p, Rs),
+                    oilPvt.saturatedGasDissolutionFactor(regionIdx, T, p),
+                    oilPvt.saturationPressure(regionIdx, T, Rs),
+                    gasPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rv),
+                    gasPvt.viscosity(regionIdx, T, p, Rv),
+                    gasPvt.saturatedOilVaporizationFactor(regionIdx, T, p)
+                };
+                for (unsigned i = 0; i < 7; ++i)
+                    if (!close(values[i], refValues[i]))
+                        OPM_THROW(std::logic_error,
+                                  "Quantity " << i << " evaluated using reduced derivatives at p = "
+                                  << pValue << " is supposed to be " << refValues[i]
+                                  << ". (is " << values[i] << ")");
+            }
+        }
+    }
+
+    // the memoized PVT relations must be identical to the ones of the wrapped objects
+    // for the evaluations which are stored and stay within the accuracy bound for the
+    // ones which are answered by the cache
+    {
+        Opm::MemoizedPvt<Opm::OilPvtMultiplexer<Scalar>, Scalar> memoizedOilPvt(oilPvt);
+        Opm::MemoizedPvt<Opm::GasPvtMultiplexer<Scalar>, Scalar> memoizedGasPvt(gasPvt);
+        memoizedOilPvt.enable(/*maxRelativeDeviation=*/1e-5);
+        memoizedGasPvt.enable(/*maxRelativeDeviation=*/1e-5);
+
+        const Scalar T = 273.15 + 20.0;
+        const Scalar tol = 1e-4;
+        for (unsigned i = 0; i < 100; ++i) {
+            // pressures which only differ by a small fraction of the permitted deviation
+            const Scalar p = 1e7*(1 + 1e-3*(i/10) + 1e-8*(i % 10));
+            for (unsigned regionIdx = 0; regionIdx < numPvtRegions; ++regionIdx) {
+                const Scalar Rs = 0.5*oilPvt.saturatedGasDissolutionFactor(regionIdx, T, Scalar(1e7));
+                const Scalar Rv = 0.5*gasPvt.saturatedOilVaporizationFactor(regionIdx, T, Scalar(1e7));
+                const Scalar values[] = {
+                    memoizedOilPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rs),
+                    memoizedOilPvt.viscosity(regionIdx, T, p, Rs),
+                    memoizedOilPvt.saturatedGasDissolutionFactor(regionIdx, T, p),
+                    memoizedGasPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rv),
+                    memoizedGasPvt.viscosity(regionIdx, T, p, Rv),
+                    memoizedGasPvt.saturatedOilVaporizationFactor(regionIdx, T, p)
+                };
+                const Scalar refValues[] = {
+                    oilPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rs),
+                    oilPvt.viscosity(regionIdx, T, p, Rs),
+                    oilPvt.saturatedGasDissolutionFactor(regionIdx, T, p),
+                    gasPvt.inverseFormationVolumeFactor(regionIdx, T, p, Rv),
+                    gasPvt.viscosity(regionIdx, T, p, Rv),
+                    gasPvt.saturatedOilVaporizationFactor(regionIdx, T, p)
+                };
+                for (unsigned j = 0; j < 6; ++j)
+                    if (std::abs(values[j] - refValues[j]) > tol*std::abs(refValues[j]))
+                        OPM_THROW(std::logic_error,
+                                  "Quantity " << j << " evaluated using the memoized PVT at p = "
+                                  << p << " is supposed to be " << refValues[j]
+                                  << ". (is " << values[j] << ")");
+            }
+        }
+
+        if (memoizedOilPvt.statistics().hits == 0 || memoizedGasPvt.statistics().hits == 0)
+            OPM_THROW(std::logic_error,
+                      "Evaluating the memoized PVT at nearby pressures must hit the cache");
+    }
+
+    // the fused and batched evaluation of the gas phase must yield the same results as
+    // the individual methods
+    {
+        std::vector<unsigned> cellRegionIdx = { 0, 0, 0, 1, 1 };
+        std::vector<Scalar> T(cellRegionIdx.size(), 273.15 + 20.0);
+        std::vector<Scalar> p = { 1e5, 5e6, 2e7, 3e6, 1e7 };
+        std::vector<Scalar> Rv(cellRegionIdx.size());
+        std::vector<Scalar> invB(cellRegionIdx.size());
+        std::vector<Scalar> mu(cellRegionIdx.size());
+        std::vector<Scalar> pSat(cellRegionIdx.size());
+
+        Opm::PvtRegionBatch batch;
+        batch.setRegionIndices(cellRegionIdx);
+        batch.saturatedOilVaporizationFactor(gasPvt, T.data(), p.data(), Rv.data());
+        for (auto& R : Rv)
+            R *= 0.5;
+        batch.inverseFormationVolumeFactorAndViscosity(gasPvt, T.data(), p.data(), Rv.data(),
+                                                       invB.data(), mu.data());
+        batch.saturationPressure(gasPvt, T.data(), Rv.data(), pSat.data());
+
+        for (unsigned cellIdx = 0; cellIdx < cellRegionIdx.size(); ++cellIdx) {
+            unsigned regionIdx = cellRegionIdx[cellIdx];
+            const Scalar refValues[] = {
+                gasPvt.inverseFormationVolumeFactor(regionIdx, T[cellIdx], p[cellIdx], Rv[cellIdx]),
+                gasPvt.viscosity(regionIdx, T[cellIdx], p[cellIdx], Rv[cellIdx]),
+                gasPvt.saturationPressure(regionIdx, T[cellIdx], Rv[cellIdx])
+            };
+            const Scalar values[] = { invB[cellIdx], mu[cellIdx], pSat[cellIdx] };
+            for (unsigned i = 0; i < 3; ++i)
+                if (std::abs(values[i] - refValues[i]) > tolerance*std::abs(refValues[i]))
+                    OPM_THROW(std::logic_error,
+                              "Batched gas quantity " << i << " of cell " << cellIdx
+                              << " is supposed to be " << refValues[i] << ". (is " << values[i] << ")");
+        }
+    }
+
+    // serialize the PVT objects and make sure that the restored objects yield
+    // identical results
+    {
+        Opm::BinaryWriter writer;
+        gasPvt.serialize(writer);
+        oilPvt.serialize(writer);
+        waterPvt.serialize(writer);
+
+        Opm::GasPvtMultiplexer<Scalar> gasPvt2;
+        Opm::OilPvtMultiplexer<Scalar> oilPvt2;
+        Opm::WaterPvtMultiplexer<Scalar> waterPvt2;
+
+        Opm::BinaryReader reader(writer.data());
+        gasPvt2.deserialize(reader);
+        oilPvt2.deserialize(reader);
+        waterPvt2.deserialize(reader);
+        if (!reader.atEnd())
+            OPM_THROW(std::logic_error, "Not all serialized PVT data was read back");
+
+        const Scalar T = 273.15 + 20.0;
+        for (unsigned regionIdx = 0; regionIdx < numPvtRegions; ++regionIdx) {
+            for (Scalar p = 1e5; p < 1e8; p *= 3) {
+                const Scalar values[] = {
+                    gasPvt.saturatedViscosity(regionIdx, T, p),
+                    gasPvt.saturatedInverseFormationVolumeFactor(regionIdx, T, p),
+                    oilPvt.saturatedViscosity(regionIdx, T, p),
+                    oilPvt.saturatedInverseFormationVolumeFactor(regionIdx, T, p),
+                    waterPvt.viscosity(regionIdx, T, p),
+                    waterPvt.inverseFormationVolumeFactor(regionIdx, T, p)
+                };
+                const Scalar restoredValues[] = {
+                    gasPvt2.saturatedViscosity(regionIdx, T, p),
+                    gasPvt2.saturatedInverseFormationVolumeFactor(regionIdx, T, p),
+                    oilPvt2.saturatedViscosity(regionIdx, T, p),
+                    oilPvt2.saturatedInverseFormationVolumeFactor(regionIdx, T, p),
+                    waterPvt2.viscosity(regionIdx, T, p),
+                    waterPvt2.inverseFormationVolumeFactor(regionIdx, T, p)
+                };
+                for (unsigned i = 0; i < 6; ++i)
+                    if (values[i] != restoredValues[i])
+                        OPM_THROW(std::logic_error,
+                                  "Quantity " << i << " of the deserialized PVT objects at p = "
+                                  << p << " is supposed to be " << values[i]
+                                  << ". (is " << restoredValues[i] << ")");
+            }
+        }
+    }
+
+    // PVT regions with identical tables must share them and yield identical results
+    {
+        typedef std::vector<std::pair<Scalar, Scalar> > SamplingPoints;
+
+        Opm::LiveOilPvt<Scalar> liveOilPvt;
+        Opm::WetGasPvt<Scalar> wetGasPvt;
+        liveOilPvt.setNumRegions(3);
+        wetGasPvt.setNumRegions(3);
+        for (unsigned regionIdx = 0; regionIdx < 3; ++regionIdx) {
+            // the tables of the second region differ from the other ones
+            const Scalar f = (regionIdx == 1) ? 1.1 : 1.0;
+            liveOilPvt.setReferenceDensities(regionIdx, 800.0, 1.0, 1000.0);
+            liveOilPvt.setSaturatedOilGasDissolutionFactor(regionIdx, SamplingPoints{{1e5, 0.0}, {1e7, 50.0*f}, {3e7, 120.0}});
+            liveOilPvt.setSaturatedOilFormationVolumeFactor(regionIdx, SamplingPoints{{1e5, 1.0}, {1e7, 1.1*f}, {3e7, 1.3}});
+            liveOilPvt.setSaturatedOilViscosity(regionIdx, SamplingPoints{{1e5, 2e-3}, {1e7, 1.5e-3*f}, {3e7, 1e-3}});
+
+            wetGasPvt.setReferenceDensities(regionIdx, 800.0, 1.0, 1000.0);
+            wetGasPvt.setSaturatedGasOilVaporizationFactor(regionIdx, SamplingPoints{{1e5, 0.0}, {1e7, 1e-4*f}, {3e7, 3e-4}});
+            wetGasPvt.setSaturatedGasFormationVolumeFactor(regionIdx, SamplingPoints{{1e5, 1.0}, {1e7, 0.01*f}, {3e7, 0.004}});
+            wetGasPvt.setSaturatedGasViscosity(regionIdx, SamplingPoints{{1e5, 1e-5}, {1e7, 2e-5*f}, {3e7, 3e-5}});
+        }
+        liveOilPvt.initEnd();
+        wetGasPvt.initEnd();
+
+        for (unsigned regionIdx = 0; regionIdx < 3; ++regionIdx) {
+            const unsigned refTableIdx = (regionIdx == 1) ? 1 : 0;
+            if (liveOilPvt.tableRegionIndex(regionIdx) != refTableIdx
+                || wetGasPvt.tableRegionIndex(regionIdx) != refTableIdx)
+                OPM_THROW(std::logic_error,
+                          "PVT region " << regionIdx << " is supposed to use the tables of region "
+                          << refTableIdx);
+        }
+
+        const Scalar T = 273.15 + 20.0;
+        for (Scalar p = 2e5; p < 3e7; p *= 2) {
+            const Scalar values[] = {
+                liveOilPvt.inverseFormationVolumeFactor(2, T, p, Scalar(30.0)),
+                liveOilPvt.viscosity(2, T, p, Scalar(30.0)),
+                liveOilPvt.saturationPressure(2, T, Scalar(30.0)),
+                wetGasPvt.inverseFormationVolumeFactor(2, T, p, Scalar(1e-5)),
+                wetGasPvt.viscosity(2, T, p, Scalar(1e-5)),
+                wetGasPvt.saturatedOilVaporizationFactor(2, T, p)
+            };
+            const Scalar refValues[] = {
+                liveOilPvt.inverseFormationVolumeFactor(0, T, p, Scalar(30.0)),
+                liveOilPvt.viscosity(0, T, p, Scalar(30.0)),
+                liveOilPvt.saturationPressure(0, T, Scalar(30.0)),
+                wetGasPvt.inverseFormationVolumeFactor(0, T, p, Scalar(1e-5)),
+                wetGasPvt.viscosity(0, T, p, Scalar(1e-5)),
+                wetGasPvt.saturatedOilVaporizationFactor(0, T, p)
+            };
+            for (unsigned i = 0; i < 6; ++i)
+                if (values[i] != refValues[i])
+                    OPM_THROW(std::logic_error,
+                              "Quantity " << i << " of a PVT region with shared tables at p = "
+                              << p << " is supposed to be " << refValues[i]
+                              << ". (is " << values[i] << ")");
+        }
+
+        // the saturation pressure inverts the saturated Rs(p) and Rv(p) tables, so
+        // evaluating them at the saturation pressure must yield the original values
+        const Scalar tol = std::numeric_limits<Scalar>::epsilon()*1e3;
+        for (unsigned regionIdx = 0; regionIdx < 3; ++regionIdx) {
+            for (unsigned i = 1; i < 50; ++i) {
+                const Scalar p = 1e5 + (3e7 - 1e5)*i/50;
+
+                const Scalar Rs = liveOilPvt.saturatedGasDissolutionFactor(regionIdx, T, p);
+                const Scalar pSat = liveOilPvt.saturationPressure(regionIdx, T, Rs);
+                const Scalar RsSat = liveOilPvt.saturatedGasDissolutionFactor(regionIdx, T, pSat);
+                if (std::abs(RsSat - Rs) > tol*Rs)
+                    OPM_THROW(std::logic_error,
+                              "The gas dissolution factor at the saturation pressure of Rs = "
+                              << Rs << " is supposed to be Rs. (is " << RsSat << ")");
+
+                const Scalar Rv = wetGasPvt.saturatedOilVaporizationFactor(regionIdx, T, p);
+                const Scalar pDew = wetGasPvt.saturationPressure(regionIdx, T, Rv);
+                const Scalar RvSat = wetGasPvt.saturatedOilVaporizationFactor(regionIdx, T, pDew);
+                if (std::abs(RvSat - Rv) > tol*Rv)
+                    OPM_THROW(std::logic_error,
+                              "The oil vaporization factor at the dew point pressure of Rv = "
+                              << Rv << " is supposed to be Rv. (is " << RvSat << ")");
+            }
+        }
+    }
+
+    // PVT regions which are not referenced by PVTNUM do not get any tables. this must
+    // not affect the thermal oil PVT, which evaluates the reference viscosity of each
+    // region during its initialization
+    {
+        const auto unusedRegionDeck =
+            parser.parseString(thermalDeckString("REGIONS\n\nPVTNUM\n   2*1 /\n"), parseContext);
+        const Opm::EclipseState unusedRegionEclState(unusedRegionDeck, parseContext);
+        const auto allRegionsDeck = parser.parseString(thermalDeckString(""), parseContext);
+        const Opm::EclipseState allRegionsEclState(allRegionsDeck, parseContext);
+
+        const auto& regionIsUsed = Opm::eclUsedPvtRegions(unusedRegionEclState, 2);
+        if (regionIsUsed.size() != 2 || !regionIsUsed[0] || regionIsUsed[1])
+            OPM_THROW(std::logic_error, "Only the first PVT region is supposed to be used");
+
+        const auto& allRegionsAreUsed = Opm::eclUsedPvtRegions(allRegionsEclState, 2);
+        if (allRegionsAreUsed.size() != 2 || !allRegionsAreUsed[0] || !allRegionsAreUsed[1])
+            OPM_THROW(std::logic_error,
+                      "All PVT regions are supposed to be used if PVTNUM is not specified");
+
+        Opm::LiveOilPvt<Scalar> liveOilPvt;
+        liveOilPvt.initFromDeck(unusedRegionDeck, unusedRegionEclState);
+        if (!liveOilPvt.regionIsUsed(0) || liveOilPvt.regionIsUsed(1))
+            OPM_THROW(std::logic_error,
+                      "The live oil PVT is supposed to compute the tables of the first region only");
+
+        Opm::OilPvtMultiplexer<Scalar> thermalOilPvt;
+        thermalOilPvt.initFromDeck(unusedRegionDeck, unusedRegionEclState);
+        if (thermalOilPvt.approach() != Opm::OilPvtMultiplexer<Scalar>::ThermalOilPvt)
+            OPM_THROW(std::logic_error, "The oil PVT is supposed to be temperature dependent");
+
+        Opm::OilPvtMultiplexer<Scalar> refThermalOilPvt;
+        refThermalOilPvt.initFromDeck(allRegionsDeck, allRegionsEclState);
+
+        // the used region must behave as if all regions had their tables
+        const Scalar T = 273.15 + 50.0;
+        for (Scalar p = 2e6; p < 3e7; p *= 2) {
+            const Scalar Rs = 30.0;
+            const Scalar mu = thermalOilPvt.viscosity(/*regionIdx=*/0, T, p, Rs);
+            const Scalar refMu = refThermalOilPvt.viscosity(/*regionIdx=*/0, T, p, Rs);
+            if (!std::isfinite(mu) || mu != refMu)
+                OPM_THROW(std::logic_error,
+                          "The thermal oil viscosity at p = " << p << " is supposed to be "
+                          << refMu << ". (is " << mu << ")");
+        }
+    }
+
     // make sure that the BlackOil fluid system's initFromDeck() method compiles.
     typedef Opm::FluidSystems::BlackOil<Scalar> BlackOilFluidSystem;
     BlackOilFluidSystem::initFromDeck(deck, eclState);
+
+    // initialize a second context of the fluid system from the serialized first one
+    Opm::BinaryWriter fluidSystemWriter;
+    BlackOilFluidSystem::serialize(fluidSystemWriter);
+
+    typename BlackOilFluidSystem::Context restoredContext;
+    {
+        typename BlackOilFluidSystem::ScopedContext scopedContext(restoredContext);
+        Opm::BinaryReader reader(fluidSystemWriter.data());
+        BlackOilFluidSystem::deserialize(reader);
+    }
+
+    for (unsigned regionIdx = 0; regionIdx < numPvtRegions; ++regionIdx) {
+        for (unsigned phaseIdx = 0; phaseIdx < BlackOilFluidSystem::numPhases; ++phaseIdx) {
+            refTmp = BlackOilFluidSystem::referenceDensity(phaseIdx, regionIdx);
+
+            typename BlackOilFluidSystem::ScopedContext scopedContext(restoredContext);
+            tmp = BlackOilFluidSystem::referenceDensity(phaseIdx, regionIdx);
+            if (tmp != refTmp)
+                OPM_THROW(std::logic_error,
+                          "The deserialized reference density of phase " << phaseIdx
+                          << " is supposed to be " << refTmp << ". (is " << tmp << ")");
+        }
+    }
 }
 
 
@@ -36,6 +36,7 @@
 
 #include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
 #include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+#include <opm/material/densead/Evaluation.hpp>
 
 #include <opm/parser/eclipse/Parser/ParseContext.hpp>
 #include <opm/parser/eclipse/Parser/Parser.hpp>
@@ -47,6 +48,14 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
 // values of strings taken from the SPE1 test case1 of opm-data
 static const char* fam1DeckString =
     "RUNSPEC\n"
@@ -287,8 +296,212 @@ static const char* hysterDeckString =
     "0.85   0.98    0.000   0\n"
     "0.88   0.984   0.000   0 /\n";
 
+// a small deck with hysteresis and two saturation regions which is used to check the
+// parameter objects of well connections whose region differs from the one of the element
+static const char* hysterRegionsDeckString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   2 1 1 /\n"
+    "\n"
+    "TABDIMS\n"
+    "   2 /\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "\n"
+    "DISGAS\n"
+    "\n"
+    "METRIC\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "   2*100 /\n"
+    "DY\n"
+    "   2*100 /\n"
+    "DZ\n"
+    "   2*10 /\n"
+    "\n"
+    "TOPS\n"
+    "   2*2000 /\n"
+    "\n"
+    "EHYSTR\n"
+    "0.1   0  0.1 1* KR /\n"
+    "\n"
+    "SATOPTS\n"
+    "HYSTER /\n"
+    "\n"
+    "PROPS\n"
+    "\n"
+    "SWOF\n"
+    "0.12   0       1       2.0\n"
+    "0.3    0.05    0.6     0.8\n"
+    "0.6    0.3     0.1     0.3\n"
+    "1.0    1.0     0       0 /\n"
+    "0.2    0       1       3.0\n"
+    "0.4    0.1     0.5     1.0\n"
+    "0.7    0.4     0.05    0.2\n"
+    "1.0    0.9     0       0 /\n"
+    "\n"
+    "SGOF\n"
+    "0      0       1       0\n"
+    "0.2    0.075   0.35    0\n"
+    "0.5    0.72    0.001   0\n"
+    "0.88   0.984   0       0 /\n"
+    "0      0       1       0\n"
+    "0.1    0.05    0.5     0\n"
+    "0.4    0.6     0.01    0\n"
+    "0.8    0.9     0       0 /\n"
+    "\n"
+    "REGIONS\n"
+    "\n"
+    "SATNUM\n"
+    "   1 2 /\n";
+
+// a small deck which uses the Leverett J-function to scale the capillary pressure. the
+// porosity is passed in to be able to compare against decks with modified porosities.
+static std::string jfuncDeckString(const std::string& poroValues)
+{
+    return
+        "RUNSPEC\n"
+        "\n"
+        "DIMENS\n"
+        "   2 2 1 /\n"
+        "\n"
+        "TABDIMS\n"
+        "/\n"
+        "\n"
+        "OIL\n"
+        "GAS\n"
+        "WATER\n"
+        "\n"
+        "ENDSCALE\n"
+        "/\n"
+        "\n"
+        "METRIC\n"
+        "\n"
+        "GRID\n"
+        "\n"
+        "DX\n"
+        "   4*100 /\n"
+        "DY\n"
+        "   4*100 /\n"
+        "DZ\n"
+        "   4*10 /\n"
+        "\n"
+        "TOPS\n"
+        "   4*2000 /\n"
+        "\n"
+        "PERMX\n"
+        "   100 200 300 400 /\n"
+        "PERMY\n"
+        "   100 250 300 450 /\n"
+        "\n"
+        "PORO\n"
+        "   " + poroValues + " /\n"
+        "\n"
+        "JFUNC\n"
+        "   WATER 25.0 /\n"
+        "\n"
+        "PROPS\n"
+        "\n"
+        "SWOF\n"
+        "0.12   0       1       2.0\n"
+        "0.3    0.05    0.6     0.8\n"
+        "0.6    0.3     0.1     0.3\n"
+        "1.0    1.0     0       0 /\n"
+        "\n"
+        "SGOF\n"
+        "0      0       1       0\n"
+        "0.2    0.075   0.35    0\n"
+        "0.5    0.72    0.001   0\n"
+        "0.88   0.984   0       0 /\n";
+}
+
 
 
+// the parameters of the elements are initialized concurrently if OpenMP is available.
+// the result must be identical to the one of the serial initialization, regardless of
+// the number of threads and of the mapping of the elements to the threads.
+template <class MaterialLawManager, class FluidState>
+void checkParallelInitialization(const Opm::Deck& deck,
+                                 const Opm::EclipseState& eclState,
+                                 const std::vector<int>& compressedToCartesianIdx)
+{
+#ifdef _OPENMP
+    typedef typename MaterialLawManager::MaterialLaw MaterialLaw;
+    typedef typename MaterialLaw::Scalar Scalar;
+    enum { numPhases = 3 };
+
+    const unsigned n = static_cast<unsigned>(compressedToCartesianIdx.size());
+    const int maxThreads = omp_get_max_threads();
+
+    omp_set_num_threads(1);
+    MaterialLawManager serialManager;
+    serialManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+
+    omp_set_num_threads(std::max(maxThreads, 4));
+    MaterialLawManager parallelManager;
+    parallelManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+
+    std::vector<unsigned> threadOfElem(n);
+    for (unsigned elemIdx = 0; elemIdx < n; ++elemIdx)
+        threadOfElem[elemIdx] = (7*elemIdx) % 5;
+    MaterialLawManager mappedManager;
+    mappedManager.setElementThreadMapping(threadOfElem);
+    mappedManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+
+    omp_set_num_threads(maxThreads);
+
+    const MaterialLawManager& constSerialManager = serialManager;
+    const MaterialLawManager* managers[] = { &parallelManager, &mappedManager };
+    for (const MaterialLawManager* manager : managers) {
+        for (unsigned elemIdx = 0; elemIdx < n; ++elemIdx) {
+            // the same elements share their parameter objects
+            if (elemIdx > 0) {
+                bool serialShared =
+                    &constSerialManager.materialLawParams(elemIdx) == &constSerialManager.materialLawParams(elemIdx - 1);
+                bool parallelShared =
+                    &manager->materialLawParams(elemIdx) == &manager->materialLawParams(elemIdx - 1);
+                if (serialShared != parallelShared)
+                    OPM_THROW(std::logic_error,
+                              "The parameters of element " << elemIdx << " are shared differently "
+                              "by the serial and the parallel initialization");
+            }
+
+            for (int i = 0; i < 11; ++i) {
+                FluidState fs;
+                Scalar Sw = Scalar(i)/10;
+                Scalar Sg = (1 - Sw)/3;
+                fs.setSaturation(0, Sw);
+                fs.setSaturation(1, 1 - Sw - Sg);
+                fs.setSaturation(2, Sg);
+
+                Scalar kr[2][numPhases];
+                Scalar pc[2][numPhases];
+                MaterialLaw::relativePermeabilities(kr[0], constSerialManager.materialLawParams(elemIdx), fs);
+                MaterialLaw::relativePermeabilities(kr[1], manager->materialLawParams(elemIdx), fs);
+                MaterialLaw::capillaryPressures(pc[0], constSerialManager.materialLawParams(elemIdx), fs);
+                MaterialLaw::capillaryPressures(pc[1], manager->materialLawParams(elemIdx), fs);
+
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                    if (kr[0][phaseIdx] != kr[1][phaseIdx] || pc[0][phaseIdx] != pc[1][phaseIdx])
+                        OPM_THROW(std::logic_error,
+                                  "The saturation functions of element " << elemIdx << " differ "
+                                  "between the serial and the parallel initialization");
+            }
+        }
+    }
+#else
+    // the initialization is always serial
+    (void) deck;
+    (void) eclState;
+    (void) compressedToCartesianIdx;
+#endif
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -333,6 +546,10 @@ inline void testAll()
 
         MaterialLawManager materialLawManager;
         materialLawManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+        // the saturation functions are evaluated using the const parameter objects,
+        // which are shared by the elements with identical end points
+        const MaterialLawManager& constMaterialLawManager = materialLawManager;
+        checkParallelInitialization<MaterialLawManager, FluidState>(deck, eclState, compressedToCartesianIdx);
 
         if (materialLawManager.enableEndPointScaling())
             OPM_THROW(std::logic_error,
@@ -342,6 +559,40 @@ inline void testAll()
             OPM_THROW(std::logic_error,
                       "Discrepancy between the deck and the EclMaterialLawManager");
 
+        // the deck neither uses end-point scaling nor hysteresis, so a manager whose
+        // material laws do not contain the respective layers must yield the same
+        // saturation functions
+        {
+            typedef Opm::EclMaterialLawManager<MaterialTraits, Scalar,
+                                               /*enableEpsLayer=*/false,
+                                               /*enableHysteresisLayer=*/false> SlimMaterialLawManager;
+            typedef typename SlimMaterialLawManager::MaterialLaw SlimMaterialLaw;
+
+            SlimMaterialLawManager slimMaterialLawManager;
+            slimMaterialLawManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                for (int i = 0; i <= 10; ++ i) {
+                    FluidState fs;
+                    fs.setSaturation(waterPhaseIdx, Scalar(i)/10);
+                    fs.setSaturation(oilPhaseIdx, Scalar(10 - i)/20);
+                    fs.setSaturation(gasPhaseIdx, Scalar(10 - i)/20);
+
+                    Scalar kr[2][numPhases];
+                    Scalar pc[2][numPhases];
+                    MaterialLaw::relativePermeabilities(kr[0], constMaterialLawManager.materialLawParams(elemIdx), fs);
+                    SlimMaterialLaw::relativePermeabilities(kr[1], slimMaterialLawManager.materialLawParams(elemIdx), fs);
+                    MaterialLaw::capillaryPressures(pc[0], constMaterialLawManager.materialLawParams(elemIdx), fs);
+                    SlimMaterialLaw::capillaryPressures(pc[1], slimMaterialLawManager.materialLawParams(elemIdx), fs);
+                    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                        if (kr[0][phaseIdx] != kr[1][phaseIdx] || pc[0][phaseIdx] != pc[1][phaseIdx])
+                            OPM_THROW(std::logic_error,
+                                      "Discrepancy between the saturation functions of the "
+                                      "full and the slim material law managers");
+                }
+            }
+        }
+
         const auto fam2Deck = parser.parseString(fam2DeckString, parseContext);
         const Opm::EclipseState fam2EclState(fam2Deck, parseContext);
 
@@ -361,6 +612,7 @@ inline void testAll()
 
         Opm::EclMaterialLawManager<MaterialTraits> hysterMaterialLawManager;
         hysterMaterialLawManager.initFromDeck(hysterDeck, hysterEclState, compressedToCartesianIdx);
+        checkParallelInitialization<MaterialLawManager, FluidState>(hysterDeck, hysterEclState, compressedToCartesianIdx);
 
         if (hysterMaterialLawManager.enableEndPointScaling())
             OPM_THROW(std::logic_error,
@@ -370,6 +622,73 @@ inline void testAll()
             OPM_THROW(std::logic_error,
                       "Discrepancy between the deck and the EclMaterialLawManager");
 
+        // a manager without the hysteresis layer must refuse a deck which uses it
+        {
+            Opm::EclMaterialLawManager<MaterialTraits, Scalar,
+                                       /*enableEpsLayer=*/true,
+                                       /*enableHysteresisLayer=*/false> slimMaterialLawManager;
+            bool refused = false;
+            try {
+                slimMaterialLawManager.initFromDeck(hysterDeck, hysterEclState, compressedToCartesianIdx);
+            }
+            catch (const std::runtime_error&) {
+                refused = true;
+            }
+            if (!refused)
+                OPM_THROW(std::logic_error,
+                          "A material law manager without the hysteresis layer accepted a "
+                          "deck which uses hysteresis");
+        }
+
+        // make sure that initializing the parameters of a subset of the elements from
+        // distributed grid properties yields the same saturation functions
+        {
+            const auto& props = hysterEclState.get3DProperties();
+            const auto& globalSatnum = props.getIntGridProperty("SATNUM").getData();
+            const auto& globalImbnum = props.getIntGridProperty("IMBNUM").getData();
+            std::vector<unsigned> localToGlobalIdx;
+            std::vector<int> localSatnum;
+            std::vector<int> localImbnum;
+            for (unsigned elemIdx = 1; elemIdx < n; elemIdx += 2) {
+                localToGlobalIdx.push_back(elemIdx);
+                localSatnum.push_back(globalSatnum[elemIdx]);
+                localImbnum.push_back(globalImbnum[elemIdx]);
+            }
+
+            Opm::EclEpsGridProperties localProps;
+            Opm::EclEpsGridProperties localImbProps;
+            localProps.satnum = &localSatnum;
+            localImbProps.satnum = &localImbnum;
+
+            MaterialLawManager localMaterialLawManager;
+            localMaterialLawManager.initFromElementProperties(hysterDeck,
+                                                              hysterEclState,
+                                                              localProps,
+                                                              localImbProps);
+
+            for (unsigned localIdx = 0; localIdx < localToGlobalIdx.size(); ++ localIdx) {
+                unsigned elemIdx = localToGlobalIdx[localIdx];
+                for (int i = 0; i <= 10; ++ i) {
+                    FluidState fs;
+                    fs.setSaturation(waterPhaseIdx, Scalar(i)/10);
+                    fs.setSaturation(oilPhaseIdx, Scalar(10 - i)/20);
+                    fs.setSaturation(gasPhaseIdx, Scalar(10 - i)/20);
+
+                    Scalar kr[2][numPhases];
+                    Scalar pc[2][numPhases];
+                    MaterialLaw::relativePermeabilities(kr[0], hysterMaterialLawManager.materialLawParams(elemIdx), fs);
+                    MaterialLaw::relativePermeabilities(kr[1], localMaterialLawManager.materialLawParams(localIdx), fs);
+                    MaterialLaw::capillaryPressures(pc[0], hysterMaterialLawManager.materialLawParams(elemIdx), fs);
+                    MaterialLaw::capillaryPressures(pc[1], localMaterialLawManager.materialLawParams(localIdx), fs);
+                    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                        if (kr[0][phaseIdx] != kr[1][phaseIdx] || pc[0][phaseIdx] != pc[1][phaseIdx])
+                            OPM_THROW(std::logic_error,
+                                      "Discrepancy between the saturation functions initialized "
+                                      "from global and from distributed grid properties");
+                }
+            }
+        }
+
 
 
         // make sure that the saturation functions for both keyword families are
@@ -388,7 +707,7 @@ inline void testAll()
                     Scalar pcFam1[numPhases]  = { 0.0, 0.0 };
                     Scalar pcFam2[numPhases]  = { 0.0, 0.0 };
                     MaterialLaw::capillaryPressures(pcFam1,
-                                                    materialLawManager.materialLawParams(elemIdx),
+                                                    constMaterialLawManager.materialLawParams(elemIdx),
                                                     fs);
                     MaterialLaw::capillaryPressures(pcFam2,
                                                     fam2MaterialLawManager.materialLawParams(elemIdx),
@@ -397,7 +716,7 @@ inline void testAll()
                     Scalar krFam1[numPhases] = { 0.0, 0.0 };
                     Scalar krFam2[numPhases] = { 0.0, 0.0 };
                     MaterialLaw::relativePermeabilities(krFam1,
-                                                        materialLawManager.materialLawParams(elemIdx),
+                                                        constMaterialLawManager.materialLawParams(elemIdx),
                                                         fs);
                     MaterialLaw::relativePermeabilities(krFam2,
                                                         fam2MaterialLawManager.materialLawParams(elemIdx),
@@ -450,6 +769,560 @@ inline void testAll()
                 }
             }
         }
+
+        // make sure that the range-wise hysteresis update reports the updated elements
+        // and that repeating it with the same saturations does not change anything
+        std::vector<FluidState> hysterFluidStates(n);
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            hysterFluidStates[elemIdx].setSaturation(waterPhaseIdx, 0.3);
+            hysterFluidStates[elemIdx].setSaturation(oilPhaseIdx, 0.5);
+            hysterFluidStates[elemIdx].setSaturation(gasPhaseIdx, 0.2);
+        }
+        std::vector<unsigned> updatedElems;
+        unsigned numUpdated =
+            hysterMaterialLawManager.updateHysteresis(hysterFluidStates,
+                                                      0, static_cast<unsigned>(n),
+                                                      &updatedElems);
+        if (numUpdated != updatedElems.size())
+            OPM_THROW(std::logic_error,
+                      "Inconsistent number of elements with updated hysteresis parameters");
+        if (hysterMaterialLawManager.updateHysteresis(hysterFluidStates, 0, static_cast<unsigned>(n)) != 0)
+            OPM_THROW(std::logic_error,
+                      "Repeating the hysteresis update must not modify the scanning curves");
+
+        // make sure that restoring a saved hysteresis state reverts the scanning curves
+        typename MaterialLawManager::HysteresisState hysterState;
+        hysterMaterialLawManager.saveHysteresisState(hysterState);
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            hysterFluidStates[elemIdx].setSaturation(waterPhaseIdx, 0.1);
+            hysterFluidStates[elemIdx].setSaturation(oilPhaseIdx, 0.5);
+            hysterFluidStates[elemIdx].setSaturation(gasPhaseIdx, 0.4);
+        }
+        hysterMaterialLawManager.updateHysteresis(hysterFluidStates, 0, static_cast<unsigned>(n));
+        hysterMaterialLawManager.restoreHysteresisState(hysterState);
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            Scalar pcSwMdc;
+            Scalar krnSwMdc;
+            hysterMaterialLawManager.oilWaterHysteresisParams(pcSwMdc, krnSwMdc, elemIdx);
+            if (pcSwMdc != hysterState.oilWaterPcSwMdc[elemIdx]
+                || krnSwMdc != hysterState.oilWaterKrnSwMdc[elemIdx])
+                OPM_THROW(std::logic_error,
+                          "Restoring the oil-water hysteresis state failed");
+
+            hysterMaterialLawManager.gasOilHysteresisParams(pcSwMdc, krnSwMdc, elemIdx);
+            if (pcSwMdc != hysterState.gasOilPcSwMdc[elemIdx]
+                || krnSwMdc != hysterState.gasOilKrnSwMdc[elemIdx])
+                OPM_THROW(std::logic_error,
+                          "Restoring the gas-oil hysteresis state failed");
+        }
+
+        // make sure that re-reading unchanged saturation regions from the deck neither
+        // modifies the saturation functions nor the hysteresis state of the elements
+        std::vector<unsigned> allSatRegions;
+        for (unsigned satRegionIdx = 0; satRegionIdx < hysterMaterialLawManager.numSatnumRegions(); ++satRegionIdx)
+            allSatRegions.push_back(satRegionIdx);
+
+        FluidState updateFs;
+        updateFs.setSaturation(waterPhaseIdx, 0.4);
+        updateFs.setSaturation(oilPhaseIdx, 0.4);
+        updateFs.setSaturation(gasPhaseIdx, 0.2);
+        std::vector<Scalar> krBeforeUpdate(n*numPhases);
+        std::vector<Scalar> pcBeforeUpdate(n*numPhases);
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            Scalar kr[numPhases];
+            Scalar pc[numPhases];
+            const auto& params = hysterMaterialLawManager.materialLawParams(elemIdx);
+            MaterialLaw::relativePermeabilities(kr, params, updateFs);
+            MaterialLaw::capillaryPressures(pc, params, updateFs);
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                krBeforeUpdate[elemIdx*numPhases + phaseIdx] = kr[phaseIdx];
+                pcBeforeUpdate[elemIdx*numPhases + phaseIdx] = pc[phaseIdx];
+            }
+        }
+
+        if (hysterMaterialLawManager.updateSatRegionsFromDeck(hysterDeck, hysterEclState,
+                                                              compressedToCartesianIdx,
+                                                              allSatRegions) != n)
+            OPM_THROW(std::logic_error,
+                      "Updating all saturation regions must re-initialize all elements");
+
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            Scalar pcSwMdc;
+            Scalar krnSwMdc;
+            hysterMaterialLawManager.oilWaterHysteresisParams(pcSwMdc, krnSwMdc, elemIdx);
+            if (pcSwMdc != hysterState.oilWaterPcSwMdc[elemIdx]
+                || krnSwMdc != hysterState.oilWaterKrnSwMdc[elemIdx])
+                OPM_THROW(std::logic_error,
+                          "Updating the saturation regions did not retain the hysteresis state");
+
+            Scalar kr[numPhases];
+            Scalar pc[numPhases];
+            const auto& params = hysterMaterialLawManager.materialLawParams(elemIdx);
+            MaterialLaw::relativePermeabilities(kr, params, updateFs);
+            MaterialLaw::capillaryPressures(pc, params, updateFs);
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                if (kr[phaseIdx] != krBeforeUpdate[elemIdx*numPhases + phaseIdx]
+                    || pc[phaseIdx] != pcBeforeUpdate[elemIdx*numPhases + phaseIdx])
+                    OPM_THROW(std::logic_error,
+                              "Updating unchanged saturation regions modified the saturation functions");
+        }
+
+        // make sure that a serialized manager yields the same saturation functions and
+        // hysteresis state, also if only a subset of the elements is written
+        Opm::BinaryWriter hysterWriter;
+        hysterMaterialLawManager.serialize(hysterWriter);
+        MaterialLawManager restoredMaterialLawManager;
+        Opm::BinaryReader hysterReader(hysterWriter.data());
+        restoredMaterialLawManager.deserialize(hysterReader);
+
+        std::vector<unsigned> partitionElemIndices;
+        for (unsigned elemIdx = 1; elemIdx < n; elemIdx += 2)
+            partitionElemIndices.push_back(elemIdx);
+        Opm::BinaryWriter partitionWriter;
+        hysterMaterialLawManager.serialize(partitionWriter, partitionElemIndices);
+        MaterialLawManager partitionMaterialLawManager;
+        Opm::BinaryReader partitionReader(partitionWriter.data());
+        partitionMaterialLawManager.deserialize(partitionReader);
+
+        if (!hysterReader.atEnd() || !partitionReader.atEnd()
+            || restoredMaterialLawManager.enableHysteresis() != true)
+            OPM_THROW(std::logic_error,
+                      "Discrepancy between the serialized and the original EclMaterialLawManager");
+
+        for (unsigned localElemIdx = 0; localElemIdx < partitionElemIndices.size(); ++ localElemIdx) {
+            unsigned elemIdx = partitionElemIndices[localElemIdx];
+            const auto& params = hysterMaterialLawManager.materialLawParams(elemIdx);
+            const auto& restoredParams = restoredMaterialLawManager.materialLawParams(elemIdx);
+            const auto& partitionParams = partitionMaterialLawManager.materialLawParams(localElemIdx);
+
+            Scalar pcSwMdc[3];
+            Scalar krnSwMdc[3];
+            hysterMaterialLawManager.oilWaterHysteresisParams(pcSwMdc[0], krnSwMdc[0], elemIdx);
+            restoredMaterialLawManager.oilWaterHysteresisParams(pcSwMdc[1], krnSwMdc[1], elemIdx);
+            partitionMaterialLawManager.oilWaterHysteresisParams(pcSwMdc[2], krnSwMdc[2], localElemIdx);
+            if (pcSwMdc[0] != pcSwMdc[1] || pcSwMdc[0] != pcSwMdc[2]
+                || krnSwMdc[0] != krnSwMdc[1] || krnSwMdc[0] != krnSwMdc[2])
+                OPM_THROW(std::logic_error,
+                          "Restoring the hysteresis state of a serialized EclMaterialLawManager failed");
+
+            for (int i = 0; i <= 10; ++ i) {
+                FluidState fs;
+                fs.setSaturation(waterPhaseIdx, Scalar(i)/10);
+                fs.setSaturation(oilPhaseIdx, Scalar(10 - i)/20);
+                fs.setSaturation(gasPhaseIdx, Scalar(10 - i)/20);
+
+                Scalar kr[3][numPhases];
+                Scalar pc[3][numPhases];
+                MaterialLaw::relativePermeabilities(kr[0], params, fs);
+                MaterialLaw::relativePermeabilities(kr[1], restoredParams, fs);
+                MaterialLaw::relativePermeabilities(kr[2], partitionParams, fs);
+                MaterialLaw::capillaryPressures(pc[0], params, fs);
+                MaterialLaw::capillaryPressures(pc[1], restoredParams, fs);
+                MaterialLaw::capillaryPressures(pc[2], partitionParams, fs);
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                    if (kr[0][phaseIdx] != kr[1][phaseIdx] || kr[0][phaseIdx] != kr[2][phaseIdx]
+                        || pc[0][phaseIdx] != pc[1][phaseIdx] || pc[0][phaseIdx] != pc[2][phaseIdx])
+                        OPM_THROW(std::logic_error,
+                                  "Discrepancy between the saturation functions of a serialized "
+                                  "and the original EclMaterialLawManager");
+                }
+            }
+        }
+
+        // make sure that the range-wise evaluation of the saturation functions yields
+        // the same results as the evaluation of the individual elements
+        std::vector<Scalar> satValues[numPhases];
+        std::vector<Scalar> krValues[numPhases];
+        std::vector<Scalar> pcValues[numPhases];
+        const Scalar* satPtrs[numPhases];
+        Scalar* krPtrs[numPhases];
+        Scalar* pcPtrs[numPhases];
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            satValues[phaseIdx].resize(n);
+            krValues[phaseIdx].resize(n);
+            pcValues[phaseIdx].resize(n);
+            satPtrs[phaseIdx] = satValues[phaseIdx].data();
+            krPtrs[phaseIdx] = krValues[phaseIdx].data();
+            pcPtrs[phaseIdx] = pcValues[phaseIdx].data();
+        }
+
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            Scalar Sw = Scalar(elemIdx % 10)/10;
+            Scalar Sg = Scalar(elemIdx % 7)/10;
+            satValues[waterPhaseIdx][elemIdx] = Sw;
+            satValues[gasPhaseIdx][elemIdx] = Sg;
+            satValues[oilPhaseIdx][elemIdx] = 1 - Sw - Sg;
+        }
+
+        materialLawManager.relativePermeabilities(krPtrs, satPtrs, 0, static_cast<unsigned>(n));
+        materialLawManager.capillaryPressures(pcPtrs, satPtrs, 0, static_cast<unsigned>(n));
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            FluidState fs;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                fs.setSaturation(phaseIdx, satValues[phaseIdx][elemIdx]);
+
+            Scalar pc[numPhases];
+            Scalar kr[numPhases];
+            MaterialLaw::capillaryPressures(pc, constMaterialLawManager.materialLawParams(elemIdx), fs);
+            MaterialLaw::relativePermeabilities(kr, constMaterialLawManager.materialLawParams(elemIdx), fs);
+
+            Scalar pcCombined[numPhases];
+            Scalar krCombined[numPhases];
+            MaterialLaw::capillaryPressuresAndRelativePermeabilities(pcCombined,
+                                                                     krCombined,
+                                                                     constMaterialLawManager.materialLawParams(elemIdx),
+                                                                     fs);
+
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                if (pc[phaseIdx] != pcValues[phaseIdx][elemIdx])
+                    OPM_THROW(std::logic_error,
+                              "Discrepancy between range-wise and element-wise capillary pressures");
+                if (kr[phaseIdx] != krValues[phaseIdx][elemIdx])
+                    OPM_THROW(std::logic_error,
+                              "Discrepancy between range-wise and element-wise relative permeabilities");
+                if (pc[phaseIdx] != pcCombined[phaseIdx] || kr[phaseIdx] != krCombined[phaseIdx])
+                    OPM_THROW(std::logic_error,
+                              "Discrepancy between the combined and the individual evaluation "
+                              "of the saturation functions");
+            }
+        }
+
+        // the value-only evaluation of saturations which exhibit derivatives yields
+        // the results of the scalar evaluation, and these are the values of the
+        // full evaluation
+        {
+            typedef Opm::DenseAd::Evaluation<Scalar, numPhases> Evaluation;
+
+            std::vector<Evaluation> satEvals[numPhases];
+            std::vector<Evaluation> krEvals[numPhases];
+            std::vector<Scalar> krValueOnly[numPhases];
+            std::vector<Scalar> pcValueOnly[numPhases];
+            const Evaluation* satEvalPtrs[numPhases];
+            Evaluation* krEvalPtrs[numPhases];
+            Scalar* krValueOnlyPtrs[numPhases];
+            Scalar* pcValueOnlyPtrs[numPhases];
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                satEvals[phaseIdx].resize(n);
+                for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx)
+                    satEvals[phaseIdx][elemIdx] =
+                        Evaluation::createVariable(satValues[phaseIdx][elemIdx], phaseIdx);
+                krEvals[phaseIdx].resize(n);
+                krValueOnly[phaseIdx].resize(n);
+                pcValueOnly[phaseIdx].resize(n);
+                satEvalPtrs[phaseIdx] = satEvals[phaseIdx].data();
+                krEvalPtrs[phaseIdx] = krEvals[phaseIdx].data();
+                krValueOnlyPtrs[phaseIdx] = krValueOnly[phaseIdx].data();
+                pcValueOnlyPtrs[phaseIdx] = pcValueOnly[phaseIdx].data();
+            }
+
+            materialLawManager.relativePermeabilities(krEvalPtrs, satEvalPtrs, 0, static_cast<unsigned>(n));
+            materialLawManager.relativePermeabilities(krValueOnlyPtrs, satEvalPtrs, 0, static_cast<unsigned>(n));
+            materialLawManager.capillaryPressures(pcValueOnlyPtrs, satEvalPtrs, 0, static_cast<unsigned>(n));
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                    if (krValueOnly[phaseIdx][elemIdx] != krValues[phaseIdx][elemIdx]
+                        || pcValueOnly[phaseIdx][elemIdx] != pcValues[phaseIdx][elemIdx])
+                        OPM_THROW(std::logic_error,
+                                  "Discrepancy between the value-only and the scalar evaluation "
+                                  "of the saturation functions");
+                    if (std::abs(krValueOnly[phaseIdx][elemIdx] - krEvals[phaseIdx][elemIdx].value()) > 1e-5)
+                        OPM_THROW(std::logic_error,
+                                  "Discrepancy between the value-only and the full evaluation "
+                                  "of the relative permeabilities");
+                }
+            }
+        }
+
+        // the same applies to the evaluation of the elements in the order of their
+        // saturation regions
+        std::vector<Scalar> regionKrValues[numPhases];
+        std::vector<Scalar> regionPcValues[numPhases];
+        Scalar* regionKrPtrs[numPhases];
+        Scalar* regionPcPtrs[numPhases];
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            regionKrValues[phaseIdx].resize(n);
+            regionPcValues[phaseIdx].resize(n);
+            regionKrPtrs[phaseIdx] = regionKrValues[phaseIdx].data();
+            regionPcPtrs[phaseIdx] = regionPcValues[phaseIdx].data();
+        }
+
+        if (materialLawManager.satnumRegionOrder().size() != n)
+            OPM_THROW(std::logic_error, "The saturation region order does not contain all elements");
+        for (unsigned satRegionIdx = 0; satRegionIdx < materialLawManager.numSatnumRegions(); ++satRegionIdx) {
+            const unsigned* elemIdxBegin = materialLawManager.satnumRegionElemsBegin(satRegionIdx);
+            const unsigned* elemIdxEnd = materialLawManager.satnumRegionElemsEnd(satRegionIdx);
+            for (const unsigned* elemIdxIt = elemIdxBegin; elemIdxIt != elemIdxEnd; ++elemIdxIt)
+                if (materialLawManager.satnumRegionIdx(*elemIdxIt) != static_cast<int>(satRegionIdx))
+                    OPM_THROW(std::logic_error, "Element " << *elemIdxIt << " is sorted into the wrong saturation region");
+
+            materialLawManager.relativePermeabilitiesOfElements(regionKrPtrs, satPtrs, elemIdxBegin, elemIdxEnd);
+            materialLawManager.capillaryPressuresOfElements(regionPcPtrs, satPtrs, elemIdxBegin, elemIdxEnd);
+        }
+
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx)
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                if (krValues[phaseIdx][elemIdx] != regionKrValues[phaseIdx][elemIdx]
+                    || pcValues[phaseIdx][elemIdx] != regionPcValues[phaseIdx][elemIdx])
+                    OPM_THROW(std::logic_error,
+                              "Discrepancy between the range-wise and the region-wise evaluation "
+                              "of the saturation functions");
+
+        // none of the elements exhibits scaled end points, so all of them can use the
+        // tabulated oil relperm of their region. the other quantities stay the same.
+        const Scalar kroTolerance = 1e-2;
+        if (materialLawManager.tabulateThreePhaseKro(kroTolerance) != static_cast<unsigned>(n))
+            OPM_THROW(std::logic_error, "The oil relperm was not tabulated for all elements");
+
+        materialLawManager.relativePermeabilities(regionKrPtrs, satPtrs, 0, static_cast<unsigned>(n));
+        materialLawManager.capillaryPressures(regionPcPtrs, satPtrs, 0, static_cast<unsigned>(n));
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                if (pcValues[phaseIdx][elemIdx] != regionPcValues[phaseIdx][elemIdx]
+                    || (phaseIdx != oilPhaseIdx && krValues[phaseIdx][elemIdx] != regionKrValues[phaseIdx][elemIdx]))
+                    OPM_THROW(std::logic_error,
+                              "The tabulation of the oil relperm modified the other saturation functions");
+            }
+
+            if (std::abs(krValues[oilPhaseIdx][elemIdx] - regionKrValues[oilPhaseIdx][elemIdx]) > 4*kroTolerance)
+                OPM_THROW(std::logic_error,
+                          "The tabulated oil relperm of element " << elemIdx << " deviates from the exact one");
+        }
+
+        // the elements of a saturation region whose end points are identical share their
+        // parameter objects. modifying the scaling points of one of them gives it a copy
+        // of its own and leaves the other ones untouched
+        {
+            const auto& constManager = materialLawManager;
+            auto oilWaterScaledPoints = [&constManager](unsigned elemIdx) -> const typename MaterialLawManager::ScalingPoints& {
+                const auto& realParams =
+                    constManager.materialLawParams(elemIdx).template getRealParams<Opm::EclDefaultApproach>();
+                return realParams.oilWaterParams().drainageParams().scaledPoints();
+            };
+
+            if (&constManager.materialLawParams(0) != &constManager.materialLawParams(1)
+                || &constManager.materialLawParams(1) != &constManager.materialLawParams(2))
+                OPM_THROW(std::logic_error, "Elements with identical end points do not share their parameters");
+
+            const Scalar origMaxKrw = oilWaterScaledPoints(1).maxKrw();
+            materialLawManager.oilWaterScaledEpsPointsDrainage(0).setMaxKrw(origMaxKrw/2);
+
+            if (&constManager.materialLawParams(0) == &constManager.materialLawParams(1))
+                OPM_THROW(std::logic_error, "Modifying the scaling points did not unshare the parameters");
+            if (&constManager.materialLawParams(1) != &constManager.materialLawParams(2))
+                OPM_THROW(std::logic_error, "Modifying the scaling points unshared the parameters of other elements");
+            if (oilWaterScaledPoints(0).maxKrw() != origMaxKrw/2
+                || oilWaterScaledPoints(1).maxKrw() != origMaxKrw
+                || oilWaterScaledPoints(2).maxKrw() != origMaxKrw)
+                OPM_THROW(std::logic_error,
+                          "Modifying the scaling points of an element affected the elements which shared them");
+
+            // the same applies to the mutable parameter objects
+            const auto* sharedParams = &constManager.materialLawParams(2);
+            if (&materialLawManager.materialLawParams(1) == sharedParams)
+                OPM_THROW(std::logic_error, "The mutable parameters of an element are shared with other elements");
+            if (&constManager.materialLawParams(2) != sharedParams)
+                OPM_THROW(std::logic_error, "Accessing the mutable parameters unshared the ones of other elements");
+            if (materialLawManager.materialLawParamsPointerReferenceHack(2).get() == &constManager.materialLawParams(3))
+                OPM_THROW(std::logic_error, "The mutable parameter pointer of an element is shared with other elements");
+
+            for (unsigned elemIdx = 1; elemIdx < n; ++ elemIdx) {
+                FluidState fs;
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                    fs.setSaturation(phaseIdx, satValues[phaseIdx][elemIdx]);
+
+                Scalar pc[numPhases];
+                MaterialLaw::capillaryPressures(pc, constManager.materialLawParams(elemIdx), fs);
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                    if (pc[phaseIdx] != pcValues[phaseIdx][elemIdx])
+                        OPM_THROW(std::logic_error,
+                                  "Modifying the scaling points of an element changed the saturation "
+                                  "functions of element " << elemIdx);
+            }
+        }
+    }
+    // updating the Leverett factors after a change of the porosity must yield the same
+    // capillary pressures as initializing the saturation functions with the new porosity
+    // in the first place
+    {
+        typedef Opm::EclMaterialLawManager<MaterialTraits> MaterialLawManager;
+        typedef typename MaterialLawManager::MaterialLaw MaterialLaw;
+
+        const auto deck = parser.parseString(jfuncDeckString("0.1 0.2 0.25 0.3"), parseContext);
+        const Opm::EclipseState eclState(deck, parseContext);
+        const auto newDeck = parser.parseString(jfuncDeckString("0.1 0.15 0.25 0.35"), parseContext);
+        const Opm::EclipseState newEclState(newDeck, parseContext);
+
+        size_t n = eclState.getInputGrid().getCartesianSize();
+        std::vector<int> compressedToCartesianIdx(n);
+        for (size_t i = 0; i < n; ++ i)
+            compressedToCartesianIdx[i] = static_cast<int>(i);
+
+        MaterialLawManager materialLawManager;
+        materialLawManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+        MaterialLawManager newMaterialLawManager;
+        newMaterialLawManager.initFromDeck(newDeck, newEclState, compressedToCartesianIdx);
+        checkParallelInitialization<MaterialLawManager, FluidState>(deck, eclState, compressedToCartesianIdx);
+
+        if (!materialLawManager.enableEndPointScaling())
+            OPM_THROW(std::logic_error,
+                      "Discrepancy between the deck and the EclMaterialLawManager");
+
+        std::vector<Scalar> newPorosity = { 0.1, 0.15, 0.25, 0.35 };
+        if (materialLawManager.updateLeverettFactors(newPorosity) != 2)
+            OPM_THROW(std::logic_error,
+                      "The Leverett factors were not updated for exactly the elements "
+                      "whose porosity changed");
+
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            for (int i = 0; i < 20; ++ i) {
+                Scalar Sw = 0.12 + (1.0 - 0.12)*i/19.0;
+                FluidState fs;
+                fs.setSaturation(waterPhaseIdx, Sw);
+                fs.setSaturation(oilPhaseIdx, 1.0 - Sw);
+                fs.setSaturation(gasPhaseIdx, 0.0);
+
+                Scalar pc[numPhases];
+                Scalar newPc[numPhases];
+                MaterialLaw::capillaryPressures(pc, materialLawManager.materialLawParams(elemIdx), fs);
+                MaterialLaw::capillaryPressures(newPc, newMaterialLawManager.materialLawParams(elemIdx), fs);
+
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                    if (std::abs(pc[phaseIdx] - newPc[phaseIdx]) > 1e-4*std::max<Scalar>(1.0, std::abs(newPc[phaseIdx])))
+                        OPM_THROW(std::logic_error,
+                                  "The capillary pressure of element " << elemIdx << " after "
+                                  "updating the Leverett factors differs from the one obtained "
+                                  "by initializing with the new porosity");
+            }
+        }
+    }
+
+    // the parameter objects of well connections whose saturation region differs from
+    // the one of their element must be pre-computed, and with hysteresis, their
+    // scanning curves must follow the ones of the element
+    {
+        typedef Opm::EclMaterialLawManager<MaterialTraits> MaterialLawManager;
+        typedef typename MaterialLawManager::MaterialLaw MaterialLaw;
+
+        const auto deck = parser.parseString(hysterRegionsDeckString, parseContext);
+        const Opm::EclipseState eclState(deck, parseContext);
+
+        size_t n = eclState.getInputGrid().getCartesianSize();
+        std::vector<int> compressedToCartesianIdx(n);
+        for (size_t i = 0; i < n; ++ i)
+            compressedToCartesianIdx[i] = static_cast<int>(i);
+
+        MaterialLawManager materialLawManager;
+        materialLawManager.initFromDeck(deck, eclState, compressedToCartesianIdx);
+
+        if (!materialLawManager.enableHysteresis() || materialLawManager.numSatnumRegions() != 2)
+            OPM_THROW(std::logic_error,
+                      "Discrepancy between the deck and the EclMaterialLawManager");
+
+        // the connections of each element to the region of the other one and a
+        // connection to the element's own region
+        const std::vector<std::pair<unsigned, unsigned> > connections = { {0, 1}, {1, 0}, {1, 1} };
+
+        bool hasThrown = false;
+        try {
+            materialLawManager.connectionMaterialLawParams(/*satRegionIdx=*/1, /*elemIdx=*/0);
+        }
+        catch (const std::logic_error&) {
+            hasThrown = true;
+        }
+        if (!hasThrown)
+            OPM_THROW(std::logic_error,
+                      "Parameters of a connection which were not pre-computed have been returned");
+
+        materialLawManager.initConnectionMaterialLawParams(connections);
+        const auto& constManager = materialLawManager;
+        if (&constManager.connectionMaterialLawParams(1, 1) != &constManager.materialLawParams(1))
+            OPM_THROW(std::logic_error,
+                      "A connection to the region of its element does not use the element's parameters");
+
+        Scalar initialPcSwMdc[2];
+        Scalar initialKrnSwMdc[2];
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx)
+            materialLawManager.oilWaterHysteresisParams(initialPcSwMdc[elemIdx],
+                                                        initialKrnSwMdc[elemIdx],
+                                                        elemIdx);
+
+        // a drainage followed by an imbibition, with some free gas in between
+        const Scalar swValues[] = { 0.8, 0.5, 0.35, 0.6, 0.9 };
+        const Scalar sgValues[] = { 0.0, 0.1, 0.2, 0.05, 0.0 };
+        for (unsigned stepIdx = 0; stepIdx < 5; ++ stepIdx) {
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                FluidState fs;
+                fs.setSaturation(waterPhaseIdx, swValues[stepIdx]);
+                fs.setSaturation(gasPhaseIdx, sgValues[stepIdx]);
+                fs.setSaturation(oilPhaseIdx, 1.0 - swValues[stepIdx] - sgValues[stepIdx]);
+                materialLawManager.updateHysteresis(fs, elemIdx);
+            }
+        }
+
+        // the kr and pc values of the connections which were updated together with
+        // their elements
+        const unsigned numSamples = 11;
+        std::vector<Scalar> values;
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            Scalar pcSwMdc, krnSwMdc;
+            materialLawManager.oilWaterHysteresisParams(pcSwMdc, krnSwMdc, elemIdx);
+            if (pcSwMdc == initialPcSwMdc[elemIdx] && krnSwMdc == initialKrnSwMdc[elemIdx])
+                OPM_THROW(std::logic_error,
+                          "The saturation history did not modify the hysteresis state of element " << elemIdx);
+
+            const auto& connParams =
+                materialLawManager.connectionMaterialLawParams(/*satRegionIdx=*/1 - elemIdx, elemIdx);
+            Scalar connPcSwMdc, connKrnSwMdc;
+            MaterialLaw::oilWaterHysteresisParams(connPcSwMdc, connKrnSwMdc, connParams);
+            if (connPcSwMdc != pcSwMdc || connKrnSwMdc != krnSwMdc)
+                OPM_THROW(std::logic_error,
+                          "The hysteresis state of the connection of element " << elemIdx
+                          << " does not follow the one of the element");
+
+            for (unsigned i = 0; i < numSamples; ++ i) {
+                FluidState fs;
+                fs.setSaturation(waterPhaseIdx, Scalar(i)/(numSamples - 1));
+                fs.setSaturation(oilPhaseIdx, Scalar(numSamples - 1 - i)/(2*(numSamples - 1)));
+                fs.setSaturation(gasPhaseIdx, Scalar(numSamples - 1 - i)/(2*(numSamples - 1)));
+
+                Scalar kr[numPhases];
+                Scalar pc[numPhases];
+                MaterialLaw::relativePermeabilities(kr, connParams, fs);
+                MaterialLaw::capillaryPressures(pc, connParams, fs);
+                values.insert(values.end(), kr, kr + numPhases);
+                values.insert(values.end(), pc, pc + numPhases);
+            }
+        }
+
+        // re-creating the connection parameters from the current state of the elements
+        // must not change anything
+        materialLawManager.initConnectionMaterialLawParams(connections);
+        auto valueIt = values.begin();
+        for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+            const auto& connParams =
+                materialLawManager.connectionMaterialLawParams(/*satRegionIdx=*/1 - elemIdx, elemIdx);
+            for (unsigned i = 0; i < numSamples; ++ i) {
+                FluidState fs;
+                fs.setSaturation(waterPhaseIdx, Scalar(i)/(numSamples - 1));
+                fs.setSaturation(oilPhaseIdx, Scalar(numSamples - 1 - i)/(2*(numSamples - 1)));
+                fs.setSaturation(gasPhaseIdx, Scalar(numSamples - 1 - i)/(2*(numSamples - 1)));
+
+                Scalar kr[numPhases];
+                Scalar pc[numPhases];
+                MaterialLaw::relativePermeabilities(kr, connParams, fs);
+                MaterialLaw::capillaryPressures(pc, connParams, fs);
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx, ++ valueIt)
+                    if (kr[phaseIdx] != *valueIt)
+                        OPM_THROW(std::logic_error,
+                                  "The relative permeabilities of the connection of element " << elemIdx
+                                  << " differ from the ones of freshly created parameters");
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx, ++ valueIt)
+                    if (pc[phaseIdx] != *valueIt)
+                        OPM_THROW(std::logic_error,
+                                  "The capillary pressures of the connection of element " << elemIdx
+                                  << " differ from the ones of freshly created parameters");
+            }
+        }
     }
 }
 
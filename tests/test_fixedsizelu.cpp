@@ -0,0 +1,213 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the LU decomposition of small fixed-size matrices.
+ *
+ * It checks the residuals of the solutions for matrices of the sizes used by the
+ * constraint solvers, the detection of singular matrices, and that factorizing
+ * several matrices at once using SIMD values yields the same results as factorizing
+ * them individually.
+ */
+#include "config.h"
+
+#include <opm/material/common/FixedSizeLu.hpp>
+#include <opm/material/common/SimdValue.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+template <class Scalar, int n>
+void fillRandom(Dune::FieldMatrix<Scalar, n, n>& A,
+                Dune::FieldVector<Scalar, n>& b,
+                std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < n; ++i) {
+        b[i] = dist(rng);
+        for (int j = 0; j < n; ++j)
+            A[i][j] = dist(rng);
+
+        // scale the rows differently, similar to the Jacobian matrices of the flash
+        // solvers whose rows stem from different kinds of equations
+        const Scalar rowScale = std::pow(10.0, (i%4) - 2);
+        for (int j = 0; j < n; ++j)
+            A[i][j] *= rowScale;
+        b[i] *= rowScale;
+    }
+}
+
+template <class Scalar, int n>
+Scalar relativeResidual(const Dune::FieldMatrix<Scalar, n, n>& A,
+                        const Dune::FieldVector<Scalar, n>& x,
+                        const Dune::FieldVector<Scalar, n>& b)
+{
+    Scalar maxRes = 0.0;
+    for (int i = 0; i < n; ++i) {
+        Scalar res = -b[i];
+        Scalar rowNorm = std::abs(b[i]);
+        for (int j = 0; j < n; ++j) {
+            res += A[i][j]*x[j];
+            rowNorm += std::abs(A[i][j]*x[j]);
+        }
+        maxRes = std::max(maxRes, std::abs(res)/rowNorm);
+    }
+    return maxRes;
+}
+
+template <class Scalar, int n>
+void testSolve()
+{
+    typedef Dune::FieldMatrix<Scalar, n, n> Matrix;
+    typedef Dune::FieldVector<Scalar, n> Vector;
+
+    std::mt19937 rng(1234 + n);
+    const Scalar tol = std::numeric_limits<Scalar>::epsilon()*n*1e3;
+
+    for (int sampleIdx = 0; sampleIdx < 20; ++sampleIdx) {
+        Matrix A;
+        Vector b, x;
+        fillRandom(A, b, rng);
+
+        if (!Opm::fixedSizeLuSolve(x, A, b))
+            OPM_THROW(std::logic_error,
+                      "Regular " << n << "x" << n << " matrix detected as singular");
+
+        Scalar res = relativeResidual(A, x, b);
+        if (!(res < tol))
+            OPM_THROW(std::logic_error,
+                      "Residual of the solution of a " << n << "x" << n
+                      << " system is too large: " << res);
+
+        // the inverse multiplied by the matrix must be the identity
+        Opm::FixedSizeLu<Scalar, n> lu;
+        lu.factorize(A);
+        Matrix Ainv;
+        lu.invert(Ainv);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                Scalar val = 0.0;
+                for (int k = 0; k < n; ++k)
+                    val += Ainv[i][k]*A[k][j];
+                if (!(std::abs(val - ((i == j)?1.0:0.0)) < tol*1e2))
+                    OPM_THROW(std::logic_error,
+                              "Inverse of a " << n << "x" << n << " matrix is incorrect");
+            }
+        }
+    }
+
+    // a matrix with a zero column must be detected as singular
+    Matrix A;
+    Vector b, x;
+    fillRandom(A, b, rng);
+    for (int i = 0; i < n; ++i)
+        A[i][n/2] = 0.0;
+    if (Opm::fixedSizeLuSolve(x, A, b))
+        OPM_THROW(std::logic_error,
+                  "Singular " << n << "x" << n << " matrix not detected");
+}
+
+template <class Scalar, int n, int width>
+void testBatched()
+{
+    typedef Opm::SimdValue<Scalar, width> SimdScalar;
+    typedef Dune::FieldMatrix<Scalar, n, n> Matrix;
+    typedef Dune::FieldVector<Scalar, n> Vector;
+
+    std::mt19937 rng(4321 + n);
+
+    std::array<Matrix, width> A;
+    std::array<Vector, width> b;
+    std::array<std::array<SimdScalar, n>, n> simdA;
+    std::array<SimdScalar, n> simdB;
+    for (int laneIdx = 0; laneIdx < width; ++laneIdx) {
+        fillRandom(A[laneIdx], b[laneIdx], rng);
+        for (int i = 0; i < n; ++i) {
+            simdB[i][laneIdx] = b[laneIdx][i];
+            for (int j = 0; j < n; ++j)
+                simdA[i][j][laneIdx] = A[laneIdx][i][j];
+        }
+    }
+
+    // make the matrix of the last lane singular
+    for (int i = 0; i < n; ++i)
+        simdA[i][n/2][width - 1] = 0.0;
+
+    Opm::FixedSizeLu<SimdScalar, n> simdLu;
+    if (simdLu.factorize(simdA))
+        OPM_THROW(std::logic_error, "Singular matrix in batch not detected");
+
+    std::array<SimdScalar, n> simdX;
+    simdLu.solve(simdX, simdB);
+    for (int laneIdx = 0; laneIdx < width - 1; ++laneIdx) {
+        if (simdLu.isSingular(laneIdx))
+            OPM_THROW(std::logic_error,
+                      "Regular matrix of lane " << laneIdx << " detected as singular");
+
+        Opm::FixedSizeLu<Scalar, n> lu;
+        lu.factorize(A[laneIdx]);
+        Vector x;
+        lu.solve(x, b[laneIdx]);
+        for (int i = 0; i < n; ++i)
+            if (simdX[i][laneIdx] != x[i])
+                OPM_THROW(std::logic_error,
+                          "Batched solution of lane " << laneIdx << " differs from the"
+                          " individual one: " << simdX[i][laneIdx] << " vs " << x[i]);
+    }
+    if (!simdLu.isSingular(width - 1))
+        OPM_THROW(std::logic_error, "Singular matrix of the last lane not detected");
+}
+
+template <class Scalar>
+void testAll()
+{
+    testSolve<Scalar, 1>();
+    testSolve<Scalar, 4>();
+    testSolve<Scalar, 9>();
+    testSolve<Scalar, 16>();
+    testSolve<Scalar, 40>();
+
+    testBatched<Scalar, 4, 4>();
+    testBatched<Scalar, 9, 8>();
+}
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    testAll<double>();
+    testAll<float>();
+
+    return 0;
+}
@@ -41,16 +41,22 @@
 #include <opm/material/fluidmatrixinteractions/RegularizedBrooksCorey.hpp>
 #include <opm/material/fluidmatrixinteractions/RegularizedVanGenuchten.hpp>
 #include <opm/material/fluidmatrixinteractions/EffToAbsLaw.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialLawParamsRegistry.hpp>
+#include <opm/material/fluidmatrixinteractions/MixedPrecisionTwoPhaseLaw.hpp>
 #include <opm/material/fluidmatrixinteractions/PiecewiseLinearTwoPhaseMaterial.hpp>
+#include <opm/material/fluidmatrixinteractions/ReducedDerivativeTwoPhaseLaw.hpp>
 #include <opm/material/fluidmatrixinteractions/SplineTwoPhaseMaterial.hpp>
+#include <opm/material/fluidmatrixinteractions/TabulatedTwoPhaseMaterial.hpp>
 #include <opm/material/fluidmatrixinteractions/ThreePhaseParkerVanGenuchten.hpp>
 #include <opm/material/fluidmatrixinteractions/EclEpsTwoPhaseLaw.hpp>
+#include <opm/material/fluidmatrixinteractions/EclEpsEnsembleTwoPhaseLaw.hpp>
 #include <opm/material/fluidmatrixinteractions/EclHysteresisTwoPhaseLaw.hpp>
 #include <opm/material/fluidmatrixinteractions/EclDefaultMaterial.hpp>
 #include <opm/material/fluidmatrixinteractions/EclStone1Material.hpp>
 #include <opm/material/fluidmatrixinteractions/EclStone2Material.hpp>
 #include <opm/material/fluidmatrixinteractions/EclTwoPhaseMaterial.hpp>
 #include <opm/material/fluidmatrixinteractions/EclMultiplexerMaterial.hpp>
+#include <opm/material/fluidmatrixinteractions/EclThreePhaseKroTable.hpp>
 
 // include the helper classes to construct traits
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
@@ -73,6 +79,12 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 // this function makes sure that a capillary pressure law adheres to
 // the generic programming interface for such laws. This API _must_ be
 // implemented by all capillary pressure laws. If there are no _very_
@@ -259,6 +271,1376 @@ void testThreePhaseSatApi()
 {
 }
 
+// this function makes sure that baking the end-point scaling into the tables of a
+// piecewise linear saturation function does not change the results
+template <class Scalar>
+void testEclEpsBaking(bool threePointScaling)
+{
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> EffLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<EffLaw> MaterialLaw;
+    typedef typename EffLaw::Params EffLawParams;
+    typedef typename MaterialLaw::Params Params;
+    typedef Opm::EclEpsScalingPoints<Scalar> ScalingPoints;
+
+    std::vector<Scalar> SwSamples = { 0.1, 0.2, 0.35, 0.5, 0.7, 0.9 };
+    std::vector<Scalar> pcSamples = { 3e5, 1e5, 5e4, 2e4, 1e4, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.05, 0.1, 0.3, 0.6, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.7, 0.4, 0.2, 0.05, 0.0 };
+    auto effParams = std::make_shared<EffLawParams>();
+    effParams->setPcnwSamples(SwSamples, pcSamples);
+    effParams->setKrwSamples(SwSamples, krwSamples);
+    effParams->setKrnSamples(SwSamples, krnSamples);
+    effParams->finalize();
+
+    auto config = std::make_shared<Opm::EclEpsConfig>();
+    config->setEnableSatScaling(true);
+    config->setEnableThreePointKrSatScaling(threePointScaling);
+    config->setEnablePcScaling(true);
+    config->setEnableKrwScaling(true);
+    config->setEnableKrnScaling(true);
+
+    auto unscaledPoints = std::make_shared<ScalingPoints>();
+    auto scaledPoints = std::make_shared<ScalingPoints>();
+    const Scalar unscaledSats[3] = { 0.1, 0.35, 0.9 };
+    const Scalar scaledSats[3] = { 0.15, 0.45, 0.85 };
+    for (unsigned pointIdx = 0; pointIdx < 3; ++pointIdx) {
+        if (pointIdx < 2) {
+            unscaledPoints->setSaturationPcPoint(pointIdx, unscaledSats[2*pointIdx]);
+            scaledPoints->setSaturationPcPoint(pointIdx, scaledSats[2*pointIdx]);
+        }
+        unscaledPoints->setSaturationKrwPoint(pointIdx, unscaledSats[pointIdx]);
+        unscaledPoints->setSaturationKrnPoint(pointIdx, unscaledSats[pointIdx]);
+        scaledPoints->setSaturationKrwPoint(pointIdx, scaledSats[pointIdx]);
+        scaledPoints->setSaturationKrnPoint(pointIdx, scaledSats[pointIdx]);
+    }
+    unscaledPoints->setMaxPcnw(3e5);
+    unscaledPoints->setMaxKrw(1.0);
+    unscaledPoints->setMaxKrn(1.0);
+    scaledPoints->setMaxPcnw(2e5);
+    scaledPoints->setMaxKrw(0.8);
+    scaledPoints->setMaxKrn(0.9);
+
+    Params params;
+    params.setConfig(config);
+    params.setUnscaledPoints(unscaledPoints);
+    params.setScaledPoints(scaledPoints);
+    params.setEffectiveLawParams(effParams);
+    params.finalize();
+
+    Params bakedParams(params);
+    if (!MaterialLaw::bakeScaling(bakedParams) || !bakedParams.hasBakedLawParams())
+        throw std::logic_error("Baking the end-point scaling failed");
+
+    for (int i = -10; i <= 110; ++i) {
+        Scalar Sw = Scalar(i)/100;
+        Scalar tol = 1e2*std::numeric_limits<Scalar>::epsilon();
+        if (std::abs(MaterialLaw::twoPhaseSatPcnw(params, Sw)
+                     - MaterialLaw::twoPhaseSatPcnw(bakedParams, Sw)) > tol*3e5)
+            throw std::logic_error("Discrepancy between the baked and the regular capillary pressure");
+        if (std::abs(MaterialLaw::twoPhaseSatKrw(params, Sw)
+                     - MaterialLaw::twoPhaseSatKrw(bakedParams, Sw)) > tol)
+            throw std::logic_error("Discrepancy between the baked and the regular wetting relperm");
+        if (std::abs(MaterialLaw::twoPhaseSatKrn(params, Sw)
+                     - MaterialLaw::twoPhaseSatKrn(bakedParams, Sw)) > tol)
+            throw std::logic_error("Discrepancy between the baked and the regular non-wetting relperm");
+    }
+
+    // modifying the scaling points must drop the baked tables
+    bakedParams.scaledPoints().setMaxKrw(0.5);
+    if (bakedParams.hasBakedLawParams())
+        throw std::logic_error("The baked tables were not dropped after modifying the scaling points");
+}
+
+// the saturation functions and the end points which are used by the tests of the
+// storage types of the ECL end-point scaling
+template <class Scalar>
+struct EclEpsStorageTestSetup
+{
+    typedef Opm::EclEpsScalingPointsInfo<Scalar> ScalingPointsInfo;
+
+    EclEpsStorageTestSetup()
+        : SwSamples{ 0.1, 0.2, 0.35, 0.5, 0.7, 0.9 }
+        , pcSamples{ 3e5, 1e5, 5e4, 2e4, 1e4, 0.0 }
+        , krwSamples{ 0.0, 0.05, 0.1, 0.3, 0.6, 1.0 }
+        , krnSamples{ 1.0, 0.7, 0.4, 0.2, 0.05, 0.0 }
+        , config(std::make_shared<Opm::EclEpsConfig>())
+        , unscaledInfo()
+        , scaledInfo()
+    {
+        config->setEnableSatScaling(true);
+        config->setEnablePcScaling(true);
+        config->setEnableKrwScaling(true);
+        config->setEnableKrnScaling(true);
+
+        unscaledInfo.Swl = 0.1;
+        unscaledInfo.Swcr = 0.1;
+        unscaledInfo.Swu = 0.9;
+        unscaledInfo.Sowcr = 0.1;
+        unscaledInfo.Sgl = 0.0;
+        unscaledInfo.maxPcow = 3e5;
+        unscaledInfo.maxKrw = 1.0;
+        unscaledInfo.maxKrow = 1.0;
+
+        scaledInfo = unscaledInfo;
+        scaledInfo.Swl = 0.13;
+        scaledInfo.Swcr = 0.17;
+        scaledInfo.Swu = 0.83;
+        scaledInfo.maxPcow = 2.1e5;
+        scaledInfo.maxKrw = 0.8;
+    }
+
+    template <class EffLawParams>
+    std::shared_ptr<EffLawParams> effectiveLawParams() const
+    {
+        auto effParams = std::make_shared<EffLawParams>();
+        effParams->setPcnwSamples(SwSamples, pcSamples);
+        effParams->setKrwSamples(SwSamples, krwSamples);
+        effParams->setKrnSamples(SwSamples, krnSamples);
+        effParams->finalize();
+        return effParams;
+    }
+
+    template <class ScalingPoints>
+    std::shared_ptr<ScalingPoints> scalingPoints(const ScalingPointsInfo& info) const
+    {
+        auto points = std::make_shared<ScalingPoints>();
+        points->init(info, *config, Opm::EclOilWaterSystem);
+        return points;
+    }
+
+    template <class Params, class EffLawParams>
+    void initParams(Params& params,
+                    std::shared_ptr<EffLawParams> effParams,
+                    std::shared_ptr<typename Params::ScalingPoints> unscaledPoints,
+                    std::shared_ptr<typename Params::ScalingPoints> scaledPoints) const
+    {
+        params.setConfig(config);
+        params.setUnscaledPoints(unscaledPoints);
+        params.setScaledPoints(scaledPoints);
+        params.setEffectiveLawParams(effParams);
+        params.finalize();
+    }
+
+    std::vector<Scalar> SwSamples;
+    std::vector<Scalar> pcSamples;
+    std::vector<Scalar> krwSamples;
+    std::vector<Scalar> krnSamples;
+    std::shared_ptr<Opm::EclEpsConfig> config;
+    ScalingPointsInfo unscaledInfo;
+    ScalingPointsInfo scaledInfo;
+};
+
+// this function makes sure that storing the tables and the scaling points of the ECL
+// saturation functions in single precision only causes deviations in the order of the
+// precision of the stored values
+template <class Scalar>
+void testEclFloatStorage()
+{
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterialParams<Traits, float> FloatEffLawParams;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> EffLaw;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits, FloatEffLawParams> FloatEffLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<EffLaw> MaterialLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<FloatEffLaw,
+                                   Opm::EclEpsTwoPhaseLawParams<FloatEffLaw, float> > FloatMaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+    typedef typename FloatMaterialLaw::Params FloatParams;
+    typedef typename Params::ScalingPoints ScalingPoints;
+    typedef typename FloatParams::ScalingPoints FloatScalingPoints;
+
+    EclEpsStorageTestSetup<Scalar> setup;
+
+    Params params;
+    setup.initParams(params,
+                     setup.template effectiveLawParams<typename EffLaw::Params>(),
+                     setup.template scalingPoints<ScalingPoints>(setup.unscaledInfo),
+                     setup.template scalingPoints<ScalingPoints>(setup.scaledInfo));
+
+    FloatParams floatParams;
+    setup.initParams(floatParams,
+                     setup.template effectiveLawParams<FloatEffLawParams>(),
+                     setup.template scalingPoints<FloatScalingPoints>(setup.unscaledInfo),
+                     setup.template scalingPoints<FloatScalingPoints>(setup.scaledInfo));
+
+    for (int i = -10; i <= 110; ++i) {
+        Scalar Sw = Scalar(i)/100;
+        Scalar tol = 1e2*std::numeric_limits<float>::epsilon();
+        if (std::abs(MaterialLaw::twoPhaseSatPcnw(params, Sw)
+                     - FloatMaterialLaw::twoPhaseSatPcnw(floatParams, Sw)) > tol*3e5)
+            throw std::logic_error("Discrepancy of the capillary pressure if using single precision storage");
+        if (std::abs(MaterialLaw::twoPhaseSatKrw(params, Sw)
+                     - FloatMaterialLaw::twoPhaseSatKrw(floatParams, Sw)) > tol)
+            throw std::logic_error("Discrepancy of the wetting relperm if using single precision storage");
+        if (std::abs(MaterialLaw::twoPhaseSatKrn(params, Sw)
+                     - FloatMaterialLaw::twoPhaseSatKrn(floatParams, Sw)) > tol)
+            throw std::logic_error("Discrepancy of the non-wetting relperm if using single precision storage");
+    }
+}
+
+// this function makes sure that storing the scaling points of the ECL saturation
+// functions as 16 bit fixed point numbers only causes deviations in the order of the
+// resolution of the stored values
+template <class Scalar>
+void testEclQuantizedStorage()
+{
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> EffLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<EffLaw> MaterialLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<EffLaw,
+                                   Opm::EclEpsTwoPhaseLawParams<EffLaw, Opm::EclEpsQuantized<Scalar> > >
+        QuantizedMaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+    typedef typename QuantizedMaterialLaw::Params QuantizedParams;
+    typedef typename Params::ScalingPoints ScalingPoints;
+    typedef typename QuantizedParams::ScalingPoints QuantizedScalingPoints;
+    typedef Opm::EclEpsQuantizationScales<Scalar> Scales;
+
+    EclEpsStorageTestSetup<Scalar> setup;
+    const auto& unscaledInfo = setup.unscaledInfo;
+    const auto& scaledInfo = setup.scaledInfo;
+    auto effParams = setup.template effectiveLawParams<typename EffLaw::Params>();
+
+    // the scales are shared by all elements of a saturation region
+    auto regionScales = std::make_shared<Scales>();
+    regionScales->maxima.fill(0.0);
+    regionScales->include(unscaledInfo, *setup.config, Opm::EclOilWaterSystem);
+    regionScales->include(scaledInfo, *setup.config, Opm::EclOilWaterSystem);
+
+    auto quantizedUnscaledPoints = setup.template scalingPoints<QuantizedScalingPoints>(unscaledInfo);
+    auto quantizedScaledPoints = std::make_shared<QuantizedScalingPoints>();
+    quantizedScaledPoints->setScales(regionScales);
+    quantizedScaledPoints->init(scaledInfo, *setup.config, Opm::EclOilWaterSystem);
+    if (quantizedScaledPoints->scales() != regionScales)
+        throw std::logic_error("The quantized scaling points do not use the scales of their region");
+    if (quantizedUnscaledPoints->maxPcnw() != unscaledInfo.maxPcow)
+        throw std::logic_error("The maximum of the points which define their scales is not exact");
+    if (sizeof(QuantizedScalingPoints) >= sizeof(ScalingPoints))
+        throw std::logic_error("The quantized scaling points are not smaller than the regular ones");
+
+    Params params;
+    setup.initParams(params,
+                     effParams,
+                     setup.template scalingPoints<ScalingPoints>(unscaledInfo),
+                     setup.template scalingPoints<ScalingPoints>(scaledInfo));
+
+    QuantizedParams quantizedParams;
+    setup.initParams(quantizedParams, effParams, quantizedUnscaledPoints, quantizedScaledPoints);
+
+    // the parameters survive the serialization
+    Opm::BinaryWriter writer;
+    quantizedParams.serialize(writer);
+    Opm::BinaryReader reader(writer.data());
+    QuantizedParams restoredParams;
+    restoredParams.deserialize(reader);
+
+    const Scalar tol = 1e-4;
+    for (int i = -10; i <= 110; ++i) {
+        Scalar Sw = Scalar(i)/100;
+        if (std::abs(MaterialLaw::twoPhaseSatPcnw(params, Sw)
+                     - QuantizedMaterialLaw::twoPhaseSatPcnw(quantizedParams, Sw)) > tol*3e5)
+            throw std::logic_error("Discrepancy of the capillary pressure if using quantized storage");
+        if (std::abs(MaterialLaw::twoPhaseSatKrw(params, Sw)
+                     - QuantizedMaterialLaw::twoPhaseSatKrw(quantizedParams, Sw)) > tol)
+            throw std::logic_error("Discrepancy of the wetting relperm if using quantized storage");
+        if (std::abs(MaterialLaw::twoPhaseSatKrn(params, Sw)
+                     - QuantizedMaterialLaw::twoPhaseSatKrn(quantizedParams, Sw)) > tol)
+            throw std::logic_error("Discrepancy of the non-wetting relperm if using quantized storage");
+        if (QuantizedMaterialLaw::twoPhaseSatKrw(quantizedParams, Sw)
+            != QuantizedMaterialLaw::twoPhaseSatKrw(restoredParams, Sw))
+            throw std::logic_error("The restored quantized scaling points differ from the original ones");
+    }
+
+    // a maximum which exceeds the scale of the region gives the points scales of their
+    // own, the ones of the region are left alone
+    quantizedParams.scaledPoints().setMaxKrw(1.5);
+    if (quantizedParams.scaledPoints().scales() == regionScales
+        || regionScales->maxima[Scales::krwIdx] != 1.0
+        || std::abs(quantizedParams.scaledPoints().maxKrw() - 1.5) > tol
+        || std::abs(quantizedParams.scaledPoints().maxPcnw() - scaledInfo.maxPcow) > tol*3e5)
+        throw std::logic_error("Exceeding the scales of the region was not handled correctly");
+}
+
+// this function makes sure that compiling the end-point scaling and the hysteresis
+// layers of the ECL saturation functions as pass-throughs does not change the results
+// if the respective features are disabled at runtime
+template <class Scalar>
+void testEclPassThroughLayers()
+{
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> EffLaw;
+    typedef Opm::EclEpsTwoPhaseLawParams<EffLaw> EpsParams;
+    typedef Opm::EclEpsTwoPhaseLaw<EffLaw> EpsLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<EffLaw, EpsParams, /*enableScaling=*/false> SlimEpsLaw;
+    typedef Opm::EclHysteresisTwoPhaseLaw<EpsLaw> MaterialLaw;
+    typedef Opm::EclHysteresisTwoPhaseLaw<SlimEpsLaw,
+                                          Opm::EclHysteresisTwoPhaseLawParams<SlimEpsLaw>,
+                                          /*enableHysteresis=*/false> SlimMaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+    typedef typename SlimMaterialLaw::Params SlimParams;
+
+    std::vector<Scalar> SwSamples = { 0.1, 0.2, 0.35, 0.5, 0.7, 0.9 };
+    std::vector<Scalar> pcSamples = { 3e5, 1e5, 5e4, 2e4, 1e4, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.05, 0.1, 0.3, 0.6, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.7, 0.4, 0.2, 0.05, 0.0 };
+    auto effParams = std::make_shared<typename EffLaw::Params>();
+    effParams->setPcnwSamples(SwSamples, pcSamples);
+    effParams->setKrwSamples(SwSamples, krwSamples);
+    effParams->setKrnSamples(SwSamples, krnSamples);
+    effParams->finalize();
+
+    // neither end-point scaling nor hysteresis are enabled by the configuration
+    auto epsConfig = std::make_shared<Opm::EclEpsConfig>();
+    auto hysteresisConfig = std::make_shared<Opm::EclHysteresisConfig>();
+
+    auto epsParams = std::make_shared<EpsParams>();
+    epsParams->setConfig(epsConfig);
+    epsParams->setUnscaledPoints(std::make_shared<typename EpsParams::ScalingPoints>());
+    epsParams->setScaledPoints(std::make_shared<typename EpsParams::ScalingPoints>());
+    epsParams->setEffectiveLawParams(effParams);
+    epsParams->finalize();
+
+    Opm::EclEpsScalingPointsInfo<Scalar> info;
+    Params params;
+    params.setConfig(hysteresisConfig);
+    params.setDrainageParams(epsParams, info, Opm::EclOilWaterSystem);
+    params.finalize();
+    SlimParams slimParams;
+    slimParams.setConfig(hysteresisConfig);
+    slimParams.setDrainageParams(epsParams, info, Opm::EclOilWaterSystem);
+    slimParams.finalize();
+
+    if (SlimEpsLaw::bakeScaling(*epsParams))
+        throw std::logic_error("The end-point scaling was baked by a pass-through layer");
+
+    std::vector<Scalar> Sw;
+    for (int i = -10; i <= 110; ++i)
+        Sw.push_back(Scalar(i)/100);
+
+    std::vector<Scalar> krw(Sw.size()), krn(Sw.size());
+    SlimMaterialLaw::twoPhaseSatKrMany(krw.data(), krn.data(),
+                                       [&slimParams](size_t) -> const SlimParams&
+                                       { return slimParams; },
+                                       Sw.data(), Sw.size());
+
+    for (size_t i = 0; i < Sw.size(); ++i) {
+        Scalar pcnw, slimPcnw, slimKrw, slimKrn;
+        SlimMaterialLaw::twoPhaseSatPcnwAndKr(&slimPcnw, &slimKrw, &slimKrn, slimParams, Sw[i]);
+        pcnw = MaterialLaw::twoPhaseSatPcnw(params, Sw[i]);
+        if (pcnw != SlimMaterialLaw::twoPhaseSatPcnw(slimParams, Sw[i]) || pcnw != slimPcnw)
+            throw std::logic_error("Discrepancy of the capillary pressure of the pass-through layers");
+        if (MaterialLaw::twoPhaseSatKrw(params, Sw[i]) != SlimMaterialLaw::twoPhaseSatKrw(slimParams, Sw[i])
+            || krw[i] != slimKrw)
+            throw std::logic_error("Discrepancy of the wetting relperm of the pass-through layers");
+        if (MaterialLaw::twoPhaseSatKrn(params, Sw[i]) != SlimMaterialLaw::twoPhaseSatKrn(slimParams, Sw[i])
+            || krn[i] != slimKrn)
+            throw std::logic_error("Discrepancy of the non-wetting relperm of the pass-through layers");
+    }
+}
+
+// this function makes sure that evaluating the end-point scaling for all members of an
+// ensemble of scaling points at once yields the same results as evaluating each
+// member individually
+template <class Scalar>
+void testEclEpsEnsemble(bool threePointScaling, bool satScaling)
+{
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> EffLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<EffLaw> EpsLaw;
+    typedef typename EpsLaw::Params EpsParams;
+    typedef Opm::EclEpsEnsembleTwoPhaseLaw<EffLaw> EnsembleLaw;
+    typedef typename EnsembleLaw::Params EnsembleParams;
+    typedef Opm::EclEpsScalingPoints<Scalar> ScalingPoints;
+
+    std::vector<Scalar> SwSamples = { 0.1, 0.2, 0.35, 0.5, 0.7, 0.9 };
+    std::vector<Scalar> pcSamples = { 3e5, 1e5, 5e4, 2e4, 1e4, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.05, 0.1, 0.3, 0.6, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.7, 0.4, 0.2, 0.05, 0.0 };
+    auto effParams = std::make_shared<typename EffLaw::Params>();
+    effParams->setPcnwSamples(SwSamples, pcSamples);
+    effParams->setKrwSamples(SwSamples, krwSamples);
+    effParams->setKrnSamples(SwSamples, krnSamples);
+    effParams->finalize();
+
+    auto config = std::make_shared<Opm::EclEpsConfig>();
+    config->setEnableSatScaling(satScaling);
+    config->setEnableThreePointKrSatScaling(threePointScaling);
+    config->setEnablePcScaling(true);
+    config->setEnableKrwScaling(true);
+    config->setEnableKrnScaling(true);
+
+    Opm::EclEpsScalingPointsInfo<Scalar> info;
+    info.Swl = 0.1;
+    info.Swcr = 0.2;
+    info.Swu = 0.9;
+    info.Sowcr = 0.3;
+    info.Sgl = 0.0;
+    info.maxPcow = 3e5;
+    info.maxKrw = 1.0;
+    info.maxKrow = 1.0;
+    auto unscaledPoints = std::make_shared<ScalingPoints>();
+    unscaledPoints->init(info, *config, Opm::EclOilWaterSystem);
+
+    // some members are identical to the previous one
+    const unsigned numMembers = 40;
+    EnsembleParams ensembleParams;
+    ensembleParams.setConfig(config);
+    ensembleParams.setUnscaledPoints(unscaledPoints);
+    ensembleParams.setEffectiveLawParams(effParams);
+    ensembleParams.setNumMembers(numMembers);
+    for (unsigned memberIdx = 0; memberIdx < numMembers; ++memberIdx) {
+        Opm::EclEpsScalingPointsInfo<Scalar> memberInfo(info);
+        if (memberIdx%5 != 4) {
+            Scalar x = Scalar(memberIdx)/numMembers;
+            memberInfo.Swl = 0.05 + 0.1*x;
+            memberInfo.Swcr = memberInfo.Swl + 0.02 + 0.1*(1 - x);
+            memberInfo.Swu = 0.95 - 0.1*x*x;
+            memberInfo.Sowcr = 0.2 + 0.15*x;
+            memberInfo.maxPcow = 1e5 + 4e5*x;
+            memberInfo.maxKrw = 0.5 + 0.5*x;
+            memberInfo.maxKrow = 1.0 - 0.3*x;
+        }
+        else
+            memberInfo.maxKrw = 0.5 + 0.5*Scalar(memberIdx - 1)/numMembers;
+        ensembleParams.setScaledPoints(memberIdx, memberInfo, Opm::EclOilWaterSystem);
+        if (memberIdx%5 == 4)
+            ensembleParams.setScaledPoints(memberIdx, ensembleParams.scaledPoints(memberIdx - 1));
+    }
+    ensembleParams.finalize();
+
+    std::vector<EpsParams> memberParams(numMembers);
+    for (unsigned memberIdx = 0; memberIdx < numMembers; ++memberIdx) {
+        EpsParams& params = memberParams[memberIdx];
+        params.setConfig(config);
+        params.setUnscaledPoints(unscaledPoints);
+        params.setScaledPoints(std::make_shared<ScalingPoints>(ensembleParams.scaledPoints(memberIdx)));
+        params.setEffectiveLawParams(effParams);
+        params.finalize();
+    }
+
+    std::vector<Scalar> pcnw(numMembers), krw(numMembers), krn(numMembers);
+    for (int i = -10; i <= 110; ++i) {
+        Scalar Sw = Scalar(i)/100;
+        EnsembleLaw::twoPhaseSatPcnwAndKr(pcnw.data(), krw.data(), krn.data(), ensembleParams, Sw);
+        for (unsigned memberIdx = 0; memberIdx < numMembers; ++memberIdx) {
+            const EpsParams& params = memberParams[memberIdx];
+            if (pcnw[memberIdx] != EpsLaw::twoPhaseSatPcnw(params, Sw)
+                || krw[memberIdx] != EpsLaw::twoPhaseSatKrw(params, Sw)
+                || krn[memberIdx] != EpsLaw::twoPhaseSatKrn(params, Sw))
+                throw std::logic_error("Discrepancy between the ensemble and the individual "
+                                       "evaluation of the end-point scaling of member "
+                                       + std::to_string(memberIdx));
+        }
+
+        std::vector<Scalar> krnOnly(numMembers);
+        EnsembleLaw::twoPhaseSatKrn(krnOnly.data(), ensembleParams, Sw);
+        if (krnOnly != krn)
+            throw std::logic_error("Discrepancy of the non-wetting relperm evaluated on its own");
+    }
+}
+
+// this function makes sure that the kernel of the Stone models which computes the
+// relative permeabilities for arrays of saturations yields the same results as the
+// regular per-element API
+template <class MaterialLaw, class FluidState>
+void testEclStoneKernel(typename MaterialLaw::Params& params)
+{
+    typedef typename MaterialLaw::Scalar Scalar;
+    typedef typename FluidState::Scalar Evaluation;
+    typedef typename MaterialLaw::GasOilMaterialLaw::Params GasOilParams;
+    typedef typename MaterialLaw::OilWaterMaterialLaw::Params OilWaterParams;
+
+    enum { numPhases = MaterialLaw::numPhases };
+    enum { waterPhaseIdx = MaterialLaw::waterPhaseIdx };
+    enum { oilPhaseIdx = MaterialLaw::oilPhaseIdx };
+    enum { gasPhaseIdx = MaterialLaw::gasPhaseIdx };
+
+    std::vector<Scalar> SwSamples = { 0.0, 0.1, 0.3, 0.5, 0.8, 1.0 };
+    std::vector<Scalar> pcSamples = { 2e5, 1e5, 5e4, 2e4, 1e4, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.0, 0.1, 0.3, 0.6, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.8, 0.4, 0.2, 0.0, 0.0 };
+
+    auto gasOilParams = std::make_shared<GasOilParams>();
+    gasOilParams->setPcnwSamples(SwSamples, pcSamples);
+    gasOilParams->setKrwSamples(SwSamples, krwSamples);
+    gasOilParams->setKrnSamples(SwSamples, krnSamples);
+    gasOilParams->finalize();
+
+    auto oilWaterParams = std::make_shared<OilWaterParams>(*gasOilParams);
+
+    params.setGasOilParams(gasOilParams);
+    params.setOilWaterParams(oilWaterParams);
+    params.setSwl(0.1);
+    params.finalize();
+
+    // the derivatives of the Stone 1 model are not defined if no oil is present
+    std::vector<Evaluation> saturations[numPhases];
+    for (int i = 0; i < 20; ++i) {
+        for (int j = 0; i + j < 20; ++j) {
+            Scalar Sw = Scalar(i)/20;
+            Scalar Sg = Scalar(j)/20;
+            saturations[waterPhaseIdx].push_back(Evaluation::createVariable(Sw, 0));
+            saturations[gasPhaseIdx].push_back(Evaluation::createVariable(Sg, 1));
+            saturations[oilPhaseIdx].push_back(1.0
+                                               - saturations[waterPhaseIdx].back()
+                                               - saturations[gasPhaseIdx].back());
+        }
+    }
+
+    size_t numValues = saturations[0].size();
+    std::vector<Evaluation> kr[numPhases];
+    Evaluation* krPtr[numPhases];
+    const Evaluation* saturationsPtr[numPhases];
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        kr[phaseIdx].resize(numValues);
+        krPtr[phaseIdx] = kr[phaseIdx].data();
+        saturationsPtr[phaseIdx] = saturations[phaseIdx].data();
+    }
+    MaterialLaw::relativePermeabilitiesMany(krPtr, params, saturationsPtr, numValues);
+
+    FluidState fs;
+    Evaluation values[numPhases];
+    for (size_t i = 0; i < numValues; ++i) {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            fs.setSaturation(phaseIdx, saturations[phaseIdx][i]);
+        MaterialLaw::relativePermeabilities(values, params, fs);
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (values[phaseIdx] != kr[phaseIdx][i])
+                throw std::logic_error("Discrepancy between the array and the per-element "
+                                       "relative permeabilities of a Stone model");
+
+        Evaluation pc[numPhases];
+        Evaluation pcCombined[numPhases];
+        Evaluation krCombined[numPhases];
+        MaterialLaw::capillaryPressures(pc, params, fs);
+        MaterialLaw::capillaryPressuresAndRelativePermeabilities(pcCombined, krCombined, params, fs);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (pcCombined[phaseIdx] != pc[phaseIdx] || krCombined[phaseIdx] != values[phaseIdx])
+                throw std::logic_error("Discrepancy between the combined and the individual "
+                                       "evaluation of a Stone model");
+    }
+}
+
+// this function makes sure that the tabulated three-phase oil relperm is close to the
+// one computed from the two-phase systems and that it is only used within the range of
+// the table. the table is left in the parameter object.
+template <class MaterialLaw, class FluidState>
+void testEclKroTable(typename MaterialLaw::Params& params, bool clampsConnateWater)
+{
+    typedef typename MaterialLaw::Scalar Scalar;
+    typedef typename MaterialLaw::Params Params;
+    typedef typename FluidState::Scalar Evaluation;
+    typedef typename MaterialLaw::GasOilMaterialLaw::Params GasOilParams;
+    typedef typename MaterialLaw::OilWaterMaterialLaw::Params OilWaterParams;
+
+    enum { numPhases = MaterialLaw::numPhases };
+    enum { waterPhaseIdx = MaterialLaw::waterPhaseIdx };
+    enum { oilPhaseIdx = MaterialLaw::oilPhaseIdx };
+    enum { gasPhaseIdx = MaterialLaw::gasPhaseIdx };
+
+    std::vector<Scalar> SwSamples = { 0.0, 0.1, 0.3, 0.5, 0.8, 1.0 };
+    std::vector<Scalar> pcSamples = { 2e5, 1e5, 5e4, 2e4, 1e4, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.0, 0.1, 0.3, 0.6, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.8, 0.4, 0.2, 0.0, 0.0 };
+
+    auto gasOilParams = std::make_shared<GasOilParams>();
+    gasOilParams->setPcnwSamples(SwSamples, pcSamples);
+    gasOilParams->setKrwSamples(SwSamples, krwSamples);
+    gasOilParams->setKrnSamples(SwSamples, krnSamples);
+    gasOilParams->finalize();
+
+    auto oilWaterParams = std::make_shared<OilWaterParams>(*gasOilParams);
+
+    const Scalar Swl = 0.1;
+    params.setGasOilParams(gasOilParams);
+    params.setOilWaterParams(oilWaterParams);
+    params.setSwl(Swl);
+    params.finalize();
+
+    // a tolerance which cannot be met with few sampling points is rejected
+    if (Opm::tabulateEclThreePhaseKro<MaterialLaw>(params, /*tolerance=*/1e-6, /*maxNumSamples=*/33))
+        throw std::logic_error("The oil relperm was tabulated although the tolerance is not met");
+
+    // the kinks of the two-phase tables are not located at sampling points, so the
+    // error decreases only linearly with the distance of the sampling points
+    const Scalar tolerance = 5e-3;
+    const auto kroTable = Opm::tabulateEclThreePhaseKro<MaterialLaw>(params, tolerance, /*maxNumSamples=*/513);
+    if (!kroTable)
+        throw std::logic_error("Tabulating the oil relperm failed");
+    if (kroTable->xMin() != Swl || kroTable->xMax() != 1.0
+        || kroTable->yMin() != 0.0 || kroTable->yMax() != Scalar(1.0 - Swl))
+        throw std::logic_error("Unexpected range of the table of the oil relperm");
+
+    Params tabulatedParams(params);
+    tabulatedParams.setKroTable(kroTable);
+
+    // the deviation between the sampling points is bounded by a few times the
+    // tolerance. below the connate water saturation, the laws which do not limit the
+    // water saturation to the connate one use the exact oil relperm.
+    FluidState fs;
+    Evaluation exactKr[numPhases];
+    Evaluation tabulatedKr[numPhases];
+    for (int i = 0; i <= 60; ++i) {
+        for (int j = 0; i + j <= 60; ++j) {
+            const Scalar Sw = Scalar(i)/60;
+            const Scalar Sg = Scalar(j)/60;
+            fs.setSaturation(waterPhaseIdx, Sw);
+            fs.setSaturation(gasPhaseIdx, Sg);
+            fs.setSaturation(oilPhaseIdx, 1.0 - Sw - Sg);
+
+            MaterialLaw::relativePermeabilities(exactKr, params, fs);
+            MaterialLaw::relativePermeabilities(tabulatedKr, tabulatedParams, fs);
+            if (tabulatedKr[waterPhaseIdx] != exactKr[waterPhaseIdx]
+                || tabulatedKr[gasPhaseIdx] != exactKr[gasPhaseIdx])
+                throw std::logic_error("The tabulation of the oil relperm modified the other relperms");
+
+            const Scalar exactKro = Opm::scalarValue(exactKr[oilPhaseIdx]);
+            const Scalar tabulatedKro = Opm::scalarValue(tabulatedKr[oilPhaseIdx]);
+            if (std::abs(tabulatedKro - exactKro) > 4*tolerance)
+                throw std::logic_error("The tabulated oil relperm deviates from the exact one at Sw="
+                                       + std::to_string(Sw) + ", Sg=" + std::to_string(Sg));
+
+            if (Sw < Swl && !clampsConnateWater && tabulatedKro != exactKro)
+                throw std::logic_error("The oil relperm was looked up outside of the range of the table");
+
+            Evaluation pc[numPhases];
+            Evaluation combinedPc[numPhases];
+            Evaluation combinedKr[numPhases];
+            MaterialLaw::capillaryPressures(pc, tabulatedParams, fs);
+            MaterialLaw::capillaryPressuresAndRelativePermeabilities(combinedPc, combinedKr, tabulatedParams, fs);
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                if (combinedPc[phaseIdx] != pc[phaseIdx] || combinedKr[phaseIdx] != tabulatedKr[phaseIdx])
+                    throw std::logic_error("Discrepancy between the combined and the individual "
+                                           "evaluation of the tabulated oil relperm");
+        }
+    }
+
+    // the table is part of the serialized parameters
+    Opm::BinaryWriter writer;
+    tabulatedParams.serialize(writer);
+    Opm::BinaryReader reader(writer.data());
+    Params restoredParams;
+    restoredParams.deserialize(reader);
+    if (!restoredParams.kroTable()
+        || restoredParams.kroTable()->numX() != kroTable->numX()
+        || restoredParams.kroTable()->eval(Scalar(0.35), Scalar(0.2)) != kroTable->eval(Scalar(0.35), Scalar(0.2)))
+        throw std::logic_error("The table of the oil relperm did not survive the serialization");
+
+    params.setKroTable(kroTable);
+}
+
+template <class MaterialLaw, class FluidState>
+void testParkerLenhardHysteresis()
+{
+    typedef typename MaterialLaw::Params Params;
+    typedef typename MaterialLaw::Scalar Scalar;
+    typedef typename Params::VanGenuchtenParams VanGenuchtenParams;
+    enum { wettingPhaseIdx = MaterialLaw::wettingPhaseIdx };
+    enum { nonWettingPhaseIdx = MaterialLaw::nonWettingPhaseIdx };
+
+    VanGenuchtenParams micParams;
+    micParams.setVgAlpha(1.0/4000);
+    micParams.setVgN(3.0);
+    micParams.finalize();
+
+    VanGenuchtenParams mdcParams;
+    mdcParams.setVgAlpha(1.0/2000);
+    mdcParams.setVgN(3.0);
+    mdcParams.finalize();
+
+    auto initParams = [&](Params& params) {
+        params.setMicParams(&micParams);
+        params.setMdcParams(&mdcParams);
+        params.setSwr(0.1);
+        params.setSnr(0.1);
+        params.finalize();
+        MaterialLaw::reset(params);
+    };
+
+    // saturations which oscillate with a slowly decreasing amplitude
+    FluidState fs;
+    auto setSaturation = [&](unsigned stepIdx) {
+        Scalar Sw = 0.5 + 0.35*std::sin(0.37*stepIdx) + 0.1*std::sin(1.3*stepIdx);
+        fs.setSaturation(wettingPhaseIdx, Sw);
+        fs.setSaturation(nonWettingPhaseIdx, 1 - Sw);
+    };
+
+    Params params;
+    initParams(params);
+
+    const unsigned numSteps = 150;
+    const unsigned checkpointStep = 100;
+    Params checkpoint(params);
+    int checkpointPiscLoop = -2;
+    int checkpointCscLoop = -2;
+    Scalar checkpointSnr = 0.0;
+    std::vector<Scalar> pc;
+    for (unsigned stepIdx = 0; stepIdx < numSteps; ++stepIdx) {
+        if (stepIdx == checkpointStep) {
+            checkpoint.mdc()->assign(*params.mdc());
+            checkpointPiscLoop = params.pisc() ? params.pisc()->loopNum() : -2;
+            checkpointCscLoop = params.csc()->loopNum();
+            checkpointSnr = params.currentSnr();
+        }
+
+        setSaturation(stepIdx);
+        MaterialLaw::update(params, fs);
+        pc.push_back(MaterialLaw::template pcnw<FluidState, Scalar>(params, fs));
+    }
+
+    // restoring the checkpoint must reproduce the history of the hysteresis model
+    params.mdc()->assign(*checkpoint.mdc());
+    params.setPisc(params.mdc()->curveForLoop(checkpointPiscLoop));
+    params.setCsc(params.mdc()->curveForLoop(checkpointCscLoop));
+    params.setCurrentSnr(checkpointSnr);
+    for (unsigned stepIdx = checkpointStep; stepIdx < numSteps; ++stepIdx) {
+        setSaturation(stepIdx);
+        MaterialLaw::update(params, fs);
+        if (MaterialLaw::template pcnw<FluidState, Scalar>(params, fs) != pc[stepIdx])
+            throw std::logic_error("Restoring a checkpoint of the Parker-Lenhard hysteresis "
+                                   "model does not reproduce its history");
+    }
+
+    // the number of scanning curves is bounded
+    Params boundedParams;
+    initParams(boundedParams);
+    boundedParams.setMaxScanningLoops(2);
+    MaterialLaw::reset(boundedParams);
+    for (unsigned stepIdx = 0; stepIdx < numSteps; ++stepIdx) {
+        setSaturation(stepIdx);
+        MaterialLaw::update(boundedParams, fs);
+        if (boundedParams.csc()->loopNum() >= 2
+            || !std::isfinite(MaterialLaw::template pcnw<FluidState, Scalar>(boundedParams, fs)))
+            throw std::logic_error("The bounded scanning curve storage of the Parker-Lenhard "
+                                   "hysteresis model does not work");
+    }
+}
+
+template <class Traits>
+void testTabulatedTwoPhaseMaterial()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::RegularizedVanGenuchten<Traits> RawLaw;
+    typedef Opm::TabulatedTwoPhaseMaterial<RawLaw> MaterialLaw;
+
+    typename RawLaw::Params rawParams;
+    rawParams.setVgAlpha(1.0/5000);
+    rawParams.setVgN(2.5);
+    rawParams.finalize();
+
+    const Scalar tolerance = 1e-3;
+    typename MaterialLaw::Params params;
+    params.setRawParams(&rawParams);
+    params.setTolerance(tolerance);
+    params.finalize();
+
+    const Scalar pcScale = std::abs(RawLaw::twoPhaseSatPcnw(rawParams, Scalar(0.5)));
+    const unsigned numSamples = 1000;
+    for (unsigned i = 0; i <= numSamples; ++i) {
+        Scalar Sw = Scalar(i)/numSamples;
+
+        Scalar pc = MaterialLaw::twoPhaseSatPcnw(params, Sw);
+        Scalar pcRaw = RawLaw::twoPhaseSatPcnw(rawParams, Sw);
+        Scalar krw = MaterialLaw::twoPhaseSatKrw(params, Sw);
+        Scalar krwRaw = RawLaw::twoPhaseSatKrw(rawParams, Sw);
+        Scalar krn = MaterialLaw::twoPhaseSatKrn(params, Sw);
+        Scalar krnRaw = RawLaw::twoPhaseSatKrn(rawParams, Sw);
+
+        // the deviation is only controlled at the centers of the intervals, so allow
+        // some slack
+        if (std::abs(pc - pcRaw) > 4*tolerance*std::max(std::abs(pcRaw), pcScale)
+            || std::abs(krw - krwRaw) > 4*tolerance*std::max<Scalar>(krwRaw, 1.0)
+            || std::abs(krn - krnRaw) > 4*tolerance*std::max<Scalar>(krnRaw, 1.0))
+            throw std::logic_error("The tabulated two-phase material law deviates too much "
+                                   "from the raw law at Sw = "+std::to_string(Sw));
+    }
+
+    // the tabulated law must be consistent with its inverse
+    Scalar pc = MaterialLaw::twoPhaseSatPcnw(params, Scalar(0.3));
+    Scalar Sw = MaterialLaw::twoPhaseSatSw(params, pc);
+    if (std::abs(Sw - 0.3) > 1e-4)
+        throw std::logic_error("The inverse of the tabulated capillary pressure is inconsistent");
+}
+
+// make sure that capillaryPressuresAndRelativePermeabilities() yields the same results
+// as capillaryPressures() and relativePermeabilities()
+template <class MaterialLaw, class FluidState>
+void testCombinedEvaluation(const typename MaterialLaw::Params& params)
+{
+    typedef typename MaterialLaw::Scalar Scalar;
+    enum { numPhases = MaterialLaw::numPhases };
+
+    FluidState fs;
+    const unsigned numSamples = 20;
+    for (unsigned i = 0; i <= numSamples; ++i) {
+        for (unsigned j = 0; i + j <= numSamples; ++j) {
+            Scalar Sw = Scalar(i)/numSamples;
+            Scalar Sn = Scalar(j)/numSamples;
+            fs.setSaturation(MaterialLaw::wettingPhaseIdx, Sw);
+            fs.setSaturation(MaterialLaw::nonWettingPhaseIdx, Sn);
+            fs.setSaturation(MaterialLaw::gasPhaseIdx, 1 - Sw - Sn);
+
+            Scalar pc[numPhases];
+            Scalar kr[numPhases];
+            Scalar pcRef[numPhases];
+            Scalar krRef[numPhases];
+            Opm::capillaryPressuresAndRelativePermeabilities<MaterialLaw>(pc, kr, params, fs);
+            MaterialLaw::capillaryPressures(pcRef, params, fs);
+            MaterialLaw::relativePermeabilities(krRef, params, fs);
+
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                if (!(std::abs(pc[phaseIdx] - pcRef[phaseIdx])
+                      <= 1e-5*std::max<Scalar>(std::abs(pcRef[phaseIdx]), 1.0))
+                    || !(std::abs(kr[phaseIdx] - krRef[phaseIdx]) <= 1e-5))
+                    throw std::logic_error("capillaryPressuresAndRelativePermeabilities() deviates "
+                                           "from the individual methods "
+                                           "for Sw = "+std::to_string(Sw)
+                                           +", Sn = "+std::to_string(Sn));
+            }
+        }
+    }
+}
+
+// make sure that the fused table of the piecewise linear law yields the same results as
+// the individual curves
+template <class Traits, class Evaluation>
+void testPiecewiseLinearFusedTable()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+
+    std::vector<Scalar> SwSamples = { 0.1, 0.2, 0.4, 0.7, 0.9 };
+    std::vector<Scalar> SwKrnSamples = { 0.1, 0.3, 0.4, 0.7, 0.9 };
+    std::vector<Scalar> pcSamples = { 3e5, 1e5, 4e4, 1e4, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.05, 0.2, 0.5, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.6, 0.3, 0.1, 0.0 };
+
+    for (int shared = 0; shared < 2; ++shared) {
+        typename MaterialLaw::Params params;
+        params.setPcnwSamples(SwSamples, pcSamples);
+        params.setKrwSamples(SwSamples, krwSamples);
+        params.setKrnSamples(shared ? SwSamples : SwKrnSamples, krnSamples);
+        params.finalize();
+
+        if (params.hasSharedSamples() != static_cast<bool>(shared))
+            throw std::logic_error("Shared sampling points of a piecewise linear law not detected");
+
+        for (int i = -2; i <= 22; ++i) {
+            const Evaluation& Sw = Evaluation::createVariable(Scalar(i)/20, 0);
+
+            Evaluation pcnw;
+            Evaluation krw;
+            Evaluation krn;
+            MaterialLaw::twoPhaseSatPcnwAndKr(&pcnw, &krw, &krn, params, Sw);
+            if (pcnw != MaterialLaw::twoPhaseSatPcnw(params, Sw)
+                || krw != MaterialLaw::twoPhaseSatKrw(params, Sw)
+                || krn != MaterialLaw::twoPhaseSatKrn(params, Sw))
+                throw std::logic_error("The combined evaluation of a piecewise linear law "
+                                       "deviates from the individual curves");
+        }
+    }
+}
+
+// make sure that evaluating a piecewise linear law in single precision yields the
+// values and derivatives of the law evaluated in the precision of the caller within
+// the accuracy of single precision
+template <class Traits, class Evaluation>
+void testMixedPrecisionTwoPhaseLaw()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::TwoPhaseMaterialTraits<float,
+                                        Traits::wettingPhaseIdx,
+                                        Traits::nonWettingPhaseIdx> FloatTraits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<FloatTraits> FloatMaterialLaw;
+    typedef Opm::MixedPrecisionTwoPhaseLaw<Traits, FloatMaterialLaw> MixedMaterialLaw;
+
+    std::vector<Scalar> SwSamples = { 0.1, 0.2, 0.35, 0.5, 0.7, 0.9 };
+    std::vector<Scalar> pcSamples = { 3e5, 1e5, 5e4, 2e4, 1e4, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.05, 0.1, 0.3, 0.6, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.7, 0.4, 0.2, 0.05, 0.0 };
+
+    typename MaterialLaw::Params params;
+    params.setPcnwSamples(SwSamples, pcSamples);
+    params.setKrwSamples(SwSamples, krwSamples);
+    params.setKrnSamples(SwSamples, krnSamples);
+    params.finalize();
+
+    typename MixedMaterialLaw::Params floatParams;
+    floatParams.setPcnwSamples(SwSamples, pcSamples);
+    floatParams.setKrwSamples(SwSamples, krwSamples);
+    floatParams.setKrnSamples(SwSamples, krnSamples);
+    floatParams.finalize();
+
+    // the derivatives are compared with a looser tolerance because the slopes of the
+    // curves are about ten times larger than their values
+    const Scalar tol = 1e2*std::numeric_limits<float>::epsilon();
+    auto close = [tol](const Evaluation& a, const Evaluation& b, Scalar scale) {
+        if (std::abs(a.value() - b.value()) > tol*scale)
+            return false;
+        for (int varIdx = 0; varIdx < Evaluation::size; ++varIdx)
+            if (std::abs(a.derivative(varIdx) - b.derivative(varIdx)) > tol*scale*10)
+                return false;
+        return true;
+    };
+
+    for (int i = -10; i <= 110; ++i) {
+        const Evaluation& Sw = Evaluation::createVariable(Scalar(i)/100 + Scalar(1e-3), 0);
+
+        Evaluation pcnw;
+        Evaluation krw;
+        Evaluation krn;
+        MixedMaterialLaw::twoPhaseSatPcnwAndKr(&pcnw, &krw, &krn, floatParams, Sw);
+        if (!close(pcnw, MaterialLaw::twoPhaseSatPcnw(params, Sw), 3e5)
+            || !close(MixedMaterialLaw::twoPhaseSatPcnw(floatParams, Sw), pcnw, 3e5))
+            throw std::logic_error("Discrepancy of the capillary pressure if evaluating in single precision");
+        if (!close(krw, MaterialLaw::twoPhaseSatKrw(params, Sw), 1.0)
+            || !close(MixedMaterialLaw::twoPhaseSatKrw(floatParams, Sw), krw, 1.0))
+            throw std::logic_error("Discrepancy of the wetting relperm if evaluating in single precision");
+        if (!close(krn, MaterialLaw::twoPhaseSatKrn(params, Sw), 1.0)
+            || !close(MixedMaterialLaw::twoPhaseSatKrn(floatParams, Sw), krn, 1.0))
+            throw std::logic_error("Discrepancy of the non-wetting relperm if evaluating in single precision");
+    }
+}
+
+// make sure that evaluating a two-phase law using an evaluation which only considers
+// the derivative with regard to the saturation yields the same values and derivatives
+// as evaluating it with all derivatives of the caller
+template <class Traits, class Evaluation>
+void testReducedDerivativeTwoPhaseLaw()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::RegularizedVanGenuchten<Traits> MaterialLaw;
+    typedef Opm::ReducedDerivativeTwoPhaseLaw<Traits, MaterialLaw> ReducedMaterialLaw;
+
+    typename MaterialLaw::Params params;
+    params.setVgAlpha(1.0/5000);
+    params.setVgN(2.5);
+    params.finalize();
+
+    const Scalar tol = 1e2*std::numeric_limits<Scalar>::epsilon();
+    auto close = [tol](const Evaluation& a, const Evaluation& b) {
+        if (std::abs(a.value() - b.value()) > tol*std::abs(b.value()))
+            return false;
+        for (int varIdx = 0; varIdx < Evaluation::size; ++varIdx)
+            if (std::abs(a.derivative(varIdx) - b.derivative(varIdx))
+                > tol*std::abs(b.derivative(varIdx)))
+                return false;
+        return true;
+    };
+
+    for (int i = 1; i < 100; ++i) {
+        // the saturation depends on all primary variables
+        Evaluation Sw = Scalar(i)/100;
+        for (int varIdx = 0; varIdx < Evaluation::size; ++varIdx)
+            Sw.setDerivative(varIdx, Scalar(varIdx + 1)/10);
+
+        Evaluation pcnw;
+        Evaluation krw;
+        Evaluation krn;
+        ReducedMaterialLaw::twoPhaseSatPcnwAndKr(&pcnw, &krw, &krn, params, Sw);
+        if (!close(pcnw, MaterialLaw::twoPhaseSatPcnw(params, Sw))
+            || !close(ReducedMaterialLaw::twoPhaseSatPcnw(params, Sw), pcnw))
+            throw std::logic_error("Discrepancy of the capillary pressure if evaluating using reduced derivatives");
+        if (!close(krw, MaterialLaw::twoPhaseSatKrw(params, Sw))
+            || !close(ReducedMaterialLaw::twoPhaseSatKrw(params, Sw), krw))
+            throw std::logic_error("Discrepancy of the wetting relperm if evaluating using reduced derivatives");
+        if (!close(krn, MaterialLaw::twoPhaseSatKrn(params, Sw))
+            || !close(ReducedMaterialLaw::twoPhaseSatKrn(params, Sw), krn))
+            throw std::logic_error("Discrepancy of the non-wetting relperm if evaluating using reduced derivatives");
+
+        const Evaluation& Sw2 = ReducedMaterialLaw::twoPhaseSatSw(params, pcnw);
+        if (!close(Sw2, MaterialLaw::twoPhaseSatSw(params, pcnw)))
+            throw std::logic_error("Discrepancy of the inverse capillary pressure if evaluating using reduced derivatives");
+    }
+}
+
+// make sure that the flat representation of the piecewise linear law which can be
+// evaluated by device code yields the same results as the law itself. this includes
+// curves which are specified in descending order and curves with jumps.
+template <class Traits, class Evaluation>
+void testFlatPiecewiseLinear()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+
+    std::vector<Scalar> SwSamples = { 0.1, 0.2, 0.4, 0.4, 0.7, 0.9 };
+    std::vector<Scalar> SwDescendingSamples = { 0.9, 0.7, 0.4, 0.3, 0.2, 0.1 };
+    std::vector<Scalar> pcSamples = { 3e5, 1e5, 4e4, 2e4, 1e4, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.05, 0.2, 0.3, 0.5, 1.0 };
+    std::vector<Scalar> krnSamples = { 0.0, 0.1, 0.3, 0.6, 0.8, 1.0 };
+
+    typename MaterialLaw::Params params;
+    params.setPcnwSamples(SwSamples, pcSamples);
+    params.setKrwSamples(SwSamples, krwSamples);
+    params.setKrnSamples(SwDescendingSamples, krnSamples);
+    params.finalize();
+
+    Opm::FlatTableBuffer<Scalar> buffer;
+    const auto& flatParams = params.exportFlat(buffer);
+    const auto& data = buffer.data();
+
+    for (int i = -2; i <= 22; ++i) {
+        const Evaluation& Sw = Evaluation::createVariable(Scalar(i)/20, 0);
+
+        Evaluation pcnw;
+        Evaluation krw;
+        Evaluation krn;
+        flatParams.twoPhaseSatPcnwAndKr(&pcnw, &krw, &krn, data, Sw);
+        if (pcnw != MaterialLaw::twoPhaseSatPcnw(params, Sw)
+            || krw != MaterialLaw::twoPhaseSatKrw(params, Sw)
+            || krn != MaterialLaw::twoPhaseSatKrn(params, Sw))
+            throw std::logic_error("The flat representation of a piecewise linear law "
+                                   "deviates from the law");
+    }
+}
+
+// make sure that resampling the tables of the piecewise linear law onto a uniform grid
+// stays within the tolerance and does not change the segments which are found
+template <class Traits>
+void testPiecewiseLinearUniformResampling()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+
+    std::vector<Scalar> SwSamples = { 0.12, 0.15, 0.2, 0.33, 0.5, 0.72, 0.8, 0.88 };
+    std::vector<Scalar> pcSamples = { 4e5, 2e5, 1e5, 5e4, 2e4, 1e4, 5e3, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.01, 0.03, 0.1, 0.25, 0.5, 0.7, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.9, 0.75, 0.5, 0.2, 0.05, 0.01, 0.0 };
+
+    // by default, the sampling points are reproduced exactly
+    typename MaterialLaw::Params exactParams;
+    exactParams.setPcnwSamples(SwSamples, pcSamples);
+    exactParams.setKrwSamples(SwSamples, krwSamples);
+    exactParams.setKrnSamples(SwSamples, krnSamples);
+    exactParams.finalize();
+    if (exactParams.hasUniformSamples()
+        || !std::equal(SwSamples.begin(), SwSamples.end(), exactParams.SwPcwnSamples().begin()))
+        throw std::logic_error("The tables of a piecewise linear law were resampled by default");
+
+    const Scalar tolerance = 1e-2;
+    typename MaterialLaw::Params uniformParams;
+    uniformParams.setPcnwSamples(SwSamples, pcSamples);
+    uniformParams.setKrwSamples(SwSamples, krwSamples);
+    uniformParams.setKrnSamples(SwSamples, krnSamples);
+    uniformParams.setUniformResampling(tolerance);
+    uniformParams.finalize();
+    if (!uniformParams.hasUniformSamples() || !uniformParams.hasSharedSamples())
+        throw std::logic_error("The tables of a piecewise linear law were not resampled");
+
+    // the same resampled tables, but looked up by bisection
+    typename MaterialLaw::Params bisectionParams;
+    bisectionParams.setPcnwSamples(uniformParams.SwPcwnSamples(), uniformParams.pcnwSamples());
+    bisectionParams.setKrwSamples(uniformParams.SwKrwSamples(), uniformParams.krwSamples());
+    bisectionParams.setKrnSamples(uniformParams.SwKrnSamples(), uniformParams.krnSamples());
+    bisectionParams.finalize();
+
+    for (int i = 0; i <= 1000; ++i) {
+        Scalar Sw = Scalar(i)/1000;
+
+        Scalar pcnw = MaterialLaw::twoPhaseSatPcnw(uniformParams, Sw);
+        Scalar krw = MaterialLaw::twoPhaseSatKrw(uniformParams, Sw);
+        Scalar krn = MaterialLaw::twoPhaseSatKrn(uniformParams, Sw);
+        if (std::abs(pcnw - MaterialLaw::twoPhaseSatPcnw(exactParams, Sw)) > 1.01*tolerance*4e5
+            || std::abs(krw - MaterialLaw::twoPhaseSatKrw(exactParams, Sw)) > 1.01*tolerance
+            || std::abs(krn - MaterialLaw::twoPhaseSatKrn(exactParams, Sw)) > 1.01*tolerance)
+            throw std::logic_error("The resampled tables of a piecewise linear law are inaccurate");
+
+        if (pcnw != MaterialLaw::twoPhaseSatPcnw(bisectionParams, Sw)
+            || krw != MaterialLaw::twoPhaseSatKrw(bisectionParams, Sw)
+            || krn != MaterialLaw::twoPhaseSatKrn(bisectionParams, Sw))
+            throw std::logic_error("The uniform segment lookup of a piecewise linear law "
+                                   "deviates from the bisection");
+    }
+
+    // curves with jumps cannot be resampled, so the original tables must be kept
+    std::vector<Scalar> SwJumpSamples = { 0.1, 0.4, 0.4, 0.9 };
+    std::vector<Scalar> krJumpSamples = { 0.0, 0.2, 0.6, 1.0 };
+    typename MaterialLaw::Params jumpParams;
+    jumpParams.setPcnwSamples(SwJumpSamples, krJumpSamples);
+    jumpParams.setKrwSamples(SwJumpSamples, krJumpSamples);
+    jumpParams.setKrnSamples(SwJumpSamples, krJumpSamples);
+    jumpParams.setUniformResampling(tolerance, /*maxSamples=*/200);
+    jumpParams.finalize();
+    if (jumpParams.hasUniformSamples() || jumpParams.SwKrwSamples().size() != SwJumpSamples.size())
+        throw std::logic_error("A piecewise linear law with a jump was resampled");
+}
+
+// make sure that simplifying the tables of the piecewise linear law removes the
+// redundant sampling points and stays within the tolerance
+template <class Traits>
+void testPiecewiseLinearSimplification()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+
+    // a finely sampled table as produced by upscaling tools: the relative
+    // permeabilities are piecewise linear with a kink at Sw = 0.5 and the capillary
+    // pressure exhibits some noise
+    const unsigned numSamples = 201;
+    std::vector<Scalar> SwSamples(numSamples);
+    std::vector<Scalar> pcSamples(numSamples);
+    std::vector<Scalar> krwSamples(numSamples);
+    std::vector<Scalar> krnSamples(numSamples);
+    for (unsigned i = 0; i < numSamples; ++i) {
+        Scalar Sw = 0.1 + 0.8*Scalar(i)/(numSamples - 1);
+        SwSamples[i] = Sw;
+        pcSamples[i] = 1e5*(0.9 - Sw) + ((i % 2)? 1.0 : -1.0);
+        krwSamples[i] = (Sw < 0.5)? 0.5*(Sw - 0.1) : 0.2 + 2.0*(Sw - 0.5);
+        krnSamples[i] = (0.9 - Sw)/0.8;
+    }
+
+    typename MaterialLaw::Params exactParams;
+    exactParams.setPcnwSamples(SwSamples, pcSamples);
+    exactParams.setKrwSamples(SwSamples, krwSamples);
+    exactParams.setKrnSamples(SwSamples, krnSamples);
+    exactParams.finalize();
+    if (exactParams.tableSimplificationStats().numSamplesBefore() != 0)
+        throw std::logic_error("The tables of a piecewise linear law were simplified by default");
+
+    const Scalar tolerance = 1e-4;
+    typename MaterialLaw::Params simplifiedParams;
+    simplifiedParams.setPcnwSamples(SwSamples, pcSamples);
+    simplifiedParams.setKrwSamples(SwSamples, krwSamples);
+    simplifiedParams.setKrnSamples(SwSamples, krnSamples);
+    simplifiedParams.setTableSimplification(tolerance);
+    simplifiedParams.finalize();
+
+    // the first and the last sampling points plus the kink are required
+    const auto& stats = simplifiedParams.tableSimplificationStats();
+    if (!simplifiedParams.hasSharedSamples()
+        || simplifiedParams.SwKrwSamples().size() != 3
+        || stats.numSamplesBefore() != 3*numSamples
+        || stats.numSamplesAfter() != 3*3)
+        throw std::logic_error("The tables of a piecewise linear law were not simplified");
+
+    for (int i = 0; i <= 1000; ++i) {
+        Scalar Sw = Scalar(i)/1000;
+        if (std::abs(MaterialLaw::twoPhaseSatPcnw(simplifiedParams, Sw)
+                     - MaterialLaw::twoPhaseSatPcnw(exactParams, Sw)) > 1.01*tolerance*0.8e5
+            || std::abs(MaterialLaw::twoPhaseSatKrw(simplifiedParams, Sw)
+                        - MaterialLaw::twoPhaseSatKrw(exactParams, Sw)) > 1.01*tolerance
+            || std::abs(MaterialLaw::twoPhaseSatKrn(simplifiedParams, Sw)
+                        - MaterialLaw::twoPhaseSatKrn(exactParams, Sw)) > 1.01*tolerance)
+            throw std::logic_error("The simplified tables of a piecewise linear law are inaccurate");
+    }
+
+    // the sampling points of jumps must be kept
+    std::vector<Scalar> SwJumpSamples = { 0.1, 0.2, 0.4, 0.4, 0.6, 0.9 };
+    std::vector<Scalar> krJumpSamples = { 0.0, 0.1, 0.3, 0.5, 0.7, 1.0 };
+    typename MaterialLaw::Params jumpParams;
+    jumpParams.setPcnwSamples(SwJumpSamples, krJumpSamples);
+    jumpParams.setKrwSamples(SwJumpSamples, krJumpSamples);
+    jumpParams.setKrnSamples(SwJumpSamples, krJumpSamples);
+    jumpParams.setTableSimplification(tolerance);
+    jumpParams.finalize();
+    if (jumpParams.SwKrwSamples() != std::vector<Scalar>({ 0.1, 0.4, 0.4, 0.9 }))
+        throw std::logic_error("The simplification of a piecewise linear law removed a jump");
+}
+
+// make sure that the inverse tables of the piecewise linear law invert the curves also
+// if they exhibit flat sections
+template <class Traits>
+void testPiecewiseLinearInverse()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+
+    std::vector<Scalar> SwSamples = { 0.0, 0.1, 0.2, 0.4, 0.6, 0.8, 0.9, 1.0 };
+    std::vector<Scalar> pcSamples = { 3e5, 2e5, 1e5, 1e5, 5e4, 0.0, 0.0, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.0, 0.0, 0.1, 0.3, 0.6, 0.8, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.5, 0.2, 0.3, 0.1, 0.0, 0.0, 0.0 };
+
+    typename MaterialLaw::Params params;
+    params.setPcnwSamples(SwSamples, pcSamples);
+    params.setKrwSamples(SwSamples, krwSamples);
+    params.setKrnSamples(SwSamples, krnSamples);
+    params.finalize();
+
+    // the non-wetting phase relperm is not monotonic, so it cannot be inverted
+    if (!params.hasPcnwInverse() || !params.hasKrwInverse() || params.hasKrnInverse())
+        throw std::logic_error("The monotonicity of the curves of a piecewise linear law "
+                               "was not detected correctly");
+
+    for (int i = 0; i <= 100; ++i) {
+        Scalar Sw = Scalar(i)/100;
+
+        Scalar pcnw = MaterialLaw::twoPhaseSatPcnw(params, Sw);
+        if (40 < i && i < 80
+            && std::abs(MaterialLaw::twoPhaseSatPcnwInv(params, pcnw) - Sw) > 1e-5)
+            throw std::logic_error("The inverse capillary pressure of a piecewise linear law is wrong");
+
+        Scalar krw = MaterialLaw::twoPhaseSatKrw(params, Sw);
+        if (20 < i && std::abs(MaterialLaw::twoPhaseSatKrwInv(params, krw) - Sw) > 1e-5)
+            throw std::logic_error("The inverse wetting phase relperm of a piecewise linear law is wrong");
+    }
+
+    // the values of flat sections map to their end point which is adjacent to the
+    // smaller values of the curve, or to the end of the table
+    if (std::abs(MaterialLaw::twoPhaseSatPcnwInv(params, Scalar(1e5)) - 0.4) > 1e-5
+        || std::abs(MaterialLaw::twoPhaseSatPcnwInv(params, Scalar(0.0)) - 1.0) > 1e-5
+        || std::abs(MaterialLaw::twoPhaseSatKrwInv(params, Scalar(0.0)) - 0.0) > 1e-5)
+        throw std::logic_error("The inverse of a flat section of a piecewise linear law is wrong");
+}
+
+// make sure that the monotone cubic interpolation of the piecewise linear law
+// reproduces the sampling points, does not overshoot them and is continuously
+// differentiable, also if the curves are looked up using the fused table
+template <class Traits, class Evaluation>
+void testPiecewiseLinearMonotoneCubic()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+
+    std::vector<Scalar> SwSamples = { 0.12, 0.15, 0.2, 0.33, 0.5, 0.72, 0.8, 0.88 };
+    std::vector<Scalar> SwKrnSamples = { 0.12, 0.17, 0.2, 0.3, 0.5, 0.7, 0.8, 0.88 };
+    std::vector<Scalar> pcSamples = { 4e5, 2e5, 1e5, 5e4, 2e4, 1e4, 5e3, 0.0 };
+    std::vector<Scalar> krwSamples = { 0.0, 0.01, 0.03, 0.1, 0.25, 0.5, 0.7, 1.0 };
+    std::vector<Scalar> krnSamples = { 1.0, 0.9, 0.75, 0.5, 0.2, 0.05, 0.01, 0.0 };
+
+    for (int shared = 0; shared < 2; ++shared) {
+        typename MaterialLaw::Params params;
+        params.setPcnwSamples(SwSamples, pcSamples);
+        params.setKrwSamples(SwSamples, krwSamples);
+        params.setKrnSamples(shared ? SwSamples : SwKrnSamples, krnSamples);
+        params.setInterpolation(Opm::TableInterpolation::MonotoneCubic);
+        params.finalize();
+
+        const auto& SwKrn = params.SwKrnSamples();
+        for (size_t i = 0; i < SwSamples.size(); ++i) {
+            if (std::abs(MaterialLaw::twoPhaseSatPcnw(params, SwSamples[i]) - pcSamples[i]) > 1e-5*4e5
+                || std::abs(MaterialLaw::twoPhaseSatKrw(params, SwSamples[i]) - krwSamples[i]) > 1e-5
+                || std::abs(MaterialLaw::twoPhaseSatKrn(params, SwKrn[i]) - krnSamples[i]) > 1e-5)
+                throw std::logic_error("The monotone cubic interpolation of a piecewise linear law "
+                                       "does not reproduce the sampling points");
+        }
+
+        // the curves are monotonic, so they must be between their values at the ends
+        // of each segment
+        for (int i = 0; i <= 1000; ++i) {
+            Scalar Sw = Scalar(i)/1000;
+            Evaluation pcnw;
+            Evaluation krw;
+            Evaluation krn;
+            MaterialLaw::twoPhaseSatPcnwAndKr(&pcnw, &krw, &krn, params,
+                                              Evaluation::createVariable(Sw, 0));
+            if (pcnw != MaterialLaw::twoPhaseSatPcnw(params, Evaluation::createVariable(Sw, 0))
+                || krw != MaterialLaw::twoPhaseSatKrw(params, Evaluation::createVariable(Sw, 0))
+                || krn != MaterialLaw::twoPhaseSatKrn(params, Evaluation::createVariable(Sw, 0)))
+                throw std::logic_error("The combined evaluation of a piecewise cubic law "
+                                       "deviates from the individual curves");
+
+            if (pcnw.derivative(0) > 0.0 || krw.derivative(0) < 0.0 || krn.derivative(0) > 0.0
+                || krw.value() < 0.0 || krw.value() > 1.0 || krn.value() < 0.0 || krn.value() > 1.0)
+                throw std::logic_error("The monotone cubic interpolation of a piecewise linear law "
+                                       "overshoots");
+        }
+
+        // the derivatives must be continuous at the interior sampling points
+        for (size_t i = 1; i + 1 < SwSamples.size(); ++i) {
+            Scalar eps = 1e-4*(SwSamples[i + 1] - SwSamples[i - 1]);
+            const Evaluation& left =
+                MaterialLaw::twoPhaseSatKrw(params, Evaluation::createVariable(SwSamples[i] - eps, 0));
+            const Evaluation& right =
+                MaterialLaw::twoPhaseSatKrw(params, Evaluation::createVariable(SwSamples[i] + eps, 0));
+            if (std::abs(left.derivative(0) - right.derivative(0)) > 1e-2*(1 + std::abs(left.derivative(0))))
+                throw std::logic_error("The derivative of the monotone cubic interpolation of a "
+                                       "piecewise linear law is not continuous");
+        }
+    }
+}
+
+template <class Traits>
+void testRegularizedVanGenuchtenPcnw()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::RegularizedVanGenuchten<Traits> MaterialLaw;
+
+    typename MaterialLaw::Params params;
+    params.setVgAlpha(1.0/5000);
+    params.setVgN(2.5);
+    params.finalize();
+
+    // the precomputed polynomial must agree with the spline of the parameters
+    const auto& spline = params.pcnwHighSpline();
+    const unsigned numSamples = 100;
+    for (unsigned i = 0; i <= numSamples; ++i) {
+        Scalar Sw = params.pcnwHighSw() + (1.0 - params.pcnwHighSw())*i/numSamples;
+        Scalar pc = MaterialLaw::twoPhaseSatPcnw(params, Sw);
+        Scalar pcSpline = spline.eval(Sw);
+        if (std::abs(pc - pcSpline) > 1e-3*std::max<Scalar>(std::abs(pcSpline), 1.0))
+            throw std::logic_error("The regularized van Genuchten law deviates from its "
+                                   "spline at Sw = "+std::to_string(Sw));
+    }
+
+    // the regularized curve must be continuous at the threshold saturations
+    const Scalar eps = 1e-5;
+    const Scalar pcScale = MaterialLaw::twoPhaseSatPcnw(params, Scalar(0.5));
+    for (Scalar SwTh : { params.pcnwLowSw(), params.pcnwHighSw(), Scalar(1.0) }) {
+        Scalar pc1 = MaterialLaw::twoPhaseSatPcnw(params, Scalar(SwTh - eps));
+        Scalar pc2 = MaterialLaw::twoPhaseSatPcnw(params, Scalar(SwTh + eps));
+        if (std::abs(pc1 - pc2) > 1e-2*std::max(std::abs(pc1), pcScale))
+            throw std::logic_error("The regularized van Genuchten law is not continuous "
+                                   "at Sw = "+std::to_string(SwTh));
+    }
+}
+
+template <class Traits>
+void testMaterialLawParamsRegistry()
+{
+    typedef typename Traits::Scalar Scalar;
+    typedef Opm::EffToAbsLaw<Opm::RegularizedVanGenuchten<Traits> > MaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+
+    // three rock types which are assigned to the cells in a round-robin fashion
+    const unsigned numRockTypes = 3;
+    const unsigned numCells = 100;
+    Opm::MaterialLawParamsRegistry<Params, unsigned short> registry;
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        unsigned rockTypeIdx = cellIdx%numRockTypes;
+
+        Params params;
+        params.setVgAlpha(1.0/(1000*(rockTypeIdx + 1)));
+        params.setVgN(2.0 + rockTypeIdx);
+        params.setResidualSaturation(Traits::wettingPhaseIdx, 0.1);
+        params.setResidualSaturation(Traits::nonWettingPhaseIdx, 0.0);
+        params.finalize();
+
+        registry.setCellParams(cellIdx, params);
+    }
+
+    if (registry.numParams() != numRockTypes)
+        throw std::logic_error("The parameter registry does not deduplicate identical objects");
+    if (registry.numCells() != numCells)
+        throw std::logic_error("The parameter registry has an invalid number of cells");
+
+    std::vector<std::vector<size_t> > cellsOfParams;
+    registry.groupCells(cellsOfParams);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        unsigned paramsIdx = registry.cellParamsIndex(cellIdx);
+        if (paramsIdx != cellIdx%numRockTypes)
+            throw std::logic_error("The parameter registry maps a cell to the wrong object");
+
+        const auto& cells = cellsOfParams[paramsIdx];
+        if (std::find(cells.begin(), cells.end(), cellIdx) == cells.end())
+            throw std::logic_error("A cell is missing in its group of the parameter registry");
+
+        const Params& params = registry.cellParams(cellIdx);
+        Scalar expectedN = 2.0 + paramsIdx;
+        if (std::abs(params.vgN() - expectedN) > 1e-6
+            || std::abs(params.vgInvM() - 1/(1 - 1/expectedN)) > 1e-4)
+            throw std::logic_error("The parameter registry returns wrong parameters");
+    }
+
+    // objects which only differ in the residual saturations must not be merged
+    Params params(registry.params(0));
+    params.setResidualSaturation(Traits::wettingPhaseIdx, 0.2);
+    params.finalize();
+    if (registry.intern(params) != numRockTypes)
+        throw std::logic_error("The parameter registry merges distinct objects");
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -393,6 +1775,12 @@ inline void testAll()
         testTwoPhaseApi<MaterialLaw, TwoPhaseFluidState>();
         testTwoPhaseSatApi<MaterialLaw, TwoPhaseFluidState>();
     }
+    {
+        typedef Opm::TabulatedTwoPhaseMaterial<Opm::RegularizedVanGenuchten<TwoPhaseTraits> > MaterialLaw;
+        testGenericApi<MaterialLaw, TwoPhaseFluidState>();
+        testTwoPhaseApi<MaterialLaw, TwoPhaseFluidState>();
+        testTwoPhaseSatApi<MaterialLaw, TwoPhaseFluidState>();
+    }
     {
         typedef Opm::VanGenuchten<TwoPhaseTraits> MaterialLaw;
         testGenericApi<MaterialLaw, TwoPhaseFluidState>();
@@ -412,6 +1800,92 @@ inline void testAll()
         testTwoPhaseSatApi<MaterialLaw, TwoPhaseFluidState>();
     }
 
+    testEclEpsBaking<Scalar>(/*threePointScaling=*/false);
+    testEclEpsBaking<Scalar>(/*threePointScaling=*/true);
+    testEclFloatStorage<Scalar>();
+    testEclQuantizedStorage<Scalar>();
+    testEclPassThroughLayers<Scalar>();
+    testEclEpsEnsemble<Scalar>(/*threePointScaling=*/false, /*satScaling=*/true);
+    testEclEpsEnsemble<Scalar>(/*threePointScaling=*/true, /*satScaling=*/true);
+    testEclEpsEnsemble<Scalar>(/*threePointScaling=*/false, /*satScaling=*/false);
+    testTabulatedTwoPhaseMaterial<TwoPhaseTraits>();
+    testRegularizedVanGenuchtenPcnw<TwoPhaseTraits>();
+    testPiecewiseLinearFusedTable<TwoPhaseTraits, Evaluation>();
+    testMixedPrecisionTwoPhaseLaw<TwoPhaseTraits, Evaluation>();
+    testReducedDerivativeTwoPhaseLaw<TwoPhaseTraits, Evaluation>();
+    testFlatPiecewiseLinear<TwoPhaseTraits, Evaluation>();
+    testPiecewiseLinearUniformResampling<TwoPhaseTraits>();
+    testPiecewiseLinearSimplification<TwoPhaseTraits>();
+    testPiecewiseLinearInverse<TwoPhaseTraits>();
+    testPiecewiseLinearMonotoneCubic<TwoPhaseTraits, Evaluation>();
+    testMaterialLawParamsRegistry<TwoPhaseTraits>();
+
+    {
+        typedef Opm::ThreePhaseParkerVanGenuchten<ThreePhaseTraits> MaterialLaw;
+        typedef Opm::ImmiscibleFluidState<Scalar, ThreePFluidSystem> FluidState;
+        typename MaterialLaw::Params params;
+        params.setVgAlpha(1.0/5000);
+        params.setVgN(2.5);
+        params.setSwr(0.1);
+        params.setSnr(0.05);
+        params.setSgr(0.05);
+        params.setSwrx(0.15);
+        params.setkrRegardsSnr(false);
+        params.finalize();
+        testCombinedEvaluation<MaterialLaw, FluidState>(params);
+    }
+    {
+        typedef Opm::LinearMaterial<ThreePhaseTraits> EffLaw;
+        typedef Opm::EffToAbsLaw<EffLaw> MaterialLaw;
+        typedef Opm::ImmiscibleFluidState<Scalar, ThreePFluidSystem> FluidState;
+        typename MaterialLaw::Params params;
+        for (unsigned phaseIdx = 0; phaseIdx < ThreePhaseTraits::numPhases; ++phaseIdx) {
+            params.setPcMinSat(phaseIdx, 0.0);
+            params.setPcMaxSat(phaseIdx, 1e5*(phaseIdx + 1));
+            params.setResidualSaturation(phaseIdx, 0.05*phaseIdx);
+        }
+        params.finalize();
+        testCombinedEvaluation<MaterialLaw, FluidState>(params);
+    }
+    testParkerLenhardHysteresis<Opm::ParkerLenhard<TwoPhaseTraits>,
+                                Opm::ImmiscibleFluidState<Scalar, TwoPFluidSystem> >();
+
+    {
+        typedef Opm::PiecewiseLinearTwoPhaseMaterial<TwoPhaseTraits> TwoPhaseMaterial;
+        typedef Opm::EclStone1Material<ThreePhaseTraits,
+                                       /*GasOilMaterial=*/TwoPhaseMaterial,
+                                       /*OilWaterMaterial=*/TwoPhaseMaterial> MaterialLaw;
+        typename MaterialLaw::Params params;
+        params.setEta(0.7);
+        testEclStoneKernel<MaterialLaw, ThreePhaseFluidState>(params);
+
+        // the kernel also needs to work if the oil relperm is tabulated. with an
+        // exponent below 1, the oil relperm of the Stone 1 model exhibits an infinite
+        // slope at zero oil saturation which cannot be tabulated accurately
+        params.setEta(1.0);
+        testEclKroTable<MaterialLaw, ThreePhaseFluidState>(params, /*clampsConnateWater=*/false);
+        testEclStoneKernel<MaterialLaw, ThreePhaseFluidState>(params);
+    }
+    {
+        typedef Opm::PiecewiseLinearTwoPhaseMaterial<TwoPhaseTraits> TwoPhaseMaterial;
+        typedef Opm::EclStone2Material<ThreePhaseTraits,
+                                       /*GasOilMaterial=*/TwoPhaseMaterial,
+                                       /*OilWaterMaterial=*/TwoPhaseMaterial> MaterialLaw;
+        typename MaterialLaw::Params params;
+        testEclStoneKernel<MaterialLaw, ThreePhaseFluidState>(params);
+
+        testEclKroTable<MaterialLaw, ThreePhaseFluidState>(params, /*clampsConnateWater=*/false);
+        testEclStoneKernel<MaterialLaw, ThreePhaseFluidState>(params);
+    }
+    {
+        typedef Opm::PiecewiseLinearTwoPhaseMaterial<TwoPhaseTraits> TwoPhaseMaterial;
+        typedef Opm::EclDefaultMaterial<ThreePhaseTraits,
+                                        /*GasOilMaterial=*/TwoPhaseMaterial,
+                                        /*OilWaterMaterial=*/TwoPhaseMaterial> MaterialLaw;
+        typename MaterialLaw::Params params;
+        testEclKroTable<MaterialLaw, ThreePhaseFluidState>(params, /*clampsConnateWater=*/true);
+    }
+
     {
         typedef Opm::BrooksCorey<TwoPhaseTraits> RawMaterialLaw;
         typedef Opm::EclEpsTwoPhaseLaw<RawMaterialLaw> MaterialLaw;
@@ -42,15 +42,24 @@
 #include <opm/material/fluidsystems/H2OAirFluidSystem.hpp>
 #include <opm/material/fluidsystems/H2OAirMesityleneFluidSystem.hpp>
 #include <opm/material/fluidsystems/H2OAirXyleneFluidSystem.hpp>
+#include <opm/material/fluidsystems/Spe5FluidSystem.hpp>
+#include <opm/material/fluidsystems/WilkeViscosityMixing.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/LiveOilPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/WetGasPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/ConstantCompressibilityWaterPvt.hpp>
+#include <opm/material/components/Dnapl.hpp>
 
 // include all fluid states
 #include <opm/material/fluidstates/PressureOverlayFluidState.hpp>
 #include <opm/material/fluidstates/SaturationOverlayFluidState.hpp>
 #include <opm/material/fluidstates/TemperatureOverlayFluidState.hpp>
+#include <opm/material/fluidstates/SingleValueOverlayFluidState.hpp>
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
 #include <opm/material/fluidstates/NonEquilibriumFluidState.hpp>
 #include <opm/material/fluidstates/ImmiscibleFluidState.hpp>
 #include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+#include <opm/material/fluidstates/FluidStateArray.hpp>
+#include <opm/material/fluidstates/BlackOilFluidState.hpp>
 
 // include the tables for CO2 which are delivered with opm-material by default
 #include <opm/material/common/UniformTabulated2DFunction.hpp>
@@ -64,6 +73,14 @@ namespace FluidSystemsTest {
 #include <dune/common/parallel/mpihelper.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 // check that the blackoil fluid system implements all non-standard functions
 template <class Evaluation, class FluidSystem>
 void ensureBlackoilApi()
@@ -149,6 +166,38 @@ void ensureBlackoilApi()
                 dummy = FluidSystem::fugacityCoefficient(fluidState, phaseIdx, compIdx,  /*regionIdx=*/0);
         }
 
+        Evaluation fugCoeffs[FluidSystem::numPhases][FluidSystem::numComponents];
+        FluidSystem::fugacityCoefficients(fluidState, /*regionIdx=*/0, fugCoeffs);
+        dummy = fugCoeffs[FluidSystem::oilPhaseIdx][FluidSystem::gasCompIdx];
+
+        // the caching parameter cache
+        typename FluidSystem::template ParameterCache<Evaluation> paramCache(/*maxOilSat=*/1.0, /*regionIdx=*/0);
+        paramCache.updateAll(fluidState);
+        paramCache.updatePhase(fluidState, FluidSystem::oilPhaseIdx);
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
+            bool upToDate OPM_UNUSED = paramCache.phaseIsUpToDate(phaseIdx);
+            dummy = paramCache.inverseFormationVolumeFactor(phaseIdx);
+            dummy = paramCache.viscosity(phaseIdx);
+            dummy = paramCache.saturatedRs(phaseIdx);
+            dummy = paramCache.saturatedRv(phaseIdx);
+            dummy = FluidSystem::density(fluidState, paramCache, phaseIdx);
+            dummy = FluidSystem::inverseFormationVolumeFactor(fluidState, paramCache, phaseIdx);
+            dummy = FluidSystem::viscosity(fluidState, paramCache, phaseIdx);
+            Scalar scalarDummy OPM_UNUSED =
+                FluidSystem::template viscosity<FluidState, Scalar>(fluidState, paramCache, phaseIdx);
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++ compIdx)
+                dummy = FluidSystem::fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx);
+        }
+        paramCache.invalidate();
+
+        // the kernel which computes the properties of all phases at once
+        typename FluidSystem::template PhaseProperties<Evaluation> phaseProps;
+        FluidSystem::computeAllPhaseProperties(fluidState, /*regionIdx=*/0, phaseProps);
+        dummy = phaseProps.invB[FluidSystem::oilPhaseIdx];
+        dummy = phaseProps.density[FluidSystem::oilPhaseIdx];
+        dummy = phaseProps.viscosity[FluidSystem::oilPhaseIdx];
+        dummy = phaseProps.saturatedDissolutionFactor[FluidSystem::oilPhaseIdx];
+
         // prevent GCC from producing a "variable assigned but unused" warning
         dummy = 2.0*dummy;
 
@@ -161,6 +210,88 @@ void ensureBlackoilApi()
 }
 
 // check the API of all fluid states
+// a compositional fluid state which computes densities and viscosities on demand
+template <class Scalar, class FluidSystem>
+class LazyFluidState
+    : public Opm::ModularFluidState<Scalar,
+                                    FluidSystem::numPhases,
+                                    FluidSystem::numComponents,
+                                    Opm::FluidStateExplicitPressureModule<Scalar, FluidSystem::numPhases, LazyFluidState<Scalar, FluidSystem> >,
+                                    Opm::FluidStateEquilibriumTemperatureModule<Scalar, FluidSystem::numPhases, LazyFluidState<Scalar, FluidSystem> >,
+                                    Opm::FluidStateExplicitCompositionModule<Scalar, FluidSystem, LazyFluidState<Scalar, FluidSystem> >,
+                                    Opm::FluidStateExplicitFugacityModule<Scalar, FluidSystem::numPhases, FluidSystem::numComponents, LazyFluidState<Scalar, FluidSystem> >,
+                                    Opm::FluidStateExplicitSaturationModule<Scalar, FluidSystem::numPhases, LazyFluidState<Scalar, FluidSystem> >,
+                                    Opm::FluidStateLazyDensityModule<Scalar, FluidSystem, LazyFluidState<Scalar, FluidSystem> >,
+                                    Opm::FluidStateLazyViscosityModule<Scalar, FluidSystem, LazyFluidState<Scalar, FluidSystem> >,
+                                    Opm::FluidStateExplicitEnthalpyModule<Scalar, FluidSystem::numPhases, LazyFluidState<Scalar, FluidSystem> > >
+{
+};
+
+// the lazy density and viscosity modules must yield the values of the fluid system
+// check that the PVT multiplexers provide the fused evaluation of the formation volume
+// factor and the viscosity
+template <class Scalar, class Evaluation>
+void ensurePvtMultiplexerApi()
+{
+    while (false) {
+        Opm::OilPvtMultiplexer<Scalar> oilPvt;
+        Opm::GasPvtMultiplexer<Scalar> gasPvt;
+        Opm::WaterPvtMultiplexer<Scalar> waterPvt;
+
+        Evaluation T = 300.0;
+        Evaluation p = 1e5;
+        Evaluation R = 0.0;
+        Evaluation invB;
+        Evaluation mu;
+
+        oilPvt.inverseFormationVolumeFactorAndViscosity(/*regionIdx=*/0, T, p, R, invB, mu);
+        oilPvt.saturatedInverseFormationVolumeFactorAndViscosity(/*regionIdx=*/0, T, p, invB, mu);
+        gasPvt.inverseFormationVolumeFactorAndViscosity(/*regionIdx=*/0, T, p, R, invB, mu);
+        gasPvt.saturatedInverseFormationVolumeFactorAndViscosity(/*regionIdx=*/0, T, p, invB, mu);
+        waterPvt.inverseFormationVolumeFactorAndViscosity(/*regionIdx=*/0, T, p, invB, mu);
+    }
+}
+
+template <class Scalar>
+void testLazyFluidStateModules()
+{
+    typedef Opm::FluidSystems::H2ON2<Scalar, /*enableComplexRelations=*/false> FluidSystem;
+
+    LazyFluidState<Scalar, FluidSystem> fs;
+    checkFluidState<Scalar>(fs);
+
+    typename FluidSystem::template ParameterCache<Scalar> paramCache;
+    fs.setTemperature(300.0);
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+        fs.setPressure(phaseIdx, 1e5);
+        fs.setMoleFraction(phaseIdx, FluidSystem::H2OIdx, 0.9);
+        fs.setMoleFraction(phaseIdx, FluidSystem::N2Idx, 0.1);
+    }
+    fs.setDensityParameterCache(paramCache);
+    fs.setViscosityParameterCache(paramCache);
+
+    const unsigned gasIdx = FluidSystem::gasPhaseIdx;
+    Scalar rho = FluidSystem::density(fs, paramCache, gasIdx);
+    Scalar mu = FluidSystem::viscosity(fs, paramCache, gasIdx);
+    if (Opm::scalarValue(fs.density(gasIdx)) != Opm::scalarValue(rho)
+        || Opm::scalarValue(fs.viscosity(gasIdx)) != Opm::scalarValue(mu))
+        throw std::logic_error("The lazy modules yield wrong values");
+
+    // memoized values are kept until they are invalidated
+    fs.setTemperature(350.0);
+    if (Opm::scalarValue(fs.density(gasIdx)) != Opm::scalarValue(rho))
+        throw std::logic_error("The lazy density module does not memoize values");
+    fs.invalidateDensities();
+    fs.invalidateViscosities();
+    if (Opm::scalarValue(fs.density(gasIdx)) == Opm::scalarValue(rho)
+        || Opm::scalarValue(fs.viscosity(gasIdx)) == Opm::scalarValue(mu))
+        throw std::logic_error("The lazy modules do not recompute invalidated values");
+
+    fs.setDensity(gasIdx, 123.0);
+    if (Opm::scalarValue(fs.density(gasIdx)) != 123.0)
+        throw std::logic_error("Explicitly set densities must be used by the lazy module");
+}
+
 template <class Scalar>
 void testAllFluidStates()
 {
@@ -201,6 +332,95 @@ void testAllFluidStates()
     {   Opm::CompositionalFluidState<Scalar, FluidSystem> fs;
         checkFluidState<Scalar>(fs); }
 
+    // setting the complete composition of a phase at once must be equivalent to
+    // setting the mole fractions individually
+    {   Opm::CompositionalFluidState<Scalar, FluidSystem> fs1, fs2;
+        const std::array<Scalar, FluidSystem::numComponents> x = {{ 0.3, 0.6 }};
+        for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+            fs1.setMoleFraction(/*phaseIdx=*/1, compIdx, x[compIdx]);
+        fs2.setMoleFractions(/*phaseIdx=*/1, x);
+
+        if (Opm::scalarValue(fs1.averageMolarMass(1)) != Opm::scalarValue(fs2.averageMolarMass(1)))
+            throw std::logic_error("setMoleFractions() yields the wrong average molar mass");
+        for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+            if (Opm::scalarValue(fs1.massFraction(1, compIdx)) != Opm::scalarValue(fs2.massFraction(1, compIdx))
+                || Opm::scalarValue(fs2.moleFraction(1, compIdx)) != Opm::scalarValue(x[compIdx]))
+                throw std::logic_error("setMoleFractions() yields the wrong composition");
+    }
+
+    // fluid states can be converted to plain values and copied via assign()
+    {   typedef typename Opm::MathToolbox<Scalar>::ValueType ValueType;
+        Opm::CompositionalFluidState<Scalar, FluidSystem> fs1, fs3;
+        typedef Opm::FluidSystems::H2ON2<ValueType, /*enableComplexRelations=*/false> ValueFluidSystem;
+        Opm::CompositionalFluidState<ValueType, ValueFluidSystem> fs2;
+        fs1.setTemperature(300.0);
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            fs1.setPressure(phaseIdx, 1e5);
+            fs1.setSaturation(phaseIdx, 0.5);
+            fs1.setDensity(phaseIdx, 1e3);
+            fs1.setViscosity(phaseIdx, 1e-3);
+            fs1.setEnthalpy(phaseIdx, 1e4);
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx) {
+                fs1.setMoleFraction(phaseIdx, compIdx, 0.2*(1 + compIdx));
+                fs1.setFugacityCoefficient(phaseIdx, compIdx, 2.0);
+            }
+        }
+        fs2.assign(fs1);
+        fs3.assign(fs1);
+
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            if (fs2.pressure(phaseIdx) != Opm::scalarValue(fs1.pressure(phaseIdx))
+                || fs2.averageMolarMass(phaseIdx) != Opm::scalarValue(fs1.averageMolarMass(phaseIdx))
+                || fs2.density(phaseIdx) != Opm::scalarValue(fs1.density(phaseIdx)))
+                throw std::logic_error("assign() does not convert the fluid state correctly");
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+                if (fs3.moleFraction(phaseIdx, compIdx) != fs1.moleFraction(phaseIdx, compIdx)
+                    || fs3.fugacityCoefficient(phaseIdx, compIdx) != fs1.fugacityCoefficient(phaseIdx, compIdx))
+                    throw std::logic_error("assign() does not copy the fluid state correctly");
+        }
+    }
+
+    // FluidStateArray
+    {   Opm::FluidStateArray<Scalar, FluidSystem> fsArray(/*numCells=*/3);
+        checkFluidState<Scalar>(fsArray[1]);
+        const auto& constArray = fsArray;
+        checkFluidState<Scalar>(constArray[2]);
+
+        // the views must behave exactly like a compositional fluid state
+        Opm::CompositionalFluidState<Scalar, FluidSystem> fs;
+        fs.setTemperature(300.0);
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            fs.setPressure(phaseIdx, 1e5*(1 + phaseIdx));
+            fs.setSaturation(phaseIdx, 0.5);
+            fs.setDensity(phaseIdx, 10.0 + 990.0*phaseIdx);
+            fs.setViscosity(phaseIdx, 1e-3);
+            fs.setEnthalpy(phaseIdx, 1e4*(1 + phaseIdx));
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx) {
+                fs.setMoleFraction(phaseIdx, compIdx, 0.2 + 0.7*compIdx - 0.1*phaseIdx);
+                fs.setFugacityCoefficient(phaseIdx, compIdx, 1.0 + compIdx);
+            }
+        }
+        fsArray[1].assign(fs);
+
+        const auto& view = constArray[1];
+        if (view.temperature(0) != fs.temperature(0))
+            throw std::logic_error("FluidStateArray: wrong temperature");
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            if (view.pressure(phaseIdx) != fs.pressure(phaseIdx)
+                || constArray.pressureData(phaseIdx)[1] != fs.pressure(phaseIdx)
+                || view.saturation(phaseIdx) != fs.saturation(phaseIdx)
+                || view.averageMolarMass(phaseIdx) != fs.averageMolarMass(phaseIdx)
+                || view.molarDensity(phaseIdx) != fs.molarDensity(phaseIdx)
+                || view.internalEnergy(phaseIdx) != fs.internalEnergy(phaseIdx))
+                throw std::logic_error("FluidStateArray: wrong phase quantities");
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+                if (view.massFraction(phaseIdx, compIdx) != fs.massFraction(phaseIdx, compIdx)
+                    || view.fugacity(phaseIdx, compIdx) != fs.fugacity(phaseIdx, compIdx)
+                    || constArray.moleFractionData(phaseIdx, compIdx)[1] != fs.moleFraction(phaseIdx, compIdx))
+                    throw std::logic_error("FluidStateArray: wrong composition");
+        }
+    }
+
     // NonEquilibriumFluidState
     {   Opm::NonEquilibriumFluidState<Scalar, FluidSystem> fs;
         checkFluidState<Scalar>(fs); }
@@ -223,6 +443,34 @@ void testAllFluidStates()
     // SaturationOverlayFluidState
     {   Opm::SaturationOverlayFluidState<BaseFluidState> fs(baseFs);
         checkFluidState<Scalar>(fs); }
+
+    // SingleValueOverlayFluidState
+    {   typedef Opm::SingleValueOverlayFluidState<BaseFluidState, Opm::OverlayQuantity::Pressure> PressureOverlay;
+        typedef typename Opm::NestedOverlayFluidState<BaseFluidState,
+                                                      Opm::OverlayQuantity::Pressure,
+                                                      Opm::OverlayQuantity::MoleFraction>::type NestedOverlay;
+
+        PressureOverlay fs(baseFs, /*phaseIdx=*/0, /*value=*/1e5);
+        checkFluidState<Scalar>(fs);
+
+        BaseFluidState initFs;
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            initFs.setPressure(phaseIdx, 2e5);
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+                initFs.setMoleFraction(phaseIdx, compIdx, 0.5);
+        }
+
+        // the intermediate overlay does not need to stay alive
+        NestedOverlay nestedFs(PressureOverlay(initFs, /*phaseIdx=*/1, /*value=*/3e5),
+                               /*phaseIdx=*/0, /*compIdx=*/1, /*value=*/0.25);
+        checkFluidState<Scalar>(nestedFs);
+        if (nestedFs.pressure(0) != initFs.pressure(0) || nestedFs.pressure(1) != 3e5)
+            throw std::logic_error("SingleValueOverlayFluidState: wrong pressures");
+        if (nestedFs.moleFraction(0, 1) != 0.25
+            || nestedFs.moleFraction(0, 0) != initFs.moleFraction(0, 0)
+            || nestedFs.moleFraction(1, 1) != initFs.moleFraction(1, 1))
+            throw std::logic_error("SingleValueOverlayFluidState: wrong mole fractions");
+    }
 }
 
 template <class Scalar, class FluidStateEval, class LhsEval>
@@ -239,6 +487,26 @@ void testAllFluidSystems()
         typedef Opm::DenseAd::Evaluation<Scalar, 1> BlackoilDummyEval;
         ensureBlackoilApi<Scalar, FluidSystem>();
         ensureBlackoilApi<BlackoilDummyEval, FluidSystem>();
+        ensurePvtMultiplexerApi<Scalar, Scalar>();
+        ensurePvtMultiplexerApi<Scalar, BlackoilDummyEval>();
+
+        // black-oil with compile-time PVT dispatch
+        typedef Opm::FluidSystems::BlackOil<Scalar,
+                                            Opm::LiveOilPvt<Scalar>,
+                                            Opm::WetGasPvt<Scalar>,
+                                            Opm::ConstantCompressibilityWaterPvt<Scalar> > StaticFluidSystem;
+        ensureBlackoilApi<Scalar, StaticFluidSystem>();
+        ensureBlackoilApi<BlackoilDummyEval, StaticFluidSystem>();
+
+        // black-oil with compile-time phase configuration
+        typedef Opm::FluidSystems::BlackOil<Scalar,
+                                            Opm::LiveOilPvt<Scalar>,
+                                            Opm::WetGasPvt<Scalar>,
+                                            Opm::ConstantCompressibilityWaterPvt<Scalar>,
+                                            Opm::FluidSystems::BlackOilStaticPhases<true, true, true,
+                                                                                    true, true> > StaticPhasesFluidSystem;
+        ensureBlackoilApi<Scalar, StaticPhasesFluidSystem>();
+        ensureBlackoilApi<BlackoilDummyEval, StaticPhasesFluidSystem>();
     }
 
     // Brine -- CO2
@@ -306,6 +574,984 @@ void testAllFluidSystems()
         checkFluidSystem<Scalar, FluidSystem, FluidStateEval, LhsEval>(); }
 }
 
+// make sure that the contexts of the black-oil fluid system are independent
+template <class Scalar>
+void testBlackoilContexts()
+{
+    typedef Opm::FluidSystems::BlackOil<Scalar> FluidSystem;
+    typedef typename FluidSystem::Context Context;
+
+    Context context1;
+    Context context2;
+
+    {
+        typename FluidSystem::ScopedContext scopedContext(context1);
+        FluidSystem::initBegin(/*numPvtRegions=*/1);
+        FluidSystem::setReferenceDensities(/*oil=*/600.0, /*water=*/1000.0, /*gas=*/1.0, /*regionIdx=*/0);
+        FluidSystem::initEnd();
+    }
+
+    {
+        typename FluidSystem::ScopedContext scopedContext(context2);
+        FluidSystem::initBegin(/*numPvtRegions=*/2);
+        FluidSystem::setEnableVaporizedOil(true);
+        FluidSystem::setReferenceDensities(/*oil=*/800.0, /*water=*/1020.0, /*gas=*/0.8, /*regionIdx=*/0);
+        FluidSystem::setReferenceDensities(/*oil=*/850.0, /*water=*/1030.0, /*gas=*/0.9, /*regionIdx=*/1);
+        FluidSystem::initEnd();
+    }
+
+    if (&FluidSystem::activeContext() == &context1 || &FluidSystem::activeContext() == &context2)
+        throw std::logic_error("oops: the default context was not restored");
+
+    FluidSystem::setActiveContext(context1);
+    if (!FluidSystem::isInitialized()
+        || FluidSystem::numRegions() != 1
+        || FluidSystem::enableVaporizedOil()
+        || FluidSystem::referenceDensity(FluidSystem::oilPhaseIdx, /*regionIdx=*/0) != 600.0)
+        throw std::logic_error("oops: black-oil context 1");
+
+    FluidSystem::setActiveContext(context2);
+    if (!FluidSystem::isInitialized()
+        || FluidSystem::numRegions() != 2
+        || !FluidSystem::enableVaporizedOil()
+        || FluidSystem::referenceDensity(FluidSystem::oilPhaseIdx, /*regionIdx=*/1) != 850.0)
+        throw std::logic_error("oops: black-oil context 2");
+
+    FluidSystem::resetActiveContext();
+}
+
+// the black-oil fluid state must derive the composition from R_s and R_v and it must
+// be able to take over the state of a generic fluid state
+template <class Scalar>
+void testBlackoilFluidState()
+{
+    typedef Opm::FluidSystems::BlackOil<Scalar> FluidSystem;
+    typedef typename FluidSystem::Context Context;
+    typedef Opm::DenseAd::Evaluation<Scalar, 3> Evaluation;
+    typedef Opm::BlackOilFluidState<Scalar, FluidSystem> FluidState;
+
+    Context context;
+    typename FluidSystem::ScopedContext scopedContext(context);
+    FluidSystem::initBegin(/*numPvtRegions=*/1);
+    FluidSystem::setEnableDissolvedGas(true);
+    FluidSystem::setEnableVaporizedOil(true);
+    FluidSystem::setReferenceDensities(/*oil=*/800.0, /*water=*/1000.0, /*gas=*/0.9, /*regionIdx=*/0);
+    FluidSystem::initEnd();
+
+    {   Opm::BlackOilFluidState<Evaluation, FluidSystem> fs;
+        checkFluidState<Evaluation>(fs); }
+
+    FluidState fs;
+    checkFluidState<Scalar>(fs);
+
+    const unsigned oilPhaseIdx = FluidSystem::oilPhaseIdx;
+    const unsigned gasPhaseIdx = FluidSystem::gasPhaseIdx;
+    fs.setPvtRegionIndex(0);
+    fs.setTemperature(350.0);
+    fs.setRs(80.0);
+    fs.setRv(1e-4);
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+        fs.setPressure(phaseIdx, 2e7 + phaseIdx*1e5);
+        fs.setSaturation(phaseIdx, 1.0/FluidSystem::numPhases);
+        fs.setInvB(phaseIdx, 1.1 + 0.1*phaseIdx);
+        fs.setViscosity(phaseIdx, 1e-3/(phaseIdx + 1));
+    }
+    fs.setDensity(FluidSystem::waterPhaseIdx, 1000.0*fs.invB(FluidSystem::waterPhaseIdx));
+    fs.setDensity(oilPhaseIdx, (800.0 + fs.Rs()*0.9)*fs.invB(oilPhaseIdx));
+    fs.setDensity(gasPhaseIdx, (0.9 + fs.Rv()*800.0)*fs.invB(gasPhaseIdx));
+
+    const Scalar tol = std::sqrt(std::numeric_limits<Scalar>::epsilon());
+    if (std::abs(fs.massFraction(oilPhaseIdx, FluidSystem::gasCompIdx)
+                 - FluidSystem::convertRsToXoG(fs.Rs(), /*regionIdx=*/0)) > tol
+        || std::abs(fs.massFraction(gasPhaseIdx, FluidSystem::oilCompIdx)
+                    - FluidSystem::convertRvToXgO(fs.Rv(), /*regionIdx=*/0)) > tol)
+        throw std::logic_error("The black-oil fluid state yields the wrong mass fractions");
+
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+        Scalar sumX = 0.0;
+        Scalar sumx = 0.0;
+        for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx) {
+            sumX += fs.massFraction(phaseIdx, compIdx);
+            sumx += fs.moleFraction(phaseIdx, compIdx);
+        }
+        if (std::abs(sumX - 1.0) > tol || std::abs(sumx - 1.0) > tol)
+            throw std::logic_error("The composition of the black-oil fluid state does not sum up to one");
+    }
+
+    // the black-oil fluid system must use R_s and R_v of the fluid state
+    if (std::abs(FluidSystem::convertXoGToRs(fs.massFraction(oilPhaseIdx, FluidSystem::gasCompIdx), /*regionIdx=*/0)
+                 - Opm::BlackOil::template getRs_<FluidSystem, Scalar, FluidState>(fs, /*regionIdx=*/0)) > tol*fs.Rs())
+        throw std::logic_error("The black-oil fluid system does not use R_s of the black-oil fluid state");
+
+    // round trip via a generic fluid state
+    Opm::SimpleModularFluidState<Scalar,
+                                 FluidSystem::numPhases,
+                                 FluidSystem::numComponents,
+                                 FluidSystem,
+                                 /*storePressure=*/true,
+                                 /*storeTemperature=*/true,
+                                 /*storeComposition=*/true,
+                                 /*storeFugacity=*/false,
+                                 /*storeSaturation=*/true,
+                                 /*storeDensity=*/true,
+                                 /*storeViscosity=*/true,
+                                 /*storeEnthalpy=*/false> genericFs;
+    genericFs.assign(fs);
+
+    FluidState fs2;
+    fs2.setPvtRegionIndex(0);
+    fs2.assign(genericFs);
+    if (std::abs(fs2.Rs() - fs.Rs()) > tol*fs.Rs()
+        || std::abs(fs2.Rv() - fs.Rv()) > tol*fs.Rv())
+        throw std::logic_error("The black-oil fluid state does not recover R_s and R_v");
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+        if (std::abs(fs2.invB(phaseIdx) - fs.invB(phaseIdx)) > tol*fs.invB(phaseIdx)
+            || fs2.viscosity(phaseIdx) != fs.viscosity(phaseIdx))
+            throw std::logic_error("The black-oil fluid state does not recover the phase properties");
+}
+
+// the bulk export of the phase properties must yield the same values as the per-cell
+// kernel of the black-oil fluid system
+template <class Scalar>
+void testBlackoilPropertyExport()
+{
+    typedef Opm::LiveOilPvt<Scalar> OilPvt;
+    typedef Opm::WetGasPvt<Scalar> GasPvt;
+    typedef Opm::ConstantCompressibilityWaterPvt<Scalar> WaterPvt;
+    typedef Opm::FluidSystems::BlackOil<Scalar, OilPvt, GasPvt, WaterPvt> FluidSystem;
+    typedef typename FluidSystem::Context Context;
+    typedef Opm::BlackOilFluidState<Scalar, FluidSystem> FluidState;
+    typedef std::vector<std::pair<Scalar, Scalar> > SamplingPoints;
+    enum { numPhases = FluidSystem::numPhases };
+
+    const unsigned numRegions = 2;
+    auto oilPvt = std::make_shared<OilPvt>();
+    auto gasPvt = std::make_shared<GasPvt>();
+    auto waterPvt = std::make_shared<WaterPvt>();
+    oilPvt->setNumRegions(numRegions);
+    gasPvt->setNumRegions(numRegions);
+    waterPvt->setNumRegions(numRegions);
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+        const Scalar f = 1.0 + 0.1*regionIdx;
+        oilPvt->setReferenceDensities(regionIdx, 800.0, 1.0, 1000.0);
+        oilPvt->setSaturatedOilGasDissolutionFactor(regionIdx, SamplingPoints{{1e5, 0.0}, {1e7, 50.0*f}, {3e7, 120.0}});
+        oilPvt->setSaturatedOilFormationVolumeFactor(regionIdx, SamplingPoints{{1e5, 1.0}, {1e7, 1.1*f}, {3e7, 1.3}});
+        oilPvt->setSaturatedOilViscosity(regionIdx, SamplingPoints{{1e5, 2e-3}, {1e7, 1.5e-3*f}, {3e7, 1e-3}});
+
+        gasPvt->setReferenceDensities(regionIdx, 800.0, 1.0, 1000.0);
+        gasPvt->setSaturatedGasOilVaporizationFactor(regionIdx, SamplingPoints{{1e5, 0.0}, {1e7, 1e-4*f}, {3e7, 3e-4}});
+        gasPvt->setSaturatedGasFormationVolumeFactor(regionIdx, SamplingPoints{{1e5, 1.0}, {1e7, 0.01*f}, {3e7, 0.004}});
+        gasPvt->setSaturatedGasViscosity(regionIdx, SamplingPoints{{1e5, 1e-5}, {1e7, 2e-5*f}, {3e7, 3e-5}});
+
+        waterPvt->setReferenceDensities(regionIdx, 800.0, 1.0, 1000.0);
+        waterPvt->setReferencePressure(regionIdx, 1e5);
+        waterPvt->setReferenceFormationVolumeFactor(regionIdx, 1.0);
+        waterPvt->setCompressibility(regionIdx, 4e-10*f);
+        waterPvt->setViscosity(regionIdx, 5e-4);
+    }
+    oilPvt->initEnd();
+    gasPvt->initEnd();
+    waterPvt->initEnd();
+
+    Context context;
+    typename FluidSystem::ScopedContext scopedContext(context);
+    FluidSystem::initBegin(numRegions);
+    FluidSystem::setEnableDissolvedGas(true);
+    FluidSystem::setEnableVaporizedOil(true);
+    FluidSystem::setOilPvt(oilPvt);
+    FluidSystem::setGasPvt(gasPvt);
+    FluidSystem::setWaterPvt(waterPvt);
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx)
+        FluidSystem::setReferenceDensities(/*oil=*/800.0, /*water=*/1000.0, /*gas=*/1.0, regionIdx);
+    FluidSystem::initEnd();
+    FluidSystem::setReservoirTemperature(273.15 + 60.0);
+
+    // cells with absent, barely present and present gas and oil phases
+    const size_t numCells = 200;
+    std::vector<unsigned> regionIdx(numCells);
+    std::vector<Scalar> Rs(numCells), Rv(numCells);
+    std::vector<std::vector<Scalar> > p(numPhases, std::vector<Scalar>(numCells));
+    std::vector<std::vector<Scalar> > S(numPhases, std::vector<Scalar>(numCells));
+    for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        regionIdx[cellIdx] = cellIdx % numRegions;
+        Rs[cellIdx] = 0.4*cellIdx;
+        Rv[cellIdx] = 1e-6*cellIdx;
+        const Scalar Sg = (cellIdx % 3 == 0) ? 0.0 : ((cellIdx % 3 == 1) ? 5e-5 : 0.2);
+        const Scalar So = (cellIdx % 4 == 0) ? 0.0 : ((cellIdx % 4 == 1) ? 2e-5 : 0.5);
+        S[FluidSystem::gasPhaseIdx][cellIdx] = Sg;
+        S[FluidSystem::oilPhaseIdx][cellIdx] = So;
+        S[FluidSystem::waterPhaseIdx][cellIdx] = 1.0 - So - Sg;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            p[phaseIdx][cellIdx] = 2e5 + 1.4e5*cellIdx + 1e4*phaseIdx;
+    }
+
+    typename FluidSystem::PropertyExportInput input;
+    input.numCells = numCells;
+    input.regionIdx = regionIdx.data();
+    input.Rs = Rs.data();
+    input.Rv = Rv.data();
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        input.pressure[phaseIdx] = p[phaseIdx].data();
+        input.saturation[phaseIdx] = S[phaseIdx].data();
+    }
+
+    // only request some of the quantities
+    std::vector<std::vector<Scalar> > invB(numPhases, std::vector<Scalar>(numCells, -1.0));
+    std::vector<std::vector<Scalar> > mu(numPhases, std::vector<Scalar>(numCells, -1.0));
+    std::vector<Scalar> rhoOil(numCells, -1.0);
+    std::vector<Scalar> RsSat(numCells, -1.0);
+    typename FluidSystem::PropertyExportOutput output;
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        output.invB[phaseIdx] = invB[phaseIdx].data();
+        output.viscosity[phaseIdx] = mu[phaseIdx].data();
+    }
+    output.density[FluidSystem::oilPhaseIdx] = rhoOil.data();
+    output.saturatedDissolutionFactor[FluidSystem::oilPhaseIdx] = RsSat.data();
+
+    FluidSystem::exportPhaseProperties(input, output);
+
+    for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState fs;
+        fs.setPvtRegionIndex(regionIdx[cellIdx]);
+        fs.setTemperature(FluidSystem::reservoirTemperature());
+        fs.setRs(Rs[cellIdx]);
+        fs.setRv(Rv[cellIdx]);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs.setPressure(phaseIdx, p[phaseIdx][cellIdx]);
+            fs.setSaturation(phaseIdx, S[phaseIdx][cellIdx]);
+        }
+
+        typename FluidSystem::template PhaseProperties<Scalar> props;
+        FluidSystem::computeAllPhaseProperties(fs, regionIdx[cellIdx], props);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (invB[phaseIdx][cellIdx] != props.invB[phaseIdx]
+                || mu[phaseIdx][cellIdx] != props.viscosity[phaseIdx])
+                throw std::logic_error("The exported properties of phase "+std::to_string(phaseIdx)
+                                       +" differ from the ones of computeAllPhaseProperties()");
+        if (rhoOil[cellIdx] != props.density[FluidSystem::oilPhaseIdx]
+            || RsSat[cellIdx] != props.saturatedDissolutionFactor[FluidSystem::oilPhaseIdx])
+            throw std::logic_error("The exported oil density or saturated R_s differ from the "
+                                   "ones of computeAllPhaseProperties()");
+    }
+}
+
+// make sure that a compile-time phase configuration of the black-oil fluid system is
+// respected and that contradicting runtime settings are rejected
+template <class Scalar>
+void testBlackoilStaticPhases()
+{
+    typedef Opm::FluidSystems::BlackOilStaticPhases</*water=*/true, /*oil=*/true, /*gas=*/false,
+                                                    /*disgas=*/false, /*vapoil=*/false> PhaseConfig;
+    typedef Opm::FluidSystems::BlackOil<Scalar,
+                                        Opm::OilPvtMultiplexer<Scalar>,
+                                        Opm::GasPvtMultiplexer<Scalar>,
+                                        Opm::WaterPvtMultiplexer<Scalar>,
+                                        PhaseConfig> FluidSystem;
+
+    static_assert(PhaseConfig::numActivePhases() == 2, "");
+    static_assert(PhaseConfig::phaseIsActive(FluidSystem::waterPhaseIdx), "");
+    static_assert(PhaseConfig::phaseIsActive(FluidSystem::oilPhaseIdx), "");
+    static_assert(!PhaseConfig::phaseIsActive(FluidSystem::gasPhaseIdx), "");
+
+    FluidSystem::initBegin(/*numPvtRegions=*/1);
+    FluidSystem::setReferenceDensities(/*oil=*/800.0, /*water=*/1000.0, /*gas=*/1.0, /*regionIdx=*/0);
+    FluidSystem::initEnd();
+
+    if (FluidSystem::numActivePhases() != 2
+        || !FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)
+        || FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)
+        || FluidSystem::enableDissolvedGas()
+        || FluidSystem::enableVaporizedOil())
+        throw std::logic_error("oops: the static phase configuration of the black-oil fluid system is not respected");
+
+    bool hasThrown = false;
+    FluidSystem::initBegin(/*numPvtRegions=*/1);
+    FluidSystem::setEnableDissolvedGas(true);
+    FluidSystem::setReferenceDensities(/*oil=*/800.0, /*water=*/1000.0, /*gas=*/1.0, /*regionIdx=*/0);
+    try { FluidSystem::initEnd(); }
+    catch (const std::logic_error&) { hasThrown = true; }
+    if (!hasThrown)
+        throw std::logic_error("oops: contradicting DISGAS setting was accepted by the black-oil fluid system");
+
+    // the runtime configured fluid system is unaffected
+    typedef Opm::FluidSystems::BlackOil<Scalar> RuntimeFluidSystem;
+    static_assert(!RuntimeFluidSystem::PhaseConfig::isStatic, "");
+}
+
+// the bulk conversion of reservoir volumes to surface volumes must yield the same values
+// and derivatives as the conversion of the individual entries
+template <class Scalar>
+void testBlackoilSurfaceVolumes()
+{
+    typedef Opm::FluidSystems::BlackOil<Scalar> FluidSystem;
+    typedef typename FluidSystem::Context Context;
+    typedef Opm::DenseAd::Evaluation<Scalar, 3> Evaluation;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
+    enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+    const unsigned numRegions = 3;
+    Context context;
+    typename FluidSystem::ScopedContext scopedContext(context);
+    FluidSystem::initBegin(numRegions);
+    FluidSystem::setEnableDissolvedGas(true);
+    FluidSystem::setEnableVaporizedOil(true);
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx)
+        FluidSystem::setReferenceDensities(/*oil=*/800.0 + 10.0*regionIdx,
+                                           /*water=*/1000.0,
+                                           /*gas=*/0.9 + 0.1*regionIdx,
+                                           regionIdx);
+    FluidSystem::initEnd();
+
+    // the entries of the same region are mostly consecutive
+    const size_t numValues = 50;
+    std::vector<unsigned> regionIdx(numValues);
+    std::vector<Evaluation> q[numPhases], invB[numPhases];
+    std::vector<Evaluation> XoG(numValues), XgO(numValues), Rs(numValues), Rv(numValues);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        q[phaseIdx].resize(numValues);
+        invB[phaseIdx].resize(numValues);
+    }
+    for (size_t i = 0; i < numValues; ++i) {
+        regionIdx[i] = (i/7) % numRegions;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            q[phaseIdx][i] = Evaluation::createVariable(1e-3*(1 + i + phaseIdx), phaseIdx);
+            invB[phaseIdx][i] = 0.9 + 0.01*i + 0.1*phaseIdx;
+        }
+        XoG[i] = Evaluation::createVariable(0.001*i, 0)*0.5;
+        XgO[i] = Evaluation::createVariable(0.002*i, 1)*0.5;
+        Rs[i] = FluidSystem::convertXoGToRs(XoG[i], regionIdx[i]);
+        Rv[i] = FluidSystem::convertXgOToRv(XgO[i], regionIdx[i]);
+    }
+
+    typename FluidSystem::template SurfaceVolumeInput<Evaluation> input;
+    input.numValues = numValues;
+    input.regionIdx = regionIdx.data();
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        input.reservoirVolume[phaseIdx] = q[phaseIdx].data();
+        input.invB[phaseIdx] = invB[phaseIdx].data();
+    }
+
+    std::vector<Evaluation> surfaceVolume[numPhases];
+    std::array<Evaluation*, numPhases> output;
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        surfaceVolume[phaseIdx].resize(numValues);
+        output[phaseIdx] = surfaceVolume[phaseIdx].data();
+    }
+
+    auto checkResults = [&](const char* what) {
+        for (size_t i = 0; i < numValues; ++i) {
+            const Evaluation& freeOil = q[oilPhaseIdx][i]*invB[oilPhaseIdx][i];
+            const Evaluation& freeGas = q[gasPhaseIdx][i]*invB[gasPhaseIdx][i];
+            if (surfaceVolume[waterPhaseIdx][i] != q[waterPhaseIdx][i]*invB[waterPhaseIdx][i]
+                || surfaceVolume[oilPhaseIdx][i] != freeOil + Rv[i]*freeGas
+                || surfaceVolume[gasPhaseIdx][i] != freeGas + Rs[i]*freeOil)
+                throw std::logic_error(std::string("The conversion to surface volumes is wrong ")
+                                       + what);
+        }
+    };
+
+    // dissolved components given by the mass fractions
+    input.XoG = XoG.data();
+    input.XgO = XgO.data();
+    FluidSystem::reservoirToSurfaceVolumes(input, output);
+    checkResults("for mass fractions");
+
+    // dissolved components given by the dissolution factors
+    input.Rs = Rs.data();
+    input.Rv = Rv.data();
+    input.XoG = nullptr;
+    input.XgO = nullptr;
+    FluidSystem::reservoirToSurfaceVolumes(input, output);
+    checkResults("for dissolution factors");
+
+    // without dissolved components
+    input.Rs = nullptr;
+    input.Rv = nullptr;
+    FluidSystem::reservoirToSurfaceVolumes(input, output);
+    for (size_t i = 0; i < numValues; ++i) {
+        Rs[i] = 0.0;
+        Rv[i] = 0.0;
+    }
+    checkResults("without dissolved components");
+}
+
+// the blending of the saturated and undersaturated quantities of the black-oil fluid
+// system must be continuous for all switching functions and continuously
+// differentiable at the end of the transition zone for the smooth ones
+template <class Scalar>
+void testBlackoilSaturatedSwitch()
+{
+    typedef Opm::LiveOilPvt<Scalar> OilPvt;
+    typedef Opm::WetGasPvt<Scalar> GasPvt;
+    typedef Opm::ConstantCompressibilityWaterPvt<Scalar> WaterPvt;
+    typedef Opm::FluidSystems::BlackOil<Scalar, OilPvt, GasPvt, WaterPvt> FluidSystem;
+    typedef typename FluidSystem::Context Context;
+    typedef typename FluidSystem::SaturatedSwitchFunction SwitchFunction;
+    typedef Opm::DenseAd::Evaluation<Scalar, 1> Evaluation;
+    typedef Opm::BlackOilFluidState<Evaluation, FluidSystem> FluidState;
+    typedef std::vector<std::pair<Scalar, Scalar> > SamplingPoints;
+    enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+
+    auto oilPvt = std::make_shared<OilPvt>();
+    auto gasPvt = std::make_shared<GasPvt>();
+    auto waterPvt = std::make_shared<WaterPvt>();
+    oilPvt->setNumRegions(1);
+    gasPvt->setNumRegions(1);
+    waterPvt->setNumRegions(1);
+    oilPvt->setReferenceDensities(0, 800.0, 1.0, 1000.0);
+    oilPvt->setSaturatedOilGasDissolutionFactor(0, SamplingPoints{{1e5, 0.0}, {1e7, 50.0}, {3e7, 120.0}});
+    oilPvt->setSaturatedOilFormationVolumeFactor(0, SamplingPoints{{1e5, 1.0}, {1e7, 1.1}, {3e7, 1.3}});
+    oilPvt->setSaturatedOilViscosity(0, SamplingPoints{{1e5, 2e-3}, {1e7, 1.5e-3}, {3e7, 1e-3}});
+    gasPvt->setReferenceDensities(0, 800.0, 1.0, 1000.0);
+    gasPvt->setSaturatedGasOilVaporizationFactor(0, SamplingPoints{{1e5, 0.0}, {1e7, 1e-4}, {3e7, 3e-4}});
+    gasPvt->setSaturatedGasFormationVolumeFactor(0, SamplingPoints{{1e5, 1.0}, {1e7, 0.01}, {3e7, 0.004}});
+    gasPvt->setSaturatedGasViscosity(0, SamplingPoints{{1e5, 1e-5}, {1e7, 2e-5}, {3e7, 3e-5}});
+    waterPvt->setReferenceDensities(0, 800.0, 1.0, 1000.0);
+    waterPvt->setReferencePressure(0, 1e5);
+    waterPvt->setReferenceFormationVolumeFactor(0, 1.0);
+    waterPvt->setCompressibility(0, 4e-10);
+    waterPvt->setViscosity(0, 5e-4);
+    oilPvt->initEnd();
+    gasPvt->initEnd();
+    waterPvt->initEnd();
+
+    Context context;
+    typename FluidSystem::ScopedContext scopedContext(context);
+    FluidSystem::initBegin(/*numPvtRegions=*/1);
+    FluidSystem::setEnableDissolvedGas(true);
+    FluidSystem::setEnableVaporizedOil(true);
+    FluidSystem::setOilPvt(oilPvt);
+    FluidSystem::setGasPvt(gasPvt);
+    FluidSystem::setWaterPvt(waterPvt);
+    FluidSystem::setReferenceDensities(/*oil=*/800.0, /*water=*/1000.0, /*gas=*/1.0, /*regionIdx=*/0);
+    FluidSystem::initEnd();
+
+    if (FluidSystem::saturatedSwitchWidth() != Scalar(1e-4)
+        || FluidSystem::saturatedSwitchFunction() != SwitchFunction::Linear)
+        throw std::logic_error("The default saturated/undersaturated switch has changed");
+
+    bool hasThrown = false;
+    try { FluidSystem::setSaturatedSwitchWidth(0.0); }
+    catch (const std::invalid_argument&) { hasThrown = true; }
+    if (!hasThrown)
+        throw std::logic_error("A non-positive width of the saturated/undersaturated switch must be rejected");
+
+    // undersaturated oil at the given gas saturation. the derivatives are the ones
+    // with regard to the gas saturation
+    auto oilState = [](Scalar Sg) {
+        FluidState fs;
+        fs.setPvtRegionIndex(0);
+        fs.setTemperature(273.15 + 60.0);
+        fs.setRs(20.0);
+        fs.setRv(0.0);
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            fs.setPressure(phaseIdx, 1e7);
+        fs.setSaturation(gasPhaseIdx, Evaluation::createVariable(Sg, 0));
+        fs.setSaturation(oilPhaseIdx, 0.5);
+        fs.setSaturation(FluidSystem::waterPhaseIdx, 0.5 - Sg);
+        return fs;
+    };
+
+    const Scalar width = 1e-2;
+    FluidSystem::setSaturatedSwitchWidth(width);
+    const Scalar bSat = oilPvt->saturatedInverseFormationVolumeFactor(0, Scalar(273.15 + 60.0), Scalar(1e7));
+    const Scalar bUndersat = oilPvt->inverseFormationVolumeFactor(0, Scalar(273.15 + 60.0), Scalar(1e7), Scalar(20.0));
+    const Scalar tol = 100*std::numeric_limits<Scalar>::epsilon();
+    const Scalar h = width*1e-3;
+    const SwitchFunction functions[] =
+        { SwitchFunction::Linear, SwitchFunction::SmoothStep, SwitchFunction::SmootherStep };
+    for (SwitchFunction function : functions) {
+        FluidSystem::setSaturatedSwitchFunction(function);
+
+        // the weights at the ends and in the middle of the transition zone
+        const Evaluation& b0 = FluidSystem::inverseFormationVolumeFactor(oilState(0.0), oilPhaseIdx, 0);
+        const Evaluation& bMid = FluidSystem::inverseFormationVolumeFactor(oilState(width/2), oilPhaseIdx, 0);
+        const Evaluation& bEnd = FluidSystem::inverseFormationVolumeFactor(oilState(width), oilPhaseIdx, 0);
+        if (std::abs(b0.value() - bUndersat) > tol*bUndersat
+            || std::abs(bMid.value() - (bSat + bUndersat)/2) > tol*bSat
+            || std::abs(bEnd.value() - bSat) > tol*bSat)
+            throw std::logic_error("The saturated/undersaturated switch yields wrong weights");
+
+        // continuity at the end of the transition zone
+        const Evaluation& bBelow = FluidSystem::inverseFormationVolumeFactor(oilState(width - h), oilPhaseIdx, 0);
+        if (std::abs(bBelow.value() - bSat) > 2*h/width*std::abs(bSat - bUndersat))
+            throw std::logic_error("The saturated/undersaturated switch is discontinuous");
+
+        // the smooth functions do not leave a kink at the end of the zone
+        const Scalar slope = std::abs(bBelow.derivative(0));
+        if (function == SwitchFunction::Linear) {
+            if (std::abs(slope - std::abs(bSat - bUndersat)/width) > 1e-3*slope)
+                throw std::logic_error("The linear saturated/undersaturated switch has the wrong slope");
+        }
+        else if (slope > 1e-2*std::abs(bSat - bUndersat)/width)
+            throw std::logic_error("The smooth saturated/undersaturated switch has a kink");
+
+        // the combined kernel must be consistent with the individual quantities
+        for (Scalar Sg : {Scalar(0.1*width), Scalar(0.7*width), Scalar(2*width)}) {
+            const auto& fs = oilState(Sg);
+            typename FluidSystem::template PhaseProperties<Evaluation> props;
+            FluidSystem::computeAllPhaseProperties(fs, /*regionIdx=*/0, props);
+            const Evaluation& b = FluidSystem::inverseFormationVolumeFactor(fs, oilPhaseIdx, 0);
+            const Evaluation& mu = FluidSystem::viscosity(fs, oilPhaseIdx, 0);
+            if (std::abs(props.invB[oilPhaseIdx].value() - b.value()) > tol*b.value()
+                || std::abs(props.invB[oilPhaseIdx].derivative(0) - b.derivative(0)) > tol*(1 + std::abs(b.derivative(0)))
+                || std::abs(props.viscosity[oilPhaseIdx].value() - mu.value()) > tol*mu.value())
+                throw std::logic_error("The combined black-oil properties differ from the individual ones");
+        }
+    }
+}
+
+// the parameter cache of the brine-CO2 fluid system must not change the results
+template <class Scalar>
+void testBrineCO2ParameterCache()
+{
+    typedef Opm::FluidSystems::BrineCO2<Scalar, Opm::FluidSystemsTest::CO2Tables> FluidSystem;
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    enum { numCells = 4 };
+
+    FluidSystem::init(/*tempMin=*/273.15, /*tempMax=*/373.15, /*nTemp=*/20,
+                      /*pressMin=*/1e5, /*pressMax=*/4e7, /*nPress=*/20);
+
+    FluidState fluidStates[numCells];
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState& fs = fluidStates[cellIdx];
+        fs.setTemperature(290.0 + 15*cellIdx);
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            fs.setPressure(phaseIdx, 5e6*(1 + cellIdx) + 1e5*phaseIdx);
+        fs.setMoleFraction(FluidSystem::liquidPhaseIdx, FluidSystem::BrineIdx, 0.98);
+        fs.setMoleFraction(FluidSystem::liquidPhaseIdx, FluidSystem::CO2Idx, 0.02);
+        fs.setMoleFraction(FluidSystem::gasPhaseIdx, FluidSystem::BrineIdx, 0.01);
+        fs.setMoleFraction(FluidSystem::gasPhaseIdx, FluidSystem::CO2Idx, 0.99);
+    }
+
+    ParameterCache batchParamCaches[numCells];
+    ParameterCache::updateAll(batchParamCaches, fluidStates, numCells);
+
+    const Scalar tol = std::numeric_limits<Scalar>::epsilon()*1e3;
+    auto isClose = [tol](Scalar a, Scalar b)
+    { return std::abs(a - b) <= tol*std::max<Scalar>(std::abs(a), std::abs(b)); };
+
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState& fs = fluidStates[cellIdx];
+        ParameterCache unusedParamCache;
+        ParameterCache paramCache;
+        paramCache.updateAll(fs);
+
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            Scalar rho = FluidSystem::density(fs, unusedParamCache, phaseIdx);
+            Scalar mu = FluidSystem::viscosity(fs, unusedParamCache, phaseIdx);
+            if (FluidSystem::density(fs, paramCache, phaseIdx) != rho
+                || !isClose(FluidSystem::density(fs, batchParamCaches[cellIdx], phaseIdx), rho))
+                throw std::logic_error("The brine-CO2 parameter cache yields wrong densities");
+            if (FluidSystem::viscosity(fs, paramCache, phaseIdx) != mu
+                || !isClose(FluidSystem::viscosity(fs, batchParamCaches[cellIdx], phaseIdx), mu))
+                throw std::logic_error("The brine-CO2 parameter cache yields wrong viscosities");
+
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx) {
+                Scalar phi = FluidSystem::fugacityCoefficient(fs, unusedParamCache, phaseIdx, compIdx);
+                if (FluidSystem::fugacityCoefficient(fs, paramCache, phaseIdx, compIdx) != phi
+                    || !isClose(FluidSystem::fugacityCoefficient(fs, batchParamCaches[cellIdx], phaseIdx, compIdx), phi))
+                    throw std::logic_error("The brine-CO2 parameter cache yields wrong fugacity coefficients");
+            }
+        }
+
+        // values which were cached for a different pressure must not be used
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            fs.setPressure(phaseIdx, 1.5*fs.pressure(phaseIdx));
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            if (FluidSystem::density(fs, paramCache, phaseIdx)
+                != FluidSystem::density(fs, unusedParamCache, phaseIdx))
+                throw std::logic_error("The brine-CO2 parameter cache uses outdated densities");
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+                if (FluidSystem::fugacityCoefficient(fs, paramCache, phaseIdx, compIdx)
+                    != FluidSystem::fugacityCoefficient(fs, unusedParamCache, phaseIdx, compIdx))
+                    throw std::logic_error("The brine-CO2 parameter cache uses outdated solubilities");
+        }
+    }
+}
+
+// the parameter caches of the H2O-N2 and H2O-air fluid systems must yield the same
+// results as the fluid systems without a cache, also if they are updated incrementally
+template <class Scalar, class FluidSystem>
+void checkTemperaturePressureCache()
+{
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    FluidState fs;
+    fs.setTemperature(300.0);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        fs.setPressure(phaseIdx, 2e5 + 1e4*phaseIdx);
+        fs.setMoleFraction(phaseIdx, /*compIdx=*/0, 0.3 + 0.4*phaseIdx);
+        fs.setMoleFraction(phaseIdx, /*compIdx=*/1, 0.7 - 0.4*phaseIdx);
+    }
+
+    ParameterCache unusedParamCache;
+    ParameterCache paramCache;
+    auto checkCache = [&](const char* what) {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            bool ok =
+                FluidSystem::density(fs, paramCache, phaseIdx)
+                == FluidSystem::density(fs, unusedParamCache, phaseIdx)
+                && FluidSystem::viscosity(fs, paramCache, phaseIdx)
+                == FluidSystem::viscosity(fs, unusedParamCache, phaseIdx);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                ok = ok
+                    && FluidSystem::fugacityCoefficient(fs, paramCache, phaseIdx, compIdx)
+                    == FluidSystem::fugacityCoefficient(fs, unusedParamCache, phaseIdx, compIdx);
+            if (!ok)
+                throw std::logic_error(std::string("The parameter cache of ")
+                                       + FluidSystem::phaseName(phaseIdx)
+                                       + " yields wrong results " + what);
+        }
+    };
+
+    paramCache.updateAll(fs);
+    checkCache("after a full update");
+
+    // the cached quantities do not depend on the composition
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        fs.setMoleFraction(phaseIdx, /*compIdx=*/0, 0.2 + 0.6*phaseIdx);
+        fs.setMoleFraction(phaseIdx, /*compIdx=*/1, 0.8 - 0.6*phaseIdx);
+        paramCache.updateComposition(fs, phaseIdx);
+    }
+    checkCache("after updating the composition");
+
+    // values which were cached for a different pressure must not be used
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+        fs.setPressure(phaseIdx, 1.5*fs.pressure(phaseIdx));
+    checkCache("for an outdated pressure");
+
+    paramCache.updateAllPressures(fs);
+    checkCache("after updating the pressures");
+
+    fs.setTemperature(320.0);
+    paramCache.updateAllTemperatures(fs);
+    checkCache("after updating the temperatures");
+}
+
+template <class Scalar>
+void testTemperaturePressureCaches()
+{
+    checkTemperaturePressureCache<Scalar, Opm::FluidSystems::H2ON2<Scalar, /*complexRelations=*/false> >();
+    checkTemperaturePressureCache<Scalar, Opm::FluidSystems::H2ON2<Scalar, /*complexRelations=*/true> >();
+    checkTemperaturePressureCache<Scalar, Opm::FluidSystems::H2OAir<Scalar, Opm::SimpleH2O<Scalar>, /*complexRelations=*/true> >();
+}
+
+// the array-valued methods of the fluid systems must yield exactly the same results as
+// the methods for single fluid states, both for a fluid state array and for a vector
+// of fluid states
+template <class Scalar, class FluidSystem>
+void checkFluidSystemBatches(bool checkThermal)
+{
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    enum { numCells = 5 };
+
+    Opm::FluidStateArray<Scalar, FluidSystem> fsArray(numCells);
+    std::vector<FluidState> fsVector(numCells);
+    std::vector<ParameterCache> paramCaches(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState& fs = fsVector[cellIdx];
+        fs.setTemperature(290.0 + 10*cellIdx);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs.setPressure(phaseIdx, 2e6*(1 + cellIdx) + 1e5*phaseIdx);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fs.setMoleFraction(phaseIdx, compIdx, (1.0 + (compIdx + phaseIdx + cellIdx) % 3)/(2*numComponents));
+        }
+        fsArray[cellIdx].assign(fs);
+        paramCaches[cellIdx].updateAll(fs);
+    }
+
+    std::vector<Scalar> refValues(numCells);
+    std::vector<Scalar> arrayValues(numCells);
+    std::vector<Scalar> vectorValues(numCells);
+    auto checkValues = [&](const char* what, unsigned phaseIdx) {
+        if (arrayValues != refValues || vectorValues != refValues)
+            throw std::logic_error(std::string("The array-valued method for the ")
+                                   + what + " of " + FluidSystem::phaseName(phaseIdx)
+                                   + " yields wrong results");
+    };
+
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            refValues[cellIdx] = FluidSystem::density(fsVector[cellIdx], paramCaches[cellIdx], phaseIdx);
+        FluidSystem::densityBatch(numCells, fsArray, paramCaches.data(), phaseIdx, arrayValues.data());
+        FluidSystem::densityBatch(numCells, fsVector, paramCaches.data(), phaseIdx, vectorValues.data());
+        checkValues("density", phaseIdx);
+
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            refValues[cellIdx] = FluidSystem::viscosity(fsVector[cellIdx], paramCaches[cellIdx], phaseIdx);
+        FluidSystem::viscosityBatch(numCells, fsArray, paramCaches.data(), phaseIdx, arrayValues.data());
+        FluidSystem::viscosityBatch(numCells, fsVector, paramCaches.data(), phaseIdx, vectorValues.data());
+        checkValues("viscosity", phaseIdx);
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+                refValues[cellIdx] =
+                    FluidSystem::fugacityCoefficient(fsVector[cellIdx], paramCaches[cellIdx], phaseIdx, compIdx);
+            FluidSystem::fugacityCoefficientBatch(numCells, fsArray, paramCaches.data(),
+                                                  phaseIdx, compIdx, arrayValues.data());
+            FluidSystem::fugacityCoefficientBatch(numCells, fsVector, paramCaches.data(),
+                                                  phaseIdx, compIdx, vectorValues.data());
+            checkValues("fugacity coefficients", phaseIdx);
+        }
+
+        if (!checkThermal)
+            continue;
+
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            refValues[cellIdx] = FluidSystem::enthalpy(fsVector[cellIdx], paramCaches[cellIdx], phaseIdx);
+        FluidSystem::enthalpyBatch(numCells, fsArray, paramCaches.data(), phaseIdx, arrayValues.data());
+        FluidSystem::enthalpyBatch(numCells, fsVector, paramCaches.data(), phaseIdx, vectorValues.data());
+        checkValues("enthalpy", phaseIdx);
+
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            refValues[cellIdx] = FluidSystem::heatCapacity(fsVector[cellIdx], paramCaches[cellIdx], phaseIdx);
+        FluidSystem::heatCapacityBatch(numCells, fsArray, paramCaches.data(), phaseIdx, arrayValues.data());
+        FluidSystem::heatCapacityBatch(numCells, fsVector, paramCaches.data(), phaseIdx, vectorValues.data());
+        checkValues("heat capacity", phaseIdx);
+    }
+}
+
+template <class Scalar>
+void testFluidSystemBatches()
+{
+    typedef Opm::FluidSystems::BrineCO2<Scalar, Opm::FluidSystemsTest::CO2Tables> BrineCO2;
+    typedef Opm::FluidSystems::Spe5<Scalar> Spe5;
+
+    BrineCO2::init(/*tempMin=*/273.15, /*tempMax=*/373.15, /*nTemp=*/20,
+                   /*pressMin=*/1e5, /*pressMax=*/4e7, /*nPress=*/20);
+    Spe5::init();
+
+    checkFluidSystemBatches<Scalar, Opm::FluidSystems::H2ON2<Scalar, /*complexRelations=*/false> >(/*checkThermal=*/true);
+    checkFluidSystemBatches<Scalar, Opm::FluidSystems::H2ON2<Scalar, /*complexRelations=*/true> >(/*checkThermal=*/true);
+    checkFluidSystemBatches<Scalar, BrineCO2>(/*checkThermal=*/true);
+    checkFluidSystemBatches<Scalar, Spe5>(/*checkThermal=*/false);
+}
+
+template <class Scalar, class FluidSystem>
+void checkMixtureTables(const Scalar* moleFractions, bool hasDiffusionCoefficients = true)
+{
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    enum { numPoints = 3 };
+
+    // the last point is outside of the tabulated range
+    const Scalar temperatures[numPoints] = { 283.15, 311.0, 400.0 };
+    const Scalar pressures[numPoints] = { 1.2e5, 3.7e5, 2e6 };
+
+    FluidState fs[numPoints];
+    std::vector<Scalar> analyticValues;
+    ParameterCache paramCache;
+    for (unsigned pointIdx = 0; pointIdx < numPoints; ++pointIdx) {
+        fs[pointIdx].setTemperature(temperatures[pointIdx]);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs[pointIdx].setPressure(phaseIdx, pressures[pointIdx]);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fs[pointIdx].setMoleFraction(phaseIdx, compIdx, moleFractions[compIdx]);
+        }
+    }
+
+    auto evalAll = [&](std::vector<Scalar>& values) {
+        values.clear();
+        for (unsigned pointIdx = 0; pointIdx < numPoints; ++pointIdx) {
+            values.push_back(FluidSystem::viscosity(fs[pointIdx], paramCache, FluidSystem::gasPhaseIdx));
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                    values.push_back(FluidSystem::fugacityCoefficient(fs[pointIdx], paramCache, phaseIdx, compIdx));
+            if (hasDiffusionCoefficients)
+                values.push_back(FluidSystem::diffusionCoefficient(fs[pointIdx], paramCache, FluidSystem::gasPhaseIdx, FluidSystem::H2OIdx));
+        }
+    };
+
+    evalAll(analyticValues);
+    FluidSystem::initMixtureTables(/*tempMin=*/275.0, /*tempMax=*/373.15, /*nTemp=*/200,
+                                   /*pressMin=*/1e5, /*pressMax=*/1e6, /*nPress=*/50);
+    std::vector<Scalar> tabulatedValues;
+    evalAll(tabulatedValues);
+
+    unsigned valuesPerPoint = static_cast<unsigned>(analyticValues.size()/numPoints);
+    for (unsigned i = 0; i < analyticValues.size(); ++i) {
+        Scalar a = analyticValues[i];
+        Scalar b = tabulatedValues[i];
+        if (i >= (numPoints - 1)*valuesPerPoint) {
+            if (a != b)
+                throw std::logic_error("Tabulated mixture properties must not be used outside of the table");
+        }
+        else if (std::abs(a - b) > 1e-2*std::abs(a))
+            throw std::logic_error("The tabulated mixture properties deviate too much from the analytic ones");
+    }
+}
+
+template <class Scalar>
+void testMixtureTables()
+{
+    const Scalar x2[] = { 0.3, 0.7 };
+    const Scalar x3[] = { 0.2, 0.1, 0.7 };
+
+    checkMixtureTables<Scalar, Opm::FluidSystems::H2OAir<Scalar, Opm::SimpleH2O<Scalar>, /*complexRelations=*/true> >(x2, /*hasDiffusionCoefficients=*/false);
+    checkMixtureTables<Scalar, Opm::FluidSystems::H2ON2<Scalar, /*complexRelations=*/true> >(x2);
+    checkMixtureTables<Scalar, Opm::FluidSystems::H2OAirXylene<Scalar> >(x3);
+    checkMixtureTables<Scalar, Opm::FluidSystems::H2OAirMesitylene<Scalar> >(x3);
+}
+
+// the component constants can be used in constant expressions
+static_assert(Opm::H2O<double>::molarMass() > 0.0, "H2O::molarMass() must be constexpr");
+static_assert(Opm::N2<double>::criticalTemperature() > 0.0, "N2::criticalTemperature() must be constexpr");
+static_assert(Opm::FluidSystems::H2ON2<double>::molarMass(Opm::FluidSystems::H2ON2<double>::N2Idx)
+              == Opm::N2<double>::molarMass(),
+              "H2ON2::molarMass() must be constexpr");
+
+template <class Scalar, class FluidSystem>
+void checkStaticIndices()
+{
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    enum { liquidPhaseIdx = FluidSystem::liquidPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+    enum { H2OIdx = FluidSystem::H2OIdx };
+    enum { N2Idx = FluidSystem::N2Idx };
+
+    FluidState fs;
+    fs.setTemperature(310.0);
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+        fs.setPressure(phaseIdx, 2e5);
+        fs.setMoleFraction(phaseIdx, H2OIdx, phaseIdx == liquidPhaseIdx ? 0.99 : 0.05);
+        fs.setMoleFraction(phaseIdx, N2Idx, phaseIdx == liquidPhaseIdx ? 0.01 : 0.95);
+    }
+    ParameterCache paramCache;
+
+    // the variants with compile-time indices must yield exactly the same values
+    bool equal =
+        FluidSystem::template density<liquidPhaseIdx>(fs, paramCache)
+        == FluidSystem::density(fs, paramCache, liquidPhaseIdx)
+        && FluidSystem::template density<gasPhaseIdx>(fs, paramCache)
+        == FluidSystem::density(fs, paramCache, gasPhaseIdx)
+        && FluidSystem::template viscosity<liquidPhaseIdx>(fs, paramCache)
+        == FluidSystem::viscosity(fs, paramCache, liquidPhaseIdx)
+        && FluidSystem::template viscosity<gasPhaseIdx>(fs, paramCache)
+        == FluidSystem::viscosity(fs, paramCache, gasPhaseIdx)
+        && FluidSystem::template enthalpy<liquidPhaseIdx>(fs, paramCache)
+        == FluidSystem::enthalpy(fs, paramCache, liquidPhaseIdx)
+        && FluidSystem::template enthalpy<gasPhaseIdx>(fs, paramCache)
+        == FluidSystem::enthalpy(fs, paramCache, gasPhaseIdx)
+        && FluidSystem::template fugacityCoefficient<liquidPhaseIdx, H2OIdx>(fs, paramCache)
+        == FluidSystem::fugacityCoefficient(fs, paramCache, liquidPhaseIdx, H2OIdx)
+        && FluidSystem::template fugacityCoefficient<liquidPhaseIdx, N2Idx>(fs, paramCache)
+        == FluidSystem::fugacityCoefficient(fs, paramCache, liquidPhaseIdx, N2Idx)
+        && FluidSystem::template fugacityCoefficient<gasPhaseIdx, N2Idx>(fs, paramCache)
+        == FluidSystem::fugacityCoefficient(fs, paramCache, gasPhaseIdx, N2Idx);
+    if (!equal)
+        throw std::logic_error("The fluid system methods with compile-time indices deviate from the ones with runtime indices");
+}
+
+template <class Scalar>
+void testStaticIndices()
+{
+    checkStaticIndices<Scalar, Opm::FluidSystems::H2ON2<Scalar, /*complexRelations=*/false> >();
+    checkStaticIndices<Scalar, Opm::FluidSystems::H2ON2<Scalar, /*complexRelations=*/true> >();
+}
+
+// the Wilke mixing rule with precomputed factors must match the textbook formula
+template <class Scalar>
+void testWilkeViscosityMixing()
+{
+    static const int numComponents = 3;
+    const Scalar M[numComponents] = { 18.0e-3, 28.96e-3, 120.2e-3 };
+    const Scalar mu[numComponents] = { 1.2e-5, 1.8e-5, 0.7e-5 };
+    const Scalar x[numComponents] = { 0.3, 0.6, 0.1 };
+
+    Scalar muRef = 0.0;
+    for (unsigned i = 0; i < numComponents; ++i) {
+        Scalar divisor = 0.0;
+        for (unsigned j = 0; j < numComponents; ++j) {
+            Scalar phiIJ = 1 + std::sqrt(mu[i]/mu[j])*std::pow(M[j]/M[i], 1/4.0);
+            phiIJ *= phiIJ;
+            phiIJ /= std::sqrt(8*(1 + M[i]/M[j]));
+            divisor += x[j]*phiIJ;
+        }
+        muRef += x[i]*mu[i]/divisor;
+    }
+
+    const Opm::WilkeViscosityMixing<Scalar, numComponents> mixing(M);
+    const Scalar tol = 100*std::numeric_limits<Scalar>::epsilon();
+    if (!(std::abs(mixing.viscosity(mu, x) - muRef) <= tol*muRef))
+        throw std::logic_error("The Wilke mixing rule deviates from the textbook formula");
+
+    // the mole fractions do not need to be normalized
+    const Scalar xScaled[numComponents] = { 0.6, 1.2, 0.2 };
+    if (!(std::abs(mixing.viscosity(mu, xScaled) - muRef) <= tol*muRef))
+        throw std::logic_error("The Wilke mixing rule depends on the sum of the mole fractions");
+}
+
+// the properties which the components declare to be constant must be the values of the
+// components and must not exhibit any derivatives
+template <class Scalar>
+void testConstantPhaseProperties()
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, 2> Evaluation;
+    typedef Opm::SimpleH2O<Scalar> H2O;
+    typedef Opm::DNAPL<Scalar> Dnapl;
+    typedef Opm::LiquidPhase<Scalar, H2O> Water;
+    typedef Opm::LiquidPhase<Scalar, Dnapl> Napl;
+    typedef Opm::GasPhase<Scalar, H2O> Steam;
+    typedef Opm::FluidSystems::TwoPhaseImmiscible<Scalar, Water, Napl> FluidSystem;
+    typedef Opm::FluidSystems::SinglePhase<Scalar, Steam> GasFluidSystem;
+
+    static_assert(Water::densityIsConstant && Water::viscosityIsConstant
+                  && Napl::densityIsConstant && Napl::heatCapacityIsConstant
+                  && Steam::viscosityIsConstant && !Steam::densityIsConstant,
+                  "Unexpected constant properties of the phases");
+    static_assert(!Opm::LiquidPhase<Scalar, Opm::H2O<Scalar> >::densityIsConstant
+                  && !Opm::GasPhase<Scalar, Opm::N2<Scalar> >::viscosityIsConstant,
+                  "Components must not declare any constant properties by default");
+
+    Opm::ImmiscibleFluidState<Evaluation, FluidSystem> fs;
+    fs.setTemperature(Opm::variable<Evaluation>(320.0, 0));
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+        fs.setPressure(phaseIdx, Opm::variable<Evaluation>(2e6 + 1e5*phaseIdx, 1));
+    typename FluidSystem::template ParameterCache<Evaluation> paramCache;
+
+    auto checkConstant = [](const Evaluation& value, Scalar refValue, const char* what) {
+        if (value.value() != refValue)
+            throw std::logic_error(std::string("The constant ") + what + " is wrong");
+        for (int derivIdx = 0; derivIdx < Evaluation::size; ++derivIdx)
+            if (value.derivative(derivIdx) != 0.0)
+                throw std::logic_error(std::string("The constant ") + what + " exhibits a derivative");
+    };
+
+    const Scalar T = 320.0;
+    const Scalar p = 2e6;
+    checkConstant(FluidSystem::density(fs, paramCache, 0), H2O::liquidDensity(T, p), "water density");
+    checkConstant(FluidSystem::viscosity(fs, paramCache, 0), H2O::liquidViscosity(T, p), "water viscosity");
+    checkConstant(FluidSystem::density(fs, paramCache, 1), Dnapl::liquidDensity(T, p), "DNAPL density");
+    checkConstant(FluidSystem::viscosity(fs, paramCache, 1), Dnapl::liquidViscosity(T, p), "DNAPL viscosity");
+    checkConstant(FluidSystem::heatCapacity(fs, paramCache, 1), Dnapl::liquidHeatCapacity(T, p), "DNAPL heat capacity");
+    checkConstant(FluidSystem::thermalConductivity(fs, paramCache, 1), Dnapl::liquidThermalConductivity(T, p),
+                  "DNAPL thermal conductivity");
+
+    // the density of steam depends on the pressure, its viscosity does not
+    Opm::ImmiscibleFluidState<Evaluation, GasFluidSystem> gasFs;
+    gasFs.setTemperature(Opm::variable<Evaluation>(T, 0));
+    gasFs.setPressure(0, Opm::variable<Evaluation>(p, 1));
+    typename GasFluidSystem::template ParameterCache<Evaluation> gasParamCache;
+    checkConstant(GasFluidSystem::viscosity(gasFs, gasParamCache, 0), H2O::gasViscosity(T, p), "steam viscosity");
+    const Evaluation& rhoSteam = GasFluidSystem::density(gasFs, gasParamCache, 0);
+    if (rhoSteam.value() != H2O::gasDensity(T, p) || !(rhoSteam.derivative(1) > 0.0))
+        throw std::logic_error("The density of steam is wrong");
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -314,6 +1560,7 @@ inline void testAll()
     // ensure that all fluid states are API-compliant
     testAllFluidStates<Scalar>();
     testAllFluidStates<Evaluation>();
+    testLazyFluidStateModules<Scalar>();
 
     // ensure that all fluid systems are API-compliant: Each fluid system must be usable
     // for both, scalars and function evaluations. The fluid systems for function
@@ -321,6 +1568,20 @@ inline void testAll()
     testAllFluidSystems<Scalar, /*FluidStateEval=*/Scalar, /*LhsEval=*/Scalar>();
     testAllFluidSystems<Scalar, /*FluidStateEval=*/Evaluation, /*LhsEval=*/Evaluation>();
     testAllFluidSystems<Scalar, /*FluidStateEval=*/Evaluation, /*LhsEval=*/Scalar>();
+
+    testBlackoilContexts<Scalar>();
+    testBlackoilStaticPhases<Scalar>();
+    testBlackoilFluidState<Scalar>();
+    testBlackoilPropertyExport<Scalar>();
+    testBlackoilSurfaceVolumes<Scalar>();
+    testBlackoilSaturatedSwitch<Scalar>();
+    testBrineCO2ParameterCache<Scalar>();
+    testTemperaturePressureCaches<Scalar>();
+    testFluidSystemBatches<Scalar>();
+    testStaticIndices<Scalar>();
+    testMixtureTables<Scalar>();
+    testWilkeViscosityMixing<Scalar>();
+    testConstantPhaseProperties<Scalar>();
 }
 
 int main(int argc, char **argv)
@@ -42,6 +42,7 @@
 #include <opm/material/fluidsystems/H2ON2FluidSystem.hpp>
 
 #include <opm/material/fluidmatrixinteractions/LinearMaterial.hpp>
+#include <opm/material/fluidmatrixinteractions/NullMaterial.hpp>
 #include <opm/material/fluidmatrixinteractions/RegularizedBrooksCorey.hpp>
 #include <opm/material/fluidmatrixinteractions/EffToAbsLaw.hpp>
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
@@ -125,6 +126,79 @@ void checkImmiscibleFlash(const FluidState& fsRef,
 
     // compare the "flashed" fluid state with the reference one
     checkSame<Scalar>(fsRef, fsFlash);
+
+    // a flash calculation which starts at the solution must converge immediately
+    Opm::FlashStatistics<Scalar> stats;
+    ImmiscibleFlash::template solve<MaterialLaw>(fsFlash, matParams, paramCache, globalMolarities, stats);
+    if (!stats.converged || stats.linearSolverFailed || stats.numIterations > 1)
+        OPM_THROW(std::runtime_error,
+                  "warm-started flash calculation did not converge in one iteration"
+                  " (" << stats.numIterations << " iterations)");
+    checkSame<Scalar>(fsRef, fsFlash);
+}
+
+// make sure that the derivatives obtained via the implicit function theorem are the
+// same as the ones obtained by running the Newton method using function evaluations
+template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
+void checkImmiscibleFlashImplicitDerivatives(const FluidState& fsRef,
+                                             typename MaterialLaw::Params& matParams)
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    typedef Opm::DenseAd::Evaluation<Scalar, numComponents + 1> Evaluation;
+    typedef Dune::FieldVector<Evaluation, numComponents> ComponentVector;
+    typedef Opm::ImmiscibleFluidState<Evaluation, FluidSystem> EvalFluidState;
+    typedef typename FluidSystem::template ParameterCache<Evaluation> ParameterCache;
+    typedef Opm::ImmiscibleFlash<Scalar, FluidSystem> ImmiscibleFlash;
+
+    // the derivatives are taken with regard to the global molarities and the
+    // temperature
+    ComponentVector globalMolarities(0.0);
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+        Scalar c = 0.0;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            c += fsRef.saturation(phaseIdx)*fsRef.molarity(phaseIdx, compIdx);
+        globalMolarities[compIdx] = Evaluation::createVariable(c, compIdx);
+    }
+    const Evaluation& T = Evaluation::createVariable(fsRef.temperature(/*phaseIdx=*/0), numComponents);
+
+    EvalFluidState fsNewton;
+    fsNewton.setTemperature(T);
+    ImmiscibleFlash::guessInitial(fsNewton, globalMolarities);
+    EvalFluidState fsImplicit(fsNewton);
+    ParameterCache paramCacheNewton;
+    ParameterCache paramCacheImplicit;
+
+    Opm::FlashStatistics<Scalar> stats;
+    ImmiscibleFlash::template solve<MaterialLaw>(fsNewton, matParams, paramCacheNewton, globalMolarities, stats);
+    if (!stats.converged)
+        OPM_THROW(std::runtime_error, "flash calculation using function evaluations did not converge");
+
+    ImmiscibleFlash::template solveWithImplicitDerivatives<MaterialLaw>(fsImplicit, matParams, paramCacheImplicit, globalMolarities, stats);
+    if (!stats.converged)
+        OPM_THROW(std::runtime_error, "flash calculation using implicit derivatives did not converge");
+
+    Scalar tol = std::max(std::numeric_limits<Scalar>::epsilon()*1e5, 1e-6);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        const Evaluation a[] = { fsNewton.pressure(phaseIdx), fsNewton.saturation(phaseIdx) };
+        const Evaluation b[] = { fsImplicit.pressure(phaseIdx), fsImplicit.saturation(phaseIdx) };
+
+        for (unsigned i = 0; i < 2; ++i) {
+            // the derivatives are compared relative to the largest one of the quantity
+            Scalar scale = std::numeric_limits<Scalar>::min();
+            for (int derivIdx = 0; derivIdx < Evaluation::size; ++derivIdx)
+                scale = std::max(scale, std::abs(a[i].derivative(derivIdx)));
+
+            for (int derivIdx = 0; derivIdx < Evaluation::size; ++derivIdx) {
+                if (std::abs(a[i].derivative(derivIdx) - b[i].derivative(derivIdx)) > tol*scale)
+                    OPM_THROW(std::runtime_error,
+                              "derivative " << derivIdx << " of quantity " << i
+                              << " of phase " << phaseIdx << " is incorrect: "
+                              << b[i].derivative(derivIdx) << " implicit vs "
+                              << a[i].derivative(derivIdx) << " Newton");
+            }
+        }
+    }
 }
 
 
@@ -249,6 +323,7 @@ inline void testAll()
 
     // check the flash calculation
     checkImmiscibleFlash<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams);
+    checkImmiscibleFlashImplicitDerivatives<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams);
 
     ////////////////
     // with capillary pressure
@@ -273,6 +348,35 @@ inline void testAll()
 
     // check the flash calculation
     checkImmiscibleFlash<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams2);
+    checkImmiscibleFlashImplicitDerivatives<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams2);
+
+    ////////////////
+    // without capillary pressure. this uses the scalar Newton method for the pressure
+    // which is common to all phases
+    ////////////////
+    std::cout << "testing two-phase without capillary pressure\n";
+
+    typedef Opm::NullMaterial<MaterialLawTraits> NullMaterialLaw;
+    typename NullMaterialLaw::Params nullParams;
+
+    fsRef.setSaturation(liquidPhaseIdx, 0.3);
+    fsRef.setPressure(liquidPhaseIdx, 2e6);
+    completeReferenceFluidState<Scalar, FluidSystem, NullMaterialLaw>(fsRef, nullParams, liquidPhaseIdx);
+
+    checkImmiscibleFlash<Scalar, FluidSystem, NullMaterialLaw>(fsRef, nullParams);
+    checkImmiscibleFlashImplicitDerivatives<Scalar, FluidSystem, NullMaterialLaw>(fsRef, nullParams);
+
+    // the results must be the same as the ones of the multi-dimensional Newton method,
+    // which is used for material laws that do not guarantee zero capillary pressure
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, liquidPhaseIdx, gasPhaseIdx> LinearTraits;
+    typedef Opm::LinearMaterial<LinearTraits> LinearMaterialLaw;
+    typename LinearMaterialLaw::Params linearParams;
+    linearParams.setPcMinSat(liquidPhaseIdx, 0.0);
+    linearParams.setPcMaxSat(liquidPhaseIdx, 0.0);
+    linearParams.setPcMinSat(gasPhaseIdx, 0.0);
+    linearParams.setPcMaxSat(gasPhaseIdx, 0.0);
+    linearParams.finalize();
+    checkImmiscibleFlash<Scalar, FluidSystem, LinearMaterialLaw>(fsRef, linearParams);
 }
 
 int main(int argc, char **argv)
@@ -35,6 +35,7 @@
 #include <opm/material/constraintsolvers/NcpFlash.hpp>
 #include <opm/material/constraintsolvers/MiscibleMultiPhaseComposition.hpp>
 #include <opm/material/constraintsolvers/ComputeFromReferencePhase.hpp>
+#include <opm/material/densead/Evaluation.hpp>
 
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
 
@@ -49,6 +50,8 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <vector>
+
 template <class Scalar, class FluidState>
 void checkSame(const FluidState& fsRef, const FluidState& fsFlash)
 {
@@ -125,9 +128,136 @@ void checkNcpFlash(const FluidState& fsRef,
 
     // compare the "flashed" fluid state with the reference one
     checkSame<Scalar>(fsRef, fsFlash);
+
+    // a flash calculation which starts at the solution must converge immediately
+    Opm::FlashStatistics<Scalar> stats;
+    NcpFlash::template solve<MaterialLaw>(fsFlash, matParams, paramCache, globalMolarities, stats);
+    if (!stats.converged || stats.linearSolverFailed || stats.numIterations > 1)
+        OPM_THROW(std::runtime_error,
+                  "warm-started flash calculation did not converge in one iteration"
+                  " (" << stats.numIterations << " iterations)");
+    checkSame<Scalar>(fsRef, fsFlash);
+}
+
+// make sure that the derivatives obtained via the implicit function theorem are the
+// same as the ones obtained by running the Newton method using function evaluations
+template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
+void checkNcpFlashImplicitDerivatives(const FluidState& fsRef,
+                                      typename MaterialLaw::Params& matParams)
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    typedef Opm::DenseAd::Evaluation<Scalar, numComponents + 1> Evaluation;
+    typedef Dune::FieldVector<Evaluation, numComponents> ComponentVector;
+    typedef Opm::CompositionalFluidState<Evaluation, FluidSystem> EvalFluidState;
+    typedef typename FluidSystem::template ParameterCache<Evaluation> ParameterCache;
+    typedef Opm::NcpFlash<Scalar, FluidSystem> NcpFlash;
+
+    // the derivatives are taken with regard to the global molarities and the
+    // temperature
+    ComponentVector globalMolarities(0.0);
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+        Scalar c = 0.0;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            c += fsRef.saturation(phaseIdx)*fsRef.molarity(phaseIdx, compIdx);
+        globalMolarities[compIdx] = Evaluation::createVariable(c, compIdx);
+    }
+    const Evaluation& T = Evaluation::createVariable(fsRef.temperature(/*phaseIdx=*/0), numComponents);
+
+    EvalFluidState fsNewton;
+    fsNewton.setTemperature(T);
+    ParameterCache paramCacheNewton;
+    paramCacheNewton.updateAll(fsNewton);
+    NcpFlash::guessInitial(fsNewton, globalMolarities);
+    EvalFluidState fsImplicit(fsNewton);
+    ParameterCache paramCacheImplicit(paramCacheNewton);
+
+    Opm::FlashStatistics<Scalar> stats;
+    NcpFlash::template solve<MaterialLaw>(fsNewton, matParams, paramCacheNewton, globalMolarities, stats);
+    if (!stats.converged)
+        OPM_THROW(std::runtime_error, "flash calculation using function evaluations did not converge");
+
+    NcpFlash::template solveWithImplicitDerivatives<MaterialLaw>(fsImplicit, matParams, paramCacheImplicit, globalMolarities, stats);
+    if (!stats.converged)
+        OPM_THROW(std::runtime_error, "flash calculation using implicit derivatives did not converge");
+
+    // the Jacobian matrix of the flash problem is poorly conditioned, so the
+    // derivatives are less accurate than the values if single precision is used
+    Scalar tol = std::max(std::numeric_limits<Scalar>::epsilon()*1e5, 1e-6);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        std::array<Evaluation, 2 + numComponents> a = {{ fsNewton.pressure(phaseIdx), fsNewton.saturation(phaseIdx) }};
+        std::array<Evaluation, 2 + numComponents> b = {{ fsImplicit.pressure(phaseIdx), fsImplicit.saturation(phaseIdx) }};
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            a[2 + compIdx] = fsNewton.moleFraction(phaseIdx, compIdx);
+            b[2 + compIdx] = fsImplicit.moleFraction(phaseIdx, compIdx);
+        }
+
+        for (unsigned i = 0; i < a.size(); ++i) {
+            // the derivatives are compared relative to the largest one of the quantity
+            Scalar scale = std::numeric_limits<Scalar>::min();
+            for (int derivIdx = 0; derivIdx < Evaluation::size; ++derivIdx)
+                scale = std::max(scale, std::abs(a[i].derivative(derivIdx)));
+
+            for (int derivIdx = 0; derivIdx < Evaluation::size; ++derivIdx) {
+                if (std::abs(a[i].derivative(derivIdx) - b[i].derivative(derivIdx)) > tol*scale)
+                    OPM_THROW(std::runtime_error,
+                              "derivative " << derivIdx << " of quantity " << i
+                              << " of phase " << phaseIdx << " is incorrect: "
+                              << b[i].derivative(derivIdx) << " implicit vs "
+                              << a[i].derivative(derivIdx) << " Newton");
+            }
+        }
+    }
 }
 
 
+template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
+void checkNcpFlashMany(const std::vector<FluidState>& fsRefs,
+                       const typename MaterialLaw::Params& matParams)
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+    typedef typename FluidSystem::template ParameterCache<typename FluidState::Scalar> ParameterCache;
+    typedef Opm::NcpFlash<Scalar, FluidSystem> NcpFlash;
+
+    unsigned numCells = static_cast<unsigned>(fsRefs.size());
+    std::vector<FluidState> fsFlash(numCells);
+    std::vector<ComponentVector> globalMolarities(numCells, ComponentVector(0.0));
+    std::vector<ParameterCache> paramCaches(numCells);
+    std::vector<const typename MaterialLaw::Params*> matParamPtrs(numCells, &matParams);
+    std::vector<int> numIterations(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        const FluidState& fsRef = fsRefs[cellIdx];
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                globalMolarities[cellIdx][compIdx] +=
+                    fsRef.saturation(phaseIdx)*fsRef.molarity(phaseIdx, compIdx);
+
+        fsFlash[cellIdx].setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+        paramCaches[cellIdx].updateAll(fsFlash[cellIdx]);
+        NcpFlash::guessInitial(fsFlash[cellIdx], globalMolarities[cellIdx]);
+    }
+
+    unsigned numFailed =
+        NcpFlash::template solveMany<MaterialLaw>(fsFlash.data(),
+                                                  matParamPtrs.data(),
+                                                  paramCaches.data(),
+                                                  globalMolarities.data(),
+                                                  numIterations.data(),
+                                                  numCells);
+    if (numFailed != 0)
+        OPM_THROW(std::runtime_error,
+                  "batched flash calculation failed for " << numFailed << " cells");
+
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        if (numIterations[cellIdx] <= 0)
+            OPM_THROW(std::runtime_error,
+                      "invalid iteration count for cell " << cellIdx);
+        checkSame<Scalar>(fsRefs[cellIdx], fsFlash[cellIdx]);
+    }
+}
+
 template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState>
 void completeReferenceFluidState(FluidState& fs,
                                  typename MaterialLaw::Params& matParams,
@@ -161,6 +291,53 @@ void completeReferenceFluidState(FluidState& fs,
 }
 
 
+template <class Scalar, class FluidSystem, class FluidState>
+void checkMiscibleMultiPhaseComposition(const FluidState& fs,
+                                        const Opm::MMPCAuxConstraint<Scalar>* auxConstraints,
+                                        unsigned numAuxConstraints,
+                                        int phasePresence)
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    Scalar tol = std::max(std::numeric_limits<Scalar>::epsilon()*1e4, 1e-6);
+
+    // the fugacities of each component must be the same in all phases
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+        Scalar fug0 = fs.fugacity(/*phaseIdx=*/0, compIdx);
+        for (unsigned phaseIdx = 1; phaseIdx < numPhases; ++phaseIdx) {
+            Scalar fug = fs.fugacity(phaseIdx, compIdx);
+            if (std::abs(fug - fug0) > tol*std::max(std::abs(fug), std::abs(fug0)))
+                OPM_THROW(std::runtime_error,
+                          "MiscibleMultiPhaseComposition: the fugacities of component "
+                          << compIdx << " differ: " << fug0 << " vs " << fug);
+        }
+    }
+
+    // the mole fractions of the present phases must sum up to 1
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        if (!(phasePresence & (1 << phaseIdx)))
+            continue;
+
+        Scalar sumx = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            sumx += fs.moleFraction(phaseIdx, compIdx);
+        if (std::abs(sumx - 1.0) > tol)
+            OPM_THROW(std::runtime_error,
+                      "MiscibleMultiPhaseComposition: the mole fractions of phase "
+                      << phaseIdx << " sum up to " << sumx);
+    }
+
+    // the auxiliary constraints must be met
+    for (unsigned auxIdx = 0; auxIdx < numAuxConstraints; ++auxIdx) {
+        const auto& aux = auxConstraints[auxIdx];
+        if (std::abs(fs.moleFraction(aux.phaseIdx(), aux.compIdx()) - aux.value()) > tol)
+            OPM_THROW(std::runtime_error,
+                      "MiscibleMultiPhaseComposition: auxiliary constraint for component "
+                      << aux.compIdx() << " in phase " << aux.phaseIdx() << " is violated");
+    }
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -203,6 +380,7 @@ inline void testAll()
     matParams.finalize();
 
     CompositionalFluidState fsRef;
+    std::vector<CompositionalFluidState> fsRefs;
 
     // create an fluid state which is consistent
 
@@ -229,6 +407,7 @@ inline void testAll()
 
     // check the flash calculation
     checkNcpFlash<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams);
+    fsRefs.push_back(fsRef);
 
     ////////////////
     // only gas
@@ -249,6 +428,7 @@ inline void testAll()
 
     // check the flash calculation
     checkNcpFlash<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams);
+    fsRefs.push_back(fsRef);
 
     ////////////////
     // both phases
@@ -268,9 +448,43 @@ inline void testAll()
     MiscibleMultiPhaseComposition::solve(fsRef, paramCache,
                                          /*setViscosity=*/false,
                                          /*setEnthalpy=*/false);
+    checkMiscibleMultiPhaseComposition<Scalar, FluidSystem>(fsRef,
+                                                            /*auxConstraints=*/nullptr,
+                                                            /*numAuxConstraints=*/0,
+                                                            /*phasePresence=*/0xffffff);
+
+    // only the liquid phase is present, the nitrogen content of the gas phase is given
+    {
+        CompositionalFluidState fsAux;
+        fsAux.assign(fsRef);
+        Opm::MMPCAuxConstraint<Scalar> auxConstraint(gasPhaseIdx, N2Idx, 0.9);
+        MiscibleMultiPhaseComposition::solve(fsAux, paramCache,
+                                             /*phasePresence=*/1 << liquidPhaseIdx,
+                                             &auxConstraint,
+                                             /*numAuxConstraints=*/1,
+                                             /*setViscosity=*/false,
+                                             /*setEnthalpy=*/false);
+        checkMiscibleMultiPhaseComposition<Scalar, FluidSystem>(fsAux,
+                                                                &auxConstraint,
+                                                                /*numAuxConstraints=*/1,
+                                                                /*phasePresence=*/1 << liquidPhaseIdx);
+    }
 
     // check the flash calculation
     checkNcpFlash<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams);
+    checkNcpFlashImplicitDerivatives<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams);
+    fsRefs.push_back(fsRef);
+
+    // flash all of the above cases at once
+    std::cout << "testing batched flash\n";
+    checkNcpFlashMany<Scalar, FluidSystem, MaterialLaw>(fsRefs, matParams);
+
+    // a larger batch whose cells need different numbers of iterations, so that the
+    // cells are distributed to the threads and re-queued
+    std::vector<CompositionalFluidState> manyFsRefs;
+    for (unsigned i = 0; i < 200; ++i)
+        manyFsRefs.push_back(fsRefs[(i*i) % fsRefs.size()]);
+    checkNcpFlashMany<Scalar, FluidSystem, MaterialLaw>(manyFsRefs, matParams);
 
     ////////////////
     // with capillary pressure
@@ -305,6 +519,7 @@ inline void testAll()
 
     // check the flash calculation
     checkNcpFlash<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams2);
+    checkNcpFlashImplicitDerivatives<Scalar, FluidSystem, MaterialLaw>(fsRef, matParams2);
 }
 
 int main(int argc, char **argv)
@@ -31,8 +31,11 @@
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/material/constraintsolvers/ComputeFromReferencePhase.hpp>
 #include <opm/material/constraintsolvers/NcpFlash.hpp>
+#include <opm/material/constraintsolvers/RachfordRiceFlash.hpp>
+#include <opm/material/constraintsolvers/SuccessiveSubstitutionFlash.hpp>
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
 #include <opm/material/fluidsystems/Spe5FluidSystem.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/BlackOilTableGenerator.hpp>
 #include <opm/material/fluidmatrixinteractions/LinearMaterial.hpp>
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
 
@@ -40,6 +43,9 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <cstdio>
+#include <string>
+
 template <class FluidSystem, class FluidState>
 void createSurfaceGasFluidSystem(FluidState& gasFluidState)
 {
@@ -292,6 +298,519 @@ void printResult(const RawTable& rawTable,
     std::cout << "};\n";
 }
 
+// make sure that a parameter cache which is updated incrementally yields the same
+// results as one that is set up from scratch
+template <class Scalar, class FluidSystem, class FluidState>
+void checkParameterCacheUpdate(const FluidState& origFluidState)
+{
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    FluidState fluidState;
+    fluidState.assign(origFluidState);
+
+    ParameterCache paramCache;
+    paramCache.updateAll(fluidState);
+
+    auto compare = [&](const char* what) {
+        ParameterCache freshParamCache;
+        freshParamCache.updateAll(fluidState);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (paramCache.molarVolume(phaseIdx) != freshParamCache.molarVolume(phaseIdx))
+                OPM_THROW(std::runtime_error,
+                          "Molar volume of phase " << FluidSystem::phaseName(phaseIdx)
+                          << " is outdated after changing the " << what);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                if (FluidSystem::fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx)
+                    != FluidSystem::fugacityCoefficient(fluidState, freshParamCache, phaseIdx, compIdx))
+                    OPM_THROW(std::runtime_error,
+                              "Fugacity coefficient of phase " << FluidSystem::phaseName(phaseIdx)
+                              << " is outdated after changing the " << what);
+        }
+    };
+
+    // nothing changed
+    paramCache.updateAll(fluidState);
+    compare("nothing");
+
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+        fluidState.setPressure(phaseIdx, 1.1*fluidState.pressure(phaseIdx));
+    paramCache.updateAll(fluidState);
+    compare("pressure");
+
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        fluidState.setMoleFraction(phaseIdx, 0, 0.9*fluidState.moleFraction(phaseIdx, 0));
+        fluidState.setMoleFraction(phaseIdx, 1, fluidState.moleFraction(phaseIdx, 1)
+                                   + 0.1*fluidState.moleFraction(phaseIdx, 0)/0.9);
+    }
+    paramCache.updateAll(fluidState);
+    compare("composition");
+
+    fluidState.setTemperature(fluidState.temperature(0) + 5.0);
+    paramCache.updateAll(fluidState);
+    compare("temperature");
+}
+
+// compare the result of the successive substitution flash with a fluid state which
+// was calculated by the NCP flash solver
+template <class Scalar, class FluidSystem, class FluidState>
+void checkFugacityDerivatives(const FluidState& origFluidState, unsigned phaseIdx)
+{
+    enum { numComponents = FluidSystem::numComponents };
+
+    FluidState fluidState;
+    fluidState.assign(origFluidState);
+
+    typename FluidSystem::template ParameterCache<Scalar> paramCache;
+    paramCache.updatePhase(fluidState, phaseIdx);
+
+    Dune::FieldMatrix<Scalar, numComponents, numComponents> dLnPhi;
+    if (!FluidSystem::lnFugacityCoefficientDerivatives(dLnPhi, fluidState, paramCache, phaseIdx))
+        OPM_THROW(std::runtime_error,
+                  "Analytic fugacity derivatives are not available for phase "
+                  << FluidSystem::phaseName(phaseIdx));
+
+    // compare the analytic derivatives with forward differences (the mixing rule cuts
+    // off negative mole fractions)
+    const Scalar eps = std::sqrt(std::numeric_limits<Scalar>::epsilon());
+    Scalar lnPhi[numComponents];
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+        lnPhi[compIdx] =
+            std::log(FluidSystem::fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx));
+
+    // the fugacity coefficients of all components computed at once are the same
+    Scalar phi[numComponents];
+    FluidSystem::fugacityCoefficients(fluidState, paramCache, phaseIdx, phi);
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+        if (std::abs(std::log(phi[compIdx]) - lnPhi[compIdx]) > 1e-10)
+            OPM_THROW(std::runtime_error,
+                      "The fugacity coefficient of component " << compIdx
+                      << " computed for all components at once is " << phi[compIdx]
+                      << " instead of " << std::exp(lnPhi[compIdx]));
+
+    for (unsigned compKIdx = 0; compKIdx < numComponents; ++compKIdx) {
+        Scalar xk = fluidState.moleFraction(phaseIdx, compKIdx);
+
+        Scalar lnPhiPlus[numComponents];
+        fluidState.setMoleFraction(phaseIdx, compKIdx, xk + eps);
+        paramCache.updatePhase(fluidState, phaseIdx);
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            lnPhiPlus[compIdx] =
+                std::log(FluidSystem::fugacityCoefficient(fluidState, paramCache, phaseIdx, compIdx));
+
+        fluidState.setMoleFraction(phaseIdx, compKIdx, xk);
+        paramCache.updatePhase(fluidState, phaseIdx);
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar numeric = (lnPhiPlus[compIdx] - lnPhi[compIdx])/eps;
+            Scalar analytic = dLnPhi[compIdx][compKIdx];
+            if (std::abs(numeric - analytic) > 1e-4*std::max<Scalar>(1.0, std::abs(numeric)))
+                OPM_THROW(std::runtime_error,
+                          "Analytic derivative of ln(phi_" << compIdx << ") with regard to x_"
+                          << compKIdx << " is " << analytic
+                          << ", finite differences yield " << numeric);
+        }
+    }
+}
+
+template <class Scalar>
+void checkCriticalPointTabulation()
+{
+    typedef Opm::PengRobinson<Scalar> PengRobinson;
+
+    Scalar aMin = 1.0, aMax = 2.0;
+    Scalar bMin = 1e-4, bMax = 1.2e-4;
+    Scalar a = 1.37, b = 1.13e-4;
+
+    // reference values using Newton's method
+    PengRobinson::init(aMin, aMax, 11, bMin, bMax, 11, /*tabulateCriticalPoints=*/false);
+    Scalar TcritRef, pcritRef, VcritRef;
+    PengRobinson::computeCriticalPoint(TcritRef, pcritRef, VcritRef, a, b);
+
+    const std::string cacheFileName = "test_pengrobinson_critical_points.bin";
+    std::remove(cacheFileName.c_str());
+    for (unsigned i = 0; i < 2; ++i) {
+        // the first iteration computes the table and writes the cache file, the
+        // second one reads it
+        PengRobinson::init(aMin, aMax, 11, bMin, bMax, 11,
+                           /*tabulateCriticalPoints=*/true, cacheFileName);
+
+        Scalar Tcrit, pcrit, Vcrit;
+        PengRobinson::computeCriticalPoint(Tcrit, pcrit, Vcrit, a, b);
+        if (std::abs(Tcrit - TcritRef) > 1e-2*TcritRef
+            || std::abs(pcrit - pcritRef) > 1e-2*pcritRef
+            || std::abs(Vcrit - VcritRef) > 1e-2*VcritRef)
+            OPM_THROW(std::runtime_error,
+                      "Tabulated critical point (" << Tcrit << ", " << pcrit << ", " << Vcrit
+                      << ") deviates from the one determined by Newton's method ("
+                      << TcritRef << ", " << pcritRef << ", " << VcritRef << ")");
+    }
+    std::remove(cacheFileName.c_str());
+
+    // disable the tabulation again
+    PengRobinson::init(aMin, aMax, 11, bMin, bMax, 11, /*tabulateCriticalPoints=*/false);
+}
+
+template <class Scalar, class FluidSystem>
+void checkVaporPressureTabulation()
+{
+    const Scalar temperatures[] = { 280.0, 323.15, 350.0, 420.0, 500.0 };
+    const Scalar tolerance = 1e-5;
+
+    // reference values using Newton's method
+    Scalar pVapRef[FluidSystem::numComponents][5];
+    for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+        for (unsigned i = 0; i < 5; ++i)
+            pVapRef[compIdx][i] = FluidSystem::vaporPressure(compIdx, temperatures[i]);
+
+    FluidSystem::tabulateVaporPressures(/*minT=*/273.15, /*numSamples=*/20, tolerance);
+    for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx) {
+        for (unsigned i = 0; i < 5; ++i) {
+            Scalar pVap = FluidSystem::vaporPressure(compIdx, temperatures[i]);
+            Scalar pVapPolished = FluidSystem::vaporPressure(compIdx, temperatures[i], /*polish=*/true);
+            const Scalar& ref = pVapRef[compIdx][i];
+            if (std::abs(pVap - ref) > 2*tolerance*ref
+                || std::abs(pVapPolished - ref) > 1e-8*ref)
+                OPM_THROW(std::runtime_error,
+                          "Tabulated vapor pressure of " << FluidSystem::componentName(compIdx)
+                          << " at T=" << temperatures[i] << " is " << pVap << " (polished: "
+                          << pVapPolished << "), Newton's method yields " << ref);
+        }
+    }
+}
+
+template <class Scalar, class FluidSystem, class FluidState>
+void checkParamsMixtureUpdate(const FluidState& origFluidState)
+{
+    enum { numComponents = FluidSystem::numComponents };
+    enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+    typedef Opm::PengRobinsonParamsMixture<Scalar, FluidSystem, oilPhaseIdx, /*useSpe5=*/true> Params;
+
+    FluidState fluidState;
+    fluidState.assign(origFluidState);
+
+    Params params;
+    params.updatePure(fluidState);
+    params.updateMix(fluidState);
+
+    // change the mole fractions one by one and compare the incremental update with
+    // the full one
+    const Scalar tol = std::numeric_limits<Scalar>::epsilon()*1e4;
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+        fluidState.setMoleFraction(oilPhaseIdx, compIdx,
+                                   0.9*fluidState.moleFraction(oilPhaseIdx, compIdx) + 0.01);
+        params.updatePure(fluidState);
+        params.updateSingleMoleFraction(fluidState, compIdx);
+
+        Params refParams;
+        refParams.updatePure(fluidState);
+        refParams.updateMix(fluidState);
+
+        if (std::abs(params.a() - refParams.a()) > tol*refParams.a()
+            || std::abs(params.b() - refParams.b()) > tol*refParams.b())
+            OPM_THROW(std::runtime_error,
+                      "Incremental update of the Peng-Robinson mixture parameters yields a = "
+                      << params.a() << ", b = " << params.b() << " instead of a = "
+                      << refParams.a() << ", b = " << refParams.b());
+
+        for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx)
+            if (std::abs(params.aSum(compJIdx) - refParams.aSum(compJIdx))
+                > tol*std::abs(refParams.aSum(compJIdx)))
+                OPM_THROW(std::runtime_error,
+                          "Incremental update of the Peng-Robinson mixture parameters yields "
+                          "a wrong attraction sum for component " << compJIdx);
+    }
+}
+
+template <class Scalar, class FluidSystem, class FluidState>
+void checkComputeFromReferencePhaseMany(const FluidState& origFluidState, unsigned refPhaseIdx)
+{
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    typedef Opm::ComputeFromReferencePhase<Scalar, FluidSystem> CFRP;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+
+    // two rows of three cells each at different pressures
+    const unsigned numCells = 6;
+    std::vector<FluidState> fluidStates(numCells);
+    std::vector<ParameterCache> paramCaches(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        fluidStates[cellIdx].assign(origFluidState);
+        if (cellIdx >= numCells/2)
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                fluidStates[cellIdx].setPressure(phaseIdx, 0.9*origFluidState.pressure(phaseIdx));
+    }
+
+    bool failedCells[numCells];
+    unsigned numFailed = CFRP::solveMany(fluidStates.data(), paramCaches.data(), numCells,
+                                         refPhaseIdx,
+                                         /*setViscosity=*/false,
+                                         /*setEnthalpy=*/false,
+                                         failedCells);
+    if (numFailed > 0)
+        OPM_THROW(std::runtime_error,
+                  "ComputeFromReferencePhase::solveMany() failed for " << numFailed << " cells");
+
+    // compare with the results of solving each cell individually
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState fluidState;
+        fluidState.assign(origFluidState);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            fluidState.setPressure(phaseIdx, fluidStates[cellIdx].pressure(phaseIdx));
+
+        ParameterCache paramCache;
+        CFRP::solve(fluidState, paramCache, refPhaseIdx,
+                    /*setViscosity=*/false,
+                    /*setEnthalpy=*/false);
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (failedCells[cellIdx]
+                || std::abs(fluidState.density(phaseIdx) - fluidStates[cellIdx].density(phaseIdx))
+                > 1e-6*fluidState.density(phaseIdx))
+                OPM_THROW(std::runtime_error,
+                          "ComputeFromReferencePhase::solveMany() yields a different density "
+                          "for phase " << phaseIdx << " in cell " << cellIdx);
+
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                if (std::abs(fluidState.moleFraction(phaseIdx, compIdx)
+                             - fluidStates[cellIdx].moleFraction(phaseIdx, compIdx)) > 1e-6)
+                    OPM_THROW(std::runtime_error,
+                              "ComputeFromReferencePhase::solveMany() yields a different "
+                              "composition for phase " << phaseIdx << " in cell " << cellIdx);
+        }
+    }
+}
+
+template <class Scalar, class FluidSystem, class FluidState, class FlashCache>
+void checkSuccessiveSubstitutionFlash(const FluidState& ncpFluidState, FlashCache& cache)
+{
+    enum {
+        numPhases = FluidSystem::numPhases,
+        gasPhaseIdx = FluidSystem::gasPhaseIdx,
+        oilPhaseIdx = FluidSystem::oilPhaseIdx,
+        numComponents = FluidSystem::numComponents
+    };
+
+    typedef Opm::SuccessiveSubstitutionFlash<Scalar, FluidSystem> Flash;
+    typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+
+    ComponentVector globalMoleFractions(0.0);
+    Scalar totalMolarity = 0.0;
+    for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx) {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+            globalMoleFractions[compIdx] +=
+                ncpFluidState.saturation(phaseIdx)*ncpFluidState.molarity(phaseIdx, compIdx);
+        totalMolarity += globalMoleFractions[compIdx];
+    }
+    globalMoleFractions /= totalMolarity;
+
+    FluidState fluidState;
+    fluidState.assign(ncpFluidState);
+    typename FluidSystem::template ParameterCache<Scalar> paramCache;
+    Scalar vaporFraction;
+    Opm::FlashStatistics<Scalar> stats;
+    Flash::solve(fluidState, paramCache, globalMoleFractions, oilPhaseIdx, gasPhaseIdx, vaporFraction, stats);
+    if (!stats.converged)
+        OPM_THROW(std::runtime_error,
+                  "Successive substitution flash did not converge at p = "
+                  << fluidState.pressure(oilPhaseIdx));
+
+    // the second cached flash calculation of the same state must hit the cache and
+    // yield the same result
+    for (unsigned i = 0; i < 2; ++i) {
+        size_t numHits = cache.numHits();
+        FluidState cachedFluidState;
+        cachedFluidState.assign(ncpFluidState);
+        Scalar cachedVaporFraction;
+        Flash::solve(cachedFluidState, paramCache, globalMoleFractions, oilPhaseIdx, gasPhaseIdx,
+                     cachedVaporFraction, stats, cache);
+        if (!stats.converged || (i == 1 && cache.numHits() != numHits + 1))
+            OPM_THROW(std::runtime_error,
+                      "Cached flash calculation failed at p = "
+                      << fluidState.pressure(oilPhaseIdx));
+        if (std::abs(cachedVaporFraction - vaporFraction) > 1e-8)
+            OPM_THROW(std::runtime_error,
+                      "Cached flash calculation yields a different vapor fraction ("
+                      << cachedVaporFraction << " vs " << vaporFraction << ")");
+    }
+
+    bool ncpIsTwoPhase =
+        ncpFluidState.saturation(gasPhaseIdx) > 1e-2
+        && ncpFluidState.saturation(oilPhaseIdx) > 1e-2;
+    if (!ncpIsTwoPhase) {
+        if (ncpFluidState.saturation(gasPhaseIdx) < 1e-10 && vaporFraction != 0.0)
+            OPM_THROW(std::runtime_error,
+                      "Successive substitution flash splits single-phase oil at p = "
+                      << fluidState.pressure(oilPhaseIdx));
+        return;
+    }
+
+    if (vaporFraction <= 0.0 || vaporFraction >= 1.0)
+        OPM_THROW(std::runtime_error,
+                  "Successive substitution flash did not find two phases at p = "
+                  << fluidState.pressure(oilPhaseIdx));
+
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+        if (phaseIdx != gasPhaseIdx && phaseIdx != oilPhaseIdx)
+            continue;
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx) {
+            Scalar error =
+                fluidState.moleFraction(phaseIdx, compIdx)
+                - ncpFluidState.moleFraction(phaseIdx, compIdx);
+            if (std::abs(error) > 1e-5)
+                OPM_THROW(std::runtime_error,
+                          "Successive substitution flash: composition error for phase "
+                          << phaseIdx << ", component " << compIdx << " exceeds tolerance"
+                          << " (" << fluidState.moleFraction(phaseIdx, compIdx) << " vs "
+                          << ncpFluidState.moleFraction(phaseIdx, compIdx) << " NCP flash,"
+                          << " error=" << error << ")");
+        }
+    }
+}
+
+// compare the result of the reduced-variable flash with the one of the NCP flash
+template <class Scalar, class FluidSystem, class MaterialLaw, class FluidState, class ComponentVector>
+void checkRachfordRiceFlash(const FluidState& initialFluidState,
+                            const FluidState& ncpFluidState,
+                            const typename MaterialLaw::Params& matParams,
+                            const ComponentVector& totalMolarities)
+{
+    enum {
+        numPhases = FluidSystem::numPhases,
+        gasPhaseIdx = FluidSystem::gasPhaseIdx,
+        oilPhaseIdx = FluidSystem::oilPhaseIdx,
+        numComponents = FluidSystem::numComponents
+    };
+
+    typedef Opm::RachfordRiceFlash<Scalar, FluidSystem, oilPhaseIdx, gasPhaseIdx> Flash;
+
+    FluidState fluidState;
+    fluidState.assign(initialFluidState);
+    typename FluidSystem::template ParameterCache<Scalar> paramCache;
+    Opm::FlashStatistics<Scalar> stats;
+    Flash::template solve<MaterialLaw>(fluidState, matParams, paramCache, totalMolarities, stats);
+    if (!stats.converged)
+        OPM_THROW(std::runtime_error,
+                  "Reduced-variable flash did not converge at p = "
+                  << ncpFluidState.pressure(oilPhaseIdx));
+
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+        Scalar error = 1 - fluidState.pressure(phaseIdx)/ncpFluidState.pressure(phaseIdx);
+        if (std::abs(error) > 1e-6)
+            OPM_THROW(std::runtime_error,
+                      "Reduced-variable flash: pressure error for phase " << phaseIdx
+                      << " exceeds tolerance (" << fluidState.pressure(phaseIdx) << " vs "
+                      << ncpFluidState.pressure(phaseIdx) << " NCP flash)");
+
+        error = fluidState.saturation(phaseIdx) - ncpFluidState.saturation(phaseIdx);
+        if (std::abs(error) > 1e-6)
+            OPM_THROW(std::runtime_error,
+                      "Reduced-variable flash: saturation error for phase " << phaseIdx
+                      << " exceeds tolerance (" << fluidState.saturation(phaseIdx) << " vs "
+                      << ncpFluidState.saturation(phaseIdx) << " NCP flash)");
+
+        // the composition of absent phases is arbitrary
+        if (phaseIdx != gasPhaseIdx && phaseIdx != oilPhaseIdx)
+            continue;
+        if (ncpFluidState.saturation(phaseIdx) < 1e-2)
+            continue;
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx) {
+            error =
+                fluidState.moleFraction(phaseIdx, compIdx)
+                - ncpFluidState.moleFraction(phaseIdx, compIdx);
+            if (std::abs(error) > 1e-5)
+                OPM_THROW(std::runtime_error,
+                          "Reduced-variable flash: composition error for phase "
+                          << phaseIdx << ", component " << compIdx << " exceeds tolerance"
+                          << " (" << fluidState.moleFraction(phaseIdx, compIdx) << " vs "
+                          << ncpFluidState.moleFraction(phaseIdx, compIdx) << " NCP flash,"
+                          << " error=" << error << ")");
+        }
+    }
+}
+
+// generate black-oil tables from the equation of state and check that the black-oil
+// densities match the ones of the equation of state at the sampled pressures
+template <class Scalar, class FluidSystem, class ComponentVector>
+void checkBlackOilTableGenerator(const ComponentVector& globalMoleFractions, Scalar T)
+{
+    enum {
+        gasPhaseIdx = FluidSystem::gasPhaseIdx,
+        oilPhaseIdx = FluidSystem::oilPhaseIdx
+    };
+
+    typedef Opm::BlackOilTableGenerator<Scalar, FluidSystem> Generator;
+    typedef Opm::SuccessiveSubstitutionFlash<Scalar, FluidSystem> Flash;
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem, /*storeEnthalpy=*/false> FluidState;
+
+    const typename Generator::LiberationProcess processes[] = {
+        Generator::ConstantCompositionLiberation,
+        Generator::DifferentialLiberation
+    };
+    for (unsigned i = 0; i < 2; ++i) {
+        Generator generator;
+        generator.setTemperature(T);
+        generator.setSurfaceConditions(1.01325e5, T);
+        generator.setPressureSampling(/*minPressure=*/1e6, /*maxPressure=*/30e6, /*numPressures=*/30);
+        generator.setUndersaturatedSampling(/*pressureRange=*/50e5, /*numSamples=*/4);
+        generator.setLiberationProcess(processes[i]);
+
+        typename Generator::OilPvt oilPvt;
+        typename Generator::GasPvt gasPvt;
+        oilPvt.setNumRegions(1);
+        gasPvt.setNumRegions(1);
+        generator.generate(oilPvt, gasPvt, /*regionIdx=*/0, globalMoleFractions);
+        oilPvt.initEnd();
+        gasPvt.initEnd();
+
+        const Scalar rhoRefO = generator.oilReferenceDensity();
+        const Scalar rhoRefG = generator.gasReferenceDensity();
+        if (!(rhoRefO > rhoRefG && rhoRefG > 0.0))
+            OPM_THROW(std::runtime_error,
+                      "Implausible reference densities: oil " << rhoRefO << ", gas " << rhoRefG);
+
+        // oil with less dissolved gas is denser at the same pressure
+        Scalar p = 10e6;
+        Scalar Rs = oilPvt.saturatedGasDissolutionFactor(0, T, p);
+        Scalar rhoSat = oilPvt.inverseFormationVolumeFactor(0, T, p, Rs)*(rhoRefO + Rs*rhoRefG);
+        Scalar rhoUndersat = oilPvt.inverseFormationVolumeFactor(0, T, p, Rs/2)*(rhoRefO + Rs/2*rhoRefG);
+        if (!(Rs > 0.0) || !(rhoUndersat > rhoSat))
+            OPM_THROW(std::runtime_error,
+                      "Implausible black-oil tables for liberation process " << i);
+
+        if (processes[i] != Generator::ConstantCompositionLiberation)
+            continue;
+
+        // for constant composition liberation, the saturated phases at a sampled
+        // pressure are the ones of the flash of the original fluid
+        FluidState fluidState;
+        fluidState.setTemperature(T);
+        fluidState.setPressure(oilPhaseIdx, p);
+        fluidState.setPressure(gasPhaseIdx, p);
+        typename FluidSystem::template ParameterCache<Scalar> paramCache;
+        Scalar vaporFraction;
+        Opm::FlashStatistics<Scalar> stats;
+        Flash::solve(fluidState, paramCache, globalMoleFractions, oilPhaseIdx, gasPhaseIdx,
+                     vaporFraction, stats);
+        if (!stats.converged || vaporFraction <= 0.0 || vaporFraction >= 1.0)
+            OPM_THROW(std::runtime_error, "The fluid is not two-phase at p = " << p);
+
+        Scalar Rv = gasPvt.saturatedOilVaporizationFactor(0, T, p);
+        Scalar rhoGasSat = gasPvt.inverseFormationVolumeFactor(0, T, p, Rv)*(rhoRefG + Rv*rhoRefO);
+        if (std::abs(rhoSat - fluidState.density(oilPhaseIdx)) > 1e-6*rhoSat
+            || std::abs(rhoGasSat - fluidState.density(gasPhaseIdx)) > 1e-6*rhoGasSat)
+            OPM_THROW(std::runtime_error,
+                      "Black-oil densities (" << rhoSat << ", " << rhoGasSat << ") deviate "
+                      "from the ones of the equation of state ("
+                      << fluidState.density(oilPhaseIdx) << ", "
+                      << fluidState.density(gasPhaseIdx) << ")");
+    }
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -384,12 +903,24 @@ inline void testAll()
     }
 
     typedef Opm::ComputeFromReferencePhase<Scalar, FluidSystem> CFRP;
+    checkComputeFromReferencePhaseMany<Scalar, FluidSystem>(fluidState, oilPhaseIdx);
     CFRP::solve(fluidState,
                 paramCache,
                 /*refPhaseIdx=*/oilPhaseIdx,
                 /*setViscosity=*/false,
                 /*setEnthalpy=*/false);
 
+    checkFugacityDerivatives<Scalar, FluidSystem>(fluidState, oilPhaseIdx);
+    checkParameterCacheUpdate<Scalar, FluidSystem>(fluidState);
+    checkParamsMixtureUpdate<Scalar, FluidSystem>(fluidState);
+    checkCriticalPointTabulation<Scalar>();
+    checkVaporPressureTabulation<Scalar, FluidSystem>();
+
+    ComponentVector globalMoleFractions;
+    for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
+        globalMoleFractions[compIdx] = fluidState.moleFraction(oilPhaseIdx, compIdx);
+    checkBlackOilTableGenerator<Scalar, FluidSystem>(globalMoleFractions, T);
+
     ////////////
     // Calculate the total molarities of the components
     ////////////
@@ -414,6 +945,7 @@ inline void testAll()
     Scalar rho_oRef = surfaceFluidState.density(oilPhaseIdx);
 
     std::vector<std::array<Scalar, 10> > resultTable;
+    Opm::FlashCache<Scalar, numComponents> flashCache;
 
     Scalar minAlpha = 0.98;
     Scalar maxAlpha = surfaceAlpha;
@@ -429,6 +961,8 @@ inline void testAll()
         curTotalMolarities /= alpha;
 
         // "flash" the modified reservoir oil
+        FluidState initialFluidState;
+        initialFluidState.assign(flashFluidState);
         Flash::template solve<MaterialLaw>(flashFluidState, matParams, paramCache, curTotalMolarities);
 
         surfaceAlpha = bringOilToSurface<Scalar, FluidSystem>(surfaceFluidState,
@@ -463,6 +997,14 @@ inline void testAll()
         tmp[9] = rho_oRef/flashFluidState.density(oilPhaseIdx);
 
         resultTable.push_back(tmp);
+
+        if (i%10 == 0) {
+            checkSuccessiveSubstitutionFlash<Scalar, FluidSystem>(flashFluidState, flashCache);
+            checkRachfordRiceFlash<Scalar, FluidSystem, MaterialLaw>(initialFluidState,
+                                                                     flashFluidState,
+                                                                     matParams,
+                                                                     curTotalMolarities);
+        }
     }
 
     std::cout << "reference density oil [kg/m^3]: " << rho_oRef << "\n";
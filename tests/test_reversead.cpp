@@ -0,0 +1,389 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Tests for the reverse-mode automatic differentiation.
+ *
+ * The gradients obtained by a backward sweep over the tape are compared with the
+ * derivatives computed by the forward-mode dense-AD evaluations for analytic
+ * functions, tabulated functions, saturation functions and PVT relations.
+ */
+#include "config.h"
+
+#include <opm/material/reversead/Math.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
+#include <opm/material/fluidmatrixinteractions/PiecewiseLinearTwoPhaseMaterial.hpp>
+#include <opm/material/fluidmatrixinteractions/EclEpsTwoPhaseLaw.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/ConstantCompressibilityOilPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/DeadOilPvt.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+typedef Opm::ReverseAd::Variable<double> Variable;
+typedef Opm::ReverseAd::Tape<double> Tape;
+typedef Opm::DenseAd::Evaluation<double, 1> ForwardEval;
+
+void checkDerivative(const std::string& what, double reverse, double forward, double tol = 1e-10)
+{
+    if (!(std::abs(reverse - forward) <= tol*(1.0 + std::abs(forward))))
+        OPM_THROW(std::logic_error,
+                  "Reverse-mode derivative of " << what << " differs from the forward-mode"
+                  " one: " << reverse << " vs " << forward);
+}
+
+// evaluate a function with reverse-mode variables and with forward-mode evaluations and
+// compare the derivatives with regard to its arguments. 'Fn' must provide a templated
+// call operator which accepts a vector of either type.
+template <class Fn>
+void compareGradients(const std::string& what, const std::vector<double>& args, const Fn& fn)
+{
+    Tape tape;
+    tape.activate();
+
+    std::vector<Variable> vars;
+    for (double arg : args)
+        vars.push_back(Variable::createIndependent(arg));
+    const Variable result = fn(vars);
+    tape.computeAdjoints(result.index());
+    tape.deactivate();
+
+    for (unsigned argIdx = 0; argIdx < args.size(); ++argIdx) {
+        std::vector<ForwardEval> evals;
+        for (unsigned i = 0; i < args.size(); ++i) {
+            if (i == argIdx)
+                evals.push_back(ForwardEval::createVariable(args[i], 0));
+            else
+                evals.push_back(ForwardEval::createConstant(args[i]));
+        }
+
+        const ForwardEval forward = fn(evals);
+        checkDerivative(what + ": value", result.value(), forward.value());
+        checkDerivative(what, tape.adjoint(vars[argIdx].index()), forward.derivative(0));
+    }
+}
+
+struct ArithmeticFn
+{
+    template <class Eval>
+    Eval operator()(const std::vector<Eval>& x) const
+    { return (x[0]*x[1] - 2.0*x[2])/(x[0] + 1.0) + 3.0/x[1] - x[2]*x[2]*0.5; }
+};
+
+struct TranscendentalFn
+{
+    template <class Eval>
+    Eval operator()(const std::vector<Eval>& x) const
+    {
+        return Opm::exp(x[0])*Opm::log(x[1]) + Opm::sqrt(x[0]*x[1]) + Opm::sin(x[0])
+            + Opm::cos(x[1]) + Opm::tan(x[0]) + Opm::atan(x[1]) + Opm::asin(x[0])
+            + Opm::acos(x[1]) + Opm::atan2(x[0], x[1]);
+    }
+};
+
+struct PowFn
+{
+    template <class Eval>
+    Eval operator()(const std::vector<Eval>& x) const
+    { return Opm::pow(x[0], x[1]) + Opm::pow(x[0], 2.5) + Opm::pow(2.0, x[1]); }
+};
+
+struct MinMaxAbsFn
+{
+    template <class Eval>
+    Eval operator()(const std::vector<Eval>& x) const
+    { return Opm::max(x[0], x[1])*Opm::min(x[0], 0.5) + Opm::abs(x[0]); }
+};
+
+void testElementaryFunctions()
+{
+    compareGradients("arithmetic", { 1.3, 0.7, 2.1 }, ArithmeticFn());
+    compareGradients("transcendental", { 0.3, 0.7 }, TranscendentalFn());
+    compareGradients("pow", { 1.3, 0.7 }, PowFn());
+    compareGradients("min/max/abs", { -1.3, 0.7 }, MinMaxAbsFn());
+
+    // constants are not recorded
+    Tape tape;
+    tape.activate();
+    const Variable x = Variable::createIndependent(2.0);
+    const Variable c = Variable(3.0)*Variable(4.0) + 1.0;
+    const Variable y = x*c;
+    if (c.isActive() || tape.size() != 2)
+        throw std::logic_error("Operations on constants must not be recorded");
+    tape.computeAdjoints(y.index());
+    checkDerivative("x*c", tape.adjoint(x.index()), 13.0);
+}
+
+struct TabulatedFn
+{
+    explicit TabulatedFn(const Opm::Tabulated1DFunction<double>& table)
+        : table_(table)
+    {}
+
+    template <class Eval>
+    Eval operator()(const std::vector<Eval>& x) const
+    { return table_.eval(x[0], /*extrapolate=*/true)*x[0]; }
+
+    const Opm::Tabulated1DFunction<double>& table_;
+};
+
+void testTabulated1DFunction()
+{
+    const std::vector<double> xs = { 0.0, 0.2, 0.5, 0.7, 1.0 };
+    const std::vector<double> ys = { 1.0, 3.0, 2.0, 5.0, 4.0 };
+    const Opm::Tabulated1DFunction<double> table(xs, ys, /*sortInputs=*/false);
+
+    for (double x : { 0.1, 0.35, 0.6, 0.95 })
+        compareGradients("Tabulated1DFunction", { x }, TabulatedFn(table));
+}
+
+std::shared_ptr<Opm::PiecewiseLinearTwoPhaseMaterialParams<Opm::TwoPhaseMaterialTraits<double, 0, 1> > >
+createEffLawParams()
+{
+    typedef Opm::TwoPhaseMaterialTraits<double, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterialParams<Traits> EffLawParams;
+
+    const std::vector<double> SwSamples = { 0.1, 0.2, 0.35, 0.5, 0.7, 0.9 };
+    const std::vector<double> pcSamples = { 3e5, 1e5, 5e4, 2e4, 1e4, 0.0 };
+    const std::vector<double> krwSamples = { 0.0, 0.05, 0.1, 0.3, 0.6, 1.0 };
+    const std::vector<double> krnSamples = { 1.0, 0.7, 0.4, 0.2, 0.05, 0.0 };
+    auto effParams = std::make_shared<EffLawParams>();
+    effParams->setPcnwSamples(SwSamples, pcSamples);
+    effParams->setKrwSamples(SwSamples, krwSamples);
+    effParams->setKrnSamples(SwSamples, krnSamples);
+    effParams->finalize();
+    return effParams;
+}
+
+template <class MaterialLaw>
+struct SaturationFn
+{
+    explicit SaturationFn(const typename MaterialLaw::Params& params)
+        : params_(params)
+    {}
+
+    template <class Eval>
+    Eval operator()(const std::vector<Eval>& x) const
+    {
+        return MaterialLaw::twoPhaseSatKrw(params_, x[0])
+            + MaterialLaw::twoPhaseSatKrn(params_, x[0])
+            + 1e-5*MaterialLaw::twoPhaseSatPcnw(params_, x[0]);
+    }
+
+    const typename MaterialLaw::Params& params_;
+};
+
+void testSaturationFunctions()
+{
+    typedef Opm::TwoPhaseMaterialTraits<double, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> EffLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<EffLaw> MaterialLaw;
+    typedef Opm::EclEpsScalingPoints<double> ScalingPoints;
+
+    const auto effParams = createEffLawParams();
+
+    auto config = std::make_shared<Opm::EclEpsConfig>();
+    config->setEnableSatScaling(true);
+    config->setEnablePcScaling(true);
+    config->setEnableKrwScaling(true);
+    config->setEnableKrnScaling(true);
+
+    auto unscaledPoints = std::make_shared<ScalingPoints>();
+    auto scaledPoints = std::make_shared<ScalingPoints>();
+    const double unscaledSats[3] = { 0.1, 0.35, 0.9 };
+    const double scaledSats[3] = { 0.15, 0.45, 0.85 };
+    for (unsigned pointIdx = 0; pointIdx < 3; ++pointIdx) {
+        if (pointIdx < 2) {
+            unscaledPoints->setSaturationPcPoint(pointIdx, unscaledSats[2*pointIdx]);
+            scaledPoints->setSaturationPcPoint(pointIdx, scaledSats[2*pointIdx]);
+        }
+        unscaledPoints->setSaturationKrwPoint(pointIdx, unscaledSats[pointIdx]);
+        unscaledPoints->setSaturationKrnPoint(pointIdx, unscaledSats[pointIdx]);
+        scaledPoints->setSaturationKrwPoint(pointIdx, scaledSats[pointIdx]);
+        scaledPoints->setSaturationKrnPoint(pointIdx, scaledSats[pointIdx]);
+    }
+    unscaledPoints->setMaxPcnw(3e5);
+    unscaledPoints->setMaxKrw(1.0);
+    unscaledPoints->setMaxKrn(1.0);
+    scaledPoints->setMaxPcnw(2e5);
+    scaledPoints->setMaxKrw(0.8);
+    scaledPoints->setMaxKrn(0.9);
+
+    MaterialLaw::Params params;
+    params.setConfig(config);
+    params.setUnscaledPoints(unscaledPoints);
+    params.setScaledPoints(scaledPoints);
+    params.setEffectiveLawParams(effParams);
+    params.finalize();
+
+    for (double Sw : { 0.17, 0.3, 0.55, 0.8 }) {
+        compareGradients("PiecewiseLinearTwoPhaseMaterial", { Sw },
+                         SaturationFn<EffLaw>(*effParams));
+        compareGradients("EclEpsTwoPhaseLaw", { Sw }, SaturationFn<MaterialLaw>(params));
+    }
+}
+
+template <class Pvt>
+struct PvtFn
+{
+    explicit PvtFn(const Pvt& pvt)
+        : pvt_(pvt)
+    {}
+
+    // x[0] is the temperature, x[1] the pressure
+    template <class Eval>
+    Eval operator()(const std::vector<Eval>& x) const
+    {
+        const Eval Rs = 0.0;
+        return 1e3*pvt_.inverseFormationVolumeFactor(/*regionIdx=*/0, x[0], x[1], Rs)
+            + 1e3*pvt_.viscosity(/*regionIdx=*/0, x[0], x[1], Rs);
+    }
+
+    const Pvt& pvt_;
+};
+
+void testPvt()
+{
+    Opm::ConstantCompressibilityOilPvt<double> constCompOilPvt;
+    constCompOilPvt.setNumRegions(1);
+    constCompOilPvt.setReferenceDensities(0, 800.0, 1.0, 1000.0);
+    constCompOilPvt.setReferencePressure(0, 1e5);
+    constCompOilPvt.setReferenceFormationVolumeFactor(0, 1.1);
+    constCompOilPvt.setCompressibility(0, 1e-9);
+    constCompOilPvt.setViscosity(0, 1e-3);
+    constCompOilPvt.setViscosibility(0, 2e-9);
+    constCompOilPvt.initEnd();
+
+    typedef Opm::Tabulated1DFunction<double> TabulatedOneDFunction;
+    Opm::DeadOilPvt<double> deadOilPvt;
+    deadOilPvt.setNumRegions(1);
+    deadOilPvt.setReferenceDensities(0, 800.0, 1.0, 1000.0);
+    deadOilPvt.setInverseOilFormationVolumeFactor(0, TabulatedOneDFunction(
+        std::vector<double>{ 1e5, 100e5, 200e5, 300e5 },
+        std::vector<double>{ 1/1.1, 1/1.08, 1/1.07, 1/1.065 }));
+    deadOilPvt.setOilViscosity(0, TabulatedOneDFunction(
+        std::vector<double>{ 1e5, 100e5, 200e5, 300e5 },
+        std::vector<double>{ 1e-3, 1.1e-3, 1.25e-3, 1.3e-3 }));
+    deadOilPvt.initEnd();
+
+    for (double p : { 50e5, 150e5, 250e5 }) {
+        compareGradients("ConstantCompressibilityOilPvt", { 350.0, p },
+                         PvtFn<Opm::ConstantCompressibilityOilPvt<double> >(constCompOilPvt));
+        compareGradients("DeadOilPvt", { 350.0, p },
+                         PvtFn<Opm::DeadOilPvt<double> >(deadOilPvt));
+    }
+}
+
+// the squared deviation of the fractional flow of a cell from 0.5
+template <class EffLaw, class Eval>
+Eval cellMisfit(const typename EffLaw::Params& effParams, const Eval& Sw, const Eval& scale)
+{
+    const Eval mobW = EffLaw::twoPhaseSatKrw(effParams, Sw)/1e-3;
+    const Eval mobN = EffLaw::twoPhaseSatKrn(effParams, Sw)/5e-3;
+    const Eval fw = mobW/(mobW + mobN);
+    return Opm::pow(scale*fw - 0.5, 2.0);
+}
+
+// the gradient of a function of many parameters is determined by a single backward
+// sweep. condensing the tape after each cell must not change it.
+void testPreaccumulation()
+{
+    typedef Opm::TwoPhaseMaterialTraits<double, 0, 1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> EffLaw;
+
+    const auto effParams = createEffLawParams();
+    const unsigned numCells = 200;
+
+    std::vector<double> Sw(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        Sw[cellIdx] = 0.12 + 0.75*cellIdx/numCells;
+
+    std::vector<double> gradient[2];
+    std::size_t tapeSize[2];
+    for (int condense = 0; condense < 2; ++condense) {
+        Tape tape;
+        tape.activate();
+
+        const Variable scale = Variable::createIndependent(0.9);
+        std::vector<Variable> vars;
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            vars.push_back(Variable::createIndependent(Sw[cellIdx]));
+
+        Variable misfit = 0.0;
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            const Tape::Position checkpoint = tape.position();
+            std::vector<Variable> cellResult(1, cellMisfit<EffLaw>(*effParams, vars[cellIdx], scale));
+            if (condense)
+                Opm::ReverseAd::preaccumulate(tape, checkpoint, cellResult);
+            misfit += cellResult[0];
+        }
+
+        tape.computeAdjoints(misfit.index());
+        tapeSize[condense] = tape.size();
+        gradient[condense].push_back(tape.adjoint(scale.index()));
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            gradient[condense].push_back(tape.adjoint(vars[cellIdx].index()));
+    }
+
+    for (unsigned i = 0; i < gradient[0].size(); ++i)
+        checkDerivative("the preaccumulated misfit", gradient[1][i], gradient[0][i]);
+
+    // each cell contributes its saturation, the condensed misfit and the summation
+    if (tapeSize[1] != 1 + 3*numCells || !(tapeSize[1] < tapeSize[0]))
+        OPM_THROW(std::logic_error,
+                  "Unexpected size of the condensed tape: " << tapeSize[1]
+                  << " (uncondensed: " << tapeSize[0] << ")");
+
+    // compare with the forward-mode derivatives of the individual cells
+    for (unsigned cellIdx = 0; cellIdx < numCells; cellIdx += 17) {
+        const ForwardEval s = ForwardEval::createVariable(Sw[cellIdx], 0);
+        const ForwardEval misfit = cellMisfit<EffLaw>(*effParams, s, ForwardEval(0.9));
+        checkDerivative("the misfit", gradient[1][cellIdx + 1], misfit.derivative(0));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    testElementaryFunctions();
+    testTabulated1DFunction();
+    testSaturationFunctions();
+    testPvt();
+    testPreaccumulation();
+
+    return 0;
+}
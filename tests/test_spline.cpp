@@ -44,7 +44,10 @@ gnuplot> plot "spline.csv" using 1:2 w l ti "Curve", \
 #include <dune/common/parallel/mpihelper.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <vector>
 
 template <class Spline>
 void testCommon(const Spline& sp,
@@ -201,6 +204,126 @@ void testMonotonic(const Spline& sp,
     }
 }
 
+template <class Spline>
+void testPrecomputedCoefficients(const Spline& sp)
+{
+    Spline fastSp(sp);
+    fastSp.precomputeCoefficients();
+    if (!fastSp.hasPrecomputedCoefficients())
+        OPM_THROW(std::runtime_error,
+                  "Spline does not report its precomputed coefficients");
+
+    double xMin = sp.xAt(0);
+    double xMax = sp.xAt(sp.numSamples() - 1);
+    size_t numValues = 1000;
+    std::vector<double> xValues(numValues + 1);
+    for (size_t i = 0; i <= numValues; ++i)
+        xValues[i] = xMin - 1 + (xMax - xMin + 2)*i/numValues;
+
+    std::vector<double> yValues;
+    fastSp.evalMany(xValues, yValues, /*extrapolate=*/true);
+    for (size_t i = 0; i <= numValues; ++i) {
+        double yRef = sp.eval(xValues[i], /*extrapolate=*/true);
+        double y = fastSp.eval(xValues[i], /*extrapolate=*/true);
+        if (std::abs(y - yRef) > 1e-9*std::max(1.0, std::abs(yRef))
+            || std::abs(yValues[i] - yRef) > 1e-9*std::max(1.0, std::abs(yRef)))
+            OPM_THROW(std::runtime_error,
+                      "Spline with precomputed coefficients deviates at x=" << xValues[i]);
+        if (std::abs(fastSp.evalDerivative(xValues[i], /*extrapolate=*/true)
+                      - sp.evalDerivative(xValues[i], /*extrapolate=*/true)) > 1e-9)
+            OPM_THROW(std::runtime_error,
+                      "Derivative of spline with precomputed coefficients deviates at x="
+                      << xValues[i]);
+    }
+
+    // setting the sampling points again must discard the precomputed data
+    fastSp.set(xMin, xMax, 0.0, 1.0, 0.0, 0.0);
+    if (fastSp.hasPrecomputedCoefficients())
+        OPM_THROW(std::runtime_error,
+                  "Spline keeps its precomputed coefficients after being modified");
+}
+
+// make sure that splines which are set up using a shared factorization of the linear
+// system are identical to the ones which are set up individually
+void testSharedSystem();
+void testSharedSystem()
+{
+    typedef Opm::Spline<double> Spline;
+
+    std::vector<double> x = { 0, 5, 7.5, 8.75, 9.375, 12.0 };
+    std::vector<std::vector<double> > ys(3);
+    for (unsigned k = 0; k < ys.size(); ++k)
+        for (unsigned i = 0; i < x.size(); ++i)
+            ys[k].push_back(std::sin(0.3*(k + 1)*x[i]) + k);
+
+    const Spline::SplineType splineTypes[] = { Spline::Full, Spline::Natural, Spline::Periodic };
+    for (auto splineType : splineTypes) {
+        Spline::MomentSystem system;
+        system.factorize(x, splineType);
+
+        for (const auto& y : ys) {
+            Spline refSp;
+            Spline sp;
+            if (splineType == Spline::Full) {
+                refSp.setXYContainers(x, y, /*m0=*/1.0, /*m1=*/-2.0);
+                sp.setXYContainers(x, y, /*m0=*/1.0, /*m1=*/-2.0, system);
+            }
+            else {
+                refSp.setXYContainers(x, y, splineType);
+                sp.setXYContainers(x, y, system);
+            }
+
+            for (unsigned i = 0; i <= 100; ++i) {
+                double xEval = -1.0 + 14.0*i/100;
+                if (sp.eval(xEval, /*extrapolate=*/true) != refSp.eval(xEval, /*extrapolate=*/true)
+                    || sp.evalDerivative(xEval, /*extrapolate=*/true) != refSp.evalDerivative(xEval, /*extrapolate=*/true))
+                    OPM_THROW(std::runtime_error,
+                              "Spline of type " << splineType << " which uses a shared system deviates at x=" << xEval);
+            }
+        }
+    }
+
+    // the x values of the sampling points must match the ones of the system
+    Spline::MomentSystem system;
+    system.factorize(x, Spline::Natural);
+    std::vector<double> otherX(x);
+    otherX[2] += 0.1;
+    bool hasThrown = false;
+    try {
+        Spline sp;
+        sp.setXYContainers(otherX, ys[0], system);
+    }
+    catch (const std::invalid_argument&) {
+        hasThrown = true;
+    }
+    if (!hasThrown)
+        OPM_THROW(std::runtime_error,
+                  "Spline accepts a shared system for different sampling points");
+
+    // solving for several right hand sides at once must yield the same results as
+    // solving them individually
+    Opm::TridiagonalMatrix<double> M(x.size());
+    for (unsigned i = 0; i < x.size(); ++i) {
+        M[i][i] = 4.0 + i;
+        if (i > 0)
+            M[i][i - 1] = 1.0 + 0.1*i;
+        if (i + 1 < x.size())
+            M[i][i + 1] = 0.5 - 0.1*i;
+    }
+    M[x.size() - 1][0] = 0.25;
+
+    Opm::TridiagonalFactorization<double> factorization(M);
+    std::vector<std::vector<double> > solutions(ys.size(), std::vector<double>(x.size()));
+    factorization.solveAll(solutions, ys);
+    for (unsigned k = 0; k < ys.size(); ++k) {
+        std::vector<double> refSolution(x.size());
+        M.solve(refSolution, ys[k]);
+        if (solutions[k] != refSolution)
+            OPM_THROW(std::runtime_error,
+                      "Solution " << k << " of the tridiagonal system with several right hand sides deviates");
+    }
+}
+
 // function prototype to prevent some compilers producing a warning
 void testAll();
 void testAll()
@@ -257,6 +380,21 @@ void testAll()
     { Opm::Spline<double> sp; sp.setArrayOfPoints(5,points); testNatural(sp, x, y); };
     { Opm::Spline<double> sp; sp.setContainerOfPoints(pointVec); testNatural(sp, x, y); };
     { Opm::Spline<double> sp; sp.setContainerOfTuples(pointsInitList); testNatural(sp, x, y); };
+
+    // precomputed coefficients
+    { Opm::Spline<double> sp(5, x, y, m0, m1); testPrecomputedCoefficients(sp); };
+    { Opm::Spline<double> sp(5, x, y); testPrecomputedCoefficients(sp); };
+    { Opm::Spline<double> sp(5, x, y, Opm::Spline<double>::Monotonic); testPrecomputedCoefficients(sp); };
+    {
+        std::vector<double> xUniform;
+        std::vector<double> yUniform;
+        for (int i = 0; i < 50; ++i) {
+            xUniform.push_back(0.1*i);
+            yUniform.push_back(std::sin(0.1*i));
+        }
+        Opm::Spline<double> sp(xUniform, yUniform);
+        testPrecomputedCoefficients(sp);
+    }
 }
 
 // function prototype to prevent some compilers producing a warning
@@ -301,6 +439,7 @@ int main(int argc, char **argv)
 
     try {
         testAll();
+        testSharedSystem();
         plot();
     }
     catch (const std::exception& e) {
@@ -34,6 +34,10 @@
 #include <opm/material/components/H2O.hpp>
 #include <opm/material/components/TabulatedComponent.hpp>
 
+#include <cstdio>
+#include <string>
+#include <vector>
+
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #include <dune/common/parallel/mpihelper.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
@@ -117,6 +121,109 @@ inline void testAll()
         //std::cerr << "\n";
     }
 
+    std::cout << "\nChecking cached tabulation\n";
+    const std::string cacheFileName =
+        "test_tabulation_h2o_" + std::to_string(sizeof(Scalar)) + ".bin";
+    std::remove(cacheFileName.c_str());
+
+    // the first call computes the tables and writes them to the file, the second
+    // one must yield the same tables by reading them back
+    const Scalar T = (tempMin + tempMax)/2;
+    const Scalar pv = IapwsH2O::vaporPressure(T);
+    TabulatedH2O::init(tempMin, tempMax, nTemp, pMin, pMax, nPress, cacheFileName);
+    Scalar refValues[6] = {
+        TabulatedH2O::vaporPressure(T),
+        TabulatedH2O::gasEnthalpy(T, Scalar(pv/2)),
+        TabulatedH2O::gasDensity(T, Scalar(pv/2)),
+        TabulatedH2O::liquidDensity(T, Scalar(pv*2)),
+        TabulatedH2O::liquidViscosity(T, Scalar(pv*2)),
+        TabulatedH2O::liquidPressure(T, TabulatedH2O::liquidDensity(T, Scalar(pv*2)))
+    };
+
+    TabulatedH2O::init(tempMin, tempMax, nTemp, pMin, pMax, nPress, cacheFileName);
+    Scalar values[6] = {
+        TabulatedH2O::vaporPressure(T),
+        TabulatedH2O::gasEnthalpy(T, Scalar(pv/2)),
+        TabulatedH2O::gasDensity(T, Scalar(pv/2)),
+        TabulatedH2O::liquidDensity(T, Scalar(pv*2)),
+        TabulatedH2O::liquidViscosity(T, Scalar(pv*2)),
+        TabulatedH2O::liquidPressure(T, TabulatedH2O::liquidDensity(T, Scalar(pv*2)))
+    };
+    for (unsigned i = 0; i < 6; ++i)
+        isSame("cached tabulation", values[i], refValues[i], Scalar(0.0));
+
+    std::remove(cacheFileName.c_str());
+
+    std::cout << "Checking independent tables\n";
+    // a table for the same range as the one of the static tables must yield identical
+    // results, and a second, finer table for a narrow range must not affect it
+    typedef typename TabulatedH2O::Tables Tables;
+    Tables coarseTables(tempMin, tempMax, nTemp, pMin, pMax, nPress);
+    Tables fineTables(T - 10, T + 10, 81, Scalar(pv/4), Scalar(pv*4), 200);
+    Scalar tableValues[6] = {
+        coarseTables.vaporPressure(T),
+        coarseTables.gasEnthalpy(T, Scalar(pv/2)),
+        coarseTables.gasDensity(T, Scalar(pv/2)),
+        coarseTables.liquidDensity(T, Scalar(pv*2)),
+        coarseTables.liquidViscosity(T, Scalar(pv*2)),
+        coarseTables.liquidPressure(T, coarseTables.liquidDensity(T, Scalar(pv*2)))
+    };
+    for (unsigned i = 0; i < 6; ++i)
+        isSame("independent tables", tableValues[i], refValues[i], Scalar(0.0));
+    isSame("fine tables", fineTables.liquidDensity(T, Scalar(pv*2)),
+           IapwsH2O::liquidDensity(T, Scalar(pv*2)), Scalar(1e-4));
+    isSame("fine tables", fineTables.gasEnthalpy(T, Scalar(pv/2)),
+           IapwsH2O::gasEnthalpy(T, Scalar(pv/2)), Scalar(1e-4));
+
+    // the tables can be read concurrently
+    const int numStates = 1000;
+    std::vector<Scalar> serialValues(numStates), parallelValues(numStates);
+    for (int stateIdx = 0; stateIdx < numStates; ++stateIdx) {
+        Scalar stateT = tempMin + (tempMax - tempMin)*Scalar(stateIdx)/numStates;
+        serialValues[stateIdx] = coarseTables.liquidDensity(stateT, pMax);
+    }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int stateIdx = 0; stateIdx < numStates; ++stateIdx) {
+        Scalar stateT = tempMin + (tempMax - tempMin)*Scalar(stateIdx)/numStates;
+        parallelValues[stateIdx] = coarseTables.liquidDensity(stateT, pMax);
+    }
+    for (int stateIdx = 0; stateIdx < numStates; ++stateIdx)
+        isSame("concurrent evaluation", parallelValues[stateIdx], serialValues[stateIdx], Scalar(0.0));
+
+    std::cout << "Checking fused lookups\n";
+    // the fused lookups must yield the same values as the individual ones, also for
+    // temperatures outside of the tabulated range
+    const Scalar fusedT[3] = { T, Scalar(tempMin + 0.3), Scalar(tempMax + 0.5) };
+    for (Scalar stateT : fusedT) {
+        const Scalar pl = Scalar(IapwsH2O::vaporPressure(stateT)*2);
+        const auto& liquid = TabulatedH2O::liquidProperties(stateT, pl);
+        isSame("fused liquidDensity", liquid[TabulatedH2O::densityIdx],
+               TabulatedH2O::liquidDensity(stateT, pl), Scalar(0.0));
+        isSame("fused liquidEnthalpy", liquid[TabulatedH2O::enthalpyIdx],
+               TabulatedH2O::liquidEnthalpy(stateT, pl), Scalar(0.0));
+        isSame("fused liquidHeatCapacity", liquid[TabulatedH2O::heatCapacityIdx],
+               TabulatedH2O::liquidHeatCapacity(stateT, pl), Scalar(0.0));
+        isSame("fused liquidViscosity", liquid[TabulatedH2O::viscosityIdx],
+               TabulatedH2O::liquidViscosity(stateT, pl), Scalar(0.0));
+        isSame("fused liquidThermalConductivity", liquid[TabulatedH2O::thermalConductivityIdx],
+               TabulatedH2O::liquidThermalConductivity(stateT, pl), Scalar(0.0));
+
+        const Scalar pg = Scalar(IapwsH2O::vaporPressure(stateT)/2);
+        const auto& gas = TabulatedH2O::gasProperties(stateT, pg);
+        isSame("fused gasDensity", gas[TabulatedH2O::densityIdx],
+               TabulatedH2O::gasDensity(stateT, pg), Scalar(0.0));
+        isSame("fused gasEnthalpy", gas[TabulatedH2O::enthalpyIdx],
+               TabulatedH2O::gasEnthalpy(stateT, pg), Scalar(0.0));
+        isSame("fused gasHeatCapacity", gas[TabulatedH2O::heatCapacityIdx],
+               TabulatedH2O::gasHeatCapacity(stateT, pg), Scalar(0.0));
+        isSame("fused gasViscosity", gas[TabulatedH2O::viscosityIdx],
+               TabulatedH2O::gasViscosity(stateT, pg), Scalar(0.0));
+        isSame("fused gasThermalConductivity", gas[TabulatedH2O::thermalConductivityIdx],
+               TabulatedH2O::gasThermalConductivity(stateT, pg), Scalar(0.0));
+    }
+
     if (success)
         std::cout << "\nsuccess\n";
 }
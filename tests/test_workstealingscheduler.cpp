@@ -0,0 +1,141 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the distribution of work items of very different
+ *        cost by Opm::WorkStealingScheduler.
+ *
+ * Each item needs a given number of units of work, of which the chunk function does
+ * one at a time before it re-queues the item. It is checked that every item gets
+ * exactly the work it needs and that no item is processed by two threads at once.
+ */
+#include "config.h"
+
+#include <opm/material/common/WorkStealingScheduler.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+void testScheduler(std::size_t numItems, std::size_t minChunkSize)
+{
+    // a few items are much more expensive than the others, and the expensive ones are
+    // clustered at the end as near-critical cells of a flash calculation might be
+    std::vector<unsigned> requiredWork(numItems);
+    for (std::size_t itemIdx = 0; itemIdx < numItems; ++itemIdx) {
+        requiredWork[itemIdx] = 1;
+        if (itemIdx % 37 == 0 || itemIdx > numItems*9/10)
+            requiredWork[itemIdx] = 100;
+    }
+
+    std::unique_ptr<std::atomic<unsigned>[]> work(new std::atomic<unsigned>[numItems]);
+    std::unique_ptr<std::atomic<bool>[]> inProgress(new std::atomic<bool>[numItems]);
+    for (std::size_t itemIdx = 0; itemIdx < numItems; ++itemIdx) {
+        work[itemIdx] = 0;
+        inProgress[itemIdx] = false;
+    }
+    std::atomic<bool> concurrentAccess(false);
+    std::atomic<bool> chunkTooSmall(false);
+
+    Opm::WorkStealingScheduler<unsigned> scheduler(minChunkSize);
+    scheduler.run(numItems, [&](std::vector<unsigned>& chunk) {
+            if (chunk.empty())
+                chunkTooSmall = true;
+
+            unsigned numUnfinished = 0;
+            for (unsigned itemIdx : chunk) {
+                if (inProgress[itemIdx].exchange(true))
+                    concurrentAccess = true;
+                unsigned itemWork = ++work[itemIdx];
+                inProgress[itemIdx] = false;
+
+                if (itemWork < requiredWork[itemIdx])
+                    chunk[numUnfinished++] = itemIdx;
+            }
+            chunk.resize(numUnfinished);
+        });
+
+    if (concurrentAccess)
+        throw std::logic_error("An item was processed by two threads at once");
+    if (chunkTooSmall)
+        throw std::logic_error("An empty chunk was handed out");
+
+    for (std::size_t itemIdx = 0; itemIdx < numItems; ++itemIdx)
+        if (work[itemIdx] != requiredWork[itemIdx])
+            OPM_THROW(std::logic_error,
+                      "Item " << itemIdx << " got " << work[itemIdx] << " units of work"
+                      " instead of " << requiredWork[itemIdx]);
+}
+
+void testException()
+{
+    // an exception thrown for one of the items must abandon the remaining ones and be
+    // propagated to the caller
+    Opm::WorkStealingScheduler<std::size_t> scheduler;
+    bool caught = false;
+    try {
+        scheduler.run(1000, [&](std::vector<std::size_t>& chunk) {
+                for (std::size_t itemIdx : chunk)
+                    if (itemIdx == 500)
+                        throw std::runtime_error("failure of item 500");
+                chunk.clear();
+            });
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+
+    if (!caught)
+        throw std::logic_error("The exception of a chunk function was not propagated");
+
+    // the scheduler is usable after an exception
+    std::atomic<std::size_t> numProcessed(0);
+    scheduler.run(100, [&](std::vector<std::size_t>& chunk) {
+            numProcessed += chunk.size();
+            chunk.clear();
+        });
+    if (numProcessed != 100)
+        throw std::logic_error("The scheduler did not process all items after an exception");
+}
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    testScheduler(/*numItems=*/10000, /*minChunkSize=*/1);
+    testScheduler(/*numItems=*/10000, /*minChunkSize=*/64);
+    testScheduler(/*numItems=*/3, /*minChunkSize=*/8);
+    testScheduler(/*numItems=*/1, /*minChunkSize=*/1);
+    testScheduler(/*numItems=*/0, /*minChunkSize=*/1);
+    testException();
+
+    return 0;
+}